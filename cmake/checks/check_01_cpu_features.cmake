@@ -27,7 +27,10 @@
 #   DEAL_II_HAVE_SSE2                    *)
 #   DEAL_II_HAVE_AVX                     *)
 #   DEAL_II_HAVE_AVX512                  *)
+#   DEAL_II_HAVE_NEON                    *)
 #   DEAL_II_COMPILER_VECTORIZATION_LEVEL
+#   DEAL_II_COMPILER_HAS_ATTRIBUTE_TARGET_CLONES
+#   DEAL_II_TARGET_CLONES
 #   DEAL_II_HAVE_OPENMP_SIMD             *)
 #   DEAL_II_OPENMP_SIMD_PRAGMA
 #
@@ -75,6 +78,7 @@ IF(DEAL_II_ALLOW_PLATFORM_INTROSPECTION)
     UNSET(DEAL_II_HAVE_SSE2 CACHE)
     UNSET(DEAL_II_HAVE_AVX CACHE)
     UNSET(DEAL_II_HAVE_AVX512 CACHE)
+    UNSET(DEAL_II_HAVE_NEON CACHE)
   ENDIF()
   SET(DEAL_II_CHECK_CPU_FEATURES_SAVED
     "${CMAKE_REQUIRED_FLAGS}" CACHE INTERNAL "" FORCE
@@ -207,19 +211,92 @@ IF(DEAL_II_ALLOW_PLATFORM_INTROSPECTION)
     }
     "
     DEAL_II_HAVE_AVX512)
+
+  #
+  # 64 bit ARM processors provide 128 bit vectors with the NEON (Advanced
+  # SIMD) instructions, which are used by the same code paths as SSE2:
+  #
+  CHECK_CXX_SOURCE_RUNS(
+    "
+    #if !defined(__ARM_NEON) || !defined(__aarch64__)
+    #error \"__ARM_NEON flag not set, no support for NEON on AArch64\"
+    #endif
+    #include <arm_neon.h>
+    int main()
+    {
+    float64x2_t a, b, c;
+    double data[2];
+    a = vdupq_n_f64 ((volatile double)(1.0));
+    a = vsetq_lane_f64 (0.0, a, 1);
+    b = vdupq_n_f64 ((volatile double)(2.25));
+    c = vaddq_f64 (a, b);
+    c = vmulq_f64 (b, vdivq_f64 (c, vdupq_n_f64 (1.0)));
+    vst1q_f64 (data, c);
+    unsigned int return_value = 0;
+    if (data[0] != 7.3125)
+      return_value = 1;
+    if (data[1] != 5.0625)
+      return_value = 1;
+    return return_value;
+    }
+    "
+    DEAL_II_HAVE_NEON)
 ENDIF()
 
 IF(DEAL_II_HAVE_AVX512)
   SET(DEAL_II_COMPILER_VECTORIZATION_LEVEL 3)
 ELSEIF(DEAL_II_HAVE_AVX)
   SET(DEAL_II_COMPILER_VECTORIZATION_LEVEL 2)
-ELSEIF(DEAL_II_HAVE_SSE2)
+ELSEIF(DEAL_II_HAVE_SSE2 OR DEAL_II_HAVE_NEON)
   SET(DEAL_II_COMPILER_VECTORIZATION_LEVEL 1)
 ELSE()
   SET(DEAL_II_COMPILER_VECTORIZATION_LEVEL 0)
 ENDIF()
 
 
+#
+# Check whether the compiler can generate several versions of a function
+# for different instruction set extensions that are selected at load time
+# according to the CPU the program runs on (function multi-versioning with
+# "__attribute__((target_clones(...)))", which needs ifunc support from the
+# linker and the C library). This is used for a few memory-bound loops in
+# the vector and sparse matrix classes, such that one installation compiled
+# for a generic x86-64 or AVX target also runs these loops with AVX2 or
+# AVX-512 on processors that support them. It is not used if the library is
+# compiled for AVX-512 anyway.
+#
+SET(DEAL_II_TARGET_CLONES " ")
+IF(DEAL_II_COMPILER_VECTORIZATION_LEVEL LESS 3)
+  CHECK_CXX_SOURCE_COMPILES(
+    "
+    #if !defined(__x86_64__)
+    #error \"function multi-versioning is only used on x86-64\"
+    #endif
+    template <typename Number>
+    __attribute__((target_clones(\"avx512f\",\"avx2\",\"default\")))
+    void scale (Number *x, const Number a, const unsigned int n)
+    {
+      for (unsigned int i=0; i<n; ++i)
+        x[i] *= a;
+    }
+    template void scale<double> (double *, const double, const unsigned int);
+    int main ()
+    {
+      double x[4] = {1., 2., 3., 4.};
+      scale (x, 2., 4);
+      return x[3] == 8. ? 0 : 1;
+    }
+    "
+    DEAL_II_COMPILER_HAS_ATTRIBUTE_TARGET_CLONES)
+
+  IF(DEAL_II_COMPILER_HAS_ATTRIBUTE_TARGET_CLONES)
+    SET(DEAL_II_TARGET_CLONES
+      "__attribute__((target_clones(\"avx512f\",\"avx2\",\"default\")))"
+      )
+  ENDIF()
+ENDIF()
+
+
 #
 # OpenMP 4.0 can be used for vectorization (supported by gcc-4.9.1 and
 # later). Only the vectorization instructions
@@ -59,7 +59,35 @@ namespace Algorithms
    * at this point.
    *
    * For the call to (*#inverse_derivative), the vector <tt>"Newton
-   * residual"</tt> is inserted before <tt>"Newton iterate"</tt>.
+   * residual"</tt> is inserted before <tt>"Newton iterate"</tt>, and the
+   * scalar <tt>"Newton forcing term"</tt> of type <tt>const double *</tt> is
+   * appended at the end. An inexact inner solver can use the latter as the
+   * relative tolerance for the linear residual, see #forcing_strategy.
+   *
+   * <h3>Jacobian-free Newton-Krylov method</h3>
+   *
+   * If #jacobian_free is set, the Newton update is computed by GMRES applied
+   * to the derivative of the residual, whose action on a vector <i>v</i> is
+   * approximated by the finite difference
+   * @f[
+   *   F'(u) v \approx \frac{F(u+hv) - F(u)}{h},
+   *   \qquad h = \frac{\sqrt{\epsilon}(1+\|u\|)}{\|v\|},
+   * @f]
+   * with one call to (*#residual) with <tt>"Newton iterate"</tt> replaced by
+   * the perturbed vector. Alternatively, an Operator computing the exact
+   * directional derivative, for instance by forward mode automatic
+   * differentiation with the number types in namespace
+   * Differentiation::AD, can be set by set_directional_derivative(). It is
+   * called with the vector <tt>"Newton direction"</tt> <i>v</i> prepended to
+   * the data of (*#residual), and writes <i>F'(u)v</i> to the first vector
+   * of <tt>out</tt>.
+   *
+   * In this mode, the derivative does not need to be assembled, and
+   * (*#inverse_derivative), if given, only serves as a right preconditioner
+   * of GMRES. It can thus be based on an outdated or simplified derivative,
+   * which is rebuilt in the same way as above upon the event
+   * Algorithms::bad_derivative, controlled by #assemble_threshold and
+   * #max_derivative_age.
    *
    * @author Guido Kanschat, 2006, 2010
    */
@@ -73,6 +101,13 @@ namespace Algorithms
      */
     Newton (OperatorBase &residual, OperatorBase &inverse_derivative);
 
+    /**
+     * Constructor for the Jacobian-free Newton-Krylov method without
+     * preconditioner, receiving the application computing the residual.
+     * Sets #jacobian_free.
+     */
+    Newton (OperatorBase &residual);
+
     /**
      * Declare the parameters applicable to Newton's method.
      */
@@ -88,6 +123,13 @@ namespace Algorithms
      */
     void initialize (OutputOperator<VectorType> &output);
 
+    /**
+     * Set the operator computing the directional derivative of the residual
+     * in the Jacobian-free mode, replacing the finite difference
+     * approximation.
+     */
+    void set_directional_derivative (OperatorBase &derivative);
+
     /**
      * The actual Newton iteration. The initial value is in <tt>out(0)</tt>,
      * which also contains the result after convergence. Values in <tt>in</tt>
@@ -98,6 +140,27 @@ namespace Algorithms
 
     virtual void notify(const Event &);
 
+    /**
+     * The choices for the forcing term, the relative tolerance of the inner
+     * linear solver in each Newton step.
+     */
+    enum ForcingStrategy
+    {
+      /**
+       * Use #forcing_term in all steps.
+       */
+      constant_forcing,
+      /**
+       * Choose the forcing term according to the reduction of the residual
+       * in the last step, by choice 2 of Eisenstat and Walker (SIAM J. Sci.
+       * Comput. 17, 1996) with the safeguards against oversolving at the
+       * beginning and the end of the iteration, bounded by #forcing_term.
+       * Early steps are solved coarsely, while the forcing term decreases
+       * as the iteration converges quadratically.
+       */
+      eisenstat_walker
+    };
+
     /**
      * Set the maximal residual reduction allowed without triggering
      * assembling in the next step. Return the previous value.
@@ -119,6 +182,13 @@ namespace Algorithms
      */
     SmartPointer<OperatorBase, Newton<VectorType> > inverse_derivative;
 
+    /**
+     * The operator computing the directional derivative of the residual in
+     * the Jacobian-free mode, or a null pointer for the finite difference
+     * approximation.
+     */
+    SmartPointer<OperatorBase, Newton<VectorType> > directional_derivative;
+
     /**
      * The operator handling the output in case the debug_vectors is true.
      * Call the initialize function first.
@@ -156,6 +226,49 @@ namespace Algorithms
     double assemble_threshold;
 
   public:
+    /**
+     * The maximal number of Newton steps in a call to operator()() after
+     * which Algorithms::bad_derivative is submitted to #inverse_derivative,
+     * regardless of #assemble_threshold. Zero, the default, disables this
+     * limit.
+     *
+     * @note Controlled by <tt>Maximal derivative age</tt> in parameter file
+     */
+    unsigned int max_derivative_age;
+
+    /**
+     * Compute the Newton update by the Jacobian-free Newton-Krylov method.
+     *
+     * @note Controlled by <tt>Jacobian free</tt> in parameter file
+     */
+    bool jacobian_free;
+
+    /**
+     * The strategy for the forcing term.
+     *
+     * @note Controlled by <tt>Forcing strategy</tt> in parameter file
+     */
+    ForcingStrategy forcing_strategy;
+
+    /**
+     * The forcing term for #constant_forcing, and the initial and maximal
+     * forcing term for #eisenstat_walker. The default is 0.9 with the
+     * strategy #eisenstat_walker.
+     *
+     * @note Controlled by <tt>Forcing term</tt> in parameter file
+     */
+    double forcing_term;
+
+    /**
+     * The maximal number of GMRES iterations in the Jacobian-free mode, and
+     * the number of vectors after which GMRES is restarted.
+     *
+     * @note Controlled by <tt>Krylov iterations</tt> and <tt>Krylov
+     * vectors</tt> in parameter file
+     */
+    unsigned int n_krylov_iterations;
+    unsigned int n_krylov_vectors;
+
     /**
      * Print residual, update and updated solution after each step into file
      * <tt>Newton_NNN</tt>?
@@ -21,15 +21,206 @@
 
 #include <deal.II/base/parameter_handler.h>
 #include <deal.II/base/logstream.h>
+#include <deal.II/base/numbers.h>
 #include <deal.II/lac/vector_memory.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_gmres.h>
 
+#include <cmath>
 #include <iomanip>
+#include <limits>
+#include <type_traits>
 
 
 DEAL_II_NAMESPACE_OPEN
 
 namespace Algorithms
 {
+  namespace internal
+  {
+    namespace NewtonImplementation
+    {
+      /**
+       * The derivative of the residual in the Jacobian-free mode of Newton,
+       * applied by a finite difference of the residual or by the operator
+       * computing the directional derivative.
+       */
+      template <typename VectorType>
+      class JacobianFreeDerivative
+      {
+      public:
+        JacobianFreeDerivative (OperatorBase     &residual,
+                                OperatorBase     *directional_derivative,
+                                const VectorType &u,
+                                const VectorType &res,
+                                const AnyData    &in)
+          :
+          residual (&residual),
+          directional_derivative (directional_derivative),
+          u (&u),
+          u_norm (u.l2_norm()),
+          res (&res),
+          in (&in)
+        {}
+
+        void vmult (VectorType &dst, const VectorType &src) const
+        {
+          if (directional_derivative != nullptr)
+            {
+              AnyData out;
+              out.add<VectorType *>(&dst, "Derivative");
+              AnyData src_data;
+              src_data.add<const VectorType *>(&src, "Newton direction");
+              src_data.add<const VectorType *>(u, "Newton iterate");
+              src_data.merge(*in);
+              (*directional_derivative)(out, src_data);
+              return;
+            }
+
+          const double src_norm = src.l2_norm();
+          if (src_norm == 0.)
+            {
+              dst = 0.;
+              return;
+            }
+
+          // the usual choice of the increment balancing the truncation error
+          // of the difference quotient and the roundoff error in the
+          // evaluation of the residual
+          typedef typename numbers::NumberTraits<typename VectorType::value_type>::real_type real_type;
+          const double h = std::sqrt(std::numeric_limits<real_type>::epsilon()) *
+                           (1. + u_norm) / src_norm;
+
+          typename VectorMemory<VectorType>::Pointer perturbed (mem);
+          perturbed->reinit (*u, true);
+          *perturbed = *u;
+          perturbed->add (h, src);
+
+          AnyData src_data;
+          src_data.add<const VectorType *>(perturbed.get(), "Newton iterate");
+          src_data.merge(*in);
+          AnyData out;
+          out.add<VectorType *>(&dst, "Residual");
+          (*residual)(out, src_data);
+          dst.sadd (1./h, -1./h, *res);
+        }
+
+      private:
+        OperatorBase     *residual;
+        OperatorBase     *directional_derivative;
+        const VectorType *u;
+        const double      u_norm;
+        const VectorType *res;
+        const AnyData    *in;
+        mutable GrowingVectorMemory<VectorType> mem;
+      };
+
+
+
+      /**
+       * A preconditioner applying the inverse derivative operator of Newton
+       * as in the Newton step.
+       */
+      template <typename VectorType>
+      class InverseDerivativePreconditioner
+      {
+      public:
+        InverseDerivativePreconditioner (OperatorBase  &inverse_derivative,
+                                         const AnyData &iterate_and_in)
+          :
+          inverse_derivative (&inverse_derivative),
+          iterate_and_in (&iterate_and_in)
+        {}
+
+        void vmult (VectorType &dst, const VectorType &src) const
+        {
+          dst = 0.;
+          AnyData out;
+          out.add<VectorType *>(&dst, "Update");
+          AnyData src_data;
+          src_data.add<const VectorType *>(&src, "Newton residual");
+          src_data.merge(*iterate_and_in);
+          try
+            {
+              (*inverse_derivative)(out, src_data);
+            }
+          catch (SolverControl::NoConvergence &e)
+            {
+              deallog << "Preconditioner failed after "
+                      << e.last_step << " steps with residual "
+                      << e.last_residual << std::endl;
+            }
+        }
+
+      private:
+        OperatorBase  *inverse_derivative;
+        const AnyData *iterate_and_in;
+      };
+
+
+
+      /**
+       * Solve for the Newton update by GMRES with right preconditioning, such
+       * that the tolerance applies to the residual of the linearized problem.
+       * Return the number of iterations.
+       */
+      template <typename VectorType>
+      unsigned int
+      solve_jacobian_free (const JacobianFreeDerivative<VectorType> &derivative,
+                           OperatorBase                             *inverse_derivative,
+                           const AnyData                            &iterate_and_in,
+                           VectorType                               &Du,
+                           const VectorType                         &res,
+                           const double                              tolerance,
+                           const unsigned int                        n_iterations,
+                           const unsigned int                        n_vectors,
+                           std::false_type)
+      {
+        SolverControl control (n_iterations, tolerance, false, false);
+        SolverGMRES<VectorType> gmres (control,
+                                       typename SolverGMRES<VectorType>::AdditionalData (n_vectors, true));
+        Du = 0.;
+        try
+          {
+            if (inverse_derivative != nullptr)
+              gmres.solve (derivative, Du, res,
+                           InverseDerivativePreconditioner<VectorType> (*inverse_derivative,
+                                                                        iterate_and_in));
+            else
+              gmres.solve (derivative, Du, res, PreconditionIdentity());
+          }
+        catch (SolverControl::NoConvergence &e)
+          {
+            deallog << "Inner iteration failed after "
+                    << e.last_step << " steps with residual "
+                    << e.last_residual << std::endl;
+          }
+        return control.last_step();
+      }
+
+
+
+      // GMRES is only implemented for real numbers
+      template <typename VectorType>
+      unsigned int
+      solve_jacobian_free (const JacobianFreeDerivative<VectorType> &,
+                           OperatorBase *,
+                           const AnyData &,
+                           VectorType &,
+                           const VectorType &,
+                           const double,
+                           const unsigned int,
+                           const unsigned int,
+                           std::true_type)
+      {
+        AssertThrow (false, ExcNotImplemented());
+        return 0;
+      }
+    }
+  }
+
+
+
   template <typename VectorType>
   Newton<VectorType>::Newton(OperatorBase &residual,
                              OperatorBase &inverse_derivative)
@@ -38,6 +229,31 @@ namespace Algorithms
     assemble_now(false),
     n_stepsize_iterations(21),
     assemble_threshold(0.),
+    max_derivative_age(0),
+    jacobian_free(false),
+    forcing_strategy(eisenstat_walker),
+    forcing_term(0.9),
+    n_krylov_iterations(100),
+    n_krylov_vectors(30),
+    debug_vectors(false),
+    debug(0)
+  {}
+
+
+
+  template <typename VectorType>
+  Newton<VectorType>::Newton(OperatorBase &residual)
+    :
+    residual(&residual),
+    assemble_now(false),
+    n_stepsize_iterations(21),
+    assemble_threshold(0.),
+    max_derivative_age(0),
+    jacobian_free(true),
+    forcing_strategy(eisenstat_walker),
+    forcing_term(0.9),
+    n_krylov_iterations(100),
+    n_krylov_vectors(30),
     debug_vectors(false),
     debug(0)
   {}
@@ -53,6 +269,13 @@ namespace Algorithms
     param.declare_entry("Stepsize iterations", "21", Patterns::Integer());
     param.declare_entry("Debug level", "0", Patterns::Integer());
     param.declare_entry("Debug vectors", "false", Patterns::Bool());
+    param.declare_entry("Maximal derivative age", "0", Patterns::Integer(0));
+    param.declare_entry("Jacobian free", "false", Patterns::Bool());
+    param.declare_entry("Forcing strategy", "Eisenstat-Walker",
+                        Patterns::Selection("constant|Eisenstat-Walker"));
+    param.declare_entry("Forcing term", "0.9", Patterns::Double(0., 1.));
+    param.declare_entry("Krylov iterations", "100", Patterns::Integer(1));
+    param.declare_entry("Krylov vectors", "30", Patterns::Integer(1));
     param.leave_subsection();
   }
 
@@ -65,6 +288,13 @@ namespace Algorithms
     assemble_threshold = param.get_double("Assemble threshold");
     n_stepsize_iterations = param.get_integer("Stepsize iterations");
     debug_vectors = param.get_bool("Debug vectors");
+    max_derivative_age = param.get_integer("Maximal derivative age");
+    jacobian_free = param.get_bool("Jacobian free");
+    forcing_strategy = (param.get("Forcing strategy") == "constant"
+                        ? constant_forcing : eisenstat_walker);
+    forcing_term = param.get_double("Forcing term");
+    n_krylov_iterations = param.get_integer("Krylov iterations");
+    n_krylov_vectors = param.get_integer("Krylov vectors");
     param.leave_subsection ();
   }
 
@@ -75,12 +305,22 @@ namespace Algorithms
     data_out = &output;
   }
 
+  template <typename VectorType>
+  void
+  Newton<VectorType>::set_directional_derivative (OperatorBase &derivative)
+  {
+    directional_derivative = &derivative;
+  }
+
   template <typename VectorType>
   void
   Newton<VectorType>::notify(const Event &e)
   {
     residual->notify(e);
-    inverse_derivative->notify(e);
+    if (inverse_derivative != nullptr)
+      inverse_derivative->notify(e);
+    if (directional_derivative != nullptr)
+      directional_derivative->notify(e);
   }
 
 
@@ -119,6 +359,8 @@ namespace Algorithms
     src1.merge(in);
     src2.add<const VectorType *>(res.get(), "Newton residual");
     src2.merge(src1);
+    double forcing = forcing_term;
+    src2.add<const double *>(&forcing, "Newton forcing term");
     AnyData out1;
     out1.add<VectorType *>(res.get(), "Residual");
     AnyData out2;
@@ -129,6 +371,7 @@ namespace Algorithms
     (*residual)(out1, src1);
     double resnorm = res->l2_norm();
     double old_residual = 0.;
+    unsigned int derivative_age = 0;
 
     if (debug_vectors)
       {
@@ -146,20 +389,57 @@ namespace Algorithms
     while (control.check(step++, resnorm) == SolverControl::iterate)
       {
         // assemble (Df(u), v)
-        if ((step > 1) && (resnorm/old_residual >= assemble_threshold))
-          inverse_derivative->notify (Events::bad_derivative);
+        ++derivative_age;
+        if ((step > 1) &&
+            ((resnorm/old_residual >= assemble_threshold) ||
+             (max_derivative_age > 0 && derivative_age > max_derivative_age)))
+          {
+            if (inverse_derivative != nullptr)
+              inverse_derivative->notify (Events::bad_derivative);
+            derivative_age = 1;
+          }
 
-        Du->reinit(u);
-        try
+        if ((step > 1) && (forcing_strategy == eisenstat_walker))
           {
-            (*inverse_derivative)(out2, src2);
+            // choice 2 of Eisenstat and Walker with gamma=0.9 and alpha=2,
+            // safeguarded against a too fast decrease and against
+            // oversolving near the tolerance of the Newton iteration
+            const double gamma = 0.9;
+            const double previous = gamma * forcing * forcing;
+            const double ratio = resnorm/old_residual;
+            forcing = gamma * ratio * ratio;
+            if (previous > 0.1)
+              forcing = std::max(forcing, previous);
+            forcing = std::min(forcing_term,
+                               std::max(forcing, 0.5*control.tolerance()/resnorm));
           }
-        catch (SolverControl::NoConvergence &e)
+        if (debug>1)
+          deallog << "Forcing term: " << forcing << std::endl;
+
+        Du->reinit(u);
+        if (jacobian_free)
           {
-            deallog << "Inner iteration failed after "
-                    << e.last_step << " steps with residual "
-                    << e.last_residual << std::endl;
+            const internal::NewtonImplementation::JacobianFreeDerivative<VectorType>
+            derivative (*residual, directional_derivative, u, *res, in);
+            const unsigned int krylov_steps =
+              internal::NewtonImplementation::solve_jacobian_free
+              (derivative, inverse_derivative, src1, *Du, *res,
+               forcing*resnorm, n_krylov_iterations, n_krylov_vectors,
+               std::integral_constant<bool, numbers::NumberTraits<typename VectorType::value_type>::is_complex>());
+            if (debug>0)
+              deallog << "Krylov steps: " << krylov_steps << std::endl;
           }
+        else
+          try
+            {
+              (*inverse_derivative)(out2, src2);
+            }
+          catch (SolverControl::NoConvergence &e)
+            {
+              deallog << "Inner iteration failed after "
+                      << e.last_step << " steps with residual "
+                      << e.last_residual << std::endl;
+            }
 
         if (debug_vectors)
           {
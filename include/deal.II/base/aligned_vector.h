@@ -20,8 +20,11 @@
 #include <deal.II/base/config.h>
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/memory_tracker.h>
+#include <deal.II/base/multithread_info.h>
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/parallel.h>
+#include <deal.II/base/thread_management.h>
 
 // boost::serialization::make_array used to be in array.hpp, but was
 // moved to a different file in BOOST 1.64
@@ -34,6 +37,7 @@
 #include <boost/serialization/split_member.hpp>
 
 #include <cstring>
+#include <map>
 #include <type_traits>
 
 
@@ -41,6 +45,162 @@
 DEAL_II_NAMESPACE_OPEN
 
 
+/**
+ * An interface for the sources of the memory of AlignedVector objects, and
+ * thus also of the Table classes. By default, AlignedVector allocates its
+ * memory with Utilities::System::posix_memalign(). Deriving from this class
+ * and passing an object of the derived class to
+ * AlignedVector::set_memory_resource() allows taking the memory from other
+ * sources, e.g., from huge pages (see HugePageMemoryResource), from pages
+ * bound to a certain NUMA node, from a preallocated arena, or from a segment
+ * of shared memory.
+ *
+ * The functions are const since a resource is shared by all vectors that use
+ * it, possibly from several threads at the same time. A resource must
+ * outlive all vectors using it. Note that the resource is part of the state
+ * of a vector: it is moved and swapped together with the memory, and a copy
+ * constructed vector uses the resource of the vector it is copied from.
+ */
+class AlignedMemoryResource
+{
+public:
+  /**
+   * Destructor.
+   */
+  virtual ~AlignedMemoryResource () = default;
+
+  /**
+   * Return a pointer to @p size bytes of memory aligned to at least
+   * @p alignment bytes. Throw an exception if no memory is available.
+   */
+  virtual void *allocate (const std::size_t size,
+                          const std::size_t alignment) const = 0;
+
+  /**
+   * Release the memory at @p ptr of @p size bytes, which has been returned by
+   * allocate() of the same object.
+   */
+  virtual void deallocate (void             *ptr,
+                           const std::size_t size) const = 0;
+
+  /**
+   * Return the resource used by the vectors for which no other resource has
+   * been set, which allocates with Utilities::System::posix_memalign() and
+   * releases with std::free().
+   */
+  static const AlignedMemoryResource &get_default ();
+};
+
+
+
+/**
+ * A memory resource that asks the operating system to back large arrays by
+ * transparent huge pages, which reduces the number of misses in the
+ * translation lookaside buffer for streaming access to arrays of many
+ * megabytes. Allocations of at least the size of a huge page are aligned to
+ * the huge page size, and marked by <code>madvise(MADV_HUGEPAGE)</code> on
+ * systems that support it. Smaller allocations are done as for the default
+ * resource. The marking is a hint that the operating system may ignore.
+ */
+class HugePageMemoryResource : public AlignedMemoryResource
+{
+public:
+  /**
+   * Constructor. The argument is the size of a huge page in bytes, which is
+   * two megabytes on most x86-64 systems.
+   */
+  HugePageMemoryResource (const std::size_t huge_page_size = 2*1024*1024);
+
+  /**
+   * Allocate memory as described in the documentation of the class.
+   */
+  virtual void *allocate (const std::size_t size,
+                          const std::size_t alignment) const override;
+
+  /**
+   * Release the memory.
+   */
+  virtual void deallocate (void             *ptr,
+                           const std::size_t size) const override;
+
+private:
+  /**
+   * The size of a huge page.
+   */
+  const std::size_t huge_page_size;
+};
+
+
+
+#ifdef DEAL_II_WITH_MPI
+/**
+ * A memory resource for read-only arrays that are identical on all processes
+ * of an MPI communicator, like the tabulated shape functions of a finite
+ * element. replicate() places one copy of such an array per compute node in
+ * an MPI-3 shared memory window (<code>MPI_Win_allocate_shared</code>) that
+ * all processes on the node read from, instead of one copy per process.
+ * This is used by AlignedVector::replicate_across_communicator().
+ *
+ * Memory obtained from allocate() is private memory of the process as for
+ * the default resource, such that a replicated vector that is copied or
+ * resized continues with private memory. Releasing a shared array with
+ * deallocate() frees the window, which is a collective operation on the
+ * processes of the node: all of them must release their replicated arrays
+ * in the same order.
+ */
+class SharedMemoryResource : public AlignedMemoryResource
+{
+public:
+  /**
+   * Allocate private memory as done by the default resource.
+   */
+  virtual void *allocate (const std::size_t size,
+                          const std::size_t alignment) const override;
+
+  /**
+   * Release the memory. If @p ptr has been returned by replicate(), this
+   * frees the shared memory window collectively on the processes of the
+   * node.
+   */
+  virtual void deallocate (void             *ptr,
+                           const std::size_t size) const override;
+
+  /**
+   * Copy the @p size bytes at @p data on the process @p root_process of
+   * @p communicator into memory shared by the processes on each node, and
+   * return a pointer to this memory, aligned to 64 bytes. On the other
+   * processes, @p data is not accessed, and @p size is set to the size
+   * given on the root process. If the size is zero, no memory is allocated
+   * and a null pointer is returned.
+   *
+   * This is a collective operation on @p communicator.
+   */
+  void *replicate (const void        *data,
+                   std::size_t       &size,
+                   const MPI_Comm    &communicator,
+                   const unsigned int root_process) const;
+
+  /**
+   * Return the object of this class, which is shared by all vectors.
+   */
+  static const SharedMemoryResource &get_instance ();
+
+private:
+  /**
+   * The shared memory windows of the arrays returned by replicate(), indexed
+   * by the address of the array within the current process.
+   */
+  mutable std::map<void *, MPI_Win> windows;
+
+  /**
+   * A mutex for the access to the windows from several threads.
+   */
+  mutable Threads::Mutex mutex;
+};
+#endif
+
+
+
 /**
  * This is a replacement class for std::vector to be used in combination with
  * VectorizedArray and derived data types. It allocates memory aligned to
@@ -52,7 +212,8 @@ DEAL_II_NAMESPACE_OPEN
  * implement parallel copy and move operations with TBB, insert deal.II-style
  * assertions, and cut some unnecessary functionality. Note that this vector
  * is a bit more memory-consuming than std::vector because of alignment, so it
- * is recommended to only use this vector on long vectors.
+ * is recommended to only use this vector on long vectors. The memory is taken
+ * from an AlignedMemoryResource, see set_memory_resource().
  *
  * @p author Katharina Kormann, Martin Kronbichler, 2011
  */
@@ -122,7 +283,8 @@ public:
   /**
    * Change the size of the vector. It keeps old elements previously available
    * but does not initialize the newly allocated memory, leaving it in an
-   * undefined state.
+   * undefined state. (If MultithreadInfo::set_parallel_first_touch() has been
+   * enabled, the new elements are zeroed in parallel instead.)
    *
    * @note This method can only be invoked for classes @p T that define a
    * default constructor, @p T(). Otherwise, compilation will fail.
@@ -224,10 +386,44 @@ public:
   void fill (const T &element);
 
   /**
-   * Swaps the given vector with the calling vector.
+   * Swaps the given vector with the calling vector, including the memory
+   * resources.
    */
   void swap (AlignedVector<T> &vec);
 
+  /**
+   * Take the memory of this vector from @p resource in the future. If the
+   * vector has already allocated memory, its elements are moved to memory
+   * from the new resource. The resource must outlive this vector.
+   */
+  void set_memory_resource (const AlignedMemoryResource &resource);
+
+  /**
+   * Return the resource the memory of this vector is taken from.
+   */
+  const AlignedMemoryResource &get_memory_resource () const;
+
+#ifdef DEAL_II_WITH_MPI
+  /**
+   * Replace the content of this vector by the one of the vector on the
+   * process @p root_process of @p communicator, stored in memory that is
+   * shared by all processes on the same node, see SharedMemoryResource.
+   * This reduces the memory for large tables that are computed identically
+   * on all processes from one copy per process to one copy per node. The
+   * elements are copied bytewise, so @p T must be trivially copyable.
+   *
+   * Afterwards, the vector must be treated as read-only since a change of
+   * its elements would be seen by all processes on the node. Resizing or
+   * copying the vector moves to private memory again. Since the
+   * shared memory is released collectively, all processes of the node must
+   * clear or destroy their replicated vectors in the same order.
+   *
+   * This is a collective operation on @p communicator.
+   */
+  void replicate_across_communicator (const MPI_Comm    &communicator,
+                                      const unsigned int root_process);
+#endif
+
   /**
    * Return whether the vector is empty, i.e., its size is zero.
    */
@@ -314,6 +510,12 @@ private:
    * Pointer to the end of the allocated memory.
    */
   T *_end_allocated;
+
+  /**
+   * The resource the memory is taken from, or a null pointer for the default
+   * resource.
+   */
+  const AlignedMemoryResource *memory_resource;
 };
 
 
@@ -643,7 +845,8 @@ AlignedVector<T>::AlignedVector ()
   :
   _data (nullptr),
   _end_data (nullptr),
-  _end_allocated (nullptr)
+  _end_allocated (nullptr),
+  memory_resource (nullptr)
 {}
 
 
@@ -655,7 +858,8 @@ AlignedVector<T>::AlignedVector (const size_type size,
   :
   _data (nullptr),
   _end_data (nullptr),
-  _end_allocated (nullptr)
+  _end_allocated (nullptr),
+  memory_resource (nullptr)
 {
   if (size > 0)
     resize (size, init);
@@ -678,7 +882,8 @@ AlignedVector<T>::AlignedVector (const AlignedVector<T> &vec)
   :
   _data (nullptr),
   _end_data (nullptr),
-  _end_allocated (nullptr)
+  _end_allocated (nullptr),
+  memory_resource (vec.memory_resource)
 {
   // copy the data from vec
   reserve (vec._end_data - vec._data);
@@ -694,7 +899,8 @@ AlignedVector<T>::AlignedVector (AlignedVector<T> &&vec)
   :
   _data (vec._data),
   _end_data (vec._end_data),
-  _end_allocated (vec._end_allocated)
+  _end_allocated (vec._end_allocated),
+  memory_resource (vec.memory_resource)
 {
   vec._data = nullptr;
   vec._end_data = nullptr;
@@ -726,6 +932,7 @@ AlignedVector<T>::operator = (AlignedVector<T> &&vec)
   _data = vec._data;
   _end_data = vec._end_data;
   _end_allocated = vec._end_allocated;
+  memory_resource = vec.memory_resource;
 
   vec._data = nullptr;
   vec._end_data = nullptr;
@@ -754,8 +961,12 @@ AlignedVector<T>::resize_fast (const size_type size_in)
   _end_data = _data + size_in;
 
   // need to still set the values in case the class is non-trivial because
-  // virtual classes etc. need to run their (default) constructor
-  if (std::is_trivial<T>::value == false && size_in > old_size)
+  // virtual classes etc. need to run their (default) constructor. for
+  // trivial classes, touch the memory in parallel if requested, see
+  // MultithreadInfo::set_parallel_first_touch()
+  if ((std::is_trivial<T>::value == false ||
+       MultithreadInfo::use_parallel_first_touch())
+      && size_in > old_size)
     dealii::internal::AlignedVectorDefaultInitialize<T,true> (size_in-old_size, _data+old_size);
 }
 
@@ -830,22 +1041,24 @@ AlignedVector<T>::reserve (const size_type size_alloc)
 
       // allocate and align along 64-byte boundaries (this is enough for all
       // levels of vectorization currently supported by deal.II)
-      T *new_data;
-      Utilities::System::posix_memalign ((void **)&new_data, 64, size_actual_allocate);
+      T *new_data = static_cast<T *>(get_memory_resource().allocate (size_actual_allocate, 64));
+      if (MemoryTracker::is_enabled())
+        MemoryTracker::record_allocation (new_data, size_actual_allocate);
 
       // copy data in case there was some content before and release the old
-      // memory with the function corresponding to the one used for allocating
+      // memory with the resource used for allocating it
       std::swap (_data, new_data);
       _end_data = _data + old_size;
       _end_allocated = _data + new_size;
-      if (_end_data != _data)
+      if (new_data != nullptr)
         {
-          dealii::internal::AlignedVectorMove<T>(new_data, new_data + old_size,
-                                                 _data);
-          free(new_data);
+          if (old_size > 0)
+            dealii::internal::AlignedVectorMove<T>(new_data, new_data + old_size,
+                                                   _data);
+          if (MemoryTracker::is_enabled())
+            MemoryTracker::record_deallocation (new_data);
+          get_memory_resource().deallocate (new_data, allocated_size * sizeof(T));
         }
-      else
-        Assert(new_data == nullptr, ExcInternalError());
     }
   else if (size_alloc == 0)
     clear();
@@ -864,7 +1077,9 @@ AlignedVector<T>::clear ()
         while (_end_data != _data)
           (--_end_data)->~T();
 
-      free(_data);
+      if (MemoryTracker::is_enabled())
+        MemoryTracker::record_deallocation (_data);
+      get_memory_resource().deallocate (_data, (_end_allocated - _data) * sizeof(T));
     }
   _data = nullptr;
   _end_data = nullptr;
@@ -960,10 +1175,72 @@ AlignedVector<T>::swap (AlignedVector<T> &vec)
   std::swap (_data, vec._data);
   std::swap (_end_data, vec._end_data);
   std::swap (_end_allocated, vec._end_allocated);
+  std::swap (memory_resource, vec.memory_resource);
+}
+
+
+
+template < class T >
+inline
+void
+AlignedVector<T>::set_memory_resource (const AlignedMemoryResource &resource)
+{
+  if (&resource == &get_memory_resource())
+    return;
+
+  // move the elements, if any, into memory of the new resource and release
+  // the old memory with the old resource
+  AlignedVector<T> new_vector;
+  new_vector.memory_resource = &resource;
+  if (_data != nullptr)
+    {
+      new_vector.reserve (capacity());
+      new_vector._end_data = new_vector._data + size();
+      dealii::internal::AlignedVectorMove<T>(_data, _end_data, new_vector._data);
+      _end_data = _data;
+    }
+  clear ();
+  swap (new_vector);
 }
 
 
 
+template < class T >
+inline
+const AlignedMemoryResource &
+AlignedVector<T>::get_memory_resource () const
+{
+  return (memory_resource != nullptr ?
+          *memory_resource :
+          AlignedMemoryResource::get_default());
+}
+
+
+
+#ifdef DEAL_II_WITH_MPI
+template < class T >
+inline
+void
+AlignedVector<T>::replicate_across_communicator (const MPI_Comm    &communicator,
+                                                 const unsigned int root_process)
+{
+  const SharedMemoryResource &resource = SharedMemoryResource::get_instance();
+  std::size_t n_bytes = size() * sizeof(T);
+  T *new_data = static_cast<T *>(resource.replicate (_data, n_bytes,
+                                                     communicator,
+                                                     root_process));
+  clear ();
+  if (new_data != nullptr)
+    {
+      _data = new_data;
+      _end_data = _end_allocated = new_data + n_bytes/sizeof(T);
+      memory_resource = &resource;
+    }
+}
+#endif
+
+
+
 template < class T >
 inline
 bool
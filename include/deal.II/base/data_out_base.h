@@ -20,6 +20,7 @@
 #include <deal.II/base/config.h>
 #include <deal.II/base/point.h>
 #include <deal.II/base/table.h>
+#include <deal.II/base/thread_management.h>
 #include <deal.II/base/geometry_info.h>
 
 #include <vector>
@@ -1121,13 +1122,30 @@ namespace DataOutBase
      */
     ZlibCompressionLevel compression_level;
 
+    /**
+     * Flag determining whether each patch is written as a single higher
+     * order Lagrange cell of VTK (VTK_LAGRANGE_CURVE,
+     * VTK_LAGRANGE_QUADRILATERAL or VTK_LAGRANGE_HEXAHEDRON) whose order is
+     * the number of subdivisions of the patch, rather than as a collection
+     * of subdivided linear cells. If the patches are created with
+     * <tt>build_patches(fe.degree)</tt>, visualization programs can then
+     * represent the polynomial solution on each cell without the output
+     * needing more subdivisions. This requires a patch to be subdivided at
+     * least once, and is only supported by DataOutBase::write_vtu(). Reading
+     * these cells needs VTK 8.1 or ParaView 5.5 or later.
+     *
+     * Default is <tt>false</tt>.
+     */
+    bool write_higher_order_cells;
+
     /**
      * Constructor.
      */
     VtkFlags (const double       time   = std::numeric_limits<double>::min(),
               const unsigned int cycle  = std::numeric_limits<unsigned int>::min(),
               const bool print_date_and_time = true,
-              const ZlibCompressionLevel compression_level = best_compression);
+              const ZlibCompressionLevel compression_level = best_compression,
+              const bool write_higher_order_cells = false);
   };
 
 
@@ -1226,11 +1244,23 @@ namespace DataOutBase
      */
     bool xdmf_hdf5_output;
 
+    /**
+     * The level of the deflate (zlib) compression of the data sets written
+     * by DataOutBase::write_hdf5_parallel(), between 0 and 9. If the level
+     * is zero, the data sets are stored contiguously and uncompressed.
+     * Otherwise, they are stored in chunks that are compressed independently,
+     * with higher levels giving smaller files at the cost of a longer time
+     * for writing. HDF5 readers decompress the data transparently. In
+     * parallel, compression requires HDF5 version 1.10.2 or later.
+     */
+    unsigned int hdf5_compression_level;
+
     /**
      * Constructor.
      */
     DataOutFilterFlags (const bool filter_duplicate_vertices = false,
-                        const bool xdmf_hdf5_output = false);
+                        const bool xdmf_hdf5_output = false,
+                        const unsigned int hdf5_compression_level = 0);
 
     /**
      * Declare all flags with name and type as offered by this class, for use
@@ -1365,6 +1395,11 @@ namespace DataOutBase
      */
     unsigned int n_data_sets() const;
 
+    /**
+     * Return the flags this object was created with.
+     */
+    const DataOutBase::DataOutFilterFlags &get_flags() const;
+
     /**
      * Empty functions to do base class inheritance.
      */
@@ -2478,12 +2513,37 @@ public:
    * (those in the given communicator) to a single compressed .vtu file on a
    * shared file system.  The communicator can be a sub communicator of the
    * one used by the computation.  This routine uses MPI I/O to achieve high
-   * performance on parallel filesystems. Also see
-   * DataOutInterface::write_vtu().
+   * performance on parallel filesystems: the position of the data of each
+   * process in the file is computed with one exclusive scan over the sizes,
+   * and all processes write their data with a single collective call, which
+   * allows the MPI implementation to aggregate the data in large blocks on a
+   * few processes. Since only one file is created, this avoids the load on
+   * the metadata servers of the file system that comes with writing one file
+   * per process. Also see DataOutInterface::write_vtu().
    */
   void write_vtu_in_parallel (const char *filename,
                               MPI_Comm comm) const;
 
+  /**
+   * Write the data in Vtu format to the file @p filename in a background
+   * task and return immediately, such that the computation can continue
+   * while the data is compressed and the file system writes the file. This
+   * function copies the patches and the names of the data sets before it
+   * returns, so the object may be changed or rebuilt (e.g., through
+   * DataOut::build_patches() in the next time step) while the task is
+   * running, at the expense of holding a second copy of the patches in
+   * memory until the task finishes.
+   *
+   * Call Threads::Task::join() on the returned object before the file is
+   * needed, and at the latest before the program ends. In a parallel
+   * computation, each process writes its own file and the files can be
+   * grouped with write_pvtu_record(). Since the task does not call any MPI
+   * functions, this works with any level of thread support of the MPI
+   * implementation. If deal.II is configured without threads, the file is
+   * written before this function returns.
+   */
+  Threads::Task<> write_vtu_in_background (const std::string &filename) const;
+
   /**
    * Some visualization programs, such as ParaView, can read several separate
    * VTU files that all form part of the same simulation, in order to
@@ -2606,6 +2666,47 @@ public:
    * contain only the solution values. If write_mesh_file is true and the
    * filenames are the same, the resulting file will contain both mesh data
    * and solution values.
+   *
+   * This allows to write the mesh only once for a time series in which the
+   * mesh does not change, which typically makes up most of the size of the
+   * output. Whether the mesh has changed since it was last written can be
+   * tracked with the signals of the Triangulation class:
+   *
+   * @code
+   * bool mesh_changed = true;
+   * triangulation.signals.any_change.connect ([&]() { mesh_changed = true; });
+   * std::string mesh_filename;
+   * std::vector<XDMFEntry> xdmf_entries;
+   *
+   * for (unsigned int step=0; ...; ++step)
+   *   {
+   *     ... // solve, possibly refine the mesh
+   *
+   *     DataOutBase::DataOutFilter data_filter(DataOutBase::DataOutFilterFlags(true, true));
+   *     data_out.write_filtered_data(data_filter);
+   *
+   *     // only write a new mesh file if the mesh has changed
+   *     if (mesh_changed)
+   *       mesh_filename = "mesh-" + Utilities::int_to_string(step, 4) + ".h5";
+   *     const std::string solution_filename
+   *       = "solution-" + Utilities::int_to_string(step, 4) + ".h5";
+   *     data_out.write_hdf5_parallel(data_filter, mesh_changed,
+   *                                  mesh_filename, solution_filename,
+   *                                  MPI_COMM_WORLD);
+   *     mesh_changed = false;
+   *
+   *     // refer to the last mesh file from the XDMF file
+   *     xdmf_entries.push_back(data_out.create_xdmf_entry(data_filter,
+   *                                                       mesh_filename,
+   *                                                       solution_filename,
+   *                                                       time, MPI_COMM_WORLD));
+   *     data_out.write_xdmf_file(xdmf_entries, "solution.xdmf", MPI_COMM_WORLD);
+   *   }
+   * @endcode
+   *
+   * Note that @p data_filter must have been filled using the same flags for
+   * all steps, so that the nodes and cells are numbered in the same way as
+   * in the mesh file that is referred to.
    */
   void write_hdf5_parallel (const DataOutBase::DataOutFilter &data_filter,
                             const bool write_mesh_file,
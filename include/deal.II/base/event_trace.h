@@ -0,0 +1,234 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_event_trace_h
+#define dealii_event_trace_h
+
+
+#include <deal.II/base/config.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/**
+ * A namespace for recording a trace of timestamped events, i.e., of the
+ * intervals in which each thread of a program worked on a particular
+ * operation. Unlike the accumulated times of TimerOutput, a trace shows
+ * which operations ran concurrently on the various threads and where
+ * threads were idle, e.g. because a WorkStream copier was the bottleneck or
+ * because the computations did not overlap with the MPI communication of
+ * ghost values.
+ *
+ * Tracing is off by default and is switched on by calling enable(). From
+ * then on, the following operations record an event:
+ * - the sections of all TimerOutput objects (category
+ *   <code>"TimerOutput"</code>),
+ * - each chunk of elements processed by the worker and the copier functions
+ *   of WorkStream::run() in parallel (category <code>"WorkStream"</code>),
+ * - each range of cells processed by the threads of MatrixFree::cell_loop()
+ *   (category <code>"MatrixFree"</code>),
+ * - the start and finish functions of the exchange of ghost values in
+ *   Utilities::MPI::Partitioner (category <code>"MPI"</code>).
+ * User code can add events for its own operations by placing a Scope object
+ * at the beginning of a block:
+ * @code
+ *   EventTrace::enable();
+ *   ...
+ *   {
+ *     EventTrace::Scope scope ("assemble rhs", "user");
+ *     ...
+ *   }
+ *   ...
+ *   std::ofstream trace_file ("trace-" + Utilities::int_to_string
+ *                             (Utilities::MPI::this_mpi_process(MPI_COMM_WORLD))
+ *                             + ".json");
+ *   EventTrace::write_chrome_trace (trace_file);
+ * @endcode
+ * The output is in the JSON format of the Chrome trace event profiler and
+ * can be viewed by opening <code>chrome://tracing</code> in a Chrome browser
+ * or with the Perfetto user interface. Each thread is shown in its own row,
+ * and each MPI process is shown as a separate process, so that the arrays
+ * <code>traceEvents</code> of the files written on the various processes
+ * can be concatenated into a single file to see all processes at once.
+ *
+ * Each thread records its events into its own ring buffer, so that recording
+ * an event needs neither a lock nor an atomic read-modify-write operation,
+ * and costs about the time of two reads of the clock. If a thread records
+ * more events than the buffer can hold, the oldest ones are overwritten.
+ * When tracing is disabled, the instrumented operations only check a flag.
+ *
+ * @ingroup utilities
+ */
+namespace EventTrace
+{
+  /**
+   * Start recording events. Every thread that records an event for the
+   * first time allocates a buffer for the given number of events, which is
+   * rounded up to the next power of two. Buffers that a thread allocated
+   * earlier keep their size.
+   */
+  void enable (const unsigned int events_per_thread = 65536);
+
+  /**
+   * Stop recording events. The events recorded so far are kept until clear()
+   * is called.
+   */
+  void disable ();
+
+  /**
+   * Return whether events are currently recorded.
+   */
+  bool is_enabled ();
+
+  /**
+   * Discard all events recorded so far. This function must not be called
+   * while other threads record events.
+   */
+  void clear ();
+
+  /**
+   * Return the current time in nanoseconds, measured with a monotonic
+   * clock, as used for the begin and end of events.
+   */
+  std::uint64_t now ();
+
+  /**
+   * Record an event of the calling thread that started at @p begin_time and
+   * ended at @p end_time, both as returned by now(). The strings @p name and
+   * @p category are not copied and must be valid until the trace has been
+   * written, such as string literals or the return values of intern().
+   * Nothing is recorded if tracing is not enabled.
+   */
+  void record (const char         *name,
+               const char         *category,
+               const std::uint64_t begin_time,
+               const std::uint64_t end_time);
+
+  /**
+   * Return a pointer to a copy of @p name that stays valid until the end of
+   * the program, equal for equal strings, for use as the name of an event
+   * whose name is not a string literal. This function takes a lock.
+   */
+  const char *intern (const std::string &name);
+
+  /**
+   * Write all recorded events of all threads to @p out in the JSON format of
+   * the Chrome trace event profiler. The events are sorted by their begin
+   * time within each thread, and times are given in microseconds relative to
+   * the first call to enable(). The MPI rank of the calling process within
+   * <code>MPI_COMM_WORLD</code> is used as the process id. This function must
+   * not be called while other threads record events, e.g. by calling it
+   * after disable().
+   */
+  void write_chrome_trace (std::ostream &out);
+
+  /**
+   * A helper class that records an event from its construction to its
+   * destruction, analogous to TimerOutput::Scope. The strings are subject to
+   * the same requirement as in record().
+   */
+  class Scope
+  {
+  public:
+    /**
+     * Constructor. Take the begin time if tracing is enabled.
+     */
+    Scope (const char *name,
+           const char *category);
+
+    /**
+     * Destructor. Record the event.
+     */
+    ~Scope ();
+
+  private:
+    /**
+     * The name of the event.
+     */
+    const char *const name;
+
+    /**
+     * The category of the event.
+     */
+    const char *const category;
+
+    /**
+     * The begin time of the event, or zero if tracing was not enabled upon
+     * construction.
+     */
+    const std::uint64_t begin_time;
+  };
+
+
+  namespace internal
+  {
+    /**
+     * The flag that is returned by is_enabled().
+     */
+    extern std::atomic<bool> tracing_enabled;
+  }
+
+
+
+  /* ---------------- inline functions ----------------- */
+
+  inline
+  bool
+  is_enabled ()
+  {
+    return internal::tracing_enabled.load (std::memory_order_relaxed);
+  }
+
+
+
+  inline
+  std::uint64_t
+  now ()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>
+           (std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+
+
+  inline
+  Scope::Scope (const char *name,
+                const char *category)
+    :
+    name (name),
+    category (category),
+    begin_time (is_enabled() ? now() : 0)
+  {}
+
+
+
+  inline
+  Scope::~Scope ()
+  {
+    if (begin_time != 0)
+      record (name, category, begin_time, now());
+  }
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
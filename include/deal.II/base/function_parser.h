@@ -302,6 +302,23 @@ public:
   virtual void vector_value (const Point<dim>   &p,
                              Vector<double>     &values) const;
 
+  /**
+   * Set <tt>values</tt> to the point values of the specified component of the
+   * function at the <tt>points</tt>. This does the same as calling value()
+   * for each point, but looks up the parser objects of the current thread
+   * only once rather than once per point and variable.
+   */
+  virtual void value_list (const std::vector<Point<dim> > &points,
+                           std::vector<double>            &values,
+                           const unsigned int              component = 0) const;
+
+  /**
+   * Set <tt>values</tt> to the point values of all components of the
+   * function at the <tt>points</tt>, in the same way as value_list().
+   */
+  virtual void vector_value_list (const std::vector<Point<dim> > &points,
+                                  std::vector<Vector<double> >   &values) const;
+
   /**
    * @addtogroup Exceptions
    * @{
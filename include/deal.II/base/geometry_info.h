@@ -831,6 +831,51 @@ namespace internal
     (dim == 3 ? 4 : 1);
   };
 
+
+  namespace GeometryInfoHelper
+  {
+    /**
+     * The tables of GeometryInfo<dim> that describe the faces of the reference
+     * cell. They are given here together with their values, rather than in a
+     * source file, such that they are compile-time constants in all files
+     * using them and lookups with known face numbers are folded away.
+     */
+    template <int dim>
+    struct FaceTables;
+
+    template <>
+    struct FaceTables<1>
+    {
+      static constexpr unsigned int unit_normal_direction[2] = { 0, 0 };
+      static constexpr int          unit_normal_orientation[2] = { -1, 1 };
+      static constexpr unsigned int opposite_face[2] = { 1, 0 };
+    };
+
+    template <>
+    struct FaceTables<2>
+    {
+      static constexpr unsigned int unit_normal_direction[4] = { 0, 0, 1, 1 };
+      static constexpr int          unit_normal_orientation[4] = { -1, 1, -1, 1 };
+      static constexpr unsigned int opposite_face[4] = { 1, 0, 3, 2 };
+    };
+
+    template <>
+    struct FaceTables<3>
+    {
+      static constexpr unsigned int unit_normal_direction[6] = { 0, 0, 1, 1, 2, 2 };
+      static constexpr int          unit_normal_orientation[6] = { -1, 1, -1, 1, -1, 1 };
+      static constexpr unsigned int opposite_face[6] = { 1, 0, 3, 2, 5, 4 };
+    };
+
+    template <>
+    struct FaceTables<4>
+    {
+      static constexpr unsigned int unit_normal_direction[8] = { 0, 0, 1, 1, 2, 2, 3, 3 };
+      static constexpr int          unit_normal_orientation[8] = { -1, 1, -1, 1, -1, 1, -1, 1 };
+      static constexpr unsigned int opposite_face[8] = { 1, 0, 3, 2, 5, 4, 7, 6 };
+    };
+  }
+
 } // namespace internal
 
 
@@ -2056,7 +2101,8 @@ struct GeometryInfo
    * normal vector is obtained by multiplying the unit vector in this
    * direction with #unit_normal_orientation.
    */
-  static const unsigned int unit_normal_direction[faces_per_cell];
+  static constexpr const unsigned int (&unit_normal_direction)[faces_per_cell]
+    = internal::GeometryInfoHelper::FaceTables<dim>::unit_normal_direction;
 
   /**
    * Orientation of the unit normal vector of a face of the reference cell. In
@@ -2074,14 +2120,16 @@ struct GeometryInfo
    * @ref GlossFaceOrientation "glossary"
    * entry on face orientation.
    */
-  static const int unit_normal_orientation[faces_per_cell];
+  static constexpr const int (&unit_normal_orientation)[faces_per_cell]
+    = internal::GeometryInfoHelper::FaceTables<dim>::unit_normal_orientation;
 
   /**
    * List of numbers which denotes which face is opposite to a given face. Its
    * entries are the first <tt>2*dim</tt> entries of <tt>{ 1, 0, 3, 2, 5, 4,
    * 7, 6}</tt>.
    */
-  static const unsigned int opposite_face[faces_per_cell];
+  static constexpr const unsigned int (&opposite_face)[faces_per_cell]
+    = internal::GeometryInfoHelper::FaceTables<dim>::opposite_face;
 
 
   /**
@@ -2107,38 +2155,20 @@ struct GeometryInfo
 #ifndef DOXYGEN
 
 
-/* -------------- declaration of explicit specializations ------------- */
+/* -------------- definition of static tables ------------- */
 
-#ifndef DEAL_II_MEMBER_ARRAY_SPECIALIZATION_BUG
-template <>
-const unsigned int GeometryInfo<1>::unit_normal_direction[faces_per_cell];
-template <>
-const unsigned int GeometryInfo<2>::unit_normal_direction[faces_per_cell];
-template <>
-const unsigned int GeometryInfo<3>::unit_normal_direction[faces_per_cell];
-template <>
-const unsigned int GeometryInfo<4>::unit_normal_direction[faces_per_cell];
+template <int dim>
+constexpr const unsigned int (&GeometryInfo<dim>::unit_normal_direction)[GeometryInfo<dim>::faces_per_cell];
 
-template <>
-const int GeometryInfo<1>::unit_normal_orientation[faces_per_cell];
-template <>
-const int GeometryInfo<2>::unit_normal_orientation[faces_per_cell];
-template <>
-const int GeometryInfo<3>::unit_normal_orientation[faces_per_cell];
-template <>
-const int GeometryInfo<4>::unit_normal_orientation[faces_per_cell];
+template <int dim>
+constexpr const int (&GeometryInfo<dim>::unit_normal_orientation)[GeometryInfo<dim>::faces_per_cell];
 
-template <>
-const unsigned int GeometryInfo<1>::opposite_face[faces_per_cell];
-template <>
-const unsigned int GeometryInfo<2>::opposite_face[faces_per_cell];
-template <>
-const unsigned int GeometryInfo<3>::opposite_face[faces_per_cell];
-template <>
-const unsigned int GeometryInfo<4>::opposite_face[faces_per_cell];
-#endif
+template <int dim>
+constexpr const unsigned int (&GeometryInfo<dim>::opposite_face)[GeometryInfo<dim>::faces_per_cell];
 
 
+/* -------------- declaration of explicit specializations ------------- */
+
 template <>
 Tensor<1,1>
 GeometryInfo<1>::
@@ -20,11 +20,10 @@
 
 #include <deal.II/base/config.h>
 #include <deal.II/base/thread_management.h>
-#include <boost/unordered_map.hpp>
 #include <boost/unordered_set.hpp>
 
+#include <algorithm>
 #include <functional>
-#include <set>
 #include <vector>
 
 
@@ -110,58 +109,69 @@ namespace GraphColoring
                         const typename identity<Iterator>::type &end,
                         const std::function<std::vector<types::global_dof_index> (const Iterator &)> &get_conflict_indices)
     {
-      // Number of iterators.
-      unsigned int n_iterators = 0;
-
-      // Create a map from conflict indices to iterators
-      boost::unordered_map<types::global_dof_index,std::vector<Iterator> > indices_to_iterators;
+      // Collect the iterators and their conflict indices, so that the
+      // iterators can be referred to by their number in the range below and
+      // the user function is only called once per iterator. The conflict
+      // indices of all iterators are stored in one array, and the pairs of
+      // conflict indices and iterator numbers are sorted, so that all the
+      // iterators that contain a given conflict index are adjacent
+      std::vector<Iterator> iterators;
+      std::vector<types::global_dof_index> conflict_indices;
+      std::vector<unsigned int> conflict_indices_start(1, 0);
+      std::vector<std::pair<types::global_dof_index,unsigned int> > indices_to_iterators;
       for (Iterator it=begin; it!=end; ++it)
         {
-          const std::vector<types::global_dof_index> conflict_indices = get_conflict_indices(it);
-          const unsigned int n_conflict_indices = conflict_indices.size();
-          for (unsigned int i=0; i<n_conflict_indices; ++i)
-            indices_to_iterators[conflict_indices[i]].push_back(it);
-          ++n_iterators;
+          const std::vector<types::global_dof_index> it_conflict_indices = get_conflict_indices(it);
+          for (unsigned int i=0; i<it_conflict_indices.size(); ++i)
+            indices_to_iterators.emplace_back(it_conflict_indices[i], iterators.size());
+          conflict_indices.insert(conflict_indices.end(),
+                                  it_conflict_indices.begin(),
+                                  it_conflict_indices.end());
+          conflict_indices_start.push_back(conflict_indices.size());
+          iterators.push_back(it);
         }
+      std::sort(indices_to_iterators.begin(), indices_to_iterators.end());
+      const unsigned int n_iterators = iterators.size();
 
       // create the very first zone which contains only the first
       // iterator. then create the other zones. keep track of all the
       // iterators that have already been assigned to a zone
-      std::vector<std::vector<Iterator> > zones(1,std::vector<Iterator> (1,begin));
-      std::set<Iterator> used_it;
-      used_it.insert(begin);
-      while (used_it.size()!=n_iterators)
+      std::vector<std::vector<unsigned int> > zones(1,std::vector<unsigned int> (1,0));
+      std::vector<bool> used_it (n_iterators, false);
+      used_it[0] = true;
+      unsigned int n_used_it = 1;
+
+      // the first iterator that might not have been assigned to a zone yet
+      unsigned int first_unused_it = 1;
+      while (n_used_it!=n_iterators)
         {
           // loop over the elements of the previous zone. for each element of
           // the previous zone, get the conflict indices and from there get
           // those iterators that are conflicting with the current element
-          typename std::vector<Iterator>::iterator previous_zone_it(zones.back().begin());
-          typename std::vector<Iterator>::iterator previous_zone_end(zones.back().end());
-          std::vector<Iterator> new_zone;
-          for (; previous_zone_it!=previous_zone_end; ++previous_zone_it)
+          std::vector<unsigned int> new_zone;
+          for (unsigned int z=0; z<zones.back().size(); ++z)
             {
-              const std::vector<types::global_dof_index>
-              conflict_indices = get_conflict_indices(*previous_zone_it);
-
-              const unsigned int n_conflict_indices(conflict_indices.size());
-              for (unsigned int i=0; i<n_conflict_indices; ++i)
+              const unsigned int current_it = zones.back()[z];
+              for (unsigned int i=conflict_indices_start[current_it];
+                   i<conflict_indices_start[current_it+1]; ++i)
                 {
-                  const std::vector<Iterator> &conflicting_elements
-                    = indices_to_iterators[conflict_indices[i]];
-                  for (unsigned int j=0; j<conflicting_elements.size(); ++j)
+                  const types::global_dof_index index = conflict_indices[i];
+                  for (auto conflicting_element
+                       = std::lower_bound(indices_to_iterators.begin(),
+                                          indices_to_iterators.end(),
+                                          std::make_pair(index, 0U));
+                       conflicting_element != indices_to_iterators.end() &&
+                       conflicting_element->first == index;
+                       ++conflicting_element)
                     {
                       // check that the iterator conflicting with the current one is not
                       // associated to a zone yet and if so, assign it to the current
                       // zone. mark it as used
-                      //
-                      // we can shortcut this test if the conflicting iterator is the
-                      // current iterator
-                      if ((conflicting_elements[j] != *previous_zone_it)
-                          &&
-                          (used_it.count(conflicting_elements[j])==0))
+                      if (used_it[conflicting_element->second] == false)
                         {
-                          new_zone.push_back(conflicting_elements[j]);
-                          used_it.insert(conflicting_elements[j]);
+                          new_zone.push_back(conflicting_element->second);
+                          used_it[conflicting_element->second] = true;
+                          ++n_used_it;
                         }
                     }
                 }
@@ -174,16 +184,25 @@ namespace GraphColoring
           if (new_zone.size()!=0)
             zones.push_back(new_zone);
           else
-            for (Iterator it=begin; it!=end; ++it)
-              if (used_it.count(it)==0)
-                {
-                  zones.push_back(std::vector<Iterator> (1,it));
-                  used_it.insert(it);
-                  break;
-                }
+            {
+              while (used_it[first_unused_it] == true)
+                ++first_unused_it;
+              zones.push_back(std::vector<unsigned int> (1,first_unused_it));
+              used_it[first_unused_it] = true;
+              ++n_used_it;
+            }
+        }
+
+      // translate the numbers of the iterators back to the iterators
+      std::vector<std::vector<Iterator> > iterator_zones(zones.size());
+      for (unsigned int z=0; z<zones.size(); ++z)
+        {
+          iterator_zones[z].reserve(zones[z].size());
+          for (unsigned int i=0; i<zones[z].size(); ++i)
+            iterator_zones[z].push_back(iterators[zones[z][i]]);
         }
 
-      return zones;
+      return iterator_zones;
     }
 
 
@@ -197,6 +216,11 @@ namespace GraphColoring
      * the chosen vertex with the least possible (lowest numbered) color. -#
      * If all the vertices are colored, stop. Otherwise, return to 3.
      *
+     * The conflict graph within the set is built from a map from the
+     * conflict indices to the elements that contain them, which takes a time
+     * proportional to the number of conflicts rather than to the square of
+     * the number of elements.
+     *
      * @param[in] partition The set of iterators that should be colored.
      * @param[in] get_conflict_indices A user defined function object
      * returning a set of indicators that are descriptive of what represents a
@@ -218,81 +242,78 @@ namespace GraphColoring
       // Number of zones composing the partitioning.
       const unsigned int partition_size(partition.size());
       std::vector<unsigned int> sorted_vertices(partition_size);
-      std::vector<int> degrees(partition_size);
-      std::vector<std::vector<types::global_dof_index> > conflict_indices(partition_size);
       std::vector<std::vector<unsigned int> > graph(partition_size);
 
-      // Get the conflict indices associated to each iterator. The conflict_indices have to
-      // be sorted so we can more easily find conflicts later on
+      // Sort the pairs of conflict indices and vertices, so that all
+      // vertices that contain a given conflict index are adjacent
+      std::vector<std::pair<types::global_dof_index,unsigned int> > indices_to_vertices;
       for (unsigned int i=0; i<partition_size; ++i)
         {
-          conflict_indices[i] = get_conflict_indices(partition[i]);
-          std::sort(conflict_indices[i].begin(), conflict_indices[i].end());
+          const std::vector<types::global_dof_index> conflict_indices
+            = get_conflict_indices(partition[i]);
+          for (unsigned int k=0; k<conflict_indices.size(); ++k)
+            indices_to_vertices.emplace_back(conflict_indices[k], i);
         }
+      std::sort(indices_to_vertices.begin(), indices_to_vertices.end());
 
-      // Compute the degree of each vertex of the graph using the
-      // intersection of the conflict indices.
-      for (unsigned int i=0; i<partition_size; ++i)
-        for (unsigned int j=i+1; j<partition_size; ++j)
-          // If the two iterators share indices then we increase the degree of the
-          // vertices and create an ''edge'' in the graph.
-          if (have_nonempty_intersection (conflict_indices[i], conflict_indices[j]))
-            {
-              ++degrees[i];
-              ++degrees[j];
-              graph[i].push_back(j);
-              graph[j].push_back(i);
-            }
-
-      // Sort the vertices by decreasing degree.
-      std::vector<int>::iterator degrees_it;
+      // Two iterators that share indices are connected by an ''edge'' in
+      // the graph. Collect the vertices that share an index with each
+      // vertex, removing duplicates and the vertex itself. The degree of a
+      // vertex is then the number of its neighbors.
+      for (unsigned int begin=0, end=0; begin<indices_to_vertices.size(); begin=end)
+        {
+          while (end<indices_to_vertices.size() &&
+                 indices_to_vertices[end].first == indices_to_vertices[begin].first)
+            ++end;
+          for (unsigned int i=begin; i<end; ++i)
+            for (unsigned int j=begin; j<end; ++j)
+              if (indices_to_vertices[i].second != indices_to_vertices[j].second)
+                graph[indices_to_vertices[i].second].push_back(indices_to_vertices[j].second);
+        }
       for (unsigned int i=0; i<partition_size; ++i)
         {
-          // Find the largest element.
-          degrees_it = std::max_element(degrees.begin(),degrees.end());
-          sorted_vertices[i] = degrees_it-degrees.begin();
-          // Put the largest element to -1 so it cannot be chosen again.
-          *degrees_it = -1;
+          std::sort(graph[i].begin(), graph[i].end());
+          graph[i].erase(std::unique(graph[i].begin(), graph[i].end()),
+                         graph[i].end());
         }
 
-      // Color the graph.
-      std::vector<boost::unordered_set<unsigned int> > colors_used;
+      // Sort the vertices by decreasing degree, keeping the vertices with
+      // the same degree in their original order.
+      for (unsigned int i=0; i<partition_size; ++i)
+        sorted_vertices[i] = i;
+      std::stable_sort(sorted_vertices.begin(), sorted_vertices.end(),
+                       [&graph](const unsigned int a, const unsigned int b)
+      {
+        return graph[a].size() > graph[b].size();
+      });
+
+      // Color the graph. A vertex can use an existing color if none of the
+      // vertices linked to it already uses that color; otherwise it gets a
+      // new color.
+      const unsigned int uncolored = numbers::invalid_unsigned_int;
+      std::vector<unsigned int> vertex_colors(partition_size, uncolored);
+      std::vector<bool> color_is_used;
       for (unsigned int i=0; i<partition_size; ++i)
         {
           const unsigned int current_vertex(sorted_vertices[i]);
-          bool new_color(true);
-          // Try to use an existing color, i.e., try to find a color which is not
-          // associated to one of the vertices linked to current_vertex.
-          // Loop over the color.
-          for (unsigned int j=0; j<partition_coloring.size(); ++j)
-            {
-              // Loop on the vertices linked to current_vertex. If one vertex linked
-              // to current_vertex is already using the color j, this color cannot
-              // be used anymore.
-              bool unused_color(true);
-              for (unsigned int k=0; k<graph[current_vertex].size(); ++k)
-                if (colors_used[j].count(graph[current_vertex][k])==1)
-                  {
-                    unused_color = false;
-                    break;
-                  }
-              if (unused_color)
-                {
-                  partition_coloring[j].push_back(partition[current_vertex]);
-                  colors_used[j].insert(current_vertex);
-                  new_color = false;
-                  break;
-                }
-            }
-          // Add a new color.
-          if (new_color)
-            {
-              partition_coloring.push_back(std::vector<Iterator> (1,
-                                                                  partition[current_vertex]));
-              boost::unordered_set<unsigned int> tmp;
-              tmp.insert(current_vertex);
-              colors_used.push_back(tmp);
-            }
+
+          // Mark the colors used by the vertices linked to current_vertex,
+          // then pick the first color that is not marked
+          color_is_used.assign(partition_coloring.size(), false);
+          for (unsigned int k=0; k<graph[current_vertex].size(); ++k)
+            if (vertex_colors[graph[current_vertex][k]] != uncolored)
+              color_is_used[vertex_colors[graph[current_vertex][k]]] = true;
+
+          unsigned int color = 0;
+          while (color<partition_coloring.size() && color_is_used[color])
+            ++color;
+
+          // Add a new color if necessary.
+          if (color == partition_coloring.size())
+            partition_coloring.push_back(std::vector<Iterator>());
+
+          partition_coloring[color].push_back(partition[current_vertex]);
+          vertex_colors[current_vertex] = color;
         }
     }
 
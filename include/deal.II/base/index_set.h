@@ -182,6 +182,12 @@ public:
    * added
    * @param[in] end The past-the-end iterator for the range of elements to be
    * added. @pre The condition <code>begin@<=end</code> needs to be satisfied.
+   *
+   * The indices need not be sorted and may contain duplicates. They are
+   * collected into ranges of consecutive indices, which are sorted once and
+   * merged with the present indices in linear time. Thus, adding many
+   * indices at once, e.g. indices collected from several threads into one
+   * vector, is much faster than calling add_index() for each of them.
    */
   template <typename ForwardIterator>
   void add_indices (const ForwardIterator &begin,
@@ -253,6 +259,28 @@ public:
    */
   size_type index_within_set (const size_type global_index) const;
 
+  /**
+   * Return the global indices of all the local indices in @p local_indices,
+   * as computed by nth_index_in_set() for each of them, in @p global_indices,
+   * which is resized as needed. Each index is first looked up in the range
+   * of the previous index and the one following it, so sorted or clustered
+   * lists of indices are translated in constant time per index, and the
+   * binary search of nth_index_in_set() is only done for jumps between
+   * distant ranges.
+   */
+  void nth_index_in_set (const std::vector<size_type> &local_indices,
+                         std::vector<size_type>       &global_indices) const;
+
+  /**
+   * Return the positions within this set of all the global indices in
+   * @p global_indices, as computed by index_within_set() for each of them,
+   * in @p local_indices, which is resized as needed. As for the other
+   * function, sorted or clustered lists of indices are translated in
+   * constant time per index.
+   */
+  void index_within_set (const std::vector<size_type> &global_indices,
+                         std::vector<size_type>       &local_indices) const;
+
   /**
    * Each index set can be represented as the union of a number of contiguous
    * intervals of indices, where if necessary intervals may only consist of
@@ -862,6 +890,13 @@ private:
    * Actually perform the compress() operation.
    */
   void do_compress() const;
+
+  /**
+   * Add the ranges <tt>[first,second)</tt> given in @p tmp_ranges, sorting
+   * them first unless @p ranges_are_sorted is set.
+   */
+  void add_ranges_internal (std::vector<std::pair<size_type,size_type> > &tmp_ranges,
+                            const bool ranges_are_sorted);
 };
 
 
@@ -1597,8 +1632,14 @@ void
 IndexSet::add_indices (const ForwardIterator &begin,
                        const ForwardIterator &end)
 {
-  // insert each element of the range. if some of them happen to be
-  // consecutive, merge them to a range
+  if (begin == end)
+    return;
+
+  // identify ranges in the given iterator range by checking whether some
+  // indices happen to be consecutive, and add all of them at once instead
+  // of inserting each of them into the sorted list of ranges
+  std::vector<std::pair<size_type,size_type> > tmp_ranges;
+  bool ranges_are_sorted = true;
   for (ForwardIterator p=begin; p!=end;)
     {
       const size_type begin_index = *p;
@@ -1611,9 +1652,14 @@ IndexSet::add_indices (const ForwardIterator &begin,
           ++q;
         }
 
-      add_range (begin_index, end_index);
+      tmp_ranges.emplace_back (begin_index, end_index);
       p = q;
+
+      if (p != end && *p < end_index)
+        ranges_are_sorted = false;
     }
+
+  add_ranges_internal (tmp_ranges, ranges_are_sorted);
 }
 
 
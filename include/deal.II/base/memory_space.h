@@ -0,0 +1,47 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_memory_space_h
+#define dealii_memory_space_h
+
+#include <deal.II/base/config.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+/**
+ * The memory spaces in which the elements of vectors can reside. The structs
+ * of this namespace are only used as tags in template arguments, for example
+ * in LinearAlgebra::distributed::VectorInMemorySpace, so that the same code
+ * can work with data on the host or on the device by changing a single
+ * template argument.
+ */
+namespace MemorySpace
+{
+  /**
+   * Structure describing the host memory space.
+   */
+  struct Host
+  {};
+
+  /**
+   * Structure describing the memory of a CUDA device.
+   */
+  struct CUDA
+  {};
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,236 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_memory_tracker_h
+#define dealii_memory_tracker_h
+
+
+#include <deal.II/base/config.h>
+
+#include <atomic>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+#if defined(DEAL_II_WITH_MPI) || defined(DEAL_II_WITH_PETSC)
+#include <mpi.h>
+#else
+typedef int MPI_Comm;
+#  ifndef MPI_COMM_WORLD
+#    define MPI_COMM_WORLD 0
+#  endif
+#endif
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/**
+ * A namespace for recording the memory held by the arrays of deal.II, broken
+ * down by subsystem, together with the peak of the memory of each subsystem
+ * over the run of a program. Unlike the memory_consumption() functions of
+ * the individual classes, which return the memory of one object at the time
+ * of the call, and Utilities::System::get_memory_stats(), which only knows
+ * the total of the process, the tracker shows which part of a program the
+ * memory belongs to at the time the high-water mark is reached.
+ *
+ * Tracking is off by default and is switched on by calling enable(). From
+ * then on, the memory allocated and released by the following classes is
+ * recorded:
+ * - AlignedVector, and thus the Table classes and most of the data of
+ *   MatrixFree and of the finite element classes,
+ * - Vector,
+ * - LinearAlgebra::distributed::Vector.
+ *
+ * Each allocation is charged to the subsystem of the innermost Scope object
+ * that is alive on the allocating thread, or to the subsystem
+ * <code>"unassigned"</code> if there is none, and the memory is credited to
+ * the same subsystem when it is released, no matter where this happens.
+ * MatrixFree::reinit() opens the scope <code>"MatrixFree"</code>, user code
+ * opens its own scopes like TimerOutput::Scope objects:
+ * @code
+ *   MemoryTracker::enable();
+ *   {
+ *     MemoryTracker::Scope scope ("multigrid levels");
+ *     mg_matrices.resize (0, triangulation.n_global_levels()-1);
+ *     ...
+ *   }
+ *   ...
+ *   MemoryTracker::print_statistics (std::cout, MPI_COMM_WORLD);
+ * @endcode
+ * Scopes are a property of the thread that creates them: allocations made
+ * by tasks that are spawned within a scope run on other threads and are
+ * charged to the subsystems of the scopes alive there.
+ *
+ * Recording an allocation takes a lock and updates a map from the address
+ * of the array to its subsystem and size, so tracking is meant for the
+ * analysis of the memory of a program rather than for production runs. When
+ * tracking is disabled, the instrumented classes only check a flag.
+ *
+ * @ingroup utilities
+ */
+namespace MemoryTracker
+{
+  /**
+   * The memory recorded for one subsystem, or for all subsystems together.
+   */
+  struct Statistics
+  {
+    /**
+     * Constructor. Set all values to zero.
+     */
+    Statistics ();
+
+    /**
+     * The number of bytes currently allocated.
+     */
+    std::size_t current_bytes;
+
+    /**
+     * The largest value of @p current_bytes since the last call to enable()
+     * or reset_peaks().
+     */
+    std::size_t peak_bytes;
+
+    /**
+     * The number of allocations since the last call to enable().
+     */
+    std::size_t n_allocations;
+  };
+
+  /**
+   * Start recording allocations, discarding the statistics recorded so far.
+   * Arrays allocated before this call are not known to the tracker, and
+   * releasing them does not change the statistics.
+   */
+  void enable ();
+
+  /**
+   * Stop recording allocations. The statistics recorded so far are kept,
+   * but no longer updated.
+   */
+  void disable ();
+
+  /**
+   * Return whether allocations are currently recorded.
+   */
+  bool is_enabled ();
+
+  /**
+   * Record that @p size bytes have been allocated at @p ptr, charged to the
+   * subsystem of the innermost scope of the calling thread. Nothing is
+   * recorded if tracking is not enabled.
+   */
+  void record_allocation (const void       *ptr,
+                          const std::size_t size);
+
+  /**
+   * Record that the memory at @p ptr is released. Nothing happens if the
+   * allocation of @p ptr has not been recorded.
+   */
+  void record_deallocation (const void *ptr);
+
+  /**
+   * Record the release of @p ptr and release it with std::free(). This
+   * function has the signature of std::free() and is the deleter of the
+   * arrays of the vector classes, which are allocated with
+   * Utilities::System::posix_memalign().
+   */
+  void free (void *ptr) noexcept;
+
+  /**
+   * Set the peak of all subsystems to their current memory.
+   */
+  void reset_peaks ();
+
+  /**
+   * Return the statistics of the subsystem @p subsystem. If nothing has been
+   * recorded for it, all values are zero.
+   */
+  Statistics get_statistics (const std::string &subsystem);
+
+  /**
+   * Return the statistics of all subsystems together. The peak is the peak
+   * of the sum, which is usually smaller than the sum of the peaks.
+   */
+  Statistics get_total_statistics ();
+
+  /**
+   * Print a table with the current and the peak memory of each subsystem
+   * to @p out, in the format of TimerOutput::print_wall_time_statistics():
+   * the minimum, average and maximum over the processes of
+   * @p mpi_communicator, together with the ranks that hold the minimum and
+   * the maximum. The table ends with the total of all subsystems and the
+   * peak resident memory of the processes as given by
+   * Utilities::System::get_memory_stats(), whose difference to the total
+   * is the memory of the parts of the program that are not tracked.
+   *
+   * This is a collective operation on @p mpi_communicator. Only the process
+   * of rank zero writes to @p out.
+   */
+  void print_statistics (std::ostream   &out,
+                         const MPI_Comm &mpi_communicator);
+
+  /**
+   * A helper class that charges the allocations of the calling thread to
+   * the subsystem given to the constructor until it is destroyed,
+   * analogous to TimerOutput::Scope. Scopes can be nested, and the
+   * subsystem of the enclosing scope is restored by the destructor.
+   */
+  class Scope
+  {
+  public:
+    /**
+     * Constructor. Make @p subsystem the subsystem of the calling thread.
+     */
+    Scope (const std::string &subsystem);
+
+    /**
+     * Destructor. Restore the previous subsystem of the calling thread.
+     */
+    ~Scope ();
+
+  private:
+    /**
+     * The index of the subsystem that was active when this object was
+     * constructed.
+     */
+    const unsigned int previous_subsystem;
+  };
+
+
+  namespace internal
+  {
+    /**
+     * The flag that is returned by is_enabled().
+     */
+    extern std::atomic<bool> tracking_enabled;
+  }
+
+
+
+  /* ---------------- inline functions ----------------- */
+
+  inline
+  bool
+  is_enabled ()
+  {
+    return internal::tracking_enabled.load (std::memory_order_relaxed);
+  }
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
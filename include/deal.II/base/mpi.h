@@ -21,6 +21,8 @@
 
 #include <vector>
 #include <map>
+#include <memory>
+#include <string>
 
 #if !defined(DEAL_II_WITH_MPI) && !defined(DEAL_II_WITH_PETSC)
 // without MPI, we would still like to use
@@ -60,6 +62,8 @@ template <typename Number> class FullMatrix;
 //Forward type declaration to allow MPI sums over LAPACKFullMatrix<number> type
 template <typename Number> class LAPACKFullMatrix;
 
+class IndexSet;
+
 
 namespace Utilities
 {
@@ -109,6 +113,12 @@ namespace Utilities
      * something to the current processor. The resulting list is not sorted.
      * It may contain duplicate entries if processors enter the same
      * destination more than once in their destinations list.
+     *
+     * With MPI 3.0 or later, this function does not communicate the
+     * destinations of all processes, but sends an empty message to each
+     * destination with the algorithm described in
+     * internal::exchange_sparse(). The result is then sorted and does not
+     * contain duplicates.
      */
     std::vector<unsigned int>
     compute_point_to_point_communication_pattern (const MPI_Comm &mpi_comm,
@@ -129,6 +139,66 @@ namespace Utilities
      */
     MPI_Comm duplicate_communicator (const MPI_Comm &mpi_communicator);
 
+    /**
+     * Return the rank of the process that owns each of the elements of
+     * @p indices_to_look_up, in the order of the elements, where each process
+     * passes its locally owned indices in @p owned_indices. Elements owned by
+     * no process get numbers::invalid_unsigned_int. The index sets of the
+     * processes must be subsets of the same index space, and each index can
+     * only be owned by one process.
+     *
+     * Rather than gathering the index sets of all processes, this function
+     * sets up a distributed directory where the process with rank @p p keeps
+     * the owners of the indices in the @p p-th of equally sized chunks of
+     * the index space. Each process registers its owned indices with the
+     * keepers of the respective chunks and then queries the keepers of the
+     * chunks of the indices to look up, using some_to_some() for the
+     * messages. Thus, the amount of data sent and received by each process
+     * is proportional to the number of intervals of its index sets and the
+     * number of indices it keeps, but not to the number of processes.
+     *
+     * This function is collective over all processes of the
+     * @ref GlossMPICommunicator "communicator" @p comm.
+     */
+    std::vector<unsigned int>
+    compute_index_owner (const IndexSet &owned_indices,
+                         const IndexSet &indices_to_look_up,
+                         const MPI_Comm &comm);
+
+    /**
+     * Send the string @p data of the process with rank @p root_process to
+     * all other processes of @p mpi_communicator, where it replaces the
+     * previous content of @p data. Strings longer than the largest
+     * <code>int</code> are sent in several pieces.
+     *
+     * This function is collective over all processes of the
+     * @ref GlossMPICommunicator "communicator". If deal.II is not configured
+     * for use of MPI, it does nothing.
+     */
+    void broadcast (std::string        &data,
+                    const MPI_Comm     &mpi_communicator,
+                    const unsigned int  root_process = 0);
+
+    /**
+     * Read the file @p filename on the process with rank @p root_process
+     * only and return its contents on all processes of
+     * @p mpi_communicator. Compared to all processes opening the same
+     * file, this avoids a large number of simultaneous requests to the
+     * metadata servers of parallel file systems, which can take minutes at
+     * the startup of jobs with thousands of processes. The argument
+     * @p filename is only used on the process @p root_process.
+     *
+     * If the file can not be opened, an exception is thrown on all
+     * processes.
+     *
+     * This function is collective over all processes of the
+     * @ref GlossMPICommunicator "communicator". If deal.II is not configured
+     * for use of MPI, it simply reads the file.
+     */
+    std::string read_file_and_broadcast (const std::string  &filename,
+                                         const MPI_Comm     &mpi_communicator,
+                                         const unsigned int  root_process = 0);
+
     /**
      * Return the sum over all processors of the value @p t. This function is
      * collective over all processors given in the
@@ -504,6 +574,12 @@ namespace Utilities
      * @return A map from the rank (unsigned int) of the process
      *  which sent the data and object received.
      *
+     * With MPI 3.0 or later, the receivers determine their senders by the
+     * non-blocking consensus algorithm described in
+     * internal::exchange_sparse(), so that the cost of this function only
+     * depends on the number of messages and not on the size of the
+     * communicator.
+     *
      * @author Giovanni Alzetta, Luca Heltai, 2017
      */
     template <typename T>
@@ -532,6 +608,110 @@ namespace Utilities
                const T        &object_to_send);
 
 
+    /**
+     * An object that represents a sum over all processors that has been
+     * started by isum() but that has not necessarily completed yet. The
+     * result can be queried with get(), which waits for the completion of
+     * the communication if necessary. In the meantime, the calling process
+     * can continue with local work, e.g., the application of a
+     * preconditioner, in order to hide the latency of the global
+     * communication.
+     *
+     * Objects of this type can be moved but not copied. If an object is
+     * destroyed while the communication is still in flight, the destructor
+     * waits for its completion.
+     *
+     * The template argument must be one of the types for which
+     * Utilities::MPI::sum() is implemented.
+     */
+    template <typename T>
+    class ReductionFuture
+    {
+    public:
+      /**
+       * Constructor. Create an object that does not represent any
+       * communication. Calling get() on it is not allowed.
+       */
+      ReductionFuture ();
+
+      /**
+       * Constructor. Create an object that represents an operation that has
+       * already completed with the given result. This is useful for
+       * situations where no communication is necessary, e.g., when running
+       * on a single processor.
+       */
+      explicit
+      ReductionFuture (const T &result);
+
+      /**
+       * Move constructor.
+       */
+      ReductionFuture (ReductionFuture<T> &&other) = default;
+
+      /**
+       * Move assignment. If the current object represents an operation that
+       * has not completed yet, wait for its completion first.
+       */
+      ReductionFuture<T> &operator = (ReductionFuture<T> &&other);
+
+      /**
+       * Destructor. Wait for the completion of the communication if
+       * necessary.
+       */
+      ~ReductionFuture ();
+
+      /**
+       * Return whether the communication has completed, i.e., whether a
+       * call to get() will return without waiting. This function does not
+       * block.
+       */
+      bool is_ready () const;
+
+      /**
+       * Wait for the completion of the communication.
+       */
+      void wait ();
+
+      /**
+       * Wait for the completion of the communication and return the sum
+       * over all processors.
+       */
+      T get ();
+
+    private:
+      /**
+       * The data of the operation. It is stored on the heap because MPI
+       * accesses the send and receive buffers until the operation has
+       * completed, and their address must not change when the object is
+       * moved.
+       */
+      struct Data;
+      std::unique_ptr<Data> data;
+
+      template <typename T2>
+      friend ReductionFuture<T2> isum (const T2 &, const MPI_Comm &);
+    };
+
+    /**
+     * Start the computation of the sum over all processors of the value @p
+     * t and return an object from which the result can be obtained once it
+     * is needed. This is the non-blocking variant of sum() and corresponds
+     * to the <code>MPI_Iallreduce</code> function. Like sum(), this function
+     * is collective over all processors of the given
+     * @ref GlossMPICommunicator "communicator",
+     * and all processors must start the non-blocking collective operations
+     * on a communicator in the same order.
+     *
+     * If the MPI implementation does not support MPI-3, the sum is computed
+     * with a blocking call to <code>MPI_Allreduce</code> and the returned
+     * object already contains the result.
+     */
+    template <typename T>
+    ReductionFuture<T>
+    isum (const T        &t,
+          const MPI_Comm &mpi_communicator);
+
+
 #ifndef DOXYGEN
     // declaration for an internal function that lives in mpi.templates.h
     namespace internal
@@ -541,6 +721,23 @@ namespace Utilities
                        const ArrayView<const T> &values,
                        const MPI_Comm           &mpi_communicator,
                        const ArrayView<T>       &output);
+
+      /**
+       * Send each of the buffers of characters in @p buffers_to_send to the
+       * process given by its key, and return the buffers received from other
+       * processes, keyed by the rank of the sender. Each process may send at
+       * most one buffer to another process. The receivers need not know in
+       * advance who sends to them: the function uses the non-blocking
+       * consensus (NBX) algorithm of Hoefler, Siebert, and Lumsdaine, where the
+       * buffers are sent with synchronous sends and every process receives
+       * whatever arrives until a non-blocking barrier, which each process
+       * enters once its own sends have been received, completes. Thus, the
+       * cost only depends on the number of messages and the logarithm of the
+       * number of processes. Only available for MPI 3.0 or later.
+       */
+      std::map<unsigned int, std::vector<char> >
+      exchange_sparse (const MPI_Comm                                   &comm,
+                       const std::map<unsigned int, std::vector<char> > &buffers_to_send);
     }
 
     // Since these depend on N they must live in the header file
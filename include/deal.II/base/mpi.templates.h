@@ -19,6 +19,7 @@
 #include <deal.II/base/config.h>
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/mpi.h>
+#include <deal.II/base/numbers.h>
 #include <deal.II/base/tensor.h>
 #include <deal.II/base/symmetric_tensor.h>
 #include <deal.II/lac/vector.h>
@@ -201,17 +202,33 @@ namespace Utilities
       Assert(objects_to_send.find(0) != objects_to_send.end() || objects_to_send.size() == 0,
              ExcMessage("Can only send to myself or to nobody."));
       return objects_to_send;
+#elif MPI_VERSION >= 3
+      // let the receivers find out about their messages by the non-blocking
+      // consensus algorithm rather than by a collective operation
+      std::map<unsigned int, std::vector<char> > buffers_to_send;
+      for (const auto &rank_obj : objects_to_send)
+        buffers_to_send[rank_obj.first]
+          = Utilities::pack(rank_obj.second, Utilities::no_compression);
+
+      const std::map<unsigned int, std::vector<char> > received_buffers
+        = internal::exchange_sparse (comm, buffers_to_send);
+
+      std::map<unsigned int, T> received_objects;
+      for (const auto &rank_buffer : received_buffers)
+        received_objects[rank_buffer.first]
+          = Utilities::unpack<T>(rank_buffer.second, Utilities::no_compression);
+
+      return received_objects;
 #else
       const auto n_procs = dealii::Utilities::MPI::n_mpi_processes(comm);
       const auto my_proc = dealii::Utilities::MPI::this_mpi_process(comm);
 
-      std::vector<unsigned int> send_to(objects_to_send.size());
-      {
-        unsigned int i=0;
-        for (const auto &m: objects_to_send)
-          send_to[i++] = m.first;
-      }
-      AssertDimension(send_to.size(), objects_to_send.size());
+      // an object sent to the own process is copied directly
+      std::vector<unsigned int> send_to;
+      send_to.reserve(objects_to_send.size());
+      for (const auto &m: objects_to_send)
+        if (m.first != my_proc)
+          send_to.push_back(m.first);
 
       const auto receive_from =
         Utilities::MPI::compute_point_to_point_communication_pattern(comm, send_to);
@@ -224,7 +241,9 @@ namespace Utilities
         for (const auto &rank_obj : objects_to_send)
           {
             const auto &rank = rank_obj.first;
-            buffers_to_send[i] = Utilities::pack(rank_obj.second);
+            if (rank == my_proc)
+              continue;
+            buffers_to_send[i] = Utilities::pack(rank_obj.second, Utilities::no_compression);
             const int ierr = MPI_Isend(buffers_to_send[i].data(),
                                        buffers_to_send[i].size(), MPI_CHAR,
                                        rank, 21, comm, &buffer_send_requests[i]);
@@ -235,6 +254,8 @@ namespace Utilities
 
       // Receiving buffers
       std::map<unsigned int, T> received_objects;
+      if (objects_to_send.find(my_proc) != objects_to_send.end())
+        received_objects[my_proc] = objects_to_send.find(my_proc)->second;
       {
         std::vector<char> buffer;
         // We do this on a first come/first served basis
@@ -260,7 +281,7 @@ namespace Utilities
             AssertThrowMPI(ierr);
             Assert(received_objects.find(rank) == received_objects.end(),
                    ExcInternalError("I should not receive again from this rank"));
-            received_objects[rank] = Utilities::unpack<T>(buffer);
+            received_objects[rank] = Utilities::unpack<T>(buffer, Utilities::no_compression);
           }
       }
 
@@ -284,7 +305,7 @@ namespace Utilities
 #else
       const auto n_procs = dealii::Utilities::MPI::n_mpi_processes(comm);
 
-      std::vector<char> buffer = Utilities::pack(object);
+      std::vector<char> buffer = Utilities::pack(object, Utilities::no_compression);
 
       int n_local_data = buffer.size();
 
@@ -315,7 +336,7 @@ namespace Utilities
         {
           std::vector<char> local_buffer(received_unrolled_buffer.begin()+rdispls[i],
                                          received_unrolled_buffer.begin()+rdispls[i]+size_all_data[i]);
-          received_objects[i] = Utilities::unpack<T>(local_buffer);
+          received_objects[i] = Utilities::unpack<T>(local_buffer, Utilities::no_compression);
         }
 
       return received_objects;
@@ -484,6 +505,140 @@ namespace Utilities
       internal::all_reduce(MPI_MIN, ArrayView<const T>(values),
                            mpi_communicator, ArrayView<T> (minima));
     }
+
+
+
+    template <typename T>
+    struct ReductionFuture<T>::Data
+    {
+      T    local_value;
+      T    result;
+      bool is_complete;
+#ifdef DEAL_II_WITH_MPI
+      MPI_Request request;
+#endif
+    };
+
+
+
+    template <typename T>
+    ReductionFuture<T>::ReductionFuture ()
+    {}
+
+
+
+    template <typename T>
+    ReductionFuture<T>::ReductionFuture (const T &result)
+      :
+      data (new Data())
+    {
+      data->local_value = result;
+      data->result = result;
+      data->is_complete = true;
+    }
+
+
+
+    template <typename T>
+    ReductionFuture<T> &
+    ReductionFuture<T>::operator = (ReductionFuture<T> &&other)
+    {
+      if (data)
+        wait();
+      data = std::move(other.data);
+      return *this;
+    }
+
+
+
+    template <typename T>
+    ReductionFuture<T>::~ReductionFuture ()
+    {
+#ifdef DEAL_II_WITH_MPI
+      // do not throw from the destructor, but the request must be completed
+      // before the buffers go away
+      if (data && !data->is_complete)
+        MPI_Wait (&data->request, MPI_STATUS_IGNORE);
+#endif
+    }
+
+
+
+    template <typename T>
+    bool
+    ReductionFuture<T>::is_ready () const
+    {
+      Assert (data, ExcMessage("This object does not represent any operation."));
+#ifdef DEAL_II_WITH_MPI
+      if (!data->is_complete)
+        {
+          int flag = 0;
+          const int ierr = MPI_Test (&data->request, &flag, MPI_STATUS_IGNORE);
+          AssertThrowMPI(ierr);
+          data->is_complete = (flag != 0);
+        }
+#endif
+      return data->is_complete;
+    }
+
+
+
+    template <typename T>
+    void
+    ReductionFuture<T>::wait ()
+    {
+      Assert (data, ExcMessage("This object does not represent any operation."));
+#ifdef DEAL_II_WITH_MPI
+      if (!data->is_complete)
+        {
+          const int ierr = MPI_Wait (&data->request, MPI_STATUS_IGNORE);
+          AssertThrowMPI(ierr);
+          data->is_complete = true;
+        }
+#endif
+    }
+
+
+
+    template <typename T>
+    T
+    ReductionFuture<T>::get ()
+    {
+      wait ();
+      return data->result;
+    }
+
+
+
+    template <typename T>
+    ReductionFuture<T>
+    isum (const T        &t,
+          const MPI_Comm &mpi_communicator)
+    {
+#if defined(DEAL_II_WITH_MPI) && MPI_VERSION >= 3
+      if (job_supports_mpi())
+        {
+          // like in all_reduce(), sum complex numbers by their real and
+          // imaginary parts
+          typedef typename numbers::NumberTraits<T>::real_type real_type;
+
+          ReductionFuture<T> future;
+          future.data.reset (new typename ReductionFuture<T>::Data());
+          future.data->local_value = t;
+          future.data->is_complete = false;
+          const int ierr = MPI_Iallreduce (&future.data->local_value,
+                                           &future.data->result,
+                                           static_cast<int>(sizeof(T)/sizeof(real_type)),
+                                           internal::mpi_type_id(static_cast<real_type *>(nullptr)),
+                                           MPI_SUM,
+                                           mpi_communicator,
+                                           &future.data->request);
+          AssertThrowMPI(ierr);
+          return future;
+        }
+#endif
+      return ReductionFuture<T> (sum (t, mpi_communicator));
+    }
   } // end of namespace MPI
 } // end of namespace Utilities
 
@@ -22,6 +22,9 @@
 #include <deal.II/base/types.h>
 #include <deal.II/base/exceptions.h>
 
+#include <cstddef>
+#include <functional>
+
 DEAL_II_NAMESPACE_OPEN
 
 /**
@@ -101,6 +104,138 @@ public:
    */
   static bool is_running_single_threaded ();
 
+  /**
+   * Select whether memory that is newly allocated by Vector,
+   * LinearAlgebra::distributed::Vector, and AlignedVector is always
+   * initialized in parallel, even if the caller asked to omit the
+   * initialization. The initialization uses the same loop partitioning as
+   * the subsequent vector operations, so that on systems with non-uniform
+   * memory access (NUMA), the memory pages are placed close to the threads
+   * that later work on them ("first touch"). Otherwise, the pages of a vector
+   * that is not zeroed upon allocation are placed by the first operation
+   * writing into them, which might be a sequential one.
+   *
+   * This setting is off by default since it adds a pass through the memory
+   * on each allocation that is not needed on systems with a single memory
+   * domain.
+   */
+  static void set_parallel_first_touch (const bool parallel_first_touch);
+
+  /**
+   * Return whether newly allocated memory of vectors is initialized in
+   * parallel, as set by set_parallel_first_touch().
+   */
+  static bool use_parallel_first_touch ();
+
+  /**
+   * Policies for the placement of the threads of the TBB onto the cores of
+   * the system, see set_thread_affinity().
+   */
+  enum ThreadAffinity
+  {
+    /**
+     * Do not pin the threads, i.e., let the operating system move them
+     * between all cores the process may run on.
+     */
+    no_pinning,
+
+    /**
+     * Pin the threads to the cores in the order of the processor packages
+     * (sockets), filling a package before continuing with the next one.
+     */
+    compact,
+
+    /**
+     * Pin the threads to the cores in a round-robin fashion over the
+     * processor packages, such that the threads and thus the memory bandwidth
+     * are spread over all packages.
+     */
+    scatter
+  };
+
+  /**
+   * Pin the threads of the TBB, including the calling thread, to single
+   * cores according to the given @p policy. Only the cores that the process
+   * is allowed to run on at the first call of this function are used, such
+   * that the binding of the process set by the MPI launcher (e.g., one MPI
+   * rank per socket with <tt>mpirun --bind-to socket</tt>) is respected and
+   * each rank pins its threads within its own part of the machine. Threads
+   * of the TBB are pinned as they enter the task scheduler; if there are
+   * more threads than cores the cores are used several times.
+   *
+   * Since the pages of a vector are placed in the memory close to the core
+   * that first touches them, pinning makes the placement by
+   * set_parallel_first_touch() persistent over the lifetime of the vector.
+   *
+   * This function is only implemented for Linux; on other systems and
+   * without multithreading support in deal.II, it only stores the policy.
+   */
+  static void set_thread_affinity (const ThreadAffinity policy);
+
+  /**
+   * Return the policy set by set_thread_affinity().
+   */
+  static ThreadAffinity get_thread_affinity ();
+
+  /**
+   * The type of a function that runs a parallel loop on behalf of the
+   * library. It is called with arguments <tt>(begin, end, grainsize,
+   * body)</tt> and must call <tt>body(lower, upper)</tt> on disjoint
+   * subranges <tt>[lower,upper)</tt> that together cover <tt>[begin,end)</tt>,
+   * possibly concurrently, and where each subrange should contain at least
+   * @p grainsize elements. It may only return once all calls of @p body are
+   * done.
+   */
+  typedef std::function<void (const std::size_t,
+                              const std::size_t,
+                              const std::size_t,
+                              const std::function<void (const std::size_t,
+                                                        const std::size_t)> &)>
+  LoopBackend;
+
+  /**
+   * Replace the Threading Building Blocks in the parallel loops of the
+   * library by the given function. This concerns
+   * parallel::apply_to_subranges(), parallel::accumulate_from_subranges(),
+   * parallel::ParallelForInteger and the operations of Vector and
+   * LinearAlgebra::distributed::Vector. Furthermore, while a loop backend is
+   * set, Threads::new_task() runs the given function immediately on the
+   * calling thread rather than as a TBB task. This is useful if deal.II
+   * functions are called from a program parallelized with another threading
+   * model, like OpenMP, since the thread pools of the TBB and of the other
+   * model would otherwise compete for the same cores. For example, OpenMP
+   * programs may use the following backend, compiled as part of the user
+   * program with OpenMP enabled:
+   * @code
+   *   MultithreadInfo::set_loop_backend
+   *   ([](const std::size_t begin,
+   *       const std::size_t end,
+   *       const std::size_t grainsize,
+   *       const std::function<void (const std::size_t,
+   *                                 const std::size_t)> &body)
+   *   {
+   *     const std::size_t n_chunks = (end-begin+grainsize-1)/grainsize;
+   *     #pragma omp parallel for if (!omp_in_parallel() && n_chunks > 1)
+   *     for (std::size_t c=0; c<n_chunks; ++c)
+   *       body (begin+c*grainsize, std::min(begin+(c+1)*grainsize, end));
+   *   });
+   * @endcode
+   * Similarly, a backend can forward to the parallel algorithms of C++17
+   * with <tt>std::for_each(std::execution::par, ...)</tt> over the chunks.
+   *
+   * Passing an empty function object restores the default of using the
+   * TBB. The loop backend must not be changed while parallel loops of the
+   * library are running. Without multithreading support in deal.II, all
+   * loops run sequentially and the loop backend is ignored.
+   */
+  static void set_loop_backend (const LoopBackend &loop_backend);
+
+  /**
+   * Return the function set by set_loop_backend(), or an empty function
+   * object if the loops use the TBB.
+   */
+  static const LoopBackend &get_loop_backend ();
+
 private:
 
   /**
@@ -120,6 +255,21 @@ private:
    * by get_n_cpus() and is returned by n_cores().
    */
   static const unsigned int n_cpus;
+
+  /**
+   * Variable storing the setting of set_parallel_first_touch().
+   */
+  static bool parallel_first_touch;
+
+  /**
+   * Variable storing the setting of set_thread_affinity().
+   */
+  static ThreadAffinity thread_affinity;
+
+  /**
+   * Variable storing the setting of set_loop_backend().
+   */
+  static LoopBackend loop_backend;
 };
 
 
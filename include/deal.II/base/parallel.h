@@ -19,14 +19,17 @@
 
 #include <deal.II/base/config.h>
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/multithread_info.h>
 #include <deal.II/base/template_constraints.h>
 #include <deal.II/base/synchronous_iterator.h>
 #include <deal.II/base/thread_management.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <tuple>
 #include <memory>
 #include <functional>
+#include <vector>
 
 #ifdef DEAL_II_WITH_THREADS
 #  include <tbb/parallel_for.h>
@@ -433,6 +436,17 @@ namespace parallel
     ff (begin, end);
 #  endif
 #else
+    if (MultithreadInfo::get_loop_backend())
+      {
+        MultithreadInfo::get_loop_backend()
+        (0, static_cast<std::size_t>(end-begin), grainsize,
+         [&](const std::size_t lower, const std::size_t upper)
+        {
+          f (begin+lower, begin+upper);
+        });
+        return;
+      }
+
     tbb::parallel_for (tbb::blocked_range<RangeType>
                        (begin, end, grainsize),
                        std::bind (&internal::apply_to_subranges<RangeType,Function>,
@@ -674,6 +688,34 @@ namespace parallel
     return ff (begin, end);
 #  endif
 #else
+    if (MultithreadInfo::get_loop_backend())
+      {
+        // split the range into a fixed number of chunks and let the
+        // backend work on them, adding up the results of the chunks
+        // afterwards
+        const std::size_t n_elements = end-begin;
+        const std::size_t chunk_size
+          = std::max<std::size_t>(std::max(grainsize, 1U),
+                                  (n_elements+4*MultithreadInfo::n_threads()-1)/
+                                  (4*MultithreadInfo::n_threads()));
+        const std::size_t n_chunks = std::max<std::size_t>
+                                     (1, (n_elements+chunk_size-1)/chunk_size);
+        std::vector<ResultType> chunk_results (n_chunks, ResultType(0));
+        MultithreadInfo::get_loop_backend()
+        (0, n_chunks, 1,
+         [&](const std::size_t lower, const std::size_t upper)
+        {
+          for (std::size_t c=lower; c<upper; ++c)
+            chunk_results[c]
+              = f (begin+c*chunk_size,
+                   begin+std::min(n_elements, (c+1)*chunk_size));
+        });
+        ResultType result = chunk_results[0];
+        for (std::size_t c=1; c<n_chunks; ++c)
+          result += chunk_results[c];
+        return result;
+      }
+
     internal::ReductionOnSubranges<ResultType,Function>
     reductor (f, std::plus<ResultType>(), 0);
     tbb::parallel_reduce (tbb::blocked_range<RangeType>(begin, end, grainsize),
@@ -856,6 +898,17 @@ namespace parallel
 
     apply_to_subrange (begin, end);
 #else
+    if (MultithreadInfo::get_loop_backend())
+      {
+        MultithreadInfo::get_loop_backend()
+        (begin, end, minimum_parallel_grain_size,
+         [this](const std::size_t lower, const std::size_t upper)
+        {
+          apply_to_subrange (lower, upper);
+        });
+        return;
+      }
+
     internal::ParallelForWrapper worker(*this);
     tbb::parallel_for (tbb::blocked_range<std::size_t>
                        (begin, end, minimum_parallel_grain_size),
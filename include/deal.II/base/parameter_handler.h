@@ -19,6 +19,7 @@
 
 #include <deal.II/base/config.h>
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
 #include <deal.II/base/subscriptor.h>
 #include <deal.II/base/patterns.h>
 
@@ -943,6 +944,26 @@ public:
   virtual void parse_input (const std::string &filename,
                             const std::string &last_line = "");
 
+  /**
+   * Parse the given file as the previous function does, but for all
+   * processes of @p mpi_communicator at once: Only the process with rank
+   * zero searches the file using the PathSearch class "PARAMETERS" and
+   * reads it, and then sends its contents to the other processes.
+   * Every process then parses the contents by the parse_input() function
+   * that takes a stream. This avoids that thousands of processes access the
+   * same file at the same time at the start of a parallel program, which
+   * puts a heavy load on the metadata servers of parallel file systems.
+   *
+   * If the file can not be found on the first process, a
+   * PathSearch::ExcFileNotFound exception is thrown on all processes.
+   *
+   * This function is collective over all processes of the
+   * @ref GlossMPICommunicator "communicator".
+   */
+  void parse_input (const std::string &filename,
+                    const MPI_Comm    &mpi_communicator,
+                    const std::string &last_line = "");
+
   /**
    * Parse input from a string to populate known parameter fields. The lines
    * in the string must be separated by <tt>@\n</tt> characters.
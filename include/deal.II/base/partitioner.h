@@ -357,6 +357,25 @@ namespace Utilities
        */
       bool ghost_indices_initialized() const;
 
+      /**
+       * Select whether the LinearAlgebra::distributed::Vector objects using
+       * this partitioner exchange their ghost values in
+       * LinearAlgebra::distributed::Vector::update_ghost_values() through
+       * persistent MPI requests, see export_to_ghosted_array_init(). This
+       * pays off for vectors whose ghost values are updated many times, e.g.
+       * in the matrix-vector products of an iterative solver, at the cost of
+       * keeping the MPI requests of every vector allocated. The default is
+       * @p false. The setting must be made before the vectors start
+       * communicating.
+       */
+      void set_persistent_communication (const bool use_persistent_requests);
+
+      /**
+       * Return whether persistent MPI requests are used for the export to
+       * ghost entries, as set by set_persistent_communication().
+       */
+      bool use_persistent_communication () const;
+
 #ifdef DEAL_II_WITH_MPI
       /**
        * Starts the exports of the data in a locally owned array to the range
@@ -389,10 +408,18 @@ namespace Utilities
        * communication that will be finalized in the
        * export_to_ghosted_array_finish() call.
        *
+       * The template argument @p TransferNumber selects the type in which the
+       * data is sent, e.g. @p float for a @p double array in order to halve
+       * the volume of the messages when the full accuracy of the ghost values
+       * is not needed. The data is converted in place in @p
+       * temporary_storage and @p ghost_array, so the size of @p
+       * TransferNumber must not exceed the size of @p Number, and the same
+       * type must be given to export_to_ghosted_array_finish().
+       *
        * This functionality is used in
        * LinearAlgebra::distributed::Vector::update_ghost_values().
        */
-      template <typename Number>
+      template <typename Number, typename TransferNumber = Number>
       void
       export_to_ghosted_array_start(const unsigned int              communication_channel,
                                     const ArrayView<const Number>  &locally_owned_array,
@@ -414,14 +441,64 @@ namespace Utilities
        * export_to_ghosted_array_start() call. This must be the same array as
        * passed to that function, otherwise MPI will likely throw an error.
        *
+       * The template argument @p TransferNumber must be the same as given to
+       * export_to_ghosted_array_start().
+       *
        * This functionality is used in
        * LinearAlgebra::distributed::Vector::update_ghost_values().
        */
-      template <typename Number>
+      template <typename Number, typename TransferNumber = Number>
       void
       export_to_ghosted_array_finish(const ArrayView<Number>  &ghost_array,
                                      std::vector<MPI_Request> &requests) const;
 
+      /**
+       * Set up persistent MPI requests for the export of the data in a
+       * locally owned array to the range described by the ghost indices of
+       * this class, i.e., the same data transfer as done by
+       * export_to_ghosted_array_start() and export_to_ghosted_array_finish().
+       * The send and receive operations are created once by MPI_Send_init()
+       * and MPI_Recv_init() and bound to the memory locations of @p
+       * temporary_storage and @p ghost_array. They can then be started as
+       * often as desired by export_to_ghosted_array_start_persistent() and be
+       * completed by export_to_ghosted_array_finish_persistent(), which saves
+       * the setup of the messages in the MPI library for every exchange.
+       *
+       * The arguments have the same meaning as for
+       * export_to_ghosted_array_start(). The requests are owned by the
+       * caller, who must release them with MPI_Request_free() once the arrays
+       * are deallocated or the communication is not needed any more.
+       */
+      template <typename Number>
+      void
+      export_to_ghosted_array_init(const unsigned int        communication_channel,
+                                   const ArrayView<Number>  &temporary_storage,
+                                   const ArrayView<Number>  &ghost_array,
+                                   std::vector<MPI_Request> &requests) const;
+
+      /**
+       * Pack the data to be sent from @p locally_owned_array into @p
+       * temporary_storage and start the persistent requests set up by
+       * export_to_ghosted_array_init(). @p temporary_storage must be the same
+       * array as passed to that function.
+       */
+      template <typename Number>
+      void
+      export_to_ghosted_array_start_persistent(const ArrayView<const Number> &locally_owned_array,
+                                               const ArrayView<Number>       &temporary_storage,
+                                               std::vector<MPI_Request>      &requests) const;
+
+      /**
+       * Wait for the communication started by
+       * export_to_ghosted_array_start_persistent() to complete. As opposed to
+       * export_to_ghosted_array_finish(), the @p requests are kept for the
+       * next exchange.
+       */
+      template <typename Number>
+      void
+      export_to_ghosted_array_finish_persistent(const ArrayView<Number>  &ghost_array,
+                                                std::vector<MPI_Request> &requests) const;
+
       /**
        * Starts importing the data on an array indexed by the ghost indices of
        * this class that is later accumulated into a locally owned array with
@@ -598,6 +675,18 @@ namespace Utilities
        */
       std::vector<unsigned int> import_indices_chunks_by_rank_data;
 
+#ifdef DEAL_II_WITH_MPI
+      /**
+       * In case only the ghost indices of a subset were received into an
+       * array sized for the larger set of ghost indices, move the data from
+       * the end of the array to the correct positions and delete the old
+       * content. Used in export_to_ghosted_array_finish().
+       */
+      template <typename Number>
+      void
+      move_ghost_data_to_larger_set(const ArrayView<Number> &ghost_array) const;
+#endif
+
       /**
        * Caches the number of ghost indices in a larger set of indices given by
        * the optional argument to set_ghost_indices().
@@ -636,6 +725,12 @@ namespace Utilities
        * Stores whether the ghost indices have been explicitly set.
        */
       bool have_ghost_indices;
+
+      /**
+       * Stores whether vectors should use persistent MPI requests for
+       * exporting data to ghost entries.
+       */
+      bool persistent_communication;
     };
 
 
@@ -847,6 +942,24 @@ namespace Utilities
       return have_ghost_indices;
     }
 
+
+
+    inline
+    void
+    Partitioner::set_persistent_communication(const bool use_persistent_requests)
+    {
+      persistent_communication = use_persistent_requests;
+    }
+
+
+
+    inline
+    bool
+    Partitioner::use_persistent_communication() const
+    {
+      return persistent_communication;
+    }
+
 #endif  // ifndef DOXYGEN
 
   } // end of namespace MPI
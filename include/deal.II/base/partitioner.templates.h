@@ -17,9 +17,11 @@
 #define dealii_partitioner_templates_h
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/event_trace.h>
 #include <deal.II/base/partitioner.h>
 #include <deal.II/lac/la_parallel_vector.h>
 
+#include <cstring>
 #include <type_traits>
 
 
@@ -34,7 +36,7 @@ namespace Utilities
 
 #ifdef DEAL_II_WITH_MPI
 
-    template <typename Number>
+    template <typename Number, typename TransferNumber>
     void
     Partitioner::export_to_ghosted_array_start(const unsigned int             communication_channel,
                                                const ArrayView<const Number> &locally_owned_array,
@@ -42,6 +44,8 @@ namespace Utilities
                                                const ArrayView<Number>       &ghost_array,
                                                std::vector<MPI_Request>      &requests) const
     {
+      EventTrace::Scope trace_scope ("export_to_ghosted_array_start", "MPI");
+
       AssertDimension(locally_owned_array.size(), local_size());
       AssertDimension(temporary_storage.size(), n_import_indices());
       Assert(ghost_array.size() == n_ghost_indices() ||
@@ -49,6 +53,11 @@ namespace Utilities
              ExcGhostIndexArrayHasWrongSize(ghost_array.size(), n_ghost_indices(),
                                             n_ghost_indices_in_larger_set));
 
+      static_assert(sizeof(TransferNumber) <= sizeof(Number),
+                    "The data is transferred in place of the vector entries, "
+                    "so the transfer type must not be larger than the "
+                    "vector type.");
+
       const unsigned int n_import_targets = import_targets_data.size();
       const unsigned int n_ghost_targets = ghost_targets_data.size();
 
@@ -78,7 +87,7 @@ namespace Utilities
           // allow writing into ghost indices even though we are in a
           // const function
           const int ierr = MPI_Irecv (ghost_array_ptr,
-                                      ghost_targets_data[i].second*sizeof(Number),
+                                      ghost_targets_data[i].second*sizeof(TransferNumber),
                                       MPI_BYTE,
                                       ghost_targets_data[i].first,
                                       ghost_targets_data[i].first + communication_channel,
@@ -96,14 +105,29 @@ namespace Utilities
           my_imports = import_indices_data.begin()+import_indices_chunks_by_rank_data[i],
           end_my_imports = import_indices_data.begin()+import_indices_chunks_by_rank_data[i+1];
           unsigned int index = 0;
-          for ( ; my_imports!= end_my_imports; ++my_imports)
-            for (unsigned int j=my_imports->first; j<my_imports->second; j++)
-              temp_array_ptr[index++] = locally_owned_array[j];
+          if (std::is_same<Number,TransferNumber>::value)
+            for ( ; my_imports!= end_my_imports; ++my_imports)
+              for (unsigned int j=my_imports->first; j<my_imports->second; j++)
+                temp_array_ptr[index++] = locally_owned_array[j];
+          else
+            {
+              // convert the data and store it densely at the beginning of
+              // the section of this target, which leaves the layout of the
+              // messages in the temporary storage unchanged
+              char *transfer_ptr = reinterpret_cast<char *>(temp_array_ptr);
+              for ( ; my_imports!= end_my_imports; ++my_imports)
+                for (unsigned int j=my_imports->first; j<my_imports->second; j++)
+                  {
+                    const TransferNumber value = static_cast<TransferNumber>(locally_owned_array[j]);
+                    std::memcpy(transfer_ptr + sizeof(TransferNumber)*(index++),
+                                &value, sizeof(TransferNumber));
+                  }
+            }
           AssertDimension(index, import_targets_data[i].second);
 
           // start the send operations
           const int ierr = MPI_Isend (temp_array_ptr,
-                                      import_targets_data[i].second*sizeof(Number),
+                                      import_targets_data[i].second*sizeof(TransferNumber),
                                       MPI_BYTE,
                                       import_targets_data[i].first,
                                       my_pid + communication_channel,
@@ -116,11 +140,179 @@ namespace Utilities
 
 
 
-    template <typename Number>
+    template <typename Number, typename TransferNumber>
     void
     Partitioner::export_to_ghosted_array_finish(const ArrayView<Number>  &ghost_array,
                                                 std::vector<MPI_Request> &requests) const
     {
+      EventTrace::Scope trace_scope ("export_to_ghosted_array_finish", "MPI");
+
+      // the wait and the rearrangement of the data are the same as for
+      // persistent requests, the only difference is that the requests are
+      // released by MPI once they have completed
+      if (std::is_same<Number,TransferNumber>::value)
+        {
+          export_to_ghosted_array_finish_persistent(ghost_array, requests);
+          requests.resize(0);
+          return;
+        }
+
+      Assert(ghost_array.size() == n_ghost_indices() ||
+             ghost_array.size() == n_ghost_indices_in_larger_set,
+             ExcGhostIndexArrayHasWrongSize(ghost_array.size(), n_ghost_indices(),
+                                            n_ghost_indices_in_larger_set));
+      AssertDimension (ghost_targets().size() + import_targets().size(),
+                       requests.size());
+      if (requests.size() > 0)
+        {
+          const int ierr = MPI_Waitall (requests.size(),
+                                        requests.data(),
+                                        MPI_STATUSES_IGNORE);
+          AssertThrowMPI (ierr);
+        }
+      requests.resize(0);
+
+      // convert the received data back to the vector type. the data of each
+      // message is stored densely at the beginning of its section, so going
+      // backwards through the section never overwrites entries that still
+      // need to be read
+      const bool use_larger_set = (n_ghost_indices_in_larger_set > n_ghost_indices() &&
+                                   ghost_array.size() == n_ghost_indices_in_larger_set);
+      Number *ghost_array_ptr = use_larger_set ?
+                                ghost_array.data()+
+                                n_ghost_indices_in_larger_set-n_ghost_indices()
+                                : ghost_array.data();
+      for (unsigned int i=0; i<ghost_targets_data.size(); i++)
+        {
+          const char *transfer_ptr = reinterpret_cast<const char *>(ghost_array_ptr);
+          for (unsigned int j=ghost_targets_data[i].second; j>0; --j)
+            {
+              TransferNumber value;
+              std::memcpy(&value, transfer_ptr + sizeof(TransferNumber)*(j-1),
+                          sizeof(TransferNumber));
+              ghost_array_ptr[j-1] = static_cast<Number>(value);
+            }
+          ghost_array_ptr += ghost_targets_data[i].second;
+        }
+
+      move_ghost_data_to_larger_set(ghost_array);
+    }
+
+
+
+    template <typename Number>
+    void
+    Partitioner::export_to_ghosted_array_init(const unsigned int        communication_channel,
+                                              const ArrayView<Number>  &temporary_storage,
+                                              const ArrayView<Number>  &ghost_array,
+                                              std::vector<MPI_Request> &requests) const
+    {
+      AssertDimension(temporary_storage.size(), n_import_indices());
+      Assert(ghost_array.size() == n_ghost_indices() ||
+             ghost_array.size() == n_ghost_indices_in_larger_set,
+             ExcGhostIndexArrayHasWrongSize(ghost_array.size(), n_ghost_indices(),
+                                            n_ghost_indices_in_larger_set));
+      Assert(requests.size() == 0,
+             ExcMessage("The requests must be freed before setting them up "
+                        "again."));
+
+      const unsigned int n_import_targets = import_targets_data.size();
+      const unsigned int n_ghost_targets = ghost_targets_data.size();
+
+      // same layout as in export_to_ghosted_array_start: first the receive
+      // operations, then the send operations
+      requests.resize (n_import_targets+n_ghost_targets);
+
+      AssertIndexRange(n_ghost_indices(), n_ghost_indices_in_larger_set+1);
+      const bool use_larger_set = (n_ghost_indices_in_larger_set > n_ghost_indices() &&
+                                   ghost_array.size() == n_ghost_indices_in_larger_set);
+      Number *ghost_array_ptr = use_larger_set ?
+                                ghost_array.data()+
+                                n_ghost_indices_in_larger_set-n_ghost_indices()
+                                : ghost_array.data();
+
+      for (unsigned int i=0; i<n_ghost_targets; i++)
+        {
+          const int ierr = MPI_Recv_init (ghost_array_ptr,
+                                          ghost_targets_data[i].second*sizeof(Number),
+                                          MPI_BYTE,
+                                          ghost_targets_data[i].first,
+                                          ghost_targets_data[i].first + communication_channel,
+                                          communicator,
+                                          &requests[i]);
+          AssertThrowMPI (ierr);
+          ghost_array_ptr += ghost_targets_data[i].second;
+        }
+
+      Number *temp_array_ptr = temporary_storage.data();
+      for (unsigned int i=0; i<n_import_targets; i++)
+        {
+          const int ierr = MPI_Send_init (temp_array_ptr,
+                                          import_targets_data[i].second*sizeof(Number),
+                                          MPI_BYTE,
+                                          import_targets_data[i].first,
+                                          my_pid + communication_channel,
+                                          communicator,
+                                          &requests[n_ghost_targets+i]);
+          AssertThrowMPI (ierr);
+          temp_array_ptr += import_targets_data[i].second;
+        }
+    }
+
+
+
+    template <typename Number>
+    void
+    Partitioner::export_to_ghosted_array_start_persistent(const ArrayView<const Number> &locally_owned_array,
+                                                          const ArrayView<Number>       &temporary_storage,
+                                                          std::vector<MPI_Request>      &requests) const
+    {
+      EventTrace::Scope trace_scope ("export_to_ghosted_array_start_persistent", "MPI");
+
+      AssertDimension(locally_owned_array.size(), local_size());
+      AssertDimension(temporary_storage.size(), n_import_indices());
+      AssertDimension (ghost_targets().size() + import_targets().size(),
+                       requests.size());
+
+      if (requests.size() == 0)
+        return;
+
+      // start the receive operations before packing the data, which gives
+      // the remote processes more time to match their messages
+      const unsigned int n_ghost_targets = ghost_targets_data.size();
+      if (n_ghost_targets > 0)
+        {
+          const int ierr = MPI_Startall (n_ghost_targets, requests.data());
+          AssertThrowMPI (ierr);
+        }
+
+      // copy the data to be sent to the import_data field. the chunks of the
+      // individual targets are stored consecutively, so a single loop over
+      // all import indices packs the data for all messages
+      Number *temp_array_ptr = temporary_storage.data();
+      for (std::vector<std::pair<unsigned int, unsigned int> >::const_iterator
+           my_imports = import_indices_data.begin();
+           my_imports != import_indices_data.end(); ++my_imports)
+        for (unsigned int j=my_imports->first; j<my_imports->second; j++)
+          *temp_array_ptr++ = locally_owned_array[j];
+      AssertDimension(temp_array_ptr-temporary_storage.data(), n_import_indices());
+
+      if (requests.size() > n_ghost_targets)
+        {
+          const int ierr = MPI_Startall (requests.size()-n_ghost_targets,
+                                         &requests[n_ghost_targets]);
+          AssertThrowMPI (ierr);
+        }
+    }
+
+
+
+    template <typename Number>
+    void
+    Partitioner::export_to_ghosted_array_finish_persistent(const ArrayView<Number>  &ghost_array,
+                                                           std::vector<MPI_Request> &requests) const
+    {
+
       Assert(ghost_array.size() == n_ghost_indices() ||
              ghost_array.size() == n_ghost_indices_in_larger_set,
              ExcGhostIndexArrayHasWrongSize(ghost_array.size(), n_ghost_indices(),
@@ -137,8 +329,16 @@ namespace Utilities
                                         MPI_STATUSES_IGNORE);
           AssertThrowMPI (ierr);
         }
-      requests.resize(0);
 
+      move_ghost_data_to_larger_set(ghost_array);
+    }
+
+
+
+    template <typename Number>
+    void
+    Partitioner::move_ghost_data_to_larger_set(const ArrayView<Number> &ghost_array) const
+    {
       // in case we only sent a subset of indices, we now need to move the data
       // to the correct positions and delete the old content
       if (n_ghost_indices_in_larger_set > n_ghost_indices() &&
@@ -174,6 +374,8 @@ namespace Utilities
                                                  const ArrayView<Number>      &temporary_storage,
                                                  std::vector<MPI_Request>     &requests) const
     {
+      EventTrace::Scope trace_scope ("import_from_ghosted_array_start", "MPI");
+
       AssertDimension(temporary_storage.size(), n_import_indices());
       Assert(ghost_array.size() == n_ghost_indices() ||
              ghost_array.size() == n_ghost_indices_in_larger_set,
@@ -316,6 +518,8 @@ namespace Utilities
                                                   const ArrayView<Number>       &ghost_array,
                                                   std::vector<MPI_Request>      &requests) const
     {
+      EventTrace::Scope trace_scope ("import_from_ghosted_array_finish", "MPI");
+
       AssertDimension(locally_owned_array.size(), local_size());
       AssertDimension(temporary_storage.size(), n_import_indices());
       Assert(ghost_array.size() == n_ghost_indices() ||
@@ -22,6 +22,7 @@
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/subscriptor.h>
 #include <deal.II/base/point.h>
+#include <deal.II/base/vectorization.h>
 
 #include <memory>
 #include <vector>
@@ -129,6 +130,21 @@ namespace Polynomials
                 const unsigned int n_derivatives,
                 number *values) const;
 
+    /**
+     * Same as above, but for VectorizedArray<number>::n_array_elements
+     * points at once, given by the components of @p x. The values and
+     * derivatives at the point <tt>x[v]</tt> are returned in component @p v
+     * of <tt>values[i], i=0,...,n_derivatives</tt>.
+     *
+     * Polynomials in the product form of Lagrange polynomials are evaluated
+     * with the vector instructions of the processor, giving the same result
+     * as the function above for each point. Polynomials in coefficient form
+     * are evaluated point by point with the function above.
+     */
+    void value (const VectorizedArray<number> &x,
+                const unsigned int             n_derivatives,
+                VectorizedArray<number>       *values) const;
+
     /**
      * Degree of the polynomial. This is the degree reflected by the number of
      * coefficients provided by the constructor. Leading non-zero coefficients
@@ -652,6 +668,48 @@ namespace Polynomials
 
 
 
+  template <typename number>
+  inline
+  void
+  Polynomial<number>::value (const VectorizedArray<number> &x,
+                             const unsigned int             n_derivatives,
+                             VectorizedArray<number>       *values) const
+  {
+    if (in_lagrange_product_form == true)
+      {
+        // same algorithm as in the scalar function, see there
+        const unsigned int n_supp = lagrange_support_points.size();
+        values[0] = 1.;
+        for (unsigned int d=1; d<=n_derivatives; ++d)
+          values[d] = 0.;
+        for (unsigned int i=0; i<n_supp; ++i)
+          {
+            const VectorizedArray<number> v = x-lagrange_support_points[i];
+            for (unsigned int k=n_derivatives; k>0; --k)
+              values[k] = values[k] * v + values[k-1];
+            values[0] *= v;
+          }
+        number k_faculty = 1;
+        for (unsigned int k=0; k<=n_derivatives; ++k)
+          {
+            values[k] = (k_faculty * lagrange_weight) * values[k];
+            k_faculty *= static_cast<number>(k+1);
+          }
+      }
+    else
+      {
+        std::vector<number> point_values (n_derivatives+1);
+        for (unsigned int v=0; v<VectorizedArray<number>::n_array_elements; ++v)
+          {
+            value (x[v], n_derivatives, point_values.data());
+            for (unsigned int k=0; k<=n_derivatives; ++k)
+              values[k][v] = point_values[k];
+          }
+      }
+  }
+
+
+
   template <typename number>
   template <class Archive>
   inline
@@ -33,6 +33,11 @@ DEAL_II_NAMESPACE_OPEN
  * href="http://en.wikipedia.org/wiki/Numerical_Recipes">Numerical
  * Recipes</a>.
  *
+ * The one-dimensional formulas are computed only once for each number of
+ * points and are then taken from a cache shared by all threads, so that
+ * creating the same formula repeatedly, for example for each level of a
+ * multigrid hierarchy, is cheap. The same holds for QGaussLobatto.
+ *
  * @author Guido Kanschat, 2001
  */
 template <int dim>
@@ -42,7 +42,10 @@ DEAL_II_NAMESPACE_OPEN
  * The underlying structure and the initialize() method of this class are designed
  * in such a way that one could use different child classes derived from the
  * base DataType class to store data on a given cell. This implies the usage of pointers,
- * in our case -- std::shared_ptr().
+ * in our case -- std::shared_ptr(). The objects of all quadrature points of a
+ * cell are nevertheless allocated in one contiguous block, which the pointers
+ * share, so that initializing a cell costs a single memory allocation and the
+ * data of a cell is close together in memory.
  *
  * @note The data type stored on each cell can be different.
  * However, within the cell this class stores a vector of objects of a single data type.
@@ -480,12 +483,15 @@ void CellDataStorage<CellIteratorType,DataType>::initialize(const CellIteratorTy
 
   if (map.find(cell) == map.end())
     {
-      map[cell] = std::vector<std::shared_ptr<DataType> >(n_q_points);
-      // we need to initialize one-by-one as the std::vector<>(q, T())
-      // will end with a single same T object stored in each element of the vector:
-      auto it = map.find(cell);
+      // allocate the objects of all quadrature points of the cell in one
+      // contiguous block rather than one by one, and let the pointers of the
+      // individual quadrature points share the ownership of this block
+      const std::shared_ptr<std::vector<T> > pool
+        = std::make_shared<std::vector<T> >(n_q_points);
+      std::vector<std::shared_ptr<DataType> > &cell_data = map[cell];
+      cell_data.resize(n_q_points);
       for (unsigned int q=0; q < n_q_points; q++)
-        it->second[q] = std::make_shared<T>();
+        cell_data[q] = std::shared_ptr<DataType>(pool, &(*pool)[q]);
     }
 }
 
@@ -508,9 +514,14 @@ template <typename CellIteratorType, typename DataType>
 bool CellDataStorage<CellIteratorType,DataType>::erase(const CellIteratorType &cell)
 {
   const auto it = map.find(cell);
+  if (it == map.end())
+    return false;
+
+  // the pointers of all quadrature points of the cell share the ownership of
+  // one block of objects, see initialize()
   for (unsigned int i = 0; i < it->second.size(); i++)
     {
-      Assert(it->second[i].unique(),
+      Assert(it->second[i].use_count() == static_cast<long>(it->second.size()),
              ExcMessage("Can not erase the cell data multiple objects reference its data."));
     }
 
@@ -532,7 +543,7 @@ void CellDataStorage<CellIteratorType,DataType>::clear()
       // loop over all objects and see if noone is using them
       for (unsigned int i = 0; i < it->second.size(); i++)
         {
-          Assert(it->second[i].unique(),
+          Assert(it->second[i].use_count() == static_cast<long>(it->second.size()),
                  ExcMessage("Can not erase the cell data, multiple objects reference it."));
         }
       it = map.erase(it);
@@ -54,6 +54,14 @@ DEAL_II_NAMESPACE_OPEN
  * @note This feature is switched off if multithreading is used (i.e., if
  * <code>DEAL_II_WITH_THREADS</code> is on).
  *
+ * @note Subscriptions are only tracked in debug mode. In release mode,
+ * subscribe() and unsubscribe() are empty inline functions, so that creating,
+ * copying and destroying a SmartPointer does not touch the subscribed object
+ * at all. This matters for objects such as the scratch data of a threaded
+ * assembly loop that hold SmartPointer members and are copied for every
+ * thread. As a consequence, n_subscriptions() always returns zero in release
+ * mode.
+ *
  * @ingroup memory
  * @author Guido Kanschat, 1998 - 2005
  */
@@ -226,6 +234,24 @@ private:
 
 //---------------------------------------------------------------------------
 
+#ifndef DEBUG
+
+inline
+void
+Subscriptor::subscribe (const char *) const
+{}
+
+
+
+inline
+void
+Subscriptor::unsubscribe (const char *) const
+{}
+
+#endif
+
+
+
 template <class Archive>
 inline
 void
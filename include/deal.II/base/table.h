@@ -599,6 +599,12 @@ public:
    */
   void swap (TableBase<N,T> &v);
 
+  /**
+   * Take the memory of the elements of this table from @p resource, e.g.,
+   * from huge pages. See AlignedVector::set_memory_resource().
+   */
+  void set_memory_resource (const AlignedMemoryResource &resource);
+
   /**
    * Determine an estimate for the memory consumption (in bytes) of this
    * object.
@@ -2040,6 +2046,16 @@ TableBase<N,T>::swap (TableBase<N,T> &v)
 
 
 
+template <int N, typename T>
+inline
+void
+TableBase<N,T>::set_memory_resource (const AlignedMemoryResource &resource)
+{
+  values.set_memory_resource (resource);
+}
+
+
+
 template <int N, typename T>
 inline
 std::size_t
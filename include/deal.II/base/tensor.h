@@ -1666,6 +1666,31 @@ scalar_product (const Tensor<rank, dim, Number> &left,
 }
 
 
+
+/**
+ * The scalar product of two tensors of rank 2, i.e., their double
+ * contraction. This overload sums the products of the entries directly
+ * instead of going through the generic contraction, which gives better code
+ * for number types like VectorizedArray.
+ *
+ * @relates Tensor
+ */
+template <int dim, typename Number, typename OtherNumber>
+inline
+typename ProductType<Number, OtherNumber>::type
+scalar_product (const Tensor<2, dim, Number> &left,
+                const Tensor<2, dim, OtherNumber> &right)
+{
+  typename ProductType<Number, OtherNumber>::type result = left[0][0] * right[0][0];
+  for (unsigned int j=1; j<dim; ++j)
+    result += left[0][j] * right[0][j];
+  for (unsigned int i=1; i<dim; ++i)
+    for (unsigned int j=0; j<dim; ++j)
+      result += left[i][j] * right[i][j];
+  return result;
+}
+
+
 /**
  * Full contraction of three tensors: Return a scalar number that is the
  * result of a full contraction of a tensor @p left of rank @p rank_1, a
@@ -1725,6 +1750,28 @@ outer_product(const Tensor<rank_1, dim, Number> &src1,
 }
 
 
+
+/**
+ * The outer product of two tensors of rank 1. This overload writes the
+ * entries directly instead of going through the generic contraction, which
+ * gives better code for number types like VectorizedArray.
+ *
+ * @relates Tensor
+ */
+template <int dim, typename Number, typename OtherNumber>
+inline
+Tensor<2, dim, typename ProductType<Number, OtherNumber>::type>
+outer_product(const Tensor<1, dim, Number> &src1,
+              const Tensor<1, dim, OtherNumber> &src2)
+{
+  Tensor<2, dim, typename ProductType<Number, OtherNumber>::type> result;
+  for (unsigned int i=0; i<dim; ++i)
+    for (unsigned int j=0; j<dim; ++j)
+      result[i][j] = src1[i] * src2[j];
+  return result;
+}
+
+
 //@}
 /**
  * @name Special operations on tensors of rank 1
@@ -1835,6 +1882,36 @@ Number determinant (const Tensor<2,1,Number> &t)
   return t[0][0];
 }
 
+/**
+ * Specialization for dim==2. Like the one for dim==3, it avoids the
+ * Laplace expansion with its temporary minors, which matters for number
+ * types like VectorizedArray.
+ *
+ * @relates Tensor
+ */
+template <typename Number>
+inline
+Number determinant (const Tensor<2,2,Number> &t)
+{
+  return t[0][0]*t[1][1] - t[1][0]*t[0][1];
+}
+
+
+/**
+ * Specialization for dim==3.
+ *
+ * @relates Tensor
+ */
+template <typename Number>
+inline
+Number determinant (const Tensor<2,3,Number> &t)
+{
+  const Number C0 = t[1][1]*t[2][2] - t[1][2]*t[2][1];
+  const Number C1 = t[1][2]*t[2][0] - t[1][0]*t[2][2];
+  const Number C2 = t[1][0]*t[2][1] - t[1][1]*t[2][0];
+  return t[0][0]*C0 + t[0][1]*C1 + t[0][2]*C2;
+}
+
 
 /**
  * Compute and return the trace of a tensor of rank 2, i.e. the sum of its
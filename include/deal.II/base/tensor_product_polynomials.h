@@ -22,6 +22,7 @@
 #include <deal.II/base/tensor.h>
 #include <deal.II/base/point.h>
 #include <deal.II/base/polynomial.h>
+#include <deal.II/base/table.h>
 #include <deal.II/base/utilities.h>
 
 #include <vector>
@@ -119,6 +120,26 @@ public:
                 std::vector<Tensor<3,dim> > &third_derivatives,
                 std::vector<Tensor<4,dim> > &fourth_derivatives) const;
 
+  /**
+   * Compute the values and the gradients of all tensor product polynomials
+   * at all the given @p unit_points, where <tt>values(i,q)</tt> and
+   * <tt>grads(i,q)</tt> hold the value and the gradient of the <tt>i</tt>th
+   * polynomial at the <tt>q</tt>th point.
+   *
+   * The tables must either be empty or of size n() times
+   * <tt>unit_points.size()</tt>. In the first case, the function will not
+   * compute these values.
+   *
+   * The one-dimensional polynomials are evaluated for
+   * VectorizedArray<double>::n_array_elements points at once. If you need the
+   * values of all polynomials at many points, e.g. for filling the tables of
+   * shape functions on a quadrature formula, use this function rather than
+   * calling the function above once per point.
+   */
+  void compute (const std::vector<Point<dim> > &unit_points,
+                Table<2,double>                &values,
+                Table<2,Tensor<1,dim> >        &grads) const;
+
   /**
    * Compute the value of the <tt>i</tt>th tensor product polynomial at
    * <tt>unit_point</tt>. Here <tt>i</tt> is given in tensor product
@@ -19,14 +19,17 @@
 
 #include <deal.II/base/config.h>
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/multithread_info.h>
 #include <deal.II/base/template_constraints.h>
 
 #ifdef DEAL_II_WITH_THREADS
 #  include <thread>
 #  include <mutex>
 #  include <condition_variable>
+#  include <atomic>
 #endif
 
+#include <complex>
 #include <iterator>
 #include <vector>
 #include <list>
@@ -557,6 +560,30 @@ namespace Threads
                   const unsigned int end,
                   const unsigned int n_intervals);
 
+  /**
+   * Add @p increment to @p target in a way that is safe when several threads
+   * add to the same memory location concurrently, i.e., without a mutex but
+   * by a compare-and-swap loop on the value. For complex numbers, the real
+   * and imaginary parts are updated separately, which gives the correct sum
+   * once all threads are done but means that other threads may observe a
+   * state in which only one part has been updated. If deal.II is configured
+   * without thread support, this is a plain addition.
+   *
+   * @ingroup threads
+   */
+  template <typename Number>
+  void atomic_add (Number       &target,
+                   const Number  increment);
+
+  /**
+   * Same as above, but for complex numbers.
+   *
+   * @ingroup threads
+   */
+  template <typename Number>
+  void atomic_add (std::complex<Number>       &target,
+                   const std::complex<Number>  increment);
+
   /**
    * @cond internal
    */
@@ -672,6 +699,54 @@ namespace Threads
       }
     return return_values;
   }
+
+
+
+  template <typename Number>
+  inline
+  void
+  atomic_add (Number       &target,
+              const Number  increment)
+  {
+#ifdef DEAL_II_WITH_THREADS
+#  if defined(__GNUC__)
+    Number old_value;
+    __atomic_load (&target, &old_value, __ATOMIC_RELAXED);
+    Number new_value = old_value + increment;
+    // on failure, old_value is overwritten by the current content of target
+    while (!__atomic_compare_exchange (&target, &old_value, &new_value,
+                                       /*weak=*/true,
+                                       __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+      new_value = old_value + increment;
+#  else
+    static_assert (sizeof(std::atomic<Number>) == sizeof(Number),
+                   "std::atomic<Number> must have the same layout as Number");
+    std::atomic<Number> &atomic_target =
+      reinterpret_cast<std::atomic<Number>&>(target);
+    Number old_value = atomic_target.load (std::memory_order_relaxed);
+    while (!atomic_target.compare_exchange_weak (old_value, old_value + increment,
+                                                 std::memory_order_relaxed))
+      ;
+#  endif
+#else
+    target += increment;
+#endif
+  }
+
+
+
+  template <typename Number>
+  inline
+  void
+  atomic_add (std::complex<Number>       &target,
+              const std::complex<Number>  increment)
+  {
+    // the standard guarantees that a complex number can be accessed as an
+    // array of its real and imaginary part
+    Number *parts = reinterpret_cast<Number *>(&target);
+    atomic_add (parts[0], increment.real());
+    atomic_add (parts[1], increment.imag());
+  }
 }
 
 #endif // DOXYGEN
@@ -1461,6 +1536,16 @@ namespace Threads
     void
     TaskDescriptor<RT>::queue_task ()
     {
+      // if the loops of the library are run by another threading model,
+      // do not start the TBB for tasks either but run the function right
+      // away, like in non-MT mode
+      if (MultithreadInfo::get_loop_backend())
+        {
+          call (function, ret_val);
+          task_is_done = true;
+          return;
+        }
+
       // use the pattern described in the TBB book on pages 230/231
       // ("Start a large task in parallel with the main program")
       task = new (tbb::task::allocate_root()) tbb::empty_task;
@@ -1520,8 +1605,10 @@ namespace Threads
       // warning about unfinished tasks when the scheduler "goes out
       // of the arena". rather, let's explicitly destroy the empty
       // task object. before that, make sure that the task has been
-      // shut down, expressed by a zero reference count
-      AssertNothrow (task != nullptr, ExcInternalError());
+      // shut down, expressed by a zero reference count. there is no task
+      // structure if the function has been run by queue_task() directly
+      if (task == nullptr)
+        return;
       AssertNothrow (task->ref_count()==0, ExcInternalError());
       task->destroy (*task);
     }
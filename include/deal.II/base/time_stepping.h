@@ -18,6 +18,7 @@
 
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/mpi.h>
 #include <deal.II/base/signaling_nan.h>
 
 #include <functional>
@@ -40,6 +41,10 @@ namespace TimeStepping
    *   - FORWARD_EULER (first order)
    *   - RK_THIRD_ORDER (third order Runge-Kutta)
    *   - RK_CLASSIC_FOURTH_ORDER (classical fourth order Runge-Kutta)
+   * - Low-storage explicit methods (see LowStorageRungeKutta::initialize):
+   *   - LOW_STORAGE_RK_STAGE3_ORDER3 (three stages, third order)
+   *   - LOW_STORAGE_RK_STAGE5_ORDER4 (five stages, fourth order, scheme
+   *     RK4(3)5[2R+]C of Kennedy, Carpenter, and Lewis)
    * - Implicit methods (see ImplicitRungeKutta::initialize):
    *   - BACKWARD_EULER (first order)
    *   - IMPLICIT_MIDPOINT (second order)
@@ -57,6 +62,7 @@ namespace TimeStepping
                             BACKWARD_EULER, IMPLICIT_MIDPOINT, CRANK_NICOLSON,
                             SDIRK_TWO_STAGES, HEUN_EULER, BOGACKI_SHAMPINE, DOPRI,
                             FEHLBERG, CASH_KARP,
+                            LOW_STORAGE_RK_STAGE3_ORDER3, LOW_STORAGE_RK_STAGE5_ORDER4,
                             invalid
                           };
 
@@ -290,6 +296,150 @@ namespace TimeStepping
 
 
 
+  /**
+   * LowStorageRungeKutta is derived from RungeKutta and implements explicit
+   * methods in the low-storage form of Kennedy, Carpenter, and Lewis (Applied
+   * Numerical Mathematics, 35:177-219, 2000). In these methods, the entries of
+   * the Butcher tableau below the subdiagonal equal the weights of the
+   * quadrature, $a_{ij} = b_j$ for $j<i-1$, such that a step only needs the
+   * solution and two more vectors, independent of the number of stages:
+   * @f{align*}{
+   *   k_i &= f(t+c_i \Delta t, r_i), \
+   *   r_{i+1} &= y + a_i \Delta t\, k_i, \
+   *   y &\leftarrow y + b_i \Delta t\, k_i,
+   * @f}
+   * for $i=1,\ldots,s$, starting with $r_1=y$, where $a_i=a_{i+1,i}$ denote
+   * the subdiagonal of the tableau. In contrast, ExplicitRungeKutta stores the
+   * $s$ stage vectors and forms the stage vectors by $i$ vector updates each.
+   *
+   * The variant of evolve_one_time_step() that takes a @p perform_stage
+   * function leaves the two vector updates of each stage to the operator. It
+   * can then compute them on the fly while writing $k_i$, e.g., in the loop
+   * that applies the inverse mass matrix of a matrix-free discontinuous
+   * Galerkin operator. This way, each stage only reads $r_i$ and $y$ and
+   * writes $r_{i+1}$ and $y$.
+   */
+  template <typename VectorType>
+  class LowStorageRungeKutta : public RungeKutta<VectorType>
+  {
+  public:
+    using RungeKutta<VectorType>::evolve_one_time_step;
+
+    /**
+     * Default constructor. This constructor creates an object for which
+     * you will want to call <code>initialize(runge_kutta_method)</code>
+     * before it can be used.
+     */
+    LowStorageRungeKutta() = default;
+
+    /**
+     * Constructor. This function calls initialize(runge_kutta_method).
+     */
+    LowStorageRungeKutta(const runge_kutta_method method);
+
+    /**
+     * Initialize the low-storage explicit Runge-Kutta method.
+     */
+    void initialize(const runge_kutta_method method);
+
+    /**
+     * This function is used to advance from time @p t to t+ @p delta_t. @p f
+     * is the function $ f(t,y) $ that should be integrated, the input
+     * parameters are the time t and the vector y and the output is value of f
+     * at this point. @p id_minus_tau_J_inverse is not used by explicit
+     * methods. evolve_one_time_step returns the time at the end of the time
+     * step.
+     */
+    double evolve_one_time_step
+    (const std::function<VectorType (const double, const VectorType &)>                &f,
+     const std::function<VectorType (const double, const double, const VectorType &)>  &id_minus_tau_J_inverse,
+     double                                                                      t,
+     double                                                                      delta_t,
+     VectorType                                                                  &y);
+
+    /**
+     * This function is used to advance from time @p t to t+ @p delta_t. This
+     * function is similar to the one derived from RungeKutta, but does not
+     * required id_minus_tau_J_inverse because it is not used for explicit
+     * methods. evolve_one_time_step returns the time at the end of the time
+     * step.
+     */
+    double evolve_one_time_step
+    (const std::function<VectorType (const double, const VectorType &)> &f,
+     double                                                       t,
+     double                                                       delta_t,
+     VectorType                                                   &y);
+
+    /**
+     * This function is used to advance from time @p t to t+ @p delta_t, with
+     * the vector updates of the stages done by @p perform_stage. A call
+     * <code>perform_stage(time, factor_solution, factor_ai, current_ri,
+     * next_ri, solution)</code> has to evaluate $k_i = f(	ext{time},
+     * 	ext{current\_ri})$ and then set <code>next_ri</code> to
+     * <code>solution + factor_ai * k_i</code> and add <code>factor_solution
+     * * k_i</code> to <code>solution</code>. In the first stage,
+     * <code>current_ri</code> is the same object as <code>solution</code>,
+     * so all of $k_i$ must be computed before <code>solution</code> is
+     * modified. <code>next_ri</code> is never the same object as one of the
+     * other two vectors and may thus hold $k_i$ in between. In the last
+     * stage, <code>factor_ai</code> is zero and <code>next_ri</code> is not
+     * used afterwards.
+     *
+     * The vectors @p vec_ri and @p vec_ki are used as the two registers of
+     * the method and must have the same layout as @p y. Their content on
+     * entry and exit is unspecified. evolve_one_time_step returns the time at
+     * the end of the time step.
+     */
+    double evolve_one_time_step
+    (const std::function<void (const double, const double, const double,
+                               const VectorType &, VectorType &, VectorType &)> &perform_stage,
+     double                                                                  t,
+     double                                                                  delta_t,
+     VectorType                                                              &y,
+     VectorType                                                              &vec_ri,
+     VectorType                                                              &vec_ki);
+
+    /**
+     * Return the coefficients of the method: the subdiagonal $a_i$ of the
+     * Butcher tableau (one entry less than the number of stages), the weights
+     * $b_i$, and the times $c_i$ of the stages.
+     */
+    void get_coefficients (std::vector<double> &ai,
+                           std::vector<double> &bi,
+                           std::vector<double> &ci) const;
+
+    /**
+     * This structure stores the name of the method used.
+     */
+    struct Status : public TimeStepping<VectorType>::Status
+    {
+      Status ()
+        :
+        method (invalid)
+      {}
+
+      runge_kutta_method method;
+    };
+
+    /**
+     * Return the status of the current object.
+     */
+    const Status &get_status() const;
+
+  private:
+    /**
+     * The subdiagonal of the Butcher tableau.
+     */
+    std::vector<double> ai;
+
+    /**
+     * Status structure of the object.
+     */
+    Status status;
+  };
+
+
+
   /**
    * This class is derived from RungeKutta and implement the implicit methods.
    * This class works only for Diagonal Implicit Runge-Kutta (DIRK) methods.
@@ -603,6 +753,152 @@ namespace TimeStepping
      */
     Status status;
   };
+
+
+
+  /**
+   * The Parareal method, which solves an initial value problem in parallel
+   * in time. The time interval is split into as many time slices as there
+   * are processes in a time communicator, and each process is responsible
+   * for one slice. A cheap coarse propagator $G$, for example an
+   * ExplicitRungeKutta method with a few large time steps or a solver on a
+   * coarser mesh, is applied sequentially from slice to slice, and an
+   * expensive fine propagator $F$, for example the same method with the
+   * time steps needed for the desired accuracy, is applied on all slices at
+   * the same time. The values $U_p$ at the beginnings of the slices are
+   * iteratively corrected by
+   * @f[
+   *   U_{p+1}^{k+1} = G(U_p^{k+1}) + F(U_p^k) - G(U_p^k),
+   * @f]
+   * starting from a sweep of the coarse propagator alone. After $k$
+   * iterations, the solution on the first $k$ slices is the one of the fine
+   * propagator, so the method ends after at most as many iterations as there
+   * are slices, but typically much earlier once the corrections fall below
+   * a given tolerance. The parallel speedup is bounded by the number of
+   * slices divided by the number of iterations.
+   *
+   * The propagators are given as functions that advance a vector from the
+   * first to the second time given to them, in place. They also define how
+   * the time is stepped within a slice, for example:
+   * @code
+   *   TimeStepping::ExplicitRungeKutta<VectorType> rk (TimeStepping::RK_CLASSIC_FOURTH_ORDER);
+   *   auto propagator = [&](const unsigned int n_steps)
+   *   {
+   *     return [&rk,n_steps,&f](const double t0, const double t1, VectorType &y)
+   *     {
+   *       const double delta_t = (t1-t0)/n_steps;
+   *       for (unsigned int step=0; step<n_steps; ++step)
+   *         rk.evolve_one_time_step (f, t0+step*delta_t, delta_t, y);
+   *     };
+   *   };
+   *   TimeStepping::Parareal<VectorType> parareal (propagator(1), propagator(100),
+   *                                                time_communicator);
+   * @endcode
+   *
+   * The problem can be distributed in space as well. In that case, the
+   * processes are split into one group per time slice, each with its own
+   * communicator for the spatial problem, and the time communicator connects
+   * the processes that own the same part of the spatial problem in all the
+   * slices, ordered by slice:
+   * @code
+   *   const unsigned int n_slices = ...;
+   *   const unsigned int rank = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+   *   const unsigned int n_procs_per_slice
+   *     = Utilities::MPI::n_mpi_processes (MPI_COMM_WORLD) / n_slices;
+   *
+   *   MPI_Comm space_communicator, time_communicator;
+   *   MPI_Comm_split (MPI_COMM_WORLD, rank / n_procs_per_slice, rank,
+   *                   &space_communicator);
+   *   MPI_Comm_split (MPI_COMM_WORLD, rank % n_procs_per_slice, rank,
+   *                   &time_communicator);
+   * @endcode
+   * The vectors on all slices must then have the same parallel partitioning
+   * with respect to their space communicators.
+   *
+   * The values of the vectors are sent between the slices as a contiguous
+   * array, so this class can be used with Vector and
+   * LinearAlgebra::distributed::Vector.
+   */
+  template <typename VectorType>
+  class Parareal
+  {
+  public:
+    /**
+     * The type of the propagators. The function advances the vector given as
+     * last argument from the time given as first argument to the time given
+     * as second argument.
+     */
+    typedef std::function<void (const double, const double, VectorType &)> Propagator;
+
+    /**
+     * Constructor. The iteration ends after @p max_iterations iterations, or
+     * after as many iterations as there are time slices if this is fewer,
+     * or as soon as the $l_2$ norm of the correction of the values at the
+     * ends of all slices is not larger than @p tolerance.
+     */
+    Parareal (const Propagator  &coarse_propagator,
+              const Propagator  &fine_propagator,
+              const MPI_Comm    &time_communicator,
+              const unsigned int max_iterations = numbers::invalid_unsigned_int,
+              const double       tolerance = 0.);
+
+    /**
+     * Solve the problem from @p t_start to @p t_end. On input, @p y holds
+     * the initial value on the first time slice, and needs to have the
+     * right size or parallel partitioning on the other slices. On output,
+     * @p y holds the solution at the end of the time slice of this process,
+     * and this time is returned. The process of the last slice thus holds
+     * the solution at @p t_end.
+     */
+    double evolve (const double t_start,
+                   const double t_end,
+                   VectorType  &y);
+
+    /**
+     * Structure that stores the number of iterations of the last call to
+     * evolve() and the norm of the correction in the last iteration.
+     */
+    struct Status
+    {
+      Status ()
+        :
+        n_iterations (0),
+        correction_norm (0.)
+      {}
+
+      unsigned int n_iterations;
+      double correction_norm;
+    };
+
+    /**
+     * Return the status of the current object.
+     */
+    const Status &get_status() const;
+
+  private:
+    /**
+     * Send the locally owned values of @p y to the process of the next time
+     * slice.
+     */
+    void send_to_next_slice (const VectorType &y) const;
+
+    /**
+     * Receive the locally owned values of @p y from the process of the
+     * previous time slice.
+     */
+    void receive_from_previous_slice (VectorType &y) const;
+
+    const Propagator coarse_propagator;
+    const Propagator fine_propagator;
+    const MPI_Comm time_communicator;
+    const unsigned int max_iterations;
+    const double tolerance;
+
+    /**
+     * Status structure of the object.
+     */
+    Status status;
+  };
 }
 
 DEAL_II_NAMESPACE_CLOSE
@@ -17,9 +17,13 @@
 #define dealii_time_stepping_templates_h
 
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.templates.h>
 #include <deal.II/base/time_stepping.h>
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
+#include <utility>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -197,6 +201,166 @@ namespace TimeStepping
 
 
 
+  // ----------------------------------------------------------------------
+  // LowStorageRungeKutta
+  // ----------------------------------------------------------------------
+
+  template <typename VectorType>
+  LowStorageRungeKutta<VectorType>::LowStorageRungeKutta(const runge_kutta_method method)
+  {
+    initialize(method);
+  }
+
+
+
+  template <typename VectorType>
+  void LowStorageRungeKutta<VectorType>::initialize(const runge_kutta_method method)
+  {
+    status.method = method;
+    ai.clear();
+    this->b.clear();
+    this->c.clear();
+
+    switch (method)
+      {
+      case (LOW_STORAGE_RK_STAGE3_ORDER3) :
+      {
+        this->n_stages = 3;
+        ai = {0.755726351946097, 0.386954477304099};
+        this->b = {0.245170287303492, 0.184896052186740, 0.569933660509768};
+
+        break;
+      }
+      case (LOW_STORAGE_RK_STAGE5_ORDER4) :
+      {
+        this->n_stages = 5;
+        ai = {970286171893./4311952581923.,
+              6584761158862./12103376702013.,
+              2251764453980./15575788980749.,
+              26877169314380./34165994151039.
+             };
+        this->b = {1153189308089./22510343858157.,
+                   1772645290293./4653164025191.,
+                   -1672844663538./4480602732383.,
+                   2114624349019./3568978502595.,
+                   5198255086312./14908931495163.
+                  };
+
+        break;
+      }
+      default :
+      {
+        AssertThrow(false,ExcMessage("Unimplemented low-storage explicit Runge-Kutta method."));
+      }
+      }
+
+    // the stage times are the row sums of the Butcher tableau
+    this->c.resize(this->n_stages, 0.);
+    double sum_of_b = 0.;
+    for (unsigned int i=1; i<this->n_stages; ++i)
+      {
+        this->c[i] = sum_of_b + ai[i-1];
+        sum_of_b += this->b[i-1];
+      }
+  }
+
+
+
+  template <typename VectorType>
+  double LowStorageRungeKutta<VectorType>::evolve_one_time_step
+  (const std::function<VectorType (const double, const VectorType &)> &f,
+   const std::function<VectorType (const double, const double, const VectorType &)> &/*id_minus_tau_J_inverse*/,
+   double                                                             t,
+   double                                                             delta_t,
+   VectorType                                                         &y)
+  {
+    return evolve_one_time_step(f,t,delta_t,y);
+  }
+
+
+
+  template <typename VectorType>
+  double LowStorageRungeKutta<VectorType>::evolve_one_time_step
+  (const std::function<VectorType (const double, const VectorType &)> &f,
+   double                                                             t,
+   double                                                             delta_t,
+   VectorType                                                         &y)
+  {
+    // k_i = f(t_i, r_i) is stored in next_ri, which is then turned into
+    // r_{i+1} = y_old + a_i k_i = y_new + (a_i - b_i) k_i
+    const auto perform_stage = [&f] (const double      time,
+                                     const double      factor_solution,
+                                     const double      factor_ai,
+                                     const VectorType &current_ri,
+                                     VectorType       &next_ri,
+                                     VectorType       &solution)
+    {
+      next_ri = f(time, current_ri);
+      solution.add(factor_solution, next_ri);
+      if (factor_ai != 0.)
+        next_ri.sadd(factor_ai-factor_solution, 1., solution);
+    };
+
+    VectorType vec_ri(y), vec_ki(y);
+    return evolve_one_time_step(perform_stage,t,delta_t,y,vec_ri,vec_ki);
+  }
+
+
+
+  template <typename VectorType>
+  double LowStorageRungeKutta<VectorType>::evolve_one_time_step
+  (const std::function<void (const double, const double, const double,
+                             const VectorType &, VectorType &, VectorType &)> &perform_stage,
+   double                                                                  t,
+   double                                                                  delta_t,
+   VectorType                                                              &y,
+   VectorType                                                              &vec_ri,
+   VectorType                                                              &vec_ki)
+  {
+    Assert(status.method != invalid,
+           ExcMessage("The method has not been initialized."));
+
+    // the first stage starts from the solution itself, the following ones
+    // alternate between the two registers
+    perform_stage(t, this->b[0]*delta_t,
+                  (this->n_stages > 1 ? ai[0]*delta_t : 0.),
+                  y, vec_ri, y);
+
+    VectorType *current_ri = &vec_ri;
+    VectorType *next_ri = &vec_ki;
+    for (unsigned int i=1; i<this->n_stages; ++i)
+      {
+        perform_stage(t+this->c[i]*delta_t, this->b[i]*delta_t,
+                      (i+1 < this->n_stages ? ai[i]*delta_t : 0.),
+                      *current_ri, *next_ri, y);
+        std::swap(current_ri, next_ri);
+      }
+
+    return (t+delta_t);
+  }
+
+
+
+  template <typename VectorType>
+  void LowStorageRungeKutta<VectorType>::get_coefficients (std::vector<double> &ai,
+                                                           std::vector<double> &bi,
+                                                           std::vector<double> &ci) const
+  {
+    ai = this->ai;
+    bi = this->b;
+    ci = this->c;
+  }
+
+
+
+  template <typename VectorType>
+  const typename LowStorageRungeKutta<VectorType>::Status &LowStorageRungeKutta<VectorType>::get_status() const
+  {
+    return status;
+  }
+
+
+
   // ----------------------------------------------------------------------
   // ImplicitRungeKutta
   // ----------------------------------------------------------------------
@@ -832,6 +996,144 @@ namespace TimeStepping
         f_stages[i] = f(t+this->c[i]*delta_t,Y);
       }
   }
+
+
+
+  // ----------------------------------------------------------------------
+  // Parareal
+  // ----------------------------------------------------------------------
+
+  template <typename VectorType>
+  Parareal<VectorType>::Parareal(const Propagator  &coarse_propagator,
+                                 const Propagator  &fine_propagator,
+                                 const MPI_Comm    &time_communicator,
+                                 const unsigned int max_iterations,
+                                 const double       tolerance)
+    :
+    coarse_propagator(coarse_propagator),
+    fine_propagator(fine_propagator),
+    time_communicator(time_communicator),
+    max_iterations(max_iterations),
+    tolerance(tolerance)
+  {}
+
+
+
+  template <typename VectorType>
+  double Parareal<VectorType>::evolve(const double t_start,
+                                      const double t_end,
+                                      VectorType  &y)
+  {
+    const unsigned int n_slices = Utilities::MPI::n_mpi_processes(time_communicator);
+    const unsigned int slice = Utilities::MPI::this_mpi_process(time_communicator);
+    const double slice_length = (t_end-t_start)/n_slices;
+    const double t0 = t_start + slice*slice_length;
+    const double t1 = (slice+1 == n_slices ? t_end : t0+slice_length);
+
+    // the value at the beginning of the slice, the coarse and the fine
+    // propagation of it, and the value at the end of the slice
+    VectorType start(y);
+    VectorType coarse(y);
+    VectorType fine(y);
+    VectorType end(y);
+
+    // initial sweep of the coarse propagator over all slices
+    if (slice > 0)
+      receive_from_previous_slice(start);
+    coarse = start;
+    coarse_propagator(t0, t1, coarse);
+    end = coarse;
+    if (slice+1 < n_slices)
+      send_to_next_slice(end);
+
+    status.n_iterations = 0;
+    status.correction_norm = 0.;
+    const unsigned int n_iterations = std::min(max_iterations, n_slices);
+    for (unsigned int k=0; k<n_iterations; ++k)
+      {
+        // the expensive part, on all slices at the same time
+        fine = start;
+        fine_propagator(t0, t1, fine);
+
+        // the correction sweep. fine and coarse are used below to hold the
+        // new value at the end of the slice and the correction
+        if (slice > 0)
+          receive_from_previous_slice(start);
+        fine -= coarse;
+        coarse = start;
+        coarse_propagator(t0, t1, coarse);
+        fine += coarse;
+        end.sadd(-1., 1., fine);
+        const double local_correction_norm = end.l2_norm();
+        end = fine;
+        if (slice+1 < n_slices)
+          send_to_next_slice(end);
+
+        ++status.n_iterations;
+        status.correction_norm
+          = std::sqrt(Utilities::MPI::sum(local_correction_norm*local_correction_norm,
+                                          time_communicator));
+        if (status.correction_norm <= tolerance)
+          break;
+      }
+
+    y = end;
+    return t1;
+  }
+
+
+
+  template <typename VectorType>
+  const typename Parareal<VectorType>::Status &
+  Parareal<VectorType>::get_status() const
+  {
+    return status;
+  }
+
+
+
+  template <typename VectorType>
+  void Parareal<VectorType>::send_to_next_slice(const VectorType &y) const
+  {
+#ifdef DEAL_II_WITH_MPI
+    const int ierr = MPI_Send(const_cast<typename VectorType::value_type *>(y.begin()),
+                              y.end()-y.begin(),
+                              Utilities::MPI::internal::mpi_type_id(y.begin()),
+                              Utilities::MPI::this_mpi_process(time_communicator)+1,
+                              0, time_communicator);
+    AssertThrowMPI(ierr);
+#else
+    (void)y;
+    Assert(false, ExcInternalError());
+#endif
+  }
+
+
+
+  template <typename VectorType>
+  void Parareal<VectorType>::receive_from_previous_slice(VectorType &y) const
+  {
+#ifdef DEAL_II_WITH_MPI
+    MPI_Status mpi_status;
+    int ierr = MPI_Recv(y.begin(), y.end()-y.begin(),
+                        Utilities::MPI::internal::mpi_type_id(y.begin()),
+                        Utilities::MPI::this_mpi_process(time_communicator)-1,
+                        0, time_communicator, &mpi_status);
+    AssertThrowMPI(ierr);
+
+    int count;
+    ierr = MPI_Get_count(&mpi_status,
+                         Utilities::MPI::internal::mpi_type_id(y.begin()),
+                         &count);
+    AssertThrowMPI(ierr);
+    AssertThrow(count == y.end()-y.begin(),
+                ExcMessage("The vectors on consecutive time slices need to have "
+                           "the same number of locally owned elements."));
+#else
+    (void)y;
+    Assert(false, ExcInternalError());
+#endif
+  }
 }
 
 DEAL_II_NAMESPACE_CLOSE
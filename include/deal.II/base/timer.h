@@ -22,13 +22,24 @@
 #include <deal.II/base/thread_management.h>
 #include <deal.II/base/utilities.h>
 
+#include <array>
 #include <chrono>
+#include <cstdint>
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 
 DEAL_II_NAMESPACE_OPEN
 
+namespace internal
+{
+  namespace TimerOutputImplementation
+  {
+    class PerformanceCounters;
+  }
+}
+
 /**
  * A clock, compatible with the <code>std::chrono</code> notion of a clock,
  * whose now() method returns a time point indicating the amount of CPU time
@@ -556,6 +567,41 @@ private:
  * sure that we only generate output on a single processor. See the step-32,
  * step-40, and step-42 tutorial programs for this kind of usage of this class.
  *
+ * The summary only shows the time of the processor that generates the
+ * output. The function print_wall_time_statistics() in addition prints the
+ * minimum, average and maximum wall time of each section over all processors
+ * of a communicator, which reveals load imbalance between the processors.
+ *
+ *
+ * <h3>Hardware performance counters</h3>
+ *
+ * On Linux systems, calling enable_performance_counters() makes the class
+ * read a set of hardware performance counters through the
+ * <code>perf_event</code> interface of the kernel upon entering and leaving
+ * each section, without attaching an external profiler. The counters
+ * recorded are the number of cycles and instructions, the number of misses
+ * in the last level cache, and optionally the number of floating point
+ * operations if a processor-specific raw event code for them is given. The
+ * function print_performance_counter_summary() then prints, for each
+ * section, the achieved GFLOP/s, an estimate of the memory bandwidth in GB/s
+ * based on the number of cache misses times the size of a cache line, and
+ * the instructions per cycle, which is the information needed to locate a
+ * section in a roofline model. Sections that are entered while another
+ * section is active are shown indented below the section that was active
+ * when they were entered for the first time.
+ *
+ * The counters measure the thread that calls enter_subsection() and
+ * leave_subsection(), which is all the work done in the section for programs
+ * that use one MPI process per core. The work done by other threads in the
+ * section, e.g. in tasks spawned by WorkStream, is not included. If the
+ * kernel does not allow access to the counters (see the file
+ * <code>/proc/sys/kernel/perf_event_paranoid</code>), or on other operating
+ * systems, enable_performance_counters() returns <code>false</code> and only
+ * times are recorded.
+ *
+ * If an event trace is recorded, see the EventTrace namespace, each call of
+ * a section is recorded as an event, in addition to being accumulated.
+ *
  * @ingroup utilities
  * @author M. Kronbichler, 2009.
  */
@@ -645,7 +691,26 @@ public:
     /**
      * Output number of calls.
      */
-    n_calls
+    n_calls,
+    /**
+     * Output the number of cycles recorded by the performance counters.
+     */
+    cycles,
+    /**
+     * Output the number of instructions recorded by the performance
+     * counters.
+     */
+    instructions,
+    /**
+     * Output the number of last level cache misses recorded by the
+     * performance counters.
+     */
+    cache_misses,
+    /**
+     * Output the number of floating point operations recorded by the
+     * performance counters.
+     */
+    floating_point_operations
   };
 
   /**
@@ -793,6 +858,44 @@ public:
    */
   void print_summary () const;
 
+  /**
+   * Print a formatted table with the minimum, average, and maximum wall time
+   * of each section over all processors in the given communicator, along
+   * with the ranks of the processors where the minimum and maximum were
+   * attained. This function must be called on all processors of the
+   * communicator, and all of them must have entered the same sections.
+   */
+  void print_wall_time_statistics (const MPI_Comm mpi_comm) const;
+
+  /**
+   * Start recording hardware performance counters for all sections entered
+   * from now on, see the documentation of this class. If
+   * @p raw_flop_event is nonzero, it is used as the processor-specific code
+   * of a raw <code>perf_event</code> event (as used by <tt>perf stat -e
+   * rNNNN</tt>) that counts floating point operations, and each event is
+   * counted as @p flops_per_event operations. For example, on Intel
+   * processors since Skylake, the event
+   * <tt>FP_ARITH_INST_RETIRED.256B_PACKED_DOUBLE</tt> has the code
+   * <tt>0x10c7</tt> and represents four operations.
+   *
+   * Return whether the counters could be set up. If not, only the times are
+   * recorded, as if this function had not been called.
+   */
+  bool enable_performance_counters (const unsigned long long raw_flop_event = 0,
+                                    const double             flops_per_event = 1.);
+
+  /**
+   * Print a formatted table with the values derived from the hardware
+   * performance counters for each section, with nested sections indented
+   * below their parent section. If the object was constructed with an MPI
+   * communicator, the counters are summed over all processors and the rates
+   * are computed with the maximal wall time of the section over all
+   * processors, i.e., the table shows the performance of the whole parallel
+   * program. In that case, this function must be called on all processors
+   * and all of them must have entered the same sections.
+   */
+  void print_performance_counter_summary () const;
+
   /**
    * By calling this function, all output can be disabled. This function
    * together with enable_output() can be useful if one wants to control the
@@ -842,6 +945,26 @@ private:
     double total_cpu_time;
     double total_wall_time;
     unsigned int n_calls;
+
+    /**
+     * The name of the section that was active when this section was entered
+     * for the first time, or an empty string for a top-level section.
+     */
+    std::string parent;
+
+    /**
+     * The values of the performance counters when the section was entered
+     * the last time, and the accumulated differences of the counters over
+     * all calls.
+     */
+    std::array<double,4> counters_at_entry;
+    std::array<double,4> total_counters;
+
+    /**
+     * The time at which the section was entered the last time, as given by
+     * EventTrace::now(), or zero if no event trace is recorded.
+     */
+    std::uint64_t trace_begin_time;
   };
 
   /**
@@ -873,6 +996,12 @@ private:
    */
   MPI_Comm            mpi_communicator;
 
+  /**
+   * The hardware performance counters, or a null pointer if they are not
+   * used.
+   */
+  std::shared_ptr<internal::TimerOutputImplementation::PerformanceCounters> performance_counters;
+
   /**
    * A lock that makes sure that this class gives reasonable results even when
    * used with several threads.
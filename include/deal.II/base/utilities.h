@@ -24,6 +24,8 @@
 #include <functional>
 #include <string>
 #include <tuple>
+#include <type_traits>
+#include <cstring>
 
 #ifdef DEAL_II_WITH_TRILINOS
 #  include <Epetra_Comm.h>
@@ -391,18 +393,58 @@ namespace Utilities
   std::vector<unsigned long long int>
   invert_permutation (const std::vector<unsigned long long int> &permutation);
 
+  /**
+   * The compression applied by Utilities::pack() to the serialized data of
+   * an object, which needs to be given to Utilities::unpack() as well.
+   * Compression is only available if the library has been compiled with
+   * ZLIB; otherwise, all settings result in uncompressed data.
+   */
+  enum Compression
+  {
+    /**
+     * Do not compress the data.
+     */
+    no_compression,
+
+    /**
+     * Use the fastest compression level of the gzip algorithm.
+     */
+    fast_compression,
+
+    /**
+     * Use the best (and slowest) compression level of the gzip algorithm.
+     */
+    best_compression
+  };
+
   /**
    * Given an arbitrary object of type T, use boost::serialization utilities
    * to pack the object into a vector of characters. The object can be unpacked
    * using the Utilities::unpack function below.
    *
    * If the library has been compiled with ZLIB enabled, then the output buffer
-   * is compressed.
+   * is compressed as selected by @p compression.
+   *
+   * Objects of trivially copyable types, like Point or CellId, and
+   * std::vector objects with elements of such types are not serialized but
+   * copied byte by byte into the buffer, without compression.
    *
    * @author Timo Heister, Wolfgang Bangerth, 2017.
    */
   template<typename T>
-  std::vector<char> pack(const T &object);
+  std::vector<char> pack(const T &object,
+                         const Compression compression = best_compression);
+
+  /**
+   * Same as above, but append the packed object to the end of the given
+   * @p dest_buffer rather than returning a new vector. This allows to pack
+   * several objects into one buffer, or to reuse the memory of a buffer for
+   * repeated communication. Returns the number of characters appended.
+   */
+  template<typename T>
+  std::size_t pack(const T           &object,
+                   std::vector<char> &dest_buffer,
+                   const Compression  compression = best_compression);
 
   /**
    * Given a vector of characters, obtained through a call to the function
@@ -410,12 +452,24 @@ namespace Utilities
    *
    * This function uses boost::serialization utilities to unpack the object
    * from a vector of characters, and it is the inverse of the function
-   * Utilities::pack
+   * Utilities::pack. The argument @p compression must be the same as in the
+   * call to Utilities::pack.
    *
    * @author Timo Heister, Wolfgang Bangerth, 2017.
    */
   template<typename T>
-  T unpack(const std::vector<char> &buffer);
+  T unpack(const std::vector<char> &buffer,
+           const Compression        compression = best_compression);
+
+  /**
+   * Same as above, but restore the object from the characters in the range
+   * <tt>[cbegin, cend)</tt> of a buffer, e.g., one of several objects that
+   * have been appended to one buffer by Utilities::pack.
+   */
+  template<typename T>
+  T unpack(const std::vector<char>::const_iterator &cbegin,
+           const std::vector<char>::const_iterator &cend,
+           const Compression                        compression = best_compression);
 
   /**
    * A namespace for utility functions that probe system properties.
@@ -501,6 +555,63 @@ namespace Utilities
      * leaving this task to the calling site.
      */
     void posix_memalign (void **memptr, size_t alignment, size_t size);
+
+    /**
+     * A read-only view of the content of a file. On POSIX systems, the file
+     * is mapped into memory with <code>mmap</code>, so that its content is
+     * only read from disk, or taken from the page cache of the operating
+     * system, when it is accessed, and no copy through a stream buffer is
+     * made. On other systems, the file is read into memory by the
+     * constructor.
+     *
+     * This class is used by the functions that read the data written by the
+     * <code>block_write()</code> functions of the vector and matrix classes,
+     * such as Vector::block_read_mapped().
+     */
+    class MemoryMappedFile
+    {
+    public:
+      /**
+       * Constructor. Map the file @p filename into memory. Throws an ExcIO
+       * exception if the file can not be opened.
+       */
+      MemoryMappedFile (const std::string &filename);
+
+      /**
+       * Destructor. Removes the mapping.
+       */
+      ~MemoryMappedFile ();
+
+      MemoryMappedFile (const MemoryMappedFile &) = delete;
+      MemoryMappedFile &operator = (const MemoryMappedFile &) = delete;
+
+      /**
+       * Return a pointer to the first character of the file.
+       */
+      const char *data () const;
+
+      /**
+       * Return the size of the file in bytes.
+       */
+      std::size_t size () const;
+
+    private:
+      /**
+       * The beginning of the mapped memory.
+       */
+      const char *file_data;
+
+      /**
+       * The size of the file.
+       */
+      std::size_t file_size;
+
+      /**
+       * The memory the file is read into on systems without
+       * <code>mmap</code>.
+       */
+      std::vector<char> buffer;
+    };
   }
 
 
@@ -773,61 +884,214 @@ namespace Utilities
 
 
 
-  template<typename T>
-  std::vector<char> pack(const T &object)
+  namespace internal
   {
-    // set up a buffer and then use it as the target of a compressing
-    // stream into which we serialize the current object
-    std::vector<char> buffer;
+    /**
+     * Whether objects of type T can be packed by copying their bytes.
+     */
+    template <typename T>
+    struct IsBitwisePackable
+    {
+#ifdef DEAL_II_HAVE_CXX11_IS_TRIVIALLY_COPYABLE
+      static const bool value = std::is_trivially_copyable<T>::value;
+#else
+      static const bool value = std::is_trivial<T>::value;
+#endif
+    };
+
+
+
+    /**
+     * A class implementing Utilities::pack and Utilities::unpack. The general
+     * case serializes the object with boost::serialization.
+     */
+    template <typename T, typename Enable = void>
+    struct Packer
     {
+      static void pack (const T           &object,
+                        std::vector<char> &dest_buffer,
+                        const Compression  compression)
+      {
 #ifdef DEAL_II_WITH_ZLIB
-      boost::iostreams::filtering_ostream out;
-      out.push(boost::iostreams::gzip_compressor
-               (boost::iostreams::gzip_params
-                (boost::iostreams::gzip::best_compression)));
-      out.push(boost::iostreams::back_inserter(buffer));
-
-      boost::archive::binary_oarchive archive(out);
-      archive << object;
-      out.flush();
+        boost::iostreams::filtering_ostream out;
+        if (compression != no_compression)
+          out.push(boost::iostreams::gzip_compressor
+                   (boost::iostreams::gzip_params
+                    (compression == best_compression ?
+                     boost::iostreams::gzip::best_compression :
+                     boost::iostreams::gzip::best_speed)));
+        out.push(boost::iostreams::back_inserter(dest_buffer));
+
+        boost::archive::binary_oarchive archive(out);
+        archive << object;
+        out.flush();
 #else
-      std::ostringstream out;
-      boost::archive::binary_oarchive archive(out);
-      archive << object;
-      const std::string &s = out.str();
-      buffer.reserve(s.size());
-      buffer.assign(s.begin(), s.end());
+        (void)compression;
+        std::ostringstream out;
+        boost::archive::binary_oarchive archive(out);
+        archive << object;
+        const std::string &s = out.str();
+        dest_buffer.insert(dest_buffer.end(), s.begin(), s.end());
 #endif
-    }
+      }
+
+      static T unpack (const std::vector<char>::const_iterator &cbegin,
+                       const std::vector<char>::const_iterator &cend,
+                       const Compression                        compression)
+      {
+        std::string decompressed_buffer;
+        T object;
+
+        // first decompress the buffer
+        {
+#ifdef DEAL_II_WITH_ZLIB
+          if (compression != no_compression)
+            {
+              boost::iostreams::filtering_ostream decompressing_stream;
+              decompressing_stream.push(boost::iostreams::gzip_decompressor());
+              decompressing_stream.push(boost::iostreams::back_inserter(decompressed_buffer));
+              decompressing_stream.write (&*cbegin, std::distance(cbegin, cend));
+            }
+          else
+#else
+          (void)compression;
+#endif
+            decompressed_buffer.assign (cbegin, cend);
+        }
+
+        // then restore the object from the buffer
+        std::istringstream in(decompressed_buffer);
+        boost::archive::binary_iarchive archive(in);
+
+        archive >> object;
+        return object;
+      }
+    };
+
+
+
+    /**
+     * Packing of trivially copyable objects by a copy of their bytes.
+     */
+    template <typename T>
+    struct Packer<T, typename std::enable_if<IsBitwisePackable<T>::value>::type>
+    {
+      static void pack (const T           &object,
+                        std::vector<char> &dest_buffer,
+                        const Compression)
+      {
+        const std::size_t previous_size = dest_buffer.size();
+        dest_buffer.resize (previous_size + sizeof(T));
+        std::memcpy (dest_buffer.data() + previous_size,
+                     reinterpret_cast<const char *>(&object), sizeof(T));
+      }
+
+      static T unpack (const std::vector<char>::const_iterator &cbegin,
+                       const std::vector<char>::const_iterator &cend,
+                       const Compression)
+      {
+        (void)cend;
+        Assert (std::distance(cbegin, cend) == sizeof(T),
+                ExcMessage("The buffer does not have the size of the object "
+                           "to be unpacked."));
+        T object;
+        std::memcpy (reinterpret_cast<char *>(&object), &*cbegin, sizeof(T));
+        return object;
+      }
+    };
+
+
+
+    /**
+     * Packing of vectors of trivially copyable objects by their number
+     * followed by a copy of the bytes of their elements.
+     */
+    template <typename T>
+    struct Packer<std::vector<T>, typename std::enable_if<IsBitwisePackable<T>::value>::type>
+    {
+      static void pack (const std::vector<T> &object,
+                        std::vector<char>    &dest_buffer,
+                        const Compression)
+      {
+        const std::size_t previous_size = dest_buffer.size();
+        const std::size_t n_elements = object.size();
+        dest_buffer.resize (previous_size + sizeof(std::size_t) +
+                            n_elements*sizeof(T));
+        std::memcpy (dest_buffer.data() + previous_size,
+                     reinterpret_cast<const char *>(&n_elements),
+                     sizeof(std::size_t));
+        if (n_elements > 0)
+          std::memcpy (dest_buffer.data() + previous_size + sizeof(std::size_t),
+                       reinterpret_cast<const char *>(object.data()),
+                       n_elements*sizeof(T));
+      }
+
+      static std::vector<T>
+      unpack (const std::vector<char>::const_iterator &cbegin,
+              const std::vector<char>::const_iterator &cend,
+              const Compression)
+      {
+        (void)cend;
+        std::size_t n_elements = 0;
+        Assert (std::distance(cbegin, cend) >= std::ptrdiff_t(sizeof(std::size_t)),
+                ExcMessage("The buffer is too small for the object to be "
+                           "unpacked."));
+        std::memcpy (reinterpret_cast<char *>(&n_elements), &*cbegin,
+                     sizeof(std::size_t));
+        Assert (std::size_t(std::distance(cbegin, cend)) ==
+                sizeof(std::size_t) + n_elements*sizeof(T),
+                ExcMessage("The buffer does not have the size of the object "
+                           "to be unpacked."));
+        std::vector<T> object (n_elements);
+        if (n_elements > 0)
+          std::memcpy (reinterpret_cast<char *>(object.data()),
+                       &*cbegin + sizeof(std::size_t),
+                       n_elements*sizeof(T));
+        return object;
+      }
+    };
+  }
+
+
+
+  template<typename T>
+  std::size_t pack(const T           &object,
+                   std::vector<char> &dest_buffer,
+                   const Compression  compression)
+  {
+    const std::size_t previous_size = dest_buffer.size();
+    internal::Packer<T>::pack (object, dest_buffer, compression);
+    return dest_buffer.size() - previous_size;
+  }
+
+
+
+  template<typename T>
+  std::vector<char> pack(const T          &object,
+                         const Compression compression)
+  {
+    std::vector<char> buffer;
+    pack (object, buffer, compression);
     return buffer;
   }
 
 
 
   template<typename T>
-  T unpack(const std::vector<char> &buffer)
+  T unpack(const std::vector<char>::const_iterator &cbegin,
+           const std::vector<char>::const_iterator &cend,
+           const Compression                        compression)
   {
-    std::string decompressed_buffer;
-    T object;
+    return internal::Packer<T>::unpack (cbegin, cend, compression);
+  }
 
-    // first decompress the buffer
-    {
-#ifdef DEAL_II_WITH_ZLIB
-      boost::iostreams::filtering_ostream decompressing_stream;
-      decompressing_stream.push(boost::iostreams::gzip_decompressor());
-      decompressing_stream.push(boost::iostreams::back_inserter(decompressed_buffer));
-      decompressing_stream.write (buffer.data(), buffer.size());
-#else
-      decompressed_buffer.assign (buffer.begin(), buffer.end());
-#endif
-    }
 
-    // then restore the object from the buffer
-    std::istringstream in(decompressed_buffer);
-    boost::archive::binary_iarchive archive(in);
 
-    archive >> object;
-    return object;
+  template<typename T>
+  T unpack(const std::vector<char> &buffer,
+           const Compression        compression)
+  {
+    return unpack<T> (buffer.cbegin(), buffer.cend(), compression);
   }
 }
 
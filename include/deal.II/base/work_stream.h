@@ -18,6 +18,7 @@
 
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/event_trace.h>
 #include <deal.II/base/graph_coloring.h>
 #include <deal.II/base/multithread_info.h>
 #include <deal.II/base/thread_management.h>
@@ -545,6 +546,7 @@ namespace WorkStream
           // given. since these worker functions are called on separate threads,
           // nothing good can happen if they throw an exception and we are best
           // off catching it and showing an error message
+          EventTrace::Scope trace_scope ("WorkStream worker", "WorkStream");
           for (unsigned int i=0; i<current_item->n_items; ++i)
             {
               try
@@ -649,6 +651,7 @@ namespace WorkStream
           // initiate copying data. for the same reasons as in the worker class
           // above, catch exceptions rather than letting it propagate into
           // unknown territories
+          EventTrace::Scope trace_scope ("WorkStream copier", "WorkStream");
           for (unsigned int i=0; i<current_item->n_items; ++i)
             {
               try
@@ -821,6 +824,8 @@ namespace WorkStream
 
           // then call the worker and copier functions on each
           // element of the chunk we were given.
+          EventTrace::Scope trace_scope ("WorkStream worker and copier",
+                                         "WorkStream");
           for (typename std::vector<Iterator>::const_iterator p=range.begin();
                p != range.end(); ++p)
             {
@@ -1180,6 +1185,170 @@ namespace WorkStream
 
 
 
+  /**
+   * A variant of the run() functions above in which the copier function is
+   * not a serialization point: the worker and the copier are called one
+   * after the other on the same thread for each element of the range, and
+   * the copier calls for different elements may run concurrently. This
+   * avoids both the sequential copier stage of the pipeline used by
+   * run(begin,end,...) and the need to color the mesh for
+   * run(colored_iterators,...), which pays off if the local computations are
+   * cheap and the copier therefore limits the scaling of the assembly.
+   *
+   * Since several copiers write into the global objects at the same time,
+   * the copier must only modify these objects in a thread-safe way. The
+   * typical use is to enable atomic additions on the global matrix and
+   * vector and to call ConstraintMatrix::distribute_local_to_global() in the
+   * copier:
+   * @code
+   *   system_matrix.set_atomic_add_mode (true);
+   *   system_rhs.set_atomic_add_mode (true);
+   *   WorkStream::run_with_concurrent_copiers
+   *     (dof_handler.begin_active(), dof_handler.end(),
+   *      worker,
+   *      [&](const CopyData &data)
+   *      {
+   *        constraints.distribute_local_to_global (data.cell_matrix,
+   *                                                data.cell_rhs,
+   *                                                data.local_dof_indices,
+   *                                                system_matrix, system_rhs);
+   *      },
+   *      ScratchData(...), CopyData(...));
+   *   system_matrix.set_atomic_add_mode (false);
+   *   system_rhs.set_atomic_add_mode (false);
+   * @endcode
+   * See SparseMatrix::set_atomic_add_mode() and Vector::set_atomic_add_mode()
+   * for what is covered by the atomic mode. In particular, the vector must
+   * only be written through its collective add() functions. This is the
+   * case for the path of ConstraintMatrix::distribute_local_to_global() for
+   * a matrix and a vector of the same number type, but not for constrained
+   * degrees of freedom with inhomogeneities when
+   * <tt>use_inhomogeneities_for_rhs</tt> is set.
+   *
+   * The range is copied into an array of iterators first, and the elements
+   * of this array are distributed in chunks of @p chunk_size elements among
+   * the threads. The arguments have the same meaning as for the other run()
+   * functions.
+   */
+  template <typename Worker,
+            typename Copier,
+            typename Iterator,
+            typename ScratchData,
+            typename CopyData>
+  void
+  run_with_concurrent_copiers (const Iterator                          &begin,
+                               const typename identity<Iterator>::type &end,
+                               Worker                                   worker,
+                               Copier                                   copier,
+                               const ScratchData                       &sample_scratch_data,
+                               const CopyData                          &sample_copy_data,
+                               const unsigned int                       chunk_size = 8)
+  {
+    Assert (chunk_size > 0,
+            ExcMessage ("The chunk_size must be at least one."));
+
+    // if no work then skip. (only use operator!= for iterators since we may
+    // not have an equality comparison operator)
+    if (!(begin != end))
+      return;
+
+    // a single color containing all elements makes implementation 3 call
+    // worker and copier on each thread without any synchronization
+    std::vector<std::vector<Iterator> > all_iterators (1);
+    for (Iterator p=begin; p!=end; ++p)
+      all_iterators[0].push_back (p);
+
+    run (all_iterators,
+         worker, copier,
+         sample_scratch_data,
+         sample_copy_data,
+         2*MultithreadInfo::n_threads(),
+         chunk_size);
+  }
+
+
+
+
+
+  /**
+   * A variant of the run() function taking a range of iterators that
+   * distributes the work by work stealing rather than by a pipeline. The
+   * pipeline of run(begin,end,...) hands out chunks of a fixed number of
+   * @p chunk_size elements, and a thread that has received a chunk with
+   * particularly expensive elements, as is common for hp-adaptive meshes
+   * where the cost of a cell can vary by two orders of magnitude, keeps the
+   * other threads waiting at the end of the range. Here, the elements are
+   * collected in an array that is recursively split by
+   * <code>tbb::parallel_for</code> with an automatic partitioner: idle threads
+   * steal the unprocessed parts of the ranges of busy threads, so that the
+   * chunk sizes adapt to the actual cost of the elements, down to chunks of
+   * @p grain_size elements.
+   *
+   * The worker and copier functions are used in the same way as for the
+   * other run() functions: the copier is called right after the worker on
+   * the same thread, but under a lock, so that no two copiers run at the
+   * same time and the copier needs no synchronization. Unlike in
+   * run(begin,end,...), however, the copier is not called in the order of
+   * the elements in the range, so floating point sums computed by the
+   * copier may differ in the last digits from run to run. If the copier can
+   * work concurrently, e.g. since the global objects use atomic additions,
+   * run_with_concurrent_copiers() avoids the lock altogether.
+   *
+   * One copy of @p sample_scratch_data and @p sample_copy_data is created
+   * per thread (plus a few more if a thread is interrupted by a stolen task
+   * of the same loop).
+   */
+  template <typename Worker,
+            typename Copier,
+            typename Iterator,
+            typename ScratchData,
+            typename CopyData>
+  void
+  run_with_work_stealing (const Iterator                          &begin,
+                          const typename identity<Iterator>::type &end,
+                          Worker                                   worker,
+                          Copier                                   copier,
+                          const ScratchData                       &sample_scratch_data,
+                          const CopyData                          &sample_copy_data,
+                          const unsigned int                       grain_size = 1)
+  {
+    Assert (grain_size > 0,
+            ExcMessage ("The grain_size must be at least one."));
+
+    // if no work then skip. (only use operator!= for iterators since we may
+    // not have an equality comparison operator)
+    if (!(begin != end))
+      return;
+
+    std::vector<std::vector<Iterator> > all_iterators (1);
+    for (Iterator p=begin; p!=end; ++p)
+      all_iterators[0].push_back (p);
+
+    // serialize the calls to the copier through a mutex. implementation 3
+    // with a single color then runs the workers without any synchronization
+    // and splits the range in the work-stealing manner of tbb::parallel_for
+    const std::function<void (const CopyData &)> copier_function = copier;
+    std::function<void (const CopyData &)> serialized_copier;
+    Threads::Mutex copier_mutex;
+    if (copier_function)
+      serialized_copier = [&](const CopyData &copy_data)
+      {
+        Threads::Mutex::ScopedLock lock (copier_mutex);
+        copier_function (copy_data);
+      };
+
+    run (all_iterators,
+         worker, serialized_copier,
+         sample_scratch_data,
+         sample_copy_data,
+         2*MultithreadInfo::n_threads(),
+         grain_size);
+  }
+
+
+
+
+
   /**
    * This is a variant of one of the two main functions of the WorkStream
    * concept, doing work as described in the introduction to this namespace.
@@ -21,9 +21,12 @@
 #include <deal.II/differentiation/ad/ad_number_types.h>
 #include <deal.II/differentiation/ad/ad_number_traits.h>
 
+#include <deal.II/differentiation/ad/dual_number.h>
+
 #include <deal.II/differentiation/ad/adolc_math.h>
 #include <deal.II/differentiation/ad/adolc_number_types.h>
 #include <deal.II/differentiation/ad/adolc_product_types.h>
+#include <deal.II/differentiation/ad/adolc_taped_function.h>
 
 #include <deal.II/differentiation/ad/sacado_math.h>
 #include <deal.II/differentiation/ad/sacado_number_types.h>
@@ -45,6 +48,11 @@ namespace Differentiation
   *   - Adol-C
   *   - Sacado (a component of Trilinos)
   *
+  * In addition, the forward-mode number type DualNumber is implemented
+  * directly, and can be used with VectorizedArray in matrix-free operators.
+  * For Adol-C, the class TapedFunction records the tape of a function once
+  * and replays it for many evaluation points.
+  *
   * @ingroup auto_symb_diff
   */
   namespace AD
@@ -0,0 +1,334 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_differentiation_ad_adolc_taped_function_h
+#define dealii_differentiation_ad_adolc_taped_function_h
+
+#include <deal.II/base/config.h>
+
+#ifdef DEAL_II_WITH_ADOLC
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/thread_local_storage.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/lac/full_matrix.h>
+
+#include <deal.II/differentiation/ad/adolc_number_types.h>
+
+#include <functional>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace Differentiation
+{
+  namespace AD
+  {
+    /**
+     * A function $f:\mathbb R^n \rightarrow \mathbb R^m$ whose operations are
+     * recorded once on an Adol-C tape, and whose values and derivatives are
+     * subsequently computed by replaying the tape at an arbitrary number of
+     * evaluation points.
+     *
+     * In the taped workflow of Adol-C, the operations of a function are
+     * recorded for one particular set of values of the independent variables
+     * and are then evaluated by the drivers of Adol-C. If a constitutive law
+     * is assembled in this way, recording a new tape for every quadrature
+     * point of every cell often dominates the cost of the assembly, although
+     * the sequence of operations is the same at all of these points. This
+     * class instead records the tape upon the first evaluation and replays it
+     * for all following evaluation points, for example in the following way:
+     * @code
+     *   Differentiation::AD::TapedFunction energy
+     *     (n_independent_variables, 1,
+     *      [&](const std::vector<adouble> &x,
+     *          std::vector<adouble>       &psi)
+     *   {
+     *     psi[0] = compute_energy (x, material_parameters);
+     *   });
+     *
+     *   for (const auto &cell : dof_handler.active_cell_iterators())
+     *     {
+     *       ...
+     *       for (unsigned int q=0; q<n_q_points; ++q)
+     *         {
+     *           energy.gradient (values_at_q_point[q], gradient);
+     *           energy.hessian (values_at_q_point[q], hessian);
+     *           ...
+     *         }
+     *     }
+     * @endcode
+     * The functions gradients(), hessians() and jacobians() evaluate the
+     * derivatives at a whole batch of points, for example all quadrature
+     * points of a cell, in one call.
+     *
+     * The function that is recorded must not contain any code whose sequence
+     * of operations depends on the values of the independent variables, such
+     * as branches on these values, unless these are implemented with the
+     * conditional assignment functions of Adol-C. If the drivers of Adol-C
+     * detect at an evaluation point that a comparison evaluates differently
+     * than during the recording, a conditional assignment switches its
+     * branch, or a function is evaluated outside the part of its domain in
+     * which it was recorded, the tape is recorded anew at that point and the
+     * evaluation is repeated. Such a re-recording is counted by
+     * n_recordings().
+     *
+     * <h3>Multithreading</h3>
+     *
+     * Each thread that evaluates an object of this class, for example within
+     * WorkStream::run(), records and replays its own tape, so that the
+     * evaluations by different threads do not interfere with each other
+     * through the state of a shared tape. The tape indices of Adol-C used by
+     * objects of this class are allocated from a common counter starting at
+     * the value passed to set_first_tape_index(), and the tapes are removed
+     * by the destructor. Note that Adol-C stores the information on all tapes
+     * in global state, so the recording of tapes is serialized by a mutex,
+     * and the evaluation from several threads at the same time requires an
+     * Adol-C installation that has been compiled with support for
+     * multithreading.
+     *
+     * @ingroup auto_symb_diff
+     */
+    class TapedFunction : public Subscriptor
+    {
+    public:
+      /**
+       * The type of the function that is recorded on the tapes. Its first
+       * argument are the independent variables, the second argument has the
+       * size of the number of dependent variables and needs to be filled
+       * with the values of the dependent variables.
+       */
+      typedef std::function<void (const std::vector<adouble> &,
+                                  std::vector<adouble> &)> RecordedFunction;
+
+      /**
+       * Constructor. The function @p function is recorded on a tape upon the
+       * first evaluation of this object on each thread.
+       */
+      TapedFunction (const unsigned int      n_independent_variables,
+                     const unsigned int      n_dependent_variables,
+                     const RecordedFunction &function);
+
+      /**
+       * Destructor. Removes the tapes recorded by this object.
+       */
+      ~TapedFunction ();
+
+      /**
+       * Copying an object of this class is not possible, since the tapes
+       * belong to exactly one object.
+       */
+      TapedFunction (const TapedFunction &) = delete;
+
+      /**
+       * Copying an object of this class is not possible, since the tapes
+       * belong to exactly one object.
+       */
+      TapedFunction &operator = (const TapedFunction &) = delete;
+
+      /**
+       * Return the number of independent variables.
+       */
+      unsigned int n_independent_variables () const;
+
+      /**
+       * Return the number of dependent variables.
+       */
+      unsigned int n_dependent_variables () const;
+
+      /**
+       * Evaluate the values of the dependent variables at the point
+       * @p x. The vector @p values is resized to the number of dependent
+       * variables.
+       */
+      void value (const std::vector<double> &x,
+                  std::vector<double>       &values) const;
+
+      /**
+       * Compute the gradient of the function at the point @p x. This
+       * function can only be called for functions with a single dependent
+       * variable. The vector @p gradient is resized to the number of
+       * independent variables.
+       */
+      void gradient (const std::vector<double> &x,
+                     std::vector<double>       &gradient) const;
+
+      /**
+       * Compute the Hessian of the function at the point @p x. This function
+       * can only be called for functions with a single dependent variable.
+       * The matrix @p hessian is resized to the number of independent
+       * variables; both its lower and its upper triangle are filled.
+       */
+      void hessian (const std::vector<double> &x,
+                    FullMatrix<double>        &hessian) const;
+
+      /**
+       * Compute the Jacobian of the function at the point @p x. The matrix
+       * @p jacobian is resized to the number of dependent times the number of
+       * independent variables.
+       */
+      void jacobian (const std::vector<double> &x,
+                     FullMatrix<double>        &jacobian) const;
+
+      /**
+       * Compute the gradients of the function at all the points in @p x, by
+       * replaying the same tape. The output vector is resized to the number
+       * of points.
+       */
+      void gradients (const std::vector<std::vector<double> > &x,
+                      std::vector<std::vector<double> >       &gradients) const;
+
+      /**
+       * Compute the Hessians of the function at all the points in @p x, by
+       * replaying the same tape. The output vector is resized to the number
+       * of points.
+       */
+      void hessians (const std::vector<std::vector<double> > &x,
+                     std::vector<FullMatrix<double> >        &hessians) const;
+
+      /**
+       * Compute the Jacobians of the function at all the points in @p x, by
+       * replaying the same tape. The output vector is resized to the number
+       * of points.
+       */
+      void jacobians (const std::vector<std::vector<double> > &x,
+                      std::vector<FullMatrix<double> >        &jacobians) const;
+
+      /**
+       * Return the number of times the function has been recorded on a tape
+       * by all threads together, including the re-recordings because the
+       * sequence of operations changed between evaluation points.
+       */
+      unsigned int n_recordings () const;
+
+      /**
+       * Set the first tape index of Adol-C that is used by the objects of
+       * this class. The default is 1000, which leaves the smaller indices to
+       * the tapes recorded by user codes. This function only affects the
+       * objects that are created after a call to it.
+       */
+      static void set_first_tape_index (const unsigned int index);
+
+      /**
+       * Exception.
+       */
+      DeclException2 (ExcAdolCDriverFailed,
+                      std::string, int,
+                      << "The Adol-C driver " << arg1 << " failed with the return "
+                      << "value " << arg2 << ", even after the tape had been recorded "
+                      << "anew at the evaluation point.");
+
+    private:
+      /**
+       * The tape of one thread.
+       */
+      struct Tape
+      {
+        /**
+         * Constructor. Marks the tape as not recorded yet.
+         */
+        Tape ();
+
+        /**
+         * The index of the tape within Adol-C, or -1 if the tape has not
+         * been recorded yet.
+         */
+        short index;
+      };
+
+      /**
+       * Return the index of the tape of the current thread, recording the
+       * tape at the point @p x if that has not happened yet.
+       */
+      short get_tape (const std::vector<double> &x) const;
+
+      /**
+       * Record the function on the tape with index @p index at the point
+       * @p x.
+       */
+      void record (const short                index,
+                   const std::vector<double> &x) const;
+
+      /**
+       * Call the Adol-C driver @p driver on the tape of the current thread.
+       * If the driver signals with a negative return value that the tape is
+       * not valid at the point @p x, the tape is recorded anew at that point
+       * and the driver is called once more.
+       */
+      void evaluate (const std::vector<double>         &x,
+                     const std::function<int (short)>  &driver,
+                     const char                        *driver_name) const;
+
+      const unsigned int n_independent;
+      const unsigned int n_dependent;
+      const RecordedFunction function;
+
+      /**
+       * The tapes of the threads that have evaluated this object so far.
+       */
+      mutable Threads::ThreadLocalStorage<Tape> tapes;
+
+      /**
+       * The indices of all tapes recorded by this object, for removing them
+       * in the destructor.
+       */
+      mutable std::vector<short> tape_indices;
+
+      /**
+       * The number of recordings so far.
+       */
+      mutable unsigned int recording_count;
+
+      /**
+       * Scratch arrays for the row pointers of the matrices passed to the
+       * drivers of Adol-C.
+       */
+      mutable Threads::ThreadLocalStorage<std::vector<double *> > row_pointers;
+    };
+
+
+    /* ---------------------------- inline functions ---------------------------- */
+
+#ifndef DOXYGEN
+
+    inline
+    unsigned int
+    TapedFunction::n_independent_variables () const
+    {
+      return n_independent;
+    }
+
+
+
+    inline
+    unsigned int
+    TapedFunction::n_dependent_variables () const
+    {
+      return n_dependent;
+    }
+
+#endif // DOXYGEN
+
+  } // namespace AD
+} // namespace Differentiation
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif // DEAL_II_WITH_ADOLC
+
+#endif
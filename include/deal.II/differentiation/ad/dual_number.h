@@ -0,0 +1,919 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_differentiation_ad_dual_number_h
+#define dealii_differentiation_ad_dual_number_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/numbers.h>
+#include <deal.II/base/template_constraints.h>
+#include <deal.II/base/vectorization.h>
+
+#include <cmath>
+#include <type_traits>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace Differentiation
+{
+  namespace AD
+  {
+
+    /**
+     * A tapeless forward-mode auto-differentiable number with a fixed number
+     * of directional derivatives, similar to Sacado::Fad::SFad. In contrast
+     * to the number types of Sacado and Adol-C, the value type can be a
+     * VectorizedArray, in which case each lane of the vector holds the value
+     * and the derivatives for a different quadrature point or cell. This
+     * allows to differentiate a constitutive law evaluated on the data of
+     * FEEvaluation, which returns values and gradients as (tensors of)
+     * VectorizedArray, without falling back to scalar assembly.
+     *
+     * The number can be used as the number type of Tensor and
+     * SymmetricTensor. As an example, the first Piola-Kirchhoff stress
+     * $P=\partial \Psi/\partial F$ and its linearization in direction of the
+     * gradient of an increment can be computed in a matrix-free operator by
+     * @code
+     *   typedef Differentiation::AD::DualNumber<VectorizedArray<double>,dim*dim> ADNumber;
+     *
+     *   const Tensor<2,dim,VectorizedArray<double> > grad_u = phi.get_gradient(q);
+     *   Tensor<2,dim,ADNumber> F;
+     *   for (unsigned int i=0; i<dim; ++i)
+     *     for (unsigned int j=0; j<dim; ++j)
+     *       F[i][j] = ADNumber((i==j ? 1. : 0.) + grad_u[i][j], i*dim+j);
+     *
+     *   const ADNumber psi = strain_energy (F);
+     *   Tensor<2,dim,VectorizedArray<double> > P;
+     *   for (unsigned int i=0; i<dim; ++i)
+     *     for (unsigned int j=0; j<dim; ++j)
+     *       P[i][j] = psi.derivative(i*dim+j);
+     * @endcode
+     * where <tt>strain_energy</tt> is a function templated on the number type.
+     * Nesting the class, as in
+     * <tt>DualNumber<DualNumber<VectorizedArray<double>,n>,n></tt>, gives
+     * access to second derivatives.
+     *
+     * The directional derivatives are stored in a plain array of size
+     * @p n_derivatives, such that all operations can be inlined and unrolled
+     * by the compiler.
+     *
+     * @tparam ValueType The type of the value and the derivatives, e.g.,
+     * <tt>double</tt>, <tt>VectorizedArray<double></tt>, or another
+     * DualNumber.
+     * @tparam n_derivatives The number of independent variables.
+     */
+    template <typename ValueType, int n_derivatives>
+    class DualNumber
+    {
+    public:
+      static_assert (n_derivatives > 0,
+                     "The number of derivatives must be positive.");
+
+      /**
+       * The type of the value and the derivatives.
+       */
+      typedef ValueType value_type;
+
+      /**
+       * The number of directional derivatives.
+       */
+      static const unsigned int n_directional_derivatives = n_derivatives;
+
+      /**
+       * Constructor. Sets the value and all derivatives to zero.
+       */
+      DualNumber ();
+
+      /**
+       * Constructor for a constant, i.e., a number with the value @p value
+       * and vanishing derivatives.
+       */
+      DualNumber (const ValueType &value);
+
+      /**
+       * Constructor for a constant from a scalar that is converted to the
+       * value type, e.g., a <tt>double</tt> that is broadcast to all lanes of
+       * a VectorizedArray.
+       */
+      template <typename OtherNumber,
+                typename = typename std::enable_if<std::is_arithmetic<OtherNumber>::value &&
+                                                   !std::is_same<OtherNumber,ValueType>::value>::type>
+      DualNumber (const OtherNumber &value);
+
+      /**
+       * Constructor for the independent variable with index
+       * @p independent_variable, i.e., a number with the value @p value,
+       * whose derivative in this direction is one and whose other
+       * derivatives are zero.
+       */
+      DualNumber (const ValueType   &value,
+                  const unsigned int independent_variable);
+
+      /**
+       * Read-write access to the value.
+       */
+      ValueType &value ();
+
+      /**
+       * Read access to the value.
+       */
+      const ValueType &value () const;
+
+      /**
+       * Read-write access to the derivative in direction @p i.
+       */
+      ValueType &derivative (const unsigned int i);
+
+      /**
+       * Read access to the derivative in direction @p i.
+       */
+      const ValueType &derivative (const unsigned int i) const;
+
+      /**
+       * Add another number.
+       */
+      DualNumber &operator += (const DualNumber &x);
+
+      /**
+       * Subtract another number.
+       */
+      DualNumber &operator -= (const DualNumber &x);
+
+      /**
+       * Multiply by another number.
+       */
+      DualNumber &operator *= (const DualNumber &x);
+
+      /**
+       * Divide by another number.
+       */
+      DualNumber &operator /= (const DualNumber &x);
+
+      /**
+       * Add a constant.
+       */
+      DualNumber &operator += (const ValueType &x);
+
+      /**
+       * Subtract a constant.
+       */
+      DualNumber &operator -= (const ValueType &x);
+
+      /**
+       * Multiply by a constant.
+       */
+      DualNumber &operator *= (const ValueType &x);
+
+      /**
+       * Divide by a constant.
+       */
+      DualNumber &operator /= (const ValueType &x);
+
+    private:
+      /**
+       * The value.
+       */
+      ValueType val;
+
+      /**
+       * The directional derivatives.
+       */
+      ValueType dx[n_derivatives];
+    };
+
+
+
+    /**
+     * Unary plus.
+     *
+     * @relatesalso DualNumber
+     */
+    template <typename ValueType, int n>
+    DualNumber<ValueType,n>
+    operator + (const DualNumber<ValueType,n> &x);
+
+    /**
+     * Unary minus.
+     *
+     * @relatesalso DualNumber
+     */
+    template <typename ValueType, int n>
+    DualNumber<ValueType,n>
+    operator - (const DualNumber<ValueType,n> &x);
+
+  } // namespace AD
+} // namespace Differentiation
+
+
+
+/* --------------------------- inline and template functions and specializations ------------------------- */
+
+
+#ifndef DOXYGEN
+
+namespace Differentiation
+{
+  namespace AD
+  {
+    namespace internal
+    {
+      // Convert a scalar or a value to the value type of a DualNumber
+      template <typename ValueType>
+      inline DEAL_II_ALWAYS_INLINE
+      const ValueType &
+      to_dual_value (const ValueType &x)
+      {
+        return x;
+      }
+
+      template <typename ValueType, typename OtherNumber>
+      inline DEAL_II_ALWAYS_INLINE
+      typename std::enable_if<std::is_arithmetic<OtherNumber>::value &&
+      !std::is_same<OtherNumber,ValueType>::value, ValueType>::type
+      to_dual_value (const OtherNumber &x)
+      {
+        ValueType result;
+        result = x;
+        return result;
+      }
+
+      // Whether the type can be combined with a DualNumber<ValueType,n> as
+      // a constant
+      template <typename ValueType, typename OtherNumber>
+      struct IsDualConstant
+      {
+        static const bool value = std::is_arithmetic<OtherNumber>::value ||
+                                  std::is_same<OtherNumber,ValueType>::value;
+      };
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    DualNumber<ValueType,n>::DualNumber ()
+    {
+      val = 0.;
+      for (unsigned int i=0; i<n; ++i)
+        dx[i] = 0.;
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    DualNumber<ValueType,n>::DualNumber (const ValueType &value)
+      :
+      val (value)
+    {
+      for (unsigned int i=0; i<n; ++i)
+        dx[i] = 0.;
+    }
+
+
+
+    template <typename ValueType, int n>
+    template <typename OtherNumber, typename>
+    inline DEAL_II_ALWAYS_INLINE
+    DualNumber<ValueType,n>::DualNumber (const OtherNumber &value)
+    {
+      val = value;
+      for (unsigned int i=0; i<n; ++i)
+        dx[i] = 0.;
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    DualNumber<ValueType,n>::DualNumber (const ValueType   &value,
+                                         const unsigned int independent_variable)
+      :
+      val (value)
+    {
+      AssertIndexRange (independent_variable, n);
+      for (unsigned int i=0; i<n; ++i)
+        dx[i] = (i == independent_variable ? 1. : 0.);
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    ValueType &
+    DualNumber<ValueType,n>::value ()
+    {
+      return val;
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    const ValueType &
+    DualNumber<ValueType,n>::value () const
+    {
+      return val;
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    ValueType &
+    DualNumber<ValueType,n>::derivative (const unsigned int i)
+    {
+      AssertIndexRange (i, n);
+      return dx[i];
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    const ValueType &
+    DualNumber<ValueType,n>::derivative (const unsigned int i) const
+    {
+      AssertIndexRange (i, n);
+      return dx[i];
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    DualNumber<ValueType,n> &
+    DualNumber<ValueType,n>::operator += (const DualNumber &x)
+    {
+      val += x.val;
+      for (unsigned int i=0; i<n; ++i)
+        dx[i] += x.dx[i];
+      return *this;
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    DualNumber<ValueType,n> &
+    DualNumber<ValueType,n>::operator -= (const DualNumber &x)
+    {
+      val -= x.val;
+      for (unsigned int i=0; i<n; ++i)
+        dx[i] -= x.dx[i];
+      return *this;
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    DualNumber<ValueType,n> &
+    DualNumber<ValueType,n>::operator *= (const DualNumber &x)
+    {
+      // x may be *this, so compute the derivatives before the value
+      for (unsigned int i=0; i<n; ++i)
+        dx[i] = dx[i] * x.val + val * x.dx[i];
+      val *= x.val;
+      return *this;
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    DualNumber<ValueType,n> &
+    DualNumber<ValueType,n>::operator /= (const DualNumber &x)
+    {
+      // (u/v)' = (u' - (u/v) v')/v, where x may be *this
+      const ValueType inverse = internal::to_dual_value<ValueType>(1.) / x.val;
+      const ValueType quotient = val * inverse;
+      for (unsigned int i=0; i<n; ++i)
+        dx[i] = (dx[i] - quotient * x.dx[i]) * inverse;
+      val = quotient;
+      return *this;
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    DualNumber<ValueType,n> &
+    DualNumber<ValueType,n>::operator += (const ValueType &x)
+    {
+      val += x;
+      return *this;
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    DualNumber<ValueType,n> &
+    DualNumber<ValueType,n>::operator -= (const ValueType &x)
+    {
+      val -= x;
+      return *this;
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    DualNumber<ValueType,n> &
+    DualNumber<ValueType,n>::operator *= (const ValueType &x)
+    {
+      val *= x;
+      for (unsigned int i=0; i<n; ++i)
+        dx[i] *= x;
+      return *this;
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    DualNumber<ValueType,n> &
+    DualNumber<ValueType,n>::operator /= (const ValueType &x)
+    {
+      const ValueType inverse = internal::to_dual_value<ValueType>(1.) / x;
+      return (*this *= inverse);
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    DualNumber<ValueType,n>
+    operator + (const DualNumber<ValueType,n> &x)
+    {
+      return x;
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    DualNumber<ValueType,n>
+    operator - (const DualNumber<ValueType,n> &x)
+    {
+      DualNumber<ValueType,n> result;
+      result -= x;
+      return result;
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    DualNumber<ValueType,n>
+    operator + (const DualNumber<ValueType,n> &x,
+                const DualNumber<ValueType,n> &y)
+    {
+      DualNumber<ValueType,n> result (x);
+      return (result += y);
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    DualNumber<ValueType,n>
+    operator - (const DualNumber<ValueType,n> &x,
+                const DualNumber<ValueType,n> &y)
+    {
+      DualNumber<ValueType,n> result (x);
+      return (result -= y);
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    DualNumber<ValueType,n>
+    operator * (const DualNumber<ValueType,n> &x,
+                const DualNumber<ValueType,n> &y)
+    {
+      DualNumber<ValueType,n> result (x);
+      return (result *= y);
+    }
+
+
+
+    template <typename ValueType, int n>
+    inline DEAL_II_ALWAYS_INLINE
+    DualNumber<ValueType,n>
+    operator / (const DualNumber<ValueType,n> &x,
+                const DualNumber<ValueType,n> &y)
+    {
+      DualNumber<ValueType,n> result (x);
+      return (result /= y);
+    }
+
+
+
+    // the operations with constants, which are either of the value type or
+    // scalars that are converted to the value type
+
+    template <typename ValueType, int n, typename OtherNumber>
+    inline DEAL_II_ALWAYS_INLINE
+    typename std::enable_if<internal::IsDualConstant<ValueType,OtherNumber>::value,
+             DualNumber<ValueType,n> >::type
+             operator + (const DualNumber<ValueType,n> &x,
+                         const OtherNumber             &y)
+    {
+      DualNumber<ValueType,n> result (x);
+      return (result += internal::to_dual_value<ValueType>(y));
+    }
+
+
+
+    template <typename ValueType, int n, typename OtherNumber>
+    inline DEAL_II_ALWAYS_INLINE
+    typename std::enable_if<internal::IsDualConstant<ValueType,OtherNumber>::value,
+             DualNumber<ValueType,n> >::type
+             operator + (const OtherNumber             &x,
+                         const DualNumber<ValueType,n> &y)
+    {
+      DualNumber<ValueType,n> result (y);
+      return (result += internal::to_dual_value<ValueType>(x));
+    }
+
+
+
+    template <typename ValueType, int n, typename OtherNumber>
+    inline DEAL_II_ALWAYS_INLINE
+    typename std::enable_if<internal::IsDualConstant<ValueType,OtherNumber>::value,
+             DualNumber<ValueType,n> >::type
+             operator - (const DualNumber<ValueType,n> &x,
+                         const OtherNumber             &y)
+    {
+      DualNumber<ValueType,n> result (x);
+      return (result -= internal::to_dual_value<ValueType>(y));
+    }
+
+
+
+    template <typename ValueType, int n, typename OtherNumber>
+    inline DEAL_II_ALWAYS_INLINE
+    typename std::enable_if<internal::IsDualConstant<ValueType,OtherNumber>::value,
+             DualNumber<ValueType,n> >::type
+             operator - (const OtherNumber             &x,
+                         const DualNumber<ValueType,n> &y)
+    {
+      DualNumber<ValueType,n> result (-y);
+      return (result += internal::to_dual_value<ValueType>(x));
+    }
+
+
+
+    template <typename ValueType, int n, typename OtherNumber>
+    inline DEAL_II_ALWAYS_INLINE
+    typename std::enable_if<internal::IsDualConstant<ValueType,OtherNumber>::value,
+             DualNumber<ValueType,n> >::type
+             operator * (const DualNumber<ValueType,n> &x,
+                         const OtherNumber             &y)
+    {
+      DualNumber<ValueType,n> result (x);
+      return (result *= internal::to_dual_value<ValueType>(y));
+    }
+
+
+
+    template <typename ValueType, int n, typename OtherNumber>
+    inline DEAL_II_ALWAYS_INLINE
+    typename std::enable_if<internal::IsDualConstant<ValueType,OtherNumber>::value,
+             DualNumber<ValueType,n> >::type
+             operator * (const OtherNumber             &x,
+                         const DualNumber<ValueType,n> &y)
+    {
+      DualNumber<ValueType,n> result (y);
+      return (result *= internal::to_dual_value<ValueType>(x));
+    }
+
+
+
+    template <typename ValueType, int n, typename OtherNumber>
+    inline DEAL_II_ALWAYS_INLINE
+    typename std::enable_if<internal::IsDualConstant<ValueType,OtherNumber>::value,
+             DualNumber<ValueType,n> >::type
+             operator / (const DualNumber<ValueType,n> &x,
+                         const OtherNumber             &y)
+    {
+      DualNumber<ValueType,n> result (x);
+      return (result /= internal::to_dual_value<ValueType>(y));
+    }
+
+
+
+    template <typename ValueType, int n, typename OtherNumber>
+    inline DEAL_II_ALWAYS_INLINE
+    typename std::enable_if<internal::IsDualConstant<ValueType,OtherNumber>::value,
+             DualNumber<ValueType,n> >::type
+             operator / (const OtherNumber             &x,
+                         const DualNumber<ValueType,n> &y)
+    {
+      DualNumber<ValueType,n> result (internal::to_dual_value<ValueType>(x));
+      return (result /= y);
+    }
+
+  } // namespace AD
+} // namespace Differentiation
+
+#endif // DOXYGEN
+
+
+
+/* -------------- Product types for Tensor and SymmetricTensor -------------- */
+
+
+#ifndef DOXYGEN
+
+namespace internal
+{
+
+  template <typename T, int n>
+  struct ProductTypeImpl<Differentiation::AD::DualNumber<T,n>, float>
+  {
+    typedef Differentiation::AD::DualNumber<T,n> type;
+  };
+
+  template <typename T, int n>
+  struct ProductTypeImpl<float, Differentiation::AD::DualNumber<T,n> >
+  {
+    typedef Differentiation::AD::DualNumber<T,n> type;
+  };
+
+  template <typename T, int n>
+  struct ProductTypeImpl<Differentiation::AD::DualNumber<T,n>, double>
+  {
+    typedef Differentiation::AD::DualNumber<T,n> type;
+  };
+
+  template <typename T, int n>
+  struct ProductTypeImpl<double, Differentiation::AD::DualNumber<T,n> >
+  {
+    typedef Differentiation::AD::DualNumber<T,n> type;
+  };
+
+  template <typename T, int n>
+  struct ProductTypeImpl<Differentiation::AD::DualNumber<T,n>, int>
+  {
+    typedef Differentiation::AD::DualNumber<T,n> type;
+  };
+
+  template <typename T, int n>
+  struct ProductTypeImpl<int, Differentiation::AD::DualNumber<T,n> >
+  {
+    typedef Differentiation::AD::DualNumber<T,n> type;
+  };
+
+  template <typename T, int n>
+  struct ProductTypeImpl<Differentiation::AD::DualNumber<T,n>, Differentiation::AD::DualNumber<T,n> >
+  {
+    typedef Differentiation::AD::DualNumber<T,n> type;
+  };
+
+}
+
+
+template <typename T, int n>
+struct EnableIfScalar<Differentiation::AD::DualNumber<T,n> >
+{
+  typedef Differentiation::AD::DualNumber<T,n> type;
+};
+
+#endif // DOXYGEN
+
+
+
+namespace numbers
+{
+  /**
+   * Specialization of the general NumberTraits class for DualNumber. The
+   * functions are declared here since the std::abs() overload for DualNumber
+   * is not visible in the general implementation.
+   */
+  template <typename T, int n>
+  struct NumberTraits<Differentiation::AD::DualNumber<T,n> >
+  {
+    static const bool is_complex = false;
+
+    typedef Differentiation::AD::DualNumber<T,n> real_type;
+
+    static
+    const real_type &conjugate (const real_type &x);
+
+    static
+    real_type abs_square (const real_type &x);
+
+    static
+    real_type abs (const real_type &x);
+  };
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+
+
+/* -------------- Math functions -------------- */
+
+
+#ifndef DOXYGEN
+
+// As for VectorizedArray, the math functions are declared in namespace std
+// so that they are found by the std:: qualified calls throughout the library
+namespace std
+{
+
+  template <typename T, int n>
+  inline
+  ::dealii::Differentiation::AD::DualNumber<T,n>
+  sqrt (const ::dealii::Differentiation::AD::DualNumber<T,n> &x)
+  {
+    ::dealii::Differentiation::AD::DualNumber<T,n> result (x);
+    result.value() = std::sqrt(x.value());
+    const T factor = ::dealii::Differentiation::AD::internal::to_dual_value<T>(0.5) / result.value();
+    for (unsigned int i=0; i<n; ++i)
+      result.derivative(i) *= factor;
+    return result;
+  }
+
+
+
+  template <typename T, int n>
+  inline
+  ::dealii::Differentiation::AD::DualNumber<T,n>
+  exp (const ::dealii::Differentiation::AD::DualNumber<T,n> &x)
+  {
+    ::dealii::Differentiation::AD::DualNumber<T,n> result (x);
+    result.value() = std::exp(x.value());
+    for (unsigned int i=0; i<n; ++i)
+      result.derivative(i) *= result.value();
+    return result;
+  }
+
+
+
+  template <typename T, int n>
+  inline
+  ::dealii::Differentiation::AD::DualNumber<T,n>
+  log (const ::dealii::Differentiation::AD::DualNumber<T,n> &x)
+  {
+    ::dealii::Differentiation::AD::DualNumber<T,n> result (x);
+    result.value() = std::log(x.value());
+    const T factor = ::dealii::Differentiation::AD::internal::to_dual_value<T>(1.) / x.value();
+    for (unsigned int i=0; i<n; ++i)
+      result.derivative(i) *= factor;
+    return result;
+  }
+
+
+
+  template <typename T, int n>
+  inline
+  ::dealii::Differentiation::AD::DualNumber<T,n>
+  sin (const ::dealii::Differentiation::AD::DualNumber<T,n> &x)
+  {
+    ::dealii::Differentiation::AD::DualNumber<T,n> result (x);
+    result.value() = std::sin(x.value());
+    const T factor = std::cos(x.value());
+    for (unsigned int i=0; i<n; ++i)
+      result.derivative(i) *= factor;
+    return result;
+  }
+
+
+
+  template <typename T, int n>
+  inline
+  ::dealii::Differentiation::AD::DualNumber<T,n>
+  cos (const ::dealii::Differentiation::AD::DualNumber<T,n> &x)
+  {
+    ::dealii::Differentiation::AD::DualNumber<T,n> result (x);
+    result.value() = std::cos(x.value());
+    const T factor = -std::sin(x.value());
+    for (unsigned int i=0; i<n; ++i)
+      result.derivative(i) *= factor;
+    return result;
+  }
+
+
+
+  template <typename T, int n>
+  inline
+  ::dealii::Differentiation::AD::DualNumber<T,n>
+  tan (const ::dealii::Differentiation::AD::DualNumber<T,n> &x)
+  {
+    ::dealii::Differentiation::AD::DualNumber<T,n> result (x);
+    result.value() = std::tan(x.value());
+    const T factor = ::dealii::Differentiation::AD::internal::to_dual_value<T>(1.) +
+                     result.value() * result.value();
+    for (unsigned int i=0; i<n; ++i)
+      result.derivative(i) *= factor;
+    return result;
+  }
+
+
+
+  /**
+   * The absolute value, whose derivative is not defined at zero.
+   */
+  template <typename T, int n>
+  inline
+  ::dealii::Differentiation::AD::DualNumber<T,n>
+  abs (const ::dealii::Differentiation::AD::DualNumber<T,n> &x)
+  {
+    ::dealii::Differentiation::AD::DualNumber<T,n> result (x);
+    result.value() = std::abs(x.value());
+    const T sign = x.value() / result.value();
+    for (unsigned int i=0; i<n; ++i)
+      result.derivative(i) *= sign;
+    return result;
+  }
+
+
+
+  template <typename T, int n>
+  inline
+  ::dealii::Differentiation::AD::DualNumber<T,n>
+  pow (const ::dealii::Differentiation::AD::DualNumber<T,n> &x,
+       const double                                           p)
+  {
+    ::dealii::Differentiation::AD::DualNumber<T,n> result (x);
+    const T x_p_minus_1 = std::pow(x.value(), p-1.);
+    result.value() = x_p_minus_1 * x.value();
+    const T factor = p * x_p_minus_1;
+    for (unsigned int i=0; i<n; ++i)
+      result.derivative(i) *= factor;
+    return result;
+  }
+
+
+
+  template <typename T, int n>
+  inline
+  ::dealii::Differentiation::AD::DualNumber<T,n>
+  pow (const ::dealii::Differentiation::AD::DualNumber<T,n> &x,
+       const ::dealii::Differentiation::AD::DualNumber<T,n> &p)
+  {
+    return std::exp(p * std::log(x));
+  }
+
+}
+
+
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace numbers
+{
+  template <typename T, int n>
+  inline
+  const Differentiation::AD::DualNumber<T,n> &
+  NumberTraits<Differentiation::AD::DualNumber<T,n> >::conjugate (const real_type &x)
+  {
+    return x;
+  }
+
+
+
+  template <typename T, int n>
+  inline
+  Differentiation::AD::DualNumber<T,n>
+  NumberTraits<Differentiation::AD::DualNumber<T,n> >::abs_square (const real_type &x)
+  {
+    return x * x;
+  }
+
+
+
+  template <typename T, int n>
+  inline
+  Differentiation::AD::DualNumber<T,n>
+  NumberTraits<Differentiation::AD::DualNumber<T,n> >::abs (const real_type &x)
+  {
+    return std::abs(x);
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif // DOXYGEN
+
+#endif
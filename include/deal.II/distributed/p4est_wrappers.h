@@ -70,6 +70,7 @@ namespace internal
       typedef p4est_quadrant_t     quadrant;
       typedef p4est_topidx_t       topidx;
       typedef p4est_locidx_t       locidx;
+      typedef p4est_gloidx_t       gloidx;
 #if DEAL_II_P4EST_VERSION_GTE(0,3,4,3)
       typedef p4est_connect_type_t balance_type;
 #else
@@ -87,6 +88,7 @@ namespace internal
       typedef p8est_quadrant_t     quadrant;
       typedef p4est_topidx_t       topidx;
       typedef p4est_locidx_t       locidx;
+      typedef p4est_gloidx_t       gloidx;
 #if DEAL_II_P4EST_VERSION_GTE(0,3,4,3)
       typedef p8est_connect_type_t balance_type;
 #else
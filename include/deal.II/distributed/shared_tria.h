@@ -117,7 +117,11 @@ namespace parallel
       {
         /**
          * Use METIS partitioner to partition active cells. This is the
-         * default partioning method.
+         * default partioning method. If functions are connected to the
+         * dealii::Triangulation::Signals::cell_weight signal, METIS balances
+         * the weights of the cells computed from it in the same way as in
+         * parallel::distributed::Triangulation rather than the number of
+         * cells.
          */
         partition_metis = 0x1,
 
@@ -301,9 +305,19 @@ namespace parallel
       /**
        * This function calls GridTools::partition_triangulation () and if
        * requested in the constructor of the class marks artificial cells.
+       * When partitioning with METIS, the partitioning is computed on the
+       * first processor only and then communicated to all others.
        */
       void partition();
 
+      /**
+       * Return the weights of the active cells to be used by the METIS
+       * partitioner, as obtained from the cell_weight signal of the
+       * triangulation, or an empty vector if no functions are connected to
+       * this signal.
+       */
+      std::vector<unsigned int> get_cell_weights () const;
+
       /**
        * A vector containing subdomain IDs of cells obtained by partitioning
        * using either zorder, METIS, or a user-defined partitioning scheme.
@@ -19,6 +19,7 @@
 #include <deal.II/base/config.h>
 #include <deal.II/distributed/tria.h>
 #include <deal.II/dofs/dof_handler.h>
+#include <deal.II/lac/vector.h>
 
 #include <vector>
 
@@ -222,6 +223,14 @@ namespace parallel
        */
       unsigned int offset;
 
+      /**
+       * The values of the degrees of freedom of one cell, used by
+       * pack_callback() and unpack_callback(). The triangulation calls them
+       * for one cell after the other, so one buffer can be reused for all
+       * cells and vectors rather than allocating a vector for every cell.
+       */
+      ::dealii::Vector<typename VectorType::value_type> dof_values;
+
       /**
        * A callback function used to pack the data on the current mesh into
        * objects that can later be retrieved after refinement, coarsening and
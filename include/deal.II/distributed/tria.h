@@ -33,6 +33,8 @@
 #include <functional>
 #include <tuple>
 
+#include <boost/range/iterator_range.hpp>
+
 #ifdef DEAL_II_WITH_MPI
 #  include <mpi.h>
 #endif
@@ -451,6 +453,14 @@ namespace parallel
        * the same way as execute_coarsening_and_refinement() with respect to
        * dealing with data movement (SolutionTransfer, etc.).
        *
+       * Only the cells that change their owner are sent to other processes
+       * along with their attached data. Processes whose set of locally owned
+       * cells stays the same do not rebuild their part of the mesh but only
+       * update the owners of their ghost cells, unless the multigrid
+       * hierarchy is constructed or
+       * Settings::mesh_reconstruction_after_repartitioning is set. If no cell
+       * changes its owner at all, the triangulation is not touched.
+       *
        * @note If no function is connected to the cell_weight signal described
        * in the dealii::Triangulation class, this function will balance the
        * number of cells on each processor. If one or more functions are
@@ -667,6 +677,45 @@ namespace parallel
                                                         const CellStatus,
                                                         const void *)> &unpack_callback);
 
+      /**
+       * Like register_data_attach(), but for data whose size differs between
+       * cells, such as the solution on cells with different finite elements
+       * in hp methods, lists of particles, or quadrature point history. The
+       * given function packs the data of a cell into a vector of bytes of any
+       * length, including zero, and is called for the same cells and with the
+       * same CellStatus as the callbacks of register_data_attach().
+       *
+       * The data of all cells is kept in a buffer next to the p4est forest
+       * and is only sent to the processes that own the cells after the
+       * repartitioning, while the data of cells that stay on the present
+       * process is not communicated. It is written to a separate file by
+       * save(), see there.
+       *
+       * The return value is a handle that needs to be passed to
+       * notify_ready_to_unpack_variable() to retrieve the data.
+       */
+      unsigned int
+      register_data_attach_variable (const std::function<std::vector<char> (const cell_iterator &,
+                                     const CellStatus)> &pack_callback);
+
+      /**
+       * The counterpart of notify_ready_to_unpack() for data registered with
+       * register_data_attach_variable(). The supplied function is called for
+       * each newly locally owned cell with the range of bytes packed for
+       * that cell, where the cell iterator and the CellStatus have the same
+       * meaning as in notify_ready_to_unpack().
+       *
+       * After load(), this function needs to be called in the same order as
+       * the data was registered before save(), with the handle obtained by
+       * calling register_data_attach_variable() again, whose packing
+       * function is then not used.
+       */
+      void
+      notify_ready_to_unpack_variable (const unsigned int handle,
+                                       const std::function<void (const cell_iterator &,
+                                                                 const CellStatus,
+                                                                 const boost::iterator_range<std::vector<char>::const_iterator> &)> &unpack_callback);
+
       /**
        * Return a permutation vector for the order the coarse cells are handed
        * off to p4est. For example the value of the $i$th element in this
@@ -776,6 +825,44 @@ namespace parallel
        */
       callback_list_t attached_data_pack_callbacks;
 
+      typedef std::function<
+      std::vector<char>(typename Triangulation<dim,spacedim>::cell_iterator, CellStatus)
+      > variable_pack_callback_t;
+
+      /**
+       * List of callback functions registered by
+       * register_data_attach_variable(), in the order of their handles.
+       */
+      std::vector<variable_pack_callback_t> variable_data_pack_callbacks;
+
+      /**
+       * number of functions registered by register_data_attach_variable()
+       * that have already unpacked their data.
+       */
+      unsigned int n_variable_datas_unpacked;
+
+      /**
+       * number of functions that need to unpack their variable size data
+       * after a call from load()
+       */
+      unsigned int n_attached_variable_deserialize;
+
+      /**
+       * The number of objects whose data is stored in variable_data_buffer.
+       */
+      unsigned int n_variable_datas_in_buffer;
+
+      /**
+       * The variable size data of the locally owned quadrants in the order of
+       * p4est, all concatenated: For each quadrant, the CellStatus and the
+       * sizes of the data of each registered object, followed by the data
+       * itself. Quadrants that do not carry data, like all but the first
+       * child of a refined cell, have no entry. The entry of the $i$th
+       * quadrant starts at <tt>variable_data_offsets[i]</tt>.
+       */
+      std::vector<char>        variable_data_buffer;
+      std::vector<std::size_t> variable_data_offsets;
+
 
       /**
        * Two arrays that store which p4est tree corresponds to which coarse
@@ -821,6 +908,16 @@ namespace parallel
        */
       void copy_local_forest_to_triangulation ();
 
+      /**
+       * Recreate the ghost layer of p4est and update the subdomain ids of
+       * the ghost cells of the attached triangulation, assuming that the
+       * locally owned cells and the refinement of the forest did not change.
+       * Called from repartition() instead of
+       * copy_local_forest_to_triangulation() on processes whose locally
+       * owned range of cells stayed the same.
+       */
+      void update_ghost_owners ();
+
       /**
        * Internal function notifying all registered classes to attach their
        * data before repartitioning occurs. Called from
@@ -828,6 +925,25 @@ namespace parallel
        */
       void attach_mesh_data();
 
+      /**
+       * Send the variable size data of the quadrants that changed their owner
+       * in the last call to p4est's partition function, which were owned
+       * according to @p old_global_first_quadrant before, to their new
+       * owners. The data of quadrants that stay on the present process is
+       * only moved within variable_data_buffer.
+       */
+      void
+      transfer_variable_data (const std::vector<typename dealii::internal::p4est::types<dim>::gloidx> &old_global_first_quadrant);
+
+      /**
+       * Write the variable size data of the locally owned quadrants into a
+       * file shared by all processes, or read it back in. Called from save()
+       * and load().
+       */
+      void save_variable_data (const char *filename) const;
+      void load_variable_data (const char *filename,
+                               const unsigned int n_attached_variable_objects);
+
       /**
        * Internal function notifying all registered slots to provide their
        * weights before repartitioning occurs. Called from
@@ -952,6 +1068,22 @@ namespace parallel
                                                         const typename dealii::Triangulation<1,spacedim>::CellStatus,
                                                         const void *)> &unpack_callback);
 
+      /**
+       * This function is not implemented, but needs to be present for the compiler.
+       */
+      unsigned int
+      register_data_attach_variable (const std::function<std::vector<char> (const typename dealii::Triangulation<1,spacedim>::cell_iterator &,
+                                     const typename dealii::Triangulation<1,spacedim>::CellStatus)> &pack_callback);
+
+      /**
+       * This function is not implemented, but needs to be present for the compiler.
+       */
+      void
+      notify_ready_to_unpack_variable (const unsigned int handle,
+                                       const std::function<void (const typename dealii::Triangulation<1,spacedim>::cell_iterator &,
+                                                                 const typename dealii::Triangulation<1,spacedim>::CellStatus,
+                                                                 const boost::iterator_range<std::vector<char>::const_iterator> &)> &unpack_callback);
+
       /**
        * Dummy arrays. This class isn't usable but the compiler wants to see
        * these variables at a couple places anyway.
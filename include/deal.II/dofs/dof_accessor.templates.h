@@ -1806,8 +1806,10 @@ namespace internal
                           std::vector<types::global_dof_index>                         &dof_indices,
                           const unsigned int                                            fe_index)
     {
-      const unsigned int dofs_per_vertex = accessor.get_fe(fe_index).dofs_per_vertex,
-                         dofs_per_line   = accessor.get_fe(fe_index).dofs_per_line;
+      const FiniteElement<DoFHandlerType::dimension,DoFHandlerType::space_dimension> &fe
+        = accessor.get_fe(fe_index);
+      const unsigned int dofs_per_vertex = fe.dofs_per_vertex,
+                         dofs_per_line   = fe.dofs_per_line;
       std::vector<types::global_dof_index>::iterator next = dof_indices.begin();
       for (unsigned int vertex=0; vertex<2; ++vertex)
         for (unsigned int d=0; d<dofs_per_vertex; ++d)
@@ -1823,9 +1825,11 @@ namespace internal
                           std::vector<types::global_dof_index>                         &dof_indices,
                           const unsigned int                                            fe_index)
     {
-      const unsigned int dofs_per_vertex = accessor.get_fe(fe_index).dofs_per_vertex,
-                         dofs_per_line   = accessor.get_fe(fe_index).dofs_per_line,
-                         dofs_per_quad   = accessor.get_fe(fe_index).dofs_per_quad;
+      const FiniteElement<DoFHandlerType::dimension,DoFHandlerType::space_dimension> &fe
+        = accessor.get_fe(fe_index);
+      const unsigned int dofs_per_vertex = fe.dofs_per_vertex,
+                         dofs_per_line   = fe.dofs_per_line,
+                         dofs_per_quad   = fe.dofs_per_quad;
       std::vector<types::global_dof_index>::iterator next = dof_indices.begin();
       for (unsigned int vertex=0; vertex<4; ++vertex)
         for (unsigned int d=0; d<dofs_per_vertex; ++d)
@@ -1842,11 +1846,16 @@ namespace internal
       // we see to correspond to the correct
       // (face-local) ordering.
       for (unsigned int line=0; line<4; ++line)
-        for (unsigned int d=0; d<dofs_per_line; ++d)
-          *next++ = accessor.line(line)->dof_index(accessor.get_fe(fe_index).
-                                                   adjust_line_dof_index_for_line_orientation(d,
-                                                       accessor.line_orientation(line)),
-                                                   fe_index);
+        if (dofs_per_line > 0)
+          {
+            const auto line_accessor = accessor.line(line);
+            const bool line_orientation = accessor.line_orientation(line);
+            for (unsigned int d=0; d<dofs_per_line; ++d)
+              *next++ = line_accessor->dof_index(fe.
+                                                 adjust_line_dof_index_for_line_orientation(d,
+                                                     line_orientation),
+                                                 fe_index);
+          }
       for (unsigned int d=0; d<dofs_per_quad; ++d)
         *next++ = accessor.dof_index(d,fe_index);
     }
@@ -1858,10 +1867,12 @@ namespace internal
                           std::vector<types::global_dof_index>                         &dof_indices,
                           const unsigned int                                            fe_index)
     {
-      const unsigned int dofs_per_vertex = accessor.get_fe(fe_index).dofs_per_vertex,
-                         dofs_per_line   = accessor.get_fe(fe_index).dofs_per_line,
-                         dofs_per_quad   = accessor.get_fe(fe_index).dofs_per_quad,
-                         dofs_per_hex    = accessor.get_fe(fe_index).dofs_per_hex;
+      const FiniteElement<DoFHandlerType::dimension,DoFHandlerType::space_dimension> &fe
+        = accessor.get_fe(fe_index);
+      const unsigned int dofs_per_vertex = fe.dofs_per_vertex,
+                         dofs_per_line   = fe.dofs_per_line,
+                         dofs_per_quad   = fe.dofs_per_quad,
+                         dofs_per_hex    = fe.dofs_per_hex;
       std::vector<types::global_dof_index>::iterator next = dof_indices.begin();
       for (unsigned int vertex=0; vertex<8; ++vertex)
         for (unsigned int d=0; d<dofs_per_vertex; ++d)
@@ -1878,10 +1889,15 @@ namespace internal
       // see to correspond to the correct
       // (cell-local) ordering.
       for (unsigned int line=0; line<12; ++line)
-        for (unsigned int d=0; d<dofs_per_line; ++d)
-          *next++ = accessor.line(line)->dof_index(accessor.get_fe(fe_index).
-                                                   adjust_line_dof_index_for_line_orientation(d,
-                                                       accessor.line_orientation(line)),fe_index);
+        if (dofs_per_line > 0)
+          {
+            const auto line_accessor = accessor.line(line);
+            const bool line_orientation = accessor.line_orientation(line);
+            for (unsigned int d=0; d<dofs_per_line; ++d)
+              *next++ = line_accessor->dof_index(fe.
+                                                 adjust_line_dof_index_for_line_orientation(d,
+                                                     line_orientation),fe_index);
+          }
       // now copy dof numbers from the face. for
       // faces with the wrong orientation, we
       // have already made sure that we're ok by
@@ -1896,13 +1912,20 @@ namespace internal
       // applies, if the face_rotation or
       // face_orientation is non-standard
       for (unsigned int quad=0; quad<6; ++quad)
-        for (unsigned int d=0; d<dofs_per_quad; ++d)
-          *next++ = accessor.quad(quad)->dof_index(accessor.get_fe(fe_index).
-                                                   adjust_quad_dof_index_for_face_orientation(d,
-                                                       accessor.face_orientation(quad),
-                                                       accessor.face_flip(quad),
-                                                       accessor.face_rotation(quad)),
-                                                   fe_index);
+        if (dofs_per_quad > 0)
+          {
+            const auto quad_accessor = accessor.quad(quad);
+            const bool face_orientation = accessor.face_orientation(quad),
+                       face_flip        = accessor.face_flip(quad),
+                       face_rotation    = accessor.face_rotation(quad);
+            for (unsigned int d=0; d<dofs_per_quad; ++d)
+              *next++ = quad_accessor->dof_index(fe.
+                                                 adjust_quad_dof_index_for_face_orientation(d,
+                                                     face_orientation,
+                                                     face_flip,
+                                                     face_rotation),
+                                                 fe_index);
+          }
       for (unsigned int d=0; d<dofs_per_hex; ++d)
         *next++ = accessor.dof_index(d,fe_index);
     }
@@ -3045,8 +3068,10 @@ namespace internal
 
         const unsigned int n_dofs = local_source_end - local_source_begin;
 
-        types::global_dof_index *dofs = &accessor.dof_handler->levels[accessor.level()]
-                                        ->cell_dof_indices_cache[accessor.present_index * n_dofs];
+        std::vector<types::global_dof_index> scratch;
+        const types::global_dof_index *dofs
+          = accessor.dof_handler->levels[accessor.level()]
+            ->get_cell_cache_start (accessor.present_index, n_dofs, scratch);
 
         // distribute cell vector
         global_destination.add(n_dofs, dofs, local_source_begin);
@@ -3104,8 +3129,10 @@ namespace internal
 
         const unsigned int n_dofs = local_source_end - local_source_begin;
 
-        types::global_dof_index *dofs = &accessor.dof_handler->levels[accessor.level()]
-                                        ->cell_dof_indices_cache[accessor.present_index * n_dofs];
+        std::vector<types::global_dof_index> scratch;
+        const types::global_dof_index *dofs
+          = accessor.dof_handler->levels[accessor.level()]
+            ->get_cell_cache_start (accessor.present_index, n_dofs, scratch);
 
         // distribute cell vector
         constraints.distribute_local_to_global (local_source_begin, local_source_end,
@@ -3168,8 +3195,10 @@ namespace internal
 
         const unsigned int n_dofs = local_source.m();
 
-        types::global_dof_index *dofs = &accessor.dof_handler->levels[accessor.level()]
-                                        ->cell_dof_indices_cache[accessor.present_index * n_dofs];
+        std::vector<types::global_dof_index> scratch;
+        const types::global_dof_index *dofs
+          = accessor.dof_handler->levels[accessor.level()]
+            ->get_cell_cache_start (accessor.present_index, n_dofs, scratch);
 
         // distribute cell matrix
         for (unsigned int i=0; i<n_dofs; ++i)
@@ -3240,8 +3269,10 @@ namespace internal
                 ExcMessage ("Cell must be active."));
 
         const unsigned int n_dofs = accessor.get_fe().dofs_per_cell;
-        types::global_dof_index *dofs = &accessor.dof_handler->levels[accessor.level()]
-                                        ->cell_dof_indices_cache[accessor.present_index *n_dofs];
+        std::vector<types::global_dof_index> scratch;
+        const types::global_dof_index *dofs
+          = accessor.dof_handler->levels[accessor.level()]
+            ->get_cell_cache_start (accessor.present_index, n_dofs, scratch);
 
         // distribute cell matrices
         for (unsigned int i=0; i<n_dofs; ++i)
@@ -3458,13 +3489,21 @@ DoFCellAccessor<DoFHandlerType,level_dof_access>::get_dof_indices
   Assert (this->active(), ExcMessage ("get_dof_indices() only works on active cells."));
   Assert (this->is_artificial() == false,
           ExcMessage ("Can't ask for DoF indices on artificial cells."));
-  AssertDimension (dof_indices.size(), this->get_fe().dofs_per_cell);
-
+  // look up the finite element only once: for hp::DoFHandler objects, this
+  // involves finding the active_fe_index of the cell, which the compiler can
+  // not hoist out of the loop below because of the writes to dof_indices
+  const unsigned int dofs_per_cell = this->get_fe().dofs_per_cell;
+  AssertDimension (dof_indices.size(), dofs_per_cell);
+
+  // if the cache is compressed, the indices are unpacked right into the
+  // output array, in which case the copy below does nothing
   const types::global_dof_index *cache
     = this->dof_handler->levels[this->present_level]
-      ->get_cell_cache_start (this->present_index, this->get_fe().dofs_per_cell);
-  for (unsigned int i=0; i<this->get_fe().dofs_per_cell; ++i, ++cache)
-    dof_indices[i] = *cache;
+      ->get_cell_cache_start (this->present_index, dofs_per_cell,
+                              dof_indices);
+  if (cache != dof_indices.data())
+    for (unsigned int i=0; i<dofs_per_cell; ++i, ++cache)
+      dof_indices[i] = *cache;
 }
 
 
@@ -3530,17 +3569,20 @@ DoFCellAccessor<DoFHandlerType,level_dof_access>::get_dof_values
   Assert (!this->has_children(),
           ExcMessage ("Cell must be active."));
 
+  const unsigned int dofs_per_cell = this->get_fe().dofs_per_cell;
   Assert (static_cast<unsigned int>(local_values_end-local_values_begin)
-          == this->get_fe().dofs_per_cell,
+          == dofs_per_cell,
           typename DoFCellAccessor::ExcVectorDoesNotMatch());
   Assert (values.size() == this->get_dof_handler().n_dofs(),
           typename DoFCellAccessor::ExcVectorDoesNotMatch());
 
+  std::vector<types::global_dof_index> scratch;
   const types::global_dof_index *cache
     = this->dof_handler->levels[this->present_level]
-      ->get_cell_cache_start (this->present_index, this->get_fe().dofs_per_cell);
+      ->get_cell_cache_start (this->present_index, dofs_per_cell,
+                              scratch);
   dealii::internal::DoFAccessor::Implementation::extract_subvector_to(
-    values, cache, cache + this->get_fe().dofs_per_cell, local_values_begin);
+    values, cache, cache + dofs_per_cell, local_values_begin);
 }
 
 
@@ -3567,9 +3609,11 @@ DoFCellAccessor<DoFHandlerType,level_dof_access>::get_dof_values
           typename DoFCellAccessor::ExcVectorDoesNotMatch());
 
 
+  std::vector<types::global_dof_index> scratch;
   const types::global_dof_index *cache
     = this->dof_handler->levels[this->present_level]
-      ->get_cell_cache_start (this->present_index, this->get_fe().dofs_per_cell);
+      ->get_cell_cache_start (this->present_index, this->get_fe().dofs_per_cell,
+                              scratch);
 
   constraints.get_dof_values(values, *cache, local_values_begin,
                              local_values_end);
@@ -3590,18 +3634,21 @@ DoFCellAccessor<DoFHandlerType,level_dof_access>::set_dof_values
   Assert (!this->has_children(),
           ExcMessage ("Cell must be active."));
 
+  const unsigned int dofs_per_cell = this->get_fe().dofs_per_cell;
   Assert (static_cast<unsigned int>(local_values.size())
-          == this->get_fe().dofs_per_cell,
+          == dofs_per_cell,
           typename DoFCellAccessor::ExcVectorDoesNotMatch());
   Assert (values.size() == this->get_dof_handler().n_dofs(),
           typename DoFCellAccessor::ExcVectorDoesNotMatch());
 
 
+  std::vector<types::global_dof_index> scratch;
   const types::global_dof_index *cache
     = this->dof_handler->levels[this->present_level]
-      ->get_cell_cache_start (this->present_index, this->get_fe().dofs_per_cell);
+      ->get_cell_cache_start (this->present_index, dofs_per_cell,
+                              scratch);
 
-  for (unsigned int i=0; i<this->get_fe().dofs_per_cell; ++i, ++cache)
+  for (unsigned int i=0; i<dofs_per_cell; ++i, ++cache)
     internal::ElementAccess<OutputVector>::set(local_values(i),
                                                *cache, values);
 }
@@ -479,6 +479,30 @@ public:
   void renumber_dofs (const unsigned int level,
                       const std::vector<types::global_dof_index> &new_numbers);
 
+  /**
+   * Select whether the cache of the dof indices on each cell, which is used
+   * by DoFCellAccessor::get_dof_indices() and similar functions, is stored in
+   * compressed form. If the library is configured with 64-bit dof indices,
+   * the compressed form stores on each level the differences of the indices
+   * to the smallest index on the current processor as 32-bit integers, which
+   * halves the memory used by the cache. The cache takes up the larger part
+   * of the memory used by this class because it stores the indices of
+   * degrees of freedom shared between cells once for each cell.
+   *
+   * The setting takes effect immediately and is also applied at the end of
+   * every subsequent call of distribute_dofs(), distribute_mg_dofs(), and
+   * renumber_dofs(). On levels where the range of indices does not fit into
+   * 32-bit integers, and if the library uses 32-bit dof indices anyway, the
+   * cache is left in its normal form.
+   *
+   * The compressed form costs an additional copy of the indices in the
+   * functions that use the cache. DoFCellAccessor::get_dof_indices() unpacks
+   * the indices directly into the given array, so codes that mostly call
+   * this function see little difference. By default, the cache is not
+   * compressed.
+   */
+  void set_compressed_cell_dof_indices_cache (const bool compress);
+
   /**
    * Return the maximum number of degrees of freedom a degree of freedom in
    * the given triangulation with the given finite element may couple with.
@@ -571,6 +595,16 @@ public:
    */
   active_cell_iterator end_active (const unsigned int level) const;
 
+  /**
+   * Return an iterator to the active cell whose
+   * @ref GlossActiveCellIndex "active cell index" is @p active_cell_index.
+   * This function takes constant time and allows to split loops over all
+   * active cells into ranges of active cell indices, see
+   * Triangulation::active_cell_with_index().
+   */
+  active_cell_iterator
+  active_cell_with_index (const unsigned int active_cell_index) const;
+
 
   /**
    * Iterator to the first used cell on level @p level. This returns a
@@ -1119,6 +1153,26 @@ private:
 
   std::unique_ptr<dealii::internal::DoFHandler::DoFFaces<dim> > mg_faces;
 
+  /**
+   * Whether the cell dof indices caches are to be stored in compressed form,
+   * as set by set_compressed_cell_dof_indices_cache().
+   */
+  bool use_compressed_cell_dof_indices_cache;
+
+  /**
+   * Convert the cell dof indices caches of all levels into compressed form
+   * if so requested by set_compressed_cell_dof_indices_cache().
+   */
+  void compress_cell_dof_indices_caches ();
+
+  /**
+   * Convert the cell dof indices caches of all levels back into their normal
+   * form. The policy classes update the caches cell by cell, which is only
+   * possible in this form, so this function is called before handing off
+   * work to the policy.
+   */
+  void uncompress_cell_dof_indices_caches ();
+
   /**
    * Make accessor objects friends.
    */
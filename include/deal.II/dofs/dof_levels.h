@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1998 - 2015 by the deal.II authors
+// Copyright (C) 1998 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -21,6 +21,7 @@
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/dofs/dof_objects.h>
+#include <algorithm>
 #include <vector>
 
 
@@ -43,6 +44,15 @@ namespace internal
      * DoFCellAccessor::update_cell_dof_indices_cache and are used by
      * DoFCellAccessor::get_dof_indices.
      *
+     * If the global dof indices are 64-bit integers, the cache can be
+     * converted by compress_cell_dof_indices_cache() into an array of 32-bit
+     * integers that store the difference of each index to the smallest index
+     * in the cache. On each processor of a parallel computation, the indices on
+     * the locally relevant cells typically span a range much smaller than the
+     * total number of degrees of freedom, so this halves the memory used by the
+     * cache even if the total number of degrees of freedom does not fit into
+     * 32 bits. See DoFHandler::set_compressed_cell_dof_indices_cache().
+     *
      * Note that vertices are separate from, and in fact have nothing to do
      * with cells. The indices of degrees of freedom located on vertices
      * therefore are not stored here, but rather in member variables of the
@@ -70,12 +80,32 @@ namespace internal
     class DoFLevel
     {
     public:
+      /**
+       * Constructor.
+       */
+      DoFLevel ();
+
       /**
        * Cache for the DoF indices on cells. The size of this array equals the
        * number of cells on a given level times selected_fe.dofs_per_cell.
+       * The array is empty if the cache is stored in compressed form in
+       * #compressed_cell_dof_indices_cache.
        */
       std::vector<types::global_dof_index> cell_dof_indices_cache;
 
+      /**
+       * The cache for the DoF indices on cells in compressed form: the
+       * difference of each index to #cell_dof_indices_cache_offset, or
+       * numbers::invalid_unsigned_int for an invalid index. The array is empty
+       * unless compress_cell_dof_indices_cache() has been called.
+       */
+      std::vector<unsigned int> compressed_cell_dof_indices_cache;
+
+      /**
+       * The smallest DoF index in the compressed cache.
+       */
+      types::global_dof_index cell_dof_indices_cache_offset;
+
       /**
        * The object containing dof-indices and related access-functions
        */
@@ -94,6 +124,34 @@ namespace internal
       get_cell_cache_start (const unsigned int obj_index,
                             const unsigned int dofs_per_cell) const;
 
+      /**
+       * Same as above, but also works if the cache is stored in compressed
+       * form. In that case, the indices of the cell are written into @p
+       * scratch, which is resized to @p dofs_per_cell elements, and a pointer
+       * to its first element is returned. Otherwise, @p scratch is not
+       * touched.
+       */
+      const types::global_dof_index *
+      get_cell_cache_start (const unsigned int                    obj_index,
+                            const unsigned int                    dofs_per_cell,
+                            std::vector<types::global_dof_index> &scratch) const;
+
+      /**
+       * Convert #cell_dof_indices_cache into #compressed_cell_dof_indices_cache
+       * and release the memory of the former. Nothing happens if the global
+       * dof indices are 32-bit integers anyway, if the cache is already
+       * compressed, or if the range of the indices in the cache does not fit
+       * into 32-bit integers.
+       */
+      void compress_cell_dof_indices_cache ();
+
+      /**
+       * Convert the cache back into #cell_dof_indices_cache if it is stored in
+       * compressed form. This needs to happen before the cache can be updated
+       * cell by cell.
+       */
+      void uncompress_cell_dof_indices_cache ();
+
       /**
        * Determine an estimate for the memory consumption (in bytes) of this
        * object.
@@ -111,6 +169,15 @@ namespace internal
 
 
 
+    template <int dim>
+    inline
+    DoFLevel<dim>::DoFLevel ()
+      :
+      cell_dof_indices_cache_offset (0)
+    {}
+
+
+
     template <int dim>
     inline
     const types::global_dof_index *
@@ -127,12 +194,102 @@ namespace internal
 
 
 
+    template <int dim>
+    inline
+    const types::global_dof_index *
+    DoFLevel<dim>::get_cell_cache_start (const unsigned int                    obj_index,
+                                         const unsigned int                    dofs_per_cell,
+                                         std::vector<types::global_dof_index> &scratch) const
+    {
+      if (compressed_cell_dof_indices_cache.empty())
+        return get_cell_cache_start (obj_index, dofs_per_cell);
+
+      Assert (obj_index*dofs_per_cell+dofs_per_cell
+              <=
+              compressed_cell_dof_indices_cache.size(),
+              ExcInternalError());
+
+      scratch.resize (dofs_per_cell);
+      const unsigned int *compressed_indices
+        = &compressed_cell_dof_indices_cache[obj_index*dofs_per_cell];
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        scratch[i] = (compressed_indices[i] == numbers::invalid_unsigned_int ?
+                      numbers::invalid_dof_index :
+                      cell_dof_indices_cache_offset + compressed_indices[i]);
+      return scratch.data();
+    }
+
+
+
+    template <int dim>
+    inline
+    void
+    DoFLevel<dim>::compress_cell_dof_indices_cache ()
+    {
+      // there is nothing to gain if the global indices are 32-bit integers
+      if (sizeof(types::global_dof_index) <= sizeof(unsigned int)
+          ||
+          cell_dof_indices_cache.empty())
+        return;
+
+      types::global_dof_index min_index = numbers::invalid_dof_index,
+                              max_index = 0;
+      for (const types::global_dof_index index : cell_dof_indices_cache)
+        if (index != numbers::invalid_dof_index)
+          {
+            min_index = std::min (min_index, index);
+            max_index = std::max (max_index, index);
+          }
+      if (min_index == numbers::invalid_dof_index)
+        min_index = max_index = 0;
+
+      // the largest difference must be representable, with
+      // invalid_unsigned_int reserved for the invalid indices
+      if (max_index - min_index >= numbers::invalid_unsigned_int)
+        return;
+
+      compressed_cell_dof_indices_cache.resize (cell_dof_indices_cache.size());
+      for (std::size_t i=0; i<cell_dof_indices_cache.size(); ++i)
+        compressed_cell_dof_indices_cache[i]
+          = (cell_dof_indices_cache[i] == numbers::invalid_dof_index ?
+             numbers::invalid_unsigned_int :
+             static_cast<unsigned int>(cell_dof_indices_cache[i] - min_index));
+      cell_dof_indices_cache_offset = min_index;
+
+      // release the memory of the uncompressed cache
+      std::vector<types::global_dof_index>().swap (cell_dof_indices_cache);
+    }
+
+
+
+    template <int dim>
+    inline
+    void
+    DoFLevel<dim>::uncompress_cell_dof_indices_cache ()
+    {
+      if (compressed_cell_dof_indices_cache.empty())
+        return;
+
+      cell_dof_indices_cache.resize (compressed_cell_dof_indices_cache.size());
+      for (std::size_t i=0; i<compressed_cell_dof_indices_cache.size(); ++i)
+        cell_dof_indices_cache[i]
+          = (compressed_cell_dof_indices_cache[i] == numbers::invalid_unsigned_int ?
+             numbers::invalid_dof_index :
+             cell_dof_indices_cache_offset + compressed_cell_dof_indices_cache[i]);
+      cell_dof_indices_cache_offset = 0;
+
+      std::vector<unsigned int>().swap (compressed_cell_dof_indices_cache);
+    }
+
+
+
     template <int dim>
     inline
     std::size_t
     DoFLevel<dim>::memory_consumption () const
     {
       return (MemoryConsumption::memory_consumption (cell_dof_indices_cache) +
+              MemoryConsumption::memory_consumption (compressed_cell_dof_indices_cache) +
               MemoryConsumption::memory_consumption (dof_object));
     }
 
@@ -145,6 +302,8 @@ namespace internal
                               const unsigned int)
     {
       ar &cell_dof_indices_cache;
+      ar &compressed_cell_dof_indices_cache;
+      ar &cell_dof_indices_cache_offset;
       ar &dof_object;
     }
   }
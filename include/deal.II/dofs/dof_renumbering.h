@@ -21,12 +21,15 @@
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/point.h>
 #include <deal.II/dofs/dof_handler.h>
+#include <deal.II/grid/grid_tools.h>
 #include <deal.II/hp/dof_handler.h>
 
 #include <vector>
 
 DEAL_II_NAMESPACE_OPEN
 
+template <int dim, typename Number> class MatrixFree;
+
 /**
  * Implementation of a number of renumbering algorithms for the degrees of
  * freedom on a triangulation.
@@ -936,6 +939,38 @@ namespace DoFRenumbering
                         const Point<DoFHandlerType::space_dimension> &center,
                         const bool                                    counter);
 
+  /**
+   * Cell-wise numbering along a space filling curve through the centers of
+   * the active cells, see GridTools::compute_space_filling_curve_indices().
+   * The function orders the cells along the curve and calls cell_wise(), so
+   * the degrees of freedom of cells close to each other get close indices,
+   * which improves the cache locality of matrix-vector products and of
+   * loops over cells. Unlike hierarchical(), the order is independent of
+   * the order of the coarse cells, which is useful for meshes imported from
+   * files.
+   *
+   * For a parallel::shared::Triangulation, the degrees of freedom are only
+   * renumbered within the range of indices owned by each process, so the
+   * partitioning of the degrees of freedom is retained. A
+   * parallel::distributed::Triangulation is not supported, as its cells are
+   * ordered along the Morton curve within each coarse cell already.
+   */
+  template <typename DoFHandlerType>
+  void
+  space_filling_curve (DoFHandlerType                    &dof_handler,
+                       const GridTools::SpaceFillingCurve curve = GridTools::hilbert_curve);
+
+  /**
+   * Compute the renumbering vector needed by the space_filling_curve()
+   * function. Does not perform the renumbering on the DoFHandler dofs but
+   * returns the renumbering vector.
+   */
+  template <typename DoFHandlerType>
+  void
+  compute_space_filling_curve (std::vector<types::global_dof_index> &new_dof_indices,
+                               const DoFHandlerType                 &dof_handler,
+                               const GridTools::SpaceFillingCurve    curve);
+
   /**
    * @}
    */
@@ -1076,6 +1111,57 @@ namespace DoFRenumbering
    * @}
    */
 
+  /**
+   * @name Numberings based on matrix-free loops
+   * @{
+   */
+
+  /**
+   * Number the locally owned degrees of freedom in the order in which the
+   * cell batches of @p matrix_free access them, i.e., the order in which
+   * MatrixFree::cell_loop() traverses the batches. Within each batch, the
+   * degrees of freedom are visited in the lexicographic order of
+   * FEEvaluation and interleaved over the lanes of the batch, so the first
+   * degree of freedom of all cells in the batch is numbered first, then the
+   * second one, and so on.
+   *
+   * As a consequence, the entries read and written by FEEvaluation for a
+   * batch are close to each other in the vector and are accessed in
+   * ascending order, which helps the hardware prefetchers. The degrees of
+   * freedom in the interior of the cells, which are not shared with other
+   * batches, are then stored interleaved in the vector, which allows
+   * MatrixFree to load them directly into VectorizedArray. For discontinuous elements, this is the
+   * case for all degrees of freedom of cell batches without constraints.
+   *
+   * Unlike MatrixFree::renumber_dofs(), this function also works for
+   * triangulations distributed over several processes, numbering the
+   * locally owned degrees of freedom within their index range, and renumbers
+   * the DoFHandler directly. The MatrixFree object must be initialized again
+   * after the renumbering.
+   *
+   * @p dof_handler must be one of the DoFHandler objects @p matrix_free has
+   * been initialized with, on the active cells.
+   */
+  template <int dim, typename Number>
+  void
+  matrix_free_data_locality (DoFHandler<dim>               &dof_handler,
+                             const MatrixFree<dim,Number> &matrix_free);
+
+  /**
+   * Compute the renumbering vector needed by the matrix_free_data_locality()
+   * function, for the locally owned degrees of freedom. Does not perform the
+   * renumbering on the DoFHandler dofs but returns the renumbering vector.
+   */
+  template <int dim, typename Number>
+  void
+  compute_matrix_free_data_locality (std::vector<types::global_dof_index> &new_dof_indices,
+                                     const DoFHandler<dim>                &dof_handler,
+                                     const MatrixFree<dim,Number>         &matrix_free);
+
+  /**
+   * @}
+   */
+
 
 
   /**
@@ -700,6 +700,45 @@ namespace DoFTools
   make_flux_sparsity_pattern (const DoFHandlerType &dof_handler,
                               SparsityPatternType  &sparsity_pattern);
 
+  /**
+   * Create the sparsity pattern of a discretization with face couplings
+   * between the degrees of freedom of neighboring cells, i.e., the same
+   * pattern that the previous function computes without constraints, and
+   * store it directly in the SparsityPattern object @p sparsity_pattern,
+   * which is reinitialized and compressed by this function.
+   *
+   * The usual way of building such a pattern, by first adding all entries
+   * to a DynamicSparsityPattern and copying it into a SparsityPattern,
+   * temporarily needs memory for both objects, and the DynamicSparsityPattern
+   * is considerably larger than the final pattern for the long rows of high
+   * order discontinuous elements. This function instead computes the
+   * lengths of all rows from the face neighbors of each cell in a first
+   * pass, and then writes the sorted column indices of each row in a second
+   * pass. For elements all of whose degrees of freedom are located in the
+   * interior of cells, such as FE_DGQ, the row lengths are exact, so that no
+   * memory beyond the final pattern is needed, and both passes are run in
+   * parallel over the cells. For other elements, the row lengths are an
+   * upper bound and the passes are sequential.
+   *
+   * For discontinuous elements, each coupling between two cells is a dense
+   * block of the matrix. If the degrees of freedom of each cell are numbered
+   * consecutively and all cells have the same number of degrees of freedom,
+   * the pattern can also be represented with one entry per block by passing
+   * the connectivity of cells computed by
+   * GridTools::get_face_connectivity_of_cells() to
+   * ChunkSparsityPattern::create_from() with a chunk size equal to the
+   * number of degrees of freedom per cell.
+   *
+   * @note This function works on sequential triangulations only and does not
+   * take constraints into account.
+   *
+   * @ingroup constraints
+   */
+  template <typename DoFHandlerType>
+  void
+  create_flux_sparsity_pattern (const DoFHandlerType &dof_handler,
+                                SparsityPattern      &sparsity_pattern);
+
   /**
    * This function does essentially the same as the other
    * make_flux_sparsity_pattern() function but allows the specification of a
@@ -2110,6 +2149,33 @@ namespace DoFTools
   get_active_fe_indices (const DoFHandlerType      &dof_handler,
                          std::vector<unsigned int> &active_fe_indices);
 
+  /**
+   * Return the active cells of a DoFHandler or hp::DoFHandler sorted by
+   * their active finite element index, keeping the order of the cells in
+   * the mesh among cells with the same index.
+   *
+   * hp::FEValues keeps one FEValues object with its own tables for each
+   * finite element of the collection. Traversing the cells in mesh order
+   * switches between these objects at almost every cell, so the tables of
+   * the different elements compete for the caches of the processor and the
+   * detection of similar cells in FEValues::reinit() rarely applies. Loops
+   * over the returned cells instead use the same element for long stretches
+   * of cells. The cells can be given to WorkStream::run() as the range
+   * <tt>cells.begin()</tt> to <tt>cells.end()</tt>, in which case the worker
+   * function receives an iterator into the vector that needs to be
+   * dereferenced to get the cell. As WorkStream groups consecutive cells
+   * into chunks, almost all chunks contain cells of a single active finite
+   * element index.
+   *
+   * For non-hp DoFHandler objects given as first argument, the cells are
+   * returned in the order of the mesh. The function returns all active
+   * cells, including ghost and artificial cells on parallel triangulations,
+   * which the caller may have to skip.
+   */
+  template <typename DoFHandlerType>
+  std::vector<typename DoFHandlerType::active_cell_iterator>
+  get_active_cells_sorted_by_fe_index (const DoFHandlerType &dof_handler);
+
   /**
    * Count how many degrees of freedom live on a set of cells (i.e., a patch)
    * described by the argument.
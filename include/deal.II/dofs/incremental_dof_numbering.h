@@ -0,0 +1,244 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_incremental_dof_numbering_h
+#define dealii_incremental_dof_numbering_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/dofs/dof_handler.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/**
+ * A class that keeps the numbers of the degrees of freedom on the part of a
+ * mesh that does not change in a step of refinement and coarsening. A call
+ * to DoFHandler::distribute_dofs() after Triangulation::execute_coarsening_and_refinement()
+ * numbers all degrees of freedom from scratch, so that all structures built
+ * on the numbering, like sparsity patterns, constraints, or the data of the
+ * MatrixFree class, have to be rebuilt even if only a few cells changed.
+ * This class instead renumbers the degrees of freedom after distributing
+ * them such that the degrees of freedom on all cells that have been neither
+ * refined nor coarsened keep their previous numbers (or at least their
+ * previous order, see CompactionPolicy), and reports which numbers are new.
+ *
+ * The usage is similar to the one of SolutionTransfer:
+ * @code
+ *   IncrementalDoFNumbering<dim> incremental_numbering (dof_handler);
+ *
+ *   // flag some cells for refinement and coarsening, e.g.
+ *   GridRefinement::refine_and_coarsen_fixed_fraction (triangulation,
+ *                                                      error_indicators,
+ *                                                      0.05, 0.01);
+ *   triangulation.prepare_coarsening_and_refinement ();
+ *   incremental_numbering.prepare_for_coarsening_and_refinement ();
+ *   triangulation.execute_coarsening_and_refinement ();
+ *
+ *   // instead of dof_handler.distribute_dofs (fe)
+ *   incremental_numbering.distribute_dofs (fe);
+ *
+ *   // the degrees of freedom with new numbers, e.g., to find the rows of
+ *   // a matrix that need to be recomputed
+ *   const IndexSet &new_dofs = incremental_numbering.get_new_dofs ();
+ * @endcode
+ *
+ * The degrees of freedom that are kept are those on the active cells without
+ * refinement or coarsening flags at the time of
+ * prepare_for_coarsening_and_refinement(). This includes the degrees of
+ * freedom on faces between unchanged cells and refined or coarsened cells,
+ * which may become constrained by hanging node constraints in the step.
+ *
+ * The class only works with sequential triangulations and with DoFHandler
+ * objects that use the same finite element before and after the step.
+ *
+ * @ingroup dofs
+ */
+template <int dim, int spacedim=dim>
+class IncrementalDoFNumbering : public Subscriptor
+{
+public:
+  /**
+   * The choice of the new numbers of the degrees of freedom that are kept
+   * from the previous numbering.
+   */
+  enum CompactionPolicy
+  {
+    /**
+     * The degrees of freedom that are kept retain their previous numbers,
+     * and the new degrees of freedom fill the numbers that are not used by
+     * them, in ascending order. If a kept number is larger than or equal to
+     * the new number of degrees of freedom, which may happen if cells have
+     * been coarsened, the function falls back to #preserve_order.
+     */
+    preserve_numbers,
+
+    /**
+     * The degrees of freedom that are kept are numbered first, in the order
+     * of their previous numbers, followed by the new degrees of freedom.
+     * Thus, the unchanged part of the mesh occupies one contiguous range of
+     * numbers at the start.
+     */
+    preserve_order
+  };
+
+  /**
+   * Constructor. Takes the DoFHandler whose numbering is to be kept.
+   */
+  IncrementalDoFNumbering (DoFHandler<dim,spacedim> &dof_handler,
+                           const CompactionPolicy    compaction_policy = preserve_numbers);
+
+  /**
+   * Store the numbers of the degrees of freedom on all active cells that
+   * have neither the refine nor the coarsen flag set. Call this function
+   * after Triangulation::prepare_coarsening_and_refinement() and before
+   * Triangulation::execute_coarsening_and_refinement().
+   */
+  void prepare_for_coarsening_and_refinement ();
+
+  /**
+   * Distribute the degrees of freedom of @p fe on the refined and coarsened
+   * mesh by DoFHandler::distribute_dofs(), and renumber them according to the
+   * compaction policy such that the degrees of freedom stored in
+   * prepare_for_coarsening_and_refinement() keep their previous numbers or
+   * order. The finite element must be the same as before the refinement
+   * step.
+   */
+  void distribute_dofs (const FiniteElement<dim,spacedim> &fe);
+
+  /**
+   * Return whether all degrees of freedom kept in the last call of
+   * distribute_dofs() have retained their previous numbers. This is not the
+   * case for the policy #preserve_order, or if #preserve_numbers had to fall
+   * back to it.
+   */
+  bool numbers_preserved () const;
+
+  /**
+   * Return the set of the numbers of those degrees of freedom that did not
+   * exist on the unchanged cells at the last call of
+   * prepare_for_coarsening_and_refinement(), i.e., the degrees of freedom
+   * on the refined or coarsened parts of the mesh.
+   */
+  const IndexSet &get_new_dofs () const;
+
+  /**
+   * Return, for each number of a degree of freedom before the refinement step,
+   * its new number after the last call of distribute_dofs(), or
+   * numbers::invalid_dof_index if the degree of freedom did not live on an
+   * unchanged cell.
+   */
+  const std::vector<types::global_dof_index> &get_old_to_new_numbers () const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t memory_consumption () const;
+
+  /**
+   * Exception
+   */
+  DeclExceptionMsg (ExcNotPrepared,
+                    "You need to call prepare_for_coarsening_and_refinement() "
+                    "before distribute_dofs().");
+
+private:
+  /**
+   * The DoFHandler.
+   */
+  SmartPointer<DoFHandler<dim,spacedim>,IncrementalDoFNumbering<dim,spacedim> > dof_handler;
+
+  /**
+   * The selected compaction policy.
+   */
+  const CompactionPolicy compaction_policy;
+
+  /**
+   * The number of degrees of freedom and of dofs per cell at the time of
+   * prepare_for_coarsening_and_refinement().
+   */
+  types::global_dof_index n_old_dofs;
+  unsigned int            dofs_per_cell;
+
+  /**
+   * The level and index of the unchanged cells, and their dof indices, with
+   * the indices of cell <tt>c</tt> stored at positions
+   * <tt>c*dofs_per_cell</tt> to <tt>(c+1)*dofs_per_cell</tt>. An active cell
+   * that is neither refined nor coarsened keeps its level and index in the
+   * triangulation.
+   */
+  std::vector<std::pair<unsigned int, unsigned int> > unchanged_cells;
+  std::vector<types::global_dof_index>                unchanged_dof_indices;
+
+  /**
+   * Whether prepare_for_coarsening_and_refinement() has been called since
+   * the last call of distribute_dofs().
+   */
+  bool prepared;
+
+  /**
+   * The results of the last call of distribute_dofs().
+   */
+  bool                                 all_numbers_preserved;
+  IndexSet                             new_dofs;
+  std::vector<types::global_dof_index> old_to_new_numbers;
+};
+
+
+
+/*----------------------------- Inline functions ----------------------------*/
+
+#ifndef DOXYGEN
+
+template <int dim, int spacedim>
+inline
+bool
+IncrementalDoFNumbering<dim,spacedim>::numbers_preserved () const
+{
+  return all_numbers_preserved;
+}
+
+
+
+template <int dim, int spacedim>
+inline
+const IndexSet &
+IncrementalDoFNumbering<dim,spacedim>::get_new_dofs () const
+{
+  return new_dofs;
+}
+
+
+
+template <int dim, int spacedim>
+inline
+const std::vector<types::global_dof_index> &
+IncrementalDoFNumbering<dim,spacedim>::get_old_to_new_numbers () const
+{
+  return old_to_new_numbers;
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,346 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_fe_point_evaluation_h
+#define dealii_fe_point_evaluation_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/polynomial.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/tensor.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/mapping_q_generic.h>
+#include <deal.II/grid/tria.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*!@addtogroup feaccess */
+/*@{*/
+
+
+/**
+ * A class that evaluates a finite element function and its gradient at an
+ * arbitrary list of points on the reference cell, which may be different on
+ * every cell. This is the situation of particles, immersed interfaces, or
+ * non-matching quadrature formulas, where creating an FEValues object with a
+ * Quadrature made from the points of each cell would allocate and fill all
+ * its tables anew on each cell.
+ *
+ * If the finite element is a scalar element whose shape functions are the
+ * tensor product of the Lagrange polynomials in its one-dimensional support
+ * points, like FE_Q, FE_DGQ, and FE_DGQArbitraryNodes, the class evaluates
+ * the one-dimensional polynomials at the coordinates of each point and sums
+ * the tensor product one direction at a time. This costs
+ * $\mathcal O(k^d)$ operations per point for an element of degree $k$, rather
+ * than evaluating all $(k+1)^d$ shape functions. The same technique is
+ * applied to the tensor product polynomials of the MappingQGeneric to
+ * compute the location of the points in real space and the Jacobians of the
+ * transformation. Other scalar elements are supported by evaluating their
+ * shape functions at each point with FiniteElement::shape_value() and
+ * FiniteElement::shape_grad().
+ *
+ * A typical use looks as follows:
+ * @code
+ *   FEPointEvaluation<dim> evaluator (mapping, fe);
+ *   Vector<double> local_values (fe.dofs_per_cell);
+ *   for (auto cell : dof_handler.active_cell_iterators())
+ *     {
+ *       // reference coordinates of the particles in the cell, e.g. from
+ *       // Mapping::transform_real_to_unit_cell()
+ *       const std::vector<Point<dim> > &unit_points = ...;
+ *       cell->get_dof_values (solution, local_values);
+ *
+ *       evaluator.reinit (cell, unit_points);
+ *       evaluator.evaluate (make_array_view(local_values), true, true);
+ *       for (unsigned int p=0; p<evaluator.n_points(); ++p)
+ *         {
+ *           const double         value    = evaluator.get_value(p);
+ *           const Tensor<1,dim> &gradient = evaluator.get_gradient(p);
+ *           ...
+ *         }
+ *     }
+ * @endcode
+ */
+template <int dim>
+class FEPointEvaluation : public Subscriptor
+{
+public:
+  /**
+   * Constructor. Sets up the one-dimensional polynomials of @p fe and of @p
+   * mapping if they have a tensor product structure. The finite element must
+   * be scalar.
+   */
+  FEPointEvaluation (const MappingQGeneric<dim> &mapping,
+                     const FiniteElement<dim>   &fe);
+
+  /**
+   * Set up the evaluation at the points @p unit_points given in the reference
+   * coordinates of @p cell. Computes the location of the points in real space
+   * and the inverse Jacobians of the mapping.
+   */
+  void reinit (const typename Triangulation<dim>::cell_iterator &cell,
+               const ArrayView<const Point<dim> >               &unit_points);
+
+  /**
+   * Same as above. Convenience function for a vector of points.
+   */
+  void reinit (const typename Triangulation<dim>::cell_iterator &cell,
+               const std::vector<Point<dim> >                   &unit_points);
+
+  /**
+   * Evaluate the finite element function with the coefficients @p
+   * solution_values, given in the numbering of the degrees of freedom of the
+   * element on the cell, at the points given to the last call of reinit().
+   * The arguments @p evaluate_values and @p evaluate_gradients select which
+   * of the values and the gradients are computed.
+   */
+  void evaluate (const ArrayView<const double> &solution_values,
+                 const bool                     evaluate_values,
+                 const bool                     evaluate_gradients);
+
+  /**
+   * Return the number of points given to the last call of reinit().
+   */
+  unsigned int n_points () const;
+
+  /**
+   * Return the value at point number @p point_index computed by the last
+   * call of evaluate().
+   */
+  double get_value (const unsigned int point_index) const;
+
+  /**
+   * Return the gradient in real coordinates at point number @p point_index
+   * computed by the last call of evaluate().
+   */
+  const Tensor<1,dim> &get_gradient (const unsigned int point_index) const;
+
+  /**
+   * Return the gradient with respect to the reference coordinates at point
+   * number @p point_index computed by the last call of evaluate().
+   */
+  const Tensor<1,dim> &get_unit_gradient (const unsigned int point_index) const;
+
+  /**
+   * Return the location in real coordinates of point number @p point_index.
+   */
+  const Point<dim> &real_point (const unsigned int point_index) const;
+
+  /**
+   * Return the location in reference coordinates of point number @p
+   * point_index.
+   */
+  const Point<dim> &unit_point (const unsigned int point_index) const;
+
+  /**
+   * Return the Jacobian of the transformation from the reference cell at
+   * point number @p point_index, where the entry $(d,e)$ is the derivative of
+   * the real coordinate $d$ with respect to the reference coordinate $e$.
+   */
+  const Tensor<2,dim> &jacobian (const unsigned int point_index) const;
+
+  /**
+   * Return whether the shape functions of the finite element are evaluated
+   * with the tensor product of one-dimensional polynomials.
+   */
+  bool uses_tensor_product_evaluation () const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * The mapping.
+   */
+  SmartPointer<const MappingQGeneric<dim>,FEPointEvaluation<dim> > mapping;
+
+  /**
+   * The finite element.
+   */
+  SmartPointer<const FiniteElement<dim>,FEPointEvaluation<dim> > fe;
+
+  /**
+   * The one-dimensional polynomials of the finite element in case its shape
+   * functions are tensor products of them, or empty otherwise.
+   */
+  std::vector<Polynomials::Polynomial<double> > fe_polynomials;
+
+  /**
+   * The lexicographic numbering of the shape functions of the finite
+   * element, i.e., the index of the shape function that is the tensor
+   * product of one-dimensional polynomials with index <tt>i</tt> running
+   * fastest in x direction.
+   */
+  std::vector<unsigned int> fe_lexicographic_numbering;
+
+  /**
+   * The one-dimensional polynomials of the mapping.
+   */
+  std::vector<Polynomials::Polynomial<double> > mapping_polynomials;
+
+  /**
+   * For each support point of the mapping in the order of
+   * MappingQGeneric::compute_mapping_support_points(), its index in the
+   * lexicographic numbering of the tensor product of the one-dimensional
+   * polynomials of the mapping.
+   */
+  std::vector<unsigned int> mapping_lexicographic_numbering;
+
+  /**
+   * The coordinates of the mapping support points of the current cell in
+   * lexicographic numbering, with the coordinate direction running slowest.
+   */
+  std::vector<double> mapping_support_points;
+
+  /**
+   * Values and derivatives of the one-dimensional polynomials of the finite
+   * element at the coordinates of the points, stored as value and derivative
+   * of polynomial <tt>i</tt> in direction <tt>d</tt> at point <tt>q</tt> in
+   * the entries <tt>((q*dim+d)*n_polynomials+i)*2</tt> and the next one.
+   */
+  std::vector<double> fe_polynomial_values;
+
+  /**
+   * Values and unit gradients of the shape functions at the points if the
+   * finite element is not evaluated with the tensor product of
+   * one-dimensional polynomials, indexed by shape function and point.
+   */
+  Table<2,double>         shape_values;
+  Table<2,Tensor<1,dim> > shape_gradients;
+
+  /**
+   * Temporary array for the coefficients of the solution in lexicographic
+   * numbering.
+   */
+  std::vector<double> lexicographic_values;
+
+  /**
+   * The data at the points of the current cell.
+   */
+  std::vector<Point<dim> >    unit_points;
+  std::vector<Point<dim> >    real_points;
+  std::vector<Tensor<2,dim> > jacobians;
+  std::vector<Tensor<2,dim> > inverse_jacobians;
+  std::vector<double>         values;
+  std::vector<Tensor<1,dim> > unit_gradients;
+  std::vector<Tensor<1,dim> > gradients;
+};
+
+/*@}*/
+
+
+/*------------------------ Inline functions: FEPointEvaluation --------------*/
+
+#ifndef DOXYGEN
+
+template <int dim>
+inline
+unsigned int
+FEPointEvaluation<dim>::n_points () const
+{
+  return unit_points.size();
+}
+
+
+
+template <int dim>
+inline
+double
+FEPointEvaluation<dim>::get_value (const unsigned int point_index) const
+{
+  AssertIndexRange (point_index, values.size());
+  return values[point_index];
+}
+
+
+
+template <int dim>
+inline
+const Tensor<1,dim> &
+FEPointEvaluation<dim>::get_gradient (const unsigned int point_index) const
+{
+  AssertIndexRange (point_index, gradients.size());
+  return gradients[point_index];
+}
+
+
+
+template <int dim>
+inline
+const Tensor<1,dim> &
+FEPointEvaluation<dim>::get_unit_gradient (const unsigned int point_index) const
+{
+  AssertIndexRange (point_index, unit_gradients.size());
+  return unit_gradients[point_index];
+}
+
+
+
+template <int dim>
+inline
+const Point<dim> &
+FEPointEvaluation<dim>::real_point (const unsigned int point_index) const
+{
+  AssertIndexRange (point_index, real_points.size());
+  return real_points[point_index];
+}
+
+
+
+template <int dim>
+inline
+const Point<dim> &
+FEPointEvaluation<dim>::unit_point (const unsigned int point_index) const
+{
+  AssertIndexRange (point_index, unit_points.size());
+  return unit_points[point_index];
+}
+
+
+
+template <int dim>
+inline
+const Tensor<2,dim> &
+FEPointEvaluation<dim>::jacobian (const unsigned int point_index) const
+{
+  AssertIndexRange (point_index, jacobians.size());
+  return jacobians[point_index];
+}
+
+
+
+template <int dim>
+inline
+bool
+FEPointEvaluation<dim>::uses_tensor_product_evaluation () const
+{
+  return fe_polynomials.size() > 0;
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
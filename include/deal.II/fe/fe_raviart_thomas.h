@@ -22,6 +22,7 @@
 #include <deal.II/base/polynomial.h>
 #include <deal.II/base/tensor_product_polynomials.h>
 #include <deal.II/base/geometry_info.h>
+#include <deal.II/base/thread_management.h>
 #include <deal.II/fe/fe.h>
 #include <deal.II/fe/fe_poly_tensor.h>
 
@@ -145,6 +146,28 @@ public:
   virtual std::pair<Table<2,bool>, std::vector<unsigned int> >
   get_constant_modes () const;
 
+  /**
+   * Projection from a fine grid space onto a coarse grid space. Overrides the
+   * respective method in FiniteElement, implementing lazy evaluation
+   * (initialize when requested): the embedding and restriction matrices are
+   * expensive to compute for higher degrees and are not needed by many
+   * programs, so they are not computed in the constructor.
+   *
+   * Only the matrices for isotropic refinement are available.
+   */
+  virtual const FullMatrix<double> &
+  get_restriction_matrix (const unsigned int child,
+                          const RefinementCase<dim> &refinement_case=RefinementCase<dim>::isotropic_refinement) const;
+
+  /**
+   * Embedding matrix between grids. Overrides the respective method in
+   * FiniteElement, implementing lazy evaluation (initialize when requested)
+   * like get_restriction_matrix().
+   */
+  virtual const FullMatrix<double> &
+  get_prolongation_matrix (const unsigned int child,
+                           const RefinementCase<dim> &refinement_case=RefinementCase<dim>::isotropic_refinement) const;
+
   virtual std::size_t memory_consumption () const;
 
 private:
@@ -157,6 +180,14 @@ private:
   static std::vector<unsigned int>
   get_dpo_vector (const unsigned int degree);
 
+  /**
+   * Compute the embedding matrices of all refinement cases and the
+   * restriction matrices of the isotropic refinement. Called from
+   * get_prolongation_matrix() and get_restriction_matrix() upon the first
+   * request, with #mutex held.
+   */
+  void initialize_embedding_and_restriction ();
+
   /**
    * Initialize the @p generalized_support_points field of the FiniteElement
    * class and fill the tables with interpolation weights (#boundary_weights
@@ -192,6 +223,12 @@ private:
    */
   Table<3, double> interior_weights;
 
+  /**
+   * Mutex for protecting the initialization of the restriction and
+   * embedding matrices.
+   */
+  mutable Threads::Mutex mutex;
+
   /**
    * Allow access from other dimensions.
    */
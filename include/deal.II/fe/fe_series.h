@@ -107,6 +107,23 @@ namespace FESeries
                    const unsigned int                cell_active_fe_index,
                    Table<dim,std::complex<double> > &fourier_coefficients);
 
+    /**
+     * Calculate the Fourier coefficients of many cells at once. The cell
+     * vector field of the <tt>i</tt>th cell is given by
+     * <tt>local_dof_values[i]</tt> and corresponds to the FiniteElement with
+     * index <tt>cell_active_fe_indices[i]</tt>. The coefficients are returned
+     * in <tt>fourier_coefficients[i]</tt>, which is resized as necessary.
+     *
+     * The transformation matrices of all finite elements involved are
+     * computed first, after which the cells are processed in parallel on all
+     * available threads. This is considerably faster than calling the
+     * function above once for every cell, for example when collecting the
+     * local values of all active cells to estimate their smoothness.
+     */
+    void calculate(const std::vector<dealii::Vector<double> >        &local_dof_values,
+                   const std::vector<unsigned int>                   &cell_active_fe_indices,
+                   std::vector<Table<dim,std::complex<double> > >    &fourier_coefficients);
+
   private:
     /**
      * hp::FECollection for which transformation matrices will be calculated.
@@ -208,6 +225,21 @@ namespace FESeries
                    const unsigned int            cell_active_fe_index,
                    Table<dim,double>            &legendre_coefficients);
 
+    /**
+     * Calculate the Legendre coefficients of many cells at once. The cell
+     * vector field of the <tt>i</tt>th cell is given by
+     * <tt>local_dof_values[i]</tt> and corresponds to the FiniteElement with
+     * index <tt>cell_active_fe_indices[i]</tt>. The coefficients are returned
+     * in <tt>legendre_coefficients[i]</tt>, which is resized as necessary.
+     *
+     * The transformation matrices of all finite elements involved are
+     * computed first, after which the cells are processed in parallel on all
+     * available threads.
+     */
+    void calculate(const std::vector<dealii::Vector<double> > &local_dof_values,
+                   const std::vector<unsigned int>            &cell_active_fe_indices,
+                   std::vector<Table<dim,double> >            &legendre_coefficients);
+
   private:
     /**
      * Number of coefficients in each direction
@@ -25,6 +25,7 @@
 #include <deal.II/fe/fe.h>
 #include <deal.II/fe/fe_tools.h>
 
+#include <array>
 #include <vector>
 #include <memory>
 #include <utility>
@@ -1061,6 +1062,19 @@ private:
    */
   std::vector<std::vector<std::size_t>> generalized_support_points_index_table;
 
+  /**
+   * For each base element, the list of shape functions of this element that
+   * belong to it. Each entry holds the index of the shape function in this
+   * element, the row of its first nonzero component in the tables of shape
+   * values of this element, and the respective row in the tables of the base
+   * element. All copies of a base element share the data of the base
+   * element, so compute_fill() uses this table to copy the data into the
+   * tables of this element in time proportional to the number of shape
+   * functions, rather than searching through all shape functions for each
+   * base element.
+   */
+  std::vector<std::vector<std::array<unsigned int,3> > > base_element_shape_function_table;
+
   /**
    * This function is simply singled out of the constructors since there are
    * several of them. It sets up the index table for the system as well as @p
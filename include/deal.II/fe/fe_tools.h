@@ -30,6 +30,7 @@
 
 
 
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -1230,6 +1231,38 @@ namespace FETools
   get_fe_by_name (const std::string &name);
 
 
+  /**
+   * Return a finite element described by @p name as in get_fe_by_name(), but
+   * shared with all other callers that ask for the same element while it is
+   * still in use. The elements are kept in a registry keyed by the given
+   * name and by the name FiniteElement::get_name() returns for the element.
+   * The registry only holds weak references, so an element is destroyed as
+   * soon as the last of the returned pointers is released, and created anew
+   * by the next call.
+   *
+   * Constructing an element, in particular FE_Q, FE_DGQ or FESystem of
+   * higher degree, involves computing support points as well as constraint,
+   * restriction and prolongation matrices. Codes that create the same
+   * element over and over again, for example for each level of a
+   * multigrid hierarchy or after each remeshing step, can use this function
+   * to construct it only once and to store it only once.
+   *
+   * This function can be called from several threads at the same time.
+   */
+  template <int dim, int spacedim = dim>
+  std::shared_ptr<const FiniteElement<dim, spacedim> >
+  get_shared_fe_by_name (const std::string &name);
+
+  /**
+   * Same as above, but return the shared element that is equal to @p fe, as
+   * identified by FiniteElement::get_name(). If no such element is in use,
+   * a copy of @p fe is stored.
+   */
+  template <int dim, int spacedim>
+  std::shared_ptr<const FiniteElement<dim, spacedim> >
+  get_shared_fe (const FiniteElement<dim, spacedim> &fe);
+
+
   /**
    * @deprecated Use get_fe_by_name() with two template parameters instead
    */
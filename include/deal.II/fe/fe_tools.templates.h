@@ -60,7 +60,9 @@
 #include <deal.II/base/index_set.h>
 
 #include <cctype>
+#include <functional>
 #include <iostream>
+#include <map>
 #include <memory>
 
 
@@ -2661,6 +2663,102 @@ namespace FETools
 
 
 
+  namespace internal
+  {
+    // The registry of the shared finite elements returned by
+    // get_shared_fe_by_name() and get_shared_fe(), along with the lock
+    // that guards it. Both are function-local statics of a function
+    // template, so that there is one registry for each pair of dim and
+    // spacedim
+    template <int dim, int spacedim>
+    std::map<std::string, std::weak_ptr<const FiniteElement<dim,spacedim> > > &
+    get_shared_fe_registry (Threads::Mutex *&mutex)
+    {
+      static Threads::Mutex registry_mutex;
+      static std::map<std::string, std::weak_ptr<const FiniteElement<dim,spacedim> > >
+      registry;
+
+      mutex = &registry_mutex;
+      return registry;
+    }
+
+
+
+    // Look up the element with the given key in the registry, and
+    // create it with the given function if it does not exist or is no
+    // longer in use
+    template <int dim, int spacedim>
+    std::shared_ptr<const FiniteElement<dim,spacedim> >
+    get_shared_fe (const std::string &key,
+                   const std::function<FiniteElement<dim,spacedim>*()> &create_fe)
+    {
+      Threads::Mutex *mutex;
+      std::map<std::string, std::weak_ptr<const FiniteElement<dim,spacedim> > >
+      &registry = get_shared_fe_registry<dim,spacedim> (mutex);
+      Threads::Mutex::ScopedLock lock (*mutex);
+
+      const auto entry = registry.find (key);
+      if (entry != registry.end())
+        if (std::shared_ptr<const FiniteElement<dim,spacedim> > fe = entry->second.lock())
+          return fe;
+
+      // remove the entries of the elements that are no longer in use, so
+      // that the registry does not grow with elements used only once
+      for (auto it = registry.begin(); it != registry.end(); )
+        if (it->second.expired())
+          it = registry.erase (it);
+        else
+          ++it;
+
+      // an equal element may be in use under its own name if the key
+      // was spelled differently. otherwise create it
+      std::shared_ptr<const FiniteElement<dim,spacedim> > fe (create_fe());
+      const std::string name = fe->get_name();
+      if (name != key)
+        {
+          const auto named_entry = registry.find (name);
+          if (named_entry != registry.end())
+            if (std::shared_ptr<const FiniteElement<dim,spacedim> > existing_fe
+                = named_entry->second.lock())
+              fe = existing_fe;
+          registry[name] = fe;
+        }
+      registry[key] = fe;
+
+      return fe;
+    }
+  }
+
+
+
+  template <int dim, int spacedim>
+  std::shared_ptr<const FiniteElement<dim, spacedim> >
+  get_shared_fe_by_name (const std::string &name)
+  {
+    return internal::get_shared_fe<dim,spacedim>
+           (Utilities::trim(name),
+            [&name]()
+    {
+      return get_fe_by_name<dim,spacedim> (name);
+    });
+  }
+
+
+
+  template <int dim, int spacedim>
+  std::shared_ptr<const FiniteElement<dim, spacedim> >
+  get_shared_fe (const FiniteElement<dim, spacedim> &fe)
+  {
+    return internal::get_shared_fe<dim,spacedim>
+           (fe.get_name(),
+            [&fe]()
+    {
+      return fe.clone().release();
+    });
+  }
+
+
+
   template <int dim, int spacedim>
   void
   compute_projection_from_quadrature_points_matrix (const FiniteElement<dim,spacedim> &fe,
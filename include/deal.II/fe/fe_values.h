@@ -18,6 +18,7 @@
 
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/aligned_vector.h>
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/subscriptor.h>
 #include <deal.II/base/point.h>
@@ -37,7 +38,9 @@
 #include <deal.II/fe/mapping.h>
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <unordered_map>
 #include <type_traits>
 
 
@@ -2059,6 +2062,25 @@ public:
   void get_function_values (const InputVector       &fe_function,
                             std::vector<Vector<typename InputVector::value_type> > &values) const;
 
+  /**
+   * Evaluate several finite element functions at the same time. This
+   * function does the same as calling the previous function once for each
+   * of the vectors in @p fe_functions, but runs over the table of shape
+   * function values only once for all of them, which is considerably faster
+   * if many vectors, e.g., the concentrations of many species, are defined
+   * on the same DoFHandler.
+   *
+   * @post <code>values[v][q](c)</code> is the value of the $c$th vector
+   * component of the field described by <code>*fe_functions[v]</code> at the
+   * $q$th quadrature point. The object is assumed to already have the
+   * correct size.
+   *
+   * @dealiiRequiresUpdateFlags{update_values}
+   */
+  template <class InputVector>
+  void get_function_values (const std::vector<const InputVector *> &fe_functions,
+                            std::vector<std::vector<Vector<typename InputVector::value_type> > > &values) const;
+
   /**
    * Generate function values from an arbitrary vector.
    *
@@ -2211,6 +2233,21 @@ public:
   void get_function_gradients (const InputVector               &fe_function,
                                std::vector<std::vector<Tensor<1,spacedim,typename InputVector::value_type> > > &gradients) const;
 
+  /**
+   * Evaluate the gradients of several finite element functions at the same
+   * time, in analogy to the get_function_values() function for several
+   * vectors.
+   *
+   * @post <code>gradients[v][q][c]</code> is the gradient of the $c$th
+   * vector component of the field described by <code>*fe_functions[v]</code>
+   * at the $q$th quadrature point.
+   *
+   * @dealiiRequiresUpdateFlags{update_gradients}
+   */
+  template <class InputVector>
+  void get_function_gradients (const std::vector<const InputVector *> &fe_functions,
+                               std::vector<std::vector<std::vector<Tensor<1,spacedim,typename InputVector::value_type> > > > &gradients) const;
+
   /**
    * Function gradient access with more flexibility. See get_function_values()
    * with corresponding arguments.
@@ -3038,6 +3075,84 @@ protected:
   void
   check_cell_similarity (const typename Triangulation<dim,spacedim>::cell_iterator &cell);
 
+  /**
+   * The data needed to evaluate finite element functions with sum
+   * factorization, i.e., by applying the one-dimensional shape functions
+   * dimension by dimension at a cost proportional to $(p+1)^{d+1}$ rather
+   * than $(p+1)^{2d}$ operations. It is set up by FEValues for scalar
+   * elements with tensor product shape functions like FE_Q and FE_DGQ of
+   * degree two and higher on tensor product quadrature formulas like QGauss,
+   * and is used by get_function_values(), get_function_gradients(), and the
+   * respective functions of FEValuesViews::Scalar.
+   */
+  struct TensorProductData
+  {
+    /**
+     * The number of shape functions and quadrature points per direction.
+     */
+    unsigned int n_dofs_1d;
+    unsigned int n_q_points_1d;
+
+    /**
+     * The values and derivatives of the one-dimensional shape functions at
+     * the one-dimensional quadrature points, with the entry for shape
+     * function $i$ and point $q$ at position $i\cdot n_{q,1d}+q$.
+     */
+    AlignedVector<double> shape_values;
+    AlignedVector<double> shape_gradients;
+
+    /**
+     * The index of the shape function of the element for each shape function
+     * in lexicographic order.
+     */
+    std::vector<unsigned int> lexicographic_numbering;
+  };
+
+  /**
+   * The data for evaluation with sum factorization, or a null pointer if the
+   * element or the quadrature formula are not of tensor product type.
+   */
+  std::unique_ptr<const TensorProductData> tensor_product_data;
+
+  /**
+   * Compute the values of the function given by the coefficients @p
+   * dof_values on the present cell with sum factorization and write them to
+   * the array @p values of length n_quadrature_points. If sum factorization
+   * is not available, nothing is done and @p false is returned.
+   *
+   * This general version is used for vector types that do not store @p
+   * double entries and always returns @p false.
+   */
+  template <typename Number, typename OutputNumber>
+  bool
+  get_function_values_with_sum_factorization (const Number *dof_values,
+                                              OutputNumber *values) const;
+
+  /**
+   * Same as above, for @p double entries where sum factorization is
+   * available.
+   */
+  bool
+  get_function_values_with_sum_factorization (const double *dof_values,
+                                              double       *values) const;
+
+  /**
+   * Like get_function_values_with_sum_factorization(), but for the gradients
+   * of the function.
+   */
+  template <typename Number, typename OutputNumber>
+  bool
+  get_function_gradients_with_sum_factorization (const Number                    *dof_values,
+                                                 Tensor<1,spacedim,OutputNumber> *gradients) const;
+
+  /**
+   * Same as above, for @p double entries where sum factorization is
+   * available.
+   */
+  bool
+  get_function_gradients_with_sum_factorization (const double       *dof_values,
+                                                 Tensor<1,spacedim> *gradients) const;
+
 private:
   /**
    * Copy constructor. Since objects of this class are not copyable, we make
@@ -3130,6 +3245,47 @@ public:
    */
   void reinit (const typename Triangulation<dim,spacedim>::cell_iterator &cell);
 
+  /**
+   * Enable a cache of the data computed by reinit() that is addressed by the
+   * geometry of the cell. If enabled, reinit() computes the support points
+   * of the mapping on the given cell and looks up their locations relative
+   * to the first support point (i.e., the shape of the cell up to a
+   * translation) in a hash table. If the same shape has been seen before,
+   * the mapping and finite element data stored for it are copied and only
+   * the quadrature points are shifted, skipping the computation of
+   * Jacobians and shape function gradients. Otherwise, the data is computed
+   * as usual and stored in the cache until @p max_n_geometries entries have
+   * been collected. A value of zero, the default, disables the cache.
+   *
+   * Contrary to the check for CellSimilarity::translation, which only
+   * compares with the previous cell, this finds repeated shapes anywhere in
+   * the mesh, e.g. on structured meshes or meshes obtained by refining a
+   * coarse mesh where only a few distinct cell shapes exist per level. Two
+   * shapes are considered equal if the relative locations of their support
+   * points agree up to a relative tolerance of about $10^{-12}$.
+   *
+   * @note The cache can only be used with mappings derived from
+   * MappingQGeneric, whose support points entirely describe the geometry of
+   * a cell. It also assumes that the data computed by the finite element
+   * does not depend on the cell except through the mapping, which is the
+   * case for elements whose shape functions are defined on the reference
+   * cell like FE_Q, FE_DGQ, FE_DGP, FE_Q_Hierarchical, and FESystem of
+   * those, but not for elements with sign changes or shape functions defined
+   * on the real cell like FE_RaviartThomas, FE_Nedelec, or
+   * FE_DGPNonparametric.
+   *
+   * @note As for CellSimilarity, the data used on a cell depends on which
+   * cell of the same shape was visited first, which results in differences
+   * at the level of roundoff when the order of cells changes between runs.
+   */
+  void set_geometry_cache_size (const unsigned int max_n_geometries);
+
+  /**
+   * Return the number of cell shapes currently stored in the cache enabled
+   * by set_geometry_cache_size().
+   */
+  unsigned int n_cached_geometries () const;
+
   /**
    * Return a reference to the copy of the quadrature formula stored by this
    * object.
@@ -3176,6 +3332,44 @@ private:
    * independent of the actual type of the cell iterator.
    */
   void do_reinit ();
+
+  /**
+   * The data stored for a cell shape by the cache enabled with
+   * set_geometry_cache_size(), together with the location of the first
+   * mapping support point of the cell the data was computed on.
+   */
+  struct CachedGeometry
+  {
+    Point<spacedim> first_support_point;
+    dealii::internal::FEValues::MappingRelatedData<dim,spacedim> mapping_output;
+    dealii::internal::FEValues::FiniteElementRelatedData<dim,spacedim> finite_element_output;
+  };
+
+  /**
+   * A hash function for the quantized relative locations of the mapping
+   * support points that address the cache.
+   */
+  struct GeometryKeyHash
+  {
+    std::size_t operator() (const std::vector<std::int64_t> &key) const;
+  };
+
+  /**
+   * The maximal number of cell shapes that are stored in the cache. Zero if
+   * the cache is disabled.
+   */
+  unsigned int max_n_cached_geometries;
+
+  /**
+   * The cache of computed data, addressed by the shape of the cell.
+   */
+  std::unordered_map<std::vector<std::int64_t>, CachedGeometry, GeometryKeyHash> geometry_cache;
+
+  /**
+   * Temporary storage for the key of the present cell, kept here to avoid
+   * allocating memory in every call to reinit().
+   */
+  std::vector<std::int64_t> geometry_key;
 };
 
 
@@ -4962,6 +5156,30 @@ FEValuesBase<dim,spacedim>::normal_vector (const unsigned int i) const
 
 
 
+template <int dim, int spacedim>
+template <typename Number, typename OutputNumber>
+inline
+bool
+FEValuesBase<dim,spacedim>::get_function_values_with_sum_factorization (const Number *,
+    OutputNumber *) const
+{
+  return false;
+}
+
+
+
+template <int dim, int spacedim>
+template <typename Number, typename OutputNumber>
+inline
+bool
+FEValuesBase<dim,spacedim>::get_function_gradients_with_sum_factorization (const Number *,
+    Tensor<1,spacedim,OutputNumber> *) const
+{
+  return false;
+}
+
+
+
 /*------------------------ Inline functions: FEValues ----------------------------*/
 
 
@@ -0,0 +1,375 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_fe_values_batch_h
+#define dealii_fe_values_batch_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/tensor.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_update_flags.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q_generic.h>
+#include <deal.II/grid/tria.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*!@addtogroup feaccess */
+/*@{*/
+
+
+/**
+ * A class that computes the same geometric data and shape function
+ * gradients as FEValues, but for a batch of VectorizedArray::n_array_elements
+ * cells at once. All data related to cells is stored in VectorizedArray
+ * objects where the $v$th component refers to the $v$th cell of the batch,
+ * so the Jacobians, their inverses, the JxW values, and the transformed
+ * shape function gradients are computed with the vector instructions of the
+ * processor, without the virtual function calls and the short loops of
+ * FEValues::reinit() for each cell. This is useful for matrix-based assembly
+ * where the evaluation of FEValues is a substantial part of the cost.
+ *
+ * The class supports the subset of FEValues that does not depend on the
+ * type of the finite element beyond the values and gradients on the
+ * reference cell:
+ * <ul>
+ * <li> The mapping must be a MappingQGeneric (or a class derived from it,
+ * like MappingQ1 or MappingQEulerian), whose support points on each cell are
+ * combined with the tensor product Lagrange polynomials of the mapping
+ * evaluated once on the reference cell.
+ * <li> The finite element must be primitive and its shape functions must be
+ * defined on the reference cell, i.e., shape values are unchanged by the
+ * mapping and the gradients transform with the inverse transpose of the
+ * Jacobian. This is the case for all elements derived from FE_Q_Base, FE_DGQ,
+ * FE_DGP, FE_Q_Hierarchical, and FE_System of those.
+ * <li> Only the update flags update_values, update_gradients,
+ * update_quadrature_points, update_jacobians, update_inverse_jacobians, and
+ * update_JxW_values are supported.
+ * </ul>
+ *
+ * A typical assembly loop looks as follows:
+ * @code
+ *   FEValuesBatch<dim> fe_values (mapping, fe, quadrature,
+ *                                 update_values | update_gradients |
+ *                                 update_JxW_values);
+ *   const unsigned int n_lanes = VectorizedArray<double>::n_array_elements;
+ *   std::vector<typename Triangulation<dim>::cell_iterator> cells;
+ *   for (auto cell=dof_handler.begin_active(); cell!=dof_handler.end(); )
+ *     {
+ *       cells.clear();
+ *       for ( ; cell!=dof_handler.end() && cells.size()<n_lanes; ++cell)
+ *         cells.push_back(cell);
+ *       fe_values.reinit (cells);
+ *
+ *       // compute the cell matrices of fe_values.n_filled_lanes() cells in
+ *       // VectorizedArray<double> using fe_values.shape_grad(i,q) and
+ *       // fe_values.JxW(q), then distribute the matrix of cell v by
+ *       // extracting component v of each entry
+ *     }
+ * @endcode
+ */
+template <int dim>
+class FEValuesBatch : public Subscriptor
+{
+public:
+  /**
+   * The number of cells that are processed at once.
+   */
+  static const unsigned int n_lanes = VectorizedArray<double>::n_array_elements;
+
+  /**
+   * Number of quadrature points.
+   */
+  const unsigned int n_quadrature_points;
+
+  /**
+   * Number of shape functions per cell.
+   */
+  const unsigned int dofs_per_cell;
+
+  /**
+   * Constructor. Precomputes the values and gradients of the shape
+   * functions of @p fe and of the polynomials of @p mapping at the points of
+   * @p quadrature on the reference cell. The update flags are extended by
+   * the flags needed to compute the requested quantities, e.g. gradients
+   * need the inverse Jacobians.
+   */
+  FEValuesBatch (const MappingQGeneric<dim> &mapping,
+                 const FiniteElement<dim>   &fe,
+                 const Quadrature<dim>      &quadrature,
+                 const UpdateFlags           update_flags);
+
+  /**
+   * Constructor. Uses a default (bi-, tri-)linear mapping like the
+   * respective constructor of FEValues.
+   */
+  FEValuesBatch (const FiniteElement<dim> &fe,
+                 const Quadrature<dim>    &quadrature,
+                 const UpdateFlags         update_flags);
+
+  /**
+   * Compute the requested quantities on the given @p cells, at most
+   * VectorizedArray::n_array_elements of them. If fewer cells are given, the
+   * remaining components of the vectorized data are computed on the first
+   * cell, so they are valid numbers, but should of course not be used.
+   */
+  void reinit (const ArrayView<const typename Triangulation<dim>::cell_iterator> &cells);
+
+  /**
+   * Same as above. Convenience function for a vector of cells.
+   */
+  void reinit (const std::vector<typename Triangulation<dim>::cell_iterator> &cells);
+
+  /**
+   * Return the number of cells passed to the last call of reinit(), i.e.,
+   * the number of components of the vectorized data that refer to actual
+   * cells.
+   */
+  unsigned int n_filled_lanes () const;
+
+  /**
+   * Value of shape function @p function_no at quadrature point @p
+   * point_no. As the shape functions are not affected by the mapping, the
+   * value is the same on all cells and returned as a scalar.
+   */
+  double shape_value (const unsigned int function_no,
+                      const unsigned int point_no) const;
+
+  /**
+   * Gradient of shape function @p function_no at quadrature point @p
+   * point_no on the cells of the batch.
+   */
+  const Tensor<1,dim,VectorizedArray<double> > &
+  shape_grad (const unsigned int function_no,
+              const unsigned int point_no) const;
+
+  /**
+   * Mapped quadrature weight, i.e., the determinant of the Jacobian times
+   * the weight of the quadrature point @p point_no, on the cells of the
+   * batch.
+   */
+  const VectorizedArray<double> &
+  JxW (const unsigned int point_no) const;
+
+  /**
+   * Jacobian of the transformation from the reference cell at quadrature
+   * point @p point_no, where the entry $(d,e)$ is the derivative of the
+   * real coordinate $d$ with respect to the reference coordinate $e$.
+   */
+  const Tensor<2,dim,VectorizedArray<double> > &
+  jacobian (const unsigned int point_no) const;
+
+  /**
+   * Inverse of the Jacobian at quadrature point @p point_no.
+   */
+  const Tensor<2,dim,VectorizedArray<double> > &
+  inverse_jacobian (const unsigned int point_no) const;
+
+  /**
+   * Location of quadrature point @p point_no on the cells of the batch.
+   */
+  const Point<dim,VectorizedArray<double> > &
+  quadrature_point (const unsigned int point_no) const;
+
+  /**
+   * Return a reference to the finite element.
+   */
+  const FiniteElement<dim> &get_fe () const;
+
+  /**
+   * Return a reference to the quadrature formula.
+   */
+  const Quadrature<dim> &get_quadrature () const;
+
+  /**
+   * Return the update flags, including the ones added in the constructor.
+   */
+  UpdateFlags get_update_flags () const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * The mapping.
+   */
+  SmartPointer<const MappingQGeneric<dim>,FEValuesBatch<dim> > mapping;
+
+  /**
+   * The finite element.
+   */
+  SmartPointer<const FiniteElement<dim>,FEValuesBatch<dim> > fe;
+
+  /**
+   * The quadrature formula.
+   */
+  const Quadrature<dim> quadrature;
+
+  /**
+   * The update flags, including the ones needed for computing the requested
+   * quantities.
+   */
+  const UpdateFlags update_flags;
+
+  /**
+   * The number of cells given to the last call of reinit().
+   */
+  unsigned int n_filled;
+
+  /**
+   * Values and gradients of the shape functions of the finite element on
+   * the reference cell, indexed by shape function and quadrature point.
+   */
+  Table<2,double>       unit_shape_values;
+  Table<2,Tensor<1,dim> > unit_shape_gradients;
+
+  /**
+   * Values and gradients of the polynomials of the mapping on the
+   * reference cell, indexed by quadrature point and mapping support point in
+   * the order of MappingQGeneric::compute_mapping_support_points().
+   */
+  Table<2,double>       mapping_values;
+  Table<2,Tensor<1,dim> > mapping_gradients;
+
+  /**
+   * The mapping support points of the cells in the batch.
+   */
+  AlignedVector<Point<dim,VectorizedArray<double> > > mapping_support_points;
+
+  /**
+   * The data on the cells of the batch.
+   */
+  AlignedVector<Point<dim,VectorizedArray<double> > >    quadrature_points;
+  AlignedVector<Tensor<2,dim,VectorizedArray<double> > > jacobians;
+  AlignedVector<Tensor<2,dim,VectorizedArray<double> > > inverse_jacobians;
+  AlignedVector<VectorizedArray<double> >                JxW_values;
+  Table<2,Tensor<1,dim,VectorizedArray<double> > >       shape_gradients;
+
+  /**
+   * Set up the data on the reference cell. Called from the constructors.
+   */
+  void initialize ();
+};
+
+/*@}*/
+
+
+/*------------------------ Inline functions: FEValuesBatch ------------------*/
+
+#ifndef DOXYGEN
+
+template <int dim>
+inline
+unsigned int
+FEValuesBatch<dim>::n_filled_lanes () const
+{
+  return n_filled;
+}
+
+
+
+template <int dim>
+inline
+double
+FEValuesBatch<dim>::shape_value (const unsigned int function_no,
+                                 const unsigned int point_no) const
+{
+  Assert (update_flags & update_values,
+          (typename FEValuesBase<dim>::ExcAccessToUninitializedField("update_values")));
+  return unit_shape_values(function_no, point_no);
+}
+
+
+
+template <int dim>
+inline
+const Tensor<1,dim,VectorizedArray<double> > &
+FEValuesBatch<dim>::shape_grad (const unsigned int function_no,
+                                const unsigned int point_no) const
+{
+  Assert (update_flags & update_gradients,
+          (typename FEValuesBase<dim>::ExcAccessToUninitializedField("update_gradients")));
+  return shape_gradients(function_no, point_no);
+}
+
+
+
+template <int dim>
+inline
+const VectorizedArray<double> &
+FEValuesBatch<dim>::JxW (const unsigned int point_no) const
+{
+  Assert (update_flags & update_JxW_values,
+          (typename FEValuesBase<dim>::ExcAccessToUninitializedField("update_JxW_values")));
+  AssertIndexRange (point_no, JxW_values.size());
+  return JxW_values[point_no];
+}
+
+
+
+template <int dim>
+inline
+const Tensor<2,dim,VectorizedArray<double> > &
+FEValuesBatch<dim>::jacobian (const unsigned int point_no) const
+{
+  Assert (update_flags & update_jacobians,
+          (typename FEValuesBase<dim>::ExcAccessToUninitializedField("update_jacobians")));
+  AssertIndexRange (point_no, jacobians.size());
+  return jacobians[point_no];
+}
+
+
+
+template <int dim>
+inline
+const Tensor<2,dim,VectorizedArray<double> > &
+FEValuesBatch<dim>::inverse_jacobian (const unsigned int point_no) const
+{
+  Assert (update_flags & update_inverse_jacobians,
+          (typename FEValuesBase<dim>::ExcAccessToUninitializedField("update_inverse_jacobians")));
+  AssertIndexRange (point_no, inverse_jacobians.size());
+  return inverse_jacobians[point_no];
+}
+
+
+
+template <int dim>
+inline
+const Point<dim,VectorizedArray<double> > &
+FEValuesBatch<dim>::quadrature_point (const unsigned int point_no) const
+{
+  Assert (update_flags & update_quadrature_points,
+          (typename FEValuesBase<dim>::ExcAccessToUninitializedField("update_quadrature_points")));
+  AssertIndexRange (point_no, quadrature_points.size());
+  return quadrature_points[point_no];
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -18,6 +18,7 @@
 
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/array_view.h>
 #include <deal.II/base/derivative_form.h>
 #include <deal.II/grid/tria.h>
 #include <deal.II/fe/fe_update_flags.h>
@@ -391,6 +392,30 @@ public:
   transform_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
                                const Point<spacedim>                                     &p) const = 0;
 
+  /**
+   * Map the points @p real_points on the real @p cell to the corresponding
+   * points on the unit cell and store them in @p unit_points, which must
+   * have the same size. This is equivalent to calling
+   * transform_real_to_unit_cell() for each point, but allows derived classes
+   * to share the work between the points, e.g., to compute the shape of the
+   * cell only once and to run the iterations for several points at once.
+   *
+   * Instead of throwing an exception of type Mapping::ExcTransformationFailed,
+   * this function sets the first coordinate of the respective entry of
+   * @p unit_points to <tt>std::numeric_limits<double>::infinity()</tt> if the
+   * transformation of a point fails, so that the results of all other points
+   * are still available. Such a point is certainly not inside the unit cell
+   * as tested by GeometryInfo::is_inside_unit_cell().
+   *
+   * The default implementation calls transform_real_to_unit_cell() for each
+   * point.
+   */
+  virtual
+  void
+  transform_points_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                      const ArrayView<const Point<spacedim> >                   &real_points,
+                                      const ArrayView<Point<dim> >                              &unit_points) const;
+
   /**
    * Transforms the point @p p on the real @p cell to the corresponding point
    * on the unit cell, and then projects it to a dim-1  point on the face with
@@ -167,6 +167,38 @@ public:
   virtual
   bool preserves_vertex_locations () const;
 
+  /**
+   * Return the locations of support points for the mapping. For example, for
+   * $Q_1$ mappings these are the vertices, and for higher order polynomial
+   * mappings they are the vertices plus interior points on edges, faces, and
+   * the cell interior that are placed in consultation with the Manifold
+   * description of the domain and its boundary. However, other classes may
+   * override this function differently. In particular, the MappingQ1Eulerian
+   * class does exactly this by not computing the support points from the
+   * geometry of the current cell but instead evaluating an externally given
+   * displacement field in addition to the geometry of the cell.
+   *
+   * The default implementation of this function is appropriate for most
+   * cases. It takes the locations of support points on the boundary of the
+   * cell from the underlying manifold. Interior support points (ie. support
+   * points in quads for 2d, in hexes for 3d) are then computed using the
+   * solution of a Laplace equation with the position of the outer support
+   * points as boundary values, in order to make the transformation as smooth
+   * as possible.
+   *
+   * The function works its way from the vertices (which it takes from the
+   * given cell) via the support points on the line (for which it calls the
+   * add_line_support_points() function) and the support points on the quad
+   * faces (in 3d, for which it calls the add_quad_support_points() function).
+   * It then adds interior support points that are either computed by
+   * interpolation from the surrounding points using weights computed by
+   * solving a Laplace equation, or if dim<spacedim, it asks the underlying
+   * manifold for the locations of interior points.
+   */
+  virtual
+  std::vector<Point<spacedim> >
+  compute_mapping_support_points (const typename Triangulation<dim,spacedim>::cell_iterator &cell) const;
+
   /**
    * @name Mapping points between reference and real cells
    * @{
@@ -184,6 +216,25 @@ public:
   transform_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
                                const Point<spacedim>                            &p) const;
 
+  /**
+   * Map the points @p real_points on the real @p cell to the unit cell, see
+   * Mapping::transform_points_real_to_unit_cell().
+   *
+   * For dim==spacedim and mappings that use the vertices of the cells, the
+   * support points of the cell are computed only once for all points, and
+   * the Newton iteration of transform_real_to_unit_cell() runs for
+   * VectorizedArray::n_array_elements points at once, evaluating the
+   * tensor product shape functions directly at the vectorized points. Points
+   * for which this iteration does not converge, e.g. points far outside the
+   * cell, are passed to transform_real_to_unit_cell(), which additionally
+   * uses a line search. Otherwise, the function of the base class is used.
+   */
+  virtual
+  void
+  transform_points_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                      const ArrayView<const Point<spacedim> >                   &real_points,
+                                      const ArrayView<Point<dim> >                              &unit_points) const;
+
   /**
    * @}
    */
@@ -450,6 +501,13 @@ public:
      */
     QGaussLobatto<1> line_support_points;
 
+  /**
+   * The index in the vector returned by compute_mapping_support_points() of
+   * each support point, when the support points are enumerated in
+   * lexicographic order of the tensor product of the line_support_points.
+   */
+  const std::vector<unsigned int> renumber_lexicographic_to_hierarchic;
+
     /**
       * In case the quadrature rule given represents a tensor product
       * we need to store the evaluations of the 1d polynomials at the
@@ -608,6 +666,13 @@ protected:
    */
   QGaussLobatto<1> line_support_points;
 
+  /**
+   * The index in the vector returned by compute_mapping_support_points() of
+   * each support point, when the support points are enumerated in
+   * lexicographic order of the tensor product of the line_support_points.
+   */
+  const std::vector<unsigned int> renumber_lexicographic_to_hierarchic;
+
   /**
    * An FE_Q object which is only needed in 3D, since it knows how to reorder
    * shape functions/DoFs on non-standard faces. This is used to reorder
@@ -650,38 +715,6 @@ protected:
    */
   Table<2,double> support_point_weights_cell;
 
-  /**
-   * Return the locations of support points for the mapping. For example, for
-   * $Q_1$ mappings these are the vertices, and for higher order polynomial
-   * mappings they are the vertices plus interior points on edges, faces, and
-   * the cell interior that are placed in consultation with the Manifold
-   * description of the domain and its boundary. However, other classes may
-   * override this function differently. In particular, the MappingQ1Eulerian
-   * class does exactly this by not computing the support points from the
-   * geometry of the current cell but instead evaluating an externally given
-   * displacement field in addition to the geometry of the cell.
-   *
-   * The default implementation of this function is appropriate for most
-   * cases. It takes the locations of support points on the boundary of the
-   * cell from the underlying manifold. Interior support points (ie. support
-   * points in quads for 2d, in hexes for 3d) are then computed using the
-   * solution of a Laplace equation with the position of the outer support
-   * points as boundary values, in order to make the transformation as smooth
-   * as possible.
-   *
-   * The function works its way from the vertices (which it takes from the
-   * given cell) via the support points on the line (for which it calls the
-   * add_line_support_points() function) and the support points on the quad
-   * faces (in 3d, for which it calls the add_quad_support_points() function).
-   * It then adds interior support points that are either computed by
-   * interpolation from the surrounding points using weights computed by
-   * solving a Laplace equation, or if dim<spacedim, it asks the underlying
-   * manifold for the locations of interior points.
-   */
-  virtual
-  std::vector<Point<spacedim> >
-  compute_mapping_support_points (const typename Triangulation<dim,spacedim>::cell_iterator &cell) const;
-
   /**
    * Transforms the point @p p on the real cell to the corresponding point on
    * the unit cell @p cell by a Newton iteration.
@@ -20,6 +20,7 @@
 #include <deal.II/base/exceptions.h>
 
 #include <array>
+#include <functional>
 #include <vector>
 #include <iostream>
 
@@ -118,7 +119,10 @@ public:
   binary_type to_binary() const;
 
   /**
-   * Return a cell_iterator to the cell represented by this CellId.
+   * Return a cell_iterator to the cell represented by this CellId. The
+   * function descends from the coarse cell through the child indices
+   * stored in this object, at a cost proportional to the number of levels,
+   * and only constructs the iterator for the final cell.
    */
   template <int dim, int spacedim>
   typename Triangulation<dim,spacedim>::cell_iterator
@@ -141,6 +145,15 @@ public:
    */
   bool operator<(const CellId &other) const;
 
+  /**
+   * Return a hash value of this CellId that is consistent with
+   * operator==(). This function allows to use CellId objects as keys of
+   * unordered containers such as <code>std::unordered_map</code>, for which
+   * the specialization of <code>std::hash</code> for CellId below calls this
+   * function.
+   */
+  std::size_t hash() const;
+
 private:
   /**
    * The number of the coarse cell within whose tree the cell
@@ -245,6 +258,28 @@ CellId::operator== (const CellId &other) const
 
 
 
+inline std::size_t
+CellId::hash() const
+{
+  // combine the coarse cell id and the child indices with the FNV-1a
+  // algorithm
+  std::size_t result = 14695981039346656037ULL;
+  const auto combine = [&result](const std::size_t value)
+  {
+    result ^= value;
+    result *= 1099511628211ULL;
+  };
+
+  combine (coarse_cell_id);
+  combine (n_child_indices);
+  for (unsigned int i=0; i<n_child_indices; ++i)
+    combine (static_cast<unsigned char>(child_indices[i]));
+
+  return result;
+}
+
+
+
 inline bool
 CellId::operator!= (const CellId &other) const
 {
@@ -278,4 +313,22 @@ bool CellId::operator<(const CellId &other) const
 
 DEAL_II_NAMESPACE_CLOSE
 
+
+namespace std
+{
+  /**
+   * Specialization of <code>std::hash</code> for CellId, so that CellId
+   * objects can be used as keys of <code>std::unordered_map</code> and
+   * <code>std::unordered_set</code>.
+   */
+  template <>
+  struct hash<dealii::CellId>
+  {
+    std::size_t operator() (const dealii::CellId &cell_id) const
+    {
+      return cell_id.hash();
+    }
+  };
+}
+
 #endif
@@ -19,6 +19,7 @@
 
 #include <deal.II/base/config.h>
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
 #include <deal.II/base/smartpointer.h>
 #include <deal.II/base/point.h>
 #include <iostream>
@@ -354,6 +355,23 @@ public:
    */
   void read (const std::string &in, Format format=Default);
 
+  /**
+   * Same as the previous function, but for use in parallel computations in
+   * which all processes in @p mpi_communicator read the same mesh, e.g., the
+   * coarse mesh of a parallel::distributed::Triangulation. Only the process
+   * with rank zero searches and reads the file, and sends its contents to
+   * all other processes, which then parse them from memory. This avoids that
+   * thousands of processes access the same file at the same time, which puts
+   * a heavy load on the metadata servers of parallel file systems.
+   *
+   * The formats netcdf and assimp can only be read from a file. For them,
+   * all processes read the file as in the previous function. This is also
+   * the case if deal.II is configured without MPI.
+   */
+  void read_and_broadcast (const std::string &filename,
+                           const MPI_Comm    &mpi_communicator,
+                           Format             format=Default);
+
   /**
    * Read grid data from an vtk file. Numerical data is ignored.
    *
@@ -438,6 +456,11 @@ public:
    * file format. The GMSH formats are documented at
    * http://www.geuz.org/gmsh/.
    *
+   * Both the ASCII and the binary variant of version 2 can be read. Binary
+   * files must have been written on a machine with the same byte order, and
+   * the stream should be opened in binary mode on systems that distinguish
+   * between text and binary files.
+   *
    * @note The input function of deal.II does not distinguish between newline
    * and other whitespace. Therefore, deal.II will be able to read files in a
    * slightly more general format than Gmsh.
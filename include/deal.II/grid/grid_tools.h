@@ -47,6 +47,7 @@ DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
 DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
 
 #include <bitset>
+#include <cstdint>
 #include <list>
 #include <set>
 
@@ -281,6 +282,60 @@ namespace GridTools
                                    std::vector<unsigned int>   &considered_vertices,
                                    const double                 tol=1e-12);
 
+  /**
+   * The space filling curves that the functions
+   * compute_space_filling_curve_indices(),
+   * reorder_cells_along_space_filling_curve(), and
+   * DoFRenumbering::space_filling_curve() can order points and cells by.
+   */
+  enum SpaceFillingCurve
+  {
+    /**
+     * The Morton curve, or Z-order curve, which interleaves the bits of the
+     * coordinates. It is the order of the cells of a
+     * parallel::distributed::Triangulation within each coarse cell.
+     */
+    morton_curve,
+    /**
+     * The Hilbert curve, which, unlike the Morton curve, only connects points
+     * that are neighbors, and therefore keeps points close to each other even
+     * better together.
+     */
+    hilbert_curve
+  };
+
+  /**
+   * Return for each of the @p points its index along the given space
+   * filling @p curve through the bounding box of all points, i.e., sorting
+   * the points by these indices orders them along the curve. This is the
+   * basis for orderings of cells and degrees of freedom that keep the data
+   * of nearby cells close to each other in memory.
+   *
+   * The bounding box is divided into $2^{64/\text{spacedim}}$ intervals in
+   * each coordinate direction (but at most $2^{52}$), and points in the same
+   * subdivision of the box get the same index.
+   */
+  template <int spacedim>
+  std::vector<std::uint64_t>
+  compute_space_filling_curve_indices (const std::vector<Point<spacedim> > &points,
+                                       const SpaceFillingCurve              curve = hilbert_curve);
+
+  /**
+   * Sort the @p cells given by the indices of their @p vertices along a
+   * space filling @p curve through their centers. Calling this function
+   * before Triangulation::create_triangulation() on meshes read from files,
+   * whose cells are often numbered in no particular order, makes sure that
+   * the coarse cells, and thus the cell iterators and all data ordered by
+   * cells, traverse the mesh in an order that keeps nearby cells together.
+   * This improves the cache locality of loops over cells, and yields
+   * compact partitions if the cells are partitioned by their order, as
+   * done by parallel::distributed::Triangulation.
+   */
+  template <int dim, int spacedim>
+  void reorder_cells_along_space_filling_curve (const std::vector<Point<spacedim> > &vertices,
+                                                std::vector<CellData<dim> >         &cells,
+                                                const SpaceFillingCurve              curve = hilbert_curve);
+
   /*@}*/
   /**
    * @name Rotating, stretching and otherwise transforming meshes
@@ -658,6 +713,50 @@ namespace GridTools
       compute_point_locations(const Cache<dim,spacedim>                                         &cache,
                               const std::vector<Point<spacedim> >                               &points);
 
+  /**
+   * A version of compute_point_locations() for a triangulation that is
+   * distributed over several processes, where each process passes its own
+   * list of @p local_points, which may lie anywhere in the domain.
+   *
+   * Each point is sent to the processes returned by
+   * Cache::get_point_owner_candidates(), i.e., the processes with a bounding
+   * box of their locally owned cells that contains the point, in a single
+   * exchange of messages between the processes involved. Each of these
+   * processes locates the point among its locally owned and ghost cells. The
+   * point is assigned to the locally owned cell with the lowest subdomain id
+   * among all cells containing it, so that a point on the interface between
+   * processes is located by exactly one of them. The processes then return
+   * to the sender which points they have located.
+   *
+   * @param[in] cache The triangulation's GridTools::Cache .
+   * @param[in] local_points The points of the current process.
+   *
+   * @param[out] Tuple containing the following information:
+   *  - The locally owned cells that contain at least one of the points of
+   *   any process.
+   *  - A vector of vectors of points, containing the reference positions of
+   *   the points in these cells, like the second entry of the result of
+   *   compute_point_locations().
+   *  - A vector of vectors of pairs, containing for each of these points the
+   *   rank of the process that passed it and its index in the
+   *   @p local_points of that process.
+   *  - A vector with the rank of the process that located each of the
+   *   @p local_points of the current process, or numbers::invalid_unsigned_int
+   *   for points outside the triangulation.
+   *
+   * This function is a collective operation on the communicator of the
+   * triangulation, if the triangulation is derived from
+   * parallel::Triangulation.
+   */
+  template <int dim, int spacedim>
+  std::tuple<
+  std::vector<typename Triangulation<dim, spacedim>::active_cell_iterator >,
+      std::vector< std::vector< Point<dim> > >,
+      std::vector< std::vector< std::pair<unsigned int,unsigned int> > >,
+      std::vector<unsigned int> >
+      distributed_compute_point_locations(const Cache<dim,spacedim>           &cache,
+                                          const std::vector<Point<spacedim> > &local_points);
+
   /**
    * Return a map of index:Point<spacedim>, containing the used vertices of the
    * given `container`. The key of the returned map is the global index in the
@@ -988,6 +1087,14 @@ namespace GridTools
    * A version of the previous function that exploits an already existing
    * GridTools::Cache<dim,spacedim> object.
    *
+   * Unless @p marked_vertices are given, the function first tests
+   * @p cell_hint and then only the cells returned by
+   * Cache::get_cell_candidates(), i.e., the cells whose bounding box contains
+   * the point, so the cost of a search does not grow with the size of the
+   * mesh. Only if the mapping is not a MappingQGeneric and none of these
+   * cells contains the point, the search around vertices of the previous
+   * function is used.
+   *
    * @author Luca Heltai, 2017
    */
   template <int dim, int spacedim>
@@ -1503,6 +1610,37 @@ namespace GridTools
                            const SparsityPattern &cell_connection_graph,
                            Triangulation<dim,spacedim>    &triangulation);
 
+  /**
+   * This function does the same as the first of the previous functions, but
+   * weighs each active cell with the entry of @p cell_weights that
+   * corresponds to its active cell index, so that METIS balances the sum of
+   * the weights of the cells in each subdomain rather than their number.
+   * This is useful if the computational cost differs between cells, for
+   * example because of different polynomial degrees or material models. The
+   * vector @p cell_weights needs to be either empty, which is equivalent to
+   * all cells having the same weight, or have one positive entry per active
+   * cell.
+   */
+  template <int dim, int spacedim>
+  void
+  partition_triangulation (const unsigned int               n_partitions,
+                           const std::vector<unsigned int> &cell_weights,
+                           Triangulation<dim,spacedim>     &triangulation);
+
+  /**
+   * This function does the same as the second of the previous functions,
+   * i.e., it partitions the cells based on the connectivity graph
+   * @p cell_connection_graph, but weighs each active cell with the
+   * corresponding entry of @p cell_weights as described for the previous
+   * function.
+   */
+  template <int dim, int spacedim>
+  void
+  partition_triangulation (const unsigned int               n_partitions,
+                           const std::vector<unsigned int> &cell_weights,
+                           const SparsityPattern           &cell_connection_graph,
+                           Triangulation<dim,spacedim>     &triangulation);
+
   /**
    * Generates a partitioning of the active cells making up the entire domain
    * using the same partitioning scheme as in the p4est library. After calling
@@ -3220,7 +3358,7 @@ namespace GridTools
         // pack all the data into the buffer for this recipient and send it.
         // keep data around till we can make sure that the packet has been
         // received
-        sendbuffers[idx] = Utilities::pack(data);
+        sendbuffers[idx] = Utilities::pack(data, Utilities::no_compression);
         const int ierr = MPI_Isend(sendbuffers[idx].data(), sendbuffers[idx].size(),
                                    MPI_BYTE, *it,
                                    786, tria->get_communicator(), &requests[idx]);
@@ -3245,7 +3383,7 @@ namespace GridTools
                         tria->get_communicator(), &status);
         AssertThrowMPI(ierr);
 
-        auto cellinfo = Utilities::unpack<CellDataTransferBuffer<dim, DataType> >(receive);
+        auto cellinfo = Utilities::unpack<CellDataTransferBuffer<dim, DataType> >(receive, Utilities::no_compression);
 
         DataType *data = cellinfo.data.data();
         for (unsigned int c=0; c<cellinfo.cell_ids.size(); ++c, ++data)
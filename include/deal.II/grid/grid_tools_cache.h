@@ -21,6 +21,7 @@
 #include <deal.II/base/subscriptor.h>
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/point.h>
+#include <deal.II/base/bounding_box.h>
 
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_iterator.h>
@@ -32,6 +33,7 @@
 
 #include <boost/signals2.hpp>
 
+#include <array>
 #include <cmath>
 
 DEAL_II_NAMESPACE_OPEN
@@ -50,8 +52,14 @@ namespace GridTools
    * for faster access whenever the triangulation has not changed.
    *
    * Notice that this class only notices if the underlying Triangulation has
-   * changed due to a Triangulation::Signals::any_change() signal being
-   * triggered.
+   * changed due to one of the signals collected by
+   * Triangulation::Signals::any_change() being triggered. Not all of them
+   * invalidate all cached objects: A movement of the mesh leaves the vertex
+   * to cell map intact, and for meshes of dimension one and two the vertex to
+   * cell map is updated after a refinement by only recomputing the entries
+   * of the vertices of the cells that were refined or coarsened, which the
+   * cache collects through the Triangulation::Signals::post_refinement_on_cell
+   * and Triangulation::Signals::pre_coarsening_on_cell signals.
    *
    * If the triangulation changes for other reasons, for example because you
    * use it in conjunction with a MappingQEulerian object that sees the
@@ -126,6 +134,91 @@ namespace GridTools
      */
     const Mapping<dim,spacedim> &get_mapping() const;
 
+    /**
+     * Return the cached map of the vertices of the locally owned and ghost
+     * cells, i.e., of all active cells that are not artificial, with their
+     * locations as given by the mapping. For a serial triangulation, this is
+     * the same as get_used_vertices(). The result can be passed to
+     * GridTools::find_closest_vertex() to only search among the vertices that
+     * are actually available on the current process.
+     */
+    const std::map<unsigned int, Point<spacedim> >
+    &get_locally_relevant_vertices() const;
+
+    /**
+     * Return the cached bounding boxes of the locally owned cells of all
+     * processes, as computed by GridTools::compute_mesh_predicate_bounding_box()
+     * on each process and collected by
+     * GridTools::exchange_local_bounding_boxes(). The boxes are computed on
+     * the finest level of the triangulation that has at most a few hundred
+     * cells and are merged where possible. For a triangulation that is not
+     * derived from parallel::Triangulation, there is only one process.
+     *
+     * If the cached boxes are outdated, this function is a collective
+     * operation on the communicator of the triangulation, i.e., it must be
+     * called on all processes at the same time.
+     */
+    const std::vector<std::vector<BoundingBox<spacedim> > >
+    &get_global_bounding_boxes() const;
+
+    /**
+     * Return the ranks of all processes with a bounding box returned by
+     * get_global_bounding_boxes() that contains the point @p p, in ascending
+     * order. The point is owned by one of these processes, if it lies inside
+     * the triangulation at all.
+     *
+     * Rather than testing the boxes of all processes, as
+     * GridTools::guess_point_owner() does, the boxes are sorted into a
+     * uniform grid of bins covering all of them, so that only the processes
+     * with a box touching the bin of @p p are tested, and the cost of a query
+     * does not grow with the number of processes for meshes that are evenly
+     * distributed.
+     *
+     * Like get_global_bounding_boxes(), this function is a collective
+     * operation if the cached boxes are outdated.
+     */
+    std::vector<unsigned int>
+    get_point_owner_candidates(const Point<spacedim> &p) const;
+
+    /**
+     * Return the cached bounding boxes of all active cells, indexed by
+     * CellAccessor::active_cell_index(). The boxes contain the vertices of
+     * the cells as given by Mapping::get_vertices() for the stored mapping,
+     * i.e., they contain the whole cell for straight-sided cells, but not
+     * necessarily for cells that are curved by a higher order mapping.
+     *
+     * If the stored mapping is a MappingQGeneric of degree higher than one,
+     * the boxes are computed from the mapping support points of the cells
+     * instead and extended by a tenth of their size in each direction, such
+     * that they contain the curved cells also.
+     *
+     * These boxes are a cheap test whether a point can lie in a cell before
+     * an expensive call to Mapping::transform_real_to_unit_cell().
+     */
+    const std::vector<BoundingBox<spacedim> >
+    &get_cell_bounding_boxes() const;
+
+    /**
+     * Return all active cells with a bounding box returned by
+     * get_cell_bounding_boxes() that contains the point @p p, ordered by
+     * their active cell index. The point lies in one of these cells, if it
+     * lies inside the triangulation at all.
+     *
+     * Like get_point_owner_candidates(), the boxes are sorted into a uniform
+     * grid of about as many bins as there are active cells, such that only
+     * the cells with a box touching the bin of @p p are tested.
+     */
+    std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator>
+    get_cell_candidates(const Point<spacedim> &p) const;
+
+    /**
+     * Return the cached map from each vertex to the subdomain ids of the
+     * ghost cells that contain the vertex. The entries of vertices that are
+     * not part of a ghost cell are empty.
+     */
+    const std::vector<std::set<unsigned int> >
+    &get_vertex_to_neighbor_subdomain() const;
+
 #ifdef DEAL_II_WITH_NANOFLANN
     /**
      * Return the cached vertex_kdtree object, constructed with the vertices of
@@ -135,6 +228,21 @@ namespace GridTools
 #endif
 
   private:
+    /**
+     * Recompute the entries of the vertex to cell map belonging to the
+     * vertices collected in changed_vertices, considering the cells
+     * collected in new_active_cells as well as the cells stored in these
+     * entries before.
+     */
+    void update_changed_vertices() const;
+
+    /**
+     * Record the vertices of the children of @p cell, and the cells that
+     * become active, when @p cell is refined or its children are coarsened.
+     */
+    void record_changed_cell(const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                             const bool refined);
+
     /**
      * Keep track of what needs to be updated next.
      */
@@ -173,6 +281,19 @@ namespace GridTools
     mutable KDTree<spacedim> vertex_kdtree;
 #endif
 
+    /**
+     * The vertices whose entries in vertex_to_cells have changed since it
+     * was computed, by refinement or coarsening. The indices may be
+     * repeated.
+     */
+    mutable std::vector<unsigned int> changed_vertices;
+
+    /**
+     * The cells that have become active since vertex_to_cells was computed.
+     * Some of them might not be active, or even exist, any more.
+     */
+    mutable std::vector<typename Triangulation<dim,spacedim>::cell_iterator> new_active_cells;
+
     /**
      * Store the used vertices of the Triangulation, as generated by
      * GridTools::extract_used_vertices().
@@ -180,9 +301,69 @@ namespace GridTools
     mutable std::map<unsigned int, Point<spacedim>> used_vertices;
 
     /**
-     * Storage for the status of the triangulation signal.
+     * Store the vertices of the locally owned and ghost cells.
+     */
+    mutable std::map<unsigned int, Point<spacedim>> locally_relevant_vertices;
+
+    /**
+     * Store the bounding boxes of the locally owned cells of all processes.
+     */
+    mutable std::vector<std::vector<BoundingBox<spacedim> > > global_bounding_boxes;
+
+    /**
+     * The box containing all boxes in global_bounding_boxes, which is
+     * divided into the bins of the point owner index.
+     */
+    mutable BoundingBox<spacedim> covering_box;
+
+    /**
+     * The number of bins of the point owner index in each coordinate
+     * direction.
+     */
+    mutable std::array<unsigned int,spacedim> n_bins;
+
+    /**
+     * For each bin of the point owner index, the ranks of the processes with
+     * a bounding box that touches the bin, in ascending order.
+     */
+    mutable std::vector<std::vector<unsigned int> > bin_ranks;
+
+    /**
+     * Store the bounding boxes of the active cells.
+     */
+    mutable std::vector<BoundingBox<spacedim> > cell_bounding_boxes;
+
+    /**
+     * The active cells, indexed by their active cell index.
+     */
+    mutable std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> active_cells;
+
+    /**
+     * The box containing all boxes in cell_bounding_boxes, which is divided
+     * into the bins of the cell index.
+     */
+    mutable BoundingBox<spacedim> cell_covering_box;
+
+    /**
+     * The number of bins of the cell index in each coordinate direction.
+     */
+    mutable std::array<unsigned int,spacedim> cell_n_bins;
+
+    /**
+     * For each bin of the cell index, the active cell indices of the cells
+     * with a bounding box that touches the bin, in ascending order.
+     */
+    mutable std::vector<std::vector<unsigned int> > bin_cells;
+
+    /**
+     * Store the subdomain ids of the ghost cells around each vertex.
+     */
+    mutable std::vector<std::set<unsigned int> > vertex_to_neighbor_subdomain;
+
+    /**
+     * Storage for the status of the triangulation signals.
      */
-    boost::signals2::connection tria_signal;
+    std::vector<boost::signals2::connection> tria_signals;
   };
 
 
@@ -61,10 +61,37 @@ namespace GridTools
      */
     update_used_vertices = 0x08,
 
+    /**
+     * Update a mapping of the vertices of the locally owned and ghost cells.
+     */
+    update_locally_relevant_vertices = 0x10,
+
+    /**
+     * Update the bounding boxes of the locally owned cells of all processes,
+     * and the index built on them to find the processes that might own a
+     * point.
+     */
+    update_global_bounding_boxes = 0x20,
+
+    /**
+     * Update the bounding boxes of the vertices of all active cells.
+     */
+    update_cell_bounding_boxes = 0x40,
+
+    /**
+     * Update the subdomain ids of the ghost cells around each vertex.
+     */
+    update_vertex_to_neighbor_subdomain = 0x80,
+
+    /**
+     * Update the index of the cells by the bins their bounding boxes touch.
+     */
+    update_cell_bounding_box_index = 0x100,
+
     /**
      * Update all objects.
      */
-    update_all = 0xFF,
+    update_all = 0x1FF,
   };
 
 
@@ -84,6 +111,12 @@ namespace GridTools
 #ifdef DEAL_II_WITH_NANOFLANN
     if (u & update_vertex_kdtree)                      s << "|vertex_kdtree";
 #endif
+    if (u & update_used_vertices)                      s << "|used_vertices";
+    if (u & update_locally_relevant_vertices)          s << "|locally_relevant_vertices";
+    if (u & update_global_bounding_boxes)              s << "|global_bounding_boxes";
+    if (u & update_cell_bounding_boxes)                s << "|cell_bounding_boxes";
+    if (u & update_vertex_to_neighbor_subdomain)       s << "|vertex_to_neighbor_subdomain";
+    if (u & update_cell_bounding_box_index)            s << "|cell_bounding_box_index";
     return s;
   }
 
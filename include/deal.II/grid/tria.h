@@ -2215,8 +2215,10 @@ public:
     /**
      * This signal is triggered for each cell during every automatic or manual
      * repartitioning. This signal is somewhat special in that it is only
-     * triggered for distributed parallel calculations and only if functions
-     * are connected to it. It is intended to allow a weighted repartitioning
+     * triggered for parallel calculations, i.e., by
+     * parallel::distributed::Triangulation and by
+     * parallel::shared::Triangulation when partitioning with METIS, and only
+     * if functions are connected to it. It is intended to allow a weighted repartitioning
      * of the domain to balance the computational load across processes in a
      * different way than balancing the number of cells. Any connected
      * function is expected to take an iterator to a cell, and a CellStatus
@@ -2642,6 +2644,36 @@ public:
    */
   active_cell_iterator last_active () const;
 
+  /**
+   * Return an iterator to the active cell whose
+   * @ref GlossActiveCellIndex "active cell index" is @p active_cell_index.
+   *
+   * In contrast to incrementing an active_cell_iterator, which needs to skip
+   * all inactive cells, this function looks up the level and index of the
+   * cell in an array that is built whenever the active cell indices are
+   * set, i.e., after creation, refinement and coarsening, and
+   * deserialization of the mesh. It thus takes constant time and allows to
+   * split a loop over all active cells into independent ranges of active
+   * cell indices, for example with parallel::apply_to_subranges():
+   * @code
+   *   parallel::apply_to_subranges
+   *     (0U, triangulation.n_active_cells(),
+   *      [&](const unsigned int begin, const unsigned int end)
+   *      {
+   *        for (unsigned int i=begin; i<end; ++i)
+   *          {
+   *            const auto cell = triangulation.active_cell_with_index (i);
+   *            ...
+   *          }
+   *      },
+   *      64);
+   * @endcode
+   *
+   * @pre @p active_cell_index must be less than n_active_cells().
+   */
+  active_cell_iterator
+  active_cell_with_index (const unsigned int active_cell_index) const;
+
   /**
    * @name Cell iterator functions returning ranges of iterators
    */
@@ -3483,8 +3515,9 @@ private:
   /**
    * For all cells, set the active cell indices so that active cells know the
    * how many-th active cell they are, and all other cells have an invalid
-   * value. This function is called after mesh creation, refinement, and
-   * serialization.
+   * value. The level and index of each active cell are also stored in
+   * active_cell_levels_and_indices. This function is called after mesh
+   * creation, refinement, and serialization.
    */
   void reset_active_cell_indices ();
 
@@ -3571,6 +3604,13 @@ private:
    */
   dealii::internal::Triangulation::NumberCache<dim> number_cache;
 
+  /**
+   * The level and the index within the level of each active cell, indexed
+   * by the active cell index. This array is filled by
+   * reset_active_cell_indices() and used by active_cell_with_index().
+   */
+  std::vector<std::pair<unsigned int, unsigned int> > active_cell_levels_and_indices;
+
   /**
    * A map that relates the number of a boundary vertex to the boundary
    * indicator. This field is only used in 1d. We have this field because we
@@ -1799,7 +1799,8 @@ template <int structdim, int dim, int spacedim>
 void *TriaAccessor<structdim,dim,spacedim>::user_pointer () const
 {
   Assert (this->used(), TriaAccessorExceptions::ExcCellNotUsed());
-  return this->objects().user_pointer(this->present_index);
+  const auto &tria_objects = this->objects();
+  return const_cast<void *>(tria_objects.user_pointer(this->present_index));
 }
 
 
@@ -1852,7 +1853,8 @@ template <int structdim, int dim, int spacedim>
 unsigned int TriaAccessor<structdim,dim,spacedim>::user_index () const
 {
   Assert (this->used(), TriaAccessorExceptions::ExcCellNotUsed());
-  return this->objects().user_index(this->present_index);
+  const auto &tria_objects = this->objects();
+  return tria_objects.user_index(this->present_index);
 }
 
 
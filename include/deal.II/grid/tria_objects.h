@@ -19,6 +19,7 @@
 #include <deal.II/base/config.h>
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/geometry_info.h>
+#include <deal.II/base/thread_management.h>
 #include <deal.II/grid/tria_object.h>
 
 #include <vector>
@@ -245,27 +246,34 @@ namespace internal
 
 
       /**
-       * Access to user pointers.
+       * Access to user pointers. The first call to this function or to the
+       * non-const user_index() function allocates the memory for the user
+       * data of all objects, see the documentation of #user_data.
        */
       void  *&user_pointer(const unsigned int i);
 
       /**
-       * Read-only access to user pointers.
+       * Read-only access to user pointers. If no user data has been set so
+       * far, this function returns a null pointer.
        */
       const void *user_pointer(const unsigned int i) const;
 
       /**
-       * Access to user indices.
+       * Access to user indices. The first call to this function or to the
+       * non-const user_pointer() function allocates the memory for the user
+       * data of all objects, see the documentation of #user_data.
        */
       unsigned int &user_index(const unsigned int i);
 
       /**
-       * Read-only access to user pointers.
+       * Read-only access to user indices. If no user data has been set so
+       * far, this function returns zero.
        */
       unsigned int user_index(const unsigned int i) const;
 
       /**
-       * Reset user data to zero.
+       * Reset user data to zero. This function does not allocate the user
+       * data if it has not been set so far.
        */
       void clear_user_data(const unsigned int i);
 
@@ -399,9 +407,29 @@ namespace internal
       /**
        * Pointer which is not used by the library but may be accessed and set
        * by the user to handle data local to a line/quad/etc.
+       *
+       * Most programs never use the user data, and for large meshes one
+       * pointer per object is a sizable part of the memory of a
+       * triangulation. This vector is therefore left empty until the user
+       * data of one of the objects is set for the first time, at which point
+       * it is resized to the number of objects and then kept at that size by
+       * reserve_space(). An empty vector is equivalent to all user data being
+       * zero.
        */
       std::vector<UserData> user_data;
 
+      /**
+       * A mutex that guards the allocation of #user_data, so that the user
+       * data of different objects can be set concurrently from several
+       * threads.
+       */
+      mutable Threads::Mutex user_data_mutex;
+
+      /**
+       * Make sure that #user_data has one entry per object.
+       */
+      void allocate_user_data ();
+
       /**
        * In order to avoid confusion between user pointers and indices, this
        * enum is set by the first function accessing either and subsequent
@@ -622,6 +650,7 @@ namespace internal
              ExcPointerIndexClash());
       user_data_type = data_pointer;
 
+      allocate_user_data ();
       Assert(i<user_data.size(), ExcIndexRange(i,0,user_data.size()));
       return user_data[i].p;
     }
@@ -636,7 +665,9 @@ namespace internal
              ExcPointerIndexClash());
       user_data_type = data_pointer;
 
-      Assert(i<user_data.size(), ExcIndexRange(i,0,user_data.size()));
+      Assert(i<cells.size(), ExcIndexRange(i,0,cells.size()));
+      if (user_data.empty())
+        return nullptr;
       return user_data[i].p;
     }
 
@@ -650,6 +681,7 @@ namespace internal
              ExcPointerIndexClash());
       user_data_type = data_index;
 
+      allocate_user_data ();
       Assert(i<user_data.size(), ExcIndexRange(i,0,user_data.size()));
       return user_data[i].i;
     }
@@ -660,8 +692,23 @@ namespace internal
     void
     TriaObjects<G>::clear_user_data (const unsigned int i)
     {
-      Assert(i<user_data.size(), ExcIndexRange(i,0,user_data.size()));
-      user_data[i].i = 0;
+      Assert(i<cells.size(), ExcIndexRange(i,0,cells.size()));
+      if (!user_data.empty())
+        user_data[i].i = 0;
+    }
+
+
+    template <typename G>
+    inline
+    void
+    TriaObjects<G>::allocate_user_data ()
+    {
+      Threads::Mutex::ScopedLock lock (user_data_mutex);
+      if (user_data.size() < cells.size())
+        {
+          user_data.reserve (cells.size());
+          user_data.resize (cells.size());
+        }
     }
 
 
@@ -684,7 +731,9 @@ namespace internal
              ExcPointerIndexClash());
       user_data_type = data_index;
 
-      Assert(i<user_data.size(), ExcIndexRange(i,0,user_data.size()));
+      Assert(i<cells.size(), ExcIndexRange(i,0,cells.size()));
+      if (user_data.empty())
+        return 0;
       return user_data[i].i;
     }
 
@@ -416,6 +416,16 @@ namespace hp
      */
     active_cell_iterator end_active (const unsigned int level) const;
 
+    /**
+     * Return an iterator to the active cell whose
+     * @ref GlossActiveCellIndex "active cell index" is @p active_cell_index.
+     * This function takes constant time and allows to split loops over all
+     * active cells into ranges of active cell indices, see
+     * Triangulation::active_cell_with_index().
+     */
+    active_cell_iterator
+    active_cell_with_index (const unsigned int active_cell_index) const;
+
     /**
      * @name Cell iterator functions returning ranges of iterators
      */
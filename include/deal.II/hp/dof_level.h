@@ -255,6 +255,16 @@ namespace internal
       get_cell_cache_start (const unsigned int obj_index,
                             const unsigned int dofs_per_cell) const;
 
+      /**
+       * Same as above. The cache of this class is never stored in compressed
+       * form, so @p scratch is not used. This function exists for
+       * compatibility with internal::DoFHandler::DoFLevel.
+       */
+      const types::global_dof_index *
+      get_cell_cache_start (const unsigned int                    obj_index,
+                            const unsigned int                    dofs_per_cell,
+                            std::vector<types::global_dof_index> &scratch) const;
+
       /**
        * Determine an estimate for the memory consumption (in bytes) of this
        * object.
@@ -479,6 +489,17 @@ namespace internal
 
 
 
+    inline
+    const types::global_dof_index *
+    DoFLevel::get_cell_cache_start (const unsigned int                    obj_index,
+                                    const unsigned int                    dofs_per_cell,
+                                    std::vector<types::global_dof_index> &) const
+    {
+      return get_cell_cache_start (obj_index, dofs_per_cell);
+    }
+
+
+
     template <class Archive>
     inline
     void
@@ -217,6 +217,14 @@ namespace hp
    * combination of finite element, quadrature formula and mapping, but only
    * those that will actually be needed.
    *
+   * Since each ::FEValues object has its own tables of shape functions,
+   * switching between them on every cell is considerably slower than working
+   * with a single ::FEValues object. Loops over the cells are faster if the
+   * cells are visited in the order returned by
+   * DoFTools::get_active_cells_sorted_by_fe_index(), where consecutive cells
+   * use the same ::FEValues object and reinit() only has to check that the
+   * indices did not change.
+   *
    * This class has not yet been implemented for the use in the codimension
    * one case (<tt>spacedim != dim </tt>).
    *
@@ -0,0 +1,440 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_batched_dense_factorization_h
+#define dealii_batched_dense_factorization_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/vectorization.h>
+
+#include <cmath>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*! @addtogroup Matrix1
+ *@{
+ */
+
+
+/**
+ * LU and Cholesky factorizations of small dense matrices, with the
+ * corresponding forward and backward substitutions. The class is intended
+ * for the many independent local problems that arise in cell-wise
+ * operations, such as block-Jacobi smoothers for discontinuous Galerkin
+ * methods, static condensation, or local projections, where the matrices
+ * are of size 10 to 100 and the overhead of calling LAPACK for each of them
+ * dominates the run time.
+ *
+ * The template argument @p Number can be a scalar type like @p double, or
+ * a VectorizedArray. In the latter case, each vectorization lane holds the
+ * matrix of a different cell, with the matrices of a whole batch of cells
+ * stored in an interleaved way as in Table<2,VectorizedArray<double> >.
+ * All operations then work on the whole batch at once, with each arithmetic
+ * operation processing all lanes with one SIMD instruction. The
+ * vectorize_matrices() function sets up such a table from scalar matrices.
+ *
+ * Since the lanes of a VectorizedArray cannot take different branches, the
+ * LU factorization is computed without pivoting. It is therefore meant for
+ * matrices whose leading principal minors are well-conditioned, such as
+ * symmetric positive definite or diagonally dominant matrices, which is the
+ * case for the applications mentioned above. The Cholesky factorization
+ * requires a symmetric positive definite matrix. No check for (nearly)
+ * singular matrices is performed.
+ *
+ * A typical use for the cell-wise inverse of a DG mass or block-diagonal
+ * matrix looks as follows:
+ * @code
+ *   Table<2,VectorizedArray<double> > cell_matrix (dofs_per_cell, dofs_per_cell);
+ *   ... // fill the cell matrices of the cell batch
+ *   BatchedDenseFactorization<VectorizedArray<double> > factorization;
+ *   factorization.factorize (cell_matrix,
+ *                            BatchedDenseFactorization<VectorizedArray<double> >::cholesky);
+ *   ...
+ *   factorization.solve (make_array_view (cell_vector));
+ * @endcode
+ */
+template <typename Number>
+class BatchedDenseFactorization
+{
+public:
+  /**
+   * The factorizations available.
+   */
+  enum FactorizationType
+  {
+    /**
+     * LU factorization without pivoting.
+     */
+    lu,
+    /**
+     * Cholesky factorization $A = L L^T$ of a symmetric positive definite
+     * matrix.
+     */
+    cholesky
+  };
+
+  /**
+   * Default constructor.
+   */
+  BatchedDenseFactorization ();
+
+  /**
+   * Constructor that immediately calls factorize().
+   */
+  BatchedDenseFactorization (const Table<2,Number>   &matrix,
+                             const FactorizationType  type = lu);
+
+  /**
+   * Compute the factorization of the given square matrix. For the Cholesky
+   * factorization, only the lower triangle of the matrix is read.
+   */
+  void factorize (const Table<2,Number>   &matrix,
+                  const FactorizationType  type = lu);
+
+  /**
+   * Solve the linear system with the factorized matrix, overwriting the
+   * right hand side @p rhs_and_solution with the solution.
+   */
+  void solve (const ArrayView<Number> &rhs_and_solution) const;
+
+  /**
+   * Solve the linear system with right hand side @p src and write the
+   * solution into @p dst.
+   */
+  void solve (const ArrayView<Number>       &dst,
+              const ArrayView<const Number> &src) const;
+
+  /**
+   * Compute the inverse of the factorized matrix by solving for all unit
+   * vectors, and write it into @p inverse, which is resized as
+   * necessary.
+   */
+  void invert (Table<2,Number> &inverse) const;
+
+  /**
+   * Return the number of rows (and columns) of the factorized matrix.
+   */
+  unsigned int size () const;
+
+  /**
+   * Return the kind of factorization that has been computed.
+   */
+  FactorizationType get_type () const;
+
+  /**
+   * Return an estimate of the memory consumption of this object in bytes.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * The number of rows of the matrix.
+   */
+  unsigned int n_rows;
+
+  /**
+   * The kind of factorization stored.
+   */
+  FactorizationType type;
+
+  /**
+   * The factors in row-major order: the strict lower triangle of L (with
+   * unit diagonal) and the upper triangle of U for the LU factorization,
+   * and the lower triangle of L for the Cholesky factorization.
+   */
+  AlignedVector<Number> factors;
+
+  /**
+   * The inverses of the diagonal entries of U for the LU factorization and
+   * of L for the Cholesky factorization, used in order to replace divisions
+   * by multiplications in the substitutions.
+   */
+  AlignedVector<Number> inverse_diagonal;
+};
+
+
+
+/**
+ * Create a table of vectorized arrays from up to
+ * VectorizedArray<Number>::n_array_elements scalar matrices of the same size,
+ * with the matrix <tt>matrices[v]</tt> placed into lane @p v. Lanes without a
+ * matrix are filled with the identity matrix, so that they can be factorized
+ * and solved with BatchedDenseFactorization without producing invalid
+ * floating point numbers.
+ *
+ * @relates BatchedDenseFactorization
+ */
+template <typename Number, typename MatrixType>
+void
+vectorize_matrices (const std::vector<const MatrixType *>   &matrices,
+                    Table<2,VectorizedArray<Number> >        &vectorized_matrix);
+
+/*@}*/
+
+
+#ifndef DOXYGEN
+/* ---------------------------- Inline functions ---------------------------- */
+
+
+template <typename Number>
+inline
+BatchedDenseFactorization<Number>::BatchedDenseFactorization ()
+  :
+  n_rows (0),
+  type (lu)
+{}
+
+
+
+template <typename Number>
+inline
+BatchedDenseFactorization<Number>::BatchedDenseFactorization
+(const Table<2,Number>   &matrix,
+ const FactorizationType  type)
+  :
+  n_rows (0),
+  type (type)
+{
+  factorize (matrix, type);
+}
+
+
+
+template <typename Number>
+inline
+void
+BatchedDenseFactorization<Number>::factorize (const Table<2,Number>   &matrix,
+                                              const FactorizationType  type_in)
+{
+  AssertDimension (matrix.n_rows(), matrix.n_cols());
+  n_rows = matrix.n_rows();
+  type = type_in;
+  const unsigned int n = n_rows;
+  factors.resize_fast (n*n);
+  inverse_diagonal.resize_fast (n);
+  if (n == 0)
+    return;
+
+  Number *a = factors.begin();
+  if (type == lu)
+    {
+      // Doolittle algorithm, working on the rows of the matrix so that the
+      // inner loops access contiguous memory
+      for (unsigned int i=0; i<n; ++i)
+        for (unsigned int j=0; j<n; ++j)
+          a[i*n+j] = matrix(i,j);
+
+      for (unsigned int k=0; k<n; ++k)
+        {
+          const Number inv_pivot = 1./a[k*n+k];
+          inverse_diagonal[k] = inv_pivot;
+          const Number *row_k = a + k*n;
+          for (unsigned int i=k+1; i<n; ++i)
+            {
+              Number *row_i = a + i*n;
+              const Number factor = row_i[k] * inv_pivot;
+              row_i[k] = factor;
+              for (unsigned int j=k+1; j<n; ++j)
+                row_i[j] -= factor * row_k[j];
+            }
+        }
+    }
+  else
+    {
+      // row-oriented Cholesky-Banachiewicz algorithm on the lower triangle
+      for (unsigned int i=0; i<n; ++i)
+        {
+          Number *row_i = a + i*n;
+          for (unsigned int j=0; j<=i; ++j)
+            {
+              const Number *row_j = a + j*n;
+              Number sum = matrix(i,j);
+              for (unsigned int k=0; k<j; ++k)
+                sum -= row_i[k] * row_j[k];
+              if (j < i)
+                row_i[j] = sum * inverse_diagonal[j];
+              else
+                {
+                  row_i[i] = std::sqrt(sum);
+                  inverse_diagonal[i] = 1./row_i[i];
+                }
+            }
+        }
+    }
+}
+
+
+
+template <typename Number>
+inline
+void
+BatchedDenseFactorization<Number>::solve (const ArrayView<Number> &x) const
+{
+  AssertDimension (x.size(), n_rows);
+  const unsigned int n = n_rows;
+  const Number *a = factors.begin();
+
+  if (type == lu)
+    {
+      // forward substitution with the unit lower triangle
+      for (unsigned int i=1; i<n; ++i)
+        {
+          const Number *row_i = a + i*n;
+          Number sum = x[i];
+          for (unsigned int k=0; k<i; ++k)
+            sum -= row_i[k] * x[k];
+          x[i] = sum;
+        }
+
+      // backward substitution with the upper triangle
+      for (int i=n-1; i>=0; --i)
+        {
+          const Number *row_i = a + i*n;
+          Number sum = x[i];
+          for (unsigned int k=i+1; k<n; ++k)
+            sum -= row_i[k] * x[k];
+          x[i] = sum * inverse_diagonal[i];
+        }
+    }
+  else
+    {
+      // forward substitution with L
+      for (unsigned int i=0; i<n; ++i)
+        {
+          const Number *row_i = a + i*n;
+          Number sum = x[i];
+          for (unsigned int k=0; k<i; ++k)
+            sum -= row_i[k] * x[k];
+          x[i] = sum * inverse_diagonal[i];
+        }
+
+      // backward substitution with L^T, column by column of L^T so that
+      // only rows of L are accessed
+      for (int i=n-1; i>=0; --i)
+        {
+          const Number *row_i = a + i*n;
+          const Number xi = x[i] * inverse_diagonal[i];
+          x[i] = xi;
+          for (int k=0; k<i; ++k)
+            x[k] -= row_i[k] * xi;
+        }
+    }
+}
+
+
+
+template <typename Number>
+inline
+void
+BatchedDenseFactorization<Number>::solve (const ArrayView<Number>       &dst,
+                                          const ArrayView<const Number> &src) const
+{
+  AssertDimension (dst.size(), n_rows);
+  AssertDimension (src.size(), n_rows);
+  for (unsigned int i=0; i<n_rows; ++i)
+    dst[i] = src[i];
+  solve (dst);
+}
+
+
+
+template <typename Number>
+inline
+void
+BatchedDenseFactorization<Number>::invert (Table<2,Number> &inverse) const
+{
+  inverse.reinit (n_rows, n_rows);
+  AlignedVector<Number> column (n_rows);
+  for (unsigned int j=0; j<n_rows; ++j)
+    {
+      for (unsigned int i=0; i<n_rows; ++i)
+        column[i] = Number();
+      column[j] = 1.;
+      solve (ArrayView<Number>(column.begin(), n_rows));
+      for (unsigned int i=0; i<n_rows; ++i)
+        inverse(i,j) = column[i];
+    }
+}
+
+
+
+template <typename Number>
+inline
+unsigned int
+BatchedDenseFactorization<Number>::size () const
+{
+  return n_rows;
+}
+
+
+
+template <typename Number>
+inline
+typename BatchedDenseFactorization<Number>::FactorizationType
+BatchedDenseFactorization<Number>::get_type () const
+{
+  return type;
+}
+
+
+
+template <typename Number>
+inline
+std::size_t
+BatchedDenseFactorization<Number>::memory_consumption () const
+{
+  return sizeof(*this) + factors.memory_consumption() +
+         inverse_diagonal.memory_consumption();
+}
+
+
+
+template <typename Number, typename MatrixType>
+inline
+void
+vectorize_matrices (const std::vector<const MatrixType *>   &matrices,
+                    Table<2,VectorizedArray<Number> >        &vectorized_matrix)
+{
+  Assert (matrices.size() > 0 &&
+          matrices.size() <= VectorizedArray<Number>::n_array_elements,
+          ExcIndexRange (matrices.size(), 1,
+                         VectorizedArray<Number>::n_array_elements+1));
+  const unsigned int m = matrices[0]->m(), n = matrices[0]->n();
+  vectorized_matrix.reinit (m, n);
+  for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+    {
+      if (v < matrices.size())
+        {
+          AssertDimension (matrices[v]->m(), m);
+          AssertDimension (matrices[v]->n(), n);
+        }
+      for (unsigned int i=0; i<m; ++i)
+        for (unsigned int j=0; j<n; ++j)
+          vectorized_matrix(i,j)[v] = (v < matrices.size() ?
+                                       (*matrices[v])(i,j) :
+                                       (i==j ? Number(1.) : Number()));
+    }
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -179,27 +179,33 @@ namespace internal
 
     /**
      * Perform a vmult_add using the ChunkSparseMatrix data structures, but
-     * only using a subinterval of the matrix rows.
-     *
-     * In the sequential case, this function is called on all rows, in the
-     * parallel case it may be called on a subrange, at the discretion of the
-     * task scheduler.
+     * only using a subinterval of the matrix rows. If the template argument
+     * @p static_chunk_size is positive, it must equal the chunk size of the
+     * sparsity pattern. The loops over the entries of a chunk then have
+     * compile-time bounds, which allows the compiler to unroll and vectorize
+     * them.
      */
-    template <typename number,
+    template <int static_chunk_size,
+              typename number,
               typename InVector,
               typename OutVector>
-    void vmult_add_on_subrange (const ChunkSparsityPattern &cols,
-                                const unsigned int  begin_row,
-                                const unsigned int  end_row,
-                                const number       *values,
-                                const std::size_t  *rowstart,
-                                const size_type    *colnums,
-                                const InVector     &src,
-                                OutVector          &dst)
+    void vmult_add_on_subrange_impl (const ChunkSparsityPattern &cols,
+                                     const unsigned int  begin_row,
+                                     const unsigned int  end_row,
+                                     const number       *values,
+                                     const std::size_t  *rowstart,
+                                     const size_type    *colnums,
+                                     const InVector     &src,
+                                     OutVector          &dst)
     {
+      Assert (static_chunk_size <= 0 ||
+              cols.get_chunk_size() == static_cast<size_type>(static_chunk_size),
+              ExcInternalError());
       const size_type m = cols.n_rows();
       const size_type n = cols.n_cols();
-      const size_type chunk_size = cols.get_chunk_size();
+      const size_type chunk_size = static_chunk_size > 0 ?
+                                   static_chunk_size :
+                                   cols.get_chunk_size();
 
       // loop over all chunks. note that we need to treat the last chunk row
       // and column differently if they have padding elements
@@ -277,6 +283,56 @@ namespace internal
              rowstart[end_row] * chunk_size * chunk_size,
              ExcInternalError());
     }
+
+
+
+    /**
+     * Perform a vmult_add using the ChunkSparseMatrix data structures, but
+     * only using a subinterval of the matrix rows.
+     *
+     * In the sequential case, this function is called on all rows, in the
+     * parallel case it may be called on a subrange, at the discretion of the
+     * task scheduler.
+     *
+     * For the chunk sizes typical of vector-valued problems, this function
+     * dispatches to a version of vmult_add_on_subrange_impl() with the chunk
+     * size fixed at compile time.
+     */
+    template <typename number,
+              typename InVector,
+              typename OutVector>
+    void vmult_add_on_subrange (const ChunkSparsityPattern &cols,
+                                const unsigned int  begin_row,
+                                const unsigned int  end_row,
+                                const number       *values,
+                                const std::size_t  *rowstart,
+                                const size_type    *colnums,
+                                const InVector     &src,
+                                OutVector          &dst)
+    {
+      switch (cols.get_chunk_size())
+        {
+        case 2:
+          vmult_add_on_subrange_impl<2> (cols, begin_row, end_row, values,
+                                         rowstart, colnums, src, dst);
+          break;
+        case 3:
+          vmult_add_on_subrange_impl<3> (cols, begin_row, end_row, values,
+                                         rowstart, colnums, src, dst);
+          break;
+        case 4:
+          vmult_add_on_subrange_impl<4> (cols, begin_row, end_row, values,
+                                         rowstart, colnums, src, dst);
+          break;
+        case 8:
+          vmult_add_on_subrange_impl<8> (cols, begin_row, end_row, values,
+                                         rowstart, colnums, src, dst);
+          break;
+        default:
+          vmult_add_on_subrange_impl<-1> (cols, begin_row, end_row, values,
+                                          rowstart, colnums, src, dst);
+        }
+    }
   }
 }
 
@@ -28,6 +28,7 @@
 
 #include <boost/range/iterator_range.hpp>
 
+#include <algorithm>
 #include <vector>
 #include <set>
 #include <utility>
@@ -996,6 +997,33 @@ public:
                               VectorType                    &global_vector,
                               bool                          use_inhomogeneities_for_rhs = false) const;
 
+  /**
+   * Like the previous function, but for a batch of cells at once, with the
+   * local matrix, the local vector, and the local dof indices of the $c$-th
+   * cell given by <tt>local_matrices[c]</tt>, <tt>local_vectors[c]</tt>, and
+   * <tt>local_dof_indices[c]</tt>. If @p local_vectors is empty, only the
+   * matrix entries are written.
+   *
+   * Most cells of a mesh do not contain any constrained degrees of freedom.
+   * For these cells, this function skips the setup of the data structures
+   * needed for resolving constraints, and writes the local matrix into the
+   * global matrix with one call per row, using column indices that are sorted
+   * once per cell. This is considerably cheaper than calling the previous
+   * function for each cell. Cells with constrained degrees of freedom are
+   * handed to the previous function.
+   *
+   * The same comments regarding thread safety as for the previous function
+   * apply.
+   */
+  template <typename MatrixType, typename VectorType>
+  void
+  distribute_local_to_global (const std::vector<FullMatrix<typename MatrixType::value_type> > &local_matrices,
+                              const std::vector<Vector<typename VectorType::value_type> >     &local_vectors,
+                              const std::vector<std::vector<size_type> >                      &local_dof_indices,
+                              MatrixType                    &global_matrix,
+                              VectorType                    &global_vector,
+                              bool                          use_inhomogeneities_for_rhs = false) const;
+
   /**
    * Do a similar operation as the distribute_local_to_global() function that
    * distributes writing entries into a matrix for constrained degrees of
@@ -1114,6 +1142,12 @@ public:
    *
    * @note If this function is called with a parallel vector @p vec, then the
    * vector must not contain ghost elements.
+   *
+   * Since close() resolves chains of constraints, the constrained entries
+   * only depend on unconstrained ones and can be computed in any order. For
+   * vectors of type Vector, BlockVector, and
+   * LinearAlgebra::distributed::Vector, the constraints are therefore
+   * applied in parallel using the compressed storage set up by close().
    */
   template <class VectorType>
   void distribute (VectorType &vec) const;
@@ -1369,6 +1403,65 @@ private:
    */
   bool sorted;
 
+  /**
+   * A copy of the constraint lines in compressed row storage, which is set
+   * up by close() and used by the functions distribute() and set_zero().
+   * Compared to the vector of ConstraintLine objects, this format stores all
+   * entries of all lines contiguously in memory, which avoids the pointer
+   * chasing through many small arrays. The i-th line of this structure
+   * corresponds to <tt>lines[i]</tt>.
+   */
+  struct CompressedLines
+  {
+    /**
+     * The index of the constrained degree of freedom of each line.
+     */
+    std::vector<size_type> line_indices;
+
+    /**
+     * The inhomogeneity of each line.
+     */
+    std::vector<double> inhomogeneities;
+
+    /**
+     * The position of the first entry of each line in @p column_indices
+     * and @p values, with one additional element for the end of the last
+     * line.
+     */
+    std::vector<size_type> row_starts;
+
+    /**
+     * The indices of the degrees of freedom the lines are constrained to.
+     */
+    std::vector<size_type> column_indices;
+
+    /**
+     * The weights of the entries.
+     */
+    std::vector<double> values;
+
+    /**
+     * Fill the arrays from the given lines.
+     */
+    void initialize (const std::vector<ConstraintLine> &lines);
+
+    /**
+     * Release all memory.
+     */
+    void clear ();
+
+    /**
+     * Determine an estimate for the memory consumption (in bytes) of this
+     * object.
+     */
+    std::size_t memory_consumption () const;
+  };
+
+  /**
+   * The compressed constraint lines, only valid if #sorted is true.
+   */
+  CompressedLines compressed_lines;
+
   /**
    * Internal function to calculate the index of line @p line in the vector
    * lines_cache using local_lines.
@@ -1499,7 +1592,8 @@ ConstraintMatrix::ConstraintMatrix (const ConstraintMatrix &constraint_matrix)
   lines (constraint_matrix.lines),
   lines_cache (constraint_matrix.lines_cache),
   local_lines (constraint_matrix.local_lines),
-  sorted (constraint_matrix.sorted)
+  sorted (constraint_matrix.sorted),
+  compressed_lines (constraint_matrix.compressed_lines)
 {}
 
 
@@ -1591,6 +1685,10 @@ ConstraintMatrix::set_inhomogeneity (const size_type line,
   Assert(lines_cache[line_index] < lines.size(), ExcInternalError());
   ConstraintLine *line_ptr = &lines[lines_cache[line_index]];
   line_ptr->inhomogeneity = value;
+
+  // keep the compressed storage up to date
+  if (sorted)
+    compressed_lines.inhomogeneities[lines_cache[line_index]] = value;
 }
 
 
@@ -1915,6 +2013,90 @@ distribute_local_to_global (const FullMatrix<typename MatrixType::value_type>
 
 
 
+template <typename MatrixType, typename VectorType>
+inline
+void
+ConstraintMatrix::
+distribute_local_to_global (const std::vector<FullMatrix<typename MatrixType::value_type> > &local_matrices,
+                            const std::vector<Vector<typename VectorType::value_type> >     &local_vectors,
+                            const std::vector<std::vector<size_type> >                      &local_dof_indices,
+                            MatrixType                   &global_matrix,
+                            VectorType                   &global_vector,
+                            bool                          use_inhomogeneities_for_rhs) const
+{
+  typedef typename MatrixType::value_type number;
+  const bool use_vectors = (local_vectors.empty() == false);
+  AssertDimension (local_matrices.size(), local_dof_indices.size());
+  if (use_vectors)
+    AssertDimension (local_vectors.size(), local_dof_indices.size());
+  Assert (lines.empty() || sorted == true, ExcMatrixNotClosed());
+
+  // scratch arrays that are reused for all cells of the batch
+  std::vector<std::pair<size_type,unsigned int> > sorted_indices;
+  std::vector<size_type> columns;
+  std::vector<number> values;
+
+  for (unsigned int c=0; c<local_dof_indices.size(); ++c)
+    {
+      const std::vector<size_type> &indices = local_dof_indices[c];
+      const FullMatrix<number> &local_matrix = local_matrices[c];
+      const unsigned int n_local_dofs = indices.size();
+
+      bool has_constraints = false;
+      if (lines.empty() == false)
+        for (unsigned int i=0; i<n_local_dofs; ++i)
+          if (is_constrained(indices[i]))
+            {
+              has_constraints = true;
+              break;
+            }
+
+      // block matrices need the splitting into blocks done by the general
+      // function
+      if (has_constraints || IsBlockMatrix<MatrixType>::value)
+        {
+          if (use_vectors)
+            distribute_local_to_global (local_matrix, local_vectors[c], indices,
+                                        global_matrix, global_vector,
+                                        use_inhomogeneities_for_rhs);
+          else
+            distribute_local_to_global (local_matrix, indices, global_matrix);
+          continue;
+        }
+
+      AssertDimension (local_matrix.m(), n_local_dofs);
+      AssertDimension (local_matrix.n(), n_local_dofs);
+
+      // sort the column indices once for all rows of the cell
+      sorted_indices.resize (n_local_dofs);
+      for (unsigned int i=0; i<n_local_dofs; ++i)
+        sorted_indices[i] = std::make_pair (indices[i], i);
+      std::sort (sorted_indices.begin(), sorted_indices.end());
+
+      columns.resize (n_local_dofs);
+      values.resize (n_local_dofs);
+      for (unsigned int i=0; i<n_local_dofs; ++i)
+        columns[i] = sorted_indices[i].first;
+
+      for (unsigned int i=0; i<n_local_dofs; ++i)
+        {
+          for (unsigned int j=0; j<n_local_dofs; ++j)
+            values[j] = local_matrix(i, sorted_indices[j].second);
+          global_matrix.add (indices[i], n_local_dofs, columns.data(),
+                             values.data(), false, true);
+        }
+
+      if (use_vectors)
+        {
+          AssertDimension (local_vectors[c].size(), n_local_dofs);
+          global_vector.add (indices, local_vectors[c]);
+        }
+    }
+}
+
+
+
+
 template <typename SparsityPatternType>
 inline
 void
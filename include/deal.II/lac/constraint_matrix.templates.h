@@ -20,6 +20,7 @@
 
 #include <deal.II/lac/constraint_matrix.h>
 
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/table.h>
 #include <deal.II/base/thread_local_storage.h>
 #include <deal.II/lac/full_matrix.h>
@@ -536,23 +537,32 @@ namespace internal
           }
       }
 
+      // the number of constraint lines that are processed by one task in
+      // the threaded loops of set_zero() and distribute()
+      const unsigned int constraint_grain_size = 512;
+
       template <typename Number>
       void set_zero_parallel(const std::vector<size_type> &cm, LinearAlgebra::distributed::Vector<Number> &vec, size_type shift = 0)
       {
-        for (typename std::vector<size_type>::const_iterator it = cm.begin();
-             it != cm.end(); ++it)
-          {
-            // If shift>0 then we are working on a part of a BlockVector
-            // so vec(i) is actually the global entry i+shift.
-            // We first make sure the line falls into the range of vec,
-            // then check if is part of the local part of the vector, before
-            // finally setting it to 0.
-            if ((*it)<shift)
-              continue;
-            size_type idx = *it - shift;
-            if (vec.in_local_range(idx))
-              vec(idx) = 0.;
-          }
+        parallel::apply_to_subranges
+        (0U, static_cast<unsigned int>(cm.size()),
+         [&] (const unsigned int begin, const unsigned int end)
+        {
+          for (unsigned int i=begin; i<end; ++i)
+            {
+              // If shift>0 then we are working on a part of a BlockVector
+              // so vec(i) is actually the global entry i+shift.
+              // We first make sure the line falls into the range of vec,
+              // then check if is part of the local part of the vector, before
+              // finally setting it to 0.
+              if (cm[i]<shift)
+                continue;
+              size_type idx = cm[i] - shift;
+              if (vec.in_local_range(idx))
+                vec(idx) = 0.;
+            }
+        },
+        constraint_grain_size);
         vec.zero_out_ghosts();
       }
 
@@ -582,9 +592,14 @@ namespace internal
       void set_zero_serial(const std::vector<size_type> &cm,
                            VectorType                   &vec)
       {
-        for (typename std::vector<size_type>::const_iterator it = cm.begin();
-             it != cm.end(); ++it)
-          vec(*it) = 0.;
+        parallel::apply_to_subranges
+        (0U, static_cast<unsigned int>(cm.size()),
+         [&] (const unsigned int begin, const unsigned int end)
+        {
+          for (unsigned int i=begin; i<end; ++i)
+            vec(cm[i]) = 0.;
+        },
+        constraint_grain_size);
       }
 
       template <class VectorType>
@@ -609,6 +624,34 @@ namespace internal
       {
         set_zero_serial(cm, vec);
       }
+
+      // a trait that determines whether different entries of a vector can
+      // be written concurrently from several threads, which is the case
+      // for the vectors of deal.II that store their elements in plain
+      // arrays
+      template <class VectorType>
+      struct SupportsConcurrentElementAccess
+      {
+        static const bool value = false;
+      };
+
+      template <typename Number>
+      struct SupportsConcurrentElementAccess<dealii::Vector<Number> >
+      {
+        static const bool value = true;
+      };
+
+      template <typename Number>
+      struct SupportsConcurrentElementAccess<dealii::BlockVector<Number> >
+      {
+        static const bool value = true;
+      };
+
+      template <typename Number>
+      struct SupportsConcurrentElementAccess<LinearAlgebra::distributed::Vector<Number> >
+      {
+        static const bool value = true;
+      };
     }
   }
 }
@@ -618,12 +661,18 @@ template <class VectorType>
 void
 ConstraintMatrix::set_zero (VectorType &vec) const
 {
-  // since we lines is a private member, we cannot pass it to the functions
-  // above. therefore, copy the content which is cheap
-  std::vector<size_type> constrained_lines(lines.size());
-  for (unsigned int i=0; i<lines.size(); ++i)
-    constrained_lines[i] = lines[i].index;
-  internal::ConstraintMatrix::set_zero_all(constrained_lines, vec);
+  // after close(), the indices of the constrained lines are readily
+  // available in the compressed storage. otherwise, copy them from the
+  // lines, which is cheap
+  if (sorted)
+    internal::ConstraintMatrix::set_zero_all(compressed_lines.line_indices, vec);
+  else
+    {
+      std::vector<size_type> constrained_lines(lines.size());
+      for (unsigned int i=0; i<lines.size(); ++i)
+        constrained_lines[i] = lines[i].index;
+      internal::ConstraintMatrix::set_zero_all(constrained_lines, vec);
+    }
 }
 
 
@@ -882,13 +931,16 @@ ConstraintMatrix::distribute (VectorType &vec) const
       // and finally throw away the ghosted vector. Implement this in the following.
       IndexSet needed_elements = vec_owned_elements;
 
-      typedef std::vector<ConstraintLine>::const_iterator constraint_iterator;
-      for (constraint_iterator it = lines.begin();
-           it != lines.end(); ++it)
-        if (vec_owned_elements.is_element(it->index))
-          for (unsigned int i=0; i<it->entries.size(); ++i)
-            if (!vec_owned_elements.is_element(it->entries[i].first))
-              needed_elements.add_index(it->entries[i].first);
+      std::vector<size_type> owned_lines;
+      for (size_type line=0; line<compressed_lines.line_indices.size(); ++line)
+        if (vec_owned_elements.is_element(compressed_lines.line_indices[line]))
+          {
+            owned_lines.push_back(line);
+            for (size_type j=compressed_lines.row_starts[line];
+                 j<compressed_lines.row_starts[line+1]; ++j)
+              if (!vec_owned_elements.is_element(compressed_lines.column_indices[j]))
+                needed_elements.add_index(compressed_lines.column_indices[j]);
+          }
 
       VectorType ghosted_vector;
       internal::import_vector_with_ghost_elements (vec,
@@ -896,20 +948,33 @@ ConstraintMatrix::distribute (VectorType &vec) const
                                                    ghosted_vector,
                                                    std::integral_constant<bool, IsBlockVector<VectorType>::value>());
 
-      for (constraint_iterator it = lines.begin();
-           it != lines.end(); ++it)
-        if (vec_owned_elements.is_element(it->index))
+      const auto distribute_on_range = [&] (const size_type begin,
+                                            const size_type end)
+      {
+        for (size_type i=begin; i<end; ++i)
           {
+            const size_type line = owned_lines[i];
             typename VectorType::value_type
-            new_value = it->inhomogeneity;
-            for (unsigned int i=0; i<it->entries.size(); ++i)
+            new_value = compressed_lines.inhomogeneities[line];
+            for (size_type j=compressed_lines.row_starts[line];
+                 j<compressed_lines.row_starts[line+1]; ++j)
               new_value += (static_cast<typename VectorType::value_type>
                             (internal::ElementAccess<VectorType>::get(
-                               ghosted_vector, it->entries[i].first)) *
-                            it->entries[i].second);
+                               ghosted_vector, compressed_lines.column_indices[j])) *
+                            compressed_lines.values[j]);
             AssertIsFinite(new_value);
-            internal::ElementAccess<VectorType>::set(new_value, it->index, vec);
+            internal::ElementAccess<VectorType>::set(new_value,
+                                                     compressed_lines.line_indices[line],
+                                                     vec);
           }
+      };
+
+      if (internal::ConstraintMatrix::SupportsConcurrentElementAccess<VectorType>::value)
+        parallel::apply_to_subranges (size_type(0), size_type(owned_lines.size()),
+                                      distribute_on_range,
+                                      internal::ConstraintMatrix::constraint_grain_size);
+      else
+        distribute_on_range (0, owned_lines.size());
 
       // now compress to communicate the entries that we added to
       // and that weren't to local processors to the owner
@@ -923,23 +988,37 @@ ConstraintMatrix::distribute (VectorType &vec) const
     // support anything else or because it's completely stored
     // locally)
     {
-      std::vector<ConstraintLine>::const_iterator next_constraint = lines.begin();
-      for (; next_constraint != lines.end(); ++next_constraint)
-        {
-          // fill entry in line
-          // next_constraint.index by adding the
-          // different contributions
-          typename VectorType::value_type
-          new_value = next_constraint->inhomogeneity;
-          for (unsigned int i=0; i<next_constraint->entries.size(); ++i)
-            new_value += (static_cast<typename VectorType::value_type>
-                          (internal::ElementAccess<VectorType>::get(
-                             vec, next_constraint->entries[i].first))*
-                          next_constraint->entries[i].second);
-          AssertIsFinite(new_value);
-          internal::ElementAccess<VectorType>::set(new_value, next_constraint->index,
-                                                   vec);
-        }
+      // since close() resolved all chains of constraints, the lines only
+      // read from unconstrained entries and can be processed in any order
+      const auto distribute_on_range = [&] (const size_type begin,
+                                            const size_type end)
+      {
+        for (size_type line=begin; line<end; ++line)
+          {
+            // fill entry in line
+            // line_indices[line] by adding the
+            // different contributions
+            typename VectorType::value_type
+            new_value = compressed_lines.inhomogeneities[line];
+            for (size_type j=compressed_lines.row_starts[line];
+                 j<compressed_lines.row_starts[line+1]; ++j)
+              new_value += (static_cast<typename VectorType::value_type>
+                            (internal::ElementAccess<VectorType>::get(
+                               vec, compressed_lines.column_indices[j]))*
+                            compressed_lines.values[j]);
+            AssertIsFinite(new_value);
+            internal::ElementAccess<VectorType>::set(new_value,
+                                                     compressed_lines.line_indices[line],
+                                                     vec);
+          }
+      };
+
+      const size_type n_lines = compressed_lines.line_indices.size();
+      if (internal::ConstraintMatrix::SupportsConcurrentElementAccess<VectorType>::value)
+        parallel::apply_to_subranges (size_type(0), n_lines, distribute_on_range,
+                                      internal::ConstraintMatrix::constraint_grain_size);
+      else
+        distribute_on_range (0, n_lines);
     }
 }
 
@@ -2248,8 +2327,13 @@ ConstraintMatrix::distribute_local_to_global (
   const bool use_vectors = (local_vector.size() == 0 &&
                             global_vector.size() == 0) ? false : true;
   typedef typename MatrixType::value_type number;
+  // the shortcut for deal.II sparse matrices writes into the matrix rows
+  // directly, so it is not available if the matrix adds atomically
+  SparseMatrix<number> *sparse_matrix
+    = dynamic_cast<SparseMatrix<number> *>(&global_matrix);
   const bool use_dealii_matrix =
-    std::is_same<MatrixType,SparseMatrix<number> >::value;
+    std::is_same<MatrixType,SparseMatrix<number> >::value &&
+    sparse_matrix->get_atomic_add_mode() == false;
 
   AssertDimension (local_matrix.n(), local_dof_indices.size());
   AssertDimension (local_matrix.m(), local_dof_indices.size());
@@ -2285,8 +2369,6 @@ ConstraintMatrix::distribute_local_to_global (
   std::vector<number>    &vector_values  = scratch_data->vector_values;
   vector_indices.resize(n_actual_dofs);
   vector_values.resize(n_actual_dofs);
-  SparseMatrix<number> *sparse_matrix
-    = dynamic_cast<SparseMatrix<number> *>(&global_matrix);
   if (use_dealii_matrix == false)
     {
       cols.resize (n_actual_dofs);
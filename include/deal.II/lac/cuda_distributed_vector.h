@@ -0,0 +1,509 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_cuda_distributed_vector_h
+#define dealii_cuda_distributed_vector_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/partitioner.h>
+#include <deal.II/lac/cuda_vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/vector_space_vector.h>
+#include <deal.II/lac/vector_operation.h>
+
+#include <memory>
+#include <vector>
+
+#ifdef DEAL_II_WITH_CUDA
+
+#include <cuda_runtime_api.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace LinearAlgebra
+{
+  namespace CUDAWrappers
+  {
+    /**
+     * A vector whose elements are distributed over the processes of an MPI
+     * communicator and stored on the GPU of each process. This is the
+     * counterpart of LinearAlgebra::distributed::Vector for data residing in
+     * device memory: The layout is described by a Utilities::MPI::Partitioner,
+     * and each process stores its locally owned elements followed by the
+     * ghost elements in one contiguous array on the device, which is
+     * returned by get_values(). This is the layout expected by
+     * CUDAWrappers::MatrixFree on meshes distributed over several processes.
+     *
+     * The ghost elements are exchanged by update_ghost_values() and
+     * compress(). Both functions pack and unpack the data of the messages by
+     * kernels on the device and pass pointers to device memory directly to
+     * MPI, so that no data is copied to the host. This requires an MPI
+     * implementation that is CUDA-aware, i.e., that accepts pointers to
+     * device memory.
+     *
+     * As for LinearAlgebra::distributed::Vector, the values of the ghost
+     * elements are only valid after a call to update_ghost_values() and
+     * before the next vector operation. All vector operations act on the
+     * locally owned elements only, and reset the ghost elements to zero.
+     * Norms and scalar products are summed over all processes.
+     *
+     * @ingroup CUDAWrappers
+     * @ingroup Vectors
+     */
+    template <typename Number>
+    class DistributedVector: public VectorSpaceVector<Number>
+    {
+    public:
+      typedef typename VectorSpaceVector<Number>::value_type value_type;
+      typedef typename VectorSpaceVector<Number>::size_type  size_type;
+      typedef typename VectorSpaceVector<Number>::real_type  real_type;
+
+      /**
+       * Constructor. Create a vector of dimension zero.
+       */
+      DistributedVector();
+
+      /**
+       * Copy constructor. The new vector has the same partitioner as @p V.
+       */
+      DistributedVector(const DistributedVector<Number> &V);
+
+      /**
+       * Constructor. Create a vector with the layout described by
+       * @p partitioner and all elements set to zero.
+       */
+      explicit DistributedVector(const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner);
+
+      /**
+       * Destructor.
+       */
+      ~DistributedVector();
+
+      /**
+       * Initialize the vector with the layout described by @p partitioner.
+       * If @p omit_zeroing_entries is false, all elements are set to zero.
+       */
+      void reinit(const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner,
+                  const bool omit_zeroing_entries = false);
+
+      /**
+       * Change the dimension to that of the vector V. The elements of V are
+       * not copied.
+       */
+      virtual void reinit(const VectorSpaceVector<Number> &V,
+                          const bool omit_zeroing_entries = false) override;
+
+      /**
+       * Import the locally owned elements of @p V, which needs to store
+       * exactly the locally owned elements of this vector. VectorOperation::values
+       * @p operation is used to decide if the elements in @p V should be added
+       * to the current vector or replace the current elements. The last
+       * parameter is not used.
+       */
+      virtual void import(const ReadWriteVector<Number> &V,
+                          VectorOperation::values operation,
+                          std::shared_ptr<const CommunicationPatternBase> communication_pattern =
+                            std::shared_ptr<const CommunicationPatternBase> ()) override;
+
+      /**
+       * Copy the locally owned elements of @p V, which needs to have the same
+       * partitioner.
+       */
+      DistributedVector<Number> &operator= (const DistributedVector<Number> &V);
+
+      /**
+       * Copy the locally owned elements of the vector @p V on the host to
+       * the device. @p V needs to have the same locally owned elements as
+       * this vector. The data is staged through a buffer in page-locked host
+       * memory that is allocated upon the first transfer and kept for the
+       * following ones, which allows the copy to the device to run at the
+       * full bandwidth of the bus.
+       */
+      void copy_from_host(const LinearAlgebra::distributed::Vector<Number> &V);
+
+      /**
+       * Copy the locally owned elements of this vector to the vector @p V on
+       * the host, through the same staging buffer as copy_from_host(). @p V
+       * needs to have the same locally owned elements as this vector; its
+       * ghost elements are set to zero.
+       */
+      void copy_to_host(LinearAlgebra::distributed::Vector<Number> &V) const;
+
+      /**
+       * Sets all elements of the vector to the scalar @p s. This operation is
+       * only allowed if @p s is equal to zero.
+       */
+      virtual DistributedVector<Number> &operator= (const Number s) override;
+
+      /**
+       * Multiply the entire vector by a fixed factor.
+       */
+      virtual DistributedVector<Number> &operator*= (const Number factor) override;
+
+      /**
+       * Divide the entire vector by a fixed factor.
+       */
+      virtual DistributedVector<Number> &operator/= (const Number factor) override;
+
+      /**
+       * Add the vector @p V to the present one.
+       */
+      virtual DistributedVector<Number> &operator+= (const VectorSpaceVector<Number> &V) override;
+
+      /**
+       * Subtract the vector @p V from the present one.
+       */
+      virtual DistributedVector<Number> &operator-= (const VectorSpaceVector<Number> &V) override;
+
+      /**
+       * Return the scalar product of two vectors.
+       */
+      virtual Number operator* (const VectorSpaceVector<Number> &V) const override;
+
+      /**
+       * Add @p to all components. Note that @p a is a scalar not a vector.
+       */
+      virtual void add(const Number a) override;
+
+      /**
+       * Simple addition of a multiple of a vector, i.e. <tt>*this += a*V</tt>.
+       */
+      virtual void add(const Number a, const VectorSpaceVector<Number> &V) override;
+
+      /**
+       * Multiple addition of scaled vectors, i.e. <tt>*this += a*V+b*W</tt>.
+       */
+      virtual void add(const Number a, const VectorSpaceVector<Number> &V,
+                       const Number b, const VectorSpaceVector<Number> &W) override;
+
+      /**
+       * Scaling and simple addition of a multiple of a vector, i.e. <tt>*this
+       * = s*(*this)+a*V</tt>
+       */
+      virtual void sadd(const Number s, const Number a,
+                        const VectorSpaceVector<Number> &V) override;
+
+      /**
+       * Scale each element of this vector by the corresponding element in the
+       * argument. This function is mostly meant to simulate multiplication
+       * (and immediate re-assignment) by a diagonal scaling matrix.
+       */
+      virtual void scale(const VectorSpaceVector<Number> &scaling_factors) override;
+
+      /**
+       * Assignment <tt>*this = a*V</tt>.
+       */
+      virtual void equ(const Number a, const VectorSpaceVector<Number> &V) override;
+
+      /**
+       * Return whether the vector contains only elements with value zero.
+       */
+      virtual bool all_zero() const override;
+
+      /**
+       * Return the mean value of all the entries of this vector.
+       */
+      virtual value_type mean_value() const override;
+
+      /**
+       * Return the l<sub>1</sub> norm of the vector (i.e., the sum of the
+       * absolute values of all entries among all processors).
+       */
+      virtual real_type l1_norm() const override;
+
+      /**
+       * Return the l<sub>2</sub> norm of the vector (i.e., the square root of
+       * the sum of the square of all entries among all processors).
+       */
+      virtual real_type l2_norm() const override;
+
+      /**
+       * Return the maximum norm of the vector (i.e., the maximum absolute
+       * value among all entries and among all processors).
+       */
+      virtual real_type linfty_norm() const override;
+
+      /**
+       * Perform a combined operation of a vector addition and a subsequent
+       * inner product, returning the value of the inner product. In other
+       * words, the result of this function is the same as if the user called
+       * @code
+       * this->add(a, V);
+       * return_value = *this * W;
+       * @endcode
+       */
+      virtual Number add_and_dot(const Number                     a,
+                                 const VectorSpaceVector<Number> &V,
+                                 const VectorSpaceVector<Number> &W) override;
+
+      /**
+       * Fill the ghost elements with the values of the corresponding elements
+       * on the processes owning them.
+       *
+       * This function is collective over all processes of the communicator
+       * of the partitioner.
+       */
+      void update_ghost_values() const;
+
+      /**
+       * Start the exchange of the ghost elements done by
+       * update_ghost_values(): The data to send is packed by a kernel
+       * launched on @p stream, which is synchronized before the messages are
+       * posted. The kernels on other streams keep running, which allows to
+       * overlap the exchange with computations that do not read the ghost
+       * elements. The locally owned elements must not be modified until
+       * update_ghost_values_finish() is called.
+       */
+      void update_ghost_values_start(const cudaStream_t stream = 0) const;
+
+      /**
+       * Wait for the exchange started by update_ghost_values_start() to
+       * finish. Afterwards, the ghost elements hold valid values.
+       */
+      void update_ghost_values_finish() const;
+
+      /**
+       * Send the values of the ghost elements to the processes owning them.
+       * Only VectorOperation::add is supported for communication, in which
+       * case the values are added to the owned elements. For
+       * VectorOperation::insert, the ghost elements are just discarded, since
+       * the values of the owner are authoritative. After this call, all
+       * ghost elements are zero.
+       *
+       * This function is collective over all processes of the communicator
+       * of the partitioner.
+       */
+      void compress(const VectorOperation::values operation);
+
+      /**
+       * Set all the ghost elements to zero.
+       */
+      void zero_out_ghosts() const;
+
+      /**
+       * Return whether the ghost elements currently hold the values set by
+       * update_ghost_values().
+       */
+      bool has_ghost_elements() const;
+
+      /**
+       * Return the pointer to the underlying array on the device, holding the
+       * locally owned elements followed by the ghost elements. Ownership
+       * still resides with this class.
+       */
+      Number *get_values() const;
+
+      /**
+       * Return the global size of the vector, equal to the sum of the number
+       * of locally owned indices among all processors.
+       */
+      virtual size_type size() const override;
+
+      /**
+       * Return the number of locally owned elements.
+       */
+      size_type local_size() const;
+
+      /**
+       * Return an index set that describes which elements of this vector are
+       * owned by the current processor.
+       */
+      virtual dealii::IndexSet locally_owned_elements() const override;
+
+      /**
+       * Return the partitioner describing the layout of this vector.
+       */
+      const std::shared_ptr<const Utilities::MPI::Partitioner> &
+      get_partitioner() const;
+
+      /**
+       * Print the locally owned elements of the vector to the output stream
+       * @p out.
+       */
+      virtual void print(std::ostream       &out,
+                         const unsigned int  precision=2,
+                         const bool          scientific=true,
+                         const bool          across=true) const override;
+
+      /**
+       * Return the memory consumption of this class in bytes.
+       */
+      virtual std::size_t memory_consumption() const override;
+
+      /**
+       * Attempt to perform an operation between two incompatible vector types.
+       *
+       * @ingroup Exceptions
+       */
+      DeclException0(ExcVectorTypeNotCompatible);
+
+    private:
+      /**
+       * Store @p partitioner and copy the local indices of the elements that
+       * are ghosts on other processes to the device.
+       */
+      void set_up_import_indices (const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner);
+
+      /**
+       * Downcast @p V, checking that it has the same partitioner as this
+       * vector, and set its ghost elements to zero.
+       */
+      const DistributedVector<Number> &
+      downcast_and_zero_ghosts (const VectorSpaceVector<Number> &V) const;
+
+      /**
+       * The layout of the vector.
+       */
+      std::shared_ptr<const Utilities::MPI::Partitioner> partitioner;
+
+      /**
+       * The locally owned elements followed by the ghost elements. The
+       * vector operations of this class act on all of them, relying on the
+       * ghost elements being zero outside of the phase between
+       * update_ghost_values() and the next operation.
+       */
+      mutable Vector<Number> values;
+
+      /**
+       * The local indices of the elements sent to other processes, in the
+       * order of Utilities::MPI::Partitioner::import_targets(), on the
+       * device.
+       */
+      unsigned int *import_indices;
+
+      /**
+       * A buffer on the device for the packed data exchanged with the
+       * processes that have the locally owned elements as ghosts.
+       */
+      mutable Number *import_data;
+
+      /**
+       * Whether the ghost elements hold valid values.
+       */
+      mutable bool vector_is_ghosted;
+
+      /**
+       * The buffer in page-locked host memory used by copy_from_host() and
+       * copy_to_host(), with space for the locally owned elements.
+       */
+      mutable Number *host_staging_buffer;
+
+      /**
+       * Return the staging buffer, allocating it if necessary.
+       */
+      Number *get_host_staging_buffer() const;
+
+      /**
+       * Free the staging buffer.
+       */
+      void free_host_staging_buffer() const;
+
+#ifdef DEAL_II_WITH_MPI
+      /**
+       * The requests of the exchange between update_ghost_values_start()
+       * and update_ghost_values_finish().
+       */
+      mutable std::vector<MPI_Request> update_ghost_values_requests;
+#endif
+    };
+
+
+
+    // ------------------------------ Inline functions -----------------------------
+
+#ifndef DOXYGEN
+
+    template <typename Number>
+    inline
+    Number *DistributedVector<Number>::get_values() const
+    {
+      return values.get_values();
+    }
+
+
+
+    template <typename Number>
+    inline
+    typename DistributedVector<Number>::size_type
+    DistributedVector<Number>::size() const
+    {
+      return partitioner ? partitioner->size() : 0;
+    }
+
+
+
+    template <typename Number>
+    inline
+    typename DistributedVector<Number>::size_type
+    DistributedVector<Number>::local_size() const
+    {
+      return partitioner ? partitioner->local_size() : 0;
+    }
+
+
+
+    template <typename Number>
+    inline
+    IndexSet DistributedVector<Number>::locally_owned_elements() const
+    {
+      return partitioner ? partitioner->locally_owned_range() : IndexSet();
+    }
+
+
+
+    template <typename Number>
+    inline
+    const std::shared_ptr<const Utilities::MPI::Partitioner> &
+    DistributedVector<Number>::get_partitioner() const
+    {
+      return partitioner;
+    }
+
+
+
+    template <typename Number>
+    inline
+    bool DistributedVector<Number>::has_ghost_elements() const
+    {
+      return vector_is_ghosted;
+    }
+
+#endif // DOXYGEN
+
+  }
+
+
+
+  namespace distributed
+  {
+    /**
+     * The vector whose elements reside in the memory of a CUDA device, see
+     * the general template.
+     */
+    template <typename Number>
+    struct VectorInMemorySpace<Number, ::dealii::MemorySpace::CUDA>
+    {
+      typedef CUDAWrappers::DistributedVector<Number> type;
+    };
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
+
+#endif
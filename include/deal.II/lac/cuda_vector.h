@@ -22,6 +22,8 @@
 #include <deal.II/lac/vector_space_vector.h>
 #include <deal.II/lac/vector_operation.h>
 
+#include <utility>
+
 #ifdef DEAL_II_WITH_CUDA
 
 DEAL_II_NAMESPACE_OPEN
@@ -111,6 +113,12 @@ namespace LinearAlgebra
        */
       virtual Vector<Number> &operator= (const Number s) override;
 
+      /**
+       * Copy the elements of @p V on the device. The memory is only
+       * reallocated if the size of the vectors differs.
+       */
+      Vector<Number> &operator= (const Vector<Number> &V);
+
       /**
        * Multiply the entive vector by a fixed factor.
        */
@@ -293,6 +301,58 @@ namespace LinearAlgebra
     {
       return complete_index_set(n_elements);
     }
+
+
+
+    namespace internal
+    {
+      /**
+       * Perform the updates <tt>x += alpha*d</tt> and <tt>g += alpha*h</tt>
+       * of the conjugate gradient method in one kernel and return the
+       * square of the norm of @p g as well as the inner product of @p g with
+       * the entry-wise product of @p diagonal and @p g. If @p diagonal is a
+       * null pointer, the identity is used as preconditioner. Both values
+       * are computed by the same kernel and copied to the host together.
+       */
+      template <typename Number>
+      std::pair<Number,Number>
+      cg_update_solution_and_residual(Vector<Number>       &x,
+                                      Vector<Number>       &g,
+                                      const Vector<Number> &d,
+                                      const Vector<Number> &h,
+                                      const Vector<Number> *diagonal,
+                                      const Number          alpha);
+
+      /**
+       * Compute the new search direction <tt>d = beta*d - P*g</tt> of the
+       * conjugate gradient method, where @p diagonal holds the entries of
+       * the diagonal preconditioner P, or P is the identity if @p diagonal
+       * is a null pointer.
+       */
+      template <typename Number>
+      void
+      cg_update_search_direction(Vector<Number>       &d,
+                                 const Vector<Number> &g,
+                                 const Vector<Number> *diagonal,
+                                 const Number          beta);
+
+      /**
+       * Perform the vector updates of one step of the Chebyshev iteration
+       * with the inverse of the matrix diagonal @p diagonal_inverse in one
+       * kernel, see PreconditionChebyshev. On entry, @p update2 holds the
+       * product of the matrix with @p dst unless @p start_zero is set.
+       */
+      template <typename Number>
+      void
+      chebyshev_vector_updates(const Vector<Number> &src,
+                               const Vector<Number> &diagonal_inverse,
+                               const bool            start_zero,
+                               const Number          factor1,
+                               const Number          factor2,
+                               Vector<Number>       &update1,
+                               const Vector<Number> &update2,
+                               Vector<Number>       &dst);
+    }
   }
 }
 
@@ -23,6 +23,7 @@
 #include <deal.II/lac/exceptions.h>
 #include <deal.II/base/index_set.h>
 
+#include <atomic>
 #include <vector>
 #include <algorithm>
 #include <iostream>
@@ -405,6 +406,92 @@ public:
                     ForwardIterator end,
                     const bool      indices_are_unique_and_sorted = false);
 
+  /**
+   * A class that allows several threads to add entries to the same
+   * DynamicSparsityPattern concurrently, for example from the worker
+   * function of WorkStream::run(). The rows are protected by a fixed number
+   * of mutexes, where the mutex of a row is selected by the remainder of the
+   * row index divided by the number of mutexes. Since different threads
+   * typically work on different parts of the mesh and thus on different
+   * rows, the threads rarely have to wait for each other.
+   *
+   * The class provides the functions of DynamicSparsityPattern needed by
+   * ConstraintMatrix::add_entries_local_to_global(), so an object of this
+   * class can be given to that function in place of the sparsity pattern
+   * itself. While entries are being added through objects of this class, no
+   * other function of the underlying sparsity pattern may be called.
+   */
+  class ThreadSafeInserter
+  {
+  public:
+    /**
+     * Declare the type for container size.
+     */
+    typedef DynamicSparsityPattern::size_type size_type;
+
+    /**
+     * Constructor. Entries are added to the given sparsity pattern.
+     */
+    ThreadSafeInserter (DynamicSparsityPattern &sparsity_pattern);
+
+    /**
+     * Destructor. Makes the entries added through this object known to the
+     * underlying sparsity pattern.
+     */
+    ~ThreadSafeInserter ();
+
+    /**
+     * Return the number of rows of the underlying sparsity pattern.
+     */
+    size_type n_rows () const;
+
+    /**
+     * Return the number of columns of the underlying sparsity pattern.
+     */
+    size_type n_cols () const;
+
+    /**
+     * Add a nonzero entry, like DynamicSparsityPattern::add(). This function
+     * may be called concurrently from several threads.
+     */
+    void add (const size_type i,
+              const size_type j);
+
+    /**
+     * Add several nonzero entries to the specified row, like
+     * DynamicSparsityPattern::add_entries(). This function may be called
+     * concurrently from several threads.
+     */
+    template <typename ForwardIterator>
+    void add_entries (const size_type row,
+                      ForwardIterator begin,
+                      ForwardIterator end,
+                      const bool      indices_are_unique_and_sorted = false);
+
+  private:
+    /**
+     * The number of mutexes protecting the rows.
+     */
+    static const unsigned int n_mutexes = 1024;
+
+    /**
+     * The sparsity pattern entries are added to.
+     */
+    DynamicSparsityPattern &sparsity_pattern;
+
+    /**
+     * The mutexes protecting the rows.
+     */
+    std::vector<Threads::Mutex> mutexes;
+
+    /**
+     * Whether any entries have been added through this object. This
+     * replaces the flag DynamicSparsityPattern::have_entries while adding
+     * entries, which can therefore not be written concurrently.
+     */
+    std::atomic<bool> have_entries;
+  };
+
   /**
    * Check if a value at a certain position may be non-zero.
    */
@@ -981,6 +1068,54 @@ DynamicSparsityPattern::add_entries (const size_type row,
 
 
 
+inline
+DynamicSparsityPattern::size_type
+DynamicSparsityPattern::ThreadSafeInserter::n_rows () const
+{
+  return sparsity_pattern.n_rows();
+}
+
+
+
+inline
+DynamicSparsityPattern::size_type
+DynamicSparsityPattern::ThreadSafeInserter::n_cols () const
+{
+  return sparsity_pattern.n_cols();
+}
+
+
+
+template <typename ForwardIterator>
+inline
+void
+DynamicSparsityPattern::ThreadSafeInserter::add_entries (const size_type row,
+                                                         ForwardIterator begin,
+                                                         ForwardIterator end,
+                                                         const bool      indices_are_sorted)
+{
+  Assert (row < sparsity_pattern.rows,
+          ExcIndexRangeType<size_type> (row, 0, sparsity_pattern.rows));
+
+  if (sparsity_pattern.rowset.size() > 0 &&
+      !sparsity_pattern.rowset.is_element(row))
+    return;
+
+  if (begin == end)
+    return;
+
+  if (!have_entries.load(std::memory_order_relaxed))
+    have_entries.store(true, std::memory_order_relaxed);
+
+  const size_type rowindex = sparsity_pattern.rowset.size()==0 ?
+                             row : sparsity_pattern.rowset.index_within_set(row);
+
+  Threads::Mutex::ScopedLock lock (mutexes[rowindex % n_mutexes]);
+  sparsity_pattern.lines[rowindex].add_entries (begin, end, indices_are_sorted);
+}
+
+
+
 inline
 types::global_dof_index
 DynamicSparsityPattern::row_length (const size_type row) const
@@ -18,6 +18,9 @@
 
 
 #include <deal.II/base/config.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/identity_matrix.h>
+#include <deal.II/lac/lapack_full_matrix.h>
 #include <deal.II/lac/linear_operator.h>
 #include <deal.II/lac/precondition.h>
 #include <deal.II/lac/solver_cg.h>
@@ -27,7 +30,9 @@
 #include <deal.II/lac/solver_minres.h>
 #include <deal.II/lac/vector_memory.h>
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -207,6 +212,168 @@ protected:
   AdditionalData additional_data;
 };
 
+/**
+ * Locally optimal block preconditioned conjugate gradient method (LOBPCG)
+ * for computing the smallest eigenvalues and eigenvectors of a symmetric
+ * generalized eigenvalue problem $Ax = \lambda Bx$ with a symmetric positive
+ * definite matrix $B$, see A. V. Knyazev, "Toward the optimal
+ * preconditioned eigensolver: Locally optimal block preconditioned conjugate
+ * gradient method", SIAM Journal on Scientific Computing 23(2), 2001.
+ *
+ * All the requested eigenpairs are computed together. In each iteration, the
+ * preconditioner is applied to the residuals $Ax_i-\lambda_i Bx_i$ of the
+ * current approximations $x_i$, and the new approximations are the Ritz
+ * vectors of the space spanned by the current approximations, the
+ * preconditioned residuals and the differences to the approximations of the
+ * previous iteration. The preconditioner should approximate the inverse of
+ * $A$ (or of $A-\sigma B$ for a shift $\sigma$ below the wanted eigenvalues),
+ * for example a PreconditionMG object. Since the method only uses the
+ * functions vmult(), add(), operator*() and the like of the vectors and
+ * operators, it works with any vector type, including
+ * LinearAlgebra::distributed::Vector, without copying vectors to an external
+ * library as the ARPACK interfaces do.
+ *
+ * The basis of the search space is made $B$-orthonormal by a modified
+ * Gram-Schmidt process, which drops the directions that are almost linearly
+ * dependent on the others, and the Rayleigh-Ritz problem of at most three
+ * times the number of eigenpairs is solved with
+ * LAPACKFullMatrix::compute_eigenvalues_symmetric(). This class therefore
+ * requires deal.II to be configured with LAPACK. Eigenpairs whose residual
+ * is below the tolerance of the SolverControl object are not extended any
+ * more (soft locking), but remain part of the Rayleigh-Ritz problem. The
+ * iteration stops when all residuals are below the tolerance.
+ *
+ * A typical use is as follows, where the eigenvectors initially contain
+ * linearly independent start vectors, for example random ones:
+ * @code
+ *   SolverControl solver_control (1000, 1e-8);
+ *   GrowingVectorMemory<LinearAlgebra::distributed::Vector<double> > memory;
+ *   EigenLOBPCG<LinearAlgebra::distributed::Vector<double> >
+ *   eigensolver (solver_control, memory);
+ *   eigensolver.solve (stiffness_operator, mass_operator, preconditioner_mg,
+ *                      eigenvalues, eigenvectors);
+ * @endcode
+ */
+template <typename VectorType = Vector<double> >
+class EigenLOBPCG : private Solver<VectorType>
+{
+public:
+  /**
+   * Declare type of container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * Standardized data struct to pipe additional data to the solver.
+   */
+  struct AdditionalData
+  {
+    /**
+     * A search direction is dropped if its $B$-norm after the
+     * orthogonalization against the other directions is less than this
+     * factor times its $B$-norm before.
+     */
+    double dependency_tolerance;
+
+    /**
+     * Constructor.
+     */
+    AdditionalData (const double dependency_tolerance = 1e-10)
+      :
+      dependency_tolerance(dependency_tolerance)
+    {}
+  };
+
+  /**
+   * Constructor.
+   */
+  EigenLOBPCG (SolverControl            &cn,
+               VectorMemory<VectorType> &mem,
+               const AdditionalData     &data=AdditionalData());
+
+  /**
+   * Compute the eigenvalues and eigenvectors of $Ax = \lambda Bx$ for the
+   * smallest <tt>eigenvectors.size()</tt> eigenvalues. On input,
+   * @p eigenvectors contains linearly independent start vectors. On output,
+   * @p eigenvalues contains the eigenvalues in ascending order and
+   * @p eigenvectors the corresponding eigenvectors, normalized to
+   * $x_i^TBx_j=\delta_{ij}$.
+   */
+  template <typename MatrixType, typename MassMatrixType, typename PreconditionerType>
+  void
+  solve (const MatrixType          &A,
+         const MassMatrixType      &B,
+         const PreconditionerType  &preconditioner,
+         std::vector<double>       &eigenvalues,
+         std::vector<VectorType>   &eigenvectors);
+
+  /**
+   * Same as above for the standard eigenvalue problem $Ax = \lambda x$.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve (const MatrixType          &A,
+         const PreconditionerType  &preconditioner,
+         std::vector<double>       &eigenvalues,
+         std::vector<VectorType>   &eigenvectors);
+
+protected:
+  /**
+   * A set of vectors together with their images under $A$ and $B$.
+   */
+  struct Block
+  {
+    std::vector<VectorType> v;
+    std::vector<VectorType> Av;
+    std::vector<VectorType> Bv;
+
+    /**
+     * Resize the block to @p n vectors of the layout of @p model.
+     */
+    void reinit (const unsigned int n,
+                 const VectorType  &model);
+
+    /**
+     * Swap the contents of this block with @p other.
+     */
+    void swap (Block &other);
+  };
+
+  /**
+   * Orthogonalize the vector @p index of @p block with respect to the $B$
+   * inner product against the vectors given by @p basis, @p A_basis and
+   * @p B_basis and normalize it. If the vector is linearly independent of
+   * the basis, it is added to the basis and true is returned.
+   */
+  bool orthonormalize (Block                           &block,
+                       const unsigned int               index,
+                       std::vector<const VectorType *> &basis,
+                       std::vector<const VectorType *> &A_basis,
+                       std::vector<const VectorType *> &B_basis) const;
+
+  /**
+   * Solve the Rayleigh-Ritz problem in the space spanned by @p basis, i.e.,
+   * compute the eigenpairs of the matrix with entries $s_i^TAs_j$ for the
+   * $B$-orthonormal basis $s_i$. Return the smallest <tt>ritz_values.size()</tt>
+   * eigenvalues in @p ritz_values and the coefficients of the Ritz vectors in
+   * the columns of @p coefficients.
+   */
+  void rayleigh_ritz (const std::vector<const VectorType *> &basis,
+                      const std::vector<const VectorType *> &A_basis,
+                      std::vector<double>                   &ritz_values,
+                      FullMatrix<double>                    &coefficients) const;
+
+  /**
+   * Control object, needed for the tolerance of the soft locking.
+   */
+  SolverControl &solver_control;
+
+  /**
+   * Flags for execution.
+   */
+  AdditionalData additional_data;
+};
+
 /*@}*/
 //---------------------------------------------------------------------------
 
@@ -422,6 +589,292 @@ EigenInverse<VectorType>::solve (double           &value,
   // otherwise exit as normal
 }
 
+//---------------------------------------------------------------------------
+
+template <class VectorType>
+void
+EigenLOBPCG<VectorType>::Block::reinit (const unsigned int n,
+                                        const VectorType  &model)
+{
+  v.resize (n);
+  Av.resize (n);
+  Bv.resize (n);
+  for (unsigned int i=0; i<n; ++i)
+    {
+      v[i].reinit (model);
+      Av[i].reinit (model);
+      Bv[i].reinit (model);
+    }
+}
+
+
+
+template <class VectorType>
+void
+EigenLOBPCG<VectorType>::Block::swap (Block &other)
+{
+  v.swap (other.v);
+  Av.swap (other.Av);
+  Bv.swap (other.Bv);
+}
+
+
+
+template <class VectorType>
+EigenLOBPCG<VectorType>::EigenLOBPCG (SolverControl            &cn,
+                                      VectorMemory<VectorType> &mem,
+                                      const AdditionalData     &data)
+  :
+  Solver<VectorType>(cn, mem),
+  solver_control(cn),
+  additional_data(data)
+{}
+
+
+
+template <class VectorType>
+bool
+EigenLOBPCG<VectorType>::orthonormalize (Block                           &block,
+                                         const unsigned int               index,
+                                         std::vector<const VectorType *> &basis,
+                                         std::vector<const VectorType *> &A_basis,
+                                         std::vector<const VectorType *> &B_basis) const
+{
+  VectorType &v = block.v[index];
+  VectorType &Av = block.Av[index];
+  VectorType &Bv = block.Bv[index];
+
+  const double initial_norm = std::sqrt (std::max (v * Bv, 0.));
+  if (initial_norm == 0.)
+    return false;
+
+  // two passes of modified Gram-Schmidt are enough to get orthogonality up
+  // to round-off. The images under A and B are updated alongside, which
+  // avoids applying the operators again
+  for (unsigned int pass=0; pass<2; ++pass)
+    for (unsigned int j=0; j<basis.size(); ++j)
+      {
+        const double coefficient = *B_basis[j] * v;
+        v.add (-coefficient, *basis[j]);
+        Av.add (-coefficient, *A_basis[j]);
+        Bv.add (-coefficient, *B_basis[j]);
+      }
+
+  const double norm = std::sqrt (std::max (v * Bv, 0.));
+  if (norm <= additional_data.dependency_tolerance * initial_norm)
+    return false;
+
+  v *= 1./norm;
+  Av *= 1./norm;
+  Bv *= 1./norm;
+  basis.push_back (&v);
+  A_basis.push_back (&Av);
+  B_basis.push_back (&Bv);
+  return true;
+}
+
+
+
+template <class VectorType>
+void
+EigenLOBPCG<VectorType>::rayleigh_ritz (const std::vector<const VectorType *> &basis,
+                                        const std::vector<const VectorType *> &A_basis,
+                                        std::vector<double>                   &ritz_values,
+                                        FullMatrix<double>                    &coefficients) const
+{
+  const unsigned int m = basis.size();
+  LAPACKFullMatrix<double> projected (m, m);
+  for (unsigned int i=0; i<m; ++i)
+    for (unsigned int j=i; j<m; ++j)
+      {
+        const double entry = *basis[i] * *A_basis[j];
+        projected(i,j) = entry;
+        projected(j,i) = entry;
+      }
+
+  // all eigenvalues lie within the maximal absolute row sum of the matrix
+  double bound = 0.;
+  for (unsigned int i=0; i<m; ++i)
+    {
+      double row_sum = 0.;
+      for (unsigned int j=0; j<m; ++j)
+        row_sum += std::fabs (projected(i,j));
+      bound = std::max (bound, row_sum);
+    }
+  bound = 1.1*bound + std::numeric_limits<double>::min();
+
+  Vector<double> values;
+  projected.compute_eigenvalues_symmetric (-bound, bound,
+                                           2.*std::numeric_limits<double>::min(),
+                                           values, coefficients);
+  AssertThrow (values.size() >= ritz_values.size(),
+               ExcMessage ("The Rayleigh-Ritz problem did not return all "
+                           "requested eigenvalues."));
+  for (unsigned int i=0; i<ritz_values.size(); ++i)
+    ritz_values[i] = values(i);
+}
+
+
+
+template <class VectorType>
+template <typename MatrixType, typename MassMatrixType, typename PreconditionerType>
+void
+EigenLOBPCG<VectorType>::solve (const MatrixType          &A,
+                                const MassMatrixType      &B,
+                                const PreconditionerType  &preconditioner,
+                                std::vector<double>       &eigenvalues,
+                                std::vector<VectorType>   &eigenvectors)
+{
+  LogStream::Prefix prefix("LOBPCG");
+
+  const unsigned int n = eigenvectors.size();
+  Assert (n > 0, ExcMessage ("At least one start vector is needed."));
+
+  // the current approximations X, the preconditioned residuals W, the
+  // search directions P and the new values of X and P, each with their
+  // images under A and B
+  Block X, W, P, X_new, P_new;
+  X.reinit (n, eigenvectors[0]);
+  W.reinit (n, eigenvectors[0]);
+  P.reinit (n, eigenvectors[0]);
+  X_new.reinit (n, eigenvectors[0]);
+  P_new.reinit (n, eigenvectors[0]);
+  unsigned int n_p = 0;
+
+  typename VectorMemory<VectorType>::Pointer Vr (this->memory);
+  VectorType &r = *Vr;
+  r.reinit (eigenvectors[0]);
+
+  std::vector<const VectorType *> basis, A_basis, B_basis;
+  basis.reserve (3*n);
+  A_basis.reserve (3*n);
+  B_basis.reserve (3*n);
+  std::vector<double> ritz_values (n);
+  FullMatrix<double> coefficients;
+
+  // set the new approximations to the Ritz vectors of the current basis,
+  // whose first n vectors are the current approximations, and the new
+  // search directions to their components in the other directions
+  const auto update = [&] ()
+  {
+    rayleigh_ritz (basis, A_basis, ritz_values, coefficients);
+    for (unsigned int i=0; i<n; ++i)
+      {
+        P_new.v[i] = 0.;
+        P_new.Av[i] = 0.;
+        P_new.Bv[i] = 0.;
+        for (unsigned int j=n; j<basis.size(); ++j)
+          {
+            P_new.v[i].add (coefficients(j,i), *basis[j]);
+            P_new.Av[i].add (coefficients(j,i), *A_basis[j]);
+            P_new.Bv[i].add (coefficients(j,i), *B_basis[j]);
+          }
+        X_new.v[i] = P_new.v[i];
+        X_new.Av[i] = P_new.Av[i];
+        X_new.Bv[i] = P_new.Bv[i];
+        for (unsigned int j=0; j<n; ++j)
+          {
+            X_new.v[i].add (coefficients(j,i), X.v[j]);
+            X_new.Av[i].add (coefficients(j,i), X.Av[j]);
+            X_new.Bv[i].add (coefficients(j,i), X.Bv[j]);
+          }
+      }
+    X.swap (X_new);
+    P.swap (P_new);
+  };
+
+  // make the start vectors B-orthonormal and start from their Ritz vectors
+  for (unsigned int i=0; i<n; ++i)
+    {
+      X.v[i] = eigenvectors[i];
+      A.vmult (X.Av[i], X.v[i]);
+      B.vmult (X.Bv[i], X.v[i]);
+      const bool independent = orthonormalize (X, i, basis, A_basis, B_basis);
+      AssertThrow (independent,
+                   ExcMessage ("The start vectors are not linearly independent."));
+    }
+  update ();
+
+  std::vector<unsigned int> active;
+  SolverControl::State conv = SolverControl::iterate;
+  double residual = 0.;
+  unsigned int iter = 0;
+  for (; ; ++iter)
+    {
+      // compute the residuals and apply the preconditioner to those that
+      // are not yet converged
+      active.clear ();
+      residual = 0.;
+      for (unsigned int i=0; i<n; ++i)
+        {
+          r = X.Av[i];
+          r.add (-ritz_values[i], X.Bv[i]);
+          const double norm = r.l2_norm();
+          residual = std::max (residual, norm);
+          if (norm > solver_control.tolerance())
+            {
+              const unsigned int j = active.size();
+              preconditioner.vmult (W.v[j], r);
+              active.push_back (i);
+            }
+        }
+
+      conv = this->iteration_status (iter, residual, X.v[0]);
+      if (conv != SolverControl::iterate)
+        break;
+
+      basis.resize (n);
+      A_basis.resize (n);
+      B_basis.resize (n);
+      for (unsigned int i=0; i<n; ++i)
+        {
+          basis[i] = &X.v[i];
+          A_basis[i] = &X.Av[i];
+          B_basis[i] = &X.Bv[i];
+        }
+
+      for (unsigned int j=0; j<active.size(); ++j)
+        {
+          A.vmult (W.Av[j], W.v[j]);
+          B.vmult (W.Bv[j], W.v[j]);
+          orthonormalize (W, j, basis, A_basis, B_basis);
+        }
+
+      // the search directions of the previous step, for the active vectors
+      // only
+      if (n_p > 0)
+        for (unsigned int j=0; j<active.size(); ++j)
+          orthonormalize (P, active[j], basis, A_basis, B_basis);
+
+      update ();
+      n_p = n;
+    }
+
+  // in case of failure: throw exception
+  AssertThrow (conv == SolverControl::success,
+               SolverControl::NoConvergence (iter, residual));
+
+  // otherwise exit as normal
+  eigenvalues = ritz_values;
+  for (unsigned int i=0; i<n; ++i)
+    eigenvectors[i].swap (X.v[i]);
+}
+
+
+
+template <class VectorType>
+template <typename MatrixType, typename PreconditionerType>
+void
+EigenLOBPCG<VectorType>::solve (const MatrixType          &A,
+                                const PreconditionerType  &preconditioner,
+                                std::vector<double>       &eigenvalues,
+                                std::vector<VectorType>   &eigenvectors)
+{
+  Assert (eigenvectors.size() > 0, ExcMessage ("At least one start vector is needed."));
+  solve (A, IdentityMatrix (eigenvectors[0].size()), preconditioner,
+         eigenvalues, eigenvectors);
+}
+
 DEAL_II_NAMESPACE_CLOSE
 
 #endif
@@ -0,0 +1,423 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_hierarchical_matrix_h
+#define dealii_hierarchical_matrix_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/bounding_box.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/lac/vector.h>
+
+#include <functional>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*! @addtogroup Matrix1
+ *@{
+ */
+
+
+/**
+ * A hierarchical matrix (H-matrix) approximation of a dense matrix whose
+ * entries $a_{ij} = k(x_i,y_j)$ stem from an asymptotically smooth kernel
+ * $k$ evaluated between points $x_i$ associated with the rows and points
+ * $y_j$ associated with the columns, as is typical for boundary element
+ * methods on codimension-one meshes of type Triangulation<dim-1,dim>. Rather
+ * than storing all $m \times n$ entries, blocks of the matrix that
+ * correspond to well-separated groups of points are stored in the low-rank
+ * form $U V^T$, which reduces the memory consumption and the cost of a
+ * matrix-vector product from ${\cal O}(mn)$ to about ${\cal O}((m+n)\log
+ * (m+n))$ for a fixed accuracy.
+ *
+ * <h3>Construction</h3>
+ *
+ * The reinit() function builds a cluster tree for the row and column points
+ * each, by recursively bisecting the BoundingBox of a set of points along its
+ * longest edge until at most AdditionalData::leaf_size points remain. From
+ * the two cluster trees, a block partitioning of the matrix is built: a pair
+ * of clusters $(\tau,\sigma)$ is called admissible if
+ * @f[
+ *   \min(\mathrm{diam}(\tau), \mathrm{diam}(\sigma)) \leq \eta\,
+ *   \mathrm{dist}(\tau,\sigma),
+ * @f]
+ * where $\eta$ is given by AdditionalData::admissibility_parameter and the
+ * diameters and distances are computed from the bounding boxes of the
+ * clusters. Admissible blocks are approximated by adaptive cross
+ * approximation (ACA) with partial pivoting, which only evaluates the kernel
+ * for a few rows and columns of the block, up to a relative accuracy of
+ * AdditionalData::aca_tolerance in the Frobenius norm. Inadmissible blocks
+ * are subdivided further, and stored as dense matrices on the leaves of the
+ * cluster trees. Blocks for which the low-rank representation would not save
+ * memory are also stored as dense matrices.
+ *
+ * The matrix entries are provided by a function object that is called with
+ * the row and column index. The blocks are set up in parallel, so this
+ * function object must be safe to call from several threads at the same
+ * time.
+ *
+ * <h3>Usage</h3>
+ *
+ * Objects of this class provide the functions vmult(), Tvmult(), vmult_add(),
+ * and Tvmult_add() on Vector objects, and can therefore be used with the
+ * iterative solvers and wrapped into a LinearOperator. For a single-layer
+ * potential with support points obtained, for example, from
+ * DoFTools::map_dofs_to_support_points(), a typical use looks as follows:
+ * @code
+ *   std::vector<Point<3> > support_points (dof_handler.n_dofs());
+ *   DoFTools::map_dofs_to_support_points (mapping, dof_handler, support_points);
+ *
+ *   HierarchicalMatrix<3> matrix;
+ *   matrix.reinit (support_points, support_points,
+ *                  [&](const unsigned int i, const unsigned int j)
+ *                  {
+ *                    return compute_single_layer_entry (i, j);
+ *                  });
+ *
+ *   const auto op = linear_operator (matrix);
+ *   SolverGMRES<Vector<double> > solver (solver_control);
+ *   solver.solve (op, solution, rhs, PreconditionIdentity());
+ * @endcode
+ *
+ * @tparam spacedim The dimension of the space the points live in.
+ *
+ * @tparam Number The type of the matrix entries, float or double.
+ */
+template <int spacedim, typename Number = double>
+class HierarchicalMatrix : public Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * Type of matrix entries.
+   */
+  typedef Number value_type;
+
+  /**
+   * Collection of parameters for the construction of the matrix.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor.
+     */
+    AdditionalData (const unsigned int leaf_size               = 32,
+                    const double       admissibility_parameter = 1.,
+                    const double       aca_tolerance           = 1e-6,
+                    const unsigned int max_rank                = numbers::invalid_unsigned_int);
+
+    /**
+     * The maximal number of points in a leaf of the cluster trees. This is
+     * also the maximal size of the dense blocks.
+     */
+    unsigned int leaf_size;
+
+    /**
+     * The parameter $\eta$ of the admissibility condition. Larger values
+     * allow more blocks to be approximated by low-rank matrices, at the cost
+     * of higher ranks.
+     */
+    double admissibility_parameter;
+
+    /**
+     * The relative accuracy in the Frobenius norm up to which admissible
+     * blocks are approximated by the adaptive cross approximation.
+     */
+    double aca_tolerance;
+
+    /**
+     * The maximal rank of the low-rank blocks. Blocks that do not reach the
+     * requested accuracy with this rank are stored as dense blocks.
+     */
+    unsigned int max_rank;
+  };
+
+  /**
+   * Constructor. Creates an empty matrix.
+   */
+  HierarchicalMatrix ();
+
+  /**
+   * Set up the matrix of size <tt>row_points.size()</tt> times
+   * <tt>column_points.size()</tt>, with the entry in row $i$ and column $j$
+   * given by <tt>matrix_entry(i,j)</tt>. The point <tt>row_points[i]</tt> is
+   * the location associated with row $i$ and determines the clustering of
+   * the rows, and similarly for the columns.
+   */
+  void reinit (const std::vector<Point<spacedim> >                       &row_points,
+               const std::vector<Point<spacedim> >                       &column_points,
+               const std::function<Number (const size_type, const size_type)> &matrix_entry,
+               const AdditionalData &additional_data = AdditionalData());
+
+  /**
+   * Release all memory and return to a state just like after having called
+   * the default constructor.
+   */
+  void clear ();
+
+  /**
+   * Return the number of rows of the matrix.
+   */
+  size_type m () const;
+
+  /**
+   * Return the number of columns of the matrix.
+   */
+  size_type n () const;
+
+  /**
+   * Matrix-vector multiplication: let $dst = M*src$ with $M$ being this
+   * matrix.
+   */
+  void vmult (Vector<Number>       &dst,
+              const Vector<Number> &src) const;
+
+  /**
+   * Adding matrix-vector multiplication: add $M*src$ to $dst$ with $M$ being
+   * this matrix.
+   */
+  void vmult_add (Vector<Number>       &dst,
+                  const Vector<Number> &src) const;
+
+  /**
+   * Matrix-vector multiplication with the transpose matrix: let
+   * $dst = M^T*src$ with $M$ being this matrix.
+   */
+  void Tvmult (Vector<Number>       &dst,
+               const Vector<Number> &src) const;
+
+  /**
+   * Adding matrix-vector multiplication with the transpose matrix: add
+   * $M^T*src$ to $dst$ with $M$ being this matrix.
+   */
+  void Tvmult_add (Vector<Number>       &dst,
+                   const Vector<Number> &src) const;
+
+  /**
+   * Return the number of blocks stored as dense matrices.
+   */
+  unsigned int n_dense_blocks () const;
+
+  /**
+   * Return the number of blocks stored in low-rank form.
+   */
+  unsigned int n_low_rank_blocks () const;
+
+  /**
+   * Return the number of values stored for the representation of the
+   * matrix, i.e., the sum of the dense block sizes and the sizes of the
+   * low-rank factors. The ratio of this number and m()*n() gives the
+   * compression relative to a dense matrix.
+   */
+  std::size_t n_stored_values () const;
+
+  /**
+   * Return an estimate of the memory consumption of this object in bytes.
+   */
+  std::size_t memory_consumption () const;
+
+  /**
+   * @addtogroup Exceptions
+   * @{
+   */
+
+  /**
+   * Exception
+   */
+  DeclExceptionMsg (ExcEmptyCluster,
+                    "The matrix must have at least one row and one column.");
+  //@}
+
+private:
+  /**
+   * A node of a cluster tree. It describes the points
+   * <tt>permutation[begin]</tt> to <tt>permutation[end-1]</tt> of the
+   * respective permutation, which are contained in @p box.
+   */
+  struct Cluster
+  {
+    /**
+     * First index in the permutation.
+     */
+    unsigned int begin;
+
+    /**
+     * One past the last index in the permutation.
+     */
+    unsigned int end;
+
+    /**
+     * The bounding box of the points of the cluster.
+     */
+    BoundingBox<spacedim> box;
+
+    /**
+     * The indices of the two children in the cluster array, or
+     * numbers::invalid_unsigned_int for a leaf.
+     */
+    unsigned int children[2];
+  };
+
+  /**
+   * A block of the matrix, coupling the rows of one cluster with the columns
+   * of another one. Dense blocks are stored in @p dense in row-major order.
+   * Low-rank blocks $U V^T$ are stored by the columns of $U$ in @p u and the
+   * columns of $V$ in @p v.
+   */
+  struct Block
+  {
+    /**
+     * Index of the row cluster.
+     */
+    unsigned int row_cluster;
+
+    /**
+     * Index of the column cluster.
+     */
+    unsigned int column_cluster;
+
+    /**
+     * Whether the block is admissible, i.e., stored in low-rank form if
+     * the approximation was successful.
+     */
+    bool is_low_rank;
+
+    /**
+     * The rank of a low-rank block.
+     */
+    unsigned int rank;
+
+    /**
+     * The entries of a dense block.
+     */
+    std::vector<Number> dense;
+
+    /**
+     * The factor $U$ of a low-rank block.
+     */
+    std::vector<Number> u;
+
+    /**
+     * The factor $V$ of a low-rank block.
+     */
+    std::vector<Number> v;
+  };
+
+  /**
+   * Build the cluster tree for the given points and store the nodes in
+   * @p clusters, with the root in the first position, and the ordering of
+   * the points in @p permutation.
+   */
+  void build_cluster_tree (const std::vector<Point<spacedim> > &points,
+                           std::vector<Cluster>                &clusters,
+                           std::vector<unsigned int>           &permutation) const;
+
+  /**
+   * Recursively partition the block given by the two clusters into
+   * admissible and dense blocks, and append them to the list of blocks.
+   */
+  void build_block_tree (const unsigned int row_cluster,
+                         const unsigned int column_cluster);
+
+  /**
+   * Compute the entries of the given block, either by the adaptive cross
+   * approximation for admissible blocks or by evaluating all entries
+   * otherwise.
+   */
+  void compute_block (Block &block) const;
+
+  /**
+   * Add the product of the matrix or its transpose with a vector in the
+   * ordering of the cluster trees to @p dst.
+   */
+  void apply_add (Number       *dst,
+                  const Number *src,
+                  const bool    transpose) const;
+
+  /**
+   * The parameters used for the construction.
+   */
+  AdditionalData additional_data;
+
+  /**
+   * The function providing the matrix entries. Only used during the setup.
+   */
+  std::function<Number (const size_type, const size_type)> matrix_entry;
+
+  /**
+   * The cluster tree of the rows.
+   */
+  std::vector<Cluster> row_clusters;
+
+  /**
+   * The cluster tree of the columns.
+   */
+  std::vector<Cluster> column_clusters;
+
+  /**
+   * The original row index of each position in the row cluster ordering.
+   */
+  std::vector<unsigned int> row_permutation;
+
+  /**
+   * The original column index of each position in the column cluster
+   * ordering.
+   */
+  std::vector<unsigned int> column_permutation;
+
+  /**
+   * The blocks the matrix is partitioned into.
+   */
+  std::vector<Block> blocks;
+};
+
+/*@}*/
+
+
+#ifndef DOXYGEN
+/* ---------------------------- Inline functions ---------------------------- */
+
+
+template <int spacedim, typename Number>
+inline
+typename HierarchicalMatrix<spacedim,Number>::size_type
+HierarchicalMatrix<spacedim,Number>::m () const
+{
+  return row_permutation.size();
+}
+
+
+
+template <int spacedim, typename Number>
+inline
+typename HierarchicalMatrix<spacedim,Number>::size_type
+HierarchicalMatrix<spacedim,Number>::n () const
+{
+  return column_permutation.size();
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
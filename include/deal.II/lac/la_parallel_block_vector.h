@@ -297,6 +297,9 @@ namespace LinearAlgebra
        * the value on the owning processor and an exception is thrown if these
        * elements do not agree.
        *
+       * For VectorOperation::add, the data of all blocks destined for a
+       * given processor is sent in a single message, i.e., the number of
+       * messages does not grow with the number of blocks.
        */
       virtual void compress (::dealii::VectorOperation::values operation) override;
 
@@ -307,6 +310,10 @@ namespace LinearAlgebra
        * ghost data is changed. This is needed to allow functions with a @p
        * const vector to perform the data exchange without creating
        * temporaries.
+       *
+       * The data of all blocks sent from one processor to another is
+       * combined into a single message, i.e., the number of messages does
+       * not grow with the number of blocks.
        */
       void update_ghost_values () const;
 
@@ -599,6 +606,14 @@ namespace LinearAlgebra
        */
       DeclException0 (ExcIteratorRangeDoesNotMatchVectorSize);
       //@}
+
+    private:
+      /**
+       * Return whether the data exchange of all blocks can be combined into
+       * a single message per pair of processors, which is the case when all
+       * blocks live on the same MPI communicator.
+       */
+      bool can_merge_messages () const;
     };
 
     /*@}*/
@@ -24,6 +24,8 @@
 #include <deal.II/lac/lapack_support.h>
 #include <deal.II/lac/vector.h>
 
+#include <map>
+
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -237,10 +239,158 @@ namespace LinearAlgebra
 
 
 
+    template <typename Number>
+    bool
+    BlockVector<Number>::can_merge_messages () const
+    {
+#ifdef DEAL_II_WITH_MPI
+      if (this->n_blocks() < 2 ||
+          Utilities::MPI::job_supports_mpi() == false)
+        return false;
+      for (unsigned int block=1; block<this->n_blocks(); ++block)
+        if (this->block(block).get_mpi_communicator() !=
+            this->block(0).get_mpi_communicator())
+          return false;
+      return true;
+#else
+      return false;
+#endif
+    }
+
+
+
     template <typename Number>
     void
     BlockVector<Number>::compress (::dealii::VectorOperation::values operation)
     {
+#ifdef DEAL_II_WITH_MPI
+      // for addition, send the ghost data of all blocks to a given processor
+      // in a single message. the message to a processor is made up of the
+      // ghost entries owned by that processor of each block in turn, and the
+      // receiver knows which of its entries the data belongs to from the
+      // import indices of its partitioners. for insertion, the blocks
+      // usually do not communicate at all, so go through the blocks below
+      if (operation == ::dealii::VectorOperation::add && can_merge_messages())
+        {
+          const unsigned int n_blocks = this->n_blocks();
+          const MPI_Comm &communicator = this->block(0).get_mpi_communicator();
+          const unsigned int my_pid = this->block(0).partitioner->this_mpi_process();
+
+          std::map<unsigned int, std::size_t> send_sizes, receive_sizes;
+          for (unsigned int block=0; block<n_blocks; ++block)
+            {
+              Assert (this->block(block).vector_is_ghosted == false,
+                      ExcMessage ("Cannot call compress() on a ghosted vector"));
+              Assert (this->block(block).compress_requests.empty(),
+                      ExcMessage("Another compress operation seems to still be "
+                                 "running. Call compress_finish() first."));
+              const Utilities::MPI::Partitioner &part = *this->block(block).partitioner;
+              for (const auto &target : part.ghost_targets())
+                send_sizes[target.first] += target.second;
+              for (const auto &target : part.import_targets())
+                receive_sizes[target.first] += target.second;
+            }
+
+          std::size_t n_send = 0, n_receive = 0;
+          for (const auto &size : send_sizes)
+            n_send += size.second;
+          for (const auto &size : receive_sizes)
+            n_receive += size.second;
+          std::vector<Number> send_data (n_send), receive_data (n_receive);
+          std::vector<MPI_Request> requests (send_sizes.size() +
+                                             receive_sizes.size());
+
+          // use the same communication channel as the per-block transfers
+          // in LA::distributed::Vector shifted by an arbitrary number
+          const unsigned int channel = 8273 + 401;
+
+          Number *receive_ptr = receive_data.data();
+          unsigned int request = 0;
+          for (const auto &size : receive_sizes)
+            {
+              AssertThrow (size.second*sizeof(Number) <
+                           static_cast<std::size_t>(std::numeric_limits<int>::max()),
+                           ExcMessage("Index overflow: Maximum message size in MPI is 2GB."));
+              const int ierr = MPI_Irecv (receive_ptr, size.second*sizeof(Number),
+                                          MPI_BYTE, size.first, size.first + channel,
+                                          communicator, &requests[request++]);
+              AssertThrowMPI (ierr);
+              receive_ptr += size.second;
+            }
+
+          // the ghost entries of each block are stored contiguously by owner,
+          // ordered by increasing rank like the entries of the map
+          std::vector<unsigned int> target (n_blocks, 0), ghost_offset (n_blocks, 0);
+          Number *send_ptr = send_data.data();
+          for (const auto &size : send_sizes)
+            {
+              Number *const start = send_ptr;
+              for (unsigned int block=0; block<n_blocks; ++block)
+                {
+                  const Vector<Number> &v = this->block(block);
+                  const auto &targets = v.partitioner->ghost_targets();
+                  if (target[block] < targets.size() &&
+                      targets[target[block]].first == size.first)
+                    {
+                      const unsigned int n = targets[target[block]].second;
+                      const Number *ghosts = v.values.get() + v.partitioner->local_size() +
+                                             ghost_offset[block];
+                      send_ptr = std::copy (ghosts, ghosts+n, send_ptr);
+                      ghost_offset[block] += n;
+                      ++target[block];
+                    }
+                }
+              AssertDimension (static_cast<std::size_t>(send_ptr-start), size.second);
+              const int ierr = MPI_Isend (start, size.second*sizeof(Number),
+                                          MPI_BYTE, size.first, my_pid + channel,
+                                          communicator, &requests[request++]);
+              AssertThrowMPI (ierr);
+            }
+
+          if (requests.size() > 0)
+            {
+              const int ierr = MPI_Waitall (requests.size(), requests.data(),
+                                            MPI_STATUSES_IGNORE);
+              AssertThrowMPI (ierr);
+            }
+
+          // add the received data to the locally owned entries, walking
+          // through the import indices of each block that belong to the
+          // respective processor
+          std::fill (target.begin(), target.end(), 0);
+          std::vector<unsigned int> range (n_blocks, 0);
+          const Number *read_ptr = receive_data.data();
+          for (const auto &size : receive_sizes)
+            {
+              const Number *const start = read_ptr;
+              for (unsigned int block=0; block<n_blocks; ++block)
+                {
+                  Vector<Number> &v = this->block(block);
+                  const auto &targets = v.partitioner->import_targets();
+                  if (target[block] < targets.size() &&
+                      targets[target[block]].first == size.first)
+                    {
+                      const auto &import_indices = v.partitioner->import_indices();
+                      for (unsigned int n = targets[target[block]].second; n>0; ++range[block])
+                        {
+                          const auto &indices = import_indices[range[block]];
+                          Assert (indices.second-indices.first <= n, ExcInternalError());
+                          for (unsigned int j=indices.first; j<indices.second; ++j)
+                            v.values[j] += *read_ptr++;
+                          n -= indices.second-indices.first;
+                        }
+                      ++target[block];
+                    }
+                }
+              AssertDimension (static_cast<std::size_t>(read_ptr-start), size.second);
+            }
+
+          for (unsigned int block=0; block<n_blocks; ++block)
+            this->block(block).zero_out_ghosts();
+          return;
+        }
+#endif
+
       // start all requests for all blocks before finishing the transfers as
       // this saves repeated synchronizations. In order to avoid conflict with
       // possible other ongoing communication requests (from
@@ -258,6 +408,130 @@ namespace LinearAlgebra
     void
     BlockVector<Number>::update_ghost_values () const
     {
+#ifdef DEAL_II_WITH_MPI
+      // send the locally owned data of all blocks needed by a given
+      // processor in a single message, made up of the data of each block in
+      // turn. the receiver knows where the entries go from the ghost targets
+      // of its partitioners, which are ordered by increasing rank
+      if (can_merge_messages())
+        {
+          const unsigned int n_blocks = this->n_blocks();
+          const MPI_Comm &communicator = this->block(0).get_mpi_communicator();
+          const unsigned int my_pid = this->block(0).partitioner->this_mpi_process();
+
+          std::map<unsigned int, std::size_t> send_sizes, receive_sizes;
+          for (unsigned int block=0; block<n_blocks; ++block)
+            {
+              Assert (this->block(block).update_ghost_values_requests.empty(),
+                      ExcMessage("Another operation seems to still be running. "
+                                 "Call update_ghost_values_finish() first."));
+              const Utilities::MPI::Partitioner &part = *this->block(block).partitioner;
+              for (const auto &target : part.import_targets())
+                send_sizes[target.first] += target.second;
+              for (const auto &target : part.ghost_targets())
+                receive_sizes[target.first] += target.second;
+            }
+
+          std::size_t n_send = 0, n_receive = 0;
+          for (const auto &size : send_sizes)
+            n_send += size.second;
+          for (const auto &size : receive_sizes)
+            n_receive += size.second;
+          std::vector<Number> send_data (n_send), receive_data (n_receive);
+          std::vector<MPI_Request> requests (send_sizes.size() +
+                                             receive_sizes.size());
+
+          // In order to avoid conflict with possible other ongoing
+          // communication requests, add an arbitrary number 9923 to the
+          // communication tag as for the per-block transfers below
+          const unsigned int channel = 9923;
+
+          Number *receive_ptr = receive_data.data();
+          unsigned int request = 0;
+          for (const auto &size : receive_sizes)
+            {
+              AssertThrow (size.second*sizeof(Number) <
+                           static_cast<std::size_t>(std::numeric_limits<int>::max()),
+                           ExcMessage("Index overflow: Maximum message size in MPI is 2GB."));
+              const int ierr = MPI_Irecv (receive_ptr, size.second*sizeof(Number),
+                                          MPI_BYTE, size.first, size.first + channel,
+                                          communicator, &requests[request++]);
+              AssertThrowMPI (ierr);
+              receive_ptr += size.second;
+            }
+
+          // pack the data for each processor, walking through the import
+          // indices of each block that belong to the respective processor
+          std::vector<unsigned int> target (n_blocks, 0), range (n_blocks, 0);
+          Number *send_ptr = send_data.data();
+          for (const auto &size : send_sizes)
+            {
+              Number *const start = send_ptr;
+              for (unsigned int block=0; block<n_blocks; ++block)
+                {
+                  const Vector<Number> &v = this->block(block);
+                  const auto &targets = v.partitioner->import_targets();
+                  if (target[block] < targets.size() &&
+                      targets[target[block]].first == size.first)
+                    {
+                      const auto &import_indices = v.partitioner->import_indices();
+                      for (unsigned int n = targets[target[block]].second; n>0; ++range[block])
+                        {
+                          const auto &indices = import_indices[range[block]];
+                          Assert (indices.second-indices.first <= n, ExcInternalError());
+                          for (unsigned int j=indices.first; j<indices.second; ++j)
+                            *send_ptr++ = v.values[j];
+                          n -= indices.second-indices.first;
+                        }
+                      ++target[block];
+                    }
+                }
+              AssertDimension (static_cast<std::size_t>(send_ptr-start), size.second);
+              const int ierr = MPI_Isend (start, size.second*sizeof(Number),
+                                          MPI_BYTE, size.first, my_pid + channel,
+                                          communicator, &requests[request++]);
+              AssertThrowMPI (ierr);
+            }
+
+          if (requests.size() > 0)
+            {
+              const int ierr = MPI_Waitall (requests.size(), requests.data(),
+                                            MPI_STATUSES_IGNORE);
+              AssertThrowMPI (ierr);
+            }
+
+          // distribute the received data into the ghost ranges of the blocks
+          std::fill (target.begin(), target.end(), 0);
+          std::vector<unsigned int> ghost_offset (n_blocks, 0);
+          const Number *read_ptr = receive_data.data();
+          for (const auto &size : receive_sizes)
+            {
+              const Number *const start = read_ptr;
+              for (unsigned int block=0; block<n_blocks; ++block)
+                {
+                  const Vector<Number> &v = this->block(block);
+                  const auto &targets = v.partitioner->ghost_targets();
+                  if (target[block] < targets.size() &&
+                      targets[target[block]].first == size.first)
+                    {
+                      const unsigned int n = targets[target[block]].second;
+                      std::copy (read_ptr, read_ptr+n,
+                                 v.values.get() + v.partitioner->local_size() +
+                                 ghost_offset[block]);
+                      read_ptr += n;
+                      ghost_offset[block] += n;
+                      ++target[block];
+                    }
+                }
+              AssertDimension (static_cast<std::size_t>(read_ptr-start), size.second);
+            }
+
+          for (unsigned int block=0; block<n_blocks; ++block)
+            this->block(block).vector_is_ghosted = true;
+          return;
+        }
+#endif
+
       // In order to avoid conflict with possible other ongoing communication
       // requests (from LA::distributed::Vector that supports unfinished
       // requests), add an arbitrary number 9923 to the communication tag
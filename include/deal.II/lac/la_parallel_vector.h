@@ -17,6 +17,8 @@
 #define dealii_la_parallel_vector_h
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/memory_space.h>
+#include <deal.II/base/memory_tracker.h>
 #include <deal.II/base/mpi.h>
 #include <deal.II/base/numbers.h>
 #include <deal.II/base/partitioner.h>
@@ -25,8 +27,10 @@
 #include <deal.II/lac/vector_space_vector.h>
 #include <deal.II/lac/vector_type_traits.h>
 
+#include <complex>
 #include <iomanip>
 #include <memory>
+#include <type_traits>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -302,6 +306,33 @@ namespace LinearAlgebra
        */
       void reinit (const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner);
 
+      /**
+       * Initialize the vector given to the parallel partitioning described in
+       * @p partitioner, and allocate the entries of all processes in the
+       * shared-memory communicator @p comm_sm in an MPI-3 shared memory
+       * window. @p comm_sm must contain processes of the communicator of @p
+       * partitioner that can access each other's memory, typically obtained
+       * by <code>MPI_Comm_split_type(communicator, MPI_COMM_TYPE_SHARED,
+       * ...)</code>, and must stay valid as long as the vector is used.
+       *
+       * In update_ghost_values() and update_ghost_values_start(), the ghost
+       * entries owned by a process in @p comm_sm are then copied directly from
+       * the memory of that process instead of being sent through MPI, and
+       * only the ghost entries owned by processes on other nodes are
+       * exchanged with MPI messages. The two processes synchronize with empty
+       * messages, so the locally owned entries of a vector must not be
+       * modified between update_ghost_values_start() and
+       * update_ghost_values_finish(). compress() is not affected.
+       *
+       * Vectors initialized from this vector by the copy constructor or
+       * reinit(const Vector<Number2>&, const bool) also use shared memory.
+       * The initialization and the destruction of the vector are collective
+       * operations on @p comm_sm. Without MPI, this function is the same as
+       * reinit(partitioner).
+       */
+      void reinit (const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner,
+                   const MPI_Comm                                             comm_sm);
+
       /**
        * Swap the contents of this vector and the other vector @p v. One could
        * do this operation with a temporary variable and copying over the data
@@ -467,6 +498,16 @@ namespace LinearAlgebra
        */
       void compress_finish (::dealii::VectorOperation::values operation);
 
+      /**
+       * Test whether the requests initiated in compress_start() have
+       * completed, without waiting for them. Many MPI implementations only
+       * advance the transfer of messages inside calls to MPI, so calling this
+       * function from time to time between compress_start() and
+       * compress_finish() lets the communication proceed while the calling
+       * code does other work. compress_finish() must still be called.
+       */
+      void compress_progress ();
+
       /**
        * Initiates communication for the @p update_ghost_values() function
        * with non-blocking communication. This function does not wait for the
@@ -493,6 +534,41 @@ namespace LinearAlgebra
        */
       void update_ghost_values_finish () const;
 
+      /**
+       * Test whether the requests initiated in update_ghost_values_start()
+       * have completed, without waiting for them, in order to let the MPI
+       * implementation advance the transfer, see compress_progress().
+       * update_ghost_values_finish() must still be called.
+       */
+      void update_ghost_values_progress () const;
+
+      /**
+       * Select whether update_ghost_values() and update_ghost_values_start()
+       * send the ghost entries in reduced precision, i.e., as @p float for
+       * vectors of @p double and as <code>std::complex&lt;float&gt;</code>
+       * for vectors of <code>std::complex&lt;double&gt;</code>. This halves
+       * the volume of the messages, at the price that the ghost entries only
+       * carry the accuracy of the reduced type, which is often sufficient
+       * e.g. for the smoothers in a multigrid method. The locally owned
+       * entries and compress() are not affected. For vectors of other number
+       * types, the setting has no effect.
+       *
+       * Vectors that are initialized from this vector by the copy constructor
+       * or reinit(const Vector<Number2>&, const bool) inherit the setting.
+       * The exchange in reduced precision does not use persistent MPI
+       * requests, see
+       * Utilities::MPI::Partitioner::set_persistent_communication(). The
+       * setting must not be changed between update_ghost_values_start() and
+       * update_ghost_values_finish().
+       */
+      void set_reduced_precision_ghost_exchange (const bool use_reduced_precision);
+
+      /**
+       * Return whether the ghost entries are exchanged in reduced precision,
+       * see set_reduced_precision_ghost_exchange().
+       */
+      bool uses_reduced_precision_ghost_exchange () const;
+
       /**
        * This method zeros the entries on ghost dofs, but does not touch
        * locally owned DoFs.
@@ -755,6 +831,41 @@ namespace LinearAlgebra
       void equ (const Number a, const Vector<Number> &u,
                 const Number b, const Vector<Number> &v);
 
+      /**
+       * Start the computation of the inner product of this vector with @p V
+       * and return an object from which the result can be obtained with
+       * Utilities::MPI::ReductionFuture::get(). The local part of the inner
+       * product is computed immediately, whereas the global sum over all
+       * processors is performed in the background with a non-blocking
+       * reduction. This allows to overlap the latency of the reduction with
+       * other work, such as the application of a preconditioner, which is
+       * the basis of pipelined Krylov methods.
+       *
+       * This is a collective operation: All processors must call this
+       * function, and the non-blocking reductions on the communicator of
+       * this vector must be started in the same order on all processors.
+       */
+      Utilities::MPI::ReductionFuture<Number>
+      inner_product_async (const Vector<Number> &V) const;
+
+      /**
+       * Non-blocking variant of norm_sqr(), see inner_product_async() for
+       * details.
+       */
+      Utilities::MPI::ReductionFuture<real_type>
+      norm_sqr_async () const;
+
+      /**
+       * Non-blocking variant of add_and_dot(): The vector update is
+       * performed immediately, whereas the global sum of the inner product
+       * is performed in the background. See inner_product_async() for
+       * details.
+       */
+      Utilities::MPI::ReductionFuture<Number>
+      add_and_dot_async (const Number          a,
+                         const Vector<Number> &V,
+                         const Vector<Number> &W);
+
       //@}
 
 
@@ -1113,7 +1224,8 @@ namespace LinearAlgebra
        *
        * Because we allocate these arrays via Utilities::System::posix_memalign,
        * we need to use a custom deleter for this object that does not call
-       * <code>delete[]</code>, but instead calls @p free().
+       * <code>delete[]</code>, but instead calls MemoryTracker::free(), which
+   * releases the memory with @p free().
        */
       std::unique_ptr<Number[], decltype(&free)> values;
 
@@ -1139,6 +1251,20 @@ namespace LinearAlgebra
        */
       mutable bool vector_is_ghosted;
 
+      /**
+       * Stores whether ghost entries are exchanged in reduced precision, see
+       * set_reduced_precision_ghost_exchange().
+       */
+      bool reduced_precision_ghost_exchange;
+
+      /**
+       * The type in which the ghost entries are sent when
+       * reduced_precision_ghost_exchange is set.
+       */
+      typedef typename std::conditional<std::is_same<Number,double>::value, float,
+              typename std::conditional<std::is_same<Number,std::complex<double> >::value,
+              std::complex<float>, Number>::type>::type reduced_precision_type;
+
 #ifdef DEAL_II_WITH_MPI
       /**
        * A vector that collects all requests from @p compress() operations.
@@ -1155,6 +1281,101 @@ namespace LinearAlgebra
        * operations. This class uses persistent MPI communicators.
        */
       mutable std::vector<MPI_Request>   update_ghost_values_requests;
+
+      /**
+       * Persistent MPI requests for @p update_ghost_values(), used when the
+       * partitioner selects persistent communication, see
+       * Utilities::MPI::Partitioner::set_persistent_communication(). The
+       * requests are bound to the memory of this vector and are set up at
+       * the first update of the ghost values, and again when a different
+       * communication channel is requested. They are released in the reinit
+       * functions.
+       */
+      mutable std::vector<MPI_Request>   persistent_update_ghost_values_requests;
+
+      /**
+       * The communication channel the persistent requests were set up for.
+       */
+      mutable unsigned int               persistent_update_ghost_values_channel;
+
+      /**
+       * Stores whether an exchange through the persistent requests has been
+       * started in @p update_ghost_values_start() and not yet been finished.
+       */
+      mutable bool                       persistent_update_ghost_values_active;
+#endif
+
+#ifdef DEAL_II_WITH_MPI
+      /**
+       * The data of a vector whose entries are allocated in an MPI-3 shared
+       * memory window, see reinit(partitioner, comm_sm).
+       */
+      struct SharedMemoryData
+      {
+        /**
+         * A contiguous range of ghost entries that is copied from the
+         * locally owned entries of a process in the shared-memory
+         * communicator.
+         */
+        struct GhostRange
+        {
+          unsigned int ghost_index;
+          unsigned int sm_rank;
+          unsigned int owner_index;
+          unsigned int n_entries;
+        };
+
+        /**
+         * The shared-memory communicator the window is allocated on.
+         */
+        MPI_Comm comm_sm;
+
+        /**
+         * The MPI window holding the entries of all processes in @p comm_sm.
+         */
+        MPI_Win window;
+
+        /**
+         * Pointers to the entries of the processes in @p comm_sm, indexed by
+         * the rank within @p comm_sm.
+         */
+        std::vector<const Number *> sm_values;
+
+        /**
+         * The ghost entries that are owned by processes in @p comm_sm.
+         */
+        std::vector<GhostRange> ghost_ranges;
+
+        /**
+         * The ranks (within the communicator of the partitioner) in @p
+         * comm_sm that own ghost entries of this process and that hold ghost
+         * entries owned by this process, respectively.
+         */
+        std::vector<unsigned int> sm_ghost_owners;
+        std::vector<unsigned int> sm_ghost_readers;
+
+        /**
+         * A partitioner that only contains the ghost entries owned by
+         * processes outside of @p comm_sm, set up with the ghost indices of
+         * the vector as the larger set, such that the data exchanged through
+         * MPI is placed at the right positions of the ghost array.
+         */
+        std::shared_ptr<const Utilities::MPI::Partitioner> off_node_partitioner;
+
+        /**
+         * The requests of the empty messages that synchronize the processes
+         * in @p comm_sm, and the communication channel they were started
+         * for.
+         */
+        std::vector<MPI_Request> requests;
+        unsigned int             channel;
+      };
+
+      /**
+       * The shared memory data of this vector, or an empty pointer if the
+       * entries are allocated by the vector itself.
+       */
+      std::unique_ptr<SharedMemoryData> shared_memory;
 #endif
 
       /**
@@ -1165,8 +1386,10 @@ namespace LinearAlgebra
       mutable Threads::Mutex mutex;
 
       /**
-       * A helper function that clears the compress_requests and
-       * update_ghost_values_requests field. Used in reinit functions.
+       * A helper function that clears the compress_requests,
+       * update_ghost_values_requests, and
+       * persistent_update_ghost_values_requests fields. Used in reinit
+       * functions.
        */
       void clear_mpi_requests ();
 
@@ -1175,6 +1398,12 @@ namespace LinearAlgebra
        */
       void resize_val (const size_type new_allocated_size);
 
+      /**
+       * A helper function that frees the shared memory window of the
+       * entries, if any, and returns the vector to an unallocated state.
+       */
+      void release_shared_memory ();
+
       /*
        * Make all other vector types friends.
        */
@@ -1505,6 +1734,41 @@ namespace LinearAlgebra
 
 #endif
 
+
+
+    /**
+     * Select the type of a vector whose locally owned elements and ghost
+     * elements are described by a Utilities::MPI::Partitioner and reside in
+     * the memory space @p MemorySpace, i.e., MemorySpace::Host or
+     * MemorySpace::CUDA. This allows to write solvers and operators once
+     * and run them on either memory space:
+     * @code
+     *   template <typename MemorySpace>
+     *   void solve(...)
+     *   {
+     *     typedef typename LinearAlgebra::distributed::VectorInMemorySpace
+     *       <double,MemorySpace>::type VectorType;
+     *     VectorType solution, rhs;
+     *     matrix_free.initialize_dof_vector(solution);
+     *     ...
+     *     SolverCG<VectorType> solver(control);
+     *     solver.solve(matrix, solution, rhs, preconditioner);
+     *   }
+     * @endcode
+     * For the host, the type is LinearAlgebra::distributed::Vector. The
+     * specialization for MemorySpace::CUDA is declared with
+     * LinearAlgebra::CUDAWrappers::DistributedVector in
+     * <tt>cuda_distributed_vector.h</tt>, which also provides the functions
+     * to transfer vectors between the two memory spaces.
+     */
+    template <typename Number, typename MemorySpace>
+    struct VectorInMemorySpace;
+
+    template <typename Number>
+    struct VectorInMemorySpace<Number, ::dealii::MemorySpace::Host>
+    {
+      typedef Vector<Number> type;
+    };
   }
 }
 
@@ -25,6 +25,8 @@
 #include <deal.II/lac/petsc_parallel_vector.h>
 #include <deal.II/lac/trilinos_vector.h>
 
+#include <map>
+
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -51,6 +53,25 @@ namespace LinearAlgebra
           AssertThrowMPI(ierr);
         }
       update_ghost_values_requests.clear();
+
+      // persistent requests stay allocated until the vector is reinitialized
+      // or destroyed, which might happen after MPI has been finalized for
+      // global objects
+      if (persistent_update_ghost_values_requests.size() > 0)
+        {
+          int finalized = 0;
+          int ierr = MPI_Finalized(&finalized);
+          AssertThrowMPI(ierr);
+          if (finalized == 0)
+            for (size_type j=0; j<persistent_update_ghost_values_requests.size(); j++)
+              {
+                ierr = MPI_Request_free(&persistent_update_ghost_values_requests[j]);
+                AssertThrowMPI(ierr);
+              }
+        }
+      persistent_update_ghost_values_requests.clear();
+      persistent_update_ghost_values_channel = numbers::invalid_unsigned_int;
+      persistent_update_ghost_values_active = false;
 #endif
     }
 
@@ -67,6 +88,8 @@ namespace LinearAlgebra
 
           Number *new_val;
           Utilities::System::posix_memalign ((void **)&new_val, 64, sizeof(Number)*new_alloc_size);
+          if (MemoryTracker::is_enabled())
+            MemoryTracker::record_allocation (new_val, sizeof(Number)*new_alloc_size);
           values.reset (new_val);
 
           allocated_size = new_alloc_size;
@@ -81,14 +104,45 @@ namespace LinearAlgebra
 
 
 
+    template <typename Number>
+    void
+    Vector<Number>::release_shared_memory ()
+    {
+#ifdef DEAL_II_WITH_MPI
+      if (shared_memory == nullptr)
+        return;
+
+      int finalized = 0;
+      int ierr = MPI_Finalized(&finalized);
+      AssertThrowMPI(ierr);
+      if (finalized == 0)
+        {
+          ierr = MPI_Win_unlock_all(shared_memory->window);
+          AssertThrowMPI(ierr);
+          ierr = MPI_Win_free(&shared_memory->window);
+          AssertThrowMPI(ierr);
+        }
+      shared_memory.reset();
+
+      // the memory was owned by the window, whose deleter in values does
+      // nothing
+      values = std::unique_ptr<Number[], decltype(&free)>(nullptr, &MemoryTracker::free);
+      allocated_size = 0;
+#endif
+    }
+
+
+
     template <typename Number>
     void
     Vector<Number>::reinit (const size_type size,
                             const bool      omit_zeroing_entries)
     {
       clear_mpi_requests();
+      release_shared_memory();
 
       // check whether we need to reallocate
+      const bool new_memory = (size > allocated_size);
       resize_val (size);
 
       // delete previous content in import data
@@ -97,8 +151,11 @@ namespace LinearAlgebra
       // set partitioner to serial version
       partitioner.reset (new Utilities::MPI::Partitioner (size));
 
-      // set entries to zero if so requested
-      if (omit_zeroing_entries == false)
+      // set entries to zero if so requested. newly allocated memory is
+      // touched with the partitioning of the vector operations if requested,
+      // see MultithreadInfo::set_parallel_first_touch()
+      if (omit_zeroing_entries == false ||
+          (new_memory && MultithreadInfo::use_parallel_first_touch()))
         this->operator = (Number());
       else
         zero_out_ghosts();
@@ -115,19 +172,45 @@ namespace LinearAlgebra
       clear_mpi_requests();
       Assert (v.partitioner.get() != nullptr, ExcNotInitialized());
 
+      reduced_precision_ghost_exchange = v.reduced_precision_ghost_exchange;
+
+#ifdef DEAL_II_WITH_MPI
+      // vectors initialized from a vector in shared memory allocate their
+      // entries in shared memory as well, and the memory of a vector in
+      // shared memory can not be reused for a vector with private memory
+      if (v.shared_memory != nullptr)
+        {
+          reinit (v.partitioner, v.shared_memory->comm_sm);
+          thread_loop_partitioner = v.thread_loop_partitioner;
+          return;
+        }
+      if (shared_memory != nullptr)
+        {
+          release_shared_memory();
+          partitioner.reset();
+        }
+#endif
+
       // check whether the partitioners are
       // different (check only if the are allocated
       // differently, not if the actual data is
       // different)
+      bool new_memory = false;
       if (partitioner.get() != v.partitioner.get())
         {
           partitioner = v.partitioner;
           const size_type new_allocated_size = partitioner->local_size() +
                                                partitioner->n_ghost_indices();
+          new_memory = (new_allocated_size > allocated_size);
           resize_val (new_allocated_size);
         }
 
-      if (omit_zeroing_entries == false)
+      // use the loop partitioner of v already for the initialization, in
+      // order to place the memory in the same way as the one of v
+      thread_loop_partitioner = v.thread_loop_partitioner;
+
+      if (omit_zeroing_entries == false ||
+          (new_memory && MultithreadInfo::use_parallel_first_touch()))
         this->operator= (Number());
       else
         zero_out_ghosts();
@@ -137,8 +220,6 @@ namespace LinearAlgebra
       // update_ghost_values, and we might have vectors where we never
       // call these methods and hence do not need to have the storage.
       import_data.reset ();
-
-      thread_loop_partitioner = v.thread_loop_partitioner;
     }
 
 
@@ -177,6 +258,7 @@ namespace LinearAlgebra
     Vector<Number>::reinit (const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner_in)
     {
       clear_mpi_requests();
+      release_shared_memory();
       partitioner = partitioner_in;
 
       // set vector size and allocate memory
@@ -199,12 +281,154 @@ namespace LinearAlgebra
 
 
 
+    template <typename Number>
+    void
+    Vector<Number>::reinit (const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner_in,
+                            const MPI_Comm                                             comm_sm)
+    {
+#ifdef DEAL_II_WITH_MPI
+      clear_mpi_requests();
+      release_shared_memory();
+      partitioner = partitioner_in;
+
+      shared_memory.reset (new SharedMemoryData());
+      shared_memory->comm_sm = comm_sm;
+      shared_memory->channel = numbers::invalid_unsigned_int;
+
+      // allocate the entries in the shared memory window. let MPI place the
+      // memory of each process separately, which typically aligns it to
+      // pages and avoids false sharing between the processes
+      const size_type new_allocated_size = partitioner->local_size() +
+                                           partitioner->n_ghost_indices();
+      MPI_Info info;
+      int ierr = MPI_Info_create(&info);
+      AssertThrowMPI(ierr);
+      ierr = MPI_Info_set(info, const_cast<char *>("alloc_shared_noncontig"),
+                          const_cast<char *>("true"));
+      AssertThrowMPI(ierr);
+      Number *new_values = nullptr;
+      ierr = MPI_Win_allocate_shared(new_allocated_size*sizeof(Number), sizeof(Number),
+                                     info, comm_sm, &new_values,
+                                     &shared_memory->window);
+      AssertThrowMPI(ierr);
+      ierr = MPI_Info_free(&info);
+      AssertThrowMPI(ierr);
+
+      // open a passive target epoch on the whole window for the lifetime of
+      // the vector, which is needed for synchronizing the memory with
+      // MPI_Win_sync
+      ierr = MPI_Win_lock_all(MPI_MODE_NOCHECK, shared_memory->window);
+      AssertThrowMPI(ierr);
+
+      // the memory is owned by the window and freed in
+      // release_shared_memory()
+      values = std::unique_ptr<Number[], decltype(&free)>(new_values,
+                                                          [](void *) noexcept {});
+      allocated_size = new_allocated_size;
+      thread_loop_partitioner.reset(new ::dealii::parallel::internal::TBBPartitioner());
+
+      int n_sm_procs = 0;
+      ierr = MPI_Comm_size(comm_sm, &n_sm_procs);
+      AssertThrowMPI(ierr);
+      shared_memory->sm_values.resize(n_sm_procs);
+      for (int p=0; p<n_sm_procs; ++p)
+        {
+          MPI_Aint segment_size;
+          int disp_unit;
+          Number *segment = nullptr;
+          ierr = MPI_Win_shared_query(shared_memory->window, p, &segment_size,
+                                      &disp_unit, &segment);
+          AssertThrowMPI(ierr);
+          shared_memory->sm_values[p] = segment;
+        }
+
+      // collect the ranks and the first locally owned indices of the
+      // processes in comm_sm
+      const unsigned int my_pid = partitioner->this_mpi_process();
+      std::vector<unsigned int> sm_ranks(n_sm_procs);
+      ierr = MPI_Allgather(&my_pid, 1, MPI_UNSIGNED,
+                           sm_ranks.data(), 1, MPI_UNSIGNED, comm_sm);
+      AssertThrowMPI(ierr);
+      const types::global_dof_index my_first = partitioner->local_range().first;
+      std::vector<types::global_dof_index> sm_first_indices(n_sm_procs);
+      ierr = MPI_Allgather(&my_first, 1, DEAL_II_DOF_INDEX_MPI_TYPE,
+                           sm_first_indices.data(), 1, DEAL_II_DOF_INDEX_MPI_TYPE,
+                           comm_sm);
+      AssertThrowMPI(ierr);
+      std::map<unsigned int,unsigned int> rank_to_sm_rank;
+      for (int p=0; p<n_sm_procs; ++p)
+        rank_to_sm_rank[sm_ranks[p]] = p;
+
+      // the ghost entries are sorted by their owner, so walk through the
+      // ghost targets and split the ghost indices into the ones that are
+      // copied from shared memory and the ones that are sent through MPI
+      const IndexSet &ghost_indices = partitioner->ghost_indices();
+      IndexSet off_node_ghost_indices(ghost_indices.size());
+      unsigned int ghost_index = 0;
+      for (unsigned int t=0; t<partitioner->ghost_targets().size(); ++t)
+        {
+          const unsigned int owner = partitioner->ghost_targets()[t].first;
+          const unsigned int n_entries = partitioner->ghost_targets()[t].second;
+          const std::map<unsigned int,unsigned int>::const_iterator
+          sm_owner = rank_to_sm_rank.find(owner);
+          if (sm_owner == rank_to_sm_rank.end())
+            {
+              for (unsigned int i=0; i<n_entries; ++i)
+                off_node_ghost_indices.add_index(ghost_indices.nth_index_in_set(ghost_index+i));
+            }
+          else
+            {
+              shared_memory->sm_ghost_owners.push_back(owner);
+              for (unsigned int i=0; i<n_entries; ++i)
+                {
+                  const unsigned int owner_index =
+                    ghost_indices.nth_index_in_set(ghost_index+i) -
+                    sm_first_indices[sm_owner->second];
+                  if (shared_memory->ghost_ranges.empty() ||
+                      shared_memory->ghost_ranges.back().sm_rank != sm_owner->second ||
+                      shared_memory->ghost_ranges.back().owner_index +
+                      shared_memory->ghost_ranges.back().n_entries != owner_index)
+                    {
+                      const typename SharedMemoryData::GhostRange
+                      range = {ghost_index+i, sm_owner->second, owner_index, 0};
+                      shared_memory->ghost_ranges.push_back(range);
+                    }
+                  ++shared_memory->ghost_ranges.back().n_entries;
+                }
+            }
+          ghost_index += n_entries;
+        }
+      off_node_ghost_indices.compress();
+
+      for (unsigned int t=0; t<partitioner->import_targets().size(); ++t)
+        if (rank_to_sm_rank.find(partitioner->import_targets()[t].first) !=
+            rank_to_sm_rank.end())
+          shared_memory->sm_ghost_readers.push_back(partitioner->import_targets()[t].first);
+
+      std::shared_ptr<Utilities::MPI::Partitioner> off_node_partitioner
+      (new Utilities::MPI::Partitioner(partitioner->locally_owned_range(),
+                                       partitioner->get_mpi_communicator()));
+      off_node_partitioner->set_ghost_indices(off_node_ghost_indices, ghost_indices);
+      shared_memory->off_node_partitioner = off_node_partitioner;
+
+      this->operator= (Number());
+      import_data.reset ();
+      vector_is_ghosted = false;
+#else
+      (void)comm_sm;
+      reinit (partitioner_in);
+#endif
+    }
+
+
+
     template <typename Number>
     Vector<Number>::Vector ()
       :
       partitioner (new Utilities::MPI::Partitioner()),
       allocated_size (0),
-      values (nullptr, &free)
+      values (nullptr, &MemoryTracker::free),
+      reduced_precision_ghost_exchange (false)
     {
       reinit(0);
     }
@@ -216,8 +440,9 @@ namespace LinearAlgebra
       :
       Subscriptor(),
       allocated_size (0),
-      values (nullptr, &free),
-      vector_is_ghosted (false)
+      values (nullptr, &MemoryTracker::free),
+      vector_is_ghosted (false),
+      reduced_precision_ghost_exchange (false)
     {
       reinit (v, true);
 
@@ -240,8 +465,9 @@ namespace LinearAlgebra
                             const MPI_Comm  communicator)
       :
       allocated_size (0),
-      values (nullptr, &free),
-      vector_is_ghosted (false)
+      values (nullptr, &MemoryTracker::free),
+      vector_is_ghosted (false),
+      reduced_precision_ghost_exchange (false)
     {
       reinit (local_range, ghost_indices, communicator);
     }
@@ -253,8 +479,9 @@ namespace LinearAlgebra
                             const MPI_Comm  communicator)
       :
       allocated_size (0),
-      values (nullptr, &free),
-      vector_is_ghosted (false)
+      values (nullptr, &MemoryTracker::free),
+      vector_is_ghosted (false),
+      reduced_precision_ghost_exchange (false)
     {
       reinit (local_range, communicator);
     }
@@ -265,8 +492,9 @@ namespace LinearAlgebra
     Vector<Number>::Vector (const size_type size)
       :
       allocated_size (0),
-      values (nullptr, &free),
-      vector_is_ghosted (false)
+      values (nullptr, &MemoryTracker::free),
+      vector_is_ghosted (false),
+      reduced_precision_ghost_exchange (false)
     {
       reinit (size, false);
     }
@@ -278,8 +506,9 @@ namespace LinearAlgebra
     Vector (const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner)
       :
       allocated_size (0),
-      values (nullptr, &free),
-      vector_is_ghosted (false)
+      values (nullptr, &MemoryTracker::free),
+      vector_is_ghosted (false),
+      reduced_precision_ghost_exchange (false)
     {
       reinit (partitioner);
     }
@@ -291,6 +520,7 @@ namespace LinearAlgebra
     Vector<Number>::~Vector ()
     {
       clear_mpi_requests();
+      release_shared_memory();
     }
 
 
@@ -576,6 +806,28 @@ namespace LinearAlgebra
 
 
 
+    template <typename Number>
+    void
+    Vector<Number>::compress_progress ()
+    {
+#ifdef DEAL_II_WITH_MPI
+      if (compress_requests.size() == 0)
+        return;
+
+      // make this function thread safe
+      Threads::Mutex::ScopedLock lock (mutex);
+
+      // the requests are only released if all of them have completed, in
+      // which case the wait in compress_finish() returns immediately
+      int flag = 0;
+      const int ierr = MPI_Testall (compress_requests.size(), compress_requests.data(),
+                                    &flag, MPI_STATUSES_IGNORE);
+      AssertThrowMPI (ierr);
+#endif
+    }
+
+
+
     template <typename Number>
     void
     Vector<Number>::update_ghost_values_start (const unsigned int counter) const
@@ -592,12 +844,102 @@ namespace LinearAlgebra
       if (import_data == nullptr && partitioner->n_import_indices() > 0)
         import_data.reset (new Number[partitioner->n_import_indices()]);
 
-      partitioner->export_to_ghosted_array_start
-      (counter,
-       ArrayView<const Number>(values.get(), partitioner->local_size()),
-       ArrayView<Number>(import_data.get(), partitioner->n_import_indices()),
-       ArrayView<Number>(values.get() + partitioner->local_size(),partitioner->n_ghost_indices()),
-       update_ghost_values_requests);
+      if (shared_memory != nullptr)
+        {
+          // make the entries written by this process visible to the other
+          // processes in shared memory before signaling that they are ready
+          int ierr = MPI_Win_sync(shared_memory->window);
+          AssertThrowMPI(ierr);
+
+          const Utilities::MPI::Partitioner &off_node_partitioner =
+            *shared_memory->off_node_partitioner;
+          off_node_partitioner.export_to_ghosted_array_start
+          (counter,
+           ArrayView<const Number>(values.get(), partitioner->local_size()),
+           ArrayView<Number>(import_data.get(), off_node_partitioner.n_import_indices()),
+           ArrayView<Number>(values.get() + partitioner->local_size(),partitioner->n_ghost_indices()),
+           update_ghost_values_requests);
+
+          // the processes in shared memory only exchange empty messages:
+          // the owners signal that their entries can be read, and the
+          // readers signal that they have copied the entries. use channels
+          // in a different range from the data messages and compress()
+          const unsigned int ready_channel = counter + 601;
+          const unsigned int done_channel = counter + 801;
+          const unsigned int my_pid = partitioner->this_mpi_process();
+          std::vector<unsigned int> &owners = shared_memory->sm_ghost_owners;
+          std::vector<unsigned int> &readers = shared_memory->sm_ghost_readers;
+          std::vector<MPI_Request> &requests = shared_memory->requests;
+          Assert(requests.size() == 0,
+                 ExcMessage("Another operation seems to still be running. "
+                            "Call update_ghost_values_finish() first."));
+          requests.resize(owners.size() + 2*readers.size());
+          for (unsigned int i=0; i<owners.size(); ++i)
+            {
+              ierr = MPI_Irecv(nullptr, 0, MPI_BYTE, owners[i], owners[i] + ready_channel,
+                               partitioner->get_mpi_communicator(), &requests[i]);
+              AssertThrowMPI(ierr);
+            }
+          for (unsigned int i=0; i<readers.size(); ++i)
+            {
+              ierr = MPI_Irecv(nullptr, 0, MPI_BYTE, readers[i], readers[i] + done_channel,
+                               partitioner->get_mpi_communicator(),
+                               &requests[owners.size()+i]);
+              AssertThrowMPI(ierr);
+              ierr = MPI_Isend(nullptr, 0, MPI_BYTE, readers[i], my_pid + ready_channel,
+                               partitioner->get_mpi_communicator(),
+                               &requests[owners.size()+readers.size()+i]);
+              AssertThrowMPI(ierr);
+            }
+          shared_memory->channel = counter;
+        }
+      else if (reduced_precision_ghost_exchange &&
+               !std::is_same<Number,reduced_precision_type>::value)
+        partitioner->export_to_ghosted_array_start<Number,reduced_precision_type>
+        (counter,
+         ArrayView<const Number>(values.get(), partitioner->local_size()),
+         ArrayView<Number>(import_data.get(), partitioner->n_import_indices()),
+         ArrayView<Number>(values.get() + partitioner->local_size(),partitioner->n_ghost_indices()),
+         update_ghost_values_requests);
+      else if (partitioner->use_persistent_communication())
+        {
+          Assert(persistent_update_ghost_values_active == false,
+                 ExcMessage("Another operation seems to still be running. "
+                            "Call update_ghost_values_finish() first."));
+
+          // the requests are bound to the vector entries and the channel, so
+          // they need to be set up only once
+          if (persistent_update_ghost_values_requests.size() == 0 ||
+              persistent_update_ghost_values_channel != counter)
+            {
+              for (size_type j=0; j<persistent_update_ghost_values_requests.size(); j++)
+                {
+                  const int ierr = MPI_Request_free(&persistent_update_ghost_values_requests[j]);
+                  AssertThrowMPI(ierr);
+                }
+              persistent_update_ghost_values_requests.clear();
+
+              partitioner->export_to_ghosted_array_init
+              (counter,
+               ArrayView<Number>(import_data.get(), partitioner->n_import_indices()),
+               ArrayView<Number>(values.get() + partitioner->local_size(),partitioner->n_ghost_indices()),
+               persistent_update_ghost_values_requests);
+              persistent_update_ghost_values_channel = counter;
+            }
+
+          partitioner->export_to_ghosted_array_start_persistent
+          (ArrayView<const Number>(values.get(), partitioner->local_size()),
+           ArrayView<Number>(import_data.get(), partitioner->n_import_indices()),
+           persistent_update_ghost_values_requests);
+          persistent_update_ghost_values_active = true;
+        }
+      else
+        partitioner->export_to_ghosted_array_start
+        (counter,
+         ArrayView<const Number>(values.get(), partitioner->local_size()),
+         ArrayView<Number>(import_data.get(), partitioner->n_import_indices()),
+         ArrayView<Number>(values.get() + partitioner->local_size(),partitioner->n_ghost_indices()),
+         update_ghost_values_requests);
 
 #else
       (void)counter;
@@ -611,6 +953,78 @@ namespace LinearAlgebra
     Vector<Number>::update_ghost_values_finish () const
     {
 #ifdef DEAL_II_WITH_MPI
+      if (shared_memory != nullptr)
+        {
+          // make this function thread safe
+          Threads::Mutex::ScopedLock lock (mutex);
+
+          // first receive the ghost entries from other nodes, which moves
+          // them to their final positions in the ghost array
+          if (update_ghost_values_requests.size() > 0)
+            shared_memory->off_node_partitioner->export_to_ghosted_array_finish
+            (ArrayView<Number>(values.get() + partitioner->local_size(),partitioner->n_ghost_indices()),
+             update_ghost_values_requests);
+
+          std::vector<unsigned int> &owners = shared_memory->sm_ghost_owners;
+          std::vector<unsigned int> &readers = shared_memory->sm_ghost_readers;
+          std::vector<MPI_Request> &requests = shared_memory->requests;
+          if (requests.size() > 0)
+            {
+              AssertDimension(requests.size(), owners.size() + 2*readers.size());
+
+              // wait for the owners of the ghost entries and copy their data
+              int ierr = MPI_Waitall(owners.size(), requests.data(),
+                                     MPI_STATUSES_IGNORE);
+              AssertThrowMPI(ierr);
+              ierr = MPI_Win_sync(shared_memory->window);
+              AssertThrowMPI(ierr);
+
+              Number *ghost_values = values.get() + partitioner->local_size();
+              for (unsigned int r=0; r<shared_memory->ghost_ranges.size(); ++r)
+                {
+                  const typename SharedMemoryData::GhostRange &range =
+                    shared_memory->ghost_ranges[r];
+                  std::copy(shared_memory->sm_values[range.sm_rank] + range.owner_index,
+                            shared_memory->sm_values[range.sm_rank] + range.owner_index +
+                            range.n_entries,
+                            ghost_values + range.ghost_index);
+                }
+
+              const unsigned int my_pid = partitioner->this_mpi_process();
+              for (unsigned int i=0; i<owners.size(); ++i)
+                {
+                  ierr = MPI_Isend(nullptr, 0, MPI_BYTE, owners[i],
+                                   my_pid + shared_memory->channel + 801,
+                                   partitioner->get_mpi_communicator(), &requests[i]);
+                  AssertThrowMPI(ierr);
+                }
+
+              // wait for the readers of our entries, which must not be
+              // modified before they have been copied
+              ierr = MPI_Waitall(requests.size(), requests.data(),
+                                 MPI_STATUSES_IGNORE);
+              AssertThrowMPI(ierr);
+              requests.clear();
+            }
+
+          vector_is_ghosted = true;
+          return;
+        }
+
+      if (persistent_update_ghost_values_active)
+        {
+          // make this function thread safe
+          Threads::Mutex::ScopedLock lock (mutex);
+
+          partitioner->export_to_ghosted_array_finish_persistent
+          (ArrayView<Number>(values.get() + partitioner->local_size(),partitioner->n_ghost_indices()),
+           persistent_update_ghost_values_requests);
+          persistent_update_ghost_values_active = false;
+
+          vector_is_ghosted = true;
+          return;
+        }
+
       // wait for both sends and receives to complete, even though only
       // receives are really necessary. this gives (much) better performance
       AssertDimension (partitioner->ghost_targets().size() +
@@ -621,9 +1035,14 @@ namespace LinearAlgebra
           // make this function thread safe
           Threads::Mutex::ScopedLock lock (mutex);
 
-          partitioner->export_to_ghosted_array_finish
-          (ArrayView<Number>(values.get() + partitioner->local_size(),partitioner->n_ghost_indices()),
-           update_ghost_values_requests);
+          if (reduced_precision_ghost_exchange)
+            partitioner->export_to_ghosted_array_finish<Number,reduced_precision_type>
+            (ArrayView<Number>(values.get() + partitioner->local_size(),partitioner->n_ghost_indices()),
+             update_ghost_values_requests);
+          else
+            partitioner->export_to_ghosted_array_finish
+            (ArrayView<Number>(values.get() + partitioner->local_size(),partitioner->n_ghost_indices()),
+             update_ghost_values_requests);
         }
 #endif
       vector_is_ghosted = true;
@@ -631,6 +1050,47 @@ namespace LinearAlgebra
 
 
 
+    template <typename Number>
+    void
+    Vector<Number>::update_ghost_values_progress () const
+    {
+#ifdef DEAL_II_WITH_MPI
+      std::vector<MPI_Request> &requests = persistent_update_ghost_values_active ?
+                                           persistent_update_ghost_values_requests :
+                                           update_ghost_values_requests;
+      if (requests.size() == 0)
+        return;
+
+      // make this function thread safe
+      Threads::Mutex::ScopedLock lock (mutex);
+
+      int flag = 0;
+      const int ierr = MPI_Testall (requests.size(), requests.data(),
+                                    &flag, MPI_STATUSES_IGNORE);
+      AssertThrowMPI (ierr);
+#endif
+    }
+
+
+
+    template <typename Number>
+    void
+    Vector<Number>::set_reduced_precision_ghost_exchange (const bool use_reduced_precision)
+    {
+      reduced_precision_ghost_exchange = use_reduced_precision;
+    }
+
+
+
+    template <typename Number>
+    bool
+    Vector<Number>::uses_reduced_precision_ghost_exchange () const
+    {
+      return reduced_precision_ghost_exchange;
+    }
+
+
+
     template <typename Number>
     void
     Vector<Number>::import(const ReadWriteVector<Number>                  &V,
@@ -706,6 +1166,16 @@ namespace LinearAlgebra
                       ExcMessage("MPI found unfinished update_ghost_values() requests"
                                  "when calling swap, which is not allowed"));
             }
+          if (persistent_update_ghost_values_active)
+            {
+              const int ierr = MPI_Testall (persistent_update_ghost_values_requests.size(),
+                                            persistent_update_ghost_values_requests.data(),
+                                            &flag, MPI_STATUSES_IGNORE);
+              AssertThrowMPI (ierr);
+              Assert (flag == 1,
+                      ExcMessage("MPI found unfinished update_ghost_values() requests"
+                                 "when calling swap, which is not allowed"));
+            }
           if (compress_requests.size()>0)
             {
               const int ierr = MPI_Testall (compress_requests.size(), compress_requests.data(),
@@ -720,6 +1190,12 @@ namespace LinearAlgebra
 
       std::swap (compress_requests, v.compress_requests);
       std::swap (update_ghost_values_requests, v.update_ghost_values_requests);
+      std::swap (persistent_update_ghost_values_requests,
+                 v.persistent_update_ghost_values_requests);
+      std::swap (persistent_update_ghost_values_channel,
+                 v.persistent_update_ghost_values_channel);
+      std::swap (persistent_update_ghost_values_active,
+                 v.persistent_update_ghost_values_active);
 #endif
 
       std::swap (partitioner,       v.partitioner);
@@ -728,6 +1204,10 @@ namespace LinearAlgebra
       std::swap (values,               v.values);
       std::swap (import_data,       v.import_data);
       std::swap (vector_is_ghosted, v.vector_is_ghosted);
+      std::swap (reduced_precision_ghost_exchange, v.reduced_precision_ghost_exchange);
+#ifdef DEAL_II_WITH_MPI
+      std::swap (shared_memory,     v.shared_memory);
+#endif
     }
 
 
@@ -1331,6 +1811,50 @@ namespace LinearAlgebra
 
 
 
+    template <typename Number>
+    Utilities::MPI::ReductionFuture<Number>
+    Vector<Number>::inner_product_async (const Vector<Number> &v) const
+    {
+      const Number local_result = inner_product_local(v);
+      if (partitioner->n_mpi_processes() > 1)
+        return Utilities::MPI::isum (local_result,
+                                     partitioner->get_mpi_communicator());
+      else
+        return Utilities::MPI::ReductionFuture<Number> (local_result);
+    }
+
+
+
+    template <typename Number>
+    Utilities::MPI::ReductionFuture<typename Vector<Number>::real_type>
+    Vector<Number>::norm_sqr_async () const
+    {
+      const real_type local_result = norm_sqr_local();
+      if (partitioner->n_mpi_processes() > 1)
+        return Utilities::MPI::isum (local_result,
+                                     partitioner->get_mpi_communicator());
+      else
+        return Utilities::MPI::ReductionFuture<real_type> (local_result);
+    }
+
+
+
+    template <typename Number>
+    Utilities::MPI::ReductionFuture<Number>
+    Vector<Number>::add_and_dot_async (const Number          a,
+                                       const Vector<Number> &v,
+                                       const Vector<Number> &w)
+    {
+      const Number local_result = add_and_dot_local(a, v, w);
+      if (partitioner->n_mpi_processes() > 1)
+        return Utilities::MPI::isum (local_result,
+                                     partitioner->get_mpi_communicator());
+      else
+        return Utilities::MPI::ReductionFuture<Number> (local_result);
+    }
+
+
+
     template <typename Number>
     inline
     bool
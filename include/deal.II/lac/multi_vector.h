@@ -0,0 +1,626 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_multi_vector_h
+#define dealii_multi_vector_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/numbers.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/types.h>
+#include <deal.II/lac/exceptions.h>
+#include <deal.II/lac/vector.h>
+
+#include <algorithm>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*! @addtogroup Vectors
+ *@{
+ */
+
+/**
+ * A collection of vectors of the same size, as needed for solving a linear
+ * system with several right hand sides at once. The entries are stored row
+ * by row, i.e., the entries of all vectors that belong to the same index are
+ * stored next to each other in memory. With this layout, a matrix-vector
+ * product SparseMatrix::vmult(MultiVector &, const MultiVector &) const
+ * loads each entry of the matrix only once for all vectors, and the
+ * innermost loop over the vectors can be vectorized by the compiler. Since
+ * the sparse matrix-vector product is usually limited by the memory
+ * bandwidth for loading the matrix, this makes the multiplication with $k$
+ * vectors considerably cheaper than $k$ separate multiplications.
+ *
+ * The arithmetic operations of this class act on all vectors at once. The
+ * operations that in a single vector involve scalars, such as add() or
+ * sadd(), take one coefficient per vector, and the inner products and norms
+ * are returned as one value per vector. This is the interface used by
+ * SolverMultiCG that runs the conjugate gradient method on all vectors
+ * simultaneously. Individual vectors can be copied in and out with
+ * set_vector() and extract_vector().
+ */
+template <typename Number>
+class MultiVector : public Subscriptor
+{
+public:
+  /**
+   * Declare standard types used in all containers.
+   */
+  typedef Number                                            value_type;
+  typedef types::global_dof_index                           size_type;
+  typedef typename numbers::NumberTraits<Number>::real_type real_type;
+
+  /**
+   * Constructor. Create an empty object.
+   */
+  MultiVector ();
+
+  /**
+   * Constructor. Create @p n_vectors vectors of size @p size and initialize
+   * all entries with zero.
+   */
+  MultiVector (const size_type    size,
+               const unsigned int n_vectors);
+
+  /**
+   * Change the size of this object to @p n_vectors vectors of size @p
+   * size. Unless @p omit_zeroing_entries is set, all entries are set to
+   * zero.
+   */
+  void reinit (const size_type    size,
+               const unsigned int n_vectors,
+               const bool         omit_zeroing_entries = false);
+
+  /**
+   * Change the size of this object to the size of @p v. Unless @p
+   * omit_zeroing_entries is set, all entries are set to zero.
+   */
+  template <typename Number2>
+  void reinit (const MultiVector<Number2> &v,
+               const bool                  omit_zeroing_entries = false);
+
+  /**
+   * Set all entries to the scalar @p s.
+   */
+  MultiVector<Number> &operator = (const Number s);
+
+  /**
+   * Return the size of each of the vectors.
+   */
+  size_type size () const;
+
+  /**
+   * Return the number of vectors.
+   */
+  unsigned int n_vectors () const;
+
+  /**
+   * Read-write access to entry @p index of vector @p vector.
+   */
+  Number &operator () (const size_type    index,
+                       const unsigned int vector);
+
+  /**
+   * Read access to entry @p index of vector @p vector.
+   */
+  const Number &operator () (const size_type    index,
+                             const unsigned int vector) const;
+
+  /**
+   * Return a pointer to the n_vectors() entries of all vectors for the
+   * given @p index.
+   */
+  Number *row (const size_type index);
+
+  /**
+   * Return a pointer to the n_vectors() entries of all vectors for the
+   * given @p index.
+   */
+  const Number *row (const size_type index) const;
+
+  /**
+   * Copy the vector with number @p vector into @p v, which is resized if
+   * necessary.
+   */
+  template <typename Number2>
+  void extract_vector (const unsigned int  vector,
+                       Vector<Number2>    &v) const;
+
+  /**
+   * Set the vector with number @p vector to @p v.
+   */
+  template <typename Number2>
+  void set_vector (const unsigned int     vector,
+                   const Vector<Number2> &v);
+
+  /**
+   * Add the vectors of @p v to the vectors of this object.
+   */
+  MultiVector<Number> &operator += (const MultiVector<Number> &v);
+
+  /**
+   * Subtract the vectors of @p v from the vectors of this object.
+   */
+  MultiVector<Number> &operator -= (const MultiVector<Number> &v);
+
+  /**
+   * Scale all vectors by @p factor.
+   */
+  MultiVector<Number> &operator *= (const Number factor);
+
+  /**
+   * Add the vectors of @p v, with vector <i>j</i> scaled by the coefficient
+   * <tt>a[j]</tt>, to the vectors of this object.
+   */
+  void add (const std::vector<Number>  &a,
+            const MultiVector<Number> &v);
+
+  /**
+   * Scale vector <i>j</i> of this object by <tt>s[j]</tt> and add vector
+   * <i>j</i> of @p v.
+   */
+  void sadd (const std::vector<Number>  &s,
+             const MultiVector<Number> &v);
+
+  /**
+   * Compute the inner products of each vector of this object with the
+   * respective vector of @p v, i.e., <tt>products[j]</tt> is the inner
+   * product of the vectors with number <i>j</i>. For complex numbers, the
+   * vectors of @p v are conjugated, like in Vector::operator*().
+   */
+  void inner_products (const MultiVector<Number> &v,
+                       std::vector<Number>       &products) const;
+
+  /**
+   * Compute the square of the $l_2$-norm of each vector.
+   */
+  void norms_sqr (std::vector<real_type> &norms) const;
+
+  /**
+   * Compute the $l_2$-norm of each vector.
+   */
+  void l2_norms (std::vector<real_type> &norms) const;
+
+  /**
+   * Return the memory consumption of this class in bytes.
+   */
+  std::size_t memory_consumption () const;
+
+  /**
+   * Exception.
+   */
+  DeclException2 (ExcDifferentNumberOfVectors,
+                  unsigned int, unsigned int,
+                  << "The number of vectors " << arg1
+                  << " does not match the expected number " << arg2 << ".");
+
+private:
+  /**
+   * Compute for each vector <i>j</i> the sum over all indices <i>i</i> of
+   * <tt>f(this(i,j), v(i,j))</tt>. In order to obtain results that do
+   * not depend on the scheduling of the tasks, the partial sums are
+   * computed on chunks of fixed size and added in a fixed order.
+   */
+  template <typename ResultType, typename Operation>
+  void reduce (const MultiVector<Number> &v,
+               const Operation           &f,
+               std::vector<ResultType>   &result) const;
+
+  /**
+   * Apply <tt>f(row_of_this, row_of_v, n_vectors)</tt> to all indices, in
+   * parallel.
+   */
+  template <typename Operation>
+  void apply (const MultiVector<Number> &v,
+              const Operation           &f);
+
+  /**
+   * The size of each vector.
+   */
+  size_type vector_size;
+
+  /**
+   * The number of vectors.
+   */
+  unsigned int n_vecs;
+
+  /**
+   * The entries of all vectors, stored index by index.
+   */
+  AlignedVector<Number> values;
+
+  template <typename Number2> friend class MultiVector;
+};
+
+/*@}*/
+
+/*----------------------- Inline functions ----------------------------------*/
+
+#ifndef DOXYGEN
+
+template <typename Number>
+inline
+MultiVector<Number>::MultiVector ()
+  :
+  vector_size (0),
+  n_vecs (0)
+{}
+
+
+
+template <typename Number>
+inline
+MultiVector<Number>::MultiVector (const size_type    size,
+                                  const unsigned int n_vectors)
+  :
+  vector_size (0),
+  n_vecs (0)
+{
+  reinit (size, n_vectors);
+}
+
+
+
+template <typename Number>
+inline
+void
+MultiVector<Number>::reinit (const size_type    size,
+                             const unsigned int n_vectors,
+                             const bool         omit_zeroing_entries)
+{
+  vector_size = size;
+  n_vecs = n_vectors;
+  if (omit_zeroing_entries && values.size() == size*n_vectors)
+    return;
+  values.resize_fast (size*n_vectors);
+  if (!omit_zeroing_entries)
+    values.fill (Number());
+}
+
+
+
+template <typename Number>
+template <typename Number2>
+inline
+void
+MultiVector<Number>::reinit (const MultiVector<Number2> &v,
+                             const bool                  omit_zeroing_entries)
+{
+  reinit (v.size(), v.n_vectors(), omit_zeroing_entries);
+}
+
+
+
+template <typename Number>
+inline
+MultiVector<Number> &
+MultiVector<Number>::operator = (const Number s)
+{
+  AssertIsFinite(s);
+  values.fill (s);
+  return *this;
+}
+
+
+
+template <typename Number>
+inline
+typename MultiVector<Number>::size_type
+MultiVector<Number>::size () const
+{
+  return vector_size;
+}
+
+
+
+template <typename Number>
+inline
+unsigned int
+MultiVector<Number>::n_vectors () const
+{
+  return n_vecs;
+}
+
+
+
+template <typename Number>
+inline
+Number &
+MultiVector<Number>::operator () (const size_type    index,
+                                  const unsigned int vector)
+{
+  AssertIndexRange (index, vector_size);
+  AssertIndexRange (vector, n_vecs);
+  return values[index*n_vecs+vector];
+}
+
+
+
+template <typename Number>
+inline
+const Number &
+MultiVector<Number>::operator () (const size_type    index,
+                                  const unsigned int vector) const
+{
+  AssertIndexRange (index, vector_size);
+  AssertIndexRange (vector, n_vecs);
+  return values[index*n_vecs+vector];
+}
+
+
+
+template <typename Number>
+inline
+Number *
+MultiVector<Number>::row (const size_type index)
+{
+  AssertIndexRange (index, vector_size);
+  return values.begin() + index*n_vecs;
+}
+
+
+
+template <typename Number>
+inline
+const Number *
+MultiVector<Number>::row (const size_type index) const
+{
+  AssertIndexRange (index, vector_size);
+  return values.begin() + index*n_vecs;
+}
+
+
+
+template <typename Number>
+template <typename Number2>
+inline
+void
+MultiVector<Number>::extract_vector (const unsigned int  vector,
+                                     Vector<Number2>    &v) const
+{
+  AssertIndexRange (vector, n_vecs);
+  if (v.size() != vector_size)
+    v.reinit (vector_size, true);
+  for (size_type i=0; i<vector_size; ++i)
+    v(i) = values[i*n_vecs+vector];
+}
+
+
+
+template <typename Number>
+template <typename Number2>
+inline
+void
+MultiVector<Number>::set_vector (const unsigned int     vector,
+                                 const Vector<Number2> &v)
+{
+  AssertIndexRange (vector, n_vecs);
+  AssertDimension (v.size(), vector_size);
+  for (size_type i=0; i<vector_size; ++i)
+    values[i*n_vecs+vector] = v(i);
+}
+
+
+
+template <typename Number>
+template <typename Operation>
+inline
+void
+MultiVector<Number>::apply (const MultiVector<Number> &v,
+                            const Operation           &f)
+{
+  AssertDimension (v.size(), vector_size);
+  Assert (v.n_vectors() == n_vecs,
+          ExcDifferentNumberOfVectors(v.n_vectors(), n_vecs));
+
+  Number *const this_values = values.begin();
+  const Number *const v_values = v.values.begin();
+  const unsigned int n = n_vecs;
+  parallel::apply_to_subranges
+  (size_type(0), vector_size,
+   [&] (const size_type begin, const size_type end)
+  {
+    for (size_type i=begin; i<end; ++i)
+      f (this_values+i*n, v_values+i*n, n);
+  },
+  std::max<size_type>(1, internal::Vector::minimum_parallel_grain_size/std::max(1U,n)));
+}
+
+
+
+template <typename Number>
+template <typename ResultType, typename Operation>
+inline
+void
+MultiVector<Number>::reduce (const MultiVector<Number> &v,
+                             const Operation           &f,
+                             std::vector<ResultType>   &result) const
+{
+  AssertDimension (v.size(), vector_size);
+  Assert (v.n_vectors() == n_vecs,
+          ExcDifferentNumberOfVectors(v.n_vectors(), n_vecs));
+
+  const unsigned int n = n_vecs;
+  const size_type chunk_size =
+    std::max<size_type>(1, internal::Vector::minimum_parallel_grain_size/std::max(1U,n));
+  const size_type n_chunks = (vector_size + chunk_size - 1) / chunk_size;
+  std::vector<ResultType> partial_sums (n_chunks*n, ResultType());
+
+  const Number *const this_values = values.begin();
+  const Number *const v_values = v.values.begin();
+  parallel::apply_to_subranges
+  (size_type(0), n_chunks,
+   [&] (const size_type begin_chunk, const size_type end_chunk)
+  {
+    for (size_type c=begin_chunk; c<end_chunk; ++c)
+      {
+        ResultType *sums = &partial_sums[c*n];
+        const size_type end = std::min(vector_size, (c+1)*chunk_size);
+        for (size_type i=c*chunk_size; i<end; ++i)
+          for (unsigned int j=0; j<n; ++j)
+            sums[j] += f (this_values[i*n+j], v_values[i*n+j]);
+      }
+  },
+  1);
+
+  result.resize (n);
+  std::fill (result.begin(), result.end(), ResultType());
+  for (size_type c=0; c<n_chunks; ++c)
+    for (unsigned int j=0; j<n; ++j)
+      result[j] += partial_sums[c*n+j];
+}
+
+
+
+template <typename Number>
+inline
+MultiVector<Number> &
+MultiVector<Number>::operator += (const MultiVector<Number> &v)
+{
+  apply (v, [] (Number *dst, const Number *src, const unsigned int n)
+  {
+    for (unsigned int j=0; j<n; ++j)
+      dst[j] += src[j];
+  });
+  return *this;
+}
+
+
+
+template <typename Number>
+inline
+MultiVector<Number> &
+MultiVector<Number>::operator -= (const MultiVector<Number> &v)
+{
+  apply (v, [] (Number *dst, const Number *src, const unsigned int n)
+  {
+    for (unsigned int j=0; j<n; ++j)
+      dst[j] -= src[j];
+  });
+  return *this;
+}
+
+
+
+template <typename Number>
+inline
+MultiVector<Number> &
+MultiVector<Number>::operator *= (const Number factor)
+{
+  AssertIsFinite(factor);
+  apply (*this, [factor] (Number *dst, const Number *, const unsigned int n)
+  {
+    for (unsigned int j=0; j<n; ++j)
+      dst[j] *= factor;
+  });
+  return *this;
+}
+
+
+
+template <typename Number>
+inline
+void
+MultiVector<Number>::add (const std::vector<Number>  &a,
+                          const MultiVector<Number> &v)
+{
+  AssertDimension (a.size(), n_vecs);
+  const Number *const coefficients = a.data();
+  apply (v, [coefficients] (Number *dst, const Number *src, const unsigned int n)
+  {
+    for (unsigned int j=0; j<n; ++j)
+      dst[j] += coefficients[j] * src[j];
+  });
+}
+
+
+
+template <typename Number>
+inline
+void
+MultiVector<Number>::sadd (const std::vector<Number>  &s,
+                           const MultiVector<Number> &v)
+{
+  AssertDimension (s.size(), n_vecs);
+  const Number *const coefficients = s.data();
+  apply (v, [coefficients] (Number *dst, const Number *src, const unsigned int n)
+  {
+    for (unsigned int j=0; j<n; ++j)
+      dst[j] = coefficients[j] * dst[j] + src[j];
+  });
+}
+
+
+
+template <typename Number>
+inline
+void
+MultiVector<Number>::inner_products (const MultiVector<Number> &v,
+                                     std::vector<Number>       &products) const
+{
+  reduce (v, [] (const Number a, const Number b)
+  {
+    return a * numbers::NumberTraits<Number>::conjugate(b);
+  }, products);
+}
+
+
+
+template <typename Number>
+inline
+void
+MultiVector<Number>::norms_sqr (std::vector<real_type> &norms) const
+{
+  reduce (*this, [] (const Number a, const Number)
+  {
+    return numbers::NumberTraits<Number>::abs_square(a);
+  }, norms);
+}
+
+
+
+template <typename Number>
+inline
+void
+MultiVector<Number>::l2_norms (std::vector<real_type> &norms) const
+{
+  norms_sqr (norms);
+  for (unsigned int j=0; j<norms.size(); ++j)
+    norms[j] = std::sqrt(norms[j]);
+}
+
+
+
+template <typename Number>
+inline
+std::size_t
+MultiVector<Number>::memory_consumption () const
+{
+  return sizeof(*this) + MemoryConsumption::memory_consumption(values);
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
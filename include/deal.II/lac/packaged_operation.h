@@ -30,6 +30,102 @@ template <typename Range, typename Domain, typename Payload> class LinearOperato
 template <typename Range = Vector<double> > class PackagedOperation;
 
 
+namespace internal
+{
+  namespace PackagedOperationImplementation
+  {
+    // A trait class that determines whether the vector type T provides the
+    // member functions add(a,V) and add(a,V,b,W) that update a vector in a
+    // single pass
+    template <typename T>
+    class has_scaled_add
+    {
+      template <typename C>
+      static std::false_type test(...);
+
+      template <typename C>
+      static auto test(C *c)
+      -> decltype(c->add(typename C::value_type(), *c),
+                  c->add(typename C::value_type(), *c,
+                         typename C::value_type(), *c),
+                  std::true_type());
+
+    public:
+      typedef decltype(test<T>(nullptr)) type;
+    };
+
+
+    // Compute v += a*u + b*w with a single pass over v if the vector type
+    // permits it
+    template <typename Range>
+    void add (Range &v,
+              const typename Range::value_type a, const Range &u,
+              const typename Range::value_type b, const Range &w,
+              std::true_type)
+    {
+      v.add(a, u, b, w);
+    }
+
+
+    template <typename Range>
+    void add (Range &v,
+              const typename Range::value_type a, const Range &u,
+              std::true_type)
+    {
+      v.add(a, u);
+    }
+
+
+    // The variants for vector types that only provide the operators the
+    // PackagedOperation class needs in general
+    template <typename Range>
+    void add (Range &v,
+              const typename Range::value_type a, const Range &u,
+              std::false_type)
+    {
+      if (a == typename Range::value_type(1.))
+        v += u;
+      else if (a == typename Range::value_type(-1.))
+        v -= u;
+      else if (a != typename Range::value_type(0.))
+        {
+          v /= a;
+          v += u;
+          v *= a;
+        }
+    }
+
+
+    template <typename Range>
+    void add (Range &v,
+              const typename Range::value_type a, const Range &u,
+              const typename Range::value_type b, const Range &w,
+              std::false_type)
+    {
+      add(v, a, u, std::false_type());
+      add(v, b, w, std::false_type());
+    }
+
+
+    template <typename Range>
+    void add (Range &v,
+              const typename Range::value_type a, const Range &u)
+    {
+      add(v, a, u, typename has_scaled_add<Range>::type());
+    }
+
+
+    template <typename Range>
+    void add (Range &v,
+              const typename Range::value_type a, const Range &u,
+              const typename Range::value_type b, const Range &w)
+    {
+      add(v, a, u, b, w, typename has_scaled_add<Range>::type());
+    }
+  }
+}
+
+
 /**
  * A class to store a computation.
  *
@@ -48,6 +144,20 @@ template <typename Range = Vector<double> > class PackagedOperation;
  *   std::function<void(Range &)> apply_add;
  * @endcode
  *
+ * Optionally, a PackagedOperation also stores how to add a multiple of its
+ * result to a vector,
+ * @code
+ *   std::function<void(Range &, Range::value_type)> apply_add_scaled;
+ * @endcode
+ * which is used by the vector space operations below to fuse linear
+ * combinations of computations: an expression like
+ * <code>b - alpha * a</code> with vectors <code>a</code> and <code>b</code>
+ * then updates the result in a single pass <code>v.add(-alpha, a)</code>
+ * instead of scaling the result vector back and forth, and a residual
+ * <code>b - op_a * x</code> is computed with a single product and a single
+ * vector update. If <code>apply_add_scaled</code> is not set, it is
+ * implemented in terms of <code>apply_add</code>.
+ *
  * Similar to the LinearOperator class it also has knowledge about how to
  * initialize a vector of the @p Range space:
  * @code
@@ -168,6 +278,11 @@ public:
       v += u;
     };
 
+    apply_add_scaled = [&u](Range &v, typename Range::value_type factor)
+    {
+      internal::PackagedOperationImplementation::add(v, factor, u);
+    };
+
     reinit_vector = [&u](Range &v, bool omit_zeroing_entries)
     {
       v.reinit(u, omit_zeroing_entries);
@@ -258,6 +373,15 @@ public:
    */
   std::function<void(Range &v)> apply_add;
 
+  /**
+   * Add the result of the PackagedOperation multiplied by @p factor to a
+   * vector v of the @p Range space. This member is optional: if it is empty,
+   * the operation is implemented with <code>apply_add</code>. Use the
+   * function internal::PackagedOperationImplementation::apply_add_scaled()
+   * to invoke it.
+   */
+  std::function<void(Range &v, typename Range::value_type factor)> apply_add_scaled;
+
   /**
    * Initializes a vector v of the Range space to be directly usable as the
    * destination parameter in an application of apply, or apply_add. Similar
@@ -269,6 +393,32 @@ public:
 };
 
 
+namespace internal
+{
+  namespace PackagedOperationImplementation
+  {
+    // Add factor times the result of comp to v, with the specialized
+    // variant stored in comp if there is one
+    template <typename Range>
+    void apply_add_scaled (const PackagedOperation<Range> &comp,
+                           Range                          &v,
+                           const typename Range::value_type factor)
+    {
+      if (comp.apply_add_scaled)
+        comp.apply_add_scaled(v, factor);
+      else if (factor == typename Range::value_type(1.))
+        comp.apply_add(v);
+      else if (factor != typename Range::value_type(0.))
+        {
+          v /= factor;
+          comp.apply_add(v);
+          v *= factor;
+        }
+    }
+  }
+}
+
+
 /**
  * @name Vector space operations
  */
@@ -306,6 +456,14 @@ operator+(const PackagedOperation<Range> &first_comp,
     second_comp.apply_add(v);
   };
 
+  return_comp.apply_add_scaled =
+    [first_comp, second_comp](Range &v, typename Range::value_type factor)
+  {
+    using internal::PackagedOperationImplementation::apply_add_scaled;
+    apply_add_scaled(first_comp, v, factor);
+    apply_add_scaled(second_comp, v, factor);
+  };
+
   return return_comp;
 }
 
@@ -329,19 +487,27 @@ operator-(const PackagedOperation<Range> &first_comp,
   // ensure to have valid PackagedOperation objects by catching first_comp and
   // second_comp by value
 
+  // the second result is subtracted with apply_add_scaled, which avoids
+  // flipping the sign of the whole vector before and after
+
   return_comp.apply = [first_comp, second_comp](Range &v)
   {
-    second_comp.apply(v);
-    v *= -1.;
-    first_comp.apply_add(v);
+    first_comp.apply(v);
+    internal::PackagedOperationImplementation::apply_add_scaled(second_comp, v, -1.);
   };
 
   return_comp.apply_add = [first_comp, second_comp](Range &v)
   {
     first_comp.apply_add(v);
-    v *= -1.;
-    second_comp.apply_add(v);
-    v *= -1.;
+    internal::PackagedOperationImplementation::apply_add_scaled(second_comp, v, -1.);
+  };
+
+  return_comp.apply_add_scaled =
+    [first_comp, second_comp](Range &v, typename Range::value_type factor)
+  {
+    using internal::PackagedOperationImplementation::apply_add_scaled;
+    apply_add_scaled(first_comp, v, factor);
+    apply_add_scaled(second_comp, v, -factor);
   };
 
   return return_comp;
@@ -375,6 +541,10 @@ operator*(const PackagedOperation<Range> &comp,
       return_comp.apply_add = [](Range &)
       {
       };
+
+      return_comp.apply_add_scaled = [](Range &, typename Range::value_type)
+      {
+      };
     }
   else
     {
@@ -386,9 +556,13 @@ operator*(const PackagedOperation<Range> &comp,
 
       return_comp.apply_add = [comp, number](Range &v)
       {
-        v /= number;
-        comp.apply_add(v);
-        v *= number;
+        internal::PackagedOperationImplementation::apply_add_scaled(comp, v, number);
+      };
+
+      return_comp.apply_add_scaled =
+        [comp, number](Range &v, typename Range::value_type factor)
+      {
+        internal::PackagedOperationImplementation::apply_add_scaled(comp, v, factor*number);
       };
     }
 
@@ -543,8 +717,12 @@ PackagedOperation<Range> operator+(const Range &u, const Range &v)
 
   return_comp.apply_add = [&u, &v](Range &x)
   {
-    x += u;
-    x += v;
+    internal::PackagedOperationImplementation::add(x, 1., u, 1., v);
+  };
+
+  return_comp.apply_add_scaled = [&u, &v](Range &x, typename Range::value_type factor)
+  {
+    internal::PackagedOperationImplementation::add(x, factor, u, factor, v);
   };
 
   return return_comp;
@@ -588,8 +766,12 @@ PackagedOperation<Range> operator-(const Range &u, const Range &v)
 
   return_comp.apply_add = [&u, &v](Range &x)
   {
-    x += u;
-    x -= v;
+    internal::PackagedOperationImplementation::add(x, 1., u, -1., v);
+  };
+
+  return_comp.apply_add_scaled = [&u, &v](Range &x, typename Range::value_type factor)
+  {
+    internal::PackagedOperationImplementation::add(x, factor, u, -factor, v);
   };
 
   return return_comp;
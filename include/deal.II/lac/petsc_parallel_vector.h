@@ -31,6 +31,14 @@
 
 DEAL_II_NAMESPACE_OPEN
 
+namespace LinearAlgebra
+{
+  namespace distributed
+  {
+    template <typename> class Vector;
+  }
+}
+
 
 /*! @addtogroup PETScWrappers
  *@{
@@ -336,6 +344,22 @@ namespace PETScWrappers
       void reinit (const IndexSet &local,
                    const MPI_Comm &communicator);
 
+      /**
+       * Reinit as a view of the locally owned elements of @p v, i.e., the
+       * PETSc vector is created by <code>VecCreateMPIWithArray</code> and
+       * works directly on the memory of @p v without copying it. This allows
+       * to pass a vector used by the matrix-free framework to a PETSc solver
+       * or preconditioner without copying it back and forth. Changes to the
+       * elements of either vector are visible in the other one.
+       *
+       * The ghost elements of @p v are not part of the view. The vector @p v
+       * must neither be destroyed nor reinitialized as long as the present
+       * object is used as a view into it. The reverse direction is not
+       * provided because a LinearAlgebra::distributed::Vector needs to store
+       * its ghost elements contiguously after the locally owned ones.
+       */
+      void reinit_as_view (LinearAlgebra::distributed::Vector<PetscScalar> &v);
+
       /**
        * Return a reference to the MPI communicator object in use with this
        * vector.
@@ -24,10 +24,16 @@
 #include <deal.II/base/parallel.h>
 #include <deal.II/base/template_constraints.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/lac/cuda_vector.h>
 #include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/read_write_vector.h>
 #include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/sparsity_tools.h>
 #include <deal.II/lac/vector_memory.h>
 
+#include <functional>
+#include <type_traits>
+
 DEAL_II_NAMESPACE_OPEN
 
 // forward declarations
@@ -398,12 +404,27 @@ public:
     /**
      * Constructor.
      */
-    AdditionalData (const double relaxation = 1.);
+    AdditionalData (const double relaxation = 1.,
+                    const bool   use_multicoloring = false);
 
     /**
      * Relaxation parameter.
      */
     double relaxation;
+
+    /**
+     * Flag to select the multicolored variants of the sweeps in
+     * PreconditionSOR and PreconditionSSOR: The rows of the matrix are
+     * colored by SparsityTools::color_sparsity_pattern() such that the rows
+     * of one color do not couple, and the rows of each color are processed
+     * in parallel. This changes the order in which the rows are processed
+     * and thus the result of the preconditioner as compared to the
+     * lexicographic ordering, but gives a preconditioner that runs on
+     * several threads. Only available if the matrix is a SparseMatrix and
+     * the vectors are of type Vector. The other relaxation methods ignore
+     * this flag.
+     */
+    bool use_multicoloring;
   };
 
   /**
@@ -441,6 +462,19 @@ protected:
    * Relaxation parameter.
    */
   double relaxation;
+
+  /**
+   * The rows of the matrix grouped by colors if the multicolored sweeps are
+   * used, empty otherwise.
+   */
+  std::vector<std::vector<types::global_dof_index> > colors;
+
+  /**
+   * Compute the colors of the matrix rows if requested by
+   * AdditionalData::use_multicoloring, as needed by the derived classes
+   * PreconditionSOR and PreconditionSSOR.
+   */
+  void initialize_colors (const AdditionalData &parameters);
 };
 
 
@@ -563,6 +597,13 @@ public:
    */
   typedef typename PreconditionRelaxation<MatrixType>::AdditionalData AdditionalData;
 
+  /**
+   * Initialize matrix and relaxation parameter, and compute the coloring of
+   * the rows if the multicolored variant is selected by @p parameters.
+   */
+  void initialize (const MatrixType     &A,
+                   const AdditionalData &parameters = AdditionalData());
+
   /**
    * Apply preconditioner.
    */
@@ -895,6 +936,32 @@ private:
  * compatibility function that can extract the diagonal in case of a serial
  * computation.
  *
+ * <h4>Merging vector updates into the matrix-vector product</h4>
+ *
+ * If the preconditioner is a DiagonalMatrix around a
+ * LinearAlgebra::distributed::Vector and the matrix provides a function
+ * <tt>vmult(dst, src, operation_before_loop, operation_after_loop)</tt> as
+ * MatrixFreeOperators::Base does, the vector updates of each Chebyshev step
+ * are passed to the matrix as @p operation_after_loop rather than being run
+ * in a separate pass through all vectors after the matrix-vector product.
+ *
+ * <h4>Reusing eigenvalue estimates</h4>
+ *
+ * In time-dependent or nonlinear problems, the preconditioner is often set up
+ * for a sequence of matrices whose spectrum changes only slightly. After the
+ * first vmult(), the estimates can be queried by
+ * get_eigenvalue_information() and stored (the returned object can also be
+ * serialized). When passed in the field
+ * PreconditionChebyshev::AdditionalData::previous_eigenvalue_information to
+ * a subsequent call to initialize(), only
+ * PreconditionChebyshev::AdditionalData::eig_cg_n_revalidation_iterations
+ * CG iterations are run to check whether the largest eigenvalue has grown
+ * beyond the previous estimate. Since a short CG run underestimates the
+ * largest eigenvalue, the previous estimate is reused if the check passes,
+ * and the full estimation with
+ * PreconditionChebyshev::AdditionalData::eig_cg_n_iterations is run
+ * otherwise.
+ *
  * @author Martin Kronbichler, 2009, 2016; extension for full compatibility with
  * LinearOperator class: Jean-Paul Pelteret, 2015
  */
@@ -907,6 +974,48 @@ public:
    */
   typedef types::global_dof_index size_type;
 
+  /**
+   * The result of the eigenvalue estimation performed by this class, as
+   * returned by get_eigenvalue_information().
+   */
+  struct EigenvalueInformation
+  {
+    /**
+     * Constructor. Sets all fields to zero, which marks the object as not
+     * containing an estimate.
+     */
+    EigenvalueInformation ();
+
+    /**
+     * The estimate of the smallest eigenvalue.
+     */
+    double min_eigenvalue_estimate;
+
+    /**
+     * The estimate of the largest eigenvalue, including the safety factor
+     * applied to the result of the CG iteration.
+     */
+    double max_eigenvalue_estimate;
+
+    /**
+     * The number of CG iterations performed for the estimate, or zero if no
+     * iterations were performed.
+     */
+    unsigned int cg_iterations;
+
+    /**
+     * The degree of the Chebyshev polynomial used with these estimates.
+     */
+    unsigned int degree;
+
+    /**
+     * Write or read the data of this object to or from a stream for the
+     * purpose of serialization.
+     */
+    template <class Archive>
+    void serialize (Archive &ar, const unsigned int version);
+  };
+
   // avoid warning about use of deprecated variables
   DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
 
@@ -986,6 +1095,22 @@ public:
      */
     double max_eigenvalue;
 
+    /**
+     * The eigenvalue estimates from a previous setup of the preconditioner,
+     * as obtained by get_eigenvalue_information(). If this object contains
+     * an estimate of the largest eigenvalue and @p eig_cg_n_iterations is
+     * positive, only @p eig_cg_n_revalidation_iterations CG iterations are
+     * performed to check whether the previous estimate is still valid, as
+     * explained in the documentation of the class.
+     */
+    EigenvalueInformation previous_eigenvalue_information;
+
+    /**
+     * Number of CG iterations performed for checking the previous eigenvalue
+     * estimate given by @p previous_eigenvalue_information.
+     */
+    unsigned int eig_cg_n_revalidation_iterations;
+
     /**
      * Stores the inverse of the diagonal of the underlying matrix.
      *
@@ -1060,6 +1185,13 @@ public:
    */
   size_type n () const;
 
+  /**
+   * Return the eigenvalue estimates the preconditioner works with. They are
+   * computed during the first application of the preconditioner after
+   * initialize(), so this function may only be called after that.
+   */
+  const EigenvalueInformation &get_eigenvalue_information () const;
+
 private:
 
   /**
@@ -1105,6 +1237,11 @@ private:
    */
   bool eigenvalues_are_initialized;
 
+  /**
+   * The eigenvalue estimates computed by estimate_eigenvalues().
+   */
+  EigenvalueInformation eigenvalue_information;
+
   /**
    * A mutex to avoid that multiple vmult() invocations by different threads
    * overwrite the temporary vectors.
@@ -1134,6 +1271,15 @@ private:
    * by the user is used.
    */
   void estimate_eigenvalues(const VectorType &src) const;
+
+  /**
+   * Run @p n_iterations steps of a CG iteration and compute the estimates
+   * of the smallest and largest eigenvalues, without the safety factor.
+   * Returns the number of iterations performed.
+   */
+  unsigned int run_eigenvalue_cg(const unsigned int n_iterations,
+                                 double            &min_eigenvalue,
+                                 double            &max_eigenvalue) const;
 };
 
 
@@ -1314,6 +1460,83 @@ PreconditionRichardson::n () const
 
 //---------------------------------------------------------------------------
 
+namespace internal
+{
+  namespace PreconditionRelaxation
+  {
+    /**
+     * The operations of PreconditionSOR and PreconditionSSOR for which
+     * SparseMatrix provides a multicolored variant.
+     */
+    enum class Sweep
+    {
+      precondition_SSOR,
+      precondition_SOR,
+      precondition_TSOR,
+      SOR_step,
+      TSOR_step,
+      SSOR_step
+    };
+
+    /**
+     * Run the multicolored variant of the given sweep. General matrix and
+     * vector types do not provide the multicolored variants.
+     */
+    template <typename MatrixType, typename VectorType, typename IndexType>
+    void
+    multicolored_sweep (const MatrixType                           &,
+                        VectorType                                 &,
+                        const VectorType                           &,
+                        const double,
+                        const std::vector<std::vector<IndexType> > &,
+                        const Sweep)
+    {
+      AssertThrow (false,
+                   ExcMessage ("The multicolored relaxation methods are only "
+                               "implemented for SparseMatrix and Vector."));
+    }
+
+    /**
+     * Run the multicolored variant of the given sweep for a SparseMatrix.
+     */
+    template <typename number, typename somenumber>
+    void
+    multicolored_sweep (const dealii::SparseMatrix<number>                          &A,
+                        dealii::Vector<somenumber>                                  &dst,
+                        const dealii::Vector<somenumber>                            &src,
+                        const double                                                 omega,
+                        const std::vector<std::vector<types::global_dof_index> > &colors,
+                        const Sweep                                                  sweep)
+    {
+      switch (sweep)
+        {
+        case Sweep::precondition_SSOR:
+          A.precondition_SSOR (dst, src, omega, colors);
+          break;
+        case Sweep::precondition_SOR:
+          A.precondition_SOR (dst, src, omega, colors);
+          break;
+        case Sweep::precondition_TSOR:
+          A.precondition_TSOR (dst, src, omega, colors);
+          break;
+        case Sweep::SOR_step:
+          A.SOR_step (dst, src, omega, colors);
+          break;
+        case Sweep::TSOR_step:
+          A.TSOR_step (dst, src, omega, colors);
+          break;
+        case Sweep::SSOR_step:
+          A.SSOR_step (dst, src, omega, colors);
+          break;
+        default:
+          Assert (false, ExcNotImplemented());
+        }
+    }
+  }
+}
+
+
+
 template <typename MatrixType>
 inline void
 PreconditionRelaxation<MatrixType>::initialize (const MatrixType     &rA,
@@ -1321,6 +1544,7 @@ PreconditionRelaxation<MatrixType>::initialize (const MatrixType     &rA,
 {
   A = &rA;
   relaxation = parameters.relaxation;
+  colors.clear();
 }
 
 
@@ -1329,6 +1553,25 @@ inline void
 PreconditionRelaxation<MatrixType>::clear ()
 {
   A = nullptr;
+  colors.clear();
+}
+
+
+
+template <typename MatrixType>
+inline void
+PreconditionRelaxation<MatrixType>::initialize_colors (const AdditionalData &parameters)
+{
+  colors.clear();
+  if (parameters.use_multicoloring == false)
+    return;
+
+  const SparseMatrix<typename MatrixType::value_type> *mat =
+    dynamic_cast<const SparseMatrix<typename MatrixType::value_type> *>(&*A);
+  AssertThrow (mat != nullptr,
+               ExcMessage ("The multicolored relaxation methods are only "
+                           "implemented for SparseMatrix objects."));
+  SparsityTools::color_sparsity_pattern (mat->get_sparsity_pattern(), colors);
 }
 
 template <typename MatrixType>
@@ -1410,6 +1653,17 @@ PreconditionJacobi<MatrixType>::Tstep (VectorType &dst, const VectorType &src) c
 
 //---------------------------------------------------------------------------
 
+template <typename MatrixType>
+inline void
+PreconditionSOR<MatrixType>::initialize (const MatrixType     &rA,
+                                         const AdditionalData &parameters)
+{
+  this->PreconditionRelaxation<MatrixType>::initialize (rA, parameters);
+  this->initialize_colors (parameters);
+}
+
+
+
 template <typename MatrixType>
 template <class VectorType>
 inline void
@@ -1420,7 +1674,12 @@ PreconditionSOR<MatrixType>::vmult (VectorType &dst, const VectorType &src) cons
     "PreconditionSOR and VectorType must have the same size_type.");
 
   Assert (this->A!=nullptr, ExcNotInitialized());
-  this->A->precondition_SOR (dst, src, this->relaxation);
+  if (this->colors.empty())
+    this->A->precondition_SOR (dst, src, this->relaxation);
+  else
+    internal::PreconditionRelaxation::multicolored_sweep
+    (*this->A, dst, src, this->relaxation, this->colors,
+     internal::PreconditionRelaxation::Sweep::precondition_SOR);
 }
 
 
@@ -1435,7 +1694,12 @@ PreconditionSOR<MatrixType>::Tvmult (VectorType &dst, const VectorType &src) con
     "PreconditionSOR and VectorType must have the same size_type.");
 
   Assert (this->A!=nullptr, ExcNotInitialized());
-  this->A->precondition_TSOR (dst, src, this->relaxation);
+  if (this->colors.empty())
+    this->A->precondition_TSOR (dst, src, this->relaxation);
+  else
+    internal::PreconditionRelaxation::multicolored_sweep
+    (*this->A, dst, src, this->relaxation, this->colors,
+     internal::PreconditionRelaxation::Sweep::precondition_TSOR);
 }
 
 
@@ -1450,7 +1714,12 @@ PreconditionSOR<MatrixType>::step (VectorType &dst, const VectorType &src) const
     "PreconditionSOR and VectorType must have the same size_type.");
 
   Assert (this->A!=nullptr, ExcNotInitialized());
-  this->A->SOR_step (dst, src, this->relaxation);
+  if (this->colors.empty())
+    this->A->SOR_step (dst, src, this->relaxation);
+  else
+    internal::PreconditionRelaxation::multicolored_sweep
+    (*this->A, dst, src, this->relaxation, this->colors,
+     internal::PreconditionRelaxation::Sweep::SOR_step);
 }
 
 
@@ -1465,7 +1734,12 @@ PreconditionSOR<MatrixType>::Tstep (VectorType &dst, const VectorType &src) cons
     "PreconditionSOR and VectorType must have the same size_type.");
 
   Assert (this->A!=nullptr, ExcNotInitialized());
-  this->A->TSOR_step (dst, src, this->relaxation);
+  if (this->colors.empty())
+    this->A->TSOR_step (dst, src, this->relaxation);
+  else
+    internal::PreconditionRelaxation::multicolored_sweep
+    (*this->A, dst, src, this->relaxation, this->colors,
+     internal::PreconditionRelaxation::Sweep::TSOR_step);
 }
 
 
@@ -1478,6 +1752,7 @@ PreconditionSSOR<MatrixType>::initialize (const MatrixType                     &
                                           const typename BaseClass::AdditionalData &parameters)
 {
   this->PreconditionRelaxation<MatrixType>::initialize (rA, parameters);
+  this->initialize_colors (parameters);
 
   // in case we have a SparseMatrix class, we can extract information about
   // the diagonal.
@@ -1516,7 +1791,12 @@ PreconditionSSOR<MatrixType>::vmult (VectorType &dst, const VectorType &src) con
     "PreconditionSSOR and VectorType must have the same size_type.");
 
   Assert (this->A!=nullptr, ExcNotInitialized());
-  this->A->precondition_SSOR (dst, src, this->relaxation, pos_right_of_diagonal);
+  if (this->colors.empty())
+    this->A->precondition_SSOR (dst, src, this->relaxation, pos_right_of_diagonal);
+  else
+    internal::PreconditionRelaxation::multicolored_sweep
+    (*this->A, dst, src, this->relaxation, this->colors,
+     internal::PreconditionRelaxation::Sweep::precondition_SSOR);
 }
 
 
@@ -1531,7 +1811,12 @@ PreconditionSSOR<MatrixType>::Tvmult (VectorType &dst, const VectorType &src) co
     "PreconditionSSOR and VectorType must have the same size_type.");
 
   Assert (this->A!=nullptr, ExcNotInitialized());
-  this->A->precondition_SSOR (dst, src, this->relaxation, pos_right_of_diagonal);
+  if (this->colors.empty())
+    this->A->precondition_SSOR (dst, src, this->relaxation, pos_right_of_diagonal);
+  else
+    internal::PreconditionRelaxation::multicolored_sweep
+    (*this->A, dst, src, this->relaxation, this->colors,
+     internal::PreconditionRelaxation::Sweep::precondition_SSOR);
 }
 
 
@@ -1546,7 +1831,12 @@ PreconditionSSOR<MatrixType>::step (VectorType &dst, const VectorType &src) cons
     "PreconditionSSOR and VectorType must have the same size_type.");
 
   Assert (this->A!=nullptr, ExcNotInitialized());
-  this->A->SSOR_step (dst, src, this->relaxation);
+  if (this->colors.empty())
+    this->A->SSOR_step (dst, src, this->relaxation);
+  else
+    internal::PreconditionRelaxation::multicolored_sweep
+    (*this->A, dst, src, this->relaxation, this->colors,
+     internal::PreconditionRelaxation::Sweep::SSOR_step);
 }
 
 
@@ -1662,9 +1952,11 @@ PreconditionUseMatrix<MatrixType,VectorType>::vmult (VectorType       &dst,
 template <typename MatrixType>
 inline
 PreconditionRelaxation<MatrixType>::AdditionalData::
-AdditionalData (const double relaxation)
+AdditionalData (const double relaxation,
+                const bool   use_multicoloring)
   :
-  relaxation (relaxation)
+  relaxation (relaxation),
+  use_multicoloring (use_multicoloring)
 {}
 
 
@@ -1857,6 +2149,137 @@ namespace internal
       VectorUpdatesRange<Number>(upd, src.local_size());
     }
 
+#ifdef DEAL_II_WITH_CUDA
+    // selection for diagonal matrix around vectors on the device, where the
+    // updates are run by a single kernel
+    template <typename Number>
+    inline
+    void
+    vector_updates (const LinearAlgebra::CUDAWrappers::Vector<Number> &src,
+                    const DiagonalMatrix<LinearAlgebra::CUDAWrappers::Vector<Number> > &jacobi,
+                    const bool    start_zero,
+                    const double  factor1,
+                    const double  factor2,
+                    LinearAlgebra::CUDAWrappers::Vector<Number> &update1,
+                    LinearAlgebra::CUDAWrappers::Vector<Number> &update2,
+                    LinearAlgebra::CUDAWrappers::Vector<Number> &,
+                    LinearAlgebra::CUDAWrappers::Vector<Number> &dst)
+    {
+      LinearAlgebra::CUDAWrappers::internal::chebyshev_vector_updates
+      (src, jacobi.get_vector(), start_zero, static_cast<Number>(factor1),
+       static_cast<Number>(factor2), update1, update2, dst);
+    }
+#endif
+
+    // a trait class that determines whether the matrix provides a vmult()
+    // function that accepts two function objects that are run on ranges of
+    // the vector entries before and after the matrix-vector product, like
+    // MatrixFreeOperators::Base
+    template <typename MatrixType, typename VectorType>
+    class has_vmult_with_std_functions
+    {
+      template <typename T>
+      static std::false_type test(...);
+
+      template <typename T>
+      static auto test(VectorType *v)
+      -> decltype(std::declval<const T>().vmult
+                  (*v, *v,
+                   std::function<void(const unsigned int, const unsigned int)>(),
+                   std::function<void(const unsigned int, const unsigned int)>()),
+                  std::true_type());
+
+    public:
+      static const bool value = decltype(test<MatrixType>(nullptr))::value;
+    };
+
+    // generic part: run the matrix-vector product and the vector updates one
+    // after the other
+    template <typename MatrixType, typename VectorType, typename PreconditionerType>
+    inline
+    void
+    vmult_and_update (const MatrixType         &matrix,
+                      const PreconditionerType &preconditioner,
+                      const VectorType         &src,
+                      const double              factor1,
+                      const double              factor2,
+                      VectorType               &update1,
+                      VectorType               &update2,
+                      VectorType               &update3,
+                      VectorType               &dst)
+    {
+      matrix.vmult (update2, dst);
+      vector_updates (src, preconditioner, false, factor1, factor2,
+                      update1, update2, update3, dst);
+    }
+
+    template <typename MatrixType, typename Number>
+    inline
+    void
+    vmult_and_update (const MatrixType                                                  &matrix,
+                      const DiagonalMatrix<LinearAlgebra::distributed::Vector<Number> > &jacobi,
+                      const LinearAlgebra::distributed::Vector<Number>                 &src,
+                      const double                                                      factor1,
+                      const double                                                      factor2,
+                      LinearAlgebra::distributed::Vector<Number>                       &update1,
+                      LinearAlgebra::distributed::Vector<Number>                       &update2,
+                      LinearAlgebra::distributed::Vector<Number>                       &update3,
+                      LinearAlgebra::distributed::Vector<Number>                       &dst,
+                      const std::false_type)
+    {
+      matrix.vmult (update2, dst);
+      vector_updates (src, jacobi, false, factor1, factor2,
+                      update1, update2, update3, dst);
+    }
+
+    // the matrix can run the vector updates as part of its matrix-vector
+    // product, which saves one pass through all vectors
+    template <typename MatrixType, typename Number>
+    inline
+    void
+    vmult_and_update (const MatrixType                                                  &matrix,
+                      const DiagonalMatrix<LinearAlgebra::distributed::Vector<Number> > &jacobi,
+                      const LinearAlgebra::distributed::Vector<Number>                 &src,
+                      const double                                                      factor1,
+                      const double                                                      factor2,
+                      LinearAlgebra::distributed::Vector<Number>                       &update1,
+                      LinearAlgebra::distributed::Vector<Number>                       &update2,
+                      LinearAlgebra::distributed::Vector<Number>                       &,
+                      LinearAlgebra::distributed::Vector<Number>                       &dst,
+                      const std::true_type)
+    {
+      // the matrix may change the layout of the ghost range of update2, so
+      // only access the vector data once the matrix has run
+      matrix.vmult (update2, dst,
+                    std::function<void(const unsigned int, const unsigned int)>(),
+                    [&] (const unsigned int begin, const unsigned int end)
+      {
+        VectorUpdater<Number> upd(src.begin(), jacobi.get_vector().begin(),
+                                  false, factor1, factor2,
+                                  update1.begin(), update2.begin(), dst.begin());
+        upd.apply_to_subrange (begin, end);
+      });
+    }
+
+    template <typename MatrixType, typename Number>
+    inline
+    void
+    vmult_and_update (const MatrixType                                                  &matrix,
+                      const DiagonalMatrix<LinearAlgebra::distributed::Vector<Number> > &jacobi,
+                      const LinearAlgebra::distributed::Vector<Number>                 &src,
+                      const double                                                      factor1,
+                      const double                                                      factor2,
+                      LinearAlgebra::distributed::Vector<Number>                       &update1,
+                      LinearAlgebra::distributed::Vector<Number>                       &update2,
+                      LinearAlgebra::distributed::Vector<Number>                       &update3,
+                      LinearAlgebra::distributed::Vector<Number>                       &dst)
+    {
+      vmult_and_update (matrix, jacobi, src, factor1, factor2,
+                        update1, update2, update3, dst,
+                        std::integral_constant<bool,has_vmult_with_std_functions
+                        <MatrixType,LinearAlgebra::distributed::Vector<Number> >::value>());
+    }
+
     template <typename MatrixType, typename VectorType, typename PreconditionerType>
     inline
     void
@@ -1903,6 +2326,36 @@ namespace internal
         }
     }
 
+#ifdef DEAL_II_WITH_CUDA
+    // the entries of a matrix on the device can not be accessed from the
+    // host, so the diagonal needs to be provided by the user
+    template <typename MatrixType, typename Number>
+    inline
+    void
+    initialize_preconditioner(const MatrixType                                                                 &matrix,
+                              std::shared_ptr<DiagonalMatrix<LinearAlgebra::CUDAWrappers::Vector<Number> > > &preconditioner,
+                              LinearAlgebra::CUDAWrappers::Vector<Number>                                      &diagonal_inverse)
+    {
+      if (preconditioner.get() == nullptr ||
+          preconditioner->m() != matrix.m())
+        {
+          if (preconditioner.get() == nullptr)
+            preconditioner.reset(new DiagonalMatrix<LinearAlgebra::CUDAWrappers::Vector<Number> >());
+
+          preconditioner->reinit(diagonal_inverse);
+          {
+            LinearAlgebra::CUDAWrappers::Vector<Number> empty_vector;
+            diagonal_inverse.reinit(empty_vector);
+          }
+
+          AssertThrow(preconditioner->m() == matrix.m(),
+                      ExcMessage("For vectors on the device, the inverse of the "
+                                 "matrix diagonal needs to be set in "
+                                 "AdditionalData::preconditioner."));
+        }
+    }
+#endif
+
     template <typename VectorType>
     void set_initial_guess(VectorType &vector)
     {
@@ -1944,6 +2397,22 @@ namespace internal
       vector.add(-mean_value);
     }
 
+#ifdef DEAL_II_WITH_CUDA
+    template <typename Number>
+    void set_initial_guess(::dealii::LinearAlgebra::CUDAWrappers::Vector<Number> &vector)
+    {
+      // Set the same high-frequency mode as for the vectors on the host,
+      // which is copied to the device once
+      LinearAlgebra::ReadWriteVector<Number> host_vector(vector.locally_owned_elements());
+      for (unsigned int i=0; i<vector.size(); ++i)
+        host_vector.local_element(i) = i%11;
+      vector.import(host_vector, VectorOperation::insert);
+
+      const Number mean_value = vector.mean_value();
+      vector.add(-mean_value);
+    }
+#endif
+
     struct EigenvalueTracker
     {
     public:
@@ -1960,6 +2429,31 @@ namespace internal
 
 
 // avoid warning about deprecated variable nonzero_starting
+template <typename MatrixType, class VectorType, typename PreconditionerType>
+inline
+PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::EigenvalueInformation::
+EigenvalueInformation ()
+  :
+  min_eigenvalue_estimate (0.),
+  max_eigenvalue_estimate (0.),
+  cg_iterations (0),
+  degree (0)
+{}
+
+
+
+template <typename MatrixType, class VectorType, typename PreconditionerType>
+template <class Archive>
+inline
+void
+PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::EigenvalueInformation::
+serialize (Archive &ar, const unsigned int)
+{
+  ar &min_eigenvalue_estimate &max_eigenvalue_estimate &cg_iterations &degree;
+}
+
+
+
 DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
 
 template <typename MatrixType, class VectorType, typename PreconditionerType>
@@ -1977,7 +2471,8 @@ AdditionalData (const unsigned int degree,
   nonzero_starting (nonzero_starting),
   eig_cg_n_iterations (eig_cg_n_iterations),
   eig_cg_residual (eig_cg_residual),
-  max_eigenvalue (max_eigenvalue)
+  max_eigenvalue (max_eigenvalue),
+  eig_cg_n_revalidation_iterations (4)
 {}
 
 DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
@@ -2023,6 +2518,7 @@ void
 PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::clear ()
 {
   eigenvalues_are_initialized = false;
+  eigenvalue_information = EigenvalueInformation();
   theta = delta = 1.0;
   matrix_ptr = nullptr;
   {
@@ -2039,6 +2535,55 @@ DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
 
 
 
+template <typename MatrixType, typename VectorType, typename PreconditionerType>
+inline
+unsigned int
+PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::run_eigenvalue_cg
+(const unsigned int n_iterations,
+ double            &min_eigenvalue,
+ double            &max_eigenvalue) const
+{
+  Assert (n_iterations > 2,
+          ExcMessage ("Need to set at least two iterations to find eigenvalues."));
+
+  // set a very strict tolerance to force at least two iterations
+  ReductionControl control (n_iterations,
+                            std::sqrt(std::numeric_limits<typename VectorType::value_type>::epsilon()),
+                            1e-10, false, false);
+
+  internal::PreconditionChebyshev::EigenvalueTracker eigenvalue_tracker;
+  SolverCG<VectorType> solver (control);
+  solver.connect_eigenvalues_slot(std::bind(&internal::PreconditionChebyshev::EigenvalueTracker::slot,
+                                            &eigenvalue_tracker,
+                                            std::placeholders::_1));
+
+  // set an initial guess which is close to the constant vector but where
+  // one entry is different to trigger high frequencies
+  update1 = 0.;
+  internal::PreconditionChebyshev::set_initial_guess(update2);
+
+  try
+    {
+      solver.solve(*matrix_ptr, update1, update2, *data.preconditioner);
+    }
+  catch (SolverControl::NoConvergence &)
+    {
+    }
+
+  // read the eigenvalues from the attached eigenvalue tracker
+  if (eigenvalue_tracker.values.empty())
+    min_eigenvalue = max_eigenvalue = 1;
+  else
+    {
+      min_eigenvalue = eigenvalue_tracker.values.front();
+      max_eigenvalue = eigenvalue_tracker.values.back();
+    }
+
+  return control.last_step();
+}
+
+
+
 template <typename MatrixType, typename VectorType, typename PreconditionerType>
 inline
 void
@@ -2051,48 +2596,44 @@ PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::estimate_eigenv
   update1.reinit(src);
   update2.reinit(src, true);
 
+  EigenvalueInformation &info
+    = const_cast<PreconditionChebyshev<MatrixType,VectorType,PreconditionerType> *>(this)->eigenvalue_information;
+  info = EigenvalueInformation();
+
   // calculate largest eigenvalue using a hand-tuned CG iteration on the
   // matrix weighted by its diagonal. we start with a vector that consists of
   // ones only, weighted by the length.
   double max_eigenvalue, min_eigenvalue;
   if (data.eig_cg_n_iterations > 0)
     {
-      Assert (data.eig_cg_n_iterations > 2,
-              ExcMessage ("Need to set at least two iterations to find eigenvalues."));
-
-      // set a very strict tolerance to force at least two iterations
-      ReductionControl control (data.eig_cg_n_iterations,
-                                std::sqrt(std::numeric_limits<typename VectorType::value_type>::epsilon()),
-                                1e-10, false, false);
-
-      internal::PreconditionChebyshev::EigenvalueTracker eigenvalue_tracker;
-      SolverCG<VectorType> solver (control);
-      solver.connect_eigenvalues_slot(std::bind(&internal::PreconditionChebyshev::EigenvalueTracker::slot,
-                                                &eigenvalue_tracker,
-                                                std::placeholders::_1));
-
-      // set an initial guess which is close to the constant vector but where
-      // one entry is different to trigger high frequencies
-      internal::PreconditionChebyshev::set_initial_guess(update2);
-
-      try
-        {
-          solver.solve(*matrix_ptr, update1, update2, *data.preconditioner);
-        }
-      catch (SolverControl::NoConvergence &)
+      bool previous_estimate_is_valid = false;
+
+      // if we got an estimate from a previous setup, check with a few CG
+      // iterations whether it still bounds the spectrum. a short CG run can
+      // only underestimate the largest eigenvalue, so we keep the previous
+      // estimate unless the short run already finds a larger eigenvalue
+      const EigenvalueInformation &previous = data.previous_eigenvalue_information;
+      if (previous.max_eigenvalue_estimate > 0.)
         {
+          info.cg_iterations = run_eigenvalue_cg(data.eig_cg_n_revalidation_iterations,
+                                                 min_eigenvalue, max_eigenvalue);
+          if (max_eigenvalue <= previous.max_eigenvalue_estimate)
+            {
+              previous_estimate_is_valid = true;
+              min_eigenvalue = std::min(min_eigenvalue,
+                                        previous.min_eigenvalue_estimate);
+              max_eigenvalue = previous.max_eigenvalue_estimate;
+            }
         }
 
-      // read the eigenvalues from the attached eigenvalue tracker
-      if (eigenvalue_tracker.values.empty())
-        min_eigenvalue = max_eigenvalue = 1;
-      else
+      if (previous_estimate_is_valid == false)
         {
-          min_eigenvalue = eigenvalue_tracker.values.front();
+          info.cg_iterations += run_eigenvalue_cg(data.eig_cg_n_iterations,
+                                                  min_eigenvalue, max_eigenvalue);
 
           // include a safety factor since the CG method will in general not
           // be converged
-          max_eigenvalue = 1.2*eigenvalue_tracker.values.back();
+          max_eigenvalue *= 1.2;
         }
     }
   else
@@ -2101,6 +2642,9 @@ PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::estimate_eigenv
       min_eigenvalue = data.max_eigenvalue/data.smoothing_range;
     }
 
+  info.min_eigenvalue_estimate = min_eigenvalue;
+  info.max_eigenvalue_estimate = max_eigenvalue;
+
   const double alpha = (data.smoothing_range > 1. ?
                         max_eigenvalue / data.smoothing_range :
                         std::min(0.9*max_eigenvalue, min_eigenvalue));
@@ -2118,6 +2662,7 @@ PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::estimate_eigenv
       const_cast<PreconditionChebyshev<MatrixType,VectorType,PreconditionerType> *>(this)->data.degree
         = 1+std::log(1./eps+std::sqrt(1./eps/eps-1))/std::log(1./sigma);
     }
+  info.degree = data.degree;
 
   const_cast<PreconditionChebyshev<MatrixType,VectorType,PreconditionerType> *>(this)->delta = (max_eigenvalue-alpha)*0.5;
   const_cast<PreconditionChebyshev<MatrixType,VectorType,PreconditionerType> *>(this)->theta = (max_eigenvalue+alpha)*0.5;
@@ -2128,6 +2673,10 @@ PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::estimate_eigenv
       (std::is_same<VectorType,dealii::Vector<typename VectorType::value_type> >::value == false
        &&
        std::is_same<VectorType,LinearAlgebra::distributed::Vector<typename VectorType::value_type> >::value == false
+#ifdef DEAL_II_WITH_CUDA
+       &&
+       std::is_same<VectorType,LinearAlgebra::CUDAWrappers::Vector<typename VectorType::value_type> >::value == false
+#endif
       ))
     update3.reinit (src, true);
 
@@ -2151,12 +2700,11 @@ PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>
   double rhok  = delta / theta,  sigma = theta / delta;
   for (unsigned int k=0; k<data.degree; ++k)
     {
-      matrix_ptr->vmult (update2, dst);
       const double rhokp = 1./(2.*sigma-rhok);
       const double factor1 = rhokp * rhok, factor2 = 2.*rhokp/delta;
       rhok = rhokp;
-      internal::PreconditionChebyshev::vector_updates
-      (src, *data.preconditioner, false, factor1, factor2, update1, update2, update3, dst);
+      internal::PreconditionChebyshev::vmult_and_update
+      (*matrix_ptr, *data.preconditioner, src, factor1, factor2, update1, update2, update3, dst);
     }
 }
 
@@ -2232,9 +2780,8 @@ PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>
   if (eigenvalues_are_initialized == false)
     estimate_eigenvalues(src);
 
-  matrix_ptr->vmult (update2, dst);
-  internal::PreconditionChebyshev::vector_updates
-  (src, *data.preconditioner, false, 0., 1./theta, update1, update2, update3, dst);
+  internal::PreconditionChebyshev::vmult_and_update
+  (*matrix_ptr, *data.preconditioner, src, 0., 1./theta, update1, update2, update3, dst);
 
   do_chebyshev_loop(dst, src);
 }
@@ -2261,6 +2808,19 @@ PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>
 
 
 
+template <typename MatrixType, typename VectorType, typename PreconditionerType>
+inline
+const typename PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::EigenvalueInformation &
+PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::get_eigenvalue_information () const
+{
+  Assert (eigenvalues_are_initialized,
+          ExcMessage("The eigenvalues are only estimated during the first "
+                     "application of the preconditioner."));
+  return eigenvalue_information;
+}
+
+
+
 template <typename MatrixType, typename VectorType, typename PreconditionerType>
 inline
 typename PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::size_type
@@ -18,6 +18,7 @@
 
 #include <deal.II/base/subscriptor.h>
 #include <deal.II/base/smartpointer.h>
+#include <deal.II/base/aligned_vector.h>
 #include <deal.II/lac/vector.h>
 #include <deal.II/lac/precondition_block_base.h>
 #include <deal.II/lac/sparsity_pattern.h>
@@ -46,6 +47,21 @@ DEAL_II_NAMESPACE_OPEN
  * Parallel computations require you to specify an initialized
  * ghost vector in AdditionalData::temp_ghost_vector.
  *
+ * <h3>Multithreading</h3>
+ *
+ * The inverses of the diagonal blocks are always computed in parallel. The
+ * relaxation step itself is sequential by default, since each block uses
+ * the values computed by the blocks before it. If
+ * AdditionalData::use_coloring is set, the blocks are instead grouped into
+ * colors by GraphColoring::make_graph_coloring() during initialize(), such
+ * that no two blocks of the same color write to an index the other one
+ * reads. The colors are then processed one after the other, with all blocks
+ * of one color processed in parallel. For the Gauss-Seidel type methods
+ * RelaxationBlockSOR and RelaxationBlockSSOR this amounts to a multicolor
+ * ordering of the blocks, which in general gives different (but equally
+ * convergent) iterates than the sequential ordering. For
+ * RelaxationBlockJacobi, the result does not change.
+ *
  * @ingroup Preconditioners
  * @author Guido Kanschat
  * @date 2010
@@ -168,6 +184,32 @@ public:
      */
     mutable VectorType *temp_ghost_vector;
 
+    /**
+     * Process the blocks in colors, and the blocks within each color in
+     * parallel, as described in the documentation of this class. This flag
+     * cannot be combined with a user-defined #order. Defaults to false.
+     *
+     * Within a color, the blocks are only processed in parallel if
+     * #temp_ghost_vector is not set and the inversion method is not
+     * PreconditionBlockBase::svd, since neither the parallel vector types
+     * nor LAPACKFullMatrix::vmult() can be used concurrently from several
+     * threads.
+     */
+    bool use_coloring;
+
+    /**
+     * Store the inverses of all diagonal blocks in a single contiguous
+     * array instead of one FullMatrix object per block. This avoids many
+     * small memory allocations and improves the data locality during the
+     * relaxation steps. Only available for the inversion method
+     * PreconditionBlockBase::gauss_jordan and if #same_diagonal is false.
+     * Defaults to false.
+     *
+     * @note If this flag is set, the inverse() function does not give
+     * access to the inverse blocks.
+     */
+    bool contiguous_inverses;
+
     /**
      * Return the memory allocated in this object.
      */
@@ -243,6 +285,35 @@ private:
    * Computes (the inverse of) a range of blocks.
    */
   void block_kernel(const size_type block_begin, const size_type block_end);
+
+  /**
+   * Perform the relaxation step restricted to a single block, using @p
+   * b_cell and @p x_cell as temporary storage.
+   */
+  void do_block_step (const size_type                          block,
+                      VectorType                              &dst,
+                      const VectorType                        &prev,
+                      const VectorType                        &src,
+                      Vector<typename VectorType::value_type> &b_cell,
+                      Vector<typename VectorType::value_type> &x_cell) const;
+
+  /**
+   * The colors of the blocks if AdditionalData::use_coloring is set, and
+   * empty otherwise.
+   */
+  std::vector<std::vector<unsigned int> > colors;
+
+  /**
+   * The inverses of all diagonal blocks in row-major order if
+   * AdditionalData::contiguous_inverses is set, and empty otherwise.
+   */
+  AlignedVector<InverseNumberType> contiguous_inverse_data;
+
+  /**
+   * The position of the inverse of each block in #contiguous_inverse_data,
+   * with one additional entry for the end of the last block.
+   */
+  std::vector<std::size_t> contiguous_inverse_offsets;
 };
 
 
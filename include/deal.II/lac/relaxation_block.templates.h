@@ -16,11 +16,15 @@
 #ifndef dealii_relaxation_block_templates_h
 #define dealii_relaxation_block_templates_h
 
+#include <deal.II/base/graph_coloring.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/lac/relaxation_block.h>
 #include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/vector_memory.h>
 #include <deal.II/lac/trilinos_vector.h>
 
+#include <algorithm>
+
 DEAL_II_NAMESPACE_OPEN
 
 template <typename MatrixType, typename InverseNumberType, typename VectorType>
@@ -38,7 +42,9 @@ RelaxationBlock<MatrixType, InverseNumberType, VectorType>::AdditionalData::Addi
   same_diagonal(same_diagonal),
   inversion(inversion),
   threshold(threshold),
-  temp_ghost_vector (temp_ghost_vector)
+  temp_ghost_vector (temp_ghost_vector),
+  use_coloring (false),
+  contiguous_inverses (false)
 {}
 
 
@@ -73,6 +79,71 @@ RelaxationBlock<MatrixType, InverseNumberType, VectorType>::initialize (const Ma
   this->reinit(additional_data->block_list.n_rows(), 0, additional_data->same_diagonal,
                additional_data->inversion);
 
+  const size_type n_blocks = additional_data->block_list.n_rows();
+
+  if (additional_data->contiguous_inverses)
+    {
+      Assert (additional_data->inversion == PreconditionBlockBase<InverseNumberType>::gauss_jordan,
+              ExcNotImplemented());
+      Assert (additional_data->same_diagonal == false, ExcNotImplemented());
+
+      contiguous_inverse_offsets.resize(n_blocks+1);
+      contiguous_inverse_offsets[0] = 0;
+      for (size_type block=0; block<n_blocks; ++block)
+        {
+          const std::size_t bs = additional_data->block_list.row_length(block);
+          contiguous_inverse_offsets[block+1] = contiguous_inverse_offsets[block] + bs*bs;
+        }
+      contiguous_inverse_data.resize_fast(contiguous_inverse_offsets.back());
+    }
+
+  if (additional_data->use_coloring && n_blocks > 0)
+    {
+      Assert (additional_data->order.size() == 0,
+              ExcMessage("The coloring of the blocks cannot be combined with "
+                         "a user-defined order of the blocks."));
+
+      // two blocks may be processed at the same time if neither writes to an
+      // index the other one reads. since a block reads the entries of prev
+      // in all columns coupling to its indices, use all these columns as
+      // conflict indices
+      std::vector<unsigned int> block_indices (n_blocks);
+      for (unsigned int i=0; i<n_blocks; ++i)
+        block_indices[i] = i;
+
+      typedef std::vector<unsigned int>::const_iterator BlockIterator;
+      const std::function<std::vector<types::global_dof_index> (const BlockIterator &)>
+      get_conflict_indices = [&M, this] (const BlockIterator &block)
+      {
+        std::vector<types::global_dof_index> indices;
+        for (SparsityPattern::iterator row = this->additional_data->block_list.begin(*block);
+             row != this->additional_data->block_list.end(*block); ++row)
+          {
+            indices.push_back (row->column());
+            for (typename MatrixType::const_iterator entry = M.begin(row->column());
+                 entry != M.end(row->column()); ++entry)
+              indices.push_back (entry->column());
+          }
+        std::sort (indices.begin(), indices.end());
+        indices.erase (std::unique(indices.begin(), indices.end()), indices.end());
+        return indices;
+      };
+
+      const std::vector<std::vector<BlockIterator> > coloring
+        = GraphColoring::make_graph_coloring (BlockIterator(block_indices.begin()),
+                                              BlockIterator(block_indices.end()),
+                                              get_conflict_indices);
+
+      colors.resize(coloring.size());
+      for (unsigned int c=0; c<coloring.size(); ++c)
+        {
+          colors[c].reserve(coloring[c].size());
+          for (unsigned int i=0; i<coloring[c].size(); ++i)
+            colors[c].push_back(*coloring[c][i]);
+          std::sort(colors[c].begin(), colors[c].end());
+        }
+    }
+
   if (additional_data->invert_diagonal)
     invert_diagblocks();
 }
@@ -85,6 +156,9 @@ RelaxationBlock<MatrixType, InverseNumberType, VectorType>::clear ()
 {
   A = nullptr;
   additional_data = nullptr;
+  colors.clear();
+  contiguous_inverse_data.clear();
+  contiguous_inverse_offsets.clear();
   PreconditionBlockBase<InverseNumberType>::clear ();
 }
 
@@ -147,8 +221,19 @@ RelaxationBlock<MatrixType, InverseNumberType, VectorType>::block_kernel (const
       switch (this->inversion)
         {
         case PreconditionBlockBase<InverseNumberType>::gauss_jordan:
-          this->inverse(block).reinit(bs, bs);
-          this->inverse(block).invert(M_cell);
+          if (this->additional_data->contiguous_inverses)
+            {
+              if (bs == 0)
+                break;
+              M_cell.gauss_jordan();
+              std::copy (&M_cell(0,0), &M_cell(0,0)+bs*bs,
+                         contiguous_inverse_data.begin()+contiguous_inverse_offsets[block]);
+            }
+          else
+            {
+              this->inverse(block).reinit(bs, bs);
+              this->inverse(block).invert(M_cell);
+            }
           break;
         case PreconditionBlockBase<InverseNumberType>::householder:
           this->inverse_householder(block).initialize(M_cell);
@@ -205,6 +290,59 @@ namespace internal
 #endif // DEAL_II_WITH_TRILINOS
 } // end namespace internal
 
+template <typename MatrixType, typename InverseNumberType, typename VectorType>
+inline
+void
+RelaxationBlock<MatrixType, InverseNumberType, VectorType>::do_block_step
+(const size_type                          block,
+ VectorType                              &dst,
+ const VectorType                        &prev,
+ const VectorType                        &src,
+ Vector<typename VectorType::value_type> &b_cell,
+ Vector<typename VectorType::value_type> &x_cell) const
+{
+  const MatrixType &M=*this->A;
+  const size_type bs = additional_data->block_list.row_length(block);
+
+  b_cell.reinit(bs);
+  x_cell.reinit(bs);
+  // Collect off-diagonal parts
+  SparsityPattern::iterator row = additional_data->block_list.begin(block);
+  for (size_type row_cell=0; row_cell<bs; ++row_cell, ++row)
+    {
+      b_cell(row_cell) = src(row->column());
+      for (typename MatrixType::const_iterator entry = M.begin(row->column());
+           entry != M.end(row->column()); ++entry)
+        b_cell(row_cell) -= entry->value() * prev(entry->column());
+    }
+  // Apply inverse diagonal
+  if (additional_data->contiguous_inverses)
+    {
+      const InverseNumberType *inverse
+        = contiguous_inverse_data.begin() + contiguous_inverse_offsets[block];
+      for (size_type i=0; i<bs; ++i, inverse += bs)
+        {
+          typename VectorType::value_type sum = 0;
+          for (size_type j=0; j<bs; ++j)
+            sum += inverse[j] * b_cell(j);
+          x_cell(i) = sum;
+        }
+    }
+  else
+    this->inverse_vmult(block, x_cell, b_cell);
+#ifdef DEBUG
+  for (unsigned int i=0; i<x_cell.size(); ++i)
+    {
+      AssertIsFinite(x_cell(i));
+    }
+#endif
+  // Store in result vector
+  row = additional_data->block_list.begin(block);
+  for (size_type row_cell=0; row_cell<bs; ++row_cell, ++row)
+    dst(row->column()) += additional_data->relaxation * x_cell(row_cell);
+}
+
+
 template <typename MatrixType, typename InverseNumberType, typename VectorType>
 inline
 void
@@ -217,9 +355,41 @@ RelaxationBlock<MatrixType, InverseNumberType, VectorType>::do_step (VectorType
 
   const VectorType &ghosted_prev = internal::prepare_ghost_vector(prev, additional_data->temp_ghost_vector);
 
-  const MatrixType &M=*this->A;
   Vector<typename VectorType::value_type> b_cell, x_cell;
 
+  if (colors.size() > 0)
+    {
+      // blocks of the same color do not depend on each other and can be
+      // processed in any order. parallel vectors and the SVD inverses do not
+      // allow concurrent access, though
+      const bool process_in_parallel
+        = (additional_data->temp_ghost_vector == nullptr &&
+           this->inversion != PreconditionBlockBase<InverseNumberType>::svd);
+
+      for (unsigned int c=0; c<colors.size(); ++c)
+        {
+          const std::vector<unsigned int> &color
+            = colors[backward ? (colors.size() - c - 1) : c];
+
+          if (process_in_parallel)
+            parallel::apply_to_subranges
+            (0U, static_cast<unsigned int>(color.size()),
+             [&] (const unsigned int begin, const unsigned int end)
+            {
+              Vector<typename VectorType::value_type> local_b_cell, local_x_cell;
+              for (unsigned int i=begin; i<end; ++i)
+                do_block_step (color[i], dst, ghosted_prev, src,
+                               local_b_cell, local_x_cell);
+            },
+            16);
+          else
+            for (unsigned int i=0; i<color.size(); ++i)
+              do_block_step (color[i], dst, ghosted_prev, src, b_cell, x_cell);
+        }
+      dst.compress(dealii::VectorOperation::add);
+      return;
+    }
+
   const bool permutation_empty = additional_data->order.size() == 0;
   const unsigned int n_permutations = (permutation_empty)
                                       ? 1U : additional_data->order.size();
@@ -240,31 +410,7 @@ RelaxationBlock<MatrixType, InverseNumberType, VectorType>::do_step (VectorType
                                         ? (additional_data->order[n_permutations-1-perm][raw_block])
                                         : (additional_data->order[perm][raw_block]));
 
-          const size_type bs = additional_data->block_list.row_length(block);
-
-          b_cell.reinit(bs);
-          x_cell.reinit(bs);
-          // Collect off-diagonal parts
-          SparsityPattern::iterator row = additional_data->block_list.begin(block);
-          for (size_type row_cell=0; row_cell<bs; ++row_cell, ++row)
-            {
-              b_cell(row_cell) = src(row->column());
-              for (typename MatrixType::const_iterator entry = M.begin(row->column());
-                   entry != M.end(row->column()); ++entry)
-                b_cell(row_cell) -= entry->value() * ghosted_prev(entry->column());
-            }
-          // Apply inverse diagonal
-          this->inverse_vmult(block, x_cell, b_cell);
-#ifdef DEBUG
-          for (unsigned int i=0; i<x_cell.size(); ++i)
-            {
-              AssertIsFinite(x_cell(i));
-            }
-#endif
-          // Store in result vector
-          row = additional_data->block_list.begin(block);
-          for (size_type row_cell=0; row_cell<bs; ++row_cell, ++row)
-            dst(row->column()) += additional_data->relaxation * x_cell(row_cell);
+          do_block_step (block, dst, ghosted_prev, src, b_cell, x_cell);
         }
     }
   dst.compress(dealii::VectorOperation::add);
@@ -21,6 +21,8 @@
 #include <deal.II/lac/tridiagonal_matrix.h>
 #include <deal.II/lac/solver.h>
 #include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/vector_operations_internal.h>
+#include <deal.II/lac/cuda_vector.h>
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/logstream.h>
 #include <deal.II/base/subscriptor.h>
@@ -30,6 +32,7 @@ DEAL_II_NAMESPACE_OPEN
 
 // forward declaration
 class PreconditionIdentity;
+template <typename> class DiagonalMatrix;
 
 
 /*!@addtogroup Solvers */
@@ -78,6 +81,27 @@ class PreconditionIdentity;
  * connect_condition_number_slot. These slots will then be called from the
  * solver with the estimates as argument.
  *
+ * <h3>Fused vector operations</h3>
+ *
+ * For vectors of type dealii::Vector and LinearAlgebra::distributed::Vector
+ * in combination with a PreconditionIdentity or a DiagonalMatrix as
+ * preconditioner, the vector updates of one iteration are merged into two
+ * loops over the vector entries: The first loop updates the solution and
+ * the residual and computes the residual norm as well as the inner product
+ * of the residual with the preconditioned residual, and the second loop
+ * computes the new search direction by applying the diagonal preconditioner
+ * on the fly. This reduces the number of times the vector entries are
+ * streamed from memory per iteration and, for parallel vectors, combines
+ * the two global reductions of the preconditioned case into a single one.
+ * The same applies to vectors of type LinearAlgebra::CUDAWrappers::Vector,
+ * where each of the two loops is a single kernel and the two inner products
+ * are copied to the host together, so that one iteration only synchronizes
+ * with the device twice.
+ * The iterates are mathematically identical to the ones of the general
+ * algorithm, but may differ in roundoff. For all other vector and
+ * preconditioner types, the operations are performed one after the other
+ * through the vector interface.
+ *
  * <h3>Observing the progress of linear solver iterations</h3>
  *
  * The solve() function of this class uses the mechanism described in the
@@ -227,6 +251,362 @@ protected:
 
 #ifndef DOXYGEN
 
+namespace internal
+{
+  namespace SolverCG
+  {
+    /**
+     * Access to the diagonal of preconditioners that act entry by entry. The
+     * general template marks preconditioners that can only be applied
+     * through their vmult() function.
+     */
+    template <typename PreconditionerType, typename VectorType>
+    struct DiagonalAccess
+    {
+      static const bool is_supported = false;
+    };
+
+    template <typename VectorType>
+    struct DiagonalAccess<PreconditionIdentity, VectorType>
+    {
+      static const bool is_supported = true;
+
+      static const typename VectorType::value_type *
+      diagonal (const PreconditionIdentity &)
+      {
+        return nullptr;
+      }
+
+      static const VectorType *
+      diagonal_vector (const PreconditionIdentity &)
+      {
+        return nullptr;
+      }
+    };
+
+    template <typename VectorType>
+    struct DiagonalAccess<DiagonalMatrix<VectorType>, VectorType>
+    {
+      static const bool is_supported = true;
+
+      static const typename VectorType::value_type *
+      diagonal (const DiagonalMatrix<VectorType> &preconditioner)
+      {
+        return preconditioner.get_vector().begin();
+      }
+
+      static const VectorType *
+      diagonal_vector (const DiagonalMatrix<VectorType> &preconditioner)
+      {
+        return &preconditioner.get_vector();
+      }
+    };
+
+    /**
+     * Determine whether the fused vector operations are implemented for
+     * the vector type, i.e., whether its entries can be accessed by
+     * VectorOperations::VectorAccess or it is a vector on the device.
+     */
+    template <typename VectorType>
+    struct FusedVectorAccess
+    {
+      static const bool is_supported =
+        internal::VectorOperations::VectorAccess<VectorType>::is_supported;
+    };
+
+#ifdef DEAL_II_WITH_CUDA
+    template <typename Number>
+    struct FusedVectorAccess<LinearAlgebra::CUDAWrappers::Vector<Number> >
+    {
+      static const bool is_supported = true;
+    };
+#endif
+
+    /**
+     * The two inner products computed by the fused update of the solution
+     * and the residual.
+     */
+    template <typename Number>
+    struct ResidualProducts
+    {
+      ResidualProducts ()
+      {
+        values[0] = values[1] = Number();
+      }
+
+      ResidualProducts &operator += (const ResidualProducts &other)
+      {
+        values[0] += other.values[0];
+        values[1] += other.values[1];
+        return *this;
+      }
+
+      ResidualProducts operator + (const ResidualProducts &other) const
+      {
+        ResidualProducts result (*this);
+        result += other;
+        return result;
+      }
+
+      Number values[2];
+    };
+
+    /**
+     * Perform the update x += a*d and g += a*h and compute the square of
+     * the norm of g, to be used with PreconditionIdentity.
+     */
+    template <typename Number>
+    struct UpdateAndNorm
+    {
+      static const bool vectorizes = VectorizedArray<Number>::n_array_elements > 1;
+
+      UpdateAndNorm (Number *x, Number *g, const Number *d, const Number *h,
+                     const Number a)
+        :
+        x(x), g(g), d(d), h(h), a(a)
+      {}
+
+      Number
+      operator() (const types::global_dof_index i) const
+      {
+        x[i] += a * d[i];
+        g[i] += a * h[i];
+        return g[i] * g[i];
+      }
+
+      VectorizedArray<Number>
+      do_vectorized (const types::global_dof_index i) const
+      {
+        VectorizedArray<Number> xi, gi, di, hi;
+        xi.load (x+i);
+        di.load (d+i);
+        xi += a * di;
+        xi.store (x+i);
+        gi.load (g+i);
+        hi.load (h+i);
+        gi += a * hi;
+        gi.store (g+i);
+        return gi * gi;
+      }
+
+      Number *x, *g;
+      const Number *d, *h;
+      const Number a;
+    };
+
+    /**
+     * Perform the update x += a*d and g += a*h and compute the square of
+     * the norm of g as well as the inner product between g and P*g with a
+     * diagonal preconditioner P.
+     */
+    template <typename Number>
+    struct UpdateAndDots
+    {
+      static const bool vectorizes = false;
+
+      UpdateAndDots (Number *x, Number *g, const Number *d, const Number *h,
+                     const Number *diagonal, const Number a)
+        :
+        x(x), g(g), d(d), h(h), diagonal(diagonal), a(a)
+      {}
+
+      ResidualProducts<Number>
+      operator() (const types::global_dof_index i) const
+      {
+        x[i] += a * d[i];
+        g[i] += a * h[i];
+        ResidualProducts<Number> result;
+        result.values[0] = g[i] * g[i];
+        result.values[1] = result.values[0] * diagonal[i];
+        return result;
+      }
+
+      Number *x, *g;
+      const Number *d, *h, *diagonal;
+      const Number a;
+    };
+
+    /**
+     * Compute the new search direction d = beta*d - P*g with a diagonal
+     * preconditioner P, or P the identity if the pointer to the diagonal is
+     * empty.
+     */
+    template <typename Number>
+    struct UpdateSearchDirection
+    {
+      UpdateSearchDirection (Number *d, const Number *g, const Number *diagonal,
+                             const Number beta)
+        :
+        d(d), g(g), diagonal(diagonal), beta(beta)
+      {}
+
+      void operator() (const types::global_dof_index begin,
+                       const types::global_dof_index end) const
+      {
+        if (diagonal == nullptr)
+          {
+            DEAL_II_OPENMP_SIMD_PRAGMA
+            for (types::global_dof_index i=begin; i<end; ++i)
+              d[i] = beta * d[i] - g[i];
+          }
+        else
+          {
+            DEAL_II_OPENMP_SIMD_PRAGMA
+            for (types::global_dof_index i=begin; i<end; ++i)
+              d[i] = beta * d[i] - diagonal[i] * g[i];
+          }
+      }
+
+      Number *d;
+      const Number *g, *diagonal;
+      const Number beta;
+    };
+
+    /**
+     * Perform the fused update of solution and residual, returning the
+     * square of the norm of the residual and the inner product between the
+     * residual and the preconditioned residual.
+     */
+    template <typename VectorType, typename PreconditionerType>
+    std::pair<double,double>
+    update_solution_and_residual (VectorType               &x,
+                                  VectorType               &g,
+                                  const VectorType         &d,
+                                  const VectorType         &h,
+                                  const double              alpha,
+                                  const PreconditionerType &preconditioner,
+                                  std::shared_ptr<parallel::internal::TBBPartitioner> &partitioner,
+                                  std::integral_constant<bool, true>)
+    {
+      typedef typename VectorType::value_type Number;
+      const Number *diagonal =
+        DiagonalAccess<PreconditionerType,VectorType>::diagonal(preconditioner);
+      const types::global_dof_index local_size =
+        internal::VectorOperations::VectorAccess<VectorType>::local_size(x);
+      if (diagonal == nullptr)
+        {
+          UpdateAndNorm<Number> op (x.begin(), g.begin(), d.begin(), h.begin(),
+                                    alpha);
+          ResidualProducts<Number> result;
+          internal::VectorOperations::parallel_reduce (op, 0, local_size,
+                                                       result.values[0],
+                                                       partitioner);
+          internal::VectorOperations::VectorAccess<VectorType>::sum
+          (ArrayView<Number>(result.values, 1), x);
+          return std::make_pair (result.values[0], result.values[0]);
+        }
+      else
+        {
+          UpdateAndDots<Number> op (x.begin(), g.begin(), d.begin(), h.begin(),
+                                    diagonal, alpha);
+          ResidualProducts<Number> result;
+          internal::VectorOperations::parallel_reduce (op, 0, local_size, result,
+                                                       partitioner);
+          internal::VectorOperations::VectorAccess<VectorType>::sum
+          (ArrayView<Number>(result.values, 2), x);
+          return std::make_pair (result.values[0], result.values[1]);
+        }
+    }
+
+    /**
+     * Compute the new search direction d = beta*d - P*g.
+     */
+    template <typename VectorType, typename PreconditionerType>
+    void
+    update_search_direction (VectorType               &d,
+                             const VectorType         &g,
+                             const double              beta,
+                             const PreconditionerType &preconditioner,
+                             std::shared_ptr<parallel::internal::TBBPartitioner> &partitioner,
+                             std::integral_constant<bool, true>)
+    {
+      typedef typename VectorType::value_type Number;
+      UpdateSearchDirection<Number>
+      op (d.begin(), g.begin(),
+          DiagonalAccess<PreconditionerType,VectorType>::diagonal(preconditioner),
+          beta);
+      const types::global_dof_index local_size =
+        internal::VectorOperations::VectorAccess<VectorType>::local_size(d);
+      internal::VectorOperations::parallel_for (op, 0, local_size, partitioner);
+    }
+
+
+
+#ifdef DEAL_II_WITH_CUDA
+    // for vectors on the device, the fused loops are run by kernels
+    template <typename Number, typename PreconditionerType>
+    std::pair<double,double>
+    update_solution_and_residual (LinearAlgebra::CUDAWrappers::Vector<Number>       &x,
+                                  LinearAlgebra::CUDAWrappers::Vector<Number>       &g,
+                                  const LinearAlgebra::CUDAWrappers::Vector<Number> &d,
+                                  const LinearAlgebra::CUDAWrappers::Vector<Number> &h,
+                                  const double              alpha,
+                                  const PreconditionerType &preconditioner,
+                                  std::shared_ptr<parallel::internal::TBBPartitioner> &,
+                                  std::integral_constant<bool, true>)
+    {
+      typedef LinearAlgebra::CUDAWrappers::Vector<Number> VectorType;
+      const std::pair<Number,Number> products =
+        LinearAlgebra::CUDAWrappers::internal::cg_update_solution_and_residual
+        (x, g, d, h,
+         DiagonalAccess<PreconditionerType,VectorType>::diagonal_vector(preconditioner),
+         static_cast<Number>(alpha));
+      return std::make_pair (static_cast<double>(products.first),
+                             static_cast<double>(products.second));
+    }
+
+    template <typename Number, typename PreconditionerType>
+    void
+    update_search_direction (LinearAlgebra::CUDAWrappers::Vector<Number>       &d,
+                             const LinearAlgebra::CUDAWrappers::Vector<Number> &g,
+                             const double              beta,
+                             const PreconditionerType &preconditioner,
+                             std::shared_ptr<parallel::internal::TBBPartitioner> &,
+                             std::integral_constant<bool, true>)
+    {
+      typedef LinearAlgebra::CUDAWrappers::Vector<Number> VectorType;
+      LinearAlgebra::CUDAWrappers::internal::cg_update_search_direction
+      (d, g,
+       DiagonalAccess<PreconditionerType,VectorType>::diagonal_vector(preconditioner),
+       static_cast<Number>(beta));
+    }
+#endif
+
+
+
+    // the fused operations are never called for unsupported vector or
+    // preconditioner types, but they need to compile
+    template <typename VectorType, typename PreconditionerType>
+    std::pair<double,double>
+    update_solution_and_residual (VectorType &,
+                                  VectorType &,
+                                  const VectorType &,
+                                  const VectorType &,
+                                  const double,
+                                  const PreconditionerType &,
+                                  std::shared_ptr<parallel::internal::TBBPartitioner> &,
+                                  std::integral_constant<bool, false>)
+    {
+      Assert (false, ExcInternalError());
+      return std::pair<double,double>();
+    }
+
+    template <typename VectorType, typename PreconditionerType>
+    void
+    update_search_direction (VectorType &,
+                             const VectorType &,
+                             const double,
+                             const PreconditionerType &,
+                             std::shared_ptr<parallel::internal::TBBPartitioner> &,
+                             std::integral_constant<bool, false>)
+    {
+      Assert (false, ExcInternalError());
+    }
+  }
+}
+
+
+
 template <typename VectorType>
 SolverCG<VectorType>::SolverCG (SolverControl        &cn,
                                 VectorMemory<VectorType> &mem,
@@ -377,6 +757,18 @@ SolverCG<VectorType>::solve (const MatrixType         &A,
       gh = res*res;
     }
 
+  // check whether we can merge the vector updates into fused loops over the
+  // vector entries
+  typedef std::integral_constant<bool,
+          internal::SolverCG::FusedVectorAccess<VectorType>::is_supported &&
+          internal::SolverCG::DiagonalAccess<PreconditionerType,VectorType>::is_supported>
+          FusedTag;
+  const bool use_fused_updates = FusedTag::value;
+  std::shared_ptr<parallel::internal::TBBPartitioner> partitioner;
+  if (use_fused_updates &&
+      internal::VectorOperations::VectorAccess<VectorType>::is_supported)
+    partitioner = std::make_shared<parallel::internal::TBBPartitioner>();
+
   while (conv == SolverControl::iterate)
     {
       it++;
@@ -386,32 +778,55 @@ SolverCG<VectorType>::solve (const MatrixType         &A,
       Assert(alpha != 0., ExcDivideByZero());
       alpha = gh/alpha;
 
-      x.add(alpha,d);
-      res = std::sqrt(g.add_and_dot(alpha, h, g));
-
-      print_vectors(it, x, g, d);
+      if (use_fused_updates)
+        {
+          const std::pair<double,double> products =
+            internal::SolverCG::update_solution_and_residual
+            (x, g, d, h, alpha, preconditioner, partitioner, FusedTag());
+          res = std::sqrt(products.first);
 
-      conv = this->iteration_status(it, res, x);
-      if (conv != SolverControl::iterate)
-        break;
+          print_vectors(it, x, g, d);
 
-      if (std::is_same<PreconditionerType,PreconditionIdentity>::value
-          == false)
-        {
-          preconditioner.vmult(h,g);
+          conv = this->iteration_status(it, res, x);
+          if (conv != SolverControl::iterate)
+            break;
 
           beta = gh;
           Assert(beta != 0., ExcDivideByZero());
-          gh   = g*h;
+          gh   = products.second;
           beta = gh/beta;
-          d.sadd(beta,-1.,h);
+          internal::SolverCG::update_search_direction
+          (d, g, beta, preconditioner, partitioner, FusedTag());
         }
       else
         {
-          beta = gh;
-          gh = res*res;
-          beta = gh/beta;
-          d.sadd(beta,-1.,g);
+          x.add(alpha,d);
+          res = std::sqrt(g.add_and_dot(alpha, h, g));
+
+          print_vectors(it, x, g, d);
+
+          conv = this->iteration_status(it, res, x);
+          if (conv != SolverControl::iterate)
+            break;
+
+              if (std::is_same<PreconditionerType,PreconditionIdentity>::value
+              == false)
+            {
+              preconditioner.vmult(h,g);
+
+              beta = gh;
+              Assert(beta != 0., ExcDivideByZero());
+              gh   = g*h;
+              beta = gh/beta;
+              d.sadd(beta,-1.,h);
+            }
+          else
+            {
+              beta = gh;
+              gh = res*res;
+              beta = gh/beta;
+              d.sadd(beta,-1.,g);
+            }
         }
 
       this->coefficients_signal(alpha,beta);
@@ -0,0 +1,613 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_solver_deflated_cg_h
+#define dealii_solver_deflated_cg_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/logstream.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*!@addtogroup Solvers */
+/*@{*/
+
+/**
+ * The deflated preconditioned conjugate gradient method with recycling of
+ * the deflation space between subsequent solves, for sequences of linear
+ * systems with symmetric positive definite matrices that change slowly, as
+ * they appear in time stepping schemes or in Newton iterations.
+ *
+ * Given a set of $k$ vectors $W = [w_1,\ldots,w_k]$ stored in this object,
+ * the iteration is restricted to the $A$-orthogonal complement of the span
+ * of $W$, and the components of the solution in the span of $W$ are
+ * computed directly by a Galerkin projection. If $W$ spans approximately the
+ * eigenvectors of the smallest eigenvalues of $A$, these eigenvalues are
+ * removed from the spectrum seen by the CG iteration, which reduces the
+ * effective condition number and thus the number of iterations. The
+ * algorithm follows
+ * @code{.bib}
+ * @Article{Saad2000,
+ *   Title   = {A deflated version of the conjugate gradient algorithm},
+ *   Author  = {Saad, Y. and Yeung, M. and Erhel, J. and Guyomarc'h, F.},
+ *   Journal = {SIAM Journal on Scientific Computing},
+ *   Year    = {2000},
+ *   Volume  = {21},
+ *   Number  = {5},
+ *   Pages   = {1909--1926}
+ * }
+ * @endcode
+ *
+ * At the end of each call to solve(), the deflation space is updated by a
+ * Rayleigh-Ritz procedure on the span of the previous deflation vectors and
+ * the first AdditionalData::n_recycled_directions search directions of the
+ * CG iteration: the AdditionalData::max_deflation_vectors Ritz vectors with
+ * the smallest Ritz values are kept for the next solve. Starting from an
+ * empty deflation space, the first solve thus performs an ordinary
+ * preconditioned CG iteration, and the deflation space improves with every
+ * subsequent solve. Alternatively, a deflation space can be provided by
+ * set_deflation_vectors().
+ *
+ * Since the matrix may change between the solves, the products of the
+ * matrix with the deflation vectors are recomputed at the beginning of each
+ * solve, which costs $k$ additional matrix-vector products. Each iteration
+ * additionally costs $k$ inner products and $k$ vector updates. The method
+ * works with any matrix type providing a vmult() function, including
+ * LinearOperator objects, and any vector type usable with SolverCG.
+ *
+ * @code
+ *   SolverControl solver_control (1000, 1e-12);
+ *   SolverDeflatedCG<> solver (solver_control);
+ *   for (unsigned int step=0; step<n_time_steps; ++step)
+ *     {
+ *       assemble_system ();
+ *       solver.solve (system_matrix, solution, system_rhs, preconditioner);
+ *     }
+ * @endcode
+ *
+ * Note that the solver object needs to persist between the solves for the
+ * deflation space to be recycled.
+ *
+ *
+ * <h3>Observing the progress of linear solver iterations</h3>
+ *
+ * The solve() function of this class uses the mechanism described in the
+ * Solver base class to determine convergence. This mechanism can also be used
+ * to observe the progress of the iteration.
+ */
+template <typename VectorType = Vector<double> >
+class SolverDeflatedCG : public Solver<VectorType>
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * Standardized data struct to pipe additional data to the solver.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor.
+     */
+    explicit
+    AdditionalData (const unsigned int max_deflation_vectors  = 8,
+                    const unsigned int n_recycled_directions  = 16,
+                    const bool         update_deflation_space = true);
+
+    /**
+     * The maximal number of vectors in the deflation space.
+     */
+    unsigned int max_deflation_vectors;
+
+    /**
+     * The number of search directions of each solve that are stored for the
+     * update of the deflation space.
+     */
+    unsigned int n_recycled_directions;
+
+    /**
+     * Whether to update the deflation space at the end of each solve. If
+     * set to false, the deflation space provided by set_deflation_vectors()
+     * is used unchanged.
+     */
+    bool update_deflation_space;
+  };
+
+  /**
+   * Constructor.
+   */
+  SolverDeflatedCG (SolverControl            &cn,
+                    VectorMemory<VectorType> &mem,
+                    const AdditionalData     &data = AdditionalData());
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  SolverDeflatedCG (SolverControl        &cn,
+                    const AdditionalData &data = AdditionalData());
+
+  /**
+   * Virtual destructor.
+   */
+  virtual ~SolverDeflatedCG () = default;
+
+  /**
+   * Solve the linear system $Ax=b$ for x, and update the deflation space
+   * if requested.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve (const MatrixType         &A,
+         VectorType               &x,
+         const VectorType         &b,
+         const PreconditionerType &preconditioner);
+
+  /**
+   * Set the deflation space to the span of the given vectors. The vectors
+   * must be linearly independent.
+   */
+  void set_deflation_vectors (const std::vector<VectorType> &vectors);
+
+  /**
+   * Return the vectors currently spanning the deflation space. They are
+   * orthonormal if they were computed by this class.
+   */
+  const std::vector<VectorType> &get_deflation_vectors () const;
+
+  /**
+   * Remove all vectors from the deflation space, e.g. when the matrix has
+   * changed so much that the old space is not useful any more.
+   */
+  void clear_deflation_vectors ();
+
+  /**
+   * Return the number of vectors in the deflation space.
+   */
+  unsigned int n_deflation_vectors () const;
+
+protected:
+  /**
+   * Compute the Ritz vectors of the matrix in the span of the deflation
+   * vectors and the given search directions, from the search directions
+   * @p directions and their products with the matrix @p matrix_directions,
+   * and store those with the smallest Ritz values as the new deflation
+   * vectors.
+   */
+  void
+  update_deflation_vectors (std::vector<VectorType> &directions,
+                            std::vector<VectorType> &matrix_directions);
+
+  /**
+   * Store a copy of the flags for this particular solver.
+   */
+  AdditionalData additional_data;
+
+  /**
+   * The vectors spanning the deflation space.
+   */
+  std::vector<VectorType> deflation_vectors;
+
+  /**
+   * The products of the matrix with the deflation vectors, computed at the
+   * beginning of each solve.
+   */
+  std::vector<VectorType> matrix_deflation_vectors;
+};
+
+/*@}*/
+
+/*------------------------- Implementation ----------------------------*/
+
+#ifndef DOXYGEN
+
+namespace internal
+{
+  namespace SolverDeflatedCG
+  {
+    // Compute all eigenvalues and eigenvectors of the small symmetric matrix
+    // @p matrix by the cyclic Jacobi method. The eigenvectors are stored in
+    // the columns of @p eigenvectors. The input matrix is overwritten.
+    inline
+    void
+    symmetric_eigenvalues (FullMatrix<double>  &matrix,
+                           std::vector<double> &eigenvalues,
+                           FullMatrix<double>  &eigenvectors)
+    {
+      const unsigned int n = matrix.m();
+      eigenvectors.reinit (n, n);
+      for (unsigned int i=0; i<n; ++i)
+        eigenvectors(i,i) = 1.;
+
+      for (unsigned int sweep=0; sweep<50; ++sweep)
+        {
+          double off_diagonal = 0., diagonal = 0.;
+          for (unsigned int i=0; i<n; ++i)
+            {
+              diagonal += matrix(i,i)*matrix(i,i);
+              for (unsigned int j=i+1; j<n; ++j)
+                off_diagonal += matrix(i,j)*matrix(i,j);
+            }
+          if (off_diagonal <= 1e-30*diagonal)
+            break;
+
+          for (unsigned int p=0; p<n; ++p)
+            for (unsigned int q=p+1; q<n; ++q)
+              {
+                if (std::abs(matrix(p,q)) <= 1e-300)
+                  continue;
+
+                // compute the rotation that eliminates the entry (p,q)
+                const double theta = (matrix(q,q)-matrix(p,p))/(2.*matrix(p,q));
+                const double t = (theta >= 0 ? 1. : -1.) /
+                                 (std::abs(theta) + std::sqrt(theta*theta+1.));
+                const double c = 1./std::sqrt(t*t+1.), s = t*c;
+
+                for (unsigned int k=0; k<n; ++k)
+                  {
+                    const double mkp = matrix(k,p), mkq = matrix(k,q);
+                    matrix(k,p) = c*mkp - s*mkq;
+                    matrix(k,q) = s*mkp + c*mkq;
+                  }
+                for (unsigned int k=0; k<n; ++k)
+                  {
+                    const double mpk = matrix(p,k), mqk = matrix(q,k);
+                    matrix(p,k) = c*mpk - s*mqk;
+                    matrix(q,k) = s*mpk + c*mqk;
+                  }
+                for (unsigned int k=0; k<n; ++k)
+                  {
+                    const double vkp = eigenvectors(k,p), vkq = eigenvectors(k,q);
+                    eigenvectors(k,p) = c*vkp - s*vkq;
+                    eigenvectors(k,q) = s*vkp + c*vkq;
+                  }
+              }
+        }
+
+      eigenvalues.resize(n);
+      for (unsigned int i=0; i<n; ++i)
+        eigenvalues[i] = matrix(i,i);
+    }
+  }
+}
+
+
+
+template <typename VectorType>
+inline
+SolverDeflatedCG<VectorType>::AdditionalData::
+AdditionalData (const unsigned int max_deflation_vectors,
+                const unsigned int n_recycled_directions,
+                const bool         update_deflation_space)
+  :
+  max_deflation_vectors (max_deflation_vectors),
+  n_recycled_directions (n_recycled_directions),
+  update_deflation_space (update_deflation_space)
+{}
+
+
+
+template <typename VectorType>
+SolverDeflatedCG<VectorType>::SolverDeflatedCG (SolverControl            &cn,
+                                                VectorMemory<VectorType> &mem,
+                                                const AdditionalData     &data)
+  :
+  Solver<VectorType> (cn,mem),
+  additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+SolverDeflatedCG<VectorType>::SolverDeflatedCG (SolverControl        &cn,
+                                                const AdditionalData &data)
+  :
+  Solver<VectorType> (cn),
+  additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+void
+SolverDeflatedCG<VectorType>::set_deflation_vectors
+(const std::vector<VectorType> &vectors)
+{
+  deflation_vectors = vectors;
+  matrix_deflation_vectors.clear();
+}
+
+
+
+template <typename VectorType>
+const std::vector<VectorType> &
+SolverDeflatedCG<VectorType>::get_deflation_vectors () const
+{
+  return deflation_vectors;
+}
+
+
+
+template <typename VectorType>
+void
+SolverDeflatedCG<VectorType>::clear_deflation_vectors ()
+{
+  deflation_vectors.clear();
+  matrix_deflation_vectors.clear();
+}
+
+
+
+template <typename VectorType>
+unsigned int
+SolverDeflatedCG<VectorType>::n_deflation_vectors () const
+{
+  return deflation_vectors.size();
+}
+
+
+
+template <typename VectorType>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverDeflatedCG<VectorType>::solve (const MatrixType         &A,
+                                     VectorType               &x,
+                                     const VectorType         &b,
+                                     const PreconditionerType &preconditioner)
+{
+  SolverControl::State conv=SolverControl::iterate;
+
+  LogStream::Prefix prefix("deflated-cg");
+
+  // Memory allocation
+  typename VectorMemory<VectorType>::Pointer r_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer z_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer p_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer q_pointer(this->memory);
+
+  // define some aliases for simpler access
+  VectorType &r = *r_pointer;
+  VectorType &z = *z_pointer;
+  VectorType &p = *p_pointer;
+  VectorType &q = *q_pointer;
+
+  r.reinit(x, true);
+  z.reinit(x, true);
+  p.reinit(x, true);
+  q.reinit(x, true);
+
+  // compute the products of the current matrix with the deflation vectors
+  // and the inverse of the Galerkin matrix W^T A W
+  const unsigned int n_deflation = deflation_vectors.size();
+  matrix_deflation_vectors.resize(n_deflation);
+  FullMatrix<double> galerkin_inverse (n_deflation, n_deflation);
+  for (unsigned int i=0; i<n_deflation; ++i)
+    {
+      matrix_deflation_vectors[i].reinit(x, true);
+      A.vmult(matrix_deflation_vectors[i], deflation_vectors[i]);
+      for (unsigned int j=0; j<=i; ++j)
+        galerkin_inverse(i,j) = galerkin_inverse(j,i)
+                                = deflation_vectors[j] * matrix_deflation_vectors[i];
+    }
+  if (n_deflation > 0)
+    galerkin_inverse.gauss_jordan();
+
+  std::vector<double> projected (n_deflation), coefficients (n_deflation);
+
+  // compute W (W^T A W)^{-1} V^T v for V either W or AW and add the result
+  // multiplied by the given factor to the given vector
+  auto apply_projection = [&] (const std::vector<VectorType> &V,
+                               const VectorType              &v)
+  {
+    for (unsigned int i=0; i<n_deflation; ++i)
+      projected[i] = V[i] * v;
+    for (unsigned int i=0; i<n_deflation; ++i)
+      {
+        coefficients[i] = 0;
+        for (unsigned int j=0; j<n_deflation; ++j)
+          coefficients[i] += galerkin_inverse(i,j) * projected[j];
+      }
+  };
+
+  // containers for the search directions used for the update of the
+  // deflation space
+  const unsigned int n_stored_directions =
+    (additional_data.update_deflation_space && additional_data.max_deflation_vectors > 0)
+    ? additional_data.n_recycled_directions : 0;
+  std::vector<VectorType> directions, matrix_directions;
+  directions.reserve(n_stored_directions);
+  matrix_directions.reserve(n_stored_directions);
+
+  // compute the initial residual and remove its component in the deflation
+  // space from the error
+  A.vmult(r, x);
+  r.sadd(-1., 1., b);
+  if (n_deflation > 0)
+    {
+      apply_projection (deflation_vectors, r);
+      for (unsigned int i=0; i<n_deflation; ++i)
+        {
+          x.add(coefficients[i], deflation_vectors[i]);
+          r.add(-coefficients[i], matrix_deflation_vectors[i]);
+        }
+    }
+
+  int it=0;
+  double res = r.l2_norm();
+  conv = this->iteration_status(0, res, x);
+
+  if (conv == SolverControl::iterate)
+    {
+      preconditioner.vmult(z, r);
+      double rz = r * z;
+
+      // p = z - W (W^T A W)^{-1} (AW)^T z
+      p = z;
+      apply_projection (matrix_deflation_vectors, z);
+      for (unsigned int i=0; i<n_deflation; ++i)
+        p.add(-coefficients[i], deflation_vectors[i]);
+
+      while (conv == SolverControl::iterate)
+        {
+          it++;
+          A.vmult(q, p);
+
+          double alpha = p * q;
+          Assert(alpha != 0., ExcDivideByZero());
+          alpha = rz/alpha;
+
+          if (directions.size() < n_stored_directions)
+            {
+              directions.push_back(p);
+              matrix_directions.push_back(q);
+            }
+
+          x.add(alpha, p);
+          res = std::sqrt(r.add_and_dot(-alpha, q, r));
+
+          conv = this->iteration_status(it, res, x);
+          if (conv != SolverControl::iterate)
+            break;
+
+          preconditioner.vmult(z, r);
+          const double rz_old = rz;
+          Assert(rz_old != 0., ExcDivideByZero());
+          rz = r * z;
+          const double beta = rz/rz_old;
+
+          p.sadd(beta, 1., z);
+          apply_projection (matrix_deflation_vectors, z);
+          for (unsigned int i=0; i<n_deflation; ++i)
+            p.add(-coefficients[i], deflation_vectors[i]);
+        }
+    }
+
+  if (directions.size() > 0)
+    update_deflation_vectors (directions, matrix_directions);
+
+  // in case of failure: throw exception
+  if (conv != SolverControl::success)
+    AssertThrow(false, SolverControl::NoConvergence (it, res));
+  // otherwise exit as normal
+}
+
+
+
+template <typename VectorType>
+void
+SolverDeflatedCG<VectorType>::update_deflation_vectors
+(std::vector<VectorType> &directions,
+ std::vector<VectorType> &matrix_directions)
+{
+  // collect the old deflation vectors and the new search directions in one
+  // basis, together with their products with the matrix
+  std::vector<VectorType> basis, matrix_basis;
+  basis.swap (deflation_vectors);
+  matrix_basis.swap (matrix_deflation_vectors);
+  for (unsigned int i=0; i<directions.size(); ++i)
+    {
+      basis.push_back (VectorType());
+      basis.back().swap (directions[i]);
+      matrix_basis.push_back (VectorType());
+      matrix_basis.back().swap (matrix_directions[i]);
+    }
+
+  // orthonormalize the basis by the modified Gram-Schmidt method, applying
+  // the same operations to the matrix products. we drop vectors that are
+  // almost linearly dependent on the previous ones
+  unsigned int n_basis = 0;
+  for (unsigned int j=0; j<basis.size(); ++j)
+    {
+      const double initial_norm = basis[j].l2_norm();
+      if (initial_norm == 0.)
+        continue;
+      for (unsigned int i=0; i<n_basis; ++i)
+        {
+          const double h = basis[i] * basis[j];
+          basis[j].add(-h, basis[i]);
+          matrix_basis[j].add(-h, matrix_basis[i]);
+        }
+      const double norm = basis[j].l2_norm();
+      if (norm < 1e-10 * initial_norm)
+        continue;
+      basis[j] *= 1./norm;
+      matrix_basis[j] *= 1./norm;
+      if (j != n_basis)
+        {
+          basis[n_basis].swap(basis[j]);
+          matrix_basis[n_basis].swap(matrix_basis[j]);
+        }
+      ++n_basis;
+    }
+
+  // compute the Ritz values and vectors of the matrix in the span of the
+  // basis
+  FullMatrix<double> projected_matrix (n_basis, n_basis);
+  for (unsigned int i=0; i<n_basis; ++i)
+    for (unsigned int j=0; j<=i; ++j)
+      projected_matrix(i,j) = projected_matrix(j,i)
+                              = 0.5 * (basis[i] * matrix_basis[j] +
+                                       basis[j] * matrix_basis[i]);
+
+  std::vector<double> ritz_values;
+  FullMatrix<double> ritz_vectors;
+  internal::SolverDeflatedCG::symmetric_eigenvalues (projected_matrix,
+                                                     ritz_values,
+                                                     ritz_vectors);
+
+  std::vector<unsigned int> ordering (n_basis);
+  for (unsigned int i=0; i<n_basis; ++i)
+    ordering[i] = i;
+  std::sort (ordering.begin(), ordering.end(),
+             [&] (const unsigned int a, const unsigned int b)
+  {
+    return ritz_values[a] < ritz_values[b];
+  });
+
+  // keep the Ritz vectors belonging to the smallest Ritz values, which are
+  // orthonormal as linear combinations of orthonormal vectors with
+  // orthonormal coefficients
+  const unsigned int n_new = std::min(n_basis, additional_data.max_deflation_vectors);
+  deflation_vectors.resize(n_new);
+  for (unsigned int l=0; l<n_new; ++l)
+    {
+      deflation_vectors[l].reinit(basis[0], true);
+      deflation_vectors[l].equ(ritz_vectors(0,ordering[l]), basis[0]);
+      for (unsigned int j=1; j<n_basis; ++j)
+        deflation_vectors[l].add(ritz_vectors(j,ordering[l]), basis[j]);
+    }
+
+  // the matrix products are recomputed in the next solve because the
+  // matrix may change
+  matrix_deflation_vectors.clear();
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -27,6 +27,7 @@
 #include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/lapack_full_matrix.h>
 #include <deal.II/lac/vector.h>
+#include <deal.II/lac/vector_operations_internal.h>
 
 #include <deal.II/base/std_cxx14/memory.h>
 
@@ -39,6 +40,36 @@ DEAL_II_NAMESPACE_OPEN
 /*!@addtogroup Solvers */
 /*@{*/
 
+namespace LinearAlgebra
+{
+  /**
+   * The algorithms available for orthogonalizing a new vector against the
+   * vectors of an orthonormal basis, as used by the Arnoldi process in
+   * SolverGMRES.
+   */
+  enum class OrthogonalizationStrategy
+  {
+    /**
+     * Use the modified Gram-Schmidt algorithm, which subtracts the
+     * projections onto the basis vectors one after the other. This needs one
+     * global reduction per basis vector for parallel vectors.
+     */
+    modified_gram_schmidt,
+
+    /**
+     * Use the classical Gram-Schmidt algorithm, which computes all the inner
+     * products with the basis vectors at once and then subtracts all
+     * projections in a single step. This needs a constant number of global
+     * reductions independent of the size of the basis, but is numerically
+     * less stable. Therefore, it is typically combined with a second
+     * orthogonalization step (re-orthogonalization).
+     */
+    classical_gram_schmidt
+  };
+}
+
+
+
 namespace internal
 {
   /**
@@ -152,6 +183,25 @@ namespace internal
  * class, see the documentation of the Solver base class.
  *
  *
+ * <h3>Orthogonalization</h3>
+ *
+ * By default, new vectors of the Arnoldi basis are orthogonalized against
+ * the previous ones with the modified Gram-Schmidt algorithm, which needs
+ * one inner product, and thus one global reduction for parallel vectors, per
+ * basis vector and iteration. On large parallel machines, where the latency
+ * of global reductions limits the scalability, the classical Gram-Schmidt
+ * algorithm can be selected via AdditionalData::orthogonalization_strategy.
+ * It computes all inner products with a single reduction and subtracts the
+ * projections in one sweep over the vectors, followed by the computation of
+ * the norm of the new vector, for a total of two reductions per iteration
+ * independent of the basis size. For dealii::Vector and
+ * LinearAlgebra::distributed::Vector, the inner products and the vector
+ * updates are performed with kernels that read each basis vector only once.
+ * Since the classical algorithm is less stable, the vector is
+ * orthogonalized a second time when loss of orthogonality is detected or
+ * when AdditionalData::force_re_orthogonalization is set.
+ *
+ *
  * <h3>Observing the progress of linear solver iterations</h3>
  *
  * The solve() function of this class uses the mechanism described in the
@@ -192,7 +242,9 @@ public:
     AdditionalData (const unsigned int max_n_tmp_vectors = 30,
                     const bool right_preconditioning = false,
                     const bool use_default_residual = true,
-                    const bool force_re_orthogonalization = false);
+                    const bool force_re_orthogonalization = false,
+                    const LinearAlgebra::OrthogonalizationStrategy orthogonalization_strategy
+                    = LinearAlgebra::OrthogonalizationStrategy::modified_gram_schmidt);
 
     /**
      * Maximum number of temporary vectors. This parameter controls the size
@@ -222,6 +274,12 @@ public:
      * if necessary.
      */
     bool force_re_orthogonalization;
+
+    /**
+     * The algorithm used for orthogonalizing the new vectors of the Arnoldi
+     * basis against the previous ones.
+     */
+    LinearAlgebra::OrthogonalizationStrategy orthogonalization_strategy;
   };
 
   /**
@@ -394,6 +452,24 @@ protected:
    bool                                                &re_orthogonalize,
    const boost::signals2::signal<void(int)>            &re_orthogonalize_signal = boost::signals2::signal<void(int)>());
 
+  /**
+   * Orthogonalize the vector @p vv against the @p dim (orthogonal) vectors
+   * given by the first argument using the classical Gram-Schmidt algorithm.
+   * The arguments and the return value are the same as for
+   * modified_gram_schmidt(). As opposed to that function, loss of
+   * orthogonality is checked in every step because the check comes at no
+   * additional cost.
+   */
+  static double
+  classical_gram_schmidt
+  (const internal::SolverGMRES::TmpVectors<VectorType> &orthogonal_vectors,
+   const unsigned int                                  dim,
+   const unsigned int                                  accumulated_iterations,
+   VectorType                                          &vv,
+   Vector<double>                                      &h,
+   bool                                                &re_orthogonalize,
+   const boost::signals2::signal<void(int)>            &re_orthogonalize_signal = boost::signals2::signal<void(int)>());
+
   /**
    * Estimates the eigenvalues from the Hessenberg matrix, H_orig, generated
    * during the inner iterations. Uses these estimate to compute the condition
@@ -574,6 +650,182 @@ namespace internal
 
 
 
+    /**
+     * Compute the inner products of @p vv with the first @p n vectors in
+     * @p orthogonal_vectors and store them in the first @p n entries of
+     * @p products, and store the square of the norm of @p vv in entry @p n.
+     * This is the general implementation through the vector interface.
+     */
+    template <class VectorType>
+    void
+    multi_dot (const TmpVectors<VectorType> &orthogonal_vectors,
+               const unsigned int            n,
+               const VectorType             &vv,
+               dealii::Vector<double>       &products,
+               std::integral_constant<bool, false>)
+    {
+      for (unsigned int i=0; i<n; ++i)
+        products(i) = vv * orthogonal_vectors[i];
+      products(n) = vv * vv;
+    }
+
+
+
+    /**
+     * Same as above, but with direct access to the vector entries. Each
+     * vector is read once, with the entries of @p vv kept in cache, and the
+     * results of all processors are combined in a single reduction. The
+     * partial sums are accumulated over fixed chunks of the vector in order
+     * to obtain results independent of the thread scheduling.
+     */
+    template <class VectorType>
+    void
+    multi_dot (const TmpVectors<VectorType> &orthogonal_vectors,
+               const unsigned int            n,
+               const VectorType             &vv,
+               dealii::Vector<double>       &products,
+               std::integral_constant<bool, true>)
+    {
+      typedef typename VectorType::value_type Number;
+      typedef internal::VectorOperations::VectorAccess<VectorType> Access;
+
+      std::vector<const Number *> vectors (n);
+      for (unsigned int i=0; i<n; ++i)
+        vectors[i] = orthogonal_vectors[i].begin();
+      const Number *vv_ptr = vv.begin();
+
+      const types::global_dof_index local_size = Access::local_size(vv);
+      const types::global_dof_index chunk_size =
+        internal::Vector::minimum_parallel_grain_size;
+      const types::global_dof_index n_chunks =
+        (local_size + chunk_size - 1) / chunk_size;
+      std::vector<double> partial_sums (n_chunks*(n+1));
+
+      parallel::apply_to_subranges
+      (types::global_dof_index(0), n_chunks,
+       [&] (const types::global_dof_index begin_chunk,
+            const types::global_dof_index end_chunk)
+      {
+        for (types::global_dof_index c=begin_chunk; c<end_chunk; ++c)
+          {
+            const types::global_dof_index begin = c*chunk_size;
+            const types::global_dof_index end = std::min(begin+chunk_size,
+                                                         local_size);
+            double *sums = &partial_sums[c*(n+1)];
+            for (unsigned int i=0; i<n; ++i)
+              {
+                double sum = 0;
+                const Number *v_ptr = vectors[i];
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (types::global_dof_index j=begin; j<end; ++j)
+                  sum += vv_ptr[j] * v_ptr[j];
+                sums[i] = sum;
+              }
+            double sum = 0;
+            DEAL_II_OPENMP_SIMD_PRAGMA
+            for (types::global_dof_index j=begin; j<end; ++j)
+              sum += vv_ptr[j] * vv_ptr[j];
+            sums[n] = sum;
+          }
+      },
+      1);
+
+      for (unsigned int i=0; i<=n; ++i)
+        products(i) = 0;
+      for (types::global_dof_index c=0; c<n_chunks; ++c)
+        for (unsigned int i=0; i<=n; ++i)
+          products(i) += partial_sums[c*(n+1)+i];
+
+      Access::sum (ArrayView<double>(products.begin(), n+1), vv);
+    }
+
+
+
+    /**
+     * Subtract the first @p n vectors in @p orthogonal_vectors, weighted by
+     * the first @p n entries of @p coefficients, from @p vv and return the
+     * square of the norm of the resulting vector. This is the general
+     * implementation through the vector interface.
+     */
+    template <class VectorType>
+    double
+    subtract_and_norm (const TmpVectors<VectorType> &orthogonal_vectors,
+                       const unsigned int            n,
+                       const dealii::Vector<double> &coefficients,
+                       VectorType                   &vv,
+                       std::integral_constant<bool, false>)
+    {
+      for (unsigned int i=0; i<n; ++i)
+        vv.add (-coefficients(i), orthogonal_vectors[i]);
+      return vv * vv;
+    }
+
+
+
+    /**
+     * Same as above, but with direct access to the vector entries, working
+     * on chunks of @p vv that stay in cache while all basis vectors are
+     * subtracted and the norm is computed along the way.
+     */
+    template <class VectorType>
+    double
+    subtract_and_norm (const TmpVectors<VectorType> &orthogonal_vectors,
+                       const unsigned int            n,
+                       const dealii::Vector<double> &coefficients,
+                       VectorType                   &vv,
+                       std::integral_constant<bool, true>)
+    {
+      typedef typename VectorType::value_type Number;
+      typedef internal::VectorOperations::VectorAccess<VectorType> Access;
+
+      std::vector<const Number *> vectors (n);
+      for (unsigned int i=0; i<n; ++i)
+        vectors[i] = orthogonal_vectors[i].begin();
+      Number *vv_ptr = vv.begin();
+
+      const types::global_dof_index local_size = Access::local_size(vv);
+      const types::global_dof_index chunk_size =
+        internal::Vector::minimum_parallel_grain_size;
+      const types::global_dof_index n_chunks =
+        (local_size + chunk_size - 1) / chunk_size;
+      std::vector<double> partial_sums (n_chunks);
+
+      parallel::apply_to_subranges
+      (types::global_dof_index(0), n_chunks,
+       [&] (const types::global_dof_index begin_chunk,
+            const types::global_dof_index end_chunk)
+      {
+        for (types::global_dof_index c=begin_chunk; c<end_chunk; ++c)
+          {
+            const types::global_dof_index begin = c*chunk_size;
+            const types::global_dof_index end = std::min(begin+chunk_size,
+                                                         local_size);
+            for (unsigned int i=0; i<n; ++i)
+              {
+                const Number factor = -coefficients(i);
+                const Number *v_ptr = vectors[i];
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (types::global_dof_index j=begin; j<end; ++j)
+                  vv_ptr[j] += factor * v_ptr[j];
+              }
+            double sum = 0;
+            DEAL_II_OPENMP_SIMD_PRAGMA
+            for (types::global_dof_index j=begin; j<end; ++j)
+              sum += vv_ptr[j] * vv_ptr[j];
+            partial_sums[c] = sum;
+          }
+      },
+      1);
+
+      double norm_square = 0;
+      for (types::global_dof_index c=0; c<n_chunks; ++c)
+        norm_square += partial_sums[c];
+      Access::sum (ArrayView<double>(&norm_square, 1), vv);
+      return norm_square;
+    }
+
+
+
     // A comparator for better printing eigenvalues
     inline
     bool complex_less_pred(const std::complex<double> &x,
@@ -592,12 +844,14 @@ SolverGMRES<VectorType>::AdditionalData::
 AdditionalData (const unsigned int max_n_tmp_vectors,
                 const bool         right_preconditioning,
                 const bool         use_default_residual,
-                const bool         force_re_orthogonalization)
+                const bool         force_re_orthogonalization,
+                const LinearAlgebra::OrthogonalizationStrategy orthogonalization_strategy)
   :
   max_n_tmp_vectors(max_n_tmp_vectors),
   right_preconditioning(right_preconditioning),
   use_default_residual(use_default_residual),
-  force_re_orthogonalization(force_re_orthogonalization)
+  force_re_orthogonalization(force_re_orthogonalization),
+  orthogonalization_strategy(orthogonalization_strategy)
 {}
 
 
@@ -716,6 +970,66 @@ SolverGMRES<VectorType>::modified_gram_schmidt
 
 
 
+template <class VectorType>
+inline
+double
+SolverGMRES<VectorType>::classical_gram_schmidt
+(const internal::SolverGMRES::TmpVectors<VectorType> &orthogonal_vectors,
+ const unsigned int                                  dim,
+ const unsigned int                                  accumulated_iterations,
+ VectorType                                          &vv,
+ Vector<double>                                      &h,
+ bool                                                &reorthogonalize,
+ const boost::signals2::signal<void(int)>            &reorthogonalize_signal)
+{
+  Assert(dim > 0, ExcInternalError());
+
+  typedef std::integral_constant<bool,
+          internal::VectorOperations::VectorAccess<VectorType>::is_supported>
+          DirectAccess;
+
+  // compute all inner products with the basis vectors and the norm of vv at
+  // once, followed by the subtraction of the projections and the
+  // computation of the new norm
+  Vector<double> products (dim+1);
+  internal::SolverGMRES::multi_dot (orthogonal_vectors, dim, vv, products,
+                                    DirectAccess());
+  const double norm_vv_start = std::sqrt(products(dim));
+  for (unsigned int i=0; i<dim; ++i)
+    h(i) = products(i);
+  double norm_vv = std::sqrt(internal::SolverGMRES::subtract_and_norm
+                             (orthogonal_vectors, dim, products, vv,
+                              DirectAccess()));
+
+  // Re-orthogonalization if loss of orthogonality detected, using the same
+  // strategy as in modified_gram_schmidt(), see there
+  if (reorthogonalize == false)
+    {
+      if (norm_vv > 10. * norm_vv_start *
+          std::sqrt(std::numeric_limits<typename VectorType::value_type>::epsilon()))
+        return norm_vv;
+
+      else
+        {
+          reorthogonalize = true;
+          if (!reorthogonalize_signal.empty())
+            reorthogonalize_signal(accumulated_iterations);
+        }
+    }
+
+  internal::SolverGMRES::multi_dot (orthogonal_vectors, dim, vv, products,
+                                    DirectAccess());
+  for (unsigned int i=0; i<dim; ++i)
+    h(i) += products(i);
+  norm_vv = std::sqrt(internal::SolverGMRES::subtract_and_norm
+                      (orthogonal_vectors, dim, products, vv,
+                       DirectAccess()));
+
+  return norm_vv;
+}
+
+
+
 template <class VectorType>
 inline void
 SolverGMRES<VectorType>::compute_eigs_and_cond
@@ -931,10 +1245,19 @@ SolverGMRES<VectorType>::solve (const MatrixType         &A,
 
           dim = inner_iteration+1;
 
-          const double s = modified_gram_schmidt(tmp_vectors, dim,
-                                                 accumulated_iterations,
-                                                 vv, h, re_orthogonalize,
-                                                 re_orthogonalize_signal);
+          const double s =
+            (additional_data.orthogonalization_strategy ==
+             LinearAlgebra::OrthogonalizationStrategy::classical_gram_schmidt)
+            ?
+            classical_gram_schmidt(tmp_vectors, dim,
+                                   accumulated_iterations,
+                                   vv, h, re_orthogonalize,
+                                   re_orthogonalize_signal)
+            :
+            modified_gram_schmidt(tmp_vectors, dim,
+                                  accumulated_iterations,
+                                  vv, h, re_orthogonalize,
+                                  re_orthogonalize_signal);
           h(inner_iteration+1) = s;
 
           //s=0 is a lucky breakdown, the solver will reach convergence,
@@ -0,0 +1,327 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_solver_iterative_refinement_h
+#define dealii_solver_iterative_refinement_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/logstream.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/vector.h>
+
+#include <limits>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*!@addtogroup Solvers */
+/*@{*/
+
+/**
+ * Implementation of a mixed-precision iterative refinement method. This
+ * solver wraps an inner iterative solver of type @p InnerSolverType that
+ * works on a vector type of (typically) lower precision, such as
+ * Vector<float>, with a matrix stored in lower precision, such as
+ * SparseMatrix<float>, and corrects the solution in an outer loop in full
+ * precision:
+ * @f{align*}{
+ *   r_k &= b - A x_k, \\
+ *   \tilde A d_k &= r_k \quad \text{(solved approximately by the inner solver)}, \\
+ *   x_{k+1} &= x_k + d_k,
+ * @f}
+ * where $A$ is the full precision matrix passed to solve() and $\tilde A$ is
+ * its low precision counterpart. The outer residual is computed with the
+ * full precision matrix, so the final accuracy is that of the full precision
+ * arithmetic, whereas the bulk of the work is done by the inner solver with
+ * half of the memory traffic for the matrix and vector entries. Since the
+ * matrix-vector product of iterative solvers is typically limited by the
+ * memory bandwidth, this can reduce the solution time considerably.
+ *
+ * The inner solver is run with a ReductionControl where the relative
+ * reduction of the residual is given by AdditionalData::inner_reduction,
+ * and it is not considered an error if the inner solver does not reach this
+ * reduction within AdditionalData::max_inner_iterations. The outer
+ * iteration is controlled by the SolverControl object given to the
+ * constructor and uses the norm of the full precision residual as the
+ * stopping criterion.
+ *
+ * A typical use looks as follows:
+ * @code
+ *   SparseMatrix<double> system_matrix;
+ *   ... // assemble matrix
+ *   SparseMatrix<float> system_matrix_float;
+ *   system_matrix_float.reinit (sparsity_pattern);
+ *   system_matrix_float.copy_from (system_matrix);
+ *
+ *   PreconditionJacobi<SparseMatrix<float> > preconditioner;
+ *   preconditioner.initialize (system_matrix_float);
+ *
+ *   SolverControl solver_control (100, 1e-12*system_rhs.l2_norm());
+ *   SolverIterativeRefinement<Vector<double>, SolverCG<Vector<float> > >
+ *     solver (solver_control);
+ *   solver.solve (system_matrix, solution, system_rhs,
+ *                 system_matrix_float, preconditioner);
+ * @endcode
+ *
+ * Alternatively, the inner solver can be run on vectors in full precision
+ * (e.g. @p InnerSolverType set to SolverCG<Vector<double> >) with a matrix
+ * in single precision. The matrix-vector products of SparseMatrix then
+ * accumulate in double precision and only the matrix values are stored in
+ * reduced precision.
+ *
+ * For the requirements on matrices and vectors in order to work with this
+ * class, see the documentation of the Solver base class. In addition, it
+ * must be possible to assign between @p VectorType and the vector type of
+ * the inner solver, and to call <tt>reinit(const VectorType &, bool)</tt>
+ * on the inner vector type.
+ *
+ *
+ * <h3>Observing the progress of linear solver iterations</h3>
+ *
+ * The solve() function of this class uses the mechanism described in the
+ * Solver base class to determine convergence of the outer iteration. The
+ * inner solver reports its progress through its own ReductionControl object,
+ * which does not log the iteration history by default.
+ */
+template <class VectorType = Vector<double>,
+          class InnerSolverType = SolverCG<Vector<float> > >
+class SolverIterativeRefinement : public Solver<VectorType>
+{
+public:
+  /**
+   * The vector type of the inner solver.
+   */
+  typedef typename InnerSolverType::vector_type inner_vector_type;
+
+  /**
+   * Standardized data struct to pipe additional data to the solver.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor. By default, reduce the inner residual by two orders of
+     * magnitude using at most 100 inner iterations per outer step.
+     */
+    explicit
+    AdditionalData (const unsigned int max_inner_iterations = 100,
+                    const double       inner_reduction      = 1e-2,
+                    const typename InnerSolverType::AdditionalData &inner_solver_data
+                    = typename InnerSolverType::AdditionalData());
+
+    /**
+     * Maximum number of iterations of the inner solver in each outer step.
+     */
+    unsigned int max_inner_iterations;
+
+    /**
+     * Relative reduction of the residual the inner solver should achieve in
+     * each outer step.
+     */
+    double inner_reduction;
+
+    /**
+     * Additional data handed to the inner solver.
+     */
+    typename InnerSolverType::AdditionalData inner_solver_data;
+  };
+
+  /**
+   * Constructor.
+   */
+  SolverIterativeRefinement (SolverControl            &cn,
+                             VectorMemory<VectorType> &mem,
+                             const AdditionalData     &data=AdditionalData());
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  SolverIterativeRefinement (SolverControl        &cn,
+                             const AdditionalData &data=AdditionalData());
+
+  /**
+   * Virtual destructor.
+   */
+  virtual ~SolverIterativeRefinement () = default;
+
+  /**
+   * Solve the linear system $Ax=b$ for x. The matrix @p A is used for
+   * computing the residual in the precision of @p VectorType. The matrix
+   * @p inner_matrix and the preconditioner @p inner_preconditioner are
+   * passed on to the inner solver and must work on vectors of type
+   * inner_vector_type.
+   */
+  template <typename MatrixType, typename InnerMatrixType, typename InnerPreconditionerType>
+  void
+  solve (const MatrixType              &A,
+         VectorType                    &x,
+         const VectorType              &b,
+         const InnerMatrixType         &inner_matrix,
+         const InnerPreconditionerType &inner_preconditioner);
+
+  /**
+   * Return the accumulated number of iterations of the inner solver in the
+   * last call to solve().
+   */
+  unsigned int n_inner_iterations () const;
+
+protected:
+  /**
+   * Control parameters.
+   */
+  AdditionalData additional_data;
+
+  /**
+   * Accumulated number of inner iterations.
+   */
+  unsigned int inner_iterations;
+};
+
+/*@}*/
+/*------------------ Implementation of iterative refinement -----------------*/
+
+#ifndef DOXYGEN
+
+template <class VectorType, class InnerSolverType>
+inline
+SolverIterativeRefinement<VectorType,InnerSolverType>::AdditionalData::
+AdditionalData (const unsigned int max_inner_iterations,
+                const double       inner_reduction,
+                const typename InnerSolverType::AdditionalData &inner_solver_data)
+  :
+  max_inner_iterations(max_inner_iterations),
+  inner_reduction(inner_reduction),
+  inner_solver_data(inner_solver_data)
+{}
+
+
+
+template <class VectorType, class InnerSolverType>
+SolverIterativeRefinement<VectorType,InnerSolverType>::
+SolverIterativeRefinement (SolverControl            &cn,
+                           VectorMemory<VectorType> &mem,
+                           const AdditionalData     &data)
+  :
+  Solver<VectorType> (cn,mem),
+  additional_data(data),
+  inner_iterations(0)
+{}
+
+
+
+template <class VectorType, class InnerSolverType>
+SolverIterativeRefinement<VectorType,InnerSolverType>::
+SolverIterativeRefinement (SolverControl        &cn,
+                           const AdditionalData &data)
+  :
+  Solver<VectorType> (cn),
+  additional_data(data),
+  inner_iterations(0)
+{}
+
+
+
+template <class VectorType, class InnerSolverType>
+template <typename MatrixType, typename InnerMatrixType, typename InnerPreconditionerType>
+void
+SolverIterativeRefinement<VectorType,InnerSolverType>::
+solve (const MatrixType              &A,
+       VectorType                    &x,
+       const VectorType              &b,
+       const InnerMatrixType         &inner_matrix,
+       const InnerPreconditionerType &inner_preconditioner)
+{
+  SolverControl::State conv=SolverControl::iterate;
+  double last_criterion = -std::numeric_limits<double>::max();
+
+  unsigned int iter = 0;
+  inner_iterations = 0;
+
+  // Memory allocation: 'Vr' holds the residual, 'Vd' the correction in full
+  // precision. The vectors of the inner solver live outside the memory pool
+  // because they are of a different type.
+  typename VectorMemory<VectorType>::Pointer Vr (this->memory);
+  typename VectorMemory<VectorType>::Pointer Vd (this->memory);
+
+  VectorType &r = *Vr;
+  r.reinit(x);
+  VectorType &d = *Vd;
+  d.reinit(x);
+
+  inner_vector_type inner_r, inner_d;
+  inner_r.reinit(x, true);
+  inner_d.reinit(x, true);
+
+  LogStream::Prefix prefix("IterativeRefinement");
+
+  while (conv==SolverControl::iterate)
+    {
+      A.vmult(r,x);
+      r.sadd(-1.,1.,b);
+
+      last_criterion = r.l2_norm();
+      conv = this->iteration_status (iter, last_criterion, x);
+      if (conv != SolverControl::iterate)
+        break;
+
+      // solve for the correction in reduced precision. we do not want to
+      // fail if the inner solver does not reach the requested reduction:
+      // any improvement gets corrected for by the outer iteration
+      inner_r = r;
+      inner_d = 0;
+      ReductionControl inner_control (additional_data.max_inner_iterations,
+                                      0., additional_data.inner_reduction,
+                                      false, false);
+      InnerSolverType inner_solver (inner_control,
+                                    additional_data.inner_solver_data);
+      try
+        {
+          inner_solver.solve (inner_matrix, inner_d, inner_r,
+                              inner_preconditioner);
+        }
+      catch (SolverControl::NoConvergence &)
+        {}
+      inner_iterations += inner_control.last_step();
+
+      d = inner_d;
+      x += d;
+
+      ++iter;
+    }
+
+  // in case of failure: throw exception
+  if (conv != SolverControl::success)
+    AssertThrow(false, SolverControl::NoConvergence (iter,
+                                                     last_criterion));
+  // otherwise exit as normal
+}
+
+
+
+template <class VectorType, class InnerSolverType>
+inline
+unsigned int
+SolverIterativeRefinement<VectorType,InnerSolverType>::n_inner_iterations () const
+{
+  return inner_iterations;
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,276 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_solver_multi_cg_h
+#define dealii_solver_multi_cg_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/logstream.h>
+#include <deal.II/lac/multi_vector.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/vector_memory.templates.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*!@addtogroup Solvers */
+/*@{*/
+
+/**
+ * The preconditioned conjugate gradient method run simultaneously on all
+ * vectors of a MultiVector, for solving a linear system with a symmetric
+ * positive definite matrix and several right hand sides. Each vector is
+ * iterated with its own step lengths exactly like in SolverCG, but the
+ * matrix-vector products and the preconditioner are applied to all vectors
+ * at once. With SparseMatrix::vmult(MultiVector &, const MultiVector &)
+ * const, each matrix entry is loaded only once per iteration for all
+ * vectors, which turns the memory-bandwidth bound matrix-vector product into
+ * a much more efficient operation.
+ *
+ * The matrix must provide a function <tt>vmult(MultiVector<Number> &, const
+ * MultiVector<Number> &)</tt>, and the preconditioner a function of the same
+ * signature. Possible choices are PreconditionIdentity, and
+ * PreconditionJacobi and PreconditionSSOR based on a SparseMatrix, since
+ * SparseMatrix implements the respective operations on MultiVector objects.
+ *
+ * The convergence check of the SolverControl object passed to the
+ * constructor is based on the largest residual norm among all vectors.
+ * Vectors that have converged to machine precision, i.e., whose residual or
+ * search direction vanishes, are no longer updated.
+ *
+ * A typical use looks as follows:
+ * @code
+ *   MultiVector<double> solution (n_dofs, n_rhs), rhs (n_dofs, n_rhs);
+ *   for (unsigned int i=0; i<n_rhs; ++i)
+ *     rhs.set_vector (i, right_hand_sides[i]);
+ *
+ *   PreconditionSSOR<SparseMatrix<double> > preconditioner;
+ *   preconditioner.initialize (system_matrix, 1.2);
+ *
+ *   SolverControl solver_control (1000, 1e-12);
+ *   SolverMultiCG<double> solver (solver_control);
+ *   solver.solve (system_matrix, solution, rhs, preconditioner);
+ * @endcode
+ *
+ * Since the iterations of the different vectors are independent, this is
+ * not a block Krylov method in the sense of O'Leary: the number of
+ * iterations for each vector is the same as when solving with SolverCG.
+ *
+ *
+ * <h3>Observing the progress of linear solver iterations</h3>
+ *
+ * The solve() function of this class uses the mechanism described in the
+ * Solver base class to determine convergence. This mechanism can also be used
+ * to observe the progress of the iteration.
+ */
+template <typename Number = double>
+class SolverMultiCG : public Solver<MultiVector<Number> >
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * Standardized data struct to pipe additional data to the solver. There
+   * is no additional data for this solver.
+   */
+  struct AdditionalData
+  {};
+
+  /**
+   * Constructor.
+   */
+  SolverMultiCG (SolverControl                     &cn,
+                 VectorMemory<MultiVector<Number> > &mem,
+                 const AdditionalData              &data = AdditionalData());
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  SolverMultiCG (SolverControl        &cn,
+                 const AdditionalData &data = AdditionalData());
+
+  /**
+   * Virtual destructor.
+   */
+  virtual ~SolverMultiCG () = default;
+
+  /**
+   * Solve the linear systems $Ax_j=b_j$ for all vectors $j$ in @p x and @p
+   * b.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve (const MatrixType          &A,
+         MultiVector<Number>       &x,
+         const MultiVector<Number> &b,
+         const PreconditionerType  &preconditioner);
+
+protected:
+  /**
+   * Return the largest of the given norms.
+   */
+  static double
+  max_norm (const std::vector<typename MultiVector<Number>::real_type> &norms);
+
+  /**
+   * Store a copy of the flags for this particular solver.
+   */
+  AdditionalData additional_data;
+};
+
+/*@}*/
+
+/*------------------------- Implementation ----------------------------*/
+
+#ifndef DOXYGEN
+
+template <typename Number>
+SolverMultiCG<Number>::SolverMultiCG (SolverControl                     &cn,
+                                      VectorMemory<MultiVector<Number> > &mem,
+                                      const AdditionalData              &data)
+  :
+  Solver<MultiVector<Number> > (cn,mem),
+  additional_data(data)
+{}
+
+
+
+template <typename Number>
+SolverMultiCG<Number>::SolverMultiCG (SolverControl        &cn,
+                                      const AdditionalData &data)
+  :
+  Solver<MultiVector<Number> > (cn),
+  additional_data(data)
+{}
+
+
+
+template <typename Number>
+double
+SolverMultiCG<Number>::max_norm
+(const std::vector<typename MultiVector<Number>::real_type> &norms)
+{
+  double result = 0;
+  for (unsigned int j=0; j<norms.size(); ++j)
+    result = std::max(result, static_cast<double>(norms[j]));
+  return result;
+}
+
+
+
+template <typename Number>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverMultiCG<Number>::solve (const MatrixType          &A,
+                              MultiVector<Number>       &x,
+                              const MultiVector<Number> &b,
+                              const PreconditionerType  &preconditioner)
+{
+  AssertDimension (x.n_vectors(), b.n_vectors());
+
+  SolverControl::State conv=SolverControl::iterate;
+  const unsigned int n_vectors = x.n_vectors();
+
+  LogStream::Prefix prefix("multi-cg");
+
+  // Memory allocation
+  typename VectorMemory<MultiVector<Number> >::Pointer g_pointer(this->memory);
+  typename VectorMemory<MultiVector<Number> >::Pointer d_pointer(this->memory);
+  typename VectorMemory<MultiVector<Number> >::Pointer h_pointer(this->memory);
+
+  // define some aliases for simpler access
+  MultiVector<Number> &g = *g_pointer;
+  MultiVector<Number> &d = *d_pointer;
+  MultiVector<Number> &h = *h_pointer;
+
+  g.reinit(x, true);
+  d.reinit(x, true);
+  h.reinit(x, true);
+
+  std::vector<Number> alpha (n_vectors), beta (n_vectors), gh (n_vectors),
+      dh (n_vectors), gh_new (n_vectors);
+  std::vector<typename MultiVector<Number>::real_type> residuals (n_vectors);
+
+  int it=0;
+
+  // compute the residuals g = b - Ax
+  A.vmult(g,x);
+  g *= Number(-1.);
+  g += b;
+  g.l2_norms(residuals);
+  double res = max_norm(residuals);
+
+  conv = this->iteration_status(0, res, x);
+  if (conv != SolverControl::iterate)
+    return;
+
+  preconditioner.vmult(h,g);
+  d = h;
+  g.inner_products(h, gh);
+
+  while (conv == SolverControl::iterate)
+    {
+      it++;
+      A.vmult(h,d);
+      d.inner_products(h, dh);
+
+      // vectors for which the search direction vanishes have converged to
+      // machine precision; do not update them any more
+      for (unsigned int j=0; j<n_vectors; ++j)
+        alpha[j] = (dh[j] != Number() ? gh[j]/dh[j] : Number());
+
+      x.add(alpha, d);
+      for (unsigned int j=0; j<n_vectors; ++j)
+        alpha[j] = -alpha[j];
+      g.add(alpha, h);
+      g.l2_norms(residuals);
+      res = max_norm(residuals);
+
+      conv = this->iteration_status(it, res, x);
+      if (conv != SolverControl::iterate)
+        break;
+
+      preconditioner.vmult(h,g);
+      g.inner_products(h, gh_new);
+
+      for (unsigned int j=0; j<n_vectors; ++j)
+        {
+          beta[j] = (gh[j] != Number() ? gh_new[j]/gh[j] : Number());
+          gh[j] = gh_new[j];
+        }
+
+      d.sadd(beta, h);
+    }
+
+  // in case of failure: throw exception
+  if (conv != SolverControl::success)
+    AssertThrow(false, SolverControl::NoConvergence (it, res));
+  // otherwise exit as normal
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,342 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sparse_amg_h
+#define dealii_sparse_amg_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include <memory>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*! @addtogroup Preconditioners
+ *@{
+ */
+
+/**
+ * An algebraic multigrid preconditioner based on smoothed aggregation for
+ * matrices of type SparseMatrix, which does not need any external library.
+ * It is intended for symmetric positive definite matrices of scalar elliptic
+ * problems, e.g. as a preconditioner of SolverCG or as the coarse grid solver
+ * of a geometric multigrid method through MGCoarseGridAMG, and works on the
+ * matrix directly without copying it into the format of another package.
+ *
+ * The setup builds a hierarchy of matrices from the given matrix: The
+ * unknowns of a level are grouped into aggregates of strongly connected
+ * unknowns, where $j$ is strongly connected to $i$ if $|a_{ij}| > \theta
+ * \sqrt{|a_{ii} a_{jj}|}$ for the threshold $\theta$ given by
+ * AdditionalData::strong_threshold. Each aggregate becomes one unknown of the
+ * next coarser level. The tentative prolongation, which is the indicator of
+ * the aggregates, i.e., the near null space of constant functions, is
+ * smoothed by one damped Jacobi step $P = (I-\omega D^{-1}A) P_\text{tent}$
+ * with $\omega = \frac{4}{3}/\rho(D^{-1}A)$, where the spectral radius is
+ * bounded by the row sums of $D^{-1}A$. The coarse matrix is the Galerkin
+ * product $P^T A P$. Unknowns without strong connections, such as rows of
+ * constrained degrees of freedom that only contain a diagonal entry, are not
+ * represented on the coarser levels. The coarsening stops once a level has
+ * at most AdditionalData::max_coarse_size unknowns, where the matrix is
+ * inverted densely, or when it does not reduce the size of the problem
+ * substantially any more.
+ *
+ * The application of the preconditioner runs AdditionalData::n_cycles
+ * V-cycles with a PreconditionChebyshev smoother around point-Jacobi on all
+ * levels but the coarsest. The matrix-vector products and vector operations
+ * of the smoother and of the transfer use the multithreading of SparseMatrix
+ * and Vector, and the computation of the strength of connections and of the
+ * prolongation matrices in the setup are parallelized over the rows as well.
+ * The aggregation itself is sequential.
+ *
+ * @note Instantiations for this template are provided for <tt>@<float@> and
+ * @<double@></tt>, with vmult() and Tvmult() for vectors of both types.
+ */
+template <typename number>
+class SparseAMG : public Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * Standardized data struct to pipe additional parameters to the
+   * preconditioner.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor.
+     */
+    AdditionalData (const double       strong_threshold = 0.08,
+                    const unsigned int smoother_degree  = 2,
+                    const double       smoothing_range  = 15.,
+                    const unsigned int n_cycles         = 1,
+                    const unsigned int max_coarse_size  = 500,
+                    const unsigned int max_levels       = 20);
+
+    /**
+     * The threshold $\theta$ of the strength of connection between two
+     * unknowns that decides whether they are put into the same aggregate.
+     * Larger values give smaller aggregates and thus more levels.
+     */
+    double strong_threshold;
+
+    /**
+     * The degree of the Chebyshev smoother on each level, see
+     * PreconditionChebyshev::AdditionalData::degree.
+     */
+    unsigned int smoother_degree;
+
+    /**
+     * The range of eigenvalues the Chebyshev smoother reduces, see
+     * PreconditionChebyshev::AdditionalData::smoothing_range.
+     */
+    double smoothing_range;
+
+    /**
+     * The number of V-cycles performed by one call to vmult(). Values larger
+     * than one give a more accurate solution, e.g. when this class is used as
+     * coarse grid solver without an outer iteration.
+     */
+    unsigned int n_cycles;
+
+    /**
+     * The size of a level below which the coarsening stops and the matrix is
+     * inverted by a dense factorization.
+     */
+    unsigned int max_coarse_size;
+
+    /**
+     * The maximal number of levels, including the fine one.
+     */
+    unsigned int max_levels;
+  };
+
+  /**
+   * Constructor. Call initialize() before using this object.
+   */
+  SparseAMG ();
+
+  /**
+   * Build the multigrid hierarchy for @p matrix. Only a reference to the
+   * matrix is stored, so it must live as long as this object is used.
+   */
+  void initialize (const SparseMatrix<number> &matrix,
+                   const AdditionalData       &additional_data = AdditionalData());
+
+  /**
+   * Release all memory and return to a state just like after having called
+   * the default constructor.
+   */
+  void clear ();
+
+  /**
+   * Apply the preconditioner, i.e., run the V-cycles with @p src as right
+   * hand side and a zero initial guess, and store the result in @p dst.
+   */
+  template <typename somenumber>
+  void vmult (Vector<somenumber>       &dst,
+              const Vector<somenumber> &src) const;
+
+  /**
+   * Apply the transpose of the preconditioner. As the V-cycle is symmetric
+   * for symmetric matrices, this is the same as vmult().
+   */
+  template <typename somenumber>
+  void Tvmult (Vector<somenumber>       &dst,
+               const Vector<somenumber> &src) const;
+
+  /**
+   * Return the dimension of the codomain (or range) space.
+   */
+  size_type m () const;
+
+  /**
+   * Return the dimension of the domain space.
+   */
+  size_type n () const;
+
+  /**
+   * Return the number of levels of the hierarchy, including the fine level.
+   */
+  unsigned int n_levels () const;
+
+  /**
+   * Return the operator complexity, i.e., the number of nonzero entries of
+   * the matrices on all levels divided by the number of nonzero entries of
+   * the fine matrix.
+   */
+  double get_operator_complexity () const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object, not counting the matrix passed to initialize().
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * The data of one level of the hierarchy.
+   */
+  struct Level
+  {
+    /**
+     * The matrix of the level, unused on the fine level, where the matrix
+     * passed to initialize() is used instead.
+     */
+    SparsityPattern      sparsity;
+    SparseMatrix<number> matrix;
+
+    /**
+     * The prolongation from the next coarser level to the present one.
+     * Empty on the coarsest level.
+     */
+    SparsityPattern      prolongation_sparsity;
+    SparseMatrix<number> prolongation;
+
+    /**
+     * The smoother of the level, unused on the coarsest level.
+     */
+    PreconditionChebyshev<SparseMatrix<number>,Vector<number> > smoother;
+
+    /**
+     * Vectors for the V-cycle.
+     */
+    mutable Vector<number> solution;
+    mutable Vector<number> rhs;
+    mutable Vector<number> residual;
+  };
+
+  /**
+   * Return the matrix of the given level.
+   */
+  const SparseMatrix<number> &get_matrix (const unsigned int level) const;
+
+  /**
+   * Group the unknowns of @p matrix into aggregates, store the aggregate of
+   * each unknown, or numbers::invalid_unsigned_int for unknowns without
+   * strong connections, and return the number of aggregates.
+   */
+  unsigned int
+  compute_aggregates (const SparseMatrix<number>  &matrix,
+                      std::vector<unsigned int>   &aggregates) const;
+
+  /**
+   * Set up the smoothed prolongation of @p level from the aggregates of its
+   * unknowns.
+   */
+  void build_prolongation (const unsigned int               level,
+                           const std::vector<unsigned int> &aggregates,
+                           const unsigned int               n_aggregates);
+
+  /**
+   * Run one V-cycle on @p level for the right hand side in the @p rhs vector
+   * of the level with a zero initial guess, storing the result in the @p
+   * solution vector of the level.
+   */
+  void v_cycle (const unsigned int level) const;
+
+  /**
+   * The matrix passed to initialize().
+   */
+  SmartPointer<const SparseMatrix<number>,SparseAMG<number> > fine_matrix;
+
+  /**
+   * The settings.
+   */
+  AdditionalData data;
+
+  /**
+   * The levels of the hierarchy, starting with the fine level.
+   */
+  std::vector<std::unique_ptr<Level> > levels;
+
+  /**
+   * The inverse of the matrix on the coarsest level.
+   */
+  FullMatrix<number> coarse_inverse;
+
+  /**
+   * Vectors for the repeated V-cycles if AdditionalData::n_cycles is larger
+   * than one.
+   */
+  mutable Vector<number> fine_solution;
+  mutable Vector<number> fine_rhs;
+};
+
+/*@}*/
+
+
+/* ---------------------------------- Inline functions ------------------- */
+
+#ifndef DOXYGEN
+
+template <typename number>
+inline
+typename SparseAMG<number>::size_type
+SparseAMG<number>::m () const
+{
+  Assert (fine_matrix != nullptr, ExcNotInitialized());
+  return fine_matrix->m();
+}
+
+
+
+template <typename number>
+inline
+typename SparseAMG<number>::size_type
+SparseAMG<number>::n () const
+{
+  Assert (fine_matrix != nullptr, ExcNotInitialized());
+  return fine_matrix->n();
+}
+
+
+
+template <typename number>
+inline
+unsigned int
+SparseAMG<number>::n_levels () const
+{
+  return levels.size();
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+inline
+void
+SparseAMG<number>::Tvmult (Vector<somenumber>       &dst,
+                           const Vector<somenumber> &src) const
+{
+  vmult (dst, src);
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -17,6 +17,8 @@
 #define dealii_sparse_decomposition_h
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/lac/sparse_matrix.h>
 
 #include <cmath>
@@ -317,6 +319,61 @@ protected:
    */
   void prebuild_lower_bound ();
 
+  /**
+   * The rows of the matrix grouped into levels for a parallel solution of
+   * the triangular systems with the lower triangular part of the
+   * decomposition: The rows of level $l$ only depend on rows of levels
+   * smaller than $l$ and can therefore be processed concurrently once all
+   * previous levels have been processed. The rows of level $l$ are stored
+   * in the entries <tt>lower_level_starts[l]</tt> to
+   * <tt>lower_level_starts[l+1]</tt> of this array. Becomes available after
+   * invocation of prebuild_levels().
+   */
+  std::vector<size_type> lower_level_rows;
+
+  /**
+   * The index of the first row of each level in #lower_level_rows.
+   */
+  std::vector<size_type> lower_level_starts;
+
+  /**
+   * Same as #lower_level_rows, but for the upper triangular part, where
+   * rows depend on rows with larger index.
+   */
+  std::vector<size_type> upper_level_rows;
+
+  /**
+   * The index of the first row of each level in #upper_level_rows.
+   */
+  std::vector<size_type> upper_level_starts;
+
+  /**
+   * Fills the level arrays #lower_level_rows, #lower_level_starts,
+   * #upper_level_rows, and #upper_level_starts from the sparsity pattern.
+   * Requires the #prebuilt_lower_bound array to be set up.
+   */
+  void prebuild_levels ();
+
+  /**
+   * Return whether the derived classes should process the rows by levels
+   * in parallel, which is the case if more than one thread is available.
+   * Processing by levels gives the same results as the sequential
+   * algorithms, since the operations on each row are performed in the same
+   * order.
+   */
+  bool use_level_scheduling () const;
+
+  /**
+   * Call <tt>row_operation(row)</tt> for the rows given by @p level_starts and
+   * @p level_rows (one of the two pairs of level arrays above), level by
+   * level. The rows within one level are processed in parallel if the
+   * level is large enough.
+   */
+  template <typename RowOperation>
+  void apply_by_levels (const std::vector<size_type> &level_starts,
+                        const std::vector<size_type> &level_rows,
+                        const RowOperation           &row_operation) const;
+
 private:
 
   /**
@@ -402,6 +459,47 @@ SparseLUDecomposition<number>::Tvmult_add (OutVector &dst,
   dst += tmp;
 }
 
+
+
+template <typename number>
+inline bool
+SparseLUDecomposition<number>::use_level_scheduling () const
+{
+  return (MultithreadInfo::n_threads() > 1 &&
+          lower_level_starts.size() > 1 &&
+          upper_level_starts.size() > 1);
+}
+
+
+
+template <typename number>
+template <typename RowOperation>
+inline void
+SparseLUDecomposition<number>::apply_by_levels
+(const std::vector<size_type> &level_starts,
+ const std::vector<size_type> &level_rows,
+ const RowOperation           &row_operation) const
+{
+  const size_type *rows = level_rows.data();
+  for (unsigned int level=0; level+1<level_starts.size(); ++level)
+    {
+      // small levels are not worth the overhead of spawning tasks
+      if (level_starts[level+1]-level_starts[level] <
+          internal::SparseMatrix::minimum_parallel_grain_size)
+        for (size_type i=level_starts[level]; i<level_starts[level+1]; ++i)
+          row_operation(rows[i]);
+      else
+        parallel::apply_to_subranges
+        (level_starts[level], level_starts[level+1],
+         [&] (const size_type begin, const size_type end)
+        {
+          for (size_type i=begin; i<end; ++i)
+            row_operation(rows[i]);
+        },
+        internal::SparseMatrix::minimum_parallel_grain_size);
+    }
+}
+
 //---------------------------------------------------------------------------
 
 
@@ -50,6 +50,11 @@ void SparseLUDecomposition<number>::clear()
   std::vector<const size_type *> tmp;
   tmp.swap (prebuilt_lower_bound);
 
+  lower_level_rows.clear();
+  lower_level_starts.clear();
+  upper_level_rows.clear();
+  upper_level_starts.clear();
+
   SparseMatrix<number>::clear();
 
   if (own_sparsity)
@@ -151,6 +156,86 @@ SparseLUDecomposition<number>::prebuild_lower_bound()
     }
 }
 
+
+
+namespace internal
+{
+  namespace SparseLUDecomposition
+  {
+    /**
+     * Sort the rows by the given levels, resulting in the arrays of rows
+     * and the starting index of each level.
+     */
+    inline void
+    sort_by_levels (const std::vector<types::global_dof_index> &levels,
+                    const types::global_dof_index               n_levels,
+                    std::vector<types::global_dof_index>       &level_rows,
+                    std::vector<types::global_dof_index>       &level_starts)
+    {
+      level_starts.clear();
+      level_starts.resize (n_levels+1, 0);
+      for (types::global_dof_index row=0; row<levels.size(); ++row)
+        ++level_starts[levels[row]+1];
+      for (types::global_dof_index l=0; l<n_levels; ++l)
+        level_starts[l+1] += level_starts[l];
+
+      std::vector<types::global_dof_index> position (level_starts.begin(),
+                                                     level_starts.end()-1);
+      level_rows.resize (levels.size());
+      for (types::global_dof_index row=0; row<levels.size(); ++row)
+        level_rows[position[levels[row]]++] = row;
+    }
+  }
+}
+
+
+
+template <typename number>
+void
+SparseLUDecomposition<number>::prebuild_levels()
+{
+  Assert (prebuilt_lower_bound.size() == this->m(), ExcNotInitialized());
+
+  const size_type *const
+  column_numbers = this->get_sparsity_pattern().colnums.get();
+  const std::size_t *const
+  rowstart_indices = this->get_sparsity_pattern().rowstart.get();
+  const size_type N = this->m();
+
+  // the level of a row is one more than the largest level among the rows
+  // it depends on, i.e., the rows of the entries left of the diagonal for
+  // the lower triangular part
+  std::vector<size_type> levels (N, 0);
+  size_type n_levels = 0;
+  for (size_type row=0; row<N; ++row)
+    {
+      size_type level = 0;
+      for (const size_type *col=&column_numbers[rowstart_indices[row]+1];
+           col != prebuilt_lower_bound[row]; ++col)
+        level = std::max (level, levels[*col]+1);
+      levels[row] = level;
+      n_levels = std::max (n_levels, level+1);
+    }
+  internal::SparseLUDecomposition::sort_by_levels (levels, n_levels,
+                                                   lower_level_rows,
+                                                   lower_level_starts);
+
+  // same for the upper triangular part, going through the rows backwards
+  n_levels = 0;
+  for (size_type row=N; row>0; --row)
+    {
+      size_type level = 0;
+      for (const size_type *col=prebuilt_lower_bound[row-1];
+           col != &column_numbers[rowstart_indices[row]]; ++col)
+        level = std::max (level, levels[*col]+1);
+      levels[row-1] = level;
+      n_levels = std::max (n_levels, level+1);
+    }
+  internal::SparseLUDecomposition::sort_by_levels (levels, n_levels,
+                                                   upper_level_rows,
+                                                   upper_level_starts);
+}
+
 template <typename number>
 template <typename somenumber>
 void
@@ -228,7 +313,11 @@ std::size_t
 SparseLUDecomposition<number>::memory_consumption () const
 {
   return (SparseMatrix<number>::memory_consumption () +
-          MemoryConsumption::memory_consumption(prebuilt_lower_bound));
+          MemoryConsumption::memory_consumption(prebuilt_lower_bound) +
+          MemoryConsumption::memory_consumption(lower_level_rows) +
+          MemoryConsumption::memory_consumption(lower_level_starts) +
+          MemoryConsumption::memory_consumption(upper_level_rows) +
+          MemoryConsumption::memory_consumption(upper_level_starts));
 }
 
 
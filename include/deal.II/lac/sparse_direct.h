@@ -139,6 +139,25 @@ public:
   template <class Matrix>
   void factorize (const Matrix &matrix);
 
+  /**
+   * Factorize a matrix that has the same sparsity pattern as the matrix
+   * passed to the last call to factorize() or refactorize(), but different
+   * values, as happens for example for the Jacobian matrices of a Newton
+   * method. The symbolic analysis of the matrix, i.e., the column ordering
+   * that reduces the fill-in and the structure of the factors, is kept from
+   * the previous factorization and only the numerical factorization is
+   * recomputed, which saves the time spent in the symbolic phase of UMFPACK.
+   *
+   * If the object has not been factorized before, or if the sparsity pattern
+   * of @p matrix differs from the one of the previous factorization, this
+   * function falls back to factorize(). Since the pivots are chosen in the
+   * numerical factorization, the symbolic analysis remains valid for any
+   * values of the entries of the matrix, as long as the matrix is
+   * nonsingular.
+   */
+  template <class Matrix>
+  void refactorize (const Matrix &matrix);
+
   /**
    * Initialize memory and call SparseDirectUMFPACK::factorize.
    */
@@ -235,6 +254,16 @@ public:
   void solve (BlockVector<double> &rhs_and_solution,
               const bool           transpose = false) const;
 
+  /**
+   * Solve for several right hand side vectors with the same factorization,
+   * e.g., for the columns of a block of unknowns or for the right hand sides
+   * of several time steps. The solutions are returned in place of the right
+   * hand side vectors. The right hand sides are solved for independently of
+   * each other, and are distributed among the available threads.
+   */
+  void solve (std::vector<Vector<double> > &rhs_and_solutions,
+              const bool                    transpose = false) const;
+
   /**
    * Call the two functions factorize() and solve() in that order, i.e.
    * perform the whole solution process for the given right hand side vector.
@@ -312,6 +341,8 @@ private:
    * The UMFPACK routines allocate objects in which they store information
    * about symbolic and numeric values of the decomposition. The actual data
    * type of these objects is opaque, and only passed around as void pointers.
+   * The symbolic decomposition is kept after the factorization for use by
+   * refactorize().
    */
   void *symbolic_decomposition;
   void *numeric_decomposition;
@@ -336,6 +367,13 @@ private:
   template <typename number>
   void sort_arrays (const BlockSparseMatrix<number> &);
 
+  /**
+   * Copy the sparsity pattern and the entries of @p matrix into the arrays
+   * Ap, Ai, and Ax in the format UMFPACK wants.
+   */
+  template <class Matrix>
+  void copy_matrix_entries (const Matrix &matrix);
+
   /**
    * The arrays in which we store the data for the solver. SuiteSparse_long
    * has to be used here for Windows 64 build, if we used only long int,
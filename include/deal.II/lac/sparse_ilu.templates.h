@@ -19,6 +19,7 @@
 
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/thread_local_storage.h>
 #include <deal.II/lac/vector.h>
 #include <deal.II/lac/sparse_ilu.h>
 
@@ -45,6 +46,7 @@ void SparseILU<number>::initialize (const SparseMatrix<somenumber> &matrix,
 
   this->strengthen_diagonal = data.strengthen_diagonal;
   this->prebuild_lower_bound ();
+  this->prebuild_levels ();
   this->copy_from (matrix);
 
   if (data.strengthen_diagonal>0)
@@ -60,37 +62,31 @@ void SparseILU<number>::initialize (const SparseMatrix<somenumber> &matrix,
   number *luval = this->SparseMatrix<number>::val.get();
 
   const size_type N = this->m();
-  size_type jrow = 0;
 
-  std::vector<size_type> iw (N, numbers::invalid_size_type);
-
-  for (size_type k=0; k<N; ++k)
-    {
-      const size_type j1 = ia[k],
-                      j2 = ia[k+1]-1;
-
-      for (size_type j=j1; j<=j2; ++j)
-        iw[ja[j]] = j;
-
-      // the algorithm in the book works on the elements of row k left of the
-      // diagonal. however, since we store the diagonal element at the first
-      // position, start at the element after the diagonal and run as long as
-      // we don't walk into the right half
-      size_type j = j1+1;
-
-      // pathological case: the current row of the matrix has only the
-      // diagonal entry. then we have nothing to do.
-      if (j > j2)
-        goto label_200;
-
-label_150:
-
-      jrow = ja[j];
-      if (jrow >= k)
-        goto label_200;
-
-      // actual computations:
+  // the elimination of row k only modifies the entries of row k and reads
+  // from the (already finished) rows left of the diagonal. the temporary
+  // array iw maps the column indices of row k to their position in the
+  // matrix and is reset to invalid entries when done with the row
+  const auto factorize_row = [&] (const size_type k,
+                                  std::vector<size_type> &iw)
+  {
+    const size_type j1 = ia[k],
+                    j2 = ia[k+1]-1;
+
+    for (size_type j=j1; j<=j2; ++j)
+      iw[ja[j]] = j;
+
+    // the algorithm in the book works on the elements of row k left of the
+    // diagonal. however, since we store the diagonal element at the first
+    // position, start at the element after the diagonal and run as long as
+    // we don't walk into the right half
+    for (size_type j=j1+1; j<=j2; ++j)
       {
+        const size_type jrow = ja[j];
+        if (jrow >= k)
+          break;
+
+        // actual computations:
         number t1 = luval[j] * luval[ia[jrow]];
         luval[j] = t1;
 
@@ -104,29 +100,36 @@ label_150:
             if (jw != numbers::invalid_size_type)
               luval[jw] -= t1 * luval[jj];
           }
-
-        ++j;
-        if (j<=j2)
-          goto label_150;
       }
 
-label_200:
-
-      // in the book there is an assertion that we have hit the diagonal
-      // element, i.e. that jrow==k. however, we store the diagonal element at
-      // the front, so jrow must actually be larger than k or j is already in
-      // the next row
-      Assert ((jrow > k) || (j==ia[k+1]), ExcInternalError());
+    // now we have to deal with the diagonal element. in the book it is
+    // located at position 'j', but here we use the convention of storing
+    // the diagonal element first, so instead of j we use uptr[k]=ia[k]
+    Assert (luval[ia[k]] != 0, ExcZeroPivot(k));
 
-      // now we have to deal with the diagonal element. in the book it is
-      // located at position 'j', but here we use the convention of storing
-      // the diagonal element first, so instead of j we use uptr[k]=ia[k]
-      Assert (luval[ia[k]] != 0, ExcZeroPivot(k));
+    luval[ia[k]] = 1./luval[ia[k]];
 
-      luval[ia[k]] = 1./luval[ia[k]];
+    for (size_type j=j1; j<=j2; ++j)
+      iw[ja[j]] = numbers::invalid_size_type;
+  };
 
-      for (size_type j=j1; j<=j2; ++j)
-        iw[ja[j]] = numbers::invalid_size_type;
+  // rows of the same level do not depend on each other and can be
+  // factorized concurrently, giving the same result as the sequential loop
+  if (this->use_level_scheduling())
+    {
+      Threads::ThreadLocalStorage<std::vector<size_type> >
+      iw_storage (std::vector<size_type> (N, numbers::invalid_size_type));
+      this->apply_by_levels (this->lower_level_starts, this->lower_level_rows,
+                             [&] (const size_type k)
+      {
+        factorize_row (k, iw_storage.get());
+      });
+    }
+  else
+    {
+      std::vector<size_type> iw (N, numbers::invalid_size_type);
+      for (size_type k=0; k<N; ++k)
+        factorize_row (k, iw);
     }
 }
 
@@ -159,22 +162,22 @@ void SparseILU<number>::vmult (Vector<somenumber>       &dst,
   // perform it at the outset of the
   // loop
   dst = src;
-  for (size_type row=0; row<N; ++row)
-    {
-      // get start of this row. skip the
-      // diagonal element
-      const size_type *const rowstart = &column_numbers[rowstart_indices[row]+1];
-      // find the position where the part
-      // right of the diagonal starts
-      const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
-
-      somenumber dst_row = dst(row);
-      const number *luval = this->SparseMatrix<number>::val.get() +
-                            (rowstart - column_numbers);
-      for (const size_type *col=rowstart; col!=first_after_diagonal; ++col, ++luval)
-        dst_row -= *luval * dst(*col);
-      dst(row) = dst_row;
-    }
+  const auto forward_row = [&] (const size_type row)
+  {
+    // get start of this row. skip the
+    // diagonal element
+    const size_type *const rowstart = &column_numbers[rowstart_indices[row]+1];
+    // find the position where the part
+    // right of the diagonal starts
+    const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
+
+    somenumber dst_row = dst(row);
+    const number *luval = this->SparseMatrix<number>::val.get() +
+                          (rowstart - column_numbers);
+    for (const size_type *col=rowstart; col!=first_after_diagonal; ++col, ++luval)
+      dst_row -= *luval * dst(*col);
+    dst(row) = dst_row;
+  };
 
   // now the backward solve. same
   // procedure, but we need not set
@@ -184,24 +187,41 @@ void SparseILU<number>::vmult (Vector<somenumber>       &dst,
   // note that we need to scale now,
   // since the diagonal is not equal to
   // one now
-  for (int row=N-1; row>=0; --row)
+  const auto backward_row = [&] (const size_type row)
+  {
+    // get end of this row
+    const size_type *const rowend = &column_numbers[rowstart_indices[row+1]];
+    // find the position where the part
+    // right of the diagonal starts
+    const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
+
+    somenumber dst_row = dst(row);
+    const number *luval = this->SparseMatrix<number>::val.get() +
+                          (first_after_diagonal - column_numbers);
+    for (const size_type *col=first_after_diagonal; col!=rowend; ++col, ++luval)
+      dst_row -= *luval * dst(*col);
+
+    // scale by the diagonal element.
+    // note that the diagonal element
+    // was stored inverted
+    dst(row) = dst_row * this->diag_element(row);
+  };
+
+  // with several threads, process the rows that do not depend on each
+  // other in parallel
+  if (this->use_level_scheduling())
     {
-      // get end of this row
-      const size_type *const rowend = &column_numbers[rowstart_indices[row+1]];
-      // find the position where the part
-      // right of the diagonal starts
-      const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
-
-      somenumber dst_row = dst(row);
-      const number *luval = this->SparseMatrix<number>::val.get() +
-                            (first_after_diagonal - column_numbers);
-      for (const size_type *col=first_after_diagonal; col!=rowend; ++col, ++luval)
-        dst_row -= *luval * dst(*col);
-
-      // scale by the diagonal element.
-      // note that the diagonal element
-      // was stored inverted
-      dst(row) = dst_row * this->diag_element(row);
+      this->apply_by_levels (this->lower_level_starts, this->lower_level_rows,
+                             forward_row);
+      this->apply_by_levels (this->upper_level_starts, this->upper_level_rows,
+                             backward_row);
+    }
+  else
+    {
+      for (size_type row=0; row<N; ++row)
+        forward_row (row);
+      for (size_type row=N; row>0; --row)
+        backward_row (row-1);
     }
 }
 
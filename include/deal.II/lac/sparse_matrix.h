@@ -20,6 +20,7 @@
 #include <deal.II/base/config.h>
 #include <deal.II/base/subscriptor.h>
 #include <deal.II/base/smartpointer.h>
+#include <deal.II/base/thread_management.h>
 #include <deal.II/lac/sparsity_pattern.h>
 #include <deal.II/lac/identity_matrix.h>
 #include <deal.II/lac/exceptions.h>
@@ -31,8 +32,10 @@
 DEAL_II_NAMESPACE_OPEN
 
 template <typename number> class Vector;
+template <typename number> class MultiVector;
 template <typename number> class FullMatrix;
 template <typename Matrix> class BlockMatrixBase;
+class SparseMatrixAssemblyPlan;
 template <typename number> class SparseILU;
 
 #ifdef DEAL_II_WITH_TRILINOS
@@ -856,6 +859,30 @@ public:
             const bool       elide_zero_values = true,
             const bool       col_indices_are_sorted = false);
 
+  /**
+   * Select whether the add() functions update the matrix entries by atomic
+   * operations (see Threads::atomic_add()). With this mode enabled, several
+   * threads may add to the same entries of the matrix concurrently, which
+   * allows running the copier functions of WorkStream::run() in parallel
+   * without coloring the mesh, see WorkStream::run_with_concurrent_copiers().
+   * Atomic additions are somewhat more expensive than plain ones and the
+   * order in which contributions are summed is no longer deterministic, so
+   * results may differ in the last digits from run to run. The default is
+   * <tt>false</tt>. The setting is a property of this object and is neither
+   * copied nor moved to other matrices.
+   *
+   * Note that this mode only makes the add() functions thread-safe. All
+   * other functions, including set() and the functions that change the
+   * structure of the matrix, must still not be called concurrently.
+   */
+  void set_atomic_add_mode (const bool use_atomic_add);
+
+  /**
+   * Return whether the add() functions use atomic updates, see
+   * set_atomic_add_mode().
+   */
+  bool get_atomic_add_mode () const;
+
   /**
    * Multiply the entire matrix by a fixed factor.
    */
@@ -1028,6 +1055,16 @@ public:
    * you want to multiply with BlockVector objects, you should consider using
    * a BlockSparseMatrix as well.
    *
+   * The sum over the entries of each row is computed in the number type of
+   * the destination vector. For example, multiplying a SparseMatrix<float>
+   * with vectors of type Vector<double> converts each matrix entry to
+   * <tt>double</tt> before the multiplication and accumulates in double
+   * precision. This allows to store a matrix in reduced precision in order
+   * to reduce the memory traffic of the matrix-vector product, which usually
+   * dominates its cost, while retaining the accuracy of the vector
+   * operations. See SolverIterativeRefinement for a solver making use of
+   * this feature.
+   *
    * Source and destination must not be the same vector.
    *
    * @dealiiOperationIsMultithreaded
@@ -1094,6 +1131,33 @@ public:
   void Tvmult_add (OutVector      &dst,
                    const InVector &src) const;
 
+  /**
+   * Matrix-vector multiplication with several vectors at once: let
+   * <i>dst<sub>j</sub> = M*src<sub>j</sub></i> for all vectors
+   * <i>j</i> stored in the MultiVector objects, with <i>M</i> being this
+   * matrix. Each entry of the matrix is loaded only once for all vectors,
+   * which makes this function much faster than calling vmult() on each
+   * vector separately when the multiplication is limited by the memory
+   * bandwidth.
+   *
+   * Source and destination must not be the same object.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <typename somenumber>
+  void vmult (MultiVector<somenumber>       &dst,
+              const MultiVector<somenumber> &src) const;
+
+  /**
+   * Matrix-vector multiplication with the transpose matrix for several
+   * vectors at once, see the function above.
+   *
+   * Source and destination must not be the same object.
+   */
+  template <typename somenumber>
+  void Tvmult (MultiVector<somenumber>       &dst,
+               const MultiVector<somenumber> &src) const;
+
   /**
    * Return the square of the norm of the vector $v$ with respect to the norm
    * induced by this matrix, i.e. $\left(v,Mv\right)$. This is useful, e.g. in
@@ -1265,6 +1329,26 @@ public:
                           const number                    omega = 1.,
                           const std::vector<std::size_t> &pos_right_of_diagonal=std::vector<std::size_t>()) const;
 
+  /**
+   * Apply the Jacobi preconditioner to several vectors at once, see the
+   * function above.
+   */
+  template <typename somenumber>
+  void precondition_Jacobi (MultiVector<somenumber>       &dst,
+                            const MultiVector<somenumber> &src,
+                            const number                   omega = 1.) const;
+
+  /**
+   * Apply SSOR preconditioning to several vectors at once, loading each
+   * matrix entry only once per sweep for all vectors. The arguments are the
+   * same as for the function above.
+   */
+  template <typename somenumber>
+  void precondition_SSOR (MultiVector<somenumber>        &dst,
+                          const MultiVector<somenumber>  &src,
+                          const number                    omega = 1.,
+                          const std::vector<std::size_t> &pos_right_of_diagonal=std::vector<std::size_t>()) const;
+
   /**
    * Apply SOR preconditioning matrix to <tt>src</tt>.
    */
@@ -1374,6 +1458,76 @@ public:
   void SSOR_step (Vector<somenumber> &v,
                   const Vector<somenumber> &b,
                   const number        om = 1.) const;
+
+  /**
+   * Apply multicolored SSOR preconditioning to <tt>src</tt> with damping
+   * <tt>omega</tt>. The rows are processed color by color in the order given
+   * by @p colors in the forward sweep and in reverse order in the backward
+   * sweep, and the rows of each color are processed in parallel. The rows of
+   * one color must not couple among each other, as guaranteed by
+   * SparsityTools::color_sparsity_pattern().
+   *
+   * This is the same algorithm as in the functions above, but applied to the
+   * matrix with rows and columns renumbered color by color. Consequently,
+   * the result differs from the one of the lexicographic ordering.
+   */
+  template <typename somenumber>
+  void precondition_SSOR (Vector<somenumber>                         &dst,
+                          const Vector<somenumber>                   &src,
+                          const number                                omega,
+                          const std::vector<std::vector<size_type> > &colors) const;
+
+  /**
+   * Apply multicolored SOR preconditioning matrix to <tt>src</tt>. See
+   * precondition_SSOR() for the meaning of @p colors.
+   */
+  template <typename somenumber>
+  void precondition_SOR (Vector<somenumber>                         &dst,
+                         const Vector<somenumber>                   &src,
+                         const number                                om,
+                         const std::vector<std::vector<size_type> > &colors) const;
+
+  /**
+   * Apply multicolored transpose SOR preconditioning matrix to <tt>src</tt>,
+   * going through the colors in reverse order. See precondition_SSOR() for
+   * the meaning of @p colors.
+   */
+  template <typename somenumber>
+  void precondition_TSOR (Vector<somenumber>                         &dst,
+                          const Vector<somenumber>                   &src,
+                          const number                                om,
+                          const std::vector<std::vector<size_type> > &colors) const;
+
+  /**
+   * Do one multicolored SOR step on <tt>v</tt> with right hand side
+   * <tt>b</tt>, processing the rows color by color and the rows of each
+   * color in parallel. See precondition_SSOR() for the meaning of @p colors.
+   */
+  template <typename somenumber>
+  void SOR_step (Vector<somenumber>                         &v,
+                 const Vector<somenumber>                   &b,
+                 const number                                om,
+                 const std::vector<std::vector<size_type> > &colors) const;
+
+  /**
+   * Do one multicolored adjoint SOR step on <tt>v</tt>, going through the
+   * colors in reverse order.
+   */
+  template <typename somenumber>
+  void TSOR_step (Vector<somenumber>                         &v,
+                  const Vector<somenumber>                   &b,
+                  const number                                om,
+                  const std::vector<std::vector<size_type> > &colors) const;
+
+  /**
+   * Do one multicolored SSOR step on <tt>v</tt> by performing TSOR after
+   * SOR.
+   */
+  template <typename somenumber>
+  void SSOR_step (Vector<somenumber>                         &v,
+                  const Vector<somenumber>                   &b,
+                  const number                                om,
+                  const std::vector<std::vector<size_type> > &colors) const;
 //@}
   /**
    * @name Iterators
@@ -1520,6 +1674,15 @@ public:
    * file that wasn't actually created that way, but not more.
    */
   void block_read (std::istream &in);
+
+  /**
+   * Read data that has been written by block_write() to the file
+   * @p filename. In contrast to block_read(), the file is mapped into memory
+   * (see Utilities::System::MemoryMappedFile) and the entries are copied
+   * from there by all threads, without the copy through a stream buffer.
+   * The same requirements and checks as for block_read() apply.
+   */
+  void block_read_mapped (const std::string &filename);
   //@}
   /**
    * @addtogroup Exceptions
@@ -1615,11 +1778,22 @@ private:
    */
   std::size_t max_len;
 
+  /**
+   * Whether the add() functions use atomic updates of the entries, see
+   * set_atomic_add_mode().
+   */
+  bool atomic_add_mode;
+
   // make all other sparse matrices friends
   template <typename somenumber> friend class SparseMatrix;
   template <typename somenumber> friend class SparseLUDecomposition;
   template <typename> friend class SparseILU;
 
+  /**
+   * To allow adding local matrices directly into the value array.
+   */
+  friend class SparseMatrixAssemblyPlan;
+
   /**
    * To allow it calling private prepare_add() and prepare_set().
    */
@@ -1764,7 +1938,30 @@ SparseMatrix<number>::add (const size_type i,
       return;
     }
 
-  val[index] += value;
+  if (atomic_add_mode)
+    Threads::atomic_add (val[index], value);
+  else
+    val[index] += value;
+}
+
+
+
+template <typename number>
+inline
+void
+SparseMatrix<number>::set_atomic_add_mode (const bool use_atomic_add)
+{
+  atomic_add_mode = use_atomic_add;
+}
+
+
+
+template <typename number>
+inline
+bool
+SparseMatrix<number>::get_atomic_add_mode () const
+{
+  return atomic_add_mode;
 }
 
 
@@ -26,6 +26,7 @@
 #include <deal.II/lac/sparse_matrix.h>
 #include <deal.II/lac/trilinos_sparse_matrix.h>
 #include <deal.II/lac/vector.h>
+#include <deal.II/lac/multi_vector.h>
 #include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
 #include <deal.II/lac/vector_memory.h>
@@ -49,7 +50,8 @@ SparseMatrix<number>::SparseMatrix ()
   :
   cols(nullptr, "SparseMatrix"),
   val(nullptr),
-  max_len(0)
+  max_len(0),
+  atomic_add_mode(false)
 {}
 
 
@@ -60,7 +62,8 @@ SparseMatrix<number>::SparseMatrix (const SparseMatrix &m)
   Subscriptor (m),
   cols(nullptr, "SparseMatrix"),
   val(nullptr),
-  max_len(0)
+  max_len(0),
+  atomic_add_mode(false)
 {
   Assert (m.cols==nullptr && m.val==nullptr && m.max_len==0,
           ExcMessage("This constructor can only be called if the provided argument "
@@ -77,7 +80,8 @@ SparseMatrix<number>::SparseMatrix (SparseMatrix<number> &&m)
   Subscriptor(std::move(m)),
   cols(m.cols),
   val(std::move(m.val)),
-  max_len(m.max_len)
+  max_len(m.max_len),
+  atomic_add_mode(false)
 {
   m.cols = nullptr;
   m.val = nullptr;
@@ -124,7 +128,8 @@ SparseMatrix<number>::SparseMatrix (const SparsityPattern &c)
   :
   cols(nullptr, "SparseMatrix"),
   val(nullptr),
-  max_len(0)
+  max_len(0),
+  atomic_add_mode(false)
 {
   reinit (c);
 }
@@ -137,7 +142,8 @@ SparseMatrix<number>::SparseMatrix (const SparsityPattern &c,
   :
   cols(nullptr, "SparseMatrix"),
   val(nullptr),
-  max_len(0)
+  max_len(0),
+  atomic_add_mode(false)
 {
   (void)id;
   Assert (c.n_rows() == id.m(), ExcDimensionMismatch (c.n_rows(), id.m()));
@@ -466,10 +472,14 @@ namespace internal
      * In the sequential case, this function is called on all rows, in the
      * parallel case it may be called on a subrange, at the discretion of the
      * task scheduler.
+     *
+     * The function is compiled for several instruction sets and the variant
+     * matching the CPU is selected at load time, see DEAL_II_TARGET_CLONES.
      */
     template <typename number,
               typename InVector,
               typename OutVector>
+    DEAL_II_TARGET_CLONES
     void vmult_on_subrange (const size_type    begin_row,
                             const size_type    end_row,
                             const number      *values,
@@ -522,9 +532,12 @@ SparseMatrix<number>::add (const size_type  row,
   // and sorted indices it is faster to
   // just go through the column indices and
   // look whether we found one, rather than
-  // doing many binary searches
+  // doing many binary searches. in atomic
+  // mode, always go through the general
+  // path below which has a single place
+  // where values are written
   if (elide_zero_values == false && col_indices_are_sorted == true &&
-      n_cols > 3)
+      n_cols > 3 && atomic_add_mode == false)
     {
       // check whether the given indices are
       // really sorted
@@ -649,7 +662,10 @@ SparseMatrix<number>::add (const size_type  row,
         }
 
 add_value:
-      val[index] += value;
+      if (atomic_add_mode)
+        Threads::atomic_add (val[index], value);
+      else
+        val[index] += value;
       ++index;
     }
 }
@@ -844,6 +860,109 @@ SparseMatrix<number>::Tvmult_add (OutVector &dst,
 }
 
 
+
+namespace internal
+{
+  namespace SparseMatrix
+  {
+    /**
+     * Perform a vmult on several vectors stored in a MultiVector, using
+     * only a subinterval of the row indices. The loop over the vectors is
+     * innermost, such that each matrix entry is loaded once.
+     */
+    template <typename number, typename somenumber>
+    void vmult_multi_on_subrange (const size_type                  begin_row,
+                                  const size_type                  end_row,
+                                  const number                    *values,
+                                  const std::size_t               *rowstart,
+                                  const size_type                 *colnums,
+                                  const MultiVector<somenumber>   &src,
+                                  MultiVector<somenumber>         &dst)
+    {
+      const unsigned int n_vectors = src.n_vectors();
+      for (size_type row=begin_row; row<end_row; ++row)
+        {
+          somenumber *dst_ptr = dst.row(row);
+          for (unsigned int v=0; v<n_vectors; ++v)
+            dst_ptr[v] = somenumber();
+          for (std::size_t j=rowstart[row]; j<rowstart[row+1]; ++j)
+            {
+              const somenumber value = values[j];
+              const somenumber *src_ptr = src.row(colnums[j]);
+              for (unsigned int v=0; v<n_vectors; ++v)
+                dst_ptr[v] += value * src_ptr[v];
+            }
+        }
+    }
+  }
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::vmult (MultiVector<somenumber>       &dst,
+                             const MultiVector<somenumber> &src) const
+{
+  Assert (cols != nullptr, ExcNotInitialized());
+  Assert (val != nullptr, ExcNotInitialized());
+  Assert(m() == dst.size(), ExcDimensionMismatch(m(),dst.size()));
+  Assert(n() == src.size(), ExcDimensionMismatch(n(),src.size()));
+  AssertDimension (dst.n_vectors(), src.n_vectors());
+
+  Assert (!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
+
+  // the work per row grows with the number of vectors, so reduce the grain
+  // size accordingly
+  const size_type grain_size =
+    std::max<size_type>(1, internal::SparseMatrix::minimum_parallel_grain_size /
+                        std::max(1U, src.n_vectors()));
+  parallel::apply_to_subranges (size_type(0), m(),
+                                std::bind (&internal::SparseMatrix::vmult_multi_on_subrange
+                                           <number,somenumber>,
+                                           std::placeholders::_1, std::placeholders::_2,
+                                           val.get(),
+                                           cols->rowstart.get(),
+                                           cols->colnums.get(),
+                                           std::cref(src),
+                                           std::ref(dst)),
+                                grain_size);
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::Tvmult (MultiVector<somenumber>       &dst,
+                              const MultiVector<somenumber> &src) const
+{
+  Assert (val != nullptr, ExcNotInitialized());
+  Assert (cols != nullptr, ExcNotInitialized());
+  Assert(n() == dst.size(), ExcDimensionMismatch(n(),dst.size()));
+  Assert(m() == src.size(), ExcDimensionMismatch(m(),src.size()));
+  AssertDimension (dst.n_vectors(), src.n_vectors());
+
+  Assert (!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
+
+  dst = 0;
+
+  const unsigned int n_vectors = src.n_vectors();
+  for (size_type i=0; i<m(); i++)
+    {
+      const somenumber *src_ptr = src.row(i);
+      for (size_type j=cols->rowstart[i]; j<cols->rowstart[i+1] ; j++)
+        {
+          const somenumber value = val[j];
+          somenumber *dst_ptr = dst.row(cols->colnums[j]);
+          for (unsigned int v=0; v<n_vectors; ++v)
+            dst_ptr[v] += value * src_ptr[v];
+        }
+    }
+}
+
+
 namespace internal
 {
   namespace SparseMatrix
@@ -1563,6 +1682,136 @@ SparseMatrix<number>::precondition_SSOR (Vector<somenumber>              &dst,
 }
 
 
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::precondition_Jacobi (MultiVector<somenumber>       &dst,
+                                           const MultiVector<somenumber> &src,
+                                           const number                   om) const
+{
+  Assert (cols != nullptr, ExcNotInitialized());
+  Assert (val != nullptr, ExcNotInitialized());
+  AssertDimension (m(), n());
+  AssertDimension (dst.size(), n());
+  AssertDimension (src.size(), n());
+  AssertDimension (dst.n_vectors(), src.n_vectors());
+
+  AssertNoZerosOnDiagonal(*this);
+
+  const size_type n = src.size();
+  const unsigned int n_vectors = src.n_vectors();
+  const std::size_t *rowstart_ptr = &cols->rowstart[0];
+
+  // for square matrices, the diagonal entry is the first in each row
+  for (size_type i=0; i<n; ++i, ++rowstart_ptr)
+    {
+      const somenumber factor = somenumber(om) / somenumber(val[*rowstart_ptr]);
+      const somenumber *src_ptr = src.row(i);
+      somenumber *dst_ptr = dst.row(i);
+      for (unsigned int v=0; v<n_vectors; ++v)
+        dst_ptr[v] = factor * src_ptr[v];
+    }
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::precondition_SSOR (MultiVector<somenumber>        &dst,
+                                         const MultiVector<somenumber>  &src,
+                                         const number                    om,
+                                         const std::vector<std::size_t> &pos_right_of_diagonal) const
+{
+  Assert (cols != nullptr, ExcNotInitialized());
+  Assert (val != nullptr, ExcNotInitialized());
+  AssertDimension (m(), n());
+  AssertDimension (dst.size(), n());
+  AssertDimension (src.size(), n());
+  AssertDimension (dst.n_vectors(), src.n_vectors());
+  Assert (pos_right_of_diagonal.size() == 0 ||
+          pos_right_of_diagonal.size() == dst.size(),
+          ExcDimensionMismatch (pos_right_of_diagonal.size(), dst.size()));
+
+  AssertNoZerosOnDiagonal(*this);
+
+  const size_type n = src.size();
+  const unsigned int n_vectors = src.n_vectors();
+  const std::size_t *rowstart = &cols->rowstart[0];
+
+  // the entries left of the diagonal are at positions rowstart[row]+1 to
+  // the first entry right of the diagonal, and the ones right of the
+  // diagonal from there to the end of the row. use the stored positions if
+  // available and search for them otherwise
+  auto first_right_of_diagonal = [&] (const size_type row) -> std::size_t
+  {
+    if (pos_right_of_diagonal.size() != 0)
+      {
+        Assert (pos_right_of_diagonal[row] <= rowstart[row+1],
+                ExcInternalError());
+        return pos_right_of_diagonal[row];
+      }
+    else
+      return (Utilities::lower_bound (&cols->colnums[rowstart[row]+1],
+                                      &cols->colnums[rowstart[row+1]],
+                                      row)
+              -
+              &cols->colnums[0]);
+  };
+
+  // forward sweep
+  for (size_type row=0; row<n; ++row)
+    {
+      somenumber *dst_ptr = dst.row(row);
+      const somenumber *src_ptr = src.row(row);
+      for (unsigned int v=0; v<n_vectors; ++v)
+        dst_ptr[v] = src_ptr[v];
+
+      const std::size_t first_right_of_diagonal_index = first_right_of_diagonal(row);
+      for (std::size_t j=rowstart[row]+1; j<first_right_of_diagonal_index; ++j)
+        {
+          const somenumber value = om * val[j];
+          const somenumber *other = dst.row(cols->colnums[j]);
+          for (unsigned int v=0; v<n_vectors; ++v)
+            dst_ptr[v] -= value * other[v];
+        }
+
+      // divide by diagonal element
+      const somenumber inverse_diagonal = somenumber(1.)/somenumber(val[rowstart[row]]);
+      for (unsigned int v=0; v<n_vectors; ++v)
+        dst_ptr[v] *= inverse_diagonal;
+    }
+
+  for (size_type row=0; row<n; ++row)
+    {
+      somenumber *dst_ptr = dst.row(row);
+      const somenumber factor = somenumber(om*(number(2.)-om)) * somenumber(val[rowstart[row]]);
+      for (unsigned int v=0; v<n_vectors; ++v)
+        dst_ptr[v] *= factor;
+    }
+
+  // backward sweep
+  for (int row=n-1; row>=0; --row)
+    {
+      somenumber *dst_ptr = dst.row(row);
+      const std::size_t end_row = rowstart[row+1];
+      const std::size_t first_right_of_diagonal_index = first_right_of_diagonal(row);
+      for (std::size_t j=first_right_of_diagonal_index; j<end_row; ++j)
+        {
+          const somenumber value = om * val[j];
+          const somenumber *other = dst.row(cols->colnums[j]);
+          for (unsigned int v=0; v<n_vectors; ++v)
+            dst_ptr[v] -= value * other[v];
+        }
+
+      const somenumber inverse_diagonal = somenumber(1.)/somenumber(val[rowstart[row]]);
+      for (unsigned int v=0; v<n_vectors; ++v)
+        dst_ptr[v] *= inverse_diagonal;
+    }
+}
+
+
+
 template <typename number>
 template <typename somenumber>
 void
@@ -1829,6 +2078,285 @@ SparseMatrix<number>::SSOR_step (Vector<somenumber> &v,
 
 
 
+namespace internal
+{
+  namespace SparseMatrix
+  {
+    /**
+     * Call <tt>row_operation(row)</tt> for all rows in @p colors, one color
+     * after the other (in reverse order of the colors if @p forward is
+     * false), and the rows within each color in parallel.
+     */
+    template <typename size_type, typename RowOperation>
+    void
+    apply_by_colors (const std::vector<std::vector<size_type> > &colors,
+                     const bool                                  forward,
+                     const RowOperation                         &row_operation)
+    {
+      for (unsigned int c=0; c<colors.size(); ++c)
+        {
+          const std::vector<size_type> &rows
+            = colors[forward ? c : colors.size()-1-c];
+          parallel::apply_to_subranges
+          (size_type(0), size_type(rows.size()),
+           [&] (const size_type begin, const size_type end)
+          {
+            for (size_type i=begin; i<end; ++i)
+              row_operation (rows[i]);
+          },
+          minimum_parallel_grain_size);
+        }
+    }
+
+
+
+    /**
+     * Compute the color of each row from the lists of rows per color.
+     */
+    template <typename size_type>
+    void
+    compute_row_colors (const std::vector<std::vector<size_type> > &colors,
+                        const size_type                             n_rows,
+                        std::vector<unsigned int>                  &row_colors)
+    {
+      row_colors.assign (n_rows, numbers::invalid_unsigned_int);
+      for (unsigned int c=0; c<colors.size(); ++c)
+        for (unsigned int i=0; i<colors[c].size(); ++i)
+          {
+            AssertIndexRange (colors[c][i], n_rows);
+            Assert (row_colors[colors[c][i]] == numbers::invalid_unsigned_int,
+                    ExcMessage ("Each row must have exactly one color."));
+            row_colors[colors[c][i]] = c;
+          }
+      Assert (std::find (row_colors.begin(), row_colors.end(),
+                         numbers::invalid_unsigned_int) == row_colors.end(),
+              ExcMessage ("Each row must have exactly one color."));
+    }
+  }
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::precondition_SSOR (Vector<somenumber>                         &dst,
+                                         const Vector<somenumber>                   &src,
+                                         const number                                om,
+                                         const std::vector<std::vector<size_type> > &colors) const
+{
+  Assert (cols != nullptr, ExcNotInitialized());
+  Assert (val != nullptr, ExcNotInitialized());
+  AssertDimension (m(), n());
+  AssertDimension (dst.size(), n());
+  AssertDimension (src.size(), n());
+
+  AssertNoZerosOnDiagonal(*this);
+
+  std::vector<unsigned int> row_colors;
+  internal::SparseMatrix::compute_row_colors (colors, n(), row_colors);
+
+  const std::size_t *rowstart = &cols->rowstart[0];
+  const size_type   *colnums  = &cols->colnums[0];
+
+  // forward sweep: the rows of the colors processed before the current one
+  // take the role of the entries left of the diagonal
+  internal::SparseMatrix::apply_by_colors
+  (colors, true, [&] (const size_type row)
+  {
+    const unsigned int color = row_colors[row];
+    number s = 0;
+    for (std::size_t j=rowstart[row]+1; j<rowstart[row+1]; ++j)
+      {
+        Assert (row_colors[colnums[j]] != color,
+                ExcMessage ("Rows of the same color must not couple."));
+        if (row_colors[colnums[j]] < color)
+          s += val[j] * number(dst(colnums[j]));
+      }
+
+    somenumber result = src(row);
+    result -= s * om;
+    result /= val[rowstart[row]];
+    dst(row) = result;
+  });
+
+  parallel::apply_to_subranges
+  (size_type(0), n(), [&] (const size_type begin, const size_type end)
+  {
+    for (size_type row=begin; row<end; ++row)
+      dst(row) *= somenumber(om*(number(2.)-om)) * somenumber(val[rowstart[row]]);
+  },
+  internal::Vector::minimum_parallel_grain_size);
+
+  // backward sweep
+  internal::SparseMatrix::apply_by_colors
+  (colors, false, [&] (const size_type row)
+  {
+    const unsigned int color = row_colors[row];
+    number s = 0;
+    for (std::size_t j=rowstart[row]+1; j<rowstart[row+1]; ++j)
+      if (row_colors[colnums[j]] > color)
+        s += val[j] * number(dst(colnums[j]));
+
+    somenumber result = dst(row);
+    result -= s * om;
+    result /= val[rowstart[row]];
+    dst(row) = result;
+  });
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::precondition_SOR (Vector<somenumber>                         &dst,
+                                        const Vector<somenumber>                   &src,
+                                        const number                                om,
+                                        const std::vector<std::vector<size_type> > &colors) const
+{
+  Assert (cols != nullptr, ExcNotInitialized());
+  Assert (val != nullptr, ExcNotInitialized());
+  AssertDimension (m(), n());
+  AssertDimension (dst.size(), n());
+  AssertDimension (src.size(), n());
+
+  AssertNoZerosOnDiagonal(*this);
+
+  std::vector<unsigned int> row_colors;
+  internal::SparseMatrix::compute_row_colors (colors, n(), row_colors);
+
+  internal::SparseMatrix::apply_by_colors
+  (colors, true, [&] (const size_type row)
+  {
+    const unsigned int color = row_colors[row];
+    somenumber s = src(row);
+    for (size_type j=cols->rowstart[row]+1; j<cols->rowstart[row+1]; ++j)
+      {
+        const size_type col = cols->colnums[j];
+        Assert (row_colors[col] != color,
+                ExcMessage ("Rows of the same color must not couple."));
+        if (row_colors[col] < color)
+          s -= somenumber(val[j]) * dst(col);
+      }
+
+    dst(row) = s * somenumber(om) / somenumber(val[cols->rowstart[row]]);
+  });
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::precondition_TSOR (Vector<somenumber>                         &dst,
+                                         const Vector<somenumber>                   &src,
+                                         const number                                om,
+                                         const std::vector<std::vector<size_type> > &colors) const
+{
+  Assert (cols != nullptr, ExcNotInitialized());
+  Assert (val != nullptr, ExcNotInitialized());
+  AssertDimension (m(), n());
+  AssertDimension (dst.size(), n());
+  AssertDimension (src.size(), n());
+
+  AssertNoZerosOnDiagonal(*this);
+
+  std::vector<unsigned int> row_colors;
+  internal::SparseMatrix::compute_row_colors (colors, n(), row_colors);
+
+  internal::SparseMatrix::apply_by_colors
+  (colors, false, [&] (const size_type row)
+  {
+    const unsigned int color = row_colors[row];
+    somenumber s = src(row);
+    for (size_type j=cols->rowstart[row]+1; j<cols->rowstart[row+1]; ++j)
+      {
+        const size_type col = cols->colnums[j];
+        Assert (row_colors[col] != color,
+                ExcMessage ("Rows of the same color must not couple."));
+        if (row_colors[col] > color)
+          s -= somenumber(val[j]) * dst(col);
+      }
+
+    dst(row) = s * somenumber(om) / somenumber(val[cols->rowstart[row]]);
+  });
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::SOR_step (Vector<somenumber>                         &v,
+                                const Vector<somenumber>                   &b,
+                                const number                                om,
+                                const std::vector<std::vector<size_type> > &colors) const
+{
+  Assert (cols != nullptr, ExcNotInitialized());
+  Assert (val != nullptr, ExcNotInitialized());
+  AssertDimension (m(), n());
+  Assert (m() == v.size(), ExcDimensionMismatch(m(),v.size()));
+  Assert (m() == b.size(), ExcDimensionMismatch(m(),b.size()));
+
+  AssertNoZerosOnDiagonal(*this);
+
+  // since the rows of one color do not couple, each row only reads entries
+  // of v that are not written concurrently
+  internal::SparseMatrix::apply_by_colors
+  (colors, true, [&] (const size_type row)
+  {
+    somenumber s = b(row);
+    for (size_type j=cols->rowstart[row]; j<cols->rowstart[row+1]; ++j)
+      s -= somenumber(val[j]) * v(cols->colnums[j]);
+    v(row) += s * somenumber(om) / somenumber(val[cols->rowstart[row]]);
+  });
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::TSOR_step (Vector<somenumber>                         &v,
+                                 const Vector<somenumber>                   &b,
+                                 const number                                om,
+                                 const std::vector<std::vector<size_type> > &colors) const
+{
+  Assert (cols != nullptr, ExcNotInitialized());
+  Assert (val != nullptr, ExcNotInitialized());
+  AssertDimension (m(), n());
+  Assert (m() == v.size(), ExcDimensionMismatch(m(),v.size()));
+  Assert (m() == b.size(), ExcDimensionMismatch(m(),b.size()));
+
+  AssertNoZerosOnDiagonal(*this);
+
+  internal::SparseMatrix::apply_by_colors
+  (colors, false, [&] (const size_type row)
+  {
+    somenumber s = b(row);
+    for (size_type j=cols->rowstart[row]; j<cols->rowstart[row+1]; ++j)
+      s -= somenumber(val[j]) * v(cols->colnums[j]);
+    v(row) += s * somenumber(om) / somenumber(val[cols->rowstart[row]]);
+  });
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::SSOR_step (Vector<somenumber>                         &v,
+                                 const Vector<somenumber>                   &b,
+                                 const number                                om,
+                                 const std::vector<std::vector<size_type> > &colors) const
+{
+  SOR_step(v,b,om,colors);
+  TSOR_step(v,b,om,colors);
+}
+
+
+
 template <typename number>
 template <typename somenumber>
 void
@@ -2014,6 +2542,60 @@ SparseMatrix<number>::block_read (std::istream &in)
 }
 
 
+
+template <typename number>
+void
+SparseMatrix<number>::block_read_mapped (const std::string &filename)
+{
+  const Utilities::System::MemoryMappedFile file (filename);
+  const char *const data = file.data();
+  const std::size_t file_size = file.size();
+
+  // the number of entries is written
+  // as '[' max_len "][", see
+  // block_write()
+  AssertThrow (file_size > 0 && data[0] == '[', ExcIO());
+  std::size_t header_size = 1;
+  while (header_size < std::min<std::size_t>(file_size, 32) &&
+         data[header_size] != ']')
+    ++header_size;
+  AssertThrow (header_size+1 < file_size &&
+               data[header_size] == ']' && data[header_size+1] == '[',
+               ExcIO());
+
+  const std::string size_string (data+1, header_size-1);
+  max_len = std::strtoull (size_string.c_str(), nullptr, 10);
+  header_size += 2;
+
+  AssertThrow (file_size == header_size + max_len*sizeof(number) + 1,
+               ExcIO());
+  AssertThrow (data[file_size-1] == ']', ExcIO());
+
+  // reallocate space
+  val.reset (new number[max_len]);
+
+  // then copy the data in parallel, with the same grain size as in
+  // operator= to get the same memory layout on NUMA systems
+  const size_type grain_size =
+    (cols != nullptr && m() > 0)
+    ?
+    internal::SparseMatrix::minimum_parallel_grain_size *
+    (cols->n_nonzero_elements()+m()) / m()
+    :
+    internal::SparseMatrix::minimum_parallel_grain_size;
+  const char *const src = data + header_size;
+  number *const dst = val.get();
+  parallel::apply_to_subranges
+  (std::size_t(0), max_len,
+   [src, dst](const std::size_t begin, const std::size_t end)
+  {
+    std::memcpy (dst + begin, src + begin*sizeof(number),
+                 (end-begin)*sizeof(number));
+  },
+  grain_size);
+}
+
+
 template <typename number>
 void
 SparseMatrix<number>::compress (::dealii::VectorOperation::values)
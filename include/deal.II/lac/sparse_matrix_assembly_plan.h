@@ -0,0 +1,323 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sparse_matrix_assembly_plan_h
+#define dealii_sparse_matrix_assembly_plan_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*! @addtogroup Matrix1
+ *@{
+ */
+
+
+/**
+ * A class that stores, for each cell of a mesh, the positions in the value
+ * array of a SparseMatrix into which the entries of the local matrix of that
+ * cell are to be added. When the same matrix is assembled many times, as in
+ * Newton iterations or time stepping schemes with varying coefficients, the
+ * search for the column indices in the SparsityPattern done by
+ * SparseMatrix::add() and ConstraintMatrix::distribute_local_to_global() is
+ * done only once when setting up this object, and all subsequent assemblies
+ * are pure scatter-add operations.
+ *
+ * Cells with constrained degrees of freedom are not handled by precomputed
+ * positions, since the constraints may couple the cell to arbitrary other
+ * rows and columns. For these cells, distribute_local_to_global() hands the
+ * local contributions to ConstraintMatrix::distribute_local_to_global().
+ *
+ * A typical use looks as follows:
+ * @code
+ *   SparseMatrixAssemblyPlan assembly_plan;
+ *   assembly_plan.reinit (dof_handler, sparsity_pattern, constraints);
+ *
+ *   for (unsigned int newton_step=0; ...; ++newton_step)
+ *     {
+ *       system_matrix = 0;
+ *       system_rhs = 0;
+ *       for (auto cell : dof_handler.active_cell_iterators())
+ *         {
+ *           // compute cell_matrix and cell_rhs
+ *           ...
+ *           assembly_plan.distribute_local_to_global (cell->active_cell_index(),
+ *                                                     cell_matrix, cell_rhs,
+ *                                                     system_matrix, system_rhs);
+ *         }
+ *     }
+ * @endcode
+ *
+ * The ordering of the rows and columns of the local matrices must be the one
+ * given by <tt>cell->get_dof_indices()</tt>, and the sparsity pattern and
+ * the constraints must not change as long as this object is used. The
+ * memory consumption of this object is one index per entry of all local
+ * matrices of unconstrained cells.
+ *
+ * @note The function distribute_local_to_global() is thread-safe under the
+ * same conditions as ConstraintMatrix::distribute_local_to_global(), i.e.,
+ * if no two threads write into the same matrix rows at the same time, or if
+ * the matrix and vector use atomic additions, see
+ * SparseMatrix::set_atomic_add_mode().
+ */
+class SparseMatrixAssemblyPlan : public Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * Constructor. Creates an empty object.
+   */
+  SparseMatrixAssemblyPlan ();
+
+  /**
+   * Set up the positions for all cells, where the degrees of freedom of the
+   * cell with index <tt>c</tt> are given by <tt>cell_dof_indices[c]</tt>. An
+   * empty list of indices marks a cell that is not going to be assembled,
+   * e.g. a cell not owned by the current processor.
+   */
+  void reinit (const std::vector<std::vector<size_type> > &cell_dof_indices,
+               const SparsityPattern                      &sparsity_pattern,
+               const ConstraintMatrix                     &constraints);
+
+  /**
+   * Set up the positions for all active cells of the given DoFHandler or
+   * hp::DoFHandler, indexed by <tt>cell->active_cell_index()</tt>. Only
+   * locally owned cells are considered.
+   */
+  template <typename DoFHandlerType>
+  void reinit (const DoFHandlerType   &dof_handler,
+               const SparsityPattern  &sparsity_pattern,
+               const ConstraintMatrix &constraints);
+
+  /**
+   * Release all memory and return to a state just like after having called
+   * the default constructor.
+   */
+  void clear ();
+
+  /**
+   * Add the local matrix of the cell with the given index to the global
+   * matrix. The global matrix must be based on the sparsity pattern given
+   * to reinit().
+   */
+  template <typename number>
+  void distribute_local_to_global (const unsigned int        cell_index,
+                                   const FullMatrix<number> &local_matrix,
+                                   SparseMatrix<number>     &global_matrix) const;
+
+  /**
+   * Add the local matrix and the local vector of the cell with the given
+   * index to the global matrix and vector, respectively.
+   */
+  template <typename number, typename VectorType>
+  void distribute_local_to_global (const unsigned int        cell_index,
+                                   const FullMatrix<number> &local_matrix,
+                                   const Vector<typename VectorType::value_type> &local_vector,
+                                   SparseMatrix<number>     &global_matrix,
+                                   VectorType               &global_vector) const;
+
+  /**
+   * Return the number of cells this object has been set up for.
+   */
+  unsigned int n_cells () const;
+
+  /**
+   * Return whether the given cell is handled by precomputed positions, i.e.,
+   * whether none of its degrees of freedom is constrained.
+   */
+  bool has_precomputed_positions (const unsigned int cell_index) const;
+
+  /**
+   * Return an estimate of the memory consumption of this object in bytes.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * The sparsity pattern the positions refer to.
+   */
+  SmartPointer<const SparsityPattern,SparseMatrixAssemblyPlan> sparsity_pattern;
+
+  /**
+   * The constraints used for the cells with constrained degrees of freedom.
+   */
+  SmartPointer<const ConstraintMatrix,SparseMatrixAssemblyPlan> constraints;
+
+  /**
+   * The degrees of freedom of all cells, stored one after the other.
+   */
+  std::vector<size_type> dof_indices;
+
+  /**
+   * The position of the first degree of freedom of each cell in
+   * #dof_indices, with one additional entry for the end of the last cell.
+   */
+  std::vector<std::size_t> dof_index_starts;
+
+  /**
+   * The positions in the value array of the global matrix of the entries
+   * of the local matrices of all cells without constraints, stored row by
+   * row for each cell.
+   */
+  std::vector<std::size_t> positions;
+
+  /**
+   * The position of the first entry of each cell in #positions, or
+   * #invalid_position for cells with constraints.
+   */
+  std::vector<std::size_t> position_starts;
+
+  /**
+   * Marker for cells without precomputed positions.
+   */
+  static const std::size_t invalid_position = static_cast<std::size_t>(-1);
+};
+
+/*@}*/
+
+
+#ifndef DOXYGEN
+/* ---------------------------- Inline functions ---------------------------- */
+
+
+template <typename DoFHandlerType>
+void
+SparseMatrixAssemblyPlan::reinit (const DoFHandlerType   &dof_handler,
+                                  const SparsityPattern  &sparsity_pattern,
+                                  const ConstraintMatrix &constraints)
+{
+  std::vector<std::vector<size_type> >
+  cell_dof_indices (dof_handler.get_triangulation().n_active_cells());
+  for (typename DoFHandlerType::active_cell_iterator cell = dof_handler.begin_active();
+       cell != dof_handler.end(); ++cell)
+    if (cell->is_locally_owned())
+      {
+        std::vector<size_type> &indices = cell_dof_indices[cell->active_cell_index()];
+        indices.resize (cell->get_fe().dofs_per_cell);
+        cell->get_dof_indices (indices);
+      }
+  reinit (cell_dof_indices, sparsity_pattern, constraints);
+}
+
+
+
+inline
+unsigned int
+SparseMatrixAssemblyPlan::n_cells () const
+{
+  return position_starts.size();
+}
+
+
+
+inline
+bool
+SparseMatrixAssemblyPlan::has_precomputed_positions (const unsigned int cell_index) const
+{
+  AssertIndexRange (cell_index, n_cells());
+  return position_starts[cell_index] != invalid_position;
+}
+
+
+
+template <typename number>
+inline
+void
+SparseMatrixAssemblyPlan::distribute_local_to_global
+(const unsigned int        cell_index,
+ const FullMatrix<number> &local_matrix,
+ SparseMatrix<number>     &global_matrix) const
+{
+  AssertIndexRange (cell_index, n_cells());
+  Assert (&global_matrix.get_sparsity_pattern() == &*sparsity_pattern,
+          ExcMessage ("The matrix must be based on the sparsity pattern given "
+                      "to reinit()."));
+
+  const size_type *indices = dof_indices.data() + dof_index_starts[cell_index];
+  const unsigned int n_dofs = dof_index_starts[cell_index+1] - dof_index_starts[cell_index];
+  AssertDimension (local_matrix.m(), n_dofs);
+  AssertDimension (local_matrix.n(), n_dofs);
+
+  if (position_starts[cell_index] == invalid_position)
+    {
+      const std::vector<size_type> local_dof_indices (indices, indices+n_dofs);
+      constraints->distribute_local_to_global (local_matrix, local_dof_indices,
+                                               global_matrix);
+      return;
+    }
+
+  const std::size_t *cell_positions = positions.data() + position_starts[cell_index];
+  number *values = global_matrix.val.get();
+  if (global_matrix.atomic_add_mode)
+    for (unsigned int i=0; i<n_dofs; ++i)
+      for (unsigned int j=0; j<n_dofs; ++j, ++cell_positions)
+        Threads::atomic_add (values[*cell_positions], local_matrix(i,j));
+  else
+    for (unsigned int i=0; i<n_dofs; ++i)
+      for (unsigned int j=0; j<n_dofs; ++j, ++cell_positions)
+        values[*cell_positions] += local_matrix(i,j);
+}
+
+
+
+template <typename number, typename VectorType>
+inline
+void
+SparseMatrixAssemblyPlan::distribute_local_to_global
+(const unsigned int        cell_index,
+ const FullMatrix<number> &local_matrix,
+ const Vector<typename VectorType::value_type> &local_vector,
+ SparseMatrix<number>     &global_matrix,
+ VectorType               &global_vector) const
+{
+  AssertIndexRange (cell_index, n_cells());
+
+  const size_type *indices = dof_indices.data() + dof_index_starts[cell_index];
+  const unsigned int n_dofs = dof_index_starts[cell_index+1] - dof_index_starts[cell_index];
+  AssertDimension (local_vector.size(), n_dofs);
+
+  if (position_starts[cell_index] == invalid_position)
+    {
+      const std::vector<size_type> local_dof_indices (indices, indices+n_dofs);
+      constraints->distribute_local_to_global (local_matrix, local_vector,
+                                               local_dof_indices,
+                                               global_matrix, global_vector);
+      return;
+    }
+
+  distribute_local_to_global (cell_index, local_matrix, global_matrix);
+  global_vector.add (n_dofs, indices, local_vector.begin());
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
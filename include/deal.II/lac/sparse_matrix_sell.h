@@ -0,0 +1,726 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sparse_matrix_sell_h
+#define dealii_sparse_matrix_sell_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/lac/exceptions.h>
+#include <deal.II/lac/sparse_matrix.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+/**
+ * @addtogroup Matrix1
+ * @{
+ */
+
+/**
+ * A sparse matrix stored in the SELL-C-$\sigma$ (sliced ELLPACK) format. This
+ * format groups the rows of a matrix into chunks of $C$ rows, with $C$ equal
+ * to VectorizedArray<Number>::n_array_elements, and stores the entries of
+ * each chunk column by column, padding rows shorter than the longest row in
+ * the chunk by zeros. The matrix-vector product then processes each chunk
+ * with SIMD instructions: Each column step of a chunk loads one
+ * VectorizedArray of matrix entries, gathers the corresponding entries of
+ * the source vector, and accumulates into one VectorizedArray holding the
+ * results of $C$ rows. This is in contrast to the compressed row storage of
+ * SparseMatrix, where the loop over one row at a time does not allow for
+ * vectorization across the rows.
+ *
+ * In order to keep the amount of padding small when row lengths vary, the
+ * rows can be sorted by their length within windows of $\sigma$ rows before
+ * being grouped into chunks. For $\sigma=1$, no sorting takes place and the
+ * rows are stored in their original order, which allows the results of full
+ * chunks to be written to the destination vector with a single vectorized
+ * store operation. For matrices from finite element discretizations with
+ * roughly uniform row lengths (e.g. continuous elements on mostly structured
+ * meshes), $\sigma=1$ is typically the best choice, whereas adaptively
+ * refined meshes with hanging nodes benefit from values of $\sigma$ in the
+ * range of a few hundred rows.
+ *
+ * This class is not meant to be assembled into. Rather, it is built from an
+ * existing SparseMatrix by the reinit() function, after which it can be used
+ * in place of the original matrix for the operations that dominate iterative
+ * solvers, namely vmult(), Tvmult(), and precondition_Jacobi(). The class
+ * satisfies the interface required by the solver classes and can, for
+ * example, be handed to SolverCG together with a PreconditionIdentity or any
+ * preconditioner built on the original SparseMatrix:
+ * @code
+ *   SparseMatrix<double> system_matrix;
+ *   ... // assemble the matrix
+ *
+ *   SparseMatrixSELL<double> sell_matrix (system_matrix, 256);
+ *   SolverCG<> solver (solver_control);
+ *   solver.solve (sell_matrix, solution, system_rhs, PreconditionIdentity());
+ * @endcode
+ *
+ * Since column indices are used as offsets for gather operations on the
+ * source vector, the number of columns of the matrix must be representable
+ * by an <tt>unsigned int</tt>.
+ *
+ * @note The matrix-vector products run in parallel with the threads
+ * available through MultithreadInfo, using the same granularity
+ * considerations as the respective functions of SparseMatrix. Tvmult() runs
+ * sequentially since writing into the destination vector is not possible
+ * without conflicts.
+ *
+ * @tparam Number The type of the matrix entries. The vector types used in
+ * the matrix-vector products must have the same value type.
+ */
+template <typename Number>
+class SparseMatrixSELL : public Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * Type of the matrix entries.
+   */
+  typedef Number value_type;
+
+  /**
+   * The number of rows grouped into one chunk, i.e., the number of elements
+   * in a VectorizedArray of the given number type.
+   */
+  static const unsigned int chunk_size = VectorizedArray<Number>::n_array_elements;
+
+  /**
+   * Default constructor. Creates an empty matrix.
+   */
+  SparseMatrixSELL ();
+
+  /**
+   * Constructor. Sets up the matrix from a given SparseMatrix by calling
+   * reinit().
+   */
+  template <typename Number2>
+  explicit SparseMatrixSELL (const SparseMatrix<Number2> &matrix,
+                             const unsigned int           sigma = 1);
+
+  /**
+   * Copy the content of the given compressed row storage matrix into the
+   * sliced ELLPACK format. The argument @p sigma specifies the size of the
+   * window in which rows are sorted by length before being grouped into
+   * chunks. Values larger than one are rounded up to the next multiple of
+   * chunk_size. A value of one disables sorting.
+   *
+   * If the matrix is square and all diagonal elements are nonzero, the
+   * inverse of the diagonal is stored as well to be used by
+   * precondition_Jacobi().
+   */
+  template <typename Number2>
+  void reinit (const SparseMatrix<Number2> &matrix,
+               const unsigned int           sigma = 1);
+
+  /**
+   * Release all memory and return to a state just like after having called
+   * the default constructor.
+   */
+  void clear ();
+
+  /**
+   * Return the number of rows of this matrix.
+   */
+  size_type m () const;
+
+  /**
+   * Return the number of columns of this matrix.
+   */
+  size_type n () const;
+
+  /**
+   * Return the number of nonzero entries of the matrix this object has been
+   * initialized from.
+   */
+  std::size_t n_nonzero_elements () const;
+
+  /**
+   * Return the number of entries actually stored, including the padding
+   * introduced by the grouping of rows into chunks. The ratio between this
+   * number and n_nonzero_elements() is a measure of the efficiency of the
+   * storage scheme for the given matrix and value of $\sigma$.
+   */
+  std::size_t n_stored_elements () const;
+
+  /**
+   * Matrix-vector multiplication: let $dst = M*src$ with $M$ being this
+   * matrix.
+   */
+  template <class VectorType>
+  void vmult (VectorType       &dst,
+              const VectorType &src) const;
+
+  /**
+   * Matrix-vector multiplication: let $dst = M^T*src$ with $M$ being this
+   * matrix. This function does the same as vmult() but takes the transposed
+   * matrix.
+   */
+  template <class VectorType>
+  void Tvmult (VectorType       &dst,
+               const VectorType &src) const;
+
+  /**
+   * Adding matrix-vector multiplication. Add $M*src$ on $dst$ with $M$ being
+   * this matrix.
+   */
+  template <class VectorType>
+  void vmult_add (VectorType       &dst,
+                  const VectorType &src) const;
+
+  /**
+   * Adding matrix-vector multiplication. Add $M^T*src$ to $dst$ with $M$
+   * being this matrix. This function does the same as vmult_add() but takes
+   * the transposed matrix.
+   */
+  template <class VectorType>
+  void Tvmult_add (VectorType       &dst,
+                   const VectorType &src) const;
+
+  /**
+   * Apply the Jacobi preconditioner, which multiplies every element of the
+   * @p src vector by the inverse of the respective diagonal element and
+   * multiplies the result with the relaxation factor @p omega. The operation
+   * runs in SIMD chunks over contiguous ranges of rows.
+   */
+  template <class VectorType>
+  void precondition_Jacobi (VectorType       &dst,
+                            const VectorType &src,
+                            const Number      omega = 1.) const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t memory_consumption () const;
+
+  /**
+   * @addtogroup Exceptions
+   * @{
+   */
+
+  /**
+   * Exception
+   */
+  DeclExceptionMsg (ExcTooManyColumns,
+                    "The number of columns of the matrix exceeds the range "
+                    "of unsigned int that is used for the column indices "
+                    "of this class.");
+
+  /**
+   * Exception
+   */
+  DeclExceptionMsg (ExcNoInverseDiagonal,
+                    "The inverse of the diagonal is only available for "
+                    "square matrices without zeros on the diagonal.");
+  //@}
+
+private:
+  /**
+   * Implementation of vmult() and vmult_add() on the range of chunks
+   * <tt>[begin,end)</tt>.
+   */
+  void vmult_on_subrange (const size_type  begin,
+                          const size_type  end,
+                          const Number    *src,
+                          Number          *dst,
+                          const bool       add) const;
+
+  /**
+   * Implementation of precondition_Jacobi() on the range of rows
+   * <tt>[begin,end)</tt>.
+   */
+  void jacobi_on_subrange (const size_type  begin,
+                           const size_type  end,
+                           const Number    *src,
+                           Number          *dst,
+                           const Number     omega) const;
+
+  /**
+   * Number of rows of the matrix.
+   */
+  size_type n_rows;
+
+  /**
+   * Number of columns of the matrix.
+   */
+  size_type n_cols;
+
+  /**
+   * Number of nonzero entries of the original matrix.
+   */
+  std::size_t n_nonzeros;
+
+  /**
+   * Whether the rows were sorted by their length, i.e., whether the row
+   * stored in position <i>i</i> is different from row <i>i</i> of the
+   * matrix.
+   */
+  bool rows_are_permuted;
+
+  /**
+   * For each position within the chunks, the index of the matrix row stored
+   * there. Padding rows in the last chunk are marked by
+   * numbers::invalid_unsigned_int. Only filled if rows_are_permuted is true
+   * or the last chunk is incomplete.
+   */
+  std::vector<unsigned int> row_indices;
+
+  /**
+   * The offset of the first column step of each chunk in the arrays
+   * @p values and @p column_indices (the latter scaled by chunk_size). The
+   * difference of two consecutive entries is the width of the chunk.
+   */
+  std::vector<std::size_t> chunk_starts;
+
+  /**
+   * The matrix entries, one VectorizedArray per column step of each chunk.
+   */
+  AlignedVector<VectorizedArray<Number> > values;
+
+  /**
+   * The column indices of the entries, chunk_size indices per column step of
+   * each chunk. Padded entries refer to column zero and have a zero value.
+   */
+  AlignedVector<unsigned int> column_indices;
+
+  /**
+   * The inverse of the diagonal in the original row ordering. Empty if the
+   * matrix is not square or has zeros on the diagonal.
+   */
+  AlignedVector<Number> inverse_diagonal;
+};
+
+/*@}*/
+
+
+#ifndef DOXYGEN
+
+/*----------------------- Inline functions ----------------------------------*/
+
+
+template <typename Number>
+inline
+SparseMatrixSELL<Number>::SparseMatrixSELL ()
+  :
+  n_rows (0),
+  n_cols (0),
+  n_nonzeros (0),
+  rows_are_permuted (false)
+{}
+
+
+
+template <typename Number>
+template <typename Number2>
+inline
+SparseMatrixSELL<Number>::SparseMatrixSELL (const SparseMatrix<Number2> &matrix,
+                                            const unsigned int           sigma)
+  :
+  SparseMatrixSELL ()
+{
+  reinit (matrix, sigma);
+}
+
+
+
+template <typename Number>
+template <typename Number2>
+void
+SparseMatrixSELL<Number>::reinit (const SparseMatrix<Number2> &matrix,
+                                  const unsigned int           sigma)
+{
+  Assert (sigma > 0, ExcMessage("The sorting window sigma must be positive."));
+  AssertThrow (matrix.n() <= std::numeric_limits<unsigned int>::max(),
+               ExcTooManyColumns());
+
+  const SparsityPattern &sparsity = matrix.get_sparsity_pattern();
+
+  n_rows = matrix.m();
+  n_cols = matrix.n();
+  n_nonzeros = matrix.n_nonzero_elements();
+  const size_type n_chunks = (n_rows + chunk_size - 1) / chunk_size;
+
+  // order the rows by their length within windows of sigma rows (rounded up
+  // to full chunks) to reduce the amount of padding
+  std::vector<unsigned int> row_order (n_chunks * chunk_size,
+                                       numbers::invalid_unsigned_int);
+  std::iota (row_order.begin(), row_order.begin() + n_rows, 0U);
+  rows_are_permuted = false;
+  if (sigma > 1)
+    {
+      const size_type window = (sigma + chunk_size - 1) / chunk_size * chunk_size;
+      for (size_type start = 0; start < n_rows; start += window)
+        std::stable_sort (row_order.begin() + start,
+                          row_order.begin() + std::min(start+window, n_rows),
+                          [&sparsity] (const unsigned int a,
+                                       const unsigned int b)
+        {
+          return sparsity.row_length(a) > sparsity.row_length(b);
+        });
+      for (size_type i=0; i<n_rows; ++i)
+        if (row_order[i] != i)
+          {
+            rows_are_permuted = true;
+            break;
+          }
+    }
+  if (rows_are_permuted || n_rows % chunk_size != 0)
+    row_indices.swap (row_order);
+  else
+    row_indices.clear ();
+
+  // compute the width of each chunk as the length of its longest row
+  chunk_starts.resize (n_chunks + 1);
+  chunk_starts[0] = 0;
+  for (size_type c=0; c<n_chunks; ++c)
+    {
+      unsigned int width = 0;
+      for (unsigned int v=0; v<chunk_size; ++v)
+        {
+          const size_type row = row_indices.empty() ? c*chunk_size+v :
+                                row_indices[c*chunk_size+v];
+          if (row < n_rows)
+            width = std::max (width, sparsity.row_length(row));
+        }
+      chunk_starts[c+1] = chunk_starts[c] + width;
+    }
+
+  values.resize_fast (chunk_starts.back());
+  column_indices.resize_fast (chunk_starts.back() * chunk_size);
+  for (std::size_t i=0; i<values.size(); ++i)
+    values[i] = Number();
+  for (std::size_t i=0; i<column_indices.size(); ++i)
+    column_indices[i] = 0;
+
+  for (size_type c=0; c<n_chunks; ++c)
+    for (unsigned int v=0; v<chunk_size; ++v)
+      {
+        const size_type row = row_indices.empty() ? c*chunk_size+v :
+                              row_indices[c*chunk_size+v];
+        if (row >= n_rows)
+          continue;
+        std::size_t j = chunk_starts[c];
+        for (typename SparseMatrix<Number2>::const_iterator
+             entry = matrix.begin(row); entry != matrix.end(row); ++entry, ++j)
+          {
+            values[j][v] = entry->value();
+            column_indices[j*chunk_size+v] = entry->column();
+          }
+      }
+
+  // finally store the inverse diagonal for square matrices without zeros on
+  // the diagonal, otherwise leave the field empty
+  inverse_diagonal.clear ();
+  if (n_rows == n_cols && n_rows > 0)
+    {
+      inverse_diagonal.resize_fast (n_rows);
+      for (size_type i=0; i<n_rows; ++i)
+        {
+          const Number diagonal = matrix.diag_element(i);
+          if (diagonal == Number())
+            {
+              inverse_diagonal.clear();
+              break;
+            }
+          inverse_diagonal[i] = Number(1.)/diagonal;
+        }
+    }
+}
+
+
+
+template <typename Number>
+inline
+void
+SparseMatrixSELL<Number>::clear ()
+{
+  n_rows = 0;
+  n_cols = 0;
+  n_nonzeros = 0;
+  rows_are_permuted = false;
+  row_indices.clear ();
+  chunk_starts.clear ();
+  values.clear ();
+  column_indices.clear ();
+  inverse_diagonal.clear ();
+}
+
+
+
+template <typename Number>
+inline
+typename SparseMatrixSELL<Number>::size_type
+SparseMatrixSELL<Number>::m () const
+{
+  return n_rows;
+}
+
+
+
+template <typename Number>
+inline
+typename SparseMatrixSELL<Number>::size_type
+SparseMatrixSELL<Number>::n () const
+{
+  return n_cols;
+}
+
+
+
+template <typename Number>
+inline
+std::size_t
+SparseMatrixSELL<Number>::n_nonzero_elements () const
+{
+  return n_nonzeros;
+}
+
+
+
+template <typename Number>
+inline
+std::size_t
+SparseMatrixSELL<Number>::n_stored_elements () const
+{
+  return values.size() * chunk_size;
+}
+
+
+
+template <typename Number>
+void
+SparseMatrixSELL<Number>::vmult_on_subrange (const size_type  begin,
+                                             const size_type  end,
+                                             const Number    *src,
+                                             Number          *dst,
+                                             const bool       add) const
+{
+  for (size_type c=begin; c<end; ++c)
+    {
+      VectorizedArray<Number> sum;
+      sum = Number();
+      const VectorizedArray<Number> *val_ptr = values.begin() + chunk_starts[c];
+      const VectorizedArray<Number> *const val_end = values.begin() + chunk_starts[c+1];
+      const unsigned int *col_ptr = column_indices.begin() + chunk_starts[c]*chunk_size;
+      for ( ; val_ptr != val_end; ++val_ptr, col_ptr += chunk_size)
+        {
+          VectorizedArray<Number> src_values;
+          src_values.gather (src, col_ptr);
+          sum += *val_ptr * src_values;
+        }
+
+      // for rows in the original order, write the full chunk at once,
+      // otherwise go through the row indices
+      if (row_indices.empty() ||
+          (!rows_are_permuted && (c+1)*chunk_size <= n_rows))
+        {
+          if (add)
+            {
+              VectorizedArray<Number> old_values;
+              old_values.load (dst + c*chunk_size);
+              sum += old_values;
+            }
+          sum.store (dst + c*chunk_size);
+        }
+      else
+        for (unsigned int v=0; v<chunk_size; ++v)
+          {
+            const unsigned int row = row_indices[c*chunk_size+v];
+            if (row != numbers::invalid_unsigned_int)
+              dst[row] = add ? dst[row] + sum[v] : sum[v];
+          }
+    }
+}
+
+
+
+template <typename Number>
+template <class VectorType>
+void
+SparseMatrixSELL<Number>::vmult (VectorType       &dst,
+                                 const VectorType &src) const
+{
+  static_assert (std::is_same<typename VectorType::value_type, Number>::value,
+                 "The vector type must have the same value type as the matrix.");
+  AssertDimension (dst.size(), m());
+  AssertDimension (src.size(), n());
+  Assert (&src != &dst, ExcSourceEqualsDestination());
+
+  const size_type n_chunks = chunk_starts.empty() ? 0 : chunk_starts.size()-1;
+  parallel::apply_to_subranges (size_type(0), n_chunks,
+                                std::bind (&SparseMatrixSELL<Number>::vmult_on_subrange,
+                                           this,
+                                           std::placeholders::_1, std::placeholders::_2,
+                                           src.begin(), dst.begin(), false),
+                                internal::SparseMatrix::minimum_parallel_grain_size/chunk_size+1);
+}
+
+
+
+template <typename Number>
+template <class VectorType>
+void
+SparseMatrixSELL<Number>::vmult_add (VectorType       &dst,
+                                     const VectorType &src) const
+{
+  static_assert (std::is_same<typename VectorType::value_type, Number>::value,
+                 "The vector type must have the same value type as the matrix.");
+  AssertDimension (dst.size(), m());
+  AssertDimension (src.size(), n());
+  Assert (&src != &dst, ExcSourceEqualsDestination());
+
+  const size_type n_chunks = chunk_starts.empty() ? 0 : chunk_starts.size()-1;
+  parallel::apply_to_subranges (size_type(0), n_chunks,
+                                std::bind (&SparseMatrixSELL<Number>::vmult_on_subrange,
+                                           this,
+                                           std::placeholders::_1, std::placeholders::_2,
+                                           src.begin(), dst.begin(), true),
+                                internal::SparseMatrix::minimum_parallel_grain_size/chunk_size+1);
+}
+
+
+
+template <typename Number>
+template <class VectorType>
+void
+SparseMatrixSELL<Number>::Tvmult (VectorType       &dst,
+                                  const VectorType &src) const
+{
+  dst = Number();
+  Tvmult_add (dst, src);
+}
+
+
+
+template <typename Number>
+template <class VectorType>
+void
+SparseMatrixSELL<Number>::Tvmult_add (VectorType       &dst,
+                                      const VectorType &src) const
+{
+  static_assert (std::is_same<typename VectorType::value_type, Number>::value,
+                 "The vector type must have the same value type as the matrix.");
+  AssertDimension (dst.size(), n());
+  AssertDimension (src.size(), m());
+  Assert (&src != &dst, ExcSourceEqualsDestination());
+
+  const Number *src_ptr = src.begin();
+  Number *dst_ptr = dst.begin();
+  for (size_type c=0; c+1<chunk_starts.size(); ++c)
+    {
+      // load the source entries of all rows in the chunk, using zero for
+      // padding rows such that their (zero) entries are ignored
+      Number src_values[chunk_size];
+      for (unsigned int v=0; v<chunk_size; ++v)
+        {
+          const unsigned int row = row_indices.empty() ? c*chunk_size+v :
+                                   row_indices[c*chunk_size+v];
+          src_values[v] = row < n_rows ? src_ptr[row] : Number();
+        }
+      for (std::size_t j=chunk_starts[c]; j<chunk_starts[c+1]; ++j)
+        for (unsigned int v=0; v<chunk_size; ++v)
+          dst_ptr[column_indices[j*chunk_size+v]] += values[j][v] * src_values[v];
+    }
+}
+
+
+
+template <typename Number>
+void
+SparseMatrixSELL<Number>::jacobi_on_subrange (const size_type  begin,
+                                              const size_type  end,
+                                              const Number    *src,
+                                              Number          *dst,
+                                              const Number     omega) const
+{
+  // the inverse diagonal is in the original row ordering, so we can run
+  // through contiguous chunks of rows with vectorized loads and stores
+  const size_type vectorized_end = begin + (end-begin)/chunk_size*chunk_size;
+  size_type i = begin;
+  for ( ; i<vectorized_end; i+=chunk_size)
+    {
+      VectorizedArray<Number> s, d;
+      s.load (src + i);
+      d.load (inverse_diagonal.begin() + i);
+      d *= s;
+      if (omega != Number(1.))
+        d *= make_vectorized_array (omega);
+      d.store (dst + i);
+    }
+  for ( ; i<end; ++i)
+    dst[i] = omega * src[i] * inverse_diagonal[i];
+}
+
+
+
+template <typename Number>
+template <class VectorType>
+void
+SparseMatrixSELL<Number>::precondition_Jacobi (VectorType       &dst,
+                                               const VectorType &src,
+                                               const Number      omega) const
+{
+  static_assert (std::is_same<typename VectorType::value_type, Number>::value,
+                 "The vector type must have the same value type as the matrix.");
+  Assert (inverse_diagonal.size() == m(), ExcNoInverseDiagonal());
+  AssertDimension (dst.size(), m());
+  AssertDimension (src.size(), m());
+
+  parallel::apply_to_subranges (size_type(0), m(),
+                                std::bind (&SparseMatrixSELL<Number>::jacobi_on_subrange,
+                                           this,
+                                           std::placeholders::_1, std::placeholders::_2,
+                                           src.begin(), dst.begin(), omega),
+                                internal::Vector::minimum_parallel_grain_size);
+}
+
+
+
+template <typename Number>
+inline
+std::size_t
+SparseMatrixSELL<Number>::memory_consumption () const
+{
+  return (sizeof(*this) +
+          MemoryConsumption::memory_consumption (row_indices) +
+          MemoryConsumption::memory_consumption (chunk_starts) +
+          values.memory_consumption () +
+          column_indices.memory_consumption () +
+          inverse_diagonal.memory_consumption ());
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -72,6 +72,7 @@ void SparseMIC<number>::initialize (const SparseMatrix<somenumber> &matrix,
   SparseLUDecomposition<number>::initialize(matrix, data);
   this->strengthen_diagonal = data.strengthen_diagonal;
   this->prebuild_lower_bound ();
+  this->prebuild_levels ();
   this->copy_from (matrix);
 
   Assert (this->m()==this->n(),   ExcNotQuadratic ());
@@ -97,24 +98,34 @@ void SparseMIC<number>::initialize (const SparseMatrix<somenumber> &matrix,
   for (size_type row=0; row<this->m(); row++)
     inner_sums[row] = get_rowsum(row);
 
-  for (size_type row=0; row<this->m(); row++)
-    {
-      const number temp = this->begin(row)->value();
-      number temp1 = 0;
-
-      // work on the lower left part of the matrix. we know
-      // it's symmetric, so we can work with this alone
-      for (typename SparseMatrix<somenumber>::const_iterator
-           p = matrix.begin(row)+1;
-           (p != matrix.end(row)) && (p->column() < row);
-           ++p)
-        temp1 += p->value() / diag[p->column()] * inner_sums[p->column()];
-
-      Assert(temp-temp1 > 0, ExcStrengthenDiagonalTooSmall());
-      diag[row] = temp - temp1;
-
-      inv_diag[row] = 1.0/diag[row];
-    }
+  const auto factorize_row = [&] (const size_type row)
+  {
+    const number temp = this->begin(row)->value();
+    number temp1 = 0;
+
+    // work on the lower left part of the matrix. we know
+    // it's symmetric, so we can work with this alone
+    for (typename SparseMatrix<somenumber>::const_iterator
+         p = matrix.begin(row)+1;
+         (p != matrix.end(row)) && (p->column() < row);
+         ++p)
+      temp1 += p->value() / diag[p->column()] * inner_sums[p->column()];
+
+    Assert(temp-temp1 > 0, ExcStrengthenDiagonalTooSmall());
+    diag[row] = temp - temp1;
+
+    inv_diag[row] = 1.0/diag[row];
+  };
+
+  // the sparsity pattern of this object contains the one of the matrix, so
+  // the levels of the lower triangle describe the dependencies between the
+  // rows of the computation above
+  if (this->use_level_scheduling())
+    this->apply_by_levels (this->lower_level_starts, this->lower_level_rows,
+                           factorize_row);
+  else
+    for (size_type row=0; row<this->m(); row++)
+      factorize_row (row);
 }
 
 
@@ -152,37 +163,58 @@ SparseMIC<number>::vmult (Vector<somenumber>       &dst,
   //
   // Solve (X-L)X{-1}(X-U) x = b in 3 steps:
   dst = src;
-  for (size_type row=0; row<N; ++row)
-    {
-      // Now: (X-L)u = b
-
-      // get start of this row. skip
-      // the diagonal element
-      for (typename SparseMatrix<number>::const_iterator
-           p = this->begin(row)+1;
-           (p != this->end(row)) && (p->column() < row);
-           ++p)
-        dst(row) -= p->value() * dst(p->column());
+  const auto forward_row = [&] (const size_type row)
+  {
+    // Now: (X-L)u = b
 
-      dst(row) *= inv_diag[row];
-    }
+    // get start of this row. skip
+    // the diagonal element
+    for (typename SparseMatrix<number>::const_iterator
+         p = this->begin(row)+1;
+         (p != this->end(row)) && (p->column() < row);
+         ++p)
+      dst(row) -= p->value() * dst(p->column());
 
-  // Now: v = Xu
-  for (size_type row=0; row<N; row++)
-    dst(row) *= diag[row];
+    dst(row) *= inv_diag[row];
+  };
 
   // x = (X-U)v
-  for (int row=N-1; row>=0; --row)
+  const auto backward_row = [&] (const size_type row)
+  {
+    // get end of this row
+    for (typename SparseMatrix<number>::const_iterator
+         p = this->begin(row)+1;
+         p != this->end(row);
+         ++p)
+      if (p->column() > row)
+        dst(row) -= p->value() * dst(p->column());
+
+    dst(row) *= inv_diag[row];
+  };
+
+  if (this->use_level_scheduling())
+    {
+      this->apply_by_levels (this->lower_level_starts, this->lower_level_rows,
+                             forward_row);
+
+      // Now: v = Xu
+      for (size_type row=0; row<N; row++)
+        dst(row) *= diag[row];
+
+      this->apply_by_levels (this->upper_level_starts, this->upper_level_rows,
+                             backward_row);
+    }
+  else
     {
-      // get end of this row
-      for (typename SparseMatrix<number>::const_iterator
-           p = this->begin(row)+1;
-           p != this->end(row);
-           ++p)
-        if (p->column() > static_cast<size_type>(row))
-          dst(row) -= p->value() * dst(p->column());
-
-      dst(row) *= inv_diag[row];
+      for (size_type row=0; row<N; ++row)
+        forward_row (row);
+
+      // Now: v = Xu
+      for (size_type row=0; row<N; row++)
+        dst(row) *= diag[row];
+
+      for (size_type row=N; row>0; --row)
+        backward_row (row-1);
     }
 }
 
@@ -924,6 +924,15 @@ public:
    */
   void block_read (std::istream &in);
 
+  /**
+   * Read data that has been written by block_write() to the file
+   * @p filename. In contrast to block_read(), the file is mapped into memory
+   * (see Utilities::System::MemoryMappedFile) and the arrays are copied from
+   * there without the copy through a stream buffer. The same checks as in
+   * block_read() are performed.
+   */
+  void block_read_mapped (const std::string &filename);
+
   /**
    * Print the sparsity of the matrix. The output consists of one line per row
    * of the format <tt>[i,j1,j2,j3,...]</tt>. <i>i</i> is the row number and
@@ -81,6 +81,19 @@ namespace SparsityTools
                   const unsigned int         n_partitions,
                   std::vector<unsigned int> &partition_indices);
 
+  /**
+   * This function does the same as the previous one, but weighs each node
+   * of the graph with the corresponding entry of @p node_weights, so that
+   * METIS balances the sum of the weights of the nodes in each partition
+   * rather than their number. The vector @p node_weights needs to be either
+   * empty, which is equivalent to all nodes having the same weight, or have
+   * one positive entry per row of the sparsity pattern.
+   */
+  void partition (const SparsityPattern           &sparsity_pattern,
+                  const std::vector<unsigned int> &node_weights,
+                  const unsigned int               n_partitions,
+                  std::vector<unsigned int>       &partition_indices);
+
   /**
    * For a given sparsity pattern, compute a re-enumeration of row/column
    * indices based on the algorithm by Cuthill-McKee.
@@ -160,6 +173,28 @@ namespace SparsityTools
   reorder_hierarchical (const DynamicSparsityPattern                   &sparsity,
                         std::vector<DynamicSparsityPattern::size_type> &new_indices);
 
+  /**
+   * Compute a coloring of the rows of the given sparsity pattern such that
+   * two rows of the same color do not couple, i.e., that row $i$ has no
+   * entry in column $j$ for any other row $j$ of the same color. The rows of
+   * one color can therefore be updated concurrently in Gauss-Seidel-like
+   * algorithms such as the multicolored variants of SparseMatrix::SOR_step()
+   * and SparseMatrix::precondition_SSOR().
+   *
+   * The coloring is computed by GraphColoring::make_graph_coloring() where the
+   * conflict indices of a row are its column indices. Since each row also
+   * contains its diagonal entry, this also detects couplings that are only
+   * present in one of the two rows in case of non-symmetric sparsity
+   * patterns. Note that this results in a distance-2 coloring, i.e., two
+   * rows also get different colors if they couple to a common third row.
+   *
+   * On output, <tt>colors[c]</tt> contains the rows of color @p c in
+   * ascending order.
+   */
+  void
+  color_sparsity_pattern (const SparsityPattern                                  &sparsity_pattern,
+                          std::vector<std::vector<SparsityPattern::size_type> > &colors);
+
 #ifdef DEAL_II_WITH_MPI
   /**
    * Communicate rows in a dynamic sparsity pattern over MPI.
@@ -19,6 +19,7 @@
 
 #include <deal.II/base/config.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/utilities.h>
 #include <deal.II/lac/vector.h>
 #include <string>
 
@@ -44,6 +45,37 @@ DEAL_II_NAMESPACE_OPEN
  * reload is called. If it is not available, @p reload waits until the
  * detached thread has loaded the data.
  *
+ * In the same way, @p swap_out can write the data in the background and
+ * return immediately, and it can compress the data before writing it. This
+ * allows to keep a long sequence of vectors, for example the forward states
+ * needed in the backward sweep of an adjoint time stepping scheme, on disk
+ * while overlapping the input and output with the computations. If the
+ * order in which the vectors are needed is known, calling @p alert on the
+ * vectors of the next few steps ahead keeps several of them being read at
+ * the same time:
+ * @code
+ *   std::vector<SwappableVector<double> > states (n_time_steps);
+ *   for (unsigned int n=0; n<n_time_steps; ++n)
+ *     {
+ *       ... // compute states[n]
+ *       states[n].swap_out ("state-" + Utilities::int_to_string(n),
+ *                           true);
+ *     }
+ *
+ *   const unsigned int n_prefetch = 2;
+ *   for (unsigned int i=0; i<n_prefetch && i<n_time_steps; ++i)
+ *     states[n_time_steps-1-i].alert ();
+ *   for (unsigned int n=n_time_steps; n>0; --n)
+ *     {
+ *       if (n > n_prefetch)
+ *         states[n-1-n_prefetch].alert ();
+ *       states[n-1].reload ();
+ *       ... // use states[n-1] in the adjoint step
+ *       states[n-1].kill_file ();
+ *       states[n-1].reinit (0);
+ *     }
+ * @endcode
+ *
  * @note Instantiations for this template are provided for <tt>@<float@> and
  * @<double@></tt>; others can be generated in application programs (see the
  * section on
@@ -94,8 +126,20 @@ public:
    *
    * If this object owns another file, for example when @p swap_out but no @p
    * kill_file has previously been called, then that is deleted first.
+   *
+   * If @p write_in_background is true, the data is written by a task in the
+   * background and the function returns immediately. The vector must then
+   * not be accessed until @p reload or @p alert has been called, which wait
+   * for the data to be written; @p kill_file and the destructor wait as well.
+   *
+   * The data is compressed as given by @p compression before it is written,
+   * see Utilities::pack(). Compression is only applied if the library was
+   * configured with ZLIB, and trades the time to compress for the time to
+   * write, which pays off for slow or shared file systems.
    */
-  void swap_out (const std::string &filename);
+  void swap_out (const std::string           &filename,
+                 const bool                   write_in_background = false,
+                 const Utilities::Compression compression = Utilities::no_compression);
 
   /**
    * Reload the data of this vector from the file to which it has been stored
@@ -127,6 +171,13 @@ public:
   void alert ();
 
 
+  /**
+   * Wait until the data written in the background by @p swap_out has been
+   * stored in the file. If no data is written in the background, this
+   * function does nothing.
+   */
+  void wait_for_swap_out ();
+
   /**
    * Remove the file to which the data has been stored the last time. After
    * this, the object does not own any file any more, so of course you can't
@@ -202,6 +253,26 @@ private:
    */
   bool data_is_preloaded;
 
+  /**
+   * The compression given to the last call to @p swap_out, which is needed
+   * to read the data back.
+   */
+  Utilities::Compression compression;
+
+  /**
+   * The task that writes the data in the background if @p swap_out was
+   * called with <tt>write_in_background=true</tt>. The object is not
+   * joinable if no such write is pending.
+   */
+  Threads::Task<> write_task;
+
+  /**
+   * Internal function that actually writes the vector to the file and then
+   * resets the size of the vector to zero. Called from @p swap_out, possibly
+   * as a task in the background.
+   */
+  void write_vector ();
+
   /**
    * Internal function that actually reloads the vector. Called from @p reload
    * and @p alert.
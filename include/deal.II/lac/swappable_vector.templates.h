@@ -27,7 +27,8 @@ DEAL_II_NAMESPACE_OPEN
 template <typename number>
 SwappableVector<number>::SwappableVector ()
   :
-  data_is_preloaded (false)
+  data_is_preloaded (false),
+  compression (Utilities::no_compression)
 {}
 
 
@@ -36,7 +37,8 @@ template <typename number>
 SwappableVector<number>::SwappableVector (const SwappableVector<number> &v) :
   Vector<number>(v),
   filename (),
-  data_is_preloaded (false)
+  data_is_preloaded (false),
+  compression (Utilities::no_compression)
 {
   Assert (v.filename == "", ExcInvalidCopyOperation());
 }
@@ -55,6 +57,8 @@ SwappableVector<number>::~SwappableVector ()
 
   if (filename != "")
     kill_file ();
+  else
+    wait_for_swap_out ();
 }
 
 
@@ -66,6 +70,8 @@ SwappableVector<number>::operator= (const SwappableVector<number> &v)
   // if necessary, first delete data
   if (filename != "")
     kill_file ();
+  else
+    wait_for_swap_out ();
 
   // if in MT mode, block all other
   // operations. if not in MT mode,
@@ -81,7 +87,9 @@ SwappableVector<number>::operator= (const SwappableVector<number> &v)
 
 
 template <typename number>
-void SwappableVector<number>::swap_out (const std::string &name)
+void SwappableVector<number>::swap_out (const std::string           &name,
+                                        const bool                   write_in_background,
+                                        const Utilities::Compression compression)
 {
   // if the vector was stored in
   // another file previously, and
@@ -92,31 +100,76 @@ void SwappableVector<number>::swap_out (const std::string &name)
     kill_file ();
 
   filename = name;
+  this->compression = compression;
 
   Assert (this->size() != 0, ExcSizeZero());
 
-  // if in MT mode, block all other
-  // operations. if not in MT mode,
-  // this is a no-op
-  Threads::Mutex::ScopedLock lock(this->lock);
-
   //  check that we have not called
   //  @p alert without the respective
   //  @p reload function
   Assert (data_is_preloaded == false, ExcInternalError());
 
-  std::ofstream tmp_out(filename.c_str());
-  this->block_write (tmp_out);
+  if (write_in_background)
+    write_task = Threads::new_task (&SwappableVector<number>::write_vector,
+                                    *this);
+  else
+    write_vector ();
+}
+
+
+
+template <typename number>
+void SwappableVector<number>::write_vector ()
+{
+  // if in MT mode, block all other
+  // operations. if not in MT mode,
+  // this is a no-op
+  Threads::Mutex::ScopedLock lock(this->lock);
+
+  std::ofstream tmp_out(filename.c_str(), std::ios::binary);
+  if (compression == Utilities::no_compression)
+    this->block_write (tmp_out);
+  else
+    {
+      // store the size of the compressed
+      // data in front of it, so that
+      // reload_vector knows how much to
+      // read
+      const std::vector<char> buffer
+        = Utilities::pack (static_cast<const Vector<number> &>(*this),
+                           compression);
+      const std::size_t buffer_size = buffer.size();
+      tmp_out.write (reinterpret_cast<const char *>(&buffer_size),
+                     sizeof(buffer_size));
+      tmp_out.write (buffer.data(), buffer_size);
+    }
   tmp_out.close ();
+  AssertThrow (tmp_out, ExcIO());
 
   this->reinit (0);
 }
 
 
 
+template <typename number>
+void SwappableVector<number>::wait_for_swap_out ()
+{
+  if (write_task.joinable())
+    {
+      write_task.join ();
+      write_task = Threads::Task<>();
+    }
+}
+
+
+
 template <typename number>
 void SwappableVector<number>::reload ()
 {
+  // the data may still be written
+  // in the background
+  wait_for_swap_out ();
+
   // if in MT mode: synchronize with
   // possibly existing @p alert
   // calls. if not in MT mode, this
@@ -155,6 +208,12 @@ void SwappableVector<number>::alert ()
   return;
 #else
 
+  // the data may still be written
+  // in the background, in which
+  // case it can only be read after
+  // that has finished
+  wait_for_swap_out ();
+
   // synchronize with possible other
   // invocations of this function and
   // other functions in this class
@@ -188,8 +247,21 @@ void SwappableVector<number>::reload_vector (const bool set_flag)
   Assert (filename != "", ExcInvalidFilename (filename));
   Assert (this->size() == 0, ExcSizeNonzero());
 
-  std::ifstream tmp_in(filename.c_str());
-  this->block_read (tmp_in);
+  std::ifstream tmp_in(filename.c_str(), std::ios::binary);
+  if (compression == Utilities::no_compression)
+    this->block_read (tmp_in);
+  else
+    {
+      std::size_t buffer_size = 0;
+      tmp_in.read (reinterpret_cast<char *>(&buffer_size),
+                   sizeof(buffer_size));
+      std::vector<char> buffer (buffer_size);
+      tmp_in.read (buffer.data(), buffer_size);
+      AssertThrow (tmp_in, ExcIO());
+
+      Vector<number>::operator = (Utilities::unpack<Vector<number> > (buffer,
+                                  compression));
+    }
   tmp_in.close ();
 
 #ifdef DEAL_II_WITH_THREADS
@@ -207,6 +279,10 @@ void SwappableVector<number>::reload_vector (const bool set_flag)
 template <typename number>
 void SwappableVector<number>::kill_file ()
 {
+  // the file can only be removed
+  // once it has been written
+  wait_for_swap_out ();
+
   // if in MT mode, wait for other
   // operations to finish first
   // (there should be none, but who
@@ -248,6 +324,8 @@ SwappableVector<number>::memory_consumption () const
   return (MemoryConsumption::memory_consumption (filename) +
           sizeof(lock) +
           MemoryConsumption::memory_consumption (data_is_preloaded) +
+          sizeof(compression) +
+          sizeof(write_task) +
           Vector<number>::memory_consumption ());
 }
 
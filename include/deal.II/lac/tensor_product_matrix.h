@@ -23,6 +23,10 @@
 #include <deal.II/lac/lapack_full_matrix.h>
 #include <deal.II/matrix_free/tensor_product_kernels.h>
 
+#include <algorithm>
+#include <cstring>
+#include <map>
+
 DEAL_II_NAMESPACE_OPEN
 
 template <typename> class Vector;
@@ -361,6 +365,177 @@ private:
 };
 
 
+
+/**
+ * A collection of tensor product matrices of the type
+ * TensorProductMatrixSymmetricSum for many cells (or batches of cells when
+ * @p Number is a VectorizedArray), as needed by a block-Jacobi or additive
+ * Schwarz smoother based on the fast diagonalization method. As opposed to a
+ * vector of TensorProductMatrixSymmetricSum objects, this class stores the 1D
+ * eigenvalues and eigenvectors of all cells in a single AlignedVector and it
+ * does not contain any temporary arrays: the functions applying the inverse
+ * take the scratch array from the caller. As a consequence, several threads
+ * can use the same object concurrently without synchronization, each with
+ * its own scratch array.
+ *
+ * If AdditionalData::compress_matrices is set, cells whose 1D mass and
+ * derivative matrices are bitwise identical share one entry in the storage.
+ * This is the typical case on Cartesian meshes or meshes with few different
+ * cell sizes, where the memory consumption and the memory traffic of the
+ * smoother then reduce to those of a few cells.
+ *
+ * The collection is set up by calling reinit() with the number of cells
+ * (cell batches), followed by insert() for each of them and a final call to
+ * finalize(). The setup functions must not be called concurrently.
+ *
+ * @tparam dim Dimension of the problem. Currently, 1D, 2D, and 3D codes are
+ * implemented.
+ *
+ * @tparam Number Arithmetic type of the underlying array elements, either
+ * float and double, or VectorizedArray<float> and VectorizedArray<double>.
+ *
+ * @tparam size Compile-time array lengths. By default at -1, which means that
+ * the run-time info stored in the matrices passed to the insert() function
+ * is used. All matrices of the collection must be of the same size.
+ */
+template <int dim, typename Number, int size = -1>
+class TensorProductMatrixSymmetricSumCollection
+{
+public:
+  /**
+   * Collection of options for the setup of the collection.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor.
+     */
+    AdditionalData (const bool compress_matrices = true);
+
+    /**
+     * Store only one entry for cells with identical 1D matrices.
+     */
+    bool compress_matrices;
+  };
+
+  /**
+   * Constructor.
+   */
+  TensorProductMatrixSymmetricSumCollection (const AdditionalData &additional_data = AdditionalData());
+
+  /**
+   * Clear all previous content and prepare the collection for
+   * @p n_entries_in cells (cell batches) that are subsequently set by insert().
+   */
+  void reinit (const unsigned int n_entries_in);
+
+  /**
+   * Set the matrix of the cell (cell batch) @p index to the tensor
+   * product matrix defined by the 1D mass matrices @p mass_matrix and 1D
+   * derivative matrices @p derivative_matrix, computing its generalized
+   * eigenvalues and eigenvectors unless an identical entry exists already.
+   * The requirements on the matrices are the same as in
+   * TensorProductMatrixSymmetricSum::reinit().
+   */
+  void insert (const unsigned int                     index,
+               const std::array<Table<2,Number>,dim> &mass_matrix,
+               const std::array<Table<2,Number>,dim> &derivative_matrix);
+
+  /**
+   * Same as above, but use the same 1D mass matrix @p mass_matrix and the
+   * same 1D derivative matrix @p derivative_matrix for each tensor
+   * direction.
+   */
+  void insert (const unsigned int     index,
+               const Table<2,Number> &mass_matrix,
+               const Table<2,Number> &derivative_matrix);
+
+  /**
+   * Release the data structures only needed during the setup. Must be
+   * called after all entries have been inserted and before apply_inverse()
+   * is used.
+   */
+  void finalize ();
+
+  /**
+   * Apply the inverse of the tensor product matrix of the cell (cell batch)
+   * @p index to @p src and write the result into @p dst, as in
+   * TensorProductMatrixSymmetricSumBase::apply_inverse(). The array
+   * @p scratch is resized as necessary and used for intermediate results.
+   */
+  void apply_inverse (const unsigned int             index,
+                      const ArrayView<Number>       &dst,
+                      const ArrayView<const Number> &src,
+                      AlignedVector<Number>         &scratch) const;
+
+  /**
+   * Return the number of cells (cell batches) in the collection.
+   */
+  unsigned int n_entries () const;
+
+  /**
+   * Return the number of distinct matrices actually stored.
+   */
+  unsigned int n_stored_matrices () const;
+
+  /**
+   * Return the number of rows of each 1D matrix.
+   */
+  unsigned int n_rows_1d () const;
+
+  /**
+   * Return an estimate of the memory consumption of this object in bytes.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * Comparator for the keys identifying the 1D matrices of a cell during
+   * the compression. Since identical cells are supposed to produce exactly
+   * the same matrix entries, we simply compare the bit patterns, which works
+   * for vectorized and non-vectorized types alike.
+   */
+  struct MatrixComparator
+  {
+    bool operator() (const std::vector<Number> &a,
+                     const std::vector<Number> &b) const;
+  };
+
+  /**
+   * The options of the collection.
+   */
+  AdditionalData additional_data;
+
+  /**
+   * The number of rows of the 1D matrices.
+   */
+  unsigned int n_1d;
+
+  /**
+   * For each cell (cell batch), the index of its entry in the storage.
+   */
+  std::vector<unsigned int> storage_index;
+
+  /**
+   * The eigenvectors and eigenvalues of all stored matrices. Each entry
+   * consists of the eigenvectors of size n_1d x n_1d for all directions,
+   * followed by the eigenvalues for all directions.
+   */
+  AlignedVector<Number> data;
+
+  /**
+   * The number of stored matrices.
+   */
+  unsigned int n_stored;
+
+  /**
+   * During the setup, the map from the 1D matrices to the storage index for
+   * the compression.
+   */
+  std::map<std::vector<Number>,unsigned int,MatrixComparator> unique_matrices;
+};
+
+
 /*----------------------- Inline functions ----------------------------------*/
 
 #ifndef DOXYGEN
@@ -412,6 +587,132 @@ namespace internal
       for (unsigned int i=0; i<n_rows; ++i, ++eigenvalues)
         *eigenvalues = deriv_copy.eigenvalue(i).real();
     }
+
+
+
+    /**
+     * Compute the generalized eigenvalues and eigenvectors of the 1D
+     * matrices @p mass_matrix and @p derivative_matrix as in
+     * spectral_assembly(). The eigenvectors are written column-wise into a
+     * row-major array of size n_rows*n_rows at @p eigenvectors.
+     */
+    template <typename Number>
+    void
+    spectral_assembly (const dealii::Table<2,Number> &mass_matrix,
+                       const dealii::Table<2,Number> &derivative_matrix,
+                       Number                *eigenvalues,
+                       Number                *eigenvectors)
+    {
+      spectral_assembly<Number> (&mass_matrix(0,0), &derivative_matrix(0,0),
+                                 mass_matrix.n_rows(), mass_matrix.n_cols(),
+                                 eigenvalues, eigenvectors);
+    }
+
+
+
+    /**
+     * Same as above for vectorized arrays, where the eigenproblem is solved
+     * separately for each vectorization lane.
+     */
+    template <typename Number>
+    void
+    spectral_assembly (const dealii::Table<2,VectorizedArray<Number> > &mass_matrix,
+                       const dealii::Table<2,VectorizedArray<Number> > &derivative_matrix,
+                       VectorizedArray<Number>                 *eigenvalues,
+                       VectorizedArray<Number>                 *eigenvectors)
+    {
+      const unsigned int n_rows = mass_matrix.n_rows();
+      const unsigned int n_cols = mass_matrix.n_cols();
+      const unsigned int nm = n_rows * n_cols;
+      std::vector<Number> mass_lane (nm), deriv_lane (nm), eigenvalues_lane (n_rows),
+          eigenvectors_lane (nm);
+      for (unsigned int lane=0; lane<VectorizedArray<Number>::n_array_elements; ++lane)
+        {
+          for (unsigned int i=0; i<nm; ++i)
+            {
+              mass_lane[i] = (&mass_matrix(0,0))[i][lane];
+              deriv_lane[i] = (&derivative_matrix(0,0))[i][lane];
+            }
+          spectral_assembly<Number> (mass_lane.data(), deriv_lane.data(), n_rows,
+                                     n_cols, eigenvalues_lane.data(),
+                                     eigenvectors_lane.data());
+          for (unsigned int i=0; i<n_rows; ++i)
+            eigenvalues[i][lane] = eigenvalues_lane[i];
+          for (unsigned int i=0; i<nm; ++i)
+            eigenvectors[i][lane] = eigenvectors_lane[i];
+        }
+    }
+
+
+
+    /**
+     * Apply the inverse of the tensor product matrix given by the 1D
+     * eigenvectors (stored column-wise in row-major arrays of size n*n) and
+     * eigenvalues for each direction by the fast diagonalization method. The
+     * array @p tmp must provide space for n^dim entries.
+     */
+    template <int dim, int size, typename Number>
+    void
+    apply_inverse (const unsigned int                    n,
+                   const std::array<const Number *,dim> &eigenvectors,
+                   const std::array<const Number *,dim> &eigenvalues,
+                   Number                               *dst,
+                   const Number                         *src,
+                   Number                               *tmp)
+    {
+      constexpr int kernel_size = size > 0 ? size-1 : -1;
+      internal::EvaluatorTensorProduct<internal::evaluate_general,dim,kernel_size,kernel_size+1,Number>
+      eval(AlignedVector<Number>(), AlignedVector<Number>(),
+           AlignedVector<Number>(), n-1, n);
+      Number *t = tmp;
+
+      // NOTE: dof_to_quad has to be interpreted as 'dof to eigenvalue index'
+      //       --> apply<.,true,.> (S,src,dst) calculates dst = S^T * src,
+      //       --> apply<.,false,.> (S,src,dst) calculates dst = S * src,
+      //       while the eigenvectors are stored column-wise in S, i.e.
+      //       rows correspond to dofs whereas columns to eigenvalue indices!
+      if (dim == 1)
+        {
+          const Number *S = eigenvectors[0];
+          eval.template apply<0, true, false> (S, src, t);
+          for (unsigned int i=0; i<n; ++i)
+            t[i] /= eigenvalues[0][i];
+          eval.template apply<0, false, false> (S, t, dst);
+        }
+
+      else if (dim == 2)
+        {
+          const Number *S0 = eigenvectors[0];
+          const Number *S1 = eigenvectors[1];
+          eval.template apply<0, true, false> (S0, src, t);
+          eval.template apply<1, true, false> (S1, t, dst);
+          for (unsigned int i1=0, c=0; i1<n; ++i1)
+            for (unsigned int i0=0; i0<n; ++i0, ++c)
+              dst[c] /= (eigenvalues[1][i1] + eigenvalues[0][i0]);
+          eval.template apply<0, false, false> (S0, dst, t);
+          eval.template apply<1, false, false> (S1, t, dst);
+        }
+
+      else if (dim == 3)
+        {
+          const Number *S0 = eigenvectors[0];
+          const Number *S1 = eigenvectors[1];
+          const Number *S2 = eigenvectors[2];
+          eval.template apply<0, true, false> (S0, src, t);
+          eval.template apply<1, true, false> (S1, t, dst);
+          eval.template apply<2, true, false> (S2, dst, t);
+          for (unsigned int i2=0, c=0; i2<n; ++i2)
+            for (unsigned int i1=0; i1<n; ++i1)
+              for (unsigned int i0=0; i0<n; ++i0, ++c)
+                t[c] /= (eigenvalues[2][i2] + eigenvalues[1][i1] + eigenvalues[0][i0]);
+          eval.template apply<0, false, false> (S0, t, dst);
+          eval.template apply<1, false, false> (S1, dst, t);
+          eval.template apply<2, false, false> (S2, t, dst);
+        }
+
+      else
+        Assert(false, ExcNotImplemented());
+    }
   }
 }
 
@@ -515,60 +816,16 @@ TensorProductMatrixSymmetricSumBase<dim,Number,size>
   Threads::Mutex::ScopedLock lock(this->mutex);
   const unsigned int n = size > 0 ? size : eigenvalues[0].size();
   tmp_array.resize_fast (Utilities::fixed_power<dim>(n));
-  constexpr int kernel_size = size > 0 ? size-1 : -1;
-  internal::EvaluatorTensorProduct<internal::evaluate_general,dim,kernel_size,kernel_size+1,Number>
-  eval(AlignedVector<Number>(), AlignedVector<Number>(),
-       AlignedVector<Number>(), mass_matrix[0].n_rows()-1, mass_matrix[0].n_rows());
-  Number *t = tmp_array.begin();
-  const Number *src = src_view.data();
-  Number *dst = &(dst_view[0]);
-
-  // NOTE: dof_to_quad has to be interpreted as 'dof to eigenvalue index'
-  //       --> apply<.,true,.> (S,src,dst) calculates dst = S^T * src,
-  //       --> apply<.,false,.> (S,src,dst) calculates dst = S * src,
-  //       while the eigenvectors are stored column-wise in S, i.e.
-  //       rows correspond to dofs whereas columns to eigenvalue indices!
-  if (dim == 1)
-    {
-      const Number *S = &eigenvectors[0](0,0);
-      eval.template apply<0, true, false> (S, src, t);
-      for (unsigned int i=0; i<n; ++i)
-        t[i] /= eigenvalues[0][i];
-      eval.template apply<0, false, false> (S, t, dst);
-    }
-
-  else if (dim == 2)
-    {
-      const Number *S0 = &(eigenvectors[0](0,0));
-      const Number *S1 = &(eigenvectors[1](0,0));
-      eval.template apply<0, true, false> (S0, src, t);
-      eval.template apply<1, true, false> (S1, t, dst);
-      for (unsigned int i1=0, c=0; i1<n; ++i1)
-        for (unsigned int i0=0; i0<n; ++i0, ++c)
-          dst[c] /= (eigenvalues[1][i1] + eigenvalues[0][i0]);
-      eval.template apply<0, false, false> (S0, dst, t);
-      eval.template apply<1, false, false> (S1, t, dst);
-    }
 
-  else if (dim == 3)
+  std::array<const Number *,dim> eigenvector_data, eigenvalue_data;
+  for (unsigned int d=0; d<dim; ++d)
     {
-      const Number *S0 = &eigenvectors[0](0,0);
-      const Number *S1 = &eigenvectors[1](0,0);
-      const Number *S2 = &eigenvectors[2](0,0);
-      eval.template apply<0, true, false> (S0, src, t);
-      eval.template apply<1, true, false> (S1, t, dst);
-      eval.template apply<2, true, false> (S2, dst, t);
-      for (unsigned int i2=0, c=0; i2<n; ++i2)
-        for (unsigned int i1=0; i1<n; ++i1)
-          for (unsigned int i0=0; i0<n; ++i0, ++c)
-            t[c] /= (eigenvalues[2][i2] + eigenvalues[1][i1] + eigenvalues[0][i0]);
-      eval.template apply<0, false, false> (S0, t, dst);
-      eval.template apply<1, false, false> (S1, dst, t);
-      eval.template apply<2, false, false> (S2, t, dst);
+      eigenvector_data[d] = &eigenvectors[d](0,0);
+      eigenvalue_data[d] = eigenvalues[d].begin();
     }
-
-  else
-    Assert(false, ExcNotImplemented());
+  internal::TensorProductMatrix::apply_inverse<dim,size>
+  (n, eigenvector_data, eigenvalue_data, &(dst_view[0]), src_view.data(),
+   tmp_array.begin());
 }
 
 
@@ -828,6 +1085,218 @@ TensorProductMatrixSymmetricSum<dim,VectorizedArray<Number>,size>
 
 
 
+// ------------------------------   TensorProductMatrixSymmetricSumCollection   ------------------------------
+
+template <int dim, typename Number, int size>
+inline
+TensorProductMatrixSymmetricSumCollection<dim,Number,size>::AdditionalData
+::AdditionalData (const bool compress_matrices)
+  :
+  compress_matrices (compress_matrices)
+{}
+
+
+
+template <int dim, typename Number, int size>
+inline
+TensorProductMatrixSymmetricSumCollection<dim,Number,size>
+::TensorProductMatrixSymmetricSumCollection (const AdditionalData &additional_data)
+  :
+  additional_data (additional_data),
+  n_1d (size > 0 ? size : 0),
+  n_stored (0)
+{}
+
+
+
+template <int dim, typename Number, int size>
+inline
+bool
+TensorProductMatrixSymmetricSumCollection<dim,Number,size>::MatrixComparator
+::operator() (const std::vector<Number> &a,
+              const std::vector<Number> &b) const
+{
+  if (a.size() != b.size())
+    return a.size() < b.size();
+  return std::memcmp (a.data(), b.data(), a.size()*sizeof(Number)) < 0;
+}
+
+
+
+template <int dim, typename Number, int size>
+inline
+void
+TensorProductMatrixSymmetricSumCollection<dim,Number,size>
+::reinit (const unsigned int n_entries_in)
+{
+  n_1d = size > 0 ? size : 0;
+  storage_index.clear();
+  storage_index.resize (n_entries_in, numbers::invalid_unsigned_int);
+  data.clear();
+  n_stored = 0;
+  unique_matrices.clear();
+}
+
+
+
+template <int dim, typename Number, int size>
+inline
+void
+TensorProductMatrixSymmetricSumCollection<dim,Number,size>
+::insert (const unsigned int                     index,
+          const std::array<Table<2,Number>,dim> &mass_matrix,
+          const std::array<Table<2,Number>,dim> &derivative_matrix)
+{
+  AssertIndexRange (index, storage_index.size());
+  if (n_1d == 0)
+    n_1d = mass_matrix[0].n_rows();
+
+  const unsigned int nn = n_1d * n_1d;
+  for (unsigned int d=0; d<dim; ++d)
+    {
+      AssertDimension (mass_matrix[d].n_rows(), n_1d);
+      AssertDimension (mass_matrix[d].n_cols(), n_1d);
+      AssertDimension (derivative_matrix[d].n_rows(), n_1d);
+      AssertDimension (derivative_matrix[d].n_cols(), n_1d);
+    }
+
+  if (additional_data.compress_matrices)
+    {
+      std::vector<Number> key (2*dim*nn);
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          std::copy (&mass_matrix[d](0,0), &mass_matrix[d](0,0)+nn,
+                     key.begin()+2*d*nn);
+          std::copy (&derivative_matrix[d](0,0), &derivative_matrix[d](0,0)+nn,
+                     key.begin()+(2*d+1)*nn);
+        }
+      const auto it = unique_matrices.find (key);
+      if (it != unique_matrices.end())
+        {
+          storage_index[index] = it->second;
+          return;
+        }
+      unique_matrices.insert (std::make_pair (std::move(key), n_stored));
+    }
+
+  const std::size_t entry_size = dim * (nn + n_1d);
+  data.resize (data.size() + entry_size);
+  Number *entry = data.begin() + n_stored * entry_size;
+  for (unsigned int d=0; d<dim; ++d)
+    internal::TensorProductMatrix::spectral_assembly (mass_matrix[d],
+                                                      derivative_matrix[d],
+                                                      entry + dim*nn + d*n_1d,
+                                                      entry + d*nn);
+  storage_index[index] = n_stored++;
+}
+
+
+
+template <int dim, typename Number, int size>
+inline
+void
+TensorProductMatrixSymmetricSumCollection<dim,Number,size>
+::insert (const unsigned int     index,
+          const Table<2,Number> &mass_matrix,
+          const Table<2,Number> &derivative_matrix)
+{
+  std::array<Table<2,Number>,dim> mass_matrices;
+  std::array<Table<2,Number>,dim> derivative_matrices;
+
+  std::fill (mass_matrices.begin(), mass_matrices.end(), mass_matrix);
+  std::fill (derivative_matrices.begin(), derivative_matrices.end(), derivative_matrix);
+
+  insert (index, mass_matrices, derivative_matrices);
+}
+
+
+
+template <int dim, typename Number, int size>
+inline
+void
+TensorProductMatrixSymmetricSumCollection<dim,Number,size>
+::finalize ()
+{
+  Assert (std::find (storage_index.begin(), storage_index.end(),
+                     numbers::invalid_unsigned_int) == storage_index.end(),
+          ExcMessage ("Not all entries of the collection have been inserted."));
+  unique_matrices.clear();
+}
+
+
+
+template <int dim, typename Number, int size>
+inline
+void
+TensorProductMatrixSymmetricSumCollection<dim,Number,size>
+::apply_inverse (const unsigned int             index,
+                 const ArrayView<Number>       &dst_view,
+                 const ArrayView<const Number> &src_view,
+                 AlignedVector<Number>         &scratch) const
+{
+  AssertIndexRange (index, storage_index.size());
+  Assert (storage_index[index] < n_stored, ExcInternalError());
+  const unsigned int n = size > 0 ? size : n_1d;
+  const unsigned int n_dofs = Utilities::fixed_power<dim>(n);
+  AssertDimension (dst_view.size(), n_dofs);
+  AssertDimension (src_view.size(), n_dofs);
+  scratch.resize_fast (n_dofs);
+
+  const Number *entry = data.begin() + storage_index[index] * dim * (n*n + n);
+  std::array<const Number *,dim> eigenvectors, eigenvalues;
+  for (unsigned int d=0; d<dim; ++d)
+    {
+      eigenvectors[d] = entry + d*n*n;
+      eigenvalues[d] = entry + dim*n*n + d*n;
+    }
+  internal::TensorProductMatrix::apply_inverse<dim,size>
+  (n, eigenvectors, eigenvalues, &(dst_view[0]), src_view.data(),
+   scratch.begin());
+}
+
+
+
+template <int dim, typename Number, int size>
+inline
+unsigned int
+TensorProductMatrixSymmetricSumCollection<dim,Number,size>::n_entries () const
+{
+  return storage_index.size();
+}
+
+
+
+template <int dim, typename Number, int size>
+inline
+unsigned int
+TensorProductMatrixSymmetricSumCollection<dim,Number,size>::n_stored_matrices () const
+{
+  return n_stored;
+}
+
+
+
+template <int dim, typename Number, int size>
+inline
+unsigned int
+TensorProductMatrixSymmetricSumCollection<dim,Number,size>::n_rows_1d () const
+{
+  return n_1d;
+}
+
+
+
+template <int dim, typename Number, int size>
+inline
+std::size_t
+TensorProductMatrixSymmetricSumCollection<dim,Number,size>::memory_consumption () const
+{
+  return (sizeof(*this) + data.memory_consumption() +
+          storage_index.capacity()*sizeof(unsigned int));
+}
+
+
+
 #endif
 
 DEAL_II_NAMESPACE_CLOSE
@@ -48,6 +48,14 @@ DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
 
 DEAL_II_NAMESPACE_OPEN
 
+namespace LinearAlgebra
+{
+  namespace distributed
+  {
+    template <typename> class Vector;
+  }
+}
+
 
 /**
  * @addtogroup TrilinosWrappers
@@ -605,6 +613,24 @@ namespace TrilinosWrappers
       void reinit (const BlockVector &v,
                    const bool         import_data = false);
 
+      /**
+       * Reinit as a view of the locally owned elements of @p v, i.e., the
+       * Trilinos vector is created in the <code>View</code> mode of Epetra
+       * and works directly on the memory of @p v without copying it. This
+       * allows to pass a vector used by the matrix-free framework to a
+       * Trilinos solver or preconditioner, e.g., the coarse solver of a
+       * multigrid method, without copying it back and forth. Changes to the
+       * elements of either vector are visible in the other one.
+       *
+       * The ghost elements of @p v are not part of the view. The vector @p v
+       * must neither be destroyed nor reinitialized as long as the present
+       * object is used as a view into it. The reverse direction, a
+       * LinearAlgebra::distributed::Vector that works on the memory of a
+       * Trilinos vector, is not provided because the former needs to store
+       * its ghost elements contiguously after the locally owned ones.
+       */
+      void reinit_as_view (LinearAlgebra::distributed::Vector<double> &v);
+
       /**
        * Compress the underlying representation of the Trilinos object, i.e.
        * flush the buffers of the vector object if it has any. This function is
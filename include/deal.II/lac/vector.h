@@ -20,7 +20,9 @@
 #include <deal.II/base/config.h>
 #include <deal.II/base/logstream.h>
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/memory_tracker.h>
 #include <deal.II/base/subscriptor.h>
+#include <deal.II/base/thread_management.h>
 #include <deal.II/base/index_set.h>
 #include <deal.II/lac/vector_operation.h>
 #include <deal.II/lac/vector_type_traits.h>
@@ -632,6 +634,27 @@ public:
             const size_type   *indices,
             const OtherNumber  *values);
 
+  /**
+   * Select whether the three collective add() functions above update the
+   * vector entries by atomic operations (see Threads::atomic_add()), such
+   * that several threads may add into the same entries concurrently. This is
+   * used for running the copier functions of WorkStream in parallel, see
+   * WorkStream::run_with_concurrent_copiers() and
+   * SparseMatrix::set_atomic_add_mode(). The default is <tt>false</tt>. The
+   * setting is a property of this object and is neither copied, moved, nor
+   * swapped to other vectors.
+   *
+   * All other functions that write into the vector, including operator()
+   * and the vector space operations, are not affected by this setting.
+   */
+  void set_atomic_add_mode (const bool use_atomic_add);
+
+  /**
+   * Return whether the collective add() functions use atomic updates, see
+   * set_atomic_add_mode().
+   */
+  bool get_atomic_add_mode () const;
+
   /**
    * Addition of @p s to all components. Note that @p s is a scalar and not a
    * vector.
@@ -797,6 +820,21 @@ public:
    */
   void block_read (std::istream &in);
 
+  /**
+   * Read a vector that has been written by block_write() to the file
+   * @p filename. In contrast to block_read(), the file is mapped into memory
+   * (see Utilities::System::MemoryMappedFile) and the data is copied from
+   * there into this vector by all threads, using the same partition of the
+   * vector into chunks as the other vector operations. This avoids the copy
+   * through the stream buffer, overlaps reading of the file with the copy,
+   * and places the memory of each chunk close to the thread that works on
+   * it in later operations on machines with several memory domains.
+   *
+   * The vector is resized if necessary. The same checks on the file content
+   * as in block_read() are performed.
+   */
+  void block_read_mapped (const std::string &filename);
+
   /**
    * Write the data of this object to a stream for the purpose of
    * serialization.
@@ -897,7 +935,8 @@ protected:
    *
    * Because we allocate these arrays via Utilities::System::posix_memalign,
    * we need to use a custom deleter for this object that does not call
-   * <code>delete[]</code>, but instead calls @p free().
+   * <code>delete[]</code>, but instead calls MemoryTracker::free(), which
+   * releases the memory with @p free().
    */
   std::unique_ptr<Number[], decltype(&free)> values;
 
@@ -907,6 +946,12 @@ protected:
    */
   mutable std::shared_ptr<parallel::internal::TBBPartitioner> thread_loop_partitioner;
 
+  /**
+   * Whether the collective add() functions use atomic updates, see
+   * set_atomic_add_mode().
+   */
+  bool atomic_add_mode;
+
   /**
    * Make all other vector types friends.
    */
@@ -952,7 +997,8 @@ Vector<Number>::Vector ()
   :
   vec_size(0),
   max_vec_size(0),
-  values(nullptr, &free)
+  values(nullptr, &MemoryTracker::free),
+  atomic_add_mode(false)
 {
   reinit(0);
 }
@@ -965,7 +1011,8 @@ Vector<Number>::Vector (const InputIterator first, const InputIterator last)
   :
   vec_size (0),
   max_vec_size (0),
-  values (nullptr, &free)
+  values (nullptr, &MemoryTracker::free),
+  atomic_add_mode (false)
 {
   // allocate memory. do not initialize it, as we will copy over to it in a
   // second
@@ -981,7 +1028,8 @@ Vector<Number>::Vector (const size_type n)
   :
   vec_size(0),
   max_vec_size(0),
-  values(nullptr, &free)
+  values(nullptr, &MemoryTracker::free),
+  atomic_add_mode(false)
 {
   reinit (n, false);
 }
@@ -1169,12 +1217,35 @@ Vector<Number>::add (const size_type  n_indices,
       Assert (numbers::is_finite(values[i]),
               ExcMessage("The given value is not finite but either infinite or Not A Number (NaN)"));
 
-      this->values[indices[i]] += values[i];
+      if (atomic_add_mode)
+        Threads::atomic_add (this->values[indices[i]], static_cast<Number>(values[i]));
+      else
+        this->values[indices[i]] += values[i];
     }
 }
 
 
 
+template <typename Number>
+inline
+void
+Vector<Number>::set_atomic_add_mode (const bool use_atomic_add)
+{
+  atomic_add_mode = use_atomic_add;
+}
+
+
+
+template <typename Number>
+inline
+bool
+Vector<Number>::get_atomic_add_mode () const
+{
+  return atomic_add_mode;
+}
+
+
+
 template <typename Number>
 template <typename Number2>
 inline
@@ -19,6 +19,7 @@
 
 #include <deal.II/base/template_constraints.h>
 #include <deal.II/base/numbers.h>
+#include <deal.II/base/utilities.h>
 #include <deal.II/lac/exceptions.h>
 #include <deal.II/lac/vector.h>
 #include <deal.II/lac/block_vector.h>
@@ -35,6 +36,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include <cstring>
 #include <iomanip>
 #include <iostream>
@@ -48,7 +50,8 @@ Vector<Number>::Vector (const Vector<Number> &v)
   Subscriptor(),
   vec_size(v.size()),
   max_vec_size(v.size()),
-  values(nullptr, &free)
+  values(nullptr, &MemoryTracker::free),
+  atomic_add_mode(false)
 {
   if (vec_size != 0)
     {
@@ -66,7 +69,8 @@ Vector<Number>::Vector (Vector<Number> &&v)
   vec_size(v.vec_size),
   max_vec_size(v.max_vec_size),
   values(std::move(v.values)),
-  thread_loop_partitioner(std::move(v.thread_loop_partitioner))
+  thread_loop_partitioner(std::move(v.thread_loop_partitioner)),
+  atomic_add_mode(false)
 {
   v.vec_size = 0;
   v.max_vec_size = 0;
@@ -82,7 +86,8 @@ Vector<Number>::Vector (const Vector<OtherNumber> &v)
   Subscriptor(),
   vec_size(v.size()),
   max_vec_size(v.size()),
-  values(nullptr, &free)
+  values(nullptr, &MemoryTracker::free),
+  atomic_add_mode(false)
 {
   if (vec_size != 0)
     {
@@ -145,7 +150,8 @@ Vector<Number>::Vector (const PETScWrappers::VectorBase &v)
   Subscriptor(),
   vec_size(0),
   max_vec_size(0),
-  values(nullptr, &free)
+  values(nullptr, &MemoryTracker::free),
+  atomic_add_mode(false)
 {
   if (v.size() != 0)
     {
@@ -163,7 +169,8 @@ Vector<Number>::Vector (const TrilinosWrappers::MPI::Vector &v)
   Subscriptor(),
   vec_size(v.size()),
   max_vec_size(v.size()),
-  values(nullptr, &free)
+  values(nullptr, &MemoryTracker::free),
+  atomic_add_mode(false)
 {
   if (vec_size != 0)
     {
@@ -269,10 +276,12 @@ void Vector<Number>::reinit (const size_type n,
       return;
     }
 
+  bool new_memory = false;
   if (n>max_vec_size)
     {
       max_vec_size = n;
       allocate();
+      new_memory = true;
     }
 
   if (vec_size != n)
@@ -285,7 +294,10 @@ void Vector<Number>::reinit (const size_type n,
         thread_loop_partitioner.reset(new parallel::internal::TBBPartitioner());
     }
 
-  if (omit_zeroing_entries == false)
+  // newly allocated memory is touched with the partitioning of the vector
+  // operations if requested, see MultithreadInfo::set_parallel_first_touch()
+  if (omit_zeroing_entries == false ||
+      (new_memory && MultithreadInfo::use_parallel_first_touch()))
     *this = Number();
 }
 
@@ -305,13 +317,16 @@ void Vector<Number>::reinit (const Vector<Number2> &v,
       return;
     }
 
+  bool new_memory = false;
   if (v.vec_size>max_vec_size)
     {
       max_vec_size = v.vec_size;
       allocate();
+      new_memory = true;
     }
   vec_size = v.vec_size;
-  if (omit_zeroing_entries == false)
+  if (omit_zeroing_entries == false ||
+      (new_memory && MultithreadInfo::use_parallel_first_touch()))
     *this = Number();
 }
 
@@ -968,6 +983,46 @@ void Vector<Number>::block_read (std::istream &in)
 
 
 
+template <typename Number>
+void Vector<Number>::block_read_mapped (const std::string &filename)
+{
+  const Utilities::System::MemoryMappedFile file (filename);
+  const char *const data = file.data();
+  const std::size_t file_size = file.size();
+
+  // the size is written as a number
+  // followed by a newline and the
+  // opening bracket, see block_write()
+  std::size_t header_size = 0;
+  while (header_size < std::min<std::size_t>(file_size, 16) &&
+         data[header_size] != '\n')
+    ++header_size;
+  AssertThrow (header_size < file_size && data[header_size] == '\n',
+               ExcIO());
+
+  const std::string size_string (data, header_size);
+  const size_type sz = std::strtoull (size_string.c_str(), nullptr, 10);
+  header_size += 2;
+
+  AssertThrow (file_size == header_size + sz*sizeof(Number) + 1, ExcIO());
+  AssertThrow (data[header_size-1] == '[', ExcIO());
+  AssertThrow (data[file_size-1] == ']', ExcIO());
+
+  // fast initialization, since the
+  // data elements are overwritten anyway
+  reinit (sz, true);
+
+  if (vec_size>0)
+    {
+      dealii::internal::VectorOperations::Vector_copy<Number,Number>
+      copier(reinterpret_cast<const Number *>(data + header_size),
+             values.get());
+      internal::VectorOperations::parallel_for(copier,0,vec_size,thread_loop_partitioner);
+    }
+}
+
+
+
 template <typename Number>
 IndexSet
 Vector<Number>::locally_owned_elements() const
@@ -993,6 +1048,8 @@ Vector<Number>::allocate()
   // allocate memory with the proper alignment requirements of 64 bytes
   Number *new_values;
   Utilities::System::posix_memalign ((void **)&new_values, 64, sizeof(Number)*max_vec_size);
+  if (MemoryTracker::is_enabled())
+    MemoryTracker::record_allocation (new_values, sizeof(Number)*max_vec_size);
   values.reset (new_values);
 }
 
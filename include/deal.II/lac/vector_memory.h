@@ -21,8 +21,10 @@
 #include <deal.II/base/smartpointer.h>
 #include <deal.II/base/logstream.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/thread_local_storage.h>
 #include <deal.II/lac/vector.h>
 
+#include <atomic>
 #include <vector>
 #include <iostream>
 #include <memory>
@@ -446,6 +448,125 @@ private:
 
 
 
+/**
+ * A pool based memory management class with a separate pool for each
+ * thread. See the documentation of the base class for a description of its
+ * purpose.
+ *
+ * Like GrowingVectorMemory, this class keeps vectors that are returned
+ * through free() for later reuse by alloc(). However, the vectors are kept
+ * in a cache local to the thread that calls free(), and alloc() only looks
+ * into the cache of the calling thread. Neither of the two functions
+ * therefore acquires a lock, and several threads, e.g. the workers of a
+ * WorkStream loop each running an inner solver, can use the same object
+ * concurrently without contention. The thread that frees a vector does not
+ * need to be the one that allocated it.
+ *
+ * alloc() returns the vector most recently freed by the calling thread.
+ * Since iterative solvers and smoothers allocate and release their
+ * temporary vectors in a stack-like fashion, this is in the steady state
+ * the vector that the same code location had obtained before, i.e., a
+ * vector with the size and parallel layout the caller is about to
+ * reinitialize it to. The reinit() calls of the vector classes keep the
+ * memory in that case, so repeated inner solves neither hit the memory
+ * allocator nor touch newly allocated memory pages.
+ *
+ * As opposed to GrowingVectorMemory, the pool is a member of each object
+ * and the vectors held by it are released by the destructor. An object of
+ * this class should therefore live as long as the solvers using it are
+ * called repeatedly, e.g., as a member variable of a preconditioner that
+ * runs an inner solver:
+ * @code
+ *   ThreadLocalVectorMemory<Vector<double> > vector_memory;
+ *   ...
+ *   // possibly from several threads at the same time:
+ *   SolverCG<Vector<double> > solver (solver_control, vector_memory);
+ *   solver.solve (matrix, solution, rhs, preconditioner);
+ * @endcode
+ */
+template <typename VectorType = dealii::Vector<double> >
+class ThreadLocalVectorMemory : public VectorMemory<VectorType>
+{
+public:
+  /**
+   * Constructor.
+   */
+  ThreadLocalVectorMemory ();
+
+  /**
+   * Destructor. Release all vectors held by the pools of all threads. At
+   * this point, all vectors allocated through this object must have been
+   * returned.
+   */
+  virtual ~ThreadLocalVectorMemory ();
+
+  /**
+   * Return a pointer to a vector, taking the one most recently returned by
+   * the calling thread if there is one and allocating a new one otherwise.
+   * As for the other classes derived from VectorMemory, the size and the
+   * content of the vector are unspecified, and the caller needs to
+   * reinitialize it appropriately.
+   *
+   * @warning Just like using <code>new</code> and <code>delete</code>
+   *   explicitly in code invites bugs where memory is leaked (either
+   *   because the corresponding <code>delete</code> is forgotten
+   *   altogether, or because of exception safety issues), using the
+   *   alloc() and free() functions explicitly invites writing code
+   *   that accidentally leaks memory. You should consider using
+   *   the VectorMemory::Pointer class instead, which provides the
+   *   same kind of service that <code>std::unique</code> provides
+   *   for arbitrary memory allocated on the heap.
+   */
+  virtual VectorType *alloc ();
+
+  /**
+   * Return a vector and indicate that it is not going to be used any further
+   * by the instance that called alloc() to get a pointer to it.
+   *
+   * For the present class, this means putting the vector into the pool of
+   * the calling thread for later reuse by the alloc() method.
+   *
+   * @warning Just like using <code>new</code> and <code>delete</code>
+   *   explicitly in code invites bugs where memory is leaked (either
+   *   because the corresponding <code>delete</code> is forgotten
+   *   altogether, or because of exception safety issues), using the
+   *   alloc() and free() functions explicitly invites writing code
+   *   that accidentally leaks memory. You should consider using
+   *   the VectorMemory::Pointer class instead, which provides the
+   *   same kind of service that <code>std::unique</code> provides
+   *   for arbitrary memory allocated on the heap.
+   */
+  virtual void free (const VectorType *const);
+
+  /**
+   * Release the vectors held by the pools of all threads. This function
+   * must not be called while other threads use the current object.
+   */
+  void release_unused_memory ();
+
+  /**
+   * Memory consumed by this class and all vectors currently held in the
+   * pools. This function must not be called while other threads use the
+   * current object.
+   */
+  virtual std::size_t memory_consumption() const;
+
+private:
+  /**
+   * The vectors available for reuse, separately for each thread. The most
+   * recently returned vector is at the end.
+   */
+  mutable Threads::ThreadLocalStorage<std::vector<VectorType *> > pools;
+
+  /**
+   * Number of vectors currently handed out by this object; used for
+   * detecting memory leaks.
+   */
+  std::atomic<unsigned int> current_alloc;
+};
+
+
+
 namespace internal
 {
   namespace GrowingVectorMemory
@@ -187,6 +187,95 @@ GrowingVectorMemory<VectorType>::memory_consumption () const
 }
 
 
+
+template <typename VectorType>
+inline
+ThreadLocalVectorMemory<VectorType>::ThreadLocalVectorMemory ()
+  :
+  current_alloc (0)
+{}
+
+
+
+template <typename VectorType>
+inline
+ThreadLocalVectorMemory<VectorType>::~ThreadLocalVectorMemory ()
+{
+  AssertNothrow(current_alloc == 0,
+                StandardExceptions::ExcMemoryLeak(current_alloc));
+  release_unused_memory ();
+}
+
+
+
+template <typename VectorType>
+inline
+VectorType *
+ThreadLocalVectorMemory<VectorType>::alloc ()
+{
+  ++current_alloc;
+
+  std::vector<VectorType *> &pool = pools.get();
+  if (pool.empty())
+    return new VectorType();
+
+  VectorType *v = pool.back();
+  pool.pop_back();
+  return v;
+}
+
+
+
+template <typename VectorType>
+inline
+void
+ThreadLocalVectorMemory<VectorType>::free (const VectorType *const v)
+{
+  Assert (current_alloc > 0,
+          typename VectorMemory<VectorType>::ExcNotAllocatedHere());
+  --current_alloc;
+  pools.get().push_back (const_cast<VectorType *>(v));
+}
+
+
+
+template <typename VectorType>
+inline
+void
+ThreadLocalVectorMemory<VectorType>::release_unused_memory ()
+{
+#ifdef DEAL_II_WITH_THREADS
+  for (auto &pool : pools.get_implementation())
+    for (VectorType *v : pool)
+      delete v;
+#else
+  for (VectorType *v : pools.get_implementation())
+    delete v;
+#endif
+  pools.clear();
+}
+
+
+
+template <typename VectorType>
+inline
+std::size_t
+ThreadLocalVectorMemory<VectorType>::memory_consumption () const
+{
+  std::size_t result = sizeof (*this);
+#ifdef DEAL_II_WITH_THREADS
+  for (const auto &pool : pools.get_implementation())
+    for (const VectorType *v : pool)
+      result += sizeof (v) + v->memory_consumption();
+#else
+  for (const VectorType *v : pools.get_implementation())
+    result += sizeof (v) + v->memory_consumption();
+#endif
+
+  return result;
+}
+
+
 DEAL_II_NAMESPACE_CLOSE
 
 #endif
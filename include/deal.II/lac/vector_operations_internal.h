@@ -17,7 +17,10 @@
 #ifndef dealii_vector_operations_internal_h
 #define dealii_vector_operations_internal_h
 
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/mpi.h>
 #include <deal.II/base/multithread_info.h>
+#include <deal.II/base/numbers.h>
 #include <deal.II/base/parallel.h>
 #include <deal.II/base/thread_management.h>
 #include <deal.II/base/vectorization.h>
@@ -27,6 +30,15 @@
 
 DEAL_II_NAMESPACE_OPEN
 
+template <typename> class Vector;
+namespace LinearAlgebra
+{
+  namespace distributed
+  {
+    template <typename> class Vector;
+  }
+}
+
 namespace internal
 {
   namespace VectorOperations
@@ -170,6 +182,18 @@ namespace internal
       if (vec_size >= 4*internal::Vector::minimum_parallel_grain_size &&
           MultithreadInfo::n_threads() > 1)
         {
+          if (MultithreadInfo::get_loop_backend())
+            {
+              TBBForFunctor<Functor> generic_functor(functor, start, end);
+              MultithreadInfo::get_loop_backend()
+              (0, generic_functor.n_chunks, 1,
+               [&](const std::size_t lower, const std::size_t upper)
+              {
+                generic_functor (tbb::blocked_range<size_type>(lower, upper, 1));
+              });
+              return;
+            }
+
           Assert(partitioner.get() != nullptr,
                  ExcInternalError("Unexpected initialization of Vector that does "
                                   "not set the TBB partitioner to a usable state."));
@@ -194,7 +218,10 @@ namespace internal
 
 
     // Define the functors necessary to use SIMD with TBB. we also include the
-    // simple copy and set operations
+    // simple copy and set operations. The loops of the vector updates are
+    // compiled for several instruction sets, with the variant selected at
+    // load time according to the CPU via DEAL_II_TARGET_CLONES (empty if the
+    // compiler does not support it)
 
     template <typename Number>
     struct Vector_set
@@ -260,6 +287,7 @@ namespace internal
         factor(factor)
       {}
 
+      DEAL_II_TARGET_CLONES
       void operator() (const size_type begin, const size_type end) const
       {
         if (parallel::internal::EnableOpenMPSimdFor<Number>::value)
@@ -289,6 +317,7 @@ namespace internal
         factor(factor)
       {}
 
+      DEAL_II_TARGET_CLONES
       void operator() (const size_type begin, const size_type end) const
       {
         if (parallel::internal::EnableOpenMPSimdFor<Number>::value)
@@ -320,6 +349,7 @@ namespace internal
         x(x)
       {}
 
+      DEAL_II_TARGET_CLONES
       void operator() (const size_type begin, const size_type end) const
       {
         if (parallel::internal::EnableOpenMPSimdFor<Number>::value)
@@ -350,6 +380,7 @@ namespace internal
         v_val(v_val)
       {}
 
+      DEAL_II_TARGET_CLONES
       void operator() (const size_type begin, const size_type end) const
       {
         if (parallel::internal::EnableOpenMPSimdFor<Number>::value)
@@ -378,6 +409,7 @@ namespace internal
         factor(factor)
       {}
 
+      DEAL_II_TARGET_CLONES
       void operator() (const size_type begin, const size_type end) const
       {
         if (parallel::internal::EnableOpenMPSimdFor<Number>::value)
@@ -406,6 +438,7 @@ namespace internal
         v_val(v_val)
       {}
 
+      DEAL_II_TARGET_CLONES
       void operator() (const size_type begin, const size_type end) const
       {
         if (parallel::internal::EnableOpenMPSimdFor<Number>::value)
@@ -437,6 +470,7 @@ namespace internal
         b(b)
       {}
 
+      DEAL_II_TARGET_CLONES
       void operator() (const size_type begin, const size_type end) const
       {
         if (parallel::internal::EnableOpenMPSimdFor<Number>::value)
@@ -469,6 +503,7 @@ namespace internal
         x(x)
       {}
 
+      DEAL_II_TARGET_CLONES
       void operator() (const size_type begin, const size_type end) const
       {
         if (parallel::internal::EnableOpenMPSimdFor<Number>::value)
@@ -503,6 +538,7 @@ namespace internal
         b(b)
       {}
 
+      DEAL_II_TARGET_CLONES
       void operator() (const size_type begin, const size_type end) const
       {
         if (parallel::internal::EnableOpenMPSimdFor<Number>::value)
@@ -535,6 +571,7 @@ namespace internal
         v_val(v_val)
       {}
 
+      DEAL_II_TARGET_CLONES
       void operator() (const size_type begin, const size_type end) const
       {
         if (parallel::internal::EnableOpenMPSimdFor<Number>::value)
@@ -564,6 +601,7 @@ namespace internal
         a(a)
       {}
 
+      DEAL_II_TARGET_CLONES
       void operator() (const size_type begin, const size_type end) const
       {
         if (parallel::internal::EnableOpenMPSimdFor<Number>::value)
@@ -597,6 +635,7 @@ namespace internal
         b(b)
       {}
 
+      DEAL_II_TARGET_CLONES
       void operator() (const size_type begin, const size_type end) const
       {
         if (parallel::internal::EnableOpenMPSimdFor<Number>::value)
@@ -634,6 +673,7 @@ namespace internal
         c(c)
       {}
 
+      DEAL_II_TARGET_CLONES
       void operator() (const size_type begin, const size_type end) const
       {
         if (parallel::internal::EnableOpenMPSimdFor<Number>::value)
@@ -668,6 +708,7 @@ namespace internal
         b_val(b_val)
       {}
 
+      DEAL_II_TARGET_CLONES
       void operator() (const size_type begin, const size_type end) const
       {
         if (parallel::internal::EnableOpenMPSimdFor<Number>::value)
@@ -918,6 +959,24 @@ namespace internal
      */
     const unsigned int vector_accumulation_recursion_threshold = 128;
 
+    // forward declarations of the inner working routines, such that they are
+    // found for operations defined outside of this namespace as well
+    template <typename Operation, typename ResultType>
+    void
+    accumulate_regular(const Operation &op,
+                       size_type       &n_chunks,
+                       size_type       &index,
+                       ResultType (&outer_results)[vector_accumulation_recursion_threshold],
+                       std::integral_constant<bool, false>);
+
+    template <typename Operation, typename Number>
+    void
+    accumulate_regular(const Operation &op,
+                       size_type       &n_chunks,
+                       size_type       &index,
+                       Number (&outer_results)[vector_accumulation_recursion_threshold],
+                       std::integral_constant<bool, true>);
+
     template <typename Operation, typename ResultType>
     void accumulate_recursive (const Operation   &op,
                                const size_type    first,
@@ -1273,6 +1332,19 @@ namespace internal
       if (vec_size >= 4*internal::Vector::minimum_parallel_grain_size &&
           MultithreadInfo::n_threads() > 1)
         {
+          if (MultithreadInfo::get_loop_backend())
+            {
+              TBBReduceFunctor<Operation,ResultType> generic_functor(op, start, end);
+              MultithreadInfo::get_loop_backend()
+              (0, generic_functor.n_chunks, 1,
+               [&](const std::size_t lower, const std::size_t upper)
+              {
+                generic_functor (tbb::blocked_range<size_type>(lower, upper, 1));
+              });
+              result = generic_functor.do_sum();
+              return;
+            }
+
           Assert(partitioner.get() != nullptr,
                  ExcInternalError("Unexpected initialization of Vector that does "
                                   "not set the TBB partitioner to a usable state."));
@@ -1295,6 +1367,78 @@ namespace internal
       (void)partitioner;
 #endif
     }
+
+
+    /**
+     * Access to the locally owned entries of vectors that store their
+     * elements contiguously in memory, used by algorithms that merge several
+     * vector operations into a single loop over the vector entries, like the
+     * fused updates in SolverCG. The general template marks vector types
+     * that do not support direct access, for which the algorithms fall back
+     * to the usual vector interface.
+     */
+    template <typename VectorType>
+    struct VectorAccess
+    {
+      static const bool is_supported = false;
+    };
+
+    /**
+     * Direct access to the entries of dealii::Vector.
+     */
+    template <typename Number>
+    struct VectorAccess<dealii::Vector<Number> >
+    {
+      static const bool is_supported = !numbers::NumberTraits<Number>::is_complex;
+
+      /**
+       * Return the number of locally stored elements.
+       */
+      static size_type local_size (const dealii::Vector<Number> &v)
+      {
+        return v.size();
+      }
+
+      /**
+       * Sum the partial results of a reduction over all processors sharing
+       * the vector, which is a no-op for serial vectors.
+       */
+      template <typename T>
+      static void sum (const ArrayView<T> &,
+                       const dealii::Vector<Number> &)
+      {}
+    };
+
+    /**
+     * Direct access to the locally owned entries of
+     * LinearAlgebra::distributed::Vector.
+     */
+    template <typename Number>
+    struct VectorAccess<LinearAlgebra::distributed::Vector<Number> >
+    {
+      static const bool is_supported = !numbers::NumberTraits<Number>::is_complex;
+
+      /**
+       * Return the number of locally owned elements.
+       */
+      static size_type local_size (const LinearAlgebra::distributed::Vector<Number> &v)
+      {
+        return v.local_size();
+      }
+
+      /**
+       * Sum the partial results of a reduction over all processors in the
+       * communicator of the vector, using a single collective operation for
+       * all given values.
+       */
+      template <typename T>
+      static void sum (const ArrayView<T> &values,
+                       const LinearAlgebra::distributed::Vector<Number> &v)
+      {
+        Utilities::MPI::sum (ArrayView<const T>(values.data(), values.size()),
+                             v.get_mpi_communicator(), values);
+      }
+    };
   }
 }
 
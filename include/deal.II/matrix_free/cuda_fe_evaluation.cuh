@@ -80,6 +80,13 @@ namespace CUDAWrappers
       Utilities::fixed_int_power<n_q_points_1d,dim>::value;
     static const unsigned int tensor_dofs_per_cell =
       Utilities::fixed_int_power<fe_degree+1,dim>::value;
+    /**
+     * Number of points in z-direction each thread works on: all of them
+     * for two-dimensional thread blocks in 3D, see
+     * use_column_thread_blocks(), and one otherwise.
+     */
+    static const unsigned int n_points_per_thread =
+      use_column_thread_blocks(dim, fe_degree) ? n_q_points_1d : 1;
 
     /**
      * Constructor.
@@ -161,6 +168,12 @@ namespace CUDAWrappers
     __device__ void apply_quad_point_operations(const functor &func);
 
   private:
+    /**
+     * Return the index within the cell of the point number @p layer of the
+     * current thread.
+     */
+    __device__ unsigned int point_index(const unsigned int layer) const;
+
     unsigned int *local_to_global;
     unsigned int n_cells;
     unsigned int padding_length;
@@ -208,13 +221,13 @@ namespace CUDAWrappers
   {
     static_assert(n_components_ == 1, "This function only supports FE with one \
                   components");
-    const unsigned int idx = (threadIdx.x%n_q_points_1d)
-                             +(dim>1 ? threadIdx.y : 0)*n_q_points_1d
-                             +(dim>2 ? threadIdx.z : 0)*n_q_points_1d*n_q_points_1d;
-
-    const unsigned int src_idx = local_to_global[idx];
-    // Use the read-only data cache.
-    values[idx] = __ldg(&src[src_idx]);
+    for (unsigned int layer=0; layer<n_points_per_thread; ++layer)
+      {
+        const unsigned int idx = point_index(layer);
+        const unsigned int src_idx = local_to_global[idx];
+        // Use the read-only data cache.
+        values[idx] = __ldg(&src[src_idx]);
+      }
 
     if (constraint_mask)
       internal::resolve_hanging_nodes_shmem<dim,fe_degree,false>(values,
@@ -238,12 +251,13 @@ namespace CUDAWrappers
                                                                 constraint_mask);
 
 
-    const unsigned int idx = (threadIdx.x%n_q_points_1d)
-                             + (dim>1 ? threadIdx.y : 0) * n_q_points_1d
-                             + (dim>2 ? threadIdx.z : 0) * n_q_points_1d * n_q_points_1d;
-    const unsigned int destination_idx = local_to_global[idx];
+    for (unsigned int layer=0; layer<n_points_per_thread; ++layer)
+      {
+        const unsigned int idx = point_index(layer);
+        const unsigned int destination_idx = local_to_global[idx];
 
-    dst[destination_idx] += values[idx];
+        dst[destination_idx] += values[idx];
+      }
   }
 
 
@@ -376,14 +390,26 @@ namespace CUDAWrappers
   FEEvaluation<dim, fe_degree, n_q_points_1d, n_components_, Number>::
   apply_quad_point_operations(const functor &func)
   {
-    const unsigned int q_point = (dim == 1 ? threadIdx.x%n_q_points_1d :
-                                  dim == 2 ? threadIdx.x%n_q_points_1d + n_q_points_1d *threadIdx.y :
-                                  threadIdx.x%n_q_points_1d + n_q_points_1d * (threadIdx.y +
-                                      n_q_points_1d*threadIdx.z));
-    func(this, q_point);
+    for (unsigned int layer=0; layer<n_points_per_thread; ++layer)
+      func(this, point_index(layer));
 
     __syncthreads();
   }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+            typename Number>
+  __device__ unsigned int
+  FEEvaluation<dim, fe_degree, n_q_points_1d, n_components_, Number>::
+  point_index(const unsigned int layer) const
+  {
+    const unsigned int z = (n_points_per_thread > 1) ? layer :
+                           (dim>2 ? threadIdx.z : 0);
+    return (threadIdx.x%n_q_points_1d)
+           + (dim>1 ? threadIdx.y : 0) * n_q_points_1d
+           + z * n_q_points_1d * n_q_points_1d;
+  }
 }
 
 DEAL_II_NAMESPACE_CLOSE
@@ -21,6 +21,7 @@
 
 #ifdef DEAL_II_WITH_CUDA
 
+#include <deal.II/base/partitioner.h>
 #include <deal.II/base/quadrature.h>
 #include <deal.II/base/tensor.h>
 #include <deal.II/dofs/dof_handler.h>
@@ -28,6 +29,7 @@
 #include <deal.II/fe/mapping_q1.h>
 #include <deal.II/fe/fe_update_flags.h>
 #include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/cuda_distributed_vector.h>
 #include <deal.II/lac/cuda_vector.h>
 #include <cuda_runtime_api.h>
 
@@ -65,6 +67,25 @@ namespace CUDAWrappers
    * This class traverse the cells in a different order than the usual
    * Triangulation class in deal.II.
    *
+   * If the DoFHandler is based on a parallel::Triangulation, e.g., a
+   * parallel::distributed::Triangulation, the loops only run over the
+   * locally owned cells, and the vectors need to be of type
+   * LinearAlgebra::CUDAWrappers::DistributedVector initialized by
+   * initialize_dof_vector(). In this case, cell_loop() exchanges the ghost
+   * values of the source vector and sends the contributions to ghost
+   * elements of the destination vector to their owners, where the data is
+   * packed on the device and passed to MPI without copying it to the host.
+   * The vectors of type LinearAlgebra::CUDAWrappers::Vector can only be used
+   * for meshes that are not distributed.
+   *
+   * Unless AdditionalData::overlap_communication_computation is disabled,
+   * the locally owned cells of a distributed mesh are colored in two
+   * groups: the cells that only touch locally owned degrees of freedom and
+   * the cells at the boundary to other processes. The kernels of the first
+   * group are launched on a CUDA stream of their own while the ghost values
+   * of the source vector are exchanged, and only the kernels of the second
+   * group wait for the exchange.
+   *
    * @ingroup CUDAWrappers
    */
   template <int dim, typename Number=double>
@@ -79,6 +100,10 @@ namespace CUDAWrappers
     template <typename Number2>
     using CUDAVector = ::dealii::LinearAlgebra::CUDAWrappers::Vector<Number2>;
 
+    // Use Number2 so we don't hide the template parameter Number
+    template <typename Number2>
+    using DistributedCUDAVector = ::dealii::LinearAlgebra::CUDAWrappers::DistributedVector<Number2>;
+
     /**
      * Parallelization scheme used: parallel_in_elem (parallelism at the level
      * of degrees of freedom) or parallel_over_elem (parallelism at the level of
@@ -90,10 +115,12 @@ namespace CUDAWrappers
     {
       AdditionalData (
         const ParallelizationScheme parallelization_scheme = parallel_in_elem,
-        const UpdateFlags mapping_update_flags = update_gradients | update_JxW_values)
+        const UpdateFlags mapping_update_flags = update_gradients | update_JxW_values,
+        const bool overlap_communication_computation = true)
         :
         parallelization_scheme(parallelization_scheme),
-        mapping_update_flags(mapping_update_flags)
+        mapping_update_flags(mapping_update_flags),
+        overlap_communication_computation(overlap_communication_computation)
       {}
 
       /**
@@ -115,6 +142,13 @@ namespace CUDAWrappers
        * must be specified by this field.
        */
       UpdateFlags mapping_update_flags;
+      /**
+       * On distributed meshes, overlap the exchange of the ghost values of the
+       * source vector in cell_loop() with the kernels on the cells that do
+       * not read any ghost value. This flag has no effect on meshes that are
+       * not distributed.
+       */
+      bool overlap_communication_computation;
     };
 
     /**
@@ -175,11 +209,50 @@ namespace CUDAWrappers
                    const CUDAVector<Number> &src,
                    CUDAVector<Number> &dst) const;
 
+    /**
+     * Same as above for vectors distributed over several processes. The
+     * ghost values of @p src are updated before the loop, and the
+     * contributions to the ghost elements of @p dst are added to the
+     * elements of their owners after the loop.
+     */
+    template <typename functor>
+    void cell_loop(const functor &func,
+                   const DistributedCUDAVector<Number> &src,
+                   DistributedCUDAVector<Number> &dst) const;
+
     void copy_constrained_values(const CUDAVector<Number> &src,
                                  CUDAVector<Number> &dst) const;
 
     void set_constrained_values(const Number val, CUDAVector<Number> &dst) const;
 
+    /**
+     * Same as above for distributed vectors. Only the locally owned
+     * constrained degrees of freedom are copied.
+     */
+    void copy_constrained_values(const DistributedCUDAVector<Number> &src,
+                                 DistributedCUDAVector<Number> &dst) const;
+
+    /**
+     * Same as above for distributed vectors. Only the locally owned
+     * constrained degrees of freedom are set.
+     */
+    void set_constrained_values(const Number val, DistributedCUDAVector<Number> &dst) const;
+
+    /**
+     * Initialize @p vec with the layout of the locally owned and the ghost
+     * degrees of freedom used by cell_loop().
+     */
+    void initialize_dof_vector(DistributedCUDAVector<Number> &vec) const;
+
+    /**
+     * Return the partitioner describing the locally owned degrees of
+     * freedom and the ghost degrees of freedom touched by the locally owned
+     * cells. The indices in Data::local_to_global are local indices of this
+     * partitioner.
+     */
+    const std::shared_ptr<const Utilities::MPI::Partitioner> &
+    get_vector_partitioner() const;
+
     /**
      * Free all the memory allocated.
      */
@@ -216,6 +289,30 @@ namespace CUDAWrappers
      * Number of colors produced by the graph coloring algorithm.
      */
     unsigned int n_colors;
+    /**
+     * Number of colors, at the start of the list of colors, whose cells do
+     * not touch any ghost degree of freedom. These colors are worked on while
+     * the ghost values are exchanged. Equal to @p n_colors if the
+     * communication is not overlapped.
+     */
+    unsigned int n_interior_colors;
+    /**
+     * The streams on which the kernels of the interior cells and the
+     * exchange of ghost values, respectively the kernels of the cells at the
+     * boundary to other processes, are run if the communication is
+     * overlapped.
+     */
+    cudaStream_t streams[2];
+    /**
+     * The event by which the kernels of the boundary cells wait for the
+     * kernels of the interior cells, which may write to the same entries of
+     * the destination vector.
+     */
+    cudaEvent_t interior_cells_done;
+    /**
+     * Whether the streams and the event above have been created.
+     */
+    bool use_streams;
     /**
      * Number of cells in each color.
      */
@@ -263,6 +360,11 @@ namespace CUDAWrappers
     unsigned int padding_length;
     std::vector<unsigned int> row_start;
 
+    /**
+     * The layout of the vectors the cell loops work on.
+     */
+    std::shared_ptr<const Utilities::MPI::Partitioner> partitioner;
+
     friend class internal::ReinitHelper<dim,Number>;
   };
 
@@ -288,6 +390,20 @@ namespace CUDAWrappers
 
 
 
+  // This function determines whether the kernels use two-dimensional thread
+  // blocks, in which each thread works on a column of degrees of freedom in
+  // z-direction whose values are kept in registers during the sum
+  // factorization, instead of one thread per degree of freedom. This limits
+  // the number of threads per cell to (fe_degree+1)^2, so that the higher
+  // degrees can be run in 3D and several cells fit into one block.
+  __host__ __device__ constexpr bool use_column_thread_blocks(int dim,
+      int fe_degree)
+  {
+    return dim==3 && fe_degree>=3;
+  }
+
+
+
   // This function determines the number of cells per block, possibly at compile
   // time
   // TODO this function should be rewritten using meta-programming
@@ -301,6 +417,11 @@ namespace CUDAWrappers
                      1) :
            dim==3 ? (fe_degree==1 ? 8 :
                      fe_degree==2 ? 2 :
+                     // two-dimensional thread blocks, limited by the shared
+                     // memory for the values and the gradients
+                     fe_degree==3 ? 8 :
+                     fe_degree==4 ? 4 :
+                     fe_degree<=7 ? 2 :
                      1) : 1;
   }
 }
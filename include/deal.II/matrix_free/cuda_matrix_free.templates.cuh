@@ -22,6 +22,8 @@
 #ifdef DEAL_II_WITH_CUDA
 
 #include <deal.II/base/graph_coloring.h>
+#include <deal.II/distributed/tria_base.h>
+#include <deal.II/dofs/dof_tools.h>
 #include <deal.II/fe/fe_values.h>
 #include <deal.II/grid/filtered_iterator.h>
 #include <deal.II/matrix_free/shape_info.h>
@@ -214,6 +216,8 @@ namespace CUDAWrappers
             data->block_dim[color] = dim3(n_dofs_1d*cells_per_block);
           else if (dim==2)
             data->block_dim[color] = dim3(n_dofs_1d*cells_per_block, n_dofs_1d);
+          else if (use_column_thread_blocks(dim, fe_degree))
+            data->block_dim[color] = dim3(n_dofs_1d*cells_per_block, n_dofs_1d);
           else
             data->block_dim[color] = dim3(n_dofs_1d*cells_per_block, n_dofs_1d, n_dofs_1d);
         }
@@ -243,8 +247,10 @@ namespace CUDAWrappers
     {
       cell->get_dof_indices(local_dof_indices);
 
+      // the kernels use the local indices of the vector partitioner
       for (unsigned int i=0; i<dofs_per_cell; ++i)
-        lexicographic_dof_indices[i] = local_dof_indices[lexicographic_inv[i]];
+        lexicographic_dof_indices[i] =
+          data->partitioner->global_to_local(local_dof_indices[lexicographic_inv[i]]);
 
       memcpy(&local_to_global_host[cell_id*padding_length], lexicographic_dof_indices.data(),
              dofs_per_cell*sizeof(unsigned int));
@@ -412,6 +418,9 @@ namespace CUDAWrappers
   template <int dim, typename Number>
   MatrixFree<dim,Number>::MatrixFree()
     :
+    n_colors(0),
+    n_interior_colors(0),
+    use_streams(false),
     constrained_dofs(nullptr),
     padding_length(0)
   {}
@@ -480,23 +489,85 @@ namespace CUDAWrappers
     // Setup the number of cells per CUDA thread block
     cells_per_block = cells_per_block_shmem(dim, fe_degree);
 
+    // On distributed meshes, the vectors hold the locally owned degrees of
+    // freedom followed by the ghosts touched by the locally owned cells
+    bool is_distributed = false;
+    if (const parallel::Triangulation<dim> *tria =
+          dynamic_cast<const parallel::Triangulation<dim>*>(&dof_handler.get_triangulation()))
+      {
+        is_distributed = true;
+        IndexSet locally_relevant_dofs;
+        DoFTools::extract_locally_relevant_dofs(dof_handler, locally_relevant_dofs);
+        partitioner = std::make_shared<Utilities::MPI::Partitioner>
+                      (dof_handler.locally_owned_dofs(), locally_relevant_dofs,
+                       tria->get_communicator());
+      }
+    else
+      partitioner = std::make_shared<Utilities::MPI::Partitioner>(dof_handler.n_dofs());
+
     internal::ReinitHelper<dim, Number> helper(this, mapping, fe, quad,
                                                shape_info,  update_flags);
 
     // Create a graph coloring
     typedef FilteredIterator<typename DoFHandler<dim>::active_cell_iterator> CellFilter;
-    CellFilter begin(IteratorFilters::LocallyOwnedCell(), dof_handler.begin_active());
-    CellFilter end(IteratorFilters::LocallyOwnedCell(), dof_handler.end());
     typedef std::function<std::vector<types::global_dof_index> (CellFilter const &)> fun_type;
     const fun_type &fun = static_cast<fun_type>(std::bind(
                                                   &internal::get_conflict_indices<dim>,
                                                   std::placeholders::_1,
                                                   constraints));
 
-    std::vector<std::vector<CellFilter>> graph =
-                                        GraphColoring::make_graph_coloring(
-                                          begin, end, fun);
+    std::vector<std::vector<CellFilter>> graph;
+    if (is_distributed && additional_data.overlap_communication_computation)
+      {
+        // Color the cells that only touch locally owned degrees of freedom
+        // and the cells at the boundary to other processes separately, so
+        // that the kernels of the former can run during the exchange of the
+        // ghost values. The interior colors come first.
+        const std::shared_ptr<const Utilities::MPI::Partitioner> owned_range = partitioner;
+        for (const bool at_boundary : {false, true})
+          {
+            auto predicate = [owned_range, at_boundary]
+                             (const typename DoFHandler<dim>::active_cell_iterator &cell)
+            {
+              if (!cell->is_locally_owned())
+                return false;
+              std::vector<types::global_dof_index> dof_indices(cell->get_fe().dofs_per_cell);
+              cell->get_dof_indices(dof_indices);
+              bool touches_ghost = false;
+              for (const types::global_dof_index dof : dof_indices)
+                if (!owned_range->in_local_range(dof))
+                  {
+                    touches_ghost = true;
+                    break;
+                  }
+              return touches_ghost == at_boundary;
+            };
+            CellFilter begin(predicate, dof_handler.begin_active());
+            CellFilter end(predicate, dof_handler.end());
+            const std::vector<std::vector<CellFilter>> group_graph =
+              GraphColoring::make_graph_coloring(begin, end, fun);
+            graph.insert(graph.end(), group_graph.begin(), group_graph.end());
+            if (at_boundary == false)
+              n_interior_colors = group_graph.size();
+          }
+
+        cuda_error = cudaStreamCreateWithFlags(&streams[0], cudaStreamNonBlocking);
+        AssertCuda(cuda_error);
+        cuda_error = cudaStreamCreateWithFlags(&streams[1], cudaStreamNonBlocking);
+        AssertCuda(cuda_error);
+        cuda_error = cudaEventCreateWithFlags(&interior_cells_done, cudaEventDisableTiming);
+        AssertCuda(cuda_error);
+        use_streams = true;
+      }
+    else
+      {
+        CellFilter begin(IteratorFilters::LocallyOwnedCell(), dof_handler.begin_active());
+        CellFilter end(IteratorFilters::LocallyOwnedCell(), dof_handler.end());
+        graph = GraphColoring::make_graph_coloring(begin, end, fun);
+      }
     n_colors = graph.size();
+    if (use_streams == false)
+      n_interior_colors = n_colors;
 
     helper.setup_color_arrays(n_colors);
     for (unsigned int i=0; i<n_colors; ++i)
@@ -516,8 +587,15 @@ namespace CUDAWrappers
     for (unsigned int i=0; i<n_colors-1; ++i)
       row_start[i+1] = row_start[i] + n_cells[i] * get_padding_length();
 
-    // Constrained indices
-    n_constrained_dofs = constraints.n_constraints();
+    // Constrained indices. Only the locally owned ones are stored, as local
+    // indices of the partitioner
+    std::vector<dealii::types::global_dof_index> constrained_dofs_host;
+    const IndexSet &locally_owned_dofs = partitioner->locally_owned_range();
+    for (IndexSet::ElementIterator dof=locally_owned_dofs.begin();
+         dof!=locally_owned_dofs.end(); ++dof)
+      if (constraints.is_constrained(*dof))
+        constrained_dofs_host.push_back(partitioner->global_to_local(*dof));
+    n_constrained_dofs = constrained_dofs_host.size();
 
     if (n_constrained_dofs != 0)
       {
@@ -531,19 +609,6 @@ namespace CUDAWrappers
         constraint_grid_dim = dim3(constraint_x_n_blocks, constraint_y_n_blocks);
         constraint_block_dim = dim3(BLOCK_SIZE);
 
-        std::vector<dealii::types::global_dof_index> constrained_dofs_host(n_constrained_dofs);
-
-        unsigned int i_constraint = 0;
-        const unsigned int n_dofs = dof_handler.n_dofs();
-        for (unsigned int i=0; i<n_dofs; ++i)
-          {
-            if (constraints.is_constrained(i))
-              {
-                constrained_dofs_host[i_constraint] = i;
-                ++i_constraint;
-              }
-          }
-
         cuda_error = cudaMalloc(&constrained_dofs, n_constrained_dofs *
                                 sizeof(dealii::types::global_dof_index));
         AssertCuda(cuda_error);
@@ -642,6 +707,20 @@ namespace CUDAWrappers
         AssertCuda(cuda_error);
         constrained_dofs = nullptr;
       }
+
+    if (use_streams)
+      {
+        for (unsigned int i=0; i<2; ++i)
+          {
+            cudaError_t cuda_error = cudaStreamDestroy(streams[i]);
+            AssertCuda(cuda_error);
+          }
+        cudaError_t cuda_error = cudaEventDestroy(interior_cells_done);
+        AssertCuda(cuda_error);
+        use_streams = false;
+      }
+    n_colors = 0;
+    n_interior_colors = 0;
   }
 
 
@@ -666,6 +745,53 @@ namespace CUDAWrappers
 
 
 
+  template <int dim, typename Number>
+  void MatrixFree<dim,Number>::copy_constrained_values(const DistributedCUDAVector<Number> &src,
+                                                       DistributedCUDAVector<Number>       &dst) const
+  {
+    Assert(src.get_partitioner()->is_compatible(*partitioner),
+           ExcMessage("The vector needs to be initialized by initialize_dof_vector()."));
+    Assert(dst.get_partitioner()->is_compatible(*partitioner),
+           ExcMessage("The vector needs to be initialized by initialize_dof_vector()."));
+
+    if (n_constrained_dofs != 0)
+      internal::copy_constrained_dofs<Number> <<<constraint_grid_dim,constraint_block_dim>>> (
+        constrained_dofs, n_constrained_dofs, src.get_values(), dst.get_values());
+  }
+
+
+
+  template <int dim, typename Number>
+  void MatrixFree<dim,Number>::set_constrained_values(Number                         val,
+                                                      DistributedCUDAVector<Number> &dst) const
+  {
+    Assert(dst.get_partitioner()->is_compatible(*partitioner),
+           ExcMessage("The vector needs to be initialized by initialize_dof_vector()."));
+
+    if (n_constrained_dofs != 0)
+      internal::set_constrained_dofs<Number> <<<constraint_grid_dim, constraint_block_dim>>>(
+        constrained_dofs, n_constrained_dofs, val, dst.get_values());
+  }
+
+
+
+  template <int dim, typename Number>
+  void MatrixFree<dim,Number>::initialize_dof_vector(DistributedCUDAVector<Number> &vec) const
+  {
+    vec.reinit(partitioner);
+  }
+
+
+
+  template <int dim, typename Number>
+  const std::shared_ptr<const Utilities::MPI::Partitioner> &
+  MatrixFree<dim,Number>::get_vector_partitioner() const
+  {
+    return partitioner;
+  }
+
+
+
   template <int dim, typename Number>
   unsigned int MatrixFree<dim,Number>::get_padding_length() const
   {
@@ -680,6 +806,10 @@ namespace CUDAWrappers
                                          const CUDAVector<Number> &src,
                                          CUDAVector<Number> &dst) const
   {
+    Assert(partitioner->local_size() == partitioner->size(),
+           ExcMessage("On distributed meshes, the cell loop needs to work on "
+                      "LinearAlgebra::CUDAWrappers::DistributedVector."));
+
     for (unsigned int i=0; i < n_colors; ++i)
       internal::apply_kernel_shmem<dim, Number, functor> <<<grid_dim[i],block_dim[i]>>> (
         func, get_data(i), src.get_values(), dst.get_values());
@@ -687,6 +817,66 @@ namespace CUDAWrappers
 
 
 
+  template <int dim, typename Number>
+  template <typename functor>
+  void MatrixFree<dim,Number>::cell_loop(const functor &func,
+                                         const DistributedCUDAVector<Number> &src,
+                                         DistributedCUDAVector<Number> &dst) const
+  {
+    Assert(src.get_partitioner()->is_compatible(*partitioner),
+           ExcMessage("The vector needs to be initialized by initialize_dof_vector()."));
+    Assert(dst.get_partitioner()->is_compatible(*partitioner),
+           ExcMessage("The vector needs to be initialized by initialize_dof_vector()."));
+
+    // the cells read the ghost elements of src, and their contributions to
+    // the ghost elements of dst are collected starting from zero
+    const bool src_was_ghosted = src.has_ghost_elements();
+    dst.zero_out_ghosts();
+
+    if (use_streams && !src_was_ghosted)
+      {
+        // the streams are non-blocking, so wait for the work on the default
+        // stream, e.g., the zeroing of the ghosts of dst, to be done
+        AssertCuda(cudaDeviceSynchronize());
+
+        // work on the interior cells while the ghost values are exchanged.
+        // The boundary cells may write to the same entries of dst as the
+        // interior cells, so they wait for the interior cells to be done.
+        for (unsigned int i=0; i < n_interior_colors; ++i)
+          internal::apply_kernel_shmem<dim, Number, functor> <<<grid_dim[i],block_dim[i],0,streams[0]>>> (
+            func, get_data(i), src.get_values(), dst.get_values());
+        AssertCuda(cudaEventRecord(interior_cells_done, streams[0]));
+
+        src.update_ghost_values_start(streams[1]);
+        src.update_ghost_values_finish();
+
+        AssertCuda(cudaStreamWaitEvent(streams[1], interior_cells_done, 0));
+        for (unsigned int i=n_interior_colors; i < n_colors; ++i)
+          internal::apply_kernel_shmem<dim, Number, functor> <<<grid_dim[i],block_dim[i],0,streams[1]>>> (
+            func, get_data(i), src.get_values(), dst.get_values());
+
+        // MPI may only access the data once the kernels are done
+        AssertCuda(cudaStreamSynchronize(streams[1]));
+      }
+    else
+      {
+        if (!src_was_ghosted)
+          src.update_ghost_values();
+
+        for (unsigned int i=0; i < n_colors; ++i)
+          internal::apply_kernel_shmem<dim, Number, functor> <<<grid_dim[i],block_dim[i]>>> (
+            func, get_data(i), src.get_values(), dst.get_values());
+
+        // MPI may only access the data once the kernels are done
+        AssertCuda(cudaDeviceSynchronize());
+      }
+    dst.compress(VectorOperation::add);
+    if (!src_was_ghosted)
+      src.zero_out_ghosts();
+  }
+
+
+
   template <int dim, typename Number>
   std::size_t MatrixFree<dim, Number>::memory_consumption() const
   {
@@ -93,6 +93,17 @@ namespace CUDAWrappers
                             const Number *in,
                             Number       *out) const;
 
+      /**
+       * Variant of apply() for two-dimensional thread blocks in 3D, see
+       * use_column_thread_blocks(). Each thread works on all the points of
+       * its column in z-direction, whose results are kept in registers until
+       * they are written.
+       */
+      template <int direction, bool dof_to_quad, bool add, bool in_place>
+      __device__ void apply_columns(Number shape_data[],
+                                    const Number *in,
+                                    Number       *out) const;
+
       /**
        * Evaluate the finite element function at the quadrature points.
        */
@@ -157,6 +168,12 @@ namespace CUDAWrappers
                                              const Number *in,
                                              Number       *out) const
     {
+      if (use_column_thread_blocks(dim, fe_degree))
+        {
+          apply_columns<direction, dof_to_quad, add, in_place>(shape_data, in, out);
+          return;
+        }
+
       const unsigned int i = (dim == 1) ? 0 : threadIdx.x%n_q_points_1d;
       const unsigned int j = (dim == 3) ? threadIdx.y : 0;
       const unsigned int q =
@@ -194,6 +211,74 @@ namespace CUDAWrappers
 
 
 
+    template <int dim, int fe_degree, int n_q_points_1d, typename Number>
+    template <int direction, bool dof_to_quad, bool add, bool in_place>
+    __device__ void EvaluatorTensorProduct<evaluate_general, dim, fe_degree,
+               n_q_points_1d, Number>::apply_columns(Number shape_data[],
+                                                     const Number *in,
+                                                     Number       *out) const
+    {
+      // The thread with index (x,y) in the cell works on the points
+      // (x,y,z) for all z. In the directions 0 and 1, it produces the result
+      // at its point of the respective direction in each layer z, whereas in
+      // direction 2 the column is only read and written by this thread.
+      const unsigned int x = threadIdx.x%n_q_points_1d;
+      const unsigned int y = threadIdx.y;
+
+      Number t[n_q_points_1d];
+      if (direction == 2)
+        {
+          // load the column into registers once, rather than reading every
+          // entry n_q_points_1d times from shared memory
+          Number column[n_q_points_1d];
+          for (int k=0; k<n_q_points_1d; ++k)
+            column[k] = in_place ? out[x + n_q_points_1d*(y + n_q_points_1d*k)] :
+                        in[x + n_q_points_1d*(y + n_q_points_1d*k)];
+          for (int q=0; q<n_q_points_1d; ++q)
+            {
+              t[q] = 0;
+              for (int k=0; k<n_q_points_1d; ++k)
+                {
+                  const unsigned int shape_idx = dof_to_quad ? (q+k*n_q_points_1d) :
+                                                 (k+q*n_q_points_1d);
+                  t[q] += shape_data[shape_idx] * column[k];
+                }
+            }
+        }
+      else
+        {
+          for (int z=0; z<n_q_points_1d; ++z)
+            {
+              t[z] = 0;
+              for (int k=0; k<n_q_points_1d; ++k)
+                {
+                  const unsigned int shape_idx = dof_to_quad ?
+                                                 ((direction == 0 ? x : y)+k*n_q_points_1d) :
+                                                 (k+(direction == 0 ? x : y)*n_q_points_1d);
+                  const unsigned int source_idx =
+                    (direction == 0) ? (k + n_q_points_1d*(y + n_q_points_1d*z)) :
+                    (x + n_q_points_1d*(k + n_q_points_1d*z));
+                  t[z] += shape_data[shape_idx] * (in_place ? out[source_idx] : in[source_idx]);
+                }
+            }
+
+          // The other threads of the cell read the entries of this layer
+          if (in_place)
+            __syncthreads();
+        }
+
+      for (int z=0; z<n_q_points_1d; ++z)
+        {
+          const unsigned int destination_idx = x + n_q_points_1d*(y + n_q_points_1d*z);
+          if (add)
+            out[destination_idx] += t[z];
+          else
+            out[destination_idx] = t[z];
+        }
+    }
+
+
+
     template <int dim, int fe_degree, int n_q_points_1d, typename Number>
     inline
     __device__ void EvaluatorTensorProduct<evaluate_general, dim, fe_degree,
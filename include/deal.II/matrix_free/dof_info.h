@@ -58,6 +58,35 @@ namespace internal
      */
     struct DoFInfo
     {
+      /**
+       * The storage formats for the indices of a cell batch that allow to
+       * skip the indirect addressing through @p dof_indices for cell batches
+       * without constraints whose indices follow a simple pattern.
+       */
+      enum class IndexStorageVariants : unsigned char
+      {
+        /**
+         * The indices are read from @p dof_indices.
+         */
+        full,
+        /**
+         * The indices of the cells in the batch are interleaved, i.e., the
+         * entry of degree of freedom <tt>i</tt> of lane <tt>v</tt> is
+         * <tt>first + i * vectorization_length + v</tt> with the index
+         * <tt>first</tt> of lane zero. The values of each degree of freedom
+         * can be loaded directly into a VectorizedArray. This is the layout
+         * of discontinuous elements after renumber_dofs().
+         */
+        interleaved,
+        /**
+         * The indices of each cell are contiguous, i.e., the entry of degree
+         * of freedom <tt>i</tt> of lane <tt>v</tt> is <tt>first_v + i</tt>
+         * with the first index <tt>first_v</tt> of that lane. This is the
+         * usual layout of discontinuous elements.
+         */
+        contiguous
+      };
+
       /**
        * Default empty constructor.
        */
@@ -214,6 +243,14 @@ namespace internal
       void guess_block_size (const SizeInfo &size_info,
                              TaskInfo       &task_info);
 
+      /**
+       * Detect the cell batches whose indices can be stored in one of the
+       * compressed formats of IndexStorageVariants and fill the fields @p
+       * index_storage_variants and @p dof_indices_contiguous. This must be
+       * called whenever @p dof_indices changes.
+       */
+      void compute_index_compression (const unsigned int vectorization_length);
+
       /**
        * This method goes through all cells that have been filled into @p
        * dof_indices and finds out which cells can be worked on independently
@@ -325,6 +362,20 @@ namespace internal
        */
       std::vector<unsigned int> dof_indices;
 
+      /**
+       * The storage format of the indices of each cell batch, see
+       * IndexStorageVariants.
+       */
+      std::vector<IndexStorageVariants> index_storage_variants;
+
+      /**
+       * For the cell batches with a compressed storage format, the index of
+       * the first degree of freedom of each lane, with @p
+       * vectorization_length entries per cell batch. For the other cell
+       * batches, the entries are numbers::invalid_unsigned_int.
+       */
+      std::vector<unsigned int> dof_indices_contiguous;
+
       /**
        * This variable describes the position of constraints in terms of the
        * local numbering of degrees of freedom on a cell. The first number
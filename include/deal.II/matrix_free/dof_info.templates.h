@@ -136,6 +136,8 @@ namespace internal
     {
       row_starts.clear();
       dof_indices.clear();
+      index_storage_variants.clear();
+      dof_indices_contiguous.clear();
       constraint_indicator.clear();
       vector_partitioner.reset();
       ghost_dofs.clear();
@@ -1850,6 +1852,52 @@ not_connect:
 
 
 
+    void
+    DoFInfo::compute_index_compression (const unsigned int vectorization_length)
+    {
+      const unsigned int n_macro_cells = row_starts.empty() ? 0 : row_starts.size()-1;
+      index_storage_variants.clear();
+      index_storage_variants.resize (n_macro_cells, IndexStorageVariants::full);
+      dof_indices_contiguous.clear();
+      dof_indices_contiguous.resize (n_macro_cells*vectorization_length,
+                                     numbers::invalid_unsigned_int);
+      if (dof_indices.empty())
+        return;
+
+      for (unsigned int cell=0; cell<n_macro_cells; ++cell)
+        {
+          // cells with constraints or with unfilled lanes keep the full
+          // indices
+          const unsigned int n_indices = row_length_indices(cell);
+          if (row_length_indicators(cell) > 0 || row_starts[cell][2] > 0 ||
+              n_indices == 0 || n_indices % vectorization_length != 0)
+            continue;
+
+          const unsigned int *indices = begin_indices(cell);
+          bool is_interleaved = true, is_contiguous = true;
+          for (unsigned int i=0; i<n_indices/vectorization_length; ++i)
+            for (unsigned int v=0; v<vectorization_length; ++v)
+              {
+                const unsigned int index = indices[i*vectorization_length+v];
+                if (index != indices[0] + i*vectorization_length + v)
+                  is_interleaved = false;
+                if (index != indices[v] + i)
+                  is_contiguous = false;
+              }
+
+          if (is_interleaved)
+            index_storage_variants[cell] = IndexStorageVariants::interleaved;
+          else if (is_contiguous)
+            index_storage_variants[cell] = IndexStorageVariants::contiguous;
+          else
+            continue;
+          for (unsigned int v=0; v<vectorization_length; ++v)
+            dof_indices_contiguous[cell*vectorization_length+v] = indices[v];
+        }
+    }
+
+
+
     void DoFInfo::renumber_dofs (std::vector<types::global_dof_index> &renumbering)
     {
       // first renumber all locally owned degrees of freedom
@@ -1905,6 +1953,8 @@ not_connect:
       std::size_t memory = sizeof(*this);
       memory += (row_starts.capacity()*sizeof(std::array<unsigned int,3>));
       memory += MemoryConsumption::memory_consumption (dof_indices);
+      memory += index_storage_variants.capacity()*sizeof(IndexStorageVariants);
+      memory += MemoryConsumption::memory_consumption (dof_indices_contiguous);
       memory += MemoryConsumption::memory_consumption (row_starts_plain_indices);
       memory += MemoryConsumption::memory_consumption (plain_dof_indices);
       memory += MemoryConsumption::memory_consumption (constraint_indicator);
@@ -171,9 +171,11 @@ namespace
     const int runtime_n_q_points_1d = shape_info.n_q_points_1d;
     if (runtime_n_q_points_1d == n_q_points_1d)
       {
-        if (n_q_points_1d == degree+1)
+        if (n_q_points_1d == degree+1 &&
+            shape_info.kernel_variant != internal::MatrixFreeFunctions::kernel_even_odd)
           {
-            if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation)
+            if (shape_info.kernel_variant == internal::MatrixFreeFunctions::kernel_default &&
+                shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation)
               internal::FEEvaluationImplCollocation<dim, degree, n_components, Number>
               ::evaluate(shape_info, values_dofs_actual, values_quad,
                          gradients_quad, hessians_quad, scratch_data,
@@ -207,9 +209,11 @@ namespace
     const int runtime_n_q_points_1d = shape_info.n_q_points_1d;
     if (runtime_n_q_points_1d == n_q_points_1d)
       {
-        if (n_q_points_1d == degree+1)
+        if (n_q_points_1d == degree+1 &&
+            shape_info.kernel_variant != internal::MatrixFreeFunctions::kernel_even_odd)
           {
-            if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation)
+            if (shape_info.kernel_variant == internal::MatrixFreeFunctions::kernel_default &&
+                shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation)
               internal::FEEvaluationImplCollocation<dim, degree, n_components, Number>
               ::integrate(shape_info, values_dofs_actual, values_quad,
                           gradients_quad, scratch_data,
@@ -249,8 +253,7 @@ namespace
                                     const bool               evaluate_gradients,
                                     const bool               evaluate_hessians)
   {
-    Assert(shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric||
-           shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation,
+    Assert(shape_info.element_type <= internal::MatrixFreeFunctions::tensor_symmetric,
            ExcInternalError());
     Factory<dim, n_components, Number>::evaluate
     (shape_info, values_dofs_actual, values_quad, gradients_quad, hessians_quad,
@@ -272,8 +275,7 @@ namespace
                                      const bool               integrate_values,
                                      const bool               integrate_gradients)
   {
-    Assert(shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric||
-           shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation,
+    Assert(shape_info.element_type <= internal::MatrixFreeFunctions::tensor_symmetric,
            ExcInternalError());
     Factory<dim, n_components, Number>::integrate
     (shape_info, values_dofs_actual, values_quad, gradients_quad,
@@ -292,6 +294,8 @@ namespace
  * Otherwise, we perform a runtime matching of the runtime parameters to find
  * the correct specialization. This matching currently supports
  * $0\leq fe\_degree \leq 9$ and $degree+1\leq n\_q\_points\_1d\leq fe\_degree+2$.
+ * Among the kernels that can evaluate a given element, the one set in
+ * ShapeInfo::kernel_variant is used.
  */
 template <int dim, int fe_degree, int n_q_points_1d, int n_components, typename Number>
 struct SelectEvaluator
@@ -396,7 +400,11 @@ SelectEvaluator<dim, fe_degree, n_q_points_1d, n_components, Number>::evaluate
 {
   Assert(fe_degree>=0  && n_q_points_1d>0, ExcInternalError());
 
+  const internal::MatrixFreeFunctions::KernelVariant variant = shape_info.kernel_variant;
+  Assert(shape_info.supports_kernel_variant(variant), ExcInternalError());
+
   if (fe_degree+1 == n_q_points_1d &&
+      variant == internal::MatrixFreeFunctions::kernel_default &&
       shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation)
     {
       internal::FEEvaluationImplCollocation<dim, fe_degree, n_components, Number>
@@ -405,14 +413,18 @@ SelectEvaluator<dim, fe_degree, n_q_points_1d, n_components, Number>::evaluate
                  evaluate_values, evaluate_gradients, evaluate_hessians);
     }
   else if (fe_degree+1 == n_q_points_1d &&
-           shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric)
+           ((variant == internal::MatrixFreeFunctions::kernel_default &&
+             shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric) ||
+            variant == internal::MatrixFreeFunctions::kernel_transform_to_collocation))
     {
       internal::FEEvaluationImplTransformToCollocation<dim, fe_degree, n_components, Number>
       ::evaluate(shape_info, values_dofs_actual, values_quad,
                  gradients_quad, hessians_quad, scratch_data,
                  evaluate_values, evaluate_gradients, evaluate_hessians);
     }
-  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric)
+  else if ((variant == internal::MatrixFreeFunctions::kernel_default &&
+            shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric) ||
+           variant == internal::MatrixFreeFunctions::kernel_even_odd)
     {
       internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_symmetric,
                dim, fe_degree, n_q_points_1d, n_components, Number>
@@ -436,7 +448,8 @@ SelectEvaluator<dim, fe_degree, n_q_points_1d, n_components, Number>::evaluate
                           gradients_quad, hessians_quad, scratch_data,
                           evaluate_values, evaluate_gradients, evaluate_hessians);
     }
-  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_general)
+  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_general ||
+           variant == internal::MatrixFreeFunctions::kernel_general)
     {
       internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_general,
                dim, fe_degree, n_q_points_1d, n_components, Number>
@@ -464,7 +477,11 @@ SelectEvaluator<dim, fe_degree, n_q_points_1d, n_components, Number>::integrate
 {
   Assert(fe_degree>=0  && n_q_points_1d>0, ExcInternalError());
 
+  const internal::MatrixFreeFunctions::KernelVariant variant = shape_info.kernel_variant;
+  Assert(shape_info.supports_kernel_variant(variant), ExcInternalError());
+
   if (fe_degree+1 == n_q_points_1d &&
+      variant == internal::MatrixFreeFunctions::kernel_default &&
       shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation)
     {
       internal::FEEvaluationImplCollocation<dim, fe_degree, n_components, Number>
@@ -473,14 +490,18 @@ SelectEvaluator<dim, fe_degree, n_q_points_1d, n_components, Number>::integrate
                   integrate_values, integrate_gradients);
     }
   else if (fe_degree+1 == n_q_points_1d &&
-           shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric)
+           ((variant == internal::MatrixFreeFunctions::kernel_default &&
+             shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric) ||
+            variant == internal::MatrixFreeFunctions::kernel_transform_to_collocation))
     {
       internal::FEEvaluationImplTransformToCollocation<dim, fe_degree, n_components, Number>
       ::integrate(shape_info, values_dofs_actual, values_quad,
                   gradients_quad, scratch_data,
                   integrate_values, integrate_gradients);
     }
-  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric)
+  else if ((variant == internal::MatrixFreeFunctions::kernel_default &&
+            shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric) ||
+           variant == internal::MatrixFreeFunctions::kernel_even_odd)
     {
       internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_symmetric,
                dim, fe_degree, n_q_points_1d, n_components, Number>
@@ -504,7 +525,8 @@ SelectEvaluator<dim, fe_degree, n_q_points_1d, n_components, Number>::integrate
                            gradients_quad, scratch_data,
                            integrate_values, integrate_gradients);
     }
-  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_general)
+  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_general ||
+           variant == internal::MatrixFreeFunctions::kernel_general)
     {
       internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_general,
                dim, fe_degree, n_q_points_1d, n_components, Number>
@@ -548,7 +570,8 @@ SelectEvaluator<dim, -1, dummy, n_components, Number>::evaluate
                           gradients_quad, hessians_quad, scratch_data,
                           evaluate_values, evaluate_gradients, evaluate_hessians);
     }
-  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_general)
+  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_general ||
+           shape_info.kernel_variant == internal::MatrixFreeFunctions::kernel_general)
     internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_general,
              dim, -1, 0, n_components, Number>
              ::evaluate(shape_info, values_dofs_actual, values_quad,
@@ -591,7 +614,8 @@ SelectEvaluator<dim, -1, dummy, n_components, Number>::integrate
                            gradients_quad, scratch_data,
                            integrate_values, integrate_gradients);
     }
-  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_general)
+  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_general ||
+           shape_info.kernel_variant == internal::MatrixFreeFunctions::kernel_general)
     internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_general,
              dim, -1, 0, n_components, Number>
              ::integrate(shape_info, values_dofs_actual, values_quad,
@@ -0,0 +1,225 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#ifndef dealii_matrix_free_face_info_h
+#define dealii_matrix_free_face_info_h
+
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/types.h>
+
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace MatrixFreeFunctions
+  {
+    /**
+     * Data type for the information about a batch of faces that are
+     * processed together in the lanes of a VectorizedArray. All faces in a
+     * batch have the same face number within the cell on the interior side,
+     * the same face number on the exterior side and, for faces at the
+     * boundary, the same boundary id.
+     *
+     * The cells adjacent to the faces are given as the index of the cell
+     * within the cell batches of MatrixFree, i.e., <tt>macro_cell *
+     * vectorization_width + lane</tt>. Lanes that are not filled because the
+     * number of faces is not divisible by the vectorization width hold the
+     * value numbers::invalid_unsigned_int.
+     */
+    template <int vectorization_width>
+    struct FaceToCells
+    {
+      /**
+       * Constructor. Mark all lanes as unused.
+       */
+      FaceToCells ();
+
+      /**
+       * Return the memory consumption of this object in bytes.
+       */
+      std::size_t memory_consumption () const;
+
+      /**
+       * The cells on the interior side of the faces, i.e., the cells whose
+       * outward normal vector is used on the face.
+       */
+      unsigned int cells_interior[vectorization_width];
+
+      /**
+       * The cells on the exterior side of the faces. For faces at the
+       * boundary, all entries are numbers::invalid_unsigned_int.
+       */
+      unsigned int cells_exterior[vectorization_width];
+
+      /**
+       * The number of the face within the interior cells, in the numbering
+       * of GeometryInfo.
+       */
+      unsigned char interior_face_no;
+
+      /**
+       * The number of the face within the exterior cells. For faces at the
+       * boundary, this is equal to interior_face_no.
+       */
+      unsigned char exterior_face_no;
+
+      /**
+       * The boundary id of faces at the boundary, and
+       * numbers::internal_face_boundary_id for inner faces.
+       */
+      types::boundary_id boundary_id;
+    };
+
+
+
+    /**
+     * The class that stores the connectivity between the faces and the cells
+     * of MatrixFree, grouped into batches of faces. The inner faces come
+     * first, followed by the faces at the boundary of the domain.
+     */
+    template <int vectorization_width>
+    struct FaceInfo
+    {
+      /**
+       * Constructor.
+       */
+      FaceInfo ();
+
+      /**
+       * Clear all data fields in this class.
+       */
+      void clear ();
+
+      /**
+       * Return the memory consumption of this class in bytes.
+       */
+      std::size_t memory_consumption () const;
+
+      /**
+       * The number of batches of inner faces.
+       */
+      unsigned int n_inner_face_batches;
+
+      /**
+       * The number of batches of faces at the boundary of the domain.
+       */
+      unsigned int n_boundary_face_batches;
+
+      /**
+       * The batches of faces, inner faces first.
+       */
+      std::vector<FaceToCells<vectorization_width> > faces;
+
+      /**
+       * The faces of the cell batches for the cell-centric loop, indexed by
+       * <tt>cell_batch * GeometryInfo<dim>::faces_per_cell + face_no</tt>.
+       * Here, FaceToCells::cells_interior holds the cells of the batch
+       * itself and FaceToCells::cells_exterior the neighbors across the
+       * faces, or numbers::invalid_unsigned_int for lanes at the boundary of
+       * the domain. Since a batch contains both inner and boundary faces,
+       * the boundary ids are stored per lane in faces_by_cells_boundary_id.
+       * Empty unless requested in MatrixFree::AdditionalData.
+       */
+      std::vector<FaceToCells<vectorization_width> > faces_by_cells;
+
+      /**
+       * The boundary ids of the faces in faces_by_cells with one entry per
+       * lane, i.e., indexed by <tt>(cell_batch *
+       * GeometryInfo<dim>::faces_per_cell + face_no) * vectorization_width +
+       * lane</tt>, and numbers::internal_face_boundary_id for faces in the
+       * interior of the domain.
+       */
+      std::vector<types::boundary_id> faces_by_cells_boundary_id;
+    };
+
+
+
+    /* ------------------- inline functions ----------------------------- */
+
+    template <int vectorization_width>
+    inline
+    FaceToCells<vectorization_width>::FaceToCells ()
+      :
+      interior_face_no (0),
+      exterior_face_no (0),
+      boundary_id (numbers::internal_face_boundary_id)
+    {
+      for (unsigned int v=0; v<vectorization_width; ++v)
+        {
+          cells_interior[v] = numbers::invalid_unsigned_int;
+          cells_exterior[v] = numbers::invalid_unsigned_int;
+        }
+    }
+
+
+
+    template <int vectorization_width>
+    inline
+    std::size_t
+    FaceToCells<vectorization_width>::memory_consumption () const
+    {
+      return sizeof (*this);
+    }
+
+
+
+    template <int vectorization_width>
+    inline
+    FaceInfo<vectorization_width>::FaceInfo ()
+      :
+      n_inner_face_batches (0),
+      n_boundary_face_batches (0)
+    {}
+
+
+
+    template <int vectorization_width>
+    inline
+    void
+    FaceInfo<vectorization_width>::clear ()
+    {
+      n_inner_face_batches = 0;
+      n_boundary_face_batches = 0;
+      faces.clear();
+      faces_by_cells.clear();
+      faces_by_cells_boundary_id.clear();
+    }
+
+
+
+    template <int vectorization_width>
+    inline
+    std::size_t
+    FaceInfo<vectorization_width>::memory_consumption () const
+    {
+      return MemoryConsumption::memory_consumption (faces) +
+             MemoryConsumption::memory_consumption (faces_by_cells) +
+             MemoryConsumption::memory_consumption (faces_by_cells_boundary_id) +
+             sizeof (*this);
+    }
+
+  } // end of namespace MatrixFreeFunctions
+} // end of namespace internal
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -53,6 +53,8 @@ namespace internal
 
 template <int dim, int fe_degree, int n_q_points_1d = fe_degree+1,
           int n_components_ = 1, typename Number = double > class FEEvaluation;
+template <int dim, int fe_degree, int n_q_points_1d = fe_degree+1,
+          int n_components_ = 1, typename Number = double > class FEFaceEvaluation;
 
 
 /**
@@ -201,6 +203,10 @@ public:
    * std::vector<VectorType> or std::vector<VectorType *>, this function reads
    * @p n_components blocks from the block vector starting at the index
    * @p first_index. For non-block vectors, @p first_index is ignored.
+   *
+   * The number type of the vector may differ from the number type @p Number
+   * of this class, e.g., a vector in double precision can be read into an
+   * evaluator in single precision. The values are then converted on the fly.
    */
   template <typename VectorType>
   void read_dof_values (const VectorType  &src,
@@ -260,6 +266,9 @@ public:
    * std::vector<VectorType> or std::vector<VectorType *>, this function
    * writes to @p n_components blocks of the block vector starting at the
    * index @p first_index. For non-block vectors, @p first_index is ignored.
+   *
+   * As for read_dof_values(), the number type of the vector may differ from
+   * the number type @p Number of this class.
    */
   template <typename VectorType>
   void distribute_local_to_global (VectorType        &dst,
@@ -944,6 +953,23 @@ protected:
    */
   mutable std::vector<types::global_dof_index> local_dof_indices;
 
+  /**
+   * The inverse Jacobians and JxW values on the present cell if they are
+   * computed on the fly, see MatrixFree::AdditionalData::compute_jacobians_on_the_fly.
+   */
+  AlignedVector<Tensor<2,dim,VectorizedArray<Number> > > jacobians_on_the_fly;
+
+  /**
+   * The JxW values on the present cell if they are computed on the fly.
+   */
+  AlignedVector<VectorizedArray<Number> > JxW_values_on_the_fly;
+
+  /**
+   * Temporary storage for evaluating the Jacobians on the fly from the
+   * support points of the mapping.
+   */
+  AlignedVector<VectorizedArray<Number> > geometry_scratch;
+
 private:
   /**
    * Sets the pointers for values, gradients, hessians to the central
@@ -951,6 +977,14 @@ private:
    */
   void set_data_pointers();
 
+  /**
+   * Compute the inverse Jacobians and JxW values on the present general cell
+   * from MappingInfo::geometry_nodes by interpolating the mapping with the
+   * sum factorization kernels, and set the pointers @p jacobian and @p
+   * J_value to them.
+   */
+  void compute_jacobians_on_the_fly();
+
   /**
    * Make other FEEvaluationBase as well as FEEvaluation objects friends.
    */
@@ -2063,6 +2097,358 @@ private:
 
 
 
+/**
+ * The class that provides the evaluation of finite element functions on the
+ * quadrature points of faces and the integration over faces, for use in the
+ * face and boundary operations of MatrixFree::loop() in discontinuous
+ * Galerkin methods. It is the face analogue of FEEvaluation: the object is
+ * initialized with a batch of faces through reinit(), reads the degrees of
+ * freedom of the cells on one side of the faces, the interior or the
+ * exterior side, and works on all faces in the batch at once through the
+ * lanes of VectorizedArray.
+ *
+ * The evaluation uses sum factorization as FEEvaluation does: the cell
+ * values are first interpolated to the face by a contraction in the
+ * direction normal to the face with the values and derivatives of the 1D
+ * shape functions at the end points of the unit interval, followed by a
+ * (dim-1)-dimensional tensor product evaluation on the face. The quadrature
+ * points are the (dim-1)-dimensional tensor product of the 1D quadrature
+ * formula given to MatrixFree, in the coordinate system of the face.
+ *
+ * A typical face operation for the interior penalty method reads:
+ * @code
+ * FEFaceEvaluation<dim,fe_degree> phi_inner (data, true), phi_outer (data, false);
+ * for (unsigned int face=face_range.first; face<face_range.second; ++face)
+ *   {
+ *     phi_inner.reinit (face);
+ *     phi_inner.read_dof_values (src);
+ *     phi_inner.evaluate (true, true);
+ *     phi_outer.reinit (face);
+ *     phi_outer.read_dof_values (src);
+ *     phi_outer.evaluate (true, true);
+ *     for (unsigned int q=0; q<phi_inner.n_q_points; ++q)
+ *       {
+ *         const VectorizedArray<double> jump =
+ *           phi_inner.get_value(q) - phi_outer.get_value(q);
+ *         const VectorizedArray<double> average_normal_derivative =
+ *           0.5 * (phi_inner.get_normal_derivative(q) +
+ *                  phi_outer.get_normal_derivative(q));
+ *         const VectorizedArray<double> flux =
+ *           jump * penalty - average_normal_derivative;
+ *         phi_inner.submit_value (flux, q);
+ *         phi_outer.submit_value (-flux, q);
+ *         phi_inner.submit_normal_derivative (-0.5 * jump, q);
+ *         phi_outer.submit_normal_derivative (-0.5 * jump, q);
+ *       }
+ *     phi_inner.integrate (true, true);
+ *     phi_inner.distribute_local_to_global (dst);
+ *     phi_outer.integrate (true, true);
+ *     phi_outer.distribute_local_to_global (dst);
+ *   }
+ * @endcode
+ *
+ * The normal vector returned by get_normal_vector() and used in
+ * get_normal_derivative() and submit_normal_derivative() always points out
+ * of the interior cell, also when evaluating on the exterior side.
+ *
+ * In MatrixFree::loop_cell_centric(), the objects are instead initialized
+ * with a cell batch and a face number through reinit(cell, face), and only
+ * the contribution to the cells of the batch is computed:
+ * @code
+ * for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+ *   {
+ *     phi.reinit (cell);
+ *     phi.read_dof_values (src);
+ *     ... // cell integrals, phi.integrate (false, true)
+ *     for (unsigned int face=0; face<GeometryInfo<dim>::faces_per_cell; ++face)
+ *       {
+ *         phi_inner.reinit (cell, face);
+ *         phi_outer.reinit (cell, face);
+ *         ... // as above, but only submit on phi_inner
+ *         phi_inner.integrate (true, true);
+ *         for (unsigned int i=0; i<phi.dofs_per_cell; ++i)
+ *           phi.begin_dof_values()[i] += phi_inner.begin_dof_values()[i];
+ *       }
+ *     phi.distribute_local_to_global (dst);
+ *   }
+ * @endcode
+ *
+ * The class is restricted to elements with a full tensor product basis of
+ * degree @p fe_degree in each component, such as FE_DGQ, on meshes where the
+ * faces are in standard orientation and connect cells of the same
+ * refinement level. Constraints on the degrees of freedom are not resolved.
+ *
+ * @tparam dim Dimension in which this class is to be used
+ *
+ * @tparam fe_degree Degree of the tensor product finite element with
+ * fe_degree+1 degrees of freedom per coordinate direction
+ *
+ * @tparam n_q_points_1d Number of points in the quadrature formula in 1D,
+ * defaults to fe_degree+1
+ *
+ * @tparam n_components Number of vector components of the finite element.
+ * Defaults to 1.
+ *
+ * @tparam Number Number format, usually @p double or @p float. Defaults to @p
+ * double
+ */
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number >
+class FEFaceEvaluation
+{
+public:
+  typedef Number number_type;
+  typedef typename std::conditional<n_components_==1, VectorizedArray<Number>,
+          Tensor<1,n_components_,VectorizedArray<Number> > >::type value_type;
+  typedef typename std::conditional<n_components_==1, Tensor<1,dim,VectorizedArray<Number> >,
+          Tensor<1,n_components_,Tensor<1,dim,VectorizedArray<Number> > > >::type gradient_type;
+  static constexpr unsigned int dimension     = dim;
+  static constexpr unsigned int n_components  = n_components_;
+  static constexpr unsigned int static_n_q_points    = Utilities::fixed_int_power<n_q_points_1d,dim-1>::value;
+  static constexpr unsigned int static_dofs_per_component = Utilities::fixed_int_power<fe_degree+1,dim>::value;
+  static constexpr unsigned int static_dofs_per_cell = static_dofs_per_component *n_components;
+
+  /**
+   * Constructor. Takes all data stored in MatrixFree, which must have been
+   * initialized with face data. The flag @p is_interior_face selects whether
+   * this object works on the cells on the interior side or on the exterior
+   * side of the faces. If applied to problems with more than one finite
+   * element or more than one quadrature formula selected during construction
+   * of @p matrix_free, @p fe_no and @p quad_no allow to select the
+   * appropriate components.
+   */
+  FEFaceEvaluation (const MatrixFree<dim,Number> &matrix_free,
+                    const bool                    is_interior_face = true,
+                    const unsigned int            fe_no   = 0,
+                    const unsigned int            quad_no = 0);
+
+  /**
+   * Destructor. Releases the scratch data.
+   */
+  ~FEFaceEvaluation ();
+
+  FEFaceEvaluation (const FEFaceEvaluation &) = delete;
+  FEFaceEvaluation &operator= (const FEFaceEvaluation &) = delete;
+
+  /**
+   * Initialize the data fields of this object to the given batch of faces,
+   * which is either an inner face batch in [0,
+   * MatrixFree::n_inner_face_batches()) or a boundary face batch after
+   * those. Boundary faces can only be evaluated on the interior side.
+   */
+  void reinit (const unsigned int face_batch_number);
+
+  /**
+   * Initialize the data fields of this object to face number @p face_number
+   * of the cells in the given cell batch, for use in
+   * MatrixFree::loop_cell_centric(). On the interior side, this object works
+   * on the cells of the batch, on the exterior side on their neighbors
+   * across the face. Lanes at the boundary of the domain have no neighbor
+   * and read zero values on the exterior side, see
+   * MatrixFree::get_faces_by_cells_boundary_id(). The normal vector points
+   * out of the cells of the batch.
+   */
+  void reinit (const unsigned int cell_batch_number,
+               const unsigned int face_number);
+
+  /**
+   * Return the number of the face within the cells on the side of the faces
+   * selected at construction, in the numbering of GeometryInfo.
+   */
+  unsigned int get_face_no () const;
+
+  /**
+   * Read the degrees of freedom of the cells adjacent to the current faces
+   * from the vector @p src.
+   */
+  template <typename VectorType>
+  void read_dof_values (const VectorType &src);
+
+  /**
+   * Add the values stored in the degrees of freedom of this object, as
+   * computed by integrate(), into the vector @p dst.
+   */
+  template <typename VectorType>
+  void distribute_local_to_global (VectorType &dst) const;
+
+  /**
+   * Evaluate the function values and the gradients of the finite element
+   * function given by the degrees of freedom at the quadrature points of the
+   * faces.
+   */
+  void evaluate (const bool evaluate_values,
+                 const bool evaluate_gradients);
+
+  /**
+   * Test the values and gradients submitted on the quadrature points by all
+   * the basis functions of the cells on the selected side and sum up the
+   * face integrals into the degrees of freedom of this object. The previous
+   * content of the degrees of freedom is overwritten.
+   */
+  void integrate (const bool integrate_values,
+                  const bool integrate_gradients);
+
+  /**
+   * Return the value of a finite element function at quadrature point
+   * number @p q_point after a call to evaluate().
+   */
+  value_type get_value (const unsigned int q_point) const;
+
+  /**
+   * Return the gradient in real coordinates of a finite element function at
+   * quadrature point number @p q_point after a call to evaluate().
+   */
+  gradient_type get_gradient (const unsigned int q_point) const;
+
+  /**
+   * Return the derivative of a finite element function in direction of the
+   * normal vector at quadrature point number @p q_point.
+   */
+  value_type get_normal_derivative (const unsigned int q_point) const;
+
+  /**
+   * Write a value to the field containing the values on quadrature points
+   * with component @p q_point, multiplied by the surface element and the
+   * quadrature weight, in order to test it by the values of all basis
+   * functions in integrate().
+   */
+  void submit_value (const value_type   val_in,
+                     const unsigned int q_point);
+
+  /**
+   * Write a gradient in real coordinates to the field containing the
+   * gradients on quadrature points with component @p q_point, in order to
+   * test it by the gradients of all basis functions in integrate().
+   */
+  void submit_gradient (const gradient_type grad_in,
+                        const unsigned int  q_point);
+
+  /**
+   * Write a value that is to be tested by the normal derivative of all basis
+   * functions in integrate(). Since this sets the gradient field, it cannot
+   * be combined with submit_gradient().
+   */
+  void submit_normal_derivative (const value_type   val_in,
+                                 const unsigned int q_point);
+
+  /**
+   * Return the unit normal vector at quadrature point number @p q_point,
+   * pointing out of the interior cell.
+   */
+  Tensor<1,dim,VectorizedArray<Number> >
+  get_normal_vector (const unsigned int q_point) const;
+
+  /**
+   * Return the surface element times the quadrature weight at quadrature
+   * point number @p q_point.
+   */
+  VectorizedArray<Number> JxW (const unsigned int q_point) const;
+
+  /**
+   * Return the quadrature point in real coordinates with number @p q_point.
+   * Only available if update_quadrature_points has been set in
+   * MatrixFree::AdditionalData for the faces.
+   */
+  Point<dim,VectorizedArray<Number> >
+  quadrature_point (const unsigned int q_point) const;
+
+  /**
+   * Return a pointer to the first entry of the degrees of freedom of this
+   * object, which are stored component by component in lexicographic order,
+   * with the faces of the batch in the lanes of VectorizedArray. This is the
+   * same layout as in FEEvaluation::begin_dof_values(), such that in
+   * MatrixFree::loop_cell_centric() the face integrals on the interior side
+   * can be added to the cell integrals before writing into the destination
+   * vector once.
+   */
+  VectorizedArray<Number> *begin_dof_values ();
+
+  /**
+   * The number of degrees of freedom of the cells on the selected side.
+   */
+  const unsigned int dofs_per_cell;
+
+  /**
+   * The number of quadrature points on a face.
+   */
+  const unsigned int n_q_points;
+
+private:
+  /**
+   * Apply the contraction between the cell and the face in direction normal
+   * to the face, where the direction is a run time argument.
+   */
+  template <bool dof_to_quad, bool add>
+  static void apply_face_kernel (const unsigned int             face_direction,
+                                 const VectorizedArray<Number> *shape_data,
+                                 const VectorizedArray<Number> *in,
+                                 VectorizedArray<Number>       *out);
+
+  /**
+   * A pointer to the MatrixFree object.
+   */
+  const MatrixFree<dim,Number> *matrix_info;
+
+  /**
+   * A pointer to the unit cell shape data.
+   */
+  const internal::MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number> > *data;
+
+  /**
+   * A pointer to the indices of the degrees of freedom.
+   */
+  const internal::MatrixFreeFunctions::DoFInfo *dof_info;
+
+  /**
+   * A pointer to the geometry data on the face batches and on the faces of
+   * the cell batches, respectively, or a null pointer if the respective data
+   * has not been set up.
+   */
+  const typename internal::MatrixFreeFunctions::MappingInfo<dim,Number>::FaceMappingData *mapping_data;
+  const typename internal::MatrixFreeFunctions::MappingInfo<dim,Number>::FaceMappingData *mapping_data_by_cells;
+
+  /**
+   * Whether this object works on the interior or the exterior side.
+   */
+  const bool is_interior_face;
+
+  /**
+   * The number of the current face batch, or the index of the current face
+   * of a cell batch within FaceInfo::faces_by_cells.
+   */
+  unsigned int face_batch;
+
+  /**
+   * The number of the current face within the cells.
+   */
+  unsigned int face_no;
+
+  /**
+   * The cells on the selected side of the faces in the current batch, as an
+   * index into the cell batches of MatrixFree.
+   */
+  unsigned int cells[VectorizedArray<Number>::n_array_elements];
+
+  /**
+   * Scratch data for the degrees of freedom, the values and gradients on
+   * quadrature points and temporary arrays of the evaluation, obtained from
+   * MatrixFree::acquire_scratch_data().
+   */
+  AlignedVector<VectorizedArray<Number> > *scratch_data_array;
+
+  VectorizedArray<Number> *values_dofs;
+  VectorizedArray<Number> *values_quad;
+  VectorizedArray<Number> *gradients_quad;
+  VectorizedArray<Number> *scratch_data;
+
+  const VectorizedArray<Number>                 *J_value;
+  const Tensor<1,dim,VectorizedArray<Number> >  *normal_vectors;
+  const Tensor<2,dim,VectorizedArray<Number> >  *jacobian;
+  const Point<dim,VectorizedArray<Number> >     *quadrature_points;
+};
+
+
+
 namespace internal
 {
   namespace MatrixFreeFunctions
@@ -2466,6 +2852,8 @@ FEEvaluationBase<dim,n_components_,Number>::reinit (const unsigned int cell_in)
       jacobian  = &mapping_info->affine_data[cell_data_number].first;
       J_value   = &mapping_info->affine_data[cell_data_number].second;
     }
+  else if (mapping_info->jacobians_on_the_fly == true)
+    compute_jacobians_on_the_fly();
   else
     {
       const unsigned int rowstart = mapping_info->
@@ -2504,6 +2892,72 @@ FEEvaluationBase<dim,n_components_,Number>::reinit (const unsigned int cell_in)
 
 
 
+template <int dim, int n_components_, typename Number>
+inline
+void
+FEEvaluationBase<dim,n_components_,Number>::compute_jacobians_on_the_fly ()
+{
+  const internal::MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number> > &geometry_shape_info
+    = mapping_info->mapping_data_gen[quad_no].geometry_shape_info[active_quad_index];
+  const unsigned int n_nodes = geometry_shape_info.dofs_per_component_on_cell;
+  const unsigned int n_q_points = geometry_shape_info.n_q_points;
+  AssertDimension (n_q_points, data->n_q_points);
+  AssertIndexRange ((cell_data_number+1)*n_nodes-1,
+                    mapping_info->geometry_nodes.size());
+
+  // the layout of the temporary array follows set_data_pointers(): the
+  // coordinates of the nodes, the values and gradients of the coordinates in
+  // the quadrature points (the values are needed as temporary array by some
+  // evaluation kernels), and the scratch data of the kernels
+  const unsigned int scratch_size = (n_nodes+1)*dim*3 + 2*n_q_points;
+  geometry_scratch.resize_fast (dim*n_nodes + dim*(dim+1)*n_q_points + scratch_size);
+  jacobians_on_the_fly.resize_fast (n_q_points);
+  JxW_values_on_the_fly.resize_fast (n_q_points);
+
+  VectorizedArray<Number> *nodes[dim];
+  VectorizedArray<Number> *values[dim];
+  VectorizedArray<Number> *gradients[dim][dim];
+  VectorizedArray<Number> *hessians[dim][(dim*(dim+1))/2];
+  for (unsigned int d=0; d<dim; ++d)
+    {
+      nodes[d] = geometry_scratch.begin() + d*n_nodes;
+      values[d] = geometry_scratch.begin() + dim*n_nodes + d*n_q_points;
+      for (unsigned int e=0; e<dim; ++e)
+        gradients[d][e] = geometry_scratch.begin() + dim*n_nodes +
+                          (dim+d*dim+e)*n_q_points;
+      for (unsigned int e=0; e<(dim*(dim+1))/2; ++e)
+        hessians[d][e] = nullptr;
+    }
+
+  const Point<dim,VectorizedArray<Number> > *cell_nodes =
+    &mapping_info->geometry_nodes[cell_data_number*n_nodes];
+  for (unsigned int i=0; i<n_nodes; ++i)
+    for (unsigned int d=0; d<dim; ++d)
+      nodes[d][i] = cell_nodes[i][d];
+
+  SelectEvaluator<dim,-1,0,dim,Number>::evaluate
+  (geometry_shape_info, nodes, values, gradients, hessians,
+   geometry_scratch.begin() + dim*n_nodes + dim*(dim+1)*n_q_points,
+   false, true, false);
+
+  // the gradient of coordinate d in direction e of the unit cell is the
+  // entry (d,e) of the Jacobian, which is transformed into the same format
+  // as MappingInfo::MappingInfoDependent::jacobians
+  for (unsigned int q=0; q<n_q_points; ++q)
+    {
+      Tensor<2,dim,VectorizedArray<Number> > jac;
+      for (unsigned int d=0; d<dim; ++d)
+        for (unsigned int e=0; e<dim; ++e)
+          jac[d][e] = gradients[d][e][q];
+      JxW_values_on_the_fly[q] = determinant(jac) * quadrature_weights[q];
+      jacobians_on_the_fly[q] = transpose(invert(jac));
+    }
+  jacobian = jacobians_on_the_fly.begin();
+  J_value = JxW_values_on_the_fly.begin();
+}
+
+
+
 template <int dim, int n_components_, typename Number>
 template <typename DoFHandlerType, bool level_dof_access>
 inline
@@ -2737,6 +3191,29 @@ namespace internal
         res[v] = vector_access(const_cast<const VectorType &>(vec), indices[v]);
     }
 
+    // variant for the entries index, index+1, ..., index+n_array_elements-1
+    // where VectorType::value_type is the same as Number -> can load directly
+    template <typename VectorType>
+    void process_dof_vectorized (const unsigned int       index,
+                                 VectorType              &vec,
+                                 VectorizedArray<Number> &res,
+                                 std::integral_constant<bool, true>) const
+    {
+      res.load(vec.begin() + index);
+    }
+
+    // variant for contiguous entries where VectorType::value_type is not the
+    // same as Number -> must manually load the data
+    template <typename VectorType>
+    void process_dof_vectorized (const unsigned int       index,
+                                 VectorType              &vec,
+                                 VectorizedArray<Number> &res,
+                                 std::integral_constant<bool, false>) const
+    {
+      for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+        res[v] = vector_access(const_cast<const VectorType &>(vec), index+v);
+    }
+
     template <typename VectorType>
     void process_dof_global (const types::global_dof_index index,
                              VectorType         &vec,
@@ -2818,6 +3295,33 @@ namespace internal
         vector_access(vec, indices[v]) += res[v];
     }
 
+    // variant for the entries index, index+1, ..., index+n_array_elements-1
+    // where VectorType::value_type is the same as Number -> can load and
+    // store directly
+    template <typename VectorType>
+    void process_dof_vectorized (const unsigned int       index,
+                                 VectorType              &vec,
+                                 VectorizedArray<Number> &res,
+                                 std::integral_constant<bool, true>) const
+    {
+      VectorizedArray<Number> tmp;
+      tmp.load(vec.begin() + index);
+      tmp += res;
+      tmp.store(vec.begin() + index);
+    }
+
+    // variant for contiguous entries where VectorType::value_type is not the
+    // same as Number -> must manually append all data
+    template <typename VectorType>
+    void process_dof_vectorized (const unsigned int       index,
+                                 VectorType              &vec,
+                                 VectorizedArray<Number> &res,
+                                 std::integral_constant<bool, false>) const
+    {
+      for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+        vector_access(vec, index+v) += res[v];
+    }
+
     template <typename VectorType>
     void process_dof_global (const types::global_dof_index index,
                              VectorType         &vec,
@@ -2883,6 +3387,25 @@ namespace internal
         vector_access(vec, indices[v]) = res[v];
     }
 
+    template <typename VectorType>
+    void process_dof_vectorized (const unsigned int       index,
+                                 VectorType              &vec,
+                                 VectorizedArray<Number> &res,
+                                 std::integral_constant<bool, true>) const
+    {
+      res.store(vec.begin() + index);
+    }
+
+    template <typename VectorType>
+    void process_dof_vectorized (const unsigned int       index,
+                                 VectorType              &vec,
+                                 VectorizedArray<Number> &res,
+                                 std::integral_constant<bool, false>) const
+    {
+      for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+        vector_access(vec, index+v) = res[v];
+    }
+
     template <typename VectorType>
     void process_dof_global (const types::global_dof_index index,
                              VectorType         &vec,
@@ -3119,11 +3642,46 @@ FEEvaluationBase<dim,n_components_,Number>
               // vectorization loop
               AssertDimension (dof_info->end_indices(cell)-dof_indices,
                                static_cast<int>(n_local_dofs));
-              for (unsigned int j=0, ind=0; j<dofs_per_component; ++j, ind += VectorizedArray<Number>::n_array_elements)
-                for (unsigned int comp=0; comp<n_components; ++comp)
-                  operation.process_dof_gather(dof_indices+ind,
-                                               *src[comp], values_dofs[comp][j],
-                                               std::integral_constant<bool, std::is_same<typename VectorType::value_type,Number>::value>());
+              typedef internal::MatrixFreeFunctions::DoFInfo::IndexStorageVariants IndexStorage;
+              const IndexStorage index_storage =
+                dof_info->index_storage_variants.empty() ? IndexStorage::full :
+                dof_info->index_storage_variants[cell];
+              const unsigned int *dof_indices_contiguous =
+                index_storage == IndexStorage::full ? nullptr :
+                &dof_info->dof_indices_contiguous[cell*VectorizedArray<Number>::n_array_elements];
+
+              // the entries of the cells are interleaved in the vector:
+              // load them directly
+              if (index_storage == IndexStorage::interleaved)
+                for (unsigned int j=0, ind=dof_indices_contiguous[0]; j<dofs_per_component;
+                     ++j, ind += VectorizedArray<Number>::n_array_elements)
+                  for (unsigned int comp=0; comp<n_components; ++comp)
+                    operation.process_dof_vectorized(ind, *src[comp], values_dofs[comp][j],
+                                                     std::integral_constant<bool, std::is_same<typename VectorType::value_type,Number>::value>());
+
+              // the entries of each cell are contiguous in the vector: only
+              // the first index of each cell is loaded
+              else if (index_storage == IndexStorage::contiguous)
+                {
+                  unsigned int indices[VectorizedArray<Number>::n_array_elements];
+                  for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+                    indices[v] = dof_indices_contiguous[v];
+                  for (unsigned int j=0; j<dofs_per_component; ++j)
+                    {
+                      for (unsigned int comp=0; comp<n_components; ++comp)
+                        operation.process_dof_gather(indices, *src[comp], values_dofs[comp][j],
+                                                     std::integral_constant<bool, std::is_same<typename VectorType::value_type,Number>::value>());
+                      for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+                        ++indices[v];
+                    }
+                }
+
+              else
+                for (unsigned int j=0, ind=0; j<dofs_per_component; ++j, ind += VectorizedArray<Number>::n_array_elements)
+                  for (unsigned int comp=0; comp<n_components; ++comp)
+                    operation.process_dof_gather(dof_indices+ind,
+                                                 *src[comp], values_dofs[comp][j],
+                                                 std::integral_constant<bool, std::is_same<typename VectorType::value_type,Number>::value>());
             }
         }
 
@@ -5439,6 +5997,689 @@ FEEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
 
 
 
+/*----------------------- FEFaceEvaluation ----------------------------------*/
+
+namespace internal
+{
+  // access to a component of the value and gradient types of
+  // FEFaceEvaluation, which are plain VectorizedArray and Tensor<1,dim>
+  // objects in the scalar case
+  template <typename Number>
+  inline
+  VectorizedArray<Number> &
+  face_value_component (VectorizedArray<Number> &value,
+                        const unsigned int)
+  {
+    return value;
+  }
+
+  template <int n_components, typename Number>
+  inline
+  VectorizedArray<Number> &
+  face_value_component (Tensor<1,n_components,VectorizedArray<Number> > &value,
+                        const unsigned int component)
+  {
+    return value[component];
+  }
+
+  template <int dim, typename Number>
+  inline
+  Tensor<1,dim,VectorizedArray<Number> > &
+  face_gradient_component (Tensor<1,dim,VectorizedArray<Number> > &gradient,
+                           const unsigned int)
+  {
+    return gradient;
+  }
+
+  template <int n_components, int dim, typename Number>
+  inline
+  Tensor<1,dim,VectorizedArray<Number> > &
+  face_gradient_component (Tensor<1,n_components,Tensor<1,dim,VectorizedArray<Number> > > &gradient,
+                           const unsigned int component)
+  {
+    return gradient[component];
+  }
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::FEFaceEvaluation (const MatrixFree<dim,Number> &data_in,
+                    const bool                    is_interior_face,
+                    const unsigned int            fe_no,
+                    const unsigned int            quad_no)
+  :
+  dofs_per_cell (static_dofs_per_cell),
+  n_q_points (static_n_q_points),
+  matrix_info (&data_in),
+  data (&data_in.get_shape_info(fe_no, quad_no)),
+  dof_info (&data_in.get_dof_info(fe_no)),
+  mapping_data (nullptr),
+  mapping_data_by_cells (nullptr),
+  is_interior_face (is_interior_face),
+  face_batch (numbers::invalid_unsigned_int),
+  face_no (numbers::invalid_unsigned_int),
+  scratch_data_array (data_in.acquire_scratch_data()),
+  J_value (nullptr),
+  normal_vectors (nullptr),
+  jacobian (nullptr),
+  quadrature_points (nullptr)
+{
+  static_assert (fe_degree >= 0,
+                 "FEFaceEvaluation needs the polynomial degree at compile time");
+
+  const internal::MatrixFreeFunctions::MappingInfo<dim,Number> &mapping_info =
+    data_in.get_mapping_info();
+  Assert (quad_no < mapping_info.face_data.size() ||
+          quad_no < mapping_info.face_data_by_cells.size(),
+          ExcMessage("The faces have not been set up in MatrixFree"));
+  if (quad_no < mapping_info.face_data.size() &&
+      mapping_info.face_data[quad_no].JxW_values.size() > 0)
+    {
+      mapping_data = &mapping_info.face_data[quad_no];
+      AssertDimension (mapping_data->n_q_points, static_n_q_points);
+    }
+  if (quad_no < mapping_info.face_data_by_cells.size())
+    {
+      mapping_data_by_cells = &mapping_info.face_data_by_cells[quad_no];
+      AssertDimension (mapping_data_by_cells->n_q_points, static_n_q_points);
+    }
+
+  Assert (data->element_type <= internal::MatrixFreeFunctions::tensor_general,
+          ExcNotImplemented("FEFaceEvaluation only supports elements with a "
+                            "full tensor product basis"));
+  AssertDimension (data->fe_degree, static_cast<unsigned int>(fe_degree));
+  AssertDimension (data->n_q_points_1d, static_cast<unsigned int>(n_q_points_1d));
+  AssertDimension (dof_info->n_components, n_components);
+  AssertDimension (dof_info->dofs_per_cell.size(), 1);
+  AssertDimension (dof_info->dofs_per_cell[0], static_dofs_per_cell);
+
+  for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+    cells[v] = numbers::invalid_unsigned_int;
+
+  // the face values and normal derivatives and the intermediate results of
+  // the tensor product evaluation on the face are stored behind the data
+  // that is visible to the user
+  const unsigned int n_max_1d = fe_degree+1 > n_q_points_1d ? fe_degree+1 : n_q_points_1d;
+  const unsigned int scratch_size = 4 * Utilities::fixed_power<dim-1>(n_max_1d);
+  scratch_data_array->resize_fast (static_dofs_per_cell +
+                                   (dim+1)*n_components*static_n_q_points +
+                                   scratch_size);
+  values_dofs = scratch_data_array->begin();
+  values_quad = values_dofs + static_dofs_per_cell;
+  gradients_quad = values_quad + n_components*static_n_q_points;
+  scratch_data = gradients_quad + n_components*dim*static_n_q_points;
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::~FEFaceEvaluation ()
+{
+  matrix_info->release_scratch_data (scratch_data_array);
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::reinit (const unsigned int face_batch_number)
+{
+  const internal::MatrixFreeFunctions::FaceToCells<VectorizedArray<Number>::n_array_elements>
+  &face_to_cells = matrix_info->get_face_info (face_batch_number);
+  Assert (is_interior_face == true ||
+          face_batch_number < matrix_info->n_inner_face_batches(),
+          ExcMessage("Boundary faces can only be evaluated on the interior side."));
+  Assert (mapping_data != nullptr,
+          ExcMessage("The face batches have not been set up in MatrixFree"));
+
+  face_batch = face_batch_number;
+  face_no = is_interior_face ? face_to_cells.interior_face_no :
+            face_to_cells.exterior_face_no;
+  for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+    cells[v] = is_interior_face ? face_to_cells.cells_interior[v] :
+               face_to_cells.cells_exterior[v];
+
+  const unsigned int offset = face_batch_number * static_n_q_points;
+  J_value = &mapping_data->JxW_values[offset];
+  normal_vectors = &mapping_data->normal_vectors[offset];
+  jacobian = mapping_data->jacobians[is_interior_face ? 0 : 1].empty() ?
+             nullptr :
+             &mapping_data->jacobians[is_interior_face ? 0 : 1][offset];
+  quadrature_points = mapping_data->quadrature_points.empty() ?
+                      nullptr : &mapping_data->quadrature_points[offset];
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::reinit (const unsigned int cell_batch_number,
+          const unsigned int face_number)
+{
+  const internal::MatrixFreeFunctions::FaceToCells<VectorizedArray<Number>::n_array_elements>
+  &face_to_cells = matrix_info->get_face_info_by_cells (cell_batch_number, face_number);
+  Assert (mapping_data_by_cells != nullptr,
+          ExcMessage("The faces of the cells have not been set up in MatrixFree"));
+
+  face_batch = cell_batch_number * GeometryInfo<dim>::faces_per_cell + face_number;
+  face_no = is_interior_face ? face_to_cells.interior_face_no :
+            face_to_cells.exterior_face_no;
+  for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+    cells[v] = is_interior_face ? face_to_cells.cells_interior[v] :
+               face_to_cells.cells_exterior[v];
+
+  const unsigned int offset = face_batch * static_n_q_points;
+  J_value = &mapping_data_by_cells->JxW_values[offset];
+  normal_vectors = &mapping_data_by_cells->normal_vectors[offset];
+  jacobian = mapping_data_by_cells->jacobians[is_interior_face ? 0 : 1].empty() ?
+             nullptr :
+             &mapping_data_by_cells->jacobians[is_interior_face ? 0 : 1][offset];
+  quadrature_points = mapping_data_by_cells->quadrature_points.empty() ?
+                      nullptr : &mapping_data_by_cells->quadrature_points[offset];
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+unsigned int
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::get_face_no () const
+{
+  Assert (face_batch != numbers::invalid_unsigned_int, ExcNotInitialized());
+  return face_no;
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+template <typename VectorType>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::read_dof_values (const VectorType &src)
+{
+  Assert (face_batch != numbers::invalid_unsigned_int, ExcNotInitialized());
+  internal::check_vector_compatibility (src, *dof_info);
+
+  const unsigned int vectorization_length = VectorizedArray<Number>::n_array_elements;
+  for (unsigned int v=0; v<vectorization_length; ++v)
+    {
+      if (cells[v] == numbers::invalid_unsigned_int)
+        {
+          for (unsigned int i=0; i<static_dofs_per_cell; ++i)
+            values_dofs[i][v] = Number();
+          continue;
+        }
+
+      // the indices of a macro cell are stored interleaved over the lanes
+      // that are filled
+      const unsigned int macro_cell = cells[v] / vectorization_length;
+      const unsigned int lane = cells[v] % vectorization_length;
+      Assert (dof_info->begin_indicators(macro_cell) ==
+              dof_info->end_indicators(macro_cell),
+              ExcNotImplemented("FEFaceEvaluation does not resolve constraints"));
+      const unsigned int n_filled = dof_info->row_starts[macro_cell][2] > 0 ?
+                                    dof_info->row_starts[macro_cell][2] :
+                                    vectorization_length;
+      const unsigned int *dof_indices = dof_info->begin_indices(macro_cell);
+      for (unsigned int i=0; i<static_dofs_per_cell; ++i)
+        values_dofs[i][v] = internal::vector_access (src, dof_indices[i*n_filled+lane]);
+    }
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+template <typename VectorType>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::distribute_local_to_global (VectorType &dst) const
+{
+  Assert (face_batch != numbers::invalid_unsigned_int, ExcNotInitialized());
+  internal::check_vector_compatibility (dst, *dof_info);
+
+  const unsigned int vectorization_length = VectorizedArray<Number>::n_array_elements;
+  for (unsigned int v=0; v<vectorization_length; ++v)
+    {
+      if (cells[v] == numbers::invalid_unsigned_int)
+        continue;
+
+      const unsigned int macro_cell = cells[v] / vectorization_length;
+      const unsigned int lane = cells[v] % vectorization_length;
+      Assert (dof_info->begin_indicators(macro_cell) ==
+              dof_info->end_indicators(macro_cell),
+              ExcNotImplemented("FEFaceEvaluation does not resolve constraints"));
+      const unsigned int n_filled = dof_info->row_starts[macro_cell][2] > 0 ?
+                                    dof_info->row_starts[macro_cell][2] :
+                                    vectorization_length;
+      const unsigned int *dof_indices = dof_info->begin_indices(macro_cell);
+      for (unsigned int i=0; i<static_dofs_per_cell; ++i)
+        internal::vector_access (dst, dof_indices[i*n_filled+lane]) += values_dofs[i][v];
+    }
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+template <bool dof_to_quad, bool add>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::apply_face_kernel (const unsigned int             face_direction,
+                     const VectorizedArray<Number> *shape_data,
+                     const VectorizedArray<Number> *in,
+                     VectorizedArray<Number>       *out)
+{
+  switch (face_direction)
+    {
+    case 0:
+      internal::apply_tensor_product_face<dim,fe_degree,VectorizedArray<Number>,0,dof_to_quad,add>
+      (shape_data, in, out);
+      break;
+    case 1:
+      internal::apply_tensor_product_face<dim,fe_degree,VectorizedArray<Number>,(dim>1?1:0),dof_to_quad,add>
+      (shape_data, in, out);
+      break;
+    case 2:
+      internal::apply_tensor_product_face<dim,fe_degree,VectorizedArray<Number>,(dim>2?2:0),dof_to_quad,add>
+      (shape_data, in, out);
+      break;
+    default:
+      Assert (false, ExcInternalError());
+    }
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::evaluate (const bool evaluate_values,
+            const bool evaluate_gradients)
+{
+  Assert (face_batch != numbers::invalid_unsigned_int, ExcNotInitialized());
+  Assert (evaluate_gradients == false || jacobian != nullptr,
+          ExcMessage("Gradients on faces need update_gradients in the face "
+                     "update flags of MatrixFree::AdditionalData"));
+
+  const unsigned int n_dofs_1d = fe_degree+1;
+  const unsigned int dofs_per_face = Utilities::fixed_int_power<fe_degree+1,dim-1>::value;
+  const unsigned int face_direction = face_no / 2;
+  const unsigned int side = face_no % 2;
+  const VectorizedArray<Number> *shape_data = data->shape_data_on_face[side].begin();
+
+  // the face values and the normal derivatives on the face, followed by two
+  // temporary arrays for the tensor product evaluation within the face
+  VectorizedArray<Number> *face_values = scratch_data;
+  VectorizedArray<Number> *face_normal_derivatives = scratch_data + dofs_per_face;
+  VectorizedArray<Number> *temp1 = face_normal_derivatives + dofs_per_face;
+  VectorizedArray<Number> *temp2 = temp1 + (scratch_data_array->end() - temp1)/2;
+
+  typedef internal::EvaluatorTensorProduct<internal::evaluate_general,dim-1,
+          fe_degree,n_q_points_1d,VectorizedArray<Number> > Eval;
+  const Eval eval (data->shape_values, data->shape_gradients, data->shape_hessians);
+
+  for (unsigned int c=0; c<n_components; ++c)
+    {
+      const VectorizedArray<Number> *dofs = values_dofs + c*static_dofs_per_component;
+      VectorizedArray<Number> *values = values_quad + c*static_n_q_points;
+      VectorizedArray<Number> *gradients = gradients_quad + c*dim*static_n_q_points;
+
+      // interpolate from the cell to the face in the normal direction
+      apply_face_kernel<true,false> (face_direction, shape_data, dofs, face_values);
+      if (evaluate_gradients)
+        apply_face_kernel<true,false> (face_direction, shape_data+n_dofs_1d,
+                                       dofs, face_normal_derivatives);
+
+      // evaluate within the face. the reference gradient is stored with the
+      // normal derivative first, followed by the derivatives along the face
+      // coordinates
+      if (dim == 1)
+        {
+          values[0] = face_values[0];
+          if (evaluate_gradients)
+            gradients[0] = face_normal_derivatives[0];
+        }
+      else if (dim == 2)
+        {
+          if (evaluate_values || evaluate_gradients)
+            eval.template values<0,true,false> (face_values, values);
+          if (evaluate_gradients)
+            {
+              eval.template values<0,true,false> (face_normal_derivatives,
+                                                  gradients);
+              eval.template gradients<0,true,false> (face_values,
+                                                     gradients+static_n_q_points);
+            }
+        }
+      else if (dim == 3)
+        {
+          eval.template values<0,true,false> (face_values, temp1);
+          eval.template values<(dim>2?1:0),true,false> (temp1, values);
+          if (evaluate_gradients)
+            {
+              eval.template gradients<(dim>2?1:0),true,false>
+              (temp1, gradients+2*static_n_q_points);
+              eval.template gradients<0,true,false> (face_values, temp2);
+              eval.template values<(dim>2?1:0),true,false>
+              (temp2, gradients+static_n_q_points);
+              eval.template values<0,true,false> (face_normal_derivatives, temp1);
+              eval.template values<(dim>2?1:0),true,false> (temp1, gradients);
+            }
+        }
+      else
+        Assert (false, ExcNotImplemented());
+    }
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::integrate (const bool integrate_values,
+             const bool integrate_gradients)
+{
+  Assert (face_batch != numbers::invalid_unsigned_int, ExcNotInitialized());
+
+  const unsigned int n_dofs_1d = fe_degree+1;
+  const unsigned int dofs_per_face = Utilities::fixed_int_power<fe_degree+1,dim-1>::value;
+  const unsigned int face_direction = face_no / 2;
+  const unsigned int side = face_no % 2;
+  const VectorizedArray<Number> *shape_data = data->shape_data_on_face[side].begin();
+
+  VectorizedArray<Number> *face_values = scratch_data;
+  VectorizedArray<Number> *face_normal_derivatives = scratch_data + dofs_per_face;
+  VectorizedArray<Number> *temp1 = face_normal_derivatives + dofs_per_face;
+  VectorizedArray<Number> *temp2 = temp1 + (scratch_data_array->end() - temp1)/2;
+
+  typedef internal::EvaluatorTensorProduct<internal::evaluate_general,dim-1,
+          fe_degree,n_q_points_1d,VectorizedArray<Number> > Eval;
+  const Eval eval (data->shape_values, data->shape_gradients, data->shape_hessians);
+
+  for (unsigned int c=0; c<n_components; ++c)
+    {
+      VectorizedArray<Number> *dofs = values_dofs + c*static_dofs_per_component;
+      const VectorizedArray<Number> *values = values_quad + c*static_n_q_points;
+      const VectorizedArray<Number> *gradients = gradients_quad + c*dim*static_n_q_points;
+
+      if (integrate_values == false && integrate_gradients == false)
+        {
+          for (unsigned int i=0; i<static_dofs_per_component; ++i)
+            dofs[i] = VectorizedArray<Number>();
+          continue;
+        }
+
+      // the transpose of the operations in evaluate(), where all the
+      // contributions to the face values are summed before going to the cell
+      if (dim == 1)
+        {
+          face_values[0] = integrate_values ? values[0] : VectorizedArray<Number>();
+          if (integrate_gradients)
+            face_normal_derivatives[0] = gradients[0];
+        }
+      else if (dim == 2)
+        {
+          if (integrate_values)
+            eval.template values<0,false,false> (values, face_values);
+          if (integrate_gradients)
+            {
+              if (integrate_values)
+                eval.template gradients<0,false,true> (gradients+static_n_q_points,
+                                                       face_values);
+              else
+                eval.template gradients<0,false,false> (gradients+static_n_q_points,
+                                                        face_values);
+              eval.template values<0,false,false> (gradients, face_normal_derivatives);
+            }
+        }
+      else if (dim == 3)
+        {
+          if (integrate_values)
+            {
+              eval.template values<(dim>2?1:0),false,false> (values, temp1);
+              if (integrate_gradients)
+                eval.template gradients<(dim>2?1:0),false,true>
+                (gradients+2*static_n_q_points, temp1);
+            }
+          else
+            eval.template gradients<(dim>2?1:0),false,false>
+            (gradients+2*static_n_q_points, temp1);
+          eval.template values<0,false,false> (temp1, face_values);
+          if (integrate_gradients)
+            {
+              eval.template values<(dim>2?1:0),false,false>
+              (gradients+static_n_q_points, temp2);
+              eval.template gradients<0,false,true> (temp2, face_values);
+              eval.template values<(dim>2?1:0),false,false> (gradients, temp1);
+              eval.template values<0,false,false> (temp1, face_normal_derivatives);
+            }
+        }
+      else
+        Assert (false, ExcNotImplemented());
+
+      apply_face_kernel<false,false> (face_direction, shape_data, face_values, dofs);
+      if (integrate_gradients)
+        apply_face_kernel<false,true> (face_direction, shape_data+n_dofs_1d,
+                                       face_normal_derivatives, dofs);
+    }
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+typename FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>::value_type
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::get_value (const unsigned int q_point) const
+{
+  AssertIndexRange (q_point, static_n_q_points);
+  value_type value;
+  for (unsigned int c=0; c<n_components; ++c)
+    internal::face_value_component (value, c) = values_quad[c*static_n_q_points+q_point];
+  return value;
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+typename FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>::gradient_type
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::get_gradient (const unsigned int q_point) const
+{
+  AssertIndexRange (q_point, static_n_q_points);
+  Assert (jacobian != nullptr, ExcNotInitialized());
+
+  // the reference gradient holds the derivative normal to the face in
+  // component zero and the derivatives along the face coordinates in the
+  // other components, which run cyclically through the coordinate
+  // directions after the normal one
+  const unsigned int face_direction = face_no / 2;
+  const Tensor<2,dim,VectorizedArray<Number> > &jac = jacobian[q_point];
+  gradient_type gradient;
+  for (unsigned int c=0; c<n_components; ++c)
+    {
+      const VectorizedArray<Number> *gradients =
+        gradients_quad + c*dim*static_n_q_points + q_point;
+      Tensor<1,dim,VectorizedArray<Number> > &grad_out =
+        internal::face_gradient_component (gradient, c);
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          grad_out[d] = jac[d][face_direction] * gradients[0];
+          for (unsigned int e=1; e<dim; ++e)
+            grad_out[d] += jac[d][(face_direction+e)%dim] * gradients[e*static_n_q_points];
+        }
+    }
+  return gradient;
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+typename FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>::value_type
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::get_normal_derivative (const unsigned int q_point) const
+{
+  gradient_type gradient = get_gradient (q_point);
+  value_type normal_derivative;
+  for (unsigned int c=0; c<n_components; ++c)
+    internal::face_value_component (normal_derivative, c) =
+      internal::face_gradient_component (gradient, c) * normal_vectors[q_point];
+  return normal_derivative;
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::submit_value (const value_type   val_in,
+                const unsigned int q_point)
+{
+  AssertIndexRange (q_point, static_n_q_points);
+  value_type value = val_in;
+  for (unsigned int c=0; c<n_components; ++c)
+    values_quad[c*static_n_q_points+q_point] =
+      internal::face_value_component (value, c) * J_value[q_point];
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::submit_gradient (const gradient_type grad_in,
+                   const unsigned int  q_point)
+{
+  AssertIndexRange (q_point, static_n_q_points);
+  Assert (jacobian != nullptr, ExcNotInitialized());
+
+  const unsigned int face_direction = face_no / 2;
+  const Tensor<2,dim,VectorizedArray<Number> > &jac = jacobian[q_point];
+  gradient_type gradient = grad_in;
+  for (unsigned int c=0; c<n_components; ++c)
+    {
+      const Tensor<1,dim,VectorizedArray<Number> > &grad =
+        internal::face_gradient_component (gradient, c);
+      VectorizedArray<Number> *gradients =
+        gradients_quad + c*dim*static_n_q_points + q_point;
+      for (unsigned int e=0; e<dim; ++e)
+        {
+          const unsigned int direction = (face_direction+e)%dim;
+          VectorizedArray<Number> sum = jac[0][direction] * grad[0];
+          for (unsigned int d=1; d<dim; ++d)
+            sum += jac[d][direction] * grad[d];
+          gradients[e*static_n_q_points] = sum * J_value[q_point];
+        }
+    }
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::submit_normal_derivative (const value_type   val_in,
+                            const unsigned int q_point)
+{
+  value_type value = val_in;
+  gradient_type gradient;
+  for (unsigned int c=0; c<n_components; ++c)
+    internal::face_gradient_component (gradient, c) =
+      internal::face_value_component (value, c) * normal_vectors[q_point];
+  submit_gradient (gradient, q_point);
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+Tensor<1,dim,VectorizedArray<Number> >
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::get_normal_vector (const unsigned int q_point) const
+{
+  AssertIndexRange (q_point, static_n_q_points);
+  return normal_vectors[q_point];
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+VectorizedArray<Number>
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::JxW (const unsigned int q_point) const
+{
+  AssertIndexRange (q_point, static_n_q_points);
+  return J_value[q_point];
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+Point<dim,VectorizedArray<Number> >
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::quadrature_point (const unsigned int q_point) const
+{
+  AssertIndexRange (q_point, static_n_q_points);
+  Assert (quadrature_points != nullptr,
+          ExcMessage("Quadrature points on faces need update_quadrature_points "
+                     "in the face update flags of MatrixFree::AdditionalData"));
+  return quadrature_points[q_point];
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+VectorizedArray<Number> *
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::begin_dof_values ()
+{
+  return values_dofs;
+}
+
+
+
 #endif  // ifndef DOXYGEN
 
 
@@ -0,0 +1,260 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#ifndef dealii_matrix_free_fe_evaluation_dispatcher_h
+#define dealii_matrix_free_fe_evaluation_dispatcher_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <type_traits>
+#include <utility>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  /**
+   * Compile-time loop over the polynomial degrees and numbers of quadrature
+   * points of FEEvaluationDispatcher. The combinations are visited in the
+   * order (degree, degree+1), ..., (degree, degree+1+n_extra_q_points),
+   * (degree+1, degree+2), and so on, until @p max_degree is exceeded, where
+   * the specialization below falls back to FEEvaluation with runtime degree.
+   */
+  template <int dim, int n_components, typename Number,
+            int max_degree, int n_extra_q_points, int degree, int n_q_points_1d,
+            typename enable = void>
+  struct FEEvaluationDispatcherImpl
+  {
+    static const bool last_n_q_points = (n_q_points_1d >= degree+1+n_extra_q_points);
+
+    typedef FEEvaluationDispatcherImpl<dim, n_components, Number, max_degree,
+            n_extra_q_points, (last_n_q_points ? degree+1 : degree),
+            (last_n_q_points ? degree+2 : n_q_points_1d+1)> Next;
+
+    template <typename Functor>
+    static void run (const dealii::MatrixFree<dim,Number> &matrix_free,
+                     const unsigned int            fe_no,
+                     const unsigned int            quad_no,
+                     const unsigned int            runtime_degree,
+                     const unsigned int            runtime_n_q_points_1d,
+                     Functor                      &functor)
+    {
+      if (runtime_degree == degree && runtime_n_q_points_1d == n_q_points_1d)
+        {
+          FEEvaluation<dim,degree,n_q_points_1d,n_components,Number>
+          fe_eval (matrix_free, fe_no, quad_no);
+          functor (fe_eval);
+        }
+      else
+        Next::run (matrix_free, fe_no, quad_no, runtime_degree,
+                   runtime_n_q_points_1d, functor);
+    }
+  };
+
+
+
+  /**
+   * End of the compile-time loop: none of the pre-instantiated combinations
+   * matched, so use FEEvaluation with runtime polynomial degree.
+   */
+  template <int dim, int n_components, typename Number,
+            int max_degree, int n_extra_q_points, int degree, int n_q_points_1d>
+  struct FEEvaluationDispatcherImpl<dim, n_components, Number, max_degree,
+    n_extra_q_points, degree, n_q_points_1d,
+    typename std::enable_if<(degree > max_degree)>::type>
+  {
+    template <typename Functor>
+    static void run (const dealii::MatrixFree<dim,Number> &matrix_free,
+                     const unsigned int            fe_no,
+                     const unsigned int            quad_no,
+                     const unsigned int ,
+                     const unsigned int ,
+                     Functor                      &functor)
+    {
+      FEEvaluation<dim,-1,0,n_components,Number> fe_eval (matrix_free, fe_no, quad_no);
+      functor (fe_eval);
+    }
+  };
+}
+
+
+
+/**
+ * A utility to call a function that works on an FEEvaluation object with
+ * template arguments that match the polynomial degree and the number of 1D
+ * quadrature points of a MatrixFree object selected at run time. For all
+ * degrees between @p min_degree and @p max_degree and between degree+1 and
+ * degree+1+@p n_extra_q_points quadrature points, the function is
+ * instantiated with the respective FEEvaluation such that the sum
+ * factorization kernels are fully specialized. For other combinations, the
+ * function is called with FEEvaluation<dim,-1,0,n_components,Number>, which
+ * selects the kernels at run time and is considerably slower.
+ *
+ * The function @p functor is called with a reference to the FEEvaluation
+ * object as only argument, so it has to accept FEEvaluation objects of
+ * different types, e.g. a lambda with an @p auto argument or a class with a
+ * templated operator(). As the dispatch involves some branches, it is
+ * typically placed around the loop over the cells of a range in the cell
+ * operation passed to MatrixFree::cell_loop(), rather than inside it:
+ * @code
+ * void local_apply (const MatrixFree<dim,double> &data,
+ *                   VectorType &dst,
+ *                   const VectorType &src,
+ *                   const std::pair<unsigned int,unsigned int> &cell_range) const
+ * {
+ *   FEEvaluationDispatcher<dim,1,double>::run
+ *   (data, 0, 0, [&](auto &phi)
+ *   {
+ *     for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+ *       {
+ *         phi.reinit (cell);
+ *         phi.read_dof_values (src);
+ *         phi.evaluate (false, true);
+ *         for (unsigned int q=0; q<phi.n_q_points; ++q)
+ *           phi.submit_gradient (phi.get_gradient(q), q);
+ *         phi.integrate (false, true);
+ *         phi.distribute_local_to_global (dst);
+ *       }
+ *   });
+ * }
+ * @endcode
+ *
+ * Since the functor is instantiated for all combinations in the range, the
+ * compile time grows with the size of the range, which should therefore be
+ * restricted to the degrees an application actually uses. The number of
+ * components is a template argument of this class because it is usually
+ * known at compile time; use one dispatcher per number of components
+ * otherwise.
+ */
+template <int dim, int n_components, typename Number,
+          int min_degree = 1, int max_degree = 8, int n_extra_q_points = 1>
+struct FEEvaluationDispatcher
+{
+  static_assert (min_degree >= 0 && n_extra_q_points >= 0,
+                 "Invalid range of degrees or quadrature points");
+
+  /**
+   * Query the polynomial degree and the number of 1D quadrature points of
+   * the finite element @p fe_no and the quadrature formula @p quad_no from
+   * @p matrix_free, construct an FEEvaluation object with the matching
+   * template arguments and call @p functor with it.
+   */
+  template <typename Functor>
+  static void run (const MatrixFree<dim,Number> &matrix_free,
+                   const unsigned int            fe_no,
+                   const unsigned int            quad_no,
+                   Functor                     &&functor);
+
+  /**
+   * Same as above for the hp case, where the polynomial degree and the
+   * quadrature formula are those of the given active FE index and active
+   * quadrature index, e.g. the index passed to the cell operation by
+   * MatrixFree::cell_loop_by_fe_index(). As FEEvaluation with runtime degree
+   * always works on the first FE index, combinations that are not
+   * pre-instantiated are only supported for index zero.
+   */
+  template <typename Functor>
+  static void run (const MatrixFree<dim,Number> &matrix_free,
+                   const unsigned int            fe_no,
+                   const unsigned int            quad_no,
+                   const unsigned int            active_fe_index,
+                   const unsigned int            active_quad_index,
+                   Functor                     &&functor);
+
+  /**
+   * Return whether the given combination of polynomial degree and number of
+   * 1D quadrature points is pre-instantiated, i.e., does not use the
+   * FEEvaluation with runtime degree.
+   */
+  static bool is_specialized (const unsigned int fe_degree,
+                              const unsigned int n_q_points_1d);
+};
+
+
+
+/* ------------------------- inline functions --------------------------- */
+
+#ifndef DOXYGEN
+
+template <int dim, int n_components, typename Number,
+          int min_degree, int max_degree, int n_extra_q_points>
+template <typename Functor>
+inline
+void
+FEEvaluationDispatcher<dim,n_components,Number,min_degree,max_degree,n_extra_q_points>
+::run (const MatrixFree<dim,Number> &matrix_free,
+       const unsigned int            fe_no,
+       const unsigned int            quad_no,
+       Functor                     &&functor)
+{
+  run (matrix_free, fe_no, quad_no, 0, 0, functor);
+}
+
+
+
+template <int dim, int n_components, typename Number,
+          int min_degree, int max_degree, int n_extra_q_points>
+template <typename Functor>
+inline
+void
+FEEvaluationDispatcher<dim,n_components,Number,min_degree,max_degree,n_extra_q_points>
+::run (const MatrixFree<dim,Number> &matrix_free,
+       const unsigned int            fe_no,
+       const unsigned int            quad_no,
+       const unsigned int            active_fe_index,
+       const unsigned int            active_quad_index,
+       Functor                     &&functor)
+{
+  const internal::MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number> > &shape_info
+    = matrix_free.get_shape_info (fe_no, quad_no, active_fe_index, active_quad_index);
+  AssertThrow (active_fe_index == 0 ||
+               is_specialized (shape_info.fe_degree, shape_info.n_q_points_1d),
+               ExcNotImplemented ("FEEvaluation with runtime degree is only "
+                                  "available for the first hp index"));
+  internal::FEEvaluationDispatcherImpl<dim, n_components, Number, max_degree,
+           n_extra_q_points, min_degree, min_degree+1>
+           ::run (matrix_free, fe_no, quad_no, shape_info.fe_degree,
+                  shape_info.n_q_points_1d, functor);
+}
+
+
+
+template <int dim, int n_components, typename Number,
+          int min_degree, int max_degree, int n_extra_q_points>
+inline
+bool
+FEEvaluationDispatcher<dim,n_components,Number,min_degree,max_degree,n_extra_q_points>
+::is_specialized (const unsigned int fe_degree,
+                  const unsigned int n_q_points_1d)
+{
+  return (fe_degree >= static_cast<unsigned int>(min_degree) &&
+          fe_degree <= static_cast<unsigned int>(max_degree) &&
+          n_q_points_1d >= fe_degree+1 &&
+          n_q_points_1d <= fe_degree+1+n_extra_q_points);
+}
+
+#endif // ifndef DOXYGEN
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,635 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#ifndef dealii_matrix_free_laplace_beltrami_operator_h
+#define dealii_matrix_free_laplace_beltrami_operator_h
+
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/matrix_free/evaluation_selector.h>
+#include <deal.II/matrix_free/shape_info.h>
+
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace MatrixFreeOperators
+{
+  /**
+   * A matrix-free implementation of the operator $a M + K$ on a surface
+   * mesh of codimension one, i.e., for a DoFHandler<dim,dim+1>, where $K$
+   * is the discretization of the Laplace-Beltrami operator
+   * $-\Delta_\Gamma$ with the bilinear form $(\nabla_\Gamma u,
+   * \nabla_\Gamma v)_\Gamma$ and $M$ is the mass matrix on the surface
+   * $\Gamma$. The factor $a$ is zero unless set by set_mass_factor(), as
+   * for example for the implicit time stepping of surface diffusion.
+   *
+   * MatrixFree and FEEvaluation are restricted to meshes with
+   * <tt>dim==spacedim</tt>. For a surface mesh, the geometry enters the
+   * bilinear form only through the metric tensor $G = J^T J$ of the
+   * $(dim+1)\times dim$ Jacobian $J$ of the mapping, by
+   * @f[
+   *   (\nabla_\Gamma u, \nabla_\Gamma v)_\Gamma = \sum_K \sum_q
+   *   \hat{\nabla} u(\hat{x}_q)^T \, G^{-1}(\hat{x}_q) \,
+   *   \hat{\nabla} v(\hat{x}_q) \, \sqrt{\det G(\hat{x}_q)} \, w_q,
+   * @f]
+   * where $\hat\nabla$ are the derivatives on the <tt>dim</tt>-dimensional
+   * unit cell. This class precomputes the symmetric tensor $\sqrt{\det G}
+   * G^{-1} w_q$ at all quadrature points in reinit() and evaluates the
+   * derivatives on the unit cell with the same sum factorization kernels as
+   * FEEvaluation, working on VectorizedArray::n_array_elements cells at
+   * once.
+   *
+   * The finite element needs to be an FE_Q<dim,dim+1> of degree @p fe_degree.
+   * Like the operators built on MatrixFree, the constrained degrees of
+   * freedom are eliminated from the operator: the entries of the source
+   * vector at these degrees of freedom are replaced according to the
+   * homogeneous part of the constraints before the operator is applied, the
+   * contributions to them are distributed to the degrees of freedom they
+   * are constrained to, and the operator acts as the identity on them.
+   *
+   * The cells are worked on one batch after the other, so the application of
+   * the operator does not use threads. The vectors need to provide access to
+   * all degrees of freedom through <tt>operator()</tt>, such as Vector or
+   * LinearAlgebra::distributed::Vector on a single process.
+   *
+   * @ingroup matrixfree
+   */
+  template <int dim, int fe_degree, int n_q_points_1d = fe_degree+1, typename Number = double>
+  class LaplaceBeltramiOperator : public Subscriptor
+  {
+  public:
+    /**
+     * Number alias.
+     */
+    typedef Number value_type;
+
+    /**
+     * size_type needed for preconditioner classes.
+     */
+    typedef types::global_dof_index size_type;
+
+    /**
+     * Constructor.
+     */
+    LaplaceBeltramiOperator ();
+
+    /**
+     * Compute the metric terms of all cells of @p dof_handler with
+     * @p mapping, and store the indices of the degrees of freedom of the
+     * cells and the constraints @p constraints. The quadrature is the Gauss
+     * formula with @p n_q_points_1d points in each direction.
+     */
+    void reinit (const Mapping<dim,dim+1>     &mapping,
+                 const DoFHandler<dim,dim+1>  &dof_handler,
+                 const ConstraintMatrix       &constraints);
+
+    /**
+     * Release all memory and return to a state just like after having called
+     * the default constructor.
+     */
+    void clear ();
+
+    /**
+     * Set the factor $a$ of the mass matrix in the operator $a M + K$.
+     */
+    void set_mass_factor (const Number factor);
+
+    /**
+     * Return the number of rows of the operator, i.e., the number of degrees
+     * of freedom.
+     */
+    size_type m () const;
+
+    /**
+     * Return the number of columns of the operator, i.e., the number of
+     * degrees of freedom.
+     */
+    size_type n () const;
+
+    /**
+     * Matrix-vector multiplication.
+     */
+    template <typename VectorType>
+    void vmult (VectorType       &dst,
+                const VectorType &src) const;
+
+    /**
+     * Transpose matrix-vector multiplication. Since the operator is
+     * symmetric, this is the same as vmult().
+     */
+    template <typename VectorType>
+    void Tvmult (VectorType       &dst,
+                 const VectorType &src) const;
+
+    /**
+     * Adding matrix-vector multiplication.
+     */
+    template <typename VectorType>
+    void vmult_add (VectorType       &dst,
+                    const VectorType &src) const;
+
+    /**
+     * Compute the diagonal of the operator into @p diagonal, for example for
+     * the use in a DiagonalMatrix as a Jacobi preconditioner or within
+     * PreconditionChebyshev. The diagonal entries of the constrained degrees
+     * of freedom are set to one, and the couplings through hanging node
+     * constraints are neglected, as in the other operators of this
+     * namespace.
+     */
+    template <typename VectorType>
+    void compute_diagonal (VectorType &diagonal) const;
+
+    /**
+     * Return the memory consumption of this object in bytes.
+     */
+    std::size_t memory_consumption () const;
+
+  private:
+    /**
+     * The number of degrees of freedom per cell.
+     */
+    static const unsigned int dofs_per_cell = Utilities::fixed_int_power<fe_degree+1,dim>::value;
+
+    /**
+     * The number of quadrature points per cell.
+     */
+    static const unsigned int n_q_points = Utilities::fixed_int_power<n_q_points_1d,dim>::value;
+
+    /**
+     * The number of entries of the geometry data per quadrature point: the
+     * upper triangle of the symmetric tensor $\sqrt{\det G} G^{-1} w_q$
+     * followed by $\sqrt{\det G} w_q$.
+     */
+    static const unsigned int n_geometry_entries = (dim*(dim+1))/2 + 1;
+
+    /**
+     * Apply the operator on the cell batch @p batch to the degrees of freedom
+     * stored at the beginning of @p scratch, overwriting them with the
+     * result. The array @p scratch needs to be of the size returned by
+     * scratch_size().
+     */
+    void apply_on_batch (const unsigned int       batch,
+                         VectorizedArray<Number> *scratch) const;
+
+    /**
+     * The size of the scratch array of apply_on_batch().
+     */
+    unsigned int scratch_size () const;
+
+    /**
+     * Read the values of the vector @p src at the degrees of freedom of the
+     * cell batch @p batch into @p values_dofs, resolving the constraints.
+     */
+    template <typename VectorType>
+    void read_dof_values (const unsigned int       batch,
+                          const VectorType        &src,
+                          VectorizedArray<Number> *values_dofs) const;
+
+    /**
+     * Add the values @p values_dofs to the vector @p dst at the degrees of
+     * freedom of the cell batch @p batch, distributing the contributions to
+     * constrained degrees of freedom.
+     */
+    template <typename VectorType>
+    void distribute_local_to_global (const unsigned int             batch,
+                                     const VectorizedArray<Number> *values_dofs,
+                                     VectorType                    &dst) const;
+
+    /**
+     * The shape functions and their derivatives on the unit cell.
+     */
+    internal::MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number> > shape_info;
+
+    /**
+     * The geometry data at all quadrature points of all cell batches.
+     */
+    AlignedVector<VectorizedArray<Number> > geometry_data;
+
+    /**
+     * The degrees of freedom of the cells in lexicographic order, stored by
+     * cell batch, then degree of freedom within the cell, then lane of the
+     * vectorized array. The lanes of the last batch that do not correspond
+     * to a cell are marked by numbers::invalid_dof_index.
+     */
+    std::vector<types::global_dof_index> dof_indices;
+
+    /**
+     * The number of cell batches.
+     */
+    unsigned int n_batches;
+
+    /**
+     * The number of degrees of freedom.
+     */
+    types::global_dof_index n_dofs;
+
+    /**
+     * The constrained degrees of freedom.
+     */
+    std::vector<types::global_dof_index> constrained_dofs;
+
+    /**
+     * The constraints passed to reinit().
+     */
+    SmartPointer<const ConstraintMatrix,LaplaceBeltramiOperator<dim,fe_degree,n_q_points_1d,Number> > constraints;
+
+    /**
+     * The factor of the mass matrix.
+     */
+    Number mass_factor;
+
+    /**
+     * Scratch data for the cell operations.
+     */
+    mutable AlignedVector<VectorizedArray<Number> > scratch_data;
+  };
+
+
+
+  /* ------------------------------ inline functions ----------------------- */
+
+#ifndef DOXYGEN
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename Number>
+  LaplaceBeltramiOperator<dim,fe_degree,n_q_points_1d,Number>::LaplaceBeltramiOperator ()
+    :
+    n_batches (0),
+    n_dofs (0),
+    mass_factor (0.)
+  {}
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename Number>
+  void
+  LaplaceBeltramiOperator<dim,fe_degree,n_q_points_1d,Number>::clear ()
+  {
+    shape_info = internal::MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number> >();
+    geometry_data.clear();
+    dof_indices.clear();
+    constrained_dofs.clear();
+    scratch_data.clear();
+    constraints = nullptr;
+    n_batches = 0;
+    n_dofs = 0;
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename Number>
+  void
+  LaplaceBeltramiOperator<dim,fe_degree,n_q_points_1d,Number>
+  ::reinit (const Mapping<dim,dim+1>     &mapping,
+            const DoFHandler<dim,dim+1>  &dof_handler,
+            const ConstraintMatrix       &constraints_in)
+  {
+    const FiniteElement<dim,dim+1> &fe = dof_handler.get_fe();
+    Assert ((dynamic_cast<const FE_Q<dim,dim+1> *>(&fe) != nullptr),
+            ExcMessage ("This operator is only implemented for FE_Q elements."));
+    AssertDimension (fe.degree, fe_degree);
+
+    // the shape functions on the unit cell are the same for all spacedim,
+    // so they are computed with the element of the same degree in dim
+    // dimensions, which needs to have the same support points
+    const FE_Q<dim> fe_unit_cell (fe_degree);
+    Assert (fe_unit_cell.get_unit_support_points() == fe.get_unit_support_points(),
+            ExcMessage ("The support points of the element need to be the "
+                        "Gauss-Lobatto points used by FE_Q by default."));
+    const QGauss<1> quadrature_1d (n_q_points_1d);
+    shape_info.reinit (quadrature_1d, fe_unit_cell);
+
+    constraints = &constraints_in;
+    n_dofs = dof_handler.n_dofs();
+    constrained_dofs.clear();
+    for (types::global_dof_index i=0; i<n_dofs; ++i)
+      if (constraints_in.is_constrained (i))
+        constrained_dofs.push_back (i);
+
+    const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+    const unsigned int n_cells = dof_handler.get_triangulation().n_active_cells();
+    n_batches = (n_cells + n_lanes - 1) / n_lanes;
+
+    dof_indices.assign (n_batches * dofs_per_cell * n_lanes, numbers::invalid_dof_index);
+    geometry_data.resize_fast (n_batches * n_q_points * n_geometry_entries);
+    for (unsigned int i=0; i<geometry_data.size(); ++i)
+      geometry_data[i] = Number();
+
+    FEValues<dim,dim+1> fe_values (mapping, fe, QGauss<dim>(n_q_points_1d),
+                                   update_jacobians | update_JxW_values);
+    std::vector<types::global_dof_index> local_dof_indices (fe.dofs_per_cell);
+
+    unsigned int cell_index = 0;
+    for (const auto &cell : dof_handler.active_cell_iterators())
+      {
+        const unsigned int batch = cell_index / n_lanes;
+        const unsigned int lane = cell_index % n_lanes;
+
+        cell->get_dof_indices (local_dof_indices);
+        for (unsigned int i=0; i<dofs_per_cell; ++i)
+          dof_indices[(batch*dofs_per_cell + i)*n_lanes + lane]
+            = local_dof_indices[shape_info.lexicographic_numbering[i]];
+
+        fe_values.reinit (cell);
+        for (unsigned int q=0; q<n_q_points; ++q)
+          {
+            const DerivativeForm<1,dim,dim+1> &jacobian = fe_values.jacobian (q);
+            Tensor<2,dim> metric;
+            for (unsigned int d=0; d<dim; ++d)
+              for (unsigned int e=0; e<dim; ++e)
+                for (unsigned int s=0; s<dim+1; ++s)
+                  metric[d][e] += jacobian[s][d] * jacobian[s][e];
+            const Tensor<2,dim> coefficient = fe_values.JxW (q) * invert (metric);
+
+            VectorizedArray<Number> *data
+              = &geometry_data[(batch*n_q_points + q)*n_geometry_entries];
+            for (unsigned int d=0, c=0; d<dim; ++d)
+              for (unsigned int e=d; e<dim; ++e, ++c)
+                data[c][lane] = coefficient[d][e];
+            data[n_geometry_entries-1][lane] = fe_values.JxW (q);
+          }
+        ++cell_index;
+      }
+
+    scratch_data.resize_fast (scratch_size());
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename Number>
+  inline
+  void
+  LaplaceBeltramiOperator<dim,fe_degree,n_q_points_1d,Number>::set_mass_factor (const Number factor)
+  {
+    mass_factor = factor;
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename Number>
+  inline
+  typename LaplaceBeltramiOperator<dim,fe_degree,n_q_points_1d,Number>::size_type
+  LaplaceBeltramiOperator<dim,fe_degree,n_q_points_1d,Number>::m () const
+  {
+    return n_dofs;
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename Number>
+  inline
+  typename LaplaceBeltramiOperator<dim,fe_degree,n_q_points_1d,Number>::size_type
+  LaplaceBeltramiOperator<dim,fe_degree,n_q_points_1d,Number>::n () const
+  {
+    return n_dofs;
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename Number>
+  inline
+  unsigned int
+  LaplaceBeltramiOperator<dim,fe_degree,n_q_points_1d,Number>::scratch_size () const
+  {
+    // the dof values, the values and reference gradients in quadrature
+    // points, and the scratch space of the sum factorization kernels, sized
+    // as in FEEvaluationBase
+    return dofs_per_cell + (dim+1) * n_q_points +
+           (dofs_per_cell+1) * 3 + 2 * n_q_points;
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename Number>
+  void
+  LaplaceBeltramiOperator<dim,fe_degree,n_q_points_1d,Number>
+  ::apply_on_batch (const unsigned int       batch,
+                    VectorizedArray<Number> *scratch) const
+  {
+    VectorizedArray<Number> *values_dofs[1] = {scratch};
+    VectorizedArray<Number> *values_quad[1] = {scratch + dofs_per_cell};
+    VectorizedArray<Number> *gradients_quad[1][dim];
+    for (unsigned int d=0; d<dim; ++d)
+      gradients_quad[0][d] = scratch + dofs_per_cell + (d+1)*n_q_points;
+    VectorizedArray<Number> *hessians_quad[1][(dim*(dim+1))/2] = {};
+    VectorizedArray<Number> *kernel_scratch = scratch + dofs_per_cell + (dim+1)*n_q_points;
+
+    const bool use_mass = (mass_factor != Number());
+    SelectEvaluator<dim,fe_degree,n_q_points_1d,1,Number>::evaluate
+    (shape_info, values_dofs, values_quad, gradients_quad, hessians_quad,
+     kernel_scratch, use_mass, true, false);
+
+    const VectorizedArray<Number> *data = &geometry_data[batch*n_q_points*n_geometry_entries];
+    for (unsigned int q=0; q<n_q_points; ++q, data += n_geometry_entries)
+      {
+        VectorizedArray<Number> gradient[dim];
+        for (unsigned int d=0; d<dim; ++d)
+          gradient[d] = gradients_quad[0][d][q];
+        for (unsigned int d=0; d<dim; ++d)
+          {
+            VectorizedArray<Number> flux = VectorizedArray<Number>();
+            for (unsigned int e=0; e<dim; ++e)
+              {
+                // index into the upper triangle stored row by row
+                const unsigned int row = std::min (d, e), column = std::max (d, e);
+                flux += data[row*dim - (row*(row-1))/2 + column - row] * gradient[e];
+              }
+            gradients_quad[0][d][q] = flux;
+          }
+        if (use_mass)
+          values_quad[0][q] *= mass_factor * data[n_geometry_entries-1];
+      }
+
+    SelectEvaluator<dim,fe_degree,n_q_points_1d,1,Number>::integrate
+    (shape_info, values_dofs, values_quad, gradients_quad, kernel_scratch,
+     use_mass, true);
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename Number>
+  template <typename VectorType>
+  void
+  LaplaceBeltramiOperator<dim,fe_degree,n_q_points_1d,Number>
+  ::read_dof_values (const unsigned int       batch,
+                     const VectorType        &src,
+                     VectorizedArray<Number> *values_dofs) const
+  {
+    const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+    const types::global_dof_index *indices = &dof_indices[batch*dofs_per_cell*n_lanes];
+    for (unsigned int i=0; i<dofs_per_cell; ++i)
+      for (unsigned int v=0; v<n_lanes; ++v, ++indices)
+        {
+          Number value = Number();
+          if (*indices == numbers::invalid_dof_index)
+            ;
+          else if (constraints->is_constrained (*indices))
+            {
+              for (const auto &entry : *constraints->get_constraint_entries (*indices))
+                value += entry.second * src(entry.first);
+            }
+          else
+            value = src(*indices);
+          values_dofs[i][v] = value;
+        }
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename Number>
+  template <typename VectorType>
+  void
+  LaplaceBeltramiOperator<dim,fe_degree,n_q_points_1d,Number>
+  ::distribute_local_to_global (const unsigned int             batch,
+                                const VectorizedArray<Number> *values_dofs,
+                                VectorType                    &dst) const
+  {
+    const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+    const types::global_dof_index *indices = &dof_indices[batch*dofs_per_cell*n_lanes];
+    for (unsigned int i=0; i<dofs_per_cell; ++i)
+      for (unsigned int v=0; v<n_lanes; ++v, ++indices)
+        if (*indices == numbers::invalid_dof_index)
+          continue;
+        else if (constraints->is_constrained (*indices))
+          {
+            for (const auto &entry : *constraints->get_constraint_entries (*indices))
+              dst(entry.first) += entry.second * values_dofs[i][v];
+          }
+        else
+          dst(*indices) += values_dofs[i][v];
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename Number>
+  template <typename VectorType>
+  void
+  LaplaceBeltramiOperator<dim,fe_degree,n_q_points_1d,Number>
+  ::vmult (VectorType       &dst,
+           const VectorType &src) const
+  {
+    dst = 0;
+    vmult_add (dst, src);
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename Number>
+  template <typename VectorType>
+  void
+  LaplaceBeltramiOperator<dim,fe_degree,n_q_points_1d,Number>
+  ::Tvmult (VectorType       &dst,
+            const VectorType &src) const
+  {
+    vmult (dst, src);
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename Number>
+  template <typename VectorType>
+  void
+  LaplaceBeltramiOperator<dim,fe_degree,n_q_points_1d,Number>
+  ::vmult_add (VectorType       &dst,
+               const VectorType &src) const
+  {
+    Assert (constraints != nullptr, ExcNotInitialized());
+    AssertDimension (dst.size(), n_dofs);
+    AssertDimension (src.size(), n_dofs);
+
+    for (unsigned int batch=0; batch<n_batches; ++batch)
+      {
+        read_dof_values (batch, src, scratch_data.begin());
+        apply_on_batch (batch, scratch_data.begin());
+        distribute_local_to_global (batch, scratch_data.begin(), dst);
+      }
+
+    // the operator is the identity on the constrained degrees of freedom
+    for (const types::global_dof_index i : constrained_dofs)
+      dst(i) += src(i);
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename Number>
+  template <typename VectorType>
+  void
+  LaplaceBeltramiOperator<dim,fe_degree,n_q_points_1d,Number>
+  ::compute_diagonal (VectorType &diagonal) const
+  {
+    Assert (constraints != nullptr, ExcNotInitialized());
+    AssertDimension (diagonal.size(), n_dofs);
+
+    const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+    diagonal = 0;
+    VectorizedArray<Number> local_diagonal[dofs_per_cell];
+    for (unsigned int batch=0; batch<n_batches; ++batch)
+      {
+        for (unsigned int i=0; i<dofs_per_cell; ++i)
+          {
+            for (unsigned int j=0; j<dofs_per_cell; ++j)
+              scratch_data[j] = Number();
+            scratch_data[i] = Number(1.);
+            apply_on_batch (batch, scratch_data.begin());
+            local_diagonal[i] = scratch_data[i];
+          }
+
+        const types::global_dof_index *indices = &dof_indices[batch*dofs_per_cell*n_lanes];
+        for (unsigned int i=0; i<dofs_per_cell; ++i)
+          for (unsigned int v=0; v<n_lanes; ++v, ++indices)
+            if (*indices != numbers::invalid_dof_index &&
+                !constraints->is_constrained (*indices))
+              diagonal(*indices) += local_diagonal[i][v];
+      }
+
+    for (const types::global_dof_index i : constrained_dofs)
+      diagonal(i) = 1.;
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename Number>
+  std::size_t
+  LaplaceBeltramiOperator<dim,fe_degree,n_q_points_1d,Number>::memory_consumption () const
+  {
+    return (shape_info.memory_consumption() +
+            geometry_data.memory_consumption() +
+            MemoryConsumption::memory_consumption (dof_indices) +
+            MemoryConsumption::memory_consumption (constrained_dofs) +
+            scratch_data.memory_consumption());
+  }
+
+#endif // DOXYGEN
+
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
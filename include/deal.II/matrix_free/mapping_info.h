@@ -24,7 +24,9 @@
 #include <deal.II/hp/q_collection.h>
 #include <deal.II/fe/fe.h>
 #include <deal.II/fe/mapping.h>
+#include <deal.II/matrix_free/face_info.h>
 #include <deal.II/matrix_free/helper_functions.h>
+#include <deal.II/matrix_free/shape_info.h>
 
 #include <memory>
 
@@ -75,13 +77,39 @@ namespace internal
        * for different kinds of iterators, e.g. standard DoFHandler,
        * multigrid, etc.)  on a fixed Triangulation. In addition, a mapping
        * and several quadrature formulas are given.
+       *
+       * If @p jacobians_on_the_fly is set, the inverse Jacobians and JxW
+       * values of general cells are not stored. Instead, the position of the
+       * support points of the mapping, which must be a MappingQGeneric or a
+       * MappingQ, is stored in geometry_nodes and the data is computed from
+       * the nodes in FEEvaluation::reinit() with the shape functions in
+       * MappingInfoDependent::geometry_shape_info.
        */
       void initialize (const dealii::Triangulation<dim>                &tria,
                        const std::vector<std::pair<unsigned int,unsigned int> > &cells,
                        const std::vector<unsigned int>         &active_fe_index,
                        const Mapping<dim>                      &mapping,
                        const std::vector<dealii::hp::QCollection<1> >  &quad,
-                       const UpdateFlags                        update_flags);
+                       const UpdateFlags                        update_flags,
+                       const bool                               jacobians_on_the_fly = false);
+
+      /**
+       * Compute the information on the faces given by @p faces, whose
+       * adjacent cells are given by their index in @p cells. For each face
+       * batch, the data is computed on the interior side, and the inverse
+       * Jacobians also on the exterior side. If FaceInfo::faces_by_cells is
+       * not empty, the same data is also computed for the faces of the cell
+       * batches, as seen from the cells of the batch. The quadrature formulas on the
+       * faces are the (dim-1)-dimensional tensor products of the given
+       * one-dimensional formulas, with the points enumerated in the
+       * coordinate system of the face as seen from the interior cell.
+       */
+      void initialize_faces (const dealii::Triangulation<dim>                &tria,
+                             const std::vector<std::pair<unsigned int,unsigned int> > &cells,
+                             const FaceInfo<VectorizedArray<Number>::n_array_elements> &faces,
+                             const Mapping<dim>                      &mapping,
+                             const std::vector<dealii::hp::QCollection<1> >  &quad,
+                             const UpdateFlags                        update_flags);
 
       /**
        * Helper function to determine which update flags must be set in the
@@ -222,6 +250,15 @@ namespace internal
          */
         AlignedVector<Point<dim,VectorizedArray<Number> > > quadrature_points;
 
+        /**
+         * The values and gradients of the shape functions of the mapping
+         * polynomials in the quadrature points, with one entry per hp
+         * quadrature formula. Used for computing the Jacobians of general
+         * cells from geometry_nodes. Only filled if jacobians_on_the_fly is
+         * set.
+         */
+        std::vector<ShapeInfo<VectorizedArray<Number> > > geometry_shape_info;
+
         /**
          * The dim-dimensional quadrature formula underlying the problem
          * (constructed from a 1D tensor product quadrature formula).
@@ -289,6 +326,87 @@ namespace internal
        */
       std::vector<MappingInfoDependent> mapping_data_gen;
 
+      /**
+       * Definition of a structure that stores the geometry data on the
+       * quadrature points of the faces for one quadrature formula. All fields
+       * are indexed by <tt>face_batch * n_q_points + q</tt>.
+       */
+      struct FaceMappingData
+      {
+        /**
+         * The number of quadrature points on a face.
+         */
+        unsigned int n_q_points;
+
+        /**
+         * The surface element times the quadrature weight on the faces.
+         */
+        AlignedVector<VectorizedArray<Number> > JxW_values;
+
+        /**
+         * The unit normal vector on the faces, pointing out of the interior
+         * cell.
+         */
+        AlignedVector<Tensor<1,dim,VectorizedArray<Number> > > normal_vectors;
+
+        /**
+         * The inverse transposed Jacobian of the interior (index 0) and the
+         * exterior (index 1) cell, i.e., the matrix that transforms a
+         * gradient in unit coordinates to a gradient in real coordinates. The
+         * data on the exterior side is only filled for inner faces, i.e., the
+         * first FaceInfo::n_inner_face_batches batches. For the faces of the
+         * cell batches, it is filled for all faces, with a copy of the
+         * interior data on lanes at the boundary of the domain.
+         */
+        AlignedVector<Tensor<2,dim,VectorizedArray<Number> > > jacobians[2];
+
+        /**
+         * The quadrature points in real coordinates.
+         */
+        AlignedVector<Point<dim,VectorizedArray<Number> > > quadrature_points;
+
+        /**
+         * Return the memory consumption in bytes.
+         */
+        std::size_t memory_consumption () const;
+      };
+
+      /**
+       * Contains the data on faces for each quadrature formula. Empty unless
+       * initialize_faces() has been called.
+       */
+      std::vector<FaceMappingData> face_data;
+
+      /**
+       * Contains the data on the faces of the cell batches for each
+       * quadrature formula, indexed by <tt>(cell_batch *
+       * GeometryInfo<dim>::faces_per_cell + face_no) * n_q_points + q</tt>,
+       * with the normal vectors pointing out of the cells of the batch. Empty
+       * unless FaceInfo::faces_by_cells has been set up.
+       */
+      std::vector<FaceMappingData> face_data_by_cells;
+
+      /**
+       * The support points of the mapping on general cells in lexicographic
+       * ordering, indexed by <tt>get_cell_data_index(cell) *
+       * Utilities::fixed_power<dim>(geometry_degree+1) + i</tt>. Only filled
+       * if jacobians_on_the_fly is set.
+       */
+      AlignedVector<Point<dim,VectorizedArray<Number> > > geometry_nodes;
+
+      /**
+       * The polynomial degree of the mapping that is represented by
+       * geometry_nodes.
+       */
+      unsigned int geometry_degree;
+
+      /**
+       * Stores whether the Jacobians and JxW values of general cells are
+       * computed on the fly from geometry_nodes rather than stored in
+       * MappingInfoDependent::jacobians and MappingInfoDependent::JxW_values.
+       */
+      bool jacobians_on_the_fly;
+
       /**
        * Stores whether JxW values have been initialized
        */
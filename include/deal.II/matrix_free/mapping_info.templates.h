@@ -19,7 +19,9 @@
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/fe/fe_nothing.h>
+#include <deal.II/fe/fe_q.h>
 #include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q.h>
 #include <deal.II/fe/mapping_q1.h>
 
 #include <deal.II/matrix_free/mapping_info.h>
@@ -37,6 +39,8 @@ namespace internal
     template <int dim, typename Number>
     MappingInfo<dim,Number>::MappingInfo()
       :
+      geometry_degree (0),
+      jacobians_on_the_fly (false),
       JxW_values_initialized (false),
       second_derivatives_initialized (false),
       quadrature_points_initialized (false)
@@ -55,6 +59,11 @@ namespace internal
       cell_type.clear();
       cartesian_data.clear();
       affine_data.clear();
+      face_data.clear();
+      face_data_by_cells.clear();
+      geometry_nodes.clear();
+      geometry_degree = 0;
+      jacobians_on_the_fly = false;
     }
 
 
@@ -133,7 +142,8 @@ namespace internal
      const std::vector<unsigned int>                          &active_fe_index,
      const Mapping<dim>                                       &mapping,
      const std::vector<dealii::hp::QCollection<1> >           &quad,
-     const UpdateFlags                                         update_flags_input)
+     const UpdateFlags                                         update_flags_input,
+     const bool                                                jacobians_on_the_fly_in)
     {
       clear();
       const unsigned int n_quads = quad.size();
@@ -158,6 +168,36 @@ namespace internal
       if (update_flags & update_quadrature_points)
         quadrature_points_initialized = true;
 
+      // for computing the Jacobians on the fly, the geometry of general cells
+      // is represented by the support points of the mapping, which are the
+      // Gauss-Lobatto points of the mapping degree for MappingQGeneric. The
+      // quadrature points of a tensor product quadrature formula are in
+      // lexicographic order, i.e., the order in which FE_Q is evaluated by
+      // the matrix-free kernels
+      std::shared_ptr<dealii::FEValues<dim> > node_values;
+      if (jacobians_on_the_fly_in == true)
+        {
+          AssertThrow (!(update_flags & update_jacobian_grads),
+                       ExcNotImplemented("Computing the Jacobians on the fly is "
+                                         "not implemented for second derivatives"));
+          if (const MappingQGeneric<dim> *mapping_q_generic =
+                dynamic_cast<const MappingQGeneric<dim> *>(&mapping))
+            geometry_degree = mapping_q_generic->get_degree();
+          else if (const MappingQ<dim> *mapping_q =
+                     dynamic_cast<const MappingQ<dim> *>(&mapping))
+            geometry_degree = mapping_q->get_degree();
+          else
+            AssertThrow (false,
+                         ExcNotImplemented("Computing the Jacobians on the fly "
+                                           "is only implemented for MappingQGeneric "
+                                           "and MappingQ"));
+          jacobians_on_the_fly = true;
+          node_values.reset
+          (new dealii::FEValues<dim> (mapping, dummy_fe,
+                                      Quadrature<dim>(QGaussLobatto<1>(geometry_degree+1)),
+                                      update_quadrature_points));
+        }
+
       // when we make comparisons about the size of Jacobians we need to know
       // the approximate size of typical entries in Jacobians. We need to fix
       // the Jacobian size once and for all. We choose the diameter of the
@@ -198,6 +238,12 @@ namespace internal
               (Quadrature<dim>(quad[my_q][q]));
               current_data.face_quadrature.push_back
               (Quadrature<dim-1>(quad[my_q][q]));
+              if (jacobians_on_the_fly == true)
+                {
+                  current_data.geometry_shape_info.emplace_back();
+                  current_data.geometry_shape_info.back().reinit
+                  (quad[my_q][q], FE_Q<dim>(QGaussLobatto<1>(geometry_degree+1)));
+                }
 
               // set quadrature weights in vectorized form
               current_data.quadrature_weights[q].resize(n_q_points);
@@ -387,8 +433,10 @@ namespace internal
                           current_data.rowstart_jacobians.reserve
                           (reserve_size);
                           reserve_size *= n_q_points;
-                          current_data.jacobians.reserve (reserve_size);
-                          if (update_flags & update_JxW_values)
+                          if (jacobians_on_the_fly == false)
+                            current_data.jacobians.reserve (reserve_size);
+                          if (update_flags & update_JxW_values &&
+                              jacobians_on_the_fly == false)
                             current_data.JxW_values.reserve (reserve_size);
                           if (update_flags & update_jacobian_grads)
                             {
@@ -396,6 +444,26 @@ namespace internal
                               current_data.jacobians_grad_upper.reserve (reserve_size);
                             }
                         }
+
+                      // store the support points of the mapping on all
+                      // lanes, which also represents the Jacobian of the
+                      // Cartesian and affine cells in the batch exactly
+                      if (jacobians_on_the_fly == true)
+                        {
+                          const unsigned int n_nodes = node_values->n_quadrature_points;
+                          geometry_nodes.resize ((insert_position+1)*n_nodes);
+                          for (unsigned int v=0; v<vectorization_length; ++v)
+                            {
+                              const std::pair<unsigned int,unsigned int> &cell_index =
+                                cells[cell*vectorization_length+v];
+                              node_values->reinit (typename dealii::Triangulation<dim>::cell_iterator
+                                                   (&tria, cell_index.first, cell_index.second));
+                              for (unsigned int i=0; i<n_nodes; ++i)
+                                for (unsigned int d=0; d<dim; ++d)
+                                  geometry_nodes[insert_position*n_nodes+i][d][v] =
+                                    node_values->quadrature_point(i)[d];
+                            }
+                        }
                     }
 
                   cell_type[cell] = ((insert_position << n_cell_type_bits) +
@@ -423,7 +491,7 @@ namespace internal
                       AssertDimension (previous_size,
                                        current_data.jacobians_grad_upper.size());
                     }
-                  for (unsigned int q=0; q<n_q_points; ++q)
+                  for (unsigned int q=0; q<(jacobians_on_the_fly ? 0 : n_q_points); ++q)
                     {
                       Tensor<2,dim,VectorizedArray<Number> > &jac = data.general_jac[q];
                       Tensor<3,dim,VectorizedArray<Number> > &jacobian_grad = data.general_jac_grad[q];
@@ -603,6 +671,166 @@ namespace internal
 
 
 
+    template <int dim, typename Number>
+    void
+    MappingInfo<dim,Number>::initialize_faces
+    (const dealii::Triangulation<dim>                         &tria,
+     const std::vector<std::pair<unsigned int,unsigned int> > &cells,
+     const FaceInfo<VectorizedArray<Number>::n_array_elements> &faces,
+     const Mapping<dim>                                       &mapping,
+     const std::vector<dealii::hp::QCollection<1> >           &quad,
+     const UpdateFlags                                         update_flags)
+    {
+      const unsigned int n_quads = quad.size();
+      const unsigned int vectorization_length =
+        VectorizedArray<Number>::n_array_elements;
+      face_data.clear();
+      face_data.resize (n_quads);
+      face_data_by_cells.clear();
+      face_data_by_cells.resize (faces.faces_by_cells.empty() ? 0 : n_quads);
+
+      const bool store_jacobians =
+        (update_flags & update_gradients || update_flags & update_inverse_jacobians);
+      const bool store_quadrature_points = update_flags & update_quadrature_points;
+
+      // the quadrature points are always computed because they are used to
+      // check that the cells on both sides of a face see the quadrature
+      // points in the same order
+      FE_Nothing<dim> dummy_fe;
+      const UpdateFlags update_flags_feval =
+        update_JxW_values | update_normal_vectors | update_quadrature_points |
+        (store_jacobians ? update_jacobians : update_default);
+
+      for (unsigned int my_q=0; my_q<n_quads; ++my_q)
+        {
+          Assert (quad[my_q].size() == 1,
+                  ExcNotImplemented("Face integrals are not implemented for "
+                                    "hp quadrature collections."));
+          const Quadrature<dim-1> face_quadrature (quad[my_q][0]);
+          const unsigned int n_q_points = face_quadrature.size();
+          FEFaceValues<dim> fe_face_values (mapping, dummy_fe, face_quadrature,
+                                            update_flags_feval);
+          std::vector<Point<dim> > interior_points (n_q_points);
+
+          // the face batches of loop() and, if requested, the faces of the
+          // cell batches for loop_cell_centric() are filled by the same code:
+          // the data on the exterior side is computed for all lanes that
+          // have an exterior cell, which are all lanes of the inner face
+          // batches in the former case. In the latter case, the exterior
+          // Jacobians of lanes at the boundary are copied from the interior
+          for (unsigned int by_cells=0; by_cells<2; ++by_cells)
+            {
+              if (by_cells == 1 && face_data_by_cells.empty())
+                continue;
+
+              const std::vector<FaceToCells<VectorizedArray<Number>::n_array_elements> >
+              &face_batches = by_cells ? faces.faces_by_cells : faces.faces;
+              const unsigned int n_face_batches = face_batches.size();
+              const unsigned int n_exterior_batches =
+                by_cells ? n_face_batches : faces.n_inner_face_batches;
+              FaceMappingData &current_data =
+                by_cells ? face_data_by_cells[my_q] : face_data[my_q];
+              current_data.n_q_points = n_q_points;
+              current_data.JxW_values.resize (n_face_batches*n_q_points);
+              current_data.normal_vectors.resize (n_face_batches*n_q_points);
+              if (store_jacobians)
+                {
+                  current_data.jacobians[0].resize (n_face_batches*n_q_points);
+                  current_data.jacobians[1].resize (n_exterior_batches*n_q_points);
+                }
+              if (store_quadrature_points)
+                current_data.quadrature_points.resize (n_face_batches*n_q_points);
+
+              for (unsigned int face=0; face<n_face_batches; ++face)
+                {
+                  const FaceToCells<VectorizedArray<Number>::n_array_elements> &face_to_cells
+                    = face_batches[face];
+                  const unsigned int offset = face*n_q_points;
+                  for (unsigned int v=0; v<vectorization_length; ++v)
+                    {
+                      // fill unused lanes with the data of the first face in
+                      // order to avoid divisions by zero in user code
+                      const unsigned int lane =
+                        face_to_cells.cells_interior[v] == numbers::invalid_unsigned_int ?
+                        0 : v;
+                      AssertIndexRange (face_to_cells.cells_interior[lane], cells.size());
+                      const std::pair<unsigned int,unsigned int> &interior_cell =
+                        cells[face_to_cells.cells_interior[lane]];
+                      typename dealii::Triangulation<dim>::cell_iterator
+                      cell_it (&tria, interior_cell.first, interior_cell.second);
+                      fe_face_values.reinit (cell_it, face_to_cells.interior_face_no);
+
+                      for (unsigned int q=0; q<n_q_points; ++q)
+                        {
+                          current_data.JxW_values[offset+q][v] = fe_face_values.JxW(q);
+                          const Tensor<1,dim> normal = fe_face_values.normal_vector(q);
+                          for (unsigned int d=0; d<dim; ++d)
+                            current_data.normal_vectors[offset+q][d][v] = normal[d];
+                          interior_points[q] = fe_face_values.quadrature_point(q);
+                          if (store_quadrature_points)
+                            for (unsigned int d=0; d<dim; ++d)
+                              current_data.quadrature_points[offset+q][d][v] =
+                                interior_points[q][d];
+                          if (store_jacobians)
+                            {
+                              const DerivativeForm<1,dim,dim> inv_jac =
+                                fe_face_values.jacobian(q).covariant_form();
+                              for (unsigned int d=0; d<dim; ++d)
+                                for (unsigned int e=0; e<dim; ++e)
+                                  current_data.jacobians[0][offset+q][d][e][v] =
+                                    inv_jac[d][e];
+                            }
+                        }
+
+                      if (face >= n_exterior_batches)
+                        continue;
+
+                      if (face_to_cells.cells_exterior[lane] == numbers::invalid_unsigned_int)
+                        {
+                          if (store_jacobians)
+                            for (unsigned int q=0; q<n_q_points; ++q)
+                              for (unsigned int d=0; d<dim; ++d)
+                                for (unsigned int e=0; e<dim; ++e)
+                                  current_data.jacobians[1][offset+q][d][e][v] =
+                                    current_data.jacobians[0][offset+q][d][e][v];
+                          continue;
+                        }
+
+                      AssertIndexRange (face_to_cells.cells_exterior[lane], cells.size());
+                      const std::pair<unsigned int,unsigned int> &exterior_cell =
+                        cells[face_to_cells.cells_exterior[lane]];
+                      typename dealii::Triangulation<dim>::cell_iterator
+                      neighbor_it (&tria, exterior_cell.first, exterior_cell.second);
+                      fe_face_values.reinit (neighbor_it, face_to_cells.exterior_face_no);
+
+                      for (unsigned int q=0; q<n_q_points; ++q)
+                        {
+                          AssertThrow (fe_face_values.quadrature_point(q).distance
+                                       (interior_points[q]) <
+                                       1e-10 * cell_it->diameter(),
+                                       ExcNotImplemented("The quadrature points on a face "
+                                                         "do not match as seen from the "
+                                                         "two adjacent cells. Faces in "
+                                                         "non-standard orientation are "
+                                                         "not supported."));
+                          if (store_jacobians)
+                            {
+                              const DerivativeForm<1,dim,dim> inv_jac =
+                                fe_face_values.jacobian(q).covariant_form();
+                              for (unsigned int d=0; d<dim; ++d)
+                                for (unsigned int e=0; e<dim; ++e)
+                                  current_data.jacobians[1][offset+q][d][e][v] =
+                                    inv_jac[d][e];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+
+
     template <int dim, typename Number>
     void
     MappingInfo<dim,Number>::evaluate_on_cell (const dealii::Triangulation<dim> &tria,
@@ -839,6 +1067,21 @@ namespace internal
       memory += MemoryConsumption::memory_consumption (n_q_points);
       memory += MemoryConsumption::memory_consumption (n_q_points_face);
       memory += MemoryConsumption::memory_consumption (quad_index_conversion);
+      memory += MemoryConsumption::memory_consumption (geometry_shape_info);
+      return memory;
+    }
+
+
+
+    template <int dim, typename Number>
+    std::size_t MappingInfo<dim,Number>::FaceMappingData::memory_consumption() const
+    {
+      std::size_t
+      memory = MemoryConsumption::memory_consumption (JxW_values);
+      memory += MemoryConsumption::memory_consumption (normal_vectors);
+      memory += MemoryConsumption::memory_consumption (jacobians[0]);
+      memory += MemoryConsumption::memory_consumption (jacobians[1]);
+      memory += MemoryConsumption::memory_consumption (quadrature_points);
       return memory;
     }
 
@@ -852,6 +1095,9 @@ namespace internal
       memory += MemoryConsumption::memory_consumption (affine_data);
       memory += MemoryConsumption::memory_consumption (cartesian_data);
       memory += MemoryConsumption::memory_consumption (cell_type);
+      memory += MemoryConsumption::memory_consumption (face_data);
+      memory += MemoryConsumption::memory_consumption (face_data_by_cells);
+      memory += MemoryConsumption::memory_consumption (geometry_nodes);
       memory += sizeof (*this);
       return memory;
     }
@@ -917,6 +1163,12 @@ namespace internal
       size_info.print_memory_statistics
       (out, MemoryConsumption::memory_consumption (affine_data) +
        MemoryConsumption::memory_consumption (cartesian_data));
+      if (jacobians_on_the_fly)
+        {
+          out << "    Memory geometry nodes:           ";
+          size_info.print_memory_statistics
+          (out, MemoryConsumption::memory_consumption (geometry_nodes));
+        }
       for (unsigned int j=0; j<mapping_data_gen.size(); ++j)
         {
           out << "    Data component " << j << std::endl;
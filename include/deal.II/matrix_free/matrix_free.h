@@ -18,6 +18,7 @@
 #define dealii_matrix_free_h
 
 #include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/event_trace.h>
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/parallel.h>
 #include <deal.II/base/quadrature.h>
@@ -47,9 +48,11 @@
 #endif
 
 #include <stdlib.h>
+#include <array>
 #include <memory>
 #include <limits>
 #include <list>
+#include <string>
 
 
 DEAL_II_NAMESPACE_OPEN
@@ -81,8 +84,9 @@ DEAL_II_NAMESPACE_OPEN
  * - ShapeInfo: It contains the shape functions of the finite element,
  * evaluated on the unit cell.
  *
- * Besides the initialization routines, this class implements only a single
- * operation, namely a loop over all cells (cell_loop()). This loop is
+ * Besides the initialization routines, this class implements a loop over all
+ * cells (cell_loop()) and, for discontinuous Galerkin methods, a loop over
+ * all cells, inner faces and boundary faces (loop()). The cell loop is
  * scheduled in such a way that cells that share degrees of freedom are not
  * worked on simultaneously, which implies that it is possible to write to
  * vectors (or matrices) in parallel without having to explicitly synchronize
@@ -100,6 +104,23 @@ DEAL_II_NAMESPACE_OPEN
  * operations for several cells with one CPU instruction and is one of the
  * main features of this framework.
  *
+ * For the face integrals in loop(), faces are grouped into batches in the
+ * same way, and evaluated with the class FEFaceEvaluation. Alternatively,
+ * loop_cell_centric() goes through the cell batches only and lets the cell
+ * operation compute the integrals on all faces of the cells itself.
+ *
+ * The template argument @p Number only sets the precision of the cached data
+ * and of the computations on the cells. The vectors passed to the loops and
+ * to FEEvaluation::read_dof_values() and
+ * FEEvaluation::distribute_local_to_global() may use a different number type,
+ * in which case the values are converted when they are read or written. This
+ * allows, e.g., to apply an operator based on MatrixFree<dim,float> with the
+ * twice wider SIMD lanes directly to the vectors of type
+ * LinearAlgebra::distributed::Vector<double> of an outer solver in double
+ * precision, without keeping separate copies of the vectors in single
+ * precision. Vectors of a different number type are set up by the variant of
+ * initialize_dof_vector() with a template argument for the number type.
+ *
  * For details on usage of this class, see the description of FEEvaluation.
  *
  * @author Katharina Kormann, Martin Kronbichler, 2010, 2011
@@ -180,10 +201,18 @@ public:
       tasks_parallel_scheme (tasks_parallel_scheme),
       tasks_block_size      (tasks_block_size),
       mapping_update_flags  (mapping_update_flags),
+      mapping_update_flags_inner_faces (update_default),
+      mapping_update_flags_boundary_faces (update_default),
+      mapping_update_flags_faces_by_cells (update_default),
       level_mg_handler      (level_mg_handler),
       store_plain_indices   (store_plain_indices),
       initialize_indices    (initialize_indices),
-      initialize_mapping    (initialize_mapping)
+      initialize_mapping    (initialize_mapping),
+      kernel_variant        (internal::MatrixFreeFunctions::kernel_default),
+      tune_kernel_variant   (false),
+      compute_jacobians_on_the_fly (false),
+      share_shape_info_on_node (false),
+      tune_tasks_parallel_scheme (false)
     {};
 
 
@@ -224,7 +253,10 @@ public:
      * cells present. Otherwise, the given number is used. If the given number
      * is larger than one third of the number of total cells, this means no
      * parallelism. Note that in the case vectorization is used, a macro cell
-     * consists of more than one physical cell.
+     * consists of more than one physical cell. Without task parallelism, the
+     * cell loop works on chunks of this size on the cells that do not
+     * depend on ghost data and tests for the completion of the MPI transfers
+     * in between.
      */
     unsigned int        tasks_block_size;
 
@@ -241,6 +273,39 @@ public:
      */
     UpdateFlags         mapping_update_flags;
 
+    /**
+     * This flag determines the mapping data on the inner faces of the mesh
+     * that should be cached, analogous to @p mapping_update_flags. If this
+     * field or @p mapping_update_flags_boundary_faces is different from
+     * update_default, the faces of the mesh are collected into batches for
+     * use in loop() and FEFaceEvaluation. The JxW values and the normal
+     * vectors on faces are always computed in that case; update_gradients
+     * additionally stores the inverse Jacobians of the cells on both sides
+     * and update_quadrature_points the quadrature points in real space. The
+     * data is computed for the union of the flags for inner and boundary
+     * faces. Defaults to update_default, i.e., no faces.
+     */
+    UpdateFlags         mapping_update_flags_inner_faces;
+
+    /**
+     * This flag determines the mapping data on the faces at the boundary of
+     * the domain that should be cached, see @p
+     * mapping_update_flags_inner_faces.
+     */
+    UpdateFlags         mapping_update_flags_boundary_faces;
+
+    /**
+     * This flag determines the mapping data on the faces that should be
+     * cached for the cell-centric loop loop_cell_centric(), with the same
+     * meaning as @p mapping_update_flags_inner_faces. If different from
+     * update_default, the data is computed for every face of every cell
+     * batch as seen from the cells of the batch, such that FEFaceEvaluation
+     * can be initialized with a cell batch and a face number. Since every
+     * inner face is then stored twice, this doubles the memory for face data
+     * compared to loop(). Defaults to update_default.
+     */
+    UpdateFlags         mapping_update_flags_faces_by_cells;
+
     /**
      * This option can be used to define whether we work on a certain level of
      * the mesh, and not the active cells. If set to invalid_unsigned_int
@@ -276,6 +341,94 @@ public:
      * independent cells should be computed).
      */
     bool                initialize_mapping;
+
+    /**
+     * Select the sum factorization kernel that FEEvaluation uses for the
+     * evaluation and integration on cells, see
+     * internal::MatrixFreeFunctions::KernelVariant. Elements that do not
+     * support the given variant, e.g. because they are not symmetric or
+     * because the number of quadrature points differs from the number of
+     * nodes in case of @p kernel_transform_to_collocation, use the default
+     * kernel. Defaults to @p kernel_default.
+     */
+    internal::MatrixFreeFunctions::KernelVariant kernel_variant;
+
+    /**
+     * If true, reinit() times all kernel variants supported by each
+     * combination of element and quadrature formula with polynomial degrees
+     * up to 9 and between degree+1 and degree+2 quadrature points in 1D, and
+     * selects the fastest one, overriding @p kernel_variant. The timings are
+     * summed over the MPI processes of the triangulation such that all
+     * processes select the same kernels. This takes a few milliseconds per
+     * element and quadrature formula. Defaults to false.
+     */
+    bool                tune_kernel_variant;
+
+    /**
+     * If true, the inverse Jacobians and JxW values on cells with
+     * non-constant Jacobian are not stored. Instead, only the support points
+     * of the mapping are stored, and FEEvaluation::reinit() computes the
+     * Jacobians in the quadrature points of the cell from them by sum
+     * factorization. For a mapping of degree $p$ and $q$ quadrature points
+     * in 1D, this reduces the geometry data of a curved cell from
+     * $(d^2+1)q^d$ to $d(p+1)^d$ numbers at the cost of a reinit() that is
+     * about as expensive as evaluating the gradient of a vector-valued
+     * function. Cartesian and affine cells as well as the data on faces are
+     * always stored. This option requires a MappingQGeneric or MappingQ and
+     * cannot be combined with update_hessians. Defaults to false.
+     */
+    bool                compute_jacobians_on_the_fly;
+
+    /**
+     * If true, the tabulated shape functions of all elements are stored only
+     * once per compute node in MPI-3 shared memory that all processes of the
+     * triangulation's communicator on the node read from, see
+     * AlignedVector::replicate_across_communicator(). This saves memory when
+     * running many MPI processes per node with high polynomial degrees or
+     * many elements. Since the shared memory is released collectively, all
+     * processes must reinit and destroy their MatrixFree objects in the same
+     * order. Has no effect without MPI. Defaults to false.
+     */
+    bool                share_shape_info_on_node;
+
+    /**
+     * If true, reinit() times a sample cell loop, which reads a vector,
+     * evaluates and integrates values and (if @p mapping_update_flags contains
+     * update_gradients) gradients with FEEvaluation on the first DoFHandler
+     * and quadrature formula, and writes into another vector, for a few
+     * combinations of @p tasks_parallel_scheme and @p tasks_block_size, and
+     * sets up the data structures with the fastest combination, overriding
+     * the values given in these fields. With multithreading, the candidates
+     * are all schemes with the block size that is guessed by default, and
+     * @p partition_partition also with half and twice that block size.
+     * Without multithreading, only the block size of the scheme @p none is
+     * varied. The timings of the slowest MPI process are compared such that
+     * all processes make the same choice.
+     *
+     * Each candidate requires a complete setup of the indices and the
+     * mapping data, so tuning makes reinit() several times as expensive. The
+     * result can be stored in the file @p tasks_tuning_cache_file to skip the
+     * timings in later runs. Tuning is only done for DoFHandler objects with
+     * @p initialize_indices and @p initialize_mapping set, and ignored for
+     * hp::DoFHandler objects. Defaults to false.
+     */
+    bool                tune_tasks_parallel_scheme;
+
+    /**
+     * The name of a text file that stores the results of the tuning of
+     * @p tune_tasks_parallel_scheme, one line per combination of the host
+     * name of the first MPI process, the number of threads and of MPI
+     * processes, the dimension, the polynomial degree of the first element,
+     * the size of @p Number, and the global number of cells rounded down to
+     * a power of two. If the file contains a line for the present
+     * combination, the stored scheme is used without any timings, otherwise
+     * a line with the result of the timings is appended. The block size is
+     * stored relative to the block size that is guessed by default. The file
+     * is only read and written by the first MPI process of the
+     * triangulation. If empty, which is the default, the timings are always
+     * done.
+     */
+    std::string         tasks_tuning_cache_file;
   };
 
   /**
@@ -449,6 +602,12 @@ public:
    * a pointer to an object in this place if it has an <code>operator()</code>
    * with the correct set of arguments since such a pointer can be converted
    * to the function object.
+   *
+   * The cells are ordered at reinit() such that the cells that access
+   * vector entries owned by other MPI processes are in the middle of the
+   * range. The cells before them are worked on while the ghost values of
+   * @p src are imported, and the cells after them while the contributions
+   * to @p dst are sent to their owners.
    */
   template <typename OutVector, typename InVector>
   void cell_loop (const std::function<void (const MatrixFree<dim,Number> &,
@@ -491,6 +650,198 @@ public:
                   OutVector      &dst,
                   const InVector &src) const;
 
+  /**
+   * Variant of cell_loop() for the hp case, where the cells are grouped by
+   * the active FE index of the DoFHandler @p vector_component. Each range
+   * of cells of the loop is split into the subranges of cells with the same
+   * active FE index as in create_cell_subrange_hp_by_index(), and @p
+   * cell_operation is called for each non-empty subrange with the active FE
+   * index as last argument. This allows to select an FEEvaluation with the
+   * polynomial degree of the respective group at compile time, e.g. with
+   * FEEvaluationDispatcher or with a switch over the FE indices. Without hp
+   * DoFHandler, the operation is called for the full ranges with index zero.
+   */
+  template <typename OutVector, typename InVector>
+  void cell_loop_by_fe_index (const std::function<void (const MatrixFree<dim,Number> &,
+                                                        OutVector &,
+                                                        const InVector &,
+                                                        const std::pair<unsigned int,
+                                                        unsigned int> &,
+                                                        const unsigned int)> &cell_operation,
+                              OutVector          &dst,
+                              const InVector     &src,
+                              const unsigned int  vector_component = 0) const;
+
+  /**
+   * Same as above, but for a class member function with signature
+   * <code>cell_operation (const MatrixFree<dim,Number> &, OutVector &,
+   * InVector &, std::pair<unsigned int,unsigned int> &, unsigned int
+   * active_fe_index) const</code>.
+   */
+  template <typename CLASS, typename OutVector, typename InVector>
+  void cell_loop_by_fe_index (void (CLASS::*function_pointer)(const MatrixFree &,
+                                                              OutVector &,
+                                                              const InVector &,
+                                                              const std::pair<unsigned int,
+                                                              unsigned int> &,
+                                                              const unsigned int)const,
+                              const CLASS        *owning_class,
+                              OutVector          &dst,
+                              const InVector     &src,
+                              const unsigned int  vector_component = 0) const;
+
+  /**
+   * This method runs a loop over all cells, all inner faces and all faces at
+   * the boundary of the domain, as needed for discontinuous Galerkin methods,
+   * and performs the MPI data exchange on the source vector and destination
+   * vector. The three function objects have the same signature as in
+   * cell_loop(). The range handed to @p cell_operation is a range of macro
+   * cells, the range handed to @p face_operation is a range of inner face
+   * batches within [0, n_inner_face_batches()), and the range handed to @p
+   * boundary_operation is a range of boundary face batches within
+   * [n_inner_face_batches(), n_inner_face_batches() +
+   * n_boundary_face_batches()). The face batches are accessed through
+   * FEFaceEvaluation.
+   *
+   * The faces must have been set up by setting
+   * AdditionalData::mapping_update_flags_inner_faces or
+   * AdditionalData::mapping_update_flags_boundary_faces. Since the integrals
+   * on a face write into the vector entries of both adjacent cells, this
+   * loop is run in serial, also if task parallelism has been enabled for
+   * cell_loop().
+   */
+  template <typename OutVector, typename InVector>
+  void loop (const std::function<void (const MatrixFree<dim,Number> &,
+                                       OutVector &,
+                                       const InVector &,
+                                       const std::pair<unsigned int,
+                                       unsigned int> &)> &cell_operation,
+             const std::function<void (const MatrixFree<dim,Number> &,
+                                       OutVector &,
+                                       const InVector &,
+                                       const std::pair<unsigned int,
+                                       unsigned int> &)> &face_operation,
+             const std::function<void (const MatrixFree<dim,Number> &,
+                                       OutVector &,
+                                       const InVector &,
+                                       const std::pair<unsigned int,
+                                       unsigned int> &)> &boundary_operation,
+             OutVector      &dst,
+             const InVector &src) const;
+
+  /**
+   * This is the second variant to run the loop over all cells and faces, now
+   * providing three function pointers to member functions of class @p CLASS
+   * with the signature <code>operation (const MatrixFree<dim,Number> &,
+   * OutVector &, InVector &, std::pair<unsigned int,unsigned
+   * int>&)const</code>, analogous to cell_loop().
+   */
+  template <typename CLASS, typename OutVector, typename InVector>
+  void loop (void (CLASS::*cell_operation)(const MatrixFree &,
+                                           OutVector &,
+                                           const InVector &,
+                                           const std::pair<unsigned int,
+                                           unsigned int> &)const,
+             void (CLASS::*face_operation)(const MatrixFree &,
+                                           OutVector &,
+                                           const InVector &,
+                                           const std::pair<unsigned int,
+                                           unsigned int> &)const,
+             void (CLASS::*boundary_operation)(const MatrixFree &,
+                                               OutVector &,
+                                               const InVector &,
+                                               const std::pair<unsigned int,
+                                               unsigned int> &)const,
+             const CLASS    *owning_class,
+             OutVector      &dst,
+             const InVector &src) const;
+
+  /**
+   * Same as above, but for class member functions which are non-const.
+   */
+  template <typename CLASS, typename OutVector, typename InVector>
+  void loop (void (CLASS::*cell_operation)(const MatrixFree &,
+                                           OutVector &,
+                                           const InVector &,
+                                           const std::pair<unsigned int,
+                                           unsigned int> &),
+             void (CLASS::*face_operation)(const MatrixFree &,
+                                           OutVector &,
+                                           const InVector &,
+                                           const std::pair<unsigned int,
+                                           unsigned int> &),
+             void (CLASS::*boundary_operation)(const MatrixFree &,
+                                               OutVector &,
+                                               const InVector &,
+                                               const std::pair<unsigned int,
+                                               unsigned int> &),
+             CLASS          *owning_class,
+             OutVector      &dst,
+             const InVector &src) const;
+
+  /**
+   * This method runs a cell-centric loop for discontinuous Galerkin methods:
+   * only the cell batches are traversed, and @p cell_operation computes the
+   * cell integrals as well as the integrals over all faces of the cells in
+   * the batch. The faces are evaluated with FEFaceEvaluation initialized by
+   * FEFaceEvaluation::reinit(cell_batch, face_no), reading the values of the
+   * neighbors directly from the source vector. All contributions to a cell
+   * are accumulated into the degrees of freedom of that cell, which can be
+   * done by adding FEFaceEvaluation::begin_dof_values() to
+   * FEEvaluation::begin_dof_values(), so that the destination vector is
+   * written once per cell, and only by the cell batch itself.
+   *
+   * Compared to loop(), each inner face is computed twice, once from each
+   * side, but there is only one pass through the vectors, and the cell
+   * batches can be processed in parallel without any synchronization since
+   * no two batches write to the same vector entries. If task parallelism
+   * has been enabled in AdditionalData::tasks_parallel_scheme, the cell
+   * batches are distributed to the threads in chunks of
+   * AdditionalData::tasks_block_size batches.
+   *
+   * The faces must have been set up by setting
+   * AdditionalData::mapping_update_flags_faces_by_cells. The function object
+   * has the same signature as in cell_loop(). Since the operation reads the
+   * source vector on neighbors, the import of ghost values is finished
+   * before the first cell batch is worked on.
+   */
+  template <typename OutVector, typename InVector>
+  void loop_cell_centric (const std::function<void (const MatrixFree<dim,Number> &,
+                                                    OutVector &,
+                                                    const InVector &,
+                                                    const std::pair<unsigned int,
+                                                    unsigned int> &)> &cell_operation,
+                          OutVector      &dst,
+                          const InVector &src) const;
+
+  /**
+   * This is the second variant of the cell-centric loop, now providing a
+   * function pointer to a member function of class @p CLASS, analogous to
+   * cell_loop().
+   */
+  template <typename CLASS, typename OutVector, typename InVector>
+  void loop_cell_centric (void (CLASS::*function_pointer)(const MatrixFree &,
+                                                          OutVector &,
+                                                          const InVector &,
+                                                          const std::pair<unsigned int,
+                                                          unsigned int> &)const,
+                          const CLASS    *owning_class,
+                          OutVector      &dst,
+                          const InVector &src) const;
+
+  /**
+   * Same as above, but for class member functions which are non-const.
+   */
+  template <typename CLASS, typename OutVector, typename InVector>
+  void loop_cell_centric (void (CLASS::*function_pointer)(const MatrixFree &,
+                                                          OutVector &,
+                                                          const InVector &,
+                                                          const std::pair<unsigned int,
+                                                          unsigned int> &),
+                          CLASS          *owning_class,
+                          OutVector      &dst,
+                          const InVector &src) const;
+
   /**
    * In the hp adaptive case, a subrange of cells as computed during the cell
    * loop might contain elements of different degrees. Use this function to
@@ -514,6 +865,17 @@ public:
                                     const unsigned int fe_index,
                                     const unsigned int vector_component = 0) const;
 
+  /**
+   * Return the active FE index of the cells in the given range of cell
+   * batches, as for example passed to the function of
+   * cell_loop_by_fe_index(). All cells in the range must have the same
+   * index. Returns zero if the DoFHandler @p vector_component is not an hp
+   * DoFHandler.
+   */
+  unsigned int
+  get_cell_range_fe_index (const std::pair<unsigned int,unsigned int> &range,
+                           const unsigned int vector_component = 0) const;
+
   //@}
 
   /**
@@ -652,6 +1014,55 @@ public:
    */
   unsigned int n_macro_cells () const;
 
+  /**
+   * Return the number of batches of inner faces, i.e., the faces that are
+   * handed to the face operation in loop(). Zero if the faces have not been
+   * set up.
+   */
+  unsigned int n_inner_face_batches () const;
+
+  /**
+   * Return the number of batches of faces at the boundary of the domain,
+   * i.e., the faces that are handed to the boundary operation in loop().
+   */
+  unsigned int n_boundary_face_batches () const;
+
+  /**
+   * Return the number of faces that are filled in the given face batch, which
+   * is between one and VectorizedArray::n_array_elements.
+   */
+  unsigned int n_active_entries_per_face_batch (const unsigned int face_batch_number) const;
+
+  /**
+   * Return the boundary id of the faces in the given boundary face batch.
+   */
+  types::boundary_id get_boundary_id (const unsigned int face_batch_number) const;
+
+  /**
+   * Return the connectivity of the given face batch to the cells.
+   */
+  const internal::MatrixFreeFunctions::FaceToCells<VectorizedArray<Number>::n_array_elements> &
+  get_face_info (const unsigned int face_batch_number) const;
+
+  /**
+   * Return the connectivity of face number @p face_number of the cells in
+   * the given cell batch to the neighboring cells, as used in
+   * loop_cell_centric().
+   */
+  const internal::MatrixFreeFunctions::FaceToCells<VectorizedArray<Number>::n_array_elements> &
+  get_face_info_by_cells (const unsigned int macro_cell_number,
+                          const unsigned int face_number) const;
+
+  /**
+   * Return the boundary ids of face number @p face_number of the cells in
+   * the given cell batch, with one entry per lane, as used in
+   * loop_cell_centric(). Faces in the interior of the domain get the id
+   * numbers::internal_face_boundary_id.
+   */
+  std::array<types::boundary_id, VectorizedArray<Number>::n_array_elements>
+  get_faces_by_cells_boundary_id (const unsigned int macro_cell_number,
+                                  const unsigned int face_number) const;
+
   /**
    * In case this structure was built based on a DoFHandler, this returns the
    * DoFHandler.
@@ -916,6 +1327,42 @@ private:
   void initialize_dof_handlers (const std::vector<const hp::DoFHandler<dim>*> &dof_handlers,
                                 const unsigned int                             level);
 
+  /**
+   * Collects the inner faces and the faces at the boundary between the cells
+   * of this structure into batches, see FaceInfo, and sets up the faces of
+   * the cell batches for the cell-centric loop if requested.
+   */
+  void initialize_face_info (const Triangulation<dim> &tria,
+                             const AdditionalData     &additional_data);
+
+  /**
+   * Sets the kernel variant of all elements in shape_info according to the
+   * given AdditionalData, timing the variants if requested.
+   */
+  void select_kernel_variants (const AdditionalData &additional_data);
+
+  /**
+   * Moves the data of all elements in shape_info to memory shared by the
+   * processes on each node if requested by the given AdditionalData.
+   */
+  void share_shape_info (const AdditionalData &additional_data);
+
+  /**
+   * Selects the scheme for task parallelism and the block size in the given
+   * AdditionalData, either from the tuning cache file or by timing a sample
+   * cell loop for a few candidates, see
+   * AdditionalData::tune_tasks_parallel_scheme. Reinitializes this object
+   * for each candidate, so the caller must reinitialize it with the selected
+   * data afterwards.
+   */
+  void select_tasks_parallel_scheme
+  (const Mapping<dim>                          &mapping,
+   const std::vector<const DoFHandler<dim> *>  &dof_handler,
+   const std::vector<const ConstraintMatrix *> &constraint,
+   const std::vector<IndexSet>                 &locally_owned_set,
+   const std::vector<hp::QCollection<1> >      &quad,
+   AdditionalData                              &additional_data);
+
   /**
    * This struct defines which DoFHandler has actually been given at
    * construction, in order to define the correct behavior when querying the
@@ -978,6 +1425,11 @@ private:
    */
   internal::MatrixFreeFunctions::MappingInfo<dim,Number> mapping_info;
 
+  /**
+   * Holds the connectivity between the face batches and the cells.
+   */
+  internal::MatrixFreeFunctions::FaceInfo<VectorizedArray<Number>::n_array_elements> face_info;
+
   /**
    * Contains shape value information on the unit cell.
    */
@@ -1118,6 +1570,104 @@ MatrixFree<dim,Number>::n_macro_cells () const
 
 
 
+template <int dim, typename Number>
+inline
+unsigned int
+MatrixFree<dim,Number>::n_inner_face_batches () const
+{
+  return face_info.n_inner_face_batches;
+}
+
+
+
+template <int dim, typename Number>
+inline
+unsigned int
+MatrixFree<dim,Number>::n_boundary_face_batches () const
+{
+  return face_info.n_boundary_face_batches;
+}
+
+
+
+template <int dim, typename Number>
+inline
+unsigned int
+MatrixFree<dim,Number>::n_active_entries_per_face_batch (const unsigned int face_batch_number) const
+{
+  AssertIndexRange (face_batch_number, face_info.faces.size());
+  const unsigned int vectorization_length = VectorizedArray<Number>::n_array_elements;
+  unsigned int n_filled = vectorization_length;
+  while (n_filled > 1 &&
+         face_info.faces[face_batch_number].cells_interior[n_filled-1] ==
+         numbers::invalid_unsigned_int)
+    --n_filled;
+  return n_filled;
+}
+
+
+
+template <int dim, typename Number>
+inline
+types::boundary_id
+MatrixFree<dim,Number>::get_boundary_id (const unsigned int face_batch_number) const
+{
+  Assert (face_batch_number >= face_info.n_inner_face_batches &&
+          face_batch_number < face_info.faces.size(),
+          ExcIndexRange (face_batch_number, face_info.n_inner_face_batches,
+                         face_info.faces.size()));
+  return face_info.faces[face_batch_number].boundary_id;
+}
+
+
+
+template <int dim, typename Number>
+inline
+const internal::MatrixFreeFunctions::FaceToCells<VectorizedArray<Number>::n_array_elements> &
+MatrixFree<dim,Number>::get_face_info (const unsigned int face_batch_number) const
+{
+  AssertIndexRange (face_batch_number, face_info.faces.size());
+  return face_info.faces[face_batch_number];
+}
+
+
+
+template <int dim, typename Number>
+inline
+const internal::MatrixFreeFunctions::FaceToCells<VectorizedArray<Number>::n_array_elements> &
+MatrixFree<dim,Number>::get_face_info_by_cells (const unsigned int macro_cell,
+                                                const unsigned int face_number) const
+{
+  AssertIndexRange (face_number, GeometryInfo<dim>::faces_per_cell);
+  AssertIndexRange (macro_cell*GeometryInfo<dim>::faces_per_cell+face_number,
+                    face_info.faces_by_cells.size());
+  return face_info.faces_by_cells[macro_cell*GeometryInfo<dim>::faces_per_cell+face_number];
+}
+
+
+
+template <int dim, typename Number>
+inline
+std::array<types::boundary_id, VectorizedArray<Number>::n_array_elements>
+MatrixFree<dim,Number>::get_faces_by_cells_boundary_id (const unsigned int macro_cell,
+                                                        const unsigned int face_number) const
+{
+  const unsigned int vectorization_length = VectorizedArray<Number>::n_array_elements;
+  AssertIndexRange (face_number, GeometryInfo<dim>::faces_per_cell);
+  AssertIndexRange ((macro_cell*GeometryInfo<dim>::faces_per_cell+face_number)*
+                    vectorization_length,
+                    face_info.faces_by_cells_boundary_id.size());
+  std::array<types::boundary_id, VectorizedArray<Number>::n_array_elements> boundary_ids;
+  const types::boundary_id *ids = &face_info.faces_by_cells_boundary_id
+                                  [(macro_cell*GeometryInfo<dim>::faces_per_cell+face_number)*
+                                   vectorization_length];
+  for (unsigned int v=0; v<vectorization_length; ++v)
+    boundary_ids[v] = ids[v];
+  return boundary_ids;
+}
+
+
+
 template <int dim, typename Number>
 inline
 unsigned int
@@ -1252,6 +1802,27 @@ MatrixFree<dim,Number>::create_cell_subrange_hp_by_index
 
 
 
+template <int dim, typename Number>
+inline
+unsigned int
+MatrixFree<dim,Number>::get_cell_range_fe_index
+(const std::pair<unsigned int,unsigned int> &range,
+ const unsigned int vector_component) const
+{
+  AssertIndexRange (vector_component, dof_info.size());
+  const std::vector<unsigned int> &fe_indices =
+    dof_info[vector_component].cell_active_fe_index;
+  if (fe_indices.empty() || range.second == range.first)
+    return 0;
+
+  AssertIndexRange (range.second, fe_indices.size()+1);
+  Assert (fe_indices[range.first] == fe_indices[range.second-1],
+          ExcMessage ("The cell range contains cells with different FE indices"));
+  return fe_indices[range.first];
+}
+
+
+
 template <int dim, typename Number>
 inline
 void
@@ -1260,6 +1831,8 @@ MatrixFree<dim,Number>::renumber_dofs (std::vector<types::global_dof_index> &ren
 {
   AssertIndexRange(vector_component, dof_info.size());
   dof_info[vector_component].renumber_dofs (renumbering);
+  dof_info[vector_component].compute_index_compression
+  (VectorizedArray<Number>::n_array_elements);
 }
 
 
@@ -1780,6 +2353,12 @@ namespace internal
   template <typename VectorStruct>
   void compress_finish_block (VectorStruct &vec,
                               std::integral_constant<bool, true>);
+  template <typename VectorStruct>
+  void update_ghost_values_progress_block (const VectorStruct &vec,
+                                           std::integral_constant<bool, true>);
+  template <typename VectorStruct>
+  void compress_progress_block (VectorStruct &vec,
+                                std::integral_constant<bool, true>);
 
   template <typename VectorStruct>
   bool update_ghost_values_start_block (const VectorStruct &,
@@ -1806,6 +2385,14 @@ namespace internal
   void compress_finish_block (VectorStruct &,
                               std::integral_constant<bool, false>)
   {}
+  template <typename VectorStruct>
+  void update_ghost_values_progress_block (const VectorStruct &,
+                                           std::integral_constant<bool, false>)
+  {}
+  template <typename VectorStruct>
+  void compress_progress_block (VectorStruct &,
+                                std::integral_constant<bool, false>)
+  {}
 
 
 
@@ -2085,6 +2672,108 @@ namespace internal
 
 
 
+  // let MPI advance the transfers started by update_ghost_values_start() and
+  // compress_start() while the cells that do not depend on them are worked on
+  template <typename VectorStruct>
+  inline
+  void update_ghost_values_progress (const VectorStruct &vec)
+  {
+    update_ghost_values_progress_block(vec,
+                                       std::integral_constant<bool, IsBlockVector<VectorStruct>::value>());
+  }
+
+
+
+  template <typename Number>
+  inline
+  void update_ghost_values_progress (const LinearAlgebra::distributed::Vector<Number> &vec)
+  {
+    vec.update_ghost_values_progress();
+  }
+
+
+
+  template <typename VectorStruct>
+  inline
+  void update_ghost_values_progress (const std::vector<VectorStruct> &vec)
+  {
+    for (unsigned int comp=0; comp<vec.size(); comp++)
+      update_ghost_values_progress(vec[comp]);
+  }
+
+
+
+  template <typename VectorStruct>
+  inline
+  void update_ghost_values_progress (const std::vector<VectorStruct *> &vec)
+  {
+    for (unsigned int comp=0; comp<vec.size(); comp++)
+      update_ghost_values_progress(*vec[comp]);
+  }
+
+
+
+  template <typename VectorStruct>
+  inline
+  void update_ghost_values_progress_block (const VectorStruct &vec,
+                                           std::integral_constant<bool, true>)
+  {
+    for (unsigned int i=0; i<vec.n_blocks(); ++i)
+      update_ghost_values_progress(vec.block(i));
+  }
+
+
+
+  template <typename VectorStruct>
+  inline
+  void compress_progress (VectorStruct &vec)
+  {
+    compress_progress_block(vec,
+                            std::integral_constant<bool, IsBlockVector<VectorStruct>::value>());
+  }
+
+
+
+  template <typename Number>
+  inline
+  void compress_progress (LinearAlgebra::distributed::Vector<Number> &vec)
+  {
+    vec.compress_progress();
+  }
+
+
+
+  template <typename VectorStruct>
+  inline
+  void compress_progress (std::vector<VectorStruct> &vec)
+  {
+    for (unsigned int comp=0; comp<vec.size(); comp++)
+      compress_progress(vec[comp]);
+  }
+
+
+
+  template <typename VectorStruct>
+  inline
+  void compress_progress (std::vector<VectorStruct *> &vec)
+  {
+    for (unsigned int comp=0; comp<vec.size(); comp++)
+      compress_progress(*vec[comp]);
+  }
+
+
+
+  template <typename VectorStruct>
+  inline
+  void compress_progress_block (VectorStruct &vec,
+                                std::integral_constant<bool, true>)
+  {
+    for (unsigned int i=0; i<vec.n_blocks(); ++i)
+      compress_progress(vec.block(i));
+  }
+
+
+
 #ifdef DEAL_II_WITH_THREADS
 
   // This defines the TBB data structures that are needed to schedule the
@@ -2112,7 +2801,10 @@ namespace internal
         std::pair<unsigned int, unsigned int> cell_range
         (task_info.partition_color_blocks_data[partition],
          task_info.partition_color_blocks_data[partition+1]);
-        worker(cell_range);
+        {
+          EventTrace::Scope trace_scope ("MatrixFree cell range", "MatrixFree");
+          worker(cell_range);
+        }
         if (is_blocked==true)
           dummy->spawn (*dummy);
         return (nullptr);
@@ -2248,6 +2940,7 @@ namespace internal
                                     ((block == task_info.position_short_block)?
                                      (task_info.block_size_last):(task_info.block_size));
               }
+            EventTrace::Scope trace_scope ("MatrixFree cell range", "MatrixFree");
             worker (cell_range);
           }
       }
@@ -2588,14 +3281,22 @@ MatrixFree<dim, Number>::cell_loop
 #endif
     // serial loop
     {
+      EventTrace::Scope trace_scope ("MatrixFree serial cell loop", "MatrixFree");
       std::pair<unsigned int,unsigned int> cell_range;
 
-      // First operate on cells where no ghost data is needed (inner cells)
-      {
-        cell_range.first = 0;
-        cell_range.second = size_info.boundary_cells_start;
-        cell_operation (*this, dst, src, cell_range);
-      }
+      // First operate on cells where no ghost data is needed (inner cells).
+      // Since many MPI implementations only advance nonblocking transfers
+      // inside MPI calls, work on chunks of cells and test for the
+      // completion of the ghost exchange in between
+      const unsigned int chunk_size = std::max (task_info.block_size, 1U);
+      for (cell_range.first = 0; cell_range.first < size_info.boundary_cells_start;
+           cell_range.first = cell_range.second)
+        {
+          cell_range.second = std::min (cell_range.first + chunk_size,
+                                        size_info.boundary_cells_start);
+          cell_operation (*this, dst, src, cell_range);
+          internal::update_ghost_values_progress(src);
+        }
 
       // before starting operations on cells that contain ghost nodes (outer
       // cells), wait for the MPI commands to finish
@@ -2611,12 +3312,16 @@ MatrixFree<dim, Number>::cell_loop
 
       internal::compress_start(dst);
 
-      // Finally operate on cells where no ghost data is needed (inner cells)
-      if (size_info.n_macro_cells > size_info.boundary_cells_end)
+      // Finally operate on cells where no ghost data is needed (inner
+      // cells), again in chunks to let the compress operation progress
+      for (cell_range.first = size_info.boundary_cells_end;
+           cell_range.first < size_info.n_macro_cells;
+           cell_range.first = cell_range.second)
         {
-          cell_range.first = size_info.boundary_cells_end;
-          cell_range.second = size_info.n_macro_cells;
+          cell_range.second = std::min (cell_range.first + chunk_size,
+                                        size_info.n_macro_cells);
           cell_operation (*this, dst, src, cell_range);
+          internal::compress_progress(dst);
         }
     }
 
@@ -2690,6 +3395,372 @@ MatrixFree<dim,Number>::cell_loop
 }
 
 
+
+template <int dim, typename Number>
+template <typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim,Number>::cell_loop_by_fe_index
+(const std::function<void (const MatrixFree<dim,Number> &,
+                           OutVector &,
+                           const InVector &,
+                           const std::pair<unsigned int,
+                           unsigned int> &,
+                           const unsigned int)> &cell_operation,
+ OutVector          &dst,
+ const InVector     &src,
+ const unsigned int  vector_component) const
+{
+  AssertIndexRange (vector_component, dof_info.size());
+  const unsigned int n_fe_indices =
+    dof_info[vector_component].cell_active_fe_index.empty() ? 1 :
+    dof_info[vector_component].max_fe_index;
+
+  // the cells within the ranges of the loop are sorted by the active FE
+  // index, so each group is a contiguous subrange
+  const std::function<void (const MatrixFree<dim,Number> &,
+                            OutVector &,
+                            const InVector &,
+                            const std::pair<unsigned int,
+                            unsigned int> &)>
+  function = [&] (const MatrixFree<dim,Number> &data,
+                  OutVector &dst,
+                  const InVector &src,
+                  const std::pair<unsigned int,unsigned int> &range)
+  {
+    for (unsigned int fe_index=0; fe_index<n_fe_indices; ++fe_index)
+      {
+        const std::pair<unsigned int,unsigned int> subrange =
+          data.create_cell_subrange_hp_by_index (range, fe_index, vector_component);
+        if (subrange.second > subrange.first)
+          cell_operation (data, dst, src, subrange, fe_index);
+      }
+  };
+  cell_loop (function, dst, src);
+}
+
+
+
+template <int dim, typename Number>
+template <typename CLASS, typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim,Number>::cell_loop_by_fe_index
+(void (CLASS::*function_pointer)(const MatrixFree<dim,Number> &,
+                                 OutVector &,
+                                 const InVector &,
+                                 const std::pair<unsigned int,
+                                 unsigned int> &,
+                                 const unsigned int)const,
+ const CLASS        *owning_class,
+ OutVector          &dst,
+ const InVector     &src,
+ const unsigned int  vector_component) const
+{
+  std::function<void (const MatrixFree<dim,Number> &,
+                      OutVector &,
+                      const InVector &,
+                      const std::pair<unsigned int,
+                      unsigned int> &,
+                      const unsigned int)>
+  function = std::bind<void>(function_pointer,
+                             owning_class,
+                             std::placeholders::_1,
+                             std::placeholders::_2,
+                             std::placeholders::_3,
+                             std::placeholders::_4,
+                             std::placeholders::_5);
+  cell_loop_by_fe_index (function, dst, src, vector_component);
+}
+
+
+
+template <int dim, typename Number>
+template <typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim, Number>::loop
+(const std::function<void (const MatrixFree<dim,Number> &,
+                           OutVector &,
+                           const InVector &,
+                           const std::pair<unsigned int,
+                           unsigned int> &)> &cell_operation,
+ const std::function<void (const MatrixFree<dim,Number> &,
+                           OutVector &,
+                           const InVector &,
+                           const std::pair<unsigned int,
+                           unsigned int> &)> &face_operation,
+ const std::function<void (const MatrixFree<dim,Number> &,
+                           OutVector &,
+                           const InVector &,
+                           const std::pair<unsigned int,
+                           unsigned int> &)> &boundary_operation,
+ OutVector       &dst,
+ const InVector  &src) const
+{
+  Assert (face_info.faces.size() > 0 || size_info.n_macro_cells == 0,
+          ExcMessage ("The faces have not been set up. Set "
+                      "AdditionalData::mapping_update_flags_inner_faces or "
+                      "AdditionalData::mapping_update_flags_boundary_faces."));
+
+  // in any case, need to start the ghost import at the beginning
+  bool ghosts_were_not_set = internal::update_ghost_values_start (src);
+
+  {
+    EventTrace::Scope trace_scope ("MatrixFree serial loop", "MatrixFree");
+    std::pair<unsigned int,unsigned int> range;
+
+    // First operate on cells where no ghost data is needed (inner cells)
+    range.first = 0;
+    range.second = size_info.boundary_cells_start;
+    cell_operation (*this, dst, src, range);
+
+    // before starting operations on cells that contain ghost nodes (outer
+    // cells), wait for the MPI commands to finish
+    internal::update_ghost_values_finish(src);
+
+    range.first = size_info.boundary_cells_start;
+    range.second = size_info.n_macro_cells;
+    if (range.second > range.first)
+      cell_operation (*this, dst, src, range);
+
+    // all faces of a cell are adjacent to locally owned cells, so face
+    // integrals do not depend on ghost data and could be overlapped with the
+    // communication
+    range.first = 0;
+    range.second = face_info.n_inner_face_batches;
+    if (range.second > range.first)
+      face_operation (*this, dst, src, range);
+
+    range.first = face_info.n_inner_face_batches;
+    range.second = face_info.n_inner_face_batches + face_info.n_boundary_face_batches;
+    if (range.second > range.first)
+      boundary_operation (*this, dst, src, range);
+
+    internal::compress_start(dst);
+  }
+
+  internal::compress_finish(dst);
+  internal::reset_ghost_values(src, ghosts_were_not_set);
+}
+
+
+
+template <int dim, typename Number>
+template <typename CLASS, typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim,Number>::loop
+(void (CLASS::*cell_operation)(const MatrixFree<dim,Number> &,
+                               OutVector &,
+                               const InVector &,
+                               const std::pair<unsigned int,
+                               unsigned int> &)const,
+ void (CLASS::*face_operation)(const MatrixFree<dim,Number> &,
+                               OutVector &,
+                               const InVector &,
+                               const std::pair<unsigned int,
+                               unsigned int> &)const,
+ void (CLASS::*boundary_operation)(const MatrixFree<dim,Number> &,
+                                   OutVector &,
+                                   const InVector &,
+                                   const std::pair<unsigned int,
+                                   unsigned int> &)const,
+ const CLASS    *owning_class,
+ OutVector      &dst,
+ const InVector &src) const
+{
+  typedef std::function<void (const MatrixFree<dim,Number> &,
+                              OutVector &,
+                              const InVector &,
+                              const std::pair<unsigned int,
+                              unsigned int> &)> Function;
+  const Function cell_function = std::bind<void>(cell_operation,
+                                                 owning_class,
+                                                 std::placeholders::_1,
+                                                 std::placeholders::_2,
+                                                 std::placeholders::_3,
+                                                 std::placeholders::_4);
+  const Function face_function = std::bind<void>(face_operation,
+                                                 owning_class,
+                                                 std::placeholders::_1,
+                                                 std::placeholders::_2,
+                                                 std::placeholders::_3,
+                                                 std::placeholders::_4);
+  const Function boundary_function = std::bind<void>(boundary_operation,
+                                                     owning_class,
+                                                     std::placeholders::_1,
+                                                     std::placeholders::_2,
+                                                     std::placeholders::_3,
+                                                     std::placeholders::_4);
+  loop (cell_function, face_function, boundary_function, dst, src);
+}
+
+
+
+template <int dim, typename Number>
+template <typename CLASS, typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim,Number>::loop
+(void (CLASS::*cell_operation)(const MatrixFree<dim,Number> &,
+                               OutVector &,
+                               const InVector &,
+                               const std::pair<unsigned int,
+                               unsigned int> &),
+ void (CLASS::*face_operation)(const MatrixFree<dim,Number> &,
+                               OutVector &,
+                               const InVector &,
+                               const std::pair<unsigned int,
+                               unsigned int> &),
+ void (CLASS::*boundary_operation)(const MatrixFree<dim,Number> &,
+                                   OutVector &,
+                                   const InVector &,
+                                   const std::pair<unsigned int,
+                                   unsigned int> &),
+ CLASS          *owning_class,
+ OutVector      &dst,
+ const InVector &src) const
+{
+  typedef std::function<void (const MatrixFree<dim,Number> &,
+                              OutVector &,
+                              const InVector &,
+                              const std::pair<unsigned int,
+                              unsigned int> &)> Function;
+  const Function cell_function = std::bind<void>(cell_operation,
+                                                 owning_class,
+                                                 std::placeholders::_1,
+                                                 std::placeholders::_2,
+                                                 std::placeholders::_3,
+                                                 std::placeholders::_4);
+  const Function face_function = std::bind<void>(face_operation,
+                                                 owning_class,
+                                                 std::placeholders::_1,
+                                                 std::placeholders::_2,
+                                                 std::placeholders::_3,
+                                                 std::placeholders::_4);
+  const Function boundary_function = std::bind<void>(boundary_operation,
+                                                     owning_class,
+                                                     std::placeholders::_1,
+                                                     std::placeholders::_2,
+                                                     std::placeholders::_3,
+                                                     std::placeholders::_4);
+  loop (cell_function, face_function, boundary_function, dst, src);
+}
+
+
+
+
+template <int dim, typename Number>
+template <typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim, Number>::loop_cell_centric
+(const std::function<void (const MatrixFree<dim,Number> &,
+                           OutVector &,
+                           const InVector &,
+                           const std::pair<unsigned int,
+                           unsigned int> &)> &cell_operation,
+ OutVector       &dst,
+ const InVector  &src) const
+{
+  Assert (face_info.faces_by_cells.size() ==
+          size_info.n_macro_cells * GeometryInfo<dim>::faces_per_cell,
+          ExcMessage ("The faces of the cells have not been set up. Set "
+                      "AdditionalData::mapping_update_flags_faces_by_cells."));
+
+  // the face integrals of the cells read the source vector on the
+  // neighbors, so the ghost values must be available for all cell batches
+  bool ghosts_were_not_set = internal::update_ghost_values_start (src);
+  internal::update_ghost_values_finish (src);
+
+  // each cell batch only writes into the vector entries of its own cells,
+  // so all batches can be worked on in parallel without synchronization
+  const auto work_on_range = [&] (const unsigned int begin,
+                                  const unsigned int end)
+  {
+    EventTrace::Scope trace_scope ("MatrixFree cell range", "MatrixFree");
+    cell_operation (*this, dst, src, std::make_pair (begin, end));
+  };
+
+  if (task_info.use_multithreading == true && task_info.block_size > 0)
+    parallel::apply_to_subranges (0U, size_info.n_macro_cells,
+                                  work_on_range, task_info.block_size);
+  else if (size_info.n_macro_cells > 0)
+    {
+      EventTrace::Scope trace_scope ("MatrixFree serial cell-centric loop",
+                                     "MatrixFree");
+      cell_operation (*this, dst, src,
+                      std::make_pair (0U, size_info.n_macro_cells));
+    }
+
+  internal::compress_start(dst);
+  internal::compress_finish(dst);
+  internal::reset_ghost_values(src, ghosts_were_not_set);
+}
+
+
+
+template <int dim, typename Number>
+template <typename CLASS, typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim,Number>::loop_cell_centric
+(void (CLASS::*function_pointer)(const MatrixFree<dim,Number> &,
+                                 OutVector &,
+                                 const InVector &,
+                                 const std::pair<unsigned int,
+                                 unsigned int> &)const,
+ const CLASS    *owning_class,
+ OutVector      &dst,
+ const InVector &src) const
+{
+  std::function<void (const MatrixFree<dim,Number> &,
+                      OutVector &,
+                      const InVector &,
+                      const std::pair<unsigned int,
+                      unsigned int> &)>
+  function = std::bind<void>(function_pointer,
+                             owning_class,
+                             std::placeholders::_1,
+                             std::placeholders::_2,
+                             std::placeholders::_3,
+                             std::placeholders::_4);
+  loop_cell_centric (function, dst, src);
+}
+
+
+
+template <int dim, typename Number>
+template <typename CLASS, typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim,Number>::loop_cell_centric
+(void(CLASS::*function_pointer)(const MatrixFree<dim,Number> &,
+                                OutVector &,
+                                const InVector &,
+                                const std::pair<unsigned int,
+                                unsigned int> &),
+ CLASS          *owning_class,
+ OutVector      &dst,
+ const InVector &src) const
+{
+  std::function<void (const MatrixFree<dim,Number> &,
+                      OutVector &,
+                      const InVector &,
+                      const std::pair<unsigned int,
+                      unsigned int> &)>
+  function = std::bind<void>(function_pointer,
+                             owning_class,
+                             std::placeholders::_1,
+                             std::placeholders::_2,
+                             std::placeholders::_3,
+                             std::placeholders::_4);
+  loop_cell_centric (function, dst, src);
+}
+
+
+
 #endif  // ifndef DOXYGEN
 
 
@@ -19,19 +19,28 @@
 
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/memory_tracker.h>
 #include <deal.II/base/tensor_product_polynomials.h>
 #include <deal.II/base/polynomials_piecewise.h>
 #include <deal.II/base/mpi.h>
+#include <deal.II/base/multithread_info.h>
 #include <deal.II/dofs/dof_accessor.h>
 #include <deal.II/fe/fe_poly.h>
 #include <deal.II/hp/q_collection.h>
 #include <deal.II/distributed/tria.h>
 
 #include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/evaluation_selector.h>
 #include <deal.II/matrix_free/shape_info.templates.h>
 #include <deal.II/matrix_free/mapping_info.templates.h>
 #include <deal.II/matrix_free/dof_info.templates.h>
 
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -68,6 +77,7 @@ copy_from (const MatrixFree<dim,Number> &v)
   constraint_pool_data = v.constraint_pool_data;
   constraint_pool_row_index = v.constraint_pool_row_index;
   mapping_info = v.mapping_info;
+  face_info = v.face_info;
   shape_info = v.shape_info;
   cell_level_index = v.cell_level_index;
   task_info = v.task_info;
@@ -87,6 +97,20 @@ internal_reinit(const Mapping<dim>                          &mapping,
                 const std::vector<hp::QCollection<1> >      &quad,
                 const typename MatrixFree<dim,Number>::AdditionalData additional_data)
 {
+  if (additional_data.tune_tasks_parallel_scheme == true &&
+      additional_data.initialize_indices == true &&
+      additional_data.initialize_mapping == true)
+    {
+      AdditionalData tuned_data = additional_data;
+      tuned_data.tune_tasks_parallel_scheme = false;
+      select_tasks_parallel_scheme (mapping, dof_handler, constraint,
+                                    locally_owned_set, quad, tuned_data);
+      internal_reinit (mapping, dof_handler, constraint, locally_owned_set,
+                       quad, tuned_data);
+      return;
+    }
+
+  MemoryTracker::Scope memory_scope ("MatrixFree");
 
   // Reads out the FE information and stores the shape function values,
   // gradients and Hessians for quadrature points.
@@ -151,13 +175,21 @@ internal_reinit(const Mapping<dim>                          &mapping,
         }
       else
 #endif
-        task_info.use_multithreading = false;
+        {
+          task_info.use_multithreading = false;
+          task_info.block_size = additional_data.tasks_block_size;
+        }
 
       // set dof_indices together with constraint_indicator and
       // constraint_pool_data. It also reorders the way cells are gone through
       // (to separate cells with overlap to other processors from others
       // without).
       initialize_indices (constraint, locally_owned_set);
+
+      if (additional_data.mapping_update_flags_inner_faces != update_default ||
+          additional_data.mapping_update_flags_boundary_faces != update_default ||
+          additional_data.mapping_update_flags_faces_by_cells != update_default)
+        initialize_face_info (dof_handler[0]->get_triangulation(), additional_data);
     }
 
   // initialize bare structures
@@ -196,10 +228,20 @@ internal_reinit(const Mapping<dim>                          &mapping,
     {
       mapping_info.initialize (dof_handler[0]->get_triangulation(), cell_level_index,
                                dof_info[0].cell_active_fe_index, mapping, quad,
-                               additional_data.mapping_update_flags);
+                               additional_data.mapping_update_flags,
+                               additional_data.compute_jacobians_on_the_fly);
+      if (face_info.faces.size() > 0 || face_info.faces_by_cells.size() > 0)
+        mapping_info.initialize_faces (dof_handler[0]->get_triangulation(),
+                                       cell_level_index, face_info, mapping, quad,
+                                       additional_data.mapping_update_flags_inner_faces |
+                                       additional_data.mapping_update_flags_boundary_faces |
+                                       additional_data.mapping_update_flags_faces_by_cells);
 
       mapping_is_initialized = true;
     }
+
+  select_kernel_variants (additional_data);
+  share_shape_info (additional_data);
 }
 
 
@@ -213,6 +255,14 @@ internal_reinit(const Mapping<dim>                            &mapping,
                 const std::vector<hp::QCollection<1> >        &quad,
                 const typename MatrixFree<dim,Number>::AdditionalData additional_data)
 {
+  MemoryTracker::Scope memory_scope ("MatrixFree");
+
+  AssertThrow (additional_data.mapping_update_flags_inner_faces == update_default &&
+               additional_data.mapping_update_flags_boundary_faces == update_default &&
+               additional_data.mapping_update_flags_faces_by_cells == update_default,
+               ExcNotImplemented("Face integrals are not implemented for "
+                                 "hp::DoFHandler."));
+
   // Reads out the FE information and stores the shape function values,
   // gradients and Hessians for quadrature points.
   {
@@ -285,7 +335,10 @@ internal_reinit(const Mapping<dim>                            &mapping,
         }
       else
 #endif
-        task_info.use_multithreading = false;
+        {
+          task_info.use_multithreading = false;
+          task_info.block_size = additional_data.tasks_block_size;
+        }
 
       // set dof_indices together with constraint_indicator and
       // constraint_pool_data. It also reorders the way cells are gone through
@@ -328,10 +381,14 @@ internal_reinit(const Mapping<dim>                            &mapping,
     {
       mapping_info.initialize (dof_handler[0]->get_triangulation(), cell_level_index,
                                dof_info[0].cell_active_fe_index, mapping, quad,
-                               additional_data.mapping_update_flags);
+                               additional_data.mapping_update_flags,
+                               additional_data.compute_jacobians_on_the_fly);
 
       mapping_is_initialized = true;
     }
+
+  select_kernel_variants (additional_data);
+  share_shape_info (additional_data);
 }
 
 
@@ -693,6 +750,10 @@ void MatrixFree<dim,Number>::initialize_indices
       if (dof_handlers.active_dof_handler == DoFHandlers::hp)
         dof_info[0].compute_renumber_hp_serial (size_info, renumbering,
                                                 irregular_cells);
+
+      // the serial loop works on chunks of cells in order to let MPI advance
+      // the communication in between, see MatrixFree::cell_loop()
+      dof_info[0].guess_block_size (size_info, task_info);
     }
 
   // Finally perform the renumbering. We also want to group several cells
@@ -761,20 +822,489 @@ void MatrixFree<dim,Number>::initialize_indices
     }
   AssertDimension(constraint_pool_data.size(), length);
   for (unsigned int no=0; no<n_fe; ++no)
-    dof_info[no].reorder_cells(size_info, renumbering,
-                               constraint_pool_row_index,
-                               irregular_cells, vectorization_length);
+    {
+      dof_info[no].reorder_cells(size_info, renumbering,
+                                 constraint_pool_row_index,
+                                 irregular_cells, vectorization_length);
+      dof_info[no].compute_index_compression (vectorization_length);
+    }
 
   indices_are_initialized = true;
 }
 
 
 
+template <int dim, typename Number>
+void MatrixFree<dim,Number>::initialize_face_info (const Triangulation<dim> &tria,
+                                                   const AdditionalData     &additional_data)
+{
+  const unsigned int vectorization_length = VectorizedArray<Number>::n_array_elements;
+  const unsigned int faces_per_cell = GeometryInfo<dim>::faces_per_cell;
+  face_info.clear();
+
+  const bool face_batches =
+    additional_data.mapping_update_flags_inner_faces != update_default ||
+    additional_data.mapping_update_flags_boundary_faces != update_default;
+  const bool faces_by_cells =
+    additional_data.mapping_update_flags_faces_by_cells != update_default;
+  if (faces_by_cells)
+    {
+      face_info.faces_by_cells.resize (size_info.n_macro_cells*faces_per_cell);
+      face_info.faces_by_cells_boundary_id.resize
+      (size_info.n_macro_cells*faces_per_cell*vectorization_length,
+       numbers::internal_face_boundary_id);
+    }
+
+  // map from the level and index of a cell to its position within the cell
+  // batches. The entries that only fill up the last lanes of irregular macro
+  // cells are skipped
+  std::map<std::pair<unsigned int,unsigned int>, unsigned int> cell_position;
+  for (unsigned int cell=0; cell<size_info.n_macro_cells; ++cell)
+    for (unsigned int v=0; v<n_components_filled(cell); ++v)
+      cell_position[cell_level_index[cell*vectorization_length+v]] =
+        cell*vectorization_length+v;
+
+  // collect the faces, grouped by the face numbers on the two sides for inner
+  // faces and by the face number and the boundary id for boundary faces. Each
+  // inner face is visited from both sides, so only add it from the side with
+  // the smaller position
+  std::map<std::pair<unsigned int,unsigned int>,
+      std::vector<std::pair<unsigned int,unsigned int> > > inner_faces;
+  std::map<std::pair<unsigned int,types::boundary_id>,
+      std::vector<unsigned int> > boundary_faces;
+  for (unsigned int cell=0; cell<size_info.n_macro_cells; ++cell)
+    for (unsigned int v=0; v<n_components_filled(cell); ++v)
+      {
+        const unsigned int position = cell*vectorization_length+v;
+        typename Triangulation<dim>::cell_iterator
+        cell_it (&tria, cell_level_index[position].first,
+                 cell_level_index[position].second);
+        for (unsigned int f=0; f<faces_per_cell; ++f)
+          {
+            internal::MatrixFreeFunctions::FaceToCells<VectorizedArray<Number>::n_array_elements>
+            *face_by_cells = faces_by_cells ?
+                             &face_info.faces_by_cells[cell*faces_per_cell+f] : nullptr;
+            if (face_by_cells != nullptr)
+              {
+                face_by_cells->interior_face_no = f;
+                face_by_cells->exterior_face_no = GeometryInfo<dim>::opposite_face[f];
+                face_by_cells->cells_interior[v] = position;
+              }
+
+            if (cell_it->at_boundary(f))
+              {
+                if (face_by_cells != nullptr)
+                  face_info.faces_by_cells_boundary_id
+                  [(cell*faces_per_cell+f)*vectorization_length+v] =
+                    cell_it->face(f)->boundary_id();
+                if (face_batches)
+                  boundary_faces[std::make_pair(f, cell_it->face(f)->boundary_id())]
+                  .push_back (position);
+                continue;
+              }
+
+            const typename Triangulation<dim>::cell_iterator neighbor =
+              cell_it->neighbor(f);
+            AssertThrow (neighbor->level() == cell_it->level() &&
+                         (dof_handlers.level != numbers::invalid_unsigned_int ||
+                          neighbor->has_children() == false),
+                         ExcNotImplemented("Face integrals are only implemented "
+                                           "for faces between cells of the "
+                                           "same refinement level."));
+            const std::map<std::pair<unsigned int,unsigned int>,
+                  unsigned int>::const_iterator neighbor_position =
+                    cell_position.find (std::make_pair (neighbor->level(),
+                                                        neighbor->index()));
+            AssertThrow (neighbor_position != cell_position.end(),
+                         ExcNotImplemented("Face integrals are only implemented "
+                                           "for faces between cells stored in "
+                                           "this MatrixFree object, not for "
+                                           "faces to ghost cells."));
+            const unsigned int neighbor_face_no = cell_it->neighbor_of_neighbor(f);
+
+            // all lanes of a cell batch must see the face with the same face
+            // number from the neighbor, which holds in standard orientation
+            if (face_by_cells != nullptr)
+              {
+                AssertThrow (neighbor_face_no == GeometryInfo<dim>::opposite_face[f],
+                             ExcNotImplemented("The cell-centric loop is only "
+                                               "implemented for faces in "
+                                               "standard orientation."));
+                face_by_cells->cells_exterior[v] = neighbor_position->second;
+              }
+
+            if (face_batches && position < neighbor_position->second)
+              inner_faces[std::make_pair(f, neighbor_face_no)]
+              .push_back (std::make_pair (position, neighbor_position->second));
+          }
+      }
+
+  for (typename std::map<std::pair<unsigned int,unsigned int>,
+       std::vector<std::pair<unsigned int,unsigned int> > >::const_iterator
+       it = inner_faces.begin(); it != inner_faces.end(); ++it)
+    for (unsigned int i=0; i<it->second.size(); i+=vectorization_length)
+      {
+        internal::MatrixFreeFunctions::FaceToCells<VectorizedArray<Number>::n_array_elements> face;
+        face.interior_face_no = it->first.first;
+        face.exterior_face_no = it->first.second;
+        for (unsigned int v=0; v<vectorization_length && i+v<it->second.size(); ++v)
+          {
+            face.cells_interior[v] = it->second[i+v].first;
+            face.cells_exterior[v] = it->second[i+v].second;
+          }
+        face_info.faces.push_back (face);
+      }
+  face_info.n_inner_face_batches = face_info.faces.size();
+
+  for (typename std::map<std::pair<unsigned int,types::boundary_id>,
+       std::vector<unsigned int> >::const_iterator
+       it = boundary_faces.begin(); it != boundary_faces.end(); ++it)
+    for (unsigned int i=0; i<it->second.size(); i+=vectorization_length)
+      {
+        internal::MatrixFreeFunctions::FaceToCells<VectorizedArray<Number>::n_array_elements> face;
+        face.interior_face_no = it->first.first;
+        face.exterior_face_no = it->first.first;
+        face.boundary_id = it->first.second;
+        for (unsigned int v=0; v<vectorization_length && i+v<it->second.size(); ++v)
+          face.cells_interior[v] = it->second[i+v];
+        face_info.faces.push_back (face);
+      }
+  face_info.n_boundary_face_batches =
+    face_info.faces.size() - face_info.n_inner_face_batches;
+}
+
+
+
+template <int dim, typename Number>
+void MatrixFree<dim,Number>::select_kernel_variants
+(const AdditionalData &additional_data)
+{
+  using namespace internal::MatrixFreeFunctions;
+
+  // apply the evaluation and integration of values and gradients on a
+  // single component repeatedly and return the best time of a few runs. The
+  // kernels are selected at runtime through the same template specializations
+  // as for FEEvaluation with fixed degree
+  auto time_kernel = [] (const ShapeInfo<VectorizedArray<Number> > &shape)
+  {
+    const unsigned int dofs_per_cell = shape.dofs_per_component_on_cell;
+    const unsigned int n_q_points = shape.n_q_points;
+    AlignedVector<VectorizedArray<Number> > data (2*dofs_per_cell + (dim+1)*n_q_points);
+    AlignedVector<VectorizedArray<Number> > scratch
+    (3*std::max(Utilities::fixed_power<dim>(shape.fe_degree+1)+1, dofs_per_cell) +
+     2*n_q_points);
+    for (unsigned int i=0; i<dofs_per_cell; ++i)
+      data[i] = Number(1)/(i+1);
+
+    // integrate into a separate array such that the input does not change
+    // over the repetitions
+    VectorizedArray<Number> *values_dofs_in[1] = {data.begin()};
+    VectorizedArray<Number> *values_dofs_out[1] = {data.begin() + dofs_per_cell};
+    VectorizedArray<Number> *values_quad[1] = {data.begin() + 2*dofs_per_cell};
+    VectorizedArray<Number> *gradients_quad[1][dim];
+    VectorizedArray<Number> *hessians_quad[1][(dim*(dim+1))/2];
+    for (unsigned int d=0; d<dim; ++d)
+      gradients_quad[0][d] = values_quad[0] + (d+1)*n_q_points;
+    for (unsigned int d=0; d<(dim*(dim+1))/2; ++d)
+      hessians_quad[0][d] = nullptr;
+
+    const unsigned int n_repetitions = std::max(1U, 100000U/dofs_per_cell);
+    double best_time = std::numeric_limits<double>::max();
+    for (unsigned int run=0; run<3; ++run)
+      {
+        const auto begin = std::chrono::steady_clock::now();
+        for (unsigned int r=0; r<n_repetitions; ++r)
+          {
+            SelectEvaluator<dim,-1,0,1,Number>::evaluate
+            (shape, values_dofs_in, values_quad, gradients_quad, hessians_quad,
+             scratch.begin(), true, true, false);
+            SelectEvaluator<dim,-1,0,1,Number>::integrate
+            (shape, values_dofs_out, values_quad, gradients_quad,
+             scratch.begin(), true, true);
+          }
+        best_time = std::min(best_time,
+                             std::chrono::duration<double>
+                             (std::chrono::steady_clock::now() - begin).count());
+      }
+    return best_time;
+  };
+
+  const KernelVariant variants[] = {kernel_default, kernel_general,
+                                    kernel_even_odd,
+                                    kernel_transform_to_collocation
+                                   };
+  const unsigned int n_variants = sizeof(variants)/sizeof(variants[0]);
+
+  auto select_kernel_variant = [&] (ShapeInfo<VectorizedArray<Number> > &shape)
+  {
+    shape.kernel_variant = shape.supports_kernel_variant(additional_data.kernel_variant) ?
+                           additional_data.kernel_variant : kernel_default;
+
+    // the runtime selection only reaches the optimized kernels for the
+    // degrees and quadrature formulas listed in SelectEvaluator
+    if (additional_data.tune_kernel_variant == false ||
+        shape.element_type > tensor_general ||
+        shape.fe_degree > 9 ||
+        shape.n_q_points_1d < shape.fe_degree+1 ||
+        shape.n_q_points_1d > shape.fe_degree+2)
+      return;
+
+    std::vector<double> times (n_variants, std::numeric_limits<double>::max());
+    for (unsigned int v=0; v<n_variants; ++v)
+      if (shape.supports_kernel_variant(variants[v]))
+        {
+          shape.kernel_variant = variants[v];
+          times[v] = time_kernel (shape);
+        }
+
+    // all processes must take the same choice because the kernels differ in
+    // roundoff, and all of them skip the same variants
+    if (Utilities::MPI::job_supports_mpi())
+      {
+        std::vector<double> sum_times (n_variants);
+        Utilities::MPI::sum (times, size_info.communicator, sum_times);
+        times.swap (sum_times);
+      }
+
+    shape.kernel_variant =
+      variants[std::min_element(times.begin(), times.end()) - times.begin()];
+  };
+
+  // the entries of the table that are not used in the hp case have no
+  // quadrature points
+  for (unsigned int no=0; no<shape_info.size(0); ++no)
+    for (unsigned int nq=0; nq<shape_info.size(1); ++nq)
+      for (unsigned int fe_no=0; fe_no<shape_info.size(2); ++fe_no)
+        for (unsigned int q_no=0; q_no<shape_info.size(3); ++q_no)
+          if (shape_info(no,nq,fe_no,q_no).n_q_points > 0)
+            select_kernel_variant (shape_info(no,nq,fe_no,q_no));
+}
+
+
+
+template <int dim, typename Number>
+void MatrixFree<dim,Number>::share_shape_info
+(const AdditionalData &additional_data)
+{
+#ifdef DEAL_II_WITH_MPI
+  if (additional_data.share_shape_info_on_node == false ||
+      Utilities::MPI::job_supports_mpi() == false)
+    return;
+
+  // all processes hold the same data, so take the one of the first process
+  for (unsigned int no=0; no<shape_info.size(0); ++no)
+    for (unsigned int nq=0; nq<shape_info.size(1); ++nq)
+      for (unsigned int fe_no=0; fe_no<shape_info.size(2); ++fe_no)
+        for (unsigned int q_no=0; q_no<shape_info.size(3); ++q_no)
+          shape_info(no,nq,fe_no,q_no).replicate_across_communicator
+          (size_info.communicator, 0);
+#else
+  (void)additional_data;
+#endif
+}
+
+
+
+template <int dim, typename Number>
+void MatrixFree<dim,Number>::select_tasks_parallel_scheme
+(const Mapping<dim>                          &mapping,
+ const std::vector<const DoFHandler<dim> *>  &dof_handler,
+ const std::vector<const ConstraintMatrix *> &constraint,
+ const std::vector<IndexSet>                 &locally_owned_set,
+ const std::vector<hp::QCollection<1> >      &quad,
+ AdditionalData                              &additional_data)
+{
+  // the candidates do not need the final kernels and the shared memory, so
+  // do not spend time on them
+  AdditionalData sample_data = additional_data;
+  sample_data.tasks_block_size = 0;
+  sample_data.tune_kernel_variant = false;
+  sample_data.share_shape_info_on_node = false;
+  internal_reinit (mapping, dof_handler, constraint, locally_owned_set, quad,
+                   sample_data);
+
+  // the block size guessed by DoFInfo depends on the number of cells of
+  // each process, so the candidates and the cache refer to multiples of it
+  const unsigned int guessed_block_size = task_info.block_size;
+  auto block_size = [&] (const double factor)
+  {
+    return factor == 1. ? 0U :
+           std::max (1U, static_cast<unsigned int>(factor*guessed_block_size + 0.5));
+  };
+
+  std::vector<std::pair<typename AdditionalData::TasksParallelScheme,double> > candidates;
+#ifdef DEAL_II_WITH_THREADS
+  if (MultithreadInfo::n_threads() > 1)
+    {
+      candidates.emplace_back (AdditionalData::none, 1.);
+      candidates.emplace_back (AdditionalData::partition_partition, 0.5);
+      candidates.emplace_back (AdditionalData::partition_partition, 1.);
+      candidates.emplace_back (AdditionalData::partition_partition, 2.);
+      candidates.emplace_back (AdditionalData::partition_color, 1.);
+      candidates.emplace_back (AdditionalData::color, 1.);
+    }
+  else
+#endif
+    {
+      candidates.emplace_back (AdditionalData::none, 0.5);
+      candidates.emplace_back (AdditionalData::none, 1.);
+      candidates.emplace_back (AdditionalData::none, 2.);
+    }
+
+  // the key of the cache is the same on all processes because it is
+  // composed on the first one
+  const bool mpi = Utilities::MPI::job_supports_mpi();
+  const types::global_dof_index n_cells =
+    mpi ? Utilities::MPI::sum (static_cast<types::global_dof_index>(size_info.n_active_cells),
+                               size_info.communicator) :
+    size_info.n_active_cells;
+  std::string key;
+  std::string cache;
+  if (size_info.my_pid == 0)
+    {
+      std::ostringstream key_stream;
+      key_stream << Utilities::System::get_hostname() << ' '
+                 << MultithreadInfo::n_threads() << ' '
+                 << size_info.n_procs << ' '
+                 << dim << ' '
+                 << dof_handler[0]->get_fe().degree << ' '
+                 << sizeof(Number) << ' '
+                 << static_cast<unsigned int>(std::log2(std::max<double>(n_cells, 1)));
+      key = key_stream.str();
+
+      if (additional_data.tasks_tuning_cache_file.empty() == false)
+        {
+          std::ifstream file (additional_data.tasks_tuning_cache_file.c_str());
+          std::ostringstream cache_stream;
+          cache_stream << file.rdbuf();
+          cache = cache_stream.str();
+        }
+    }
+  if (mpi)
+    {
+      Utilities::MPI::broadcast (key, size_info.communicator);
+      Utilities::MPI::broadcast (cache, size_info.communicator);
+    }
+
+  // each line holds the seven entries of the key followed by the index of
+  // the scheme, the factor of the guessed block size, and the time
+  {
+    std::istringstream cache_stream (cache);
+    std::string line;
+    while (std::getline (cache_stream, line))
+      {
+        std::istringstream line_stream (line);
+        std::string hostname;
+        unsigned int numbers[6];
+        line_stream >> hostname;
+        for (unsigned int i=0; i<6; ++i)
+          line_stream >> numbers[i];
+        std::ostringstream line_key;
+        line_key << hostname;
+        for (unsigned int i=0; i<6; ++i)
+          line_key << ' ' << numbers[i];
+
+        unsigned int scheme;
+        double factor;
+        line_stream >> scheme >> factor;
+        if (line_stream && line_key.str() == key && scheme <= AdditionalData::color &&
+            factor > 0.)
+          {
+            additional_data.tasks_parallel_scheme =
+              static_cast<typename AdditionalData::TasksParallelScheme>(scheme);
+            additional_data.tasks_block_size = block_size (factor);
+            return;
+          }
+      }
+  }
+
+  // the sample loop applies a mass matrix, plus a Laplacian if the gradients
+  // are available, on the first component of the first element
+  const bool evaluate_gradients =
+    (additional_data.mapping_update_flags & update_gradients) != 0;
+  const std::function<void (const MatrixFree<dim,Number> &,
+                            LinearAlgebra::distributed::Vector<Number> &,
+                            const LinearAlgebra::distributed::Vector<Number> &,
+                            const std::pair<unsigned int,unsigned int> &)>
+  sample_operation = [evaluate_gradients]
+                     (const MatrixFree<dim,Number>                     &data,
+                      LinearAlgebra::distributed::Vector<Number>       &dst,
+                      const LinearAlgebra::distributed::Vector<Number> &src,
+                      const std::pair<unsigned int,unsigned int>       &cell_range)
+  {
+    FEEvaluation<dim,-1,0,1,Number> phi (data);
+    for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+      {
+        phi.reinit (cell);
+        phi.read_dof_values (src);
+        phi.evaluate (true, evaluate_gradients);
+        for (unsigned int q=0; q<phi.n_q_points; ++q)
+          {
+            phi.submit_value (phi.get_value(q), q);
+            if (evaluate_gradients)
+              phi.submit_gradient (phi.get_gradient(q), q);
+          }
+        phi.integrate (true, evaluate_gradients);
+        phi.distribute_local_to_global (dst);
+      }
+  };
+
+  // all processes must run the same number of loops because of the ghost
+  // exchange, so base it on the average vector size
+  std::vector<double> times (candidates.size());
+  for (unsigned int c=0; c<candidates.size(); ++c)
+    {
+      sample_data.tasks_parallel_scheme = candidates[c].first;
+      sample_data.tasks_block_size = block_size (candidates[c].second);
+      internal_reinit (mapping, dof_handler, constraint, locally_owned_set, quad,
+                       sample_data);
+
+      LinearAlgebra::distributed::Vector<Number> src, dst;
+      initialize_dof_vector (src);
+      initialize_dof_vector (dst);
+      for (unsigned int i=0; i<src.local_size(); ++i)
+        src.local_element(i) = Number(1)/(i+1);
+
+      const unsigned int n_repetitions =
+        std::min (100U, std::max (3U, static_cast<unsigned int>
+                                  (10000000/(src.size()/size_info.n_procs+1))));
+      cell_loop (sample_operation, dst, src);
+      const auto begin = std::chrono::steady_clock::now();
+      for (unsigned int r=0; r<n_repetitions; ++r)
+        cell_loop (sample_operation, dst, src);
+      times[c] = std::chrono::duration<double>
+                 (std::chrono::steady_clock::now() - begin).count() / n_repetitions;
+    }
+
+  // the slowest process determines the time of the loop
+  if (mpi)
+    {
+      std::vector<double> max_times (candidates.size());
+      Utilities::MPI::max (times, size_info.communicator, max_times);
+      times.swap (max_times);
+    }
+
+  const unsigned int best = std::min_element(times.begin(), times.end()) - times.begin();
+  additional_data.tasks_parallel_scheme = candidates[best].first;
+  additional_data.tasks_block_size = block_size (candidates[best].second);
+
+  if (size_info.my_pid == 0 && additional_data.tasks_tuning_cache_file.empty() == false)
+    {
+      std::ofstream file (additional_data.tasks_tuning_cache_file.c_str(),
+                          std::ios::app);
+      file << key << ' ' << static_cast<unsigned int>(candidates[best].first)
+           << ' ' << candidates[best].second << ' ' << times[best] << std::endl;
+    }
+}
+
+
+
 template <int dim, typename Number>
 void MatrixFree<dim,Number>::clear()
 {
   dof_info.clear();
   mapping_info.clear();
+  face_info.clear();
   cell_level_index.clear();
   size_info.clear();
   task_info.clear();
@@ -797,6 +1327,7 @@ std::size_t MatrixFree<dim,Number>::memory_consumption () const
   memory += MemoryConsumption::memory_consumption (task_info);
   memory += sizeof(*this);
   memory += mapping_info.memory_consumption();
+  memory += face_info.memory_consumption();
   return memory;
 }
 
@@ -28,6 +28,8 @@
 #include <deal.II/matrix_free/matrix_free.h>
 #include <deal.II/matrix_free/fe_evaluation.h>
 
+#include <functional>
+
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -297,6 +299,31 @@ namespace MatrixFreeOperators
     void vmult (VectorType &dst,
                 const VectorType &src) const;
 
+    /**
+     * Matrix-vector multiplication with additional operations on the
+     * vector entries before and after the evaluation of the operator. The
+     * two function objects are called with half-open ranges <tt>[begin,
+     * end)</tt> of locally owned indices, possibly in parallel for disjoint
+     * ranges. @p operation_before_loop is called on a range before @p dst
+     * is zeroed and before @p src is read on that range, and @p
+     * operation_after_loop is called on a range once the entries of @p dst
+     * on it are final and @p src is not read there any more. This allows
+     * to merge vector updates, e.g. of the Chebyshev iteration in
+     * PreconditionChebyshev, with the passes over the vectors done by the
+     * matrix-vector product. Either function object may be empty.
+     *
+     * The computation of the operator itself uses the cell loop of
+     * MatrixFree. Derived classes that write their own loop may override
+     * this function to call the operations from within that loop.
+     *
+     * @note This function is only implemented for vectors that consist of a
+     * single block.
+     */
+    void vmult (VectorType &dst,
+                const VectorType &src,
+                const std::function<void(const unsigned int, const unsigned int)> &operation_before_loop,
+                const std::function<void(const unsigned int, const unsigned int)> &operation_after_loop) const;
+
     /**
      * Transpose matrix-vector multiplication.
      */
@@ -629,6 +656,68 @@ namespace MatrixFreeOperators
 
 
 
+  /**
+   * Compute the diagonal of the operator defined by the cell operation @p
+   * cell_operation without assembling a matrix. On each cell batch, the
+   * operation is applied to each unit vector of the local degrees of freedom
+   * in turn, i.e., to the same basis function on the cells in the lanes of
+   * the vectorized array, after the values in FEEvaluation::begin_dof_values()
+   * have been set. The operation must evaluate, work on the quadrature
+   * points and integrate, but neither call reinit() nor read or write any
+   * vector, like the following lambda for the Laplacian:
+   * @code
+   * MatrixFreeOperators::compute_diagonal<dim,fe_degree,fe_degree+1,1,double>
+   * (matrix_free, diagonal,
+   *  [](FEEvaluation<dim,fe_degree,fe_degree+1,1,double> &phi)
+   *  {
+   *    phi.evaluate (false, true);
+   *    for (unsigned int q=0; q<phi.n_q_points; ++q)
+   *      phi.submit_gradient (phi.get_gradient(q), q);
+   *    phi.integrate (false, true);
+   *  });
+   * @endcode
+   *
+   * The local diagonals are summed into @p diagonal, which must have been
+   * initialized by MatrixFree::initialize_dof_vector(), with
+   * FEEvaluation::distribute_local_to_global() within MatrixFree::cell_loop(),
+   * so the work is parallelized with the scheme selected for @p
+   * matrix_free. As for user-written diagonals, the entries of constrained
+   * degrees of freedom are zero and hanging node constraints are applied to
+   * the local diagonal rather than to the local matrix, which gives the
+   * approximations of the diagonal commonly used for smoothers.
+   */
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components,
+            typename Number, typename VectorType>
+  void
+  compute_diagonal (const MatrixFree<dim,Number> &matrix_free,
+                    VectorType                   &diagonal,
+                    const std::function<void (FEEvaluation<dim,fe_degree,n_q_points_1d,n_components,Number> &)> &cell_operation,
+                    const unsigned int            fe_no = 0,
+                    const unsigned int            quad_no = 0);
+
+  /**
+   * Compute the matrices of the operator @p cell_operation on each cell in
+   * the same way as compute_diagonal(), e.g. for building a block-Jacobi
+   * preconditioner for discontinuous elements. The result is stored in @p
+   * cell_matrices, which is resized to hold one matrix of size
+   * FEEvaluation::dofs_per_cell per cell batch, with the entry $(i,j)$ of the
+   * matrices of the cells in the lanes of cell batch @p cell at position
+   * <tt>(cell * dofs_per_cell + i) * dofs_per_cell + j</tt>. The rows and
+   * columns are numbered as in FEEvaluation::begin_dof_values(), i.e., by
+   * component and lexicographically within the component, and constraints
+   * are not applied.
+   */
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components,
+            typename Number>
+  void
+  compute_cell_matrices (const MatrixFree<dim,Number>            &matrix_free,
+                         AlignedVector<VectorizedArray<Number> > &cell_matrices,
+                         const std::function<void (FEEvaluation<dim,fe_degree,n_q_points_1d,n_components,Number> &)> &cell_operation,
+                         const unsigned int                       fe_no = 0,
+                         const unsigned int                       quad_no = 0);
+
+
+
   /**
    * This class implements the operation of the action of a mass matrix.
    *
@@ -927,6 +1016,98 @@ namespace MatrixFreeOperators
       }
   }
 
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components,
+            typename Number, typename VectorType>
+  void
+  compute_diagonal (const MatrixFree<dim,Number> &matrix_free,
+                    VectorType                   &diagonal,
+                    const std::function<void (FEEvaluation<dim,fe_degree,n_q_points_1d,n_components,Number> &)> &cell_operation,
+                    const unsigned int            fe_no,
+                    const unsigned int            quad_no)
+  {
+    typedef FEEvaluation<dim,fe_degree,n_q_points_1d,n_components,Number> FEEval;
+    const std::function<void (const MatrixFree<dim,Number> &,
+                              VectorType &,
+                              const unsigned int &,
+                              const std::pair<unsigned int,unsigned int> &)>
+    local_diagonal = [&] (const MatrixFree<dim,Number> &data,
+                          VectorType &dst,
+                          const unsigned int &,
+                          const std::pair<unsigned int,unsigned int> &cell_range)
+    {
+      FEEval phi (data, fe_no, quad_no);
+      AlignedVector<VectorizedArray<Number> > local_diagonal_vector (phi.dofs_per_cell);
+      for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+        {
+          phi.reinit (cell);
+          for (unsigned int i=0; i<phi.dofs_per_cell; ++i)
+            {
+              for (unsigned int j=0; j<phi.dofs_per_cell; ++j)
+                phi.begin_dof_values()[j] = VectorizedArray<Number>();
+              phi.begin_dof_values()[i] = make_vectorized_array<Number> (1.);
+              cell_operation (phi);
+              local_diagonal_vector[i] = phi.begin_dof_values()[i];
+            }
+          for (unsigned int i=0; i<phi.dofs_per_cell; ++i)
+            phi.begin_dof_values()[i] = local_diagonal_vector[i];
+          phi.distribute_local_to_global (dst);
+        }
+    };
+
+    diagonal = 0;
+    const unsigned int dummy = 0;
+    matrix_free.cell_loop (local_diagonal, diagonal, dummy);
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components,
+            typename Number>
+  void
+  compute_cell_matrices (const MatrixFree<dim,Number>            &matrix_free,
+                         AlignedVector<VectorizedArray<Number> > &cell_matrices,
+                         const std::function<void (FEEvaluation<dim,fe_degree,n_q_points_1d,n_components,Number> &)> &cell_operation,
+                         const unsigned int                       fe_no,
+                         const unsigned int                       quad_no)
+  {
+    typedef FEEvaluation<dim,fe_degree,n_q_points_1d,n_components,Number> FEEval;
+    const unsigned int dofs_per_cell = FEEval(matrix_free, fe_no, quad_no).dofs_per_cell;
+    cell_matrices.resize_fast (matrix_free.n_macro_cells() * dofs_per_cell * dofs_per_cell);
+
+    // each cell batch writes into its own part of cell_matrices, so the
+    // loop can run in parallel without conflicts
+    const std::function<void (const MatrixFree<dim,Number> &,
+                              AlignedVector<VectorizedArray<Number> > &,
+                              const unsigned int &,
+                              const std::pair<unsigned int,unsigned int> &)>
+    local_matrix = [&] (const MatrixFree<dim,Number> &data,
+                        AlignedVector<VectorizedArray<Number> > &dst,
+                        const unsigned int &,
+                        const std::pair<unsigned int,unsigned int> &cell_range)
+    {
+      FEEval phi (data, fe_no, quad_no);
+      for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+        {
+          phi.reinit (cell);
+          VectorizedArray<Number> *matrix = dst.begin() + cell*dofs_per_cell*dofs_per_cell;
+          for (unsigned int j=0; j<dofs_per_cell; ++j)
+            {
+              for (unsigned int i=0; i<dofs_per_cell; ++i)
+                phi.begin_dof_values()[i] = VectorizedArray<Number>();
+              phi.begin_dof_values()[j] = make_vectorized_array<Number> (1.);
+              cell_operation (phi);
+              for (unsigned int i=0; i<dofs_per_cell; ++i)
+                matrix[i*dofs_per_cell+j] = phi.begin_dof_values()[i];
+            }
+        }
+    };
+
+    const unsigned int dummy = 0;
+    matrix_free.cell_loop (local_matrix, cell_matrices, dummy);
+  }
+
   //----------------- Base operator -----------------------------
   template <int dim, typename VectorType>
   Base<dim,VectorType>::Base ()
@@ -1174,6 +1355,40 @@ namespace MatrixFreeOperators
 
 
 
+  template <int dim, typename VectorType>
+  void
+  Base<dim,VectorType>::vmult (VectorType       &dst,
+                               const VectorType &src,
+                               const std::function<void(const unsigned int, const unsigned int)> &operation_before_loop,
+                               const std::function<void(const unsigned int, const unsigned int)> &operation_after_loop) const
+  {
+    typedef typename Base<dim,VectorType>::value_type Number;
+    Assert (n_blocks(dst) == 1, ExcNotImplemented());
+
+    // combine the operation before the loop with zeroing the destination
+    // vector in a single pass over the locally owned range
+    const unsigned int local_size = subblock(dst,0).local_size();
+    Number *dst_ptr = subblock(dst,0).begin();
+    parallel::apply_to_subranges
+    (0U, local_size,
+     [&] (const unsigned int begin, const unsigned int end)
+    {
+      if (operation_before_loop)
+        operation_before_loop (begin, end);
+      std::fill (dst_ptr+begin, dst_ptr+end, Number());
+    },
+    internal::Vector::minimum_parallel_grain_size);
+    subblock(dst,0).zero_out_ghosts();
+
+    mult_add (dst, src, false);
+
+    if (operation_after_loop)
+      parallel::apply_to_subranges (0U, local_size, operation_after_loop,
+                                    internal::Vector::minimum_parallel_grain_size);
+  }
+
+
+
   template <int dim, typename VectorType>
   void
   Base<dim,VectorType>::vmult_add (VectorType &dst,
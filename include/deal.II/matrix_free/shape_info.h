@@ -75,6 +75,44 @@ namespace internal
       tensor_symmetric_plus_dg0 = 5
     };
 
+    /**
+     * An enum that selects among the sum factorization kernels that can
+     * evaluate a given element. All variants compute the same result up to
+     * roundoff, but their speed depends on the polynomial degree, the number
+     * of quadrature points and the instruction set the library was compiled
+     * for, so the best choice is a property of the machine rather than of the
+     * element.
+     */
+    enum KernelVariant
+    {
+      /**
+       * Select the kernel based on the ElementType: the collocation kernel
+       * for tensor_symmetric_collocation, the transformation to the
+       * collocation space for tensor_symmetric if the number of quadrature
+       * points equals the number of nodes, and the even-odd kernels for all
+       * other symmetric elements.
+       */
+      kernel_default = 0,
+      /**
+       * Apply the 1D matrices of shape values and gradients with full
+       * matrix-vector products, i.e., the kernels for tensor_general.
+       */
+      kernel_general = 1,
+      /**
+       * Use the kernels that exploit the symmetry of the 1D matrices of
+       * symmetric elements, i.e., the even-odd decomposition that halves the
+       * number of arithmetic operations for all but the lowest degrees, also
+       * in case the number of quadrature points equals the number of nodes.
+       */
+      kernel_even_odd = 2,
+      /**
+       * Interpolate the values into the collocation space of the quadrature
+       * points and compute the gradients there, which is only possible when
+       * the number of quadrature points equals the number of nodes.
+       */
+      kernel_transform_to_collocation = 3
+    };
+
     /**
      * The class that stores the shape functions, gradients and Hessians
      * evaluated for a tensor product finite element and tensor product
@@ -117,6 +155,19 @@ namespace internal
        */
       std::size_t memory_consumption () const;
 
+#ifdef DEAL_II_WITH_MPI
+      /**
+       * Replace the tabulated shape data of this object by the one on the
+       * process @p root_process of @p communicator, stored once per compute
+       * node in shared memory, see
+       * AlignedVector::replicate_across_communicator(). All processes must
+       * have initialized this object with the same element and quadrature
+       * formula. This is a collective operation on @p communicator.
+       */
+      void replicate_across_communicator (const MPI_Comm    &communicator,
+                                          const unsigned int root_process);
+#endif
+
       /**
        * Encodes the type of element detected at construction. FEEvaluation
        * will select the most efficient algorithm based on the given element
@@ -124,6 +175,19 @@ namespace internal
        */
       ElementType element_type;
 
+      /**
+       * The kernel selected for the evaluation of this element. Set to
+       * kernel_default by reinit() and possibly changed by MatrixFree
+       * according to MatrixFree::AdditionalData::kernel_variant.
+       */
+      KernelVariant kernel_variant;
+
+      /**
+       * Return whether the given kernel variant can be used for the element
+       * stored in this object.
+       */
+      bool supports_kernel_variant (const KernelVariant variant) const;
+
       /**
        * Stores the shape values of the 1D finite element evaluated on all 1D
        * quadrature points in vectorized format, i.e., as an array of
@@ -362,6 +426,7 @@ namespace internal
                                   const unsigned int base_element_number)
       :
       element_type(tensor_general),
+      kernel_variant (kernel_default),
       fe_degree (0),
       n_q_points_1d (0),
       n_q_points (0),
@@ -373,6 +438,28 @@ namespace internal
       reinit (quad, fe_in, base_element_number);
     }
 
+
+
+    template <typename Number>
+    inline
+    bool
+    ShapeInfo<Number>::supports_kernel_variant (const KernelVariant variant) const
+    {
+      switch (variant)
+        {
+        case kernel_default:
+          return true;
+        case kernel_general:
+          return element_type <= tensor_general;
+        case kernel_even_odd:
+          return element_type <= tensor_symmetric;
+        case kernel_transform_to_collocation:
+          return element_type <= tensor_symmetric && n_q_points_1d == fe_degree+1;
+        default:
+          return false;
+        }
+    }
+
   } // end of namespace MatrixFreeFunctions
 
 } // end of namespace internal
@@ -59,6 +59,7 @@ namespace internal
     ShapeInfo<Number>::ShapeInfo ()
       :
       element_type (tensor_general),
+      kernel_variant (kernel_default),
       fe_degree (numbers::invalid_unsigned_int),
       n_q_points_1d(0),
       n_q_points (0),
@@ -84,6 +85,7 @@ namespace internal
 
       fe_degree = fe->degree;
       n_q_points_1d = quad.size();
+      kernel_variant = kernel_default;
 
       const unsigned int n_dofs_1d = std::min(fe->dofs_per_cell, fe_degree+1);
 
@@ -522,6 +524,32 @@ namespace internal
       return memory;
     }
 
+#ifdef DEAL_II_WITH_MPI
+    template <typename Number>
+    void
+    ShapeInfo<Number>::replicate_across_communicator (const MPI_Comm    &communicator,
+                                                      const unsigned int root_process)
+    {
+      shape_values.replicate_across_communicator (communicator, root_process);
+      shape_gradients.replicate_across_communicator (communicator, root_process);
+      shape_hessians.replicate_across_communicator (communicator, root_process);
+      shape_values_eo.replicate_across_communicator (communicator, root_process);
+      shape_gradients_eo.replicate_across_communicator (communicator, root_process);
+      shape_hessians_eo.replicate_across_communicator (communicator, root_process);
+      shape_gradients_collocation_eo.replicate_across_communicator (communicator, root_process);
+      shape_hessians_collocation_eo.replicate_across_communicator (communicator, root_process);
+      for (unsigned int i=0; i<2; ++i)
+        {
+          shape_data_on_face[i].replicate_across_communicator (communicator, root_process);
+          values_within_subface[i].replicate_across_communicator (communicator, root_process);
+          gradients_within_subface[i].replicate_across_communicator (communicator, root_process);
+          hessians_within_subface[i].replicate_across_communicator (communicator, root_process);
+        }
+    }
+#endif
+
+
+
     // end of functions for ShapeInfo
 
   } // end of namespace MatrixFreeFunctions
@@ -20,6 +20,7 @@
 #include <deal.II/base/config.h>
 #include <deal.II/base/work_stream.h>
 #include <deal.II/base/template_constraints.h>
+#include <deal.II/base/thread_local_storage.h>
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/filtered_iterator.h>
 #include <deal.II/meshworker/local_integrator.h>
@@ -27,6 +28,7 @@
 #include <deal.II/meshworker/integration_info.h>
 
 #include <functional>
+#include <memory>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -147,6 +149,86 @@ namespace MeshWorker
 
 
 
+  /**
+   * Copies of an INFOBOX, for example an IntegrationInfoBox, for all the
+   * threads that have worked on a loop() with this object, which persist
+   * between the calls to loop().
+   *
+   * The loop() without such an object creates a copy of the INFOBOX for each
+   * thread at the start of every loop, including all the FEValues objects
+   * it contains, and destroys them at the end. In codes that run the same
+   * loop many times, for example once per time step on a small mesh, this
+   * setup often costs as much as the integration itself. If an object of
+   * this class is passed to loop(), each thread instead creates its copy
+   * upon the first call and reuses it in all following loops.
+   *
+   * The copies are made from the INFOBOX passed to the first loop a thread
+   * works on, and are not updated afterwards. Call clear() whenever the
+   * INFOBOX is initialized anew, for example with a different finite
+   * element, mapping, quadrature or set of vectors.
+   *
+   * @ingroup MeshWorker
+   */
+  template <class INFOBOX>
+  class InfoBoxCache
+  {
+  public:
+    /**
+     * Constructor. Creates an empty cache.
+     */
+    InfoBoxCache () = default;
+
+    /**
+     * The copies belong to exactly one cache, so copying is not possible.
+     */
+    InfoBoxCache (const InfoBoxCache<INFOBOX> &) = delete;
+
+    /**
+     * The copies belong to exactly one cache, so copying is not possible.
+     */
+    InfoBoxCache<INFOBOX> &operator = (const InfoBoxCache<INFOBOX> &) = delete;
+
+    /**
+     * Return the copy of the current thread, creating it from @p sample if
+     * the current thread has none yet.
+     */
+    INFOBOX &get (const INFOBOX &sample);
+
+    /**
+     * Delete the copies of all threads, such that they are created anew
+     * from the INFOBOX passed to the next loop.
+     */
+    void clear ();
+
+  private:
+    Threads::ThreadLocalStorage<std::shared_ptr<INFOBOX> > infos;
+  };
+
+
+
+  template <class INFOBOX>
+  inline
+  INFOBOX &
+  InfoBoxCache<INFOBOX>::get (const INFOBOX &sample)
+  {
+    std::shared_ptr<INFOBOX> &info = infos.get();
+    if (!info)
+      info = std::shared_ptr<INFOBOX>(new INFOBOX(sample));
+    return *info;
+  }
+
+
+
+  template <class INFOBOX>
+  inline
+  void
+  InfoBoxCache<INFOBOX>::clear ()
+  {
+    infos.clear();
+  }
+
+
+
   /**
    * The function called by loop() to perform the required actions on a cell
    * and its faces. The three functions <tt>cell_worker</tt>,
@@ -414,6 +496,58 @@ namespace MeshWorker
   }
 
 
+  /**
+   * The same as the function above, but the copies of @p info that the
+   * threads work on are taken from @p info_cache, where they persist until
+   * the next loop instead of being created anew. See InfoBoxCache for when
+   * the cache needs to be cleared.
+   *
+   * @ingroup MeshWorker
+   */
+  template <int dim, int spacedim, class DOFINFO, class INFOBOX, class ASSEMBLER, class ITERATOR>
+  void loop(ITERATOR begin,
+            typename identity<ITERATOR>::type end,
+            DOFINFO &dinfo,
+            INFOBOX &info,
+            InfoBoxCache<INFOBOX> &info_cache,
+            const std::function<void (DOFINFO &, typename INFOBOX::CellInfo &)> &cell_worker,
+            const std::function<void (DOFINFO &, typename INFOBOX::CellInfo &)> &boundary_worker,
+            const std::function<void (DOFINFO &, DOFINFO &,
+                                      typename INFOBOX::CellInfo &,
+                                      typename INFOBOX::CellInfo &)> &face_worker,
+            ASSEMBLER &assembler,
+            const LoopControl &lctrl = LoopControl())
+  {
+    DoFInfoBox<dim, DOFINFO> dof_info(dinfo);
+
+    assembler.initialize_info(dof_info.cell, false);
+    for (unsigned int i=0; i<GeometryInfo<dim>::faces_per_cell; ++i)
+      {
+        assembler.initialize_info(dof_info.interior[i], true);
+        assembler.initialize_info(dof_info.exterior[i], true);
+      }
+
+    // The scratch data of WorkStream is only a pointer to the copy of the
+    // info box of the current thread, which is looked up on the first cell
+    const auto worker = [&] (const ITERATOR &cell,
+                             INFOBOX *&thread_info,
+                             DoFInfoBox<dim, DOFINFO> &local_dof_info)
+    {
+      if (thread_info == nullptr)
+        thread_info = &info_cache.get(info);
+      cell_action<INFOBOX, DOFINFO, dim, spacedim, ITERATOR>
+      (cell, local_dof_info, *thread_info, cell_worker, boundary_worker, face_worker, lctrl);
+    };
+
+    // Loop over all cells
+    WorkStream::run(begin, end,
+                    worker,
+                    std::bind(&internal::assemble<dim,DOFINFO,ASSEMBLER>, std::placeholders::_1, &assembler),
+                    static_cast<INFOBOX *>(nullptr), dof_info);
+  }
+
+
+
   /**
    * Simplified interface for loop() if specialized for integration, using the
    * virtual functions in LocalIntegrator.
@@ -453,6 +587,48 @@ namespace MeshWorker
      lctrl);
   }
 
+
+
+  /**
+   * The same as the function above, but with copies of @p box that persist
+   * in @p box_cache between loops. See InfoBoxCache for details.
+   *
+   * @ingroup MeshWorker
+   */
+  template <int dim, int spacedim, class ITERATOR, class ASSEMBLER>
+  void integration_loop(ITERATOR begin,
+                        typename identity<ITERATOR>::type end,
+                        DoFInfo<dim, spacedim> &dof_info,
+                        IntegrationInfoBox<dim, spacedim> &box,
+                        InfoBoxCache<IntegrationInfoBox<dim, spacedim> > &box_cache,
+                        const LocalIntegrator<dim, spacedim> &integrator,
+                        ASSEMBLER &assembler,
+                        const LoopControl &lctrl = LoopControl())
+  {
+    std::function<void (DoFInfo<dim, spacedim>&, IntegrationInfo<dim, spacedim>&)> cell_worker;
+    std::function<void (DoFInfo<dim, spacedim>&, IntegrationInfo<dim, spacedim>&)> boundary_worker;
+    std::function<void (DoFInfo<dim, spacedim>&, DoFInfo<dim, spacedim> &,
+                        IntegrationInfo<dim, spacedim> &,
+                        IntegrationInfo<dim, spacedim> &)> face_worker;
+    if (integrator.use_cell)
+      cell_worker = std::bind(&LocalIntegrator<dim, spacedim>::cell, &integrator, std::placeholders::_1, std::placeholders::_2);
+    if (integrator.use_boundary)
+      boundary_worker = std::bind(&LocalIntegrator<dim, spacedim>::boundary, &integrator, std::placeholders::_1, std::placeholders::_2);
+    if (integrator.use_face)
+      face_worker = std::bind(&LocalIntegrator<dim, spacedim>::face, &integrator, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
+
+    loop<dim, spacedim>
+    (begin, end,
+     dof_info,
+     box,
+     box_cache,
+     cell_worker,
+     boundary_worker,
+     face_worker,
+     assembler,
+     lctrl);
+  }
+
 }
 
 DEAL_II_NAMESPACE_CLOSE
@@ -19,6 +19,7 @@
 
 #include <deal.II/base/config.h>
 #include <deal.II/base/work_stream.h>
+#include <deal.II/base/graph_coloring.h>
 #include <deal.II/base/template_constraints.h>
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/filtered_iterator.h>
@@ -28,7 +29,9 @@
 #include <deal.II/meshworker/integration_info.h>
 #include <deal.II/meshworker/assemble_flags.h>
 
+#include <algorithm>
 #include <functional>
+#include <vector>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -36,6 +39,196 @@ template <typename> class TriaActiveIterator;
 
 namespace MeshWorker
 {
+  namespace internal
+  {
+    /**
+     * Check the consistency of the workers and the AssembleFlags passed to
+     * mesh_loop() and return the function that mesh_loop() runs on each
+     * cell. This function encodes the logic that decides which faces of a
+     * cell are worked on, and is shared by all variants of mesh_loop(). The
+     * workers are referenced by the returned object, so they need to
+     * outlive it.
+     */
+    template <class CellIteratorType, class ScratchData, class CopyData>
+    std::function<void (const CellIteratorType &, ScratchData &, CopyData &)>
+    make_mesh_loop_cell_action
+    (const std::function<void (const CellIteratorType &, ScratchData &, CopyData &)> &cell_worker,
+     const CopyData &sample_copy_data,
+     const AssembleFlags flags,
+     const std::function<void (const CellIteratorType &, const unsigned int &, ScratchData &, CopyData &)> &boundary_worker,
+     const std::function<void (const CellIteratorType &, const unsigned int &, const unsigned int &,
+                               const CellIteratorType &, const unsigned int &, const unsigned int &,
+                               ScratchData &, CopyData &)> &face_worker)
+    {
+      Assert((!cell_worker) == !(flags & work_on_cells),
+             ExcMessage("If you specify a cell_worker, you need to set assemble_own_cells or assemble_ghost_cells."));
+
+      Assert((flags & (assemble_own_interior_faces_once|assemble_own_interior_faces_both))
+             != (assemble_own_interior_faces_once|assemble_own_interior_faces_both),
+             ExcMessage("You can only specify assemble_own_interior_faces_once OR assemble_own_interior_faces_both."));
+
+      Assert((flags & (assemble_ghost_faces_once|assemble_ghost_faces_both))
+             != (assemble_ghost_faces_once|assemble_ghost_faces_both),
+             ExcMessage("You can only specify assemble_ghost_faces_once OR assemble_ghost_faces_both."));
+
+      Assert(!(flags & cells_after_faces) ||
+             (flags & (assemble_own_cells | assemble_ghost_cells)),
+             ExcMessage("The option cells_after_faces only makes sense if you assemble on cells."));
+
+      Assert((!face_worker) == !(flags & work_on_faces),
+             ExcMessage("If you specify a face_worker, assemble_face_* needs to be set."));
+
+      Assert((!boundary_worker) == !(flags & assemble_boundary_faces),
+             ExcMessage("If you specify a boundary_worker, assemble_boundary_faces needs to be set."));
+
+      return [&sample_copy_data, &cell_worker, &boundary_worker, &face_worker, flags]
+             (const CellIteratorType &cell, ScratchData &scratch, CopyData &copy)
+      {
+        // First reset the CopyData class to the empty copy_data given by the user.
+        copy = sample_copy_data;
+
+        const bool ignore_subdomain = (cell->get_triangulation().locally_owned_subdomain()
+                                       == numbers::invalid_subdomain_id);
+
+        types::subdomain_id current_subdomain_id = (cell->is_level_cell()
+                                                    ? cell->level_subdomain_id()
+                                                    : cell->subdomain_id());
+
+        const bool own_cell = ignore_subdomain || (current_subdomain_id == cell->get_triangulation().locally_owned_subdomain());
+
+        if ((!ignore_subdomain) && (current_subdomain_id == numbers::artificial_subdomain_id))
+          return;
+
+        if ( !(flags & (cells_after_faces)) &&
+             ( ((flags & (assemble_own_cells)) && own_cell)
+               || ( (flags & assemble_ghost_cells) && !own_cell) ) )
+          cell_worker(cell, scratch, copy);
+
+        if (flags & (work_on_faces | work_on_boundary))
+          for (unsigned int face_no=0; face_no < GeometryInfo<CellIteratorType::AccessorType::Container::dimension>::faces_per_cell; ++face_no)
+            {
+              typename CellIteratorType::AccessorType::Container::face_iterator face = cell->face(face_no);
+              if (cell->at_boundary(face_no) && !cell->has_periodic_neighbor(face_no))
+                {
+                  // only integrate boundary faces of own cells
+                  if ( (flags & assemble_boundary_faces) && own_cell)
+                    boundary_worker(cell, face_no, scratch, copy);
+                }
+              else
+                {
+                  // interior face, potentially assemble
+                  TriaIterator<typename CellIteratorType::AccessorType> neighbor = cell->neighbor_or_periodic_neighbor(face_no);
+
+                  types::subdomain_id neighbor_subdomain_id = numbers::artificial_subdomain_id;
+                  if (neighbor->is_level_cell())
+                    neighbor_subdomain_id = neighbor->level_subdomain_id();
+                  //subdomain id is only valid for active cells
+                  else if (neighbor->active())
+                    neighbor_subdomain_id = neighbor->subdomain_id();
+
+                  const bool own_neighbor = ignore_subdomain ||
+                                            (neighbor_subdomain_id == cell->get_triangulation().locally_owned_subdomain());
+
+                  // skip all faces between two ghost cells
+                  if (!own_cell && !own_neighbor)
+                    continue;
+
+                  // skip if the user doesn't want faces between own cells
+                  if (own_cell && own_neighbor && !(flags & (assemble_own_interior_faces_both | assemble_own_interior_faces_once)))
+                    continue;
+
+                  // skip face to ghost
+                  if (own_cell != own_neighbor && !(flags & (assemble_ghost_faces_both | assemble_ghost_faces_once)))
+                    continue;
+
+                  // Deal with refinement edges from the refined side. Assuming one-irregular
+                  // meshes, this situation should only occur if both cells are active.
+                  const bool periodic_neighbor = cell->has_periodic_neighbor(face_no);
+
+                  if ((!periodic_neighbor && cell->neighbor_is_coarser(face_no))
+                      || (periodic_neighbor && cell->periodic_neighbor_is_coarser(face_no)))
+                    {
+                      Assert(!cell->has_children(), ExcInternalError());
+                      Assert(!neighbor->has_children(), ExcInternalError());
+
+                      // skip if only one processor needs to assemble the face
+                      // to a ghost cell and the fine cell is not ours.
+                      if (!own_cell && (flags & assemble_ghost_faces_once))
+                        continue;
+
+                      const std::pair<unsigned int, unsigned int> neighbor_face_no
+                        = periodic_neighbor?
+                          cell->periodic_neighbor_of_coarser_periodic_neighbor(face_no):
+                          cell->neighbor_of_coarser_neighbor(face_no);
+
+                      face_worker(cell, face_no, numbers::invalid_unsigned_int,
+                                  neighbor, neighbor_face_no.first, neighbor_face_no.second,
+                                  scratch, copy);
+
+                      if (flags & assemble_own_interior_faces_both)
+                        {
+                          // If own faces are to be assembled from both sides, call the
+                          // faceworker again with swapped arguments. This is because
+                          // we won't be looking at an adaptively refined edge
+                          // coming from the other side.
+                          face_worker(neighbor, neighbor_face_no.first, neighbor_face_no.second,
+                                      cell, face_no, numbers::invalid_unsigned_int,
+                                      scratch, copy);
+                        }
+                    }
+                  else
+                    {
+                      // If iterator is active and neighbor is refined, skip
+                      // internal face.
+                      if (dealii::internal::is_active_iterator(cell) && neighbor->has_children())
+                        continue;
+
+                      // Now neighbor is on same level, double-check this:
+                      Assert(cell->level()==neighbor->level(), ExcInternalError());
+
+                      // If we own both cells only do faces from one side (unless
+                      // AssembleFlags says otherwise). Here, we rely on cell comparison
+                      // that will look at cell->index().
+                      if (own_cell && own_neighbor
+                          && (flags & assemble_own_interior_faces_once)
+                          && (neighbor < cell))
+                        continue;
+
+                      // We only look at faces to ghost on the same level once
+                      // (only where own_cell=true and own_neighbor=false)
+                      if (!own_cell)
+                        continue;
+
+                      // now only one processor assembles faces_to_ghost. We let the
+                      // processor with the smaller (level-)subdomain id assemble the
+                      // face.
+                      if (own_cell && !own_neighbor
+                          && (flags & assemble_ghost_faces_once)
+                          && (neighbor_subdomain_id < current_subdomain_id))
+                        continue;
+
+                      const unsigned int neighbor_face_no = periodic_neighbor?
+                                                            cell->periodic_neighbor_face_no(face_no):
+                                                            cell->neighbor_face_no(face_no);
+                      Assert (periodic_neighbor || neighbor->face(neighbor_face_no) == face, ExcInternalError());
+
+                      face_worker(cell, face_no, numbers::invalid_unsigned_int,
+                                  neighbor, neighbor_face_no, numbers::invalid_unsigned_int,
+                                  scratch, copy);
+                    }
+                }
+            } // faces
+
+        // Execute the cell_worker if faces are handled before cells
+        if ((flags & cells_after_faces) &&
+            ( ((flags & assemble_own_cells) && own_cell) || ((flags & assemble_ghost_cells) && !own_cell)))
+          cell_worker(cell, scratch, copy);
+      };
+    }
+  }
+
+
+
   /**
    * This function extends the WorkStream concept to work on meshes
    * (cells and/or faces) and handles the complicated logic for
@@ -137,175 +330,145 @@ namespace MeshWorker
                  const unsigned int   queue_length = 2*MultithreadInfo::n_threads(),
                  const unsigned int   chunk_size = 8)
   {
-    Assert((!cell_worker) == !(flags & work_on_cells),
-           ExcMessage("If you specify a cell_worker, you need to set assemble_own_cells or assemble_ghost_cells."));
+    // Submit to workstream
+    WorkStream::run(begin, end,
+                    internal::make_mesh_loop_cell_action<CellIteratorType, ScratchData, CopyData>
+                    (cell_worker, sample_copy_data, flags, boundary_worker, face_worker),
+                    copier,
+                    sample_scratch_data, sample_copy_data,
+                    queue_length, chunk_size);
+  }
 
-    Assert((flags & (assemble_own_interior_faces_once|assemble_own_interior_faces_both))
-           != (assemble_own_interior_faces_once|assemble_own_interior_faces_both),
-           ExcMessage("You can only specify assemble_own_interior_faces_once OR assemble_own_interior_faces_both."));
 
-    Assert((flags & (assemble_ghost_faces_once|assemble_ghost_faces_both))
-           != (assemble_ghost_faces_once|assemble_ghost_faces_both),
-           ExcMessage("You can only specify assemble_ghost_faces_once OR assemble_ghost_faces_both."));
+  /**
+   * Same as the function above, but for a range of cells that has been
+   * partitioned into colors, for example by make_mesh_loop_coloring(). The
+   * colors are worked on one after the other, and all cells of one color
+   * are worked on in parallel. In contrast to the function above, the @p
+   * copier is not serialized, but is called for a cell on the same thread
+   * right after the work on that cell, concurrently with the copiers of the
+   * other cells of the same color. The coloring must therefore guarantee
+   * that the copiers of two cells of the same color never write to the same
+   * memory location, including the contributions computed by the @p
+   * face_worker and the @p boundary_worker. See WorkStream::run() for the
+   * same concept applied to plain cell loops.
+   *
+   * For discontinuous Galerkin methods, where the serialized copier limits
+   * the parallel scalability of the function above, this variant avoids
+   * both the serialization and the use of locks in the copier.
+   *
+   * @ingroup MeshWorker
+   */
+  template <class CellIteratorType,
+            class ScratchData, class CopyData>
+  void mesh_loop(const std::vector<std::vector<CellIteratorType> > &colored_cells,
 
-    Assert(!(flags & cells_after_faces) ||
-           (flags & (assemble_own_cells | assemble_ghost_cells)),
-           ExcMessage("The option cells_after_faces only makes sense if you assemble on cells."));
+                 const typename identity<std::function<void (const CellIteratorType &, ScratchData &, CopyData &)>>::type &cell_worker,
+                 const typename identity<std::function<void (const CopyData &)>>::type &copier,
 
-    Assert((!face_worker) == !(flags & work_on_faces),
-           ExcMessage("If you specify a face_worker, assemble_face_* needs to be set."));
+                 const ScratchData &sample_scratch_data,
+                 const CopyData &sample_copy_data,
 
-    Assert((!boundary_worker) == !(flags & assemble_boundary_faces),
-           ExcMessage("If you specify a boundary_worker, assemble_boundary_faces needs to be set."));
+                 const AssembleFlags flags = assemble_own_cells,
 
-    auto cell_action = [&] (const CellIteratorType &cell, ScratchData &scratch, CopyData &copy)
-    {
-      // First reset the CopyData class to the empty copy_data given by the user.
-      copy = sample_copy_data;
+                 const typename identity<std::function<void (const CellIteratorType &, const unsigned int &, ScratchData &, CopyData &)>>::type &boundary_worker=
+                   std::function<void (const CellIteratorType &, const unsigned int &, ScratchData &, CopyData &)>(),
 
-      const bool ignore_subdomain = (cell->get_triangulation().locally_owned_subdomain()
-                                     == numbers::invalid_subdomain_id);
+                 const typename identity<std::function<void (const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                                             const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                                             ScratchData &, CopyData &)>>::type &face_worker=
+                   std::function<void (const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                       const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                       ScratchData &, CopyData &)>(),
 
-      types::subdomain_id current_subdomain_id = (cell->is_level_cell()
-                                                  ? cell->level_subdomain_id()
-                                                  : cell->subdomain_id());
+                 const unsigned int   queue_length = 2*MultithreadInfo::n_threads(),
+                 const unsigned int   chunk_size = 8)
+  {
+    WorkStream::run(colored_cells,
+                    internal::make_mesh_loop_cell_action<CellIteratorType, ScratchData, CopyData>
+                    (cell_worker, sample_copy_data, flags, boundary_worker, face_worker),
+                    copier,
+                    sample_scratch_data, sample_copy_data,
+                    queue_length, chunk_size);
+  }
 
-      const bool own_cell = ignore_subdomain || (current_subdomain_id == cell->get_triangulation().locally_owned_subdomain());
 
-      if ((!ignore_subdomain) && (current_subdomain_id == numbers::artificial_subdomain_id))
-        return;
 
-      if ( !(flags & (cells_after_faces)) &&
-           ( ((flags & (assemble_own_cells)) && own_cell)
-             || ( (flags & assemble_ghost_cells) && !own_cell) ) )
-        cell_worker(cell, scratch, copy);
+  /**
+   * Partition the cells in the range from @p begin to @p end into colors
+   * such that two cells of the same color can be worked on, and copied into
+   * global data structures, at the same time by the variant of mesh_loop()
+   * that takes colored cells. Two cells conflict if the degrees of freedom
+   * of either of them, or of the neighbors across the faces that mesh_loop()
+   * visits from either of them with the given @p flags, have a degree of
+   * freedom in common. This assumes that the copier of a cell writes into
+   * the entries of the degrees of freedom of the cell itself and, if faces
+   * are assembled, of the neighbors across these faces, which is the case
+   * for the usual assembly of matrices and vectors. The coloring is
+   * computed by GraphColoring::make_graph_coloring() and only needs to be
+   * recomputed when the mesh or the degrees of freedom change.
+   *
+   * The iterators need to be cell iterators of a DoFHandler, either on the
+   * active cells or on the cells of one level of a multilevel hierarchy.
+   */
+  template <class CellIteratorType>
+  std::vector<std::vector<CellIteratorType> >
+  make_mesh_loop_coloring(const CellIteratorType &begin,
+                          const typename identity<CellIteratorType>::type &end,
+                          const AssembleFlags flags = assemble_own_cells)
+  {
+    const auto is_artificial = [] (const TriaIterator<typename CellIteratorType::AccessorType> &cell)
+    {
+      return ((cell->is_level_cell()
+               ? cell->level_subdomain_id()
+               : (cell->active() ? cell->subdomain_id() : numbers::invalid_subdomain_id))
+              == numbers::artificial_subdomain_id);
+    };
 
-      if (flags & (work_on_faces | work_on_boundary))
-        for (unsigned int face_no=0; face_no < GeometryInfo<CellIteratorType::AccessorType::Container::dimension>::faces_per_cell; ++face_no)
-          {
-            typename CellIteratorType::AccessorType::Container::face_iterator face = cell->face(face_no);
-            if (cell->at_boundary(face_no) && !cell->has_periodic_neighbor(face_no))
-              {
-                // only integrate boundary faces of own cells
-                if ( (flags & assemble_boundary_faces) && own_cell)
-                  boundary_worker(cell, face_no, scratch, copy);
-              }
-            else
+    const auto get_conflict_indices = [flags,&is_artificial] (const CellIteratorType &cell)
+    {
+      // artificial cells are skipped by mesh_loop() and do not conflict
+      // with any other cell
+      if (is_artificial (cell))
+        return std::vector<types::global_dof_index>();
+
+      std::vector<types::global_dof_index> conflict_indices (cell->get_fe().dofs_per_cell);
+      cell->get_active_or_mg_dof_indices (conflict_indices);
+
+      if (flags & work_on_faces)
+        {
+          std::vector<types::global_dof_index> neighbor_dof_indices;
+          for (unsigned int face_no=0; face_no < GeometryInfo<CellIteratorType::AccessorType::Container::dimension>::faces_per_cell; ++face_no)
+            if (!cell->at_boundary(face_no) || cell->has_periodic_neighbor(face_no))
               {
-                // interior face, potentially assemble
-                TriaIterator<typename CellIteratorType::AccessorType> neighbor = cell->neighbor_or_periodic_neighbor(face_no);
-
-                types::subdomain_id neighbor_subdomain_id = numbers::artificial_subdomain_id;
-                if (neighbor->is_level_cell())
-                  neighbor_subdomain_id = neighbor->level_subdomain_id();
-                //subdomain id is only valid for active cells
-                else if (neighbor->active())
-                  neighbor_subdomain_id = neighbor->subdomain_id();
-
-                const bool own_neighbor = ignore_subdomain ||
-                                          (neighbor_subdomain_id == cell->get_triangulation().locally_owned_subdomain());
-
-                // skip all faces between two ghost cells
-                if (!own_cell && !own_neighbor)
-                  continue;
-
-                // skip if the user doesn't want faces between own cells
-                if (own_cell && own_neighbor && !(flags & (assemble_own_interior_faces_both | assemble_own_interior_faces_once)))
-                  continue;
-
-                // skip face to ghost
-                if (own_cell != own_neighbor && !(flags & (assemble_ghost_faces_both | assemble_ghost_faces_once)))
+                const TriaIterator<typename CellIteratorType::AccessorType> neighbor
+                  = cell->neighbor_or_periodic_neighbor(face_no);
+
+                // mesh_loop() works on the faces to finer neighbors from the
+                // side of the neighbor, so these conflicts are recorded by
+                // the neighbor
+                if ((dealii::internal::is_active_iterator(cell) && neighbor->has_children())
+                    || is_artificial (neighbor))
                   continue;
 
-                // Deal with refinement edges from the refined side. Assuming one-irregular
-                // meshes, this situation should only occur if both cells are active.
-                const bool periodic_neighbor = cell->has_periodic_neighbor(face_no);
-
-                if ((!periodic_neighbor && cell->neighbor_is_coarser(face_no))
-                    || (periodic_neighbor && cell->periodic_neighbor_is_coarser(face_no)))
-                  {
-                    Assert(!cell->has_children(), ExcInternalError());
-                    Assert(!neighbor->has_children(), ExcInternalError());
-
-                    // skip if only one processor needs to assemble the face
-                    // to a ghost cell and the fine cell is not ours.
-                    if (!own_cell && (flags & assemble_ghost_faces_once))
-                      continue;
-
-                    const std::pair<unsigned int, unsigned int> neighbor_face_no
-                      = periodic_neighbor?
-                        cell->periodic_neighbor_of_coarser_periodic_neighbor(face_no):
-                        cell->neighbor_of_coarser_neighbor(face_no);
-
-                    face_worker(cell, face_no, numbers::invalid_unsigned_int,
-                                neighbor, neighbor_face_no.first, neighbor_face_no.second,
-                                scratch, copy);
-
-                    if (flags & assemble_own_interior_faces_both)
-                      {
-                        // If own faces are to be assembled from both sides, call the
-                        // faceworker again with swapped arguments. This is because
-                        // we won't be looking at an adaptively refined edge
-                        // coming from the other side.
-                        face_worker(neighbor, neighbor_face_no.first, neighbor_face_no.second,
-                                    cell, face_no, numbers::invalid_unsigned_int,
-                                    scratch, copy);
-                      }
-                  }
-                else
-                  {
-                    // If iterator is active and neighbor is refined, skip
-                    // internal face.
-                    if (internal::is_active_iterator(cell) && neighbor->has_children())
-                      continue;
-
-                    // Now neighbor is on same level, double-check this:
-                    Assert(cell->level()==neighbor->level(), ExcInternalError());
-
-                    // If we own both cells only do faces from one side (unless
-                    // AssembleFlags says otherwise). Here, we rely on cell comparison
-                    // that will look at cell->index().
-                    if (own_cell && own_neighbor
-                        && (flags & assemble_own_interior_faces_once)
-                        && (neighbor < cell))
-                      continue;
-
-                    // We only look at faces to ghost on the same level once
-                    // (only where own_cell=true and own_neighbor=false)
-                    if (!own_cell)
-                      continue;
-
-                    // now only one processor assembles faces_to_ghost. We let the
-                    // processor with the smaller (level-)subdomain id assemble the
-                    // face.
-                    if (own_cell && !own_neighbor
-                        && (flags & assemble_ghost_faces_once)
-                        && (neighbor_subdomain_id < current_subdomain_id))
-                      continue;
-
-                    const unsigned int neighbor_face_no = periodic_neighbor?
-                                                          cell->periodic_neighbor_face_no(face_no):
-                                                          cell->neighbor_face_no(face_no);
-                    Assert (periodic_neighbor || neighbor->face(neighbor_face_no) == face, ExcInternalError());
-
-                    face_worker(cell, face_no, numbers::invalid_unsigned_int,
-                                neighbor, neighbor_face_no, numbers::invalid_unsigned_int,
-                                scratch, copy);
-                  }
+                neighbor_dof_indices.resize (neighbor->get_fe().dofs_per_cell);
+                neighbor->get_active_or_mg_dof_indices (neighbor_dof_indices);
+                conflict_indices.insert (conflict_indices.end(),
+                                         neighbor_dof_indices.begin(),
+                                         neighbor_dof_indices.end());
               }
-          } // faces
+        }
 
-      // Execute the cell_worker if faces are handled before cells
-      if ((flags & cells_after_faces) &&
-          ( ((flags & assemble_own_cells) && own_cell) || ((flags & assemble_ghost_cells) && !own_cell)))
-        cell_worker(cell, scratch, copy);
+      std::sort (conflict_indices.begin(), conflict_indices.end());
+      conflict_indices.erase (std::unique (conflict_indices.begin(), conflict_indices.end()),
+                              conflict_indices.end());
+      return conflict_indices;
     };
 
-    // Submit to workstream
-    WorkStream::run(begin, end,
-                    cell_action, copier,
-                    sample_scratch_data, sample_copy_data,
-                    queue_length, chunk_size);
+    return GraphColoring::make_graph_coloring
+           (begin, end,
+            std::function<std::vector<types::global_dof_index> (const CellIteratorType &)>
+            (get_conflict_indices));
   }
 }
 
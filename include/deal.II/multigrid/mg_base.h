@@ -205,6 +205,33 @@ public:
   virtual void restrict_and_add (const unsigned int from_level,
                                  VectorType         &dst,
                                  const VectorType   &src) const = 0;
+
+  /**
+   * Prolongate a vector from level <tt>to_level-1</tt> to level
+   * <tt>to_level</tt> and add the result to <tt>dst</tt>. This is the
+   * coarse grid correction of the multigrid cycle. The default
+   * implementation calls prolongate() on a temporary vector, whereas derived
+   * classes can override it to add the result directly and save a pass
+   * through the fine vector.
+   */
+  virtual void prolongate_and_add (const unsigned int to_level,
+                                   VectorType         &dst,
+                                   const VectorType   &src) const;
+
+  /**
+   * Restrict the residual <tt>rhs - matrix_times_solution</tt> from level
+   * <tt>from_level</tt> to level <tt>from_level-1</tt> and add the result to
+   * <tt>dst</tt>, like restrict_and_add(). The content of @p
+   * matrix_times_solution is undefined after the call. The default
+   * implementation computes the residual in @p matrix_times_solution and
+   * calls restrict_and_add(), whereas derived classes can override it to
+   * form the residual while copying the vector into their internal data
+   * structures and save a pass through the fine vector.
+   */
+  virtual void restrict_residual_and_add (const unsigned int from_level,
+                                          VectorType         &dst,
+                                          const VectorType   &rhs,
+                                          VectorType         &matrix_times_solution) const;
 };
 
 
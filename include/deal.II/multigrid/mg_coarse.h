@@ -21,6 +21,7 @@
 #include <deal.II/lac/householder.h>
 #include <deal.II/lac/linear_operator.h>
 #include <deal.II/lac/matrix_lib.h>
+#include <deal.II/lac/sparse_amg.h>
 #include <deal.II/multigrid/mg_base.h>
 
 DEAL_II_NAMESPACE_OPEN
@@ -269,6 +270,52 @@ private:
   Householder<number> householder;
 };
 
+/**
+ * Coarse grid solver by the algebraic multigrid method of the class
+ * SparseAMG.
+ *
+ * Upon initialization, the AMG hierarchy of the coarse grid matrix is
+ * set up. The operator() then applies the number of V-cycles given by
+ * SparseAMG::AdditionalData::n_cycles, which controls the accuracy of the
+ * coarse grid solve. For an exact solve, use SparseAMG as preconditioner in
+ * MGCoarseGridIterativeSolver instead.
+ */
+template <typename number = double, class VectorType = Vector<number> >
+class MGCoarseGridAMG : public MGCoarseGridBase<VectorType>
+{
+public:
+  /**
+   * Constructor leaving an uninitialized object.
+   */
+  MGCoarseGridAMG () = default;
+
+  /**
+   * Set up the AMG hierarchy for the coarse grid matrix @p A. Only a
+   * reference to the matrix is stored.
+   */
+  void initialize (const SparseMatrix<number>                       &A,
+                   const typename SparseAMG<number>::AdditionalData &additional_data
+                   = typename SparseAMG<number>::AdditionalData());
+
+  /**
+   * Apply the V-cycles to @p src and store the result in @p dst.
+   */
+  void operator() (const unsigned int level,
+                   VectorType         &dst,
+                   const VectorType   &src) const;
+
+  /**
+   * Return the underlying AMG preconditioner.
+   */
+  const SparseAMG<number> &get_amg () const;
+
+private:
+  /**
+   * The AMG preconditioner.
+   */
+  SparseAMG<number> amg;
+};
+
 /**
  * Coarse grid solver using singular value decomposition of LAPACK matrices.
  *
@@ -564,6 +611,39 @@ MGCoarseGridHouseholder<number, VectorType>::operator() (const unsigned int /*le
 
 
 
+template <typename number, class VectorType>
+void
+MGCoarseGridAMG<number, VectorType>::initialize
+(const SparseMatrix<number>                       &A,
+ const typename SparseAMG<number>::AdditionalData &additional_data)
+{
+  amg.initialize(A, additional_data);
+}
+
+
+
+template <typename number, class VectorType>
+void
+MGCoarseGridAMG<number, VectorType>::operator() (const unsigned int /*level*/,
+                                                 VectorType         &dst,
+                                                 const VectorType   &src) const
+{
+  amg.vmult(dst, src);
+}
+
+
+
+template <typename number, class VectorType>
+const SparseAMG<number> &
+MGCoarseGridAMG<number, VectorType>::get_amg () const
+{
+  return amg;
+}
+
+//---------------------------------------------------------------------------
+
+
+
 template <typename number, class VectorType>
 void
 MGCoarseGridSVD<number, VectorType>::initialize (const FullMatrix<number> &A,
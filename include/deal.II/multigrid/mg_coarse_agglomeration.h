@@ -0,0 +1,231 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_mg_coarse_agglomeration_h
+#define dealii_mg_coarse_agglomeration_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/partitioner.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/multigrid/mg_base.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+/*!@addtogroup mg */
+/*@{*/
+
+/**
+ * Coarse grid solver that agglomerates the coarse level onto a subset of
+ * the MPI processes. On large numbers of processes, the coarse level of a
+ * multigrid hierarchy has only a few unknowns per process or none at all,
+ * and an iterative coarse grid solver spends most of its time in the global
+ * reductions and the ghost exchange over all processes, whereas the number
+ * of operations is small. This class moves the coarse level vectors to the
+ * first few processes of the communicator, where the unknowns are split
+ * into contiguous chunks of equal size, and runs the actual coarse grid
+ * solver, e.g. MGCoarseGridIterativeSolver, on a subcommunicator containing
+ * only these processes. All other processes only send their part of the
+ * right hand side and receive their part of the solution. With a single
+ * target process, this corresponds to a serial coarse grid solve.
+ *
+ * The coarse grid solver passed to set_coarse_grid_solver() works on vectors
+ * with the layout given by get_partitioner(), i.e., the matrix and the
+ * preconditioner it uses must be set up for vectors on the communicator
+ * returned by get_communicator(). This is only required on the processes for
+ * which is_active() returns true.
+ *
+ * The number of target processes can be selected by
+ * suggest_n_target_processes(), which keeps a given minimal number of
+ * cells or unknowns on each process.
+ *
+ * The unknowns owned by each process on the coarse level are required to
+ * form a contiguous range, as is the case for the vectors of DoFHandler and
+ * MatrixFree.
+ */
+template <typename Number>
+class MGCoarseGridAgglomeration
+  : public MGCoarseGridBase<LinearAlgebra::distributed::Vector<Number> >
+{
+public:
+  typedef LinearAlgebra::distributed::Vector<Number> VectorType;
+
+  /**
+   * Default constructor.
+   */
+  MGCoarseGridAgglomeration ();
+
+  /**
+   * Destructor. Frees the subcommunicator.
+   */
+  virtual ~MGCoarseGridAgglomeration ();
+
+  /**
+   * Set up the agglomeration of vectors with the layout of @p partitioner
+   * onto the first @p n_target_processes processes of its communicator. The
+   * ghost entries of @p partitioner are irrelevant. This function is
+   * collective over the communicator of @p partitioner.
+   */
+  void initialize (const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner,
+                   const unsigned int n_target_processes);
+
+  /**
+   * Set the coarse grid solver that is applied to the agglomerated vectors.
+   * Only a reference to the object is stored. Only needs to be called on
+   * the processes for which is_active() returns true.
+   */
+  void set_coarse_grid_solver (const MGCoarseGridBase<VectorType> &coarse_grid_solver);
+
+  /**
+   * Release the coarse grid solver and the subcommunicator.
+   */
+  void clear ();
+
+  /**
+   * Return whether the present process is part of the subcommunicator.
+   */
+  bool is_active () const;
+
+  /**
+   * Return the subcommunicator the agglomerated vectors live on. Must only
+   * be called on the processes for which is_active() returns true.
+   */
+  const MPI_Comm &get_communicator () const;
+
+  /**
+   * Return the layout of the agglomerated vectors. Must only be called on
+   * the processes for which is_active() returns true.
+   */
+  const std::shared_ptr<const Utilities::MPI::Partitioner> &
+  get_partitioner () const;
+
+  /**
+   * Copy the locally owned entries of @p src, which has the layout of the
+   * partitioner passed to initialize(), into the agglomerated vector @p
+   * dst. On the processes that are not active, @p dst is not touched.
+   */
+  void gather (VectorType       &dst,
+               const VectorType &src) const;
+
+  /**
+   * Copy the agglomerated vector @p src back into the locally owned entries
+   * of @p dst. This is the reverse operation of gather().
+   */
+  void scatter (VectorType       &dst,
+                const VectorType &src) const;
+
+  /**
+   * Implementation of the abstract function: Gather @p src onto the
+   * subcommunicator, apply the coarse grid solver there, and scatter the
+   * result into @p dst.
+   */
+  virtual void operator() (const unsigned int level,
+                           VectorType         &dst,
+                           const VectorType   &src) const;
+
+  /**
+   * Return the number of processes to agglomerate a coarse level with @p
+   * n_global_items cells or unknowns onto, such that each of them has at
+   * least @p min_items_per_process of them, but at most the number of
+   * processes in @p mpi_communicator and at least one.
+   */
+  static unsigned int
+  suggest_n_target_processes (const types::global_dof_index n_global_items,
+                              const unsigned int            min_items_per_process,
+                              const MPI_Comm               &mpi_communicator);
+
+  /**
+   * Return the memory consumption of this object in bytes.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * A contiguous part of the locally owned range that is exchanged with
+   * another process, given by the rank of that process, the offset within
+   * the local range and the number of entries.
+   */
+  typedef std::array<unsigned int,3> Chunk;
+
+  /**
+   * Send the entries of @p send_data described by @p send_chunks and
+   * receive the entries of @p receive_data described by @p receive_chunks.
+   */
+  void exchange (const std::vector<Chunk> &send_chunks,
+                 const Number             *send_data,
+                 const std::vector<Chunk> &receive_chunks,
+                 Number                   *receive_data) const;
+
+  /**
+   * The communicator of the original layout.
+   */
+  MPI_Comm mpi_communicator;
+
+  /**
+   * The subcommunicator of the first processes of mpi_communicator.
+   */
+  MPI_Comm sub_communicator;
+
+  /**
+   * Whether the present process is part of the subcommunicator.
+   */
+  bool active;
+
+  /**
+   * The layout of the agglomerated vectors.
+   */
+  std::shared_ptr<const Utilities::MPI::Partitioner> agglomerated_partitioner;
+
+  /**
+   * The local size of the original layout.
+   */
+  unsigned int original_local_size;
+
+  /**
+   * The parts of the locally owned range of the original layout that belong
+   * to the processes of the agglomerated layout.
+   */
+  std::vector<Chunk> original_chunks;
+
+  /**
+   * The parts of the locally owned range of the agglomerated layout that
+   * belong to the processes of the original layout.
+   */
+  std::vector<Chunk> agglomerated_chunks;
+
+  /**
+   * The coarse grid solver applied on the subcommunicator.
+   */
+  SmartPointer<const MGCoarseGridBase<VectorType>,MGCoarseGridAgglomeration<Number> > coarse_grid_solver;
+
+  /**
+   * Agglomerated vectors for the right hand side and the solution.
+   */
+  mutable VectorType agglomerated_src;
+  mutable VectorType agglomerated_dst;
+};
+
+/*@}*/
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
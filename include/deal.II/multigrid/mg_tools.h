@@ -28,7 +28,9 @@
 DEAL_II_NAMESPACE_OPEN
 
 template <int dim, int spacedim> class DoFHandler;
+template <typename Object> class MGLevelObject;
 class MGConstrainedDoFs;
+class SparsityPattern;
 
 /* !@addtogroup mg */
 /* @{ */
@@ -151,6 +153,41 @@ namespace MGTools
                                    SparsityPatternType     &sparsity,
                                    const unsigned int      level);
 
+  /**
+   * Build the sparsity patterns of all levels of @p dof_handler in one go.
+   * The result is the same as calling make_sparsity_pattern() (or
+   * make_flux_sparsity_pattern() if @p add_face_couplings is true) on a
+   * DynamicSparsityPattern for each level and copying it into @p sparsity,
+   * but the patterns are built directly as compressed SparsityPattern
+   * objects with the exact number of entries in each row, without an
+   * intermediate DynamicSparsityPattern.
+   *
+   * The levels are independent and are built in parallel. Within a level,
+   * the rows are split into one range per thread and the entries of each
+   * range are collected in parallel.
+   *
+   * @p sparsity is resized to the levels of the triangulation. Since each
+   * SparsityPattern stores all rows of its level, this function is meant for
+   * triangulations that are not distributed.
+   */
+  template <int dim, int spacedim>
+  void
+  make_level_sparsity_patterns (const DoFHandler<dim,spacedim> &dof_handler,
+                                MGLevelObject<SparsityPattern> &sparsity,
+                                const bool                      add_face_couplings = false);
+
+  /**
+   * Build the sparsity patterns of the interface matrices of all levels of
+   * @p dof_handler, with the same entries as make_interface_sparsity_pattern().
+   * As in make_level_sparsity_patterns(), the patterns are built in parallel
+   * over and within the levels with the exact number of entries in each row.
+   */
+  template <int dim, int spacedim>
+  void
+  make_level_interface_sparsity_patterns (const DoFHandler<dim,spacedim> &dof_handler,
+                                          const MGConstrainedDoFs        &mg_constrained_dofs,
+                                          MGLevelObject<SparsityPattern> &sparsity);
+
 
   /**
    * Count the dofs block-wise on each level.
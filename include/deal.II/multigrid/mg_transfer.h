@@ -115,11 +115,18 @@ namespace internal
     typedef ::dealii::SparseMatrix<Number> Matrix;
 
     template <typename SparsityPatternType, typename DoFHandlerType>
-    static void reinit(Matrix &, Sparsity &, int, const SparsityPatternType &, const DoFHandlerType &)
+    static void reinit(Matrix &matrix, Sparsity &sparsity, int level, const SparsityPatternType &sp, const DoFHandlerType &dh)
     {
-      AssertThrow(false, ExcNotImplemented(
-                    "ERROR: MGTransferPrebuilt with LinearAlgebra::distributed::Vector currently "
-                    "needs deal.II to be configured with Trilinos."));
+      // without Trilinos, the transfer matrices are deal.II matrices that
+      // work on vectors with all entries stored locally
+      AssertThrow(dh.locally_owned_mg_dofs(level+1).n_elements() == dh.n_dofs(level+1) &&
+                  dh.locally_owned_mg_dofs(level).n_elements() == dh.n_dofs(level),
+                  ExcNotImplemented(
+                    "ERROR: MGTransferPrebuilt with LinearAlgebra::distributed::Vector "
+                    "on more than one process currently needs deal.II to be configured "
+                    "with Trilinos."));
+      sparsity.copy_from (sp);
+      matrix.reinit (sparsity);
     }
   };
 
@@ -500,6 +507,12 @@ protected:
  * once by looping over all cells and storing the result in a matrix for each
  * level, but requires additional memory.
  *
+ * For vector types that use SparseMatrix objects as transfer matrices, the
+ * transposed matrices are stored as well, so that both prolongation and
+ * restriction run in parallel on the available threads. Without Trilinos,
+ * LinearAlgebra::distributed::Vector uses SparseMatrix objects as well,
+ * which restricts it to programs that run on a single process.
+ *
  * See MGTransferBase to find out which of the transfer classes is best for
  * your needs.
  *
@@ -596,6 +609,15 @@ public:
                                  VectorType         &dst,
                                  const VectorType   &src) const;
 
+  /**
+   * Prolongate a vector from level <tt>to_level-1</tt> to level
+   * <tt>to_level</tt> and add the result to <tt>dst</tt>, using a
+   * multiplication with the prolongation matrix that adds into @p dst.
+   */
+  virtual void prolongate_and_add (const unsigned int to_level,
+                                   VectorType         &dst,
+                                   const VectorType   &src) const;
+
   /**
    * Finite element does not provide prolongation matrices.
    */
@@ -630,6 +652,21 @@ private:
    */
   std::vector<std::shared_ptr<typename internal::MatrixSelector<VectorType>::Matrix> > prolongation_matrices;
 
+  /**
+   * Sparsity patterns for the restriction matrices.
+   */
+  std::vector<std::shared_ptr<SparsityPattern> > restriction_sparsities;
+
+  /**
+   * The transposes of the prolongation matrices, if these are of type
+   * SparseMatrix; empty otherwise. The multiplication with the transpose of
+   * a SparseMatrix runs on a single thread, since different rows add into
+   * the same entries of the result, whereas the multiplication with the
+   * transposed matrix is done in parallel. This is paid for by storing the
+   * entries of the transfer matrices twice.
+   */
+  std::vector<std::shared_ptr<SparseMatrix<typename VectorType::value_type> > > restriction_matrices;
+
   /**
    * Degrees of freedom on the refinement edge excluding those on the
    * boundary.
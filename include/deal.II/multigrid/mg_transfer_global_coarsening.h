@@ -0,0 +1,377 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_mg_transfer_global_coarsening_h
+#define dealii_mg_transfer_global_coarsening_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/mg_level_object.h>
+#include <deal.II/base/partitioner.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/multigrid/mg_base.h>
+
+#include <memory>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup mg */
+/*@{*/
+
+/**
+ * Transfer between the active cells of two DoFHandler objects on two
+ * different triangulations, where the coarse triangulation is obtained from
+ * the fine one by coarsening each cell at most once, as e.g. created by
+ * MGTransferGlobalCoarseningTools::create_geometric_coarsening_sequence().
+ * Each active cell of the fine triangulation is thus either also an active
+ * cell of the coarse triangulation or a child of an active coarse cell. In
+ * contrast to MGTransferMatrixFree, which works on the level cells of a
+ * single triangulation (local smoothing), this is the building block of
+ * multigrid methods with global coarsening, where each level is a separate
+ * mesh that covers the whole domain and can be partitioned independently
+ * of the other levels. Thus the coarse levels of a locally refined
+ * parallel::distributed::Triangulation keep a good load balance.
+ *
+ * The partitioning of the two triangulations is arbitrary: The connection
+ * between the locally owned fine cells and the coarse cells they derive
+ * from, which might be owned by any other process, is established by a
+ * rendezvous exchange of the CellId of the cells in reinit(). During the
+ * transfer, the unknowns of remote coarse cells are accessed through the
+ * ghost entries of an internal coarse vector.
+ *
+ * The prolongation interpolates the coarse function into the fine space by
+ * the embedding matrices of the finite element, after resolving the
+ * constraints of the coarse space, e.g. hanging nodes. For continuous
+ * elements, the contributions of the cells sharing a fine unknown are
+ * averaged. The restriction is the transpose of the prolongation. The
+ * constrained entries of the fine residual are ignored in the restriction,
+ * and the inhomogeneities of the coarse constraints are not considered, as
+ * usual in multigrid methods.
+ *
+ * This class assumes that both DoFHandler objects use the same finite
+ * element, and it does not support hp::DoFHandler.
+ */
+template <int dim, typename Number>
+class MGTwoLevelTransfer
+{
+public:
+  typedef LinearAlgebra::distributed::Vector<Number> VectorType;
+
+  /**
+   * Set up the transfer between the active DoFs of @p dof_handler_fine and
+   * @p dof_handler_coarse. The constraints must be closed and contain at
+   * least the locally relevant constrained DoFs of the respective DoFHandler.
+   * This function is collective over the communicator of the triangulation.
+   */
+  void reinit (const DoFHandler<dim> &dof_handler_fine,
+               const DoFHandler<dim> &dof_handler_coarse,
+               const ConstraintMatrix &constraints_fine,
+               const ConstraintMatrix &constraints_coarse);
+
+  /**
+   * Prolongate the vector @p src of the coarse space to the fine space and
+   * store the result in @p dst. Both vectors must have the locally owned
+   * DoFs of the respective DoFHandler as local range, but their ghost layout
+   * is arbitrary.
+   */
+  void prolongate (VectorType       &dst,
+                   const VectorType &src) const;
+
+  /**
+   * Same as prolongate(), but add the result to @p dst.
+   */
+  void prolongate_and_add (VectorType       &dst,
+                           const VectorType &src) const;
+
+  /**
+   * Restrict the vector @p src of the fine space to the coarse space and add
+   * the result to @p dst.
+   */
+  void restrict_and_add (VectorType       &dst,
+                         const VectorType &src) const;
+
+  /**
+   * Return the memory consumption of this object in bytes.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * Compute the prolongation of @p src into vec_fine.
+   */
+  void prolongate_to_vec_fine (const VectorType &src) const;
+
+  /**
+   * The number of unknowns per cell.
+   */
+  unsigned int dofs_per_cell;
+
+  /**
+   * The indices of the unknowns of the locally owned fine cells within
+   * vec_fine, with dofs_per_cell entries per cell.
+   */
+  std::vector<unsigned int> fine_indices;
+
+  /**
+   * The indices of the unknowns of the coarse cell that each locally owned
+   * fine cell derives from within vec_coarse, with dofs_per_cell entries per
+   * fine cell.
+   */
+  std::vector<unsigned int> coarse_indices;
+
+  /**
+   * For each locally owned fine cell, the index of the cell within the
+   * children of the coarse cell, or numbers::invalid_unsigned_int if the
+   * cell is active on both triangulations.
+   */
+  std::vector<unsigned int> child_numbers;
+
+  /**
+   * The embedding matrices for the isotropic children.
+   */
+  std::vector<FullMatrix<Number> > prolongation_matrices;
+
+  /**
+   * The inverse of the number of fine cells sharing an unknown, stored in
+   * the layout of vec_fine.
+   */
+  VectorType weights;
+
+  /**
+   * The locally owned constrained unknowns of the coarse space as indices
+   * within vec_coarse, together with the row starts into constraint_entries.
+   */
+  std::vector<unsigned int> coarse_constrained_indices;
+  std::vector<unsigned int> coarse_constraint_row_starts;
+
+  /**
+   * The entries of the coarse constraints, as the index of the unknown
+   * within vec_coarse and the weight.
+   */
+  std::vector<std::pair<unsigned int,Number> > coarse_constraint_entries;
+
+  /**
+   * The locally owned constrained unknowns of the fine space as indices
+   * within vec_fine.
+   */
+  std::vector<unsigned int> fine_constrained_indices;
+
+  /**
+   * Vectors with the ghost layout needed for the transfer.
+   */
+  mutable VectorType vec_fine;
+  mutable VectorType vec_coarse;
+};
+
+
+
+/**
+ * Implementation of the MGTransferBase interface for multigrid methods with
+ * global coarsening, where each level is represented by a separate
+ * DoFHandler on its own triangulation and the levels are connected by
+ * MGTwoLevelTransfer objects. The finest level is the DoFHandler the
+ * problem is posed on, such that copy_to_mg() and copy_from_mg() only copy
+ * the vector entries.
+ */
+template <int dim, typename Number>
+class MGTransferGlobalCoarsening : public MGTransferBase<LinearAlgebra::distributed::Vector<Number> >
+{
+public:
+  typedef LinearAlgebra::distributed::Vector<Number> VectorType;
+
+  /**
+   * Destructor.
+   */
+  virtual ~MGTransferGlobalCoarsening () = default;
+
+  /**
+   * Set up the hierarchy, where <tt>transfers[level]</tt> connects the
+   * levels <tt>level-1</tt> and @p level for all levels except the
+   * coarsest one, and @p partitioners hold the parallel layout of the
+   * vectors on all levels, e.g. obtained by
+   * MatrixFree::get_vector_partitioner() of the level operators. Both
+   * objects must have the same level range.
+   */
+  void build (const MGLevelObject<std::shared_ptr<const MGTwoLevelTransfer<dim,Number> > > &transfers,
+              const MGLevelObject<std::shared_ptr<const Utilities::MPI::Partitioner> > &partitioners);
+
+  /**
+   * Prolongate a vector from level <tt>to_level-1</tt> to level
+   * <tt>to_level</tt>.
+   */
+  virtual void prolongate (const unsigned int to_level,
+                           VectorType        &dst,
+                           const VectorType  &src) const;
+
+  /**
+   * Prolongate a vector from level <tt>to_level-1</tt> to level
+   * <tt>to_level</tt> and add the result to @p dst.
+   */
+  virtual void prolongate_and_add (const unsigned int to_level,
+                                   VectorType        &dst,
+                                   const VectorType  &src) const;
+
+  /**
+   * Restrict a vector from level <tt>from_level</tt> to level
+   * <tt>from_level-1</tt> and add the result to @p dst.
+   */
+  virtual void restrict_and_add (const unsigned int from_level,
+                                 VectorType        &dst,
+                                 const VectorType  &src) const;
+
+  /**
+   * Initialize the vectors on all levels and copy the global vector @p src
+   * into the finest level. The DoFHandler argument is only present for
+   * compatibility with the other transfer classes.
+   */
+  template <typename Number2, int spacedim>
+  void
+  copy_to_mg (const DoFHandler<dim,spacedim>                    &dof_handler,
+              MGLevelObject<VectorType>                         &dst,
+              const LinearAlgebra::distributed::Vector<Number2> &src) const;
+
+  /**
+   * Copy the finest level of @p src into the global vector @p dst.
+   */
+  template <typename Number2, int spacedim>
+  void
+  copy_from_mg (const DoFHandler<dim,spacedim>              &dof_handler,
+                LinearAlgebra::distributed::Vector<Number2> &dst,
+                const MGLevelObject<VectorType>             &src) const;
+
+  /**
+   * Add the finest level of @p src to the global vector @p dst.
+   */
+  template <typename Number2, int spacedim>
+  void
+  copy_from_mg_add (const DoFHandler<dim,spacedim>              &dof_handler,
+                    LinearAlgebra::distributed::Vector<Number2> &dst,
+                    const MGLevelObject<VectorType>             &src) const;
+
+  /**
+   * Return the memory consumption of this object in bytes, not counting the
+   * transfer objects passed to build().
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * The transfers between the levels.
+   */
+  MGLevelObject<std::shared_ptr<const MGTwoLevelTransfer<dim,Number> > > transfers;
+
+  /**
+   * The parallel layout of the level vectors.
+   */
+  MGLevelObject<std::shared_ptr<const Utilities::MPI::Partitioner> > partitioners;
+};
+
+
+/*@}*/
+
+
+
+/**
+ * Functions to set up the mesh hierarchy for multigrid methods with global
+ * coarsening.
+ */
+namespace MGTransferGlobalCoarseningTools
+{
+  /**
+   * Create a sequence of triangulations in which each one is obtained from
+   * the next finer one by coarsening all cells whose children are all active
+   * in the finer one, starting from @p fine_triangulation and ending with a
+   * triangulation without refinement. The result is ordered from the
+   * coarsest to the finest triangulation and does not include @p
+   * fine_triangulation itself.
+   *
+   * For a parallel::distributed::Triangulation, the new triangulations are
+   * created with the communicator and settings of @p fine_triangulation on
+   * the coarse mesh of @p fine_triangulation and refined until they match,
+   * which repartitions each of them with p4est independently of the others.
+   * The manifolds of @p fine_triangulation are attached to the new
+   * triangulations, so they must live as long as those are used.
+   */
+  template <int dim>
+  std::vector<std::shared_ptr<const Triangulation<dim> > >
+  create_geometric_coarsening_sequence (const Triangulation<dim> &fine_triangulation);
+}
+
+
+
+//------------------------ templated functions -------------------------
+#ifndef DOXYGEN
+
+
+template <int dim, typename Number>
+template <typename Number2, int spacedim>
+void
+MGTransferGlobalCoarsening<dim,Number>::copy_to_mg
+(const DoFHandler<dim,spacedim>                    &,
+ MGLevelObject<VectorType>                         &dst,
+ const LinearAlgebra::distributed::Vector<Number2> &src) const
+{
+  AssertDimension (dst.max_level(), partitioners.max_level());
+  for (unsigned int level=dst.min_level(); level<=dst.max_level(); ++level)
+    dst[level].reinit(partitioners[level]);
+  AssertDimension (dst[dst.max_level()].local_size(), src.local_size());
+  dst[dst.max_level()].copy_locally_owned_data_from(src);
+}
+
+
+
+template <int dim, typename Number>
+template <typename Number2, int spacedim>
+void
+MGTransferGlobalCoarsening<dim,Number>::copy_from_mg
+(const DoFHandler<dim,spacedim>              &,
+ LinearAlgebra::distributed::Vector<Number2> &dst,
+ const MGLevelObject<VectorType>             &src) const
+{
+  AssertDimension (dst.local_size(), src[src.max_level()].local_size());
+  dst.zero_out_ghosts();
+  dst.copy_locally_owned_data_from(src[src.max_level()]);
+}
+
+
+
+template <int dim, typename Number>
+template <typename Number2, int spacedim>
+void
+MGTransferGlobalCoarsening<dim,Number>::copy_from_mg_add
+(const DoFHandler<dim,spacedim>              &,
+ LinearAlgebra::distributed::Vector<Number2> &dst,
+ const MGLevelObject<VectorType>             &src) const
+{
+  const VectorType &src_level = src[src.max_level()];
+  AssertDimension (dst.local_size(), src_level.local_size());
+  dst.zero_out_ghosts();
+  for (unsigned int i=0; i<dst.local_size(); ++i)
+    dst.local_element(i) += src_level.local_element(i);
+}
+
+
+#endif // DOXYGEN
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -127,6 +127,28 @@ public:
                                  LinearAlgebra::distributed::Vector<Number>       &dst,
                                  const LinearAlgebra::distributed::Vector<Number> &src) const;
 
+  /**
+   * Prolongate a vector from level <tt>to_level-1</tt> to level
+   * <tt>to_level</tt> and add the result to @p dst. Compared to calling
+   * prolongate() on a temporary vector and adding it, this saves one pass
+   * through the fine vector.
+   */
+  virtual void prolongate_and_add (const unsigned int                           to_level,
+                                   LinearAlgebra::distributed::Vector<Number>       &dst,
+                                   const LinearAlgebra::distributed::Vector<Number> &src) const;
+
+  /**
+   * Restrict the residual <tt>rhs - matrix_times_solution</tt> from level
+   * <tt>from_level</tt> to level <tt>from_level-1</tt> and add the result to
+   * @p dst. The residual is formed while filling the internal ghosted vector,
+   * which saves one pass through the fine vectors compared to computing it
+   * separately. The vector @p matrix_times_solution is not modified.
+   */
+  virtual void restrict_residual_and_add (const unsigned int                           from_level,
+                                          LinearAlgebra::distributed::Vector<Number>       &dst,
+                                          const LinearAlgebra::distributed::Vector<Number> &rhs,
+                                          LinearAlgebra::distributed::Vector<Number>       &matrix_times_solution) const;
+
   /**
    * Restrict fine-mesh field @p src to each multigrid level in @p mg_dof and
    * store the result in @p dst.
@@ -231,6 +253,20 @@ private:
    */
   std::vector<std::vector<std::vector<unsigned short> > > dirichlet_indices;
 
+  /**
+   * Copy @p src into the ghosted vector of level <tt>to_level-1</tt> and
+   * compute the prolongation into the ghosted vector of level @p to_level.
+   */
+  void prolongate_to_ghosted (const unsigned int                                to_level,
+                              const LinearAlgebra::distributed::Vector<Number> &src) const;
+
+  /**
+   * Restrict the locally owned entries of the ghosted vector of level @p
+   * from_level and add the result to @p dst.
+   */
+  void restrict_ghosted_and_add (const unsigned int                          from_level,
+                                 LinearAlgebra::distributed::Vector<Number> &dst) const;
+
   /**
    * Performs templated prolongation operation
    */
@@ -356,6 +392,24 @@ public:
                                  LinearAlgebra::distributed::BlockVector<Number>       &dst,
                                  const LinearAlgebra::distributed::BlockVector<Number> &src) const;
 
+  /**
+   * Prolongate a vector from level <tt>to_level-1</tt> to level
+   * <tt>to_level</tt> and add the result to @p dst, see
+   * MGTransferMatrixFree::prolongate_and_add().
+   */
+  virtual void prolongate_and_add (const unsigned int                                    to_level,
+                                   LinearAlgebra::distributed::BlockVector<Number>       &dst,
+                                   const LinearAlgebra::distributed::BlockVector<Number> &src) const;
+
+  /**
+   * Restrict the residual <tt>rhs - matrix_times_solution</tt> and add the
+   * result to @p dst, see MGTransferMatrixFree::restrict_residual_and_add().
+   */
+  virtual void restrict_residual_and_add (const unsigned int                                    from_level,
+                                          LinearAlgebra::distributed::BlockVector<Number>       &dst,
+                                          const LinearAlgebra::distributed::BlockVector<Number> &rhs,
+                                          LinearAlgebra::distributed::BlockVector<Number>       &matrix_times_solution) const;
+
   /**
    * Transfer from a block-vector on the global grid to block-vectors defined
    * on each of the levels separately for active degrees of freedom.
@@ -0,0 +1,399 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_mg_transfer_polynomial_h
+#define dealii_mg_transfer_polynomial_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/mg_level_object.h>
+#include <deal.II/base/partitioner.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/multigrid/mg_base.h>
+#include <deal.II/multigrid/mg_transfer_matrix_free.h>
+#include <deal.II/dofs/dof_handler.h>
+
+#include <memory>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup mg */
+/*@{*/
+
+/**
+ * Transfer between two finite element spaces of different polynomial degree
+ * on the same mesh, as needed for multigrid methods that coarsen the
+ * polynomial degree (p-multigrid). The two spaces are represented by two
+ * DoFHandler objects that are handed to the same MatrixFree object, such that
+ * the cell batches of both spaces coincide. The prolongation from the coarse
+ * space of degree k' to the fine space of degree k is the embedding, i.e.,
+ * the interpolation of the coarse polynomials into the nodes of the fine
+ * element on each cell, which is applied by sum factorization with the 1D
+ * interpolation matrix stored in a ShapeInfo object. The restriction is the
+ * transpose of the prolongation.
+ *
+ * Since a continuous element shares degrees of freedom between cells, the
+ * cell contributions to the prolongated vector are weighted by the inverse
+ * of the number of cells sharing each fine degree of freedom. For FE_DGQ, all
+ * weights are one. The constraints of the coarse space, e.g. hanging nodes or
+ * homogeneous Dirichlet conditions, are resolved when reading the coarse
+ * vector and applied in transpose form when restricting. The fine space is
+ * accessed without constraints.
+ *
+ * This class currently only works for scalar finite elements with support
+ * points based on the tensor product of 1D polynomials, i.e., FE_Q and
+ * FE_DGQ and their variants with arbitrary nodes.
+ */
+template <int dim, typename Number>
+class MGTransferPolynomial
+{
+public:
+  typedef LinearAlgebra::distributed::Vector<Number> VectorType;
+
+  /**
+   * Constructor. Does nothing, call build() before use.
+   */
+  MGTransferPolynomial ();
+
+  /**
+   * Reset the object to the state it had right after the default
+   * constructor.
+   */
+  void clear ();
+
+  /**
+   * Set up the transfer between the finite elements with index @p fe_no_fine
+   * and @p fe_no_coarse in @p matrix_free. The MatrixFree object must not be
+   * modified or destroyed as long as this object is used. For multigrid
+   * levels, @p matrix_free is set up with the level DoFs of both DoFHandler
+   * objects on the same level, see MatrixFree::AdditionalData::level_mg_handler.
+   */
+  void build (const std::shared_ptr<const MatrixFree<dim,Number> > &matrix_free,
+              const unsigned int fe_no_fine,
+              const unsigned int fe_no_coarse);
+
+  /**
+   * Prolongate the vector @p src of the coarse space to the fine space and
+   * store the result in @p dst. Both vectors must have the locally owned
+   * range of the respective DoFHandler in the MatrixFree object, but their
+   * ghost layout is arbitrary.
+   */
+  void prolongate (VectorType       &dst,
+                   const VectorType &src) const;
+
+  /**
+   * Restrict the vector @p src of the fine space to the coarse space and add
+   * the result to @p dst.
+   */
+  void restrict_and_add (VectorType       &dst,
+                         const VectorType &src) const;
+
+  /**
+   * Return the memory consumption of this object in bytes.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+
+  /**
+   * Apply the 1D interpolation matrix in all directions on
+   * <tt>evaluation_data</tt>, going from the coarse to the fine space if @p
+   * prolongate is true and in transpose form otherwise.
+   */
+  template <bool prolongate>
+  void apply_tensorized_op () const;
+
+  /**
+   * The underlying MatrixFree object.
+   */
+  std::shared_ptr<const MatrixFree<dim,Number> > matrix_free;
+
+  /**
+   * The index of the fine element within matrix_free.
+   */
+  unsigned int fe_no_fine;
+
+  /**
+   * The index of the coarse element within matrix_free.
+   */
+  unsigned int fe_no_coarse;
+
+  /**
+   * Holds the values of the coarse shape functions in the support points of
+   * the fine element in 1D.
+   */
+  internal::MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number> > shape_info;
+
+  /**
+   * The inverse of the number of cells sharing a fine degree of freedom, in
+   * the lexicographic order of the unknowns per cell batch, i.e., with
+   * <tt>n_fine_dofs</tt> entries for each cell batch.
+   */
+  AlignedVector<VectorizedArray<Number> > weights;
+
+  /**
+   * Vectors with the ghost layout of matrix_free, used to read from and
+   * write into the vectors passed to prolongate() and restrict_and_add().
+   */
+  mutable VectorType vec_fine;
+  mutable VectorType vec_coarse;
+
+  /**
+   * Scratch memory for the sum factorization.
+   */
+  mutable AlignedVector<VectorizedArray<Number> > evaluation_data;
+};
+
+
+
+/**
+ * Implementation of the MGTransferBase interface for a multigrid hierarchy
+ * that combines geometric and polynomial coarsening. The coarse levels
+ * <tt>0,...,n_h_levels-1</tt> are the mesh levels of a DoFHandler with the
+ * lowest polynomial degree, connected by an MGTransferMatrixFree object. On
+ * top of these, the levels <tt>n_h_levels,...,n_h_levels+n_p_levels-1</tt>
+ * live on the finest mesh level with increasing polynomial degree and are
+ * connected by MGTransferPolynomial objects. Here, the first polynomial
+ * transfer goes from level <tt>n_h_levels-1</tt>, the finest geometric level,
+ * to level <tt>n_h_levels</tt>. This allows e.g. to go from a DG discretization
+ * of degree six to degree one on the fine mesh before coarsening the mesh,
+ * where a purely geometric hierarchy would keep the high degree down to the
+ * coarse grid solver.
+ *
+ * The transfer from the global vector to the finest level and back in
+ * copy_to_mg() and copy_from_mg() is forwarded to an MGTransferMatrixFree
+ * object built on the DoFHandler of the finest degree, which must have its
+ * level DoFs distributed. Consequently, all polynomial transfers must be
+ * based on the level DoFs of the finest mesh level as well.
+ */
+template <int dim, typename Number>
+class MGTransferHybrid : public MGTransferBase<LinearAlgebra::distributed::Vector<Number> >
+{
+public:
+  typedef LinearAlgebra::distributed::Vector<Number> VectorType;
+
+  /**
+   * Constructor. Does nothing, call build() before use.
+   */
+  MGTransferHybrid ();
+
+  /**
+   * Destructor.
+   */
+  virtual ~MGTransferHybrid () = default;
+
+  /**
+   * Set up the hierarchy, storing pointers to the given objects which must
+   * therefore live as long as this object is used. The arguments are
+   *
+   * - @p h_transfer: The transfer between the levels of the DoFHandler with
+   * the lowest polynomial degree, built with MGTransferMatrixFree::build(),
+   * which defines the levels <tt>0,...,n_h_levels-1</tt>, where
+   * <tt>n_h_levels</tt> is the number of levels of the triangulation.
+   *
+   * - @p p_transfers: The polynomial transfers, ordered from the lowest to
+   * the highest degree, where entry @p i connects the levels
+   * <tt>n_h_levels-1+i</tt> and <tt>n_h_levels+i</tt>.
+   *
+   * - @p top_transfer: A transfer object built with
+   * MGTransferMatrixFree::build() on the DoFHandler of the highest degree,
+   * used for copy_to_mg() and copy_from_mg(). If there are no polynomial
+   * levels, this is typically the same object as @p h_transfer.
+   *
+   * - @p partitioners: The parallel layout of the vectors on all levels of
+   * the hierarchy, e.g. obtained by MatrixFree::get_vector_partitioner() of
+   * the level operators, used to initialize the level vectors in
+   * copy_to_mg().
+   */
+  void build (const MGTransferMatrixFree<dim,Number> &h_transfer,
+              const std::vector<std::shared_ptr<const MGTransferPolynomial<dim,Number> > > &p_transfers,
+              const MGTransferMatrixFree<dim,Number> &top_transfer,
+              const MGLevelObject<std::shared_ptr<const Utilities::MPI::Partitioner> > &partitioners);
+
+  /**
+   * Prolongate a vector from level <tt>to_level-1</tt> to level
+   * <tt>to_level</tt>, using the geometric transfer on the lower levels and
+   * the polynomial transfer on the upper ones.
+   */
+  virtual void prolongate (const unsigned int to_level,
+                           VectorType        &dst,
+                           const VectorType  &src) const;
+
+  /**
+   * Restrict a vector from level <tt>from_level</tt> to level
+   * <tt>from_level-1</tt> and add the result to @p dst.
+   */
+  virtual void restrict_and_add (const unsigned int from_level,
+                                 VectorType        &dst,
+                                 const VectorType  &src) const;
+
+  /**
+   * Initialize the vectors on all levels and transfer the global vector @p
+   * src, defined on the DoFHandler of the highest degree, to the finest
+   * level.
+   */
+  template <typename Number2, int spacedim>
+  void
+  copy_to_mg (const DoFHandler<dim,spacedim>                 &dof_handler,
+              MGLevelObject<VectorType>                      &dst,
+              const LinearAlgebra::distributed::Vector<Number2> &src) const;
+
+  /**
+   * Transfer the finest level of @p src into the global vector @p dst.
+   */
+  template <typename Number2, int spacedim>
+  void
+  copy_from_mg (const DoFHandler<dim,spacedim>              &dof_handler,
+                LinearAlgebra::distributed::Vector<Number2> &dst,
+                const MGLevelObject<VectorType>             &src) const;
+
+  /**
+   * Same as copy_from_mg() but adding to the global vector.
+   */
+  template <typename Number2, int spacedim>
+  void
+  copy_from_mg_add (const DoFHandler<dim,spacedim>              &dof_handler,
+                    LinearAlgebra::distributed::Vector<Number2> &dst,
+                    const MGLevelObject<VectorType>             &src) const;
+
+  /**
+   * Return the number of levels with geometric coarsening.
+   */
+  unsigned int n_h_levels () const;
+
+  /**
+   * Return the memory consumption of this object in bytes, not counting the
+   * objects passed to build().
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * The transfer between the geometric levels.
+   */
+  SmartPointer<const MGTransferMatrixFree<dim,Number>,MGTransferHybrid<dim,Number> > h_transfer;
+
+  /**
+   * The transfers between the polynomial levels.
+   */
+  std::vector<std::shared_ptr<const MGTransferPolynomial<dim,Number> > > p_transfers;
+
+  /**
+   * The transfer used to connect the finest level with the global vector.
+   */
+  SmartPointer<const MGTransferMatrixFree<dim,Number>,MGTransferHybrid<dim,Number> > top_transfer;
+
+  /**
+   * The parallel layout of the level vectors.
+   */
+  MGLevelObject<std::shared_ptr<const Utilities::MPI::Partitioner> > partitioners;
+
+  /**
+   * The number of levels with geometric coarsening.
+   */
+  unsigned int n_geometric_levels;
+
+  /**
+   * The finest level vector in the level numbering of the DoFHandler of the
+   * highest degree, as needed by top_transfer.
+   */
+  mutable MGLevelObject<VectorType> top_level_vector;
+};
+
+
+/*@}*/
+
+
+//------------------------ templated functions -------------------------
+#ifndef DOXYGEN
+
+
+template <int dim, typename Number>
+template <typename Number2, int spacedim>
+void
+MGTransferHybrid<dim,Number>::copy_to_mg
+(const DoFHandler<dim,spacedim>                    &dof_handler,
+ MGLevelObject<VectorType>                         &dst,
+ const LinearAlgebra::distributed::Vector<Number2> &src) const
+{
+  Assert (top_transfer != nullptr, ExcNotInitialized());
+  AssertDimension (dst.max_level(), partitioners.max_level());
+  for (unsigned int level=dst.min_level(); level<=dst.max_level(); ++level)
+    dst[level].reinit(partitioners[level]);
+
+  const unsigned int top_level = dof_handler.get_triangulation().n_global_levels()-1;
+  top_level_vector.resize(top_level, top_level);
+  top_transfer->copy_to_mg(dof_handler, top_level_vector, src);
+  dst[dst.max_level()].copy_locally_owned_data_from(top_level_vector[top_level]);
+}
+
+
+
+template <int dim, typename Number>
+template <typename Number2, int spacedim>
+void
+MGTransferHybrid<dim,Number>::copy_from_mg
+(const DoFHandler<dim,spacedim>              &dof_handler,
+ LinearAlgebra::distributed::Vector<Number2> &dst,
+ const MGLevelObject<VectorType>             &src) const
+{
+  Assert (top_transfer != nullptr, ExcNotInitialized());
+  const unsigned int top_level = dof_handler.get_triangulation().n_global_levels()-1;
+  top_level_vector.resize(top_level, top_level);
+  top_level_vector[top_level].reinit(src[src.max_level()], true);
+  top_level_vector[top_level].copy_locally_owned_data_from(src[src.max_level()]);
+  top_transfer->copy_from_mg(dof_handler, dst, top_level_vector);
+}
+
+
+
+template <int dim, typename Number>
+template <typename Number2, int spacedim>
+void
+MGTransferHybrid<dim,Number>::copy_from_mg_add
+(const DoFHandler<dim,spacedim>              &dof_handler,
+ LinearAlgebra::distributed::Vector<Number2> &dst,
+ const MGLevelObject<VectorType>             &src) const
+{
+  Assert (top_transfer != nullptr, ExcNotInitialized());
+  const unsigned int top_level = dof_handler.get_triangulation().n_global_levels()-1;
+  top_level_vector.resize(top_level, top_level);
+  top_level_vector[top_level].reinit(src[src.max_level()], true);
+  top_level_vector[top_level].copy_locally_owned_data_from(src[src.max_level()]);
+  top_transfer->copy_from_mg_add(dof_handler, dst, top_level_vector);
+}
+
+
+
+template <int dim, typename Number>
+inline
+unsigned int
+MGTransferHybrid<dim,Number>::n_h_levels () const
+{
+  return n_geometric_levels;
+}
+
+
+#endif // DOXYGEN
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
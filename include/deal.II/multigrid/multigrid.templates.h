@@ -141,29 +141,38 @@ Multigrid<VectorType>::level_v_step (const unsigned int level)
       if (debug>2)
         deallog << "Norm     t[" << level << "] " << t[level].l2_norm() << std::endl;
     }
-  t[level].sadd(-1.0, 1.0, defect[level]);
-
-  if (debug>2)
-    deallog << "Residual norm          " << t[level].l2_norm()
-            << std::endl;
 
   // Get the defect on the next coarser level as part of the (DG) edge matrix
-  // and then the main part by the restriction of the transfer
+  // and then the main part by the restriction of the transfer. Unless the
+  // residual is printed, let the transfer form it on the fly to avoid a
+  // separate pass through the vectors.
   if (edge_down != nullptr)
     {
       edge_down->vmult(level, t[level-1], solution[level]);
       defect[level-1] -= t[level-1];
     }
-  transfer->restrict_and_add(level, defect[level-1], t[level]);
+  if (debug>2)
+    {
+      t[level].sadd(-1.0, 1.0, defect[level]);
+      deallog << "Residual norm          " << t[level].l2_norm()
+              << std::endl;
+      transfer->restrict_and_add(level, defect[level-1], t[level]);
+    }
+  else
+    transfer->restrict_residual_and_add(level, defect[level-1], defect[level], t[level]);
 
   // do recursion
   level_v_step(level-1);
 
   // do coarse grid correction
-  transfer->prolongate(level, t[level], solution[level-1]);
   if (debug>2)
-    deallog << "Prolongate norm        " << t[level].l2_norm() << std::endl;
-  solution[level] += t[level];
+    {
+      transfer->prolongate(level, t[level], solution[level-1]);
+      deallog << "Prolongate norm        " << t[level].l2_norm() << std::endl;
+      solution[level] += t[level];
+    }
+  else
+    transfer->prolongate_and_add(level, solution[level], solution[level-1]);
 
   // get in contribution from edge matrices to the defect
   if (edge_in != nullptr)
@@ -253,11 +262,6 @@ Multigrid<VectorType>::level_step(const unsigned int level,
   matrix->vmult(level, t[level], solution[level]);
   if (edge_out != nullptr)
     edge_out->vmult_add(level, t[level], solution[level]);
-  t[level].sadd(-1.0, 1.0, defect2[level]);
-
-  if (debug>2)
-    deallog << cychar << "-cycle residual norm   " << t[level].l2_norm()
-            << std::endl;
 
   // Get the defect on the next coarser level as part of the (DG) edge matrix
   // and then the main part by the restriction of the transfer
@@ -266,7 +270,16 @@ Multigrid<VectorType>::level_step(const unsigned int level,
   else
     defect2[level-1] = typename VectorType::value_type(0.);
 
-  transfer->restrict_and_add (level, defect2[level-1], t[level]);
+  if (debug>2)
+    {
+      t[level].sadd(-1.0, 1.0, defect2[level]);
+      deallog << cychar << "-cycle residual norm   " << t[level].l2_norm()
+              << std::endl;
+      transfer->restrict_and_add (level, defect2[level-1], t[level]);
+    }
+  else
+    transfer->restrict_residual_and_add (level, defect2[level-1], defect2[level],
+                                         t[level]);
 
   // Every cycle starts with a recursion of its type.
   level_step(level-1, cycle);
@@ -285,8 +298,7 @@ Multigrid<VectorType>::level_step(const unsigned int level,
     }
 
   // do coarse grid correction
-  transfer->prolongate(level, t[level], solution[level-1]);
-  solution[level] += t[level];
+  transfer->prolongate_and_add(level, solution[level], solution[level-1]);
 
   // get in contribution from edge matrices to the defect
   if (edge_in != nullptr)
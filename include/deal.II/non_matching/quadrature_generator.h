@@ -0,0 +1,345 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_non_matching_quadrature_generator_h
+#define dealii_non_matching_quadrature_generator_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/bounding_box.h>
+#include <deal.II/base/function.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/non_matching/immersed_surface_quadrature.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+namespace NonMatching
+{
+
+  /**
+   * Parameters that control the generation of quadratures by
+   * QuadratureGenerator.
+   */
+  struct AdditionalQGeneratorData
+  {
+    /**
+     * Constructor.
+     */
+    AdditionalQGeneratorData (const unsigned int max_box_splits = 4,
+                              const unsigned int n_root_search_intervals = 4,
+                              const double       root_tolerance = 1e-12);
+
+    /**
+     * The number of times a box is split in all coordinate directions if no
+     * direction is found in which all level set functions are monotone. If
+     * a box can not be split any further, the quadrature on it is still
+     * generated with the direction in which the level set function changes
+     * the most, at a reduced order of accuracy.
+     */
+    unsigned int max_box_splits;
+
+    /**
+     * The number of intervals an interval is divided into when searching the
+     * roots of a function along it that is not known to be monotone.
+     */
+    unsigned int n_root_search_intervals;
+
+    /**
+     * The tolerance of the root finding, relative to the length of the
+     * interval the root is searched in.
+     */
+    double root_tolerance;
+  };
+
+
+
+  /**
+   * The location of a box, for example a cell, relative to the zero contour
+   * of a level set function $\psi$.
+   */
+  enum class LocationToLevelSet
+  {
+    /**
+     * $\psi < 0$ on the whole box.
+     */
+    inside,
+    /**
+     * $\psi > 0$ on the whole box.
+     */
+    outside,
+    /**
+     * The zero contour of $\psi$ intersects the box.
+     */
+    intersected
+  };
+
+
+
+  /**
+   * A class that generates quadrature rules over the regions of a box,
+   * $B \subset \mathbb{R}^{dim}$, that are defined by a level set function
+   * $\psi$: the inside region $\{x \in B : \psi(x) < 0\}$, the outside region
+   * $\{x \in B : \psi(x) > 0\}$, and the surface $\{x \in B : \psi(x) = 0\}$
+   * that separates them. The surface quadrature is an
+   * ImmersedSurfaceQuadrature and contains the normals $\nabla \psi / |\nabla
+   * \psi|$, which point from the inside to the outside region.
+   *
+   * The quadratures are generated by the dimension-recursive algorithm of
+   * R. Saye, "High-order quadrature methods for implicitly defined surfaces
+   * and volumes in hyperrectangles", SIAM Journal on Scientific Computing
+   * 37(2), 2015. A coordinate direction is sought in which $\psi$ is
+   * monotone on the box. The zero contour can then be written as a height
+   * function over the face of the box that is orthogonal to this direction,
+   * and the integral over a region is written as an integral over that face
+   * of one-dimensional integrals along the height direction. The restrictions
+   * of $\psi$ to the top and bottom faces of the box define the level set
+   * functions of the integral over the face, to which the same algorithm is
+   * applied in one dimension less. In one dimension, the roots of all level
+   * set functions split the interval into the subintervals on which they have
+   * one sign, and the one-dimensional quadrature passed to the constructor is
+   * used on each subinterval. If the quadrature passed to the constructor is
+   * a Gauss formula with $n$ points, the generated rules integrate
+   * polynomials of degree $2n-1$ exactly for the usual smooth level set
+   * functions, in contrast to subdividing the box and discarding the points
+   * outside the region, which only converges with the size of the
+   * subdivision. If no monotone direction exists, the box is split into
+   * $2^{dim}$ boxes and the algorithm is applied to each of them, up to the
+   * number of splits given by AdditionalQGeneratorData::max_box_splits.
+   *
+   * Whether $\psi$ has one sign or is monotone on a box is decided from the
+   * values and gradients of $\psi$ at the vertices and the center of the box.
+   * This is an estimate and not a guaranteed bound, so the level set
+   * function should be resolved by the boxes passed to generate(), i.e.,
+   * its zero contour should not have features that are much smaller than the
+   * boxes.
+   *
+   * The class can be used as follows, where the quadratures are generated in
+   * the coordinates of the box that is passed to generate():
+   * @code
+   *   NonMatching::QuadratureGenerator<dim> generator (QGauss<1>(fe_degree+1));
+   *   generator.generate (level_set, box);
+   *   const Quadrature<dim> &inside = generator.get_inside_quadrature();
+   *   const NonMatching::ImmersedSurfaceQuadrature<dim> &surface
+   *     = generator.get_surface_quadrature();
+   * @endcode
+   * In order to generate the quadratures for all the cells of a mesh, see
+   * the class CutCellQuadratures.
+   */
+  template <int dim>
+  class QuadratureGenerator
+  {
+  public:
+    /**
+     * Constructor. The one-dimensional quadrature @p quadrature1D, given on
+     * the unit interval, is the basis of all the quadratures generated.
+     */
+    QuadratureGenerator (const Quadrature<1>            &quadrature1D,
+                         const AdditionalQGeneratorData &additional_data = AdditionalQGeneratorData());
+
+    /**
+     * Generate the quadratures of the inside and outside regions and of the
+     * surface defined by the level set function @p level_set on the box
+     * @p box. The function @p level_set needs to provide the functions
+     * Function::value() and Function::gradient().
+     */
+    void generate (const Function<dim>     &level_set,
+                   const BoundingBox<dim> &box);
+
+    /**
+     * Return the location of the box passed to the last call to generate()
+     * relative to the zero contour of the level set function.
+     */
+    LocationToLevelSet get_location () const;
+
+    /**
+     * Return the quadrature of the region where the level set function is
+     * negative, generated by the last call to generate().
+     */
+    const Quadrature<dim> &get_inside_quadrature () const;
+
+    /**
+     * Return the quadrature of the region where the level set function is
+     * positive, generated by the last call to generate().
+     */
+    const Quadrature<dim> &get_outside_quadrature () const;
+
+    /**
+     * Return the quadrature of the zero contour of the level set function,
+     * generated by the last call to generate().
+     */
+    const ImmersedSurfaceQuadrature<dim> &get_surface_quadrature () const;
+
+  private:
+    /**
+     * The one-dimensional quadrature on the unit interval.
+     */
+    const Quadrature<1> quadrature1D;
+
+    /**
+     * The parameters of the algorithm.
+     */
+    const AdditionalQGeneratorData additional_data;
+
+    /**
+     * The location of the box of the last call to generate().
+     */
+    LocationToLevelSet location;
+
+    /**
+     * The generated quadratures.
+     */
+    Quadrature<dim> inside_quadrature;
+    Quadrature<dim> outside_quadrature;
+    ImmersedSurfaceQuadrature<dim> surface_quadrature;
+  };
+
+
+
+  /**
+   * The inside, outside and surface quadratures of all active cells of a
+   * triangulation for a level set function given in real space. The
+   * quadratures are generated once by reinit(), in parallel on all threads,
+   * and can then be used by all the loops over the cells until the level set
+   * function or the mesh changes. The quadratures are given on the unit cell
+   * and can be passed to an FEValues object on the cell.
+   *
+   * The quadratures are only stored for the cells that are intersected by
+   * the zero contour. For the other cells, which lie entirely inside or
+   * outside, the usual quadrature of the cell should be used, as in the
+   * following example:
+   * @code
+   *   NonMatching::CutCellQuadratures<dim> cut_quadratures (QGauss<1>(fe_degree+1));
+   *   cut_quadratures.reinit (triangulation, level_set);
+   *
+   *   for (const auto &cell : dof_handler.active_cell_iterators())
+   *     if (cut_quadratures.get_location (cell) ==
+   *         NonMatching::LocationToLevelSet::inside)
+   *       {
+   *         fe_values.reinit (cell);
+   *         ...
+   *       }
+   *     else if (cut_quadratures.get_location (cell) ==
+   *              NonMatching::LocationToLevelSet::intersected)
+   *       {
+   *         FEValues<dim> cut_fe_values (mapping, fe,
+   *                                      cut_quadratures.get_inside_quadrature (cell),
+   *                                      update_flags);
+   *         cut_fe_values.reinit (cell);
+   *         ...
+   *       }
+   * @endcode
+   *
+   * The level set function is evaluated on the unit cell through the affine
+   * mapping defined by the bounding box of each cell, so this class requires
+   * meshes whose cells are rectangles or bricks with faces parallel to the
+   * coordinate planes.
+   */
+  template <int dim>
+  class CutCellQuadratures : public Subscriptor
+  {
+  public:
+    /**
+     * Constructor. The arguments are passed on to the QuadratureGenerator
+     * objects that generate the quadratures.
+     */
+    CutCellQuadratures (const Quadrature<1>            &quadrature1D,
+                        const AdditionalQGeneratorData &additional_data = AdditionalQGeneratorData());
+
+    /**
+     * Generate the quadratures on all active cells of @p triangulation for the
+     * level set function @p level_set, which is given in real space. The
+     * work is distributed among the available threads.
+     */
+    void reinit (const Triangulation<dim> &triangulation,
+                 const Function<dim>      &level_set);
+
+    /**
+     * Return the location of @p cell relative to the zero contour of the
+     * level set function.
+     */
+    LocationToLevelSet
+    get_location (const typename Triangulation<dim>::active_cell_iterator &cell) const;
+
+    /**
+     * Return the quadrature on the unit cell of the part of the intersected
+     * cell @p cell where the level set function is negative.
+     */
+    const Quadrature<dim> &
+    get_inside_quadrature (const typename Triangulation<dim>::active_cell_iterator &cell) const;
+
+    /**
+     * Return the quadrature on the unit cell of the part of the intersected
+     * cell @p cell where the level set function is positive.
+     */
+    const Quadrature<dim> &
+    get_outside_quadrature (const typename Triangulation<dim>::active_cell_iterator &cell) const;
+
+    /**
+     * Return the quadrature on the unit cell of the zero contour of the level
+     * set function within the intersected cell @p cell.
+     */
+    const ImmersedSurfaceQuadrature<dim> &
+    get_surface_quadrature (const typename Triangulation<dim>::active_cell_iterator &cell) const;
+
+    /**
+     * Return an estimate (in bytes) for the memory consumption of this
+     * object.
+     */
+    std::size_t memory_consumption () const;
+
+  private:
+    /**
+     * Return the index of @p cell within the vectors of quadratures, after
+     * checking that the cell is intersected.
+     */
+    unsigned int
+    cut_cell_index (const typename Triangulation<dim>::active_cell_iterator &cell) const;
+
+    const Quadrature<1> quadrature1D;
+
+    const AdditionalQGeneratorData additional_data;
+
+    /**
+     * The triangulation passed to reinit().
+     */
+    SmartPointer<const Triangulation<dim>,CutCellQuadratures<dim> > triangulation;
+
+    /**
+     * The location of each active cell, indexed by the active cell index.
+     */
+    std::vector<LocationToLevelSet> locations;
+
+    /**
+     * The index of each intersected cell within the vectors of quadratures,
+     * indexed by the active cell index.
+     */
+    std::vector<unsigned int> cut_cell_indices;
+
+    /**
+     * The quadratures of the intersected cells.
+     */
+    std::vector<Quadrature<dim> > inside_quadratures;
+    std::vector<Quadrature<dim> > outside_quadratures;
+    std::vector<ImmersedSurfaceQuadrature<dim> > surface_quadratures;
+  };
+
+}
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -21,6 +21,7 @@
 #include <deal.II/base/config.h>
 #include <deal.II/numerics/data_out_dof_data.h>
 
+#include <functional>
 #include <memory>
 
 DEAL_II_NAMESPACE_OPEN
@@ -286,6 +287,49 @@ public:
                               const unsigned int n_subdivisions = 0,
                               const CurvedCellRegion curved_region = curved_boundary);
 
+  /**
+   * Same as the function above, but rather than building the patches of all
+   * cells at once, this function builds the patches of at most @p
+   * n_cells_per_chunk consecutive cells at a time and calls @p process_chunk
+   * with the index of the chunk after the patches of each chunk are built.
+   * Within @p process_chunk, the patches of the current chunk are the ones
+   * returned by get_patches(), so the function can call any of the write_*
+   * functions of this class to write them, for example as one piece of a
+   * parallel VTU record. The patches of a chunk are released before the
+   * next chunk is built, so the memory needed for the patches of the whole
+   * mesh, which can be a multiple of the memory of the solution vectors when
+   * many subdivisions are used, is reduced to the memory of one chunk.
+   *
+   * The patches of a chunk are numbered starting at zero, and neighbor
+   * information only refers to patches within the same chunk. The function
+   * @p process_chunk is called at least once, with empty patches if there
+   * are no cells to output, so that every process of a parallel computation
+   * writes the same pieces. After this function returns, get_patches()
+   * returns an empty vector.
+   *
+   * A typical use writes each chunk to a separate file and groups them with
+   * write_pvtu_record():
+   * @code
+   *   std::vector<std::string> piece_names;
+   *   data_out.build_patches_in_chunks
+   *   (mapping, n_subdivisions, 10000,
+   *    [&] (const unsigned int chunk)
+   *    {
+   *      piece_names.push_back ("solution-" +
+   *                             Utilities::int_to_string(chunk, 4) + ".vtu");
+   *      std::ofstream output (piece_names.back().c_str());
+   *      data_out.write_vtu (output);
+   *    });
+   *   std::ofstream master_output ("solution.pvtu");
+   *   data_out.write_pvtu_record (master_output, piece_names);
+   * @endcode
+   */
+  void build_patches_in_chunks (const Mapping<DoFHandlerType::dimension, DoFHandlerType::space_dimension> &mapping,
+                                const unsigned int n_subdivisions,
+                                const unsigned int n_cells_per_chunk,
+                                const std::function<void (const unsigned int)> &process_chunk,
+                                const CurvedCellRegion curved_region = curved_boundary);
+
   /**
    * Return the first cell which we want output for. The default
    * implementation returns the first active cell, but you might want to
@@ -322,6 +366,19 @@ private:
    */
   virtual cell_iterator next_locally_owned_cell (const cell_iterator &cell);
 
+  /**
+   * Build the patches of the cells in chunks of at most @p n_cells_per_chunk
+   * cells and call @p process_chunk, if it is not empty, after each chunk.
+   * This is the implementation of both build_patches() and
+   * build_patches_in_chunks().
+   */
+  void build_patches_impl
+  (const Mapping<DoFHandlerType::dimension, DoFHandlerType::space_dimension> &mapping,
+   const unsigned int                                                        n_subdivisions,
+   const CurvedCellRegion                                                    curved_region,
+   const unsigned int                                                        n_cells_per_chunk,
+   const std::function<void (const unsigned int)>                           &process_chunk);
+
   /**
    * Build one patch. This function is called in a WorkStream context.
    *
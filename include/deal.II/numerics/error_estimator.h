@@ -114,14 +114,16 @@ namespace hp
  * will suffice. For higher order elements, it is necessary to utilize higher
  * order quadrature formulae as well.
  *
- * We store the contribution of each face in a @p map, as provided by the C++
- * standard library, with the iterator pointing to that face being the key
- * into the map. When looping the second time over all cells, we have to sum
+ * We store the contribution of each face in an array indexed by the index of
+ * that face in the triangulation. Since every face is integrated by exactly
+ * one of its adjacent cells, the threads working on different cells write
+ * into different entries of this array. When looping the second time over
+ * all cells, we have to sum
  * up the contributions of the faces and take the square root. For the Kelly
  * estimator, the multiplication with $\frac {h_K}{24}$ is done in the second
  * loop. By doing so we avoid problems to decide with which $h_K$ to multiply,
  * that of the cell on the one or that of the cell on the other side of the
- * face. Whereas for the hp-estimator the @p map stores integrals multiplied
+ * face. Whereas for the hp-estimator the array stores integrals multiplied
  * by $\frac {h_F}{2p_F}$, which are then summed in the second loop.
  *
  * $h_K$ ($h_F$) is taken to be the greatest length of the diagonals of the cell
@@ -218,7 +220,7 @@ namespace hp
  * Since we integrate from the coarse side of the face, we have the mother
  * face readily at hand and store the result of the integration over that
  * mother face (being the sum of the integrals along the subfaces) in the
- * abovementioned map of integrals as well. This consumes some memory more
+ * abovementioned array of integrals as well. This consumes some memory more
  * than needed, but makes the summing up of the face contributions to the
  * cells easier, since then we have the information from all faces of all
  * cells at hand and need not think about explicitly determining whether a
@@ -293,40 +293,6 @@ namespace internal
 
 
 
-    /**
-     * Copy data from the local_face_integrals map of a single ParallelData
-     * object into a global such map. This is the copier stage of a WorkStream
-     * pipeline.
-     */
-    template <typename DoFHandlerType>
-    void
-    copy_local_to_global
-    (const std::map<typename DoFHandlerType::face_iterator,std::vector<double> > &local_face_integrals,
-     std::map<typename DoFHandlerType::face_iterator,std::vector<double> > &face_integrals)
-    {
-
-      // now copy locally computed elements into the global map
-      for (typename std::map<typename DoFHandlerType::face_iterator,std::vector<double> >::const_iterator
-           p=local_face_integrals.begin();
-           p!=local_face_integrals.end();
-           ++p)
-        {
-          // double check that the element does not already exists in the
-          // global map
-          Assert (face_integrals.find (p->first) == face_integrals.end(),
-                  ExcInternalError());
-
-          for (unsigned int i=0; i<p->second.size(); ++i)
-            {
-              Assert (numbers::is_finite(p->second[i]), ExcInternalError());
-              Assert (p->second[i] >= 0, ExcInternalError());
-            }
-
-          face_integrals[p->first] = p->second;
-        }
-    }
-
-
     /**
      * Actually do the computation based on the evaluated gradients in
      * ParallelData.
@@ -617,7 +583,7 @@ namespace internal
     void
     integrate_over_regular_face (const std::vector<const InputVector *>   &solutions,
                                  ParallelData<DoFHandlerType, typename InputVector::value_type> &parallel_data,
-                                 std::map<typename DoFHandlerType::face_iterator,std::vector<double> > &local_face_integrals,
+                                 std::vector<double>                     &face_integrals,
                                  const typename DoFHandlerType::active_cell_iterator &cell,
                                  const unsigned int                       face_no,
                                  dealii::hp::FEFaceValues<DoFHandlerType::dimension, DoFHandlerType::space_dimension> &fe_face_values_cell,
@@ -638,9 +604,8 @@ namespace internal
 
       // get gradients of the finite element
       // function on this cell
-      for (unsigned int n=0; n<n_solution_vectors; ++n)
-        fe_face_values_cell.get_present_fe_values()
-        .get_function_gradients (*solutions[n], parallel_data.psi[n]);
+      fe_face_values_cell.get_present_fe_values()
+      .get_function_gradients (solutions, parallel_data.psi);
 
       double factor;
       // now compute over the other side of the face
@@ -670,12 +635,8 @@ namespace internal
                                                        strategy);
 
           // get gradients on neighbor cell
-          for (unsigned int n=0; n<n_solution_vectors; ++n)
-            {
-              fe_face_values_neighbor.get_present_fe_values()
-              .get_function_gradients (*solutions[n],
-                                       parallel_data.neighbor_psi[n]);
-            }
+          fe_face_values_neighbor.get_present_fe_values()
+          .get_function_gradients (solutions, parallel_data.neighbor_psi);
 
           parallel_data.neighbor_normal_vectors =
             fe_face_values_neighbor.get_present_fe_values().get_all_normal_vectors();
@@ -689,12 +650,12 @@ namespace internal
         }
 
       // now go to the generic function that does all the other things
-      local_face_integrals[face] =
-        integrate_over_face (parallel_data, face,
-                             fe_face_values_cell);
+      const std::vector<double> face_integral
+        = integrate_over_face (parallel_data, face,
+                               fe_face_values_cell);
 
-      for (unsigned int i = 0; i < local_face_integrals[face].size(); i++)
-        local_face_integrals[face][i] *= factor;
+      for (unsigned int n=0; n<n_solution_vectors; ++n)
+        face_integrals[face->index()*n_solution_vectors+n] = face_integral[n] * factor;
     }
 
 
@@ -709,7 +670,7 @@ namespace internal
     void
     integrate_over_irregular_face (const std::vector<const InputVector *>   &solutions,
                                    ParallelData<DoFHandlerType, typename InputVector::value_type> &parallel_data,
-                                   std::map<typename DoFHandlerType::face_iterator,std::vector<double> > &local_face_integrals,
+                                   std::vector<double>                     &face_integrals,
                                    const typename DoFHandlerType::active_cell_iterator    &cell,
                                    const unsigned int                          face_no,
                                    dealii::hp::FEFaceValues<DoFHandlerType::dimension,DoFHandlerType::space_dimension>    &fe_face_values,
@@ -769,41 +730,38 @@ namespace internal
                                                                       strategy);
 
           // store the gradient of the solution in psi
-          for (unsigned int n=0; n<n_solution_vectors; ++n)
-            fe_subface_values.get_present_fe_values()
-            .get_function_gradients (*solutions[n], parallel_data.psi[n]);
+          fe_subface_values.get_present_fe_values()
+          .get_function_gradients (solutions, parallel_data.psi);
 
           // store the gradient from the neighbor's side in @p{neighbor_psi}
-          for (unsigned int n=0; n<n_solution_vectors; ++n)
-            fe_face_values.get_present_fe_values()
-            .get_function_gradients (*solutions[n], parallel_data.neighbor_psi[n]);
+          fe_face_values.get_present_fe_values()
+          .get_function_gradients (solutions, parallel_data.neighbor_psi);
 
           // call generic evaluate function
           parallel_data.neighbor_normal_vectors =
             fe_subface_values.get_present_fe_values().get_all_normal_vectors();
 
-          local_face_integrals[neighbor_child->face(neighbor_neighbor)] =
-            integrate_over_face (parallel_data, face, fe_face_values);
-          for (unsigned int i = 0; i < local_face_integrals[neighbor_child->face(neighbor_neighbor)].size(); i++)
-            local_face_integrals[neighbor_child->face(neighbor_neighbor)][i] *= factor;
+          const std::vector<double> face_integral
+            = integrate_over_face (parallel_data, face, fe_face_values);
+          const unsigned int subface_index
+            = neighbor_child->face(neighbor_neighbor)->index();
+          for (unsigned int n=0; n<n_solution_vectors; ++n)
+            face_integrals[subface_index*n_solution_vectors+n] = face_integral[n] * factor;
         }
 
       // finally loop over all subfaces to collect the contributions of the
       // subfaces and store them with the mother face
-      std::vector<double> sum (n_solution_vectors, 0);
-      for (unsigned int subface_no=0; subface_no<face->n_children(); ++subface_no)
+      for (unsigned int n=0; n<n_solution_vectors; ++n)
         {
-          Assert (local_face_integrals.find(face->child(subface_no)) !=
-                  local_face_integrals.end(),
-                  ExcInternalError());
-          Assert (local_face_integrals[face->child(subface_no)][0] >= 0,
-                  ExcInternalError());
-
-          for (unsigned int n=0; n<n_solution_vectors; ++n)
-            sum[n] += local_face_integrals[face->child(subface_no)][n];
+          double sum = 0;
+          for (unsigned int subface_no=0; subface_no<face->n_children(); ++subface_no)
+            {
+              Assert (face_integrals[face->child(subface_no)->index()*n_solution_vectors+n] >= 0,
+                      ExcInternalError());
+              sum += face_integrals[face->child(subface_no)->index()*n_solution_vectors+n];
+            }
+          face_integrals[face->index()*n_solution_vectors+n] = sum;
         }
-
-      local_face_integrals[face] = sum;
     }
 
 
@@ -817,7 +775,7 @@ namespace internal
     void
     estimate_one_cell (const typename DoFHandlerType::active_cell_iterator &cell,
                        ParallelData<DoFHandlerType, typename InputVector::value_type> &parallel_data,
-                       std::map<typename DoFHandlerType::face_iterator,std::vector<double> > &local_face_integrals,
+                       std::vector<double>                     &face_integrals,
                        const std::vector<const InputVector *> &solutions,
                        const typename KellyErrorEstimator<DoFHandlerType::dimension,DoFHandlerType::space_dimension>::Strategy strategy)
     {
@@ -827,9 +785,6 @@ namespace internal
       const types::subdomain_id subdomain_id = parallel_data.subdomain_id;
       const unsigned int material_id  = parallel_data.material_id;
 
-      // empty our own copy of the local face integrals
-      local_face_integrals.clear();
-
       // loop over all faces of this cell
       for (unsigned int face_no=0;
            face_no<GeometryInfo<dim>::faces_per_cell; ++face_no)
@@ -866,8 +821,8 @@ namespace internal
               (parallel_data.neumann_bc->find(face->boundary_id()) ==
                parallel_data.neumann_bc->end()))
             {
-              local_face_integrals[face]
-                = std::vector<double> (n_solution_vectors, 0.);
+              for (unsigned int n=0; n<n_solution_vectors; ++n)
+                face_integrals[face->index()*n_solution_vectors+n] = 0.;
               continue;
             }
 
@@ -937,7 +892,7 @@ namespace internal
             // the integration of these both cases together
             integrate_over_regular_face (solutions,
                                          parallel_data,
-                                         local_face_integrals,
+                                         face_integrals,
                                          cell, face_no,
                                          parallel_data.fe_face_values_cell,
                                          parallel_data.fe_face_values_neighbor,
@@ -948,7 +903,7 @@ namespace internal
             // fit into the framework of the above function
             integrate_over_irregular_face (solutions,
                                            parallel_data,
-                                           local_face_integrals,
+                                           face_integrals,
                                            cell, face_no,
                                            parallel_data.fe_face_values_cell,
                                            parallel_data.fe_subface_values,
@@ -1137,11 +1092,17 @@ estimate (const Mapping<dim, spacedim>               &mapping,
 
   const unsigned int n_solution_vectors = solutions.size();
 
-  // Map of integrals indexed by the corresponding face. In this map we store
-  // the integrated jump of the gradient for each face.  At the end of the
-  // function, we again loop over the cells and collect the contributions of
-  // the different faces of the cell.
-  std::map<typename DoFHandlerType::face_iterator,std::vector<double> > face_integrals;
+  // Array of integrals indexed by the corresponding face, with the
+  // integrated jump of the gradient of solution vector n on face f stored at
+  // position f*n_solution_vectors+n. At the end of the function, we again
+  // loop over the cells and collect the contributions of the different faces
+  // of the cell. Every face is computed by exactly one cell, so the cells
+  // can write their results into this array directly from the worker
+  // threads. Entries of faces that are not computed keep the negative
+  // initial value.
+  std::vector<double> face_integrals (static_cast<std::size_t>(dof_handler.get_triangulation().n_raw_faces()) *
+                                      n_solution_vectors,
+                                      -1.);
 
   // all the data needed in the error estimator by each of the threads is
   // gathered in the following structures
@@ -1157,17 +1118,20 @@ estimate (const Mapping<dim, spacedim>               &mapping,
                  &neumann_bc,
                  component_mask,
                  coefficients);
-  std::map<typename DoFHandlerType::face_iterator,std::vector<double> > sample_local_face_integrals;
 
   // now let's work on all those cells:
   WorkStream::run (dof_handler.begin_active(),
                    static_cast<typename DoFHandlerType::active_cell_iterator>(dof_handler.end()),
                    std::bind (&internal::estimate_one_cell<InputVector,DoFHandlerType>,
-                              std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::ref(solutions),strategy),
-                   std::bind (&internal::copy_local_to_global<DoFHandlerType>,
-                              std::placeholders::_1, std::ref(face_integrals)),
+                              std::placeholders::_1, std::placeholders::_2,
+                              /* no std::placeholders::_3, since the face
+                                 integrals are written right into the
+                                 global array */
+                              std::ref(face_integrals), std::ref(solutions), strategy),
+                   // no copy-local-to-global function needed here
+                   std::function<void (const int &)>(),
                    parallel_data,
-                   sample_local_face_integrals);
+                   /* dummy CopyData object = */ 0);
 
   // finally add up the contributions of the faces for each cell
 
@@ -1197,9 +1161,7 @@ estimate (const Mapping<dim, spacedim>               &mapping,
         for (unsigned int face_no=0; face_no<GeometryInfo<dim>::faces_per_cell;
              ++face_no)
           {
-            Assert(face_integrals.find(cell->face(face_no))
-                   != face_integrals.end(),
-                   ExcInternalError());
+            const unsigned int face_index = cell->face(face_no)->index();
             const double factor = internal::cell_factor<DoFHandlerType>(cell,
                                                                         face_no,
                                                                         dof_handler,
@@ -1209,11 +1171,11 @@ estimate (const Mapping<dim, spacedim>               &mapping,
               {
                 // make sure that we have written a meaningful value into this
                 // slot
-                Assert (face_integrals[cell->face(face_no)][n] >= 0,
+                Assert (face_integrals[face_index*n_solution_vectors+n] >= 0,
                         ExcInternalError());
 
                 (*errors[n])(present_cell)
-                += (face_integrals[cell->face(face_no)][n] * factor);
+                += (face_integrals[face_index*n_solution_vectors+n] * factor);
               }
           }
 
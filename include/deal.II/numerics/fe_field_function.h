@@ -20,6 +20,7 @@
 #include <deal.II/dofs/dof_handler.h>
 #include <deal.II/dofs/dof_accessor.h>
 #include <deal.II/fe/mapping_q1.h>
+#include <deal.II/grid/grid_tools_cache.h>
 #include <deal.II/base/function.h>
 #include <deal.II/base/point.h>
 #include <deal.II/base/tensor.h>
@@ -403,9 +404,11 @@ namespace Functions
      * points, the second is a list of quadrature points matching each cell of
      * the first list, and the third contains the index of the given
      * quadrature points, i.e., @p points[maps[3][4]] ends up as the 5th
-     * quadrature point in the 4th cell. This is where optimization would
-     * help. This function returns the number of cells that contain the given
-     * set of points.
+     * quadrature point in the 4th cell. The points are located by
+     * GridTools::compute_point_locations() with a GridTools::Cache of the
+     * triangulation that is kept by this object, so that the cost is about
+     * proportional to the number of points. This function returns the number
+     * of cells that contain the given set of points.
      */
     unsigned int
     compute_point_locations
@@ -442,6 +445,21 @@ namespace Functions
      */
     mutable cell_hint_t cell_hint;
 
+    /**
+     * The cache of the triangulation with the data structures for locating
+     * points. It is shared between the copies of this object.
+     */
+    std::shared_ptr<const GridTools::Cache<dim,dim> > cache;
+
+    /**
+     * Return the active cell around the point @p p together with the
+     * reference coordinates of the point in this cell, using the cache.
+     * Throw an exception of type VectorTools::ExcPointNotAvailableHere if the
+     * cell is artificial.
+     */
+    std::pair<typename DoFHandlerType::active_cell_iterator, Point<dim> >
+    find_cell_around_point (const Point<dim> &p) const;
+
     /**
      * Given a cell, return the reference coordinates of the given point
      * within this cell if it indeed lies within the cell. Otherwise return an
@@ -19,6 +19,7 @@
 
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/logstream.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/grid/grid_tools.h>
 #include <deal.II/hp/fe_collection.h>
 #include <deal.II/hp/fe_values.h>
@@ -33,6 +34,43 @@ DEAL_II_NAMESPACE_OPEN
 
 namespace Functions
 {
+  namespace internal
+  {
+    /**
+     * Call @p evaluator for each of the @p cells with an FEValues object that
+     * has been initialized with the given @p update_flags on the cell for the
+     * reference points @p qpoints of that cell. The cells are distributed
+     * among the threads, so @p evaluator must only write data of the cell it
+     * is called for.
+     */
+    template <int dim, typename CellIterator, typename Evaluator>
+    void
+    evaluate_on_cells (const Mapping<dim>                           &mapping,
+                       const std::vector<CellIterator>              &cells,
+                       const std::vector<std::vector<Point<dim> > > &qpoints,
+                       const UpdateFlags                             update_flags,
+                       const Evaluator                              &evaluator)
+    {
+      parallel::apply_to_subranges
+      (0U, static_cast<unsigned int>(cells.size()),
+       [&](const unsigned int begin, const unsigned int end)
+      {
+        for (unsigned int i=begin; i<end; ++i)
+          {
+            const unsigned int nq = qpoints[i].size();
+            const Quadrature<dim> quadrature (qpoints[i],
+                                              std::vector<double>(nq, 1./nq));
+            FEValues<dim> fe_values (mapping, cells[i]->get_fe(), quadrature,
+                                     update_flags);
+            fe_values.reinit (cells[i]);
+            evaluator (i, fe_values);
+          }
+      },
+      8);
+    }
+  }
+
+
 
   template <int dim, typename DoFHandlerType, typename VectorType>
   FEFieldFunction<dim, DoFHandlerType, VectorType>::FEFieldFunction
@@ -44,7 +82,9 @@ namespace Functions
     dh(&mydh, "FEFieldFunction"),
     data_vector(myv),
     mapping(mymapping),
-    cell_hint(dh->end())
+    cell_hint(dh->end()),
+    cache(std::make_shared<GridTools::Cache<dim,dim> >(mydh.get_triangulation(),
+                                                        mymapping))
   {
   }
 
@@ -74,10 +114,8 @@ namespace Functions
     qp = get_reference_coordinates (cell, p);
     if (!qp)
       {
-        const std::pair<typename dealii::internal::ActiveCellIterator<dim, dim, DoFHandlerType>::type, Point<dim> > my_pair
-          = GridTools::find_active_cell_around_point (mapping, *dh, p);
-        AssertThrow (!my_pair.first->is_artificial(),
-                     VectorTools::ExcPointNotAvailableHere());
+        const std::pair<typename DoFHandlerType::active_cell_iterator, Point<dim> > my_pair
+          = find_cell_around_point (p);
 
         cell = my_pair.first;
         qp = my_pair.second;
@@ -131,10 +169,8 @@ namespace Functions
     qp = get_reference_coordinates (cell, p);
     if (!qp)
       {
-        const std::pair<typename dealii::internal::ActiveCellIterator<dim, dim, DoFHandlerType>::type, Point<dim> > my_pair
-          = GridTools::find_active_cell_around_point (mapping, *dh, p);
-        AssertThrow (!my_pair.first->is_artificial(),
-                     VectorTools::ExcPointNotAvailableHere());
+        const std::pair<typename DoFHandlerType::active_cell_iterator, Point<dim> > my_pair
+          = find_cell_around_point (p);
 
         cell = my_pair.first;
         qp = my_pair.second;
@@ -203,10 +239,8 @@ namespace Functions
     qp = get_reference_coordinates (cell, p);
     if (!qp)
       {
-        const std::pair<typename dealii::internal::ActiveCellIterator<dim, dim, DoFHandlerType>::type, Point<dim> > my_pair
-          = GridTools::find_active_cell_around_point (mapping, *dh, p);
-        AssertThrow (!my_pair.first->is_artificial(),
-                     VectorTools::ExcPointNotAvailableHere());
+        const std::pair<typename DoFHandlerType::active_cell_iterator, Point<dim> > my_pair
+          = find_cell_around_point (p);
 
         cell = my_pair.first;
         qp = my_pair.second;
@@ -258,33 +292,17 @@ namespace Functions
     std::vector<std::vector<Point<dim> > > qpoints;
     std::vector<std::vector<unsigned int> > maps;
 
-    unsigned int ncells = compute_point_locations(points, cells, qpoints, maps);
-    hp::MappingCollection<dim> mapping_collection (mapping);
-    const hp::FECollection<dim> &fe_collection = dh->get_fe_collection();
-    hp::QCollection<dim> quadrature_collection;
-    // Create quadrature collection
-    for (unsigned int i=0; i<ncells; ++i)
-      {
-        // Number of quadrature points on this cell
-        unsigned int nq = qpoints[i].size();
-        // Construct a quadrature formula
-        std::vector< double > ww(nq, 1./((double) nq));
-
-        quadrature_collection.push_back (Quadrature<dim> (qpoints[i], ww));
-      }
-    // Get a function value object
-    hp::FEValues<dim> fe_v(mapping_collection, fe_collection, quadrature_collection,
-                           update_values);
-    // Now gather all the informations we need
-    for (unsigned int i=0; i<ncells; ++i)
-      {
-        fe_v.reinit(cells[i], i, 0);
-        const unsigned int nq = qpoints[i].size();
-        std::vector< Vector<typename VectorType::value_type> > vvalues (nq, Vector<typename VectorType::value_type>(this->n_components));
-        fe_v.get_present_fe_values ().get_function_values(data_vector, vvalues);
-        for (unsigned int q=0; q<nq; ++q)
-          values[maps[i][q]] = vvalues[q];
-      }
+    compute_point_locations(points, cells, qpoints, maps);
+    internal::evaluate_on_cells
+    (mapping, cells, qpoints, update_values,
+     [&](const unsigned int i, const FEValues<dim> &fe_v)
+    {
+      const unsigned int nq = qpoints[i].size();
+      std::vector< Vector<typename VectorType::value_type> > vvalues (nq, Vector<typename VectorType::value_type>(this->n_components));
+      fe_v.get_function_values(data_vector, vvalues);
+      for (unsigned int q=0; q<nq; ++q)
+        values[maps[i][q]] = vvalues[q];
+    });
   }
 
 
@@ -319,39 +337,23 @@ namespace Functions
     std::vector<std::vector<Point<dim> > > qpoints;
     std::vector<std::vector<unsigned int> > maps;
 
-    unsigned int ncells = compute_point_locations(points, cells, qpoints, maps);
-    hp::MappingCollection<dim> mapping_collection (mapping);
-    const hp::FECollection<dim> &fe_collection = dh->get_fe_collection();
-    hp::QCollection<dim> quadrature_collection;
-    // Create quadrature collection
-    for (unsigned int i=0; i<ncells; ++i)
-      {
-        // Number of quadrature points on this cell
-        unsigned int nq = qpoints[i].size();
-        // Construct a quadrature formula
-        std::vector< double > ww(nq, 1./((double) nq));
-
-        quadrature_collection.push_back (Quadrature<dim> (qpoints[i], ww));
-      }
-    // Get a function value object
-    hp::FEValues<dim> fe_v(mapping_collection, fe_collection, quadrature_collection,
-                           update_gradients);
-    // Now gather all the informations we need
-    for (unsigned int i=0; i<ncells; ++i)
-      {
-        fe_v.reinit(cells[i], i, 0);
-        const unsigned int nq = qpoints[i].size();
-        std::vector< std::vector<Tensor<1,dim,typename VectorType::value_type> > >
-        vgrads (nq, std::vector<Tensor<1,dim,typename VectorType::value_type> >(this->n_components));
-        fe_v.get_present_fe_values ().get_function_gradients(data_vector, vgrads);
-        for (unsigned int q=0; q<nq; ++q)
-          {
-            const unsigned int s = vgrads[q].size();
-            values[maps[i][q]].resize(s);
-            for (unsigned int l=0; l<s; l++)
-              values[maps[i][q]][l] = vgrads[q][l];
-          }
-      }
+    compute_point_locations(points, cells, qpoints, maps);
+    internal::evaluate_on_cells
+    (mapping, cells, qpoints, update_gradients,
+     [&](const unsigned int i, const FEValues<dim> &fe_v)
+    {
+      const unsigned int nq = qpoints[i].size();
+      std::vector< std::vector<Tensor<1,dim,typename VectorType::value_type> > >
+      vgrads (nq, std::vector<Tensor<1,dim,typename VectorType::value_type> >(this->n_components));
+      fe_v.get_function_gradients(data_vector, vgrads);
+      for (unsigned int q=0; q<nq; ++q)
+        {
+          const unsigned int s = vgrads[q].size();
+          values[maps[i][q]].resize(s);
+          for (unsigned int l=0; l<s; l++)
+            values[maps[i][q]][l] = vgrads[q][l];
+        }
+    });
   }
 
   template <int dim, typename DoFHandlerType, typename VectorType>
@@ -384,33 +386,17 @@ namespace Functions
     std::vector<std::vector<Point<dim> > > qpoints;
     std::vector<std::vector<unsigned int> > maps;
 
-    unsigned int ncells = compute_point_locations(points, cells, qpoints, maps);
-    hp::MappingCollection<dim> mapping_collection (mapping);
-    const hp::FECollection<dim> &fe_collection = dh->get_fe_collection();
-    hp::QCollection<dim> quadrature_collection;
-    // Create quadrature collection
-    for (unsigned int i=0; i<ncells; ++i)
-      {
-        // Number of quadrature points on this cell
-        unsigned int nq = qpoints[i].size();
-        // Construct a quadrature formula
-        std::vector< double > ww(nq, 1./((double) nq));
-
-        quadrature_collection.push_back (Quadrature<dim> (qpoints[i], ww));
-      }
-    // Get a function value object
-    hp::FEValues<dim> fe_v(mapping_collection, fe_collection, quadrature_collection,
-                           update_hessians);
-    // Now gather all the informations we need
-    for (unsigned int i=0; i<ncells; ++i)
-      {
-        fe_v.reinit(cells[i], i, 0);
-        const unsigned int nq = qpoints[i].size();
-        std::vector< Vector<typename VectorType::value_type> > vvalues (nq, Vector<typename VectorType::value_type>(this->n_components));
-        fe_v.get_present_fe_values ().get_function_laplacians(data_vector, vvalues);
-        for (unsigned int q=0; q<nq; ++q)
-          values[maps[i][q]] = vvalues[q];
-      }
+    compute_point_locations(points, cells, qpoints, maps);
+    internal::evaluate_on_cells
+    (mapping, cells, qpoints, update_hessians,
+     [&](const unsigned int i, const FEValues<dim> &fe_v)
+    {
+      const unsigned int nq = qpoints[i].size();
+      std::vector< Vector<typename VectorType::value_type> > vvalues (nq, Vector<typename VectorType::value_type>(this->n_components));
+      fe_v.get_function_laplacians(data_vector, vvalues);
+      for (unsigned int q=0; q<nq; ++q)
+        values[maps[i][q]] = vvalues[q];
+    });
   }
 
   template <int dim, typename DoFHandlerType, typename VectorType>
@@ -438,144 +424,35 @@ namespace Functions
    std::vector<std::vector<Point<dim> > >                      &qpoints,
    std::vector<std::vector<unsigned int> >                     &maps) const
   {
-    // How many points are here?
-    const unsigned int np = points.size();
-
     // Reset output maps.
     cells.clear();
     qpoints.clear();
     maps.clear();
 
     // Now the easy case.
-    if (np==0) return 0;
-
-    // Keep track of the points we
-    // found
-    std::vector<bool> point_flags(np, false);
-
-    // Set this to true until all
-    // points have been classified
-    bool left_over = true;
-
-    // Current quadrature point
-    typename DoFHandlerType::active_cell_iterator cell = cell_hint.get();
-    if (cell == dh->end())
-      cell = dh->begin_active();
-
-    {
-      // see if the point is
-      // inside the
-      // cell. there are two
-      // ways that
-      // transform_real_to_unit_cell
-      // can indicate that a
-      // point is outside: by
-      // returning
-      // coordinates that lie
-      // outside the
-      // reference cell, or
-      // by throwing an
-      // exception. handle
-      // both
-      boost::optional<Point<dim> >
-      qp = get_reference_coordinates (cell, points[0]);
-      if (!qp)
-        {
-          const std::pair<typename dealii::internal::ActiveCellIterator<dim, dim, DoFHandlerType>::type, Point<dim> >
-          my_pair  = GridTools::find_active_cell_around_point
-                     (mapping, *dh, points[0]);
-          AssertThrow (!my_pair.first->is_artificial(),
-                       VectorTools::ExcPointNotAvailableHere());
-
-          cell = my_pair.first;
-          qp = my_pair.second;
-          point_flags[0] = true;
-        }
-
-      // check that the cell is available:
-      AssertThrow (!cell->is_artificial(),
-                   VectorTools::ExcPointNotAvailableHere());
-
-      // Put in the first point.
-      cells.push_back(cell);
-      qpoints.emplace_back(1, qp.get());
-      maps.emplace_back(1, 0);
-    }
-
-
-    // Check if we need to do anything else
-    if (points.size() > 1)
-      left_over = true;
-    else
-      left_over = false;
-
-
-    // This is the first index of a non processed point
-    unsigned int first_outside = 1;
-
-    // And this is the index of the current cell
-    unsigned int c = 0;
-
-    while (left_over == true)
+    if (points.size()==0) return 0;
+
+    // the cache only tests the cells whose bounding boxes contain a point,
+    // rather than all cells found so far for all points left over
+    std::tuple<
+    std::vector<typename Triangulation<dim>::active_cell_iterator>,
+        std::vector<std::vector<Point<dim> > >,
+        std::vector<std::vector<unsigned int> > >
+        cell_qpoint_map = GridTools::compute_point_locations (*cache, points);
+
+    const std::vector<typename Triangulation<dim>::active_cell_iterator>
+    &tria_cells = std::get<0>(cell_qpoint_map);
+    cells.reserve (tria_cells.size());
+    for (unsigned int c=0; c<tria_cells.size(); ++c)
       {
-        // Assume this is the last one
-        left_over = false;
-        Assert(first_outside < np,
-               ExcIndexRange(first_outside, 0, np));
-
-        // If we found one in this cell, keep looking in the same cell
-        for (unsigned int p=first_outside; p<np; ++p)
-          if (point_flags[p] == false)
-            {
-              // same logic as above
-              const boost::optional<Point<dim> >
-              qp = get_reference_coordinates (cells[c], points[p]);
-              if (qp)
-                {
-                  point_flags[p] = true;
-                  qpoints[c].push_back(qp.get());
-                  maps[c].push_back(p);
-                }
-              else
-                {
-                  // Set things up for next round
-                  if (left_over == false)
-                    first_outside = p;
-                  left_over = true;
-                }
-            }
-        // If we got here and there is
-        // no left over, we are
-        // done. Else we need to find
-        // the next cell
-        if (left_over == true)
-          {
-            const std::pair<typename dealii::internal::ActiveCellIterator<dim, dim, DoFHandlerType>::type, Point<dim> > my_pair
-              = GridTools::find_active_cell_around_point (mapping, *dh, points[first_outside]);
-            AssertThrow (!my_pair.first->is_artificial(),
-                         VectorTools::ExcPointNotAvailableHere());
-
-            cells.push_back(my_pair.first);
-            qpoints.emplace_back(1, my_pair.second);
-            maps.emplace_back(1, first_outside);
-            c++;
-            point_flags[first_outside] = true;
-            // And check if we can exit the loop now
-            if (first_outside == np-1)
-              left_over = false;
-          }
+        // check that the cell is available:
+        AssertThrow (!tria_cells[c]->is_artificial(),
+                     VectorTools::ExcPointNotAvailableHere());
+        cells.emplace_back (&dh->get_triangulation(), tria_cells[c]->level(),
+                            tria_cells[c]->index(), &*dh);
       }
-
-    // Augment of one the number of cells
-    ++c;
-    // Debug Checking
-    Assert(c == cells.size(), ExcInternalError());
-
-    Assert(c == maps.size(),
-           ExcDimensionMismatch(c, maps.size()));
-
-    Assert(c == qpoints.size(),
-           ExcDimensionMismatch(c, qpoints.size()));
+    qpoints = std::move (std::get<1>(cell_qpoint_map));
+    maps = std::move (std::get<2>(cell_qpoint_map));
 
 #ifdef DEBUG
     unsigned int qps = 0;
@@ -583,17 +460,35 @@ namespace Functions
     // the cells must be the same as
     // the number of points we
     // started off from.
-    for (unsigned int n=0; n<c; ++n)
+    for (unsigned int n=0; n<cells.size(); ++n)
       {
         Assert(qpoints[n].size() == maps[n].size(),
                ExcDimensionMismatch(qpoints[n].size(), maps[n].size()));
         qps += qpoints[n].size();
       }
-    Assert(qps == np,
-           ExcDimensionMismatch(qps, np));
+    Assert(qps == points.size(),
+           ExcDimensionMismatch(qps, points.size()));
 #endif
 
-    return c;
+    return cells.size();
+  }
+
+
+
+  template <int dim, typename DoFHandlerType, typename VectorType>
+  std::pair<typename DoFHandlerType::active_cell_iterator, Point<dim> >
+  FEFieldFunction<dim, DoFHandlerType, VectorType>::
+  find_cell_around_point (const Point<dim> &p) const
+  {
+    const std::pair<typename Triangulation<dim>::active_cell_iterator, Point<dim> >
+    my_pair = GridTools::find_active_cell_around_point (*cache, p);
+    AssertThrow (!my_pair.first->is_artificial(),
+                 VectorTools::ExcPointNotAvailableHere());
+
+    return std::make_pair (typename DoFHandlerType::active_cell_iterator
+                           (&dh->get_triangulation(), my_pair.first->level(),
+                            my_pair.first->index(), &*dh),
+                           my_pair.second);
   }
 
 
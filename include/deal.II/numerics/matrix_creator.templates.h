@@ -18,6 +18,7 @@
 
 #include <deal.II/base/function.h>
 #include <deal.II/base/quadrature.h>
+#include <deal.II/base/multithread_info.h>
 #include <deal.II/base/work_stream.h>
 #include <deal.II/base/geometry_info.h>
 #include <deal.II/base/quadrature.h>
@@ -616,6 +617,54 @@ namespace MatrixCreator
 
 
 
+    /**
+     * Run the assembly of the cells in the range from @p begin to @p end into
+     * a SparseMatrix and, if @p right_hand_side is not a null pointer, into
+     * a Vector. With more than one thread, the copiers run concurrently on
+     * the threads of the workers with atomic additions into the matrix and
+     * the vector, rather than one after the other in a separate stage of the
+     * pipeline that becomes the bottleneck for cheap local matrices like the
+     * ones of the mass and Laplace matrices.
+     */
+    template <typename Iterator,
+              typename Worker,
+              typename ScratchData,
+              typename number>
+    void run_assembly (const Iterator                         &begin,
+                       const Iterator                         &end,
+                       Worker                                  worker,
+                       const ScratchData                      &scratch_data,
+                       const AssemblerData::CopyData<number>  &copy_data,
+                       SparseMatrix<number>                   &matrix,
+                       dealii::Vector<number>                 *right_hand_side)
+    {
+      const auto copier
+        = std::bind (&copy_local_to_global<number,SparseMatrix<number>,dealii::Vector<number> >,
+                     std::placeholders::_1, &matrix, right_hand_side);
+
+      if (MultithreadInfo::n_threads() == 1)
+        {
+          WorkStream::run (begin, end, worker, copier, scratch_data, copy_data);
+          return;
+        }
+
+      const bool matrix_was_atomic = matrix.get_atomic_add_mode();
+      const bool rhs_was_atomic = (right_hand_side != nullptr &&
+                                   right_hand_side->get_atomic_add_mode());
+      matrix.set_atomic_add_mode (true);
+      if (right_hand_side != nullptr)
+        right_hand_side->set_atomic_add_mode (true);
+
+      WorkStream::run_with_concurrent_copiers (begin, end, worker, copier,
+                                               scratch_data, copy_data);
+
+      matrix.set_atomic_add_mode (matrix_was_atomic);
+      if (right_hand_side != nullptr)
+        right_hand_side->set_atomic_add_mode (rhs_was_atomic);
+    }
+
+
+
     namespace AssemblerBoundary
     {
       struct Scratch
@@ -694,14 +743,11 @@ namespace MatrixCreator
     copy_data.dof_indices.resize (assembler_data.fe_collection.max_dofs_per_cell());
     copy_data.constraints = &constraints;
 
-    WorkStream::run (dof.begin_active(),
-                     static_cast<typename DoFHandler<dim,spacedim>::active_cell_iterator>(dof.end()),
-                     &MatrixCreator::internal::mass_assembler<dim, spacedim, typename DoFHandler<dim,spacedim>::active_cell_iterator,number>,
-                     std::bind (&MatrixCreator::internal::
-                                copy_local_to_global<number,SparseMatrix<number>, Vector<number> >,
-                                std::placeholders::_1, &matrix, (Vector<number> *)nullptr),
-                     assembler_data,
-                     copy_data);
+    MatrixCreator::internal::run_assembly
+    (dof.begin_active(),
+     static_cast<typename DoFHandler<dim,spacedim>::active_cell_iterator>(dof.end()),
+     &MatrixCreator::internal::mass_assembler<dim, spacedim, typename DoFHandler<dim,spacedim>::active_cell_iterator,number>,
+     assembler_data, copy_data, matrix, (Vector<number> *)nullptr);
   }
 
 
@@ -750,14 +796,11 @@ namespace MatrixCreator
     copy_data.dof_indices.resize (assembler_data.fe_collection.max_dofs_per_cell());
     copy_data.constraints = &constraints;
 
-    WorkStream::run (dof.begin_active(),
-                     static_cast<typename DoFHandler<dim,spacedim>::active_cell_iterator>(dof.end()),
-                     &MatrixCreator::internal::mass_assembler<dim, spacedim, typename DoFHandler<dim,spacedim>::active_cell_iterator,number>,
-                     std::bind(&MatrixCreator::internal::
-                               copy_local_to_global<number,SparseMatrix<number>, Vector<number> >,
-                               std::placeholders::_1, &matrix, &rhs_vector),
-                     assembler_data,
-                     copy_data);
+    MatrixCreator::internal::run_assembly
+    (dof.begin_active(),
+     static_cast<typename DoFHandler<dim,spacedim>::active_cell_iterator>(dof.end()),
+     &MatrixCreator::internal::mass_assembler<dim, spacedim, typename DoFHandler<dim,spacedim>::active_cell_iterator,number>,
+     assembler_data, copy_data, matrix, &rhs_vector);
   }
 
 
@@ -804,14 +847,11 @@ namespace MatrixCreator
     copy_data.dof_indices.resize (assembler_data.fe_collection.max_dofs_per_cell());
     copy_data.constraints = &constraints;
 
-    WorkStream::run (dof.begin_active(),
-                     static_cast<typename hp::DoFHandler<dim,spacedim>::active_cell_iterator>(dof.end()),
-                     &MatrixCreator::internal::mass_assembler<dim, spacedim, typename hp::DoFHandler<dim,spacedim>::active_cell_iterator,number>,
-                     std::bind (&MatrixCreator::internal::
-                                copy_local_to_global<number,SparseMatrix<number>, Vector<number> >,
-                                std::placeholders::_1, &matrix, (Vector<number> *)nullptr),
-                     assembler_data,
-                     copy_data);
+    MatrixCreator::internal::run_assembly
+    (dof.begin_active(),
+     static_cast<typename hp::DoFHandler<dim,spacedim>::active_cell_iterator>(dof.end()),
+     &MatrixCreator::internal::mass_assembler<dim, spacedim, typename hp::DoFHandler<dim,spacedim>::active_cell_iterator,number>,
+     assembler_data, copy_data, matrix, (Vector<number> *)nullptr);
   }
 
 
@@ -857,14 +897,11 @@ namespace MatrixCreator
     copy_data.dof_indices.resize (assembler_data.fe_collection.max_dofs_per_cell());
     copy_data.constraints = &constraints;
 
-    WorkStream::run (dof.begin_active(),
-                     static_cast<typename hp::DoFHandler<dim,spacedim>::active_cell_iterator>(dof.end()),
-                     &MatrixCreator::internal::mass_assembler<dim, spacedim, typename hp::DoFHandler<dim,spacedim>::active_cell_iterator,number>,
-                     std::bind (&MatrixCreator::internal::
-                                copy_local_to_global<number,SparseMatrix<number>, Vector<number> >,
-                                std::placeholders::_1, &matrix, &rhs_vector),
-                     assembler_data,
-                     copy_data);
+    MatrixCreator::internal::run_assembly
+    (dof.begin_active(),
+     static_cast<typename hp::DoFHandler<dim,spacedim>::active_cell_iterator>(dof.end()),
+     &MatrixCreator::internal::mass_assembler<dim, spacedim, typename hp::DoFHandler<dim,spacedim>::active_cell_iterator,number>,
+     assembler_data, copy_data, matrix, &rhs_vector);
   }
 
 
@@ -1720,16 +1757,11 @@ namespace MatrixCreator
     copy_data.dof_indices.resize (assembler_data.fe_collection.max_dofs_per_cell());
     copy_data.constraints = &constraints;
 
-    WorkStream::run (dof.begin_active(),
-                     static_cast<typename DoFHandler<dim,spacedim>::active_cell_iterator>(dof.end()),
-                     &MatrixCreator::internal::laplace_assembler<dim, spacedim, typename DoFHandler<dim,spacedim>::active_cell_iterator>,
-                     std::bind (&MatrixCreator::internal::
-                                copy_local_to_global<double,SparseMatrix<double>, Vector<double> >,
-                                std::placeholders::_1,
-                                &matrix,
-                                (Vector<double> *)(nullptr)),
-                     assembler_data,
-                     copy_data);
+    MatrixCreator::internal::run_assembly
+    (dof.begin_active(),
+     static_cast<typename DoFHandler<dim,spacedim>::active_cell_iterator>(dof.end()),
+     &MatrixCreator::internal::laplace_assembler<dim, spacedim, typename DoFHandler<dim,spacedim>::active_cell_iterator>,
+     assembler_data, copy_data, matrix, (Vector<double> *)(nullptr));
   }
 
 
@@ -1778,16 +1810,11 @@ namespace MatrixCreator
     copy_data.dof_indices.resize (assembler_data.fe_collection.max_dofs_per_cell());
     copy_data.constraints = &constraints;
 
-    WorkStream::run (dof.begin_active(),
-                     static_cast<typename DoFHandler<dim,spacedim>::active_cell_iterator>(dof.end()),
-                     &MatrixCreator::internal::laplace_assembler<dim, spacedim, typename DoFHandler<dim,spacedim>::active_cell_iterator>,
-                     std::bind (&MatrixCreator::internal::
-                                copy_local_to_global<double,SparseMatrix<double>, Vector<double> >,
-                                std::placeholders::_1,
-                                &matrix,
-                                &rhs_vector),
-                     assembler_data,
-                     copy_data);
+    MatrixCreator::internal::run_assembly
+    (dof.begin_active(),
+     static_cast<typename DoFHandler<dim,spacedim>::active_cell_iterator>(dof.end()),
+     &MatrixCreator::internal::laplace_assembler<dim, spacedim, typename DoFHandler<dim,spacedim>::active_cell_iterator>,
+     assembler_data, copy_data, matrix, &rhs_vector);
   }
 
 
@@ -1833,16 +1860,11 @@ namespace MatrixCreator
     copy_data.dof_indices.resize (assembler_data.fe_collection.max_dofs_per_cell());
     copy_data.constraints = &constraints;
 
-    WorkStream::run (dof.begin_active(),
-                     static_cast<typename hp::DoFHandler<dim,spacedim>::active_cell_iterator>(dof.end()),
-                     &MatrixCreator::internal::laplace_assembler<dim, spacedim, typename hp::DoFHandler<dim,spacedim>::active_cell_iterator>,
-                     std::bind (&MatrixCreator::internal::
-                                copy_local_to_global<double,SparseMatrix<double>, Vector<double> >,
-                                std::placeholders::_1,
-                                &matrix,
-                                (Vector<double> *)nullptr),
-                     assembler_data,
-                     copy_data);
+    MatrixCreator::internal::run_assembly
+    (dof.begin_active(),
+     static_cast<typename hp::DoFHandler<dim,spacedim>::active_cell_iterator>(dof.end()),
+     &MatrixCreator::internal::laplace_assembler<dim, spacedim, typename hp::DoFHandler<dim,spacedim>::active_cell_iterator>,
+     assembler_data, copy_data, matrix, (Vector<double> *)nullptr);
   }
 
 
@@ -1888,16 +1910,11 @@ namespace MatrixCreator
     copy_data.dof_indices.resize (assembler_data.fe_collection.max_dofs_per_cell());
     copy_data.constraints = &constraints;
 
-    WorkStream::run (dof.begin_active(),
-                     static_cast<typename hp::DoFHandler<dim,spacedim>::active_cell_iterator>(dof.end()),
-                     &MatrixCreator::internal::laplace_assembler<dim, spacedim, typename hp::DoFHandler<dim,spacedim>::active_cell_iterator>,
-                     std::bind (&MatrixCreator::internal::
-                                copy_local_to_global<double,SparseMatrix<double>, Vector<double> >,
-                                std::placeholders::_1,
-                                &matrix,
-                                &rhs_vector),
-                     assembler_data,
-                     copy_data);
+    MatrixCreator::internal::run_assembly
+    (dof.begin_active(),
+     static_cast<typename hp::DoFHandler<dim,spacedim>::active_cell_iterator>(dof.end()),
+     &MatrixCreator::internal::laplace_assembler<dim, spacedim, typename hp::DoFHandler<dim,spacedim>::active_cell_iterator>,
+     assembler_data, copy_data, matrix, &rhs_vector);
   }
 
 
@@ -0,0 +1,198 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_non_matching_interpolation_h
+#define dealii_non_matching_interpolation_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/mapping.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/**
+ * A class that interpolates finite element functions between two DoFHandler
+ * objects on meshes that need not be related in any way, e.g., the meshes
+ * of a fluid and a structure that touch or overlap each other. Unlike
+ * VectorTools::interpolate_to_different_mesh(), the meshes need not be
+ * derived from the same coarse mesh, and unlike Functions::FEFieldFunction,
+ * the points of the target mesh are located in the source mesh only once.
+ *
+ * reinit() computes the support points of the locally owned degrees of
+ * freedom of the target, locates them in the source mesh with
+ * GridTools::distributed_compute_point_locations(), and stores the values of
+ * the shape functions of the source element at these points. Each call of
+ * interpolate() then only computes the sums of the source values times the
+ * stored shape values on the processes that own the source cells, and sends
+ * the results directly to the processes that own the target degrees of
+ * freedom along the communication pattern set up by reinit(). Thus, the
+ * interpolation costs about as much as a product with a sparse matrix.
+ *
+ * The target element must have support points, and the source element must
+ * be primitive and have the same number of vector components. The
+ * triangulations may be distributed, in which case they must share the same
+ * communicator. Degrees of freedom of the target whose support points are
+ * not inside the source mesh are not touched by interpolate(); their number
+ * is returned by n_unlocated_dofs().
+ *
+ * A typical use for two meshes that do not change looks as follows:
+ * @code
+ *   NonMatchingInterpolation<dim> fluid_to_solid;
+ *   fluid_to_solid.reinit (fluid_mapping, fluid_dof_handler,
+ *                          solid_mapping, solid_dof_handler);
+ *   for (unsigned int step=0; step<n_steps; ++step)
+ *     {
+ *       ...
+ *       fluid_to_solid.interpolate (fluid_velocity, solid_velocity);
+ *     }
+ * @endcode
+ *
+ * @ingroup numerics
+ */
+template <int dim, int spacedim=dim>
+class NonMatchingInterpolation : public Subscriptor
+{
+public:
+  /**
+   * Constructor. Sets up an empty object, which must be initialized with
+   * reinit() before use.
+   */
+  NonMatchingInterpolation ();
+
+  /**
+   * Locate the support points of the locally owned degrees of freedom of
+   * @p target_dof_handler, as given by @p target_mapping, in the mesh of
+   * @p source_dof_handler with the mapping @p source_mapping, and store the
+   * data needed by interpolate(). This function must be called again after
+   * one of the meshes has changed.
+   *
+   * If the triangulations are distributed, this is a collective operation on
+   * their communicator.
+   */
+  void reinit (const Mapping<dim,spacedim>    &source_mapping,
+               const DoFHandler<dim,spacedim> &source_dof_handler,
+               const Mapping<dim,spacedim>    &target_mapping,
+               const DoFHandler<dim,spacedim> &target_dof_handler);
+
+  /**
+   * Interpolate the finite element function @p source given on the source
+   * DoFHandler into the locally owned entries of the vector @p target
+   * for the target DoFHandler. For distributed vectors, @p source must
+   * contain the ghost values of the degrees of freedom on the locally owned
+   * cells, i.e., at least the locally active degrees of freedom.
+   *
+   * If the triangulations are distributed, this is a collective operation on
+   * their communicator.
+   */
+  template <typename VectorType>
+  void interpolate (const VectorType &source,
+                    VectorType       &target) const;
+
+  /**
+   * Return the number of locally owned degrees of freedom of the target
+   * whose support points have not been found in the source mesh in the last
+   * call of reinit().
+   */
+  types::global_dof_index n_unlocated_dofs () const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * The communicator of the source triangulation, or MPI_COMM_SELF for a
+   * serial triangulation.
+   */
+  MPI_Comm mpi_communicator;
+
+  /**
+   * The number of vector components of the elements. Each support point of
+   * the target is represented by one row for each component.
+   */
+  unsigned int n_components;
+
+  /**
+   * The ranks of the processes that receive interpolated values from the
+   * current process, and the range of rows computed for each of them in
+   * <tt>send_row_starts[i]</tt> to <tt>send_row_starts[i+1]</tt>.
+   */
+  std::vector<unsigned int> send_ranks;
+  std::vector<unsigned int> send_row_starts;
+
+  /**
+   * The interpolation weights of the located points in compressed row
+   * storage: the value of row <tt>r</tt> is the sum of the source values of
+   * the entries <tt>source_dof_indices[k]</tt> times <tt>weights[k]</tt> for
+   * <tt>k</tt> from <tt>row_starts[r]</tt> to <tt>row_starts[r+1]</tt>.
+   */
+  std::vector<unsigned int>            row_starts;
+  std::vector<types::global_dof_index> source_dof_indices;
+  std::vector<double>                  weights;
+
+  /**
+   * The ranks of the processes that compute interpolated values for the
+   * current process, and the range of rows received from each of them in
+   * <tt>receive_row_starts[i]</tt> to <tt>receive_row_starts[i+1]</tt>.
+   */
+  std::vector<unsigned int> receive_ranks;
+  std::vector<unsigned int> receive_row_starts;
+
+  /**
+   * The target degree of freedom of each received row, or
+   * numbers::invalid_dof_index if the target element has no degree of
+   * freedom of that component at the support point.
+   */
+  std::vector<types::global_dof_index> target_dof_indices;
+
+  /**
+   * The number of target degrees of freedom that have not been located.
+   */
+  types::global_dof_index n_unlocated;
+
+  /**
+   * Buffers for the values sent and received in interpolate().
+   */
+  mutable std::vector<double> send_buffer;
+  mutable std::vector<double> receive_buffer;
+};
+
+
+
+/*----------------------------- Inline functions ----------------------------*/
+
+#ifndef DOXYGEN
+
+template <int dim, int spacedim>
+inline
+types::global_dof_index
+NonMatchingInterpolation<dim,spacedim>::n_unlocated_dofs () const
+{
+  return n_unlocated;
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -23,6 +23,7 @@
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/lac/vector.h>
+#include <deal.II/lac/full_matrix.h>
 #include <deal.II/grid/grid_tools.h>
 #include <deal.II/dofs/dof_accessor.h>
 #include <deal.II/dofs/dof_handler.h>
@@ -59,6 +60,17 @@ namespace internal
       Point <dim> requested_location;
       std::vector <Point <dim> > support_point_locations;
       std::vector <types::global_dof_index> solution_indices;
+
+      /**
+       * The cell that surrounds @p requested_location and the values of all
+       * shape function components of the finite element @p
+       * requested_location_fe at this point. These are computed the first
+       * time PointValueHistory::evaluate_field_at_requested_location() is
+       * called, so that later calls do not need to search the mesh again.
+       */
+      typename DoFHandler<dim>::active_cell_iterator requested_location_cell;
+      FullMatrix<double> requested_location_shape_values;
+      const FiniteElement<dim> *requested_location_fe;
     };
   }
 }
@@ -359,9 +371,12 @@ public:
    * Extract values at the points actually requested from the VectorType
    * supplied and add them to the new dataset in vector_name. Unlike the other
    * evaluate_field methods this method does not care if the dof_handler has
-   * been modified because it uses calls to @p VectorTools::point_value to
-   * extract there data. Therefore, if only this method is used, the class is
-   * fully compatible with adaptive refinement. The component_mask supplied
+   * been modified because it evaluates the finite element field at the
+   * requested points in the same way as @p VectorTools::point_value.
+   * Therefore, if only this method is used, the class is fully compatible
+   * with adaptive refinement. As long as the triangulation does not change,
+   * the cells surrounding the points and the values of the shape functions
+   * at the points are computed only once and reused in later calls. The component_mask supplied
    * when the field was added is used to select components to extract. If a @p
    * DoFHandler is used, one (and only one) evaluate_field method must be
    * called for each dataset (time step, iteration, etc) for each vector_name,
@@ -778,7 +778,12 @@ namespace VectorTools
    * quadrature formula for integration of the provided function while a
    * QGauss(fe_degree+2) object is used for the mass operator. You should
    * therefore make sure that the given quadrature formula is sufficient for
-   * creating the right-hand side.
+   * creating the right-hand side. For discontinuous tensor product elements
+   * like FE_DGQ of degree up to three and without constraints, the mass
+   * matrix is block diagonal, and its inverse is applied exactly on each cell
+   * by MatrixFreeOperators::CellwiseInverseMassMatrix with a QGauss(fe_degree+1)
+   * mass operator instead of solving a global linear system. On affine cells,
+   * this gives the same result as the global solve.
    *
    * Otherwise, only serial Triangulations are supported and the mass matrix
    * is assembled exactly using MatrixTools::create_mass_matrix and the same
@@ -22,6 +22,7 @@
 #include <deal.II/base/polynomials_piecewise.h>
 #include <deal.II/base/qprojector.h>
 #include <deal.II/base/quadrature.h>
+#include <deal.II/base/work_stream.h>
 #include <deal.II/distributed/tria_base.h>
 #include <deal.II/lac/vector.h>
 #include <deal.II/lac/block_vector.h>
@@ -1288,6 +1289,21 @@ namespace VectorTools
       Assert (dof.get_fe(0).n_components() == components,
               ExcDimensionMismatch(components, dof.get_fe(0).n_components()));
 
+      // for discontinuous tensor product elements without constraints, the
+      // mass matrix is block diagonal, and we can apply the exact inverse on
+      // each cell with CellwiseInverseMassMatrix instead of solving a global
+      // system. this needs the Gauss quadrature with fe_degree+1 points, so
+      // decide before setting up the MatrixFree object. the condition on the
+      // number of dofs excludes FE_DGP whose basis is not a tensor product
+      const FiniteElement<dim,spacedim> &fe = dof.get_fe();
+      const bool use_cellwise_inverse
+        = (fe_degree != -1 &&
+           constraints.n_constraints() == 0 &&
+           fe.dofs_per_cell == (dim == 1 ? fe.dofs_per_line :
+                                dim == 2 ? fe.dofs_per_quad :
+                                fe.dofs_per_hex) &&
+           fe.dofs_per_cell == components * Utilities::fixed_power<dim>(fe.degree+1));
+
       // set up mass matrix and right hand side
       typename MatrixFree<dim,Number>::AdditionalData additional_data;
       additional_data.tasks_parallel_scheme =
@@ -1296,7 +1312,33 @@ namespace VectorTools
       std::shared_ptr<MatrixFree<dim, Number> > matrix_free(
         new MatrixFree<dim, Number> ());
       matrix_free->reinit (mapping, dof, constraints,
-                           QGauss<1>(dof.get_fe().degree+2), additional_data);
+                           QGauss<1>(fe.degree + (use_cellwise_inverse ? 1 : 2)),
+                           additional_data);
+
+      if (use_cellwise_inverse)
+        {
+          LinearAlgebra::distributed::Vector<Number> rhs;
+          matrix_free->initialize_dof_vector(work_result);
+          matrix_free->initialize_dof_vector(rhs);
+          create_right_hand_side (mapping, dof, quadrature, function, rhs, constraints);
+          rhs.update_ghost_values();
+
+          FEEvaluation<dim,fe_degree,fe_degree+1,components,Number> phi(*matrix_free);
+          MatrixFreeOperators::CellwiseInverseMassMatrix<dim,fe_degree,components,Number>
+          inverse_mass(phi);
+          AlignedVector<VectorizedArray<Number> > inverse_JxW(phi.n_q_points);
+          for (unsigned int cell=0; cell<matrix_free->n_macro_cells(); ++cell)
+            {
+              phi.reinit(cell);
+              phi.read_dof_values(rhs);
+              inverse_mass.fill_inverse_JxW_values(inverse_JxW);
+              inverse_mass.apply(inverse_JxW, components, phi.begin_dof_values(),
+                                 phi.begin_dof_values());
+              phi.set_dof_values(work_result);
+            }
+          return;
+        }
+
       typedef MatrixFreeOperators::MassOperator<dim, fe_degree, fe_degree+2, components, LinearAlgebra::distributed::Vector<Number> > MatrixType;
       MatrixType mass_matrix;
       mass_matrix.initialize(matrix_free);
@@ -7484,33 +7526,45 @@ namespace VectorTools
       const dealii::hp::FECollection<dim,spacedim> &fe_collection = dof.get_fe_collection();
       IDScratchData<dim,spacedim, Number> data(mapping, fe_collection, q, update_flags);
 
-      // loop over all cells
-      for (typename DoFHandlerType::active_cell_iterator cell = dof.begin_active();
-           cell != dof.end(); ++cell)
+      // loop over all cells in parallel. each cell writes its own entry of
+      // the output vector, so no copier stage is needed
+      auto worker = [&](const typename DoFHandlerType::active_cell_iterator &cell,
+                        IDScratchData<dim,spacedim,Number>                  &scratch,
+                        int &)
+      {
         if (cell->is_locally_owned())
           {
             // initialize for this cell
-            data.x_fe_values.reinit (cell);
+            scratch.x_fe_values.reinit (cell);
 
             const dealii::FEValues<dim, spacedim> &fe_values
-              = data.x_fe_values.get_present_fe_values ();
+              = scratch.x_fe_values.get_present_fe_values ();
             const unsigned int   n_q_points = fe_values.n_quadrature_points;
-            data.resize_vectors (n_q_points, n_components);
+            scratch.resize_vectors (n_q_points, n_components);
 
             if (update_flags & update_values)
-              fe_values.get_function_values (fe_function, data.function_values);
+              fe_values.get_function_values (fe_function, scratch.function_values);
             if (update_flags & update_gradients)
-              fe_values.get_function_gradients (fe_function, data.function_grads);
+              fe_values.get_function_gradients (fe_function, scratch.function_grads);
 
             difference(cell->active_cell_index()) =
               integrate_difference_inner<dim,spacedim, Number> (exact_solution, norm, weight,
                                                                 update_flags, exponent,
-                                                                n_components, data);
+                                                                n_components, scratch);
           }
         else
           // the cell is a ghost cell or is artificial. write a zero into the
           // corresponding value of the returned vector
           difference(cell->active_cell_index()) = 0;
+      };
+
+      WorkStream::run (dof.begin_active(),
+                       static_cast<typename DoFHandlerType::active_cell_iterator>(dof.end()),
+                       worker,
+                       // no copy-local-to-global function needed here
+                       std::function<void (const int &)>(),
+                       data,
+                       /* dummy CopyData object = */ 0);
     }
 
   } // namespace internal
@@ -17,6 +17,7 @@
 #define dealii_particles_particle_accessor_h
 
 #include <deal.II/particles/particle.h>
+#include <deal.II/particles/particle_container.h>
 #include <deal.II/base/array_view.h>
 #include <deal.II/grid/tria.h>
 
@@ -91,6 +92,10 @@ namespace Particles
      * since the particle generator does not know about the properties
      * we want to do it not at construction time. Another use for this
      * function is after particle transfer to a new process.
+     *
+     * All particles stored in a ParticleHandler share the property pool of
+     * the ParticleHandler, so this function sets the property pool of all
+     * particles of the container this accessor points into.
      */
     void
     set_property_pool(PropertyPool &property_pool);
@@ -177,25 +182,32 @@ namespace Particles
     ParticleAccessor ();
 
     /**
-     * Construct an accessor from a reference to a map and an iterator to the map.
-     * This constructor is protected so that it can only be accessed by friend
-     * classes.
+     * Construct an accessor from a reference to a container and the index of
+     * a particle in the container. This constructor is protected so that it
+     * can only be accessed by friend classes.
      */
-    ParticleAccessor (const std::multimap<internal::LevelInd, Particle<dim,spacedim> > &map,
-                      const typename std::multimap<internal::LevelInd, Particle<dim,spacedim> >::iterator &particle);
+    ParticleAccessor (const internal::ParticleContainer<dim,spacedim> &container,
+                      const std::size_t                                particle_index);
 
   private:
     /**
      * A pointer to the container that stores the particles. Obviously,
      * this accessor is invalidated if the container changes.
      */
-    std::multimap<internal::LevelInd, Particle<dim,spacedim> > *map;
+    internal::ParticleContainer<dim,spacedim> *container;
 
     /**
-     * An iterator into the container of particles. Obviously,
+     * The index of the particle in the container. Obviously,
      * this accessor is invalidated if the container changes.
      */
-    typename std::multimap<internal::LevelInd, Particle<dim,spacedim> >::iterator particle;
+    std::size_t particle_index;
+
+    /**
+     * The position of the cell of the particle among the cells with
+     * particles of the container, which is kept up to date when moving
+     * through the particles.
+     */
+    unsigned int cell_slot;
 
     /**
      * Make ParticleIterator a friend to allow it constructing ParticleAccessors.
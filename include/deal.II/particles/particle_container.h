@@ -0,0 +1,355 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_particles_particle_container_h
+#define dealii_particles_particle_container_h
+
+#include <deal.II/particles/particle.h>
+#include <deal.II/particles/property_pool.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/types.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace Particles
+{
+  namespace internal
+  {
+    /**
+     * The container in which a ParticleHandler stores its particles. The
+     * particles are sorted by the level/index pair of the cell they are in,
+     * and the data of all particles is kept in one array per member of the
+     * Particle class, i.e., the locations, reference locations, ids and
+     * handles to the properties of consecutive particles are stored
+     * consecutively in memory. Only the cells that contain particles are
+     * stored, together with the range of particles in each cell.
+     *
+     * Particles are addressed by their index in the container. All indices,
+     * and therefore all ParticleIterator objects, are invalidated by
+     * functions that add or remove particles.
+     *
+     * Particles can be added in any order by push_back(), which appends
+     * them to an unsorted tail of the arrays. The tail is sorted into the
+     * other particles by sort(), which needs $O(N + M \log M)$ operations
+     * for $N$ particles already sorted and $M$ new particles. All other
+     * functions of this class except the element access require the
+     * container to be sorted. The particles in the tail can be accessed,
+     * though, and ParticleIterator objects pointing to them can be used to
+     * access the data of a particle, but not to move to other particles.
+     *
+     * The container owns the property handles of its particles and returns
+     * them to the property pool set by set_property_pool() when particles
+     * are removed.
+     */
+    template <int dim, int spacedim>
+    class ParticleContainer
+    {
+    public:
+      /**
+       * Constructor. Creates an empty container without a property pool.
+       */
+      ParticleContainer ();
+
+      /**
+       * Destructor. Returns the property handles of all particles to the
+       * property pool.
+       */
+      ~ParticleContainer ();
+
+      /**
+       * Set the property pool that is used to manage the properties of the
+       * particles of this container.
+       */
+      void set_property_pool (PropertyPool &property_pool);
+
+      /**
+       * Return the property pool of this container, or a null pointer if
+       * none was set.
+       */
+      PropertyPool *get_property_pool () const;
+
+      /**
+       * Remove all particles and return their property handles to the
+       * property pool.
+       */
+      void clear ();
+
+      /**
+       * Return the number of particles, including the ones in the unsorted
+       * tail.
+       */
+      std::size_t size () const;
+
+      /**
+       * Return the number of cells that contain at least one particle.
+       */
+      unsigned int n_cells () const;
+
+      /**
+       * Return the maximal number of particles in one cell.
+       */
+      std::size_t max_particles_per_cell () const;
+
+      /**
+       * Return whether all particles are sorted, i.e., whether the unsorted
+       * tail is empty.
+       */
+      bool is_sorted () const;
+
+      /**
+       * Return the index of the first particle in the cell with the given
+       * level/index pair and one past the index of the last one. Both are
+       * equal to the index of the first particle in a later cell if the cell
+       * does not contain particles.
+       */
+      std::pair<std::size_t,std::size_t>
+      particle_range (const LevelInd &cell) const;
+
+      /**
+       * Return the position of the cell that contains the sorted particle
+       * with index @p index among the cells with particles, or n_cells() if
+       * @p index is the number of sorted particles.
+       */
+      unsigned int cell_slot (const std::size_t index) const;
+
+      /**
+       * Return the level/index pair of the cell of the particle with index
+       * @p index. @p cell_slot must be the value returned by cell_slot() for
+       * @p index if the particle is sorted, and is ignored for particles in
+       * the unsorted tail.
+       */
+      const LevelInd &
+      get_cell (const std::size_t  index,
+                const unsigned int cell_slot) const;
+
+      /**
+       * Return the index of the first particle in the cell with position
+       * @p cell_slot among the cells with particles.
+       */
+      std::size_t cell_begin (const unsigned int cell_slot) const;
+
+      /**
+       * Append a particle in the cell @p cell to the unsorted tail. The
+       * properties of the particle are copied into a new slot of the
+       * property pool if @p particle has properties. Return the index of
+       * the new particle.
+       */
+      std::size_t push_back (const LevelInd               &cell,
+                             const Particle<dim,spacedim> &particle);
+
+      /**
+       * Append a particle in the cell @p cell to the unsorted tail, whose
+       * data is read from @p data as written by ParticleAccessor::write_data()
+       * or Particle::write_data(). @p data is advanced by the size of the data
+       * of the particle. Return the index of the new particle.
+       */
+      std::size_t push_back (const LevelInd  &cell,
+                             const void    *&data);
+
+      /**
+       * Sort the particles of the unsorted tail into the particles that are
+       * already sorted. Particles in the same cell keep their order, and the
+       * particles of the tail are put after the particles that already were
+       * in the same cell.
+       */
+      void sort ();
+
+      /**
+       * Move all particles of @p other into this container, and sort them
+       * into it. @p other is empty afterwards and must use the same property
+       * pool.
+       */
+      void merge (ParticleContainer<dim,spacedim> &other);
+
+      /**
+       * Move the particles with the indices @p moved_particles into the
+       * cells @p new_cells, and remove the particles with the indices
+       * @p removed_particles. Each particle must only appear once in the
+       * two lists.
+       */
+      void relocate (const std::vector<std::size_t> &moved_particles,
+                     const std::vector<LevelInd>    &new_cells,
+                     const std::vector<std::size_t> &removed_particles);
+
+      /**
+       * Remove the particle with index @p index. This needs $O(N)$
+       * operations.
+       */
+      void erase (const std::size_t index);
+
+      /**
+       * Overwrite the id, the locations and the properties of the particle
+       * with index @p index by data read from @p data as written by
+       * ParticleAccessor::write_data() or Particle::write_data(). @p data is
+       * advanced by the size of the data of the particle. The particle stays
+       * in its cell, and indices of particles are not invalidated.
+       */
+      void read_data (const std::size_t  index,
+                      const void       *&data);
+
+      /**
+       * Return a number that is changed by all functions that add, remove
+       * or reorder particles, i.e., by all functions that invalidate the
+       * indices of particles. Two equal return values therefore mean that
+       * the indices of the particles are still valid.
+       */
+      std::size_t n_modifications () const;
+
+      /**
+       * The locations of the particles.
+       */
+      std::vector<Point<spacedim> > locations;
+
+      /**
+       * The locations of the particles in the reference coordinates of
+       * their cells.
+       */
+      std::vector<Point<dim> > reference_locations;
+
+      /**
+       * The ids of the particles.
+       */
+      std::vector<types::particle_index> ids;
+
+      /**
+       * The handles to the properties of the particles, or
+       * PropertyPool::invalid_handle for particles without properties.
+       */
+      std::vector<PropertyPool::Handle> properties;
+
+    private:
+      /**
+       * Remove the particles for which @p remove is true while keeping the
+       * order of the others. The property handles of the removed particles
+       * are not touched.
+       */
+      void compact (const std::vector<bool> &remove);
+
+      /**
+       * The property pool that manages the properties of the particles.
+       */
+      PropertyPool *property_pool;
+
+      /**
+       * The sorted level/index pairs of the cells that contain sorted
+       * particles.
+       */
+      std::vector<LevelInd> cells;
+
+      /**
+       * The index of the first particle of each cell in @p cells, with an
+       * additional entry at the end that is the number of sorted particles.
+       */
+      std::vector<std::size_t> cell_offsets;
+
+      /**
+       * The cells of the particles in the unsorted tail.
+       */
+      std::vector<LevelInd> unsorted_cells;
+
+      /**
+       * The counter returned by n_modifications().
+       */
+      std::size_t modification_counter;
+    };
+
+
+
+    /* ---------------------- inline functions ------------------------- */
+
+    template <int dim, int spacedim>
+    inline
+    std::size_t
+    ParticleContainer<dim,spacedim>::size () const
+    {
+      return ids.size();
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline
+    unsigned int
+    ParticleContainer<dim,spacedim>::n_cells () const
+    {
+      return cells.size();
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline
+    bool
+    ParticleContainer<dim,spacedim>::is_sorted () const
+    {
+      return unsorted_cells.empty();
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline
+    std::size_t
+    ParticleContainer<dim,spacedim>::n_modifications () const
+    {
+      return modification_counter;
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline
+    PropertyPool *
+    ParticleContainer<dim,spacedim>::get_property_pool () const
+    {
+      return property_pool;
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline
+    const LevelInd &
+    ParticleContainer<dim,spacedim>::get_cell (const std::size_t  index,
+                                               const unsigned int cell_slot) const
+    {
+      AssertIndexRange (index, size());
+      if (index >= cell_offsets.back())
+        return unsorted_cells[index-cell_offsets.back()];
+
+      AssertIndexRange (cell_slot, cells.size());
+      Assert (cell_offsets[cell_slot] <= index && index < cell_offsets[cell_slot+1],
+              ExcInternalError());
+      return cells[cell_slot];
+    }
+
+
+
+    template <int dim, int spacedim>
+    inline
+    std::size_t
+    ParticleContainer<dim,spacedim>::cell_begin (const unsigned int cell_slot) const
+    {
+      AssertIndexRange (cell_slot, cell_offsets.size());
+      return cell_offsets[cell_slot];
+    }
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -17,10 +17,12 @@
 #define dealii_particles_particle_handler_h
 
 #include <deal.II/particles/particle.h>
+#include <deal.II/particles/particle_container.h>
 #include <deal.II/particles/particle_iterator.h>
 #include <deal.II/particles/property_pool.h>
 
 #include <deal.II/distributed/tria.h>
+#include <deal.II/grid/grid_tools_cache.h>
 #include <deal.II/base/subscriptor.h>
 #include <deal.II/base/mpi.h>
 #include <deal.II/base/array_view.h>
@@ -181,8 +183,10 @@ namespace Particles
     /**
      * Insert a particle into the collection of particles. Return an iterator
      * to the new position of the particle. This function involves a copy of
-     * the particle and its properties. Note that this function is of $O(N \log N)$
-     * complexity for $N$ particles.
+     * the particle and its properties. Note that this function is of $O(N)$
+     * complexity for $N$ particles, because the particles are stored sorted
+     * by their cells in contiguous arrays. Use insert_particles() to insert
+     * many particles at once.
      */
     particle_iterator
     insert_particle(const Particle<dim,spacedim> &particle,
@@ -306,9 +310,31 @@ namespace Particles
      * Exchanges all particles that live in cells that are ghost cells to
      * other processes. Clears and re-populates the ghost_neighbors
      * member variable.
+     *
+     * If @p enable_ghost_cache is true, the pattern of this exchange, i.e.,
+     * which particles are sent to which process and how much data is
+     * received from each process, is stored together with persistent MPI
+     * requests and buffers, so that update_ghost_particles() can later
+     * resend the data of the same particles without setting up the
+     * communication again.
+     */
+    void
+    exchange_ghost_particles(const bool enable_ghost_cache = false);
+
+    /**
+     * Update the data of the ghost particles, i.e., their locations and
+     * properties, from their current values on the processes that own them.
+     * This only works after a call to exchange_ghost_particles() with
+     * <code>enable_ghost_cache = true</code>, and only as long as no
+     * particles have been added, removed or moved to other cells since
+     * then. The ghost particles keep their cells, and no sizes need to be
+     * communicated, so this function only posts one message to and from
+     * each process that shares ghost particles with the present one. This
+     * makes it considerably cheaper than exchange_ghost_particles() for
+     * time steps in which the particles move, but stay in their cells.
      */
     void
-    exchange_ghost_particles();
+    update_ghost_particles();
 
     /**
      * Callback function that should be called before every
@@ -343,18 +369,25 @@ namespace Particles
      */
     SmartPointer<const Mapping<dim,spacedim>,ParticleHandler<dim,spacedim> > mapping;
 
+    /**
+     * Cached information about the triangulation, like the cells adjacent
+     * to each vertex and the bounding boxes of the cells, which is used to
+     * find the new cells of particles that have moved.
+     */
+    std::unique_ptr<GridTools::Cache<dim,spacedim> > triangulation_cache;
+
     /**
      * Set of particles currently living in the local domain, organized by
      * the level/index of the cell they are in.
      */
-    std::multimap<internal::LevelInd, Particle<dim,spacedim> > particles;
+    internal::ParticleContainer<dim,spacedim> particles;
 
     /**
      * Set of particles that currently live in the ghost cells of the local domain,
      * organized by the level/index of the cell they are in. These
      * particles are equivalent to the ghost entries in distributed vectors.
      */
-    std::multimap<internal::LevelInd, Particle<dim,spacedim> > ghost_particles;
+    internal::ParticleContainer<dim,spacedim> ghost_particles;
 
     /**
      * This variable stores how many particles are stored globally. It is
@@ -431,19 +464,115 @@ namespace Particles
     unsigned int data_offset;
 
 #ifdef DEAL_II_WITH_MPI
+    /**
+     * The communication pattern of the last call of
+     * exchange_ghost_particles() with the ghost cache enabled, which is
+     * reused by update_ghost_particles().
+     */
+    struct GhostParticleCache
+    {
+      /**
+       * Constructor. Creates an invalid cache.
+       */
+      GhostParticleCache ();
+
+      /**
+       * Destructor. Frees the persistent MPI requests.
+       */
+      ~GhostParticleCache ();
+
+      /**
+       * Free the persistent MPI requests and invalidate the cache.
+       */
+      void clear ();
+
+      /**
+       * Whether the cache describes the present ghost particles.
+       */
+      bool valid;
+
+      /**
+       * The value of ParticleContainer::n_modifications() of the locally
+       * owned particles when the cache was set up. The indices in
+       * @p send_particles are only valid as long as it has not changed.
+       */
+      std::size_t particles_modifications;
+
+      /**
+       * The same for the ghost particles, which are addressed by
+       * @p recv_particles.
+       */
+      std::size_t ghost_particles_modifications;
+
+      /**
+       * The number of bytes of the data of one particle, including the data
+       * stored by the store callback.
+       */
+      std::size_t particle_size;
+
+      /**
+       * The processes this process communicates with.
+       */
+      std::vector<types::subdomain_id> neighbors;
+
+      /**
+       * The indices of the locally owned particles sent to each process in
+       * @p neighbors.
+       */
+      std::vector<std::vector<std::size_t> > send_particles;
+
+      /**
+       * The indices of the ghost particles in the order in which they are
+       * received.
+       */
+      std::vector<std::size_t> recv_particles;
+
+      /**
+       * The number of particles received from each process in
+       * @p neighbors.
+       */
+      std::vector<unsigned int> n_recv_particles;
+
+      /**
+       * The buffers for the sent and received data. The persistent requests
+       * point into them, so they must not be reallocated while the cache is
+       * valid.
+       */
+      std::vector<char> send_data;
+      std::vector<char> recv_data;
+
+      /**
+       * The persistent requests for all messages to and from the neighbors
+       * that exchange at least one particle.
+       */
+      std::vector<MPI_Request> requests;
+    };
+
+    /**
+     * The cached communication pattern of the ghost particles.
+     */
+    GhostParticleCache ghost_particles_cache;
+
+    /**
+     * Buffers for the data sent and received by send_recv_particles(). They
+     * are kept between calls so that their memory can be reused.
+     */
+    std::vector<char> send_buffer;
+    std::vector<char> recv_buffer;
+
     /**
      * Transfer particles that have crossed subdomain boundaries to other
      * processors.
      * All received particles and their new cells will be appended to the
-     * @p received_particles vector.
+     * @p received_particles container.
      *
      * @param [in] particles_to_send All particles that should be sent and
      * their new subdomain_ids are in this map.
      *
-     * @param [in,out] received_particles Vector that stores all received
-     * particles. Note that it is not required nor checked that the list
-     * is empty, received particles are simply attached to the end of
-     * the vector.
+     * @param [in,out] received_particles Container that stores all received
+     * particles. Note that it is not required nor checked that the container
+     * is empty, received particles are simply appended to its unsorted
+     * tail and it is the caller's responsibility to sort it.
      *
      * @param [in] new_cells_for_particles Optional vector of cell
      * iterators with the same structure as @p particles_to_send. If this
@@ -451,12 +580,17 @@ namespace Particles
      * particle to be send in which the particle belongs. This parameter
      * is necessary if the cell information of the particle iterator is
      * outdated (e.g. after particle movement).
+     *
+     * @param [out] n_received_particles If not a null pointer, the number
+     * of particles received from each ghost owner, in the order of
+     * Triangulation::ghost_owners(), is stored in this vector.
      */
     void
     send_recv_particles(const std::map<types::subdomain_id, std::vector<particle_iterator> > &particles_to_send,
-                        std::multimap<internal::LevelInd,Particle <dim,spacedim> > &received_particles,
+                        internal::ParticleContainer<dim,spacedim> &received_particles,
                         const std::map<types::subdomain_id, std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> > &new_cells_for_particles =
-                          std::map<types::subdomain_id, std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> > ());
+                          std::map<types::subdomain_id, std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> > (),
+                        std::vector<unsigned int> *n_received_particles = nullptr);
 #endif
 
     /**
@@ -41,10 +41,10 @@ namespace Particles
 
     /**
      * Constructor of the iterator. Takes a reference to the particle
-     * container, and an iterator to the cell-particle pair.
+     * container, and the index of the particle in it.
      */
-    ParticleIterator (const std::multimap<internal::LevelInd, Particle<dim,spacedim> > &map,
-                      const typename std::multimap<internal::LevelInd, Particle<dim,spacedim> >::iterator &particle);
+    ParticleIterator (const internal::ParticleContainer<dim,spacedim> &container,
+                      const std::size_t                                particle_index);
 
     /**
      * Dereferencing operator, returns a reference to an accessor. Usage is thus
@@ -18,6 +18,9 @@
 
 #include <deal.II/base/array_view.h>
 
+#include <memory>
+#include <vector>
+
 DEAL_II_NAMESPACE_OPEN
 
 namespace Particles
@@ -28,8 +31,14 @@ namespace Particles
    * needs the same amount, it is more efficient to let this be handled by a
    * central manager that does not need to allocate/deallocate memory every
    * time a particle is constructed/destroyed.
-   * The current implementation uses simple new/delete allocation for every
-   * block. Additionally, the current implementation
+   * The current implementation allocates the memory in large blocks
+   * (slabs) that each hold the properties of many particles consecutively.
+   * Slots of deallocated properties are kept in a free list and handed out
+   * again before a new block is allocated, and the memory is only returned
+   * to the operating system when the pool is destroyed. The size of new
+   * blocks grows with the number of slots that are already allocated, so
+   * that the number of allocations is logarithmic in the number of
+   * particles. Additionally, the current implementation
    * assumes the same number of properties per particle, but of course the
    * PropertyType could contain a pointer to dynamically allocated memory
    * with varying sizes per particle (this memory would not be managed by this
@@ -64,6 +73,15 @@ namespace Particles
      */
     Handle allocate_properties_array ();
 
+    /**
+     * Append @p n_handles new handles to @p handles. This is equivalent to
+     * calling allocate_properties_array() @p n_handles times, but allocates
+     * all the memory that is needed at once, so that the properties of the
+     * new handles are stored consecutively if the free list is empty.
+     */
+    void allocate_properties_arrays (const std::size_t    n_handles,
+                                     std::vector<Handle> &handles);
+
     /**
      * Mark the properties corresponding to the handle @p handle as
      * deleted. Calling this function more than once for the same
@@ -71,6 +89,12 @@ namespace Particles
      */
     void deallocate_properties_array (const Handle handle);
 
+    /**
+     * Mark the properties corresponding to all handles in @p handles as
+     * deleted. Entries that equal invalid_handle are ignored.
+     */
+    void deallocate_properties_arrays (const std::vector<Handle> &handles);
+
     /**
      * Return an ArrayView to the properties that correspond to the given
      * handle @p handle.
@@ -79,7 +103,8 @@ namespace Particles
 
     /**
      * Reserves the dynamic memory needed for storing the properties of
-     * @p size particles.
+     * @p size particles, i.e., makes sure that the next @p size calls of
+     * allocate_properties_array() do not need to allocate memory.
      */
     void reserve(const std::size_t size);
 
@@ -88,11 +113,52 @@ namespace Particles
      */
     unsigned int n_properties_per_slot() const;
 
+    /**
+     * Return the number of handles that are currently allocated.
+     */
+    std::size_t n_allocated_handles() const;
+
+    /**
+     * Return an estimate of the memory consumption (in bytes) of this
+     * object.
+     */
+    std::size_t memory_consumption() const;
+
   private:
+    /**
+     * Allocate a new block with at least @p n_slots slots and add its slots
+     * to the free list.
+     */
+    void allocate_block (const std::size_t n_slots);
+
     /**
      * The number of properties that are reserved per particle.
      */
     const unsigned int n_properties;
+
+    /**
+     * The number of doubles per slot. This is n_properties, but at least
+     * one, so that different handles are distinct even if there are no
+     * properties.
+     */
+    const unsigned int slot_size;
+
+    /**
+     * The blocks of memory from which the slots are taken.
+     */
+    std::vector<std::unique_ptr<double[]> > blocks;
+
+    /**
+     * The total number of slots in all blocks.
+     */
+    std::size_t n_slots;
+
+    /**
+     * The slots that are currently not in use. The slots are taken from the
+     * back, and the slots of a new block are added in reverse order, so
+     * consecutive allocations get consecutive slots.
+     */
+    std::vector<Handle> free_slots;
   };
 
 
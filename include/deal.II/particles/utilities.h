@@ -0,0 +1,106 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_particles_utilities_h
+#define dealii_particles_utilities_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/component_mask.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/particles/particle_handler.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+#ifdef DEAL_II_WITH_P4EST
+
+namespace Particles
+{
+  /**
+   * Functions that transfer data between finite element fields and the
+   * particles of a ParticleHandler.
+   *
+   * The finite element fields are evaluated at the reference locations of
+   * the particles, which are stored by the ParticleHandler, so no mapping and
+   * no FEValues object is needed. The functions loop over the cells that
+   * contain particles in parallel using WorkStream. For the components of
+   * the finite element that belong to an FE_Q base element, the shape
+   * functions are evaluated as tensor products of the one-dimensional
+   * Lagrange polynomials for VectorizedArray::n_array_elements particles at
+   * once, which needs $O(p\,d)$ operations per particle for the polynomials
+   * and two multiplications per degree of freedom of the cell. All other
+   * components are evaluated through FiniteElement::shape_value_component(),
+   * so only elements whose shape functions do not depend on the mapping are
+   * supported, which are checked to be primitive.
+   *
+   * The data of the particles is stored in vectors with
+   * <code>n_locally_owned_particles() * n_components</code> entries, where
+   * <code>n_components</code> is the number of selected components, and the
+   * entries of the components of the $i$th particle in the order of
+   * ParticleHandler::begin() to ParticleHandler::end() come
+   * consecutively.
+   */
+  namespace Utilities
+  {
+    /**
+     * Evaluate the finite element field @p field_vector defined on
+     * @p dof_handler at the locations of the locally owned particles of
+     * @p particle_handler, and store the values of the components selected
+     * by @p field_comps in @p interpolated_field, which is resized as
+     * necessary. An empty component mask selects all components.
+     *
+     * @p dof_handler must be built on the triangulation of
+     * @p particle_handler, and @p field_vector must allow to read the values
+     * of the degrees of freedom of all locally owned cells, i.e., parallel
+     * vectors need to contain the locally relevant ghost entries.
+     */
+    template <int dim, int spacedim, typename VectorType>
+    void
+    interpolate_field_on_particles (const DoFHandler<dim,spacedim>           &dof_handler,
+                                    const ParticleHandler<dim,spacedim>      &particle_handler,
+                                    const VectorType                         &field_vector,
+                                    Vector<typename VectorType::value_type>  &interpolated_field,
+                                    const ComponentMask                      &field_comps = ComponentMask());
+
+    /**
+     * The transpose of interpolate_field_on_particles(): Add the values in
+     * @p particle_values, in the same format as the output of
+     * interpolate_field_on_particles(), multiplied by the values of the shape
+     * functions at the locations of the particles to @p field_vector, i.e.,
+     * compute $u_j \mathrel{+}= \sum_p \varphi_j(x_p) v_p$ for all degrees
+     * of freedom $j$ of the selected components. This deposits quantities
+     * carried by the particles, like mass or charge, on a finite element
+     * field.
+     *
+     * @p field_vector is not set to zero before. Parallel vectors need to
+     * allow writing to the degrees of freedom of all locally owned cells,
+     * and the function calls <code>compress(VectorOperation::add)</code> on
+     * @p field_vector at the end, so it needs to be called on all processes.
+     */
+    template <int dim, int spacedim, typename VectorType>
+    void
+    deposit_particle_values_on_field (const DoFHandler<dim,spacedim>                &dof_handler,
+                                      const ParticleHandler<dim,spacedim>           &particle_handler,
+                                      const Vector<typename VectorType::value_type> &particle_values,
+                                      VectorType                                    &field_vector,
+                                      const ComponentMask                           &field_comps = ComponentMask());
+  }
+}
+
+#endif // DEAL_II_WITH_P4EST
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
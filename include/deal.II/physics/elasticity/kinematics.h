@@ -390,7 +390,7 @@ Physics::Elasticity::Kinematics::w (
 {
   // This could be implemented as w = l-d, but that would mean computing "l"
   // a second time.
-  const Tensor<2,dim> grad_v = l(F,dF_dt);
+  const Tensor<2,dim,Number> grad_v = l(F,dF_dt);
   return internal::NumberType<Number>::value(0.5)*(grad_v - transpose(grad_v));
 }
 
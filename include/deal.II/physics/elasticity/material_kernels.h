@@ -0,0 +1,560 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_elasticity_material_kernels_h
+#define dealii_elasticity_material_kernels_h
+
+
+#include <deal.II/base/symmetric_tensor.h>
+#include <deal.II/base/tensor.h>
+
+#include <cmath>
+#include <limits>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace Physics
+{
+
+  namespace Elasticity
+  {
+
+    /**
+     * A collection of constitutive laws, given by the stress as a function
+     * of the deformation and by the action of the linearization of the
+     * stress on a direction, which is what a matrix-free operator needs in
+     * each quadrature point. All functions are templated on the number type,
+     * and are written such that they can be evaluated with
+     * <tt>VectorizedArray<double></tt> for several quadrature points at once,
+     * as done by FEEvaluation: they contain no branches that depend on the
+     * deformation, and they compute the few intermediate quantities, like the
+     * inverse of the deformation gradient, once and reuse them instead of
+     * forming the tensors of the Kinematics namespace one after the other.
+     *
+     * A typical use in the quadrature point loop of a matrix-free operator
+     * for finite strain elasticity reads:
+     * @code
+     *   const Physics::Elasticity::MaterialKernels::NeoHookean<dim,VectorizedArray<double> >
+     *   material (mu, lambda);
+     *   ...
+     *   for (unsigned int q=0; q<phi.n_q_points; ++q)
+     *     {
+     *       const Tensor<2,dim,VectorizedArray<double> > F
+     *         = Physics::Elasticity::Kinematics::F (phi_u.get_gradient(q));
+     *       phi.submit_gradient (material.linearized_first_piola_kirchhoff_stress
+     *                            (F, phi.get_gradient(q)), q);
+     *     }
+     * @endcode
+     *
+     * @note The hyperelastic laws are formulated for the codimension 0 case
+     * with a Cartesian basis, like the other functions of the
+     * Physics::Elasticity namespace.
+     */
+    namespace MaterialKernels
+    {
+
+      /**
+       * The compressible Neo-Hookean material with the stored energy function
+       * @f[
+       *   \Psi(\mathbf{F}) = \frac{\mu}{2} \left( \mathrm{tr}(\mathbf{C}) - d
+       *   \right) - \mu \ln J + \frac{\lambda}{2} \left( \ln J \right)^2,
+       * @f]
+       * where $\mu$ and $\lambda$ are the Lam&eacute; parameters of the
+       * linearized material, $\mathbf{C} = \mathbf{F}^T\mathbf{F}$, and $J =
+       * \det \mathbf{F}$.
+       */
+      template <int dim, typename Number>
+      class NeoHookean
+      {
+      public:
+        /**
+         * Constructor.
+         */
+        NeoHookean (const double mu,
+                    const double lambda);
+
+        /**
+         * Return the first Piola-Kirchhoff stress
+         * $\mathbf{P} = \mu \mathbf{F} + (\lambda \ln J - \mu)
+         * \mathbf{F}^{-T}$.
+         */
+        Tensor<2,dim,Number>
+        first_piola_kirchhoff_stress (const Tensor<2,dim,Number> &F) const;
+
+        /**
+         * Return the directional derivative of the first Piola-Kirchhoff
+         * stress at the deformation gradient @p F in the direction @p Grad_du,
+         * $\mathbf{P}'(\mathbf{F})[\mathbf{H}] = \mu \mathbf{H} + \lambda
+         * \, \mathrm{tr}(\mathbf{F}^{-1}\mathbf{H}) \mathbf{F}^{-T} + (\mu -
+         * \lambda \ln J) \mathbf{F}^{-T}\mathbf{H}^T\mathbf{F}^{-T}$.
+         */
+        Tensor<2,dim,Number>
+        linearized_first_piola_kirchhoff_stress (const Tensor<2,dim,Number> &F,
+                                                 const Tensor<2,dim,Number> &Grad_du) const;
+
+      private:
+        const Number mu;
+        const Number lambda;
+      };
+
+
+
+      /**
+       * The compressible Mooney-Rivlin material with the stored energy
+       * function
+       * @f[
+       *   \Psi(\mathbf{F}) = c_1 \left( I_1 - d \right) + c_2 \left( I_2 -
+       *   \frac{d(d-1)}{2} \right) - \beta \ln J + \frac{\lambda}{2} \left(
+       *   \ln J \right)^2, \qquad \beta = 2c_1 + 2(d-1)c_2,
+       * @f]
+       * in terms of the invariants $I_1 = \mathrm{tr}(\mathbf{C})$ and $I_2 =
+       * \frac 12 \left( I_1^2 - \mathbf{C}:\mathbf{C} \right)$ of the right
+       * Cauchy-Green tensor. The choice of $\beta$ makes the reference
+       * configuration stress free. For $c_2=0$, this is the Neo-Hookean
+       * material with $\mu = 2c_1$.
+       */
+      template <int dim, typename Number>
+      class MooneyRivlin
+      {
+      public:
+        /**
+         * Constructor.
+         */
+        MooneyRivlin (const double c_1,
+                      const double c_2,
+                      const double lambda);
+
+        /**
+         * Return the first Piola-Kirchhoff stress
+         * $\mathbf{P} = 2c_1 \mathbf{F} + 2c_2 \left( I_1 \mathbf{F} -
+         * \mathbf{F}\mathbf{C} \right) + (\lambda \ln J - \beta)
+         * \mathbf{F}^{-T}$.
+         */
+        Tensor<2,dim,Number>
+        first_piola_kirchhoff_stress (const Tensor<2,dim,Number> &F) const;
+
+        /**
+         * Return the directional derivative of the first Piola-Kirchhoff
+         * stress at the deformation gradient @p F in the direction
+         * @p Grad_du.
+         */
+        Tensor<2,dim,Number>
+        linearized_first_piola_kirchhoff_stress (const Tensor<2,dim,Number> &F,
+                                                 const Tensor<2,dim,Number> &Grad_du) const;
+
+      private:
+        const Number c_1;
+        const Number c_2;
+        const Number lambda;
+        const Number beta;
+      };
+
+
+
+      /**
+       * Small strain J2 (von Mises) plasticity with linear isotropic
+       * hardening. The yield function is
+       * @f[
+       *   f(\boldsymbol{\sigma}, \alpha) = \| \mathrm{dev}\,
+       *   \boldsymbol{\sigma} \| - \sqrt{\tfrac 23} \left( \sigma_y + H \alpha
+       *   \right),
+       * @f]
+       * where $\alpha$ is the accumulated plastic strain, and the stress is
+       * $\boldsymbol{\sigma} = \kappa \, \mathrm{tr}(\boldsymbol{\varepsilon})
+       * \mathbf{I} + 2\mu \, \mathrm{dev}(\boldsymbol{\varepsilon} -
+       * \boldsymbol{\varepsilon}^p)$.
+       *
+       * The stress is computed by the radial return mapping of Simo and
+       * Hughes, "Computational Inelasticity", Springer 1998. The plastic
+       * multiplier is computed as the positive part of the trial yield
+       * function, so that the elastic and plastic quadrature points are
+       * treated by the same instructions: for the elastic ones, the
+       * multiplier is zero and the update does not change the trial state.
+       * This allows to evaluate quadrature points of different state
+       * together in the lanes of a <tt>VectorizedArray</tt>.
+       */
+      template <int dim, typename Number>
+      class J2Plasticity
+      {
+      public:
+        /**
+         * The internal variables of a quadrature point.
+         */
+        struct State
+        {
+          /**
+           * Constructor. Sets the state of the virgin material.
+           */
+          State ();
+
+          /**
+           * The plastic strain $\boldsymbol{\varepsilon}^p$.
+           */
+          SymmetricTensor<2,dim,Number> plastic_strain;
+
+          /**
+           * The accumulated plastic strain $\alpha$.
+           */
+          Number accumulated_plastic_strain;
+        };
+
+        /**
+         * The data computed by the return mapping that defines the
+         * consistent tangent $\mathbb{C} = \kappa \mathbf{I} \otimes
+         * \mathbf{I} + 2\mu\theta \, \mathbb{P}_{\mathrm{dev}} - 2\mu
+         * \bar\theta \, \mathbf{n} \otimes \mathbf{n}$, which is applied by
+         * apply_consistent_tangent().
+         */
+        struct TangentData
+        {
+          /**
+           * The factor $\theta$, which is one in elastic points.
+           */
+          Number theta;
+
+          /**
+           * The factor $\bar\theta$, which is zero in elastic points.
+           */
+          Number theta_bar;
+
+          /**
+           * The unit normal $\mathbf{n}$ to the yield surface.
+           */
+          SymmetricTensor<2,dim,Number> normal;
+        };
+
+        /**
+         * Constructor, with the bulk modulus @p kappa, the shear modulus
+         * @p mu, the initial yield stress @p yield_stress, and the hardening
+         * modulus @p hardening_modulus.
+         */
+        J2Plasticity (const double kappa,
+                      const double mu,
+                      const double yield_stress,
+                      const double hardening_modulus);
+
+        /**
+         * Compute the stress for the total strain @p strain, given the state
+         * @p old_state at the end of the previous load or time step. The state
+         * after the step is written to @p new_state and the data for the
+         * consistent tangent to @p tangent_data.
+         */
+        SymmetricTensor<2,dim,Number>
+        return_mapping (const SymmetricTensor<2,dim,Number> &strain,
+                        const State                         &old_state,
+                        State                               &new_state,
+                        TangentData                         &tangent_data) const;
+
+        /**
+         * Return the consistent tangent at the state described by
+         * @p tangent_data applied to the strain increment
+         * @p strain_increment.
+         */
+        SymmetricTensor<2,dim,Number>
+        apply_consistent_tangent (const SymmetricTensor<2,dim,Number> &strain_increment,
+                                  const TangentData                   &tangent_data) const;
+
+      private:
+        const Number kappa;
+        const Number mu;
+        const Number yield_stress;
+        const Number hardening_modulus;
+      };
+    }
+  }
+}
+
+
+
+#ifndef DOXYGEN
+
+// ------------------------- inline functions ------------------------
+
+namespace Physics
+{
+  namespace Elasticity
+  {
+    namespace MaterialKernels
+    {
+      namespace internal
+      {
+        // Return a number of type Number with all components set to
+        // @p value. VectorizedArray can not be constructed from a double
+        template <typename Number>
+        inline
+        Number
+        make_number (const double value)
+        {
+          Number result;
+          result = value;
+          return result;
+        }
+
+
+
+        // Compute the inverse of F and the logarithm of its determinant,
+        // which are the quantities shared by the hyperelastic laws
+        template <int dim, typename Number>
+        inline
+        void
+        compute_inverse_and_log_det (const Tensor<2,dim,Number> &F,
+                                     Tensor<2,dim,Number>       &F_inv,
+                                     Number                     &log_J)
+        {
+          const Number J = determinant(F);
+          F_inv = invert(F);
+          log_J = std::log(J);
+        }
+      }
+
+
+
+      template <int dim, typename Number>
+      inline
+      NeoHookean<dim,Number>::NeoHookean (const double mu,
+                                          const double lambda)
+        :
+        mu (internal::make_number<Number>(mu)),
+        lambda (internal::make_number<Number>(lambda))
+      {}
+
+
+
+      template <int dim, typename Number>
+      inline
+      Tensor<2,dim,Number>
+      NeoHookean<dim,Number>::first_piola_kirchhoff_stress (const Tensor<2,dim,Number> &F) const
+      {
+        Tensor<2,dim,Number> F_inv;
+        Number log_J;
+        internal::compute_inverse_and_log_det (F, F_inv, log_J);
+
+        const Number factor = lambda*log_J - mu;
+        Tensor<2,dim,Number> P;
+        for (unsigned int i=0; i<dim; ++i)
+          for (unsigned int j=0; j<dim; ++j)
+            P[i][j] = mu*F[i][j] + factor*F_inv[j][i];
+        return P;
+      }
+
+
+
+      template <int dim, typename Number>
+      inline
+      Tensor<2,dim,Number>
+      NeoHookean<dim,Number>::linearized_first_piola_kirchhoff_stress
+      (const Tensor<2,dim,Number> &F,
+       const Tensor<2,dim,Number> &Grad_du) const
+      {
+        Tensor<2,dim,Number> F_inv;
+        Number log_J;
+        internal::compute_inverse_and_log_det (F, F_inv, log_J);
+
+        // F^{-T} H^T F^{-T} is the transpose of F^{-1} H F^{-1}
+        const Tensor<2,dim,Number> F_inv_H = F_inv * Grad_du;
+        const Tensor<2,dim,Number> F_inv_H_F_inv = F_inv_H * F_inv;
+        const Number volumetric_factor = lambda*trace(F_inv_H);
+        const Number factor = mu - lambda*log_J;
+
+        Tensor<2,dim,Number> dP;
+        for (unsigned int i=0; i<dim; ++i)
+          for (unsigned int j=0; j<dim; ++j)
+            dP[i][j] = (mu*Grad_du[i][j] + volumetric_factor*F_inv[j][i] +
+                        factor*F_inv_H_F_inv[j][i]);
+        return dP;
+      }
+
+
+
+      template <int dim, typename Number>
+      inline
+      MooneyRivlin<dim,Number>::MooneyRivlin (const double c_1,
+                                              const double c_2,
+                                              const double lambda)
+        :
+        c_1 (internal::make_number<Number>(c_1)),
+        c_2 (internal::make_number<Number>(c_2)),
+        lambda (internal::make_number<Number>(lambda)),
+        beta (internal::make_number<Number>(2.*c_1 + 2.*(dim-1)*c_2))
+      {}
+
+
+
+      template <int dim, typename Number>
+      inline
+      Tensor<2,dim,Number>
+      MooneyRivlin<dim,Number>::first_piola_kirchhoff_stress (const Tensor<2,dim,Number> &F) const
+      {
+        Tensor<2,dim,Number> F_inv;
+        Number log_J;
+        internal::compute_inverse_and_log_det (F, F_inv, log_J);
+
+        const Tensor<2,dim,Number> C = transpose(F) * F;
+        const Tensor<2,dim,Number> F_C = F * C;
+        const Number I_1 = trace(C);
+
+        const Number two = internal::make_number<Number>(2.);
+        const Number factor_F = two*c_1 + two*c_2*I_1;
+        const Number factor_F_C = two*c_2;
+        const Number factor_F_inv = lambda*log_J - beta;
+
+        Tensor<2,dim,Number> P;
+        for (unsigned int i=0; i<dim; ++i)
+          for (unsigned int j=0; j<dim; ++j)
+            P[i][j] = (factor_F*F[i][j] - factor_F_C*F_C[i][j] +
+                       factor_F_inv*F_inv[j][i]);
+        return P;
+      }
+
+
+
+      template <int dim, typename Number>
+      inline
+      Tensor<2,dim,Number>
+      MooneyRivlin<dim,Number>::linearized_first_piola_kirchhoff_stress
+      (const Tensor<2,dim,Number> &F,
+       const Tensor<2,dim,Number> &Grad_du) const
+      {
+        Tensor<2,dim,Number> F_inv;
+        Number log_J;
+        internal::compute_inverse_and_log_det (F, F_inv, log_J);
+
+        const Tensor<2,dim,Number> C = transpose(F) * F;
+        const Number I_1 = trace(C);
+        // derivatives of I_1 and C in the direction H
+        const Number dI_1 = internal::make_number<Number>(2.) * scalar_product(F, Grad_du);
+        const Tensor<2,dim,Number> Ft_H = transpose(F) * Grad_du;
+        const Tensor<2,dim,Number> dC = Ft_H + transpose(Ft_H);
+        const Tensor<2,dim,Number> H_C = Grad_du * C;
+        const Tensor<2,dim,Number> F_dC = F * dC;
+
+        const Tensor<2,dim,Number> F_inv_H = F_inv * Grad_du;
+        const Tensor<2,dim,Number> F_inv_H_F_inv = F_inv_H * F_inv;
+
+        const Number two = internal::make_number<Number>(2.);
+        const Number factor_H = two*c_1 + two*c_2*I_1;
+        const Number factor_F = two*c_2*dI_1;
+        const Number factor_C = two*c_2;
+        const Number volumetric_factor = lambda*trace(F_inv_H);
+        const Number factor_F_inv = beta - lambda*log_J;
+
+        Tensor<2,dim,Number> dP;
+        for (unsigned int i=0; i<dim; ++i)
+          for (unsigned int j=0; j<dim; ++j)
+            dP[i][j] = (factor_H*Grad_du[i][j] + factor_F*F[i][j] -
+                        factor_C*(H_C[i][j] + F_dC[i][j]) +
+                        volumetric_factor*F_inv[j][i] +
+                        factor_F_inv*F_inv_H_F_inv[j][i]);
+        return dP;
+      }
+
+
+
+      template <int dim, typename Number>
+      inline
+      J2Plasticity<dim,Number>::State::State ()
+        :
+        accumulated_plastic_strain (internal::make_number<Number>(0.))
+      {}
+
+
+
+      template <int dim, typename Number>
+      inline
+      J2Plasticity<dim,Number>::J2Plasticity (const double kappa,
+                                              const double mu,
+                                              const double yield_stress,
+                                              const double hardening_modulus)
+        :
+        kappa (internal::make_number<Number>(kappa)),
+        mu (internal::make_number<Number>(mu)),
+        yield_stress (internal::make_number<Number>(yield_stress)),
+        hardening_modulus (internal::make_number<Number>(hardening_modulus))
+      {}
+
+
+
+      template <int dim, typename Number>
+      inline
+      SymmetricTensor<2,dim,Number>
+      J2Plasticity<dim,Number>::return_mapping (const SymmetricTensor<2,dim,Number> &strain,
+                                                const State                         &old_state,
+                                                State                               &new_state,
+                                                TangentData                         &tangent_data) const
+      {
+        const Number sqrt_two_thirds = internal::make_number<Number>(std::sqrt(2./3.));
+        const Number two_mu = internal::make_number<Number>(2.)*mu;
+
+        // elastic trial state
+        const SymmetricTensor<2,dim,Number> trial_deviator
+          = two_mu * deviator(strain - old_state.plastic_strain);
+        const Number trial_norm = std::sqrt(trial_deviator * trial_deviator);
+        const Number trial_yield_function
+          = trial_norm - sqrt_two_thirds*(yield_stress + hardening_modulus*
+                                          old_state.accumulated_plastic_strain);
+
+        // the plastic multiplier is zero in elastic points, and the return
+        // direction is only used when it is nonzero, so guard the division
+        // against the zero deviator of the reference state
+        const Number tiny = internal::make_number<Number>(std::numeric_limits<double>::min());
+        const Number positive_yield_function = std::max(trial_yield_function, internal::make_number<Number>(0.));
+        const Number delta_gamma
+          = positive_yield_function / (two_mu + internal::make_number<Number>(2./3.)*hardening_modulus);
+        const Number inverse_trial_norm = internal::make_number<Number>(1.) / std::max(trial_norm, tiny);
+        tangent_data.normal = inverse_trial_norm * trial_deviator;
+
+        new_state.plastic_strain = old_state.plastic_strain + delta_gamma * tangent_data.normal;
+        new_state.accumulated_plastic_strain
+          = old_state.accumulated_plastic_strain + sqrt_two_thirds*delta_gamma;
+
+        // the indicator is one in plastic points and zero in elastic ones,
+        // computed without a comparison
+        const Number plastic_indicator
+          = positive_yield_function / (std::abs(trial_yield_function) + tiny);
+        const Number reduction = two_mu*delta_gamma*inverse_trial_norm;
+        tangent_data.theta = internal::make_number<Number>(1.) - reduction;
+        tangent_data.theta_bar
+          = plastic_indicator / (internal::make_number<Number>(1.) + hardening_modulus/(internal::make_number<Number>(3.)*mu))
+            - reduction;
+
+        const SymmetricTensor<2,dim,Number> deviatoric_stress
+          = trial_deviator - (two_mu*delta_gamma) * tangent_data.normal;
+        return deviatoric_stress + (kappa*trace(strain)) * unit_symmetric_tensor<dim,Number>();
+      }
+
+
+
+      template <int dim, typename Number>
+      inline
+      SymmetricTensor<2,dim,Number>
+      J2Plasticity<dim,Number>::apply_consistent_tangent
+      (const SymmetricTensor<2,dim,Number> &strain_increment,
+       const TangentData                   &tangent_data) const
+      {
+        const Number two_mu = internal::make_number<Number>(2.)*mu;
+        const Number normal_component = tangent_data.normal * strain_increment;
+        return ((two_mu*tangent_data.theta) * deviator(strain_increment)
+                - (two_mu*tangent_data.theta_bar*normal_component) * tangent_data.normal
+                + (kappa*trace(strain_increment)) * unit_symmetric_tensor<dim,Number>());
+      }
+    }
+  }
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -27,6 +27,8 @@
 
 #include <deal.II/lac/vector.h>
 #include <deal.II/lac/block_vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/la_parallel_block_vector.h>
 
 #ifdef DEAL_II_WITH_TRILINOS
 #include <deal.II/lac/trilinos_vector.h>
@@ -44,7 +46,8 @@ namespace SUNDIALS
   namespace internal
   {
     // The following internal functions are used by SUNDIALS wrappers to copy
-    // to and from deal.II vector types.
+    // to and from deal.II vector types. For N_Vector objects that wrap a
+    // deal.II vector (see n_vector.h), the wrapped vector is copied.
 #ifdef DEAL_II_WITH_MPI
 
 #ifdef DEAL_II_WITH_TRILINOS
@@ -70,6 +73,12 @@ namespace SUNDIALS
 
     void copy(Vector<double> &dst, const N_Vector &src);
     void copy(N_Vector &dst, const Vector<double> &src);
+
+    void copy(LinearAlgebra::distributed::Vector<double> &dst, const N_Vector &src);
+    void copy(N_Vector &dst, const LinearAlgebra::distributed::Vector<double> &src);
+
+    void copy(LinearAlgebra::distributed::BlockVector<double> &dst, const N_Vector &src);
+    void copy(N_Vector &dst, const LinearAlgebra::distributed::BlockVector<double> &src);
   }
 }
 DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,203 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2017 by the deal.II authors
+//
+//    This file is part of the deal.II library.
+//
+//    The deal.II library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal.II distribution.
+//
+//-----------------------------------------------------------
+
+#ifndef dealii_sundials_n_vector_h
+#define dealii_sundials_n_vector_h
+
+#include <deal.II/base/config.h>
+#ifdef DEAL_II_WITH_SUNDIALS
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/block_vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/la_parallel_block_vector.h>
+#include <deal.II/lac/vector_memory.h>
+#include <deal.II/sundials/copy.h>
+
+#include <sundials/sundials_nvector.h>
+
+#include <functional>
+#include <type_traits>
+
+DEAL_II_NAMESPACE_OPEN
+namespace SUNDIALS
+{
+  namespace internal
+  {
+    /**
+     * A type trait that is true for the vector types of deal.II whose
+     * objects can be used as the content of an N_Vector, with the operations
+     * of SUNDIALS on N_Vector implemented by the operations of the vector
+     * class. This avoids copying the data between the deal.II vectors and
+     * N_Vector objects in the callbacks of the SUNDIALS wrappers.
+     */
+    template <typename VectorType>
+    struct IsNVectorWrappable : std::false_type
+    {};
+
+    template <>
+    struct IsNVectorWrappable<Vector<double> > : std::true_type
+    {};
+
+    template <>
+    struct IsNVectorWrappable<BlockVector<double> > : std::true_type
+    {};
+
+    template <>
+    struct IsNVectorWrappable<LinearAlgebra::distributed::Vector<double> > : std::true_type
+    {};
+
+    template <>
+    struct IsNVectorWrappable<LinearAlgebra::distributed::BlockVector<double> > : std::true_type
+    {};
+
+    /**
+     * Create an N_Vector with the size and parallel layout of @p model and
+     * all entries set to zero. For the types of IsNVectorWrappable and if
+     * @p wrap is true, the N_Vector owns a vector of type @p VectorType,
+     * which can be accessed by unwrap_nvector(). Otherwise, the N_Vector is a
+     * serial or parallel vector of SUNDIALS on @p communicator, depending on
+     * whether @p VectorType is a serial vector, and its entries need to be
+     * copied by the functions in copy.h.
+     *
+     * The N_Vector needs to be destroyed by N_VDestroy().
+     */
+    template <typename VectorType>
+    N_Vector
+    create_nvector (const VectorType &model,
+                    const MPI_Comm   &communicator,
+                    const bool        wrap = true);
+
+    /**
+     * Return a pointer to the vector of type @p VectorType stored in
+     * @p nvector if it has been created by create_nvector() (or cloned by
+     * SUNDIALS from such a vector), and a null pointer otherwise.
+     */
+    template <typename VectorType>
+    VectorType *
+    unwrap_nvector (N_Vector nvector);
+
+    /**
+     * The ways in which an NVectorView accesses its N_Vector.
+     */
+    enum class NVectorAccess
+    {
+      /**
+       * The entries of the N_Vector are read.
+       */
+      read,
+      /**
+       * The entries of the N_Vector are overwritten.
+       */
+      write,
+      /**
+       * The entries of the N_Vector are read and overwritten.
+       */
+      read_write
+    };
+
+    /**
+     * Access to the content of an N_Vector as an object of type
+     * @p VectorType in the callbacks of SUNDIALS. If the N_Vector wraps a
+     * deal.II vector, the view refers to that vector. Otherwise, the view
+     * holds a vector initialized by the function passed to the constructor,
+     * into which the entries of the N_Vector are copied upon construction
+     * (unless the access is NVectorAccess::write), and from which they are
+     * copied back upon destruction (unless the access is
+     * NVectorAccess::read).
+     */
+    template <typename VectorType>
+    class NVectorView
+    {
+    public:
+      /**
+       * Constructor.
+       */
+      NVectorView (N_Vector                                  nvector,
+                   const std::function<void (VectorType &)> &reinit_vector,
+                   const NVectorAccess                       access = NVectorAccess::read);
+
+      /**
+       * Destructor. Copies the entries back into the N_Vector if necessary.
+       */
+      ~NVectorView ();
+
+      /**
+       * Access to the vector.
+       */
+      VectorType &operator* () const;
+
+    private:
+      N_Vector                                    nvector;
+      const NVectorAccess                         access;
+      GrowingVectorMemory<VectorType>             memory;
+      typename VectorMemory<VectorType>::Pointer  copied_vector;
+      VectorType                                 *vector;
+    };
+
+
+
+    /*---------------------------- Inline functions ---------------------------*/
+
+#ifndef DOXYGEN
+
+    template <typename VectorType>
+    inline
+    NVectorView<VectorType>::NVectorView (N_Vector                                  nvector,
+                                          const std::function<void (VectorType &)> &reinit_vector,
+                                          const NVectorAccess                       access)
+      :
+      nvector (nvector),
+      access (access),
+      vector (unwrap_nvector<VectorType>(nvector))
+    {
+      if (vector == nullptr)
+        {
+          copied_vector = typename VectorMemory<VectorType>::Pointer(memory);
+          reinit_vector (*copied_vector);
+          if (access != NVectorAccess::write)
+            copy (*copied_vector, this->nvector);
+          vector = copied_vector.get();
+        }
+    }
+
+
+
+    template <typename VectorType>
+    inline
+    NVectorView<VectorType>::~NVectorView ()
+    {
+      if (copied_vector && access != NVectorAccess::read)
+        copy (nvector, *copied_vector);
+    }
+
+
+
+    template <typename VectorType>
+    inline
+    VectorType &
+    NVectorView<VectorType>::operator* () const
+    {
+      return *vector;
+    }
+
+#endif // DOXYGEN
+  }
+}
+DEAL_II_NAMESPACE_CLOSE
+
+#endif // DEAL_II_WITH_SUNDIALS
+#endif // dealii_sundials_n_vector_h
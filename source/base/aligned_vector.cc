@@ -0,0 +1,237 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/utilities.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#ifndef DEAL_II_MSVC
+#  include <sys/mman.h>
+#endif
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace
+{
+  /**
+   * The default resource of AlignedVector.
+   */
+  class SystemMemoryResource : public AlignedMemoryResource
+  {
+  public:
+    virtual void *allocate (const std::size_t size,
+                            const std::size_t alignment) const override
+    {
+      void *ptr;
+      Utilities::System::posix_memalign (&ptr, alignment, size);
+      return ptr;
+    }
+
+    virtual void deallocate (void *ptr,
+                             const std::size_t) const override
+    {
+      std::free (ptr);
+    }
+  };
+}
+
+
+
+const AlignedMemoryResource &
+AlignedMemoryResource::get_default ()
+{
+  static const SystemMemoryResource resource;
+  return resource;
+}
+
+
+
+HugePageMemoryResource::HugePageMemoryResource (const std::size_t huge_page_size)
+  :
+  huge_page_size (huge_page_size)
+{
+  Assert (huge_page_size > 0 && (huge_page_size & (huge_page_size-1)) == 0,
+          ExcMessage ("The huge page size must be a power of two."));
+}
+
+
+
+void *
+HugePageMemoryResource::allocate (const std::size_t size,
+                                  const std::size_t alignment) const
+{
+  if (size < huge_page_size)
+    return get_default().allocate (size, alignment);
+
+  void *ptr;
+  Utilities::System::posix_memalign (&ptr, std::max(alignment, huge_page_size),
+                                     size);
+#ifdef MADV_HUGEPAGE
+  // only a hint, so ignore the return value: the memory is usable in any
+  // case, just with regular pages
+  madvise (ptr, size, MADV_HUGEPAGE);
+#endif
+  return ptr;
+}
+
+
+
+void
+HugePageMemoryResource::deallocate (void *ptr,
+                                    const std::size_t) const
+{
+  std::free (ptr);
+}
+
+
+
+#ifdef DEAL_II_WITH_MPI
+void *
+SharedMemoryResource::allocate (const std::size_t size,
+                                const std::size_t alignment) const
+{
+  return get_default().allocate (size, alignment);
+}
+
+
+
+void
+SharedMemoryResource::deallocate (void             *ptr,
+                                  const std::size_t size) const
+{
+  MPI_Win window = MPI_WIN_NULL;
+  {
+    Threads::Mutex::ScopedLock lock (mutex);
+    const auto it = windows.find (ptr);
+    if (it != windows.end())
+      {
+        window = it->second;
+        windows.erase (it);
+      }
+  }
+
+  if (window != MPI_WIN_NULL)
+    {
+      const int ierr = MPI_Win_free (&window);
+      (void)ierr;
+      AssertNothrow (ierr == MPI_SUCCESS, ExcMPI(ierr));
+    }
+  else
+    get_default().deallocate (ptr, size);
+}
+
+
+
+void *
+SharedMemoryResource::replicate (const void        *data,
+                                 std::size_t       &size,
+                                 const MPI_Comm    &communicator,
+                                 const unsigned int root_process) const
+{
+  const unsigned int my_rank = Utilities::MPI::this_mpi_process (communicator);
+  AssertIndexRange (root_process, Utilities::MPI::n_mpi_processes (communicator));
+
+  unsigned long long int n_bytes = size;
+  int ierr = MPI_Bcast (&n_bytes, 1, MPI_UNSIGNED_LONG_LONG, root_process,
+                        communicator);
+  AssertThrowMPI (ierr);
+  size = n_bytes;
+  if (size == 0)
+    return nullptr;
+
+  // group the processes by node. The key puts the root process first on its
+  // node, and otherwise the process with the lowest rank, which then holds
+  // the memory of the node
+  const int key = (my_rank == root_process ? 0 : my_rank+1);
+  MPI_Comm node_communicator;
+  ierr = MPI_Comm_split_type (communicator, MPI_COMM_TYPE_SHARED, key,
+                              MPI_INFO_NULL, &node_communicator);
+  AssertThrowMPI (ierr);
+  const bool holds_memory =
+    (Utilities::MPI::this_mpi_process (node_communicator) == 0);
+
+  // MPI does not guarantee any alignment of the window, so allocate some
+  // more memory and move the start to the next multiple of 64 bytes, with
+  // the offset determined by the process holding the memory since the
+  // addresses differ between the processes
+  const std::size_t alignment = 64;
+  void *ptr = nullptr;
+  MPI_Win window;
+  ierr = MPI_Win_allocate_shared (holds_memory ? size+alignment : 0, 1,
+                                  MPI_INFO_NULL, node_communicator, &ptr,
+                                  &window);
+  AssertThrowMPI (ierr);
+  MPI_Aint window_size;
+  int      displacement_unit;
+  ierr = MPI_Win_shared_query (window, 0, &window_size, &displacement_unit,
+                               &ptr);
+  AssertThrowMPI (ierr);
+  unsigned int offset =
+    (alignment - reinterpret_cast<std::size_t>(ptr) % alignment) % alignment;
+  ierr = MPI_Bcast (&offset, 1, MPI_UNSIGNED, 0, node_communicator);
+  AssertThrowMPI (ierr);
+  ptr = static_cast<char *>(ptr) + offset;
+
+  // distribute the data from the root process to the processes holding the
+  // memory of the other nodes, in chunks whose size fits into an int
+  MPI_Comm holder_communicator;
+  ierr = MPI_Comm_split (communicator, holds_memory ? 0 : MPI_UNDEFINED, key,
+                         &holder_communicator);
+  AssertThrowMPI (ierr);
+  if (holds_memory)
+    {
+      if (my_rank == root_process)
+        std::memcpy (ptr, data, size);
+      const std::size_t max_chunk = std::numeric_limits<int>::max();
+      for (std::size_t start=0; start<size; start+=max_chunk)
+        {
+          ierr = MPI_Bcast (static_cast<char *>(ptr)+start,
+                            std::min(max_chunk, size-start), MPI_BYTE, 0,
+                            holder_communicator);
+          AssertThrowMPI (ierr);
+        }
+      ierr = MPI_Comm_free (&holder_communicator);
+      AssertThrowMPI (ierr);
+    }
+
+  // the other processes on the node may only read after the data is in place
+  ierr = MPI_Barrier (node_communicator);
+  AssertThrowMPI (ierr);
+  ierr = MPI_Comm_free (&node_communicator);
+  AssertThrowMPI (ierr);
+
+  Threads::Mutex::ScopedLock lock (mutex);
+  windows[ptr] = window;
+  return ptr;
+}
+
+
+
+const SharedMemoryResource &
+SharedMemoryResource::get_instance ()
+{
+  static const SharedMemoryResource resource;
+  return resource;
+}
+#endif
+
+
+DEAL_II_NAMESPACE_CLOSE
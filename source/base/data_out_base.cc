@@ -41,6 +41,7 @@
 #include <cstring>
 #include <algorithm>
 #include <iomanip>
+#include <limits>
 #include <ctime>
 #include <cmath>
 #include <set>
@@ -251,11 +252,28 @@ namespace
       }
   }
 
+  /**
+   * The size in bytes of the blocks into which write_compressed_block()
+   * splits the data before compressing them. Each block is compressed
+   * independently, so the blocks can be compressed in parallel, and files
+   * written this way can be read by any VTK reader since this is the
+   * multi-block layout of the vtkZLibDataCompressor.
+   */
+  const std::size_t vtu_compression_block_size = 1 << 18;
+
   /**
    * Do a zlib compression followed
    * by a base64 encoding of the
    * given data. The result is then
    * written to the given stream.
+   *
+   * The data is split into blocks of
+   * vtu_compression_block_size bytes
+   * that are compressed in parallel
+   * tasks. The header lists the number
+   * of blocks, the uncompressed size of
+   * a block and of the last block, and
+   * the compressed size of each block.
    */
   template <typename T>
   void write_compressed_block (const std::vector<T>        &data,
@@ -264,37 +282,85 @@ namespace
   {
     if (data.size() != 0)
       {
-        // allocate a buffer for compressing
-        // data and do so
-        uLongf compressed_data_length
-          = compressBound (data.size() * sizeof(T));
-        char *compressed_data = new char[compressed_data_length];
-        int err = compress2 ((Bytef *) compressed_data,
-                             &compressed_data_length,
-                             (const Bytef *) data.data(),
-                             data.size() * sizeof(T),
-                             get_zlib_compression_level(flags.compression_level));
-        (void)err;
-        Assert (err == Z_OK, ExcInternalError());
+        const std::size_t data_size = data.size() * sizeof(T);
+        const std::size_t n_blocks
+          = (data_size + vtu_compression_block_size - 1) / vtu_compression_block_size;
+        const std::size_t last_block_size
+          = data_size - (n_blocks-1) * vtu_compression_block_size;
+        const int compression_level
+          = get_zlib_compression_level(flags.compression_level);
+        const Bytef *uncompressed_data = (const Bytef *) data.data();
+
+        // allocate a buffer for compressing each block and compress the
+        // blocks, using parallel tasks if there is more than one
+        std::vector<std::vector<Bytef> > compressed_blocks (n_blocks);
+        std::vector<uLongf> compressed_block_sizes (n_blocks);
+        const auto compress_block = [&] (const std::size_t block)
+        {
+          const std::size_t block_size = (block == n_blocks-1 ?
+                                          last_block_size :
+                                          vtu_compression_block_size);
+          compressed_block_sizes[block] = compressBound (block_size);
+          compressed_blocks[block].resize (compressed_block_sizes[block]);
+          int err = compress2 (compressed_blocks[block].data(),
+                               &compressed_block_sizes[block],
+                               uncompressed_data + block * vtu_compression_block_size,
+                               block_size,
+                               compression_level);
+          (void)err;
+          Assert (err == Z_OK, ExcInternalError());
+        };
+
+        if (n_blocks == 1)
+          compress_block (0);
+        else
+          {
+            Threads::TaskGroup<> tasks;
+            for (std::size_t block=0; block<n_blocks; ++block)
+              tasks += Threads::new_task (std::function<void ()>
+                                          ([&compress_block, block] ()
+            {
+              compress_block (block);
+            }));
+            tasks.join_all ();
+          }
 
         // now encode the compression header
-        const uint32_t compression_header[4]
-          = { 1,                                   /* number of blocks */
-              (uint32_t)(data.size() * sizeof(T)), /* size of block */
-              (uint32_t)(data.size() * sizeof(T)), /* size of last block */
-              (uint32_t)compressed_data_length
-            }; /* list of compressed sizes of blocks */
-
-        char *encoded_header = encode_block ((char *)&compression_header[0],
-                                             4 * sizeof(compression_header[0]));
+        std::vector<uint32_t> compression_header (3 + n_blocks);
+        compression_header[0] = n_blocks;                          /* number of blocks */
+        compression_header[1] = (n_blocks == 1 ?
+                                 last_block_size :
+                                 vtu_compression_block_size);      /* size of block */
+        compression_header[2] = last_block_size;                   /* size of last block */
+        std::size_t compressed_data_length = 0;
+        for (std::size_t block=0; block<n_blocks; ++block)
+          {
+            compression_header[3+block] = compressed_block_sizes[block]; /* list of compressed sizes of blocks */
+            compressed_data_length += compressed_block_sizes[block];
+          }
+
+        char *encoded_header = encode_block ((char *)compression_header.data(),
+                                             compression_header.size() *
+                                             sizeof(compression_header[0]));
         output_stream << encoded_header;
         delete[] encoded_header;
 
         // next do the compressed
-        // data encoding in base64
-        char *encoded_data = encode_block (compressed_data,
+        // data encoding in base64. the
+        // blocks are encoded as one
+        // contiguous stream
+        std::vector<char> compressed_data (compressed_data_length);
+        std::size_t offset = 0;
+        for (std::size_t block=0; block<n_blocks; ++block)
+          {
+            std::memcpy (&compressed_data[offset], compressed_blocks[block].data(),
+                         compressed_block_sizes[block]);
+            offset += compressed_block_sizes[block];
+          }
+        compressed_blocks.clear ();
+
+        char *encoded_data = encode_block (compressed_data.data(),
                                            compressed_data_length);
-        delete[] compressed_data;
 
         output_stream << encoded_data;
         delete[] encoded_data;
@@ -589,6 +655,14 @@ namespace DataOutBase
 
 
 
+  const DataOutBase::DataOutFilterFlags &
+  DataOutFilter::get_flags() const
+  {
+    return flags;
+  }
+
+
+
   void
   DataOutFilter::flush_points ()
   {}
@@ -705,6 +779,133 @@ namespace
     1, 3, 9, 12, static_cast<unsigned int>(-1)
   };
 
+  // The VTK cell types VTK_LAGRANGE_CURVE, VTK_LAGRANGE_QUADRILATERAL and
+  // VTK_LAGRANGE_HEXAHEDRON used when writing one higher order cell per
+  // patch
+  const unsigned int vtk_lagrange_type[5] =
+  {
+    1, 68, 70, 72, static_cast<unsigned int>(-1)
+  };
+
+
+
+  /**
+   * Return the position within a VTK Lagrange cell of order @p order of the
+   * point that has the lexicographic indices (i,j,k) on the patch. VTK
+   * numbers the vertices first, followed by the points on the edges, on the
+   * faces, and in the interior, each group in lexicographic order.
+   */
+  unsigned int
+  vtk_point_index_from_ijk (const unsigned int,
+                            const unsigned int,
+                            const unsigned int,
+                            const std::integral_constant<int,0>,
+                            const unsigned int)
+  {
+    return 0;
+  }
+
+
+
+  unsigned int
+  vtk_point_index_from_ijk (const unsigned int i,
+                            const unsigned int,
+                            const unsigned int,
+                            const std::integral_constant<int,1>,
+                            const unsigned int order)
+  {
+    if (i == 0)
+      return 0;
+    else if (i == order)
+      return 1;
+    else
+      return i + 1;
+  }
+
+
+
+  unsigned int
+  vtk_point_index_from_ijk (const unsigned int i,
+                            const unsigned int j,
+                            const unsigned int,
+                            const std::integral_constant<int,2>,
+                            const unsigned int order)
+  {
+    const bool ibdy = (i == 0 || i == order);
+    const bool jbdy = (j == 0 || j == order);
+    const unsigned int nbdy = (ibdy ? 1 : 0) + (jbdy ? 1 : 0);
+
+    // vertices
+    if (nbdy == 2)
+      return (i ? (j ? 2 : 1) : (j ? 3 : 0));
+
+    // edges, in the order of the vertices they connect
+    unsigned int offset = 4;
+    if (nbdy == 1)
+      {
+        if (!ibdy)
+          return (i - 1) + (j ? 2*(order - 1) : 0) + offset;
+        else
+          return (j - 1) + (i ? order - 1 : 3*(order - 1)) + offset;
+      }
+
+    // interior
+    offset += 4 * (order - 1);
+    return offset + (i - 1) + (order - 1) * (j - 1);
+  }
+
+
+
+  unsigned int
+  vtk_point_index_from_ijk (const unsigned int i,
+                            const unsigned int j,
+                            const unsigned int k,
+                            const std::integral_constant<int,3>,
+                            const unsigned int order)
+  {
+    const bool ibdy = (i == 0 || i == order);
+    const bool jbdy = (j == 0 || j == order);
+    const bool kbdy = (k == 0 || k == order);
+    const unsigned int nbdy = (ibdy ? 1 : 0) + (jbdy ? 1 : 0) + (kbdy ? 1 : 0);
+
+    // vertices
+    if (nbdy == 3)
+      return (i ? (j ? 2 : 1) : (j ? 3 : 0)) + (k ? 4 : 0);
+
+    // edges: first the four edges of the bottom face, then those of the top
+    // face, then the four edges in k direction. the latter use the ordering
+    // VTK expects for files with a version before 2.2, in which the last two
+    // of these edges are swapped
+    unsigned int offset = 8;
+    if (nbdy == 2)
+      {
+        if (!ibdy)
+          return (i - 1) + (j ? 2*(order - 1) : 0) + (k ? 4*(order - 1) : 0) + offset;
+        if (!jbdy)
+          return (j - 1) + (i ? order - 1 : 3*(order - 1)) + (k ? 4*(order - 1) : 0) + offset;
+        offset += 8 * (order - 1);
+        return (k - 1) + (order - 1) * (i ? (j ? 3 : 1) : (j ? 2 : 0)) + offset;
+      }
+
+    // faces: the two faces with normal in i direction, then j, then k
+    offset += 12 * (order - 1);
+    if (nbdy == 1)
+      {
+        const unsigned int n_face_points = (order - 1) * (order - 1);
+        if (ibdy)
+          return (j - 1) + (order - 1) * (k - 1) + (i ? n_face_points : 0) + offset;
+        offset += 2 * n_face_points;
+        if (jbdy)
+          return (i - 1) + (order - 1) * (k - 1) + (j ? n_face_points : 0) + offset;
+        offset += 2 * n_face_points;
+        return (i - 1) + (order - 1) * (j - 1) + (k ? n_face_points : 0) + offset;
+      }
+
+    // interior
+    offset += 6 * (order - 1) * (order - 1);
+    return offset + (i - 1) + (order - 1) * ((j - 1) + (order - 1) * (k - 1));
+  }
+
 //----------------------------------------------------------------------//
 //Auxiliary functions
 //----------------------------------------------------------------------//
@@ -1131,6 +1332,14 @@ namespace
                      const unsigned int y_offset,
                      const unsigned int z_offset);
 
+    /**
+     * Write a higher order cell whose points are the ones with the numbers
+     * <tt>start+connectivity[i]</tt>.
+     */
+    void write_high_order_cell (const unsigned int               index,
+                                const unsigned int               start,
+                                const std::vector<unsigned int> &connectivity);
+
     void flush_cells ();
 
     template <typename T>
@@ -1601,6 +1810,23 @@ namespace
 
 
 
+  void
+  VtuStream::write_high_order_cell (const unsigned int,
+                                    const unsigned int               start,
+                                    const std::vector<unsigned int> &connectivity)
+  {
+#if !defined(DEAL_II_WITH_ZLIB)
+    for (unsigned int i=0; i<connectivity.size(); ++i)
+      stream << (i == 0 ? "" : "\t") << start+connectivity[i];
+    stream << '\n';
+#else
+    for (unsigned int i=0; i<connectivity.size(); ++i)
+      cells.push_back (start+connectivity[i]);
+#endif
+  }
+
+
+
   void
   VtuStream::flush_cells ()
   {
@@ -1865,10 +2091,15 @@ namespace DataOutBase
 
 
   DataOutFilterFlags::DataOutFilterFlags (const bool filter_duplicate_vertices,
-                                          const bool xdmf_hdf5_output) :
+                                          const bool xdmf_hdf5_output,
+                                          const unsigned int hdf5_compression_level) :
     filter_duplicate_vertices(filter_duplicate_vertices),
-    xdmf_hdf5_output(xdmf_hdf5_output)
-  {}
+    xdmf_hdf5_output(xdmf_hdf5_output),
+    hdf5_compression_level(hdf5_compression_level)
+  {
+    Assert (hdf5_compression_level <= 9,
+            ExcIndexRange (hdf5_compression_level, 0, 10));
+  }
 
 
   void DataOutFilterFlags::declare_parameters (ParameterHandler &prm)
@@ -1900,6 +2131,11 @@ namespace DataOutBase
     prm.declare_entry ("XDMF HDF5 output", "false",
                        Patterns::Bool(),
                        "Whether the data will be used in an XDMF/HDF5 combination.");
+    prm.declare_entry ("HDF5 compression level", "0",
+                       Patterns::Integer(0,9),
+                       "The level of the deflate compression of the data sets "
+                       "in HDF5 files, between 0 (no compression, data sets are "
+                       "stored contiguously) and 9 (best compression).");
   }
 
 
@@ -1908,6 +2144,7 @@ namespace DataOutBase
   {
     filter_duplicate_vertices = prm.get_bool ("Filter duplicate vertices");
     xdmf_hdf5_output = prm.get_bool ("XDMF HDF5 output");
+    hdf5_compression_level = prm.get_integer ("HDF5 compression level");
   }
 
 
@@ -2286,12 +2523,14 @@ namespace DataOutBase
   VtkFlags::VtkFlags (const double time,
                       const unsigned int cycle,
                       const bool print_date_and_time,
-                      const VtkFlags::ZlibCompressionLevel compression_level)
+                      const VtkFlags::ZlibCompressionLevel compression_level,
+                      const bool write_higher_order_cells)
     :
     time (time),
     cycle (cycle),
     print_date_and_time (print_date_and_time),
-    compression_level (compression_level)
+    compression_level (compression_level),
+    write_higher_order_cells (write_higher_order_cells)
   {}
 
 
@@ -2481,6 +2720,49 @@ namespace DataOutBase
   }
 
 
+
+  template <int dim, int spacedim, typename StreamType>
+  void
+  write_high_order_cells (const std::vector<Patch<dim,spacedim> > &patches,
+                          StreamType                              &out)
+  {
+    Assert (dim<=3, ExcNotImplemented());
+    unsigned int count = 0;
+    unsigned int first_vertex_of_patch = 0;
+    std::vector<unsigned int> connectivity;
+    for (typename std::vector<Patch<dim,spacedim> >::const_iterator
+         patch=patches.begin();
+         patch!=patches.end(); ++patch)
+      {
+        const unsigned int n_subdivisions = patch->n_subdivisions;
+        const unsigned int n = n_subdivisions+1;
+        Assert (dim == 0 || n_subdivisions >= 1,
+                ExcMessage ("Higher order cells can only be written for patches "
+                            "that are subdivided at least once."));
+
+        // the points of the patch are numbered lexicographically, so find
+        // the position of each of them in the VTK cell
+        connectivity.resize (Utilities::fixed_power<dim>(n));
+        const unsigned int n1 = (dim>0) ? n : 1;
+        const unsigned int n2 = (dim>1) ? n : 1;
+        const unsigned int n3 = (dim>2) ? n : 1;
+        for (unsigned int i3=0; i3<n3; ++i3)
+          for (unsigned int i2=0; i2<n2; ++i2)
+            for (unsigned int i1=0; i1<n1; ++i1)
+              connectivity[vtk_point_index_from_ijk (i1, i2, i3,
+                                                     std::integral_constant<int,dim>(),
+                                                     n_subdivisions)]
+                = i3*n*n + i2*n + i1;
+
+        out.write_high_order_cell (count++, first_vertex_of_patch, connectivity);
+
+        first_vertex_of_patch += Utilities::fixed_power<dim>(n);
+      }
+
+    out.flush_cells ();
+  }
+
+
   template <int dim, int spacedim, class StreamType>
   void
   write_data
@@ -5395,6 +5677,10 @@ namespace DataOutBase
     // note that according to the standard, we
     // have to print d=1..3 dimensions, even if
     // we are in reality in 2d, for example
+    // if higher order cells are written, each patch is one cell
+    if (flags.write_higher_order_cells)
+      n_cells = patches.size();
+
     out << "<Piece NumberOfPoints=\"" << n_nodes
         <<"\" NumberOfCells=\"" << n_cells << "\" >\n";
     out << "  <Points>\n";
@@ -5408,7 +5694,10 @@ namespace DataOutBase
     out << "  <Cells>\n";
     out << "    <DataArray type=\"Int32\" Name=\"connectivity\" format=\""
         << ascii_or_binary << "\">\n";
-    write_cells(patches, vtu_out);
+    if (flags.write_higher_order_cells)
+      write_high_order_cells(patches, vtu_out);
+    else
+      write_cells(patches, vtu_out);
     out << "    </DataArray>\n";
 
     // XML VTU format uses offsets; this is
@@ -5419,8 +5708,18 @@ namespace DataOutBase
         << ascii_or_binary << "\">\n";
 
     std::vector<int32_t> offsets (n_cells);
-    for (unsigned int i=0; i<n_cells; ++i)
-      offsets[i] = (i+1)*GeometryInfo<dim>::vertices_per_cell;
+    if (flags.write_higher_order_cells)
+      {
+        int32_t offset = 0;
+        for (unsigned int i=0; i<n_cells; ++i)
+          {
+            offset += Utilities::fixed_power<dim>(patches[i].n_subdivisions+1);
+            offsets[i] = offset;
+          }
+      }
+    else
+      for (unsigned int i=0; i<n_cells; ++i)
+        offsets[i] = (i+1)*GeometryInfo<dim>::vertices_per_cell;
     vtu_out << offsets;
     out << "\n";
     out << "    </DataArray>\n";
@@ -5435,12 +5734,15 @@ namespace DataOutBase
       // uint8_t might be a typedef to unsigned
       // char which is then not printed as
       // ascii integers
+      const unsigned int cell_type = (flags.write_higher_order_cells ?
+                                      vtk_lagrange_type[dim] :
+                                      vtk_cell_type[dim]);
 #ifdef DEAL_II_WITH_ZLIB
       std::vector<uint8_t> cell_types (n_cells,
-                                       static_cast<uint8_t>(vtk_cell_type[dim]));
+                                       static_cast<uint8_t>(cell_type));
 #else
       std::vector<unsigned int> cell_types (n_cells,
-                                            vtk_cell_type[dim]);
+                                            cell_type);
 #endif
       // this should compress well :-)
       vtu_out << cell_types;
@@ -6622,13 +6924,54 @@ void DataOutInterface<dim,spacedim>::write_vtu_in_parallel (const char *filename
   ierr = MPI_Comm_size(comm, &nproc);
   AssertThrowMPI(ierr);
 
+  // every process generates its part of the file in memory: the first one
+  // writes the header in front of its piece, the last one the footer
+  // behind its piece
+  std::string data;
+  {
+    std::stringstream ss;
+    if (myrank==0)
+      DataOutBase::write_vtu_header(ss, vtk_flags);
+    DataOutBase::write_vtu_main (get_patches(), get_dataset_names(),
+                                 get_vector_data_ranges(),
+                                 vtk_flags, ss);
+    if (myrank==nproc-1)
+      DataOutBase::write_vtu_footer(ss);
+    data = ss.str();
+  }
+  AssertThrow (data.size() <= static_cast<std::size_t>(std::numeric_limits<int>::max()),
+               ExcMessage ("The output of a single process exceeds the size "
+                           "that can be written with one MPI I/O call."));
+
+  // compute the position of each part in the file with a single
+  // exclusive scan, rather than serializing the processes through the
+  // shared file pointer of MPI_File_write_ordered
+  unsigned long long int local_size = data.size();
+  unsigned long long int offset = 0;
+  ierr = MPI_Exscan (&local_size, &offset, 1, MPI_UNSIGNED_LONG_LONG,
+                     MPI_SUM, comm);
+  AssertThrowMPI(ierr);
+  // the result of MPI_Exscan is undefined on the first process
+  if (myrank==0)
+    offset = 0;
+
+  // ask for collective buffering, i.e., the two-phase algorithm in which a
+  // few aggregator processes collect the data of the others and write them
+  // in large contiguous chunks. MPI implementations ignore hints they do not
+  // know, and the number of aggregators can be set through the environment
+  // of the MPI implementation
   MPI_Info info;
   ierr = MPI_Info_create(&info);
   AssertThrowMPI(ierr);
+  ierr = MPI_Info_set(info, const_cast<char *>("romio_cb_write"),
+                      const_cast<char *>("enable"));
+  AssertThrowMPI(ierr);
   MPI_File fh;
   ierr = MPI_File_open(comm, const_cast<char *>(filename),
                        MPI_MODE_CREATE | MPI_MODE_WRONLY, info, &fh);
   AssertThrowMPI(ierr);
+  ierr = MPI_Info_free(&info);
+  AssertThrowMPI(ierr);
 
   ierr = MPI_File_set_size(fh, 0); // delete the file contents
   AssertThrowMPI(ierr);
@@ -6636,53 +6979,66 @@ void DataOutInterface<dim,spacedim>::write_vtu_in_parallel (const char *filename
   // write while one core is still setting the size to zero.
   ierr = MPI_Barrier(comm);
   AssertThrowMPI(ierr);
-  ierr = MPI_Info_free(&info);
+
+  ierr = MPI_File_write_at_all(fh, offset, const_cast<char *>(data.c_str()),
+                               data.size(), MPI_CHAR, MPI_STATUS_IGNORE);
   AssertThrowMPI(ierr);
 
-  unsigned int header_size;
+  ierr = MPI_File_close( &fh );
+  AssertThrowMPI(ierr);
+#endif
+}
 
-  //write header
-  if (myrank==0)
-    {
-      std::stringstream ss;
-      DataOutBase::write_vtu_header(ss, vtk_flags);
-      header_size = ss.str().size();
-      ierr = MPI_File_write(fh, const_cast<char *>(ss.str().c_str()), header_size,
-                            MPI_CHAR, MPI_STATUS_IGNORE);
-      AssertThrowMPI(ierr);
-    }
 
-  ierr = MPI_Bcast(&header_size, 1, MPI_UNSIGNED, 0, comm);
-  AssertThrowMPI(ierr);
+namespace
+{
+  /**
+   * A copy of the data needed for writing a Vtu file, owned by the task
+   * that writes it in DataOutInterface::write_vtu_in_background().
+   */
+  template <int dim, int spacedim>
+  struct VtuBackgroundData
+  {
+    std::vector<DataOutBase::Patch<dim,spacedim> >                     patches;
+    std::vector<std::string>                                          data_names;
+    std::vector<std::tuple<unsigned int, unsigned int, std::string> > vector_data_ranges;
+    DataOutBase::VtkFlags                                             flags;
+    std::string                                                       filename;
+  };
 
-  ierr = MPI_File_seek_shared( fh, header_size, MPI_SEEK_SET );
-  AssertThrowMPI(ierr);
+
+  template <int dim, int spacedim>
+  void
+  write_vtu_background_data (const std::shared_ptr<const VtuBackgroundData<dim,spacedim> > &data)
   {
-    std::stringstream ss;
-    DataOutBase::write_vtu_main (get_patches(), get_dataset_names(),
-                                 get_vector_data_ranges(),
-                                 vtk_flags, ss);
-    ierr = MPI_File_write_ordered(fh, const_cast<char *>(ss.str().c_str()),
-                                  ss.str().size(), MPI_CHAR, MPI_STATUS_IGNORE);
-    AssertThrowMPI(ierr);
+    std::ofstream out (data->filename.c_str());
+    AssertThrow (out, ExcIO());
+    DataOutBase::write_vtu (data->patches, data->data_names,
+                            data->vector_data_ranges,
+                            data->flags, out);
   }
+}
 
-  //write footer
-  if (myrank==0)
-    {
-      std::stringstream ss;
-      DataOutBase::write_vtu_footer(ss);
-      unsigned int footer_size = ss.str().size();
-      ierr = MPI_File_write_shared(fh, const_cast<char *>(ss.str().c_str()),
-                                   footer_size, MPI_CHAR, MPI_STATUS_IGNORE);
-      AssertThrowMPI(ierr);
-    }
-  ierr = MPI_File_close( &fh );
-  AssertThrowMPI(ierr);
-#endif
+
+
+template <int dim, int spacedim>
+Threads::Task<>
+DataOutInterface<dim,spacedim>::write_vtu_in_background (const std::string &filename) const
+{
+  std::shared_ptr<VtuBackgroundData<dim,spacedim> >
+  data (new VtuBackgroundData<dim,spacedim>());
+  data->patches            = get_patches();
+  data->data_names         = get_dataset_names();
+  data->vector_data_ranges = get_vector_data_ranges();
+  data->flags              = vtk_flags;
+  data->filename           = filename;
+
+  return Threads::new_task (&write_vtu_background_data<dim,spacedim>,
+                            std::shared_ptr<const VtuBackgroundData<dim,spacedim> >(data));
 }
 
 
+
 template <int dim, int spacedim>
 void
 DataOutInterface<dim,spacedim>::write_pvtu_record (std::ostream &out,
@@ -6961,6 +7317,48 @@ void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &
 
 
 
+#ifdef DEAL_II_WITH_HDF5
+namespace
+{
+  /**
+   * Create the dataset creation property list for a two-dimensional data set
+   * of @p n_rows times @p n_columns entries of type @p element_size. If
+   * @p compression_level is positive, the data set is split into chunks of
+   * about one megabyte that contain whole rows, and each chunk is compressed
+   * with the deflate filter of the given level. Otherwise, the default
+   * contiguous layout is used. The caller must close the returned property
+   * list.
+   */
+  hid_t
+  create_hdf5_dataset_properties (const hsize_t      n_rows,
+                                  const hsize_t      n_columns,
+                                  const std::size_t  element_size,
+                                  const unsigned int compression_level)
+  {
+    const hid_t dataset_plist_id = H5Pcreate(H5P_DATASET_CREATE);
+    AssertThrow(dataset_plist_id >= 0, ExcIO());
+
+    // chunked data sets can not have a chunk size of zero
+    if (compression_level > 0 && n_rows > 0 && n_columns > 0)
+      {
+        const hsize_t chunk_bytes = 1 << 20;
+        hsize_t chunk_dims[2];
+        chunk_dims[0] = std::min (n_rows,
+                                  std::max<hsize_t> (1, chunk_bytes/(n_columns*element_size)));
+        chunk_dims[1] = n_columns;
+        herr_t status = H5Pset_chunk(dataset_plist_id, 2, chunk_dims);
+        AssertThrow(status >= 0, ExcIO());
+        status = H5Pset_deflate(dataset_plist_id, compression_level);
+        AssertThrow(status >= 0, ExcIO());
+      }
+
+    return dataset_plist_id;
+  }
+}
+#endif
+
+
+
 template <int dim, int spacedim>
 void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &/*patches*/,
                                        const DataOutBase::DataOutFilter &data_filter,
@@ -7030,8 +7428,26 @@ void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &
   // Set the access to use the specified MPI_Comm object
   status = H5Pset_fapl_mpio(file_plist_id, comm, MPI_INFO_NULL);
   AssertThrow(status >= 0, ExcIO());
+#if H5_VERSION_GE(1,10,0)
+  // Let all processes read and write the metadata collectively, rather than
+  // every process accessing the metadata of the file independently
+  status = H5Pset_all_coll_metadata_ops(file_plist_id, true);
+  AssertThrow(status >= 0, ExcIO());
+  status = H5Pset_coll_metadata_write(file_plist_id, true);
+  AssertThrow(status >= 0, ExcIO());
+#endif
+#if !H5_VERSION_GE(1,10,2)
+  // Writing data sets with filters in parallel is only supported by later
+  // versions of HDF5
+  AssertThrow (data_filter.get_flags().hdf5_compression_level == 0,
+               ExcMessage ("Compressed parallel HDF5 output requires HDF5 "
+                           "version 1.10.2 or later."));
 #endif
 #endif
+#endif
+
+  const unsigned int compression_level = data_filter.get_flags().hdf5_compression_level;
+  hid_t              dataset_plist_id;
 
   // Compute the global total number of nodes/cells
   // And determine the offset of the data for this process
@@ -7077,18 +7493,27 @@ void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &
       AssertThrow(cell_dataspace >= 0, ExcIO());
 
       // Create the dataset for the nodes and cells
+      dataset_plist_id = create_hdf5_dataset_properties (node_ds_dim[0], node_ds_dim[1],
+                                                         sizeof(double), compression_level);
 #if H5Gcreate_vers == 1
-      node_dataset = H5Dcreate(h5_mesh_file_id, "nodes", H5T_NATIVE_DOUBLE, node_dataspace, H5P_DEFAULT);
+      node_dataset = H5Dcreate(h5_mesh_file_id, "nodes", H5T_NATIVE_DOUBLE, node_dataspace, dataset_plist_id);
 #else
-      node_dataset = H5Dcreate(h5_mesh_file_id, "nodes", H5T_NATIVE_DOUBLE, node_dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      node_dataset = H5Dcreate(h5_mesh_file_id, "nodes", H5T_NATIVE_DOUBLE, node_dataspace, H5P_DEFAULT, dataset_plist_id, H5P_DEFAULT);
 #endif
       AssertThrow(node_dataset >= 0, ExcIO());
+      status = H5Pclose(dataset_plist_id);
+      AssertThrow(status >= 0, ExcIO());
+
+      dataset_plist_id = create_hdf5_dataset_properties (cell_ds_dim[0], cell_ds_dim[1],
+                                                         sizeof(unsigned int), compression_level);
 #if H5Gcreate_vers == 1
-      cell_dataset = H5Dcreate(h5_mesh_file_id, "cells", H5T_NATIVE_UINT, cell_dataspace, H5P_DEFAULT);
+      cell_dataset = H5Dcreate(h5_mesh_file_id, "cells", H5T_NATIVE_UINT, cell_dataspace, dataset_plist_id);
 #else
-      cell_dataset = H5Dcreate(h5_mesh_file_id, "cells", H5T_NATIVE_UINT, cell_dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      cell_dataset = H5Dcreate(h5_mesh_file_id, "cells", H5T_NATIVE_UINT, cell_dataspace, H5P_DEFAULT, dataset_plist_id, H5P_DEFAULT);
 #endif
       AssertThrow(cell_dataset >= 0, ExcIO());
+      status = H5Pclose(dataset_plist_id);
+      AssertThrow(status >= 0, ExcIO());
 
       // Close the node and cell dataspaces since we're done with them
       status = H5Sclose(node_dataspace);
@@ -7195,12 +7620,16 @@ void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &
       pt_data_dataspace = H5Screate_simple(2, node_ds_dim, nullptr);
       AssertThrow(pt_data_dataspace >= 0, ExcIO());
 
+      dataset_plist_id = create_hdf5_dataset_properties (node_ds_dim[0], node_ds_dim[1],
+                                                         sizeof(double), compression_level);
 #if H5Gcreate_vers == 1
-      pt_data_dataset = H5Dcreate(h5_solution_file_id, vector_name.c_str(), H5T_NATIVE_DOUBLE, pt_data_dataspace, H5P_DEFAULT);
+      pt_data_dataset = H5Dcreate(h5_solution_file_id, vector_name.c_str(), H5T_NATIVE_DOUBLE, pt_data_dataspace, dataset_plist_id);
 #else
-      pt_data_dataset = H5Dcreate(h5_solution_file_id, vector_name.c_str(), H5T_NATIVE_DOUBLE, pt_data_dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      pt_data_dataset = H5Dcreate(h5_solution_file_id, vector_name.c_str(), H5T_NATIVE_DOUBLE, pt_data_dataspace, H5P_DEFAULT, dataset_plist_id, H5P_DEFAULT);
 #endif
       AssertThrow(pt_data_dataset >= 0, ExcIO());
+      status = H5Pclose(dataset_plist_id);
+      AssertThrow(status >= 0, ExcIO());
 
       // Create the data subset we'll use to read from memory
       count[0] = local_node_cell_count[0];
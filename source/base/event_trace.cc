@@ -0,0 +1,281 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/event_trace.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/thread_local_storage.h>
+#include <deal.II/base/thread_management.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace EventTrace
+{
+  namespace internal
+  {
+    std::atomic<bool> tracing_enabled (false);
+
+    namespace
+    {
+      /**
+       * A recorded event.
+       */
+      struct Event
+      {
+        const char   *name;
+        const char   *category;
+        std::uint64_t begin_time;
+        std::uint64_t end_time;
+      };
+
+
+
+      /**
+       * The ring buffer of the events of one thread. Only the owning thread
+       * writes into the buffer, so recording an event only needs to publish
+       * the new number of events, which the thread writing the trace reads.
+       */
+      struct ThreadBuffer
+      {
+        ThreadBuffer (const unsigned int capacity,
+                      const unsigned int thread_index)
+          :
+          events (capacity),
+          n_recorded (0),
+          thread_index (thread_index)
+        {}
+
+        std::vector<Event>         events;
+        std::atomic<std::uint64_t> n_recorded;
+        const unsigned int         thread_index;
+      };
+
+
+
+      /**
+       * The buffers of all threads that have recorded events. The buffers
+       * are never freed before the end of the program, so that the events of
+       * threads that have terminated can still be written and the pointers
+       * held by the threads stay valid.
+       */
+      std::vector<std::unique_ptr<ThreadBuffer> > thread_buffers;
+
+      /**
+       * The strings returned by intern().
+       */
+      std::set<std::string> interned_strings;
+
+      /**
+       * A mutex that guards the two objects above.
+       */
+      Threads::Mutex mutex;
+
+      /**
+       * The capacity of newly allocated buffers.
+       */
+      std::atomic<unsigned int> events_per_thread (65536);
+
+      /**
+       * The time of the first call to enable(), used as origin of the times
+       * in the trace.
+       */
+      std::atomic<std::uint64_t> time_origin (0);
+
+      /**
+       * The buffer of the calling thread, or a null pointer if the thread has
+       * not recorded any event yet.
+       */
+      Threads::ThreadLocalStorage<ThreadBuffer *> this_thread_buffer (nullptr);
+
+
+
+      ThreadBuffer &get_thread_buffer ()
+      {
+        ThreadBuffer *&buffer = this_thread_buffer.get();
+        if (buffer == nullptr)
+          {
+            Threads::Mutex::ScopedLock lock (mutex);
+            thread_buffers.emplace_back
+            (new ThreadBuffer (events_per_thread.load(), thread_buffers.size()));
+            buffer = thread_buffers.back().get();
+          }
+        return *buffer;
+      }
+
+
+
+      /**
+       * Write a string into a JSON document, escaping the characters that
+       * have a special meaning there.
+       */
+      void write_json_string (std::ostream &out,
+                              const char   *string)
+      {
+        out << '"';
+        for ( ; *string != '\0'; ++string)
+          if (*string == '"' || *string == '\\')
+            out << '\\' << *string;
+          else if (static_cast<unsigned char>(*string) < 0x20)
+            out << ' ';
+          else
+            out << *string;
+        out << '"';
+      }
+    }
+  }
+
+
+
+  void
+  enable (const unsigned int events_per_thread)
+  {
+    unsigned int capacity = 1;
+    while (capacity < events_per_thread)
+      capacity *= 2;
+    internal::events_per_thread = capacity;
+
+    std::uint64_t no_origin = 0;
+    internal::time_origin.compare_exchange_strong (no_origin, now());
+
+    internal::tracing_enabled = true;
+  }
+
+
+
+  void
+  disable ()
+  {
+    internal::tracing_enabled = false;
+  }
+
+
+
+  void
+  clear ()
+  {
+    Threads::Mutex::ScopedLock lock (internal::mutex);
+    for (unsigned int i=0; i<internal::thread_buffers.size(); ++i)
+      internal::thread_buffers[i]->n_recorded = 0;
+  }
+
+
+
+  void
+  record (const char         *name,
+          const char         *category,
+          const std::uint64_t begin_time,
+          const std::uint64_t end_time)
+  {
+    if (!is_enabled())
+      return;
+
+    internal::ThreadBuffer &buffer = internal::get_thread_buffer();
+
+    // the buffer size is a power of two, so the position in the ring is given
+    // by the lower bits of the event counter. only this thread writes the
+    // counter, so a load and a store are enough
+    const std::uint64_t index = buffer.n_recorded.load (std::memory_order_relaxed);
+    internal::Event &event = buffer.events[index & (buffer.events.size()-1)];
+    event.name       = name;
+    event.category   = category;
+    event.begin_time = begin_time;
+    event.end_time   = end_time;
+    buffer.n_recorded.store (index+1, std::memory_order_release);
+  }
+
+
+
+  const char *
+  intern (const std::string &name)
+  {
+    Threads::Mutex::ScopedLock lock (internal::mutex);
+    return internal::interned_strings.insert(name).first->c_str();
+  }
+
+
+
+  void
+  write_chrome_trace (std::ostream &out)
+  {
+    Threads::Mutex::ScopedLock lock (internal::mutex);
+
+    const unsigned int process_index
+      = (Utilities::MPI::job_supports_mpi() ?
+         Utilities::MPI::this_mpi_process (MPI_COMM_WORLD) : 0);
+    const std::uint64_t time_origin = internal::time_origin.load();
+
+    const std::ios::fmtflags old_flags = out.flags();
+    const std::streamsize old_precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+
+    out << "{\"traceEvents\":[" << std::endl;
+    bool first_event = true;
+
+    std::vector<internal::Event> events;
+    for (unsigned int b=0; b<internal::thread_buffers.size(); ++b)
+      {
+        const internal::ThreadBuffer &buffer = *internal::thread_buffers[b];
+
+        // collect the events still in the ring, i.e., the last ones if the
+        // ring has overflown, and sort them by their begin time since an event
+        // is recorded at its end, after all the events nested in it
+        const std::uint64_t n_recorded = buffer.n_recorded.load (std::memory_order_acquire);
+        const std::uint64_t n_events = std::min<std::uint64_t> (n_recorded,
+                                                                buffer.events.size());
+        events.clear();
+        for (std::uint64_t i=n_recorded-n_events; i<n_recorded; ++i)
+          events.push_back (buffer.events[i & (buffer.events.size()-1)]);
+        std::stable_sort (events.begin(), events.end(),
+                          [] (const internal::Event &a,
+                              const internal::Event &b)
+        {
+          return a.begin_time < b.begin_time;
+        });
+
+        for (unsigned int i=0; i<events.size(); ++i)
+          {
+            if (!first_event)
+              out << ',' << std::endl;
+            first_event = false;
+
+            out << "{\"name\":";
+            internal::write_json_string (out, events[i].name);
+            out << ",\"cat\":";
+            internal::write_json_string (out, events[i].category);
+            out << ",\"ph\":\"X\",\"ts\":"
+                << 1e-3 * (events[i].begin_time - std::min(time_origin, events[i].begin_time))
+                << ",\"dur\":"
+                << 1e-3 * (events[i].end_time - events[i].begin_time)
+                << ",\"pid\":" << process_index
+                << ",\"tid\":" << buffer.thread_index << '}';
+          }
+      }
+
+    out << std::endl << "],\"displayTimeUnit\":\"ms\"}" << std::endl;
+
+    out.flags (old_flags);
+    out.precision (old_precision);
+  }
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -41,69 +41,27 @@ template <int dim> const unsigned int GeometryInfo<dim>::hexes_per_cell;
 
 using namespace numbers;
 
-template <>
-const unsigned int
-GeometryInfo<1>::unit_normal_direction[faces_per_cell]
-  = { 0, 0 };
-
-template <>
-const unsigned int
-GeometryInfo<2>::unit_normal_direction[faces_per_cell]
-  = { 0, 0, 1, 1 };
-
-template <>
-const unsigned int
-GeometryInfo<3>::unit_normal_direction[faces_per_cell]
-  = { 0, 0, 1, 1, 2, 2 };
-
-template <>
-const unsigned int
-GeometryInfo<4>::unit_normal_direction[faces_per_cell]
-  = { 0, 0, 1, 1, 2, 2, 3, 3 };
-
-
-
-template <>
-const int
-GeometryInfo<1>::unit_normal_orientation[faces_per_cell]
-  = { -1, 1 };
-
-template <>
-const int
-GeometryInfo<2>::unit_normal_orientation[faces_per_cell]
-  = { -1, 1, -1, 1 };
-
-template <>
-const int
-GeometryInfo<3>::unit_normal_orientation[faces_per_cell]
-  = { -1, 1, -1, 1, -1, 1 };
-
-template <>
-const int
-GeometryInfo<4>::unit_normal_orientation[faces_per_cell]
-  = { -1, 1, -1, 1, -1, 1, -1, 1 };
-
-
-
-template <>
-const unsigned int
-GeometryInfo<1>::opposite_face[faces_per_cell]
-  = { 1, 0 };
+namespace internal
+{
+  namespace GeometryInfoHelper
+  {
+    constexpr unsigned int FaceTables<1>::unit_normal_direction[2];
+    constexpr int          FaceTables<1>::unit_normal_orientation[2];
+    constexpr unsigned int FaceTables<1>::opposite_face[2];
 
-template <>
-const unsigned int
-GeometryInfo<2>::opposite_face[faces_per_cell]
-  = { 1, 0, 3, 2 };
+    constexpr unsigned int FaceTables<2>::unit_normal_direction[4];
+    constexpr int          FaceTables<2>::unit_normal_orientation[4];
+    constexpr unsigned int FaceTables<2>::opposite_face[4];
 
-template <>
-const unsigned int
-GeometryInfo<3>::opposite_face[faces_per_cell]
-  = { 1, 0, 3, 2, 5, 4 };
+    constexpr unsigned int FaceTables<3>::unit_normal_direction[6];
+    constexpr int          FaceTables<3>::unit_normal_orientation[6];
+    constexpr unsigned int FaceTables<3>::opposite_face[6];
 
-template <>
-const unsigned int
-GeometryInfo<4>::opposite_face[faces_per_cell]
-  = { 1, 0, 3, 2, 5, 4, 7, 6 };
+    constexpr unsigned int FaceTables<4>::unit_normal_direction[8];
+    constexpr int          FaceTables<4>::unit_normal_orientation[8];
+    constexpr unsigned int FaceTables<4>::opposite_face[8];
+  }
+}
 
 
 const unsigned int GeometryInfo<0>::ucd_to_deal[GeometryInfo<0>::vertices_per_cell]
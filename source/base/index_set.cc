@@ -289,70 +289,40 @@ IndexSet::subtract_set (const IndexSet &other)
 {
   compress();
   other.compress();
-  is_compressed = false;
-
 
-  // we save new ranges to be added to our IndexSet in an temporary vector and
-  // add all of them in one go at the end.
+  // walk through both lists of sorted ranges simultaneously and store the
+  // parts of the own ranges not covered by the other set. each range of the
+  // other set splits at most one own range, which bounds the number of new
+  // ranges
   std::vector<Range> new_ranges;
+  new_ranges.reserve (ranges.size() + other.ranges.size());
 
-  std::vector<Range>::iterator own_it = ranges.begin();
-  std::vector<Range>::iterator other_it = other.ranges.begin();
-
-  while (own_it != ranges.end() && other_it != other.ranges.end())
+  std::vector<Range>::const_iterator other_it = other.ranges.begin();
+  for (std::vector<Range>::const_iterator own_it = ranges.begin();
+       own_it != ranges.end(); ++own_it)
     {
-      //advance own iterator until we get an overlap
-      if (own_it->end <= other_it->begin)
-        {
-          ++own_it;
-          continue;
-        }
-      //we are done with other_it, so advance
-      if (own_it->begin >= other_it->end)
-        {
-          ++other_it;
-          continue;
-        }
+      size_type begin = own_it->begin;
+      while (other_it != other.ranges.end() && other_it->end <= begin)
+        ++other_it;
 
-      //Now own_it and other_it overlap.  First save the part of own_it that
-      //is before other_it (if not empty).
-      if (own_it->begin < other_it->begin)
+      while (other_it != other.ranges.end() && other_it->begin < own_it->end)
         {
-          Range r(own_it->begin, other_it->begin);
-          r.nth_index_in_set = 0; //fix warning of unused variable
-          new_ranges.push_back(r);
-        }
-      // change own_it to the sub range behind other_it. Do not delete own_it
-      // in any case. As removal would invalidate iterators, we just shrink
-      // the range to an empty one.
-      own_it->begin = other_it->end;
-      if (own_it->begin > own_it->end)
-        {
-          own_it->begin = own_it->end;
-          ++own_it;
-        }
+          if (other_it->begin > begin)
+            new_ranges.emplace_back (begin, other_it->begin);
+          begin = std::max (begin, other_it->end);
 
-      // continue without advancing iterators, the right one will be advanced
-      // next.
-    }
+          // a range extending past the own range may also cover the next one
+          if (other_it->end > own_it->end)
+            break;
+          ++other_it;
+        }
 
-  // Now delete all empty ranges we might
-  // have created.
-  for (std::vector<Range>::iterator it = ranges.begin();
-       it != ranges.end(); )
-    {
-      if (it->begin >= it->end)
-        it = ranges.erase(it);
-      else
-        ++it;
+      if (begin < own_it->end)
+        new_ranges.emplace_back (begin, own_it->end);
     }
 
-  // done, now add the temporary ranges
-  const std::vector<Range>::iterator end = new_ranges.end();
-  for (std::vector<Range>::iterator it = new_ranges.begin();
-       it != end; ++it)
-    add_range(it->begin, it->end);
-
+  ranges.swap (new_ranges);
+  is_compressed = false;
   compress();
 }
 
@@ -451,6 +421,31 @@ IndexSet::add_indices(const IndexSet &other,
 
 
 
+void
+IndexSet::add_ranges_internal (std::vector<std::pair<size_type,size_type> > &tmp_ranges,
+                               const bool ranges_are_sorted)
+{
+  if (ranges_are_sorted == false)
+    std::sort (tmp_ranges.begin(), tmp_ranges.end());
+
+  // few ranges are cheaper to insert one by one. otherwise, build an index
+  // set from the sorted ranges, which only appends, and merge it with the
+  // present ranges in linear time. the number 9 is chosen heuristically
+  if (tmp_ranges.size() > 9)
+    {
+      IndexSet tmp_set (size());
+      tmp_set.ranges.reserve (tmp_ranges.size());
+      for (unsigned int i=0; i<tmp_ranges.size(); ++i)
+        tmp_set.add_range (tmp_ranges[i].first, tmp_ranges[i].second);
+      add_indices (tmp_set);
+    }
+  else
+    for (unsigned int i=0; i<tmp_ranges.size(); ++i)
+      add_range (tmp_ranges[i].first, tmp_ranges[i].second);
+}
+
+
+
 void
 IndexSet::write(std::ostream &out) const
 {
@@ -542,6 +537,98 @@ void IndexSet::fill_index_vector(std::vector<size_type> &indices) const
 
 
 
+void
+IndexSet::nth_index_in_set (const std::vector<size_type> &local_indices,
+                            std::vector<size_type>       &global_indices) const
+{
+  global_indices.resize (local_indices.size());
+  if (local_indices.empty())
+    return;
+
+  compress ();
+
+  // look up the next index in the range of the previous one and the range
+  // after it before searching all ranges, starting from the largest range
+  Assert (largest_range < ranges.size(), ExcInternalError());
+  std::vector<Range>::const_iterator range = ranges.begin() + largest_range;
+  for (std::size_t i=0; i<local_indices.size(); ++i)
+    {
+      const size_type n = local_indices[i];
+      Assert (n < n_elements(), ExcIndexRangeType<size_type> (n, 0, n_elements()));
+      if (n < range->nth_index_in_set ||
+          n >= range->nth_index_in_set+(range->end-range->begin))
+        {
+          if (range+1 != ranges.end() &&
+              n >= (range+1)->nth_index_in_set &&
+              n < (range+1)->nth_index_in_set+((range+1)->end-(range+1)->begin))
+            ++range;
+          else
+            {
+              Range r (n,n+1);
+              r.nth_index_in_set = n;
+              range = Utilities::lower_bound (ranges.begin(), ranges.end(), r,
+                                              Range::nth_index_compare);
+              Assert (range != ranges.end(), ExcInternalError());
+            }
+        }
+      global_indices[i] = range->begin + (n-range->nth_index_in_set);
+    }
+}
+
+
+
+void
+IndexSet::index_within_set (const std::vector<size_type> &global_indices,
+                            std::vector<size_type>       &local_indices) const
+{
+  // to make this call thread-safe, compress() must not be called through this
+  // function
+  Assert (is_compressed == true, ExcMessage ("IndexSet must be compressed."));
+  local_indices.resize (global_indices.size());
+  if (global_indices.empty())
+    return;
+  if (is_empty())
+    {
+      std::fill (local_indices.begin(), local_indices.end(),
+                 numbers::invalid_dof_index);
+      return;
+    }
+
+  // look up the next index in the range of the previous one and the range
+  // after it before searching all ranges, starting from the largest range
+  Assert (largest_range < ranges.size(), ExcInternalError());
+  std::vector<Range>::const_iterator range = ranges.begin() + largest_range;
+  for (std::size_t i=0; i<global_indices.size(); ++i)
+    {
+      const size_type n = global_indices[i];
+      Assert (n < size(), ExcIndexRangeType<size_type> (n, 0, size()));
+      if (n < range->begin || n >= range->end)
+        {
+          if (range+1 != ranges.end() &&
+              n >= (range+1)->begin && n < (range+1)->end)
+            ++range;
+          else
+            {
+              const std::vector<Range>::const_iterator
+              p = Utilities::lower_bound (ranges.begin(), ranges.end(),
+                                          Range(n,n), Range::end_compare);
+
+              // if n is not in this set
+              if (p == ranges.end() || p->end == n || p->begin > n)
+                {
+                  local_indices[i] = numbers::invalid_dof_index;
+                  continue;
+                }
+              range = p;
+            }
+        }
+      local_indices[i] = (n-range->begin) + range->nth_index_in_set;
+    }
+}
+
+
+
+
 
 #ifdef DEAL_II_WITH_TRILINOS
 
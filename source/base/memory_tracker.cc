@@ -0,0 +1,416 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/memory_tracker.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/thread_local_storage.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/base/utilities.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace MemoryTracker
+{
+  namespace internal
+  {
+    std::atomic<bool> tracking_enabled (false);
+
+    namespace
+    {
+      /**
+       * A recorded array.
+       */
+      struct Allocation
+      {
+        unsigned int subsystem;
+        std::size_t  size;
+      };
+
+
+
+      /**
+       * The state of the tracker.
+       */
+      struct Data
+      {
+        Data ()
+          :
+          names (1, "unassigned"),
+          statistics (1),
+          current_subsystem (0)
+        {
+          indices[names[0]] = 0;
+        }
+
+        /**
+         * The names of the subsystems, and the index of each name. Names are
+         * never removed, so that the indices held by Scope objects stay
+         * valid.
+         */
+        std::vector<std::string>            names;
+        std::map<std::string, unsigned int> indices;
+
+        /**
+         * The statistics of each subsystem and of all together.
+         */
+        std::vector<Statistics> statistics;
+        Statistics              total;
+
+        /**
+         * The arrays allocated since the last call to enable() and not yet
+         * released.
+         */
+        std::unordered_map<const void *, Allocation> allocations;
+
+        /**
+         * A mutex that guards the objects above.
+         */
+        Threads::Mutex mutex;
+
+        /**
+         * The subsystem of the innermost scope of each thread.
+         */
+        Threads::ThreadLocalStorage<unsigned int> current_subsystem;
+      };
+
+
+
+      /**
+       * Return the state of the tracker. The object is created on first use
+       * and never destroyed, since arrays owned by static objects of other
+       * files may be released after the static objects of this file have
+       * been destroyed.
+       */
+      Data &get_data ()
+      {
+        static Data *const data = new Data();
+        return *data;
+      }
+
+
+
+      /**
+       * Return the union of the names in @p names over all processes of
+       * @p mpi_communicator, sorted alphabetically.
+       */
+      std::set<std::string>
+      gather_names (const std::vector<std::string> &names,
+                    const MPI_Comm                 &mpi_communicator)
+      {
+        std::set<std::string> all_names (names.begin(), names.end());
+#ifdef DEAL_II_WITH_MPI
+        if (Utilities::MPI::job_supports_mpi() == false ||
+            Utilities::MPI::n_mpi_processes (mpi_communicator) == 1)
+          return all_names;
+
+        // send the names as one string in which each name is terminated by a
+        // zero character
+        std::vector<char> my_buffer;
+        for (unsigned int i=0; i<names.size(); ++i)
+          {
+            my_buffer.insert (my_buffer.end(), names[i].begin(), names[i].end());
+            my_buffer.push_back ('\0');
+          }
+
+        const unsigned int n_procs = Utilities::MPI::n_mpi_processes (mpi_communicator);
+        int my_size = my_buffer.size();
+        std::vector<int> sizes (n_procs);
+        int ierr = MPI_Allgather (&my_size, 1, MPI_INT, sizes.data(), 1, MPI_INT,
+                                  mpi_communicator);
+        AssertThrowMPI (ierr);
+
+        std::vector<int> offsets (n_procs+1, 0);
+        for (unsigned int p=0; p<n_procs; ++p)
+          offsets[p+1] = offsets[p] + sizes[p];
+        std::vector<char> buffer (std::max(offsets[n_procs], 1));
+        ierr = MPI_Allgatherv (my_buffer.data(), my_size, MPI_CHAR,
+                               buffer.data(), sizes.data(), offsets.data(), MPI_CHAR,
+                               mpi_communicator);
+        AssertThrowMPI (ierr);
+
+        for (int begin=0; begin<offsets[n_procs]; )
+          {
+            const std::string name (&buffer[begin]);
+            all_names.insert (name);
+            begin += name.size() + 1;
+          }
+#else
+        (void)mpi_communicator;
+#endif
+        return all_names;
+      }
+    }
+  }
+
+
+
+  Statistics::Statistics ()
+    :
+    current_bytes (0),
+    peak_bytes (0),
+    n_allocations (0)
+  {}
+
+
+
+  void
+  enable ()
+  {
+    internal::Data &data = internal::get_data();
+    Threads::Mutex::ScopedLock lock (data.mutex);
+    data.allocations.clear();
+    std::fill (data.statistics.begin(), data.statistics.end(), Statistics());
+    data.total = Statistics();
+    internal::tracking_enabled = true;
+  }
+
+
+
+  void
+  disable ()
+  {
+    internal::tracking_enabled = false;
+  }
+
+
+
+  void
+  record_allocation (const void       *ptr,
+                     const std::size_t size)
+  {
+    if (!is_enabled() || ptr == nullptr)
+      return;
+
+    internal::Data &data = internal::get_data();
+    const unsigned int subsystem = data.current_subsystem.get();
+
+    Threads::Mutex::ScopedLock lock (data.mutex);
+    const internal::Allocation allocation = {subsystem, size};
+
+    // an address that is still recorded belongs to an array that has been
+    // released without being recorded, so credit it before reusing the entry
+    std::unordered_map<const void *, internal::Allocation>::iterator
+    existing = data.allocations.find (ptr);
+    if (existing != data.allocations.end())
+      {
+        data.statistics[existing->second.subsystem].current_bytes -= existing->second.size;
+        data.total.current_bytes -= existing->second.size;
+        existing->second = allocation;
+      }
+    else
+      data.allocations.insert (std::make_pair (ptr, allocation));
+
+    for (Statistics *statistics : { &data.statistics[subsystem], &data.total })
+      {
+        statistics->current_bytes += size;
+        statistics->peak_bytes = std::max (statistics->peak_bytes,
+                                           statistics->current_bytes);
+        ++statistics->n_allocations;
+      }
+  }
+
+
+
+  void
+  record_deallocation (const void *ptr)
+  {
+    if (!is_enabled() || ptr == nullptr)
+      return;
+
+    internal::Data &data = internal::get_data();
+    Threads::Mutex::ScopedLock lock (data.mutex);
+    std::unordered_map<const void *, internal::Allocation>::iterator
+    allocation = data.allocations.find (ptr);
+    if (allocation == data.allocations.end())
+      return;
+
+    data.statistics[allocation->second.subsystem].current_bytes -= allocation->second.size;
+    data.total.current_bytes -= allocation->second.size;
+    data.allocations.erase (allocation);
+  }
+
+
+
+  void
+  free (void *ptr) noexcept
+  {
+    if (is_enabled())
+      record_deallocation (ptr);
+    std::free (ptr);
+  }
+
+
+
+  void
+  reset_peaks ()
+  {
+    internal::Data &data = internal::get_data();
+    Threads::Mutex::ScopedLock lock (data.mutex);
+    for (unsigned int i=0; i<data.statistics.size(); ++i)
+      data.statistics[i].peak_bytes = data.statistics[i].current_bytes;
+    data.total.peak_bytes = data.total.current_bytes;
+  }
+
+
+
+  Statistics
+  get_statistics (const std::string &subsystem)
+  {
+    internal::Data &data = internal::get_data();
+    Threads::Mutex::ScopedLock lock (data.mutex);
+    const std::map<std::string, unsigned int>::const_iterator
+    index = data.indices.find (subsystem);
+    if (index == data.indices.end())
+      return Statistics();
+    else
+      return data.statistics[index->second];
+  }
+
+
+
+  Statistics
+  get_total_statistics ()
+  {
+    internal::Data &data = internal::get_data();
+    Threads::Mutex::ScopedLock lock (data.mutex);
+    return data.total;
+  }
+
+
+
+  void
+  print_statistics (std::ostream   &out,
+                    const MPI_Comm &mpi_communicator)
+  {
+    std::vector<std::string> names;
+    {
+      internal::Data &data = internal::get_data();
+      Threads::Mutex::ScopedLock lock (data.mutex);
+      names = data.names;
+    }
+    const std::set<std::string> all_names = internal::gather_names (names,
+                                            mpi_communicator);
+
+    const bool print = (Utilities::MPI::job_supports_mpi() == false ||
+                        Utilities::MPI::this_mpi_process (mpi_communicator) == 0);
+
+    const std::ios::fmtflags old_flags = out.flags();
+    const std::streamsize old_precision = out.precision();
+
+    const double megabyte = 1024.*1024.;
+    const auto print_row = [&] (const std::string &name,
+                                const double       current_bytes,
+                                const double       peak_bytes)
+    {
+      // collective operations, so call them on all processes
+      const Utilities::MPI::MinMaxAvg current
+        = Utilities::MPI::min_max_avg (current_bytes/megabyte, mpi_communicator);
+      const Utilities::MPI::MinMaxAvg peak
+        = Utilities::MPI::min_max_avg (peak_bytes/megabyte, mpi_communicator);
+      if (!print)
+        return;
+
+      std::string name_out = name;
+      name_out.resize (32, ' ');
+      out << "| " << name_out;
+      out << std::fixed << std::setprecision(1) << std::right;
+      out << "|" << std::setw(10) << current.avg << " |";
+      out << std::setw(10) << current.max << " |";
+      out << std::setw(5) << current.max_index << " |";
+      out << std::setw(10) << peak.min << " |";
+      out << std::setw(10) << peak.avg << " |";
+      out << std::setw(10) << peak.max << " |";
+      out << std::setw(5) << peak.max_index << " |" << std::endl;
+    };
+
+    const char *const separator
+      = "+---------------------------------+-----------+-----------+------+"
+        "-----------+-----------+-----------+------+\n";
+    if (print)
+      out << "\n\n"
+          << separator
+          << "| Subsystem (memory in MB)        |  cur. avg |  cur. max | rank |"
+          << "  peak min |  peak avg |  peak max | rank |\n"
+          << separator;
+
+    for (const std::string &name : all_names)
+      {
+        const Statistics statistics = get_statistics (name);
+        print_row (name, statistics.current_bytes, statistics.peak_bytes);
+      }
+
+    if (print)
+      out << separator;
+    const Statistics total = get_total_statistics();
+    print_row ("total tracked", total.current_bytes, total.peak_bytes);
+
+    Utilities::System::MemoryStats memory_stats;
+    memory_stats.VmRSS = 0;
+    memory_stats.VmHWM = 0;
+    Utilities::System::get_memory_stats (memory_stats);
+    print_row ("process resident (VmRSS/VmHWM)",
+               1024.*memory_stats.VmRSS, 1024.*memory_stats.VmHWM);
+    if (print)
+      out << separator << std::endl;
+
+    out.flags (old_flags);
+    out.precision (old_precision);
+  }
+
+
+
+  Scope::Scope (const std::string &subsystem)
+    :
+    previous_subsystem (internal::get_data().current_subsystem.get())
+  {
+    internal::Data &data = internal::get_data();
+    unsigned int index;
+    {
+      Threads::Mutex::ScopedLock lock (data.mutex);
+      const std::map<std::string, unsigned int>::const_iterator
+      existing = data.indices.find (subsystem);
+      if (existing != data.indices.end())
+        index = existing->second;
+      else
+        {
+          index = data.names.size();
+          data.names.push_back (subsystem);
+          data.statistics.push_back (Statistics());
+          data.indices[subsystem] = index;
+        }
+    }
+    data.current_subsystem.get() = index;
+  }
+
+
+
+  Scope::~Scope ()
+  {
+    internal::get_data().current_subsystem.get() = previous_subsystem;
+  }
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -18,12 +18,16 @@
 #include <deal.II/base/mpi.templates.h>
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/index_set.h>
 #include <deal.II/lac/vector_memory.h>
 #include <deal.II/lac/la_parallel_vector.h>
 #include <deal.II/lac/la_parallel_block_vector.h>
 #include <deal.II/base/multithread_info.h>
 
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <sstream>
 
 #ifdef DEAL_II_WITH_TRILINOS
 #  ifdef DEAL_II_WITH_MPI
@@ -87,6 +91,134 @@ namespace Utilities
     }
 
 
+#if MPI_VERSION >= 3
+    namespace
+    {
+      /**
+       * The key of the attribute that counts the calls of
+       * internal::exchange_sparse() on a communicator.
+       */
+      int exchange_counter_keyval = MPI_KEYVAL_INVALID;
+    }
+
+
+
+    namespace internal
+    {
+      std::map<unsigned int, std::vector<char> >
+      exchange_sparse (const MPI_Comm                                   &comm,
+                       const std::map<unsigned int, std::vector<char> > &buffers_to_send)
+      {
+        const unsigned int myid = Utilities::MPI::this_mpi_process(comm);
+        std::map<unsigned int, std::vector<char> > received_buffers;
+
+        // a process might already start the next exchange and send to us
+        // while we still wait for the barrier of the current one. thus, let
+        // the messages of consecutive exchanges on a communicator use
+        // different tags, based on a counter attached to the communicator
+        // (which is consistent among the processes since all of them call
+        // this function the same number of times)
+        int ierr;
+        if (exchange_counter_keyval == MPI_KEYVAL_INVALID)
+          {
+            ierr = MPI_Comm_create_keyval (MPI_COMM_NULL_COPY_FN,
+                                           MPI_COMM_NULL_DELETE_FN,
+                                           &exchange_counter_keyval, nullptr);
+            AssertThrowMPI(ierr);
+          }
+        void *attribute = nullptr;
+        int   attribute_is_set = 0;
+        ierr = MPI_Comm_get_attr (comm, exchange_counter_keyval,
+                                  &attribute, &attribute_is_set);
+        AssertThrowMPI(ierr);
+        const std::size_t counter = attribute_is_set ?
+                                    reinterpret_cast<std::size_t>(attribute) : 0;
+        ierr = MPI_Comm_set_attr (comm, exchange_counter_keyval,
+                                  reinterpret_cast<void *>(counter+1));
+        AssertThrowMPI(ierr);
+        const int tag = 4710 + static_cast<int>(counter % 2);
+
+        // send all messages with synchronous sends, which complete once the
+        // receiver has started to receive them
+        std::vector<MPI_Request> send_requests;
+        send_requests.reserve (buffers_to_send.size());
+        for (const auto &rank_buffer : buffers_to_send)
+          {
+            AssertIndexRange (rank_buffer.first,
+                              Utilities::MPI::n_mpi_processes(comm));
+            if (rank_buffer.first == myid)
+              {
+                received_buffers[myid] = rank_buffer.second;
+                continue;
+              }
+            send_requests.emplace_back ();
+            ierr = MPI_Issend (const_cast<char *>(rank_buffer.second.data()),
+                               rank_buffer.second.size(), MPI_CHAR,
+                               rank_buffer.first, tag, comm,
+                               &send_requests.back());
+            AssertThrowMPI(ierr);
+          }
+
+        // receive messages from whoever sends to us until all processes have
+        // got all their messages delivered. this is the case once the
+        // non-blocking barrier, which each process enters after its own
+        // sends have completed, is done
+        MPI_Request barrier_request;
+        bool barrier_started = false;
+        while (true)
+          {
+            int        message_available = 0;
+            MPI_Status status;
+            ierr = MPI_Iprobe (MPI_ANY_SOURCE, tag, comm,
+                               &message_available, &status);
+            AssertThrowMPI(ierr);
+            if (message_available)
+              {
+                int length = 0;
+                ierr = MPI_Get_count (&status, MPI_CHAR, &length);
+                AssertThrowMPI(ierr);
+                const unsigned int source = status.MPI_SOURCE;
+                Assert (received_buffers.find(source) == received_buffers.end(),
+                        ExcMessage("Each process may only send one message "
+                                   "to another process."));
+                std::vector<char> &buffer = received_buffers[source];
+                buffer.resize (length);
+                ierr = MPI_Recv (buffer.data(), length, MPI_CHAR, source, tag,
+                                 comm, MPI_STATUS_IGNORE);
+                AssertThrowMPI(ierr);
+              }
+
+            if (barrier_started == false)
+              {
+                int all_sends_done = 0;
+                ierr = MPI_Testall (send_requests.size(), send_requests.data(),
+                                    &all_sends_done, MPI_STATUSES_IGNORE);
+                AssertThrowMPI(ierr);
+                if (all_sends_done)
+                  {
+                    ierr = MPI_Ibarrier (comm, &barrier_request);
+                    AssertThrowMPI(ierr);
+                    barrier_started = true;
+                  }
+              }
+            else
+              {
+                int barrier_done = 0;
+                ierr = MPI_Test (&barrier_request, &barrier_done,
+                                 MPI_STATUS_IGNORE);
+                AssertThrowMPI(ierr);
+                if (barrier_done)
+                  break;
+              }
+          }
+
+        return received_buffers;
+      }
+    }
+#endif
+
+
+
     std::vector<unsigned int>
     compute_point_to_point_communication_pattern (const MPI_Comm &mpi_comm,
                                                   const std::vector<unsigned int> &destinations)
@@ -102,7 +234,24 @@ namespace Utilities
                   ExcMessage ("There is no point in communicating with ourselves."));
         }
 
+#if MPI_VERSION >= 3
+      // send an empty message to each destination and see who sends to
+      // us. this only involves the processes that actually communicate plus
+      // a non-blocking barrier, rather than a collective operation on data
+      // of the size of the communicator
+      std::map<unsigned int, std::vector<char> > messages;
+      for (const unsigned int destination : destinations)
+        messages[destination];
+      const std::map<unsigned int, std::vector<char> > received_messages
+        = internal::exchange_sparse (mpi_comm, messages);
+
+      std::vector<unsigned int> origins;
+      origins.reserve (received_messages.size());
+      for (const auto &message : received_messages)
+        origins.push_back (message.first);
+      return origins;
 
+#else
       // let all processors communicate the maximal number of destinations
       // they have
       const unsigned int max_n_destinations
@@ -142,6 +291,7 @@ namespace Utilities
             break;
 
       return origins;
+#endif
     }
 
 
@@ -529,6 +679,186 @@ namespace Utilities
 
 
 
+    std::vector<unsigned int>
+    compute_index_owner (const IndexSet &owned_indices,
+                         const IndexSet &indices_to_look_up,
+                         const MPI_Comm &comm)
+    {
+      AssertDimension (owned_indices.size(), indices_to_look_up.size());
+
+      std::vector<unsigned int> owners (indices_to_look_up.n_elements(),
+                                        numbers::invalid_unsigned_int);
+#ifdef DEAL_II_WITH_MPI
+      typedef IndexSet::size_type size_type;
+
+      const unsigned int my_pid = this_mpi_process(comm);
+      const unsigned int n_procs = n_mpi_processes(comm);
+
+      // process p keeps the owners of the indices in the p-th of n_procs
+      // chunks of the index space, no matter which process owns them
+      const size_type size = owned_indices.size();
+      const size_type chunk_size = std::max<size_type> ((size + n_procs - 1) / n_procs, 1);
+      const size_type dictionary_begin
+        = std::min<size_type> (static_cast<size_type>(my_pid) * chunk_size, size);
+      const size_type dictionary_end
+        = std::min<size_type> (dictionary_begin + chunk_size, size);
+
+      // split the intervals of an index set at the boundaries of the chunks
+      // and collect them as pairs of begin and end by the keeper of the chunk
+      const auto split_into_chunks = [chunk_size] (const IndexSet &indices)
+      {
+        std::map<unsigned int, std::vector<size_type> > ranges;
+        for (IndexSet::IntervalIterator interval = indices.begin_intervals();
+             interval != indices.end_intervals(); ++interval)
+          {
+            const size_type end = interval->last() + 1;
+            for (size_type begin = *interval->begin(); begin < end; )
+              {
+                const unsigned int keeper = begin / chunk_size;
+                const size_type chunk_end
+                  = std::min<size_type> (end, (static_cast<size_type>(keeper) + 1) * chunk_size);
+                ranges[keeper].push_back (begin);
+                ranges[keeper].push_back (chunk_end);
+                begin = chunk_end;
+              }
+          }
+        return ranges;
+      };
+
+      // step 1: register the owned indices with the keepers of their chunks
+      std::vector<unsigned int> dictionary (dictionary_end - dictionary_begin,
+                                            numbers::invalid_unsigned_int);
+      {
+        const std::map<unsigned int, std::vector<size_type> > owned_ranges
+          = some_to_some (comm, split_into_chunks (owned_indices));
+        for (const auto &rank_ranges : owned_ranges)
+          for (unsigned int r=0; r<rank_ranges.second.size(); r+=2)
+            for (size_type i=rank_ranges.second[r]; i<rank_ranges.second[r+1]; ++i)
+              {
+                Assert (dictionary[i-dictionary_begin] == numbers::invalid_unsigned_int,
+                        ExcMessage ("Index " + std::to_string(i) + " is owned by "
+                                    "more than one process."));
+                dictionary[i-dictionary_begin] = rank_ranges.first;
+              }
+      }
+
+      // step 2: send the indices to look up to the keepers of their chunks,
+      // which answer with runs of indices of the same owner, stored as
+      // pairs of the owner and the length of the run
+      const std::map<unsigned int, std::vector<size_type> > queries
+        = some_to_some (comm, split_into_chunks (indices_to_look_up));
+      std::map<unsigned int, std::vector<unsigned int> > answers;
+      for (const auto &rank_ranges : queries)
+        {
+          std::vector<unsigned int> &runs = answers[rank_ranges.first];
+          for (unsigned int r=0; r<rank_ranges.second.size(); r+=2)
+            for (size_type i=rank_ranges.second[r]; i<rank_ranges.second[r+1]; ++i)
+              {
+                const unsigned int owner = dictionary[i-dictionary_begin];
+                if (runs.size() > 0 && runs[runs.size()-2] == owner)
+                  ++runs.back();
+                else
+                  {
+                    runs.push_back (owner);
+                    runs.push_back (1);
+                  }
+              }
+        }
+
+      // step 3: the answers of the keepers come in the order of the indices
+      // since the keepers are sorted by their chunks
+      const std::map<unsigned int, std::vector<unsigned int> > received_answers
+        = some_to_some (comm, answers);
+      unsigned int index = 0;
+      for (const auto &rank_runs : received_answers)
+        for (unsigned int r=0; r<rank_runs.second.size(); r+=2)
+          for (unsigned int j=0; j<rank_runs.second[r+1]; ++j, ++index)
+            {
+              AssertIndexRange (index, owners.size());
+              owners[index] = rank_runs.second[r];
+            }
+      AssertDimension (index, owners.size());
+#else
+      (void)comm;
+      unsigned int index = 0;
+      for (IndexSet::ElementIterator it = indices_to_look_up.begin();
+           it != indices_to_look_up.end(); ++it, ++index)
+        if (owned_indices.is_element (*it))
+          owners[index] = 0;
+#endif
+      return owners;
+    }
+
+
+
+    void broadcast (std::string        &data,
+                    const MPI_Comm     &mpi_communicator,
+                    const unsigned int  root_process)
+    {
+#ifdef DEAL_II_WITH_MPI
+      AssertIndexRange (root_process, n_mpi_processes(mpi_communicator));
+
+      unsigned long long int size = data.size();
+      int ierr = MPI_Bcast (&size, 1, MPI_UNSIGNED_LONG_LONG,
+                            root_process, mpi_communicator);
+      AssertThrowMPI(ierr);
+      data.resize (size);
+
+      // the count argument of MPI_Bcast is an int
+      const unsigned long long int max_piece_size = std::numeric_limits<int>::max();
+      for (unsigned long long int offset = 0; offset < size; offset += max_piece_size)
+        {
+          ierr = MPI_Bcast (&data[offset],
+                            static_cast<int>(std::min (max_piece_size, size-offset)),
+                            MPI_CHAR, root_process, mpi_communicator);
+          AssertThrowMPI(ierr);
+        }
+#else
+      (void)data;
+      (void)mpi_communicator;
+      (void)root_process;
+#endif
+    }
+
+
+
+    std::string read_file_and_broadcast (const std::string  &filename,
+                                         const MPI_Comm     &mpi_communicator,
+                                         const unsigned int  root_process)
+    {
+      std::string contents;
+      int file_is_open = 1;
+      if (this_mpi_process(mpi_communicator) == root_process)
+        {
+          std::ifstream in (filename.c_str(), std::ios::binary);
+          if (in)
+            {
+              std::ostringstream buffer;
+              buffer << in.rdbuf();
+              contents = buffer.str();
+            }
+          else
+            file_is_open = 0;
+        }
+
+      // let the other processes know about a failure before throwing, they
+      // would wait for the contents of the file forever otherwise
+#ifdef DEAL_II_WITH_MPI
+      const int ierr = MPI_Bcast (&file_is_open, 1, MPI_INT,
+                                  root_process, mpi_communicator);
+      AssertThrowMPI(ierr);
+#endif
+      AssertThrow (file_is_open == 1,
+                   ExcMessage ("The file <" + filename + "> could not be opened "
+                               "on the process with rank " +
+                               Utilities::to_string(root_process) + "."));
+
+      broadcast (contents, mpi_communicator, root_process);
+      return contents;
+    }
+
+
+
 #include "mpi.inst"
   } // end of namespace MPI
 } // end of namespace Utilities
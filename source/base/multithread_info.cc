@@ -30,6 +30,16 @@
 #ifdef DEAL_II_WITH_THREADS
 #  include <deal.II/base/thread_management.h>
 #  include <tbb/task_scheduler_init.h>
+#  include <tbb/task_scheduler_observer.h>
+#endif
+
+#if defined(DEAL_II_WITH_THREADS) && defined(__linux__)
+#  include <sched.h>
+#  include <atomic>
+#  include <fstream>
+#  include <string>
+#  include <utility>
+#  include <vector>
 #endif
 
 DEAL_II_NAMESPACE_OPEN
@@ -189,6 +199,182 @@ bool MultithreadInfo::is_running_single_threaded()
 }
 
 
+void MultithreadInfo::set_parallel_first_touch (const bool parallel_first_touch_in)
+{
+  parallel_first_touch = parallel_first_touch_in;
+}
+
+
+bool MultithreadInfo::use_parallel_first_touch ()
+{
+  return parallel_first_touch;
+}
+
+
+void MultithreadInfo::set_loop_backend (const LoopBackend &loop_backend_in)
+{
+  loop_backend = loop_backend_in;
+}
+
+
+const MultithreadInfo::LoopBackend &
+MultithreadInfo::get_loop_backend ()
+{
+  return loop_backend;
+}
+
+
+#if defined(DEAL_II_WITH_THREADS) && defined(__linux__)
+
+namespace
+{
+  /**
+   * The cores the process was allowed to run on at the first call of
+   * set_thread_affinity().
+   */
+  cpu_set_t process_mask;
+  bool      process_mask_is_set = false;
+
+  /**
+   * The cores to pin the threads to, in the order of the thread slots, or
+   * an empty vector if the threads are not pinned.
+   */
+  std::vector<int> pinning_cpus;
+
+  /**
+   * A counter that is increased by every call of set_thread_affinity(), and
+   * the next slot to be given to a thread of the TBB since that call. Slot
+   * zero is the thread calling set_thread_affinity().
+   */
+  std::atomic<unsigned int> pinning_generation (0);
+  std::atomic<unsigned int> next_thread_slot (1);
+
+
+
+  /**
+   * Return the processor package (socket) of the given core as reported by
+   * the kernel, or zero if this information is not available.
+   */
+  unsigned int
+  get_package_id (const int cpu)
+  {
+    std::ifstream file ("/sys/devices/system/cpu/cpu" + std::to_string(cpu)
+                        + "/topology/physical_package_id");
+    unsigned int package_id = 0;
+    if (file)
+      file >> package_id;
+    return package_id;
+  }
+
+
+
+  /**
+   * Pin the calling thread to the core of the given slot, or let it run on
+   * all cores of the process if the threads are not pinned.
+   */
+  void
+  pin_calling_thread (const unsigned int slot)
+  {
+    if (pinning_cpus.empty())
+      sched_setaffinity (0, sizeof(process_mask), &process_mask);
+    else
+      {
+        cpu_set_t mask;
+        CPU_ZERO (&mask);
+        CPU_SET (pinning_cpus[slot % pinning_cpus.size()], &mask);
+        sched_setaffinity (0, sizeof(mask), &mask);
+      }
+  }
+
+
+
+  /**
+   * An observer that pins the worker threads of the TBB when they enter the
+   * task scheduler for the first time after a call of set_thread_affinity().
+   */
+  class PinningObserver : public tbb::task_scheduler_observer
+  {
+  public:
+    virtual void on_scheduler_entry (bool is_worker)
+    {
+      if (is_worker == false)
+        return;
+
+      static thread_local unsigned int pinned_generation = 0;
+      const unsigned int generation = pinning_generation.load();
+      if (pinned_generation != generation)
+        {
+          pinned_generation = generation;
+          pin_calling_thread (next_thread_slot++);
+        }
+    }
+  };
+}
+
+#endif
+
+
+
+void MultithreadInfo::set_thread_affinity (const ThreadAffinity policy)
+{
+  thread_affinity = policy;
+
+#if defined(DEAL_II_WITH_THREADS) && defined(__linux__)
+  if (process_mask_is_set == false)
+    {
+      CPU_ZERO (&process_mask);
+      if (sched_getaffinity (0, sizeof(process_mask), &process_mask) != 0)
+        return;
+      process_mask_is_set = true;
+    }
+
+  // collect the allowed cores together with their package and sort them
+  // according to the policy
+  std::vector<std::pair<unsigned int,int> > cpus;
+  for (int cpu=0; cpu<CPU_SETSIZE; ++cpu)
+    if (CPU_ISSET (cpu, &process_mask))
+      cpus.emplace_back (get_package_id(cpu), cpu);
+  std::sort (cpus.begin(), cpus.end());
+
+  pinning_cpus.clear();
+  if (policy == compact)
+    for (const auto &cpu : cpus)
+      pinning_cpus.push_back (cpu.second);
+  else if (policy == scatter)
+    {
+      // take the cores of the packages in turns
+      std::vector<std::vector<int> > cpus_of_package;
+      for (unsigned int i=0; i<cpus.size(); ++i)
+        {
+          if (i == 0 || cpus[i].first != cpus[i-1].first)
+            cpus_of_package.emplace_back ();
+          cpus_of_package.back().push_back (cpus[i].second);
+        }
+      for (unsigned int j=0; pinning_cpus.size()<cpus.size(); ++j)
+        for (const auto &package : cpus_of_package)
+          if (j < package.size())
+            pinning_cpus.push_back (package[j]);
+    }
+
+  // pin the calling thread right away, and the workers of the TBB as soon as
+  // they get to work again
+  next_thread_slot = 1;
+  ++pinning_generation;
+  pin_calling_thread (0);
+
+  static PinningObserver observer;
+  observer.observe (true);
+#endif
+}
+
+
+MultithreadInfo::ThreadAffinity
+MultithreadInfo::get_thread_affinity ()
+{
+  return thread_affinity;
+}
+
+
 std::size_t
 MultithreadInfo::memory_consumption ()
 {
@@ -200,6 +386,9 @@ MultithreadInfo::memory_consumption ()
 
 const unsigned int MultithreadInfo::n_cpus = MultithreadInfo::get_n_cpus();
 unsigned int MultithreadInfo::n_max_threads = numbers::invalid_unsigned_int;
+bool MultithreadInfo::parallel_first_touch = false;
+MultithreadInfo::ThreadAffinity MultithreadInfo::thread_affinity = MultithreadInfo::no_pinning;
+MultithreadInfo::LoopBackend MultithreadInfo::loop_backend;
 
 namespace
 {
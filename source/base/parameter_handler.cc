@@ -439,6 +439,41 @@ void ParameterHandler::parse_input (const std::string &filename,
 
 
 
+void ParameterHandler::parse_input (const std::string &filename,
+                                    const MPI_Comm    &mpi_communicator,
+                                    const std::string &last_line)
+{
+  // only the first process searches the file. the others need to know
+  // whether it was found before an exception is thrown, since they would
+  // wait for the contents of the file forever otherwise
+  std::string openname;
+  int file_found = 1;
+  if (Utilities::MPI::this_mpi_process(mpi_communicator) == 0)
+    {
+      try
+        {
+          PathSearch search("PARAMETERS");
+          openname = search.find(filename);
+        }
+      catch (const PathSearch::ExcFileNotFound &)
+        {
+          file_found = 0;
+        }
+    }
+#ifdef DEAL_II_WITH_MPI
+  const int ierr = MPI_Bcast (&file_found, 1, MPI_INT, 0, mpi_communicator);
+  AssertThrowMPI(ierr);
+#endif
+  AssertThrow (file_found == 1,
+               PathSearch::ExcFileNotFound (filename, "PARAMETERS"));
+
+  std::istringstream input_stream
+  (Utilities::MPI::read_file_and_broadcast (openname, mpi_communicator));
+  parse_input (input_stream, filename, last_line);
+}
+
+
+
 void
 ParameterHandler::parse_input_from_string (const char *s,
                                            const std::string &last_line)
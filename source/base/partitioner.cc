@@ -15,6 +15,7 @@
 
 #include <deal.II/base/partitioner.h>
 #include <deal.II/base/partitioner.templates.h>
+#include <deal.II/base/mpi.templates.h>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -32,7 +33,8 @@ namespace Utilities
       my_pid (0),
       n_procs (1),
       communicator (MPI_COMM_SELF),
-      have_ghost_indices (false)
+      have_ghost_indices (false),
+      persistent_communication (false)
     {}
 
 
@@ -49,7 +51,8 @@ namespace Utilities
       my_pid (0),
       n_procs (1),
       communicator (MPI_COMM_SELF),
-      have_ghost_indices (false)
+      have_ghost_indices (false),
+      persistent_communication (false)
     {
       locally_owned_range_data.add_range (0, size);
       locally_owned_range_data.compress ();
@@ -69,7 +72,8 @@ namespace Utilities
       my_pid (0),
       n_procs (1),
       communicator (communicator_in),
-      have_ghost_indices (false)
+      have_ghost_indices (false),
+      persistent_communication (false)
     {
       set_owned_indices (locally_owned_indices);
       set_ghost_indices (ghost_indices_in);
@@ -87,7 +91,8 @@ namespace Utilities
       my_pid (0),
       n_procs (1),
       communicator (communicator_in),
-      have_ghost_indices (false)
+      have_ghost_indices (false),
+      persistent_communication (false)
     {
       set_owned_indices (locally_owned_indices);
     }
@@ -173,9 +178,6 @@ namespace Utilities
       // the processors the ghost indices actually belong to, and the indices
       // that are locally held but ghost indices of other processors. This
       // allows then to import and export data very easily.
-
-      // find out the end index for each processor and communicate it (this
-      // implies the start index for the next processor)
 #ifdef DEAL_II_WITH_MPI
       if (n_procs < 2)
         {
@@ -185,44 +187,14 @@ namespace Utilities
           return;
         }
 
-      std::vector<types::global_dof_index> first_index (n_procs+1);
-      // Allow non-zero start index for the vector. send this data to all
-      // processors
-      first_index[0] = local_range_data.first;
-      int ierr = MPI_Bcast(first_index.data(), 1, DEAL_II_DOF_INDEX_MPI_TYPE,
-                           0, communicator);
-      AssertThrowMPI(ierr);
-
-      // Get the end-of-local_range for all processors
-      ierr = MPI_Allgather(&local_range_data.second, 1,
-                           DEAL_II_DOF_INDEX_MPI_TYPE, &first_index[1], 1,
-                           DEAL_II_DOF_INDEX_MPI_TYPE, communicator);
-      AssertThrowMPI(ierr);
-      first_index[n_procs] = global_size;
-
-      // fix case when there are some processors without any locally owned
-      // indices: then there might be a zero in some entries
-      if (global_size > 0)
-        {
-          unsigned int first_proc_with_nonzero_dofs = 0;
-          for (unsigned int i=0; i<n_procs; ++i)
-            if (first_index[i+1]>0)
-              {
-                first_proc_with_nonzero_dofs = i;
-                break;
-              }
-          for (unsigned int i=first_proc_with_nonzero_dofs+1; i<n_procs; ++i)
-            if (first_index[i] == 0)
-              first_index[i] = first_index[i-1];
-
-          // correct if our processor has a wrong local range
-          if (first_index[my_pid] != local_range_data.first)
-            {
-              Assert(local_range_data.first == local_range_data.second,
-                     ExcInternalError());
-              local_range_data.first = local_range_data.second = first_index[my_pid];
-            }
-        }
+      // find the owners of the ghost indices by a distributed directory of
+      // the locally owned ranges, which only involves the processes we
+      // actually communicate with, rather than by gathering the ranges of
+      // all processes
+      const std::vector<unsigned int> ghost_owners
+        = Utilities::MPI::compute_index_owner (locally_owned_range_data,
+                                               ghost_indices_data,
+                                               communicator);
 
       // Allocate memory for data that will be exported
       std::vector<types::global_dof_index> expanded_ghost_indices (n_ghost_indices_data);
@@ -234,96 +206,68 @@ namespace Utilities
           // data to that field of the partitioner. This way, the variable
           // ghost_targets will have exactly the size we need, whereas the
           // vector filled with emplace_back might actually be too long.
-          unsigned int current_proc = 0;
           ghost_indices_data.fill_index_vector (expanded_ghost_indices);
-          types::global_dof_index current_index = expanded_ghost_indices[0];
-          while (current_index >= first_index[current_proc+1])
-            current_proc++;
-          std::vector<std::pair<unsigned int, unsigned int> > ghost_targets_temp
-          (1, std::pair<unsigned int, unsigned int>(current_proc, 0));
-          n_ghost_targets++;
-
-          for (unsigned int iterator=1; iterator<n_ghost_indices_data; ++iterator)
+          std::vector<std::pair<unsigned int, unsigned int> > ghost_targets_temp;
+          for (unsigned int iterator=0; iterator<n_ghost_indices_data; ++iterator)
             {
-              current_index = expanded_ghost_indices[iterator];
-              while (current_index >= first_index[current_proc+1])
-                current_proc++;
+              const unsigned int current_proc = ghost_owners[iterator];
+              AssertThrow (current_proc != numbers::invalid_unsigned_int,
+                           ExcMessage ("The ghost index " +
+                                       std::to_string(expanded_ghost_indices[iterator]) +
+                                       " is not owned by any process."));
               AssertIndexRange (current_proc, n_procs);
-              if ( ghost_targets_temp[n_ghost_targets-1].first < current_proc)
+              if (n_ghost_targets == 0 ||
+                  ghost_targets_temp[n_ghost_targets-1].first < current_proc)
                 {
-                  ghost_targets_temp[n_ghost_targets-1].second =
-                    iterator - ghost_targets_temp[n_ghost_targets-1].second;
-                  ghost_targets_temp.emplace_back (current_proc, iterator);
+                  ghost_targets_temp.emplace_back (current_proc, 0);
                   n_ghost_targets++;
                 }
+              Assert (ghost_targets_temp[n_ghost_targets-1].first == current_proc,
+                      ExcMessage ("The locally owned ranges must be ordered "
+                                  "by the rank of their processes."));
+              ++ghost_targets_temp[n_ghost_targets-1].second;
             }
-          ghost_targets_temp[n_ghost_targets-1].second =
-            n_ghost_indices_data - ghost_targets_temp[n_ghost_targets-1].second;
           ghost_targets_data = ghost_targets_temp;
         }
-      // find the processes that want to import to me
+      // send the ghost indices to their owners. the owners do not know in
+      // advance who imports from them, so let some_to_some() find that out
+      // rather than exchanging one integer with every other process
+      std::vector<types::global_dof_index> expanded_import_indices;
       {
-        std::vector<int> send_buffer (n_procs, 0);
-        std::vector<int> receive_buffer (n_procs, 0);
+        std::map<unsigned int, std::vector<types::global_dof_index> > ghost_indices_by_rank;
+        unsigned int current_index_start = 0;
         for (unsigned int i=0; i<n_ghost_targets; i++)
-          send_buffer[ghost_targets_data[i].first] = ghost_targets_data[i].second;
+          {
+            ghost_indices_by_rank[ghost_targets_data[i].first]
+            .assign (expanded_ghost_indices.begin() + current_index_start,
+                     expanded_ghost_indices.begin() + current_index_start +
+                     ghost_targets_data[i].second);
+            current_index_start += ghost_targets_data[i].second;
+          }
+        AssertDimension (current_index_start, n_ghost_indices_data);
 
-        const int ierr = MPI_Alltoall (send_buffer.data(), 1, MPI_INT, receive_buffer.data(), 1,
-                                       MPI_INT, communicator);
-        AssertThrowMPI(ierr);
+        const std::map<unsigned int, std::vector<types::global_dof_index> >
+        import_indices_by_rank = Utilities::MPI::some_to_some (communicator,
+                                                               ghost_indices_by_rank);
 
-        // allocate memory for import data
+        // the received map is sorted by rank, as the import targets are
         std::vector<std::pair<unsigned int,unsigned int> > import_targets_temp;
         n_import_indices_data = 0;
-        for (unsigned int i=0; i<n_procs; i++)
-          if (receive_buffer[i] > 0)
+        for (const auto &rank_indices : import_indices_by_rank)
+          if (rank_indices.second.size() > 0)
             {
-              n_import_indices_data += receive_buffer[i];
-              import_targets_temp.emplace_back(i, receive_buffer[i]);
+              n_import_indices_data += rank_indices.second.size();
+              import_targets_temp.emplace_back(rank_indices.first,
+                                               rank_indices.second.size());
             }
         // copy, don't move, to get deterministic memory usage.
         import_targets_data = import_targets_temp;
-      }
 
-      // send and receive indices for import data. non-blocking receives and
-      // blocking sends
-      std::vector<types::global_dof_index> expanded_import_indices (n_import_indices_data);
-      {
-        unsigned int current_index_start = 0;
-        std::vector<MPI_Request> import_requests (import_targets_data.size());
-        for (unsigned int i=0; i<import_targets_data.size(); i++)
-          {
-            const int ierr = MPI_Irecv (&expanded_import_indices[current_index_start],
-                                        import_targets_data[i].second,
-                                        DEAL_II_DOF_INDEX_MPI_TYPE,
-                                        import_targets_data[i].first,
-                                        import_targets_data[i].first,
-                                        communicator, &import_requests[i]);
-            AssertThrowMPI(ierr);
-            current_index_start += import_targets_data[i].second;
-          }
-        AssertDimension (current_index_start, n_import_indices_data);
-
-        // use blocking send
-        current_index_start = 0;
-        for (unsigned int i=0; i<n_ghost_targets; i++)
-          {
-            const int ierr = MPI_Send (&expanded_ghost_indices[current_index_start],
-                                       ghost_targets_data[i].second, DEAL_II_DOF_INDEX_MPI_TYPE,
-                                       ghost_targets_data[i].first, my_pid,
-                                       communicator);
-            AssertThrowMPI(ierr);
-            current_index_start += ghost_targets_data[i].second;
-          }
-        AssertDimension (current_index_start, n_ghost_indices_data);
-
-        if (import_requests.size()>0)
-          {
-            const int ierr = MPI_Waitall (import_requests.size(),
-                                          import_requests.data(),
-                                          MPI_STATUSES_IGNORE);
-            AssertThrowMPI(ierr);
-          }
+        expanded_import_indices.reserve (n_import_indices_data);
+        for (const auto &rank_indices : import_indices_by_rank)
+          expanded_import_indices.insert (expanded_import_indices.end(),
+                                          rank_indices.second.begin(),
+                                          rank_indices.second.end());
 
         // transform import indices to local index space and compress
         // contiguous indices in form of ranges
@@ -388,15 +332,17 @@ namespace Utilities
 
           n_ghost_indices_in_larger_set = larger_ghost_index_set.n_elements();
 
-          std::vector<unsigned int> expanded_numbering;
-          for (IndexSet::ElementIterator it=ghost_indices_data.begin();
-               it != ghost_indices_data.end(); ++it)
-            {
-              Assert(larger_ghost_index_set.is_element(*it),
-                     ExcMessage("The given larger ghost index set must contain"
-                                "all indices in the actual index set."));
-              expanded_numbering.push_back(larger_ghost_index_set.index_within_set(*it));
-            }
+          std::vector<types::global_dof_index> ghost_indices;
+          ghost_indices_data.fill_index_vector (ghost_indices);
+          std::vector<types::global_dof_index> expanded_numbering;
+          larger_ghost_index_set.index_within_set (ghost_indices,
+                                                   expanded_numbering);
+#ifdef DEBUG
+          for (unsigned int i=0; i<expanded_numbering.size(); ++i)
+            Assert(expanded_numbering[i] != numbers::invalid_dof_index,
+                   ExcMessage("The given larger ghost index set must contain"
+                              "all indices in the actual index set."));
+#endif
 
           std::vector<std::pair<unsigned int,unsigned int> > ghost_indices_subset;
           ghost_indices_subset_chunks_by_rank_data.resize(ghost_targets_data.size()+1);
@@ -484,4 +430,22 @@ namespace Utilities
 // explicit instantiations from .templates.h file
 #include "partitioner.inst"
 
+#ifdef DEAL_II_WITH_MPI
+// ghost exchange in reduced precision
+template void Utilities::MPI::Partitioner::export_to_ghosted_array_start<double,float>(const unsigned int ,
+    const ArrayView<const double> &,
+    const ArrayView<double> &,
+    const ArrayView<double> &,
+    std::vector<MPI_Request> &) const;
+template void Utilities::MPI::Partitioner::export_to_ghosted_array_finish<double,float>(const ArrayView<double> &,
+    std::vector<MPI_Request> &) const;
+template void Utilities::MPI::Partitioner::export_to_ghosted_array_start<std::complex<double>,std::complex<float> >(const unsigned int ,
+    const ArrayView<const std::complex<double> > &,
+    const ArrayView<std::complex<double> > &,
+    const ArrayView<std::complex<double> > &,
+    std::vector<MPI_Request> &) const;
+template void Utilities::MPI::Partitioner::export_to_ghosted_array_finish<std::complex<double>,std::complex<float> >(const ArrayView<std::complex<double> > &,
+    std::vector<MPI_Request> &) const;
+#endif
+
 DEAL_II_NAMESPACE_CLOSE
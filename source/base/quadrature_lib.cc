@@ -15,16 +15,84 @@
 
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/geometry_info.h>
+#include <deal.II/base/thread_management.h>
 
 #include <cmath>
 #include <limits>
 #include <algorithm>
 #include <functional>
+#include <map>
 
 
 DEAL_II_NAMESPACE_OPEN
 
 
+namespace
+{
+  // The one-dimensional Gauss and Gauss-Lobatto formulas are computed by a
+  // Newton iteration for each root, which is the dominant cost of setting up
+  // finite elements (whose support points use them) and of the tensor
+  // product formulas in higher dimensions. Since the same formulas are
+  // requested over and over again, they are stored here once computed,
+  // keyed by the number of points. The maps are function-local statics so
+  // that they exist when quadrature objects are created during static
+  // initialization in other translation units.
+  Threads::Mutex &
+  quadrature_cache_mutex ()
+  {
+    static Threads::Mutex mutex;
+    return mutex;
+  }
+
+  std::map<unsigned int, Quadrature<1> > &
+  gauss_cache ()
+  {
+    static std::map<unsigned int, Quadrature<1> > cache;
+    return cache;
+  }
+
+  std::map<unsigned int, Quadrature<1> > &
+  gauss_lobatto_cache ()
+  {
+    static std::map<unsigned int, Quadrature<1> > cache;
+    return cache;
+  }
+
+
+
+  // Look up the formula with @p n points in @p cache and copy it to
+  // @p quadrature_points and @p weights if it exists. Return whether
+  // this was the case.
+  bool
+  get_cached_quadrature (const std::map<unsigned int, Quadrature<1> > &cache,
+                         const unsigned int                           n,
+                         std::vector<Point<1> >                       &quadrature_points,
+                         std::vector<double>                          &weights)
+  {
+    Threads::Mutex::ScopedLock lock (quadrature_cache_mutex());
+    const auto entry = cache.find (n);
+    if (entry == cache.end())
+      return false;
+
+    quadrature_points = entry->second.get_points();
+    weights = entry->second.get_weights();
+    return true;
+  }
+
+
+
+  void
+  add_cached_quadrature (std::map<unsigned int, Quadrature<1> > &cache,
+                         const std::vector<Point<1> >           &quadrature_points,
+                         const std::vector<double>              &weights)
+  {
+    Threads::Mutex::ScopedLock lock (quadrature_cache_mutex());
+    cache.insert (std::make_pair (static_cast<unsigned int>(weights.size()),
+                                  Quadrature<1> (quadrature_points, weights)));
+  }
+}
+
+
 // please note: for a given dimension, we need the quadrature formulae
 // for all lower dimensions as well. That is why in this file the check
 // is for deal_II_dimension >= any_number and not for ==
@@ -67,6 +135,10 @@ QGauss<1>::QGauss (const unsigned int n)
   if (n == 0)
     return;
 
+  if (get_cached_quadrature (gauss_cache(), n,
+                             this->quadrature_points, this->weights))
+    return;
+
   const unsigned int m = (n+1)/2;
 
   // tolerance for the Newton
@@ -159,6 +231,8 @@ QGauss<1>::QGauss (const unsigned int n)
       this->weights[i-1] = w;
       this->weights[n-i] = w;
     }
+
+  add_cached_quadrature (gauss_cache(), this->quadrature_points, this->weights);
 }
 
 
@@ -169,6 +243,10 @@ QGaussLobatto<1>::QGaussLobatto (const unsigned int n)
 {
   Assert (n >= 2, ExcNotImplemented());
 
+  if (get_cached_quadrature (gauss_lobatto_cache(), n,
+                             this->quadrature_points, this->weights))
+    return;
+
   std::vector<long double> points  = compute_quadrature_points(n, 1, 1);
   std::vector<long double> w       = compute_quadrature_weights(points, 0, 0);
 
@@ -179,6 +257,9 @@ QGaussLobatto<1>::QGaussLobatto (const unsigned int n)
       this->quadrature_points[i] = Point<1>(0.5 + 0.5*static_cast<double>(points[i]));
       this->weights[i]           = 0.5*w[i];
     }
+
+  add_cached_quadrature (gauss_lobatto_cache(), this->quadrature_points,
+                         this->weights);
 }
 
 
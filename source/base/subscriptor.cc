@@ -144,10 +144,14 @@ Subscriptor &Subscriptor::operator = (Subscriptor &&s)
 
 
 
+#ifdef DEBUG
+
+// in release mode, subscribe() and unsubscribe() are empty inline functions
+// defined in the header file
+
 void
 Subscriptor::subscribe(const char *id) const
 {
-#ifdef DEBUG
   if (object_info == nullptr)
     object_info = &typeid(*this);
   ++counter;
@@ -166,16 +170,12 @@ Subscriptor::subscribe(const char *id) const
 #  else
   (void)id;
 #  endif
-#else
-  (void)id;
-#endif
 }
 
 
 void
 Subscriptor::unsubscribe(const char *id) const
 {
-#ifdef DEBUG
   const char *name = (id != nullptr) ? id : unknown_subscriber;
   AssertNothrow (counter>0, ExcNoSubscriber(object_info->name(), name));
   // This is for the case that we do
@@ -194,11 +194,10 @@ Subscriptor::unsubscribe(const char *id) const
 
   it->second--;
 #  endif
-#else
-  (void)id;
-#endif
 }
 
+#endif
+
 
 
 unsigned int Subscriptor::n_subscriptions () const
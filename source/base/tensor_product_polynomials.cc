@@ -15,8 +15,10 @@
 
 #include <deal.II/base/tensor_product_polynomials.h>
 #include <deal.II/base/polynomials_piecewise.h>
+#include <deal.II/base/aligned_vector.h>
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/table.h>
+#include <deal.II/base/vectorization.h>
 
 #include <boost/container/small_vector.hpp>
 #include <array>
@@ -71,6 +73,41 @@ namespace internal
       indices[1] = (n/n_pols_0) % n_pols_1;
       indices[2] = n / (n_pols_0*n_pols_1);
     }
+
+    /**
+     * Evaluate a one-dimensional polynomial and its first @p n_derivatives
+     * derivatives, at most one, at the points given by the components of @p
+     * x. The general case evaluates the points one by one.
+     */
+    template <typename PolynomialType>
+    inline
+    void evaluate_polynomial(const PolynomialType          &polynomial,
+                             const VectorizedArray<double> &x,
+                             const unsigned int             n_derivatives,
+                             VectorizedArray<double>       *values)
+    {
+      Assert (n_derivatives < 2, ExcInternalError());
+      double point_values[2];
+      for (unsigned int v=0; v<VectorizedArray<double>::n_array_elements; ++v)
+        {
+          polynomial.value(x[v], n_derivatives, point_values);
+          for (unsigned int k=0; k<=n_derivatives; ++k)
+            values[k][v] = point_values[k];
+        }
+    }
+
+    /**
+     * Same as above, but for Polynomials::Polynomial which can evaluate
+     * several points at once.
+     */
+    inline
+    void evaluate_polynomial(const Polynomials::Polynomial<double> &polynomial,
+                             const VectorizedArray<double>         &x,
+                             const unsigned int                     n_derivatives,
+                             VectorizedArray<double>               *values)
+    {
+      polynomial.value(x, n_derivatives, values);
+    }
   }
 }
 
@@ -386,6 +423,80 @@ compute (const Point<dim>            &p,
 
 
 
+template <int dim, typename PolynomialType>
+void
+TensorProductPolynomials<dim,PolynomialType>::
+compute (const std::vector<Point<dim> > &unit_points,
+         Table<2,double>                &values,
+         Table<2,Tensor<1,dim> >        &grads) const
+{
+  Assert(dim<=3, ExcNotImplemented());
+  const unsigned int n_points = unit_points.size();
+  Assert ((values.n_rows()==n_tensor_pols && values.n_cols()==n_points) ||
+          values.n_elements()==0,
+          ExcDimensionMismatch2(values.n_rows(), n_tensor_pols, 0));
+  Assert ((grads.n_rows()==n_tensor_pols && grads.n_cols()==n_points) ||
+          grads.n_elements()==0,
+          ExcDimensionMismatch2(grads.n_rows(), n_tensor_pols, 0));
+
+  const bool update_values = (values.n_elements() > 0),
+             update_grads  = (grads.n_elements() > 0);
+  if (update_values == false && update_grads == false)
+    return;
+  const unsigned int n_derivatives = update_grads ? 1 : 0;
+
+  // Evaluate the 1D polynomials with one point per component of
+  // VectorizedArray, padding the last batch with the first point of the
+  // batch, and then form the tensor products like in the function above
+  const unsigned int n_lanes = VectorizedArray<double>::n_array_elements;
+  const unsigned int n_polynomials = polynomials.size();
+  AlignedVector<VectorizedArray<double> > values_1d(n_polynomials*dim*2);
+  for (unsigned int q0=0; q0<n_points; q0+=n_lanes)
+    {
+      const unsigned int n_filled = std::min(n_points-q0, n_lanes);
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          VectorizedArray<double> x;
+          for (unsigned int v=0; v<n_lanes; ++v)
+            x[v] = unit_points[q0+(v<n_filled ? v : 0)][d];
+          for (unsigned int i=0; i<n_polynomials; ++i)
+            internal::evaluate_polynomial(polynomials[i], x, n_derivatives,
+                                          &values_1d[(i*dim+d)*2]);
+        }
+
+      unsigned int indices[3];
+      unsigned int ind=0;
+      for (indices[2]=0; indices[2]<(dim>2?n_polynomials:1); ++indices[2])
+        for (indices[1]=0; indices[1]<(dim>1?n_polynomials:1); ++indices[1])
+          for (indices[0]=0; indices[0]<n_polynomials; ++indices[0], ++ind)
+            {
+              const unsigned int i = index_map_inverse[ind];
+
+              if (update_values)
+                {
+                  VectorizedArray<double> value = values_1d[indices[0]*dim*2];
+                  for (unsigned int x=1; x<dim; ++x)
+                    value *= values_1d[(indices[x]*dim+x)*2];
+                  for (unsigned int v=0; v<n_filled; ++v)
+                    values(i,q0+v) = value[v];
+                }
+
+              if (update_grads)
+                for (unsigned int d=0; d<dim; ++d)
+                  {
+                    VectorizedArray<double> grad = values_1d[indices[0]*dim*2+(d==0)];
+                    for (unsigned int x=1; x<dim; ++x)
+                      grad *= values_1d[(indices[x]*dim+x)*2+(d==x)];
+                    for (unsigned int v=0; v<n_filled; ++v)
+                      grads(i,q0+v)[d] = grad[v];
+                  }
+            }
+    }
+}
+
+
+
+
 /* ------------------- AnisotropicPolynomials -------------- */
 
 
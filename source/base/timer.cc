@@ -13,6 +13,7 @@
 //
 // ---------------------------------------------------------------------
 
+#include <deal.II/base/event_trace.h>
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/mpi.h>
 #include <deal.II/base/signaling_nan.h>
@@ -22,6 +23,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <iomanip>
 #include <map>
@@ -37,6 +39,17 @@
 #  include <windows.h>
 #endif
 
+#if defined(__linux__) && defined(__has_include)
+#  if __has_include(<linux/perf_event.h>)
+#    define DEAL_II_TIMER_HAVE_PERF_EVENT
+#    include <linux/perf_event.h>
+#    include <sys/ioctl.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#    include <cstring>
+#  endif
+#endif
+
 
 
 DEAL_II_NAMESPACE_OPEN
@@ -291,6 +304,174 @@ void Timer::reset ()
 
 
 
+namespace internal
+{
+  namespace TimerOutputImplementation
+  {
+    /**
+     * The indices of the counters in the arrays stored for each section.
+     */
+    enum CounterIndex
+    {
+      cycle_counter = 0,
+      instruction_counter = 1,
+      cache_miss_counter = 2,
+      flop_counter = 3
+    };
+
+    /**
+     * The number of bytes transferred from memory for each miss in the
+     * last level cache.
+     */
+    const double cache_line_size = 64.;
+
+
+
+    /**
+     * A group of hardware performance counters of the calling thread, read
+     * through the perf_event interface of the Linux kernel.
+     */
+    class PerformanceCounters
+    {
+    public:
+      /**
+       * Constructor. Open the counters. If @p raw_flop_event is zero, no
+       * floating point operations are counted.
+       */
+      PerformanceCounters (const unsigned long long raw_flop_event,
+                           const double             flops_per_event);
+
+      /**
+       * Destructor. Close the counters.
+       */
+      ~PerformanceCounters ();
+
+      /**
+       * Return whether at least the cycle counter could be opened.
+       */
+      bool is_available () const;
+
+      /**
+       * Return whether the floating point operations are counted.
+       */
+      bool counts_flops () const;
+
+      /**
+       * Return the current values of all counters, with zero for the ones
+       * that could not be opened.
+       */
+      std::array<double,4> read () const;
+
+    private:
+      /**
+       * The file descriptors of the counters, or -1 for counters that could
+       * not be opened.
+       */
+      std::array<int,4> file_descriptors;
+
+      /**
+       * The number of floating point operations per event of the flop
+       * counter.
+       */
+      const double flops_per_event;
+    };
+
+
+
+#ifdef DEAL_II_TIMER_HAVE_PERF_EVENT
+    namespace
+    {
+      int open_counter (const unsigned int       type,
+                        const unsigned long long config)
+      {
+        struct perf_event_attr attributes;
+        std::memset (&attributes, 0, sizeof(attributes));
+        attributes.type           = type;
+        attributes.size           = sizeof(attributes);
+        attributes.config         = config;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv     = 1;
+
+        // measure the calling thread on any cpu
+        return syscall (__NR_perf_event_open, &attributes, 0, -1, -1, 0);
+      }
+    }
+#endif
+
+
+
+    PerformanceCounters::PerformanceCounters (const unsigned long long raw_flop_event,
+                                              const double             flops_per_event)
+      :
+      flops_per_event (flops_per_event)
+    {
+      file_descriptors.fill (-1);
+#ifdef DEAL_II_TIMER_HAVE_PERF_EVENT
+      file_descriptors[cycle_counter]
+        = open_counter (PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+      file_descriptors[instruction_counter]
+        = open_counter (PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+      file_descriptors[cache_miss_counter]
+        = open_counter (PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+      if (raw_flop_event != 0)
+        file_descriptors[flop_counter]
+          = open_counter (PERF_TYPE_RAW, raw_flop_event);
+#else
+      (void)raw_flop_event;
+#endif
+    }
+
+
+
+    PerformanceCounters::~PerformanceCounters ()
+    {
+#ifdef DEAL_II_TIMER_HAVE_PERF_EVENT
+      for (unsigned int i=0; i<file_descriptors.size(); ++i)
+        if (file_descriptors[i] >= 0)
+          close (file_descriptors[i]);
+#endif
+    }
+
+
+
+    bool
+    PerformanceCounters::is_available () const
+    {
+      return file_descriptors[cycle_counter] >= 0;
+    }
+
+
+
+    bool
+    PerformanceCounters::counts_flops () const
+    {
+      return file_descriptors[flop_counter] >= 0;
+    }
+
+
+
+    std::array<double,4>
+    PerformanceCounters::read () const
+    {
+      std::array<double,4> values;
+      values.fill (0.);
+#ifdef DEAL_II_TIMER_HAVE_PERF_EVENT
+      for (unsigned int i=0; i<file_descriptors.size(); ++i)
+        if (file_descriptors[i] >= 0)
+          {
+            std::uint64_t count = 0;
+            if (::read (file_descriptors[i], &count, sizeof(count)) == sizeof(count))
+              values[i] = count;
+          }
+#endif
+      values[flop_counter] *= flops_per_event;
+      return values;
+    }
+  }
+}
+
+
+
 /* ---------------------------- TimerOutput -------------------------- */
 
 TimerOutput::TimerOutput (std::ostream &stream,
@@ -359,7 +540,10 @@ TimerOutput::~TimerOutput()
 
   if ( (output_frequency == summary || output_frequency == every_call_and_summary)
        && output_is_enabled == true)
-    print_summary();
+    {
+      print_summary();
+      print_performance_counter_summary();
+    }
 }
 
 
@@ -395,8 +579,18 @@ TimerOutput::enter_subsection (const std::string &section_name)
       sections[section_name].total_cpu_time = 0;
       sections[section_name].total_wall_time = 0;
       sections[section_name].n_calls = 0;
+      sections[section_name].parent = (active_sections.empty() ?
+                                       std::string() :
+                                       active_sections.back());
+      sections[section_name].total_counters.fill (0.);
     }
 
+  if (performance_counters)
+    sections[section_name].counters_at_entry = performance_counters->read();
+
+  sections[section_name].trace_begin_time = (EventTrace::is_enabled() ?
+                                              EventTrace::now() : 0);
+
   sections[section_name].timer.reset();
   sections[section_name].timer.start();
   sections[section_name].n_calls++;
@@ -440,6 +634,19 @@ TimerOutput::leave_subsection (const std::string &section_name)
   const double cpu_time = sections[actual_section_name].timer.last_cpu_time();
   sections[actual_section_name].total_cpu_time += cpu_time;
 
+  if (performance_counters)
+    {
+      const std::array<double,4> counters = performance_counters->read();
+      Section &section = sections[actual_section_name];
+      for (unsigned int i=0; i<counters.size(); ++i)
+        section.total_counters[i] += counters[i] - section.counters_at_entry[i];
+    }
+
+  if (sections[actual_section_name].trace_begin_time != 0)
+    EventTrace::record (EventTrace::intern (actual_section_name), "TimerOutput",
+                        sections[actual_section_name].trace_begin_time,
+                        EventTrace::now());
+
   // in case we have to print out something, do that here...
   if ((output_frequency == every_call || output_frequency == every_call_and_summary)
       && output_is_enabled == true)
@@ -485,6 +692,22 @@ TimerOutput::get_summary_data (const OutputData kind) const
         case TimerOutput::OutputData::n_calls:
           output[section.first] = section.second.n_calls;
           break;
+        case TimerOutput::OutputData::cycles:
+          output[section.first] = section.second.total_counters
+                                  [internal::TimerOutputImplementation::cycle_counter];
+          break;
+        case TimerOutput::OutputData::instructions:
+          output[section.first] = section.second.total_counters
+                                  [internal::TimerOutputImplementation::instruction_counter];
+          break;
+        case TimerOutput::OutputData::cache_misses:
+          output[section.first] = section.second.total_counters
+                                  [internal::TimerOutputImplementation::cache_miss_counter];
+          break;
+        case TimerOutput::OutputData::floating_point_operations:
+          output[section.first] = section.second.total_counters
+                                  [internal::TimerOutputImplementation::flop_counter];
+          break;
         default:
           Assert(false, ExcNotImplemented());
         }
@@ -663,6 +886,186 @@ TimerOutput::print_summary () const
 
 
 
+void
+TimerOutput::print_wall_time_statistics (const MPI_Comm mpi_comm) const
+{
+  const std::istream::fmtflags old_flags = out_stream.get_stream().flags();
+  const std::streamsize    old_precision = out_stream.get_stream().precision ();
+  const std::streamsize    old_width     = out_stream.get_stream().width ();
+
+  out_stream << "\n\n"
+             << "+---------------------------------+-----------+"
+             << "------------+------+------------+------------+------+\n"
+             << "| Section                         | no. calls |"
+             << "   min time | rank |   avg time |   max time | rank |\n"
+             << "+---------------------------------+-----------+"
+             << "------------+------+------------+------------+------+";
+  for (std::map<std::string, Section>::const_iterator
+       i = sections.begin(); i!=sections.end(); ++i)
+    {
+      const Utilities::MPI::MinMaxAvg data
+        = Utilities::MPI::min_max_avg (i->second.total_wall_time, mpi_comm);
+
+      std::string name_out = i->first;
+      unsigned int pos_non_space = name_out.find_first_not_of (' ');
+      name_out.erase(0, pos_non_space);
+      name_out.resize (32, ' ');
+      out_stream << std::endl;
+      out_stream << "| " << name_out;
+      out_stream << "| " << std::setw(9) << i->second.n_calls << " |";
+      out_stream << std::setprecision(3) << std::right;
+      out_stream << std::setw(10) << data.min << "s |";
+      out_stream << std::setw(5) << data.min_index << " |";
+      out_stream << std::setw(10) << data.avg << "s |";
+      out_stream << std::setw(10) << data.max << "s |";
+      out_stream << std::setw(5) << data.max_index << " |";
+    }
+  out_stream << std::endl
+             << "+---------------------------------+-----------+"
+             << "------------+------+------------+------------+------+\n"
+             << std::endl;
+
+  out_stream.get_stream().precision (old_precision);
+  out_stream.get_stream().width (old_width);
+  out_stream.get_stream().flags (old_flags);
+}
+
+
+
+bool
+TimerOutput::enable_performance_counters (const unsigned long long raw_flop_event,
+                                          const double             flops_per_event)
+{
+  Threads::Mutex::ScopedLock lock (mutex);
+
+  Assert (active_sections.empty(),
+          ExcMessage ("Performance counters can only be enabled while no "
+                      "section is active."));
+
+  performance_counters.reset
+  (new internal::TimerOutputImplementation::PerformanceCounters (raw_flop_event,
+      flops_per_event));
+  if (performance_counters->is_available() == false)
+    performance_counters.reset ();
+
+  return performance_counters != nullptr;
+}
+
+
+
+void
+TimerOutput::print_performance_counter_summary () const
+{
+  using namespace internal::TimerOutputImplementation;
+
+  if (!performance_counters)
+    return;
+
+  // sort the sections into a tree by their parents, and collect them in
+  // depth-first order along with their nesting depth
+  std::map<std::string, std::vector<std::string> > children;
+  for (std::map<std::string, Section>::const_iterator
+       i = sections.begin(); i!=sections.end(); ++i)
+    {
+      const bool parent_exists = (i->second.parent.empty() == false &&
+                                  sections.find(i->second.parent) != sections.end());
+      children[parent_exists ? i->second.parent : std::string()].push_back (i->first);
+    }
+
+  std::vector<std::pair<std::string, unsigned int> > ordered_sections;
+  std::vector<std::pair<std::string, unsigned int> > stack;
+  const std::vector<std::string> &roots = children[std::string()];
+  for (std::vector<std::string>::const_reverse_iterator r=roots.rbegin();
+       r!=roots.rend(); ++r)
+    stack.push_back (std::make_pair (*r, 0U));
+  while (stack.empty() == false)
+    {
+      const std::pair<std::string, unsigned int> current = stack.back();
+      stack.pop_back ();
+      ordered_sections.push_back (current);
+
+      std::map<std::string, std::vector<std::string> >::const_iterator
+      c = children.find (current.first);
+      if (c != children.end())
+        for (std::vector<std::string>::const_reverse_iterator r=c->second.rbegin();
+             r!=c->second.rend(); ++r)
+          stack.push_back (std::make_pair (*r, current.second+1));
+    }
+
+  // accumulate the counters over all processors and take the maximal wall
+  // time, all in one reduction each
+  const unsigned int n_sections = ordered_sections.size();
+  std::vector<double> counters (4*n_sections), wall_times (n_sections);
+  for (unsigned int s=0; s<n_sections; ++s)
+    {
+      const Section &section = sections.find(ordered_sections[s].first)->second;
+      for (unsigned int i=0; i<4; ++i)
+        counters[4*s+i] = section.total_counters[i];
+      wall_times[s] = section.total_wall_time;
+    }
+  Utilities::MPI::sum (counters, mpi_communicator, counters);
+  Utilities::MPI::max (wall_times, mpi_communicator, wall_times);
+
+  const std::istream::fmtflags old_flags = out_stream.get_stream().flags();
+  const std::streamsize    old_precision = out_stream.get_stream().precision ();
+  const std::streamsize    old_width     = out_stream.get_stream().width ();
+
+  out_stream << "\n\n"
+             << "+---------------------------------+-----------+------------"
+             << "+------------+------------+------------+\n"
+             << "| Section                         | no. calls |  wall time "
+             << "|    GFLOP/s |  est. GB/s |        IPC |\n"
+             << "+---------------------------------+-----------+------------"
+             << "+------------+------------+------------+";
+  for (unsigned int s=0; s<n_sections; ++s)
+    {
+      const Section &section = sections.find(ordered_sections[s].first)->second;
+      const double wall_time = wall_times[s];
+
+      std::string name_out = ordered_sections[s].first;
+      unsigned int pos_non_space = name_out.find_first_not_of (' ');
+      name_out.erase(0, pos_non_space);
+      name_out.insert (0, 2*ordered_sections[s].second, ' ');
+      name_out.resize (32, ' ');
+      out_stream << std::endl;
+      out_stream << "| " << name_out;
+      out_stream << "| " << std::setw(9) << section.n_calls << " |";
+      out_stream << std::setprecision(3) << std::right;
+      out_stream << std::setw(10) << wall_time << "s |";
+
+      out_stream << std::setw(11);
+      if (performance_counters->counts_flops() && wall_time > 0)
+        out_stream << counters[4*s+flop_counter] / wall_time * 1e-9;
+      else
+        out_stream << "-";
+      out_stream << " |";
+
+      out_stream << std::setw(11);
+      if (wall_time > 0)
+        out_stream << counters[4*s+cache_miss_counter] * cache_line_size / wall_time * 1e-9;
+      else
+        out_stream << "-";
+      out_stream << " |";
+
+      out_stream << std::setw(11);
+      if (counters[4*s+cycle_counter] > 0)
+        out_stream << counters[4*s+instruction_counter] / counters[4*s+cycle_counter];
+      else
+        out_stream << "-";
+      out_stream << " |";
+    }
+  out_stream << std::endl
+             << "+---------------------------------+-----------+------------"
+             << "+------------+------------+------------+\n"
+             << std::endl;
+
+  out_stream.get_stream().precision (old_precision);
+  out_stream.get_stream().width (old_width);
+  out_stream.get_stream().flags (old_flags);
+}
+
+
+
 void
 TimerOutput::disable_output ()
 {
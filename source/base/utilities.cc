@@ -52,6 +52,10 @@ DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
 
 #ifndef DEAL_II_MSVC
 #  include <stdlib.h>
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
 #endif
 
 
@@ -721,6 +725,79 @@ namespace Utilities
 
 
 
+    MemoryMappedFile::MemoryMappedFile (const std::string &filename)
+      :
+      file_data (nullptr),
+      file_size (0)
+    {
+#ifndef DEAL_II_MSVC
+      const int fd = ::open (filename.c_str(), O_RDONLY);
+      AssertThrow (fd != -1, ExcIO());
+
+      struct stat file_status;
+      const int ierr = ::fstat (fd, &file_status);
+      if (ierr != 0)
+        {
+          ::close (fd);
+          AssertThrow (false, ExcIO());
+        }
+      file_size = file_status.st_size;
+
+      if (file_size > 0)
+        {
+          void *ptr = ::mmap (nullptr, file_size, PROT_READ, MAP_PRIVATE,
+                              fd, 0);
+          ::close (fd);
+          AssertThrow (ptr != MAP_FAILED, ExcIO());
+#  ifdef MADV_SEQUENTIAL
+          // only a hint to read ahead, so ignore the return value
+          ::madvise (ptr, file_size, MADV_SEQUENTIAL);
+#  endif
+          file_data = static_cast<const char *>(ptr);
+        }
+      else
+        ::close (fd);
+#else
+      std::ifstream in (filename.c_str(), std::ios::binary);
+      AssertThrow (in, ExcIO());
+      in.seekg (0, std::ios::end);
+      file_size = in.tellg();
+      in.seekg (0, std::ios::beg);
+      buffer.resize (file_size);
+      in.read (buffer.data(), file_size);
+      AssertThrow (in, ExcIO());
+      file_data = buffer.data();
+#endif
+    }
+
+
+
+    MemoryMappedFile::~MemoryMappedFile ()
+    {
+#ifndef DEAL_II_MSVC
+      if (file_data != nullptr)
+        ::munmap (const_cast<char *>(file_data), file_size);
+#endif
+    }
+
+
+
+    const char *
+    MemoryMappedFile::data () const
+    {
+      return file_data;
+    }
+
+
+
+    std::size_t
+    MemoryMappedFile::size () const
+    {
+      return file_size;
+    }
+
+
+
     bool job_supports_mpi ()
     {
       return Utilities::MPI::job_supports_mpi();
@@ -0,0 +1,290 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/config.h>
+
+#ifdef DEAL_II_WITH_ADOLC
+
+#include <deal.II/differentiation/ad/adolc_taped_function.h>
+
+DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
+#include <adolc/drivers/drivers.h>
+#include <adolc/taping.h>
+DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
+
+#include <limits>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace Differentiation
+{
+  namespace AD
+  {
+    namespace
+    {
+      // Adol-C keeps the information on all tapes in global state, so the
+      // allocation of tape indices and the recording of tapes are done
+      // while holding this mutex
+      Threads::Mutex tape_mutex;
+
+      unsigned int next_tape_index = 1000;
+    }
+
+
+
+    TapedFunction::Tape::Tape ()
+      :
+      index (-1)
+    {}
+
+
+
+    TapedFunction::TapedFunction (const unsigned int      n_independent_variables,
+                                  const unsigned int      n_dependent_variables,
+                                  const RecordedFunction &function)
+      :
+      n_independent (n_independent_variables),
+      n_dependent (n_dependent_variables),
+      function (function),
+      recording_count (0)
+    {
+      Assert (n_independent > 0, ExcZero());
+      Assert (n_dependent > 0, ExcZero());
+      Assert (function, ExcMessage ("The function to be recorded is empty."));
+    }
+
+
+
+    TapedFunction::~TapedFunction ()
+    {
+      Threads::Mutex::ScopedLock lock (tape_mutex);
+      for (const short index : tape_indices)
+        removeTape (index, ADOLC_REMOVE_COMPLETELY);
+    }
+
+
+
+    void
+    TapedFunction::set_first_tape_index (const unsigned int index)
+    {
+      Assert (index <= static_cast<unsigned int>(std::numeric_limits<short>::max()),
+              ExcIndexRange (index, 0, std::numeric_limits<short>::max()+1));
+
+      Threads::Mutex::ScopedLock lock (tape_mutex);
+      next_tape_index = index;
+    }
+
+
+
+    unsigned int
+    TapedFunction::n_recordings () const
+    {
+      Threads::Mutex::ScopedLock lock (tape_mutex);
+      return recording_count;
+    }
+
+
+
+    void
+    TapedFunction::record (const short                index,
+                           const std::vector<double> &x) const
+    {
+      Threads::Mutex::ScopedLock lock (tape_mutex);
+
+      std::vector<adouble> independent_variables (n_independent);
+      std::vector<adouble> dependent_variables (n_dependent);
+      std::vector<double> values (n_dependent);
+
+      trace_on (index);
+      for (unsigned int i=0; i<n_independent; ++i)
+        independent_variables[i] <<= x[i];
+      function (independent_variables, dependent_variables);
+      AssertDimension (dependent_variables.size(), n_dependent);
+      for (unsigned int i=0; i<n_dependent; ++i)
+        dependent_variables[i] >>= values[i];
+      trace_off ();
+
+      ++recording_count;
+    }
+
+
+
+    short
+    TapedFunction::get_tape (const std::vector<double> &x) const
+    {
+      Tape &tape = tapes.get();
+      if (tape.index < 0)
+        {
+          {
+            Threads::Mutex::ScopedLock lock (tape_mutex);
+            AssertThrow (next_tape_index <=
+                         static_cast<unsigned int>(std::numeric_limits<short>::max()),
+                         ExcMessage ("All tape indices of Adol-C are in use."));
+            tape.index = next_tape_index++;
+            tape_indices.push_back (tape.index);
+          }
+          record (tape.index, x);
+        }
+      return tape.index;
+    }
+
+
+
+    void
+    TapedFunction::evaluate (const std::vector<double>         &x,
+                             const std::function<int (short)>  &driver,
+                             const char                        *driver_name) const
+    {
+      AssertDimension (x.size(), n_independent);
+
+      const short index = get_tape (x);
+      int return_value = driver (index);
+
+      // a negative return value indicates that the sequence of operations
+      // at x differs from the recorded one, so record the tape anew at x
+      if (return_value < 0)
+        {
+          record (index, x);
+          return_value = driver (index);
+          AssertThrow (return_value >= 0,
+                       ExcAdolCDriverFailed (driver_name, return_value));
+        }
+    }
+
+
+
+    void
+    TapedFunction::value (const std::vector<double> &x,
+                          std::vector<double>       &values) const
+    {
+      values.resize (n_dependent);
+      evaluate (x, [&](const short index)
+      {
+        return ::function (index, n_dependent, n_independent,
+                           const_cast<double *>(x.data()), values.data());
+      },
+      "function");
+    }
+
+
+
+    void
+    TapedFunction::gradient (const std::vector<double> &x,
+                             std::vector<double>       &gradient) const
+    {
+      Assert (n_dependent == 1,
+              ExcMessage ("The gradient can only be computed for functions "
+                          "with a single dependent variable."));
+
+      gradient.resize (n_independent);
+      evaluate (x, [&](const short index)
+      {
+        return ::gradient (index, n_independent,
+                           const_cast<double *>(x.data()), gradient.data());
+      },
+      "gradient");
+    }
+
+
+
+    void
+    TapedFunction::hessian (const std::vector<double> &x,
+                            FullMatrix<double>        &hessian) const
+    {
+      Assert (n_dependent == 1,
+              ExcMessage ("The Hessian can only be computed for functions "
+                          "with a single dependent variable."));
+
+      hessian.reinit (n_independent, n_independent);
+      std::vector<double *> &rows = row_pointers.get();
+      rows.resize (n_independent);
+      for (unsigned int i=0; i<n_independent; ++i)
+        rows[i] = &hessian(i,0);
+
+      evaluate (x, [&](const short index)
+      {
+        return ::hessian (index, n_independent,
+                          const_cast<double *>(x.data()), rows.data());
+      },
+      "hessian");
+
+      // the driver only fills the lower triangle
+      for (unsigned int i=0; i<n_independent; ++i)
+        for (unsigned int j=i+1; j<n_independent; ++j)
+          hessian(i,j) = hessian(j,i);
+    }
+
+
+
+    void
+    TapedFunction::jacobian (const std::vector<double> &x,
+                             FullMatrix<double>        &jacobian) const
+    {
+      jacobian.reinit (n_dependent, n_independent);
+      std::vector<double *> &rows = row_pointers.get();
+      rows.resize (n_dependent);
+      for (unsigned int i=0; i<n_dependent; ++i)
+        rows[i] = &jacobian(i,0);
+
+      evaluate (x, [&](const short index)
+      {
+        return ::jacobian (index, n_dependent, n_independent,
+                           const_cast<double *>(x.data()), rows.data());
+      },
+      "jacobian");
+    }
+
+
+
+    void
+    TapedFunction::gradients (const std::vector<std::vector<double> > &x,
+                              std::vector<std::vector<double> >       &gradients) const
+    {
+      gradients.resize (x.size());
+      for (unsigned int q=0; q<x.size(); ++q)
+        gradient (x[q], gradients[q]);
+    }
+
+
+
+    void
+    TapedFunction::hessians (const std::vector<std::vector<double> > &x,
+                             std::vector<FullMatrix<double> >        &hessians) const
+    {
+      hessians.resize (x.size());
+      for (unsigned int q=0; q<x.size(); ++q)
+        hessian (x[q], hessians[q]);
+    }
+
+
+
+    void
+    TapedFunction::jacobians (const std::vector<std::vector<double> > &x,
+                              std::vector<FullMatrix<double> >        &jacobians) const
+    {
+      jacobians.resize (x.size());
+      for (unsigned int q=0; q<x.size(); ++q)
+        jacobian (x[q], jacobians[q]);
+    }
+
+  } // namespace AD
+} // namespace Differentiation
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
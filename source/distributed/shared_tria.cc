@@ -54,6 +54,28 @@ namespace parallel
 
 
 
+    template <int dim, int spacedim>
+    std::vector<unsigned int>
+    Triangulation<dim,spacedim>::get_cell_weights () const
+    {
+      // if nobody is connected to the signal, all cells have the same
+      // weight, which is what an empty vector indicates to the partitioner
+      if (this->signals.cell_weight.num_slots() == 0)
+        return std::vector<unsigned int>();
+
+      // otherwise use the same convention as
+      // parallel::distributed::Triangulation, i.e., every cell has a base
+      // weight of 1000 to which the return values of the slots are added
+      std::vector<unsigned int> weights (this->n_active_cells());
+      for (const auto &cell : this->active_cell_iterators())
+        weights[cell->active_cell_index()]
+          = 1000 + this->signals.cell_weight (cell,
+                                              dealii::Triangulation<dim,spacedim>::CELL_PERSIST);
+      return weights;
+    }
+
+
+
     template <int dim, int spacedim>
     void Triangulation<dim,spacedim>::partition()
     {
@@ -71,7 +93,26 @@ namespace parallel
 
       if (settings & partition_metis)
         {
-          dealii::GridTools::partition_triangulation (this->n_subdomains, *this);
+          // all processors store the same mesh and would compute the same
+          // partitioning, so let only the first one call METIS and send the
+          // resulting subdomain ids to all others
+          std::vector<types::subdomain_id> subdomain_ids (this->n_active_cells());
+          if (this->my_subdomain == 0)
+            {
+              dealii::GridTools::partition_triangulation (this->n_subdomains,
+                                                          get_cell_weights(),
+                                                          *this);
+              for (const auto &cell : this->active_cell_iterators())
+                subdomain_ids[cell->active_cell_index()] = cell->subdomain_id();
+            }
+
+          const int ierr = MPI_Bcast (subdomain_ids.data(), subdomain_ids.size(),
+                                      MPI_UNSIGNED, 0, this->get_communicator());
+          AssertThrowMPI (ierr);
+
+          if (this->my_subdomain != 0)
+            for (const auto &cell : this->active_cell_iterators())
+              cell->set_subdomain_id (subdomain_ids[cell->active_cell_index()]);
         }
       else if (settings & partition_zorder)
         {
@@ -211,13 +211,14 @@ namespace parallel
       typename DoFHandlerType::cell_iterator cell(*cell_, dof_handler);
 
       const unsigned int dofs_per_cell=cell->get_fe().dofs_per_cell;
-      ::dealii::Vector<typename VectorType::value_type> dofvalues(dofs_per_cell);
+      if (dof_values.size() != dofs_per_cell)
+        dof_values.reinit(dofs_per_cell, true);
       for (typename std::vector<const VectorType *>::iterator it=input_vectors.begin();
            it !=input_vectors.end();
            ++it)
         {
-          cell->get_interpolated_dof_values(*(*it), dofvalues);
-          std::memcpy(data_store, &dofvalues(0), sizeof(typename VectorType::value_type)*dofs_per_cell);
+          cell->get_interpolated_dof_values(*(*it), dof_values);
+          std::memcpy(data_store, &dof_values(0), sizeof(typename VectorType::value_type)*dofs_per_cell);
           data_store += dofs_per_cell;
         }
     }
@@ -235,15 +236,16 @@ namespace parallel
       cell(*cell_, dof_handler);
 
       const unsigned int dofs_per_cell=cell->get_fe().dofs_per_cell;
-      ::dealii::Vector<typename VectorType::value_type> dofvalues(dofs_per_cell);
+      if (dof_values.size() != dofs_per_cell)
+        dof_values.reinit(dofs_per_cell, true);
       const typename VectorType::value_type *data_store = reinterpret_cast<const typename VectorType::value_type *>(data);
 
       for (typename std::vector<VectorType *>::iterator it = all_out.begin();
            it != all_out.end();
            ++it)
         {
-          std::memcpy(&dofvalues(0), data_store, sizeof(typename VectorType::value_type)*dofs_per_cell);
-          cell->set_dof_values_by_interpolation(dofvalues, *(*it));
+          std::memcpy(&dof_values(0), data_store, sizeof(typename VectorType::value_type)*dofs_per_cell);
+          cell->set_dof_values_by_interpolation(dof_values, *(*it));
           data_store += dofs_per_cell;
         }
     }
@@ -27,6 +27,9 @@
 #include <deal.II/distributed/p4est_wrappers.h>
 
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
 #include <numeric>
 #include <iostream>
 #include <fstream>
@@ -431,14 +434,22 @@ namespace
   }
 
 
+  /**
+   * Set the refine and coarsen flags of the cells rooted in @p dealii_cell
+   * such that they match the local part of the p4est tree, and set the
+   * subdomain ids of the cells that already match. Return whether all cells
+   * match already, i.e., whether no flag had to be set.
+   */
   template <int dim, int spacedim>
-  void
+  bool
   match_tree_recursively (const typename internal::p4est::types<dim>::tree     &tree,
                           const typename Triangulation<dim,spacedim>::cell_iterator     &dealii_cell,
                           const typename internal::p4est::types<dim>::quadrant &p4est_cell,
                           const typename internal::p4est::types<dim>::forest   &forest,
                           const types::subdomain_id                           my_subdomain)
   {
+    bool matches = true;
+
     // check if this cell exists in the local p4est cell
     if (sc_array_bsearch(const_cast<sc_array_t *>(&tree.quadrants),
                          &p4est_cell,
@@ -449,6 +460,8 @@ namespace
         delete_all_children<dim,spacedim> (dealii_cell);
         if (!dealii_cell->has_children())
           dealii_cell->set_subdomain_id(my_subdomain);
+        else
+          matches = false;
       }
     else
       {
@@ -458,7 +471,10 @@ namespace
         // already have children then loop over all children and see if they
         // are locally available as well
         if (dealii_cell->has_children () == false)
-          dealii_cell->set_refine_flag ();
+          {
+            dealii_cell->set_refine_flag ();
+            matches = false;
+          }
         else
           {
             typename internal::p4est::types<dim>::quadrant
@@ -496,19 +512,24 @@ namespace
                   delete_all_children<dim,spacedim> (dealii_cell->child(c));
                   dealii_cell->child(c)
                   ->recursively_set_subdomain_id(numbers::artificial_subdomain_id);
+                  if (dealii_cell->child(c)->has_children())
+                    matches = false;
                 }
               else
                 {
                   // at least some part of the tree rooted in this child is
                   // locally available
-                  match_tree_recursively<dim,spacedim> (tree,
-                                                        dealii_cell->child(c),
-                                                        p4est_child[c],
-                                                        forest,
-                                                        my_subdomain);
+                  if (!match_tree_recursively<dim,spacedim> (tree,
+                                                             dealii_cell->child(c),
+                                                             p4est_child[c],
+                                                             forest,
+                                                             my_subdomain))
+                    matches = false;
                 }
           }
       }
+
+    return matches;
   }
 
 
@@ -548,6 +569,50 @@ namespace
 
 
 
+  /**
+   * Call all functions registered with register_data_attach_variable() for
+   * the given cell and concatenate the CellStatus, the sizes of the data
+   * packed by the individual functions, and the data itself.
+   */
+  template <int dim, int spacedim>
+  std::vector<char>
+  pack_variable_data (const typename Triangulation<dim,spacedim>::cell_iterator &dealii_cell,
+                      const typename parallel::distributed::Triangulation<dim,spacedim>::CellStatus status,
+                      const typename std::vector<typename std::function<
+                      std::vector<char>(typename parallel::distributed::Triangulation<dim,spacedim>::cell_iterator,
+                                        typename parallel::distributed::Triangulation<dim,spacedim>::CellStatus)
+                      > > &variable_data_pack_callbacks)
+  {
+    typedef typename parallel::distributed::Triangulation<dim,spacedim>::CellStatus CellStatus;
+
+    const unsigned int n_objects = variable_data_pack_callbacks.size();
+    std::vector<std::vector<char> > object_data (n_objects);
+    std::size_t size = sizeof(CellStatus) + n_objects * sizeof(unsigned int);
+    for (unsigned int i=0; i<n_objects; ++i)
+      {
+        object_data[i] = variable_data_pack_callbacks[i] (dealii_cell, status);
+        size += object_data[i].size();
+      }
+
+    std::vector<char> data (size);
+    char *ptr = data.data();
+    std::memcpy (ptr, &status, sizeof(CellStatus));
+    ptr += sizeof(CellStatus);
+    for (unsigned int i=0; i<n_objects; ++i)
+      {
+        const unsigned int object_size = object_data[i].size();
+        std::memcpy (ptr, &object_size, sizeof(unsigned int));
+        ptr += sizeof(unsigned int);
+      }
+    for (unsigned int i=0; i<n_objects; ++i)
+      ptr = std::copy (object_data[i].begin(), object_data[i].end(), ptr);
+    Assert (ptr == data.data()+size, ExcInternalError());
+
+    return data;
+  }
+
+
+
   template <int dim, int spacedim>
   void
   attach_mesh_data_recursively (const typename internal::p4est::types<dim>::tree &tree,
@@ -557,7 +622,12 @@ namespace
                                 void(typename parallel::distributed::Triangulation<dim,spacedim>::cell_iterator,
                                      typename parallel::distributed::Triangulation<dim,spacedim>::CellStatus,
                                      void *)
-                                > > > &attached_data_pack_callbacks)
+                                > > > &attached_data_pack_callbacks,
+                                const typename std::vector<typename std::function<
+                                std::vector<char>(typename parallel::distributed::Triangulation<dim,spacedim>::cell_iterator,
+                                                  typename parallel::distributed::Triangulation<dim,spacedim>::CellStatus)
+                                > > &variable_data_pack_callbacks,
+                                std::vector<std::vector<char> > &variable_data)
   {
     typedef std::list<std::pair<unsigned int, typename std::function<
     void(typename parallel::distributed::Triangulation<dim,spacedim>::cell_iterator,
@@ -604,7 +674,9 @@ namespace
             attach_mesh_data_recursively<dim,spacedim> (tree,
                                                         dealii_cell->child(c),
                                                         p4est_child[c],
-                                                        attached_data_pack_callbacks);
+                                                        attached_data_pack_callbacks,
+                                                        variable_data_pack_callbacks,
+                                                        variable_data);
           }
       }
     else if (!p4est_has_children && !dealii_cell->has_children())
@@ -625,6 +697,12 @@ namespace
                            parallel::distributed::Triangulation<dim,spacedim>::CELL_PERSIST,
                            ptr);
           }
+
+        if (variable_data_pack_callbacks.size() > 0)
+          variable_data[tree.quadrants_offset + idx]
+            = pack_variable_data<dim,spacedim> (dealii_cell,
+                                                parallel::distributed::Triangulation<dim,spacedim>::CELL_PERSIST,
+                                                variable_data_pack_callbacks);
       }
     else if (p4est_has_children)
       {
@@ -671,6 +749,12 @@ namespace
                            ptr);
           }
 
+        if (variable_data_pack_callbacks.size() > 0)
+          variable_data[tree.quadrants_offset + child0_idx]
+            = pack_variable_data<dim,spacedim> (dealii_cell,
+                                                parallel::distributed::Triangulation<dim,spacedim>::CELL_REFINE,
+                                                variable_data_pack_callbacks);
+
         //mark other children as invalid, so that unpack only happens once
         for (unsigned int i=1; i<GeometryInfo<dim>::max_children_per_cell; ++i)
           {
@@ -703,6 +787,12 @@ namespace
                            parallel::distributed::Triangulation<dim,spacedim>::CELL_COARSEN,
                            ptr);
           }
+
+        if (variable_data_pack_callbacks.size() > 0)
+          variable_data[tree.quadrants_offset + idx]
+            = pack_variable_data<dim,spacedim> (dealii_cell,
+                                                parallel::distributed::Triangulation<dim,spacedim>::CELL_COARSEN,
+                                                variable_data_pack_callbacks);
       }
   }
 
@@ -887,6 +977,123 @@ namespace
 
 
 
+  template <int dim, int spacedim>
+  void
+  post_variable_data_recursively (const typename internal::p4est::types<dim>::tree &tree,
+                                  const typename Triangulation<dim,spacedim>::cell_iterator &dealii_cell,
+                                  const typename Triangulation<dim,spacedim>::cell_iterator &parent_cell,
+                                  const typename internal::p4est::types<dim>::quadrant &p4est_cell,
+                                  const unsigned int handle,
+                                  const unsigned int n_objects,
+                                  const std::vector<char> &variable_data_buffer,
+                                  const std::vector<std::size_t> &variable_data_offsets,
+                                  const typename std::function<
+                                  void(typename parallel::distributed::Triangulation<dim,spacedim>::cell_iterator,
+                                       typename parallel::distributed::Triangulation<dim,spacedim>::CellStatus,
+                                       const boost::iterator_range<std::vector<char>::const_iterator> &)
+                                  > &unpack_callback)
+  {
+    typedef typename parallel::distributed::Triangulation<dim,spacedim>::CellStatus CellStatus;
+
+    int idx = sc_array_bsearch(const_cast<sc_array_t *>(&tree.quadrants),
+                               &p4est_cell,
+                               internal::p4est::functions<dim>::quadrant_compare);
+    if (idx == -1 && (internal::p4est::functions<dim>::
+                      quadrant_overlaps_tree (const_cast<typename internal::p4est::types<dim>::tree *>(&tree),
+                                              &p4est_cell)
+                      == false))
+      // this quadrant and none of its children belong to us.
+      return;
+
+    const bool p4est_has_children = (idx == -1);
+    if (p4est_has_children)
+      {
+        Assert(dealii_cell->has_children(), ExcInternalError());
+
+        //recurse further
+        typename internal::p4est::types<dim>::quadrant
+        p4est_child[GeometryInfo<dim>::max_children_per_cell];
+        for (unsigned int c=0; c<GeometryInfo<dim>::max_children_per_cell; ++c)
+          switch (dim)
+            {
+            case 2:
+              P4EST_QUADRANT_INIT(&p4est_child[c]);
+              break;
+            case 3:
+              P8EST_QUADRANT_INIT(&p4est_child[c]);
+              break;
+            default:
+              Assert (false, ExcNotImplemented());
+            }
+
+        internal::p4est::functions<dim>::
+        quadrant_childrenv (&p4est_cell, p4est_child);
+
+        for (unsigned int c=0;
+             c<GeometryInfo<dim>::max_children_per_cell; ++c)
+          post_variable_data_recursively<dim,spacedim> (tree,
+                                                        dealii_cell->child(c),
+                                                        dealii_cell,
+                                                        p4est_child[c],
+                                                        handle,
+                                                        n_objects,
+                                                        variable_data_buffer,
+                                                        variable_data_offsets,
+                                                        unpack_callback);
+      }
+    else
+      {
+        Assert(! dealii_cell->has_children(), ExcInternalError());
+
+        // quadrants without data are the ones with status CELL_INVALID
+        const std::size_t local_index = tree.quadrants_offset + idx;
+        AssertIndexRange (local_index+1, variable_data_offsets.size());
+        if (variable_data_offsets[local_index] == variable_data_offsets[local_index+1])
+          return;
+
+        std::vector<char>::const_iterator
+        data = variable_data_buffer.begin() + variable_data_offsets[local_index];
+        CellStatus status;
+        std::memcpy (&status, &*data, sizeof(CellStatus));
+        data += sizeof(CellStatus);
+
+        // skip the data of the objects registered before this one
+        unsigned int object_size = 0;
+        std::vector<char>::const_iterator
+        object_data = data + n_objects * sizeof(unsigned int);
+        for (unsigned int i=0; i<=handle; ++i)
+          {
+            object_data += object_size;
+            std::memcpy (&object_size, &*(data + i*sizeof(unsigned int)),
+                         sizeof(unsigned int));
+          }
+        Assert (object_data + object_size <= variable_data_buffer.begin() +
+                variable_data_offsets[local_index+1],
+                ExcInternalError());
+
+        const boost::iterator_range<std::vector<char>::const_iterator>
+        data_range (object_data, object_data + object_size);
+        switch (status)
+          {
+          case parallel::distributed::Triangulation<dim,spacedim>::CELL_PERSIST:
+          case parallel::distributed::Triangulation<dim,spacedim>::CELL_COARSEN:
+          {
+            unpack_callback(dealii_cell, status, data_range);
+            break;
+          }
+          case parallel::distributed::Triangulation<dim,spacedim>::CELL_REFINE:
+          {
+            unpack_callback(parent_cell, status, data_range);
+            break;
+          }
+          default:
+            Assert (false, ExcInternalError());
+          }
+      }
+  }
+
+
+
   /**
    * A data structure that we use to store which cells (indicated by
    * internal::p4est::types<dim>::quadrant objects) shall be refined and which
@@ -1294,7 +1501,10 @@ namespace parallel
       parallel_forest (nullptr),
       attached_data_size(0),
       n_attached_datas(0),
-      n_attached_deserialize(0)
+      n_attached_deserialize(0),
+      n_variable_datas_unpacked(0),
+      n_attached_variable_deserialize(0),
+      n_variable_datas_in_buffer(0)
     {
       parallel_ghost = nullptr;
     }
@@ -1777,16 +1987,17 @@ namespace parallel
         {
           std::string fname=std::string(filename)+".info";
           std::ofstream f(fname.c_str());
-          f << "version nproc attached_bytes n_attached_objs n_coarse_cells" << std::endl
-            << 2 << " "
+          f << "version nproc attached_bytes n_attached_objs n_coarse_cells n_attached_variable_objs" << std::endl
+            << 3 << " "
             << Utilities::MPI::n_mpi_processes (this->mpi_communicator) << " "
             << real_data_size << " "
             << attached_data_pack_callbacks.size() << " "
-            << this->n_cells(0)
+            << this->n_cells(0) << " "
+            << variable_data_pack_callbacks.size()
             << std::endl;
         }
 
-      if (attached_data_size>0)
+      if (attached_data_size>0 || variable_data_pack_callbacks.size()>0)
         {
           const_cast<dealii::parallel::distributed::Triangulation<dim, spacedim>*>(this)
           ->attach_mesh_data();
@@ -1794,6 +2005,11 @@ namespace parallel
 
       dealii::internal::p4est::functions<dim>::save(filename, parallel_forest, attached_data_size>0);
 
+      // the data of variable size goes into a second file, which is written
+      // collectively by all processes
+      if (n_variable_datas_in_buffer>0)
+        save_variable_data(filename);
+
       dealii::parallel::distributed::Triangulation<dim, spacedim> *tria
         = const_cast<dealii::parallel::distributed::Triangulation<dim, spacedim>*>(this);
 
@@ -1801,6 +2017,12 @@ namespace parallel
       tria->attached_data_size = 0;
       tria->attached_data_pack_callbacks.clear();
 
+      tria->variable_data_pack_callbacks.clear();
+      tria->n_variable_datas_unpacked = 0;
+      tria->n_variable_datas_in_buffer = 0;
+      tria->variable_data_buffer.clear();
+      tria->variable_data_offsets.clear();
+
       // and release the data
       void *userptr = parallel_forest->user_pointer;
       dealii::internal::p4est::functions<dim>::reset_data (parallel_forest, 0, nullptr, nullptr);
@@ -1829,6 +2051,7 @@ namespace parallel
       connectivity = nullptr;
 
       unsigned int version, numcpus, attached_size, attached_count, n_coarse_cells;
+      unsigned int attached_variable_count = 0;
       {
         std::string fname=std::string(filename)+".info";
         std::ifstream f(fname.c_str());
@@ -1836,9 +2059,13 @@ namespace parallel
         std::string firstline;
         getline(f, firstline); //skip first line
         f >> version >> numcpus >> attached_size >> attached_count >> n_coarse_cells;
+        // version 3 adds the data of variable size
+        if (version == 3)
+          f >> attached_variable_count;
       }
 
-      Assert(version == 2, ExcMessage("Incompatible version found in .info file."));
+      Assert(version == 2 || version == 3,
+             ExcMessage("Incompatible version found in .info file."));
       Assert(this->n_cells(0) == n_coarse_cells, ExcMessage("Number of coarse cells differ!"));
 #if DEAL_II_P4EST_VERSION_GTE(0,3,4,3)
 #else
@@ -1852,6 +2079,13 @@ namespace parallel
       n_attached_datas = 0;
       n_attached_deserialize = attached_count;
 
+      variable_data_pack_callbacks.clear();
+      variable_data_buffer.clear();
+      variable_data_offsets.clear();
+      n_variable_datas_unpacked = 0;
+      n_variable_datas_in_buffer = 0;
+      n_attached_variable_deserialize = attached_variable_count;
+
 #if DEAL_II_P4EST_VERSION_GTE(0,3,4,3)
       parallel_forest = dealii::internal::p4est::functions<dim>::load_ext (
                           filename, this->mpi_communicator,
@@ -1875,6 +2109,11 @@ namespace parallel
         // will leave it in here.
         repartition();
 
+      // the data of variable size is read for the final partition of the
+      // forest
+      if (attached_variable_count > 0)
+        load_variable_data (filename, attached_variable_count);
+
       try
         {
           copy_local_forest_to_triangulation ();
@@ -1898,6 +2137,113 @@ namespace parallel
 
 
 
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::
+    save_variable_data (const char *filename) const
+    {
+      // the file starts with the sizes of the data of all quadrants in the
+      // global p4est order, followed by the data itself in the same order.
+      // this layout does not depend on the partition, so the file can be
+      // read with any number of processes
+      const unsigned int n_procs = Utilities::MPI::n_mpi_processes (this->mpi_communicator);
+      const unsigned int my_pid = Utilities::MPI::this_mpi_process (this->mpi_communicator);
+      const unsigned int n_local_quadrants = parallel_forest->local_num_quadrants;
+      AssertDimension (variable_data_offsets.size(), n_local_quadrants+1);
+
+      std::vector<unsigned int> sizes (n_local_quadrants);
+      for (unsigned int i=0; i<n_local_quadrants; ++i)
+        sizes[i] = variable_data_offsets[i+1] - variable_data_offsets[i];
+
+      unsigned long long int local_size = variable_data_buffer.size(), local_offset = 0;
+      int ierr = MPI_Exscan (&local_size, &local_offset, 1, MPI_UNSIGNED_LONG_LONG,
+                             MPI_SUM, this->mpi_communicator);
+      AssertThrowMPI(ierr);
+      // the result of MPI_Exscan is undefined on the first process
+      if (my_pid == 0)
+        local_offset = 0;
+      AssertThrow (variable_data_buffer.size() <= static_cast<std::size_t>(std::numeric_limits<int>::max()),
+                   ExcMessage ("The variable size data of one process exceeds 2GB."));
+
+      const std::string fname = std::string(filename)+"_variable.data";
+      MPI_File fh;
+      ierr = MPI_File_open (this->mpi_communicator, const_cast<char *>(fname.c_str()),
+                            MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+      AssertThrowMPI(ierr);
+      // remove previous content of the file
+      ierr = MPI_File_set_size (fh, 0);
+      AssertThrowMPI(ierr);
+
+      ierr = MPI_File_write_at_all (fh,
+                                    parallel_forest->global_first_quadrant[my_pid] * sizeof(unsigned int),
+                                    sizes.data(), n_local_quadrants * sizeof(unsigned int),
+                                    MPI_BYTE, MPI_STATUS_IGNORE);
+      AssertThrowMPI(ierr);
+
+      const MPI_Offset header_size = parallel_forest->global_first_quadrant[n_procs] * sizeof(unsigned int);
+      ierr = MPI_File_write_at_all (fh, header_size + local_offset,
+                                    const_cast<char *>(variable_data_buffer.data()),
+                                    variable_data_buffer.size(), MPI_BYTE, MPI_STATUS_IGNORE);
+      AssertThrowMPI(ierr);
+
+      ierr = MPI_File_close (&fh);
+      AssertThrowMPI(ierr);
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::
+    load_variable_data (const char *filename,
+                        const unsigned int n_attached_variable_objects)
+    {
+      const unsigned int n_procs = Utilities::MPI::n_mpi_processes (this->mpi_communicator);
+      const unsigned int my_pid = Utilities::MPI::this_mpi_process (this->mpi_communicator);
+      const unsigned int n_local_quadrants = parallel_forest->local_num_quadrants;
+
+      const std::string fname = std::string(filename)+"_variable.data";
+      MPI_File fh;
+      int ierr = MPI_File_open (this->mpi_communicator, const_cast<char *>(fname.c_str()),
+                                MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+      AssertThrowMPI(ierr);
+
+      std::vector<unsigned int> sizes (n_local_quadrants);
+      ierr = MPI_File_read_at_all (fh,
+                                   parallel_forest->global_first_quadrant[my_pid] * sizeof(unsigned int),
+                                   sizes.data(), n_local_quadrants * sizeof(unsigned int),
+                                   MPI_BYTE, MPI_STATUS_IGNORE);
+      AssertThrowMPI(ierr);
+
+      variable_data_offsets.resize (n_local_quadrants+1);
+      variable_data_offsets[0] = 0;
+      for (unsigned int i=0; i<n_local_quadrants; ++i)
+        variable_data_offsets[i+1] = variable_data_offsets[i] + sizes[i];
+
+      unsigned long long int local_size = variable_data_offsets.back(), local_offset = 0;
+      ierr = MPI_Exscan (&local_size, &local_offset, 1, MPI_UNSIGNED_LONG_LONG,
+                         MPI_SUM, this->mpi_communicator);
+      AssertThrowMPI(ierr);
+      if (my_pid == 0)
+        local_offset = 0;
+      AssertThrow (local_size <= static_cast<unsigned long long int>(std::numeric_limits<int>::max()),
+                   ExcMessage ("The variable size data of one process exceeds 2GB."));
+
+      variable_data_buffer.resize (local_size);
+      const MPI_Offset header_size = parallel_forest->global_first_quadrant[n_procs] * sizeof(unsigned int);
+      ierr = MPI_File_read_at_all (fh, header_size + local_offset,
+                                   variable_data_buffer.data(), local_size,
+                                   MPI_BYTE, MPI_STATUS_IGNORE);
+      AssertThrowMPI(ierr);
+
+      ierr = MPI_File_close (&fh);
+      AssertThrowMPI(ierr);
+
+      n_variable_datas_in_buffer = n_attached_variable_objects;
+    }
+
+
+
     template <int dim, int spacedim>
     unsigned int
     Triangulation<dim,spacedim>::get_checksum () const
@@ -2539,6 +2885,15 @@ namespace parallel
            ++cell)
         cell->recursively_set_subdomain_id(numbers::artificial_subdomain_id);
 
+      // the coarse cells whose descendants need to be compared with p4est
+      // in the next pass. once the cells rooted in a coarse cell match the
+      // forest without setting any refine or coarsen flag, and the
+      // refinement in between does not touch them, matching them again
+      // would not do anything, so each pass only works on the parts of the
+      // mesh that are still changing
+      std::vector<bool> coarse_cell_needs_matching (this->n_cells(0), true);
+      bool local_mesh_refined = false;
+
       do
         {
           for (typename Triangulation<dim,spacedim>::cell_iterator
@@ -2546,6 +2901,9 @@ namespace parallel
                cell != this->end(0);
                ++cell)
             {
+              if (coarse_cell_needs_matching[cell->index()] == false)
+                continue;
+
               // if this processor stores no part of the forest that comes out
               // of this coarse grid cell, then we need to delete all children
               // of this cell (the coarse grid cell remains)
@@ -2556,6 +2914,7 @@ namespace parallel
                   delete_all_children<dim,spacedim> (cell);
                   if (!cell->has_children())
                     cell->set_subdomain_id (numbers::artificial_subdomain_id);
+                  coarse_cell_needs_matching[cell->index()] = cell->has_children();
                 }
 
               else
@@ -2569,10 +2928,11 @@ namespace parallel
 
                   dealii::internal::p4est::init_coarse_quadrant<dim>(p4est_coarse_cell);
 
-                  match_tree_recursively<dim,spacedim> (*tree, cell,
-                                                        p4est_coarse_cell,
-                                                        *parallel_forest,
-                                                        this->my_subdomain);
+                  coarse_cell_needs_matching[cell->index()]
+                    = !match_tree_recursively<dim,spacedim> (*tree, cell,
+                                                             p4est_coarse_cell,
+                                                             *parallel_forest,
+                                                             this->my_subdomain);
                 }
             }
 
@@ -2602,7 +2962,8 @@ namespace parallel
           // fix all the flags to make sure we have a consistent mesh
           this->prepare_coarsening_and_refinement ();
 
-          // see if any flags are still set
+          // see if any flags are still set, and match the coarse cells with
+          // flagged descendants again in the next pass
           mesh_changed = false;
           for (typename Triangulation<dim,spacedim>::active_cell_iterator
                cell = this->begin_active();
@@ -2611,24 +2972,44 @@ namespace parallel
             if (cell->refine_flag_set() || cell->coarsen_flag_set())
               {
                 mesh_changed = true;
-                break;
+
+                typename Triangulation<dim,spacedim>::cell_iterator coarse_cell = cell;
+                while (coarse_cell->level() > 0)
+                  coarse_cell = coarse_cell->parent();
+                coarse_cell_needs_matching[coarse_cell->index()] = true;
               }
 
           // actually do the refinement to change the local mesh by
-          // calling the base class refinement function directly
-          try
-            {
-              dealii::Triangulation<dim,spacedim>::execute_coarsening_and_refinement();
-            }
-          catch (const typename Triangulation<dim,spacedim>::DistortedCellList &)
+          // calling the base class refinement function directly. without
+          // any flags, this would only recompute the neighbor information
+          // of the unchanged mesh
+          if (mesh_changed)
             {
-              // the underlying triangulation should not be checking for
-              // distorted cells
-              Assert (false, ExcInternalError());
+              local_mesh_refined = true;
+              try
+                {
+                  dealii::Triangulation<dim,spacedim>::execute_coarsening_and_refinement();
+                }
+              catch (const typename Triangulation<dim,spacedim>::DistortedCellList &)
+                {
+                  // the underlying triangulation should not be checking for
+                  // distorted cells
+                  Assert (false, ExcInternalError());
+                }
             }
         }
       while (mesh_changed);
 
+      // objects attached to the triangulation learn about changes of the
+      // mesh through the signals of the serial refinement. if the local mesh
+      // did not change, the subdomain ids of its cells still might have, so
+      // send the same signals as a refinement without any flags does
+      if (local_mesh_refined == false)
+        {
+          this->signals.pre_refinement();
+          this->signals.post_refinement();
+        }
+
 #ifdef DEBUG
       // check if correct number of ghosts is created
       unsigned int num_ghosts = 0;
@@ -2865,6 +3246,13 @@ namespace parallel
 
       if (!(settings & no_automatic_repartitioning))
         {
+          // remember the old partition for the variable size data
+          std::vector<typename dealii::internal::p4est::types<dim>::gloidx> old_global_first_quadrant;
+          if (n_variable_datas_in_buffer > 0)
+            old_global_first_quadrant.assign (parallel_forest->global_first_quadrant,
+                                              parallel_forest->global_first_quadrant +
+                                              Utilities::MPI::n_mpi_processes (this->mpi_communicator) + 1);
+
           // partition the new mesh between all processors. If cell weights have
           // not been given balance the number of cells.
           if (this->signals.cell_weight.num_slots() == 0)
@@ -2893,6 +3281,9 @@ namespace parallel
               // reset the user pointer to its previous state
               parallel_forest->user_pointer = this;
             }
+
+          if (n_variable_datas_in_buffer > 0)
+            transfer_variable_data (old_global_first_quadrant);
         }
 
       // finally copy back from local part of tree to deal.II
@@ -2994,6 +3385,13 @@ namespace parallel
       // (such as SolutionTransfer data) to the p4est
       attach_mesh_data();
 
+      // remember the old partition, for the variable size data and to find
+      // out which parts of the mesh change
+      const unsigned int n_procs = Utilities::MPI::n_mpi_processes (this->mpi_communicator);
+      const std::vector<typename dealii::internal::p4est::types<dim>::gloidx>
+      old_global_first_quadrant (parallel_forest->global_first_quadrant,
+                                 parallel_forest->global_first_quadrant + n_procs + 1);
+
       if (this->signals.cell_weight.num_slots() == 0)
         {
           // no cell weights given -- call p4est's 'partition' without a
@@ -3025,20 +3423,117 @@ namespace parallel
           parallel_forest->user_pointer = this;
         }
 
-      try
+      if (n_variable_datas_in_buffer > 0)
+        transfer_variable_data (old_global_first_quadrant);
+
+      // p4est only ships the quadrants that change their owner, along with
+      // their data, so the data attached to all other cells has not been
+      // touched. if no quadrant changed its owner at all, which all
+      // processes see alike, the local triangulation is still valid
+      const typename dealii::internal::p4est::types<dim>::gloidx
+      *new_global_first_quadrant = parallel_forest->global_first_quadrant;
+      if (std::equal (old_global_first_quadrant.begin(),
+                      old_global_first_quadrant.end(),
+                      new_global_first_quadrant))
+        return;
+
+      // since the refinement of the forest is unchanged, processes that keep
+      // their locally owned cells also keep all the cells of their ghost layer,
+      // whose owners might have changed, though. the locally relevant
+      // part of the triangulation then stays the same and only the subdomain
+      // ids of the ghost cells need to be updated, unless we also need the
+      // level subdomain ids or a deterministic order of the cells
+      const unsigned int my_pid = this->my_subdomain;
+      if (old_global_first_quadrant[my_pid] == new_global_first_quadrant[my_pid]
+          &&
+          old_global_first_quadrant[my_pid+1] == new_global_first_quadrant[my_pid+1]
+          &&
+          !(settings & construct_multigrid_hierarchy)
+          &&
+          !(settings & mesh_reconstruction_after_repartitioning))
+        update_ghost_owners ();
+      else
+        try
+          {
+            copy_local_forest_to_triangulation ();
+          }
+        catch (const typename Triangulation<dim>::DistortedCellList &)
+          {
+            // the underlying triangulation should not be checking for distorted
+            // cells
+            Assert (false, ExcInternalError());
+          }
+
+      // update how many cells, edges, etc, we store locally
+      this->update_number_cache ();
+      this->update_periodic_face_map();
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::update_ghost_owners ()
+    {
+      // query p4est for the new ghost cells. this is a collective operation
+      // that copy_local_forest_to_triangulation() calls exactly once as well
+      if (parallel_ghost != nullptr)
         {
-          copy_local_forest_to_triangulation ();
+          dealii::internal::p4est::functions<dim>::ghost_destroy (parallel_ghost);
+          parallel_ghost = nullptr;
         }
-      catch (const typename Triangulation<dim>::DistortedCellList &)
+      parallel_ghost = dealii::internal::p4est::functions<dim>::ghost_new (parallel_forest,
+                       (dim == 2
+                        ?
+                        typename dealii::internal::p4est::types<dim>::
+                        balance_type(P4EST_CONNECT_CORNER)
+                        :
+                        typename dealii::internal::p4est::types<dim>::
+                        balance_type(P8EST_CONNECT_CORNER)));
+
+      Assert (parallel_ghost, ExcInternalError());
+
+      // all ghost quadrants already exist as active cells, so matching them
+      // only sets the subdomain id of the cells
+      types::subdomain_id ghost_owner=0;
+      typename dealii::internal::p4est::types<dim>::topidx ghost_tree=0;
+      for (unsigned int g_idx=0; g_idx<parallel_ghost->ghosts.elem_count; ++g_idx)
         {
-          // the underlying triangulation should not be checking for distorted
-          // cells
-          Assert (false, ExcInternalError());
+          while (g_idx >= (unsigned int)parallel_ghost->proc_offsets[ghost_owner+1])
+            ++ghost_owner;
+          while (g_idx >= (unsigned int)parallel_ghost->tree_offsets[ghost_tree+1])
+            ++ghost_tree;
+
+          typename dealii::internal::p4est::types<dim>::quadrant *quadr =
+            static_cast<typename dealii::internal::p4est::types<dim>::quadrant *>
+            ( sc_array_index(&parallel_ghost->ghosts, g_idx) );
+
+          match_quadrant<dim,spacedim> (this,
+                                        p4est_tree_to_coarse_cell_permutation[ghost_tree],
+                                        *quadr, ghost_owner);
         }
 
-      // update how many cells, edges, etc, we store locally
-      this->update_number_cache ();
-      this->update_periodic_face_map();
+#ifdef DEBUG
+      unsigned int num_ghosts = 0;
+      for (typename Triangulation<dim,spacedim>::active_cell_iterator
+           cell = this->begin_active();
+           cell != this->end();
+           ++cell)
+        {
+          Assert (!cell->refine_flag_set() && !cell->coarsen_flag_set(),
+                  ExcInternalError());
+          if (cell->subdomain_id() != this->my_subdomain
+              &&
+              cell->subdomain_id() != numbers::artificial_subdomain_id)
+            ++num_ghosts;
+        }
+      Assert (num_ghosts == parallel_ghost->ghosts.elem_count, ExcInternalError());
+#endif
+
+      // notify the objects attached to the triangulation about the new
+      // subdomain ids, as copy_local_forest_to_triangulation() does
+      this->signals.pre_refinement();
+      this->signals.post_refinement();
     }
 
 
@@ -3290,6 +3785,92 @@ namespace parallel
     }
 
 
+    template <int dim, int spacedim>
+    unsigned int
+    Triangulation<dim,spacedim>::
+    register_data_attach_variable (const std::function<std::vector<char> (const cell_iterator &,
+                                   const CellStatus)> &pack_callback)
+    {
+      Assert(n_variable_datas_unpacked==0 || n_attached_variable_deserialize>0,
+             ExcMessage("register_data_attach_variable(), not all data has been unpacked last time?"));
+
+      variable_data_pack_callbacks.push_back(pack_callback);
+      return variable_data_pack_callbacks.size()-1;
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::
+    notify_ready_to_unpack_variable (const unsigned int handle,
+                                     const std::function<void (const cell_iterator &,
+                                                               const CellStatus,
+                                                               const boost::iterator_range<std::vector<char>::const_iterator> &)> &unpack_callback)
+    {
+      Assert (handle < n_variable_datas_in_buffer,
+              ExcMessage ("invalid handle in notify_ready_to_unpack_variable()"));
+      Assert (n_variable_datas_unpacked < variable_data_pack_callbacks.size(),
+              ExcMessage ("notify_ready_to_unpack_variable() called too often"));
+      AssertDimension (variable_data_offsets.size(),
+                       static_cast<std::size_t>(parallel_forest->local_num_quadrants+1));
+
+      // Recurse over p4est and hand the caller the data back
+      for (typename Triangulation<dim, spacedim>::cell_iterator
+           cell = this->begin (0);
+           cell != this->end (0);
+           ++cell)
+        {
+          //skip coarse cells, that are not ours
+          if (tree_exists_locally<dim, spacedim> (parallel_forest,
+                                                  coarse_cell_to_p4est_tree_permutation[cell->index() ])
+              == false)
+            continue;
+
+          typename dealii::internal::p4est::types<dim>::quadrant p4est_coarse_cell;
+          typename dealii::internal::p4est::types<dim>::tree *tree =
+            init_tree (cell->index());
+
+          dealii::internal::p4est::init_coarse_quadrant<dim> (p4est_coarse_cell);
+
+          post_variable_data_recursively<dim, spacedim> (*tree,
+                                                         cell,
+                                                         cell,
+                                                         p4est_coarse_cell,
+                                                         handle,
+                                                         n_variable_datas_in_buffer,
+                                                         variable_data_buffer,
+                                                         variable_data_offsets,
+                                                         unpack_callback);
+        }
+
+      ++n_variable_datas_unpacked;
+      if (n_attached_variable_deserialize > 0)
+        --n_attached_variable_deserialize;
+
+      // as in notify_ready_to_unpack(), keep the data until the last object
+      // has been deserialized after load()
+      if (n_variable_datas_unpacked == variable_data_pack_callbacks.size() &&
+          n_attached_variable_deserialize == 0)
+        {
+          variable_data_pack_callbacks.clear();
+          n_variable_datas_unpacked = 0;
+          n_variable_datas_in_buffer = 0;
+          std::vector<char>().swap (variable_data_buffer);
+          std::vector<std::size_t>().swap (variable_data_offsets);
+
+          // release the CellStatus stored in p4est unless there is still
+          // data of fixed size to be unpacked
+          if (attached_data_size == 0)
+            {
+              void *userptr = parallel_forest->user_pointer;
+              dealii::internal::p4est::functions<dim>::reset_data (parallel_forest, 0, nullptr, nullptr);
+              parallel_forest->user_pointer = userptr;
+            }
+        }
+    }
+
+
     template <int dim, int spacedim>
     const std::vector<types::global_dof_index> &
     Triangulation<dim, spacedim>::get_p4est_tree_to_coarse_cell_permutation() const
@@ -3549,6 +4130,8 @@ namespace parallel
         + MemoryConsumption::memory_consumption(parallel_forest)
         + MemoryConsumption::memory_consumption(attached_data_size)
         + MemoryConsumption::memory_consumption(n_attached_datas)
+        + MemoryConsumption::memory_consumption(variable_data_buffer)
+        + MemoryConsumption::memory_consumption(variable_data_offsets)
 //      + MemoryConsumption::memory_consumption(attached_data_pack_callbacks) //TODO[TH]: how?
         + MemoryConsumption::memory_consumption(coarse_cell_to_p4est_tree_permutation)
         + MemoryConsumption::memory_consumption(p4est_tree_to_coarse_cell_permutation)
@@ -3633,8 +4216,9 @@ namespace parallel
     attach_mesh_data()
     {
       // determine size of memory in bytes to attach to each cell. This needs
-      // to be constant because of p4est.
-      if (attached_data_size==0)
+      // to be constant because of p4est. Data of variable size is collected
+      // separately, but the CellStatus is stored in p4est in any case.
+      if (attached_data_size==0 && variable_data_pack_callbacks.size()==0)
         {
           Assert(n_attached_datas==0, ExcInternalError());
 
@@ -3649,6 +4233,11 @@ namespace parallel
                                                            nullptr, nullptr);
       parallel_forest->user_pointer = userptr;
 
+      // the variable size data of each local quadrant, in the order of p4est
+      std::vector<std::vector<char> > variable_data;
+      if (variable_data_pack_callbacks.size() > 0)
+        variable_data.resize (parallel_forest->local_num_quadrants);
+
 
       // Recurse over p4est and Triangulation
       // to find refined/coarsened/kept
@@ -3673,10 +4262,173 @@ namespace parallel
           attach_mesh_data_recursively<dim,spacedim>(*tree,
                                                      cell,
                                                      p4est_coarse_cell,
-                                                     attached_data_pack_callbacks);
+                                                     attached_data_pack_callbacks,
+                                                     variable_data_pack_callbacks,
+                                                     variable_data);
+        }
+
+      // concatenate the variable size data into one buffer that can be sent
+      // around in pieces
+      if (variable_data_pack_callbacks.size() > 0)
+        {
+          n_variable_datas_in_buffer = variable_data_pack_callbacks.size();
+          variable_data_offsets.resize (variable_data.size()+1);
+          variable_data_offsets[0] = 0;
+          for (unsigned int i=0; i<variable_data.size(); ++i)
+            variable_data_offsets[i+1] = variable_data_offsets[i] + variable_data[i].size();
+
+          variable_data_buffer.resize (variable_data_offsets.back());
+          for (unsigned int i=0; i<variable_data.size(); ++i)
+            std::copy (variable_data[i].begin(), variable_data[i].end(),
+                       variable_data_buffer.begin() + variable_data_offsets[i]);
         }
     }
 
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::
+    transfer_variable_data (const std::vector<typename dealii::internal::p4est::types<dim>::gloidx> &old_global_first_quadrant)
+    {
+      typedef typename dealii::internal::p4est::types<dim>::gloidx gloidx;
+
+      const unsigned int n_procs = Utilities::MPI::n_mpi_processes (this->mpi_communicator);
+      const unsigned int my_pid = Utilities::MPI::this_mpi_process (this->mpi_communicator);
+      AssertDimension (old_global_first_quadrant.size(), n_procs+1);
+      const gloidx *new_global_first_quadrant = parallel_forest->global_first_quadrant;
+
+      const gloidx old_begin = old_global_first_quadrant[my_pid];
+      const gloidx old_end = old_global_first_quadrant[my_pid+1];
+      const gloidx new_begin = new_global_first_quadrant[my_pid];
+      const gloidx new_end = new_global_first_quadrant[my_pid+1];
+      AssertDimension (variable_data_offsets.size(),
+                       static_cast<std::size_t>(old_end-old_begin+1));
+
+      // the quadrants move along the global p4est order, so the present
+      // process exchanges contiguous ranges of quadrants with the processes
+      // whose new (for sending) or old (for receiving) range overlaps with
+      // its own one. if the local range did not change, nothing needs to be
+      // sent or received
+      if (old_begin == new_begin && old_end == new_end)
+        return;
+
+      // triples of process, first and last quadrant
+      std::vector<std::array<gloidx,3> > send_ranges, receive_ranges;
+      for (unsigned int p = std::upper_bound (new_global_first_quadrant,
+                                              new_global_first_quadrant+n_procs,
+                                              old_begin) - new_global_first_quadrant - 1;
+           p<n_procs && new_global_first_quadrant[p] < old_end; ++p)
+        {
+          const gloidx begin = std::max (old_begin, new_global_first_quadrant[p]);
+          const gloidx end = std::min (old_end, new_global_first_quadrant[p+1]);
+          if (begin < end)
+            send_ranges.push_back (std::array<gloidx,3> {{p, begin, end}});
+        }
+      for (unsigned int p = std::upper_bound (old_global_first_quadrant.begin(),
+                                              old_global_first_quadrant.end()-1,
+                                              new_begin) - old_global_first_quadrant.begin() - 1;
+           p<n_procs && old_global_first_quadrant[p] < new_end; ++p)
+        {
+          const gloidx begin = std::max (new_begin, old_global_first_quadrant[p]);
+          const gloidx end = std::min (new_end, old_global_first_quadrant[p+1]);
+          if (begin < end)
+            receive_ranges.push_back (std::array<gloidx,3> {{p, begin, end}});
+        }
+
+      // first exchange the size of the data of each quadrant, then the data
+      // itself
+      std::vector<unsigned int> new_sizes (new_end-new_begin);
+      std::vector<std::vector<unsigned int> > send_sizes (send_ranges.size());
+      std::vector<MPI_Request> requests;
+      requests.reserve (send_ranges.size()+receive_ranges.size());
+      for (unsigned int i=0; i<receive_ranges.size(); ++i)
+        if (receive_ranges[i][0] != my_pid)
+          {
+            requests.push_back (MPI_Request());
+            const int ierr = MPI_Irecv (&new_sizes[receive_ranges[i][1]-new_begin],
+                                        (receive_ranges[i][2]-receive_ranges[i][1]) * sizeof(unsigned int),
+                                        MPI_BYTE, receive_ranges[i][0], 124,
+                                        this->mpi_communicator, &requests.back());
+            AssertThrowMPI(ierr);
+          }
+      for (unsigned int i=0; i<send_ranges.size(); ++i)
+        {
+          send_sizes[i].resize (send_ranges[i][2]-send_ranges[i][1]);
+          for (gloidx q=send_ranges[i][1]; q<send_ranges[i][2]; ++q)
+            send_sizes[i][q-send_ranges[i][1]] = variable_data_offsets[q-old_begin+1] -
+                                                 variable_data_offsets[q-old_begin];
+          if (send_ranges[i][0] == my_pid)
+            std::copy (send_sizes[i].begin(), send_sizes[i].end(),
+                       new_sizes.begin() + (send_ranges[i][1]-new_begin));
+          else
+            {
+              requests.push_back (MPI_Request());
+              const int ierr = MPI_Isend (send_sizes[i].data(),
+                                          send_sizes[i].size() * sizeof(unsigned int),
+                                          MPI_BYTE, send_ranges[i][0], 124,
+                                          this->mpi_communicator, &requests.back());
+              AssertThrowMPI(ierr);
+            }
+        }
+      if (requests.size() > 0)
+        {
+          const int ierr = MPI_Waitall (requests.size(), requests.data(),
+                                        MPI_STATUSES_IGNORE);
+          AssertThrowMPI(ierr);
+        }
+
+      std::vector<std::size_t> new_offsets (new_sizes.size()+1, 0);
+      for (unsigned int i=0; i<new_sizes.size(); ++i)
+        new_offsets[i+1] = new_offsets[i] + new_sizes[i];
+      std::vector<char> new_buffer (new_offsets.back());
+
+      requests.clear();
+      for (unsigned int i=0; i<receive_ranges.size(); ++i)
+        if (receive_ranges[i][0] != my_pid)
+          {
+            const std::size_t begin = new_offsets[receive_ranges[i][1]-new_begin];
+            const std::size_t size = new_offsets[receive_ranges[i][2]-new_begin] - begin;
+            AssertThrow (size <= static_cast<std::size_t>(std::numeric_limits<int>::max()),
+                         ExcMessage ("The variable size data to be sent to another "
+                                     "process exceeds 2GB."));
+            requests.push_back (MPI_Request());
+            const int ierr = MPI_Irecv (new_buffer.data() + begin, size,
+                                        MPI_BYTE, receive_ranges[i][0], 125,
+                                        this->mpi_communicator, &requests.back());
+            AssertThrowMPI(ierr);
+          }
+      for (unsigned int i=0; i<send_ranges.size(); ++i)
+        {
+          const std::size_t begin = variable_data_offsets[send_ranges[i][1]-old_begin];
+          const std::size_t size = variable_data_offsets[send_ranges[i][2]-old_begin] - begin;
+          if (send_ranges[i][0] == my_pid)
+            std::copy (variable_data_buffer.begin() + begin,
+                       variable_data_buffer.begin() + begin + size,
+                       new_buffer.begin() + new_offsets[send_ranges[i][1]-new_begin]);
+          else
+            {
+              AssertThrow (size <= static_cast<std::size_t>(std::numeric_limits<int>::max()),
+                           ExcMessage ("The variable size data to be sent to another "
+                                       "process exceeds 2GB."));
+              requests.push_back (MPI_Request());
+              const int ierr = MPI_Isend (variable_data_buffer.data() + begin, size,
+                                          MPI_BYTE, send_ranges[i][0], 125,
+                                          this->mpi_communicator, &requests.back());
+              AssertThrowMPI(ierr);
+            }
+        }
+      if (requests.size() > 0)
+        {
+          const int ierr = MPI_Waitall (requests.size(), requests.data(),
+                                        MPI_STATUSES_IGNORE);
+          AssertThrowMPI(ierr);
+        }
+
+      variable_data_buffer.swap (new_buffer);
+      variable_data_offsets.swap (new_offsets);
+    }
+
     template <int dim, int spacedim>
     std::vector<unsigned int>
     Triangulation<dim,spacedim>::
@@ -3783,6 +4535,29 @@ namespace parallel
     }
 
 
+
+    template <int spacedim>
+    unsigned int
+    Triangulation<1,spacedim>::register_data_attach_variable (const std::function<std::vector<char> (const typename dealii::Triangulation<1,spacedim>::cell_iterator &,
+        const typename dealii::Triangulation<1,spacedim>::CellStatus)> &/*pack_callback*/)
+    {
+      Assert (false, ExcNotImplemented());
+      return 0;
+    }
+
+
+
+    template <int spacedim>
+    void
+    Triangulation<1,spacedim>::notify_ready_to_unpack_variable (const unsigned int /*handle*/,
+        const std::function<void (const typename dealii::Triangulation<1,spacedim>::cell_iterator &,
+                                  const typename dealii::Triangulation<1,spacedim>::CellStatus,
+                                  const boost::iterator_range<std::vector<char>::const_iterator> &)> &/*unpack_callback*/)
+    {
+      Assert (false, ExcNotImplemented());
+    }
+
+
     template <int spacedim>
     const std::vector<types::global_dof_index> &
     Triangulation<1,spacedim>::get_p4est_tree_to_coarse_cell_permutation() const
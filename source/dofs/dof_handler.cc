@@ -14,6 +14,7 @@
 // ---------------------------------------------------------------------
 
 #include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/thread_management.h>
 #include <deal.II/dofs/dof_handler.h>
 #include <deal.II/dofs/dof_handler_policy.h>
 #include <deal.II/dofs/dof_levels.h>
@@ -655,7 +656,8 @@ DoFHandler<dim,spacedim>::DoFHandler (const Triangulation<dim,spacedim> &tria)
   tria(&tria, typeid(*this).name()),
   fe_collection(nullptr),
   faces(nullptr),
-  mg_faces (nullptr)
+  mg_faces (nullptr),
+  use_compressed_cell_dof_indices_cache (false)
 {
   // decide whether we need a sequential or a parallel distributed policy
   if (dynamic_cast<const parallel::shared::Triangulation< dim, spacedim>*>
@@ -675,7 +677,8 @@ template <int dim, int spacedim>
 DoFHandler<dim,spacedim>::DoFHandler ()
   :
   tria(nullptr, typeid(*this).name()),
-  fe_collection(nullptr)
+  fe_collection(nullptr),
+  use_compressed_cell_dof_indices_cache (false)
 {}
 
 
@@ -779,6 +782,16 @@ DoFHandler<dim, spacedim>::end_active (const unsigned int level) const
 
 
 
+template <int dim, int spacedim>
+typename DoFHandler<dim, spacedim>::active_cell_iterator
+DoFHandler<dim, spacedim>::active_cell_with_index (const unsigned int active_cell_index) const
+{
+  return active_cell_iterator (*this->get_triangulation().active_cell_with_index (active_cell_index),
+                               this);
+}
+
+
+
 template <int dim, int spacedim>
 typename DoFHandler<dim, spacedim>::level_cell_iterator
 DoFHandler<dim, spacedim>::begin_mg (const unsigned int level) const
@@ -1020,6 +1033,7 @@ void DoFHandler<dim,spacedim>::distribute_dofs (const FiniteElement<dim,spacedim
 
   // hand things off to the policy
   number_cache = policy->distribute_dofs ();
+  compress_cell_dof_indices_caches ();
 
   // initialize the block info object
   // only if this is a sequential
@@ -1051,7 +1065,9 @@ void DoFHandler<dim, spacedim>::distribute_mg_dofs ()
   clear_mg_space();
 
   internal::DoFHandler::Implementation::reserve_space_mg (*this);
+  uncompress_cell_dof_indices_caches ();
   mg_number_cache = policy->distribute_mg_dofs ();
+  compress_cell_dof_indices_caches ();
 
   // initialize the block info object
   // only if this is a sequential
@@ -1143,7 +1159,9 @@ DoFHandler<dim,spacedim>::renumber_dofs (const std::vector<types::global_dof_ind
               ExcMessage ("New DoF index is not less than the total number of dofs."));
 #endif
 
+  uncompress_cell_dof_indices_caches ();
   number_cache = policy->renumber_dofs (new_numbers);
+  compress_cell_dof_indices_caches ();
 }
 
 
@@ -1177,7 +1195,56 @@ DoFHandler<dim,spacedim>::renumber_dofs (const unsigned int
               ExcMessage ("New DoF index is not less than the total number of dofs."));
 #endif
 
+  uncompress_cell_dof_indices_caches ();
   mg_number_cache[level] = policy->renumber_mg_dofs (level, new_numbers);
+  compress_cell_dof_indices_caches ();
+}
+
+
+
+template <int dim, int spacedim>
+void
+DoFHandler<dim,spacedim>::set_compressed_cell_dof_indices_cache (const bool compress)
+{
+  use_compressed_cell_dof_indices_cache = compress;
+  if (compress)
+    compress_cell_dof_indices_caches ();
+  else
+    uncompress_cell_dof_indices_caches ();
+}
+
+
+
+template <int dim, int spacedim>
+void
+DoFHandler<dim,spacedim>::compress_cell_dof_indices_caches ()
+{
+  if (use_compressed_cell_dof_indices_cache == false)
+    return;
+
+  // the levels are independent of each other
+  Threads::TaskGroup<> tasks;
+  for (unsigned int i=0; i<levels.size(); ++i)
+    tasks += Threads::new_task ([this,i]()
+  {
+    levels[i]->compress_cell_dof_indices_cache ();
+  });
+  tasks.join_all ();
+}
+
+
+
+template <int dim, int spacedim>
+void
+DoFHandler<dim,spacedim>::uncompress_cell_dof_indices_caches ()
+{
+  Threads::TaskGroup<> tasks;
+  for (unsigned int i=0; i<levels.size(); ++i)
+    tasks += Threads::new_task ([this,i]()
+  {
+    levels[i]->uncompress_cell_dof_indices_cache ();
+  });
+  tasks.join_all ();
 }
 
 
@@ -19,6 +19,8 @@
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/partitioner.h>
 #include <deal.II/grid/grid_tools.h>
 #include <deal.II/grid/tria.h>
@@ -42,6 +44,7 @@ DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
 #endif
 DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
 
+#include <atomic>
 #include <set>
 #include <algorithm>
 #include <numeric>
@@ -144,6 +147,38 @@ namespace internal
         }
 
 
+        /**
+         * Replace every valid entry of @p dof_indices by its new number,
+         * i.e., by <tt>new_numbers[i]</tt> for the entry <tt>i</tt>, or by
+         * <tt>new_numbers[indices.index_within_set(i)]</tt> if @p indices is
+         * not empty. The entries are independent of each other, so the vector
+         * is split into ranges that are worked on in parallel.
+         */
+        void
+        renumber_dof_indices (const std::vector<types::global_dof_index> &new_numbers,
+                              const IndexSet                             &indices,
+                              std::vector<types::global_dof_index>       &dof_indices)
+        {
+          // make sure the IndexSet is compressed before the parallel
+          // region, rather than having the threads wait for each other
+          // on the first call to index_within_set()
+          indices.compress ();
+
+          parallel::apply_to_subranges
+          (std::size_t(0), dof_indices.size(),
+           [&] (const std::size_t begin, const std::size_t end)
+          {
+            for (std::size_t i=begin; i<end; ++i)
+              if (dof_indices[i] != numbers::invalid_dof_index)
+                dof_indices[i] = ((indices.size() == 0) ?
+                                  new_numbers[dof_indices[i]] :
+                                  new_numbers[indices.index_within_set(dof_indices[i])]);
+          },
+          /* grainsize = */ 4096);
+        }
+
+
+
         typedef
         std::vector<std::pair<unsigned int, unsigned int> > DoFIdentities;
 
@@ -1202,24 +1237,22 @@ namespace internal
 
 
         /**
-         * Distribute degrees of freedom on all cells, or on cells with the
-         * correct subdomain_id if the corresponding argument is not equal to
-         * numbers::invalid_subdomain_id. Return the total number of dofs
-         * distributed.
+         * Distribute dofs on all active cells that are not artificial and, if
+         * @p subdomain_id is not equal to numbers::invalid_subdomain_id, have
+         * the given subdomain id, one cell after the other in the order of
+         * the active cell iterators. Return the next unused index number.
+         *
+         * This is the version for the hp::DoFHandler, where the unification
+         * step that follows renumbers the indices anyway.
          */
-        template <class DoFHandlerType>
+        template <int dim, int spacedim>
         static
         types::global_dof_index
-        distribute_dofs (const types::subdomain_id     subdomain_id,
-                         DoFHandlerType               &dof_handler)
+        distribute_dofs_on_cells (const types::subdomain_id     subdomain_id,
+                                  hp::DoFHandler<dim,spacedim> &dof_handler)
         {
-          Assert (dof_handler.get_triangulation().n_levels() > 0,
-                  ExcMessage("Empty triangulation"));
-
-          // Step 1: distribute dofs on all cells, but definitely
-          // exclude artificial cells
           types::global_dof_index next_free_dof = 0;
-          typename DoFHandlerType::active_cell_iterator
+          typename hp::DoFHandler<dim,spacedim>::active_cell_iterator
           cell = dof_handler.begin_active(),
           endc = dof_handler.end();
 
@@ -1233,6 +1266,244 @@ namespace internal
                                                              cell,
                                                              next_free_dof);
 
+          return next_free_dof;
+        }
+
+
+
+        /**
+         * Number the dofs on the quads of @p cell that are owned by @p chunk
+         * and have not been numbered yet, starting at @p next_free_dof. A
+         * helper function for distribute_dofs_on_cells() below: only in 3d,
+         * the quads carry dofs separate from the ones of the cell.
+         */
+        template <int dim, int spacedim>
+        static
+        void
+        distribute_dofs_on_owned_quads (const typename DoFHandler<dim,spacedim>::active_cell_iterator &cell,
+                                        const std::vector<std::atomic<unsigned int> >               &quad_owner,
+                                        const unsigned int                                           chunk,
+                                        types::global_dof_index                                     &next_free_dof,
+                                        std::true_type)
+        {
+          const unsigned int dofs_per_quad = cell->get_fe().dofs_per_quad;
+          for (unsigned int q=0; q<GeometryInfo<dim>::quads_per_cell; ++q)
+            {
+              const typename DoFHandler<dim,spacedim>::quad_iterator quad = cell->quad(q);
+              if (quad_owner[quad->index()].load (std::memory_order_relaxed) == chunk
+                  &&
+                  quad->dof_index(0) == numbers::invalid_dof_index)
+                for (unsigned int d=0; d<dofs_per_quad; ++d)
+                  quad->set_dof_index (d, next_free_dof++);
+            }
+        }
+
+
+
+        template <int dim, int spacedim>
+        static
+        void
+        distribute_dofs_on_owned_quads (const typename DoFHandler<dim,spacedim>::active_cell_iterator &,
+                                        const std::vector<std::atomic<unsigned int> > &,
+                                        const unsigned int,
+                                        types::global_dof_index &,
+                                        std::false_type)
+        {}
+
+
+
+        /**
+         * Same as above, but for the DoFHandler. On large meshes, the cells
+         * are split into contiguous chunks (in the order of the active cell
+         * iterators) that are enumerated in parallel. The result is exactly
+         * the same numbering as the one we would get by enumerating one cell
+         * after the other:
+         *
+         * - First, each chunk of cells marks the vertices, lines, and quads
+         *   it touches. An object is owned by the first chunk that touches it,
+         *   which is the chunk whose first cell with this object would
+         *   have numbered it in the sequential enumeration.
+         * - Second, the number of dofs on the objects owned by each chunk plus
+         *   the dofs in the interior of its cells give the start of the range
+         *   of indices of each chunk by a prefix sum.
+         * - Finally, each chunk walks over its cells and numbers the dofs on
+         *   the objects it owns, starting at its first index.
+         */
+        template <int dim, int spacedim>
+        static
+        types::global_dof_index
+        distribute_dofs_on_cells (const types::subdomain_id  subdomain_id,
+                                  DoFHandler<dim,spacedim>  &dof_handler)
+        {
+          const FiniteElement<dim,spacedim> &fe = dof_handler.get_fe();
+          const dealii::Triangulation<dim,spacedim> &tria = dof_handler.get_triangulation();
+
+          std::vector<typename DoFHandler<dim,spacedim>::active_cell_iterator> cells;
+          cells.reserve (tria.n_active_cells());
+          for (const auto &cell : dof_handler.active_cell_iterators())
+            if (! cell->is_artificial())
+              if ((subdomain_id == numbers::invalid_subdomain_id)
+                  ||
+                  (cell->subdomain_id() == subdomain_id))
+                cells.push_back (cell);
+
+          // setting up the chunks only pays off if each of them has a
+          // reasonable number of cells
+          const unsigned int min_cells_per_chunk = 1000;
+          const unsigned int n_chunks
+            = std::min<std::size_t> (4*MultithreadInfo::n_threads(),
+                                     cells.size() / min_cells_per_chunk);
+          if (n_chunks < 2)
+            {
+              types::global_dof_index next_free_dof = 0;
+              for (const auto &cell : cells)
+                next_free_dof
+                  = Implementation::distribute_dofs_on_cell (dof_handler,
+                                                             cell,
+                                                             next_free_dof);
+              return next_free_dof;
+            }
+
+          std::vector<std::size_t> chunk_cell_start (n_chunks+1);
+          for (unsigned int c=0; c<=n_chunks; ++c)
+            chunk_cell_start[c] = cells.size() * c / n_chunks;
+
+          // the owning chunk of each vertex, line, and quad that carries
+          // dofs. the owner is the smallest chunk touching the object, which
+          // we find by an atomic minimum
+          const bool number_vertices = (fe.dofs_per_vertex > 0);
+          const bool number_lines    = (dim > 1 && fe.dofs_per_line > 0);
+          const bool number_quads    = (dim > 2 && fe.dofs_per_quad > 0);
+          const unsigned int dofs_per_cell_interior = fe.template n_dofs_per_object<dim>();
+
+          std::vector<std::atomic<unsigned int> >
+          vertex_owner (number_vertices ? tria.n_vertices() : 0),
+                       line_owner (number_lines ? tria.n_raw_lines() : 0),
+                       quad_owner (number_quads ? tria.n_raw_quads() : 0);
+          for (auto owner : {&vertex_owner, &line_owner, &quad_owner})
+            for (auto &o : *owner)
+              o.store (numbers::invalid_unsigned_int, std::memory_order_relaxed);
+
+          const auto mark_owner = [] (std::atomic<unsigned int> &owner,
+                                      const unsigned int         chunk)
+          {
+            unsigned int old_owner = owner.load (std::memory_order_relaxed);
+            while (chunk < old_owner &&
+                   !owner.compare_exchange_weak (old_owner, chunk,
+                                                 std::memory_order_relaxed))
+              ;
+          };
+
+          {
+            Threads::TaskGroup<> tasks;
+            for (unsigned int c=0; c<n_chunks; ++c)
+              tasks += Threads::new_task ([&,c]()
+            {
+              for (std::size_t i=chunk_cell_start[c]; i<chunk_cell_start[c+1]; ++i)
+                {
+                  const auto &cell = cells[i];
+                  if (number_vertices)
+                    for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+                      mark_owner (vertex_owner[cell->vertex_index(v)], c);
+                  if (number_lines)
+                    for (unsigned int l=0; l<GeometryInfo<dim>::lines_per_cell; ++l)
+                      mark_owner (line_owner[cell->line_index(l)], c);
+                  if (number_quads)
+                    for (unsigned int q=0; q<GeometryInfo<dim>::quads_per_cell; ++q)
+                      mark_owner (quad_owner[cell->quad_index(q)], c);
+                }
+            });
+            tasks.join_all ();
+          }
+
+          // count the dofs of each chunk and compute the start of its range
+          // of indices
+          std::vector<types::global_dof_index> chunk_dof_start (n_chunks+1, 0);
+          for (unsigned int c=0; c<n_chunks; ++c)
+            chunk_dof_start[c+1] = (chunk_cell_start[c+1]-chunk_cell_start[c]) *
+                                   dofs_per_cell_interior;
+          for (const auto &o : vertex_owner)
+            if (o.load (std::memory_order_relaxed) != numbers::invalid_unsigned_int)
+              chunk_dof_start[o.load (std::memory_order_relaxed)+1] += fe.dofs_per_vertex;
+          for (const auto &o : line_owner)
+            if (o.load (std::memory_order_relaxed) != numbers::invalid_unsigned_int)
+              chunk_dof_start[o.load (std::memory_order_relaxed)+1] += fe.dofs_per_line;
+          for (const auto &o : quad_owner)
+            if (o.load (std::memory_order_relaxed) != numbers::invalid_unsigned_int)
+              chunk_dof_start[o.load (std::memory_order_relaxed)+1] += fe.dofs_per_quad;
+          std::partial_sum (chunk_dof_start.begin(), chunk_dof_start.end(),
+                            chunk_dof_start.begin());
+
+          // finally number the dofs in the same order as
+          // distribute_dofs_on_cell(). only the owning chunk ever reads or
+          // writes the dofs of an object, so the chunks can work at the
+          // same time
+          {
+            Threads::TaskGroup<> tasks;
+            for (unsigned int c=0; c<n_chunks; ++c)
+              tasks += Threads::new_task ([&,c]()
+            {
+              types::global_dof_index next_free_dof = chunk_dof_start[c];
+              for (std::size_t i=chunk_cell_start[c]; i<chunk_cell_start[c+1]; ++i)
+                {
+                  const auto &cell = cells[i];
+                  if (number_vertices)
+                    for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+                      if (vertex_owner[cell->vertex_index(v)].load (std::memory_order_relaxed) == c
+                          &&
+                          cell->vertex_dof_index(v, 0) == numbers::invalid_dof_index)
+                        for (unsigned int d=0; d<fe.dofs_per_vertex; ++d)
+                          cell->set_vertex_dof_index (v, d, next_free_dof++);
+
+                  if (number_lines)
+                    for (unsigned int l=0; l<GeometryInfo<dim>::lines_per_cell; ++l)
+                      {
+                        const auto line = cell->line(l);
+                        if (line_owner[line->index()].load (std::memory_order_relaxed) == c
+                            &&
+                            line->dof_index(0) == numbers::invalid_dof_index)
+                          for (unsigned int d=0; d<fe.dofs_per_line; ++d)
+                            line->set_dof_index (d, next_free_dof++);
+                      }
+
+                  if (number_quads)
+                    distribute_dofs_on_owned_quads<dim,spacedim> (cell, quad_owner, c,
+                                                                  next_free_dof,
+                                                                  std::integral_constant<bool, (dim>2)>());
+
+                  for (unsigned int d=0; d<dofs_per_cell_interior; ++d)
+                    cell->set_dof_index (d, next_free_dof++);
+                }
+              Assert (next_free_dof == chunk_dof_start[c+1], ExcInternalError());
+            });
+            tasks.join_all ();
+          }
+
+          return chunk_dof_start[n_chunks];
+        }
+
+
+
+        /**
+         * Distribute degrees of freedom on all cells, or on cells with the
+         * correct subdomain_id if the corresponding argument is not equal to
+         * numbers::invalid_subdomain_id. Return the total number of dofs
+         * distributed.
+         */
+        template <class DoFHandlerType>
+        static
+        types::global_dof_index
+        distribute_dofs (const types::subdomain_id     subdomain_id,
+                         DoFHandlerType               &dof_handler)
+        {
+          Assert (dof_handler.get_triangulation().n_levels() > 0,
+                  ExcMessage("Empty triangulation"));
+
+          // Step 1: distribute dofs on all cells, but definitely
+          // exclude artificial cells
+          types::global_dof_index next_free_dof
+            = distribute_dofs_on_cells (subdomain_id, dof_handler);
+
           // Step 2: unify dof indices in case this is an hp DoFHandler
           //
           // during unification, we need to renumber DoF indices. there,
@@ -1534,21 +1805,24 @@ namespace internal
           // correct but also faster; note, however, that dof numbers
           // may be invalid_dof_index, namely when the appropriate
           // vertex/line/etc is unused
-          for (std::vector<types::global_dof_index>::iterator
-               i=dof_handler.vertex_dofs.begin();
-               i!=dof_handler.vertex_dofs.end(); ++i)
-            if (*i != numbers::invalid_dof_index)
-              *i = (indices.size() == 0)?
-                   (new_numbers[*i]) :
-                   (new_numbers[indices.index_within_set(*i)]);
-            else if (check_validity)
-              // if index is invalid_dof_index: check if this one
-              // really is unused
-              Assert (dof_handler.get_triangulation()
-                      .vertex_used((i-dof_handler.vertex_dofs.begin()) /
-                                   dof_handler.get_fe().dofs_per_vertex)
-                      == false,
-                      ExcInternalError ());
+#ifdef DEBUG
+          // if an index is invalid_dof_index: check if this one
+          // really is unused
+          if (check_validity)
+            for (std::vector<types::global_dof_index>::const_iterator
+                 i=dof_handler.vertex_dofs.begin();
+                 i!=dof_handler.vertex_dofs.end(); ++i)
+              if (*i == numbers::invalid_dof_index)
+                Assert (dof_handler.get_triangulation()
+                        .vertex_used((i-dof_handler.vertex_dofs.begin()) /
+                                     dof_handler.get_fe().dofs_per_vertex)
+                        == false,
+                        ExcInternalError ());
+#else
+          (void)check_validity;
+#endif
+
+          renumber_dof_indices (new_numbers, indices, dof_handler.vertex_dofs);
         }
 
 
@@ -1568,13 +1842,8 @@ namespace internal
                             DoFHandler<dim,spacedim>                   &dof_handler)
         {
           for (unsigned int level=0; level<dof_handler.levels.size(); ++level)
-            for (std::vector<types::global_dof_index>::iterator
-                 i=dof_handler.levels[level]->dof_object.dofs.begin();
-                 i!=dof_handler.levels[level]->dof_object.dofs.end(); ++i)
-              if (*i != numbers::invalid_dof_index)
-                *i = ((indices.size() == 0) ?
-                      new_numbers[*i] :
-                      new_numbers[indices.index_within_set(*i)]);
+            renumber_dof_indices (new_numbers, indices,
+                                  dof_handler.levels[level]->dof_object.dofs);
         }
 
 
@@ -1606,13 +1875,8 @@ namespace internal
                             DoFHandler<2,spacedim>                     &dof_handler)
         {
           // treat dofs on lines
-          for (std::vector<types::global_dof_index>::iterator
-               i=dof_handler.faces->lines.dofs.begin();
-               i!=dof_handler.faces->lines.dofs.end(); ++i)
-            if (*i != numbers::invalid_dof_index)
-              *i = ((indices.size() == 0) ?
-                    new_numbers[*i] :
-                    new_numbers[indices.index_within_set(*i)]);
+          renumber_dof_indices (new_numbers, indices,
+                                dof_handler.faces->lines.dofs);
         }
 
 
@@ -1625,22 +1889,12 @@ namespace internal
                             DoFHandler<3,spacedim>                     &dof_handler)
         {
           // treat dofs on lines
-          for (std::vector<types::global_dof_index>::iterator
-               i=dof_handler.faces->lines.dofs.begin();
-               i!=dof_handler.faces->lines.dofs.end(); ++i)
-            if (*i != numbers::invalid_dof_index)
-              *i = ((indices.size() == 0) ?
-                    new_numbers[*i] :
-                    new_numbers[indices.index_within_set(*i)]);
+          renumber_dof_indices (new_numbers, indices,
+                                dof_handler.faces->lines.dofs);
 
           // treat dofs on quads
-          for (std::vector<types::global_dof_index>::iterator
-               i=dof_handler.faces->quads.dofs.begin();
-               i!=dof_handler.faces->quads.dofs.end(); ++i)
-            if (*i != numbers::invalid_dof_index)
-              *i = ((indices.size() == 0) ?
-                    new_numbers[*i] :
-                    new_numbers[indices.index_within_set(*i)]);
+          renumber_dof_indices (new_numbers, indices,
+                                dof_handler.faces->quads.dofs);
         }
 
 
@@ -29,6 +29,7 @@
 #include <deal.II/dofs/dof_tools.h>
 #include <deal.II/dofs/dof_renumbering.h>
 
+#include <deal.II/grid/grid_tools.h>
 #include <deal.II/grid/tria_iterator.h>
 #include <deal.II/grid/tria.h>
 
@@ -39,6 +40,8 @@
 
 #include <deal.II/multigrid/mg_tools.h>
 
+#include <deal.II/matrix_free/matrix_free.h>
+
 #include <deal.II/distributed/tria.h>
 
 #include <boost/config.hpp>
@@ -57,6 +60,7 @@ DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
 #include <map>
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <functional>
 
 
@@ -1834,6 +1838,84 @@ namespace DoFRenumbering
 
 
 
+  template <typename DoFHandlerType>
+  void
+  space_filling_curve (DoFHandlerType                    &dof_handler,
+                       const GridTools::SpaceFillingCurve curve)
+  {
+    std::vector<types::global_dof_index> renumbering(dof_handler.n_dofs());
+    compute_space_filling_curve(renumbering, dof_handler, curve);
+
+    dof_handler.renumber_dofs(renumbering);
+  }
+
+
+
+  template <typename DoFHandlerType>
+  void
+  compute_space_filling_curve (std::vector<types::global_dof_index> &new_indices,
+                               const DoFHandlerType                 &dof_handler,
+                               const GridTools::SpaceFillingCurve    curve)
+  {
+    const unsigned int dim = DoFHandlerType::dimension;
+    const unsigned int spacedim = DoFHandlerType::space_dimension;
+    Assert ((dynamic_cast<const parallel::distributed::Triangulation<dim,spacedim>*>
+             (&dof_handler.get_triangulation()) == nullptr),
+            ExcNotImplemented());
+    AssertDimension (new_indices.size(), dof_handler.n_dofs());
+
+    std::vector<typename DoFHandlerType::active_cell_iterator> cells;
+    std::vector<Point<spacedim> > centers;
+    cells.reserve (dof_handler.get_triangulation().n_active_cells());
+    centers.reserve (dof_handler.get_triangulation().n_active_cells());
+    for (const auto &cell : dof_handler.active_cell_iterators())
+      {
+        cells.push_back (cell);
+        centers.push_back (cell->center());
+      }
+
+    const std::vector<std::uint64_t> curve_indices
+      = GridTools::compute_space_filling_curve_indices (centers, curve);
+    std::vector<unsigned int> order (cells.size());
+    for (unsigned int c=0; c<cells.size(); ++c)
+      order[c] = c;
+    std::stable_sort (order.begin(), order.end(),
+                      [&](const unsigned int a, const unsigned int b)
+    {
+      return curve_indices[a] < curve_indices[b];
+    });
+
+    std::vector<typename DoFHandlerType::active_cell_iterator> ordered_cells;
+    ordered_cells.reserve (cells.size());
+    for (const unsigned int c : order)
+      ordered_cells.push_back (cells[c]);
+
+    std::vector<types::global_dof_index> reverse(new_indices.size());
+    compute_cell_wise(new_indices, reverse, dof_handler, ordered_cells);
+
+    // if the degrees of freedom are owned by several processes, as for a
+    // parallel::shared::Triangulation, number the degrees of freedom of each
+    // process in the new order, but within the range it owns
+    const std::vector<IndexSet> &owned_dofs = dof_handler.locally_owned_dofs_per_processor();
+    if (owned_dofs.size() > 1)
+      {
+        std::vector<unsigned int> owner (dof_handler.n_dofs());
+        std::vector<types::global_dof_index> next_index (owned_dofs.size(), 0);
+        for (unsigned int p=0; p<owned_dofs.size(); ++p)
+          {
+            Assert (owned_dofs[p].is_contiguous(), ExcNotImplemented());
+            for (const types::global_dof_index i : owned_dofs[p])
+              owner[i] = p;
+            if (owned_dofs[p].n_elements() > 0)
+              next_index[p] = owned_dofs[p].nth_index_in_set(0);
+          }
+        for (const types::global_dof_index i : reverse)
+          new_indices[i] = next_index[owner[i]]++;
+      }
+  }
+
+
+
   template <typename DoFHandlerType>
   void
   random (DoFHandlerType &dof_handler)
@@ -1937,6 +2019,87 @@ namespace DoFRenumbering
             ExcInternalError());
   }
 
+
+
+  template <int dim, typename Number>
+  void
+  matrix_free_data_locality (DoFHandler<dim>               &dof_handler,
+                             const MatrixFree<dim,Number> &matrix_free)
+  {
+    std::vector<types::global_dof_index> renumbering;
+    compute_matrix_free_data_locality(renumbering, dof_handler, matrix_free);
+
+    dof_handler.renumber_dofs(renumbering);
+  }
+
+
+
+  template <int dim, typename Number>
+  void
+  compute_matrix_free_data_locality (std::vector<types::global_dof_index> &new_dof_indices,
+                                     const DoFHandler<dim>                &dof_handler,
+                                     const MatrixFree<dim,Number>         &matrix_free)
+  {
+    unsigned int dof_index = numbers::invalid_unsigned_int;
+    for (unsigned int i=0; i<matrix_free.n_components(); ++i)
+      if (&matrix_free.get_dof_handler(i) == &dof_handler)
+        {
+          dof_index = i;
+          break;
+        }
+    Assert (dof_index != numbers::invalid_unsigned_int,
+            ExcMessage ("The DoFHandler must be one of the DoFHandler objects "
+                        "the MatrixFree object has been initialized with."));
+
+    const IndexSet &owned_dofs = dof_handler.locally_owned_dofs();
+    new_dof_indices.clear ();
+    new_dof_indices.resize (owned_dofs.n_elements(), numbers::invalid_dof_index);
+
+    const std::vector<unsigned int> &lexicographic_numbering
+      = matrix_free.get_shape_info(dof_index).lexicographic_numbering;
+    const unsigned int dofs_per_cell = dof_handler.get_fe().dofs_per_cell;
+    AssertDimension (lexicographic_numbering.size(), dofs_per_cell);
+
+    const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+    std::vector<std::vector<types::global_dof_index> >
+    lane_dof_indices (n_lanes, std::vector<types::global_dof_index>(dofs_per_cell));
+
+    // number the degrees of freedom when they are first accessed by the cell
+    // batches, interleaved over the lanes of each batch
+    types::global_dof_index next_index = 0;
+    for (unsigned int batch=0; batch<matrix_free.n_macro_cells(); ++batch)
+      {
+        const unsigned int n_filled = matrix_free.n_components_filled(batch);
+        for (unsigned int v=0; v<n_filled; ++v)
+          {
+            const typename DoFHandler<dim>::cell_iterator cell
+              = matrix_free.get_cell_iterator(batch, v, dof_index);
+            Assert (cell->active(), ExcNotImplemented());
+            cell->get_dof_indices (lane_dof_indices[v]);
+          }
+
+        for (unsigned int i=0; i<dofs_per_cell; ++i)
+          for (unsigned int v=0; v<n_filled; ++v)
+            {
+              const types::global_dof_index dof = lane_dof_indices[v][lexicographic_numbering[i]];
+              if (owned_dofs.is_element(dof))
+                {
+                  types::global_dof_index &new_index
+                    = new_dof_indices[owned_dofs.index_within_set(dof)];
+                  if (new_index == numbers::invalid_dof_index)
+                    new_index = owned_dofs.nth_index_in_set(next_index++);
+                }
+            }
+      }
+
+    // degrees of freedom that are only accessed by cells of other processes
+    // go last
+    for (auto &new_index : new_dof_indices)
+      if (new_index == numbers::invalid_dof_index)
+        new_index = owned_dofs.nth_index_in_set(next_index++);
+    AssertDimension (next_index, owned_dofs.n_elements());
+  }
+
 } // namespace DoFRenumbering
 
 
@@ -1264,6 +1264,35 @@ namespace DoFTools
       active_fe_indices[cell->active_cell_index()] = cell->active_fe_index();
   }
 
+
+
+  template <typename DoFHandlerType>
+  std::vector<typename DoFHandlerType::active_cell_iterator>
+  get_active_cells_sorted_by_fe_index (const DoFHandlerType &dof_handler)
+  {
+    // sort by counting the cells with each index, which keeps the order of
+    // the cells with the same index
+    std::vector<unsigned int> n_cells_per_fe_index;
+    for (const auto &cell : dof_handler.active_cell_iterators())
+      {
+        const unsigned int fe_index = cell->active_fe_index();
+        if (fe_index >= n_cells_per_fe_index.size())
+          n_cells_per_fe_index.resize (fe_index+1, 0);
+        ++n_cells_per_fe_index[fe_index];
+      }
+
+    std::vector<unsigned int> next_position (n_cells_per_fe_index.size(), 0);
+    for (unsigned int i=1; i<n_cells_per_fe_index.size(); ++i)
+      next_position[i] = next_position[i-1] + n_cells_per_fe_index[i-1];
+
+    std::vector<typename DoFHandlerType::active_cell_iterator>
+    cells (dof_handler.get_triangulation().n_active_cells());
+    for (const auto &cell : dof_handler.active_cell_iterators())
+      cells[next_position[cell->active_fe_index()]++] = cell;
+
+    return cells;
+  }
+
   template <typename DoFHandlerType>
   std::vector<IndexSet>
   locally_owned_dofs_per_subdomain (const DoFHandlerType  &dof_handler)
@@ -13,6 +13,7 @@
 //
 // ---------------------------------------------------------------------
 
+#include <deal.II/base/multithread_info.h>
 #include <deal.II/base/thread_management.h>
 #include <deal.II/base/table.h>
 #include <deal.II/base/template_constraints.h>
@@ -369,6 +370,26 @@ namespace DoFTools
 
 
 
+      /**
+       * Return fe1.compare_for_face_domination(fe2). The result is computed
+       * the first time it is asked for and is then stored in @p domination,
+       * since this query can be expensive (e.g., for FESystem objects) and is
+       * needed once per face between two given elements.
+       */
+      template <int dim, int spacedim>
+      FiniteElementDomination::Domination
+      get_face_domination (const FiniteElement<dim,spacedim> &fe1,
+                           const FiniteElement<dim,spacedim> &fe2,
+                           std::unique_ptr<FiniteElementDomination::Domination> &domination)
+      {
+        if (domination == nullptr)
+          domination = std_cxx14::make_unique<FiniteElementDomination::Domination>
+                       (fe1.compare_for_face_domination (fe2));
+        return *domination;
+      }
+
+
+
       /**
        * Given the face interpolation matrix between two elements, split it
        * into its master and slave parts and invert the master part as
@@ -466,11 +487,13 @@ namespace DoFTools
 
 
       /**
-       * Copy constraints into a constraint matrix object.
+       * Append constraints to the list @p new_constraints.
        *
        * This function removes zero constraints and those, which constrain
-       * a DoF which was already eliminated in one of the previous steps of
-       * the hp hanging node procedure.
+       * a DoF which was already constrained in @p constraints before the
+       * hp hanging node procedure started. DoFs that are constrained by an
+       * earlier entry of @p new_constraints are removed when the list is
+       * copied into the constraint matrix.
        *
        * It also suppresses very small entries in the constraint matrix to
        * avoid making the sparsity pattern fuller than necessary.
@@ -479,7 +502,8 @@ namespace DoFTools
       filter_constraints (const std::vector<types::global_dof_index> &master_dofs,
                           const std::vector<types::global_dof_index> &slave_dofs,
                           const FullMatrix<double> &face_constraints,
-                          ConstraintMatrix &constraints)
+                          const ConstraintMatrix &constraints,
+                          std::vector<ConstraintMatrix::ConstraintLine> &new_constraints)
       {
         Assert (face_constraints.n () == master_dofs.size (),
                 ExcDimensionMismatch(master_dofs.size (),
@@ -532,15 +556,16 @@ namespace DoFTools
                   // lead to problems because it makes sparsity patterns
                   // fuller than necessary without producing any
                   // significant effect
-                  constraints.add_line (slave_dofs[row]);
+                  ConstraintMatrix::ConstraintLine line;
+                  line.index = slave_dofs[row];
+                  line.inhomogeneity = 0.;
                   for (unsigned int i=0; i<n_master_dofs; ++i)
                     if ((face_constraints(row,i) != 0)
                         &&
                         (std::fabs(face_constraints(row,i)) >= 1e-14*abs_sum))
-                      constraints.add_entry (slave_dofs[row],
-                                             master_dofs[i],
-                                             face_constraints (row,i));
-                  constraints.set_inhomogeneity (slave_dofs[row], 0.);
+                      line.entries.emplace_back (master_dofs[i],
+                                                 face_constraints (row,i));
+                  new_constraints.push_back (std::move(line));
                 }
             }
       }
@@ -1021,10 +1046,21 @@ namespace DoFTools
 
 
 
+    /**
+     * Compute the hanging node constraints on the active cells in the range
+     * from @p begin to @p end and append them to @p new_constraints, in
+     * the order in which the cells are visited. @p constraints contains the
+     * constraints that existed before the make_hanging_node_constraints()
+     * call and is only read.
+     */
     template <typename DoFHandlerType>
     void
-    make_hp_hanging_node_constraints (const DoFHandlerType &dof_handler,
-                                      ConstraintMatrix     &constraints)
+    make_hp_hanging_node_constraints_on_cells
+    (const DoFHandlerType                                &dof_handler,
+     const typename DoFHandlerType::active_cell_iterator &begin,
+     const typename DoFHandlerType::active_cell_iterator &end,
+     const ConstraintMatrix                              &constraints,
+     std::vector<ConstraintMatrix::ConstraintLine>       &new_constraints)
     {
       // note: this function is going to be hard to understand if you
       // haven't read the hp paper. however, we try to follow the notation
@@ -1074,14 +1110,18 @@ namespace DoFTools
       master_dof_masks (n_finite_elements (dof_handler),
                         n_finite_elements (dof_handler));
 
+      // and a cache for the results of compare_for_face_domination() for
+      // each pair of finite elements
+      Table<2,std::unique_ptr<FiniteElementDomination::Domination> >
+      face_dominations (n_finite_elements (dof_handler),
+                        n_finite_elements (dof_handler));
+
       // loop over all faces
       //
       // note that even though we may visit a face twice if the neighboring
       // cells are equally refined, we can only visit each face with
       // hanging nodes once
-      typename DoFHandlerType::active_cell_iterator cell = dof_handler.begin_active(),
-                                                    endc = dof_handler.end();
-      for (; cell!=endc; ++cell)
+      for (typename DoFHandlerType::active_cell_iterator cell=begin; cell!=end; ++cell)
         {
           // artificial cells can at best neighbor ghost cells, but we're not
           // interested in these interfaces
@@ -1138,8 +1178,11 @@ namespace DoFTools
                     if (!cell->neighbor_child_on_subface (face, c)->is_artificial())
                       {
                         mother_face_dominates = mother_face_dominates &
-                                                (cell->get_fe().compare_for_face_domination
-                                                 (cell->neighbor_child_on_subface (face, c)->get_fe()));
+                                                get_face_domination
+                                                (cell->get_fe(),
+                                                 cell->neighbor_child_on_subface (face, c)->get_fe(),
+                                                 face_dominations[cell->active_fe_index()]
+                                                 [cell->neighbor_child_on_subface (face, c)->active_fe_index()]);
                         fe_ind_face_subface.insert(cell->neighbor_child_on_subface (face, c)->active_fe_index());
                       }
 
@@ -1187,8 +1230,10 @@ namespace DoFTools
                         // subface between FE_Q(1) and FE_Nothing, there
                         // are no constraints that we need to take care of.
                         // in that case, just continue
-                        if (cell->get_fe().compare_for_face_domination
-                            (subface->get_fe(subface_fe_index))
+                        if (get_face_domination
+                            (cell->get_fe(),
+                             subface->get_fe(subface_fe_index),
+                             face_dominations[cell->active_fe_index()][subface_fe_index])
                             ==
                             FiniteElementDomination::no_requirements)
                           continue;
@@ -1237,7 +1282,8 @@ namespace DoFTools
                                             slave_dofs,
                                             *(subface_interpolation_matrices
                                               [cell->active_fe_index()][subface_fe_index][c]),
-                                            constraints);
+                                            constraints,
+                                            new_constraints);
                       }
 
                     break;
@@ -1356,7 +1402,8 @@ namespace DoFTools
                     filter_constraints (master_dofs,
                                         slave_dofs,
                                         constraint_matrix,
-                                        constraints);
+                                        constraints,
+                                        new_constraints);
 
 
 
@@ -1413,7 +1460,8 @@ namespace DoFTools
                         filter_constraints (master_dofs,
                                             slave_dofs,
                                             constraint_matrix,
-                                            constraints);
+                                            constraints,
+                                            new_constraints);
                       }
 
                     break;
@@ -1462,7 +1510,10 @@ namespace DoFTools
                     const typename DoFHandlerType::level_cell_iterator neighbor = cell->neighbor (face);
 
                     // see which side of the face we have to constrain
-                    switch (cell->get_fe().compare_for_face_domination (neighbor->get_fe ()))
+                    switch (get_face_domination (cell->get_fe(),
+                                                 neighbor->get_fe (),
+                                                 face_dominations[cell->active_fe_index()]
+                                                 [neighbor->active_fe_index()]))
                       {
                       case FiniteElementDomination::this_element_dominates:
                       {
@@ -1496,7 +1547,8 @@ namespace DoFTools
                                             *(face_interpolation_matrices
                                               [cell->active_fe_index()]
                                               [neighbor->active_fe_index()]),
-                                            constraints);
+                                            constraints,
+                                            new_constraints);
 
                         break;
                       }
@@ -1645,7 +1697,8 @@ namespace DoFTools
                         filter_constraints (master_dofs,
                                             slave_dofs,
                                             constraint_matrix,
-                                            constraints);
+                                            constraints,
+                                            new_constraints);
 
                         // now do the same for another FE
                         // this is pretty much the same we do above to
@@ -1678,7 +1731,8 @@ namespace DoFTools
                         filter_constraints (master_dofs,
                                             slave_dofs,
                                             constraint_matrix,
-                                            constraints);
+                                            constraints,
+                                            new_constraints);
 
                         break;
                       }
@@ -1697,10 +1751,67 @@ namespace DoFTools
               }
         }
     }
-  }
 
 
 
+    template <typename DoFHandlerType>
+    void
+    make_hp_hanging_node_constraints (const DoFHandlerType &dof_handler,
+                                      ConstraintMatrix     &constraints)
+    {
+      // split the active cells into contiguous chunks that are worked on in
+      // parallel. each chunk computes a list of constraints in the order in
+      // which its cells are visited, and they are entered into the
+      // constraint matrix one chunk after the other. since a DoF is only
+      // constrained by the first constraint we find for it, this gives the
+      // same constraints as visiting all cells in one loop
+      const unsigned int min_cells_per_chunk = 500;
+      const unsigned int n_chunks
+        = std::max (1U,
+                    std::min (4*MultithreadInfo::n_threads(),
+                              dof_handler.get_triangulation().n_active_cells() /
+                              min_cells_per_chunk));
+
+      std::vector<typename DoFHandlerType::active_cell_iterator> chunk_begin;
+      chunk_begin.reserve (n_chunks+1);
+      {
+        const unsigned int n_active_cells = dof_handler.get_triangulation().n_active_cells();
+        unsigned int index = 0;
+        for (typename DoFHandlerType::active_cell_iterator
+             cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell, ++index)
+          if (static_cast<std::size_t>(index) * n_chunks >=
+              static_cast<std::size_t>(chunk_begin.size()) * n_active_cells)
+            chunk_begin.push_back (cell);
+        while (chunk_begin.size() < n_chunks+1)
+          chunk_begin.push_back (dof_handler.end());
+      }
+
+      std::vector<std::vector<ConstraintMatrix::ConstraintLine> > new_constraints (n_chunks);
+      Threads::TaskGroup<> tasks;
+      for (unsigned int c=0; c<n_chunks; ++c)
+        tasks += Threads::new_task ([&,c]()
+      {
+        make_hp_hanging_node_constraints_on_cells (dof_handler,
+                                                   chunk_begin[c],
+                                                   chunk_begin[c+1],
+                                                   constraints,
+                                                   new_constraints[c]);
+      });
+      tasks.join_all ();
+
+      for (unsigned int c=0; c<n_chunks; ++c)
+        for (const ConstraintMatrix::ConstraintLine &line : new_constraints[c])
+          if (constraints.is_constrained (line.index) == false)
+            {
+              constraints.add_line (line.index);
+              for (const auto &entry : line.entries)
+                constraints.add_entry (line.index, entry.first, entry.second);
+              constraints.set_inhomogeneity (line.index, line.inhomogeneity);
+            }
+    }
+  }
+
+
 
   template <typename DoFHandlerType>
   void
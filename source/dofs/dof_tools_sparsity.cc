@@ -14,10 +14,13 @@
 // ---------------------------------------------------------------------
 
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/table.h>
 #include <deal.II/base/template_constraints.h>
 #include <deal.II/base/utilities.h>
+#include <deal.II/base/work_stream.h>
 #include <deal.II/lac/sparsity_pattern.h>
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
 #include <deal.II/lac/trilinos_sparsity_pattern.h>
@@ -49,6 +52,152 @@ DEAL_II_NAMESPACE_OPEN
 
 namespace DoFTools
 {
+  namespace internal
+  {
+    namespace
+    {
+      /**
+       * Add the couplings between the degrees of freedom on each locally
+       * owned cell (of the given subdomain, if any) to the sparsity pattern,
+       * resolving the constraints. If @p dof_masks is not empty, it
+       * contains the couplings to be added for each element of the finite
+       * element collection. This function goes through the cells one after
+       * the other.
+       */
+      template <typename DoFHandlerType, typename SparsityPatternType>
+      void
+      add_cell_entries_sequentially (const DoFHandlerType              &dof,
+                                     SparsityPatternType               &sparsity,
+                                     const ConstraintMatrix            &constraints,
+                                     const bool                         keep_constrained_dofs,
+                                     const types::subdomain_id          subdomain_id,
+                                     const std::vector<Table<2,bool> > &dof_masks)
+      {
+        std::vector<types::global_dof_index> dofs_on_this_cell;
+        dofs_on_this_cell.reserve (max_dofs_per_cell(dof));
+        typename DoFHandlerType::active_cell_iterator cell = dof.begin_active(),
+                                                      endc = dof.end();
+
+        // In case we work with a distributed sparsity pattern of Trilinos
+        // type, we only have to do the work if the current cell is owned by
+        // the calling processor. Otherwise, just continue.
+        for (; cell!=endc; ++cell)
+          if (((subdomain_id == numbers::invalid_subdomain_id)
+               ||
+               (subdomain_id == cell->subdomain_id()))
+              &&
+              cell->is_locally_owned())
+            {
+              const unsigned int dofs_per_cell = cell->get_fe().dofs_per_cell;
+              dofs_on_this_cell.resize (dofs_per_cell);
+              cell->get_dof_indices (dofs_on_this_cell);
+
+              // make sparsity pattern for this cell. if no constraints pattern
+              // was given, then the following call acts as if simply no
+              // constraints existed
+              if (dof_masks.empty())
+                constraints.add_entries_local_to_global (dofs_on_this_cell,
+                                                         sparsity,
+                                                         keep_constrained_dofs);
+              else
+                constraints.add_entries_local_to_global (dofs_on_this_cell,
+                                                         sparsity,
+                                                         keep_constrained_dofs,
+                                                         dof_masks[cell->active_fe_index()]);
+            }
+      }
+
+
+
+      /**
+       * Same as add_cell_entries_sequentially(). This is the general
+       * version for all sparsity pattern types that cannot be filled
+       * concurrently.
+       */
+      template <typename DoFHandlerType, typename SparsityPatternType>
+      void
+      add_cell_entries (const DoFHandlerType              &dof,
+                        SparsityPatternType               &sparsity,
+                        const ConstraintMatrix            &constraints,
+                        const bool                         keep_constrained_dofs,
+                        const types::subdomain_id          subdomain_id,
+                        const std::vector<Table<2,bool> > &dof_masks)
+      {
+        add_cell_entries_sequentially (dof, sparsity, constraints,
+                                       keep_constrained_dofs, subdomain_id,
+                                       dof_masks);
+      }
+
+
+
+      /**
+       * Same as add_cell_entries_sequentially(), but work on several cells
+       * concurrently if more than one thread is available. The entries are
+       * added through DynamicSparsityPattern::ThreadSafeInserter.
+       */
+      template <typename DoFHandlerType>
+      void
+      add_cell_entries (const DoFHandlerType              &dof,
+                        DynamicSparsityPattern            &sparsity,
+                        const ConstraintMatrix            &constraints,
+                        const bool                         keep_constrained_dofs,
+                        const types::subdomain_id          subdomain_id,
+                        const std::vector<Table<2,bool> > &dof_masks)
+      {
+        if (MultithreadInfo::n_threads() == 1)
+          {
+            add_cell_entries_sequentially (dof, sparsity, constraints,
+                                           keep_constrained_dofs, subdomain_id,
+                                           dof_masks);
+            return;
+          }
+
+        DynamicSparsityPattern::ThreadSafeInserter inserter (sparsity);
+
+        auto worker
+          = [&] (const typename DoFHandlerType::active_cell_iterator &cell,
+                 std::vector<types::global_dof_index>                &dofs_on_this_cell,
+                 void *)
+        {
+          if (((subdomain_id == numbers::invalid_subdomain_id)
+               ||
+               (subdomain_id == cell->subdomain_id()))
+              &&
+              cell->is_locally_owned())
+            {
+              dofs_on_this_cell.resize (cell->get_fe().dofs_per_cell);
+              cell->get_dof_indices (dofs_on_this_cell);
+
+              if (dof_masks.empty())
+                constraints.add_entries_local_to_global (dofs_on_this_cell,
+                                                         inserter,
+                                                         keep_constrained_dofs);
+              else
+                constraints.add_entries_local_to_global (dofs_on_this_cell,
+                                                         inserter,
+                                                         keep_constrained_dofs,
+                                                         dof_masks[cell->active_fe_index()]);
+            }
+        };
+
+        // the entries are written directly by the worker, so there is no
+        // copier. by using WorkStream, we make sure that we only run
+        // through the range of iterators once, whereas a parallel_for loop
+        // for example has to split the range multiple times, which is
+        // expensive because cell iterators are not random access iterators
+        // with a cheap operator-
+        WorkStream::run (dof.begin_active(), dof.end(),
+                         worker,
+                         /* copier */ std::function<void (void *)>(),
+                         /* scratch_data */ std::vector<types::global_dof_index>(),
+                         /* copy_data */ nullptr,
+                         2*MultithreadInfo::n_threads(),
+                         /* chunk_size = */ 32);
+      }
+    }
+  }
+
+
 
   template <typename DoFHandlerType, typename SparsityPatternType>
   void
@@ -79,32 +228,9 @@ namespace DoFTools
                   "associated DoF handler objects, asking for any subdomain other "
                   "than the locally owned one does not make sense."));
 
-    std::vector<types::global_dof_index> dofs_on_this_cell;
-    dofs_on_this_cell.reserve (max_dofs_per_cell(dof));
-    typename DoFHandlerType::active_cell_iterator cell = dof.begin_active(),
-                                                  endc = dof.end();
-
-    // In case we work with a distributed sparsity pattern of Trilinos
-    // type, we only have to do the work if the current cell is owned by
-    // the calling processor. Otherwise, just continue.
-    for (; cell!=endc; ++cell)
-      if (((subdomain_id == numbers::invalid_subdomain_id)
-           ||
-           (subdomain_id == cell->subdomain_id()))
-          &&
-          cell->is_locally_owned())
-        {
-          const unsigned int dofs_per_cell = cell->get_fe().dofs_per_cell;
-          dofs_on_this_cell.resize (dofs_per_cell);
-          cell->get_dof_indices (dofs_on_this_cell);
-
-          // make sparsity pattern for this cell. if no constraints pattern
-          // was given, then the following call acts as if simply no
-          // constraints existed
-          constraints.add_entries_local_to_global (dofs_on_this_cell,
-                                                   sparsity,
-                                                   keep_constrained_dofs);
-        }
+    internal::add_cell_entries (dof, sparsity, constraints,
+                                keep_constrained_dofs, subdomain_id,
+                                std::vector<Table<2,bool> >());
   }
 
 
@@ -162,35 +288,9 @@ namespace DoFTools
               bool_dof_mask[f](i,j) = true;
       }
 
-    std::vector<types::global_dof_index> dofs_on_this_cell(fe_collection.max_dofs_per_cell());
-    typename DoFHandlerType::active_cell_iterator cell = dof.begin_active(),
-                                                  endc = dof.end();
-
-    // In case we work with a distributed sparsity pattern of Trilinos
-    // type, we only have to do the work if the current cell is owned by
-    // the calling processor. Otherwise, just continue.
-    for (; cell!=endc; ++cell)
-      if (((subdomain_id == numbers::invalid_subdomain_id)
-           ||
-           (subdomain_id == cell->subdomain_id()))
-          &&
-          cell->is_locally_owned())
-        {
-          const unsigned int fe_index = cell->active_fe_index();
-          const unsigned int dofs_per_cell =fe_collection[fe_index].dofs_per_cell;
-
-          dofs_on_this_cell.resize (dofs_per_cell);
-          cell->get_dof_indices (dofs_on_this_cell);
-
-
-          // make sparsity pattern for this cell. if no constraints pattern
-          // was given, then the following call acts as if simply no
-          // constraints existed
-          constraints.add_entries_local_to_global (dofs_on_this_cell,
-                                                   sparsity,
-                                                   keep_constrained_dofs,
-                                                   bool_dof_mask[fe_index]);
-        }
+    internal::add_cell_entries (dof, sparsity, constraints,
+                                keep_constrained_dofs, subdomain_id,
+                                bool_dof_mask);
   }
 
 
@@ -619,6 +719,134 @@ namespace DoFTools
     make_flux_sparsity_pattern (dof, sparsity, constraints);
   }
 
+
+
+  template <typename DoFHandlerType>
+  void
+  create_flux_sparsity_pattern (const DoFHandlerType &dof,
+                                SparsityPattern      &sparsity)
+  {
+    const unsigned int dim = DoFHandlerType::dimension;
+    const types::global_dof_index n_dofs = dof.n_dofs();
+
+    Assert (dof.get_triangulation().locally_owned_subdomain() == numbers::invalid_subdomain_id,
+            ExcMessage ("This function can only be used with sequential "
+                        "triangulations."));
+
+    const unsigned int n_active_cells = dof.get_triangulation().n_active_cells();
+
+    // the degrees of freedom of a cell couple with those of the cell itself
+    // and of all active cells that share a face with it. collect these
+    // column indices, sorted, for the given active cell
+    auto get_columns = [&dof](const typename DoFHandlerType::active_cell_iterator &cell,
+                              std::vector<types::global_dof_index> &dofs_on_this_cell,
+                              std::vector<types::global_dof_index> &dofs_on_other_cell,
+                              std::vector<types::global_dof_index> &columns)
+    {
+      dofs_on_this_cell.resize (cell->get_fe().dofs_per_cell);
+      cell->get_dof_indices (dofs_on_this_cell);
+      columns = dofs_on_this_cell;
+
+      for (unsigned int face=0; face<GeometryInfo<dim>::faces_per_cell; ++face)
+        {
+          const bool periodic_neighbor = cell->has_periodic_neighbor(face);
+          if (cell->at_boundary(face) && !periodic_neighbor)
+            continue;
+
+          typename DoFHandlerType::level_cell_iterator neighbor
+            = cell->neighbor_or_periodic_neighbor(face);
+
+          // in 1d, go straight to the cell behind this particular cell's
+          // most terminal child, see make_flux_sparsity_pattern()
+          if (dim==1)
+            while (neighbor->has_children())
+              neighbor = neighbor->child(face==0 ? 1 : 0);
+
+          if (neighbor->has_children())
+            for (unsigned int sub_nr=0; sub_nr!=cell->face(face)->number_of_children(); ++sub_nr)
+              {
+                const typename DoFHandlerType::level_cell_iterator sub_neighbor
+                  = periodic_neighbor ?
+                    cell->periodic_neighbor_child_on_subface (face, sub_nr) :
+                    cell->neighbor_child_on_subface (face, sub_nr);
+                dofs_on_other_cell.resize (sub_neighbor->get_fe().dofs_per_cell);
+                sub_neighbor->get_dof_indices (dofs_on_other_cell);
+                columns.insert (columns.end(), dofs_on_other_cell.begin(),
+                                dofs_on_other_cell.end());
+              }
+          else
+            {
+              dofs_on_other_cell.resize (neighbor->get_fe().dofs_per_cell);
+              neighbor->get_dof_indices (dofs_on_other_cell);
+              columns.insert (columns.end(), dofs_on_other_cell.begin(),
+                              dofs_on_other_cell.end());
+            }
+        }
+
+      std::sort (columns.begin(), columns.end());
+      columns.erase (std::unique (columns.begin(), columns.end()),
+                     columns.end());
+    };
+
+    // if all degrees of freedom are located in the interior of cells, as
+    // for discontinuous elements, every row of the matrix belongs to
+    // exactly one cell and the cells can be worked on in parallel.
+    // otherwise, rows are shared between cells and we work sequentially
+    bool rows_belong_to_one_cell = true;
+    for (const auto &cell : dof.active_cell_iterators())
+      if (cell->get_fe().dofs_per_cell !=
+          cell->get_fe().template n_dofs_per_object<dim>())
+        {
+          rows_belong_to_one_cell = false;
+          break;
+        }
+    const unsigned int grainsize = (rows_belong_to_one_cell ?
+                                    64 : n_active_cells);
+
+    // in a first pass, compute the lengths of the rows. these are exact if
+    // every row belongs to one cell and an upper bound otherwise
+    std::vector<unsigned int> row_lengths (n_dofs, 0);
+    parallel::apply_to_subranges
+    (0U, n_active_cells,
+     [&](const unsigned int begin, const unsigned int end)
+    {
+      std::vector<types::global_dof_index> dofs_on_this_cell, dofs_on_other_cell, columns;
+      for (unsigned int c=begin; c<end; ++c)
+        {
+          get_columns (dof.active_cell_with_index(c),
+                       dofs_on_this_cell, dofs_on_other_cell, columns);
+          for (unsigned int i=0; i<dofs_on_this_cell.size(); ++i)
+            row_lengths[dofs_on_this_cell[i]] += columns.size();
+        }
+    },
+    grainsize);
+    for (types::global_dof_index i=0; i<n_dofs; ++i)
+      row_lengths[i] = std::min<types::global_dof_index> (row_lengths[i], n_dofs);
+
+    // then allocate the sparsity pattern and fill it. since every cell adds
+    // the same sorted set of columns to each of its rows, rows that belong
+    // to one cell are written at once without searching in the row
+    sparsity.reinit (n_dofs, n_dofs, row_lengths);
+    parallel::apply_to_subranges
+    (0U, n_active_cells,
+     [&](const unsigned int begin, const unsigned int end)
+    {
+      std::vector<types::global_dof_index> dofs_on_this_cell, dofs_on_other_cell, columns;
+      for (unsigned int c=begin; c<end; ++c)
+        {
+          get_columns (dof.active_cell_with_index(c),
+                       dofs_on_this_cell, dofs_on_other_cell, columns);
+          for (unsigned int i=0; i<dofs_on_this_cell.size(); ++i)
+            sparsity.add_entries (dofs_on_this_cell[i],
+                                  columns.begin(), columns.end(),
+                                  true);
+        }
+    },
+    grainsize);
+
+    sparsity.compress ();
+  }
+
   template <int dim, int spacedim>
   Table<2,Coupling>
   dof_couplings_from_component_couplings (const FiniteElement<dim,spacedim> &fe,
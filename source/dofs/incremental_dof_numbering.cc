@@ -0,0 +1,200 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/distributed/tria_base.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/incremental_dof_numbering.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/grid/tria_iterator.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, int spacedim>
+IncrementalDoFNumbering<dim,spacedim>::
+IncrementalDoFNumbering (DoFHandler<dim,spacedim> &dof_handler,
+                         const CompactionPolicy    compaction_policy)
+  :
+  dof_handler (&dof_handler, typeid(*this).name()),
+  compaction_policy (compaction_policy),
+  n_old_dofs (0),
+  dofs_per_cell (0),
+  prepared (false),
+  all_numbers_preserved (false)
+{
+  Assert ((dynamic_cast<const parallel::Triangulation<dim,spacedim>*>
+           (&dof_handler.get_triangulation()) == nullptr),
+          ExcMessage ("IncrementalDoFNumbering only works with sequential "
+                      "triangulations."));
+}
+
+
+
+template <int dim, int spacedim>
+void
+IncrementalDoFNumbering<dim,spacedim>::prepare_for_coarsening_and_refinement ()
+{
+  Assert (dof_handler->has_active_dofs(),
+          ExcMessage ("The DoFHandler needs to have distributed its degrees of "
+                      "freedom before the refinement step."));
+
+  n_old_dofs = dof_handler->n_dofs();
+  dofs_per_cell = dof_handler->get_fe().dofs_per_cell;
+  unchanged_cells.clear();
+  unchanged_dof_indices.clear();
+
+  std::vector<types::global_dof_index> local_dof_indices (dofs_per_cell);
+  for (const auto &cell : dof_handler->active_cell_iterators())
+    if (!cell->refine_flag_set() && !cell->coarsen_flag_set())
+      {
+        unchanged_cells.emplace_back (cell->level(), cell->index());
+        cell->get_dof_indices (local_dof_indices);
+        unchanged_dof_indices.insert (unchanged_dof_indices.end(),
+                                      local_dof_indices.begin(),
+                                      local_dof_indices.end());
+      }
+
+  prepared = true;
+}
+
+
+
+template <int dim, int spacedim>
+void
+IncrementalDoFNumbering<dim,spacedim>::distribute_dofs (const FiniteElement<dim,spacedim> &fe)
+{
+  Assert (prepared, ExcNotPrepared());
+  AssertDimension (fe.dofs_per_cell, dofs_per_cell);
+
+  dof_handler->distribute_dofs (fe);
+  const types::global_dof_index n_dofs = dof_handler->n_dofs();
+
+  // for each degree of freedom of the new numbering, find its previous
+  // number if it lives on an unchanged cell
+  std::vector<types::global_dof_index> old_numbers (n_dofs, numbers::invalid_dof_index);
+  std::vector<types::global_dof_index> local_dof_indices (dofs_per_cell);
+  for (unsigned int c=0; c<unchanged_cells.size(); ++c)
+    {
+      const typename DoFHandler<dim,spacedim>::active_cell_iterator
+      cell (&dof_handler->get_triangulation(),
+            unchanged_cells[c].first, unchanged_cells[c].second,
+            &*dof_handler);
+      Assert (cell->active(), ExcInternalError());
+
+      cell->get_dof_indices (local_dof_indices);
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        {
+          Assert ((old_numbers[local_dof_indices[i]] == numbers::invalid_dof_index)
+                  ||
+                  (old_numbers[local_dof_indices[i]] ==
+                   unchanged_dof_indices[c*dofs_per_cell+i]),
+                  ExcInternalError());
+          old_numbers[local_dof_indices[i]] = unchanged_dof_indices[c*dofs_per_cell+i];
+        }
+    }
+
+  // the numbers that are kept must fit into the new range for the numbers
+  // to be preserved
+  all_numbers_preserved = (compaction_policy == preserve_numbers);
+  for (types::global_dof_index i=0; i<n_dofs; ++i)
+    if (old_numbers[i] != numbers::invalid_dof_index && old_numbers[i] >= n_dofs)
+      {
+        all_numbers_preserved = false;
+        break;
+      }
+
+  std::vector<types::global_dof_index> new_numbers (n_dofs);
+  new_dofs.clear ();
+  new_dofs.set_size (n_dofs);
+  if (all_numbers_preserved)
+    {
+      // keep the old numbers, and give the remaining numbers to the new
+      // degrees of freedom in the order of distribute_dofs()
+      std::vector<bool> number_is_used (n_dofs, false);
+      for (types::global_dof_index i=0; i<n_dofs; ++i)
+        if (old_numbers[i] != numbers::invalid_dof_index)
+          {
+            new_numbers[i] = old_numbers[i];
+            number_is_used[old_numbers[i]] = true;
+          }
+
+      types::global_dof_index next_free_number = 0;
+      for (types::global_dof_index i=0; i<n_dofs; ++i)
+        if (old_numbers[i] == numbers::invalid_dof_index)
+          {
+            while (number_is_used[next_free_number])
+              ++next_free_number;
+            new_numbers[i] = next_free_number;
+            new_dofs.add_index (next_free_number);
+            ++next_free_number;
+          }
+    }
+  else
+    {
+      // number the kept degrees of freedom by their rank among the old
+      // numbers that are kept, and the new degrees of freedom after them
+      std::vector<types::global_dof_index> rank_of_old_number (n_old_dofs,
+                                                               numbers::invalid_dof_index);
+      for (types::global_dof_index i=0; i<n_dofs; ++i)
+        if (old_numbers[i] != numbers::invalid_dof_index)
+          rank_of_old_number[old_numbers[i]] = 0;
+      types::global_dof_index n_kept_dofs = 0;
+      for (types::global_dof_index j=0; j<n_old_dofs; ++j)
+        if (rank_of_old_number[j] != numbers::invalid_dof_index)
+          rank_of_old_number[j] = n_kept_dofs++;
+
+      types::global_dof_index next_free_number = n_kept_dofs;
+      for (types::global_dof_index i=0; i<n_dofs; ++i)
+        if (old_numbers[i] != numbers::invalid_dof_index)
+          new_numbers[i] = rank_of_old_number[old_numbers[i]];
+        else
+          new_numbers[i] = next_free_number++;
+      new_dofs.add_range (n_kept_dofs, n_dofs);
+    }
+  new_dofs.compress ();
+
+  old_to_new_numbers.assign (n_old_dofs, numbers::invalid_dof_index);
+  for (types::global_dof_index i=0; i<n_dofs; ++i)
+    if (old_numbers[i] != numbers::invalid_dof_index)
+      old_to_new_numbers[old_numbers[i]] = new_numbers[i];
+
+  dof_handler->renumber_dofs (new_numbers);
+
+  // the stored data refer to the mesh before the refinement step
+  unchanged_cells.clear ();
+  std::vector<types::global_dof_index>().swap (unchanged_dof_indices);
+  prepared = false;
+}
+
+
+
+template <int dim, int spacedim>
+std::size_t
+IncrementalDoFNumbering<dim,spacedim>::memory_consumption () const
+{
+  return (sizeof(*this) +
+          MemoryConsumption::memory_consumption (unchanged_cells) +
+          MemoryConsumption::memory_consumption (unchanged_dof_indices) +
+          new_dofs.memory_consumption () +
+          MemoryConsumption::memory_consumption (old_to_new_numbers));
+}
+
+
+// explicit instantiations
+#include "incremental_dof_numbering.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
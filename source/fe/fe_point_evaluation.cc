@@ -0,0 +1,361 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/tensor_product_polynomials.h>
+#include <deal.II/fe/fe_point_evaluation.h>
+#include <deal.II/fe/fe_poly.h>
+#include <deal.II/fe/fe_tools.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include <boost/container/small_vector.hpp>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace FEPointEvaluationImplementation
+  {
+    /**
+     * Evaluate the value and the first derivative of the one-dimensional
+     * polynomials at the coordinate @p x, storing them in consecutive entries
+     * of @p values for each polynomial.
+     */
+    inline
+    void
+    evaluate_polynomials (const std::vector<Polynomials::Polynomial<double> > &polynomials,
+                          const double                                         x,
+                          double                                              *values)
+    {
+      for (unsigned int i=0; i<polynomials.size(); ++i)
+        polynomials[i].value (x, 1, values+2*i);
+    }
+
+
+
+    /**
+     * Evaluate the value and the gradient of the tensor product of @p n
+     * one-dimensional polynomials per direction with the given @p
+     * coefficients in lexicographic numbering at a point, where @p shapes
+     * holds the values and the derivatives of the polynomials at the
+     * coordinates of the point as computed by evaluate_polynomials() for all
+     * directions. The sums are done one direction at a time.
+     */
+    template <int dim>
+    inline
+    void
+    evaluate_tensor_product (const unsigned int n,
+                             const double      *shapes,
+                             const double      *coefficients,
+                             double            &value,
+                             Tensor<1,dim>     &gradient)
+    {
+      const unsigned int n_y = (dim > 1 ? n : 1);
+      const unsigned int n_z = (dim > 2 ? n : 1);
+      const double *shapes_x = shapes;
+      const double *shapes_y = shapes + (dim > 1 ? 2*n : 0);
+      const double *shapes_z = shapes + (dim > 2 ? 4*n : 0);
+
+      value = 0.;
+      gradient = Tensor<1,dim>();
+      for (unsigned int k=0; k<n_z; ++k)
+        {
+          double value_y = 0., derivative_y[2] = {0., 0.};
+          for (unsigned int j=0; j<n_y; ++j)
+            {
+              const double *c = coefficients + (k*n_y+j)*n;
+              double value_x = 0., derivative_x = 0.;
+              for (unsigned int i=0; i<n; ++i)
+                {
+                  value_x      += c[i] * shapes_x[2*i];
+                  derivative_x += c[i] * shapes_x[2*i+1];
+                }
+              if (dim > 1)
+                {
+                  value_y         += value_x      * shapes_y[2*j];
+                  derivative_y[0] += derivative_x * shapes_y[2*j];
+                  derivative_y[1] += value_x      * shapes_y[2*j+1];
+                }
+              else
+                {
+                  value_y         = value_x;
+                  derivative_y[0] = derivative_x;
+                }
+            }
+          if (dim > 2)
+            {
+              value             += value_y         * shapes_z[2*k];
+              gradient[0]       += derivative_y[0] * shapes_z[2*k];
+              gradient[1]       += derivative_y[1] * shapes_z[2*k];
+              gradient[dim-1]   += value_y         * shapes_z[2*k+1];
+            }
+          else
+            {
+              value       = value_y;
+              gradient[0] = derivative_y[0];
+              if (dim > 1)
+                gradient[dim-1] = derivative_y[1];
+            }
+        }
+    }
+  }
+}
+
+
+
+template <int dim>
+FEPointEvaluation<dim>::FEPointEvaluation (const MappingQGeneric<dim> &mapping,
+                                           const FiniteElement<dim>   &fe)
+  :
+  mapping (&mapping, typeid(*this).name()),
+  fe (&fe, typeid(*this).name())
+{
+  Assert (fe.n_components() == 1,
+          ExcMessage ("FEPointEvaluation only supports scalar finite elements."));
+
+  // the polynomials of the mapping are the tensor product Lagrange
+  // polynomials in the Gauss-Lobatto points, with the support points
+  // returned by MappingQGeneric::compute_mapping_support_points() in the
+  // hierarchic numbering of FE_Q
+  const unsigned int mapping_degree = mapping.get_degree();
+  mapping_polynomials = Polynomials::generate_complete_Lagrange_basis
+                        (QGaussLobatto<1>(mapping_degree+1).get_points());
+  mapping_lexicographic_numbering.resize (Utilities::fixed_power<dim>(mapping_degree+1));
+  FETools::hierarchic_to_lexicographic_numbering<dim> (mapping_degree,
+                                                       mapping_lexicographic_numbering);
+  mapping_support_points.resize (dim*mapping_lexicographic_numbering.size());
+
+  // check whether the element is the tensor product of the Lagrange
+  // polynomials in its one-dimensional support points (FE_Q, FE_DGQ,
+  // FE_DGQArbitraryNodes)
+  const FE_Poly<TensorProductPolynomials<dim>,dim,dim> *fe_poly =
+    dynamic_cast<const FE_Poly<TensorProductPolynomials<dim>,dim,dim>*>(&fe);
+  if (fe_poly != nullptr && fe_poly->has_support_points() &&
+      Utilities::fixed_power<dim>(fe_poly->degree+1) == fe.dofs_per_cell)
+    {
+      const unsigned int n_1d = fe_poly->degree+1;
+      const std::vector<unsigned int> lexicographic =
+        fe_poly->get_poly_space_numbering_inverse();
+      std::vector<Point<1> > points_1d (n_1d);
+      for (unsigned int i=0; i<n_1d; ++i)
+        points_1d[i][0] = fe.get_unit_support_points()[lexicographic[i]][0];
+      const std::vector<Polynomials::Polynomial<double> > polynomials =
+        Polynomials::generate_complete_Lagrange_basis (points_1d);
+
+      // verify that the tensor product reproduces the shape functions of the
+      // element at some point inside the cell
+      Point<dim> test_point;
+      for (unsigned int d=0; d<dim; ++d)
+        test_point[d] = 0.31 + 0.17*d;
+      std::vector<double> shapes (2*dim*n_1d);
+      for (unsigned int d=0; d<dim; ++d)
+        internal::FEPointEvaluationImplementation::evaluate_polynomials
+        (polynomials, test_point[d], &shapes[2*d*n_1d]);
+
+      bool is_tensor_product = true;
+      for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+        {
+          double value = 1.;
+          unsigned int index = i;
+          for (unsigned int d=0; d<dim; ++d, index /= n_1d)
+            value *= shapes[2*(d*n_1d+index%n_1d)];
+          if (std::abs(value - fe.shape_value(lexicographic[i], test_point)) > 1e-10)
+            is_tensor_product = false;
+        }
+
+      if (is_tensor_product)
+        {
+          fe_polynomials = polynomials;
+          fe_lexicographic_numbering = lexicographic;
+          lexicographic_values.resize (fe.dofs_per_cell);
+        }
+    }
+}
+
+
+
+template <int dim>
+void
+FEPointEvaluation<dim>::reinit (const typename Triangulation<dim>::cell_iterator &cell,
+                                const std::vector<Point<dim> >                   &unit_points)
+{
+  reinit (cell, ArrayView<const Point<dim> >(unit_points.data(),
+                                             unit_points.size()));
+}
+
+
+
+template <int dim>
+void
+FEPointEvaluation<dim>::reinit (const typename Triangulation<dim>::cell_iterator &cell,
+                                const ArrayView<const Point<dim> >               &points)
+{
+  const unsigned int n_q_points = points.size();
+  unit_points.assign (points.begin(), points.end());
+  real_points.resize (n_q_points);
+  jacobians.resize (n_q_points);
+  inverse_jacobians.resize (n_q_points);
+
+  // collect the mapping support points in lexicographic numbering, one
+  // coordinate direction after the other
+  const std::vector<Point<dim> > support_points =
+    mapping->compute_mapping_support_points (cell);
+  const unsigned int n_mapping_points = mapping_lexicographic_numbering.size();
+  AssertDimension (support_points.size(), n_mapping_points);
+  for (unsigned int k=0; k<n_mapping_points; ++k)
+    for (unsigned int d=0; d<dim; ++d)
+      mapping_support_points[d*n_mapping_points+mapping_lexicographic_numbering[k]] =
+        support_points[k][d];
+
+  const unsigned int n_mapping_1d = mapping_polynomials.size();
+  boost::container::small_vector<double, 64> mapping_shapes (2*dim*n_mapping_1d);
+  for (unsigned int q=0; q<n_q_points; ++q)
+    {
+      for (unsigned int d=0; d<dim; ++d)
+        internal::FEPointEvaluationImplementation::evaluate_polynomials
+        (mapping_polynomials, unit_points[q][d], &mapping_shapes[2*d*n_mapping_1d]);
+
+      Tensor<1,dim> derivatives;
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          internal::FEPointEvaluationImplementation::evaluate_tensor_product<dim>
+          (n_mapping_1d, mapping_shapes.data(),
+           &mapping_support_points[d*n_mapping_points],
+           real_points[q][d], derivatives);
+          for (unsigned int e=0; e<dim; ++e)
+            jacobians[q][d][e] = derivatives[e];
+        }
+#ifdef DEBUG
+      const double det = determinant(jacobians[q]);
+      Assert (det > 1e-12*Utilities::fixed_power<dim>(cell->diameter()/
+                                                       std::sqrt(double(dim))),
+              (typename Mapping<dim>::ExcDistortedMappedCell(cell->center(), det, q)));
+#endif
+      inverse_jacobians[q] = invert(jacobians[q]);
+    }
+
+  // evaluate the shape functions of the element, either through the
+  // one-dimensional polynomials or through the element itself
+  if (uses_tensor_product_evaluation())
+    {
+      const unsigned int n_1d = fe_polynomials.size();
+      fe_polynomial_values.resize (n_q_points*2*dim*n_1d);
+      for (unsigned int q=0; q<n_q_points; ++q)
+        for (unsigned int d=0; d<dim; ++d)
+          internal::FEPointEvaluationImplementation::evaluate_polynomials
+          (fe_polynomials, unit_points[q][d], &fe_polynomial_values[2*(q*dim+d)*n_1d]);
+    }
+  else
+    {
+      if (shape_values.n_cols() != n_q_points)
+        {
+          shape_values.reinit (fe->dofs_per_cell, n_q_points);
+          shape_gradients.reinit (fe->dofs_per_cell, n_q_points);
+        }
+      for (unsigned int i=0; i<fe->dofs_per_cell; ++i)
+        for (unsigned int q=0; q<n_q_points; ++q)
+          {
+            shape_values(i,q) = fe->shape_value (i, unit_points[q]);
+            shape_gradients(i,q) = fe->shape_grad (i, unit_points[q]);
+          }
+    }
+
+  values.resize (n_q_points);
+  unit_gradients.resize (n_q_points);
+  gradients.resize (n_q_points);
+}
+
+
+
+template <int dim>
+void
+FEPointEvaluation<dim>::evaluate (const ArrayView<const double> &solution_values,
+                                  const bool                     evaluate_values,
+                                  const bool                     evaluate_gradients)
+{
+  AssertDimension (solution_values.size(), fe->dofs_per_cell);
+  const unsigned int n_q_points = unit_points.size();
+
+  if (uses_tensor_product_evaluation())
+    {
+      // the value comes almost for free with the gradient, so compute both
+      const unsigned int n_1d = fe_polynomials.size();
+      for (unsigned int i=0; i<fe->dofs_per_cell; ++i)
+        lexicographic_values[i] = solution_values[fe_lexicographic_numbering[i]];
+      for (unsigned int q=0; q<n_q_points; ++q)
+        internal::FEPointEvaluationImplementation::evaluate_tensor_product<dim>
+        (n_1d, &fe_polynomial_values[2*q*dim*n_1d], lexicographic_values.data(),
+         values[q], unit_gradients[q]);
+    }
+  else
+    for (unsigned int q=0; q<n_q_points; ++q)
+      {
+        double value = 0.;
+        Tensor<1,dim> unit_gradient;
+        for (unsigned int i=0; i<fe->dofs_per_cell; ++i)
+          {
+            if (evaluate_values)
+              value += solution_values[i] * shape_values(i,q);
+            if (evaluate_gradients)
+              unit_gradient += solution_values[i] * shape_gradients(i,q);
+          }
+        values[q] = value;
+        unit_gradients[q] = unit_gradient;
+      }
+
+  // the gradients are transformed to real space by the transpose of the
+  // inverse Jacobian
+  if (evaluate_gradients)
+    for (unsigned int q=0; q<n_q_points; ++q)
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          double sum = inverse_jacobians[q][0][d] * unit_gradients[q][0];
+          for (unsigned int e=1; e<dim; ++e)
+            sum += inverse_jacobians[q][e][d] * unit_gradients[q][e];
+          gradients[q][d] = sum;
+        }
+}
+
+
+
+template <int dim>
+std::size_t
+FEPointEvaluation<dim>::memory_consumption () const
+{
+  return (sizeof(*this) +
+          MemoryConsumption::memory_consumption (fe_lexicographic_numbering) +
+          MemoryConsumption::memory_consumption (mapping_lexicographic_numbering) +
+          MemoryConsumption::memory_consumption (mapping_support_points) +
+          MemoryConsumption::memory_consumption (fe_polynomial_values) +
+          MemoryConsumption::memory_consumption (shape_values) +
+          MemoryConsumption::memory_consumption (shape_gradients) +
+          MemoryConsumption::memory_consumption (lexicographic_values) +
+          MemoryConsumption::memory_consumption (unit_points) +
+          MemoryConsumption::memory_consumption (real_points) +
+          MemoryConsumption::memory_consumption (jacobians) +
+          MemoryConsumption::memory_consumption (inverse_jacobians) +
+          MemoryConsumption::memory_consumption (values) +
+          MemoryConsumption::memory_consumption (unit_gradients) +
+          MemoryConsumption::memory_consumption (gradients));
+}
+
+
+// explicit instantiations
+#include "fe_point_evaluation.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -71,15 +71,9 @@ FE_RaviartThomas<dim>::FE_RaviartThomas (const unsigned int deg)
   // and similar functions will be the correct ones, not
   // the raw shape functions from the polynomial space anymore.
 
-  // Reinit the vectors of
-  // restriction and prolongation
-  // matrices to the right sizes.
-  // Restriction only for isotropic
-  // refinement
-  this->reinit_restriction_and_prolongation_matrices(true);
-  // Fill prolongation matrices with embedding operators
-  FETools::compute_embedding_matrices (*this, this->prolongation);
-  initialize_restriction();
+  // do not initialize embedding and restriction here. these matrices are
+  // initialized on demand in get_restriction_matrix and
+  // get_prolongation_matrix
 
   // TODO[TL]: for anisotropic refinement we will probably need a table of submatrices with an array for each refine case
   FullMatrix<double> face_embeddings[GeometryInfo<dim>::max_children_per_face];
@@ -497,6 +491,90 @@ convert_generalized_support_point_values_to_dof_values(const std::vector<Vector<
 
 
 
+template <int dim>
+void
+FE_RaviartThomas<dim>::initialize_embedding_and_restriction ()
+{
+  // Reinit the vectors of
+  // restriction and prolongation
+  // matrices to the right sizes.
+  // Restriction only for isotropic
+  // refinement
+  this->reinit_restriction_and_prolongation_matrices(true);
+  // Fill prolongation matrices with embedding operators
+  FETools::compute_embedding_matrices (*this, this->prolongation);
+  initialize_restriction();
+}
+
+
+
+template <int dim>
+const FullMatrix<double> &
+FE_RaviartThomas<dim>
+::get_prolongation_matrix (const unsigned int child,
+                           const RefinementCase<dim> &refinement_case) const
+{
+  Assert (refinement_case<RefinementCase<dim>::isotropic_refinement+1,
+          ExcIndexRange(refinement_case,0,RefinementCase<dim>::isotropic_refinement+1));
+  Assert (refinement_case!=RefinementCase<dim>::no_refinement,
+          ExcMessage("Prolongation matrices are only available for refined cells!"));
+  Assert (child<GeometryInfo<dim>::n_children(refinement_case),
+          ExcIndexRange(child,0,GeometryInfo<dim>::n_children(refinement_case)));
+
+  // initialization upon first request
+  if (this->prolongation[refinement_case-1][child].n() == 0)
+    {
+      Threads::Mutex::ScopedLock lock(this->mutex);
+
+      // if matrix got updated while waiting for the lock
+      if (this->prolongation[refinement_case-1][child].n() ==
+          this->dofs_per_cell)
+        return this->prolongation[refinement_case-1][child];
+
+      // now do the work. need to get a non-const version of data in order to
+      // be able to modify them inside a const function
+      const_cast<FE_RaviartThomas<dim>&>(*this).initialize_embedding_and_restriction ();
+    }
+
+  // we use refinement_case-1 here. the -1 takes care of the origin of the
+  // vector, as for RefinementCase<dim>::no_refinement (=0) there is no data
+  // available and so the vector indices are shifted
+  return this->prolongation[refinement_case-1][child];
+}
+
+
+
+template <int dim>
+const FullMatrix<double> &
+FE_RaviartThomas<dim>
+::get_restriction_matrix (const unsigned int child,
+                          const RefinementCase<dim> &refinement_case) const
+{
+  Assert (refinement_case<RefinementCase<dim>::isotropic_refinement+1,
+          ExcIndexRange(refinement_case,0,RefinementCase<dim>::isotropic_refinement+1));
+  Assert (refinement_case!=RefinementCase<dim>::no_refinement,
+          ExcMessage("Restriction matrices are only available for refined cells!"));
+  Assert (child<GeometryInfo<dim>::n_children(RefinementCase<dim>(refinement_case)),
+          ExcIndexRange(child,0,GeometryInfo<dim>::n_children(RefinementCase<dim>(refinement_case))));
+
+  // initialization upon first request. only the matrices of the isotropic
+  // refinement are computed, so check on those
+  const unsigned int iso = RefinementCase<dim>::isotropic_refinement-1;
+  if (this->restriction[iso][child].n() == 0)
+    {
+      Threads::Mutex::ScopedLock lock(this->mutex);
+
+      // if matrix got updated while waiting for the lock
+      if (this->restriction[iso][child].n() != this->dofs_per_cell)
+        const_cast<FE_RaviartThomas<dim>&>(*this).initialize_embedding_and_restriction ();
+    }
+
+  // let the base class check that the matrix is available
+  return FiniteElement<dim>::get_restriction_matrix (child, refinement_case);
+}
+
+
+
 template <int dim>
 std::size_t
 FE_RaviartThomas<dim>::memory_consumption () const
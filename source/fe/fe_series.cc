@@ -17,6 +17,7 @@
 
 #include <deal.II/fe/fe_series.h>
 #include <deal.II/base/numbers.h>
+#include <deal.II/base/parallel.h>
 
 #include <cctype>
 #include <iostream>
@@ -32,6 +33,81 @@ DEAL_II_NAMESPACE_OPEN
 namespace FESeries
 {
 
+  namespace
+  {
+    /**
+     * Multiply the transformation @p matrix with @p local_dof_values and
+     * store the result in @p coefficients. @p unrolled_coefficients is used
+     * as scratch space.
+     */
+    template <int dim, typename CoefficientType>
+    void
+    apply_transformation_matrix (const FullMatrix<CoefficientType> &matrix,
+                                 const Vector<double>              &local_dof_values,
+                                 std::vector<CoefficientType>      &unrolled_coefficients,
+                                 Table<dim,CoefficientType>        &coefficients)
+    {
+      Assert (local_dof_values.size() == matrix.n(),
+              ExcDimensionMismatch(local_dof_values.size(),matrix.n()));
+      Assert (coefficients.n_elements() == matrix.m(),
+              ExcDimensionMismatch(coefficients.n_elements(),matrix.m()));
+
+      unrolled_coefficients.resize (matrix.m());
+      const unsigned int n_dofs = matrix.n();
+      for (unsigned int i = 0; i < matrix.m(); ++i)
+        {
+          CoefficientType sum = CoefficientType();
+          if (n_dofs > 0)
+            {
+              const CoefficientType *matrix_row = &matrix(i,0);
+              for (unsigned int j = 0; j < n_dofs; ++j)
+                sum += matrix_row[j] * local_dof_values[j];
+            }
+          unrolled_coefficients[i] = sum;
+        }
+
+      coefficients.fill(unrolled_coefficients.begin());
+    }
+
+
+
+    /**
+     * Apply the transformation matrices @p matrices to the local values of
+     * all cells in parallel. The matrices of all finite elements used need
+     * to exist already.
+     */
+    template <int dim, typename CoefficientType>
+    void
+    apply_transformation_matrices (const std::vector<FullMatrix<CoefficientType> > &matrices,
+                                   const std::vector<Vector<double> >              &local_dof_values,
+                                   const std::vector<unsigned int>                 &cell_active_fe_indices,
+                                   const TableIndices<dim>                         &coefficients_size,
+                                   std::vector<Table<dim,CoefficientType> >        &coefficients)
+    {
+      AssertDimension (local_dof_values.size(), cell_active_fe_indices.size());
+
+      coefficients.resize (local_dof_values.size());
+      parallel::apply_to_subranges
+      (0U, static_cast<unsigned int>(local_dof_values.size()),
+       [&](const unsigned int begin,
+           const unsigned int end)
+      {
+        std::vector<CoefficientType> unrolled_coefficients;
+        for (unsigned int cell=begin; cell<end; ++cell)
+          {
+            coefficients[cell].reinit (coefficients_size);
+            apply_transformation_matrix (matrices[cell_active_fe_indices[cell]],
+                                         local_dof_values[cell],
+                                         unrolled_coefficients,
+                                         coefficients[cell]);
+          }
+      },
+      64);
+    }
+  }
+
+
+
   /*-------------- Fourier -------------------------------*/
 
   void set_k_vectors(Table<1, Tensor<1,1> > &k_vectors,
@@ -89,24 +165,29 @@ namespace FESeries
                                Table<dim,std::complex<double> > &fourier_coefficients)
   {
     ensure_existence(cell_active_fe_index);
-    const FullMatrix<std::complex<double> > &matrix = fourier_transform_matrices[cell_active_fe_index];
-
-    std::fill(unrolled_coefficients.begin(),
-              unrolled_coefficients.end(),
-              std::complex<double>(0.));
-
-    Assert (unrolled_coefficients.size() == matrix.m(),
-            ExcInternalError());
+    apply_transformation_matrix (fourier_transform_matrices[cell_active_fe_index],
+                                 local_dof_values,
+                                 unrolled_coefficients,
+                                 fourier_coefficients);
+  }
 
-    Assert (local_dof_values.size() == matrix.n(),
-            ExcDimensionMismatch(local_dof_values.size(),matrix.n()));
 
-    for (unsigned int i = 0; i < unrolled_coefficients.size(); i++)
-      for (unsigned int j = 0; j < local_dof_values.size(); j++)
-        unrolled_coefficients[i] += matrix[i][j] *
-                                    local_dof_values[j];
 
-    fourier_coefficients.fill(unrolled_coefficients.begin());
+  template <int dim>
+  void Fourier<dim>::calculate(const std::vector<Vector<double> >             &local_dof_values,
+                               const std::vector<unsigned int>                &cell_active_fe_indices,
+                               std::vector<Table<dim,std::complex<double> > > &fourier_coefficients)
+  {
+    // computing the transformation matrices modifies this object, so do it
+    // before going parallel
+    for (unsigned int i=0; i<cell_active_fe_indices.size(); ++i)
+      ensure_existence(cell_active_fe_indices[i]);
+
+    apply_transformation_matrices (fourier_transform_matrices,
+                                   local_dof_values,
+                                   cell_active_fe_indices,
+                                   k_vectors.size(),
+                                   fourier_coefficients);
   }
 
   template <int dim>
@@ -261,24 +342,33 @@ namespace FESeries
                                 Table<dim,double>            &legendre_coefficients)
   {
     ensure_existence(cell_active_fe_index);
-    const FullMatrix<double> &matrix = legendre_transform_matrices[cell_active_fe_index];
-
-    std::fill(unrolled_coefficients.begin(),
-              unrolled_coefficients.end(),
-              0.);
-
-    Assert (unrolled_coefficients.size() == matrix.m(),
-            ExcInternalError());
+    apply_transformation_matrix (legendre_transform_matrices[cell_active_fe_index],
+                                 local_dof_values,
+                                 unrolled_coefficients,
+                                 legendre_coefficients);
+  }
 
-    Assert (local_dof_values.size() == matrix.n(),
-            ExcDimensionMismatch(local_dof_values.size(),matrix.n()));
 
-    for (unsigned int i = 0; i < unrolled_coefficients.size(); i++)
-      for (unsigned int j = 0; j < local_dof_values.size(); j++)
-        unrolled_coefficients[i] += matrix[i][j] *
-                                    local_dof_values[j];
 
-    legendre_coefficients.fill(unrolled_coefficients.begin());
+  template <int dim>
+  void Legendre<dim>::calculate(const std::vector<Vector<double> > &local_dof_values,
+                                const std::vector<unsigned int>    &cell_active_fe_indices,
+                                std::vector<Table<dim,double> >    &legendre_coefficients)
+  {
+    // computing the transformation matrices modifies this object, so do it
+    // before going parallel
+    for (unsigned int i=0; i<cell_active_fe_indices.size(); ++i)
+      ensure_existence(cell_active_fe_indices[i]);
+
+    TableIndices<dim> coefficients_size;
+    for (unsigned int d=0; d<dim; ++d)
+      coefficients_size[d] = N;
+
+    apply_transformation_matrices (legendre_transform_matrices,
+                                   local_dof_values,
+                                   cell_active_fe_indices,
+                                   coefficients_size,
+                                   legendre_coefficients);
   }
 
 
@@ -1213,76 +1213,55 @@ compute_fill (const Mapping<dim,spacedim>                      &mapping,
                                          mapping, mapping_internal, mapping_data,
                                          base_fe_data, base_data);
 
-        // now data has been generated, so copy it. we used to work by
-        // looping over all base elements (i.e. this outer loop), then over
-        // multiplicity, then over the shape functions from that base
-        // element, but that requires that we can infer the global number of
-        // a shape function from its number in the base element. for that we
-        // had the component_to_system_table.
+        // now data has been generated, so copy it. all copies of the base
+        // element share the data of the base element, and every shape
+        // function of the composed element that belongs to this base element
+        // gets its data from the rows of the respective shape function of
+        // the base element.
         //
-        // however, this does of course no longer work since we have
-        // non-primitive elements. so we go the other way round: loop over
-        // all shape functions of the composed element, and here only treat
-        // those shape functions that belong to a given base element
-        //TODO: Introduce the needed table and loop only over base element shape functions. This here is not efficient at all AND very bad style
-        const UpdateFlags base_flags = base_fe_data.update_each;
-
         // some base element might involve values that depend on the shape
         // of the geometry, so we always need to copy the shape values around
         // also in case we detected a cell similarity (but no heavy work will
         // be done inside the individual elements in case we have a
         // translation and simple elements).
-        for (unsigned int system_index=0; system_index<this->dofs_per_cell;
-             ++system_index)
-          if (this->system_to_base_table[system_index].first.first == base_no)
-            {
-              const unsigned int
-              base_index = this->system_to_base_table[system_index].second;
-              Assert (base_index<base_fe.dofs_per_cell, ExcInternalError());
-
-              // now copy. if the shape function is primitive, then there
-              // is only one value to be copied, but for non-primitive
-              // elements, there might be more values to be copied
-              //
-              // so, find out from which index to take this one value, and
-              // to which index to put
-              unsigned int out_index = 0;
-              for (unsigned int i=0; i<system_index; ++i)
-                out_index += this->n_nonzero_components(i);
-              unsigned int in_index = 0;
-              for (unsigned int i=0; i<base_index; ++i)
-                in_index += base_fe.n_nonzero_components(i);
-
-              // then loop over the number of components to be copied
-              Assert (this->n_nonzero_components(system_index) ==
-                      base_fe.n_nonzero_components(base_index),
-                      ExcInternalError());
-
-              if (base_flags & update_values)
-                for (unsigned int s=0; s<this->n_nonzero_components(system_index); ++s)
-                  for (unsigned int q=0; q<n_q_points; ++q)
-                    output_data.shape_values[out_index+s][q] =
-                      base_data.shape_values(in_index+s,q);
-
-              if (base_flags & update_gradients)
-                for (unsigned int s=0; s<this->n_nonzero_components(system_index); ++s)
-                  for (unsigned int q=0; q<n_q_points; ++q)
-                    output_data.shape_gradients[out_index+s][q] =
-                      base_data.shape_gradients[in_index+s][q];
-
-              if (base_flags & update_hessians)
-                for (unsigned int s=0; s<this->n_nonzero_components(system_index); ++s)
-                  for (unsigned int q=0; q<n_q_points; ++q)
-                    output_data.shape_hessians[out_index+s][q] =
-                      base_data.shape_hessians[in_index+s][q];
-
-              if (base_flags & update_3rd_derivatives)
-                for (unsigned int s=0; s<this->n_nonzero_components(system_index); ++s)
-                  for (unsigned int q=0; q<n_q_points; ++q)
-                    output_data.shape_3rd_derivatives[out_index+s][q] =
-                      base_data.shape_3rd_derivatives[in_index+s][q];
+        const UpdateFlags base_flags = base_fe_data.update_each;
 
-            }
+        for (const std::array<unsigned int,3> &entry :
+             base_element_shape_function_table[base_no])
+          {
+            // if the shape function is primitive, then there is only one
+            // value to be copied, but for non-primitive elements, there
+            // might be more values to be copied
+            const unsigned int system_index = entry[0];
+            const unsigned int out_index    = entry[1];
+            const unsigned int in_index     = entry[2];
+            const unsigned int n_nonzero_components =
+              this->n_nonzero_components(system_index);
+
+            if (base_flags & update_values)
+              for (unsigned int s=0; s<n_nonzero_components; ++s)
+                for (unsigned int q=0; q<n_q_points; ++q)
+                  output_data.shape_values[out_index+s][q] =
+                    base_data.shape_values(in_index+s,q);
+
+            if (base_flags & update_gradients)
+              for (unsigned int s=0; s<n_nonzero_components; ++s)
+                for (unsigned int q=0; q<n_q_points; ++q)
+                  output_data.shape_gradients[out_index+s][q] =
+                    base_data.shape_gradients[in_index+s][q];
+
+            if (base_flags & update_hessians)
+              for (unsigned int s=0; s<n_nonzero_components; ++s)
+                for (unsigned int q=0; q<n_q_points; ++q)
+                  output_data.shape_hessians[out_index+s][q] =
+                    base_data.shape_hessians[in_index+s][q];
+
+            if (base_flags & update_3rd_derivatives)
+              for (unsigned int s=0; s<n_nonzero_components; ++s)
+                for (unsigned int q=0; q<n_q_points; ++q)
+                  output_data.shape_3rd_derivatives[out_index+s][q] =
+                    base_data.shape_3rd_derivatives[in_index+s][q];
+          }
       }
 }
 
@@ -1524,6 +1503,36 @@ void FESystem<dim,spacedim>::initialize (const std::vector<const FiniteElement<d
                                             this->face_system_to_component_table,
                                             *this);
 
+    // collect the shape functions of each base element together with the
+    // first row of their nonzero components in the tables of shape values
+    // of this element and of the base element
+    base_element_shape_function_table.resize(this->n_base_elements());
+    std::vector<std::vector<unsigned int> > base_rows(this->n_base_elements());
+    for (unsigned int b=0; b<this->n_base_elements(); ++b)
+      {
+        base_rows[b].resize(base_element(b).dofs_per_cell);
+        unsigned int row = 0;
+        for (unsigned int i=0; i<base_element(b).dofs_per_cell; ++i)
+          {
+            base_rows[b][i] = row;
+            row += base_element(b).n_nonzero_components(i);
+          }
+      }
+
+    unsigned int row = 0;
+    for (unsigned int i=0; i<this->dofs_per_cell; ++i)
+      {
+        const unsigned int
+        base       = this->system_to_base_table[i].first.first,
+        base_index = this->system_to_base_table[i].second;
+        Assert (base_index<base_element(base).dofs_per_cell, ExcInternalError());
+        Assert (this->n_nonzero_components(i) ==
+                base_element(base).n_nonzero_components(base_index),
+                ExcInternalError());
+        base_element_shape_function_table[base].push_back
+        ({{i, row, base_rows[base][base_index]}});
+        row += this->n_nonzero_components(i);
+      }
   }
 
   // now initialize interface constraints, support points, and other tables.
@@ -2355,6 +2364,9 @@ FESystem<dim,spacedim>::memory_consumption () const
                      sizeof (base_elements));
   for (unsigned int i=0; i<base_elements.size(); ++i)
     mem += MemoryConsumption::memory_consumption (*base_elements[i].first);
+  for (unsigned int i=0; i<base_element_shape_function_table.size(); ++i)
+    mem += (base_element_shape_function_table[i].capacity() *
+            sizeof(std::array<unsigned int,3>));
   return mem;
 }
 
@@ -19,6 +19,7 @@
 #include <deal.II/base/numbers.h>
 #include <deal.II/base/quadrature.h>
 #include <deal.II/base/signaling_nan.h>
+#include <deal.II/base/tensor_product_polynomials.h>
 #include <deal.II/differentiation/ad.h>
 #include <deal.II/lac/vector.h>
 #include <deal.II/lac/block_vector.h>
@@ -37,7 +38,10 @@
 #include <deal.II/fe/mapping_q1.h>
 #include <deal.II/fe/fe_values.h>
 #include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_poly.h>
+#include <deal.II/matrix_free/tensor_product_kernels.h>
 
+#include <cmath>
 #include <iomanip>
 #include <memory>
 #include <type_traits>
@@ -1346,6 +1350,10 @@ namespace FEValuesViews
     // get function values of dofs on this cell and call internal worker function
     dealii::Vector<typename InputVector::value_type> dof_values(fe_values->dofs_per_cell);
     fe_values->present_cell->get_interpolated_dof_values(fe_function, dof_values);
+    AssertDimension (values.size(), fe_values->n_quadrature_points);
+    if (fe_values->fe->n_components() == 1 &&
+        fe_values->get_function_values_with_sum_factorization (dof_values.begin(), values.data()))
+      return;
     internal::do_function_values<dim,spacedim>
     (make_array_view(dof_values.begin(), dof_values.end()),
      fe_values->finite_element_output.shape_values, shape_function_data, values);
@@ -1388,6 +1396,11 @@ namespace FEValuesViews
     // get function values of dofs on this cell
     dealii::Vector<typename InputVector::value_type> dof_values (fe_values->dofs_per_cell);
     fe_values->present_cell->get_interpolated_dof_values(fe_function, dof_values);
+    AssertDimension (gradients.size(), fe_values->n_quadrature_points);
+    if (fe_values->fe->n_components() == 1 &&
+        fe_values->get_function_gradients_with_sum_factorization (dof_values.begin(),
+            gradients.data()))
+      return;
     internal::do_function_derivatives<1,dim,spacedim>
     (make_array_view(dof_values.begin(), dof_values.end()),
      fe_values->finite_element_output.shape_gradients, shape_function_data, gradients);
@@ -2996,6 +3009,138 @@ namespace internal
         }
   }
 
+  // evaluate several finite element functions at once. the dof values of
+  // function v are given in dof_values_ptr[v*dofs_per_cell+i]. the loop over
+  // the shape functions is the outermost one, so that each row of the shape
+  // function table is read once for all functions rather than once per
+  // function
+  template <int dim, int spacedim, typename Number>
+  void
+  do_function_values_multiple (const Number                                     *dof_values_ptr,
+                               const dealii::Table<2,double>                    &shape_values,
+                               const FiniteElement<dim,spacedim>                &fe,
+                               const std::vector<unsigned int>                  &shape_function_to_row_table,
+                               std::vector<std::vector<dealii::Vector<Number> > > &values)
+  {
+    const unsigned int n_vectors = values.size();
+    const unsigned int dofs_per_cell = fe.dofs_per_cell;
+    const unsigned int n_components = fe.n_components();
+
+    // initialize with zero
+    for (unsigned int v=0; v<n_vectors; ++v)
+      for (unsigned int q=0; q<values[v].size(); ++q)
+        {
+          AssertDimension (values[v][q].size(), n_components);
+          values[v][q] = Number();
+        }
+
+    // see if there the current cell has DoFs at all, and if not
+    // then there is nothing else to do.
+    if (dofs_per_cell == 0)
+      return;
+
+    const unsigned int n_quadrature_points = shape_values.n_cols();
+    for (unsigned int v=0; v<n_vectors; ++v)
+      AssertDimension (values[v].size(), n_quadrature_points);
+
+    for (unsigned int shape_func=0; shape_func<dofs_per_cell; ++shape_func)
+      for (unsigned int c=0; c<n_components; ++c)
+        {
+          if (fe.is_primitive(shape_func))
+            {
+              if (c != fe.system_to_component_index(shape_func).first)
+                continue;
+            }
+          else if (fe.get_nonzero_components(shape_func)[c] == false)
+            continue;
+
+          const unsigned int
+          row = shape_function_to_row_table[shape_func*n_components+c];
+          const double *shape_value_ptr = &shape_values(row, 0);
+
+          for (unsigned int v=0; v<n_vectors; ++v)
+            {
+              const Number value = dof_values_ptr[v*dofs_per_cell+shape_func];
+              // For auto-differentiable numbers, the fact that a DoF value is zero
+              // does not imply that its derivatives are zero as well. So we
+              // can't filter by value for these number types.
+              if (!Differentiation::AD::is_ad_number<Number>::value)
+                if (value == dealii::internal::NumberType<Number>::value(0.0))
+                  continue;
+
+              std::vector<dealii::Vector<Number> > &values_v = values[v];
+              for (unsigned int point=0; point<n_quadrature_points; ++point)
+                values_v[point](c) += value * shape_value_ptr[point];
+            }
+        }
+  }
+
+  // the same as above for gradients and Hessians
+  template <int order, int dim, int spacedim, typename Number>
+  void
+  do_function_derivatives_multiple (const Number                                                         *dof_values_ptr,
+                                    const dealii::Table<2,Tensor<order,spacedim> >                       &shape_derivatives,
+                                    const FiniteElement<dim,spacedim>                                    &fe,
+                                    const std::vector<unsigned int>                                      &shape_function_to_row_table,
+                                    std::vector<std::vector<std::vector<Tensor<order,spacedim,Number> > > > &derivatives)
+  {
+    const unsigned int n_vectors = derivatives.size();
+    const unsigned int dofs_per_cell = fe.dofs_per_cell;
+    const unsigned int n_components = fe.n_components();
+
+    // initialize with zero
+    for (unsigned int v=0; v<n_vectors; ++v)
+      for (unsigned int q=0; q<derivatives[v].size(); ++q)
+        {
+          AssertDimension (derivatives[v][q].size(), n_components);
+          std::fill_n (derivatives[v][q].begin(), n_components,
+                       Tensor<order,spacedim,Number>());
+        }
+
+    // see if there the current cell has DoFs at all, and if not
+    // then there is nothing else to do.
+    if (dofs_per_cell == 0)
+      return;
+
+    const unsigned int n_quadrature_points = shape_derivatives[0].size();
+    for (unsigned int v=0; v<n_vectors; ++v)
+      AssertDimension (derivatives[v].size(), n_quadrature_points);
+
+    for (unsigned int shape_func=0; shape_func<dofs_per_cell; ++shape_func)
+      for (unsigned int c=0; c<n_components; ++c)
+        {
+          if (fe.is_primitive(shape_func))
+            {
+              if (c != fe.system_to_component_index(shape_func).first)
+                continue;
+            }
+          else if (fe.get_nonzero_components(shape_func)[c] == false)
+            continue;
+
+          const unsigned int
+          row = shape_function_to_row_table[shape_func*n_components+c];
+          const Tensor<order,spacedim> *shape_derivative_ptr =
+            &shape_derivatives[row][0];
+
+          for (unsigned int v=0; v<n_vectors; ++v)
+            {
+              const Number value = dof_values_ptr[v*dofs_per_cell+shape_func];
+              // For auto-differentiable numbers, the fact that a DoF value is zero
+              // does not imply that its derivatives are zero as well. So we
+              // can't filter by value for these number types.
+              if (!Differentiation::AD::is_ad_number<Number>::value)
+                if (value == dealii::internal::NumberType<Number>::value(0.0))
+                  continue;
+
+              std::vector<std::vector<Tensor<order,spacedim,Number> > > &derivatives_v
+                = derivatives[v];
+              for (unsigned int point=0; point<n_quadrature_points; ++point)
+                derivatives_v[point][c] += value *
+                                           dealii::Tensor<order,spacedim,Number>(shape_derivative_ptr[point]);
+            }
+        }
+  }
+
   template <int spacedim, typename Number, typename Number2>
   void
   do_function_laplacians (const Number2        *dof_values_ptr,
@@ -3154,6 +3299,9 @@ void FEValuesBase<dim,spacedim>::get_function_values (
   // get function values of dofs on this cell
   Vector<Number> dof_values (dofs_per_cell);
   present_cell->get_interpolated_dof_values(fe_function, dof_values);
+  AssertDimension (values.size(), n_quadrature_points);
+  if (get_function_values_with_sum_factorization (dof_values.begin(), values.data()))
+    return;
   internal::do_function_values (dof_values.begin(), this->finite_element_output.shape_values,
                                 values);
 }
@@ -3176,6 +3324,9 @@ void FEValuesBase<dim,spacedim>::get_function_values (
   boost::container::small_vector<Number, 200> dof_values(dofs_per_cell);
   for (unsigned int i=0; i<dofs_per_cell; ++i)
     dof_values[i] = get_vector_element (fe_function, indices[i]);
+  AssertDimension (values.size(), n_quadrature_points);
+  if (get_function_values_with_sum_factorization (dof_values.data(), values.data()))
+    return;
   internal::do_function_values(dof_values.data(), this->finite_element_output.shape_values, values);
 }
 
@@ -3267,6 +3418,38 @@ void FEValuesBase<dim,spacedim>::get_function_values (
 
 
 
+template <int dim, int spacedim>
+template <class InputVector>
+void FEValuesBase<dim,spacedim>::get_function_values (
+  const std::vector<const InputVector *>                                &fe_functions,
+  std::vector<std::vector<Vector<typename InputVector::value_type> > > &values) const
+{
+  typedef typename InputVector::value_type Number;
+  Assert (present_cell.get() != nullptr,
+          ExcMessage ("FEValues object is not reinit'ed to any cell"));
+  Assert (this->update_flags & update_values,
+          ExcAccessToUninitializedField("update_values"));
+  AssertDimension (values.size(), fe_functions.size());
+
+  // get function values of dofs on this cell for all vectors
+  Vector<Number> dof_values (fe_functions.size() * dofs_per_cell);
+  Vector<Number> cell_dof_values (dofs_per_cell);
+  for (unsigned int v=0; v<fe_functions.size(); ++v)
+    {
+      AssertDimension (fe_functions[v]->size(), present_cell->n_dofs_for_dof_handler());
+      present_cell->get_interpolated_dof_values(*fe_functions[v], cell_dof_values);
+      std::copy (cell_dof_values.begin(), cell_dof_values.end(),
+                 dof_values.begin() + v*dofs_per_cell);
+    }
+  internal::do_function_values_multiple(dof_values.begin(),
+                                        this->finite_element_output.shape_values,
+                                        *fe,
+                                        this->finite_element_output.shape_function_to_row_table,
+                                        values);
+}
+
+
+
 template <int dim, int spacedim>
 template <class InputVector>
 void
@@ -3285,6 +3468,9 @@ FEValuesBase<dim,spacedim>::get_function_gradients (
   // get function values of dofs on this cell
   Vector<Number> dof_values (dofs_per_cell);
   present_cell->get_interpolated_dof_values(fe_function, dof_values);
+  AssertDimension (gradients.size(), n_quadrature_points);
+  if (get_function_gradients_with_sum_factorization (dof_values.begin(), gradients.data()))
+    return;
   internal::do_function_derivatives(dof_values.begin(), this->finite_element_output.shape_gradients,
                                     gradients);
 }
@@ -3307,6 +3493,9 @@ void FEValuesBase<dim,spacedim>::get_function_gradients (
   boost::container::small_vector<Number, 200> dof_values(dofs_per_cell);
   for (unsigned int i=0; i<dofs_per_cell; ++i)
     dof_values[i] = get_vector_element (fe_function, indices[i]);
+  AssertDimension (gradients.size(), n_quadrature_points);
+  if (get_function_gradients_with_sum_factorization (dof_values.data(), gradients.data()))
+    return;
   internal::do_function_derivatives(dof_values.data(), this->finite_element_output.shape_gradients,
                                     gradients);
 }
@@ -3340,6 +3529,39 @@ FEValuesBase<dim,spacedim>::get_function_gradients (
 
 
 
+template <int dim, int spacedim>
+template <class InputVector>
+void
+FEValuesBase<dim,spacedim>::get_function_gradients (
+  const std::vector<const InputVector *>                                                     &fe_functions,
+  std::vector<std::vector<std::vector<Tensor<1,spacedim,typename InputVector::value_type> > > > &gradients) const
+{
+  typedef typename InputVector::value_type Number;
+  Assert (this->update_flags & update_gradients,
+          ExcAccessToUninitializedField("update_gradients"));
+  Assert (present_cell.get() != nullptr,
+          ExcMessage ("FEValues object is not reinit'ed to any cell"));
+  AssertDimension (gradients.size(), fe_functions.size());
+
+  // get function values of dofs on this cell for all vectors
+  Vector<Number> dof_values (fe_functions.size() * dofs_per_cell);
+  Vector<Number> cell_dof_values (dofs_per_cell);
+  for (unsigned int v=0; v<fe_functions.size(); ++v)
+    {
+      AssertDimension (fe_functions[v]->size(), present_cell->n_dofs_for_dof_handler());
+      present_cell->get_interpolated_dof_values(*fe_functions[v], cell_dof_values);
+      std::copy (cell_dof_values.begin(), cell_dof_values.end(),
+                 dof_values.begin() + v*dofs_per_cell);
+    }
+  internal::do_function_derivatives_multiple(dof_values.begin(),
+                                             this->finite_element_output.shape_gradients,
+                                             *fe,
+                                             this->finite_element_output.shape_function_to_row_table,
+                                             gradients);
+}
+
+
+
 template <int dim, int spacedim>
 template <class InputVector>
 void FEValuesBase<dim,spacedim>::get_function_gradients (
@@ -3890,6 +4112,119 @@ FEValuesBase<dim,spacedim>::get_cell_similarity () const
 }
 
 
+
+template <int dim, int spacedim>
+bool
+FEValuesBase<dim,spacedim>::get_function_values_with_sum_factorization (const double *dof_values,
+    double       *values) const
+{
+  if (tensor_product_data.get() == nullptr)
+    return false;
+
+  const TensorProductData &data = *tensor_product_data;
+  const internal::EvaluatorTensorProduct<internal::evaluate_general,dim,-1,0,double>
+  eval (data.shape_values, data.shape_gradients, data.shape_gradients,
+        data.n_dofs_1d-1, data.n_q_points_1d);
+
+  // intermediate results of the partial sums have at most as many entries
+  // as the larger of the number of dofs and quadrature points
+  const unsigned int temp_size = std::max (dofs_per_cell, n_quadrature_points);
+  boost::container::small_vector<double, 1024> scratch (dofs_per_cell + 2*temp_size);
+  double *lexicographic_dof_values = scratch.data();
+  double *temp1 = lexicographic_dof_values + dofs_per_cell;
+  double *temp2 = temp1 + temp_size;
+  for (unsigned int i=0; i<dofs_per_cell; ++i)
+    lexicographic_dof_values[i] = dof_values[data.lexicographic_numbering[i]];
+
+  switch (dim)
+    {
+    case 2:
+      eval.template values<0,true,false> (lexicographic_dof_values, temp1);
+      eval.template values<1,true,false> (temp1, values);
+      break;
+    case 3:
+      eval.template values<0,true,false> (lexicographic_dof_values, temp1);
+      eval.template values<1,true,false> (temp1, temp2);
+      eval.template values<2,true,false> (temp2, values);
+      break;
+    default:
+      Assert (false, ExcInternalError());
+    }
+
+  return true;
+}
+
+
+
+template <int dim, int spacedim>
+bool
+FEValuesBase<dim,spacedim>::get_function_gradients_with_sum_factorization (const double       *dof_values,
+    Tensor<1,spacedim> *gradients) const
+{
+  if (tensor_product_data.get() == nullptr ||
+      this->mapping_output.inverse_jacobians.size() != n_quadrature_points)
+    return false;
+
+  const TensorProductData &data = *tensor_product_data;
+  const internal::EvaluatorTensorProduct<internal::evaluate_general,dim,-1,0,double>
+  eval (data.shape_values, data.shape_gradients, data.shape_gradients,
+        data.n_dofs_1d-1, data.n_q_points_1d);
+
+  const unsigned int temp_size = std::max (dofs_per_cell, n_quadrature_points);
+  boost::container::small_vector<double, 1024> scratch (dofs_per_cell + 2*temp_size +
+                                                        dim*n_quadrature_points);
+  double *lexicographic_dof_values = scratch.data();
+  double *temp1 = lexicographic_dof_values + dofs_per_cell;
+  double *temp2 = temp1 + temp_size;
+  double *unit_gradients[3];
+  for (unsigned int d=0; d<dim; ++d)
+    unit_gradients[d] = temp2 + temp_size + d*n_quadrature_points;
+  for (unsigned int i=0; i<dofs_per_cell; ++i)
+    lexicographic_dof_values[i] = dof_values[data.lexicographic_numbering[i]];
+
+  // compute the derivatives with respect to the unit coordinates, in the
+  // same order as done by matrix-free evaluation in FEEvaluationImpl
+  switch (dim)
+    {
+    case 2:
+      eval.template gradients<0,true,false> (lexicographic_dof_values, temp1);
+      eval.template values<1,true,false> (temp1, unit_gradients[0]);
+      eval.template values<0,true,false> (lexicographic_dof_values, temp1);
+      eval.template gradients<1,true,false> (temp1, unit_gradients[dim-1]);
+      break;
+    case 3:
+      eval.template gradients<0,true,false> (lexicographic_dof_values, temp1);
+      eval.template values<1,true,false> (temp1, temp2);
+      eval.template values<2,true,false> (temp2, unit_gradients[0]);
+      eval.template values<0,true,false> (lexicographic_dof_values, temp1);
+      eval.template gradients<1,true,false> (temp1, temp2);
+      eval.template values<2,true,false> (temp2, unit_gradients[1]);
+      eval.template values<1,true,false> (temp1, temp2);
+      eval.template gradients<2,true,false> (temp2, unit_gradients[dim-1]);
+      break;
+    default:
+      Assert (false, ExcInternalError());
+    }
+
+  // transform to real space by the transpose of the inverse Jacobian, like
+  // the covariant transformation applied by the element to shape gradients
+  for (unsigned int q=0; q<n_quadrature_points; ++q)
+    {
+      const DerivativeForm<1,spacedim,dim> &inverse_jacobian =
+        this->mapping_output.inverse_jacobians[q];
+      for (unsigned int d=0; d<spacedim; ++d)
+        {
+          double sum = inverse_jacobian[0][d] * unit_gradients[0][q];
+          for (unsigned int e=1; e<dim; ++e)
+            sum += inverse_jacobian[e][d] * unit_gradients[e][q];
+          gradients[q][d] = sum;
+        }
+    }
+
+  return true;
+}
+
+
 template <int dim, int spacedim>
 const unsigned int FEValuesBase<dim,spacedim>::dimension;
 
@@ -3916,7 +4251,8 @@ FEValues<dim,spacedim>::FEValues (const Mapping<dim,spacedim>       &mapping,
                               update_default,
                               mapping,
                               fe),
-  quadrature (q)
+  quadrature (q),
+  max_n_cached_geometries (0)
 {
   initialize (update_flags);
 }
@@ -3933,7 +4269,8 @@ FEValues<dim,spacedim>::FEValues (const FiniteElement<dim,spacedim> &fe,
                               update_default,
                               StaticMappingQ1<dim,spacedim>::mapping,
                               fe),
-  quadrature (q)
+  quadrature (q),
+  max_n_cached_geometries (0)
 {
   initialize (update_flags);
 }
@@ -3955,7 +4292,60 @@ FEValues<dim,spacedim>::initialize (const UpdateFlags update_flags)
                         "triangulation it refers to is embedded in a higher "
                         "dimensional space."));
 
-  const UpdateFlags flags = this->compute_update_flags (update_flags);
+  // check whether function values and gradients can be evaluated with sum
+  // factorization, i.e., the element is scalar with shape functions that
+  // are tensor products of the same nodal 1d polynomials (FE_Q, FE_DGQ,
+  // FE_DGQArbitraryNodes), the quadrature formula is the tensor product of
+  // a single 1d formula (QGauss, QGaussLobatto, etc.), and the degree is
+  // high enough for the dense evaluation to become more expensive
+  const FE_Poly<TensorProductPolynomials<dim>,dim,spacedim> *fe_poly =
+    dynamic_cast<const FE_Poly<TensorProductPolynomials<dim>,dim,spacedim>*>(&*this->fe);
+  if (dim > 1 && fe_poly != nullptr && fe_poly->has_support_points() &&
+      fe_poly->degree >= 2 && quadrature.is_tensor_product() &&
+      Utilities::fixed_power<dim>(fe_poly->degree+1) == this->dofs_per_cell)
+    {
+      const Quadrature<1> quadrature_1d = quadrature.get_tensor_basis()[0];
+      bool same_1d_formula = (Utilities::fixed_power<dim>(quadrature_1d.size()) ==
+                              this->n_quadrature_points);
+      for (unsigned int d=1; d<dim; ++d)
+        if (quadrature.get_tensor_basis()[d].get_points() != quadrature_1d.get_points())
+          same_1d_formula = false;
+
+      const std::vector<unsigned int> lexicographic =
+        fe_poly->get_poly_space_numbering_inverse();
+
+      // evaluate the 1d polynomials along the line through the first support
+      // point where the other 1d factors are one
+      const Point<dim> unit_point = fe_poly->get_unit_support_points()[lexicographic[0]];
+      if (same_1d_formula &&
+          std::abs(fe_poly->shape_value(lexicographic[0], unit_point) - 1.) < 1e-13)
+        {
+          std::unique_ptr<typename FEValuesBase<dim,spacedim>::TensorProductData>
+          data (new typename FEValuesBase<dim,spacedim>::TensorProductData());
+          data->n_dofs_1d = fe_poly->degree+1;
+          data->n_q_points_1d = quadrature_1d.size();
+          data->lexicographic_numbering = lexicographic;
+          data->shape_values.resize (data->n_dofs_1d*data->n_q_points_1d);
+          data->shape_gradients.resize (data->n_dofs_1d*data->n_q_points_1d);
+          for (unsigned int i=0; i<data->n_dofs_1d; ++i)
+            for (unsigned int q=0; q<data->n_q_points_1d; ++q)
+              {
+                Point<dim> point = unit_point;
+                point[0] = quadrature_1d.point(q)[0];
+                data->shape_values[i*data->n_q_points_1d+q] =
+                  fe_poly->shape_value(lexicographic[i], point);
+                data->shape_gradients[i*data->n_q_points_1d+q] =
+                  fe_poly->shape_grad(lexicographic[i], point)[0];
+              }
+          this->tensor_product_data = std::move(data);
+        }
+    }
+
+  // for gradients, sum factorization gives the derivatives on the reference
+  // cell that we transform with the inverse Jacobians of the mapping
+  const UpdateFlags flags = this->compute_update_flags
+                            ((this->tensor_product_data && (update_flags & update_gradients)) ?
+                             (update_flags | update_inverse_jacobians) : update_flags);
 
   // initialize the base classes
   if (flags & update_mapping)
@@ -4075,9 +4465,97 @@ FEValues<dim,spacedim>::reinit
 
 
 
+template <int dim, int spacedim>
+void
+FEValues<dim,spacedim>::set_geometry_cache_size (const unsigned int max_n_geometries)
+{
+  const bool mapping_is_q_generic =
+    dynamic_cast<const MappingQGeneric<dim,spacedim> *>(&this->get_mapping()) != nullptr;
+  (void)mapping_is_q_generic;
+  Assert (max_n_geometries == 0 || mapping_is_q_generic,
+          ExcMessage ("The geometry cache of FEValues can only be used with "
+                      "mappings derived from MappingQGeneric."));
+  max_n_cached_geometries = max_n_geometries;
+  geometry_cache.clear();
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+FEValues<dim,spacedim>::n_cached_geometries () const
+{
+  return geometry_cache.size();
+}
+
+
+
+template <int dim, int spacedim>
+std::size_t
+FEValues<dim,spacedim>::GeometryKeyHash::operator() (const std::vector<std::int64_t> &key) const
+{
+  // combine the hashes of the entries like boost::hash_combine
+  std::size_t hash = key.size();
+  for (unsigned int i=0; i<key.size(); ++i)
+    hash ^= std::hash<std::int64_t>()(key[i]) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  return hash;
+}
+
+
+
 template <int dim, int spacedim>
 void FEValues<dim,spacedim>::do_reinit ()
 {
+  // if the geometry cache is enabled, describe the shape of the cell by the
+  // locations of the support points of the mapping relative to the first
+  // one, rounded to a multiple of 2^-40 times the size of the cell. rounding
+  // to a power of two makes cells of the same size end up with identical
+  // keys unless the size is right at a power of two, in which case we only
+  // miss the cache
+  std::vector<Point<spacedim> > support_points;
+  if (max_n_cached_geometries > 0)
+    {
+      const MappingQGeneric<dim,spacedim> &mapping =
+        static_cast<const MappingQGeneric<dim,spacedim> &>(this->get_mapping());
+      support_points = mapping.compute_mapping_support_points(*this->present_cell);
+
+      double max_distance = 0;
+      for (unsigned int i=1; i<support_points.size(); ++i)
+        for (unsigned int d=0; d<spacedim; ++d)
+          max_distance = std::max (max_distance,
+                                   std::abs(support_points[i][d] - support_points[0][d]));
+      int exponent = 0;
+      std::frexp (max_distance, &exponent);
+      const double scaling = std::ldexp (1., 40-exponent);
+
+      geometry_key.resize (2 + (support_points.size()-1)*spacedim);
+      geometry_key[0] = exponent;
+      // on manifolds, the orientation of the cell changes the normal vectors
+      geometry_key[1] = (dim<spacedim ?
+                         static_cast<const typename Triangulation<dim,spacedim>::cell_iterator &>
+                         (*this->present_cell)->direction_flag() : true);
+      for (unsigned int i=1, c=2; i<support_points.size(); ++i)
+        for (unsigned int d=0; d<spacedim; ++d, ++c)
+          geometry_key[c] = std::llround ((support_points[i][d] - support_points[0][d])
+                                          * scaling);
+
+      const typename std::unordered_map<std::vector<std::int64_t>,CachedGeometry,GeometryKeyHash>::const_iterator
+      entry = geometry_cache.find (geometry_key);
+      if (entry != geometry_cache.end())
+        {
+          this->mapping_output = entry->second.mapping_output;
+          this->finite_element_output = entry->second.finite_element_output;
+          const Tensor<1,spacedim> shift = support_points[0] - entry->second.first_support_point;
+          for (unsigned int q=0; q<this->mapping_output.quadrature_points.size(); ++q)
+            this->mapping_output.quadrature_points[q] += shift;
+
+          // the internal data of the mapping and the finite element no longer
+          // matches the present cell, so the next cell must not use it
+          this->cell_similarity = CellSimilarity::invalid_next_cell;
+          return;
+        }
+    }
+
   // first call the mapping and let it generate the data
   // specific to the mapping. also let it inspect the
   // cell similarity flag and, if necessary, update
@@ -4104,6 +4582,15 @@ void FEValues<dim,spacedim>::do_reinit ()
                                 this->mapping_output,
                                 *this->fe_data,
                                 this->finite_element_output);
+
+  if (max_n_cached_geometries > 0 &&
+      geometry_cache.size() < max_n_cached_geometries)
+    {
+      CachedGeometry &cached = geometry_cache[geometry_key];
+      cached.first_support_point = support_points[0];
+      cached.mapping_output = this->mapping_output;
+      cached.finite_element_output = this->finite_element_output;
+    }
 }
 
 
@@ -4112,8 +4599,16 @@ template <int dim, int spacedim>
 std::size_t
 FEValues<dim,spacedim>::memory_consumption () const
 {
+  std::size_t cache_memory = MemoryConsumption::memory_consumption (geometry_key);
+  for (typename std::unordered_map<std::vector<std::int64_t>,CachedGeometry,GeometryKeyHash>::const_iterator
+       entry = geometry_cache.begin(); entry != geometry_cache.end(); ++entry)
+    cache_memory += (MemoryConsumption::memory_consumption (entry->first) +
+                     entry->second.mapping_output.memory_consumption() +
+                     entry->second.finite_element_output.memory_consumption());
+
   return (FEValuesBase<dim,spacedim>::memory_consumption () +
-          MemoryConsumption::memory_consumption (quadrature));
+          MemoryConsumption::memory_consumption (quadrature) +
+          cache_memory);
 }
 
 
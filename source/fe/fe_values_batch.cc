@@ -0,0 +1,329 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/polynomial.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/tensor_product_polynomials.h>
+#include <deal.II/fe/fe_tools.h>
+#include <deal.II/fe/fe_values_batch.h>
+#include <deal.II/fe/mapping_q1.h>
+#include <deal.II/grid/tria_iterator.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace FEValuesBatchImplementation
+  {
+    /**
+     * Add the flags needed for computing the quantities requested by @p
+     * update_flags.
+     */
+    inline
+    UpdateFlags
+    add_required_flags (const UpdateFlags update_flags)
+    {
+      UpdateFlags flags = update_flags;
+      if (flags & update_gradients)
+        flags |= update_inverse_jacobians;
+      if (flags & (update_inverse_jacobians | update_JxW_values))
+        flags |= update_jacobians;
+      return flags;
+    }
+  }
+}
+
+
+
+template <int dim>
+const unsigned int FEValuesBatch<dim>::n_lanes;
+
+
+
+template <int dim>
+FEValuesBatch<dim>::FEValuesBatch (const MappingQGeneric<dim> &mapping,
+                                   const FiniteElement<dim>   &fe,
+                                   const Quadrature<dim>      &quadrature,
+                                   const UpdateFlags           update_flags)
+  :
+  n_quadrature_points (quadrature.size()),
+  dofs_per_cell (fe.dofs_per_cell),
+  mapping (&mapping, typeid(*this).name()),
+  fe (&fe, typeid(*this).name()),
+  quadrature (quadrature),
+  update_flags (internal::FEValuesBatchImplementation::add_required_flags(update_flags)),
+  n_filled (0)
+{
+  initialize ();
+}
+
+
+
+template <int dim>
+FEValuesBatch<dim>::FEValuesBatch (const FiniteElement<dim> &fe,
+                                   const Quadrature<dim>    &quadrature,
+                                   const UpdateFlags         update_flags)
+  :
+  n_quadrature_points (quadrature.size()),
+  dofs_per_cell (fe.dofs_per_cell),
+  mapping (&StaticMappingQ1<dim>::mapping, typeid(*this).name()),
+  fe (&fe, typeid(*this).name()),
+  quadrature (quadrature),
+  update_flags (internal::FEValuesBatchImplementation::add_required_flags(update_flags)),
+  n_filled (0)
+{
+  initialize ();
+}
+
+
+
+template <int dim>
+void
+FEValuesBatch<dim>::initialize ()
+{
+  Assert ((update_flags & ~(update_values | update_gradients |
+                            update_quadrature_points | update_jacobians |
+                            update_inverse_jacobians | update_JxW_values)) == 0,
+          ExcMessage ("FEValuesBatch only supports the update flags update_values, "
+                      "update_gradients, update_quadrature_points, update_jacobians, "
+                      "update_inverse_jacobians, and update_JxW_values."));
+  Assert (fe->is_primitive(),
+          ExcMessage ("FEValuesBatch only supports primitive elements whose shape "
+                      "functions are defined on the reference cell."));
+
+  // the shape functions on the reference cell
+  if (update_flags & update_values)
+    {
+      unit_shape_values.reinit (dofs_per_cell, n_quadrature_points);
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        for (unsigned int q=0; q<n_quadrature_points; ++q)
+          unit_shape_values(i,q) = fe->shape_value(i, quadrature.point(q));
+    }
+  if (update_flags & update_gradients)
+    {
+      unit_shape_gradients.reinit (dofs_per_cell, n_quadrature_points);
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        for (unsigned int q=0; q<n_quadrature_points; ++q)
+          unit_shape_gradients(i,q) = fe->shape_grad(i, quadrature.point(q));
+      shape_gradients.reinit (dofs_per_cell, n_quadrature_points);
+    }
+
+  // the polynomials of the mapping are the tensor product Lagrange
+  // polynomials in the Gauss-Lobatto points, numbered like the support points
+  // returned by MappingQGeneric::compute_mapping_support_points(), i.e., in
+  // the hierarchic numbering of FE_Q
+  const unsigned int mapping_degree = mapping->get_degree();
+  const TensorProductPolynomials<dim> mapping_polynomials
+  (Polynomials::generate_complete_Lagrange_basis
+   (QGaussLobatto<1>(mapping_degree+1).get_points()));
+  const unsigned int n_mapping_points = mapping_polynomials.n();
+  std::vector<unsigned int> hierarchic_to_lexicographic (n_mapping_points);
+  FETools::hierarchic_to_lexicographic_numbering<dim> (mapping_degree,
+                                                       hierarchic_to_lexicographic);
+
+  Table<2,double> polynomial_values;
+  Table<2,Tensor<1,dim> > polynomial_gradients;
+  if (update_flags & update_quadrature_points)
+    polynomial_values.reinit (n_mapping_points, n_quadrature_points);
+  if (update_flags & update_jacobians)
+    polynomial_gradients.reinit (n_mapping_points, n_quadrature_points);
+  mapping_polynomials.compute (quadrature.get_points(), polynomial_values,
+                               polynomial_gradients);
+
+  if (update_flags & update_quadrature_points)
+    {
+      mapping_values.reinit (n_quadrature_points, n_mapping_points);
+      for (unsigned int q=0; q<n_quadrature_points; ++q)
+        for (unsigned int k=0; k<n_mapping_points; ++k)
+          mapping_values(q,k) = polynomial_values(hierarchic_to_lexicographic[k], q);
+      quadrature_points.resize (n_quadrature_points);
+    }
+  if (update_flags & update_jacobians)
+    {
+      mapping_gradients.reinit (n_quadrature_points, n_mapping_points);
+      for (unsigned int q=0; q<n_quadrature_points; ++q)
+        for (unsigned int k=0; k<n_mapping_points; ++k)
+          mapping_gradients(q,k) = polynomial_gradients(hierarchic_to_lexicographic[k], q);
+      jacobians.resize (n_quadrature_points);
+    }
+  if (update_flags & update_inverse_jacobians)
+    inverse_jacobians.resize (n_quadrature_points);
+  if (update_flags & update_JxW_values)
+    JxW_values.resize (n_quadrature_points);
+
+  mapping_support_points.resize (n_mapping_points);
+}
+
+
+
+template <int dim>
+void
+FEValuesBatch<dim>::reinit (const std::vector<typename Triangulation<dim>::cell_iterator> &cells)
+{
+  reinit (ArrayView<const typename Triangulation<dim>::cell_iterator>(cells.data(),
+          cells.size()));
+}
+
+
+
+template <int dim>
+void
+FEValuesBatch<dim>::reinit (const ArrayView<const typename Triangulation<dim>::cell_iterator> &cells)
+{
+  Assert (cells.size() > 0 && cells.size() <= n_lanes,
+          ExcIndexRange (cells.size(), 1, n_lanes+1));
+  n_filled = cells.size();
+
+  // collect the support points of the mapping, filling the unused lanes
+  // with the first cell
+  const unsigned int n_mapping_points = mapping_support_points.size();
+  for (unsigned int v=0; v<n_lanes; ++v)
+    {
+      if (v > 0 && v >= n_filled)
+        {
+          for (unsigned int k=0; k<n_mapping_points; ++k)
+            for (unsigned int d=0; d<dim; ++d)
+              mapping_support_points[k][d][v] = mapping_support_points[k][d][0];
+          continue;
+        }
+
+      const std::vector<Point<dim> > cell_points =
+        mapping->compute_mapping_support_points (cells[v]);
+      AssertDimension (cell_points.size(), n_mapping_points);
+      for (unsigned int k=0; k<n_mapping_points; ++k)
+        for (unsigned int d=0; d<dim; ++d)
+          mapping_support_points[k][d][v] = cell_points[k][d];
+    }
+
+  if (update_flags & update_quadrature_points)
+    for (unsigned int q=0; q<n_quadrature_points; ++q)
+      {
+        Point<dim,VectorizedArray<double> > point;
+        for (unsigned int k=0; k<n_mapping_points; ++k)
+          {
+            const VectorizedArray<double> weight = make_vectorized_array(mapping_values(q,k));
+            for (unsigned int d=0; d<dim; ++d)
+              point[d] += weight * mapping_support_points[k][d];
+          }
+        quadrature_points[q] = point;
+      }
+
+  if (update_flags & update_jacobians)
+    for (unsigned int q=0; q<n_quadrature_points; ++q)
+      {
+        Tensor<2,dim,VectorizedArray<double> > jac;
+        for (unsigned int k=0; k<n_mapping_points; ++k)
+          for (unsigned int e=0; e<dim; ++e)
+            {
+              const VectorizedArray<double> derivative =
+                make_vectorized_array(mapping_gradients(q,k)[e]);
+              for (unsigned int d=0; d<dim; ++d)
+                jac[d][e] += derivative * mapping_support_points[k][d];
+            }
+        jacobians[q] = jac;
+
+        if (update_flags & (update_inverse_jacobians | update_JxW_values))
+          {
+            const VectorizedArray<double> det = determinant(jac);
+#ifdef DEBUG
+            for (unsigned int v=0; v<n_filled; ++v)
+              Assert (det[v] > 1e-12*Utilities::fixed_power<dim>(cells[v]->diameter()/
+                                                                   std::sqrt(double(dim))),
+                      (typename Mapping<dim>::ExcDistortedMappedCell(cells[v]->center(),
+                                                                     det[v], q)));
+#endif
+            if (update_flags & update_JxW_values)
+              JxW_values[q] = det * quadrature.weight(q);
+            if (update_flags & update_inverse_jacobians)
+              inverse_jacobians[q] = invert(jac);
+          }
+      }
+
+  // the gradients of the shape functions are transformed by the inverse
+  // transpose of the Jacobian
+  if (update_flags & update_gradients)
+    for (unsigned int q=0; q<n_quadrature_points; ++q)
+      {
+        const Tensor<2,dim,VectorizedArray<double> > &inv_jac = inverse_jacobians[q];
+        for (unsigned int i=0; i<dofs_per_cell; ++i)
+          {
+            const Tensor<1,dim> &unit_grad = unit_shape_gradients(i,q);
+            Tensor<1,dim,VectorizedArray<double> > grad;
+            for (unsigned int e=0; e<dim; ++e)
+              {
+                const VectorizedArray<double> unit_derivative = make_vectorized_array(unit_grad[e]);
+                for (unsigned int d=0; d<dim; ++d)
+                  grad[d] += inv_jac[e][d] * unit_derivative;
+              }
+            shape_gradients(i,q) = grad;
+          }
+      }
+}
+
+
+
+template <int dim>
+const FiniteElement<dim> &
+FEValuesBatch<dim>::get_fe () const
+{
+  return *fe;
+}
+
+
+
+template <int dim>
+const Quadrature<dim> &
+FEValuesBatch<dim>::get_quadrature () const
+{
+  return quadrature;
+}
+
+
+
+template <int dim>
+UpdateFlags
+FEValuesBatch<dim>::get_update_flags () const
+{
+  return update_flags;
+}
+
+
+
+template <int dim>
+std::size_t
+FEValuesBatch<dim>::memory_consumption () const
+{
+  return (sizeof(*this) +
+          MemoryConsumption::memory_consumption (quadrature) +
+          MemoryConsumption::memory_consumption (unit_shape_values) +
+          MemoryConsumption::memory_consumption (unit_shape_gradients) +
+          MemoryConsumption::memory_consumption (mapping_values) +
+          MemoryConsumption::memory_consumption (mapping_gradients) +
+          MemoryConsumption::memory_consumption (mapping_support_points) +
+          MemoryConsumption::memory_consumption (quadrature_points) +
+          MemoryConsumption::memory_consumption (jacobians) +
+          MemoryConsumption::memory_consumption (inverse_jacobians) +
+          MemoryConsumption::memory_consumption (JxW_values) +
+          MemoryConsumption::memory_consumption (shape_gradients));
+}
+
+
+// explicit instantiations
+#include "fe_values_batch.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
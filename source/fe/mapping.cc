@@ -17,6 +17,8 @@
 #include <deal.II/grid/tria.h>
 #include <deal.II/fe/mapping.h>
 
+#include <limits>
+
 DEAL_II_NAMESPACE_OPEN
 
 
@@ -34,6 +36,30 @@ Mapping<dim, spacedim>::get_vertices (
 }
 
 
+template <int dim, int spacedim>
+void
+Mapping<dim,spacedim>::
+transform_points_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                    const ArrayView<const Point<spacedim> >                   &real_points,
+                                    const ArrayView<Point<dim> >                              &unit_points) const
+{
+  AssertDimension (real_points.size(), unit_points.size());
+
+  for (unsigned int i=0; i<real_points.size(); ++i)
+    {
+      try
+        {
+          unit_points[i] = transform_real_to_unit_cell (cell, real_points[i]);
+        }
+      catch (typename Mapping<dim,spacedim>::ExcTransformationFailed &)
+        {
+          unit_points[i] = Point<dim>();
+          unit_points[i][0] = std::numeric_limits<double>::infinity();
+        }
+    }
+}
+
+
 template <int dim, int spacedim>
 Point<dim-1>
 Mapping<dim,spacedim>::
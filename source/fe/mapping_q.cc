@@ -501,6 +501,25 @@ transform_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_it
 
 
 
+template <int dim, int spacedim>
+void
+MappingQ<dim,spacedim>::
+transform_points_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                    const ArrayView<const Point<spacedim> >                   &real_points,
+                                    const ArrayView<Point<dim> >                              &unit_points) const
+{
+  if (cell->has_boundary_lines()
+      ||
+      use_mapping_q_on_all_cells
+      ||
+      (dim!=spacedim) )
+    qp_mapping->transform_points_real_to_unit_cell(cell, real_points, unit_points);
+  else
+    q1_mapping->transform_points_real_to_unit_cell(cell, real_points, unit_points);
+}
+
+
+
 template <int dim, int spacedim>
 Mapping<dim,spacedim> *
 MappingQ<dim,spacedim>::clone () const
@@ -14,6 +14,7 @@
 // ---------------------------------------------------------------------
 
 
+#include <deal.II/base/aligned_vector.h>
 #include <deal.II/base/array_view.h>
 #include <deal.II/base/derivative_form.h>
 #include <deal.II/base/quadrature.h>
@@ -42,6 +43,7 @@
 #include <cmath>
 #include <algorithm>
 #include <numeric>
+#include <limits>
 #include <array>
 #include <memory>
 
@@ -643,52 +645,11 @@ initialize (const UpdateFlags      update_flags,
 
   const unsigned int n_q_points = q.size();
 
-  // see if we need the (transformation) shape function values
-  // and/or gradients and resize the necessary arrays
-  if (this->update_each & update_quadrature_points)
-    shape_values.resize(n_shape_functions * n_q_points);
-
-  if (this->update_each & (update_covariant_transformation
-                           | update_contravariant_transformation
-                           | update_JxW_values
-                           | update_boundary_forms
-                           | update_normal_vectors
-                           | update_jacobians
-                           | update_jacobian_grads
-                           | update_inverse_jacobians
-                           | update_jacobian_pushed_forward_grads
-                           | update_jacobian_2nd_derivatives
-                           | update_jacobian_pushed_forward_2nd_derivatives
-                           | update_jacobian_3rd_derivatives
-                           | update_jacobian_pushed_forward_3rd_derivatives))
-    shape_derivatives.resize(n_shape_functions * n_q_points);
-
-  if (this->update_each & update_covariant_transformation)
-    covariant.resize(n_original_q_points);
-
-  if (this->update_each & update_contravariant_transformation)
-    contravariant.resize(n_original_q_points);
-
-  if (this->update_each & update_volume_elements)
-    volume_elements.resize(n_original_q_points);
-
-  if (this->update_each &
-      (update_jacobian_grads | update_jacobian_pushed_forward_grads) )
-    shape_second_derivatives.resize(n_shape_functions * n_q_points);
-
-  if (this->update_each &
-      (update_jacobian_2nd_derivatives | update_jacobian_pushed_forward_2nd_derivatives) )
-    shape_third_derivatives.resize(n_shape_functions * n_q_points);
-
-  if (this->update_each &
-      (update_jacobian_3rd_derivatives | update_jacobian_pushed_forward_3rd_derivatives) )
-    shape_fourth_derivatives.resize(n_shape_functions * n_q_points);
-
-  const std::vector<Point<dim> > &ref_q_points = q.get_points();
-  // now also fill the various fields with their correct values
-  compute_shape_function_values (ref_q_points);
-
-  tensor_product_quadrature = q.is_tensor_product();
+  // a tensor product quadrature formula allows to evaluate the quadrature
+  // points and Jacobians on cells with sum factorization. this does not pay
+  // off for a single point as used by transform_real_to_unit_cell(), where
+  // we skip the setup of the tensor product data
+  tensor_product_quadrature = (q.is_tensor_product() && n_q_points > 1);
 
   if (dim>1)
     {
@@ -738,6 +699,64 @@ initialize (const UpdateFlags      update_flags,
             }
         }
     }
+
+  // the tables of the shape functions of the mapping in all quadrature
+  // points are not needed when the quadrature points, Jacobians, and
+  // Jacobian gradients are computed with sum factorization, unless higher
+  // derivatives are requested
+  const bool need_shape_tables =
+    (dim == 1 || tensor_product_quadrature == false ||
+     (this->update_each & (update_jacobian_pushed_forward_grads |
+                           update_jacobian_2nd_derivatives |
+                           update_jacobian_pushed_forward_2nd_derivatives |
+                           update_jacobian_3rd_derivatives |
+                           update_jacobian_pushed_forward_3rd_derivatives)));
+
+  // see if we need the (transformation) shape function values
+  // and/or gradients and resize the necessary arrays
+  if (need_shape_tables && (this->update_each & update_quadrature_points))
+    shape_values.resize(n_shape_functions * n_q_points);
+
+  if (need_shape_tables &&
+      (this->update_each & (update_covariant_transformation
+                            | update_contravariant_transformation
+                            | update_JxW_values
+                            | update_boundary_forms
+                            | update_normal_vectors
+                            | update_jacobians
+                            | update_jacobian_grads
+                            | update_inverse_jacobians
+                            | update_jacobian_pushed_forward_grads
+                            | update_jacobian_2nd_derivatives
+                            | update_jacobian_pushed_forward_2nd_derivatives
+                            | update_jacobian_3rd_derivatives
+                            | update_jacobian_pushed_forward_3rd_derivatives)))
+    shape_derivatives.resize(n_shape_functions * n_q_points);
+
+  if (this->update_each & update_covariant_transformation)
+    covariant.resize(n_original_q_points);
+
+  if (this->update_each & update_contravariant_transformation)
+    contravariant.resize(n_original_q_points);
+
+  if (this->update_each & update_volume_elements)
+    volume_elements.resize(n_original_q_points);
+
+  if (need_shape_tables && (this->update_each &
+                            (update_jacobian_grads | update_jacobian_pushed_forward_grads)))
+    shape_second_derivatives.resize(n_shape_functions * n_q_points);
+
+  if (this->update_each &
+      (update_jacobian_2nd_derivatives | update_jacobian_pushed_forward_2nd_derivatives) )
+    shape_third_derivatives.resize(n_shape_functions * n_q_points);
+
+  if (this->update_each &
+      (update_jacobian_3rd_derivatives | update_jacobian_pushed_forward_3rd_derivatives) )
+    shape_fourth_derivatives.resize(n_shape_functions * n_q_points);
+
+  const std::vector<Point<dim> > &ref_q_points = q.get_points();
+  // now also fill the various fields with their correct values
+  compute_shape_function_values (ref_q_points);
 }
 
 
@@ -1463,6 +1482,211 @@ namespace internal
 
 
 
+      /**
+       * Evaluate the Lagrange polynomials with the support points @p nodes
+       * and their derivatives at the vectorized coordinate @p x. @p
+       * inverse_denominators contains the inverse of the denominators of the
+       * polynomials.
+       */
+      template <typename Number>
+      void
+      evaluate_lagrange_polynomials (const std::vector<double> &nodes,
+                                     const std::vector<double> &inverse_denominators,
+                                     const Number              &x,
+                                     Number                    *values,
+                                     Number                    *derivatives)
+      {
+        const unsigned int n_nodes = nodes.size();
+        for (unsigned int j=0; j<n_nodes; ++j)
+          {
+            Number value, derivative;
+            value = inverse_denominators[j];
+            derivative = 0.;
+            for (unsigned int k=0; k<n_nodes; ++k)
+              if (k != j)
+                {
+                  // product rule
+                  derivative = derivative * (x - nodes[k]) + value;
+                  value *= x - nodes[k];
+                }
+            values[j] = value;
+            derivatives[j] = derivative;
+          }
+      }
+
+
+
+      /**
+       * Implementation of transform_points_real_to_unit_cell for
+       * dim==spacedim on cells with support points @p support_points in
+       * lexicographic order of the tensor product of the 1d support points
+       * @p nodes. The Newton iteration of do_transform_real_to_unit_cell_internal
+       * without line search is done for VectorizedArray::n_array_elements
+       * points at once. The first coordinate of a point for which the
+       * iteration fails to converge is set to infinity.
+       */
+      template <int dim, int spacedim>
+      void
+      do_transform_points_real_to_unit_cell
+      (const typename dealii::Triangulation<dim,spacedim>::cell_iterator &cell,
+       const std::vector<Point<spacedim> >                               &support_points,
+       const std::vector<double>                                         &nodes,
+       const ArrayView<const Point<spacedim> >                           &real_points,
+       const ArrayView<Point<dim> >                                      &unit_points)
+      {
+        Assert (dim == spacedim, ExcNotImplemented());
+        typedef VectorizedArray<double> Number;
+        const unsigned int n_lanes = Number::n_array_elements;
+        const unsigned int n_nodes = nodes.size();
+        AssertDimension (support_points.size(), Utilities::fixed_power<dim>(n_nodes));
+
+        std::vector<double> inverse_denominators (n_nodes, 1.);
+        for (unsigned int j=0; j<n_nodes; ++j)
+          for (unsigned int k=0; k<n_nodes; ++k)
+            if (k != j)
+              inverse_denominators[j] /= nodes[j] - nodes[k];
+
+        // the same tolerances as in do_transform_real_to_unit_cell_internal
+        const double eps = 1.e-11;
+        const unsigned int newton_iteration_limit = 20;
+
+        AlignedVector<Number> values (dim*n_nodes), derivatives (dim*n_nodes);
+
+        for (unsigned int first=0; first<real_points.size(); first+=n_lanes)
+          {
+            const unsigned int n_points = std::min<std::size_t>(n_lanes, real_points.size()-first);
+
+            // start from the affine approximation of the cell, like the
+            // scalar version. unused lanes repeat the last point
+            Point<dim,Number> p_real, p_unit;
+            for (unsigned int l=0; l<n_lanes; ++l)
+              {
+                const Point<spacedim> &p = real_points[first + std::min(l, n_points-1)];
+                const Point<dim> initial_p_unit
+                  = GeometryInfo<dim>::project_to_unit_cell(cell->real_to_unit_cell_affine_approximation(p));
+                for (unsigned int d=0; d<dim; ++d)
+                  {
+                    p_real[d][l] = p[d];
+                    p_unit[d][l] = initial_p_unit[d];
+                  }
+              }
+
+            bool done[n_lanes];
+            for (unsigned int l=0; l<n_lanes; ++l)
+              done[l] = (l >= n_points);
+            unsigned int n_done = n_lanes - n_points;
+
+            for (unsigned int newton_iteration=0;
+                 newton_iteration<=newton_iteration_limit && n_done<n_lanes;
+                 ++newton_iteration)
+              {
+                for (unsigned int d=0; d<dim; ++d)
+                  evaluate_lagrange_polynomials (nodes, inverse_denominators, p_unit[d],
+                                                 &values[d*n_nodes], &derivatives[d*n_nodes]);
+
+                // f(x) and f'(x), evaluated by sum factorization: first
+                // contract the support points with the 1d polynomials in x
+                // direction, then the partial sums in y and z direction. the
+                // indices d1, d2 avoid compiler warnings about accessing
+                // components that are never used in lower dimensions
+                const unsigned int d1 = dim>1 ? 1 : 0;
+                const unsigned int d2 = dim>2 ? 2 : 0;
+                const unsigned int n_nodes_y = dim>1 ? n_nodes : 1;
+                const unsigned int n_nodes_z = dim>2 ? n_nodes : 1;
+                Tensor<1,dim,Number> f;
+                Tensor<2,dim,Number> df;
+                for (unsigned int iz=0; iz<n_nodes_z; ++iz)
+                  {
+                    Tensor<1,dim,Number> value_xy;
+                    Tensor<2,dim,Number> derivative_xy;
+                    for (unsigned int iy=0; iy<n_nodes_y; ++iy)
+                      {
+                        const Point<spacedim> *points =
+                          &support_points[(iz*n_nodes_y+iy)*n_nodes];
+                        Tensor<1,dim,Number> value_x, derivative_x;
+                        for (unsigned int ix=0; ix<n_nodes; ++ix)
+                          for (unsigned int d=0; d<dim; ++d)
+                            {
+                              value_x[d] += points[ix][d] * values[ix];
+                              derivative_x[d] += points[ix][d] * derivatives[ix];
+                            }
+                        if (dim > 1)
+                          {
+                            const Number value_y = values[n_nodes+iy];
+                            const Number derivative_y = derivatives[n_nodes+iy];
+                            for (unsigned int d=0; d<dim; ++d)
+                              {
+                                value_xy[d] += value_x[d] * value_y;
+                                derivative_xy[d][0] += derivative_x[d] * value_y;
+                                derivative_xy[d][d1] += value_x[d] * derivative_y;
+                              }
+                          }
+                        else
+                          {
+                            value_xy = value_x;
+                            derivative_xy[0][0] = derivative_x[0];
+                          }
+                      }
+                    if (dim > 2)
+                      {
+                        const Number value_z = values[2*n_nodes+iz];
+                        const Number derivative_z = derivatives[2*n_nodes+iz];
+                        for (unsigned int d=0; d<dim; ++d)
+                          {
+                            f[d] += value_xy[d] * value_z;
+                            df[d][0] += derivative_xy[d][0] * value_z;
+                            df[d][d1] += derivative_xy[d][d1] * value_z;
+                            df[d][d2] += value_xy[d] * derivative_z;
+                          }
+                      }
+                    else
+                      {
+                        f = value_xy;
+                        df = derivative_xy;
+                      }
+                  }
+                for (unsigned int d=0; d<dim; ++d)
+                  f[d] -= p_real[d];
+
+                const Number det = determinant(df);
+                const Tensor<1,dim,Number> delta = invert(df) * f;
+                const Number delta_norm_square = delta * delta;
+
+                for (unsigned int l=0; l<n_lanes; ++l)
+                  if (!done[l])
+                    {
+                      if (!(det[l] > 0))
+                        {
+                          // the scalar version decides what to do with
+                          // degenerate points
+                          unit_points[first+l] = Point<dim>();
+                          unit_points[first+l][0] = std::numeric_limits<double>::infinity();
+                          done[l] = true;
+                          ++n_done;
+                        }
+                      else if (delta_norm_square[l] < eps*eps)
+                        {
+                          for (unsigned int d=0; d<dim; ++d)
+                            unit_points[first+l][d] = p_unit[d][l] - delta[d][l];
+                          done[l] = true;
+                          ++n_done;
+                        }
+                    }
+
+                p_unit -= delta;
+              }
+
+            for (unsigned int l=0; l<n_points; ++l)
+              if (!done[l])
+                {
+                  unit_points[first+l] = Point<dim>();
+                  unit_points[first+l][0] = std::numeric_limits<double>::infinity();
+                }
+          }
+      }
+
+
+
       /**
        * Implementation of transform_real_to_unit_cell for dim==spacedim-1
        */
@@ -2284,6 +2508,9 @@ MappingQGeneric<dim,spacedim>::MappingQGeneric (const unsigned int p)
   :
   polynomial_degree(p),
   line_support_points(this->polynomial_degree+1),
+  renumber_lexicographic_to_hierarchic (FETools::lexicographic_to_hierarchic_numbering
+                                        (FiniteElementData<dim> (internal::MappingQGeneric::get_dpo_vector<dim>
+                                                                 (this->polynomial_degree), 1, this->polynomial_degree))),
   fe_q(dim == 3 ? new FE_Q<dim>(this->polynomial_degree) : nullptr),
   support_point_weights_perimeter_to_interior (internal::MappingQGeneric::compute_support_point_weights_perimeter_to_interior(this->polynomial_degree, dim)),
   support_point_weights_cell (internal::MappingQGeneric::compute_support_point_weights_cell<dim>(this->polynomial_degree))
@@ -2299,6 +2526,7 @@ MappingQGeneric<dim,spacedim>::MappingQGeneric (const MappingQGeneric<dim,spaced
   :
   polynomial_degree(mapping.polynomial_degree),
   line_support_points(mapping.line_support_points),
+  renumber_lexicographic_to_hierarchic(mapping.renumber_lexicographic_to_hierarchic),
   fe_q(dim == 3 ? new FE_Q<dim>(*mapping.fe_q) : nullptr),
   support_point_weights_perimeter_to_interior (mapping.support_point_weights_perimeter_to_interior),
   support_point_weights_cell (mapping.support_point_weights_cell)
@@ -2664,6 +2892,52 @@ transform_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_it
 
 
 
+template <int dim, int spacedim>
+void
+MappingQGeneric<dim,spacedim>::
+transform_points_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                    const ArrayView<const Point<spacedim> >                   &real_points,
+                                    const ArrayView<Point<dim> >                              &unit_points) const
+{
+  AssertDimension (real_points.size(), unit_points.size());
+
+  // the vectorized Newton iteration starts from the affine approximation
+  // given by the vertices of the cell, like transform_real_to_unit_cell()
+  if (dim != spacedim || this->preserves_vertex_locations() == false)
+    {
+      Mapping<dim,spacedim>::transform_points_real_to_unit_cell (cell, real_points, unit_points);
+      return;
+    }
+
+  const std::vector<Point<spacedim> > support_points
+    = this->compute_mapping_support_points (cell);
+  std::vector<Point<spacedim> > lexicographic_support_points (support_points.size());
+  for (unsigned int i=0; i<support_points.size(); ++i)
+    lexicographic_support_points[i] = support_points[renumber_lexicographic_to_hierarchic[i]];
+
+  std::vector<double> nodes (line_support_points.size());
+  for (unsigned int i=0; i<nodes.size(); ++i)
+    nodes[i] = line_support_points.point(i)[0];
+
+  internal::MappingQGeneric::do_transform_points_real_to_unit_cell<dim,spacedim>
+  (cell, lexicographic_support_points, nodes, real_points, unit_points);
+
+  // points for which the iteration without line search failed get a
+  // second chance with the scalar algorithm
+  for (unsigned int i=0; i<real_points.size(); ++i)
+    if (unit_points[i][0] == std::numeric_limits<double>::infinity())
+      {
+        try
+          {
+            unit_points[i] = transform_real_to_unit_cell (cell, real_points[i]);
+          }
+        catch (typename Mapping<dim,spacedim>::ExcTransformationFailed &)
+          {}
+      }
+}
+
+
+
 template <int dim, int spacedim>
 UpdateFlags
 MappingQGeneric<dim,spacedim>::requires_update_flags (const UpdateFlags in) const
@@ -16,6 +16,8 @@
 #include <deal.II/grid/cell_id.h>
 
 #include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
 
 #include <sstream>
 
@@ -162,12 +164,19 @@ template <int dim, int spacedim>
 typename Triangulation<dim,spacedim>::cell_iterator
 CellId::to_cell(const Triangulation<dim,spacedim> &tria) const
 {
-  typename Triangulation<dim,spacedim>::cell_iterator cell (&tria,0,coarse_cell_id);
-
-  for (unsigned int i = 0; i < n_child_indices; ++i)
-    cell = cell->child(static_cast<unsigned int> (child_indices[i]));
+  // walk down the tree on the level and index of the cells, rather than
+  // constructing (and checking) a new iterator on every level
+  int index = coarse_cell_id;
+  for (unsigned int level = 0; level < n_child_indices; ++level)
+    {
+      const CellAccessor<dim,spacedim> cell (&tria, level, index);
+      Assert (cell.has_children(),
+              ExcMessage ("The CellId refers to a cell that does not exist "
+                          "in this triangulation."));
+      index = cell.child_index (static_cast<unsigned int> (child_indices[level]));
+    }
 
-  return cell;
+  return typename Triangulation<dim,spacedim>::cell_iterator (&tria, n_child_indices, index);
 }
 
 // explicit instantiations
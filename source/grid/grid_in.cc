@@ -28,6 +28,8 @@
 #include <fstream>
 #include <functional>
 #include <cctype>
+#include <limits>
+#include <sstream>
 
 
 #ifdef DEAL_II_WITH_NETCDF
@@ -86,6 +88,35 @@ namespace
     // vertices except in 1d
     Assert (dim != 1, ExcInternalError());
   }
+
+
+
+  /**
+   * Return the number of nodes of an element of the given type in version 2
+   * of the gmsh format, or zero for types whose number of nodes we do not
+   * know.
+   */
+  unsigned int
+  gmsh_n_element_nodes (const unsigned int cell_type)
+  {
+    switch (cell_type)
+      {
+      case 1:   // line
+        return 2;
+      case 2:   // triangle
+        return 3;
+      case 3:   // quadrilateral
+        return 4;
+      case 4:   // tetrahedron
+        return 4;
+      case 5:   // hexahedron
+        return 8;
+      case 15:  // point
+        return 1;
+      default:
+        return 0;
+      }
+  }
 }
 
 template <int dim, int spacedim>
@@ -1250,6 +1281,10 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
   else
     AssertThrow (false, ExcInvalidGMSHInput(line));
 
+  // whether the nodes and elements are given in the binary variant of
+  // version 2 of the format
+  bool binary_format = false;
+
   // if file format is 2 or greater
   // then we also have to read the
   // rest of the header
@@ -1262,8 +1297,22 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
 
       Assert ( (version >= 2.0) &&
                (version <= 2.2), ExcNotImplemented());
-      Assert (file_type == 0, ExcNotImplemented());
-      Assert (data_size == sizeof(double), ExcNotImplemented());
+      AssertThrow (file_type == 0 || file_type == 1, ExcNotImplemented());
+      AssertThrow (data_size == sizeof(double), ExcNotImplemented());
+
+      // in binary files, the header is followed by the integer one written
+      // in binary form, which allows to detect the byte order
+      if (file_type == 1)
+        {
+          binary_format = true;
+          in.get();
+          int one;
+          in.read (reinterpret_cast<char *>(&one), sizeof(one));
+          AssertThrow (in && one == 1,
+                       ExcMessage ("The binary gmsh file was written on a "
+                                   "machine with a different byte order, "
+                                   "which is not supported."));
+        }
 
       // read the end of the header
       // and the first line of the
@@ -1297,10 +1346,9 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
   // now read the nodes list
   in >> n_vertices;
   std::vector<Point<spacedim> >     vertices (n_vertices);
-  // set up mapping between numbering
-  // in msh-file (nod) and in the
-  // vertices vector
-  std::map<int,int> vertex_indices;
+  std::vector<int>                  vertex_numbers (n_vertices);
+  if (binary_format)
+    in.get();
 
   for (unsigned int vertex=0; vertex<n_vertices; ++vertex)
     {
@@ -1308,14 +1356,62 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
       double x[3];
 
       // read vertex
-      in >> vertex_number
-         >> x[0] >> x[1] >> x[2];
+      if (binary_format)
+        {
+          in.read (reinterpret_cast<char *>(&vertex_number), sizeof(vertex_number));
+          in.read (reinterpret_cast<char *>(&x[0]), 3*sizeof(double));
+        }
+      else
+        in >> vertex_number
+           >> x[0] >> x[1] >> x[2];
 
       for (unsigned int d=0; d<spacedim; ++d)
         vertices[vertex](d) = x[d];
-      // store mapping
-      vertex_indices[vertex_number] = vertex;
+      vertex_numbers[vertex] = vertex_number;
     }
+  AssertThrow (in, ExcIO());
+
+  // set up mapping between numbering in msh-file (nod) and in the vertices
+  // vector. gmsh usually numbers the vertices consecutively starting at one,
+  // in which case we can use a vector rather than a map for the lookup,
+  // which is much faster for large meshes
+  std::map<int,unsigned int>  vertex_index_map;
+  std::vector<unsigned int>   vertex_index_table;
+  {
+    int min_number = 0, max_number = 0;
+    if (n_vertices > 0)
+      {
+        min_number = *std::min_element (vertex_numbers.begin(), vertex_numbers.end());
+        max_number = *std::max_element (vertex_numbers.begin(), vertex_numbers.end());
+      }
+    if (min_number >= 0 &&
+        static_cast<std::size_t>(max_number) < 2*static_cast<std::size_t>(n_vertices)+16)
+      {
+        vertex_index_table.resize (max_number+1, numbers::invalid_unsigned_int);
+        for (unsigned int vertex=0; vertex<n_vertices; ++vertex)
+          vertex_index_table[vertex_numbers[vertex]] = vertex;
+      }
+    else
+      for (unsigned int vertex=0; vertex<n_vertices; ++vertex)
+        vertex_index_map[vertex_numbers[vertex]] = vertex;
+  }
+  std::vector<int>().swap (vertex_numbers);
+
+  // return the index in the vertices vector of the vertex with the given
+  // number in the msh-file, or numbers::invalid_unsigned_int if there is no
+  // such vertex
+  const auto vertex_index = [&] (const int vertex_number) -> unsigned int
+  {
+    if (vertex_index_map.empty())
+      return ((vertex_number >= 0 &&
+               static_cast<std::size_t>(vertex_number) < vertex_index_table.size()) ?
+              vertex_index_table[vertex_number] :
+              numbers::invalid_unsigned_int);
+
+    const std::map<int,unsigned int>::const_iterator
+    p = vertex_index_map.find (vertex_number);
+    return (p != vertex_index_map.end() ? p->second : numbers::invalid_unsigned_int);
+  };
 
   // Assert we reached the end of the block
   in >> line;
@@ -1330,6 +1426,8 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
                ExcInvalidGMSHInput(line));
 
   in >> n_cells;
+  if (binary_format)
+    in.get();
 
   // set up array of cells and subcells (faces). In 1d, there is currently no
   // standard way in deal.II to pass boundary indicators attached to individual
@@ -1338,6 +1436,16 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
   SubCellData                                subcelldata;
   std::map<unsigned int, types::boundary_id> boundary_ids_1d;
 
+  // in the binary format, the elements are given in blocks of elements of
+  // the same type and with the same number of tags, each preceded by a
+  // header with the type, the number of elements, and the number of tags
+  int binary_block_header[3] = { 0, 0, 0 };
+  int binary_elements_left_in_block = 0;
+  std::vector<int> binary_element_data;
+
+  // the numbers of the nodes of the current element in the msh-file
+  std::vector<unsigned int> node_numbers;
+
   for (unsigned int cell=0; cell<n_cells; ++cell)
     {
       // note that since in the input
@@ -1365,41 +1473,79 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
       */
 
       unsigned int elm_number;
-      in >> elm_number     // ELM-NUMBER
-         >> cell_type;     // ELM-TYPE
-
-      switch (gmsh_file_format)
-        {
-        case 1:
+      if (binary_format)
         {
-          in >> material_id  // REG-PHYS
-             >> dummy        // reg_elm
-             >> nod_num;
-          break;
+          if (binary_elements_left_in_block == 0)
+            {
+              in.read (reinterpret_cast<char *>(&binary_block_header[0]),
+                       sizeof(binary_block_header));
+              AssertThrow (in, ExcIO());
+              binary_elements_left_in_block = binary_block_header[1];
+              AssertThrow (binary_elements_left_in_block > 0,
+                           ExcMessage ("Invalid element block in binary gmsh file."));
+            }
+          --binary_elements_left_in_block;
+
+          cell_type = binary_block_header[0];
+          const unsigned int n_tags = binary_block_header[2];
+          nod_num = gmsh_n_element_nodes (cell_type);
+
+          // we can not skip elements of unknown type since we do not know
+          // their size
+          AssertThrow (nod_num > 0, ExcGmshUnsupportedGeometry(cell_type));
+
+          binary_element_data.resize (1 + n_tags + nod_num);
+          in.read (reinterpret_cast<char *>(binary_element_data.data()),
+                   binary_element_data.size()*sizeof(int));
+          elm_number  = binary_element_data[0];
+          material_id = (n_tags > 0 ? binary_element_data[1] : 0);
+          node_numbers.assign (binary_element_data.begin()+1+n_tags,
+                               binary_element_data.end());
         }
-
-        case 2:
+      else
         {
-          // read the tags; ignore all but the first one which we will
-          // interpret as the material_id (for cells) or boundary_id
-          // (for faces)
-          unsigned int n_tags;
-          in >> n_tags;
-          if (n_tags > 0)
-            in >> material_id;
-          else
-            material_id = 0;
+          in >> elm_number     // ELM-NUMBER
+             >> cell_type;     // ELM-TYPE
 
-          for (unsigned int i=1; i<n_tags; ++i)
-            in >> dummy;
+          switch (gmsh_file_format)
+            {
+            case 1:
+            {
+              in >> material_id  // REG-PHYS
+                 >> dummy        // reg_elm
+                 >> nod_num;
+              break;
+            }
 
-          nod_num = GeometryInfo<dim>::vertices_per_cell;
+            case 2:
+            {
+              // read the tags; ignore all but the first one which we will
+              // interpret as the material_id (for cells) or boundary_id
+              // (for faces)
+              unsigned int n_tags;
+              in >> n_tags;
+              if (n_tags > 0)
+                in >> material_id;
+              else
+                material_id = 0;
 
-          break;
-        }
+              for (unsigned int i=1; i<n_tags; ++i)
+                in >> dummy;
+
+              // elements of types we do not know have no nodes here, the
+              // exception below is thrown for them anyway
+              nod_num = gmsh_n_element_nodes (cell_type);
+
+              break;
+            }
 
-        default:
-          AssertThrow (false, ExcNotImplemented());
+            default:
+              AssertThrow (false, ExcNotImplemented());
+            }
+
+          node_numbers.resize (nod_num);
+          for (unsigned int i=0; i<nod_num; ++i)
+            in >> node_numbers[i];
         }
 
 
@@ -1430,7 +1576,7 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
           // allocate and read indices
           cells.emplace_back ();
           for (unsigned int i=0; i<GeometryInfo<dim>::vertices_per_cell; ++i)
-            in >> cells.back().vertices[i];
+            cells.back().vertices[i] = node_numbers[i];
 
           // to make sure that the cast wont fail
           Assert(material_id<= std::numeric_limits<types::material_id>::max(),
@@ -1445,21 +1591,22 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
           // consecutive numbering
           for (unsigned int i=0; i<GeometryInfo<dim>::vertices_per_cell; ++i)
             {
-              AssertThrow (vertex_indices.find (cells.back().vertices[i]) !=
-                           vertex_indices.end(),
+              const unsigned int index = vertex_index (cells.back().vertices[i]);
+              AssertThrow (index != numbers::invalid_unsigned_int,
                            ExcInvalidVertexIndexGmsh(cell, elm_number,
                                                      cells.back().vertices[i]));
 
               // vertex with this index exists
-              cells.back().vertices[i] = vertex_indices[cells.back().vertices[i]];
+              cells.back().vertices[i] = index;
             }
         }
       else if ((cell_type == 1) && ((dim == 2) || (dim == 3)))
         // boundary info
         {
+          AssertThrow (nod_num >= 2, ExcIO());
           subcelldata.boundary_lines.emplace_back ();
-          in >> subcelldata.boundary_lines.back().vertices[0]
-             >> subcelldata.boundary_lines.back().vertices[1];
+          for (unsigned int i=0; i<2; ++i)
+            subcelldata.boundary_lines.back().vertices[i] = node_numbers[i];
 
           // to make sure that the cast wont fail
           Assert(material_id<= std::numeric_limits<types::boundary_id>::max(),
@@ -1474,29 +1621,23 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
           // transform from ucd to
           // consecutive numbering
           for (unsigned int i=0; i<2; ++i)
-            if (vertex_indices.find (subcelldata.boundary_lines.back().vertices[i]) !=
-                vertex_indices.end())
-              // vertex with this index exists
-              subcelldata.boundary_lines.back().vertices[i]
-                = vertex_indices[subcelldata.boundary_lines.back().vertices[i]];
-            else
-              {
-                // no such vertex index
-                AssertThrow (false,
-                             ExcInvalidVertexIndex(cell,
-                                                   subcelldata.boundary_lines.back().vertices[i]));
-                subcelldata.boundary_lines.back().vertices[i] =
-                  numbers::invalid_unsigned_int;
-              };
+            {
+              const unsigned int index
+                = vertex_index (subcelldata.boundary_lines.back().vertices[i]);
+              // no such vertex index
+              AssertThrow (index != numbers::invalid_unsigned_int,
+                           ExcInvalidVertexIndex(cell,
+                                                 subcelldata.boundary_lines.back().vertices[i]));
+              subcelldata.boundary_lines.back().vertices[i] = index;
+            }
         }
       else if ((cell_type == 3) && (dim == 3))
         // boundary info
         {
+          AssertThrow (nod_num >= 4, ExcIO());
           subcelldata.boundary_quads.emplace_back ();
-          in >> subcelldata.boundary_quads.back().vertices[0]
-             >> subcelldata.boundary_quads.back().vertices[1]
-             >> subcelldata.boundary_quads.back().vertices[2]
-             >> subcelldata.boundary_quads.back().vertices[3];
+          for (unsigned int i=0; i<4; ++i)
+            subcelldata.boundary_quads.back().vertices[i] = node_numbers[i];
 
           // to make sure that the cast wont fail
           Assert(material_id<= std::numeric_limits<types::boundary_id>::max(),
@@ -1511,45 +1652,27 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
           // transform from gmsh to
           // consecutive numbering
           for (unsigned int i=0; i<4; ++i)
-            if (vertex_indices.find (subcelldata.boundary_quads.back().vertices[i]) !=
-                vertex_indices.end())
-              // vertex with this index exists
-              subcelldata.boundary_quads.back().vertices[i]
-                = vertex_indices[subcelldata.boundary_quads.back().vertices[i]];
-            else
-              {
-                // no such vertex index
-                Assert (false,
-                        ExcInvalidVertexIndex(cell,
-                                              subcelldata.boundary_quads.back().vertices[i]));
-                subcelldata.boundary_quads.back().vertices[i] =
-                  numbers::invalid_unsigned_int;
-              }
+            {
+              const unsigned int index
+                = vertex_index (subcelldata.boundary_quads.back().vertices[i]);
+              // no such vertex index
+              Assert (index != numbers::invalid_unsigned_int,
+                      ExcInvalidVertexIndex(cell,
+                                            subcelldata.boundary_quads.back().vertices[i]));
+              subcelldata.boundary_quads.back().vertices[i] = index;
+            }
 
         }
       else if (cell_type == 15)
         {
-          // read the indices of nodes given
-          unsigned int node_index;
-          switch (gmsh_file_format)
-            {
-            case 1:
-            {
-              for (unsigned int i=0; i<nod_num; ++i)
-                in >> node_index;
-              break;
-            }
-            case 2:
-            {
-              in >> node_index;
-              break;
-            }
-            }
+          // the index of the node is the last one given
+          AssertThrow (nod_num > 0, ExcIO());
+          const unsigned int node_index = node_numbers[nod_num-1];
 
           // we only care about boundary indicators assigned to individual
           // vertices in 1d (because otherwise the vertices are not faces)
           if (dim == 1)
-            boundary_ids_1d[vertex_indices[node_index]] = material_id;
+            boundary_ids_1d[vertex_index(node_index)] = material_id;
         }
       else
         // cannot read this, so throw
@@ -2910,36 +3033,127 @@ GridIn<3>::debug_output_grid (const std::vector<CellData<3> > &cells,
 
 
 
+namespace
+{
+  /**
+   * Search the mesh file @p filename with the PathSearch mechanism and
+   * return its full name. If @p format is GridIn::Default, it is set to the
+   * format given by the suffix of the file name, if any.
+   */
+  template <int dim, int spacedim>
+  std::string
+  find_mesh_file (const std::string                      &filename,
+                  typename GridIn<dim,spacedim>::Format  &format)
+  {
+    // Search file class for meshes
+    PathSearch search("MESH");
+    std::string name;
+    if (format == GridIn<dim,spacedim>::Default)
+      name = search.find(filename);
+    else
+      name = search.find(filename, GridIn<dim,spacedim>::default_suffix(format));
+
+    if (format == GridIn<dim,spacedim>::Default)
+      {
+        const std::string::size_type slashpos = name.find_last_of('/');
+        const std::string::size_type dotpos = name.find_last_of('.');
+        if (dotpos < name.length()
+            && (dotpos > slashpos || slashpos == std::string::npos))
+          {
+            std::string ext = name.substr(dotpos+1);
+            format = GridIn<dim,spacedim>::parse_format(ext);
+          }
+      }
+    return name;
+  }
+}
+
+
+
 template <int dim, int spacedim>
 void GridIn<dim, spacedim>::read (const std::string &filename,
                                   Format format)
 {
-  // Search file class for meshes
-  PathSearch search("MESH");
-  std::string name;
   // Open the file and remember its name
-  if (format == Default)
-    name = search.find(filename);
+  const std::string name = find_mesh_file<dim,spacedim> (filename, format);
+  std::ifstream in(name.c_str());
+
+  if (format == netcdf)
+    read_netcdf(filename);
   else
-    name = search.find(filename, default_suffix(format));
+    read(in, format);
+}
 
-  std::ifstream in(name.c_str());
 
-  if (format == Default)
+
+template <int dim, int spacedim>
+void GridIn<dim, spacedim>::read_and_broadcast (const std::string &filename,
+                                                const MPI_Comm    &mpi_communicator,
+                                                Format             format)
+{
+#ifndef DEAL_II_WITH_MPI
+  (void)mpi_communicator;
+  read (filename, format);
+#else
+  if (format == netcdf || format == assimp ||
+      Utilities::MPI::n_mpi_processes(mpi_communicator) == 1)
     {
-      const std::string::size_type slashpos = name.find_last_of('/');
-      const std::string::size_type dotpos = name.find_last_of('.');
-      if (dotpos < name.length()
-          && (dotpos > slashpos || slashpos == std::string::npos))
+      read (filename, format);
+      return;
+    }
+
+  // the first process finds and reads the file, and determines the format
+  // if it is not given
+  const unsigned int my_rank = Utilities::MPI::this_mpi_process(mpi_communicator);
+  std::string contents;
+  int format_and_status[2] = { static_cast<int>(format), 1 };
+  if (my_rank == 0)
+    {
+      // do not throw before the other processes know about the failure,
+      // they would wait for the broadcast below forever
+      try
+        {
+          const std::string name = find_mesh_file<dim,spacedim> (filename, format);
+          format_and_status[0] = static_cast<int>(format);
+          if (format != netcdf && format != assimp)
+            {
+              std::ifstream in (name.c_str(), std::ios::binary);
+              if (in)
+                {
+                  std::ostringstream buffer;
+                  buffer << in.rdbuf();
+                  contents = buffer.str();
+                }
+              else
+                format_and_status[1] = 0;
+            }
+        }
+      catch (...)
         {
-          std::string ext = name.substr(dotpos+1);
-          format = parse_format(ext);
+          format_and_status[1] = 0;
         }
     }
-  if (format == netcdf)
-    read_netcdf(filename);
-  else
-    read(in, format);
+
+  int ierr = MPI_Bcast (&format_and_status[0], 2, MPI_INT, 0, mpi_communicator);
+  AssertThrowMPI(ierr);
+  format = static_cast<Format>(format_and_status[0]);
+  AssertThrow (format_and_status[1] == 1,
+               ExcMessage ("The mesh file <" + filename + "> could not be "
+                           "found or opened on the first process."));
+
+  // the suffix of the file may tell that it can only be read from a file
+  if (format == netcdf || format == assimp)
+    {
+      read (filename, format);
+      return;
+    }
+
+  Utilities::MPI::broadcast (contents, mpi_communicator);
+
+  std::istringstream in (contents);
+  std::string().swap (contents);
+  read (in, format);
+#endif
 }
 
 
@@ -127,6 +127,72 @@ namespace internal
 
         return t;
       }
+
+
+
+      /**
+       * Consider the entries of the range [begin,end) in the order given by
+       * @p comp and return the smallest number k of leading entries whose
+       * sum is not less than @p target, but at most end-begin-1. The k-th
+       * and the (k+1)-th entry in this order are returned in @p last_summed
+       * and @p first_not_summed; the former is only set if k>0.
+       *
+       * This gives the same result as sorting the range and summing up its
+       * entries from the front, but only sorts the part of the range around
+       * the k-th entry. The range is repeatedly split in half by
+       * std::nth_element(), which takes linear time on average.
+       */
+      template <typename Iterator, typename Compare>
+      unsigned int
+      count_leading_entries_for_sum (const Iterator begin,
+                                     const Iterator end,
+                                     const double   target,
+                                     const Compare  comp,
+                                     typename std::iterator_traits<Iterator>::value_type &last_summed,
+                                     typename std::iterator_traits<Iterator>::value_type &first_not_summed)
+      {
+        const unsigned int n = end - begin;
+        Assert (n > 0, ExcInternalError());
+
+        // narrow down the range [lo,hi) such that it contains the lo-th to
+        // the hi-th entries in sorted order, the sum of the entries before
+        // it is less than the target, and the sum including the entries up
+        // to hi is not
+        unsigned int lo = 0, hi = n;
+        double sum = 0;
+        while (hi - lo > 64)
+          {
+            const unsigned int mid = lo + (hi - lo) / 2;
+            std::nth_element (begin+lo, begin+mid, begin+hi, comp);
+            const double partial_sum = std::accumulate (begin+lo, begin+mid,
+                                                        0.);
+            if (sum + partial_sum < target)
+              {
+                sum += partial_sum;
+                lo = mid;
+              }
+            else
+              hi = mid;
+          }
+
+        // the rest of the way is walked on the sorted subrange
+        std::sort (begin+lo, begin+hi, comp);
+        unsigned int k = lo;
+        for (; (sum < target) && (k != n-1) && (k != hi); ++k)
+          sum += *(begin+k);
+
+        if (k > lo)
+          last_summed = *(begin+k-1);
+        else if (k > 0)
+          last_summed = *std::max_element (begin, begin+lo, comp);
+
+        if (k < hi)
+          first_not_summed = *(begin+k);
+        else
+          first_not_summed = *std::min_element (begin+hi, end, comp);
+
+        return k;
+      }
     }
   } /* namespace GridRefinement */
 } /* namespace internal */
@@ -358,29 +424,30 @@ GridRefinement::refine_and_coarsen_fixed_fraction (Triangulation<dim,spacedim> &
   tmp = criteria;
   const double total_error = tmp.l1_norm();
 
-  // sort the largest criteria to the
-  // beginning of the vector
-  std::sort (tmp.begin(), tmp.end(), std::greater<double>());
-
-  // compute thresholds
-  typename Vector<typename VectorType::value_type>::const_iterator
-  pp=tmp.begin();
-  for (double sum=0;
-       (sum<top_fraction*total_error) && (pp!=(tmp.end()-1));
-       ++pp)
-    sum += *pp;
-  double top_threshold = ( pp != tmp.begin () ?
-                           (*pp+*(pp-1))/2 :
-                           *pp );
-  typename Vector<typename VectorType::value_type>::const_iterator
-  qq=(tmp.end()-1);
-  for (double sum=0;
-       (sum<bottom_fraction*total_error) && (qq!=tmp.begin());
-       --qq)
-    sum += *qq;
-  double bottom_threshold = ( qq != (tmp.end()-1) ?
-                              (*qq + *(qq+1))/2 :
+  // compute thresholds: the top threshold lies between the smallest of
+  // the largest criteria that together make up the top fraction of the
+  // total error and the next smaller one, and similarly for the bottom
+  // threshold. rather than sorting the whole vector, only find these
+  // entries
+  typename VectorType::value_type last_summed = 0, first_not_summed = 0;
+  const unsigned int refine_cells
+    = internal::GridRefinement::count_leading_entries_for_sum
+      (tmp.begin(), tmp.end(), top_fraction*total_error,
+       std::greater<typename VectorType::value_type>(),
+       last_summed, first_not_summed);
+  double top_threshold = ( refine_cells != 0 ?
+                           (first_not_summed+last_summed)/2 :
+                           first_not_summed );
+
+  const unsigned int n_bottom_cells
+    = internal::GridRefinement::count_leading_entries_for_sum
+      (tmp.begin(), tmp.end(), bottom_fraction*total_error,
+       std::less<typename VectorType::value_type>(),
+       last_summed, first_not_summed);
+  double bottom_threshold = ( n_bottom_cells != 0 ?
+                              (first_not_summed + last_summed)/2 :
                               0);
+  const unsigned int coarsen_cells = n_bottom_cells + 1;
 
   // we now have an idea how many cells we
   // are going to refine and coarsen. we use
@@ -395,9 +462,6 @@ GridRefinement::refine_and_coarsen_fixed_fraction (Triangulation<dim,spacedim> &
   // isotropic refinement as guess for a mixed
   // refinemnt as well.
   {
-    const unsigned int refine_cells  = pp - tmp.begin(),
-                       coarsen_cells = tmp.end() - qq;
-
     if (static_cast<unsigned int>
         (tria.n_active_cells()
          + refine_cells * (GeometryInfo<dim>::max_children_per_cell - 1)
@@ -457,7 +521,7 @@ GridRefinement::refine_and_coarsen_fixed_fraction (Triangulation<dim,spacedim> &
 
   // actually flag cells
   if (top_threshold < internal::GridRefinement::max_element(criteria))
-    refine (tria, criteria, top_threshold, pp - tmp.begin());
+    refine (tria, criteria, top_threshold, refine_cells);
 
   if (bottom_threshold > internal::GridRefinement::min_element(criteria))
     coarsen (tria, criteria, bottom_threshold);
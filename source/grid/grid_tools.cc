@@ -13,6 +13,7 @@
 //
 // ---------------------------------------------------------------------
 
+#include <deal.II/base/mpi.templates.h>
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/thread_management.h>
 #include <deal.II/lac/vector.h>
@@ -49,9 +50,12 @@
 
 #include <boost/random/uniform_real_distribution.hpp>
 #include <boost/random/mersenne_twister.hpp>
+#include <boost/serialization/utility.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <numeric>
 #include <list>
 #include <set>
@@ -551,6 +555,118 @@ namespace GridTools
 
 
 
+  template <int spacedim>
+  std::vector<std::uint64_t>
+  compute_space_filling_curve_indices (const std::vector<Point<spacedim> > &points,
+                                       const SpaceFillingCurve              curve)
+  {
+    std::vector<std::uint64_t> indices (points.size());
+    if (points.size() == 0)
+      return indices;
+
+    // the number of bits of each coordinate, such that the bits of all
+    // coordinates fit into one index, and the coordinates can still be
+    // represented exactly as double
+    const unsigned int n_bits = std::min (64/spacedim, 52);
+    const std::uint64_t max_coordinate = (std::uint64_t(1) << n_bits) - 1;
+
+    Point<spacedim> lower = points[0], upper = points[0];
+    for (const auto &point : points)
+      for (unsigned int d=0; d<spacedim; ++d)
+        {
+          lower[d] = std::min (lower[d], point[d]);
+          upper[d] = std::max (upper[d], point[d]);
+        }
+
+    for (unsigned int i=0; i<points.size(); ++i)
+      {
+        std::array<std::uint64_t,spacedim> x;
+        for (unsigned int d=0; d<spacedim; ++d)
+          x[d] = (upper[d] > lower[d] ?
+                  static_cast<std::uint64_t>((points[i][d]-lower[d]) / (upper[d]-lower[d]) *
+                                             max_coordinate) :
+                  0);
+
+        // transform the coordinates into the transposed form of the Hilbert
+        // index, following J. Skilling, "Programming the Hilbert curve", AIP
+        // Conference Proceedings 707, 2004. in one dimension, both curves
+        // follow the coordinate
+        if (curve == hilbert_curve && spacedim > 1)
+          {
+            for (std::uint64_t q = std::uint64_t(1) << (n_bits-1); q > 1; q >>= 1)
+              {
+                const std::uint64_t p = q - 1;
+                for (unsigned int d=0; d<spacedim; ++d)
+                  if (x[d] & q)
+                    x[0] ^= p;
+                  else
+                    {
+                      const std::uint64_t t = (x[0] ^ x[d]) & p;
+                      x[0] ^= t;
+                      x[d] ^= t;
+                    }
+              }
+
+            for (unsigned int d=1; d<spacedim; ++d)
+              x[d] ^= x[d-1];
+            std::uint64_t t = 0;
+            for (std::uint64_t q = std::uint64_t(1) << (n_bits-1); q > 1; q >>= 1)
+              if (x[spacedim-1] & q)
+                t ^= q - 1;
+            for (unsigned int d=0; d<spacedim; ++d)
+              x[d] ^= t;
+          }
+
+        // interleave the bits, starting with the most significant ones
+        std::uint64_t index = 0;
+        for (int b=n_bits-1; b>=0; --b)
+          for (unsigned int d=0; d<spacedim; ++d)
+            index = (index << 1) | ((x[d] >> b) & 1);
+        indices[i] = index;
+      }
+
+    return indices;
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  reorder_cells_along_space_filling_curve (const std::vector<Point<spacedim> > &vertices,
+                                           std::vector<CellData<dim> >         &cells,
+                                           const SpaceFillingCurve              curve)
+  {
+    std::vector<Point<spacedim> > centers (cells.size());
+    for (unsigned int c=0; c<cells.size(); ++c)
+      {
+        for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+          {
+            AssertIndexRange (cells[c].vertices[v], vertices.size());
+            centers[c] += vertices[cells[c].vertices[v]];
+          }
+        centers[c] /= GeometryInfo<dim>::vertices_per_cell;
+      }
+
+    const std::vector<std::uint64_t> indices
+      = compute_space_filling_curve_indices (centers, curve);
+    std::vector<unsigned int> order (cells.size());
+    for (unsigned int c=0; c<cells.size(); ++c)
+      order[c] = c;
+    std::stable_sort (order.begin(), order.end(),
+                      [&](const unsigned int a, const unsigned int b)
+    {
+      return indices[a] < indices[b];
+    });
+
+    std::vector<CellData<dim> > sorted_cells;
+    sorted_cells.reserve (cells.size());
+    for (const unsigned int c : order)
+      sorted_cells.push_back (cells[c]);
+    cells.swap (sorted_cells);
+  }
+
+
+
 // define some transformations in an anonymous namespace
   namespace
   {
@@ -2282,7 +2398,7 @@ next_cell:
         while (found_neighbors)
           {
             found_neighbors = false;
-            for (unsigned int i=0; i<bounding_boxes.size()-1; ++i)
+            for (unsigned int i=0; i+1<bounding_boxes.size(); ++i)
               {
                 if ( std::find(merged_boxes_idx.begin(),merged_boxes_idx.end(),i) == merged_boxes_idx.end())
                   for (unsigned int j=i+1; j<bounding_boxes.size(); ++j)
@@ -2824,6 +2940,33 @@ next_cell:
   void
   partition_triangulation (const unsigned int           n_partitions,
                            Triangulation<dim,spacedim> &triangulation)
+  {
+    partition_triangulation (n_partitions,
+                             std::vector<unsigned int>(),
+                             triangulation);
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  partition_triangulation (const unsigned int           n_partitions,
+                           const SparsityPattern        &cell_connection_graph,
+                           Triangulation<dim,spacedim>  &triangulation)
+  {
+    partition_triangulation (n_partitions,
+                             std::vector<unsigned int>(),
+                             cell_connection_graph,
+                             triangulation);
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  partition_triangulation (const unsigned int               n_partitions,
+                           const std::vector<unsigned int> &cell_weights,
+                           Triangulation<dim,spacedim>     &triangulation)
   {
     Assert ((dynamic_cast<parallel::distributed::Triangulation<dim,spacedim>*>
              (&triangulation)
@@ -2855,6 +2998,7 @@ next_cell:
     SparsityPattern sp_cell_connectivity;
     sp_cell_connectivity.copy_from(cell_connectivity);
     partition_triangulation (n_partitions,
+                             cell_weights,
                              sp_cell_connectivity,
                              triangulation);
   }
@@ -2863,9 +3007,10 @@ next_cell:
 
   template <int dim, int spacedim>
   void
-  partition_triangulation (const unsigned int           n_partitions,
-                           const SparsityPattern        &cell_connection_graph,
-                           Triangulation<dim,spacedim>  &triangulation)
+  partition_triangulation (const unsigned int               n_partitions,
+                           const std::vector<unsigned int> &cell_weights,
+                           const SparsityPattern           &cell_connection_graph,
+                           Triangulation<dim,spacedim>     &triangulation)
   {
     Assert ((dynamic_cast<parallel::distributed::Triangulation<dim,spacedim>*>
              (&triangulation)
@@ -2878,6 +3023,10 @@ next_cell:
             ExcMessage ("Connectivity graph has wrong size"));
     Assert (cell_connection_graph.n_cols() == triangulation.n_active_cells(),
             ExcMessage ("Connectivity graph has wrong size"));
+    Assert (cell_weights.size() == 0 ||
+            cell_weights.size() == triangulation.n_active_cells(),
+            ExcMessage ("The number of cell weights must be zero or equal "
+                        "to the number of active cells."));
 
     // check for an easy return
     if (n_partitions == 1)
@@ -2894,7 +3043,8 @@ next_cell:
     // of freedom (which is associated with a
     // cell)
     std::vector<unsigned int> partition_indices (triangulation.n_active_cells());
-    SparsityTools::partition (cell_connection_graph, n_partitions,  partition_indices);
+    SparsityTools::partition (cell_connection_graph, cell_weights,
+                              n_partitions, partition_indices);
 
     // finally loop over all cells and set the
     // subdomain ids
@@ -5171,6 +5321,11 @@ next_cell:
     std::get<1>(cell_qpoint_map).emplace_back(1, my_pair.second);
     std::get<2>(cell_qpoint_map).emplace_back(1, 0);
 
+    // The position of each cell found so far in the output, by active cell
+    // index
+    std::map<unsigned int,unsigned int> cell_positions;
+    cell_positions[my_pair.first->active_cell_index()] = 0;
+
     // Now the second easy case.
     if (np==1) return cell_qpoint_map;
     // Computing the cell center and diameter
@@ -5200,12 +5355,14 @@ next_cell:
         else
           {
             // Check if it is in another cell already found
-            typename std::vector<typename Triangulation<dim, spacedim>::active_cell_iterator>::iterator
-            cells_it = std::find(std::get<0>(cell_qpoint_map).begin(),std::get<0>(cell_qpoint_map).end()-1,my_pair.first);
+            const typename std::map<unsigned int,unsigned int>::const_iterator
+            cells_it = cell_positions.find(my_pair.first->active_cell_index());
 
-            if ( cells_it == std::get<0>(cell_qpoint_map).end()-1 )
+            if ( cells_it == cell_positions.end() )
               {
                 // Cell not found: adding a new cell
+                cell_positions[my_pair.first->active_cell_index()]
+                  = std::get<0>(cell_qpoint_map).size();
                 std::get<0>(cell_qpoint_map).emplace_back(my_pair.first);
                 std::get<1>(cell_qpoint_map).emplace_back(1, my_pair.second);
                 std::get<2>(cell_qpoint_map).emplace_back(1, p);
@@ -5216,7 +5373,7 @@ next_cell:
               }
             else
               {
-                unsigned int current_cell = cells_it - std::get<0>(cell_qpoint_map).begin();
+                const unsigned int current_cell = cells_it->second;
                 // Cell found: just adding the point index and qpoint to the list
                 std::get<1>(cell_qpoint_map)[current_cell].emplace_back(my_pair.second);
                 std::get<2>(cell_qpoint_map)[current_cell].emplace_back(p);
@@ -5255,6 +5412,113 @@ next_cell:
 
 
 
+  template <int dim, int spacedim>
+  std::tuple<
+  std::vector<typename Triangulation<dim, spacedim>::active_cell_iterator >,
+      std::vector< std::vector< Point<dim> > >,
+      std::vector< std::vector< std::pair<unsigned int,unsigned int> > >,
+      std::vector<unsigned int> >
+      distributed_compute_point_locations(const Cache<dim,spacedim>           &cache,
+                                          const std::vector<Point<spacedim> > &local_points)
+  {
+    const Triangulation<dim,spacedim> &tria = cache.get_triangulation();
+    const Mapping<dim,spacedim> &mapping = cache.get_mapping();
+
+    const parallel::Triangulation<dim,spacedim> *parallel_tria
+      = dynamic_cast<const parallel::Triangulation<dim,spacedim> *>(&tria);
+    const MPI_Comm mpi_communicator = (parallel_tria != nullptr ?
+                                       parallel_tria->get_communicator() :
+                                       MPI_COMM_SELF);
+
+    // Step 1: send each point, together with its index, to all processes
+    // with a bounding box containing it
+    typedef std::vector<std::pair<unsigned int, Point<spacedim> > > PointList;
+    std::map<unsigned int, PointList> points_to_send;
+    for (unsigned int i=0; i<local_points.size(); ++i)
+      for (const unsigned int rank : cache.get_point_owner_candidates(local_points[i]))
+        points_to_send[rank].emplace_back(i, local_points[i]);
+
+    const std::map<unsigned int, PointList> received_points
+      = (parallel_tria != nullptr ?
+         Utilities::MPI::some_to_some(mpi_communicator, points_to_send) :
+         points_to_send);
+
+    // Step 2: locate the received points. A point belongs to the cell with
+    // the lowest subdomain id among all cells, including the ghost cells,
+    // that contain it. All processes with such a cell come to the same
+    // conclusion, so each point is located exactly once
+    std::tuple<
+    std::vector<typename Triangulation<dim, spacedim>::active_cell_iterator >,
+        std::vector< std::vector< Point<dim> > >,
+        std::vector< std::vector< std::pair<unsigned int,unsigned int> > >,
+        std::vector<unsigned int> >
+        result;
+    std::map<unsigned int,unsigned int> cell_positions;
+    std::map<unsigned int, std::vector<unsigned int> > found_points;
+
+    for (const auto &rank_and_points : received_points)
+      for (const auto &index_and_point : rank_and_points.second)
+        {
+          typename Triangulation<dim,spacedim>::active_cell_iterator owner_cell = tria.end();
+          types::subdomain_id owner = numbers::invalid_subdomain_id;
+          Point<dim> owner_unit_point;
+          for (const auto &cell : cache.get_cell_candidates(index_and_point.second))
+            if (!cell->is_artificial() && cell->subdomain_id() < owner)
+              {
+                try
+                  {
+                    const Point<dim> p_unit
+                      = mapping.transform_real_to_unit_cell(cell, index_and_point.second);
+                    if (GeometryInfo<dim>::is_inside_unit_cell(p_unit, 1e-10))
+                      {
+                        owner_cell = cell;
+                        owner = cell->subdomain_id();
+                        owner_unit_point = p_unit;
+                      }
+                  }
+                catch (typename Mapping<dim,spacedim>::ExcTransformationFailed &)
+                  {}
+              }
+
+          if (owner_cell == tria.end() || !owner_cell->is_locally_owned())
+            continue;
+
+          const auto position = cell_positions.insert
+                                (std::make_pair(owner_cell->active_cell_index(),
+                                                std::get<0>(result).size()));
+          if (position.second)
+            {
+              std::get<0>(result).push_back(owner_cell);
+              std::get<1>(result).emplace_back();
+              std::get<2>(result).emplace_back();
+            }
+          std::get<1>(result)[position.first->second].push_back(owner_unit_point);
+          std::get<2>(result)[position.first->second].emplace_back(rank_and_points.first,
+                                                                    index_and_point.first);
+          found_points[rank_and_points.first].push_back(index_and_point.first);
+        }
+
+    // Step 3: tell the senders which of their points have been located
+    const std::map<unsigned int, std::vector<unsigned int> > located_points
+      = (parallel_tria != nullptr ?
+         Utilities::MPI::some_to_some(mpi_communicator, found_points) :
+         found_points);
+
+    std::get<3>(result).resize(local_points.size(), numbers::invalid_unsigned_int);
+    for (const auto &rank_and_indices : located_points)
+      for (const unsigned int index : rank_and_indices.second)
+        {
+          AssertIndexRange(index, local_points.size());
+          Assert(std::get<3>(result)[index] == numbers::invalid_unsigned_int,
+                 ExcInternalError());
+          std::get<3>(result)[index] = rank_and_indices.first;
+        }
+
+    return result;
+  }
+
+
+
   template<int dim, int spacedim>
   std::map<unsigned int, Point<spacedim> >
   extract_used_vertices(const Triangulation<dim, spacedim> &container,
@@ -5296,6 +5560,48 @@ next_cell:
   {
     const auto &mesh = cache.get_triangulation();
     const auto &mapping = cache.get_mapping();
+
+    // return whether the point lies in the given cell, and compute its
+    // location in the reference cell
+    std::pair<typename Triangulation<dim,spacedim>::active_cell_iterator, Point<dim> > cell_and_position;
+    const auto point_is_inside
+      = [&](const typename Triangulation<dim,spacedim>::active_cell_iterator &cell) -> bool
+    {
+      try
+        {
+          const Point<dim> p_unit = mapping.transform_real_to_unit_cell(cell, p);
+          if (GeometryInfo<dim>::is_inside_unit_cell(p_unit))
+            {
+              cell_and_position.first = cell;
+              cell_and_position.second = p_unit;
+              return true;
+            }
+        }
+      catch (typename Mapping<dim,spacedim>::ExcTransformationFailed &)
+        {}
+      return false;
+    };
+
+    // first try the hint, then all cells whose bounding box contains the
+    // point. unless vertices are marked, which restricts the search to the
+    // cells around them
+    if (marked_vertices.size() == 0)
+      {
+        if (cell_hint.state() == IteratorState::valid && point_is_inside(cell_hint))
+          return cell_and_position;
+
+        for (const auto &cell : cache.get_cell_candidates(p))
+          if (cell != cell_hint && point_is_inside(cell))
+            return cell_and_position;
+
+        // the bounding boxes cover all cells of a MappingQGeneric, so the
+        // point is outside the mesh. for other mappings, the boxes only
+        // cover the vertices, so we fall back to the search around
+        // vertices below
+        AssertThrow((dynamic_cast<const MappingQGeneric<dim,spacedim> *>(&mapping) == nullptr),
+                    ExcPointNotFound<spacedim>(p));
+      }
+
     const auto &vertex_to_cells = cache.get_vertex_to_cell_map();
     const auto &vertex_to_cell_centers = cache.get_vertex_to_cell_centers_directions();
 
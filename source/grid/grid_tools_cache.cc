@@ -15,11 +15,110 @@
 
 #include <deal.II/grid/grid_tools_cache.h>
 #include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/filtered_iterator.h>
+#include <deal.II/distributed/tria_base.h>
+
+#include <algorithm>
+#include <cmath>
 
 DEAL_II_NAMESPACE_OPEN
 
 namespace GridTools
 {
+  namespace
+  {
+    /**
+     * Return the index of the bin in coordinate direction @p d of the
+     * uniform subdivision of @p covering_box into @p n_bins bins that
+     * contains the coordinate @p x. Coordinates outside the box are moved
+     * to the first or last bin.
+     */
+    template <int spacedim>
+    unsigned int
+    bin_coordinate (const BoundingBox<spacedim> &covering_box,
+                    const unsigned int           n_bins,
+                    const unsigned int           d,
+                    const double                 x)
+    {
+      const double lower = covering_box.get_boundary_points().first[d];
+      const double upper = covering_box.get_boundary_points().second[d];
+      if (!(upper > lower) || !(x > lower))
+        return 0;
+      const double relative = (x - lower) / (upper - lower) * n_bins;
+      return std::min(static_cast<unsigned int>(relative), n_bins-1);
+    }
+
+
+
+    /**
+     * Return the index of the bin of the uniform subdivision of @p
+     * covering_box into @p n_bins bins per coordinate direction that contains
+     * the point @p p, with the first coordinate running fastest.
+     */
+    template <int spacedim>
+    unsigned int
+    bin_index (const BoundingBox<spacedim>               &covering_box,
+               const std::array<unsigned int,spacedim> &n_bins,
+               const Point<spacedim>                     &p)
+    {
+      unsigned int index = 0;
+      for (int d=spacedim-1; d>=0; --d)
+        index = index*n_bins[d] + bin_coordinate(covering_box, n_bins[d], d, p[d]);
+      return index;
+    }
+
+
+
+    /**
+     * Append @p value to the entries of all bins of the uniform subdivision
+     * of @p covering_box into @p n_bins bins per coordinate direction that
+     * are touched by @p box, unless it is already the last entry of a bin.
+     */
+    template <int spacedim>
+    void
+    insert_into_bins (const BoundingBox<spacedim>               &covering_box,
+                      const std::array<unsigned int,spacedim> &n_bins,
+                      const BoundingBox<spacedim>               &box,
+                      const unsigned int                         value,
+                      std::vector<std::vector<unsigned int> >   &bins)
+    {
+      std::array<unsigned int,spacedim> lower, upper;
+      for (unsigned int d=0; d<spacedim; ++d)
+        {
+          lower[d] = bin_coordinate(covering_box, n_bins[d], d,
+                                    box.get_boundary_points().first[d]);
+          upper[d] = bin_coordinate(covering_box, n_bins[d], d,
+                                    box.get_boundary_points().second[d]);
+        }
+
+      // loop over all bins between lower and upper, with the first
+      // coordinate running fastest
+      std::array<unsigned int,spacedim> bin = lower;
+      while (true)
+        {
+          unsigned int index = 0;
+          for (int d=spacedim-1; d>=0; --d)
+            index = index*n_bins[d] + bin[d];
+          if (bins[index].empty() || bins[index].back() != value)
+            bins[index].push_back(value);
+
+          unsigned int d = 0;
+          for (; d<spacedim; ++d)
+            if (bin[d] < upper[d])
+              {
+                ++bin[d];
+                break;
+              }
+            else
+              bin[d] = lower[d];
+          if (d == spacedim)
+            break;
+        }
+    }
+  }
+
+
+
 
   template<int dim, int spacedim>
   Cache<dim,spacedim>::Cache(
@@ -29,19 +128,59 @@ namespace GridTools
     tria(&tria),
     mapping(&mapping)
   {
-    tria_signal = tria.signals.any_change.connect([&]()
+    tria_signals.push_back(tria.signals.create.connect([this]()
+    {
+      mark_for_update(update_all);
+    }));
+    tria_signals.push_back(tria.signals.clear.connect([this]()
     {
       mark_for_update(update_all);
-    });
+    }));
+
+    // moving the vertices does not change which cells are adjacent to a
+    // vertex
+    tria_signals.push_back(tria.signals.mesh_movement.connect([this]()
+    {
+      mark_for_update((update_vertex_to_cell_centers_directions & ~update_vertex_to_cell_map) |
+                      update_vertex_kdtree |
+                      update_used_vertices |
+                      update_locally_relevant_vertices |
+                      update_global_bounding_boxes |
+                      update_cell_bounding_boxes |
+                      update_cell_bounding_box_index);
+    }));
+
+    // after refinement, the vertex to cell map only needs to be updated
+    // around the cells that were refined or coarsened. in 3d, refining a
+    // cell also adds hanging vertices to the cells that only share an edge
+    // with it, which are hard to find, so we recompute the whole map there
+    tria_signals.push_back(tria.signals.post_refinement_on_cell.connect
+                           ([this](const typename Triangulation<dim,spacedim>::cell_iterator &cell)
+    {
+      record_changed_cell(cell, true);
+    }));
+    tria_signals.push_back(tria.signals.pre_coarsening_on_cell.connect
+                           ([this](const typename Triangulation<dim,spacedim>::cell_iterator &cell)
+    {
+      record_changed_cell(cell, false);
+    }));
+    tria_signals.push_back(tria.signals.post_refinement.connect([this]()
+    {
+      if (dim == 3)
+        mark_for_update(update_all);
+      else
+        mark_for_update(update_all & ~update_vertex_to_cell_map);
+    }));
   }
 
   template<int dim, int spacedim>
   Cache<dim,spacedim>::~Cache()
   {
-    // Make sure that the signals that was attached to the triangulation
-    // is removed here.
-    if (tria_signal.connected())
-      tria_signal.disconnect();
+    // Make sure that the signals that were attached to the triangulation
+    // are removed here.
+    for (auto &signal : tria_signals)
+      if (signal.connected())
+        signal.disconnect();
   }
 
 
@@ -61,13 +200,226 @@ namespace GridTools
     if (update_flags & update_vertex_to_cell_map)
       {
         vertex_to_cells = GridTools::vertex_to_cell_map(*tria);
+        changed_vertices.clear();
+        new_active_cells.clear();
         update_flags = update_flags & ~update_vertex_to_cell_map;
       }
+    else
+      update_changed_vertices();
     return vertex_to_cells;
   }
 
 
 
+  template<int dim, int spacedim>
+  void
+  Cache<dim,spacedim>::record_changed_cell(const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                           const bool refined)
+  {
+    // nothing to do if the whole map is recomputed anyway
+    if (dim == 3 || (update_flags & update_vertex_to_cell_map))
+      return;
+
+    // the vertices of the parent are vertices of the children as well
+    for (unsigned int c=0; c<cell->n_children(); ++c)
+      {
+        for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+          changed_vertices.push_back(cell->child(c)->vertex_index(v));
+        if (refined)
+          new_active_cells.push_back(cell->child(c));
+      }
+    if (!refined)
+      new_active_cells.push_back(cell);
+  }
+
+
+
+  template<int dim, int spacedim>
+  void
+  Cache<dim,spacedim>::update_changed_vertices() const
+  {
+    if (changed_vertices.empty())
+      {
+        new_active_cells.clear();
+        return;
+      }
+
+    std::sort(changed_vertices.begin(), changed_vertices.end());
+    changed_vertices.erase(std::unique(changed_vertices.begin(), changed_vertices.end()),
+                           changed_vertices.end());
+
+    vertex_to_cells.resize(tria->n_vertices());
+    std::vector<bool> vertex_changed(tria->n_vertices(), false);
+
+    // all active cells that contribute to the entry of a vertex, either
+    // because the vertex is one of their own vertices, or because it is a
+    // hanging vertex on the face of a neighbor, have the vertex among their
+    // vertices. they were therefore either stored in the entry before, or
+    // have become active since
+    std::vector<typename Triangulation<dim,spacedim>::cell_iterator> cells;
+    cells.swap(new_active_cells);
+    for (const unsigned int v : changed_vertices)
+      {
+        vertex_changed[v] = true;
+        cells.insert(cells.end(), vertex_to_cells[v].begin(), vertex_to_cells[v].end());
+        vertex_to_cells[v].clear();
+      }
+    std::sort(cells.begin(), cells.end());
+    cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+    // now insert the cells in the same way as GridTools::vertex_to_cell_map()
+    // does, but only for the changed vertices. some of the cells may have
+    // been refined or deleted in the meantime
+    for (const auto &cell : cells)
+      {
+        if (static_cast<unsigned int>(cell->level()) >= tria->n_levels()
+            ||
+            static_cast<unsigned int>(cell->index()) >= tria->n_raw_cells(cell->level())
+            ||
+            !cell->used()
+            ||
+            !cell->active())
+          continue;
+
+        const typename Triangulation<dim,spacedim>::active_cell_iterator active_cell (cell);
+        for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+          if (vertex_changed[cell->vertex_index(v)])
+            vertex_to_cells[cell->vertex_index(v)].insert(active_cell);
+
+        for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+          if ((cell->at_boundary(f)==false) && (cell->neighbor(f)->active()))
+            {
+              const typename Triangulation<dim,spacedim>::active_cell_iterator
+              adjacent_cell (cell->neighbor(f));
+              for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_face; ++v)
+                if (vertex_changed[cell->face(f)->vertex_index(v)])
+                  vertex_to_cells[cell->face(f)->vertex_index(v)].insert(adjacent_cell);
+            }
+      }
+
+    changed_vertices.clear();
+  }
+
+
+
+  template<int dim, int spacedim>
+  const std::vector<BoundingBox<spacedim> > &
+  Cache<dim,spacedim>::get_cell_bounding_boxes() const
+  {
+    if (update_flags & update_cell_bounding_boxes)
+      {
+        // for a MappingQGeneric of higher degree, the cells are described by
+        // the mapping support points, which give a box covering the curved
+        // cell up to the overshoot of the polynomials between the points,
+        // which we account for by a safety factor
+        const MappingQGeneric<dim,spacedim> *mapping_q
+          = dynamic_cast<const MappingQGeneric<dim,spacedim> *>(&*mapping);
+        const bool use_support_points = (mapping_q != nullptr &&
+                                         mapping_q->get_degree() > 1);
+        const double safety_factor = 0.1;
+
+        cell_bounding_boxes.resize(tria->n_active_cells());
+        for (const auto &cell : tria->active_cell_iterators())
+          {
+            std::vector<Point<spacedim> > points;
+            if (use_support_points)
+              points = mapping_q->compute_mapping_support_points(cell);
+            else
+              {
+                const std::array<Point<spacedim>, GeometryInfo<dim>::vertices_per_cell>
+                vertices = mapping->get_vertices(cell);
+                points.assign(vertices.begin(), vertices.end());
+              }
+            Point<spacedim> lower = points[0], upper = points[0];
+            for (unsigned int v=1; v<points.size(); ++v)
+              for (unsigned int d=0; d<spacedim; ++d)
+                {
+                  lower[d] = std::min(lower[d], points[v][d]);
+                  upper[d] = std::max(upper[d], points[v][d]);
+                }
+            if (use_support_points)
+              {
+                const Tensor<1,spacedim> extension = safety_factor * (upper - lower);
+                lower -= extension;
+                upper += extension;
+              }
+            cell_bounding_boxes[cell->active_cell_index()]
+              = BoundingBox<spacedim>(std::make_pair(lower, upper));
+          }
+        update_flags = update_flags & ~update_cell_bounding_boxes;
+      }
+    return cell_bounding_boxes;
+  }
+
+
+
+  template<int dim, int spacedim>
+  std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator>
+  Cache<dim,spacedim>::get_cell_candidates(const Point<spacedim> &p) const
+  {
+    const std::vector<BoundingBox<spacedim> > &boxes = get_cell_bounding_boxes();
+
+    if (update_flags & update_cell_bounding_box_index)
+      {
+        active_cells.resize(tria->n_active_cells());
+        for (const auto &cell : tria->active_cell_iterators())
+          active_cells[cell->active_cell_index()] = cell;
+
+        // divide the box covering all cells into about as many bins as there
+        // are cells, and store the cells with a box touching each bin
+        cell_covering_box = BoundingBox<spacedim>();
+        for (unsigned int i=0; i<boxes.size(); ++i)
+          if (i == 0)
+            cell_covering_box = boxes[i];
+          else
+            cell_covering_box.merge_with(boxes[i]);
+
+        const unsigned int n_bins_per_direction =
+          std::max(1U, static_cast<unsigned int>(std::ceil(std::pow(boxes.size(), 1./spacedim))));
+        std::fill(cell_n_bins.begin(), cell_n_bins.end(), n_bins_per_direction);
+        unsigned int n_total_bins = 1;
+        for (unsigned int d=0; d<spacedim; ++d)
+          n_total_bins *= cell_n_bins[d];
+        bin_cells.clear();
+        bin_cells.resize(n_total_bins);
+
+        for (unsigned int i=0; i<boxes.size(); ++i)
+          insert_into_bins<spacedim>(cell_covering_box, cell_n_bins, boxes[i], i, bin_cells);
+
+        update_flags = update_flags & ~update_cell_bounding_box_index;
+      }
+
+    std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> cells;
+    if (boxes.empty() || !cell_covering_box.point_inside(p))
+      return cells;
+
+    for (const unsigned int i : bin_cells[bin_index<spacedim>(cell_covering_box, cell_n_bins, p)])
+      if (boxes[i].point_inside(p))
+        cells.push_back(active_cells[i]);
+    return cells;
+  }
+
+
+
+  template<int dim, int spacedim>
+  const std::vector<std::set<unsigned int> > &
+  Cache<dim,spacedim>::get_vertex_to_neighbor_subdomain() const
+  {
+    if (update_flags & update_vertex_to_neighbor_subdomain)
+      {
+        vertex_to_neighbor_subdomain.clear();
+        vertex_to_neighbor_subdomain.resize(tria->n_vertices());
+        for (const auto &cell : tria->active_cell_iterators())
+          if (cell->is_ghost())
+            for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+              vertex_to_neighbor_subdomain[cell->vertex_index(v)].insert(cell->subdomain_id());
+        update_flags = update_flags & ~update_vertex_to_neighbor_subdomain;
+      }
+    return vertex_to_neighbor_subdomain;
+  }
+
+
+
   template<int dim, int spacedim>
   const std::vector<std::vector<Tensor<1,spacedim>>> &
   Cache<dim,spacedim>::get_vertex_to_cell_centers_directions() const
@@ -97,6 +449,114 @@ namespace GridTools
 
 
 
+  template<int dim, int spacedim>
+  const std::map<unsigned int, Point<spacedim> > &
+  Cache<dim,spacedim>::get_locally_relevant_vertices() const
+  {
+    if (update_flags & update_locally_relevant_vertices)
+      {
+        locally_relevant_vertices.clear();
+        for (const auto &cell : tria->active_cell_iterators())
+          if (!cell->is_artificial())
+            {
+              const auto vs = mapping->get_vertices(cell);
+              for (unsigned int i=0; i<vs.size(); ++i)
+                locally_relevant_vertices[cell->vertex_index(i)] = vs[i];
+            }
+        update_flags = update_flags & ~update_locally_relevant_vertices;
+      }
+    return locally_relevant_vertices;
+  }
+
+
+
+  template<int dim, int spacedim>
+  const std::vector<std::vector<BoundingBox<spacedim> > > &
+  Cache<dim,spacedim>::get_global_bounding_boxes() const
+  {
+    if (update_flags & update_global_bounding_boxes)
+      {
+        // use the finest level with a limited number of cells, which gives a
+        // reasonable description of the locally owned part of the mesh at a
+        // cost of the merging of the boxes that stays small
+        const unsigned int max_n_cells = 256;
+        std::vector<BoundingBox<spacedim> > local_boxes;
+        if (tria->n_levels() > 0)
+          {
+            unsigned int level = 0;
+            while (level+1 < tria->n_levels() && tria->n_cells(level+1) <= max_n_cells)
+              ++level;
+            local_boxes = GridTools::compute_mesh_predicate_bounding_box
+                          (*tria, IteratorFilters::LocallyOwnedCell(), level,
+                           tria->n_cells(level) <= max_n_cells);
+          }
+
+#ifdef DEAL_II_WITH_MPI
+        if (const parallel::Triangulation<dim,spacedim> *parallel_tria
+            = dynamic_cast<const parallel::Triangulation<dim,spacedim> *>(&*tria))
+          global_bounding_boxes = GridTools::exchange_local_bounding_boxes
+                                  (local_boxes, parallel_tria->get_communicator());
+        else
+#endif
+          global_bounding_boxes.assign(1, local_boxes);
+
+        // divide the box covering all boxes into about as many bins as there
+        // are boxes, and store the processes with a box touching each bin
+        unsigned int n_boxes = 0;
+        covering_box = BoundingBox<spacedim>();
+        for (const auto &boxes : global_bounding_boxes)
+          for (const auto &box : boxes)
+            {
+              if (n_boxes == 0)
+                covering_box = box;
+              else
+                covering_box.merge_with(box);
+              ++n_boxes;
+            }
+
+        const unsigned int n_bins_per_direction =
+          std::max(1U, static_cast<unsigned int>(std::ceil(std::pow(n_boxes, 1./spacedim))));
+        std::fill(n_bins.begin(), n_bins.end(), n_bins_per_direction);
+        unsigned int n_total_bins = 1;
+        for (unsigned int d=0; d<spacedim; ++d)
+          n_total_bins *= n_bins[d];
+        bin_ranks.clear();
+        bin_ranks.resize(n_total_bins);
+
+        for (unsigned int rank=0; rank<global_bounding_boxes.size(); ++rank)
+          for (const auto &box : global_bounding_boxes[rank])
+            insert_into_bins<spacedim>(covering_box, n_bins, box, rank, bin_ranks);
+
+        update_flags = update_flags & ~update_global_bounding_boxes;
+      }
+    return global_bounding_boxes;
+  }
+
+
+
+  template<int dim, int spacedim>
+  std::vector<unsigned int>
+  Cache<dim,spacedim>::get_point_owner_candidates(const Point<spacedim> &p) const
+  {
+    const std::vector<std::vector<BoundingBox<spacedim> > > &boxes
+      = get_global_bounding_boxes();
+
+    std::vector<unsigned int> ranks;
+    if (!covering_box.point_inside(p))
+      return ranks;
+
+    for (const unsigned int rank : bin_ranks[bin_index<spacedim>(covering_box, n_bins, p)])
+      for (const auto &box : boxes[rank])
+        if (box.point_inside(p))
+          {
+            ranks.push_back(rank);
+            break;
+          }
+    return ranks;
+  }
+
+
+
 #ifdef DEAL_II_WITH_NANOFLANN
   template<int dim, int spacedim>
   const KDTree<spacedim> &Cache<dim,spacedim>::get_vertex_kdtree() const
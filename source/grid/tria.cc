@@ -18,6 +18,8 @@
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/table.h>
 #include <deal.II/base/geometry_info.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/thread_management.h>
 
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_levels.h>
@@ -1046,6 +1048,53 @@ namespace
   }
 
 
+
+  // call the function object f(level) for all levels from 0 to n_levels-1
+  // on separate tasks. this is used for loops over cells in which the
+  // work on the cells of one level only writes to the data of that level
+  // and of the children on the next finer level, since each level stores
+  // its flags in separate arrays
+  template <typename Function>
+  void
+  apply_to_levels (const unsigned int  n_levels,
+                   const Function     &f)
+  {
+    Threads::TaskGroup<> tasks;
+    for (unsigned int level=0; level<n_levels; ++level)
+      tasks += Threads::new_task ([&f,level]()
+    {
+      f (level);
+    });
+    tasks.join_all ();
+  }
+
+
+
+  // compute the new vertex new_point(object) for each of the given objects
+  // in parallel and return them in the same order. this is used to move the
+  // queries of the manifolds out of the sequential refinement loops: the
+  // new point of a line or cell only depends on vertices that exist before
+  // the loop starts, and evaluating curved manifolds, e.g. with the
+  // pull-backs of a TransfiniteInterpolationManifold, is the expensive part
+  // of the refinement
+  template <int spacedim, typename Iterator, typename Function>
+  std::vector<Point<spacedim> >
+  compute_new_points (const std::vector<Iterator> &objects,
+                      const Function              &new_point)
+  {
+    std::vector<Point<spacedim> > points (objects.size());
+    parallel::apply_to_subranges
+    (0U, static_cast<unsigned int>(objects.size()),
+     [&](const unsigned int begin, const unsigned int end)
+    {
+      for (unsigned int i=begin; i<end; ++i)
+        points[i] = new_point (objects[i]);
+    },
+    16);
+    return points;
+  }
+
+
 }// end of anonymous namespace
 
 
@@ -4763,7 +4812,42 @@ namespace internal
             typename Triangulation<dim,spacedim>::raw_line_iterator
             next_unused_line = triangulation.begin_raw_line ();
 
+            // compute the midpoints of all lines to be refined up front,
+            // in parallel
+            std::vector<typename Triangulation<dim,spacedim>::active_line_iterator>
+            lines_to_refine;
             for (; line!=endl; ++line)
+              if (line->user_flag_set())
+                lines_to_refine.push_back (line);
+
+            const std::vector<Point<spacedim> > line_midpoints
+              = compute_new_points<spacedim>
+                (lines_to_refine,
+                 [&triangulation](const typename Triangulation<dim,spacedim>::active_line_iterator &line)
+            {
+              if (spacedim == dim)
+                {
+                  // for the case of a domain in an
+                  // equal-dimensional space we only have to treat
+                  // boundary lines differently; for interior
+                  // lines we can compute the midpoint as the mean
+                  // of the two vertices: if (line->at_boundary())
+                  return line->center(true);
+                }
+              else
+                // however, if spacedim>dim, we always have to ask
+                // the boundary object for its answer. We use the
+                // same object of the cell (which was stored in
+                // line->user_index() before) unless a manifold_id
+                // has been set on this very line.
+                if (line->manifold_id() == numbers::invalid_manifold_id)
+                  return triangulation.get_manifold(line->user_index()).get_new_point_on_line (line);
+                else
+                  return line->center(true);
+            });
+
+            unsigned int n_refined_lines = 0;
+            for (line = triangulation.begin_active_line(); line!=endl; ++line)
               if (line->user_flag_set())
                 {
                   // this line needs to be refined
@@ -4776,28 +4860,8 @@ namespace internal
                           ExcMessage("Internal error: During refinement, the triangulation wants to access an element of the 'vertices' array but it turns out that the array is not large enough."));
                   triangulation.vertices_used[next_unused_vertex] = true;
 
-                  if (spacedim == dim)
-                    {
-                      // for the case of a domain in an
-                      // equal-dimensional space we only have to treat
-                      // boundary lines differently; for interior
-                      // lines we can compute the midpoint as the mean
-                      // of the two vertices: if (line->at_boundary())
-                      triangulation.vertices[next_unused_vertex]
-                        = line->center(true);
-                    }
-                  else
-                    // however, if spacedim>dim, we always have to ask
-                    // the boundary object for its answer. We use the
-                    // same object of the cell (which was stored in
-                    // line->user_index() before) unless a manifold_id
-                    // has been set on this very line.
-                    if (line->manifold_id() == numbers::invalid_manifold_id)
-                      triangulation.vertices[next_unused_vertex]
-                        = triangulation.get_manifold(line->user_index()).get_new_point_on_line (line);
-                    else
-                      triangulation.vertices[next_unused_vertex]
-                        = line->center(true);
+                  triangulation.vertices[next_unused_vertex]
+                    = line_midpoints[n_refined_lines++];
 
                   // now that we created the right point, make up the
                   // two child lines.  To this end, find a pair of
@@ -4858,6 +4922,8 @@ namespace internal
                   // refinement
                   line->clear_user_flag ();
                 }
+            Assert (n_refined_lines == lines_to_refine.size(),
+                    ExcInternalError());
           }
 
 
@@ -5232,7 +5298,24 @@ namespace internal
             typename Triangulation<dim,spacedim>::raw_line_iterator
             next_unused_line = triangulation.begin_raw_line ();
 
+            // compute the midpoints of all lines to be refined up front,
+            // in parallel
+            std::vector<typename Triangulation<dim,spacedim>::active_line_iterator>
+            lines_to_refine;
             for (; line!=endl; ++line)
+              if (line->user_flag_set())
+                lines_to_refine.push_back (line);
+
+            const std::vector<Point<spacedim> > line_midpoints
+              = compute_new_points<spacedim>
+                (lines_to_refine,
+                 [](const typename Triangulation<dim,spacedim>::active_line_iterator &line)
+            {
+              return line->center(true);
+            });
+
+            unsigned int n_refined_lines = 0;
+            for (line = triangulation.begin_active_line(); line!=endl; ++line)
               if (line->user_flag_set())
                 {
                   // this line needs to be refined
@@ -5246,7 +5329,7 @@ namespace internal
                   triangulation.vertices_used[next_unused_vertex] = true;
 
                   triangulation.vertices[next_unused_vertex]
-                    = line->center(true);
+                    = line_midpoints[n_refined_lines++];
 
                   // now that we created the right point, make up the
                   // two child lines (++ takes care of the end of the
@@ -5298,6 +5381,8 @@ namespace internal
                   // for refinement
                   line->clear_user_flag ();
                 }
+            Assert (n_refined_lines == lines_to_refine.size(),
+                    ExcInternalError());
           }
 
 
@@ -6069,6 +6154,28 @@ namespace internal
         typename Triangulation<3,spacedim>::DistortedCellList
         cells_with_distorted_children;
 
+        // compute the centers of all isotropically refined hexes up front,
+        // in parallel. they depend on the vertices, the midpoints of the
+        // lines and the centers of the faces of the hexes, which have all
+        // been set above
+        std::vector<typename Triangulation<dim,spacedim>::active_hex_iterator>
+        hexes_to_refine;
+        for (unsigned int level=0; level!=triangulation.levels.size()-1; ++level)
+          for (typename Triangulation<dim,spacedim>::active_hex_iterator
+               hex = triangulation.begin_active_hex(level);
+               hex != triangulation.begin_active_hex(level+1); ++hex)
+            if (hex->refine_flag_set() == RefinementCase<dim>::cut_xyz)
+              hexes_to_refine.push_back (hex);
+
+        const std::vector<Point<spacedim> > hex_centers
+          = compute_new_points<spacedim>
+            (hexes_to_refine,
+             [](const typename Triangulation<dim,spacedim>::active_hex_iterator &hex)
+        {
+          return hex->center(true, true);
+        });
+        unsigned int n_refined_hexes = 0;
+
         for (unsigned int level=0; level!=triangulation.levels.size()-1; ++level)
           {
             // only active objects can be refined further; remember
@@ -7924,11 +8031,13 @@ namespace internal
                       // the new vertex is definitely in the interior,
                       // so we need not worry about the
                       // boundary. However we need to worry about
-                      // Manifolds. Let the cell compute its own
+                      // Manifolds. The cell has computed its own
                       // center, by querying the underlying manifold
-                      // object.
+                      // object, before the loop.
+                      Assert (hexes_to_refine[n_refined_hexes] == hex,
+                              ExcInternalError());
                       triangulation.vertices[next_unused_vertex] =
-                        hex->center(true, true);
+                        hex_centers[n_refined_hexes++];
 
                       // set the data of the six lines.  first collect
                       // the indices of the seven vertices (consider
@@ -8483,6 +8592,8 @@ namespace internal
                   triangulation.signals.post_refinement_on_cell(hex);
                 }
           }
+        Assert (n_refined_hexes == hexes_to_refine.size(),
+                ExcInternalError());
 
         // clear user data on quads. we used some of this data to
         // indicate anisotropic refinemnt cases on faces. all data
@@ -8910,6 +9021,7 @@ Triangulation (Triangulation<dim, spacedim> &&tria)
   anisotropic_refinement(tria.anisotropic_refinement),
   check_for_distorted_cells(tria.check_for_distorted_cells),
   number_cache(tria.number_cache),
+  active_cell_levels_and_indices(std::move(tria.active_cell_levels_and_indices)),
   vertex_to_boundary_id_map_1d(std::move(tria.vertex_to_boundary_id_map_1d)),
   vertex_to_manifold_id_map_1d(std::move(tria.vertex_to_manifold_id_map_1d))
 {
@@ -8933,6 +9045,7 @@ Triangulation<dim, spacedim>::operator= (Triangulation<dim, spacedim> &&tria)
   manifold = std::move(tria.manifold);
   anisotropic_refinement = tria.anisotropic_refinement;
   number_cache = tria.number_cache;
+  active_cell_levels_and_indices = std::move(tria.active_cell_levels_and_indices);
   vertex_to_boundary_id_map_1d = std::move(tria.vertex_to_boundary_id_map_1d);
   vertex_to_manifold_id_map_1d = std::move(tria.vertex_to_manifold_id_map_1d);
 
@@ -9241,6 +9354,7 @@ copy_triangulation (const Triangulation<dim, spacedim> &other_tria)
     levels.push_back (std_cxx14::make_unique<internal::Triangulation::TriaLevel<dim>>(*other_tria.levels[level]));
 
   number_cache = other_tria.number_cache;
+  active_cell_levels_and_indices = other_tria.active_cell_levels_and_indices;
 
   if (dim == 1)
     {
@@ -10621,6 +10735,18 @@ Triangulation<dim,spacedim>::last_active () const
 
 
 
+template <int dim, int spacedim>
+typename Triangulation<dim,spacedim>::active_cell_iterator
+Triangulation<dim,spacedim>::active_cell_with_index (const unsigned int active_cell_index) const
+{
+  AssertIndexRange (active_cell_index, active_cell_levels_and_indices.size());
+  return active_cell_iterator (const_cast<Triangulation<dim, spacedim>*>(this),
+                               active_cell_levels_and_indices[active_cell_index].first,
+                               active_cell_levels_and_indices[active_cell_index].second);
+}
+
+
+
 template <int dim, int spacedim>
 typename Triangulation<dim,spacedim>::cell_iterator
 Triangulation<dim,spacedim>::end () const
@@ -11832,17 +11958,48 @@ template <int dim, int spacedim>
 void
 Triangulation<dim,spacedim>::reset_active_cell_indices ()
 {
-  unsigned int active_cell_index = 0;
-  for (raw_cell_iterator cell=begin_raw(); cell!=end(); ++cell)
-    if ((cell->used() == false) || cell->has_children())
-      cell->set_active_cell_index (numbers::invalid_unsigned_int);
-    else
+  // the active cells are numbered level by level. count them on each
+  // level first, so that all levels can then be numbered at the same time
+  // starting from the number of active cells on the coarser levels
+  std::vector<unsigned int> first_active_cell_index (levels.size()+1, 0);
+  apply_to_levels (levels.size(),
+                   [&](const unsigned int level)
+  {
+    unsigned int n_active_cells_on_level = 0;
+    for (unsigned int index=0; index<levels[level]->cells.cells.size(); ++index)
       {
-        cell->set_active_cell_index (active_cell_index);
-        ++active_cell_index;
+        const raw_cell_iterator cell (this, level, index);
+        if (cell->used() && !cell->has_children())
+          ++n_active_cells_on_level;
+      }
+    first_active_cell_index[level+1] = n_active_cells_on_level;
+  });
+  std::partial_sum (first_active_cell_index.begin(),
+                    first_active_cell_index.end(),
+                    first_active_cell_index.begin());
+
+  active_cell_levels_and_indices.resize (first_active_cell_index.back());
+
+  apply_to_levels (levels.size(),
+                   [&](const unsigned int level)
+  {
+    unsigned int active_cell_index = first_active_cell_index[level];
+    for (unsigned int index=0; index<levels[level]->cells.cells.size(); ++index)
+      {
+        raw_cell_iterator cell (this, level, index);
+        if ((cell->used() == false) || cell->has_children())
+          cell->set_active_cell_index (numbers::invalid_unsigned_int);
+        else
+          {
+            cell->set_active_cell_index (active_cell_index);
+            active_cell_levels_and_indices[active_cell_index]
+              = std::make_pair (level, index);
+            ++active_cell_index;
+          }
       }
+  });
 
-  Assert (active_cell_index == n_active_cells(), ExcInternalError());
+  Assert (first_active_cell_index.back() == n_active_cells(), ExcInternalError());
 }
 
 
@@ -11908,6 +12065,7 @@ Triangulation<dim, spacedim>::clear_despite_subscriptions()
   manifold.clear();
 
   number_cache = internal::Triangulation::NumberCache<dim>();
+  active_cell_levels_and_indices.clear ();
 }
 
 
@@ -11966,22 +12124,30 @@ void Triangulation<dim, spacedim>::execute_coarsening ()
   // @p{fix_coarsen_flags}, of a cell either all or no children must
   // be flagged for coarsening, so it is ok to only check the first
   // child
+  //
+  // the cells of one level only touch their own user flags and the coarsen
+  // flags of their children, so the levels can be worked on in parallel
   clear_user_flags ();
 
+  apply_to_levels (levels.size(),
+                   [this](const unsigned int level)
+  {
+    for (cell_iterator cell=begin(level); cell!=end(level); ++cell)
+      if (!cell->active())
+        if (cell->child(0)->coarsen_flag_set())
+          {
+            cell->set_user_flag();
+            for (unsigned int child=0; child<cell->n_children(); ++child)
+              {
+                Assert (cell->child(child)->coarsen_flag_set(),
+                        ExcInternalError());
+                cell->child(child)->clear_coarsen_flag();
+              }
+          }
+  });
+
   cell_iterator cell = begin(),
                 endc = end();
-  for (; cell!=endc; ++cell)
-    if (!cell->active())
-      if (cell->child(0)->coarsen_flag_set())
-        {
-          cell->set_user_flag();
-          for (unsigned int child=0; child<cell->n_children(); ++child)
-            {
-              Assert (cell->child(child)->coarsen_flag_set(),
-                      ExcInternalError());
-              cell->child(child)->clear_coarsen_flag();
-            }
-        }
 
 
   // now do the actual coarsening step. Since the loop goes over used
@@ -12149,30 +12315,38 @@ void Triangulation<dim, spacedim>::fix_coarsen_flags ()
       for (; acell!=end_ac; ++acell)
         acell->clear_coarsen_flag();
 
+      //
+      // as in execute_coarsening(), the levels can be worked on in
+      // parallel
+      apply_to_levels (levels.size(),
+                       [this](const unsigned int level)
+      {
+        for (cell_iterator cell=begin(level); cell!=end(level); ++cell)
+          {
+            // nothing to do if we are already on the finest level
+            if (cell->active())
+              continue;
+
+            const unsigned int n_children=cell->n_children();
+            unsigned int flagged_children=0;
+            for (unsigned int child=0; child<n_children; ++child)
+              if (cell->child(child)->active() &&
+                  cell->child(child)->coarsen_flag_set())
+                {
+                  ++flagged_children;
+                  // clear flag since we don't need it anymore
+                  cell->child(child)->clear_coarsen_flag();
+                }
+
+            // flag this cell for coarsening if all children were
+            // flagged
+            if (flagged_children == n_children)
+              cell->set_user_flag();
+          }
+      });
+
       cell_iterator cell = begin(),
                     endc = end();
-      for (; cell!=endc; ++cell)
-        {
-          // nothing to do if we are already on the finest level
-          if (cell->active())
-            continue;
-
-          const unsigned int n_children=cell->n_children();
-          unsigned int flagged_children=0;
-          for (unsigned int child=0; child<n_children; ++child)
-            if (cell->child(child)->active() &&
-                cell->child(child)->coarsen_flag_set())
-              {
-                ++flagged_children;
-                // clear flag since we don't need it anymore
-                cell->child(child)->clear_coarsen_flag();
-              }
-
-          // flag this cell for coarsening if all children were
-          // flagged
-          if (flagged_children == n_children)
-            cell->set_user_flag();
-        }
 
       // in principle no coarsen flags should be set any more at this
       // point
@@ -13447,6 +13621,7 @@ Triangulation<dim, spacedim>::memory_consumption () const
   mem += sizeof(manifold);
   mem += sizeof(smooth_grid);
   mem += MemoryConsumption::memory_consumption (number_cache);
+  mem += MemoryConsumption::memory_consumption (active_cell_levels_and_indices);
   mem += sizeof (faces);
   if (faces)
     mem += MemoryConsumption::memory_consumption (*faces);
@@ -1073,6 +1073,16 @@ namespace hp
 
 
 
+  template <int dim, int spacedim>
+  typename DoFHandler<dim, spacedim>::active_cell_iterator
+  DoFHandler<dim, spacedim>::active_cell_with_index (const unsigned int active_cell_index) const
+  {
+    return active_cell_iterator (*this->get_triangulation().active_cell_with_index (active_cell_index),
+                                 this);
+  }
+
+
+
   template <int dim, int spacedim>
   IteratorRange<typename DoFHandler<dim, spacedim>::cell_iterator>
   DoFHandler<dim, spacedim>::cell_iterators () const
@@ -81,11 +81,16 @@ namespace internal
               ExcIndexRange (q_index, 0, q_collection.size()));
 
 
+      // if the same triple of indices as on the previous cell is
+      // requested, as is the case for most cells when looping over cells
+      // sorted by their active_fe_index, we can return the object right away
+      const TableIndices<3> fe_values_index (fe_index, mapping_index, q_index);
+      if (fe_values_index == present_fe_values_index)
+        return *fe_values_table(present_fe_values_index);
+
       // set the triple of indices
       // that we want to work with
-      present_fe_values_index = TableIndices<3> (fe_index,
-                                                 mapping_index,
-                                                 q_index);
+      present_fe_values_index = fe_values_index;
 
       // first check whether we
       // already have an object for
@@ -59,6 +59,58 @@ ConstraintMatrix::copy_from (const ConstraintMatrix &other)
   lines_cache = other.lines_cache;
   local_lines = other.local_lines;
   sorted      = other.sorted;
+  compressed_lines = other.compressed_lines;
+}
+
+
+
+void
+ConstraintMatrix::CompressedLines::initialize (const std::vector<ConstraintLine> &lines)
+{
+  line_indices.resize (lines.size());
+  inhomogeneities.resize (lines.size());
+  row_starts.resize (lines.size()+1);
+
+  row_starts[0] = 0;
+  for (size_type i=0; i<lines.size(); ++i)
+    {
+      line_indices[i] = lines[i].index;
+      inhomogeneities[i] = lines[i].inhomogeneity;
+      row_starts[i+1] = row_starts[i] + lines[i].entries.size();
+    }
+
+  column_indices.resize (row_starts.back());
+  values.resize (row_starts.back());
+  for (size_type i=0; i<lines.size(); ++i)
+    for (size_type j=0; j<lines[i].entries.size(); ++j)
+      {
+        column_indices[row_starts[i]+j] = lines[i].entries[j].first;
+        values[row_starts[i]+j] = lines[i].entries[j].second;
+      }
+}
+
+
+
+void
+ConstraintMatrix::CompressedLines::clear ()
+{
+  std::vector<size_type>().swap (line_indices);
+  std::vector<double>().swap (inhomogeneities);
+  std::vector<size_type>().swap (row_starts);
+  std::vector<size_type>().swap (column_indices);
+  std::vector<double>().swap (values);
+}
+
+
+
+std::size_t
+ConstraintMatrix::CompressedLines::memory_consumption () const
+{
+  return (MemoryConsumption::memory_consumption (line_indices) +
+          MemoryConsumption::memory_consumption (inhomogeneities) +
+          MemoryConsumption::memory_consumption (row_starts) +
+          MemoryConsumption::memory_consumption (column_indices) +
+          MemoryConsumption::memory_consumption (values));
 }
 
 
@@ -482,6 +534,8 @@ void ConstraintMatrix::close ()
         }
 #endif
 
+  compressed_lines.initialize (lines);
+
   sorted = true;
 }
 
@@ -653,6 +707,9 @@ void ConstraintMatrix::shift (const size_type offset)
         j->first += offset;
     }
 
+  if (sorted)
+    compressed_lines.initialize (lines);
+
 #ifdef DEBUG
   // make sure that lines, lines_cache and local_lines
   // are still linked correctly
@@ -677,6 +734,8 @@ void ConstraintMatrix::clear ()
     lines_cache.swap (tmp);
   }
 
+  compressed_lines.clear ();
+
   sorted = false;
 }
 
@@ -1232,7 +1291,8 @@ ConstraintMatrix::memory_consumption () const
   return (MemoryConsumption::memory_consumption (lines) +
           MemoryConsumption::memory_consumption (lines_cache) +
           MemoryConsumption::memory_consumption (sorted) +
-          MemoryConsumption::memory_consumption (local_lines));
+          MemoryConsumption::memory_consumption (local_lines) +
+          compressed_lines.memory_consumption ());
 }
 
 
@@ -1418,6 +1478,7 @@ BLOCK_MATRIX_VECTOR_FUNCTIONS(TrilinosWrappers::BlockSparseMatrix, TrilinosWrapp
 
 SPARSITY_FUNCTIONS(SparsityPattern);
 SPARSITY_FUNCTIONS(DynamicSparsityPattern);
+SPARSITY_FUNCTIONS(DynamicSparsityPattern::ThreadSafeInserter);
 BLOCK_SPARSITY_FUNCTIONS(BlockSparsityPattern);
 BLOCK_SPARSITY_FUNCTIONS(BlockDynamicSparsityPattern);
 
@@ -0,0 +1,837 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/lac/cuda_distributed_vector.h>
+#include <deal.II/lac/cuda_atomic.cuh>
+#include <deal.II/lac/read_write_vector.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
+#include <algorithm>
+#include <cmath>
+
+#ifdef DEAL_II_WITH_CUDA
+
+DEAL_II_NAMESPACE_OPEN
+
+#define BLOCK_SIZE 512
+
+namespace LinearAlgebra
+{
+  namespace CUDAWrappers
+  {
+    namespace internal
+    {
+      // the tag of the messages for the exchange of ghost values
+      const int ghost_exchange_tag = 4011;
+
+
+
+      template <typename Number>
+      __global__ void gather(Number             *buffer,
+                             const Number       *val,
+                             const unsigned int *indices,
+                             const unsigned int  N)
+      {
+        const unsigned int idx = threadIdx.x + blockIdx.x*blockDim.x;
+        if (idx<N)
+          buffer[idx] = val[indices[idx]];
+      }
+
+
+
+      template <typename Number>
+      __global__ void scatter_add(Number             *val,
+                                  const Number       *buffer,
+                                  const unsigned int *indices,
+                                  const unsigned int  N)
+      {
+        // the same element may be a ghost on several processes
+        const unsigned int idx = threadIdx.x + blockIdx.x*blockDim.x;
+        if (idx<N)
+          atomicAdd_wrapper(&val[indices[idx]], buffer[idx]);
+      }
+    }
+
+
+
+    template <typename Number>
+    DistributedVector<Number>::DistributedVector()
+      :
+      import_indices(nullptr),
+      import_data(nullptr),
+      vector_is_ghosted(false),
+      host_staging_buffer(nullptr)
+    {}
+
+
+
+    template <typename Number>
+    DistributedVector<Number>::DistributedVector(const DistributedVector<Number> &V)
+      :
+      import_indices(nullptr),
+      import_data(nullptr),
+      vector_is_ghosted(false),
+      host_staging_buffer(nullptr)
+    {
+      if (V.partitioner)
+        {
+          reinit(V.partitioner, true);
+          *this = V;
+        }
+    }
+
+
+
+    template <typename Number>
+    DistributedVector<Number>::DistributedVector
+    (const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner)
+      :
+      import_indices(nullptr),
+      import_data(nullptr),
+      vector_is_ghosted(false),
+      host_staging_buffer(nullptr)
+    {
+      reinit(partitioner);
+    }
+
+
+
+    template <typename Number>
+    DistributedVector<Number>::~DistributedVector()
+    {
+      if (import_indices != nullptr)
+        {
+          cudaError_t error_code = cudaFree(import_indices);
+          AssertCuda(error_code);
+          import_indices = nullptr;
+        }
+      if (import_data != nullptr)
+        {
+          cudaError_t error_code = cudaFree(import_data);
+          AssertCuda(error_code);
+          import_data = nullptr;
+        }
+      free_host_staging_buffer();
+    }
+
+
+
+    template <typename Number>
+    void DistributedVector<Number>::reinit
+    (const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner,
+     const bool omit_zeroing_entries)
+    {
+      values.reinit(partitioner->local_size() + partitioner->n_ghost_indices(),
+                    omit_zeroing_entries);
+
+      if (this->partitioner.get() != partitioner.get())
+        {
+          free_host_staging_buffer();
+          set_up_import_indices(partitioner);
+        }
+
+      // the ghost elements need to be zero, see the documentation of the
+      // member variable
+      if (omit_zeroing_entries)
+        zero_out_ghosts();
+      vector_is_ghosted = false;
+    }
+
+
+
+    template <typename Number>
+    void DistributedVector<Number>::set_up_import_indices
+    (const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner)
+    {
+      this->partitioner = partitioner;
+
+      if (import_indices != nullptr)
+        {
+          cudaError_t error_code = cudaFree(import_indices);
+          AssertCuda(error_code);
+          import_indices = nullptr;
+        }
+      if (import_data != nullptr)
+        {
+          cudaError_t error_code = cudaFree(import_data);
+          AssertCuda(error_code);
+          import_data = nullptr;
+        }
+
+      // expand the ranges of the indices to send into a list on the device
+      const unsigned int n_import_indices = partitioner->n_import_indices();
+      if (n_import_indices > 0)
+        {
+          std::vector<unsigned int> import_indices_host;
+          import_indices_host.reserve(n_import_indices);
+          for (const auto &range : partitioner->import_indices())
+            for (unsigned int i=range.first; i<range.second; ++i)
+              import_indices_host.push_back(i);
+          AssertDimension(import_indices_host.size(), n_import_indices);
+
+          cudaError_t error_code = cudaMalloc(&import_indices,
+                                              n_import_indices*sizeof(unsigned int));
+          AssertCuda(error_code);
+          error_code = cudaMemcpy(import_indices, import_indices_host.data(),
+                                  n_import_indices*sizeof(unsigned int),
+                                  cudaMemcpyHostToDevice);
+          AssertCuda(error_code);
+
+          error_code = cudaMalloc(&import_data, n_import_indices*sizeof(Number));
+          AssertCuda(error_code);
+        }
+    }
+
+
+
+    template <typename Number>
+    void DistributedVector<Number>::reinit(const VectorSpaceVector<Number> &V,
+                                           const bool omit_zeroing_entries)
+    {
+      Assert(dynamic_cast<const DistributedVector<Number>*>(&V)!=nullptr,
+             ExcVectorTypeNotCompatible());
+      const DistributedVector<Number> &down_V =
+        dynamic_cast<const DistributedVector<Number>&>(V);
+
+      reinit(down_V.partitioner, omit_zeroing_entries);
+    }
+
+
+
+    template <typename Number>
+    Number *DistributedVector<Number>::get_host_staging_buffer() const
+    {
+      if (host_staging_buffer == nullptr && local_size() > 0)
+        {
+          cudaError_t error_code = cudaMallocHost(&host_staging_buffer,
+                                                  local_size()*sizeof(Number));
+          AssertCuda(error_code);
+        }
+      return host_staging_buffer;
+    }
+
+
+
+    template <typename Number>
+    void DistributedVector<Number>::free_host_staging_buffer() const
+    {
+      if (host_staging_buffer != nullptr)
+        {
+          cudaError_t error_code = cudaFreeHost(host_staging_buffer);
+          AssertCuda(error_code);
+          host_staging_buffer = nullptr;
+        }
+    }
+
+
+
+    template <typename Number>
+    void DistributedVector<Number>::copy_from_host(const LinearAlgebra::distributed::Vector<Number> &V)
+    {
+      Assert(V.locally_owned_elements() == locally_owned_elements(),
+             ExcMessage("The vector on the host needs to have the same "
+                        "locally owned elements as this vector."));
+
+      zero_out_ghosts();
+      const size_type n_local = local_size();
+      if (n_local == 0)
+        return;
+
+      Number *buffer = get_host_staging_buffer();
+      std::copy(V.begin(), V.begin()+n_local, buffer);
+      cudaError_t error_code = cudaMemcpy(values.get_values(), buffer,
+                                          n_local*sizeof(Number),
+                                          cudaMemcpyHostToDevice);
+      AssertCuda(error_code);
+    }
+
+
+
+    template <typename Number>
+    void DistributedVector<Number>::copy_to_host(LinearAlgebra::distributed::Vector<Number> &V) const
+    {
+      Assert(V.locally_owned_elements() == locally_owned_elements(),
+             ExcMessage("The vector on the host needs to have the same "
+                        "locally owned elements as this vector."));
+
+      V.zero_out_ghosts();
+      const size_type n_local = local_size();
+      if (n_local == 0)
+        return;
+
+      Number *buffer = get_host_staging_buffer();
+      cudaError_t error_code = cudaMemcpy(buffer, values.get_values(),
+                                          n_local*sizeof(Number),
+                                          cudaMemcpyDeviceToHost);
+      AssertCuda(error_code);
+      std::copy(buffer, buffer+n_local, V.begin());
+    }
+
+
+
+    template <typename Number>
+    void DistributedVector<Number>::import(const ReadWriteVector<Number> &V,
+                                           VectorOperation::values operation,
+                                           std::shared_ptr<const CommunicationPatternBase> )
+    {
+      Assert(V.get_stored_elements() == locally_owned_elements(),
+             ExcMessage("The ReadWriteVector needs to store exactly the locally "
+                        "owned elements of this vector."));
+
+      zero_out_ghosts();
+      const size_type n_local = local_size();
+      if (n_local == 0)
+        return;
+
+      if (operation == VectorOperation::insert)
+        {
+          cudaError_t error_code = cudaMemcpy(values.get_values(), V.begin(),
+                                              n_local*sizeof(Number),
+                                              cudaMemcpyHostToDevice);
+          AssertCuda(error_code);
+        }
+      else
+        {
+          Vector<Number> tmp(values.size());
+          cudaError_t error_code = cudaMemset(tmp.get_values(), 0,
+                                              values.size()*sizeof(Number));
+          AssertCuda(error_code);
+          error_code = cudaMemcpy(tmp.get_values(), V.begin(),
+                                  n_local*sizeof(Number),
+                                  cudaMemcpyHostToDevice);
+          AssertCuda(error_code);
+          values += tmp;
+        }
+    }
+
+
+
+    template <typename Number>
+    const DistributedVector<Number> &
+    DistributedVector<Number>::downcast_and_zero_ghosts (const VectorSpaceVector<Number> &V) const
+    {
+      // Check that casting will work
+      Assert(dynamic_cast<const DistributedVector<Number>*>(&V)!=nullptr,
+             ExcVectorTypeNotCompatible());
+
+      // Downcast V. If it fails, it throws an exception.
+      const DistributedVector<Number> &down_V =
+        dynamic_cast<const DistributedVector<Number>&>(V);
+      Assert(down_V.partitioner.get() == partitioner.get() ||
+             down_V.partitioner->is_compatible(*partitioner),
+             ExcMessage("The vectors need to have the same partitioner."));
+
+      down_V.zero_out_ghosts();
+      return down_V;
+    }
+
+
+
+    template <typename Number>
+    DistributedVector<Number> &
+    DistributedVector<Number>::operator= (const DistributedVector<Number> &V)
+    {
+      if (&V == this)
+        return *this;
+
+      if (partitioner.get() != V.partitioner.get())
+        reinit(V.partitioner, true);
+
+      const DistributedVector<Number> &down_V = downcast_and_zero_ghosts(V);
+      zero_out_ghosts();
+      if (values.size() > 0)
+        {
+          cudaError_t error_code = cudaMemcpy(values.get_values(),
+                                              down_V.values.get_values(),
+                                              values.size()*sizeof(Number),
+                                              cudaMemcpyDeviceToDevice);
+          AssertCuda(error_code);
+        }
+
+      return *this;
+    }
+
+
+
+    template <typename Number>
+    DistributedVector<Number> &DistributedVector<Number>::operator= (const Number s)
+    {
+      if (values.size() > 0)
+        values = s;
+      vector_is_ghosted = false;
+
+      return *this;
+    }
+
+
+
+    template <typename Number>
+    DistributedVector<Number> &DistributedVector<Number>::operator*= (const Number factor)
+    {
+      zero_out_ghosts();
+      if (values.size() > 0)
+        values *= factor;
+
+      return *this;
+    }
+
+
+
+    template <typename Number>
+    DistributedVector<Number> &DistributedVector<Number>::operator/= (const Number factor)
+    {
+      zero_out_ghosts();
+      if (values.size() > 0)
+        values /= factor;
+
+      return *this;
+    }
+
+
+
+    template <typename Number>
+    DistributedVector<Number> &
+    DistributedVector<Number>::operator+= (const VectorSpaceVector<Number> &V)
+    {
+      const DistributedVector<Number> &down_V = downcast_and_zero_ghosts(V);
+      zero_out_ghosts();
+      if (values.size() > 0)
+        values += down_V.values;
+
+      return *this;
+    }
+
+
+
+    template <typename Number>
+    DistributedVector<Number> &
+    DistributedVector<Number>::operator-= (const VectorSpaceVector<Number> &V)
+    {
+      const DistributedVector<Number> &down_V = downcast_and_zero_ghosts(V);
+      zero_out_ghosts();
+      if (values.size() > 0)
+        values -= down_V.values;
+
+      return *this;
+    }
+
+
+
+    template <typename Number>
+    Number DistributedVector<Number>::operator* (const VectorSpaceVector<Number> &V) const
+    {
+      const DistributedVector<Number> &down_V = downcast_and_zero_ghosts(V);
+      zero_out_ghosts();
+
+      const Number local_result = (values.size() > 0) ?
+                                  values * down_V.values :
+                                  Number();
+      return Utilities::MPI::sum(local_result, partitioner->get_mpi_communicator());
+    }
+
+
+
+    template <typename Number>
+    void DistributedVector<Number>::add(const Number a)
+    {
+      zero_out_ghosts();
+      if (values.size() > 0)
+        {
+          values.add(a);
+          // only the owned elements get the constant
+          zero_out_ghosts();
+        }
+    }
+
+
+
+    template <typename Number>
+    void DistributedVector<Number>::add(const Number a, const VectorSpaceVector<Number> &V)
+    {
+      const DistributedVector<Number> &down_V = downcast_and_zero_ghosts(V);
+      zero_out_ghosts();
+      if (values.size() > 0)
+        values.add(a, down_V.values);
+    }
+
+
+
+    template <typename Number>
+    void DistributedVector<Number>::add(const Number a, const VectorSpaceVector<Number> &V,
+                                        const Number b, const VectorSpaceVector<Number> &W)
+    {
+      const DistributedVector<Number> &down_V = downcast_and_zero_ghosts(V);
+      const DistributedVector<Number> &down_W = downcast_and_zero_ghosts(W);
+      zero_out_ghosts();
+      if (values.size() > 0)
+        values.add(a, down_V.values, b, down_W.values);
+    }
+
+
+
+    template <typename Number>
+    void DistributedVector<Number>::sadd(const Number s, const Number a,
+                                         const VectorSpaceVector<Number> &V)
+    {
+      const DistributedVector<Number> &down_V = downcast_and_zero_ghosts(V);
+      zero_out_ghosts();
+      if (values.size() > 0)
+        values.sadd(s, a, down_V.values);
+    }
+
+
+
+    template <typename Number>
+    void DistributedVector<Number>::scale(const VectorSpaceVector<Number> &scaling_factors)
+    {
+      const DistributedVector<Number> &down_scaling_factors =
+        downcast_and_zero_ghosts(scaling_factors);
+      zero_out_ghosts();
+      if (values.size() > 0)
+        values.scale(down_scaling_factors.values);
+    }
+
+
+
+    template <typename Number>
+    void DistributedVector<Number>::equ(const Number a, const VectorSpaceVector<Number> &V)
+    {
+      const DistributedVector<Number> &down_V = downcast_and_zero_ghosts(V);
+      zero_out_ghosts();
+      if (values.size() > 0)
+        values.equ(a, down_V.values);
+    }
+
+
+
+    template <typename Number>
+    bool DistributedVector<Number>::all_zero() const
+    {
+      return (linfty_norm() == 0) ? true : false;
+    }
+
+
+
+    template <typename Number>
+    typename DistributedVector<Number>::value_type
+    DistributedVector<Number>::mean_value() const
+    {
+      zero_out_ghosts();
+
+      // the mean value of the local array includes the ghost elements, which
+      // are zero
+      const Number local_sum = (values.size() > 0) ?
+                               values.mean_value() *
+                               static_cast<value_type>(values.size()) :
+                               Number();
+      return Utilities::MPI::sum(local_sum, partitioner->get_mpi_communicator()) /
+             static_cast<value_type>(size());
+    }
+
+
+
+    template <typename Number>
+    typename DistributedVector<Number>::real_type
+    DistributedVector<Number>::l1_norm() const
+    {
+      zero_out_ghosts();
+
+      const real_type local_result = (values.size() > 0) ?
+                                     values.l1_norm() :
+                                     real_type();
+      return Utilities::MPI::sum(local_result, partitioner->get_mpi_communicator());
+    }
+
+
+
+    template <typename Number>
+    typename DistributedVector<Number>::real_type
+    DistributedVector<Number>::l2_norm() const
+    {
+      return std::sqrt((*this)*(*this));
+    }
+
+
+
+    template <typename Number>
+    typename DistributedVector<Number>::real_type
+    DistributedVector<Number>::linfty_norm() const
+    {
+      zero_out_ghosts();
+
+      const real_type local_result = (values.size() > 0) ?
+                                     values.linfty_norm() :
+                                     real_type();
+      return Utilities::MPI::max(local_result, partitioner->get_mpi_communicator());
+    }
+
+
+
+    template <typename Number>
+    Number DistributedVector<Number>::add_and_dot(const Number                     a,
+                                                  const VectorSpaceVector<Number> &V,
+                                                  const VectorSpaceVector<Number> &W)
+    {
+      const DistributedVector<Number> &down_V = downcast_and_zero_ghosts(V);
+      const DistributedVector<Number> &down_W = downcast_and_zero_ghosts(W);
+      zero_out_ghosts();
+
+      const Number local_result = (values.size() > 0) ?
+                                  values.add_and_dot(a, down_V.values, down_W.values) :
+                                  Number();
+      return Utilities::MPI::sum(local_result, partitioner->get_mpi_communicator());
+    }
+
+
+
+    template <typename Number>
+    void DistributedVector<Number>::update_ghost_values() const
+    {
+      update_ghost_values_start();
+      update_ghost_values_finish();
+    }
+
+
+
+    template <typename Number>
+    void DistributedVector<Number>::update_ghost_values_start(const cudaStream_t stream) const
+    {
+#ifdef DEAL_II_WITH_MPI
+      Assert(update_ghost_values_requests.empty(),
+             ExcMessage("update_ghost_values_start() has been called again "
+                        "before update_ghost_values_finish()."));
+
+      const unsigned int n_import_indices = partitioner->n_import_indices();
+      const MPI_Comm &communicator = partitioner->get_mpi_communicator();
+
+      // pack the data to send on the device
+      if (n_import_indices > 0)
+        {
+          const unsigned int n_blocks = 1 + (n_import_indices-1)/BLOCK_SIZE;
+          internal::gather<Number> <<<n_blocks,BLOCK_SIZE,0,stream>>>(import_data,
+                                                                      values.get_values(),
+                                                                      import_indices,
+                                                                      n_import_indices);
+          // Check that the kernel was launched correctly
+          AssertCuda(cudaGetLastError());
+          // The data needs to be complete before MPI starts sending it
+          AssertCuda(cudaStreamSynchronize(stream));
+        }
+
+      // receive the ghost elements directly into their place in the array,
+      // since the ghosts of each process are contiguous
+      update_ghost_values_requests.reserve(partitioner->ghost_targets().size() +
+                                           partitioner->import_targets().size());
+      Number *ghost_entries = values.get_values() + partitioner->local_size();
+      for (const auto &target : partitioner->ghost_targets())
+        {
+          update_ghost_values_requests.emplace_back();
+          const int ierr = MPI_Irecv(ghost_entries, static_cast<int>(target.second*sizeof(Number)),
+                                     MPI_BYTE, target.first,
+                                     internal::ghost_exchange_tag, communicator,
+                                     &update_ghost_values_requests.back());
+          AssertThrowMPI(ierr);
+          ghost_entries += target.second;
+        }
+
+      Number *import_entries = import_data;
+      for (const auto &target : partitioner->import_targets())
+        {
+          update_ghost_values_requests.emplace_back();
+          const int ierr = MPI_Isend(import_entries, static_cast<int>(target.second*sizeof(Number)),
+                                     MPI_BYTE, target.first,
+                                     internal::ghost_exchange_tag, communicator,
+                                     &update_ghost_values_requests.back());
+          AssertThrowMPI(ierr);
+          import_entries += target.second;
+        }
+#else
+      (void)stream;
+#endif
+    }
+
+
+
+    template <typename Number>
+    void DistributedVector<Number>::update_ghost_values_finish() const
+    {
+#ifdef DEAL_II_WITH_MPI
+      if (update_ghost_values_requests.size() > 0)
+        {
+          const int ierr = MPI_Waitall(update_ghost_values_requests.size(),
+                                       update_ghost_values_requests.data(),
+                                       MPI_STATUSES_IGNORE);
+          AssertThrowMPI(ierr);
+          update_ghost_values_requests.clear();
+        }
+#endif
+
+      vector_is_ghosted = true;
+    }
+
+
+
+    template <typename Number>
+    void DistributedVector<Number>::compress(const VectorOperation::values operation)
+    {
+#ifdef DEAL_II_WITH_MPI
+      if (operation == VectorOperation::add)
+        {
+          const MPI_Comm &communicator = partitioner->get_mpi_communicator();
+
+          // receive the contributions of other processes into the packed
+          // buffer, and send the ghost elements to their owners
+          std::vector<MPI_Request> requests;
+          requests.reserve(partitioner->ghost_targets().size() +
+                           partitioner->import_targets().size());
+          Number *import_entries = import_data;
+          for (const auto &target : partitioner->import_targets())
+            {
+              requests.emplace_back();
+              const int ierr = MPI_Irecv(import_entries, static_cast<int>(target.second*sizeof(Number)),
+                                         MPI_BYTE, target.first,
+                                         internal::ghost_exchange_tag, communicator,
+                                         &requests.back());
+              AssertThrowMPI(ierr);
+              import_entries += target.second;
+            }
+
+          Number *ghost_entries = values.get_values() + partitioner->local_size();
+          for (const auto &target : partitioner->ghost_targets())
+            {
+              requests.emplace_back();
+              const int ierr = MPI_Isend(ghost_entries, static_cast<int>(target.second*sizeof(Number)),
+                                         MPI_BYTE, target.first,
+                                         internal::ghost_exchange_tag, communicator,
+                                         &requests.back());
+              AssertThrowMPI(ierr);
+              ghost_entries += target.second;
+            }
+
+          if (requests.size() > 0)
+            {
+              const int ierr = MPI_Waitall(requests.size(), requests.data(),
+                                           MPI_STATUSES_IGNORE);
+              AssertThrowMPI(ierr);
+            }
+
+          // add the contributions to the owned elements on the device
+          const unsigned int n_import_indices = partitioner->n_import_indices();
+          if (n_import_indices > 0)
+            {
+              const unsigned int n_blocks = 1 + (n_import_indices-1)/BLOCK_SIZE;
+              internal::scatter_add<Number> <<<n_blocks,BLOCK_SIZE>>>(values.get_values(),
+                                                                      import_data,
+                                                                      import_indices,
+                                                                      n_import_indices);
+              // Check that the kernel was launched correctly
+              AssertCuda(cudaGetLastError());
+              // Check that there was no problem during the execution of the kernel
+              AssertCuda(cudaDeviceSynchronize());
+            }
+        }
+      else
+        Assert(operation == VectorOperation::insert,
+               ExcNotImplemented());
+#else
+      (void)operation;
+#endif
+
+      zero_out_ghosts();
+    }
+
+
+
+    template <typename Number>
+    void DistributedVector<Number>::zero_out_ghosts() const
+    {
+      const unsigned int n_ghosts = partitioner ? partitioner->n_ghost_indices() : 0;
+      if (n_ghosts > 0)
+        {
+          cudaError_t error_code = cudaMemset(values.get_values() + partitioner->local_size(),
+                                              0, n_ghosts*sizeof(Number));
+          AssertCuda(error_code);
+        }
+      vector_is_ghosted = false;
+    }
+
+
+
+    template <typename Number>
+    void DistributedVector<Number>::print(std::ostream       &out,
+                                          const unsigned int  precision,
+                                          const bool          scientific,
+                                          const bool          ) const
+    {
+      AssertThrow(out, ExcIO());
+      std::ios::fmtflags old_flags = out.flags();
+      unsigned int old_precision = out.precision (precision);
+
+      out.precision (precision);
+      if (scientific)
+        out.setf (std::ios::scientific, std::ios::floatfield);
+      else
+        out.setf (std::ios::fixed, std::ios::floatfield);
+
+      out << "Locally owned IndexSet: ";
+      locally_owned_elements().print(out);
+      out << std::endl;
+
+      // Copy the locally owned elements to the host
+      const size_type n_local = local_size();
+      std::vector<Number> cpu_val(n_local);
+      if (n_local > 0)
+        {
+          cudaError_t error_code = cudaMemcpy(cpu_val.data(), values.get_values(),
+                                              n_local*sizeof(Number),
+                                              cudaMemcpyDeviceToHost);
+          AssertCuda(error_code);
+        }
+      for (unsigned int i=0; i<n_local; ++i)
+        out << cpu_val[i] << std::endl;
+      out << std::flush;
+
+      AssertThrow (out, ExcIO());
+      // reset output format
+      out.flags (old_flags);
+      out.precision(old_precision);
+    }
+
+
+
+    template <typename Number>
+    std::size_t DistributedVector<Number>::memory_consumption() const
+    {
+      std::size_t memory = sizeof(*this);
+      memory += values.memory_consumption();
+      if (partitioner)
+        memory += partitioner->n_import_indices() * (sizeof(unsigned int) + sizeof(Number));
+      if (host_staging_buffer != nullptr)
+        memory += local_size() * sizeof(Number);
+
+      return memory;
+    }
+
+
+
+    // Explicit Instanationation
+    template class DistributedVector<float>;
+    template class DistributedVector<double>;
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
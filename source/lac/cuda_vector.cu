@@ -247,6 +247,16 @@ namespace LinearAlgebra
         else
           result_buffer[local_idx] = Operation::null_value();
 
+        for (unsigned int i=1; i<CHUNK_SIZE; ++i)
+          {
+            const typename Vector<Number>::size_type idx = global_idx +
+                                                           i*BLOCK_SIZE;
+            if (idx<N)
+              result_buffer[local_idx] =
+                Operation::reduction_op(result_buffer[local_idx],
+                                        Operation::element_wise_op(v[idx]));
+          }
+
         __syncthreads();
 
         reduce<Number,Operation> (result, result_buffer, local_idx, global_idx, N);
@@ -456,7 +466,7 @@ namespace LinearAlgebra
         else
           res_buf[local_idx] = 0.;
 
-        for (unsigned int i=1; i<BLOCK_SIZE; ++i)
+        for (unsigned int i=1; i<CHUNK_SIZE; ++i)
           {
             const unsigned int idx = global_idx + i*BLOCK_SIZE;
             if (idx < N)
@@ -471,6 +481,116 @@ namespace LinearAlgebra
         reduce<Number, DotProduct<Number>> (res, res_buf, local_idx,
                                             global_idx, N);
       }
+
+
+
+      template <typename Number>
+      __global__ void cg_update_and_dots(Number       *res,
+                                         Number       *x,
+                                         Number       *g,
+                                         const Number *d,
+                                         const Number *h,
+                                         const Number *diagonal,
+                                         const Number  a,
+                                         const typename Vector<Number>::size_type N)
+      {
+        __shared__ Number norm_buf[BLOCK_SIZE];
+        __shared__ Number dot_buf[BLOCK_SIZE];
+
+        const unsigned int global_idx = threadIdx.x + blockIdx.x *
+                                        (blockDim.x*CHUNK_SIZE);
+        const unsigned int local_idx = threadIdx.x;
+        norm_buf[local_idx] = 0.;
+        dot_buf[local_idx] = 0.;
+        for (unsigned int i=0; i<CHUNK_SIZE; ++i)
+          {
+            const unsigned int idx = global_idx + i*BLOCK_SIZE;
+            if (idx < N)
+              {
+                x[idx] += a*d[idx];
+                const Number g_idx = g[idx] + a*h[idx];
+                g[idx] = g_idx;
+                norm_buf[local_idx] += g_idx*g_idx;
+                if (diagonal != nullptr)
+                  dot_buf[local_idx] += g_idx*diagonal[idx]*g_idx;
+              }
+          }
+
+        __syncthreads();
+
+        reduce<Number, DotProduct<Number>> (res, norm_buf, local_idx,
+                                            global_idx, N);
+        if (diagonal != nullptr)
+          reduce<Number, DotProduct<Number>> (res+1, dot_buf, local_idx,
+                                              global_idx, N);
+      }
+
+
+
+      template <typename Number>
+      __global__ void cg_search_direction(Number       *d,
+                                          const Number *g,
+                                          const Number *diagonal,
+                                          const Number  beta,
+                                          const typename Vector<Number>::size_type N)
+      {
+        const typename Vector<Number>::size_type idx_base = threadIdx.x +
+                                                            blockIdx.x*(blockDim.x*CHUNK_SIZE);
+        for (unsigned int i=0; i<CHUNK_SIZE; ++i)
+          {
+            const typename Vector<Number>::size_type idx = idx_base +
+                                                           i*BLOCK_SIZE;
+            if (idx < N)
+              d[idx] = beta*d[idx] - (diagonal != nullptr ? diagonal[idx]*g[idx] : g[idx]);
+          }
+      }
+
+
+
+      // the same operations as internal::PreconditionChebyshev::VectorUpdater
+      template <typename Number>
+      __global__ void chebyshev_updates(const Number *src,
+                                        const Number *diagonal_inverse,
+                                        const bool    start_zero,
+                                        const Number  factor1,
+                                        const Number  factor2,
+                                        Number       *update1,
+                                        const Number *update2,
+                                        Number       *dst,
+                                        const typename Vector<Number>::size_type N)
+      {
+        const typename Vector<Number>::size_type idx_base = threadIdx.x +
+                                                            blockIdx.x*(blockDim.x*CHUNK_SIZE);
+        for (unsigned int i=0; i<CHUNK_SIZE; ++i)
+          {
+            const typename Vector<Number>::size_type idx = idx_base +
+                                                           i*BLOCK_SIZE;
+            if (idx < N)
+              {
+                if (factor1 == Number())
+                  {
+                    if (start_zero)
+                      {
+                        dst[idx] = factor2 * src[idx] * diagonal_inverse[idx];
+                        update1[idx] = -dst[idx];
+                      }
+                    else
+                      {
+                        update1[idx] = (update2[idx]-src[idx]) * factor2 *
+                                       diagonal_inverse[idx];
+                        dst[idx] -= update1[idx];
+                      }
+                  }
+                else
+                  {
+                    const Number update = factor1 * update1[idx] + factor2 *
+                                          ((update2[idx] - src[idx]) * diagonal_inverse[idx]);
+                    update1[idx] = update;
+                    dst[idx] -= update;
+                  }
+              }
+          }
+      }
     }
 
 
@@ -544,18 +664,21 @@ namespace LinearAlgebra
         {
           if (n_elements != n)
             {
-              cudaError_t error_code = cudaFree(val);
+              if (val != nullptr)
+                {
+                  cudaError_t error_code = cudaFree(val);
+                  AssertCuda(error_code);
+                }
+
+              cudaError_t error_code = cudaMalloc(&val, n*sizeof(Number));
               AssertCuda(error_code);
             }
 
-          cudaError_t error_code = cudaMalloc(&val, n*sizeof(Number));
-          AssertCuda(error_code);
-
           // If necessary set the elements to zero
           if (omit_zeroing_entries == false)
             {
               cudaError_t error_code = cudaMemset(val, 0,
-                                                  n_elements*sizeof(Number));
+                                                  n*sizeof(Number));
               AssertCuda(error_code);
             }
         }
@@ -629,6 +752,25 @@ namespace LinearAlgebra
 
 
 
+    template <typename Number>
+    Vector<Number> &Vector<Number>::operator= (const Vector<Number> &V)
+    {
+      if (&V == this)
+        return *this;
+
+      reinit(V.n_elements, true);
+      if (n_elements > 0)
+        {
+          cudaError_t error_code = cudaMemcpy(val, V.val, n_elements*sizeof(Number),
+                                              cudaMemcpyDeviceToDevice);
+          AssertCuda(error_code);
+        }
+
+      return *this;
+    }
+
+
+
     template <typename Number>
     Vector<Number> &Vector<Number>::operator*= (const Number factor)
     {
@@ -733,9 +875,10 @@ namespace LinearAlgebra
              ExcMessage("Cannot add two vectors with different numbers of elements"));
 
       Number *result_device;
-      cudaError_t error_code = cudaMalloc(&result_device, n_elements*sizeof(Number));
+      cudaError_t error_code = cudaMalloc(&result_device, sizeof(Number));
       AssertCuda(error_code);
       error_code = cudaMemset(result_device, Number(), sizeof(Number));
+      AssertCuda(error_code);
 
       const int n_blocks = 1 + (n_elements-1)/(CHUNK_SIZE*BLOCK_SIZE);
       internal::double_vector_reduction<Number, internal::DotProduct<Number>>
@@ -1108,9 +1251,136 @@ namespace LinearAlgebra
 
 
 
+    namespace internal
+    {
+      template <typename Number>
+      std::pair<Number,Number>
+      cg_update_solution_and_residual(Vector<Number>       &x,
+                                      Vector<Number>       &g,
+                                      const Vector<Number> &d,
+                                      const Vector<Number> &h,
+                                      const Vector<Number> *diagonal,
+                                      const Number          alpha)
+      {
+        const typename Vector<Number>::size_type n = x.size();
+        Assert(g.size() == n, ExcDimensionMismatch(g.size(), n));
+        Assert(d.size() == n, ExcDimensionMismatch(d.size(), n));
+        Assert(h.size() == n, ExcDimensionMismatch(h.size(), n));
+        Assert(diagonal == nullptr || diagonal->size() == n,
+               ExcDimensionMismatch(diagonal->size(), n));
+
+        Number *res_d;
+        cudaError_t error_code = cudaMalloc(&res_d, 2*sizeof(Number));
+        AssertCuda(error_code);
+        error_code = cudaMemset(res_d, 0, 2*sizeof(Number));
+        AssertCuda(error_code);
+
+        if (n > 0)
+          {
+            const int n_blocks = 1 + (n-1)/(CHUNK_SIZE*BLOCK_SIZE);
+            cg_update_and_dots<Number> <<<dim3(n_blocks,1),dim3(BLOCK_SIZE)>>>(
+              res_d, x.get_values(), g.get_values(), d.get_values(), h.get_values(),
+              diagonal != nullptr ? diagonal->get_values() : nullptr, alpha, n);
+            // Check that the kernel was launched correctly
+            AssertCuda(cudaGetLastError());
+          }
+
+        Number res[2];
+        error_code = cudaMemcpy(res, res_d, 2*sizeof(Number), cudaMemcpyDeviceToHost);
+        AssertCuda(error_code);
+        error_code = cudaFree(res_d);
+        AssertCuda(error_code);
+
+        if (diagonal == nullptr)
+          res[1] = res[0];
+        return std::make_pair(res[0], res[1]);
+      }
+
+
+
+      template <typename Number>
+      void
+      cg_update_search_direction(Vector<Number>       &d,
+                                 const Vector<Number> &g,
+                                 const Vector<Number> *diagonal,
+                                 const Number          beta)
+      {
+        const typename Vector<Number>::size_type n = d.size();
+        Assert(g.size() == n, ExcDimensionMismatch(g.size(), n));
+        Assert(diagonal == nullptr || diagonal->size() == n,
+               ExcDimensionMismatch(diagonal->size(), n));
+        if (n == 0)
+          return;
+
+        const int n_blocks = 1 + (n-1)/(CHUNK_SIZE*BLOCK_SIZE);
+        cg_search_direction<Number> <<<n_blocks,BLOCK_SIZE>>>(
+          d.get_values(), g.get_values(),
+          diagonal != nullptr ? diagonal->get_values() : nullptr, beta, n);
+
+        // Check that the kernel was launched correctly
+        AssertCuda(cudaGetLastError());
+      }
+
+
+
+      template <typename Number>
+      void
+      chebyshev_vector_updates(const Vector<Number> &src,
+                               const Vector<Number> &diagonal_inverse,
+                               const bool            start_zero,
+                               const Number          factor1,
+                               const Number          factor2,
+                               Vector<Number>       &update1,
+                               const Vector<Number> &update2,
+                               Vector<Number>       &dst)
+      {
+        const typename Vector<Number>::size_type n = src.size();
+        Assert(diagonal_inverse.size() == n,
+               ExcDimensionMismatch(diagonal_inverse.size(), n));
+        Assert(dst.size() == n, ExcDimensionMismatch(dst.size(), n));
+        Assert(start_zero || update2.size() == n,
+               ExcDimensionMismatch(update2.size(), n));
+        if (update1.size() != n)
+          update1.reinit(n, true);
+        if (n == 0)
+          return;
+
+        const int n_blocks = 1 + (n-1)/(CHUNK_SIZE*BLOCK_SIZE);
+        chebyshev_updates<Number> <<<n_blocks,BLOCK_SIZE>>>(
+          src.get_values(), diagonal_inverse.get_values(), start_zero,
+          factor1, factor2, update1.get_values(), update2.get_values(),
+          dst.get_values(), n);
+
+        // Check that the kernel was launched correctly
+        AssertCuda(cudaGetLastError());
+      }
+    }
+
+
+
     // Explicit Instanationation
     template class Vector<float>;
     template class Vector<double>;
+
+#define INSTANTIATE_FUSED_OPERATIONS(Number)                            \
+    template std::pair<Number,Number>                                   \
+    internal::cg_update_solution_and_residual<Number>                   \
+    (Vector<Number> &, Vector<Number> &, const Vector<Number> &,        \
+     const Vector<Number> &, const Vector<Number> *, const Number);     \
+    template void                                                       \
+    internal::cg_update_search_direction<Number>                        \
+    (Vector<Number> &, const Vector<Number> &, const Vector<Number> *,  \
+     const Number);                                                     \
+    template void                                                       \
+    internal::chebyshev_vector_updates<Number>                          \
+    (const Vector<Number> &, const Vector<Number> &, const bool,        \
+     const Number, const Number, Vector<Number> &,                      \
+     const Vector<Number> &, Vector<Number> &)
+
+    INSTANTIATE_FUSED_OPERATIONS(float);
+    INSTANTIATE_FUSED_OPERATIONS(double);
+
+#undef INSTANTIATE_FUSED_OPERATIONS
   }
 }
 
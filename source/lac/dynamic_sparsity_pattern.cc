@@ -505,6 +505,36 @@ DynamicSparsityPattern::memory_consumption () const
 }
 
 
+
+
+DynamicSparsityPattern::ThreadSafeInserter::
+ThreadSafeInserter (DynamicSparsityPattern &sparsity_pattern)
+  :
+  sparsity_pattern (sparsity_pattern),
+  mutexes (n_mutexes),
+  have_entries (false)
+{}
+
+
+
+DynamicSparsityPattern::ThreadSafeInserter::~ThreadSafeInserter ()
+{
+  if (have_entries)
+    sparsity_pattern.have_entries = true;
+}
+
+
+
+void
+DynamicSparsityPattern::ThreadSafeInserter::add (const size_type i,
+                                                 const size_type j)
+{
+  Assert (j<sparsity_pattern.cols,
+          ExcIndexRangeType<size_type>(j, 0, sparsity_pattern.cols));
+  add_entries (i, &j, &j+1, true);
+}
+
+
 // explicit instantiations
 template void DynamicSparsityPattern::Line::add_entries(size_type *,
                                                         size_type *,
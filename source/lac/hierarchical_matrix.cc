@@ -0,0 +1,553 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/lac/hierarchical_matrix.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace HierarchicalMatrix
+  {
+    /**
+     * Return the length of the diagonal of a bounding box.
+     */
+    template <int spacedim>
+    double
+    diameter (const BoundingBox<spacedim> &box)
+    {
+      return box.get_boundary_points().first.distance(box.get_boundary_points().second);
+    }
+
+
+
+    /**
+     * Return the Euclidean distance between two bounding boxes, which is
+     * zero if they overlap.
+     */
+    template <int spacedim>
+    double
+    distance (const BoundingBox<spacedim> &box1,
+              const BoundingBox<spacedim> &box2)
+    {
+      const std::pair<Point<spacedim>,Point<spacedim> > &p1 = box1.get_boundary_points();
+      const std::pair<Point<spacedim>,Point<spacedim> > &p2 = box2.get_boundary_points();
+      double distance_square = 0;
+      for (unsigned int d=0; d<spacedim; ++d)
+        {
+          const double gap = std::max(0., std::max(p1.first[d] - p2.second[d],
+                                                   p2.first[d] - p1.second[d]));
+          distance_square += gap * gap;
+        }
+      return std::sqrt(distance_square);
+    }
+  }
+}
+
+
+
+template <int spacedim, typename Number>
+HierarchicalMatrix<spacedim,Number>::AdditionalData::
+AdditionalData (const unsigned int leaf_size,
+                const double       admissibility_parameter,
+                const double       aca_tolerance,
+                const unsigned int max_rank)
+  :
+  leaf_size (leaf_size),
+  admissibility_parameter (admissibility_parameter),
+  aca_tolerance (aca_tolerance),
+  max_rank (max_rank)
+{}
+
+
+
+template <int spacedim, typename Number>
+HierarchicalMatrix<spacedim,Number>::HierarchicalMatrix ()
+{}
+
+
+
+template <int spacedim, typename Number>
+void
+HierarchicalMatrix<spacedim,Number>::clear ()
+{
+  matrix_entry = std::function<Number (const size_type, const size_type)>();
+  row_clusters.clear();
+  column_clusters.clear();
+  row_permutation.clear();
+  column_permutation.clear();
+  blocks.clear();
+}
+
+
+
+template <int spacedim, typename Number>
+void
+HierarchicalMatrix<spacedim,Number>::
+reinit (const std::vector<Point<spacedim> >                            &row_points,
+        const std::vector<Point<spacedim> >                            &column_points,
+        const std::function<Number (const size_type, const size_type)> &matrix_entry_in,
+        const AdditionalData                                           &additional_data_in)
+{
+  AssertThrow (row_points.size() > 0 && column_points.size() > 0,
+               ExcEmptyCluster());
+  Assert (additional_data_in.leaf_size > 0, ExcMessage ("The leaf size must be positive."));
+
+  clear ();
+  additional_data = additional_data_in;
+  matrix_entry = matrix_entry_in;
+
+  build_cluster_tree (row_points, row_clusters, row_permutation);
+  build_cluster_tree (column_points, column_clusters, column_permutation);
+  build_block_tree (0, 0);
+
+  // the blocks are independent of each other, so compute them in
+  // parallel. each block evaluates many matrix entries, so a grain size of
+  // one block is appropriate
+  parallel::apply_to_subranges (0U, static_cast<unsigned int>(blocks.size()),
+                                [this] (const unsigned int begin,
+                                        const unsigned int end)
+  {
+    for (unsigned int b=begin; b<end; ++b)
+      compute_block (blocks[b]);
+  },
+  1);
+
+  matrix_entry = std::function<Number (const size_type, const size_type)>();
+}
+
+
+
+template <int spacedim, typename Number>
+void
+HierarchicalMatrix<spacedim,Number>::
+build_cluster_tree (const std::vector<Point<spacedim> > &points,
+                    std::vector<Cluster>                &clusters,
+                    std::vector<unsigned int>           &permutation) const
+{
+  permutation.resize (points.size());
+  std::iota (permutation.begin(), permutation.end(), 0U);
+
+  clusters.clear();
+  clusters.reserve (2*(points.size()/additional_data.leaf_size+1));
+
+  // build the tree in breadth-first order, starting with the cluster of all
+  // points
+  Cluster root;
+  root.begin = 0;
+  root.end = points.size();
+  clusters.push_back (root);
+  for (unsigned int c=0; c<clusters.size(); ++c)
+    {
+      const unsigned int begin = clusters[c].begin;
+      const unsigned int end = clusters[c].end;
+
+      Point<spacedim> lower = points[permutation[begin]], upper = lower;
+      for (unsigned int i=begin+1; i<end; ++i)
+        for (unsigned int d=0; d<spacedim; ++d)
+          {
+            lower[d] = std::min(lower[d], points[permutation[i]][d]);
+            upper[d] = std::max(upper[d], points[permutation[i]][d]);
+          }
+      clusters[c].box = BoundingBox<spacedim>(std::make_pair(lower, upper));
+      clusters[c].children[0] = clusters[c].children[1] = numbers::invalid_unsigned_int;
+
+      if (end - begin <= additional_data.leaf_size)
+        continue;
+
+      // split at the median along the longest edge of the bounding box
+      unsigned int split_direction = 0;
+      for (unsigned int d=1; d<spacedim; ++d)
+        if (upper[d]-lower[d] > upper[split_direction]-lower[split_direction])
+          split_direction = d;
+
+      const unsigned int middle = begin + (end-begin)/2;
+      std::nth_element (permutation.begin()+begin, permutation.begin()+middle,
+                        permutation.begin()+end,
+                        [&] (const unsigned int a, const unsigned int b)
+      {
+        return points[a][split_direction] < points[b][split_direction];
+      });
+
+      Cluster child;
+      child.begin = begin;
+      child.end = middle;
+      clusters[c].children[0] = clusters.size();
+      clusters.push_back (child);
+      child.begin = middle;
+      child.end = end;
+      clusters[c].children[1] = clusters.size();
+      clusters.push_back (child);
+    }
+}
+
+
+
+template <int spacedim, typename Number>
+void
+HierarchicalMatrix<spacedim,Number>::
+build_block_tree (const unsigned int row_cluster,
+                  const unsigned int column_cluster)
+{
+  const Cluster &rows = row_clusters[row_cluster];
+  const Cluster &columns = column_clusters[column_cluster];
+
+  const double distance = internal::HierarchicalMatrix::distance (rows.box, columns.box);
+  const bool admissible
+    = (distance > 0 &&
+       std::min(internal::HierarchicalMatrix::diameter (rows.box),
+                internal::HierarchicalMatrix::diameter (columns.box))
+       <= additional_data.admissibility_parameter * distance);
+
+  const bool row_leaf = (rows.children[0] == numbers::invalid_unsigned_int);
+  const bool column_leaf = (columns.children[0] == numbers::invalid_unsigned_int);
+  if (admissible || (row_leaf && column_leaf))
+    {
+      Block block;
+      block.row_cluster = row_cluster;
+      block.column_cluster = column_cluster;
+      block.is_low_rank = admissible;
+      block.rank = 0;
+      blocks.push_back (std::move(block));
+    }
+  else if (row_leaf)
+    for (unsigned int c=0; c<2; ++c)
+      build_block_tree (row_cluster, columns.children[c]);
+  else if (column_leaf)
+    for (unsigned int r=0; r<2; ++r)
+      build_block_tree (rows.children[r], column_cluster);
+  else
+    for (unsigned int r=0; r<2; ++r)
+      for (unsigned int c=0; c<2; ++c)
+        build_block_tree (rows.children[r], columns.children[c]);
+}
+
+
+
+template <int spacedim, typename Number>
+void
+HierarchicalMatrix<spacedim,Number>::compute_block (Block &block) const
+{
+  const Cluster &rows = row_clusters[block.row_cluster];
+  const Cluster &columns = column_clusters[block.column_cluster];
+  const unsigned int n_rows = rows.end - rows.begin;
+  const unsigned int n_columns = columns.end - columns.begin;
+  const unsigned int *row_indices = &row_permutation[rows.begin];
+  const unsigned int *column_indices = &column_permutation[columns.begin];
+
+  if (block.is_low_rank)
+    {
+      // adaptive cross approximation with partial pivoting. the low-rank
+      // representation only pays off as long as rank*(n_rows+n_columns) is
+      // smaller than n_rows*n_columns
+      const unsigned int max_rank = std::min (additional_data.max_rank,
+                                              n_rows*n_columns/(n_rows+n_columns));
+      std::vector<bool> row_used (n_rows, false);
+      std::vector<Number> row (n_columns), column (n_rows);
+      double norm_square = 0;
+      bool converged = false;
+      unsigned int pivot_row = 0;
+      while (block.rank < max_rank)
+        {
+          // residual of the pivot row
+          for (unsigned int j=0; j<n_columns; ++j)
+            row[j] = matrix_entry (row_indices[pivot_row], column_indices[j]);
+          for (unsigned int l=0; l<block.rank; ++l)
+            {
+              const Number u_l = block.u[l*n_rows+pivot_row];
+              const Number *v_l = &block.v[l*n_columns];
+              for (unsigned int j=0; j<n_columns; ++j)
+                row[j] -= u_l * v_l[j];
+            }
+          row_used[pivot_row] = true;
+
+          unsigned int pivot_column = 0;
+          for (unsigned int j=1; j<n_columns; ++j)
+            if (std::abs(row[j]) > std::abs(row[pivot_column]))
+              pivot_column = j;
+
+          // the row is already represented exactly: go to the next row not
+          // used so far, or stop if there is none
+          if (row[pivot_column] == Number())
+            {
+              pivot_row = std::find (row_used.begin(), row_used.end(), false)
+                          - row_used.begin();
+              if (pivot_row == n_rows)
+                {
+                  converged = true;
+                  break;
+                }
+              continue;
+            }
+
+          const Number scaling = Number(1.)/row[pivot_column];
+          for (unsigned int j=0; j<n_columns; ++j)
+            row[j] *= scaling;
+
+          // residual of the pivot column
+          for (unsigned int i=0; i<n_rows; ++i)
+            column[i] = matrix_entry (row_indices[i], column_indices[pivot_column]);
+          for (unsigned int l=0; l<block.rank; ++l)
+            {
+              const Number *u_l = &block.u[l*n_rows];
+              const Number v_l = block.v[l*n_columns+pivot_column];
+              for (unsigned int i=0; i<n_rows; ++i)
+                column[i] -= u_l[i] * v_l;
+            }
+
+          // update the estimate of the Frobenius norm of the approximation
+          // by the contributions of the new rank-one term
+          double column_norm_square = 0, row_norm_square = 0;
+          for (unsigned int i=0; i<n_rows; ++i)
+            column_norm_square += column[i]*column[i];
+          for (unsigned int j=0; j<n_columns; ++j)
+            row_norm_square += row[j]*row[j];
+          double mixed_terms = 0;
+          for (unsigned int l=0; l<block.rank; ++l)
+            {
+              double u_product = 0, v_product = 0;
+              for (unsigned int i=0; i<n_rows; ++i)
+                u_product += column[i]*block.u[l*n_rows+i];
+              for (unsigned int j=0; j<n_columns; ++j)
+                v_product += row[j]*block.v[l*n_columns+j];
+              mixed_terms += u_product * v_product;
+            }
+          norm_square += 2.*mixed_terms + column_norm_square*row_norm_square;
+
+          block.u.insert (block.u.end(), column.begin(), column.end());
+          block.v.insert (block.v.end(), row.begin(), row.end());
+          ++block.rank;
+
+          if (column_norm_square*row_norm_square <=
+              additional_data.aca_tolerance*additional_data.aca_tolerance*norm_square)
+            {
+              converged = true;
+              break;
+            }
+
+          // the next pivot row is the row not used so far with the largest
+          // entry in the current column
+          pivot_row = n_rows;
+          for (unsigned int i=0; i<n_rows; ++i)
+            if (row_used[i] == false &&
+                (pivot_row == n_rows || std::abs(column[i]) > std::abs(column[pivot_row])))
+              pivot_row = i;
+          if (pivot_row == n_rows)
+            {
+              converged = true;
+              break;
+            }
+        }
+
+      if (converged)
+        return;
+
+      // the approximation did not reach the accuracy with a rank that saves
+      // memory, so store the block as a dense one
+      block.is_low_rank = false;
+      block.rank = 0;
+      std::vector<Number>().swap (block.u);
+      std::vector<Number>().swap (block.v);
+    }
+
+  block.dense.resize (static_cast<std::size_t>(n_rows)*n_columns);
+  for (unsigned int i=0; i<n_rows; ++i)
+    for (unsigned int j=0; j<n_columns; ++j)
+      block.dense[i*n_columns+j] = matrix_entry (row_indices[i], column_indices[j]);
+}
+
+
+
+template <int spacedim, typename Number>
+void
+HierarchicalMatrix<spacedim,Number>::apply_add (Number       *dst,
+                                                const Number *src,
+                                                const bool    transpose) const
+{
+  std::vector<Number> tmp;
+  for (const Block &block : blocks)
+    {
+      const Cluster &rows = row_clusters[block.row_cluster];
+      const Cluster &columns = column_clusters[block.column_cluster];
+      const unsigned int n_rows = rows.end - rows.begin;
+      const unsigned int n_columns = columns.end - columns.begin;
+
+      // in the transpose case, the roles of rows and columns as well as the
+      // ones of the two low-rank factors are interchanged
+      const unsigned int n_dst = transpose ? n_columns : n_rows;
+      const unsigned int n_src = transpose ? n_rows : n_columns;
+      Number *dst_block = dst + (transpose ? columns.begin : rows.begin);
+      const Number *src_block = src + (transpose ? rows.begin : columns.begin);
+
+      if (block.is_low_rank)
+        {
+          const Number *left = transpose ? block.v.data() : block.u.data();
+          const Number *right = transpose ? block.u.data() : block.v.data();
+          tmp.resize (block.rank);
+          for (unsigned int l=0; l<block.rank; ++l)
+            {
+              Number sum = Number();
+              for (unsigned int j=0; j<n_src; ++j)
+                sum += right[l*n_src+j] * src_block[j];
+              tmp[l] = sum;
+            }
+          for (unsigned int l=0; l<block.rank; ++l)
+            for (unsigned int i=0; i<n_dst; ++i)
+              dst_block[i] += left[l*n_dst+i] * tmp[l];
+        }
+      else if (transpose == false)
+        for (unsigned int i=0; i<n_rows; ++i)
+          {
+            const Number *matrix_row = &block.dense[i*n_columns];
+            Number sum = Number();
+            for (unsigned int j=0; j<n_columns; ++j)
+              sum += matrix_row[j] * src_block[j];
+            dst_block[i] += sum;
+          }
+      else
+        for (unsigned int i=0; i<n_rows; ++i)
+          {
+            const Number *matrix_row = &block.dense[i*n_columns];
+            for (unsigned int j=0; j<n_columns; ++j)
+              dst_block[j] += matrix_row[j] * src_block[i];
+          }
+    }
+}
+
+
+
+template <int spacedim, typename Number>
+void
+HierarchicalMatrix<spacedim,Number>::vmult (Vector<Number>       &dst,
+                                            const Vector<Number> &src) const
+{
+  dst = Number();
+  vmult_add (dst, src);
+}
+
+
+
+template <int spacedim, typename Number>
+void
+HierarchicalMatrix<spacedim,Number>::vmult_add (Vector<Number>       &dst,
+                                                const Vector<Number> &src) const
+{
+  AssertDimension (dst.size(), m());
+  AssertDimension (src.size(), n());
+
+  std::vector<Number> src_permuted (n()), dst_permuted (m(), Number());
+  for (unsigned int j=0; j<n(); ++j)
+    src_permuted[j] = src(column_permutation[j]);
+  apply_add (dst_permuted.data(), src_permuted.data(), false);
+  for (unsigned int i=0; i<m(); ++i)
+    dst(row_permutation[i]) += dst_permuted[i];
+}
+
+
+
+template <int spacedim, typename Number>
+void
+HierarchicalMatrix<spacedim,Number>::Tvmult (Vector<Number>       &dst,
+                                             const Vector<Number> &src) const
+{
+  dst = Number();
+  Tvmult_add (dst, src);
+}
+
+
+
+template <int spacedim, typename Number>
+void
+HierarchicalMatrix<spacedim,Number>::Tvmult_add (Vector<Number>       &dst,
+                                                 const Vector<Number> &src) const
+{
+  AssertDimension (dst.size(), n());
+  AssertDimension (src.size(), m());
+
+  std::vector<Number> src_permuted (m()), dst_permuted (n(), Number());
+  for (unsigned int i=0; i<m(); ++i)
+    src_permuted[i] = src(row_permutation[i]);
+  apply_add (dst_permuted.data(), src_permuted.data(), true);
+  for (unsigned int j=0; j<n(); ++j)
+    dst(column_permutation[j]) += dst_permuted[j];
+}
+
+
+
+template <int spacedim, typename Number>
+unsigned int
+HierarchicalMatrix<spacedim,Number>::n_dense_blocks () const
+{
+  return std::count_if (blocks.begin(), blocks.end(),
+                        [] (const Block &block)
+  {
+    return block.is_low_rank == false;
+  });
+}
+
+
+
+template <int spacedim, typename Number>
+unsigned int
+HierarchicalMatrix<spacedim,Number>::n_low_rank_blocks () const
+{
+  return blocks.size() - n_dense_blocks();
+}
+
+
+
+template <int spacedim, typename Number>
+std::size_t
+HierarchicalMatrix<spacedim,Number>::n_stored_values () const
+{
+  std::size_t n_values = 0;
+  for (const Block &block : blocks)
+    n_values += block.dense.size() + block.u.size() + block.v.size();
+  return n_values;
+}
+
+
+
+template <int spacedim, typename Number>
+std::size_t
+HierarchicalMatrix<spacedim,Number>::memory_consumption () const
+{
+  std::size_t memory = sizeof(*this) +
+                       MemoryConsumption::memory_consumption (row_permutation) +
+                       MemoryConsumption::memory_consumption (column_permutation) +
+                       (row_clusters.capacity() + column_clusters.capacity()) * sizeof(Cluster) +
+                       blocks.capacity() * sizeof(Block);
+  for (const Block &block : blocks)
+    memory += (block.dense.capacity() + block.u.capacity() + block.v.capacity()) * sizeof(Number);
+  return memory;
+}
+
+
+
+template class HierarchicalMatrix<1,double>;
+template class HierarchicalMatrix<2,double>;
+template class HierarchicalMatrix<3,double>;
+template class HierarchicalMatrix<1,float>;
+template class HierarchicalMatrix<2,float>;
+template class HierarchicalMatrix<3,float>;
+
+DEAL_II_NAMESPACE_CLOSE
@@ -15,6 +15,7 @@
 
 #include <deal.II/base/mpi.h>
 #include <deal.II/lac/petsc_parallel_vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
 
 #ifdef DEAL_II_WITH_PETSC
 
@@ -237,6 +238,29 @@ namespace PETScWrappers
     }
 
 
+
+    void
+    Vector::reinit_as_view (LinearAlgebra::distributed::Vector<PetscScalar> &v)
+    {
+      PetscErrorCode ierr = VecDestroy (&vector);
+      AssertThrow (ierr == 0, ExcPETScError(ierr));
+
+      communicator = v.get_mpi_communicator();
+
+      Assert(v.locally_owned_elements().is_ascending_and_one_to_one(communicator),
+             ExcNotImplemented());
+      ghosted = false;
+      ghost_indices.clear();
+
+      // PETSc does not take ownership of the array, so destroying the Vec
+      // leaves the memory of v untouched
+      ierr = VecCreateMPIWithArray (communicator, 1, v.local_size(), v.size(),
+                                    v.begin(), &vector);
+      AssertThrow (ierr == 0, ExcPETScError(ierr));
+      obtained_ownership = true;
+    }
+
+
     void
     Vector::create_vector (const size_type n,
                            const size_type local_size)
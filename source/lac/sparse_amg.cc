@@ -0,0 +1,457 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_amg.h>
+
+#include <algorithm>
+#include <cmath>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace SparseAMGImplementation
+  {
+    // the number of rows processed by one task in the parallel loops of the
+    // setup
+    const unsigned int rows_per_task = 2048;
+  }
+}
+
+
+
+template <typename number>
+SparseAMG<number>::AdditionalData::AdditionalData
+(const double       strong_threshold,
+ const unsigned int smoother_degree,
+ const double       smoothing_range,
+ const unsigned int n_cycles,
+ const unsigned int max_coarse_size,
+ const unsigned int max_levels)
+  :
+  strong_threshold (strong_threshold),
+  smoother_degree (smoother_degree),
+  smoothing_range (smoothing_range),
+  n_cycles (n_cycles),
+  max_coarse_size (max_coarse_size),
+  max_levels (max_levels)
+{}
+
+
+
+template <typename number>
+SparseAMG<number>::SparseAMG ()
+  :
+  fine_matrix (nullptr, typeid(*this).name())
+{}
+
+
+
+template <typename number>
+void
+SparseAMG<number>::clear ()
+{
+  levels.clear();
+  coarse_inverse.reinit(0, 0);
+  fine_solution.reinit(0);
+  fine_rhs.reinit(0);
+  fine_matrix = nullptr;
+}
+
+
+
+template <typename number>
+const SparseMatrix<number> &
+SparseAMG<number>::get_matrix (const unsigned int level) const
+{
+  AssertIndexRange (level, levels.size());
+  return level == 0 ? *fine_matrix : levels[level]->matrix;
+}
+
+
+
+template <typename number>
+void
+SparseAMG<number>::initialize (const SparseMatrix<number> &matrix,
+                               const AdditionalData       &additional_data)
+{
+  Assert (matrix.m() == matrix.n(), ExcNotQuadratic());
+  AssertThrow (additional_data.n_cycles > 0,
+               ExcMessage("At least one V-cycle must be performed"));
+  AssertThrow (additional_data.max_levels > 0,
+               ExcMessage("The hierarchy must contain at least one level"));
+
+  clear();
+  fine_matrix = &matrix;
+  data = additional_data;
+
+  levels.emplace_back(new Level());
+  std::vector<unsigned int> aggregates;
+  while (get_matrix(levels.size()-1).m() > data.max_coarse_size &&
+         levels.size() < data.max_levels)
+    {
+      const unsigned int level = levels.size()-1;
+      const SparseMatrix<number> &level_matrix = get_matrix(level);
+      const unsigned int n_aggregates = compute_aggregates(level_matrix, aggregates);
+
+      // stop if the aggregation stagnates, which happens for matrices
+      // without strong connections, e.g. mass matrices, where the smoother
+      // is good enough on its own
+      if (n_aggregates == 0 || n_aggregates > 0.8 * level_matrix.m())
+        break;
+
+      build_prolongation(level, aggregates, n_aggregates);
+
+      // compute the Galerkin product P^T A P of the next coarser level
+      std::unique_ptr<Level> coarse (new Level());
+      {
+        SparsityPattern sparsity_ap;
+        SparseMatrix<number> ap;
+        ap.reinit(sparsity_ap);
+        level_matrix.mmult(ap, levels[level]->prolongation);
+        coarse->matrix.reinit(coarse->sparsity);
+        levels[level]->prolongation.Tmmult(coarse->matrix, ap);
+      }
+      levels.push_back(std::move(coarse));
+    }
+
+  // set up the smoothers on all levels but the coarsest
+  typename PreconditionChebyshev<SparseMatrix<number>,Vector<number> >::AdditionalData
+  smoother_data;
+  smoother_data.degree = data.smoother_degree;
+  smoother_data.smoothing_range = data.smoothing_range;
+  smoother_data.eig_cg_n_iterations = 10;
+  for (unsigned int level=0; level<levels.size(); ++level)
+    {
+      const SparseMatrix<number> &level_matrix = get_matrix(level);
+      if (level+1 < levels.size())
+        {
+          levels[level]->smoother.initialize(level_matrix, smoother_data);
+          levels[level]->residual.reinit(level_matrix.m(), true);
+        }
+      levels[level]->solution.reinit(level_matrix.m(), true);
+      levels[level]->rhs.reinit(level_matrix.m(), true);
+    }
+
+  // invert the coarsest matrix
+  coarse_inverse.copy_from(get_matrix(levels.size()-1));
+  if (coarse_inverse.m() > 0)
+    coarse_inverse.gauss_jordan();
+}
+
+
+
+template <typename number>
+unsigned int
+SparseAMG<number>::compute_aggregates (const SparseMatrix<number> &matrix,
+                                       std::vector<unsigned int>  &aggregates) const
+{
+  const size_type n_rows = matrix.m();
+  const double threshold = data.strong_threshold * data.strong_threshold;
+
+  Vector<number> diagonal(n_rows);
+  for (size_type i=0; i<n_rows; ++i)
+    diagonal(i) = matrix.diag_element(i);
+
+  // collect the strong connections of each row, first counting and then
+  // filling them
+  std::vector<unsigned int> strong_row_starts(n_rows+1, 0);
+  std::vector<size_type> strong_columns;
+  const auto is_strong = [&](const size_type row,
+                             const typename SparseMatrix<number>::const_iterator &entry)
+  {
+    const double value = entry->value();
+    return (entry->column() != row &&
+            value*value > threshold *
+            std::abs(static_cast<double>(diagonal(row)) *
+                     static_cast<double>(diagonal(entry->column()))));
+  };
+  parallel::apply_to_subranges
+  (size_type(0), n_rows,
+   [&](const size_type begin, const size_type end)
+  {
+    for (size_type i=begin; i<end; ++i)
+      for (auto entry=matrix.begin(i); entry != matrix.end(i); ++entry)
+        if (is_strong(i, entry))
+          ++strong_row_starts[i+1];
+  },
+  internal::SparseAMGImplementation::rows_per_task);
+  for (size_type i=0; i<n_rows; ++i)
+    strong_row_starts[i+1] += strong_row_starts[i];
+  strong_columns.resize(strong_row_starts[n_rows]);
+  parallel::apply_to_subranges
+  (size_type(0), n_rows,
+   [&](const size_type begin, const size_type end)
+  {
+    for (size_type i=begin; i<end; ++i)
+      {
+        unsigned int index = strong_row_starts[i];
+        for (auto entry=matrix.begin(i); entry != matrix.end(i); ++entry)
+          if (is_strong(i, entry))
+            strong_columns[index++] = entry->column();
+      }
+  },
+  internal::SparseAMGImplementation::rows_per_task);
+
+  aggregates.clear();
+  aggregates.resize(n_rows, numbers::invalid_unsigned_int);
+  unsigned int n_aggregates = 0;
+
+  // first pass: form aggregates from the strong neighborhoods of unknowns
+  // whose neighbors are all still free
+  for (size_type i=0; i<n_rows; ++i)
+    {
+      if (aggregates[i] != numbers::invalid_unsigned_int ||
+          strong_row_starts[i] == strong_row_starts[i+1])
+        continue;
+      bool all_free = true;
+      for (unsigned int j=strong_row_starts[i]; j<strong_row_starts[i+1]; ++j)
+        if (aggregates[strong_columns[j]] != numbers::invalid_unsigned_int)
+          {
+            all_free = false;
+            break;
+          }
+      if (all_free)
+        {
+          aggregates[i] = n_aggregates;
+          for (unsigned int j=strong_row_starts[i]; j<strong_row_starts[i+1]; ++j)
+            aggregates[strong_columns[j]] = n_aggregates;
+          ++n_aggregates;
+        }
+    }
+
+  // second pass: attach the remaining unknowns to the aggregate of the first
+  // pass they are most strongly connected to
+  const std::vector<unsigned int> first_pass_aggregates = aggregates;
+  for (size_type i=0; i<n_rows; ++i)
+    {
+      if (aggregates[i] != numbers::invalid_unsigned_int)
+        continue;
+      double strongest = 0.;
+      for (auto entry=matrix.begin(i); entry != matrix.end(i); ++entry)
+        if (is_strong(i, entry) &&
+            first_pass_aggregates[entry->column()] != numbers::invalid_unsigned_int &&
+            std::abs(static_cast<double>(entry->value())) > strongest)
+          {
+            strongest = std::abs(static_cast<double>(entry->value()));
+            aggregates[i] = first_pass_aggregates[entry->column()];
+          }
+    }
+
+  // third pass: group the unknowns that are still free with their free
+  // strong neighbors
+  for (size_type i=0; i<n_rows; ++i)
+    if (aggregates[i] == numbers::invalid_unsigned_int &&
+        strong_row_starts[i] < strong_row_starts[i+1])
+      {
+        aggregates[i] = n_aggregates;
+        for (unsigned int j=strong_row_starts[i]; j<strong_row_starts[i+1]; ++j)
+          if (aggregates[strong_columns[j]] == numbers::invalid_unsigned_int)
+            aggregates[strong_columns[j]] = n_aggregates;
+        ++n_aggregates;
+      }
+
+  return n_aggregates;
+}
+
+
+
+template <typename number>
+void
+SparseAMG<number>::build_prolongation (const unsigned int               level,
+                                       const std::vector<unsigned int> &aggregates,
+                                       const unsigned int               n_aggregates)
+{
+  const SparseMatrix<number> &matrix = get_matrix(level);
+  const size_type n_rows = matrix.m();
+  AssertDimension (aggregates.size(), n_rows);
+
+  // bound the spectral radius of D^{-1}A by the maximal absolute row sum
+  std::vector<double> row_sums(n_rows, 0.);
+  parallel::apply_to_subranges
+  (size_type(0), n_rows,
+   [&](const size_type begin, const size_type end)
+  {
+    for (size_type i=begin; i<end; ++i)
+      {
+        const double diagonal = std::abs(static_cast<double>(matrix.diag_element(i)));
+        if (diagonal == 0.)
+          continue;
+        for (auto entry=matrix.begin(i); entry != matrix.end(i); ++entry)
+          row_sums[i] += std::abs(static_cast<double>(entry->value()));
+        row_sums[i] /= diagonal;
+      }
+  },
+  internal::SparseAMGImplementation::rows_per_task);
+  const double spectral_radius = *std::max_element(row_sums.begin(), row_sums.end());
+  const double omega = spectral_radius > 0. ? 4./3./spectral_radius : 0.;
+
+  // the smoothed prolongation couples each row with the aggregates of all
+  // unknowns in the row of the matrix
+  Level &data_level = *levels[level];
+  {
+    DynamicSparsityPattern dsp(n_rows, n_aggregates);
+    for (size_type i=0; i<n_rows; ++i)
+      for (auto entry=matrix.begin(i); entry != matrix.end(i); ++entry)
+        if (aggregates[entry->column()] != numbers::invalid_unsigned_int)
+          dsp.add(i, aggregates[entry->column()]);
+    data_level.prolongation_sparsity.copy_from(dsp);
+  }
+  data_level.prolongation.reinit(data_level.prolongation_sparsity);
+
+  SparseMatrix<number> &prolongation = data_level.prolongation;
+  parallel::apply_to_subranges
+  (size_type(0), n_rows,
+   [&](const size_type begin, const size_type end)
+  {
+    for (size_type i=begin; i<end; ++i)
+      {
+        const number diagonal = matrix.diag_element(i);
+        if (diagonal == number())
+          {
+            if (aggregates[i] != numbers::invalid_unsigned_int)
+              prolongation.set(i, aggregates[i], number(1.));
+            continue;
+          }
+        for (auto entry=matrix.begin(i); entry != matrix.end(i); ++entry)
+          if (aggregates[entry->column()] != numbers::invalid_unsigned_int)
+            prolongation.add(i, aggregates[entry->column()],
+                             (entry->column() == i ? number(1.) : number()) -
+                             number(omega) * entry->value() / diagonal);
+      }
+  },
+  internal::SparseAMGImplementation::rows_per_task);
+}
+
+
+
+template <typename number>
+void
+SparseAMG<number>::v_cycle (const unsigned int level) const
+{
+  Level &data_level = *levels[level];
+  if (level+1 == levels.size())
+    {
+      if (coarse_inverse.m() > 0)
+        coarse_inverse.vmult(data_level.solution, data_level.rhs);
+      return;
+    }
+
+  const SparseMatrix<number> &matrix = get_matrix(level);
+  Level &coarse = *levels[level+1];
+
+  data_level.smoother.vmult(data_level.solution, data_level.rhs);
+  matrix.residual(data_level.residual, data_level.solution, data_level.rhs);
+  data_level.prolongation.Tvmult(coarse.rhs, data_level.residual);
+
+  v_cycle(level+1);
+
+  data_level.prolongation.vmult_add(data_level.solution, coarse.solution);
+  data_level.smoother.step(data_level.solution, data_level.rhs);
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseAMG<number>::vmult (Vector<somenumber>       &dst,
+                          const Vector<somenumber> &src) const
+{
+  Assert (fine_matrix != nullptr, ExcNotInitialized());
+  AssertDimension (dst.size(), fine_matrix->m());
+  AssertDimension (src.size(), fine_matrix->m());
+
+  Level &fine = *levels[0];
+  if (data.n_cycles == 1)
+    {
+      fine.rhs = src;
+      v_cycle(0);
+      dst = fine.solution;
+      return;
+    }
+
+  // repeat the V-cycles on the residual of the previous ones
+  fine_rhs = src;
+  fine_solution.reinit(fine_rhs.size());
+  for (unsigned int cycle=0; cycle<data.n_cycles; ++cycle)
+    {
+      if (cycle == 0)
+        fine.rhs = fine_rhs;
+      else
+        fine_matrix->residual(fine.rhs, fine_solution, fine_rhs);
+      v_cycle(0);
+      fine_solution += fine.solution;
+    }
+  dst = fine_solution;
+}
+
+
+
+template <typename number>
+double
+SparseAMG<number>::get_operator_complexity () const
+{
+  Assert (fine_matrix != nullptr, ExcNotInitialized());
+  double n_nonzeros = 0;
+  for (unsigned int level=0; level<levels.size(); ++level)
+    n_nonzeros += get_matrix(level).n_nonzero_elements();
+  return n_nonzeros / std::max<double>(1., fine_matrix->n_nonzero_elements());
+}
+
+
+
+template <typename number>
+std::size_t
+SparseAMG<number>::memory_consumption () const
+{
+  std::size_t memory = sizeof(*this) + coarse_inverse.memory_consumption() +
+                       fine_solution.memory_consumption() +
+                       fine_rhs.memory_consumption();
+  for (unsigned int level=0; level<levels.size(); ++level)
+    {
+      const Level &data_level = *levels[level];
+      memory += sizeof(Level) +
+                data_level.sparsity.memory_consumption() +
+                data_level.matrix.memory_consumption() +
+                data_level.prolongation_sparsity.memory_consumption() +
+                data_level.prolongation.memory_consumption() +
+                data_level.solution.memory_consumption() +
+                data_level.rhs.memory_consumption() +
+                data_level.residual.memory_consumption();
+    }
+  return memory;
+}
+
+
+
+// explicit instantiations
+template class SparseAMG<float>;
+template class SparseAMG<double>;
+
+template void SparseAMG<float>::vmult<float> (Vector<float> &,
+                                              const Vector<float> &) const;
+template void SparseAMG<float>::vmult<double> (Vector<double> &,
+                                               const Vector<double> &) const;
+template void SparseAMG<double>::vmult<float> (Vector<float> &,
+                                               const Vector<float> &) const;
+template void SparseAMG<double>::vmult<double> (Vector<double> &,
+                                                const Vector<double> &) const;
+
+DEAL_II_NAMESPACE_CLOSE
@@ -15,6 +15,7 @@
 
 #include <deal.II/lac/sparse_direct.h>
 #include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/thread_management.h>
 #include <deal.II/lac/sparse_matrix.h>
 #include <deal.II/lac/block_sparse_matrix.h>
@@ -202,15 +203,8 @@ sort_arrays (const BlockSparseMatrix<number> &matrix)
 template <class Matrix>
 void
 SparseDirectUMFPACK::
-factorize (const Matrix &matrix)
+copy_matrix_entries (const Matrix &matrix)
 {
-  Assert (matrix.m() == matrix.n(), ExcNotQuadratic())
-
-  clear ();
-
-  _m = matrix.m();
-  _n = matrix.n();
-
   const size_type N = matrix.m();
 
   // copy over the data from the matrix to the data structures UMFPACK
@@ -276,6 +270,25 @@ factorize (const Matrix &matrix)
   // careful for block sparse matrices, so ship this task out to a
   // different function
   sort_arrays (matrix);
+}
+
+
+
+template <class Matrix>
+void
+SparseDirectUMFPACK::
+factorize (const Matrix &matrix)
+{
+  Assert (matrix.m() == matrix.n(), ExcNotQuadratic())
+
+  clear ();
+
+  _m = matrix.m();
+  _n = matrix.n();
+
+  copy_matrix_entries (matrix);
+
+  const size_type N = matrix.m();
 
   int status;
   status = umfpack_dl_symbolic (N, N,
@@ -291,8 +304,51 @@ factorize (const Matrix &matrix)
                                control.data(), nullptr);
   AssertThrow (status == UMFPACK_OK,
                ExcUMFPACKError("umfpack_dl_numeric", status));
+}
+
+
+
+template <class Matrix>
+void
+SparseDirectUMFPACK::
+refactorize (const Matrix &matrix)
+{
+  Assert (matrix.m() == matrix.n(), ExcNotQuadratic())
+
+  if (symbolic_decomposition == nullptr ||
+      matrix.m() != _m ||
+      static_cast<std::size_t>(matrix.n_nonzero_elements()) != Ai.size())
+    {
+      factorize (matrix);
+      return;
+    }
+
+  // copy the new entries, but keep the old sparsity pattern around to check
+  // that the symbolic decomposition still applies to the new matrix
+  std::vector<SuiteSparse_long> old_Ap, old_Ai;
+  old_Ap.swap (Ap);
+  old_Ai.swap (Ai);
+
+  copy_matrix_entries (matrix);
 
-  umfpack_dl_free_symbolic (&symbolic_decomposition) ;
+  if (Ap != old_Ap || Ai != old_Ai)
+    {
+      factorize (matrix);
+      return;
+    }
+
+  if (numeric_decomposition != nullptr)
+    {
+      umfpack_dl_free_numeric (&numeric_decomposition);
+      numeric_decomposition = nullptr;
+    }
+
+  const int status = umfpack_dl_numeric (Ap.data(), Ai.data(), Ax.data(),
+                                         symbolic_decomposition,
+                                         &numeric_decomposition,
+                                         control.data(), nullptr);
+  AssertThrow (status == UMFPACK_OK,
+               ExcUMFPACKError("umfpack_dl_numeric", status));
 }
 
 
@@ -340,6 +396,50 @@ SparseDirectUMFPACK::solve (BlockVector<double> &rhs_and_solution,
 
 
 
+void
+SparseDirectUMFPACK::solve (std::vector<Vector<double> > &rhs_and_solutions,
+                            bool                          transpose /*=false*/) const
+{
+  // make sure that some kind of factorize() call has happened before
+  Assert (Ap.size() != 0, ExcNotInitialized());
+  Assert (Ai.size() != 0, ExcNotInitialized());
+  Assert (Ai.size() == Ax.size(), ExcNotInitialized());
+
+  for (unsigned int i=0; i<rhs_and_solutions.size(); ++i)
+    AssertDimension (rhs_and_solutions[i].size(), _m);
+
+  // the numeric decomposition is only read by umfpack_dl_wsolve, so the
+  // right hand sides can be solved for concurrently. each range of right
+  // hand sides gets its own copy of the right hand side and the work arrays,
+  // which umfpack_dl_solve would otherwise allocate for every single solve
+  // (the size of W covers the case of iterative refinement)
+  parallel::apply_to_subranges
+  (0U, static_cast<unsigned int>(rhs_and_solutions.size()),
+   [&](const unsigned int begin, const unsigned int end)
+  {
+    Vector<double> rhs (_m);
+    std::vector<SuiteSparse_long> Wi (_m);
+    std::vector<double> W (5*_m);
+
+    for (unsigned int i=begin; i<end; ++i)
+      {
+        rhs = rhs_and_solutions[i];
+        const int status
+          = umfpack_dl_wsolve (transpose ? UMFPACK_A : UMFPACK_At,
+                               Ap.data(), Ai.data(), Ax.data(),
+                               rhs_and_solutions[i].begin(), rhs.begin(),
+                               numeric_decomposition,
+                               control.data(), nullptr,
+                               Wi.data(), W.data());
+        AssertThrow (status == UMFPACK_OK,
+                     ExcUMFPACKError("umfpack_dl_wsolve", status));
+      }
+  },
+  1);
+}
+
+
+
 template <class Matrix>
 void
 SparseDirectUMFPACK::solve (const Matrix   &matrix,
@@ -387,6 +487,13 @@ void SparseDirectUMFPACK::factorize (const Matrix &)
 }
 
 
+template <class Matrix>
+void SparseDirectUMFPACK::refactorize (const Matrix &)
+{
+  AssertThrow(false, ExcMessage("To call this function you need UMFPACK, but you configured deal.II without passing the necessary switch to 'cmake'. Please consult the installation instructions in doc/readme.html."));
+}
+
+
 void
 SparseDirectUMFPACK::solve (Vector<double> &, bool) const
 {
@@ -402,6 +509,14 @@ SparseDirectUMFPACK::solve (BlockVector<double> &, bool) const
 }
 
 
+
+void
+SparseDirectUMFPACK::solve (std::vector<Vector<double> > &, bool) const
+{
+  AssertThrow(false, ExcMessage("To call this function you need UMFPACK, but you configured deal.II without passing the necessary switch to 'cmake'. Please consult the installation instructions in doc/readme.html."));
+}
+
+
 template <class Matrix>
 void
 SparseDirectUMFPACK::solve (const Matrix &,
@@ -491,19 +606,21 @@ SparseDirectUMFPACK::n () const
 
 
 // explicit instantiations for SparseMatrixUMFPACK
-#define InstantiateUMFPACK(MatrixType)                      \
-  template                                                  \
-  void SparseDirectUMFPACK::factorize (const MatrixType &); \
-  template                                                  \
-  void SparseDirectUMFPACK::solve (const MatrixType &,      \
-                                   Vector<double> &,        \
-                                   bool);                   \
-  template                                                  \
-  void SparseDirectUMFPACK::solve (const MatrixType &,      \
-                                   BlockVector<double> &,   \
-                                   bool);                   \
-  template                                                  \
-  void SparseDirectUMFPACK::initialize (const MatrixType &, \
+#define InstantiateUMFPACK(MatrixType)                        \
+  template                                                    \
+  void SparseDirectUMFPACK::factorize (const MatrixType &);   \
+  template                                                    \
+  void SparseDirectUMFPACK::refactorize (const MatrixType &); \
+  template                                                    \
+  void SparseDirectUMFPACK::solve (const MatrixType &,        \
+                                   Vector<double> &,          \
+                                   bool);                     \
+  template                                                    \
+  void SparseDirectUMFPACK::solve (const MatrixType &,        \
+                                   BlockVector<double> &,     \
+                                   bool);                     \
+  template                                                    \
+  void SparseDirectUMFPACK::initialize (const MatrixType &,   \
                                         const AdditionalData);
 
 InstantiateUMFPACK(SparseMatrix<double>)
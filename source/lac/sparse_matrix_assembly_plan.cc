@@ -0,0 +1,116 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/lac/sparse_matrix_assembly_plan.h>
+#include <deal.II/base/memory_consumption.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+SparseMatrixAssemblyPlan::SparseMatrixAssemblyPlan ()
+{}
+
+
+
+void
+SparseMatrixAssemblyPlan::reinit (const std::vector<std::vector<size_type> > &cell_dof_indices,
+                                  const SparsityPattern                      &sparsity,
+                                  const ConstraintMatrix                     &constraint_matrix)
+{
+  Assert (sparsity.is_compressed(), SparsityPattern::ExcNotCompressed());
+
+  clear ();
+  sparsity_pattern = &sparsity;
+  constraints = &constraint_matrix;
+
+  const unsigned int n_cells = cell_dof_indices.size();
+  dof_index_starts.resize (n_cells+1);
+  position_starts.resize (n_cells);
+
+  // count the sizes of the arrays first to avoid repeated reallocation
+  dof_index_starts[0] = 0;
+  std::size_t n_positions = 0;
+  for (unsigned int c=0; c<n_cells; ++c)
+    {
+      const std::vector<size_type> &indices = cell_dof_indices[c];
+      dof_index_starts[c+1] = dof_index_starts[c] + indices.size();
+
+      bool is_constrained = false;
+      for (unsigned int i=0; i<indices.size(); ++i)
+        if (constraint_matrix.is_constrained (indices[i]))
+          {
+            is_constrained = true;
+            break;
+          }
+
+      if (is_constrained || indices.empty())
+        position_starts[c] = invalid_position;
+      else
+        {
+          position_starts[c] = n_positions;
+          n_positions += indices.size() * indices.size();
+        }
+    }
+
+  dof_indices.resize (dof_index_starts[n_cells]);
+  positions.resize (n_positions);
+  for (unsigned int c=0; c<n_cells; ++c)
+    {
+      const std::vector<size_type> &indices = cell_dof_indices[c];
+      std::copy (indices.begin(), indices.end(),
+                 dof_indices.begin() + dof_index_starts[c]);
+
+      if (position_starts[c] == invalid_position)
+        continue;
+
+      std::size_t *cell_positions = positions.data() + position_starts[c];
+      for (unsigned int i=0; i<indices.size(); ++i)
+        for (unsigned int j=0; j<indices.size(); ++j, ++cell_positions)
+          {
+            const size_type position = sparsity (indices[i], indices[j]);
+            Assert (position != SparsityPattern::invalid_entry,
+                    ExcMessage ("The sparsity pattern does not contain all "
+                                "entries coupling the degrees of freedom of "
+                                "a cell."));
+            *cell_positions = position;
+          }
+    }
+}
+
+
+
+void
+SparseMatrixAssemblyPlan::clear ()
+{
+  sparsity_pattern = nullptr;
+  constraints = nullptr;
+  dof_indices.clear ();
+  dof_index_starts.clear ();
+  positions.clear ();
+  position_starts.clear ();
+}
+
+
+
+std::size_t
+SparseMatrixAssemblyPlan::memory_consumption () const
+{
+  return (MemoryConsumption::memory_consumption (dof_indices) +
+          MemoryConsumption::memory_consumption (dof_index_starts) +
+          MemoryConsumption::memory_consumption (positions) +
+          MemoryConsumption::memory_consumption (position_starts));
+}
+
+DEAL_II_NAMESPACE_CLOSE
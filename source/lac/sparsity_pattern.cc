@@ -21,8 +21,10 @@
 #include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
 
+#include <cstring>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include <algorithm>
 #include <cmath>
 #include <numeric>
@@ -994,6 +996,58 @@ SparsityPattern::block_read (std::istream &in)
 
 
 
+void
+SparsityPattern::block_read_mapped (const std::string &filename)
+{
+  const Utilities::System::MemoryMappedFile file (filename);
+  const char *const data = file.data();
+  const std::size_t file_size = file.size();
+
+  // the simple data is written as text in front of the first array, see
+  // block_write(). parse it from a string stream just as block_read() does
+  std::size_t header_size = 0;
+  while (header_size+1 < std::min<std::size_t>(file_size, 256) &&
+         !(data[header_size] == ']' && data[header_size+1] == '['))
+    ++header_size;
+  AssertThrow (header_size+1 < file_size &&
+               data[header_size] == ']' && data[header_size+1] == '[',
+               ExcIO());
+
+  std::istringstream in (std::string (data, header_size));
+  char c;
+  in >> c;
+  AssertThrow (c == '[', ExcIO());
+  in >> max_dim
+     >> rows
+     >> cols
+     >> max_vec_len
+     >> max_row_length
+     >> compressed
+     >> store_diagonal_first_in_row;
+  AssertThrow (in, ExcIO());
+  header_size += 2;
+
+  const std::size_t rowstart_bytes = (max_dim+1) * sizeof(std::size_t);
+  const std::size_t colnums_bytes = max_vec_len * sizeof(size_type);
+  AssertThrow (file_size == header_size + rowstart_bytes + 2 + colnums_bytes + 1,
+               ExcIO());
+  AssertThrow (data[header_size+rowstart_bytes] == ']' &&
+               data[header_size+rowstart_bytes+1] == '[' &&
+               data[file_size-1] == ']',
+               ExcIO());
+
+  // reallocate space
+  rowstart.reset (new std::size_t[max_dim+1]);
+  colnums.reset (new size_type[max_vec_len]);
+
+  // then copy the data
+  std::memcpy (rowstart.get(), data + header_size, rowstart_bytes);
+  std::memcpy (colnums.get(), data + header_size + rowstart_bytes + 2,
+               colnums_bytes);
+}
+
+
+
 std::size_t
 SparsityPattern::memory_consumption () const
 {
@@ -15,6 +15,7 @@
 
 
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/graph_coloring.h>
 #include <deal.II/lac/exceptions.h>
 #include <deal.II/lac/sparsity_pattern.h>
 #include <deal.II/lac/sparsity_tools.h>
@@ -48,6 +49,17 @@ namespace SparsityTools
   void partition (const SparsityPattern     &sparsity_pattern,
                   const unsigned int         n_partitions,
                   std::vector<unsigned int> &partition_indices)
+  {
+    partition (sparsity_pattern, std::vector<unsigned int>(),
+               n_partitions, partition_indices);
+  }
+
+
+
+  void partition (const SparsityPattern           &sparsity_pattern,
+                  const std::vector<unsigned int> &node_weights,
+                  const unsigned int               n_partitions,
+                  std::vector<unsigned int>       &partition_indices)
   {
     Assert (sparsity_pattern.n_rows()==sparsity_pattern.n_cols(),
             ExcNotQuadratic());
@@ -58,6 +70,10 @@ namespace SparsityTools
     Assert (partition_indices.size() == sparsity_pattern.n_rows(),
             ExcInvalidArraySize (partition_indices.size(),
                                  sparsity_pattern.n_rows()));
+    Assert (node_weights.size() == 0 ||
+            node_weights.size() == sparsity_pattern.n_rows(),
+            ExcInvalidArraySize (node_weights.size(),
+                                 sparsity_pattern.n_rows()));
 
     // check for an easy return
     if (n_partitions == 1 || (sparsity_pattern.n_rows()==1))
@@ -70,6 +86,7 @@ namespace SparsityTools
     // installed and detected
 #ifndef DEAL_II_WITH_METIS
     (void)sparsity_pattern;
+    (void)node_weights;
     AssertThrow (false, ExcMETISNotInstalled());
 #else
 
@@ -110,6 +127,13 @@ namespace SparsityTools
         int_rowstart.push_back(int_colnums.size());
       }
 
+    // the weights of the nodes, if any; METIS interprets a null pointer
+    // as all nodes having the same weight
+    std::vector<idx_t> int_node_weights (node_weights.begin(),
+                                         node_weights.end());
+    idx_t *vwgt = (int_node_weights.size() > 0 ?
+                   int_node_weights.data() : nullptr);
+
     std::vector<idx_t> int_partition_indices (sparsity_pattern.n_rows());
 
     // Make use of METIS' error code.
@@ -120,14 +144,14 @@ namespace SparsityTools
     // Use recursive if the number of partitions is less than or equal to 8
     if (nparts <= 8)
       ierr = METIS_PartGraphRecursive(&n, &ncon, int_rowstart.data(), int_colnums.data(),
-                                      nullptr, nullptr, nullptr,
+                                      vwgt, nullptr, nullptr,
                                       &nparts,nullptr,nullptr,options,
                                       &dummy,int_partition_indices.data());
 
     // Otherwise use kway
     else
       ierr = METIS_PartGraphKway(&n, &ncon, int_rowstart.data(), int_colnums.data(),
-                                 nullptr, nullptr, nullptr,
+                                 vwgt, nullptr, nullptr,
                                  &nparts,nullptr,nullptr,options,
                                  &dummy,int_partition_indices.data());
 
@@ -500,6 +524,56 @@ namespace SparsityTools
 
 
 
+  void
+  color_sparsity_pattern (const SparsityPattern                                  &sparsity_pattern,
+                          std::vector<std::vector<SparsityPattern::size_type> > &colors)
+  {
+    Assert (sparsity_pattern.n_rows()==sparsity_pattern.n_cols(),
+            ExcNotQuadratic());
+    Assert (sparsity_pattern.is_compressed(),
+            SparsityPattern::ExcNotCompressed());
+
+    typedef SparsityPattern::size_type size_type;
+
+    colors.clear();
+    if (sparsity_pattern.n_rows() == 0)
+      return;
+
+    // GraphColoring works on ranges of iterators, so set up a list of all
+    // rows and color iterators into that list
+    std::vector<size_type> rows (sparsity_pattern.n_rows());
+    for (size_type row=0; row<rows.size(); ++row)
+      rows[row] = row;
+
+    typedef std::vector<size_type>::const_iterator Iterator;
+    const std::function<std::vector<types::global_dof_index> (const Iterator &)>
+    get_conflict_indices = [&sparsity_pattern] (const Iterator &row)
+    {
+      std::vector<types::global_dof_index> indices;
+      indices.reserve (sparsity_pattern.row_length(*row));
+      for (SparsityPattern::iterator p=sparsity_pattern.begin(*row);
+           p != sparsity_pattern.end(*row); ++p)
+        indices.push_back (p->column());
+      return indices;
+    };
+
+    const std::vector<std::vector<Iterator> > coloring
+      = GraphColoring::make_graph_coloring (Iterator(rows.begin()),
+                                            Iterator(rows.end()),
+                                            get_conflict_indices);
+
+    colors.resize (coloring.size());
+    for (unsigned int c=0; c<coloring.size(); ++c)
+      {
+        colors[c].reserve (coloring[c].size());
+        for (unsigned int i=0; i<coloring[c].size(); ++i)
+          colors[c].push_back (*coloring[c][i]);
+        std::sort (colors[c].begin(), colors[c].end());
+      }
+  }
+
+
+
 #ifdef DEAL_II_WITH_MPI
   void distribute_sparsity_pattern
   (DynamicSparsityPattern                               &dsp,
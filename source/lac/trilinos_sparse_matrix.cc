@@ -603,17 +603,21 @@ namespace TrilinosWrappers
              ExcMessage("Locally relevant rows of sparsity pattern must contain "
                         "all locally owned rows"));
 
+      // get the relevant rows as a vector once, since looking up the n-th
+      // index in the set is not a constant time operation
+      std::vector<dealii::types::global_dof_index> relevant_row_indices;
+      relevant_rows.fill_index_vector(relevant_row_indices);
+
       // check whether the relevant rows correspond to exactly the same map as
       // the owned rows. In that case, do not create the nonlocal graph and
       // fill the columns by demand
       bool have_ghost_rows = false;
       {
-        std::vector<dealii::types::global_dof_index> indices;
-        relevant_rows.fill_index_vector(indices);
+        std::vector<TrilinosWrappers::types::int_type>
+        indices (relevant_row_indices.begin(), relevant_row_indices.end());
         Epetra_Map relevant_map (TrilinosWrappers::types::int_type(-1),
                                  TrilinosWrappers::types::int_type(relevant_rows.n_elements()),
-                                 (indices.empty() ? nullptr :
-                                  reinterpret_cast<TrilinosWrappers::types::int_type *>(indices.data())),
+                                 (indices.empty() ? nullptr : indices.data()),
                                  0, input_row_map.Comm());
         if (relevant_map.SameAs(input_row_map))
           have_ghost_rows = false;
@@ -621,20 +625,26 @@ namespace TrilinosWrappers
           have_ghost_rows = true;
       }
 
+      // compute the lengths of all relevant rows, which are needed twice
+      // below
       const unsigned int n_rows = relevant_rows.n_elements();
+      std::vector<int> row_lengths (n_rows);
+      for (unsigned int i=0; i<n_rows; ++i)
+        row_lengths[i] = sparsity_pattern.row_length(relevant_row_indices[i]);
+
       std::vector<TrilinosWrappers::types::int_type> ghost_rows;
       std::vector<int> n_entries_per_row(input_row_map.NumMyElements());
       std::vector<int> n_entries_per_ghost_row;
       for (unsigned int i=0, own=0; i<n_rows; ++i)
         {
           const TrilinosWrappers::types::int_type global_row =
-            relevant_rows.nth_index_in_set(i);
+            relevant_row_indices[i];
           if (input_row_map.MyGID(global_row))
-            n_entries_per_row[own++] = sparsity_pattern.row_length(global_row);
-          else if (sparsity_pattern.row_length(global_row) > 0)
+            n_entries_per_row[own++] = row_lengths[i];
+          else if (row_lengths[i] > 0)
             {
               ghost_rows.push_back(global_row);
-              n_entries_per_ghost_row.push_back(sparsity_pattern.row_length(global_row));
+              n_entries_per_ghost_row.push_back(row_lengths[i]);
             }
         }
 
@@ -664,8 +674,8 @@ namespace TrilinosWrappers
       for (unsigned int i=0; i<n_rows; ++i)
         {
           const TrilinosWrappers::types::int_type global_row =
-            relevant_rows.nth_index_in_set(i);
-          const int row_length = sparsity_pattern.row_length(global_row);
+            relevant_row_indices[i];
+          const int row_length = row_lengths[i];
           if (row_length == 0)
             continue;
 
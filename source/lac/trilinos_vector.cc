@@ -21,6 +21,7 @@
 #  include <deal.II/lac/trilinos_sparse_matrix.h>
 #  include <deal.II/lac/trilinos_parallel_block_vector.h>
 #  include <deal.II/lac/trilinos_index_access.h>
+#  include <deal.II/lac/la_parallel_vector.h>
 
 DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
 #  include <Epetra_Import.h>
@@ -186,6 +187,31 @@ namespace TrilinosWrappers
 
 
 
+    void
+    Vector::reinit_as_view (LinearAlgebra::distributed::Vector<double> &v)
+    {
+      nonlocal_vector.reset();
+
+      const IndexSet &locally_owned = v.locally_owned_elements();
+      Assert (locally_owned.is_ascending_and_one_to_one(v.get_mpi_communicator()),
+              ExcNotImplemented());
+
+      Epetra_Map map = locally_owned.make_trilinos_map (v.get_mpi_communicator(),
+                                                        true);
+
+      // wrap the locally owned part of the array of v, which is stored
+      // contiguously before the ghost elements
+      vector.reset (new Epetra_FEVector(View, map, v.begin(),
+                                        static_cast<int>(v.local_size()), 1));
+
+      has_ghosts = false;
+      owned_elements = locally_owned;
+      compressed = true;
+      last_action = Zero;
+    }
+
+
+
     void
     Vector::reinit (const Vector &v,
                     const bool        omit_zeroing_entries,
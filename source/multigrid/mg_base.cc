@@ -38,6 +38,34 @@ MGSmootherBase<VectorType>::apply (const unsigned int level,
 }
 
 
+template <typename VectorType>
+void
+MGTransferBase<VectorType>::prolongate_and_add (const unsigned int to_level,
+                                                VectorType         &dst,
+                                                const VectorType   &src) const
+{
+  VectorType temp;
+  temp.reinit(dst, true);
+  prolongate(to_level, temp, src);
+  dst += temp;
+}
+
+
+
+template <typename VectorType>
+void
+MGTransferBase<VectorType>::restrict_residual_and_add
+(const unsigned int from_level,
+ VectorType         &dst,
+ const VectorType   &rhs,
+ VectorType         &matrix_times_solution) const
+{
+  matrix_times_solution.sadd(-1.0, 1.0, rhs);
+  restrict_and_add(from_level, dst, matrix_times_solution);
+}
+
+
+
 // Explicit instantiations
 
 #include "mg_base.inst"
@@ -0,0 +1,371 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/multigrid/mg_coarse_agglomeration.h>
+
+#include <algorithm>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <typename Number>
+MGCoarseGridAgglomeration<Number>::MGCoarseGridAgglomeration ()
+  :
+  mpi_communicator (MPI_COMM_SELF),
+  sub_communicator (MPI_COMM_SELF),
+  active (false),
+  original_local_size (0)
+{}
+
+
+
+template <typename Number>
+MGCoarseGridAgglomeration<Number>::~MGCoarseGridAgglomeration ()
+{
+  clear();
+}
+
+
+
+template <typename Number>
+void
+MGCoarseGridAgglomeration<Number>::clear ()
+{
+  coarse_grid_solver = nullptr;
+  agglomerated_src.reinit(0);
+  agglomerated_dst.reinit(0);
+  agglomerated_partitioner.reset();
+  original_chunks.clear();
+  agglomerated_chunks.clear();
+  original_local_size = 0;
+
+#ifdef DEAL_II_WITH_MPI
+  if (active)
+    {
+      // the destructor might run after MPI_Finalize for objects with static
+      // lifetime, in which case the communicator is already gone
+      int finalized;
+      MPI_Finalized(&finalized);
+      if (!finalized)
+        {
+          const int ierr = MPI_Comm_free(&sub_communicator);
+          AssertThrowMPI(ierr);
+        }
+    }
+#endif
+  sub_communicator = MPI_COMM_SELF;
+  active = false;
+}
+
+
+
+template <typename Number>
+void
+MGCoarseGridAgglomeration<Number>::initialize
+(const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner,
+ const unsigned int n_target_processes)
+{
+  clear();
+
+  mpi_communicator = partitioner->get_mpi_communicator();
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes(mpi_communicator);
+  const unsigned int my_pid = Utilities::MPI::this_mpi_process(mpi_communicator);
+  AssertThrow (n_target_processes >= 1 && n_target_processes <= n_procs,
+               ExcMessage("The number of target processes must be between one "
+                          "and the number of processes in the communicator"));
+  Assert (partitioner->locally_owned_range().is_contiguous(),
+          ExcMessage("The locally owned unknowns must form a contiguous range"));
+
+  // collect the start of the local range of all processes
+  original_local_size = partitioner->local_size();
+  std::vector<types::global_dof_index> original_starts(n_procs+1, 0);
+#ifdef DEAL_II_WITH_MPI
+  {
+    types::global_dof_index my_size = original_local_size;
+    const int ierr = MPI_Allgather(&my_size, 1, DEAL_II_DOF_INDEX_MPI_TYPE,
+                                   &original_starts[1], 1,
+                                   DEAL_II_DOF_INDEX_MPI_TYPE,
+                                   mpi_communicator);
+    AssertThrowMPI(ierr);
+    for (unsigned int p=0; p<n_procs; ++p)
+      original_starts[p+1] += original_starts[p];
+  }
+#else
+  original_starts[1] = original_local_size;
+#endif
+  const types::global_dof_index size = partitioner->size();
+  AssertDimension (original_starts[n_procs], size);
+  Assert (original_local_size == 0 ||
+          original_starts[my_pid] == partitioner->local_range().first,
+          ExcMessage("The local ranges must be ordered by the process rank"));
+
+  std::vector<types::global_dof_index> agglomerated_starts(n_procs+1, size);
+  for (unsigned int p=0; p<n_target_processes; ++p)
+    agglomerated_starts[p] = size * p / n_target_processes;
+
+  // intersect the local ranges of the two layouts
+  const types::global_dof_index my_begin = original_starts[my_pid];
+  const types::global_dof_index my_end = original_starts[my_pid+1];
+  for (unsigned int p=0; p<n_target_processes; ++p)
+    {
+      const types::global_dof_index begin = std::max(my_begin, agglomerated_starts[p]);
+      const types::global_dof_index end = std::min(my_end, agglomerated_starts[p+1]);
+      if (begin < end)
+        original_chunks.push_back
+        (Chunk {{p, static_cast<unsigned int>(begin-my_begin),
+                 static_cast<unsigned int>(end-begin)
+                }
+               });
+    }
+
+  active = (my_pid < n_target_processes);
+  if (active)
+    {
+      const types::global_dof_index my_agglomerated_begin = agglomerated_starts[my_pid];
+      const types::global_dof_index my_agglomerated_end = agglomerated_starts[my_pid+1];
+      for (unsigned int p=0; p<n_procs; ++p)
+        {
+          const types::global_dof_index begin = std::max(my_agglomerated_begin,
+                                                         original_starts[p]);
+          const types::global_dof_index end = std::min(my_agglomerated_end,
+                                                       original_starts[p+1]);
+          if (begin < end)
+            agglomerated_chunks.push_back
+            (Chunk {{p, static_cast<unsigned int>(begin-my_agglomerated_begin),
+                     static_cast<unsigned int>(end-begin)
+                    }
+                   });
+        }
+    }
+
+#ifdef DEAL_II_WITH_MPI
+  const int ierr = MPI_Comm_split(mpi_communicator, active ? 0 : MPI_UNDEFINED,
+                                  my_pid, &sub_communicator);
+  AssertThrowMPI(ierr);
+#else
+  sub_communicator = mpi_communicator;
+#endif
+
+  if (active)
+    {
+      IndexSet owned(size);
+      owned.add_range(agglomerated_starts[my_pid], agglomerated_starts[my_pid+1]);
+      agglomerated_partitioner.reset
+      (new Utilities::MPI::Partitioner(owned, sub_communicator));
+      agglomerated_src.reinit(agglomerated_partitioner);
+      agglomerated_dst.reinit(agglomerated_partitioner);
+    }
+}
+
+
+
+template <typename Number>
+void
+MGCoarseGridAgglomeration<Number>::set_coarse_grid_solver
+(const MGCoarseGridBase<VectorType> &solver)
+{
+  coarse_grid_solver = &solver;
+}
+
+
+
+template <typename Number>
+bool
+MGCoarseGridAgglomeration<Number>::is_active () const
+{
+  return active;
+}
+
+
+
+template <typename Number>
+const MPI_Comm &
+MGCoarseGridAgglomeration<Number>::get_communicator () const
+{
+  Assert (active, ExcMessage("The subcommunicator is only available on the "
+                             "active processes"));
+  return sub_communicator;
+}
+
+
+
+template <typename Number>
+const std::shared_ptr<const Utilities::MPI::Partitioner> &
+MGCoarseGridAgglomeration<Number>::get_partitioner () const
+{
+  Assert (active, ExcMessage("The agglomerated layout is only available on "
+                             "the active processes"));
+  return agglomerated_partitioner;
+}
+
+
+
+template <typename Number>
+void
+MGCoarseGridAgglomeration<Number>::exchange
+(const std::vector<Chunk> &send_chunks,
+ const Number             *send_data,
+ const std::vector<Chunk> &receive_chunks,
+ Number                   *receive_data) const
+{
+#ifdef DEAL_II_WITH_MPI
+  const unsigned int my_pid = Utilities::MPI::this_mpi_process(mpi_communicator);
+  const int mpi_tag = 4122;
+
+  std::vector<MPI_Request> requests;
+  requests.reserve(send_chunks.size()+receive_chunks.size());
+  const Chunk *local_receive = nullptr;
+  for (unsigned int i=0; i<receive_chunks.size(); ++i)
+    if (receive_chunks[i][0] == my_pid)
+      local_receive = &receive_chunks[i];
+    else
+      {
+        requests.push_back(MPI_Request());
+        const int ierr = MPI_Irecv(receive_data+receive_chunks[i][1],
+                                   receive_chunks[i][2]*sizeof(Number), MPI_BYTE,
+                                   receive_chunks[i][0], mpi_tag,
+                                   mpi_communicator, &requests.back());
+        AssertThrowMPI(ierr);
+      }
+
+  for (unsigned int i=0; i<send_chunks.size(); ++i)
+    if (send_chunks[i][0] == my_pid)
+      {
+        Assert (local_receive != nullptr, ExcInternalError());
+        AssertDimension (send_chunks[i][2], (*local_receive)[2]);
+        std::copy(send_data+send_chunks[i][1],
+                  send_data+send_chunks[i][1]+send_chunks[i][2],
+                  receive_data+(*local_receive)[1]);
+      }
+    else
+      {
+        requests.push_back(MPI_Request());
+        const int ierr = MPI_Isend(const_cast<Number *>(send_data+send_chunks[i][1]),
+                                   send_chunks[i][2]*sizeof(Number), MPI_BYTE,
+                                   send_chunks[i][0], mpi_tag,
+                                   mpi_communicator, &requests.back());
+        AssertThrowMPI(ierr);
+      }
+
+  if (requests.size() > 0)
+    {
+      const int ierr = MPI_Waitall(requests.size(), requests.data(),
+                                   MPI_STATUSES_IGNORE);
+      AssertThrowMPI(ierr);
+    }
+#else
+  // in serial, both layouts consist of one chunk of the whole vector
+  for (unsigned int i=0; i<send_chunks.size(); ++i)
+    std::copy(send_data+send_chunks[i][1],
+              send_data+send_chunks[i][1]+send_chunks[i][2],
+              receive_data+receive_chunks[i][1]);
+#endif
+}
+
+
+
+template <typename Number>
+void
+MGCoarseGridAgglomeration<Number>::gather (VectorType       &dst,
+                                           const VectorType &src) const
+{
+  AssertDimension (src.local_size(), original_local_size);
+  if (active)
+    {
+      AssertDimension (dst.local_size(), agglomerated_partitioner->local_size());
+      dst.zero_out_ghosts();
+    }
+  exchange(original_chunks, src.begin(),
+           agglomerated_chunks, active ? dst.begin() : nullptr);
+}
+
+
+
+template <typename Number>
+void
+MGCoarseGridAgglomeration<Number>::scatter (VectorType       &dst,
+                                            const VectorType &src) const
+{
+  AssertDimension (dst.local_size(), original_local_size);
+  if (active)
+    AssertDimension (src.local_size(), agglomerated_partitioner->local_size());
+  dst.zero_out_ghosts();
+  exchange(agglomerated_chunks, active ? src.begin() : nullptr,
+           original_chunks, dst.begin());
+}
+
+
+
+template <typename Number>
+void
+MGCoarseGridAgglomeration<Number>::operator() (const unsigned int level,
+                                               VectorType         &dst,
+                                               const VectorType   &src) const
+{
+  gather(agglomerated_src, src);
+  if (active)
+    {
+      Assert (coarse_grid_solver != nullptr,
+              ExcMessage("The coarse grid solver has not been set"));
+      agglomerated_dst = Number();
+      (*coarse_grid_solver)(level, agglomerated_dst, agglomerated_src);
+    }
+  scatter(dst, agglomerated_dst);
+}
+
+
+
+template <typename Number>
+unsigned int
+MGCoarseGridAgglomeration<Number>::suggest_n_target_processes
+(const types::global_dof_index n_global_items,
+ const unsigned int            min_items_per_process,
+ const MPI_Comm               &mpi_communicator)
+{
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes(mpi_communicator);
+  if (min_items_per_process == 0)
+    return n_procs;
+  const types::global_dof_index n_target = n_global_items / min_items_per_process;
+  return std::max(1U, static_cast<unsigned int>
+                  (std::min<types::global_dof_index>(n_target, n_procs)));
+}
+
+
+
+template <typename Number>
+std::size_t
+MGCoarseGridAgglomeration<Number>::memory_consumption () const
+{
+  std::size_t memory = sizeof(*this);
+  memory += MemoryConsumption::memory_consumption(original_chunks);
+  memory += MemoryConsumption::memory_consumption(agglomerated_chunks);
+  memory += agglomerated_src.memory_consumption();
+  memory += agglomerated_dst.memory_consumption();
+  if (agglomerated_partitioner.get() != nullptr)
+    memory += agglomerated_partitioner->memory_consumption();
+  return memory;
+}
+
+
+
+// explicit instantiations
+template class MGCoarseGridAgglomeration<float>;
+template class MGCoarseGridAgglomeration<double>;
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -14,6 +14,7 @@
 // ---------------------------------------------------------------------
 
 #include <deal.II/base/logstream.h>
+#include <deal.II/base/multithread_info.h>
 #include <deal.II/base/thread_management.h>
 #include <deal.II/lac/sparsity_pattern.h>
 #include <deal.II/lac/block_sparsity_pattern.h>
@@ -1016,6 +1017,228 @@ namespace MGTools
 
 
 
+  namespace internal
+  {
+    namespace
+    {
+      /**
+       * Build the sparsity pattern of one level with exact row lengths. The
+       * dof indices of the cells and of their neighbors on the level are
+       * collected first. Then the rows are split into one range per thread,
+       * and each task collects the entries of the rows in its range. Once
+       * the length of all rows is known, @p sparsity is sized exactly and the
+       * rows are filled, again in parallel since the rows are disjoint.
+       *
+       * Only the couplings between the dofs @p i and @p j of a cell for which
+       * <tt>entry_filter(i,j)</tt> is true are added.
+       */
+      template <int dim, int spacedim, typename EntryFilter>
+      void
+      build_level_sparsity_pattern (const DoFHandler<dim,spacedim> &dof,
+                                    const unsigned int              level,
+                                    const bool                      add_face_couplings,
+                                    const EntryFilter              &entry_filter,
+                                    SparsityPattern                &sparsity)
+      {
+        const types::global_dof_index n_dofs = dof.n_dofs(level);
+        const unsigned int dofs_per_cell = dof.get_fe().dofs_per_cell;
+
+        // The dof indices of all locally owned cells of the level, and for
+        // each face with a neighbor on the same level the index of the cell,
+        // the dof indices of the neighbor and whether the neighbor is owned
+        // by another processor (in which case its rows get the couplings
+        // over this face as well)
+        std::vector<types::global_dof_index> cell_dofs;
+        std::vector<unsigned int> face_cells;
+        std::vector<types::global_dof_index> neighbor_dofs;
+        std::vector<bool> neighbor_is_ghost;
+
+        std::vector<types::global_dof_index> dofs_on_this_cell(dofs_per_cell);
+        for (typename DoFHandler<dim,spacedim>::cell_iterator cell = dof.begin(level);
+             cell != dof.end(level); ++cell)
+          if (cell->is_locally_owned_on_level())
+            {
+              const unsigned int cell_index = cell_dofs.size() / dofs_per_cell;
+              cell->get_mg_dof_indices (dofs_on_this_cell);
+              cell_dofs.insert (cell_dofs.end(),
+                                dofs_on_this_cell.begin(), dofs_on_this_cell.end());
+
+              if (add_face_couplings)
+                for (unsigned int face=0; face<GeometryInfo<dim>::faces_per_cell; ++face)
+                  if (((! cell->at_boundary(face)) &&
+                       (static_cast<unsigned int>(cell->neighbor_level(face)) == level))
+                      ||
+                      (cell->has_periodic_neighbor(face) &&
+                       (static_cast<unsigned int>(cell->periodic_neighbor_level(face)) == level)))
+                    {
+                      const typename DoFHandler<dim,spacedim>::cell_iterator
+                      neighbor = cell->neighbor_or_periodic_neighbor(face);
+                      neighbor->get_mg_dof_indices (dofs_on_this_cell);
+                      face_cells.push_back (cell_index);
+                      neighbor_dofs.insert (neighbor_dofs.end(),
+                                            dofs_on_this_cell.begin(), dofs_on_this_cell.end());
+                      neighbor_is_ghost.push_back (neighbor->is_locally_owned_on_level() == false);
+                    }
+            }
+
+        const unsigned int n_cells = cell_dofs.size() / dofs_per_cell;
+        const unsigned int n_chunks
+          = std::max<types::global_dof_index> (std::min<types::global_dof_index>
+                                               (MultithreadInfo::n_threads(), n_dofs),
+                                               1);
+        const types::global_dof_index chunk_size = (n_dofs + n_chunks - 1) / n_chunks;
+
+        // the column indices of each row, collected for each range of rows
+        std::vector<std::vector<std::vector<types::global_dof_index> > > rows (n_chunks);
+
+        const auto collect_rows = [&] (const unsigned int chunk)
+        {
+          const types::global_dof_index begin = chunk * chunk_size;
+          const types::global_dof_index end = std::min (begin + chunk_size, n_dofs);
+          std::vector<std::vector<types::global_dof_index> > &my_rows = rows[chunk];
+          my_rows.resize (end > begin ? end - begin : 0);
+
+          const auto add_block = [&] (const types::global_dof_index *row_dofs,
+                                      const types::global_dof_index *col_dofs)
+          {
+            for (unsigned int i=0; i<dofs_per_cell; ++i)
+              if (row_dofs[i] >= begin && row_dofs[i] < end)
+                for (unsigned int j=0; j<dofs_per_cell; ++j)
+                  if (entry_filter (row_dofs[i], col_dofs[j]))
+                    my_rows[row_dofs[i]-begin].push_back (col_dofs[j]);
+          };
+
+          for (unsigned int c=0; c<n_cells; ++c)
+            {
+              const types::global_dof_index *dofs = &cell_dofs[c*dofs_per_cell];
+              add_block (dofs, dofs);
+            }
+
+          for (unsigned int f=0; f<face_cells.size(); ++f)
+            {
+              const types::global_dof_index *dofs = &cell_dofs[face_cells[f]*dofs_per_cell];
+              const types::global_dof_index *other_dofs = &neighbor_dofs[f*dofs_per_cell];
+              add_block (dofs, other_dofs);
+              if (neighbor_is_ghost[f])
+                {
+                  add_block (other_dofs, other_dofs);
+                  add_block (other_dofs, dofs);
+                }
+            }
+
+          for (unsigned int r=0; r<my_rows.size(); ++r)
+            {
+              std::sort (my_rows[r].begin(), my_rows[r].end());
+              my_rows[r].erase (std::unique (my_rows[r].begin(), my_rows[r].end()),
+                                my_rows[r].end());
+            }
+        };
+
+        Threads::TaskGroup<> collect_tasks;
+        for (unsigned int chunk=0; chunk<n_chunks; ++chunk)
+          collect_tasks += Threads::new_task ([&collect_rows, chunk] ()
+          {
+            collect_rows (chunk);
+          });
+        collect_tasks.join_all ();
+
+        std::vector<unsigned int> row_lengths (n_dofs);
+        for (unsigned int chunk=0; chunk<n_chunks; ++chunk)
+          for (unsigned int r=0; r<rows[chunk].size(); ++r)
+            row_lengths[chunk*chunk_size+r] = rows[chunk][r].size();
+        sparsity.reinit (n_dofs, n_dofs, row_lengths);
+
+        Threads::TaskGroup<> fill_tasks;
+        for (unsigned int chunk=0; chunk<n_chunks; ++chunk)
+          fill_tasks += Threads::new_task ([&sparsity, &rows, chunk, chunk_size] ()
+          {
+            std::vector<std::vector<types::global_dof_index> > &my_rows = rows[chunk];
+            for (unsigned int r=0; r<my_rows.size(); ++r)
+              {
+                sparsity.add_entries (chunk*chunk_size+r,
+                                      my_rows[r].begin(), my_rows[r].end(),
+                                      true);
+                std::vector<types::global_dof_index>().swap (my_rows[r]);
+              }
+          });
+        fill_tasks.join_all ();
+
+        sparsity.compress ();
+      }
+
+
+
+      /**
+       * Resize @p sparsity to the levels of @p dof and build the pattern of
+       * each level with build_level_sparsity_pattern() in a task of its own.
+       * The entry filter is called with the level as its first argument.
+       */
+      template <int dim, int spacedim, typename EntryFilter>
+      void
+      build_all_level_sparsity_patterns (const DoFHandler<dim,spacedim> &dof,
+                                         const bool                      add_face_couplings,
+                                         const EntryFilter              &entry_filter,
+                                         MGLevelObject<SparsityPattern> &sparsity)
+      {
+        const unsigned int n_levels = dof.get_triangulation().n_global_levels();
+        sparsity.resize (0, n_levels-1);
+
+        Threads::TaskGroup<> tasks;
+        for (unsigned int level=0; level<n_levels; ++level)
+          tasks += Threads::new_task ([&, level] ()
+          {
+            build_level_sparsity_pattern
+            (dof, level, add_face_couplings,
+             [&entry_filter, level] (const types::global_dof_index i,
+                                     const types::global_dof_index j)
+            {
+              return entry_filter (level, i, j);
+            },
+            sparsity[level]);
+          });
+        tasks.join_all ();
+      }
+    }
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  make_level_sparsity_patterns (const DoFHandler<dim,spacedim> &dof,
+                                MGLevelObject<SparsityPattern> &sparsity,
+                                const bool                      add_face_couplings)
+  {
+    internal::build_all_level_sparsity_patterns
+    (dof, add_face_couplings,
+     [] (const unsigned int, const types::global_dof_index, const types::global_dof_index)
+    {
+      return true;
+    },
+    sparsity);
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  make_level_interface_sparsity_patterns (const DoFHandler<dim,spacedim> &dof,
+                                          const MGConstrainedDoFs        &mg_constrained_dofs,
+                                          MGLevelObject<SparsityPattern> &sparsity)
+  {
+    internal::build_all_level_sparsity_patterns
+    (dof, false,
+     [&mg_constrained_dofs] (const unsigned int            level,
+                             const types::global_dof_index i,
+                             const types::global_dof_index j)
+    {
+      return mg_constrained_dofs.is_interface_matrix_entry (level, i, j);
+    },
+    sparsity);
+  }
+
+
+
   template <int dim, int spacedim>
   void
   count_dofs_per_component (const DoFHandler<dim,spacedim> &dof_handler,
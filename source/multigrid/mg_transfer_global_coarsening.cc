@@ -0,0 +1,801 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/grid/cell_id.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/multigrid/mg_transfer_global_coarsening.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace
+{
+  template <int dim>
+  MPI_Comm
+  get_communicator (const Triangulation<dim> &tria)
+  {
+    const parallel::Triangulation<dim> *ptria =
+      dynamic_cast<const parallel::Triangulation<dim> *>(&tria);
+    return ptria != nullptr ? ptria->get_communicator() : MPI_COMM_SELF;
+  }
+
+
+
+  // the number of entries used to send a CellId in its binary form
+  const unsigned int n_cell_id_entries = std::tuple_size<CellId::binary_type>::value;
+
+
+
+  template <int dim>
+  void
+  append_cell_id (const CellId                         &id,
+                  std::vector<types::global_dof_index> &buffer)
+  {
+    const CellId::binary_type binary = id.template to_binary<dim>();
+    buffer.insert(buffer.end(), binary.begin(), binary.end());
+  }
+
+
+
+  CellId
+  read_cell_id (const types::global_dof_index *buffer)
+  {
+    CellId::binary_type binary;
+    for (unsigned int i=0; i<n_cell_id_entries; ++i)
+      binary[i] = buffer[i];
+    return CellId(binary);
+  }
+
+
+
+  // the process that collects the information about the cell with the given
+  // id in the rendezvous exchanges. It must only depend on the id such that
+  // the owners of a cell on different triangulations find each other.
+  template <int dim>
+  unsigned int
+  rendezvous_rank (const CellId       &id,
+                   const unsigned int  n_procs)
+  {
+    const CellId::binary_type binary = id.template to_binary<dim>();
+    std::uint64_t hash = 0;
+    for (unsigned int i=0; i<n_cell_id_entries; ++i)
+      hash = hash*1099511628211ULL + binary[i];
+    return hash % n_procs;
+  }
+
+
+
+  // send the data in send_data[p] to process p and return the data
+  // received from all processes
+  std::vector<std::vector<types::global_dof_index> >
+  exchange_data (const std::vector<std::vector<types::global_dof_index> > &send_data,
+                 const MPI_Comm                                           &communicator)
+  {
+    const unsigned int n_procs = Utilities::MPI::n_mpi_processes(communicator);
+    AssertDimension (send_data.size(), n_procs);
+    if (n_procs == 1)
+      return send_data;
+
+    std::vector<std::vector<types::global_dof_index> > receive_data(n_procs);
+#ifdef DEAL_II_WITH_MPI
+    std::vector<int> send_counts(n_procs), send_offsets(n_procs+1, 0);
+    for (unsigned int p=0; p<n_procs; ++p)
+      {
+        send_counts[p] = send_data[p].size();
+        send_offsets[p+1] = send_offsets[p] + send_counts[p];
+      }
+    std::vector<int> receive_counts(n_procs), receive_offsets(n_procs+1, 0);
+    int ierr = MPI_Alltoall(send_counts.data(), 1, MPI_INT,
+                            receive_counts.data(), 1, MPI_INT, communicator);
+    AssertThrowMPI(ierr);
+    for (unsigned int p=0; p<n_procs; ++p)
+      receive_offsets[p+1] = receive_offsets[p] + receive_counts[p];
+
+    std::vector<types::global_dof_index> send_buffer(send_offsets.back());
+    for (unsigned int p=0; p<n_procs; ++p)
+      std::copy(send_data[p].begin(), send_data[p].end(),
+                send_buffer.begin()+send_offsets[p]);
+    std::vector<types::global_dof_index> receive_buffer(receive_offsets.back());
+    ierr = MPI_Alltoallv(send_buffer.data(), send_counts.data(), send_offsets.data(),
+                         DEAL_II_DOF_INDEX_MPI_TYPE,
+                         receive_buffer.data(), receive_counts.data(),
+                         receive_offsets.data(), DEAL_II_DOF_INDEX_MPI_TYPE,
+                         communicator);
+    AssertThrowMPI(ierr);
+
+    for (unsigned int p=0; p<n_procs; ++p)
+      receive_data[p].assign(receive_buffer.begin()+receive_offsets[p],
+                             receive_buffer.begin()+receive_offsets[p+1]);
+#endif
+    return receive_data;
+  }
+}
+
+
+
+template <int dim, typename Number>
+void MGTwoLevelTransfer<dim,Number>::reinit
+(const DoFHandler<dim>  &dof_handler_fine,
+ const DoFHandler<dim>  &dof_handler_coarse,
+ const ConstraintMatrix &constraints_fine,
+ const ConstraintMatrix &constraints_coarse)
+{
+  const FiniteElement<dim> &fe = dof_handler_fine.get_fe();
+  AssertThrow (fe.get_name() == dof_handler_coarse.get_fe().get_name(),
+               ExcNotImplemented("MGTwoLevelTransfer only works with the same "
+                                 "finite element on both levels"));
+  dofs_per_cell = fe.dofs_per_cell;
+
+  const MPI_Comm communicator = get_communicator(dof_handler_fine.get_triangulation());
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes(communicator);
+  std::vector<types::global_dof_index> dof_indices(dofs_per_cell);
+
+  // step 1: the owners of the coarse cells send the unknowns of their cells
+  // to the rendezvous processes
+  std::vector<std::vector<types::global_dof_index> > send_data(n_procs);
+  for (const auto &cell : dof_handler_coarse.active_cell_iterators())
+    if (cell->is_locally_owned())
+      {
+        std::vector<types::global_dof_index> &buffer =
+          send_data[rendezvous_rank<dim>(cell->id(), n_procs)];
+        append_cell_id<dim>(cell->id(), buffer);
+        cell->get_dof_indices(dof_indices);
+        buffer.insert(buffer.end(), dof_indices.begin(), dof_indices.end());
+      }
+  const std::vector<std::vector<types::global_dof_index> > rendezvous_cell_data =
+    exchange_data(send_data, communicator);
+  std::map<CellId, const types::global_dof_index *> rendezvous_cells;
+  for (unsigned int p=0; p<n_procs; ++p)
+    for (unsigned int i=0; i<rendezvous_cell_data[p].size();
+         i += n_cell_id_entries+dofs_per_cell)
+      rendezvous_cells[read_cell_id(&rendezvous_cell_data[p][i])] =
+        &rendezvous_cell_data[p][i+n_cell_id_entries];
+
+  // step 2: the owners of the fine cells ask for the coarse cell that
+  // corresponds to the fine cell, which is either the cell itself or its
+  // parent
+  std::vector<std::vector<CellId> > requested_cells(n_procs);
+  {
+    std::set<CellId> requested;
+    for (auto &buffer : send_data)
+      buffer.clear();
+    for (const auto &cell : dof_handler_fine.active_cell_iterators())
+      if (cell->is_locally_owned())
+        for (unsigned int candidate=0; candidate<2; ++candidate)
+          {
+            if (candidate == 1 && cell->level() == 0)
+              break;
+            const CellId id = candidate == 0 ? cell->id() : cell->parent()->id();
+            if (requested.insert(id).second == false)
+              continue;
+            const unsigned int rank = rendezvous_rank<dim>(id, n_procs);
+            requested_cells[rank].push_back(id);
+            append_cell_id<dim>(id, send_data[rank]);
+          }
+  }
+  const std::vector<std::vector<types::global_dof_index> > requests =
+    exchange_data(send_data, communicator);
+
+  // step 3: the rendezvous processes answer with a flag whether they know
+  // the cell, followed by its unknowns
+  for (unsigned int p=0; p<n_procs; ++p)
+    {
+      send_data[p].clear();
+      for (unsigned int i=0; i<requests[p].size(); i += n_cell_id_entries)
+        {
+          const auto it = rendezvous_cells.find(read_cell_id(&requests[p][i]));
+          if (it == rendezvous_cells.end())
+            send_data[p].push_back(0);
+          else
+            {
+              send_data[p].push_back(1);
+              send_data[p].insert(send_data[p].end(), it->second,
+                                  it->second+dofs_per_cell);
+            }
+        }
+    }
+  const std::vector<std::vector<types::global_dof_index> > answers =
+    exchange_data(send_data, communicator);
+  std::map<CellId, std::vector<types::global_dof_index> > coarse_cells;
+  for (unsigned int p=0; p<n_procs; ++p)
+    {
+      unsigned int position = 0;
+      for (const CellId &id : requested_cells[p])
+        if (answers[p][position++] == 1)
+          {
+            coarse_cells[id].assign(answers[p].begin()+position,
+                                    answers[p].begin()+position+dofs_per_cell);
+            position += dofs_per_cell;
+          }
+      AssertDimension (position, answers[p].size());
+    }
+
+  // step 4: collect the unknowns of the locally owned fine cells and of the
+  // coarse cells they derive from in global numbering
+  std::vector<types::global_dof_index> fine_global_indices;
+  std::vector<types::global_dof_index> coarse_global_indices;
+  child_numbers.clear();
+  for (const auto &cell : dof_handler_fine.active_cell_iterators())
+    if (cell->is_locally_owned())
+      {
+        cell->get_dof_indices(dof_indices);
+        fine_global_indices.insert(fine_global_indices.end(),
+                                   dof_indices.begin(), dof_indices.end());
+
+        auto it = coarse_cells.find(cell->id());
+        unsigned int child_number = numbers::invalid_unsigned_int;
+        if (it == coarse_cells.end() && cell->level() > 0)
+          {
+            it = coarse_cells.find(cell->parent()->id());
+            for (unsigned int c=0; c<cell->parent()->n_children(); ++c)
+              if (cell->parent()->child_index(c) == cell->index())
+                child_number = c;
+          }
+        AssertThrow (it != coarse_cells.end(),
+                     ExcMessage("The coarse triangulation is not obtained by "
+                                "coarsening the cells of the fine triangulation "
+                                "at most once"));
+        coarse_global_indices.insert(coarse_global_indices.end(),
+                                     it->second.begin(), it->second.end());
+        child_numbers.push_back(child_number);
+      }
+
+  // step 5: set up the vectors, where the coarse vector also holds the
+  // entries the locally owned constrained unknowns depend on
+  const IndexSet &owned_fine = dof_handler_fine.locally_owned_dofs();
+  const IndexSet &owned_coarse = dof_handler_coarse.locally_owned_dofs();
+  IndexSet ghost_fine(owned_fine.size());
+  {
+    std::vector<types::global_dof_index> sorted(fine_global_indices);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    ghost_fine.add_indices(sorted.begin(), sorted.end());
+  }
+  ghost_fine.subtract_set(owned_fine);
+
+  IndexSet ghost_coarse(owned_coarse.size());
+  {
+    std::vector<types::global_dof_index> sorted(coarse_global_indices);
+    for (IndexSet::ElementIterator i=owned_coarse.begin(); i!=owned_coarse.end(); ++i)
+      if (constraints_coarse.is_constrained(*i))
+        for (const auto &entry : *constraints_coarse.get_constraint_entries(*i))
+          sorted.push_back(entry.first);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    ghost_coarse.add_indices(sorted.begin(), sorted.end());
+  }
+  ghost_coarse.subtract_set(owned_coarse);
+
+  vec_fine.reinit(owned_fine, ghost_fine, communicator);
+  vec_coarse.reinit(owned_coarse, ghost_coarse, communicator);
+  weights.reinit(vec_fine);
+
+  const Utilities::MPI::Partitioner &partitioner_fine = *vec_fine.get_partitioner();
+  const Utilities::MPI::Partitioner &partitioner_coarse = *vec_coarse.get_partitioner();
+  fine_indices.resize(fine_global_indices.size());
+  for (unsigned int i=0; i<fine_global_indices.size(); ++i)
+    fine_indices[i] = partitioner_fine.global_to_local(fine_global_indices[i]);
+  coarse_indices.resize(coarse_global_indices.size());
+  for (unsigned int i=0; i<coarse_global_indices.size(); ++i)
+    coarse_indices[i] = partitioner_coarse.global_to_local(coarse_global_indices[i]);
+
+  coarse_constrained_indices.clear();
+  coarse_constraint_row_starts.assign(1, 0);
+  coarse_constraint_entries.clear();
+  for (IndexSet::ElementIterator i=owned_coarse.begin(); i!=owned_coarse.end(); ++i)
+    if (constraints_coarse.is_constrained(*i))
+      {
+        coarse_constrained_indices.push_back(partitioner_coarse.global_to_local(*i));
+        for (const auto &entry : *constraints_coarse.get_constraint_entries(*i))
+          coarse_constraint_entries.emplace_back(partitioner_coarse.global_to_local(entry.first),
+                                                 entry.second);
+        coarse_constraint_row_starts.push_back(coarse_constraint_entries.size());
+      }
+
+  fine_constrained_indices.clear();
+  for (IndexSet::ElementIterator i=owned_fine.begin(); i!=owned_fine.end(); ++i)
+    if (constraints_fine.is_constrained(*i))
+      fine_constrained_indices.push_back(partitioner_fine.global_to_local(*i));
+
+  // step 6: the embedding matrices and the weights for averaging the
+  // contributions of several cells
+  prolongation_matrices.clear();
+  if (std::find_if(child_numbers.begin(), child_numbers.end(),
+                   [](const unsigned int c)
+  {
+    return c != numbers::invalid_unsigned_int;
+  }) != child_numbers.end())
+    {
+      prolongation_matrices.resize(GeometryInfo<dim>::max_children_per_cell);
+      for (unsigned int c=0; c<GeometryInfo<dim>::max_children_per_cell; ++c)
+        prolongation_matrices[c].copy_from(fe.get_prolongation_matrix(c));
+    }
+
+  for (unsigned int i=0; i<fine_indices.size(); ++i)
+    weights.local_element(fine_indices[i]) += Number(1.);
+  weights.compress(VectorOperation::add);
+  for (unsigned int i=0; i<weights.local_size(); ++i)
+    weights.local_element(i) = weights.local_element(i) > Number(0.) ?
+                               Number(1.)/weights.local_element(i) : Number(0.);
+  weights.update_ghost_values();
+}
+
+
+
+template <int dim, typename Number>
+void MGTwoLevelTransfer<dim,Number>
+::prolongate (VectorType       &dst,
+              const VectorType &src) const
+{
+  prolongate_to_vec_fine(src);
+  dst.copy_locally_owned_data_from(vec_fine);
+}
+
+
+
+template <int dim, typename Number>
+void MGTwoLevelTransfer<dim,Number>
+::prolongate_and_add (VectorType       &dst,
+                      const VectorType &src) const
+{
+  prolongate_to_vec_fine(src);
+  AssertDimension (dst.local_size(), vec_fine.local_size());
+  for (unsigned int i=0; i<dst.local_size(); ++i)
+    dst.local_element(i) += vec_fine.local_element(i);
+}
+
+
+
+template <int dim, typename Number>
+void MGTwoLevelTransfer<dim,Number>
+::prolongate_to_vec_fine (const VectorType &src) const
+{
+  vec_coarse.copy_locally_owned_data_from(src);
+  vec_coarse.update_ghost_values();
+
+  // resolve the constraints of the locally owned coarse unknowns and
+  // exchange the result with the processes that read them
+  for (unsigned int i=0; i<coarse_constrained_indices.size(); ++i)
+    {
+      Number value = Number();
+      for (unsigned int j=coarse_constraint_row_starts[i];
+           j<coarse_constraint_row_starts[i+1]; ++j)
+        value += vec_coarse.local_element(coarse_constraint_entries[j].first) *
+                 coarse_constraint_entries[j].second;
+      vec_coarse.local_element(coarse_constrained_indices[i]) = value;
+    }
+  vec_coarse.update_ghost_values();
+
+  vec_fine = Number(0.);
+  Vector<Number> coarse_values(dofs_per_cell), fine_values(dofs_per_cell);
+  for (unsigned int cell=0; cell<child_numbers.size(); ++cell)
+    {
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        coarse_values(i) = vec_coarse.local_element(coarse_indices[cell*dofs_per_cell+i]);
+      if (child_numbers[cell] == numbers::invalid_unsigned_int)
+        fine_values = coarse_values;
+      else
+        prolongation_matrices[child_numbers[cell]].vmult(fine_values, coarse_values);
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        {
+          const unsigned int index = fine_indices[cell*dofs_per_cell+i];
+          vec_fine.local_element(index) += fine_values(i) * weights.local_element(index);
+        }
+    }
+  vec_fine.compress(VectorOperation::add);
+}
+
+
+
+template <int dim, typename Number>
+void MGTwoLevelTransfer<dim,Number>
+::restrict_and_add (VectorType       &dst,
+                    const VectorType &src) const
+{
+  vec_fine.copy_locally_owned_data_from(src);
+  for (unsigned int i=0; i<fine_constrained_indices.size(); ++i)
+    vec_fine.local_element(fine_constrained_indices[i]) = Number(0.);
+  vec_fine.update_ghost_values();
+
+  vec_coarse = Number(0.);
+  Vector<Number> coarse_values(dofs_per_cell), fine_values(dofs_per_cell);
+  for (unsigned int cell=0; cell<child_numbers.size(); ++cell)
+    {
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        {
+          const unsigned int index = fine_indices[cell*dofs_per_cell+i];
+          fine_values(i) = vec_fine.local_element(index) * weights.local_element(index);
+        }
+      if (child_numbers[cell] == numbers::invalid_unsigned_int)
+        coarse_values = fine_values;
+      else
+        prolongation_matrices[child_numbers[cell]].Tvmult(coarse_values, fine_values);
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        vec_coarse.local_element(coarse_indices[cell*dofs_per_cell+i]) += coarse_values(i);
+    }
+  vec_coarse.compress(VectorOperation::add);
+
+  // apply the transpose of resolving the constraints, which moves the
+  // entries of constrained unknowns to the unknowns they depend on
+  for (unsigned int i=0; i<coarse_constrained_indices.size(); ++i)
+    {
+      const Number value = vec_coarse.local_element(coarse_constrained_indices[i]);
+      vec_coarse.local_element(coarse_constrained_indices[i]) = Number(0.);
+      for (unsigned int j=coarse_constraint_row_starts[i];
+           j<coarse_constraint_row_starts[i+1]; ++j)
+        vec_coarse.local_element(coarse_constraint_entries[j].first) +=
+          value * coarse_constraint_entries[j].second;
+    }
+  vec_coarse.compress(VectorOperation::add);
+
+  AssertDimension (dst.local_size(), vec_coarse.local_size());
+  for (unsigned int i=0; i<dst.local_size(); ++i)
+    dst.local_element(i) += vec_coarse.local_element(i);
+}
+
+
+
+template <int dim, typename Number>
+std::size_t
+MGTwoLevelTransfer<dim,Number>::memory_consumption () const
+{
+  return MemoryConsumption::memory_consumption(fine_indices) +
+         MemoryConsumption::memory_consumption(coarse_indices) +
+         MemoryConsumption::memory_consumption(child_numbers) +
+         MemoryConsumption::memory_consumption(prolongation_matrices) +
+         weights.memory_consumption() +
+         MemoryConsumption::memory_consumption(coarse_constrained_indices) +
+         MemoryConsumption::memory_consumption(coarse_constraint_row_starts) +
+         MemoryConsumption::memory_consumption(coarse_constraint_entries) +
+         MemoryConsumption::memory_consumption(fine_constrained_indices) +
+         vec_fine.memory_consumption() +
+         vec_coarse.memory_consumption();
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferGlobalCoarsening<dim,Number>
+::build (const MGLevelObject<std::shared_ptr<const MGTwoLevelTransfer<dim,Number> > > &transfers_in,
+         const MGLevelObject<std::shared_ptr<const Utilities::MPI::Partitioner> > &partitioners_in)
+{
+  AssertDimension (transfers_in.min_level(), partitioners_in.min_level());
+  AssertDimension (transfers_in.max_level(), partitioners_in.max_level());
+  transfers.resize(transfers_in.min_level(), transfers_in.max_level());
+  partitioners.resize(partitioners_in.min_level(), partitioners_in.max_level());
+  for (unsigned int level=transfers_in.min_level(); level<=transfers_in.max_level(); ++level)
+    {
+      transfers[level] = transfers_in[level];
+      partitioners[level] = partitioners_in[level];
+    }
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferGlobalCoarsening<dim,Number>
+::prolongate (const unsigned int to_level,
+              VectorType        &dst,
+              const VectorType  &src) const
+{
+  Assert (to_level > transfers.min_level() && to_level <= transfers.max_level(),
+          ExcIndexRange(to_level, transfers.min_level()+1, transfers.max_level()+1));
+  Assert (transfers[to_level].get() != nullptr, ExcNotInitialized());
+  transfers[to_level]->prolongate(dst, src);
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferGlobalCoarsening<dim,Number>
+::prolongate_and_add (const unsigned int to_level,
+                      VectorType        &dst,
+                      const VectorType  &src) const
+{
+  Assert (to_level > transfers.min_level() && to_level <= transfers.max_level(),
+          ExcIndexRange(to_level, transfers.min_level()+1, transfers.max_level()+1));
+  Assert (transfers[to_level].get() != nullptr, ExcNotInitialized());
+  transfers[to_level]->prolongate_and_add(dst, src);
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferGlobalCoarsening<dim,Number>
+::restrict_and_add (const unsigned int from_level,
+                    VectorType        &dst,
+                    const VectorType  &src) const
+{
+  Assert (from_level > transfers.min_level() && from_level <= transfers.max_level(),
+          ExcIndexRange(from_level, transfers.min_level()+1, transfers.max_level()+1));
+  Assert (transfers[from_level].get() != nullptr, ExcNotInitialized());
+  transfers[from_level]->restrict_and_add(dst, src);
+}
+
+
+
+template <int dim, typename Number>
+std::size_t
+MGTransferGlobalCoarsening<dim,Number>::memory_consumption () const
+{
+  std::size_t memory = sizeof(*this);
+  for (unsigned int level=transfers.min_level(); level<=transfers.max_level(); ++level)
+    memory += MemoryConsumption::memory_consumption(transfers[level]) +
+              MemoryConsumption::memory_consumption(partitioners[level]);
+  return memory;
+}
+
+
+
+namespace MGTransferGlobalCoarseningTools
+{
+  namespace
+  {
+#ifdef DEAL_II_WITH_P4EST
+    // describe a boundary face of the coarse mesh in the subcell data
+    inline
+    void
+    add_boundary_face (const Triangulation<1>::face_iterator &,
+                       const std::vector<unsigned int> &,
+                       SubCellData &)
+    {}
+
+
+
+    inline
+    void
+    add_boundary_face (const Triangulation<2>::face_iterator &face,
+                       const std::vector<unsigned int>       &new_vertex_indices,
+                       SubCellData                           &subcell_data)
+    {
+      CellData<1> face_data;
+      for (unsigned int v=0; v<GeometryInfo<2>::vertices_per_face; ++v)
+        face_data.vertices[v] = new_vertex_indices[face->vertex_index(v)];
+      face_data.boundary_id = face->boundary_id();
+      face_data.manifold_id = face->manifold_id();
+      subcell_data.boundary_lines.push_back(face_data);
+    }
+
+
+
+    inline
+    void
+    add_boundary_face (const Triangulation<3>::face_iterator &face,
+                       const std::vector<unsigned int>       &new_vertex_indices,
+                       SubCellData                           &subcell_data)
+    {
+      CellData<2> face_data;
+      for (unsigned int v=0; v<GeometryInfo<3>::vertices_per_face; ++v)
+        face_data.vertices[v] = new_vertex_indices[face->vertex_index(v)];
+      face_data.boundary_id = face->boundary_id();
+      face_data.manifold_id = face->manifold_id();
+      subcell_data.boundary_quads.push_back(face_data);
+    }
+
+
+
+    // create a distributed triangulation with the coarse mesh of @p tria
+    template <int dim>
+    std::shared_ptr<parallel::distributed::Triangulation<dim> >
+    create_coarse_mesh (const parallel::distributed::Triangulation<dim> &tria)
+    {
+      std::shared_ptr<parallel::distributed::Triangulation<dim> > coarse_tria
+      (new parallel::distributed::Triangulation<dim>(tria.get_communicator(),
+                                                      tria.get_mesh_smoothing()));
+
+      std::vector<unsigned int> new_vertex_indices(tria.n_vertices(),
+                                                   numbers::invalid_unsigned_int);
+      std::vector<Point<dim> > vertices;
+      std::vector<CellData<dim> > cells;
+      SubCellData subcell_data;
+      for (typename Triangulation<dim>::cell_iterator cell=tria.begin(0);
+           cell != tria.end(0); ++cell)
+        {
+          CellData<dim> cell_data;
+          for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+            {
+              unsigned int &index = new_vertex_indices[cell->vertex_index(v)];
+              if (index == numbers::invalid_unsigned_int)
+                {
+                  index = vertices.size();
+                  vertices.push_back(cell->vertex(v));
+                }
+              cell_data.vertices[v] = index;
+            }
+          cell_data.material_id = cell->material_id();
+          cell_data.manifold_id = cell->manifold_id();
+          cells.push_back(cell_data);
+
+          for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+            if (cell->face(f)->at_boundary())
+              add_boundary_face(cell->face(f), new_vertex_indices, subcell_data);
+        }
+      coarse_tria->create_triangulation(vertices, cells, subcell_data);
+
+      for (const types::manifold_id id : tria.get_manifold_ids())
+        if (id != numbers::flat_manifold_id)
+          coarse_tria->set_manifold(id, tria.get_manifold(id));
+      return coarse_tria;
+    }
+
+
+
+    // parallel::distributed::Triangulation is not implemented in 1D
+    std::shared_ptr<parallel::distributed::Triangulation<1> >
+    create_coarse_mesh (const parallel::distributed::Triangulation<1> &)
+    {
+      AssertThrow (false, ExcNotImplemented());
+      return std::shared_ptr<parallel::distributed::Triangulation<1> >();
+    }
+
+
+
+    // create the triangulation obtained by coarsening all cells of @p tria
+    // once whose children are all active, with a new partitioning
+    template <int dim>
+    std::shared_ptr<const Triangulation<dim> >
+    create_coarsening (const parallel::distributed::Triangulation<dim> &tria)
+    {
+      const MPI_Comm communicator = tria.get_communicator();
+      const unsigned int n_procs = Utilities::MPI::n_mpi_processes(communicator);
+
+      // a cell of the new triangulation must be refined if it has a child
+      // that is not active in the old one, i.e., if it is an ancestor of an
+      // active cell at a distance of at least two. the owners of the active
+      // cells send these ancestors to the rendezvous processes
+      std::vector<std::vector<types::global_dof_index> > send_data(n_procs);
+      {
+        std::set<CellId> ancestors;
+        for (const auto &cell : tria.active_cell_iterators())
+          if (cell->is_locally_owned() && cell->level() > 1)
+            for (typename Triangulation<dim>::cell_iterator ancestor=cell->parent()->parent();
+                 ; ancestor=ancestor->parent())
+              {
+                if (ancestors.insert(ancestor->id()).second == false)
+                  break;
+                append_cell_id<dim>(ancestor->id(),
+                                    send_data[rendezvous_rank<dim>(ancestor->id(), n_procs)]);
+                if (ancestor->level() == 0)
+                  break;
+              }
+      }
+      const std::vector<std::vector<types::global_dof_index> > refined_data =
+        exchange_data(send_data, communicator);
+      std::set<CellId> refined_cells;
+      for (unsigned int p=0; p<n_procs; ++p)
+        for (unsigned int i=0; i<refined_data[p].size(); i += n_cell_id_entries)
+          refined_cells.insert(read_cell_id(&refined_data[p][i]));
+
+      std::shared_ptr<parallel::distributed::Triangulation<dim> > coarse_tria =
+        create_coarse_mesh(tria);
+      while (true)
+        {
+          // ask the rendezvous processes whether the locally owned cells
+          // need to be refined
+          std::vector<std::vector<typename Triangulation<dim>::active_cell_iterator> >
+          requested_cells(n_procs);
+          for (auto &buffer : send_data)
+            buffer.clear();
+          for (const auto &cell : coarse_tria->active_cell_iterators())
+            if (cell->is_locally_owned())
+              {
+                const unsigned int rank = rendezvous_rank<dim>(cell->id(), n_procs);
+                requested_cells[rank].push_back(cell);
+                append_cell_id<dim>(cell->id(), send_data[rank]);
+              }
+          const std::vector<std::vector<types::global_dof_index> > requests =
+            exchange_data(send_data, communicator);
+          for (unsigned int p=0; p<n_procs; ++p)
+            {
+              send_data[p].clear();
+              for (unsigned int i=0; i<requests[p].size(); i += n_cell_id_entries)
+                send_data[p].push_back(refined_cells.find(read_cell_id(&requests[p][i]))
+                                       != refined_cells.end());
+            }
+          const std::vector<std::vector<types::global_dof_index> > answers =
+            exchange_data(send_data, communicator);
+
+          unsigned int n_flagged_cells = 0;
+          for (unsigned int p=0; p<n_procs; ++p)
+            for (unsigned int i=0; i<requested_cells[p].size(); ++i)
+              if (answers[p][i] == 1)
+                {
+                  requested_cells[p][i]->set_refine_flag();
+                  ++n_flagged_cells;
+                }
+          if (Utilities::MPI::sum(n_flagged_cells, communicator) == 0)
+            break;
+          coarse_tria->execute_coarsening_and_refinement();
+        }
+
+      return coarse_tria;
+    }
+#endif
+
+
+
+    // create the triangulation obtained by coarsening all cells of @p tria
+    // once whose children are all active
+    template <int dim>
+    std::shared_ptr<const Triangulation<dim> >
+    create_coarsening (const Triangulation<dim> &tria)
+    {
+      std::shared_ptr<Triangulation<dim> > coarse_tria(new Triangulation<dim>());
+      coarse_tria->copy_triangulation(tria);
+      for (const auto &cell : coarse_tria->active_cell_iterators())
+        if (cell->level() > 0)
+          cell->set_coarsen_flag();
+      coarse_tria->execute_coarsening_and_refinement();
+      return coarse_tria;
+    }
+  }
+
+
+
+  template <int dim>
+  std::vector<std::shared_ptr<const Triangulation<dim> > >
+  create_geometric_coarsening_sequence (const Triangulation<dim> &fine_triangulation)
+  {
+    bool is_supported =
+      (dynamic_cast<const parallel::Triangulation<dim> *>(&fine_triangulation) == nullptr);
+#ifdef DEAL_II_WITH_P4EST
+    is_supported |=
+      (dynamic_cast<const parallel::distributed::Triangulation<dim> *>(&fine_triangulation) != nullptr);
+#endif
+    AssertThrow (is_supported,
+                 ExcNotImplemented("Only serial triangulations and "
+                                   "parallel::distributed::Triangulation are supported"));
+
+    std::vector<std::shared_ptr<const Triangulation<dim> > > sequence;
+    const Triangulation<dim> *tria = &fine_triangulation;
+    while (tria->n_global_levels() > 1)
+      {
+        const unsigned int n_cells = tria->n_global_active_cells();
+#ifdef DEAL_II_WITH_P4EST
+        if (const parallel::distributed::Triangulation<dim> *tria_distributed =
+              dynamic_cast<const parallel::distributed::Triangulation<dim> *>(tria))
+          sequence.push_back(create_coarsening(*tria_distributed));
+        else
+#endif
+          sequence.push_back(create_coarsening(*tria));
+        tria = sequence.back().get();
+        AssertThrow (tria->n_global_active_cells() < n_cells,
+                     ExcMessage("The triangulation could not be coarsened"));
+      }
+
+    std::reverse(sequence.begin(), sequence.end());
+    return sequence;
+  }
+}
+
+
+
+// explicit instantiation
+#include "mg_transfer_global_coarsening.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -149,11 +149,38 @@ void MGTransferMatrixFree<dim,Number>
               LinearAlgebra::distributed::Vector<Number>       &dst,
               const LinearAlgebra::distributed::Vector<Number> &src) const
 {
-  Assert ((to_level >= 1) && (to_level<=level_dof_indices.size()),
-          ExcIndexRange (to_level, 1, level_dof_indices.size()+1));
+  prolongate_to_ghosted(to_level, src);
+
+  AssertDimension(this->ghosted_level_vector[to_level].local_size(),
+                  dst.local_size());
+  dst.copy_locally_owned_data_from(this->ghosted_level_vector[to_level]);
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferMatrixFree<dim,Number>
+::prolongate_and_add (const unsigned int                           to_level,
+                      LinearAlgebra::distributed::Vector<Number>       &dst,
+                      const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  prolongate_to_ghosted(to_level, src);
 
   AssertDimension(this->ghosted_level_vector[to_level].local_size(),
                   dst.local_size());
+  dst += this->ghosted_level_vector[to_level];
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferMatrixFree<dim,Number>
+::prolongate_to_ghosted (const unsigned int                                to_level,
+                         const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  Assert ((to_level >= 1) && (to_level<=level_dof_indices.size()),
+          ExcIndexRange (to_level, 1, level_dof_indices.size()+1));
+
   AssertDimension(this->ghosted_level_vector[to_level-1].local_size(),
                   src.local_size());
 
@@ -202,7 +229,6 @@ void MGTransferMatrixFree<dim,Number>
                           this->ghosted_level_vector[to_level-1]);
 
   this->ghosted_level_vector[to_level].compress(VectorOperation::add);
-  dst.copy_locally_owned_data_from(this->ghosted_level_vector[to_level]);
 }
 
 
@@ -218,10 +244,47 @@ void MGTransferMatrixFree<dim,Number>
 
   AssertDimension(this->ghosted_level_vector[from_level].local_size(),
                   src.local_size());
+
+  this->ghosted_level_vector[from_level].copy_locally_owned_data_from(src);
+  restrict_ghosted_and_add(from_level, dst);
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferMatrixFree<dim,Number>
+::restrict_residual_and_add (const unsigned int                           from_level,
+                             LinearAlgebra::distributed::Vector<Number>       &dst,
+                             const LinearAlgebra::distributed::Vector<Number> &rhs,
+                             LinearAlgebra::distributed::Vector<Number>       &matrix_times_solution) const
+{
+  Assert ((from_level >= 1) && (from_level<=level_dof_indices.size()),
+          ExcIndexRange (from_level, 1, level_dof_indices.size()+1));
+
+  LinearAlgebra::distributed::Vector<Number> &ghosted_src = this->ghosted_level_vector[from_level];
+  AssertDimension(ghosted_src.local_size(), rhs.local_size());
+  AssertDimension(ghosted_src.local_size(), matrix_times_solution.local_size());
+
+  const unsigned int local_size = ghosted_src.local_size();
+  Number *ghosted_ptr = ghosted_src.begin();
+  const Number *rhs_ptr = rhs.begin();
+  const Number *matrix_times_solution_ptr = matrix_times_solution.begin();
+  for (unsigned int i=0; i<local_size; ++i)
+    ghosted_ptr[i] = rhs_ptr[i] - matrix_times_solution_ptr[i];
+
+  restrict_ghosted_and_add(from_level, dst);
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferMatrixFree<dim,Number>
+::restrict_ghosted_and_add (const unsigned int                          from_level,
+                            LinearAlgebra::distributed::Vector<Number> &dst) const
+{
   AssertDimension(this->ghosted_level_vector[from_level-1].local_size(),
                   dst.local_size());
 
-  this->ghosted_level_vector[from_level].copy_locally_owned_data_from(src);
   this->ghosted_level_vector[from_level].update_ghost_values();
   this->ghosted_level_vector[from_level-1] = 0.;
 
@@ -671,6 +734,51 @@ void MGTransferBlockMatrixFree<dim,Number>
 
 
 
+template <int dim, typename Number>
+void MGTransferBlockMatrixFree<dim,Number>
+::prolongate_and_add (const unsigned int                                    to_level,
+                      LinearAlgebra::distributed::BlockVector<Number>       &dst,
+                      const LinearAlgebra::distributed::BlockVector<Number> &src) const
+{
+  const unsigned int n_blocks = src.n_blocks();
+  AssertDimension(dst.n_blocks(), n_blocks);
+
+  if (!same_for_all)
+    AssertDimension (matrix_free_transfer_vector.size(), n_blocks);
+
+  for (unsigned int b = 0; b < n_blocks; ++b)
+    {
+      const unsigned int data_block = same_for_all ? 0 : b;
+      matrix_free_transfer_vector[data_block].prolongate_and_add(to_level, dst.block(b), src.block(b));
+    }
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferBlockMatrixFree<dim,Number>
+::restrict_residual_and_add (const unsigned int                                    from_level,
+                             LinearAlgebra::distributed::BlockVector<Number>       &dst,
+                             const LinearAlgebra::distributed::BlockVector<Number> &rhs,
+                             LinearAlgebra::distributed::BlockVector<Number>       &matrix_times_solution) const
+{
+  const unsigned int n_blocks = rhs.n_blocks();
+  AssertDimension(dst.n_blocks(), n_blocks);
+  AssertDimension(matrix_times_solution.n_blocks(), n_blocks);
+
+  if (!same_for_all)
+    AssertDimension (matrix_free_transfer_vector.size(), n_blocks);
+
+  for (unsigned int b = 0; b < n_blocks; ++b)
+    {
+      const unsigned int data_block = same_for_all ? 0 : b;
+      matrix_free_transfer_vector[data_block].restrict_residual_and_add
+      (from_level, dst.block(b), rhs.block(b), matrix_times_solution.block(b));
+    }
+}
+
+
+
 template <int dim, typename Number>
 std::size_t
 MGTransferBlockMatrixFree<dim,Number>::memory_consumption() const
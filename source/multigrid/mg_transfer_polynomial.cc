@@ -0,0 +1,354 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/quadrature.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/tensor_product_kernels.h>
+#include <deal.II/multigrid/mg_transfer_polynomial.h>
+
+#include <algorithm>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, typename Number>
+MGTransferPolynomial<dim,Number>::MGTransferPolynomial ()
+  :
+  fe_no_fine (numbers::invalid_unsigned_int),
+  fe_no_coarse (numbers::invalid_unsigned_int)
+{}
+
+
+
+template <int dim, typename Number>
+void MGTransferPolynomial<dim,Number>::clear ()
+{
+  matrix_free.reset();
+  fe_no_fine = numbers::invalid_unsigned_int;
+  fe_no_coarse = numbers::invalid_unsigned_int;
+  shape_info = internal::MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number> >();
+  weights.clear();
+  vec_fine.reinit(0);
+  vec_coarse.reinit(0);
+  evaluation_data.clear();
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferPolynomial<dim,Number>
+::build (const std::shared_ptr<const MatrixFree<dim,Number> > &matrix_free_in,
+         const unsigned int fe_no_fine_in,
+         const unsigned int fe_no_coarse_in)
+{
+  clear();
+  matrix_free = matrix_free_in;
+  fe_no_fine = fe_no_fine_in;
+  fe_no_coarse = fe_no_coarse_in;
+
+  const FiniteElement<dim> &fe_fine = matrix_free->get_dof_handler(fe_no_fine).get_fe();
+  const FiniteElement<dim> &fe_coarse = matrix_free->get_dof_handler(fe_no_coarse).get_fe();
+  AssertThrow (fe_fine.n_components() == 1 && fe_coarse.n_components() == 1,
+               ExcNotImplemented("MGTransferPolynomial only works for scalar "
+                                 "finite elements"));
+  AssertThrow (fe_fine.has_support_points(),
+               ExcMessage("The fine element " + fe_fine.get_name() +
+                          " does not have support points"));
+
+  // the 1D support points of the fine element in lexicographic order are
+  // the points along the first coordinate direction
+  const internal::MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number> > &shape_info_fine
+    = matrix_free->get_shape_info(fe_no_fine);
+  const unsigned int n_fine_dofs_1d = shape_info_fine.fe_degree+1;
+  AssertDimension (Utilities::fixed_power<dim>(n_fine_dofs_1d),
+                   shape_info_fine.dofs_per_component_on_cell);
+  std::vector<Point<1> > fine_points(n_fine_dofs_1d);
+  for (unsigned int i=0; i<n_fine_dofs_1d; ++i)
+    fine_points[i][0] = fe_fine.get_unit_support_points()
+                        [shape_info_fine.lexicographic_numbering[i]][0];
+
+  // the values of the coarse shape functions in the fine support points
+  // make up the 1D prolongation matrix
+  shape_info.reinit(Quadrature<1>(fine_points), fe_coarse);
+  AssertDimension (Utilities::fixed_power<dim>(shape_info.fe_degree+1),
+                   matrix_free->get_shape_info(fe_no_coarse).dofs_per_component_on_cell);
+
+  matrix_free->initialize_dof_vector(vec_fine, fe_no_fine);
+  matrix_free->initialize_dof_vector(vec_coarse, fe_no_coarse);
+
+  // count the number of cells that share each fine degree of freedom,
+  // ignoring constraints
+  const internal::MatrixFreeFunctions::DoFInfo &dof_info
+    = matrix_free->get_dof_info(fe_no_fine);
+  const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+  const unsigned int n_fine_dofs = shape_info_fine.dofs_per_component_on_cell;
+  const unsigned int n_cells = matrix_free->n_macro_cells();
+  for (unsigned int cell=0; cell<n_cells; ++cell)
+    {
+      const unsigned int n_filled = matrix_free->n_components_filled(cell);
+      const unsigned int stride = dof_info.row_starts[cell][2] > 0 ? n_filled : n_lanes;
+      const unsigned int *dof_indices = dof_info.begin_indices_plain(cell);
+      for (unsigned int i=0; i<n_fine_dofs; ++i)
+        for (unsigned int v=0; v<n_filled; ++v)
+          vec_fine.local_element(dof_indices[i*stride+v]) += Number(1.);
+    }
+  vec_fine.compress(VectorOperation::add);
+  vec_fine.update_ghost_values();
+
+  weights.resize(n_cells*n_fine_dofs);
+  FEEvaluation<dim,-1,0,1,Number> phi_fine(*matrix_free, fe_no_fine);
+  for (unsigned int cell=0; cell<n_cells; ++cell)
+    {
+      phi_fine.reinit(cell);
+      phi_fine.read_dof_values_plain(vec_fine);
+      for (unsigned int i=0; i<n_fine_dofs; ++i)
+        {
+          // unfilled lanes have a count of zero, set a weight of zero there
+          const VectorizedArray<Number> count = phi_fine.begin_dof_values()[i];
+          for (unsigned int v=0; v<n_lanes; ++v)
+            weights[cell*n_fine_dofs+i][v] = count[v] > Number(0.) ?
+                                             Number(1.)/count[v] : Number(0.);
+        }
+    }
+  vec_fine = Number(0.);
+
+  const unsigned int n_max_dofs_1d = std::max(n_fine_dofs_1d, shape_info.fe_degree+1);
+  evaluation_data.resize(3*Utilities::fixed_power<dim>(n_max_dofs_1d));
+}
+
+
+
+template <int dim, typename Number>
+template <bool prolongate>
+void MGTransferPolynomial<dim,Number>::apply_tensorized_op () const
+{
+  typedef internal::EvaluatorTensorProduct<internal::evaluate_general,dim,-1,0,VectorizedArray<Number> > Evaluator;
+  Evaluator evaluator (shape_info.shape_values,
+                       shape_info.shape_gradients,
+                       shape_info.shape_hessians,
+                       shape_info.fe_degree,
+                       shape_info.n_q_points_1d);
+
+  // in the FEEvaluation terminology, the coarse unknowns are the degrees of
+  // freedom and the fine unknowns the quadrature points of the evaluator
+  const unsigned int size = evaluation_data.size()/3;
+  VectorizedArray<Number> *t0 = evaluation_data.begin();
+  VectorizedArray<Number> *t1 = evaluation_data.begin()+size;
+  VectorizedArray<Number> *t2 = evaluation_data.begin()+2*size;
+  if (dim == 1)
+    evaluator.template values<0,prolongate,false>(t0, t2);
+  else if (dim == 2)
+    {
+      evaluator.template values<0,prolongate,false>(t0, t1);
+      evaluator.template values<1,prolongate,false>(t1, t2);
+    }
+  else if (dim == 3)
+    {
+      evaluator.template values<0,prolongate,false>(t0, t2);
+      evaluator.template values<1,prolongate,false>(t2, t1);
+      evaluator.template values<2,prolongate,false>(t1, t2);
+    }
+  else
+    Assert(false, ExcNotImplemented());
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferPolynomial<dim,Number>
+::prolongate (VectorType       &dst,
+              const VectorType &src) const
+{
+  Assert (matrix_free.get() != nullptr, ExcNotInitialized());
+  vec_coarse.copy_locally_owned_data_from(src);
+  vec_coarse.update_ghost_values();
+  vec_fine = Number(0.);
+
+  const internal::MatrixFreeFunctions::DoFInfo &dof_info
+    = matrix_free->get_dof_info(fe_no_fine);
+  const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+  const unsigned int n_fine_dofs = Utilities::fixed_power<dim>(shape_info.n_q_points_1d);
+  const unsigned int size = evaluation_data.size()/3;
+
+  FEEvaluation<dim,-1,0,1,Number> phi_coarse(*matrix_free, fe_no_coarse);
+  for (unsigned int cell=0; cell<matrix_free->n_macro_cells(); ++cell)
+    {
+      phi_coarse.reinit(cell);
+      phi_coarse.read_dof_values(vec_coarse);
+      std::copy(phi_coarse.begin_dof_values(),
+                phi_coarse.begin_dof_values()+phi_coarse.dofs_per_cell,
+                evaluation_data.begin());
+
+      apply_tensorized_op<true>();
+
+      // add the weighted values into the fine vector, bypassing constraints
+      const VectorizedArray<Number> *fine_values = evaluation_data.begin()+2*size;
+      const VectorizedArray<Number> *cell_weights = &weights[cell*n_fine_dofs];
+      const unsigned int n_filled = matrix_free->n_components_filled(cell);
+      const unsigned int stride = dof_info.row_starts[cell][2] > 0 ? n_filled : n_lanes;
+      const unsigned int *dof_indices = dof_info.begin_indices_plain(cell);
+      for (unsigned int i=0; i<n_fine_dofs; ++i)
+        {
+          const VectorizedArray<Number> value = fine_values[i] * cell_weights[i];
+          for (unsigned int v=0; v<n_filled; ++v)
+            vec_fine.local_element(dof_indices[i*stride+v]) += value[v];
+        }
+    }
+
+  vec_fine.compress(VectorOperation::add);
+  dst.copy_locally_owned_data_from(vec_fine);
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferPolynomial<dim,Number>
+::restrict_and_add (VectorType       &dst,
+                    const VectorType &src) const
+{
+  Assert (matrix_free.get() != nullptr, ExcNotInitialized());
+  vec_fine.copy_locally_owned_data_from(src);
+  vec_fine.update_ghost_values();
+  vec_coarse = Number(0.);
+
+  const unsigned int n_fine_dofs = Utilities::fixed_power<dim>(shape_info.n_q_points_1d);
+  const unsigned int size = evaluation_data.size()/3;
+
+  FEEvaluation<dim,-1,0,1,Number> phi_fine(*matrix_free, fe_no_fine);
+  FEEvaluation<dim,-1,0,1,Number> phi_coarse(*matrix_free, fe_no_coarse);
+  for (unsigned int cell=0; cell<matrix_free->n_macro_cells(); ++cell)
+    {
+      phi_fine.reinit(cell);
+      phi_fine.read_dof_values_plain(vec_fine);
+      const VectorizedArray<Number> *cell_weights = &weights[cell*n_fine_dofs];
+      for (unsigned int i=0; i<n_fine_dofs; ++i)
+        evaluation_data[i] = phi_fine.begin_dof_values()[i] * cell_weights[i];
+
+      apply_tensorized_op<false>();
+
+      phi_coarse.reinit(cell);
+      std::copy(evaluation_data.begin()+2*size,
+                evaluation_data.begin()+2*size+phi_coarse.dofs_per_cell,
+                phi_coarse.begin_dof_values());
+      phi_coarse.distribute_local_to_global(vec_coarse);
+    }
+
+  vec_coarse.compress(VectorOperation::add);
+  for (unsigned int i=0; i<dst.local_size(); ++i)
+    dst.local_element(i) += vec_coarse.local_element(i);
+}
+
+
+
+template <int dim, typename Number>
+std::size_t
+MGTransferPolynomial<dim,Number>::memory_consumption () const
+{
+  return shape_info.memory_consumption() +
+         MemoryConsumption::memory_consumption(weights) +
+         vec_fine.memory_consumption() +
+         vec_coarse.memory_consumption() +
+         MemoryConsumption::memory_consumption(evaluation_data);
+}
+
+
+
+template <int dim, typename Number>
+MGTransferHybrid<dim,Number>::MGTransferHybrid ()
+  :
+  n_geometric_levels (0)
+{}
+
+
+
+template <int dim, typename Number>
+void MGTransferHybrid<dim,Number>
+::build (const MGTransferMatrixFree<dim,Number> &h_transfer_in,
+         const std::vector<std::shared_ptr<const MGTransferPolynomial<dim,Number> > > &p_transfers_in,
+         const MGTransferMatrixFree<dim,Number> &top_transfer_in,
+         const MGLevelObject<std::shared_ptr<const Utilities::MPI::Partitioner> > &partitioners_in)
+{
+  AssertThrow (partitioners_in.max_level()+1 > p_transfers_in.size(),
+               ExcMessage("The number of polynomial levels exceeds the number "
+                          "of levels of the partitioners"));
+  h_transfer = &h_transfer_in;
+  p_transfers = p_transfers_in;
+  top_transfer = &top_transfer_in;
+  partitioners.resize(partitioners_in.min_level(), partitioners_in.max_level());
+  for (unsigned int level=partitioners_in.min_level();
+       level<=partitioners_in.max_level(); ++level)
+    partitioners[level] = partitioners_in[level];
+  n_geometric_levels = partitioners_in.max_level()+1-p_transfers_in.size();
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferHybrid<dim,Number>
+::prolongate (const unsigned int to_level,
+              VectorType        &dst,
+              const VectorType  &src) const
+{
+  Assert (h_transfer != nullptr, ExcNotInitialized());
+  if (to_level < n_geometric_levels)
+    h_transfer->prolongate(to_level, dst, src);
+  else
+    {
+      AssertIndexRange (to_level-n_geometric_levels, p_transfers.size());
+      p_transfers[to_level-n_geometric_levels]->prolongate(dst, src);
+    }
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferHybrid<dim,Number>
+::restrict_and_add (const unsigned int from_level,
+                    VectorType        &dst,
+                    const VectorType  &src) const
+{
+  Assert (h_transfer != nullptr, ExcNotInitialized());
+  if (from_level < n_geometric_levels)
+    h_transfer->restrict_and_add(from_level, dst, src);
+  else
+    {
+      AssertIndexRange (from_level-n_geometric_levels, p_transfers.size());
+      p_transfers[from_level-n_geometric_levels]->restrict_and_add(dst, src);
+    }
+}
+
+
+
+template <int dim, typename Number>
+std::size_t
+MGTransferHybrid<dim,Number>::memory_consumption () const
+{
+  std::size_t memory = MemoryConsumption::memory_consumption(p_transfers);
+  for (unsigned int level=top_level_vector.min_level();
+       level<=top_level_vector.max_level(); ++level)
+    memory += top_level_vector[level].memory_consumption();
+  return memory;
+}
+
+
+
+// explicit instantiation
+#include "mg_transfer_polynomial.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
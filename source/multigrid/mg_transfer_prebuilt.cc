@@ -80,6 +80,8 @@ void MGTransferPrebuilt<VectorType>::clear ()
   MGLevelGlobalTransfer<VectorType>::clear();
   prolongation_matrices.resize(0);
   prolongation_sparsities.resize(0);
+  restriction_matrices.resize(0);
+  restriction_sparsities.resize(0);
   interface_dofs.resize(0);
 }
 
@@ -98,6 +100,52 @@ void MGTransferPrebuilt<VectorType>::prolongate (const unsigned int to_level,
 
 
 
+template <typename VectorType>
+void MGTransferPrebuilt<VectorType>::prolongate_and_add (const unsigned int to_level,
+                                                         VectorType        &dst,
+                                                         const VectorType  &src) const
+{
+  Assert ((to_level >= 1) && (to_level<=prolongation_matrices.size()),
+          ExcIndexRange (to_level, 1, prolongation_matrices.size()+1));
+
+  prolongation_matrices[to_level-1]->vmult_add (dst, src);
+}
+
+
+
+namespace
+{
+  /**
+   * Helper function for restrict_and_add. Multiplies with the transposed
+   * prolongation matrix if it has been built, which is done in parallel,
+   * and with the transpose of the prolongation matrix otherwise.
+   */
+  template <typename number, typename VectorType>
+  void apply_restriction (const SparseMatrix<number> &prolongation,
+                          const SparseMatrix<number> &restriction,
+                          VectorType                 &dst,
+                          const VectorType           &src)
+  {
+    if (!restriction.empty())
+      restriction.vmult_add (dst, src);
+    else
+      prolongation.Tvmult_add (dst, src);
+  }
+
+
+
+  template <typename MatrixType, typename number, typename VectorType>
+  void apply_restriction (const MatrixType           &prolongation,
+                          const SparseMatrix<number> &,
+                          VectorType                 &dst,
+                          const VectorType           &src)
+  {
+    prolongation.Tvmult_add (dst, src);
+  }
+}
+
+
+
 template <typename VectorType>
 void MGTransferPrebuilt<VectorType>::restrict_and_add (const unsigned int from_level,
                                                        VectorType        &dst,
@@ -107,7 +155,9 @@ void MGTransferPrebuilt<VectorType>::restrict_and_add (const unsigned int from_l
           ExcIndexRange (from_level, 1, prolongation_matrices.size()+1));
   (void)from_level;
 
-  prolongation_matrices[from_level-1]->Tvmult_add (dst, src);
+  apply_restriction (*prolongation_matrices[from_level-1],
+                     *restriction_matrices[from_level-1],
+                     dst, src);
 }
 
 
@@ -131,6 +181,41 @@ namespace
             ind = mg_constrained_dofs->get_level_constraint_matrix(level).get_constraint_entries(ind)->front().first;
           }
   }
+
+
+
+  /**
+   * Helper function for build_matrices. Builds the transpose of a
+   * prolongation matrix of type SparseMatrix, which restrict_and_add()
+   * applies in parallel instead of the sequential Tvmult_add().
+   */
+  template <typename number>
+  void build_transpose (const SparseMatrix<number> &matrix,
+                        SparsityPattern            &transpose_sparsity,
+                        SparseMatrix<number>       &transpose)
+  {
+    DynamicSparsityPattern dsp (matrix.n(), matrix.m());
+    for (auto entry = matrix.begin(); entry != matrix.end(); ++entry)
+      dsp.add (entry->column(), entry->row());
+    transpose_sparsity.copy_from (dsp);
+    dsp.reinit (0,0);
+
+    transpose.reinit (transpose_sparsity);
+    for (auto entry = matrix.begin(); entry != matrix.end(); ++entry)
+      transpose.set (entry->column(), entry->row(), entry->value());
+  }
+
+
+
+  /**
+   * Other matrix types, like the Trilinos matrices, provide a parallel
+   * multiplication with the transpose already, so leave the transpose empty.
+   */
+  template <typename MatrixType, typename number>
+  void build_transpose (const MatrixType &,
+                        SparsityPattern &,
+                        SparseMatrix<number> &)
+  {}
 }
 
 template <typename VectorType>
@@ -159,6 +244,10 @@ void MGTransferPrebuilt<VectorType>::build_matrices
   prolongation_sparsities.resize (0);
   prolongation_matrices.reserve (n_levels - 1);
   prolongation_sparsities.reserve (n_levels - 1);
+  restriction_matrices.resize (0);
+  restriction_sparsities.resize (0);
+  restriction_matrices.reserve (n_levels - 1);
+  restriction_sparsities.reserve (n_levels - 1);
 
   for (unsigned int i=0; i<n_levels-1; ++i)
     {
@@ -166,6 +255,9 @@ void MGTransferPrebuilt<VectorType>::build_matrices
       (new typename internal::MatrixSelector<VectorType>::Sparsity);
       prolongation_matrices.emplace_back
       (new typename internal::MatrixSelector<VectorType>::Matrix);
+      restriction_sparsities.emplace_back (new SparsityPattern);
+      restriction_matrices.emplace_back
+      (new SparseMatrix<typename VectorType::value_type>);
     }
 
   // two fields which will store the
@@ -286,6 +378,10 @@ void MGTransferPrebuilt<VectorType>::build_matrices
               }
           }
       prolongation_matrices[level]->compress(VectorOperation::insert);
+
+      build_transpose (*prolongation_matrices[level],
+                       *restriction_sparsities[level],
+                       *restriction_matrices[level]);
     }
 
   this->fill_and_communicate_copy_indices(mg_dof);
@@ -314,7 +410,9 @@ MGTransferPrebuilt<VectorType>::memory_consumption () const
   std::size_t result = MGLevelGlobalTransfer<VectorType>::memory_consumption();
   for (unsigned int i=0; i<prolongation_matrices.size(); ++i)
     result += prolongation_matrices[i]->memory_consumption()
-              + prolongation_sparsities[i]->memory_consumption();
+              + prolongation_sparsities[i]->memory_consumption()
+              + restriction_matrices[i]->memory_consumption()
+              + restriction_sparsities[i]->memory_consumption();
 
   return result;
 }
@@ -0,0 +1,1051 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/non_matching/quadrature_generator.h>
+
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+
+DEAL_II_NAMESPACE_OPEN
+namespace NonMatching
+{
+  namespace internal
+  {
+    namespace QuadratureGeneratorImplementation
+    {
+      /**
+       * A level set function together with the sign it is required to have
+       * on the region to be integrated over: -1 or +1, or 0 if the function
+       * only splits the region at its roots.
+       */
+      template <int dim>
+      struct SignedFunction
+      {
+        const Function<dim> *function;
+        int sign;
+      };
+
+
+
+      /**
+       * Estimates of the ranges of the values and of the partial derivatives
+       * of a function on a box.
+       */
+      template <int dim>
+      struct FunctionBounds
+      {
+        std::pair<double,double> value;
+        std::array<std::pair<double,double>,dim> gradient;
+      };
+
+
+
+      /**
+       * Estimate the ranges of the values and partial derivatives of @p f
+       * on @p box from the values and gradients at the vertices and the
+       * center of the box. The range of the values additionally contains the
+       * range of the first-order Taylor expansion about the center.
+       */
+      template <int dim>
+      FunctionBounds<dim>
+      estimate_bounds (const Function<dim>     &f,
+                       const BoundingBox<dim> &box)
+      {
+        const std::pair<Point<dim>,Point<dim> > &corners = box.get_boundary_points();
+
+        Point<dim> center;
+        for (unsigned int d=0; d<dim; ++d)
+          center[d] = 0.5 * (corners.first[d] + corners.second[d]);
+
+        const double         center_value = f.value (center);
+        const Tensor<1,dim> center_gradient = f.gradient (center);
+
+        FunctionBounds<dim> bounds;
+        double spread = 0;
+        for (unsigned int d=0; d<dim; ++d)
+          {
+            spread += 0.5 * std::abs(center_gradient[d]) * (corners.second[d] - corners.first[d]);
+            bounds.gradient[d] = std::make_pair (center_gradient[d], center_gradient[d]);
+          }
+        bounds.value = std::make_pair (center_value - spread, center_value + spread);
+
+        for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+          {
+            Point<dim> vertex;
+            for (unsigned int d=0; d<dim; ++d)
+              vertex[d] = (v & (1U << d)) ? corners.second[d] : corners.first[d];
+
+            const double value = f.value (vertex);
+            bounds.value.first = std::min (bounds.value.first, value);
+            bounds.value.second = std::max (bounds.value.second, value);
+
+            const Tensor<1,dim> gradient = f.gradient (vertex);
+            for (unsigned int d=0; d<dim; ++d)
+              {
+                bounds.gradient[d].first = std::min (bounds.gradient[d].first, gradient[d]);
+                bounds.gradient[d].second = std::max (bounds.gradient[d].second, gradient[d]);
+              }
+          }
+        return bounds;
+      }
+
+
+
+      /**
+       * Return +1 or -1 if the range @p range only contains positive or
+       * negative numbers, respectively, and 0 otherwise.
+       */
+      inline
+      int
+      definite_sign (const std::pair<double,double> &range)
+      {
+        if (range.first > 0)
+          return 1;
+        else if (range.second < 0)
+          return -1;
+        else
+          return 0;
+      }
+
+
+
+      /**
+       * Find a coordinate direction in which all the functions with the
+       * bounds @p bounds are monotone and return true, or return false and
+       * the direction in which the functions change the most.
+       */
+      template <int dim>
+      bool
+      find_height_direction (const std::vector<FunctionBounds<dim> > &bounds,
+                             unsigned int                            &direction)
+      {
+        double best_monotone = -1;
+        double best_change = -1;
+        unsigned int change_direction = 0;
+        for (unsigned int d=0; d<dim; ++d)
+          {
+            double smallest_slope = std::numeric_limits<double>::max();
+            double change = 0;
+            for (const FunctionBounds<dim> &b : bounds)
+              {
+                smallest_slope = (definite_sign (b.gradient[d]) == 0 ? 0 :
+                                  std::min (smallest_slope,
+                                            std::min (std::abs(b.gradient[d].first),
+                                                      std::abs(b.gradient[d].second))));
+                change += std::abs(b.gradient[d].first) + std::abs(b.gradient[d].second);
+              }
+            if (smallest_slope > 0 && smallest_slope > best_monotone)
+              {
+                best_monotone = smallest_slope;
+                direction = d;
+              }
+            if (change > best_change)
+              {
+                best_change = change;
+                change_direction = d;
+              }
+          }
+
+        if (best_monotone > 0)
+          return true;
+
+        direction = change_direction;
+        return false;
+      }
+
+
+
+      /**
+       * Return the point in @p dim dimensions that is obtained by inserting
+       * the coordinate @p coordinate in the direction @p direction into
+       * @p point.
+       */
+      template <int dim>
+      Point<dim>
+      lift (const Point<dim-1>  &point,
+            const unsigned int  direction,
+            const double        coordinate)
+      {
+        Point<dim> lifted;
+        for (unsigned int d=0, e=0; d<dim; ++d)
+          lifted[d] = (d == direction ? coordinate : point[e++]);
+        return lifted;
+      }
+
+
+
+      /**
+       * Return the face of @p box that is orthogonal to the direction
+       * @p direction, as a box in one dimension less.
+       */
+      template <int dim>
+      BoundingBox<dim-1>
+      cross_section (const BoundingBox<dim> &box,
+                     const unsigned int      direction)
+      {
+        const std::pair<Point<dim>,Point<dim> > &corners = box.get_boundary_points();
+        std::pair<Point<dim-1>,Point<dim-1> > face_corners;
+        for (unsigned int d=0, e=0; d<dim; ++d)
+          if (d != direction)
+            {
+              face_corners.first[e] = corners.first[d];
+              face_corners.second[e] = corners.second[d];
+              ++e;
+            }
+        return BoundingBox<dim-1> (face_corners);
+      }
+
+
+
+      /**
+       * The restriction of a function to the hyperplane on which the
+       * coordinate @p direction has the value @p coordinate.
+       */
+      template <int dim>
+      class Restriction : public Function<dim-1>
+      {
+      public:
+        Restriction (const Function<dim> &function,
+                     const unsigned int   direction,
+                     const double         coordinate)
+          :
+          function (function),
+          direction (direction),
+          coordinate (coordinate)
+        {}
+
+        virtual double value (const Point<dim-1>  &point,
+                              const unsigned int  component = 0) const
+        {
+          return function.value (lift<dim> (point, direction, coordinate), component);
+        }
+
+        virtual Tensor<1,dim-1> gradient (const Point<dim-1>  &point,
+                                          const unsigned int  component = 0) const
+        {
+          const Tensor<1,dim> full_gradient
+            = function.gradient (lift<dim> (point, direction, coordinate), component);
+          Tensor<1,dim-1> gradient;
+          for (unsigned int d=0, e=0; d<dim; ++d)
+            if (d != direction)
+              gradient[e++] = full_gradient[d];
+          return gradient;
+        }
+
+      private:
+        const Function<dim> &function;
+        const unsigned int   direction;
+        const double         coordinate;
+      };
+
+
+
+      /**
+       * A function given in real space, evaluated on the unit cell through
+       * the affine mapping onto the box @p box.
+       */
+      template <int dim>
+      class FunctionOnUnitCell : public Function<dim>
+      {
+      public:
+        FunctionOnUnitCell (const Function<dim>     &function,
+                            const BoundingBox<dim> &box)
+          :
+          function (function),
+          lower_corner (box.get_boundary_points().first),
+          side_lengths (box.get_boundary_points().second - box.get_boundary_points().first)
+        {}
+
+        virtual double value (const Point<dim>   &point,
+                              const unsigned int  component = 0) const
+        {
+          return function.value (to_real (point), component);
+        }
+
+        virtual Tensor<1,dim> gradient (const Point<dim>   &point,
+                                        const unsigned int  component = 0) const
+        {
+          Tensor<1,dim> gradient = function.gradient (to_real (point), component);
+          for (unsigned int d=0; d<dim; ++d)
+            gradient[d] *= side_lengths[d];
+          return gradient;
+        }
+
+      private:
+        Point<dim> to_real (const Point<dim> &point) const
+        {
+          Point<dim> real = lower_corner;
+          for (unsigned int d=0; d<dim; ++d)
+            real[d] += side_lengths[d] * point[d];
+          return real;
+        }
+
+        const Function<dim> &function;
+        const Point<dim>     lower_corner;
+        const Tensor<1,dim>  side_lengths;
+      };
+
+
+
+      /**
+       * Find the roots of @p f on the interval [@p a, @p b] and append them to
+       * @p roots. If @p monotone is false, the interval is first divided into
+       * AdditionalQGeneratorData::n_root_search_intervals subintervals, and a
+       * root is searched in each of them in which the function changes its
+       * sign. The roots are found by the Illinois variant of the regula
+       * falsi.
+       */
+      void
+      find_roots (const std::function<double (const double)> &f,
+                  const double                                a,
+                  const double                                b,
+                  const bool                                  monotone,
+                  const AdditionalQGeneratorData             &data,
+                  std::vector<double>                        &roots)
+      {
+        const unsigned int n_intervals = monotone ? 1 : std::max (data.n_root_search_intervals, 1U);
+        const double tolerance = data.root_tolerance * (b - a);
+
+        double left = a;
+        double f_left = f (a);
+        for (unsigned int i=0; i<n_intervals; ++i)
+          {
+            const double right = (i+1 == n_intervals ? b : a + (b - a) * (i+1) / n_intervals);
+            const double f_right = f (right);
+
+            if (f_left == 0)
+              roots.push_back (left);
+            else if (f_left * f_right < 0)
+              {
+                double x0 = left, f0 = f_left, x1 = right, f1 = f_right;
+                double root = left;
+                int retained_side = 0;
+                for (unsigned int iteration=0; iteration<100; ++iteration)
+                  {
+                    const double new_root = (f0 * x1 - f1 * x0) / (f0 - f1);
+                    const bool converged = (iteration > 0 && std::abs(new_root - root) < tolerance);
+                    root = new_root;
+                    const double f_root = f (root);
+                    if (f_root == 0 || converged || x1 - x0 < tolerance)
+                      break;
+
+                    // halve the value at an end point that is retained twice
+                    // in a row, which makes the iteration superlinear
+                    if (f_root * f1 > 0)
+                      {
+                        x1 = root;
+                        f1 = f_root;
+                        if (retained_side == -1)
+                          f0 *= 0.5;
+                        retained_side = -1;
+                      }
+                    else
+                      {
+                        x0 = root;
+                        f0 = f_root;
+                        if (retained_side == 1)
+                          f1 *= 0.5;
+                        retained_side = 1;
+                      }
+                  }
+                roots.push_back (root);
+              }
+
+            left = right;
+            f_left = f_right;
+          }
+        if (f_left == 0)
+          roots.push_back (b);
+      }
+
+
+
+      /**
+       * Split the interval [@p a, @p b] at the roots @p roots and add the
+       * points of @p quadrature1D on each subinterval on which @p in_region
+       * is true at the midpoint.
+       */
+      void
+      add_interval_points (std::vector<double>                                       &roots,
+                           const double                                               a,
+                           const double                                               b,
+                           const Quadrature<1>                                       &quadrature1D,
+                           const std::function<bool (const double)>                  &in_region,
+                           const std::function<void (const double, const double)> &add_point)
+      {
+        roots.push_back (a);
+        roots.push_back (b);
+        std::sort (roots.begin(), roots.end());
+
+        for (unsigned int i=0; i+1<roots.size(); ++i)
+          {
+            const double left = std::max (roots[i], a);
+            const double right = std::min (roots[i+1], b);
+            if (right <= left || !in_region (0.5 * (left + right)))
+              continue;
+            for (unsigned int q=0; q<quadrature1D.size(); ++q)
+              add_point (left + (right - left) * quadrature1D.point(q)[0],
+                         (right - left) * quadrature1D.weight(q));
+          }
+      }
+
+
+
+      /**
+       * Remove the functions of @p functions whose sign on @p box is known,
+       * and return false if one of them has the sign opposite to the
+       * required one, i.e., the region is empty.
+       */
+      template <int dim>
+      bool
+      prune (const std::vector<SignedFunction<dim> > &functions,
+             const BoundingBox<dim>                 &box,
+             std::vector<SignedFunction<dim> >       &active_functions,
+             std::vector<FunctionBounds<dim> >       &bounds)
+      {
+        for (const SignedFunction<dim> &f : functions)
+          {
+            const FunctionBounds<dim> function_bounds = estimate_bounds (*f.function, box);
+            const int sign = definite_sign (function_bounds.value);
+            if (sign == 0)
+              {
+                active_functions.push_back (f);
+                bounds.push_back (function_bounds);
+              }
+            else if (f.sign != 0 && sign != f.sign)
+              return false;
+          }
+        return true;
+      }
+
+
+
+      /**
+       * Return true if the point @p point lies in the region where all the
+       * functions @p functions have their required sign.
+       */
+      template <int dim>
+      bool
+      in_region (const std::vector<SignedFunction<dim> > &functions,
+                 const Point<dim>                        &point)
+      {
+        for (const SignedFunction<dim> &f : functions)
+          if (f.sign != 0 && f.sign * f.function->value (point) <= 0)
+            return false;
+        return true;
+      }
+
+
+
+      /**
+       * The children of a box that is split in all coordinate directions.
+       */
+      template <int dim>
+      std::vector<BoundingBox<dim> >
+      split_box (const BoundingBox<dim> &box)
+      {
+        const std::pair<Point<dim>,Point<dim> > &corners = box.get_boundary_points();
+        std::vector<BoundingBox<dim> > children;
+        for (unsigned int c=0; c<GeometryInfo<dim>::max_children_per_cell; ++c)
+          {
+            std::pair<Point<dim>,Point<dim> > child_corners;
+            for (unsigned int d=0; d<dim; ++d)
+              {
+                const double mid = 0.5 * (corners.first[d] + corners.second[d]);
+                child_corners.first[d] = (c & (1U << d)) ? mid : corners.first[d];
+                child_corners.second[d] = (c & (1U << d)) ? corners.second[d] : mid;
+              }
+            children.push_back (BoundingBox<dim> (child_corners));
+          }
+        return children;
+      }
+
+
+
+      /**
+       * The recursive part of the algorithm in @p dim dimensions, which
+       * generates the quadrature points on a box and passes them to a
+       * function object.
+       */
+      template <int dim>
+      class Generator
+      {
+      public:
+        Generator (const Quadrature<1>            &quadrature1D,
+                   const AdditionalQGeneratorData &data)
+          :
+          quadrature1D (quadrature1D),
+          data (data),
+          tensor_quadrature (quadrature1D),
+          lower_generator (quadrature1D, data)
+        {}
+
+        /**
+         * Add the tensor product quadrature on @p box, with all weights
+         * multiplied by @p weight.
+         */
+        void tensor_product (const BoundingBox<dim>                                      &box,
+                             const double                                                 weight,
+                             const std::function<void (const Point<dim> &, const double)> &add_point) const
+        {
+          const std::pair<Point<dim>,Point<dim> > &corners = box.get_boundary_points();
+          const double volume = box.volume();
+          for (unsigned int q=0; q<tensor_quadrature.size(); ++q)
+            {
+              Point<dim> point;
+              for (unsigned int d=0; d<dim; ++d)
+                point[d] = corners.first[d] + (corners.second[d] - corners.first[d])
+                           * tensor_quadrature.point(q)[d];
+              add_point (point, weight * volume * tensor_quadrature.weight(q));
+            }
+        }
+
+        /**
+         * Generate the quadrature of the region of @p box on which all the
+         * functions @p functions have their required sign.
+         */
+        void volume (const std::vector<SignedFunction<dim> >                     &functions,
+                     const BoundingBox<dim>                                       &box,
+                     const unsigned int                                           n_splits,
+                     const std::function<void (const Point<dim> &, const double)> &add_point) const
+        {
+          std::vector<SignedFunction<dim> > active_functions;
+          std::vector<FunctionBounds<dim> > bounds;
+          if (!prune (functions, box, active_functions, bounds))
+            return;
+
+          if (active_functions.empty())
+            {
+              tensor_product (box, 1., add_point);
+              return;
+            }
+
+          unsigned int direction = 0;
+          const bool monotone = find_height_direction (bounds, direction);
+          if (!monotone && n_splits < data.max_box_splits)
+            {
+              for (const BoundingBox<dim> &child : split_box (box))
+                volume (active_functions, child, n_splits+1, add_point);
+              return;
+            }
+
+          // The functions of the integral over the face orthogonal to the
+          // height direction are the restrictions to the bottom and top faces
+          // of the box. If a function f with the required sign s increases in
+          // the height direction, there are points with s*f>0 on a vertical
+          // line only if s*f>0 at the top, and vice versa.
+          const std::pair<Point<dim>,Point<dim> > &corners = box.get_boundary_points();
+          std::vector<std::unique_ptr<Restriction<dim> > > restrictions;
+          std::vector<SignedFunction<dim-1> > face_functions;
+          for (unsigned int i=0; i<active_functions.size(); ++i)
+            {
+              restrictions.emplace_back (new Restriction<dim> (*active_functions[i].function,
+                                                               direction, corners.first[direction]));
+              restrictions.emplace_back (new Restriction<dim> (*active_functions[i].function,
+                                                               direction, corners.second[direction]));
+
+              const int slope = definite_sign (bounds[i].gradient[direction]);
+              const int sign = active_functions[i].sign;
+              const int bottom_sign = (monotone && sign == -slope) ? sign : 0;
+              const int top_sign = (monotone && sign == slope) ? sign : 0;
+              face_functions.push_back (SignedFunction<dim-1> {restrictions[2*i].get(), bottom_sign});
+              face_functions.push_back (SignedFunction<dim-1> {restrictions[2*i+1].get(), top_sign});
+            }
+
+          const double a = corners.first[direction];
+          const double b = corners.second[direction];
+          std::vector<double> roots;
+          const auto integrand = [&] (const Point<dim-1> &face_point, const double face_weight)
+          {
+            roots.clear();
+            for (const SignedFunction<dim> &f : active_functions)
+              find_roots ([&] (const double t)
+            {
+              return f.function->value (lift<dim> (face_point, direction, t));
+            },
+            a, b, monotone, data, roots);
+
+            add_interval_points (roots, a, b, quadrature1D,
+                                 [&] (const double t)
+            {
+              return in_region (active_functions, lift<dim> (face_point, direction, t));
+            },
+            [&] (const double t, const double weight)
+            {
+              add_point (lift<dim> (face_point, direction, t), face_weight * weight);
+            });
+          };
+
+          lower_generator.volume (face_functions, cross_section (box, direction),
+                                  n_splits, integrand);
+        }
+
+        /**
+         * Generate the quadrature of the zero contour of @p level_set on
+         * @p box.
+         */
+        void surface (const Function<dim>                                                               &level_set,
+                      const BoundingBox<dim>                                                            &box,
+                      const unsigned int                                                                n_splits,
+                      const std::function<void (const Point<dim> &, const double, const Tensor<1,dim> &)> &add_point) const
+        {
+          const std::vector<FunctionBounds<dim> > bounds (1, estimate_bounds (level_set, box));
+          if (definite_sign (bounds[0].value) != 0)
+            return;
+
+          unsigned int direction = 0;
+          const bool monotone = find_height_direction (bounds, direction);
+          if (!monotone && n_splits < data.max_box_splits)
+            {
+              for (const BoundingBox<dim> &child : split_box (box))
+                surface (level_set, child, n_splits+1, add_point);
+              return;
+            }
+
+          // A vertical line only crosses the zero contour if the level set
+          // function has different signs at the bottom and the top
+          const std::pair<Point<dim>,Point<dim> > &corners = box.get_boundary_points();
+          const Restriction<dim> bottom (level_set, direction, corners.first[direction]);
+          const Restriction<dim> top (level_set, direction, corners.second[direction]);
+          const int slope = monotone ? definite_sign (bounds[0].gradient[direction]) : 0;
+          const std::vector<SignedFunction<dim-1> > face_functions
+          {
+            SignedFunction<dim-1> {&bottom, -slope},
+            SignedFunction<dim-1> {&top, slope}
+          };
+
+          const double a = corners.first[direction];
+          const double b = corners.second[direction];
+          std::vector<double> roots;
+          const auto integrand = [&] (const Point<dim-1> &face_point, const double face_weight)
+          {
+            roots.clear();
+            find_roots ([&] (const double t)
+            {
+              return level_set.value (lift<dim> (face_point, direction, t));
+            },
+            a, b, monotone, data, roots);
+
+            for (const double t : roots)
+              {
+                const Point<dim> point = lift<dim> (face_point, direction, t);
+                const Tensor<1,dim> gradient = level_set.gradient (point);
+                const double gradient_norm = gradient.norm();
+                if (std::abs(gradient[direction]) <= 1e-12 * gradient_norm)
+                  continue;
+                add_point (point,
+                           face_weight * gradient_norm / std::abs(gradient[direction]),
+                           gradient / gradient_norm);
+              }
+          };
+
+          lower_generator.volume (face_functions, cross_section (box, direction),
+                                  n_splits, integrand);
+        }
+
+      private:
+        const Quadrature<1>            &quadrature1D;
+        const AdditionalQGeneratorData &data;
+        const Quadrature<dim>           tensor_quadrature;
+        const Generator<dim-1>          lower_generator;
+      };
+
+
+
+      /**
+       * The algorithm in one dimension, where the interval is split at the
+       * roots of all the functions.
+       */
+      template <>
+      class Generator<1>
+      {
+      public:
+        Generator (const Quadrature<1>            &quadrature1D,
+                   const AdditionalQGeneratorData &data)
+          :
+          quadrature1D (quadrature1D),
+          data (data)
+        {}
+
+        void tensor_product (const BoundingBox<1>                                      &box,
+                             const double                                               weight,
+                             const std::function<void (const Point<1> &, const double)> &add_point) const
+        {
+          const double a = box.get_boundary_points().first[0];
+          const double b = box.get_boundary_points().second[0];
+          for (unsigned int q=0; q<quadrature1D.size(); ++q)
+            add_point (Point<1> (a + (b - a) * quadrature1D.point(q)[0]),
+                       weight * (b - a) * quadrature1D.weight(q));
+        }
+
+        void volume (const std::vector<SignedFunction<1> >                     &functions,
+                     const BoundingBox<1>                                       &box,
+                     const unsigned int                                         ,
+                     const std::function<void (const Point<1> &, const double)> &add_point) const
+        {
+          std::vector<SignedFunction<1> > active_functions;
+          std::vector<FunctionBounds<1> > bounds;
+          if (!prune (functions, box, active_functions, bounds))
+            return;
+
+          if (active_functions.empty())
+            {
+              tensor_product (box, 1., add_point);
+              return;
+            }
+
+          const double a = box.get_boundary_points().first[0];
+          const double b = box.get_boundary_points().second[0];
+          std::vector<double> roots;
+          for (unsigned int i=0; i<active_functions.size(); ++i)
+            find_roots ([&] (const double t)
+          {
+            return active_functions[i].function->value (Point<1>(t));
+          },
+          a, b, definite_sign (bounds[i].gradient[0]) != 0, data, roots);
+
+          add_interval_points (roots, a, b, quadrature1D,
+                               [&] (const double t)
+          {
+            return in_region (active_functions, Point<1>(t));
+          },
+          [&] (const double t, const double weight)
+          {
+            add_point (Point<1>(t), weight);
+          });
+        }
+
+        void surface (const Function<1>                                                             &level_set,
+                      const BoundingBox<1>                                                          &box,
+                      const unsigned int                                                            ,
+                      const std::function<void (const Point<1> &, const double, const Tensor<1,1> &)> &add_point) const
+        {
+          const FunctionBounds<1> bounds = estimate_bounds (level_set, box);
+          if (definite_sign (bounds.value) != 0)
+            return;
+
+          const double a = box.get_boundary_points().first[0];
+          const double b = box.get_boundary_points().second[0];
+          std::vector<double> roots;
+          find_roots ([&] (const double t)
+          {
+            return level_set.value (Point<1>(t));
+          },
+          a, b, definite_sign (bounds.gradient[0]) != 0, data, roots);
+
+          for (const double t : roots)
+            {
+              const double derivative = level_set.gradient (Point<1>(t))[0];
+              if (derivative == 0)
+                continue;
+              Tensor<1,1> normal;
+              normal[0] = (derivative > 0 ? 1. : -1.);
+              add_point (Point<1>(t), 1., normal);
+            }
+        }
+
+      private:
+        const Quadrature<1>            &quadrature1D;
+        const AdditionalQGeneratorData &data;
+      };
+    }
+  }
+
+
+
+  AdditionalQGeneratorData::AdditionalQGeneratorData (const unsigned int max_box_splits,
+                                                      const unsigned int n_root_search_intervals,
+                                                      const double       root_tolerance)
+    :
+    max_box_splits (max_box_splits),
+    n_root_search_intervals (n_root_search_intervals),
+    root_tolerance (root_tolerance)
+  {}
+
+
+
+  template <int dim>
+  QuadratureGenerator<dim>::QuadratureGenerator (const Quadrature<1>            &quadrature1D,
+                                                 const AdditionalQGeneratorData &additional_data)
+    :
+    quadrature1D (quadrature1D),
+    additional_data (additional_data),
+    location (LocationToLevelSet::intersected)
+  {
+    Assert (quadrature1D.size() > 0, ExcMessage ("The quadrature must not be empty."));
+  }
+
+
+
+  template <int dim>
+  void
+  QuadratureGenerator<dim>::generate (const Function<dim>     &level_set,
+                                      const BoundingBox<dim> &box)
+  {
+    using namespace internal::QuadratureGeneratorImplementation;
+
+    const Generator<dim> generator (quadrature1D, additional_data);
+
+    std::vector<Point<dim> > points;
+    std::vector<double> weights;
+    const auto add_point = [&] (const Point<dim> &point, const double weight)
+    {
+      points.push_back (point);
+      weights.push_back (weight);
+    };
+
+    inside_quadrature = Quadrature<dim>();
+    outside_quadrature = Quadrature<dim>();
+    surface_quadrature = ImmersedSurfaceQuadrature<dim>();
+
+    // boxes away from the zero contour get the tensor product quadrature
+    const int sign = definite_sign (estimate_bounds (level_set, box).value);
+    if (sign != 0)
+      {
+        generator.tensor_product (box, 1., add_point);
+        if (sign < 0)
+          {
+            location = LocationToLevelSet::inside;
+            inside_quadrature = Quadrature<dim> (points, weights);
+          }
+        else
+          {
+            location = LocationToLevelSet::outside;
+            outside_quadrature = Quadrature<dim> (points, weights);
+          }
+        return;
+      }
+
+    location = LocationToLevelSet::intersected;
+
+    generator.volume (std::vector<SignedFunction<dim> > (1, SignedFunction<dim> {&level_set, -1}),
+                      box, 0, add_point);
+    inside_quadrature = Quadrature<dim> (points, weights);
+
+    points.clear();
+    weights.clear();
+    generator.volume (std::vector<SignedFunction<dim> > (1, SignedFunction<dim> {&level_set, 1}),
+                      box, 0, add_point);
+    outside_quadrature = Quadrature<dim> (points, weights);
+
+    generator.surface (level_set, box, 0,
+                       [&] (const Point<dim> &point, const double weight, const Tensor<1,dim> &normal)
+    {
+      surface_quadrature.push_back (point, weight, normal);
+    });
+  }
+
+
+
+  template <int dim>
+  LocationToLevelSet
+  QuadratureGenerator<dim>::get_location () const
+  {
+    return location;
+  }
+
+
+
+  template <int dim>
+  const Quadrature<dim> &
+  QuadratureGenerator<dim>::get_inside_quadrature () const
+  {
+    return inside_quadrature;
+  }
+
+
+
+  template <int dim>
+  const Quadrature<dim> &
+  QuadratureGenerator<dim>::get_outside_quadrature () const
+  {
+    return outside_quadrature;
+  }
+
+
+
+  template <int dim>
+  const ImmersedSurfaceQuadrature<dim> &
+  QuadratureGenerator<dim>::get_surface_quadrature () const
+  {
+    return surface_quadrature;
+  }
+
+
+
+  template <int dim>
+  CutCellQuadratures<dim>::CutCellQuadratures (const Quadrature<1>            &quadrature1D,
+                                               const AdditionalQGeneratorData &additional_data)
+    :
+    quadrature1D (quadrature1D),
+    additional_data (additional_data)
+  {}
+
+
+
+  template <int dim>
+  void
+  CutCellQuadratures<dim>::reinit (const Triangulation<dim> &tria,
+                                   const Function<dim>      &level_set)
+  {
+    triangulation = &tria;
+
+    std::vector<typename Triangulation<dim>::active_cell_iterator> cells;
+    cells.reserve (tria.n_active_cells());
+    for (const auto &cell : tria.active_cell_iterators())
+      cells.push_back (cell);
+
+    const unsigned int n_cells = cells.size();
+    locations.assign (n_cells, LocationToLevelSet::inside);
+    cut_cell_indices.assign (n_cells, numbers::invalid_unsigned_int);
+
+    std::vector<Quadrature<dim> > inside (n_cells), outside (n_cells);
+    std::vector<ImmersedSurfaceQuadrature<dim> > surface (n_cells);
+
+    std::pair<Point<dim>,Point<dim> > unit_corners;
+    for (unsigned int d=0; d<dim; ++d)
+      unit_corners.second[d] = 1.;
+    const BoundingBox<dim> unit_cell (unit_corners);
+
+    // every subrange has its own generator and writes the results of its
+    // cells, so no synchronization is necessary
+    parallel::apply_to_subranges
+    (0U, n_cells,
+     [&] (const unsigned int begin, const unsigned int end)
+    {
+      QuadratureGenerator<dim> generator (quadrature1D, additional_data);
+      for (unsigned int i=begin; i<end; ++i)
+        {
+          const unsigned int index = cells[i]->active_cell_index();
+          const internal::QuadratureGeneratorImplementation::FunctionOnUnitCell<dim>
+          cell_level_set (level_set, cells[i]->bounding_box());
+          generator.generate (cell_level_set, unit_cell);
+          locations[index] = generator.get_location();
+          if (locations[index] == LocationToLevelSet::intersected)
+            {
+              inside[index] = generator.get_inside_quadrature();
+              outside[index] = generator.get_outside_quadrature();
+              surface[index] = generator.get_surface_quadrature();
+            }
+        }
+    },
+    16);
+
+    inside_quadratures.clear();
+    outside_quadratures.clear();
+    surface_quadratures.clear();
+    for (unsigned int i=0; i<n_cells; ++i)
+      if (locations[i] == LocationToLevelSet::intersected)
+        {
+          cut_cell_indices[i] = inside_quadratures.size();
+          inside_quadratures.push_back (std::move (inside[i]));
+          outside_quadratures.push_back (std::move (outside[i]));
+          surface_quadratures.push_back (std::move (surface[i]));
+        }
+  }
+
+
+
+  template <int dim>
+  LocationToLevelSet
+  CutCellQuadratures<dim>::get_location
+  (const typename Triangulation<dim>::active_cell_iterator &cell) const
+  {
+    Assert (&cell->get_triangulation() == triangulation,
+            ExcMessage ("The cell does not belong to the triangulation passed to reinit()."));
+    AssertIndexRange (cell->active_cell_index(), locations.size());
+    return locations[cell->active_cell_index()];
+  }
+
+
+
+  template <int dim>
+  unsigned int
+  CutCellQuadratures<dim>::cut_cell_index
+  (const typename Triangulation<dim>::active_cell_iterator &cell) const
+  {
+    Assert (get_location (cell) == LocationToLevelSet::intersected,
+            ExcMessage ("Quadratures are only stored for intersected cells."));
+    return cut_cell_indices[cell->active_cell_index()];
+  }
+
+
+
+  template <int dim>
+  const Quadrature<dim> &
+  CutCellQuadratures<dim>::get_inside_quadrature
+  (const typename Triangulation<dim>::active_cell_iterator &cell) const
+  {
+    return inside_quadratures[cut_cell_index (cell)];
+  }
+
+
+
+  template <int dim>
+  const Quadrature<dim> &
+  CutCellQuadratures<dim>::get_outside_quadrature
+  (const typename Triangulation<dim>::active_cell_iterator &cell) const
+  {
+    return outside_quadratures[cut_cell_index (cell)];
+  }
+
+
+
+  template <int dim>
+  const ImmersedSurfaceQuadrature<dim> &
+  CutCellQuadratures<dim>::get_surface_quadrature
+  (const typename Triangulation<dim>::active_cell_iterator &cell) const
+  {
+    return surface_quadratures[cut_cell_index (cell)];
+  }
+
+
+
+  template <int dim>
+  std::size_t
+  CutCellQuadratures<dim>::memory_consumption () const
+  {
+    std::size_t memory = locations.capacity() * sizeof (LocationToLevelSet) +
+                         MemoryConsumption::memory_consumption (cut_cell_indices) +
+                         MemoryConsumption::memory_consumption (inside_quadratures) +
+                         MemoryConsumption::memory_consumption (outside_quadratures);
+    for (const ImmersedSurfaceQuadrature<dim> &quadrature : surface_quadratures)
+      memory += quadrature.memory_consumption() +
+                MemoryConsumption::memory_consumption (quadrature.get_normal_vectors());
+    return memory;
+  }
+
+
+
+  template class QuadratureGenerator<1>;
+  template class QuadratureGenerator<2>;
+  template class QuadratureGenerator<3>;
+
+  template class CutCellQuadratures<1>;
+  template class CutCellQuadratures<2>;
+  template class CutCellQuadratures<3>;
+
+}
+DEAL_II_NAMESPACE_CLOSE
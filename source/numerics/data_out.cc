@@ -68,8 +68,18 @@ build_one_patch
  const unsigned int                                                                           n_subdivisions,
  const CurvedCellRegion                                                                       curved_cell_region)
 {
-  // first create the output object that we will write into
-  ::dealii::DataOutBase::Patch<DoFHandlerType::dimension, DoFHandlerType::space_dimension> patch;
+  // first get the output object that we will write into. we write directly
+  // into the patches vector, which allows the memory of the data table to be
+  // reused by the Table::reinit() calls below if the patches have been built
+  // before, e.g. in the previous time step or the previous chunk of cells,
+  // rather than allocating new memory for each patch
+  const unsigned int patch_idx =
+    (*scratch_data.cell_to_patch_index_map)[cell_and_index->first->level()][cell_and_index->first->index()];
+  // did we mess up the indices?
+  Assert(patch_idx < this->patches.size(), ExcInternalError());
+  ::dealii::DataOutBase::Patch<DoFHandlerType::dimension, DoFHandlerType::space_dimension> &patch
+    = this->patches[patch_idx];
+  patch.patch_index = patch_idx;
   patch.n_subdivisions = n_subdivisions;
 
   // set the vertices of the patch. if the mapping does not preserve locations
@@ -351,17 +361,6 @@ build_one_patch
       patch.neighbors[f]
         = (*scratch_data.cell_to_patch_index_map)[neighbor->level()][neighbor->index()];
     }
-
-  const unsigned int patch_idx =
-    (*scratch_data.cell_to_patch_index_map)[cell_and_index->first->level()][cell_and_index->first->index()];
-  // did we mess up the indices?
-  Assert(patch_idx < this->patches.size(), ExcInternalError());
-  patch.patch_index = patch_idx;
-
-  // Put the patch into the patches vector. instead of copying the data,
-  // simply swap the contents to avoid the penalty of writing into another
-  // processor's memory
-  this->patches[patch_idx].swap (patch);
 }
 
 
@@ -378,8 +377,46 @@ void DataOut<dim,DoFHandlerType>::build_patches (const unsigned int n_subdivisio
 template <int dim, typename DoFHandlerType>
 void DataOut<dim,DoFHandlerType>::build_patches
 (const Mapping<DoFHandlerType::dimension,DoFHandlerType::space_dimension> &mapping,
- const unsigned int                                                        n_subdivisions_,
+ const unsigned int                                                        n_subdivisions,
  const CurvedCellRegion                                                    curved_region)
+{
+  build_patches_impl (mapping, n_subdivisions, curved_region,
+                      numbers::invalid_unsigned_int,
+                      std::function<void (const unsigned int)>());
+}
+
+
+
+template <int dim, typename DoFHandlerType>
+void DataOut<dim,DoFHandlerType>::build_patches_in_chunks
+(const Mapping<DoFHandlerType::dimension,DoFHandlerType::space_dimension> &mapping,
+ const unsigned int                                                        n_subdivisions,
+ const unsigned int                                                        n_cells_per_chunk,
+ const std::function<void (const unsigned int)>                           &process_chunk,
+ const CurvedCellRegion                                                    curved_region)
+{
+  Assert (n_cells_per_chunk > 0,
+          ExcMessage ("The number of cells per chunk must be positive."));
+  Assert (process_chunk,
+          ExcMessage ("A function to process the chunks of patches is needed."));
+
+  build_patches_impl (mapping, n_subdivisions, curved_region,
+                      n_cells_per_chunk, process_chunk);
+
+  // release the patches of the last chunk
+  std::vector<dealii::DataOutBase::Patch<DoFHandlerType::dimension,
+      DoFHandlerType::space_dimension> >().swap (this->patches);
+}
+
+
+
+template <int dim, typename DoFHandlerType>
+void DataOut<dim,DoFHandlerType>::build_patches_impl
+(const Mapping<DoFHandlerType::dimension,DoFHandlerType::space_dimension> &mapping,
+ const unsigned int                                                        n_subdivisions_,
+ const CurvedCellRegion                                                    curved_region,
+ const unsigned int                                                        n_cells_per_chunk,
+ const std::function<void (const unsigned int)>                           &process_chunk)
 {
   // Check consistency of redundant template parameter
   Assert (dim==DoFHandlerType::dimension, ExcDimensionMismatch(dim, DoFHandlerType::dimension));
@@ -463,9 +500,6 @@ void DataOut<dim,DoFHandlerType>::build_patches
       }
   }
 
-  this->patches.clear ();
-  this->patches.resize(all_cells.size());
-
   // now create a default object for the WorkStream object to work with
   unsigned int n_datasets = 0;
   for (unsigned int i=0; i<this->cell_data.size(); ++i)
@@ -505,31 +539,70 @@ void DataOut<dim,DoFHandlerType>::build_patches
                update_flags,
                cell_to_patch_index_map);
 
-  // now build the patches in parallel
-  if (all_cells.size() > 0)
-    WorkStream::run (&all_cells[0],
-                     &all_cells[0]+all_cells.size(),
-                     std::bind(&DataOut<dim,DoFHandlerType>::build_one_patch,
-                               this,
-                               std::placeholders::_1,
-                               std::placeholders::_2,
-                               /* no std::placeholders::_3, since this function doesn't actually need a
-                                  copy data object -- it just writes everything right into the
-                                  output array */
-                               n_subdivisions,
-                               curved_cell_region),
-                     // no copy-local-to-global function needed here
-                     std::function<void (const int &)>(),
-                     thread_data,
-                     /* dummy CopyData object = */ 0,
-                     // experimenting shows that we can make things run a bit
-                     // faster if we increase the number of cells we work on
-                     // per item (i.e., WorkStream's chunk_size argument,
-                     // about 10% improvement) and the items in flight at any
-                     // given time (another 5% on the testcase discussed in
-                     // @ref workstream_paper, on 32 cores) and if
-                     8*MultithreadInfo::n_threads(),
-                     64);
+  // now build the patches in parallel, one chunk of cells at a time. if
+  // there is more than one chunk, the patches of each chunk are numbered
+  // starting at zero, so we renumber the cells of the current chunk in
+  // cell_to_patch_index_map and mark the cells of all other chunks as having
+  // no patch, such that build_one_patch() does not set neighbors outside
+  // the chunk
+  const unsigned int n_cells = all_cells.size();
+  const unsigned int chunk_size = std::max (1U, std::min (n_cells_per_chunk,
+                                                          n_cells));
+  if (chunk_size < n_cells)
+    for (unsigned int i=chunk_size; i<n_cells; ++i)
+      cell_to_patch_index_map[all_cells[i].first->level()][all_cells[i].first->index()]
+        = dealii::DataOutBase::Patch<DoFHandlerType::dimension,
+          DoFHandlerType::space_dimension>::no_neighbor;
+
+  for (unsigned int chunk=0, begin=0; ; ++chunk, begin += chunk_size)
+    {
+      const unsigned int end = std::min (begin+chunk_size, n_cells);
+      if (begin > 0)
+        {
+          for (unsigned int i=begin-chunk_size; i<begin; ++i)
+            cell_to_patch_index_map[all_cells[i].first->level()][all_cells[i].first->index()]
+              = dealii::DataOutBase::Patch<DoFHandlerType::dimension,
+                DoFHandlerType::space_dimension>::no_neighbor;
+          for (unsigned int i=begin; i<end; ++i)
+            cell_to_patch_index_map[all_cells[i].first->level()][all_cells[i].first->index()]
+              = i-begin;
+        }
+
+      // keep the patches that already exist, such that their memory can be
+      // reused
+      this->patches.resize (end-begin);
+
+      if (end > begin)
+        WorkStream::run (&all_cells[0]+begin,
+                         &all_cells[0]+end,
+                         std::bind(&DataOut<dim,DoFHandlerType>::build_one_patch,
+                                   this,
+                                   std::placeholders::_1,
+                                   std::placeholders::_2,
+                                   /* no std::placeholders::_3, since this function doesn't actually need a
+                                      copy data object -- it just writes everything right into the
+                                      output array */
+                                   n_subdivisions,
+                                   curved_cell_region),
+                         // no copy-local-to-global function needed here
+                         std::function<void (const int &)>(),
+                         thread_data,
+                         /* dummy CopyData object = */ 0,
+                         // experimenting shows that we can make things run a bit
+                         // faster if we increase the number of cells we work on
+                         // per item (i.e., WorkStream's chunk_size argument,
+                         // about 10% improvement) and the items in flight at any
+                         // given time (another 5% on the testcase discussed in
+                         // @ref workstream_paper, on 32 cores) and if
+                         8*MultithreadInfo::n_threads(),
+                         64);
+
+      if (process_chunk)
+        process_chunk (chunk);
+
+      if (end >= n_cells)
+        break;
+    }
 }
 
 
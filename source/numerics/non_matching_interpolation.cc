@@ -0,0 +1,316 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/distributed/tria_base.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/grid_tools_cache.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/la_vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/petsc_parallel_vector.h>
+#include <deal.II/lac/trilinos_vector.h>
+#include <deal.II/lac/vector_element_access.h>
+#include <deal.II/numerics/non_matching_interpolation.h>
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, int spacedim>
+NonMatchingInterpolation<dim,spacedim>::NonMatchingInterpolation ()
+  :
+  mpi_communicator (MPI_COMM_SELF),
+  n_components (0),
+  n_unlocated (0)
+{}
+
+
+
+template <int dim, int spacedim>
+void
+NonMatchingInterpolation<dim,spacedim>::reinit
+(const Mapping<dim,spacedim>    &source_mapping,
+ const DoFHandler<dim,spacedim> &source_dof_handler,
+ const Mapping<dim,spacedim>    &target_mapping,
+ const DoFHandler<dim,spacedim> &target_dof_handler)
+{
+  const FiniteElement<dim,spacedim> &source_fe = source_dof_handler.get_fe();
+  const FiniteElement<dim,spacedim> &target_fe = target_dof_handler.get_fe();
+  Assert (source_fe.is_primitive(),
+          ExcMessage ("The source element must be primitive."));
+  Assert (target_fe.has_support_points(),
+          ExcMessage ("The target element must have support points."));
+  AssertDimension (source_fe.n_components(), target_fe.n_components());
+
+  n_components = target_fe.n_components();
+
+  const parallel::Triangulation<dim,spacedim> *parallel_tria
+    = dynamic_cast<const parallel::Triangulation<dim,spacedim> *>
+      (&source_dof_handler.get_triangulation());
+  mpi_communicator = (parallel_tria != nullptr ?
+                      parallel_tria->get_communicator() :
+                      MPI_COMM_SELF);
+
+  // Step 1: collect the support points of the locally owned target degrees
+  // of freedom. The degrees of freedom of all components at the same support
+  // point of a cell share one point, identified by the first degree of
+  // freedom of the cell at that point
+  const std::vector<Point<dim> > &unit_support_points = target_fe.get_unit_support_points();
+  std::vector<unsigned int> first_dof_at_point (target_fe.dofs_per_cell);
+  for (unsigned int i=0; i<target_fe.dofs_per_cell; ++i)
+    {
+      first_dof_at_point[i] = i;
+      for (unsigned int j=0; j<i; ++j)
+        if (unit_support_points[j] == unit_support_points[i])
+          {
+            first_dof_at_point[i] = j;
+            break;
+          }
+    }
+
+  FEValues<dim,spacedim> fe_values (target_mapping, target_fe,
+                                    Quadrature<dim>(unit_support_points),
+                                    update_quadrature_points);
+  const IndexSet &owned_dofs = target_dof_handler.locally_owned_dofs();
+  std::vector<bool> dof_is_collected (owned_dofs.n_elements(), false);
+  std::vector<types::global_dof_index> dof_indices (target_fe.dofs_per_cell);
+
+  std::vector<Point<spacedim> > points;
+  std::vector<types::global_dof_index> point_dof_indices;
+  for (const auto &cell : target_dof_handler.active_cell_iterators())
+    if (cell->is_locally_owned())
+      {
+        fe_values.reinit (cell);
+        cell->get_dof_indices (dof_indices);
+        for (unsigned int i=0; i<target_fe.dofs_per_cell; ++i)
+          if (first_dof_at_point[i] == i)
+            {
+              bool point_is_new = false;
+              for (unsigned int j=i; j<target_fe.dofs_per_cell; ++j)
+                if (first_dof_at_point[j] == i &&
+                    owned_dofs.is_element(dof_indices[j]) &&
+                    !dof_is_collected[owned_dofs.index_within_set(dof_indices[j])])
+                  {
+                    if (!point_is_new)
+                      {
+                        point_is_new = true;
+                        points.push_back (fe_values.quadrature_point(i));
+                        point_dof_indices.resize (point_dof_indices.size() + n_components,
+                                                  numbers::invalid_dof_index);
+                      }
+                    dof_is_collected[owned_dofs.index_within_set(dof_indices[j])] = true;
+                    point_dof_indices[point_dof_indices.size() - n_components +
+                                      target_fe.system_to_component_index(j).first]
+                      = dof_indices[j];
+                  }
+            }
+      }
+
+  // Step 2: locate the points in the source mesh
+  const GridTools::Cache<dim,spacedim> cache (source_dof_handler.get_triangulation(),
+                                              source_mapping);
+  const auto point_locations
+    = GridTools::distributed_compute_point_locations (cache, points);
+
+  // Step 3: compute the weights of the points located on this process,
+  // sorted by the rank and index of the points, which is the order in which
+  // the target processes expect them
+  std::vector<std::tuple<unsigned int, unsigned int, unsigned int, unsigned int> > located_points;
+  for (unsigned int c=0; c<std::get<0>(point_locations).size(); ++c)
+    for (unsigned int q=0; q<std::get<1>(point_locations)[c].size(); ++q)
+      located_points.emplace_back (std::get<2>(point_locations)[c][q].first,
+                                   std::get<2>(point_locations)[c][q].second,
+                                   c, q);
+  std::sort (located_points.begin(), located_points.end());
+
+  send_ranks.clear ();
+  send_row_starts.assign (1, 0);
+  row_starts.assign (1, 0);
+  source_dof_indices.clear ();
+  weights.clear ();
+  dof_indices.resize (source_fe.dofs_per_cell);
+  for (const auto &point : located_points)
+    {
+      if (send_ranks.empty() || send_ranks.back() != std::get<0>(point))
+        {
+          if (!send_ranks.empty())
+            send_row_starts.push_back (row_starts.size()-1);
+          send_ranks.push_back (std::get<0>(point));
+        }
+
+      const auto &tria_cell = std::get<0>(point_locations)[std::get<2>(point)];
+      const typename DoFHandler<dim,spacedim>::active_cell_iterator
+      cell (&source_dof_handler.get_triangulation(),
+            tria_cell->level(), tria_cell->index(), &source_dof_handler);
+      cell->get_dof_indices (dof_indices);
+      const Point<dim> &unit_point = std::get<1>(point_locations)[std::get<2>(point)][std::get<3>(point)];
+
+      for (unsigned int component=0; component<n_components; ++component)
+        {
+          for (unsigned int i=0; i<source_fe.dofs_per_cell; ++i)
+            if (source_fe.system_to_component_index(i).first == component)
+              {
+                source_dof_indices.push_back (dof_indices[i]);
+                weights.push_back (source_fe.shape_value(i, unit_point));
+              }
+          row_starts.push_back (weights.size());
+        }
+    }
+  send_row_starts.push_back (row_starts.size()-1);
+
+  // Step 4: set up the rows received from the processes that located the
+  // points of this process, in the same order
+  const std::vector<unsigned int> &point_owners = std::get<3>(point_locations);
+  std::map<unsigned int, std::vector<unsigned int> > points_by_owner;
+  n_unlocated = 0;
+  for (unsigned int p=0; p<points.size(); ++p)
+    if (point_owners[p] != numbers::invalid_unsigned_int)
+      points_by_owner[point_owners[p]].push_back (p);
+    else
+      for (unsigned int component=0; component<n_components; ++component)
+        if (point_dof_indices[p*n_components+component] != numbers::invalid_dof_index)
+          ++n_unlocated;
+
+  receive_ranks.clear ();
+  receive_row_starts.assign (1, 0);
+  target_dof_indices.clear ();
+  for (const auto &owner_and_points : points_by_owner)
+    {
+      receive_ranks.push_back (owner_and_points.first);
+      for (const unsigned int p : owner_and_points.second)
+        for (unsigned int component=0; component<n_components; ++component)
+          target_dof_indices.push_back (point_dof_indices[p*n_components+component]);
+      receive_row_starts.push_back (target_dof_indices.size());
+    }
+
+  send_buffer.resize (row_starts.size()-1);
+  receive_buffer.resize (target_dof_indices.size());
+}
+
+
+
+template <int dim, int spacedim>
+template <typename VectorType>
+void
+NonMatchingInterpolation<dim,spacedim>::interpolate (const VectorType &source,
+                                                     VectorType       &target) const
+{
+  const unsigned int my_rank = Utilities::MPI::this_mpi_process (mpi_communicator);
+
+  // post the receives before computing the values sent to other processes
+#ifdef DEAL_II_WITH_MPI
+  const int mpi_tag = 54;
+  std::vector<MPI_Request> requests;
+  requests.reserve (send_ranks.size() + receive_ranks.size());
+  for (unsigned int i=0; i<receive_ranks.size(); ++i)
+    if (receive_ranks[i] != my_rank)
+      {
+        requests.emplace_back ();
+        const int ierr = MPI_Irecv (&receive_buffer[receive_row_starts[i]],
+                                    receive_row_starts[i+1]-receive_row_starts[i],
+                                    MPI_DOUBLE, receive_ranks[i], mpi_tag,
+                                    mpi_communicator, &requests.back());
+        AssertThrowMPI (ierr);
+      }
+#endif
+
+  for (unsigned int i=0; i<send_ranks.size(); ++i)
+    {
+      for (unsigned int row=send_row_starts[i]; row<send_row_starts[i+1]; ++row)
+        {
+          double value = 0;
+          for (unsigned int k=row_starts[row]; k<row_starts[row+1]; ++k)
+            value += weights[k] *
+                     internal::ElementAccess<VectorType>::get (source, source_dof_indices[k]);
+          send_buffer[row] = value;
+        }
+
+      if (send_ranks[i] == my_rank)
+        {
+          const unsigned int receive_index
+            = std::lower_bound (receive_ranks.begin(), receive_ranks.end(), my_rank)
+              - receive_ranks.begin();
+          Assert (receive_index < receive_ranks.size() &&
+                  receive_ranks[receive_index] == my_rank,
+                  ExcInternalError());
+          AssertDimension (send_row_starts[i+1]-send_row_starts[i],
+                           receive_row_starts[receive_index+1]-receive_row_starts[receive_index]);
+          std::copy (send_buffer.begin()+send_row_starts[i],
+                     send_buffer.begin()+send_row_starts[i+1],
+                     receive_buffer.begin()+receive_row_starts[receive_index]);
+        }
+#ifdef DEAL_II_WITH_MPI
+      else
+        {
+          requests.emplace_back ();
+          const int ierr = MPI_Isend (&send_buffer[send_row_starts[i]],
+                                      send_row_starts[i+1]-send_row_starts[i],
+                                      MPI_DOUBLE, send_ranks[i], mpi_tag,
+                                      mpi_communicator, &requests.back());
+          AssertThrowMPI (ierr);
+        }
+#endif
+    }
+
+#ifdef DEAL_II_WITH_MPI
+  if (requests.size() > 0)
+    {
+      const int ierr = MPI_Waitall (requests.size(), requests.data(),
+                                    MPI_STATUSES_IGNORE);
+      AssertThrowMPI (ierr);
+    }
+#endif
+
+  for (unsigned int row=0; row<target_dof_indices.size(); ++row)
+    if (target_dof_indices[row] != numbers::invalid_dof_index)
+      internal::ElementAccess<VectorType>::set (receive_buffer[row],
+                                                target_dof_indices[row],
+                                                target);
+  target.compress (VectorOperation::insert);
+}
+
+
+
+template <int dim, int spacedim>
+std::size_t
+NonMatchingInterpolation<dim,spacedim>::memory_consumption () const
+{
+  return (sizeof(*this) +
+          MemoryConsumption::memory_consumption (send_ranks) +
+          MemoryConsumption::memory_consumption (send_row_starts) +
+          MemoryConsumption::memory_consumption (row_starts) +
+          MemoryConsumption::memory_consumption (source_dof_indices) +
+          MemoryConsumption::memory_consumption (weights) +
+          MemoryConsumption::memory_consumption (receive_ranks) +
+          MemoryConsumption::memory_consumption (receive_row_starts) +
+          MemoryConsumption::memory_consumption (target_dof_indices) +
+          MemoryConsumption::memory_consumption (send_buffer) +
+          MemoryConsumption::memory_consumption (receive_buffer));
+}
+
+
+// explicit instantiations
+#include "non_matching_interpolation.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -49,6 +49,7 @@ namespace internal
       requested_location = new_requested_location;
       support_point_locations = new_locations;
       solution_indices = new_sol_indices;
+      requested_location_fe = nullptr;
     }
   }
 }
@@ -841,12 +842,61 @@ void PointValueHistory<dim>
 
   typename std::vector <internal::PointValueHistory::PointGeometryData <dim> >::iterator point = point_geometry_data.begin ();
   Vector <number> value (dof_handler->get_fe(0).n_components());
+  std::vector<types::global_dof_index> local_dof_indices;
   for (unsigned int data_store_index = 0; point != point_geometry_data.end (); ++point, ++data_store_index)
     {
       // Make a Vector <double> for the value
       // at the point. It will have as many
       // components as there are in the fe.
-      VectorTools::point_value (*dof_handler, solution, point->requested_location, value);
+      if (triangulation_changed)
+        // the cell found for this point before may not exist any more, so
+        // search it again
+        VectorTools::point_value (*dof_handler, solution, point->requested_location, value);
+      else
+        {
+          const FiniteElement<dim> &fe = dof_handler->get_fe();
+
+          // find the cell around the point and evaluate the shape functions
+          // there only the first time, like VectorTools::point_value does
+          if (point->requested_location_fe != &fe)
+            {
+              const std::pair<typename DoFHandler<dim>::active_cell_iterator, Point<dim> >
+              cell_point
+                = GridTools::find_active_cell_around_point (StaticMappingQ1<dim>::mapping,
+                                                            *dof_handler,
+                                                            point->requested_location);
+              AssertThrow (cell_point.first->is_locally_owned(),
+                           VectorTools::ExcPointNotAvailableHere());
+              const Quadrature<dim>
+              quadrature (GeometryInfo<dim>::project_to_unit_cell(cell_point.second));
+
+              FEValues<dim> fe_values (StaticMappingQ1<dim>::mapping, fe,
+                                       quadrature, update_values);
+              fe_values.reinit (cell_point.first);
+
+              point->requested_location_cell = cell_point.first;
+              point->requested_location_shape_values.reinit (fe.dofs_per_cell,
+                                                             fe.n_components());
+              for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+                for (unsigned int c=0; c<fe.n_components(); ++c)
+                  point->requested_location_shape_values(i,c)
+                    = fe_values.shape_value_component (i, 0, c);
+              point->requested_location_fe = &fe;
+            }
+
+          local_dof_indices.resize (fe.dofs_per_cell);
+          point->requested_location_cell->get_dof_indices (local_dof_indices);
+
+          value = 0;
+          for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+            {
+              const number dof_value
+                = internal::ElementAccess<VectorType>::get (solution,
+                                                            local_dof_indices[i]);
+              for (unsigned int c=0; c<fe.n_components(); ++c)
+                value(c) += dof_value * point->requested_location_shape_values(i,c);
+            }
+        }
 
       // Look up the component_mask and add
       // in components according to that mask
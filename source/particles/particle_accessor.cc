@@ -22,18 +22,24 @@ namespace Particles
   template <int dim, int spacedim>
   ParticleAccessor<dim,spacedim>::ParticleAccessor ()
     :
-    map (NULL),
-    particle ()
+    container (NULL),
+    particle_index (0),
+    cell_slot (0)
   {}
 
 
 
   template <int dim, int spacedim>
-  ParticleAccessor<dim,spacedim>::ParticleAccessor (const std::multimap<internal::LevelInd, Particle<dim,spacedim> > &map,
-                                                    const typename std::multimap<internal::LevelInd, Particle<dim,spacedim> >::iterator &particle)
+  ParticleAccessor<dim,spacedim>::ParticleAccessor (const internal::ParticleContainer<dim,spacedim> &container,
+                                                    const std::size_t particle_index)
     :
-    map (const_cast<std::multimap<internal::LevelInd, Particle<dim,spacedim> > *> (&map)),
-    particle (particle)
+    container (const_cast<internal::ParticleContainer<dim,spacedim> *> (&container)),
+    particle_index (particle_index),
+    cell_slot (particle_index < container.cell_begin(container.n_cells())
+               ?
+               container.cell_slot(particle_index)
+               :
+               container.n_cells())
   {}
 
 
@@ -42,10 +48,33 @@ namespace Particles
   void
   ParticleAccessor<dim,spacedim>::write_data (void *&data) const
   {
-    Assert(particle != map->end(),
+    Assert(particle_index < container->size(),
            ExcInternalError());
 
-    particle->second.write_data(data);
+    types::particle_index *id_data  = static_cast<types::particle_index *> (data);
+    *id_data = container->ids[particle_index];
+    ++id_data;
+    double *pdata = reinterpret_cast<double *> (id_data);
+
+    // Write location data
+    const Point<spacedim> &location = container->locations[particle_index];
+    for (unsigned int i = 0; i < spacedim; ++i,++pdata)
+      *pdata = location(i);
+
+    // Write reference location data
+    const Point<dim> &reference_location = container->reference_locations[particle_index];
+    for (unsigned int i = 0; i < dim; ++i,++pdata)
+      *pdata = reference_location(i);
+
+    // Write property data
+    if (has_properties())
+      {
+        const ArrayView<const double> particle_properties = get_properties();
+        for (unsigned int i = 0; i < particle_properties.size(); ++i,++pdata)
+          *pdata = particle_properties[i];
+      }
+
+    data = static_cast<void *> (pdata);
   }
 
 
@@ -54,10 +83,10 @@ namespace Particles
   void
   ParticleAccessor<dim,spacedim>::set_location (const Point<spacedim> &new_loc)
   {
-    Assert(particle != map->end(),
+    Assert(particle_index < container->size(),
            ExcInternalError());
 
-    particle->second.set_location(new_loc);
+    container->locations[particle_index] = new_loc;
   }
 
 
@@ -66,10 +95,10 @@ namespace Particles
   const Point<spacedim> &
   ParticleAccessor<dim,spacedim>::get_location () const
   {
-    Assert(particle != map->end(),
+    Assert(particle_index < container->size(),
            ExcInternalError());
 
-    return particle->second.get_location();
+    return container->locations[particle_index];
   }
 
 
@@ -78,10 +107,10 @@ namespace Particles
   void
   ParticleAccessor<dim,spacedim>::set_reference_location (const Point<dim> &new_loc)
   {
-    Assert(particle != map->end(),
+    Assert(particle_index < container->size(),
            ExcInternalError());
 
-    particle->second.set_reference_location(new_loc);
+    container->reference_locations[particle_index] = new_loc;
   }
 
 
@@ -90,10 +119,10 @@ namespace Particles
   const Point<dim> &
   ParticleAccessor<dim,spacedim>::get_reference_location () const
   {
-    Assert(particle != map->end(),
+    Assert(particle_index < container->size(),
            ExcInternalError());
 
-    return particle->second.get_reference_location();
+    return container->reference_locations[particle_index];
   }
 
 
@@ -102,10 +131,10 @@ namespace Particles
   types::particle_index
   ParticleAccessor<dim,spacedim>::get_id () const
   {
-    Assert(particle != map->end(),
+    Assert(particle_index < container->size(),
            ExcInternalError());
 
-    return particle->second.get_id();
+    return container->ids[particle_index];
   }
 
 
@@ -114,10 +143,16 @@ namespace Particles
   void
   ParticleAccessor<dim,spacedim>::set_property_pool (PropertyPool &new_property_pool)
   {
-    Assert(particle != map->end(),
+    Assert(particle_index < container->size(),
            ExcInternalError());
-
-    particle->second.set_property_pool(new_property_pool);
+    Assert(container->get_property_pool() == NULL
+           ||
+           container->get_property_pool() == &new_property_pool
+           ||
+           container->size() == 0,
+           ExcMessage("All particles stored in a container share one property pool."));
+
+    container->set_property_pool(new_property_pool);
   }
 
 
@@ -126,10 +161,11 @@ namespace Particles
   bool
   ParticleAccessor<dim,spacedim>::has_properties () const
   {
-    Assert(particle != map->end(),
+    Assert(particle_index < container->size(),
            ExcInternalError());
 
-    return particle->second.has_properties();
+    return (container->get_property_pool() != NULL)
+           && (container->properties[particle_index] != PropertyPool::invalid_handle);
   }
 
 
@@ -138,11 +174,26 @@ namespace Particles
   void
   ParticleAccessor<dim,spacedim>::set_properties (const std::vector<double> &new_properties)
   {
-    Assert(particle != map->end(),
+    Assert(particle_index < container->size(),
+           ExcInternalError());
+    Assert(container->get_property_pool() != NULL,
            ExcInternalError());
 
-    particle->second.set_properties(new_properties);
-    return;
+    PropertyPool &property_pool = *container->get_property_pool();
+    PropertyPool::Handle &handle = container->properties[particle_index];
+    if (handle == PropertyPool::invalid_handle)
+      handle = property_pool.allocate_properties_array();
+
+    const ArrayView<double> old_properties = property_pool.get_properties(handle);
+
+    Assert (new_properties.size() == old_properties.size(),
+            ExcMessage(std::string("You are trying to assign properties with an incompatible length. ")
+                       + "The particle has space to store " + Utilities::to_string(old_properties.size()) + " properties, "
+                       + "and this function tries to assign" + Utilities::to_string(new_properties.size()) + " properties. "
+                       + "This is not allowed."));
+
+    if (old_properties.size() > 0)
+      std::copy(new_properties.begin(), new_properties.end(), old_properties.begin());
   }
 
 
@@ -151,10 +202,12 @@ namespace Particles
   const ArrayView<const double>
   ParticleAccessor<dim,spacedim>::get_properties () const
   {
-    Assert(particle != map->end(),
+    Assert(particle_index < container->size(),
+           ExcInternalError());
+    Assert(container->get_property_pool() != NULL,
            ExcInternalError());
 
-    return particle->second.get_properties();
+    return container->get_property_pool()->get_properties(container->properties[particle_index]);
   }
 
 
@@ -163,12 +216,13 @@ namespace Particles
   typename Triangulation<dim,spacedim>::cell_iterator
   ParticleAccessor<dim,spacedim>::get_surrounding_cell (const Triangulation<dim,spacedim> &triangulation) const
   {
-    Assert(particle != map->end(),
+    Assert(particle_index < container->size(),
            ExcInternalError());
 
+    const internal::LevelInd &level_index = container->get_cell(particle_index, cell_slot);
     const typename Triangulation<dim,spacedim>::cell_iterator cell (&triangulation,
-        particle->first.first,
-        particle->first.second);
+        level_index.first,
+        level_index.second);
     return cell;
   }
 
@@ -178,10 +232,12 @@ namespace Particles
   const ArrayView<double>
   ParticleAccessor<dim,spacedim>::get_properties ()
   {
-    Assert(particle != map->end(),
+    Assert(particle_index < container->size(),
+           ExcInternalError());
+    Assert(container->get_property_pool() != NULL,
            ExcInternalError());
 
-    return particle->second.get_properties();
+    return container->get_property_pool()->get_properties(container->properties[particle_index]);
   }
 
 
@@ -190,10 +246,16 @@ namespace Particles
   std::size_t
   ParticleAccessor<dim,spacedim>::serialized_size_in_bytes () const
   {
-    Assert(particle != map->end(),
+    Assert(particle_index < container->size(),
            ExcInternalError());
 
-    return particle->second.serialized_size_in_bytes();
+    std::size_t size = sizeof(types::particle_index)
+                       + sizeof(Point<spacedim>)
+                       + sizeof(Point<dim>);
+
+    if (has_properties())
+      size += sizeof(double) * get_properties().size();
+    return size;
   }
 
 
@@ -202,8 +264,15 @@ namespace Particles
   void
   ParticleAccessor<dim,spacedim>::next ()
   {
-    Assert (particle != map->end(),ExcInternalError());
-    ++particle;
+    Assert (particle_index < container->size(),ExcInternalError());
+    Assert (container->is_sorted(),ExcInternalError());
+    ++particle_index;
+
+    // the particles are stored cell by cell, and no cell without particles
+    // is stored, so the next particle is either in the same cell or in the
+    // next one
+    if (particle_index == container->cell_begin(cell_slot+1))
+      ++cell_slot;
   }
 
 
@@ -212,8 +281,11 @@ namespace Particles
   void
   ParticleAccessor<dim,spacedim>::prev ()
   {
-    Assert (particle != map->begin(),ExcInternalError());
-    --particle;
+    Assert (particle_index > 0,ExcInternalError());
+    Assert (container->is_sorted(),ExcInternalError());
+    if (particle_index == container->cell_begin(cell_slot))
+      --cell_slot;
+    --particle_index;
   }
 
 
@@ -222,7 +294,7 @@ namespace Particles
   bool
   ParticleAccessor<dim,spacedim>::operator != (const ParticleAccessor<dim,spacedim> &other) const
   {
-    return (map != other.map) || (particle != other.particle);
+    return (container != other.container) || (particle_index != other.particle_index);
   }
 
 
@@ -231,7 +303,7 @@ namespace Particles
   bool
   ParticleAccessor<dim,spacedim>::operator == (const ParticleAccessor<dim,spacedim> &other) const
   {
-    return (map == other.map) && (particle == other.particle);
+    return (container == other.container) && (particle_index == other.particle_index);
   }
 }
 
@@ -0,0 +1,470 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/particles/particle_container.h>
+
+#include <algorithm>
+#include <numeric>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace Particles
+{
+  namespace internal
+  {
+    template <int dim, int spacedim>
+    ParticleContainer<dim,spacedim>::ParticleContainer ()
+      :
+      property_pool (nullptr),
+      cell_offsets (1, 0),
+      modification_counter (0)
+    {}
+
+
+
+    template <int dim, int spacedim>
+    ParticleContainer<dim,spacedim>::~ParticleContainer ()
+    {
+      clear ();
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    ParticleContainer<dim,spacedim>::set_property_pool (PropertyPool &new_property_pool)
+    {
+      property_pool = &new_property_pool;
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    ParticleContainer<dim,spacedim>::clear ()
+    {
+      if (property_pool != nullptr)
+        property_pool->deallocate_properties_arrays(properties);
+
+      locations.clear();
+      reference_locations.clear();
+      ids.clear();
+      properties.clear();
+      cells.clear();
+      cell_offsets.assign(1, 0);
+      unsorted_cells.clear();
+      ++modification_counter;
+    }
+
+
+
+    template <int dim, int spacedim>
+    std::size_t
+    ParticleContainer<dim,spacedim>::max_particles_per_cell () const
+    {
+      Assert (is_sorted(), ExcInternalError());
+
+      std::size_t max_particles = 0;
+      for (unsigned int c=0; c<cells.size(); ++c)
+        max_particles = std::max(max_particles, cell_offsets[c+1]-cell_offsets[c]);
+      return max_particles;
+    }
+
+
+
+    template <int dim, int spacedim>
+    std::pair<std::size_t,std::size_t>
+    ParticleContainer<dim,spacedim>::particle_range (const LevelInd &cell) const
+    {
+      Assert (is_sorted(), ExcInternalError());
+
+      const unsigned int c = std::lower_bound(cells.begin(), cells.end(), cell) - cells.begin();
+      if (c == cells.size() || cells[c] != cell)
+        return std::make_pair(cell_offsets[c], cell_offsets[c]);
+      return std::make_pair(cell_offsets[c], cell_offsets[c+1]);
+    }
+
+
+
+    template <int dim, int spacedim>
+    unsigned int
+    ParticleContainer<dim,spacedim>::cell_slot (const std::size_t index) const
+    {
+      Assert (index <= cell_offsets.back(), ExcInternalError());
+
+      // the first cell that starts behind the particle is the one after the
+      // cell of the particle
+      return (std::upper_bound(cell_offsets.begin(), cell_offsets.end()-1, index)
+              - cell_offsets.begin()) - 1;
+    }
+
+
+
+    template <int dim, int spacedim>
+    std::size_t
+    ParticleContainer<dim,spacedim>::push_back (const LevelInd               &cell,
+                                                const Particle<dim,spacedim> &particle)
+    {
+      locations.push_back(particle.get_location());
+      reference_locations.push_back(particle.get_reference_location());
+      ids.push_back(particle.get_id());
+      unsorted_cells.push_back(cell);
+
+      if (particle.has_properties())
+        {
+          Assert (property_pool != nullptr, ExcInternalError());
+          const PropertyPool::Handle handle = property_pool->allocate_properties_array();
+          const ArrayView<const double> their_properties = particle.get_properties();
+          const ArrayView<double> my_properties = property_pool->get_properties(handle);
+          std::copy(their_properties.begin(), their_properties.end(), my_properties.begin());
+          properties.push_back(handle);
+        }
+      else
+        properties.push_back(PropertyPool::invalid_handle);
+
+      ++modification_counter;
+      return size()-1;
+    }
+
+
+
+    template <int dim, int spacedim>
+    std::size_t
+    ParticleContainer<dim,spacedim>::push_back (const LevelInd  &cell,
+                                                const void    *&data)
+    {
+      Assert (property_pool != nullptr, ExcInternalError());
+
+      // this is the format written by Particle::write_data()
+      const types::particle_index *id_data = static_cast<const types::particle_index *> (data);
+      ids.push_back(*id_data++);
+      const double *pdata = reinterpret_cast<const double *> (id_data);
+
+      Point<spacedim> location;
+      for (unsigned int i = 0; i < spacedim; ++i)
+        location(i) = *pdata++;
+      locations.push_back(location);
+
+      Point<dim> reference_location;
+      for (unsigned int i = 0; i < dim; ++i)
+        reference_location(i) = *pdata++;
+      reference_locations.push_back(reference_location);
+
+      const PropertyPool::Handle handle = property_pool->allocate_properties_array();
+      const ArrayView<double> particle_properties = property_pool->get_properties(handle);
+      for (unsigned int i = 0; i < particle_properties.size(); ++i)
+        particle_properties[i] = *pdata++;
+      properties.push_back(handle);
+
+      unsorted_cells.push_back(cell);
+      ++modification_counter;
+
+      data = static_cast<const void *> (pdata);
+      return size()-1;
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    ParticleContainer<dim,spacedim>::sort ()
+    {
+      if (is_sorted())
+        return;
+
+      const std::size_t n_sorted = cell_offsets.back();
+      const std::size_t n_new = unsorted_cells.size();
+
+      // sort the tail by its cells, keeping the order within each cell
+      std::vector<std::size_t> permutation(n_new);
+      std::iota(permutation.begin(), permutation.end(), 0);
+      std::stable_sort(permutation.begin(), permutation.end(),
+                       [&](const std::size_t a, const std::size_t b)
+      {
+        return unsorted_cells[a] < unsorted_cells[b];
+      });
+
+      std::vector<Point<spacedim> > new_locations(n_new);
+      std::vector<Point<dim> > new_reference_locations(n_new);
+      std::vector<types::particle_index> new_ids(n_new);
+      std::vector<PropertyPool::Handle> new_properties(n_new);
+      std::vector<LevelInd> new_cells(n_new);
+      for (std::size_t i=0; i<n_new; ++i)
+        {
+          new_locations[i] = locations[n_sorted+permutation[i]];
+          new_reference_locations[i] = reference_locations[n_sorted+permutation[i]];
+          new_ids[i] = ids[n_sorted+permutation[i]];
+          new_properties[i] = properties[n_sorted+permutation[i]];
+          new_cells[i] = unsorted_cells[permutation[i]];
+        }
+
+      // merge the two sorted sequences in place, starting from the back of
+      // the arrays, which already have the final size. new particles go
+      // behind the old ones of the same cell
+      std::size_t old_index = n_sorted;
+      std::size_t new_index = n_new;
+      std::size_t destination = n_sorted + n_new;
+      unsigned int old_cell = cells.size();
+      while (new_index > 0)
+        {
+          if (old_index > 0)
+            while (cell_offsets[old_cell] >= old_index)
+              --old_cell;
+
+          --destination;
+          if (old_index > 0 && new_cells[new_index-1] < cells[old_cell])
+            {
+              --old_index;
+              locations[destination] = locations[old_index];
+              reference_locations[destination] = reference_locations[old_index];
+              ids[destination] = ids[old_index];
+              properties[destination] = properties[old_index];
+            }
+          else
+            {
+              --new_index;
+              locations[destination] = new_locations[new_index];
+              reference_locations[destination] = new_reference_locations[new_index];
+              ids[destination] = new_ids[new_index];
+              properties[destination] = new_properties[new_index];
+            }
+        }
+
+      // merge the lists of cells and their number of particles
+      std::vector<LevelInd> merged_cells;
+      std::vector<std::size_t> merged_offsets(1, 0);
+      merged_cells.reserve(cells.size()+n_new);
+      merged_offsets.reserve(cells.size()+n_new+1);
+      unsigned int c = 0;
+      std::size_t n = 0;
+      while (c < cells.size() || n < n_new)
+        {
+          LevelInd cell;
+          if (n == n_new || (c < cells.size() && !(new_cells[n] < cells[c])))
+            cell = cells[c];
+          else
+            cell = new_cells[n];
+
+          std::size_t n_particles = 0;
+          if (c < cells.size() && cells[c] == cell)
+            {
+              n_particles += cell_offsets[c+1] - cell_offsets[c];
+              ++c;
+            }
+          while (n < n_new && new_cells[n] == cell)
+            {
+              ++n_particles;
+              ++n;
+            }
+
+          merged_cells.push_back(cell);
+          merged_offsets.push_back(merged_offsets.back() + n_particles);
+        }
+
+      cells.swap(merged_cells);
+      cell_offsets.swap(merged_offsets);
+      unsorted_cells.clear();
+      ++modification_counter;
+
+      AssertDimension (cell_offsets.back(), size());
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    ParticleContainer<dim,spacedim>::merge (ParticleContainer<dim,spacedim> &other)
+    {
+      Assert (is_sorted(), ExcInternalError());
+      Assert (other.size() == 0 || other.property_pool == property_pool,
+              ExcMessage("Particles can only be merged from a container that "
+                         "uses the same property pool."));
+
+      unsorted_cells.reserve(other.size());
+      for (unsigned int c=0; c<other.cells.size(); ++c)
+        unsorted_cells.insert(unsorted_cells.end(),
+                              other.cell_offsets[c+1] - other.cell_offsets[c],
+                              other.cells[c]);
+      unsorted_cells.insert(unsorted_cells.end(),
+                            other.unsorted_cells.begin(), other.unsorted_cells.end());
+
+      locations.insert(locations.end(), other.locations.begin(), other.locations.end());
+      reference_locations.insert(reference_locations.end(),
+                                 other.reference_locations.begin(),
+                                 other.reference_locations.end());
+      ids.insert(ids.end(), other.ids.begin(), other.ids.end());
+      properties.insert(properties.end(), other.properties.begin(), other.properties.end());
+
+      // the handles now belong to this container
+      other.properties.clear();
+      other.clear();
+
+      sort();
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    ParticleContainer<dim,spacedim>::relocate (const std::vector<std::size_t> &moved_particles,
+                                               const std::vector<LevelInd>    &new_cells,
+                                               const std::vector<std::size_t> &removed_particles)
+    {
+      Assert (is_sorted(), ExcInternalError());
+      AssertDimension (moved_particles.size(), new_cells.size());
+
+      std::vector<bool> remove(size(), false);
+
+      // keep the data of the moved particles, including their property
+      // handles, to append them again after removing them from their old
+      // cells
+      std::vector<Point<spacedim> > moved_locations(moved_particles.size());
+      std::vector<Point<dim> > moved_reference_locations(moved_particles.size());
+      std::vector<types::particle_index> moved_ids(moved_particles.size());
+      std::vector<PropertyPool::Handle> moved_properties(moved_particles.size());
+      for (std::size_t i=0; i<moved_particles.size(); ++i)
+        {
+          const std::size_t index = moved_particles[i];
+          AssertIndexRange (index, size());
+          Assert (remove[index] == false, ExcInternalError());
+          moved_locations[i] = locations[index];
+          moved_reference_locations[i] = reference_locations[index];
+          moved_ids[i] = ids[index];
+          moved_properties[i] = properties[index];
+          remove[index] = true;
+        }
+
+      for (const std::size_t index : removed_particles)
+        {
+          AssertIndexRange (index, size());
+          Assert (remove[index] == false, ExcInternalError());
+          if (properties[index] != PropertyPool::invalid_handle)
+            property_pool->deallocate_properties_array(properties[index]);
+          remove[index] = true;
+        }
+
+      compact(remove);
+
+      locations.insert(locations.end(), moved_locations.begin(), moved_locations.end());
+      reference_locations.insert(reference_locations.end(),
+                                 moved_reference_locations.begin(),
+                                 moved_reference_locations.end());
+      ids.insert(ids.end(), moved_ids.begin(), moved_ids.end());
+      properties.insert(properties.end(), moved_properties.begin(), moved_properties.end());
+      unsorted_cells = new_cells;
+
+      sort();
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    ParticleContainer<dim,spacedim>::erase (const std::size_t index)
+    {
+      Assert (is_sorted(), ExcInternalError());
+      AssertIndexRange (index, size());
+
+      if (properties[index] != PropertyPool::invalid_handle)
+        property_pool->deallocate_properties_array(properties[index]);
+
+      std::vector<bool> remove(size(), false);
+      remove[index] = true;
+      compact(remove);
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    ParticleContainer<dim,spacedim>::read_data (const std::size_t  index,
+                                                const void       *&data)
+    {
+      AssertIndexRange (index, size());
+
+      // this is the format written by Particle::write_data()
+      const types::particle_index *id_data = static_cast<const types::particle_index *> (data);
+      ids[index] = *id_data++;
+      const double *pdata = reinterpret_cast<const double *> (id_data);
+
+      for (unsigned int i = 0; i < spacedim; ++i)
+        locations[index](i) = *pdata++;
+
+      for (unsigned int i = 0; i < dim; ++i)
+        reference_locations[index](i) = *pdata++;
+
+      if (properties[index] != PropertyPool::invalid_handle)
+        {
+          const ArrayView<double> particle_properties = property_pool->get_properties(properties[index]);
+          for (unsigned int i = 0; i < particle_properties.size(); ++i)
+            particle_properties[i] = *pdata++;
+        }
+
+      data = static_cast<const void *> (pdata);
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    ParticleContainer<dim,spacedim>::compact (const std::vector<bool> &remove)
+    {
+      Assert (is_sorted(), ExcInternalError());
+      AssertDimension (remove.size(), size());
+
+      std::size_t destination = 0;
+      unsigned int destination_cell = 0;
+      for (unsigned int c=0; c<cells.size(); ++c)
+        {
+          const std::size_t cell_start = destination;
+          for (std::size_t i=cell_offsets[c]; i<cell_offsets[c+1]; ++i)
+            if (!remove[i])
+              {
+                locations[destination] = locations[i];
+                reference_locations[destination] = reference_locations[i];
+                ids[destination] = ids[i];
+                properties[destination] = properties[i];
+                ++destination;
+              }
+
+          // drop cells without particles
+          if (destination > cell_start)
+            {
+              cells[destination_cell] = cells[c];
+              cell_offsets[destination_cell] = cell_start;
+              ++destination_cell;
+            }
+        }
+
+      cells.resize(destination_cell);
+      cell_offsets.resize(destination_cell+1);
+      cell_offsets[destination_cell] = destination;
+
+      locations.resize(destination);
+      reference_locations.resize(destination);
+      ids.resize(destination);
+      properties.resize(destination);
+      ++modification_counter;
+    }
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+DEAL_II_NAMESPACE_OPEN
+
+#include "particle_container.inst"
+
+DEAL_II_NAMESPACE_CLOSE
@@ -15,9 +15,11 @@
 
 #include <deal.II/particles/particle_handler.h>
 
+#include <deal.II/base/parallel.h>
 #include <deal.II/grid/grid_tools.h>
 #include <deal.II/grid/grid_tools_cache.h>
 
+#include <numeric>
 #include <utility>
 
 DEAL_II_NAMESPACE_OPEN
@@ -40,7 +42,10 @@ namespace Particles
     store_callback(),
     load_callback(),
     data_offset(numbers::invalid_unsigned_int)
-  {}
+  {
+    particles.set_property_pool(*property_pool);
+    ghost_particles.set_property_pool(*property_pool);
+  }
 
 
 
@@ -51,6 +56,7 @@ namespace Particles
     :
     triangulation(&triangulation, typeid(*this).name()),
     mapping(&mapping, typeid(*this).name()),
+    triangulation_cache(new GridTools::Cache<dim,spacedim>(triangulation, mapping)),
     particles(),
     ghost_particles(),
     global_number_of_particles(0),
@@ -61,13 +67,21 @@ namespace Particles
     store_callback(),
     load_callback(),
     data_offset(numbers::invalid_unsigned_int)
-  {}
+  {
+    particles.set_property_pool(*property_pool);
+    ghost_particles.set_property_pool(*property_pool);
+  }
 
 
 
   template <int dim,int spacedim>
   ParticleHandler<dim,spacedim>::~ParticleHandler()
-  {}
+  {
+    // return the properties of all particles to the property pool before
+    // it is destroyed
+    particles.clear();
+    ghost_particles.clear();
+  }
 
 
 
@@ -77,11 +91,18 @@ namespace Particles
                                             const Mapping<dim,spacedim> &mapp,
                                             const unsigned int n_properties)
   {
+    triangulation_cache.reset(new GridTools::Cache<dim,spacedim>(tria, mapp));
     triangulation = &tria;
     mapping = &mapp;
 
+    // The properties of existing particles are stored in the old pool
+    particles.clear();
+    ghost_particles.clear();
+
     // Create the memory pool that will store all particle properties
     property_pool.reset(new PropertyPool(n_properties));
+    particles.set_property_pool(*property_pool);
+    ghost_particles.set_property_pool(*property_pool);
   }
 
 
@@ -113,24 +134,10 @@ namespace Particles
   {
 
     types::particle_index locally_highest_index = 0;
-    unsigned int local_max_particles_per_cell = 0;
-    unsigned int current_particles_per_cell = 0;
-    typename Triangulation<dim,spacedim>::active_cell_iterator current_cell = triangulation->begin_active();
+    for (const types::particle_index id : particles.ids)
+      locally_highest_index = std::max(locally_highest_index,id);
 
-    for (particle_iterator particle = begin(); particle != end(); ++particle)
-      {
-        locally_highest_index = std::max(locally_highest_index,particle->get_id());
-
-        if (particle->get_surrounding_cell(*triangulation) != current_cell)
-          {
-            current_particles_per_cell = 0;
-            current_cell = particle->get_surrounding_cell(*triangulation);
-          }
-
-        ++current_particles_per_cell;
-        local_max_particles_per_cell = std::max(local_max_particles_per_cell,
-                                                current_particles_per_cell);
-      }
+    const unsigned int local_max_particles_per_cell = particles.max_particles_per_cell();
 
     global_number_of_particles = dealii::Utilities::MPI::sum (particles.size(), triangulation->get_communicator());
     next_free_particle_index = dealii::Utilities::MPI::max (locally_highest_index, triangulation->get_communicator()) + 1;
@@ -153,7 +160,7 @@ namespace Particles
   typename ParticleHandler<dim,spacedim>::particle_iterator
   ParticleHandler<dim,spacedim>::begin()
   {
-    return particle_iterator(particles,particles.begin());
+    return particle_iterator(particles,0);
   }
 
 
@@ -171,7 +178,7 @@ namespace Particles
   typename ParticleHandler<dim,spacedim>::particle_iterator
   ParticleHandler<dim,spacedim>::end()
   {
-    return particle_iterator(particles,particles.end());
+    return particle_iterator(particles,particles.size());
   }
 
 
@@ -189,7 +196,7 @@ namespace Particles
   typename ParticleHandler<dim,spacedim>::particle_iterator
   ParticleHandler<dim,spacedim>::begin_ghost()
   {
-    return particle_iterator(ghost_particles,ghost_particles.begin());
+    return particle_iterator(ghost_particles,0);
   }
 
 
@@ -207,7 +214,7 @@ namespace Particles
   typename ParticleHandler<dim,spacedim>::particle_iterator
   ParticleHandler<dim,spacedim>::end_ghost()
   {
-    return particle_iterator(ghost_particles,ghost_particles.end());
+    return particle_iterator(ghost_particles,ghost_particles.size());
   }
 
 
@@ -229,12 +236,12 @@ namespace Particles
 
     if (cell->is_ghost())
       {
-        const auto particles_in_cell = ghost_particles.equal_range(level_index);
+        const auto particles_in_cell = ghost_particles.particle_range(level_index);
         return boost::make_iterator_range(particle_iterator(ghost_particles,particles_in_cell.first),
                                           particle_iterator(ghost_particles,particles_in_cell.second));
       }
 
-    const auto particles_in_cell = particles.equal_range(level_index);
+    const auto particles_in_cell = particles.particle_range(level_index);
     return boost::make_iterator_range(particle_iterator(particles,particles_in_cell.first),
                                       particle_iterator(particles,particles_in_cell.second));
   }
@@ -245,7 +252,7 @@ namespace Particles
   void
   ParticleHandler<dim,spacedim>::remove_particle(const ParticleHandler<dim,spacedim>::particle_iterator &particle)
   {
-    particles.erase(particle->particle);
+    particles.erase(particle->particle_index);
   }
 
 
@@ -255,17 +262,12 @@ namespace Particles
   ParticleHandler<dim,spacedim>::insert_particle(const Particle<dim,spacedim> &particle,
                                                  const typename Triangulation<dim,spacedim>::active_cell_iterator &cell)
   {
-    typename std::multimap<internal::LevelInd, Particle<dim,spacedim> >::iterator it =
-      particles.insert(std::make_pair(internal::LevelInd(cell->level(),cell->index()),particle));
-
-    particle_iterator particle_it (particles,it);
-    particle_it->set_property_pool(*property_pool);
+    const internal::LevelInd level_index (cell->level(),cell->index());
+    particles.push_back(level_index, particle);
+    particles.sort();
 
-    if (particle.has_properties())
-      for (unsigned int n=0; n<particle.get_properties().size(); ++n)
-        particle_it->get_properties()[n] = particle.get_properties()[n];
-
-    return particle_it;
+    // the new particle is the last one in its cell
+    return particle_iterator(particles,particles.particle_range(level_index).second-1);
   }
 
 
@@ -275,10 +277,11 @@ namespace Particles
   ParticleHandler<dim,spacedim>::insert_particles(const std::multimap<typename Triangulation<dim,spacedim>::active_cell_iterator,
                                                   Particle<dim,spacedim> > &new_particles)
   {
+    property_pool->reserve(new_particles.size());
     for (auto particle = new_particles.begin(); particle != new_particles.end(); ++particle)
-      particles.insert(particles.end(),
-                       std::make_pair(internal::LevelInd(particle->first->level(),particle->first->index()),
-                                      particle->second));
+      particles.push_back(internal::LevelInd(particle->first->level(),particle->first->index()),
+                          particle->second);
+    particles.sort();
 
     update_cached_numbers();
   }
@@ -316,19 +319,16 @@ namespace Particles
     if (cells.size() == 0)
       return;
 
-    auto hint = particles.find(std::make_pair(cells[0]->level(),cells[0]->index()));
     for (unsigned int i=0; i<cells.size(); ++i)
       {
         internal::LevelInd current_cell(cells[i]->level(),cells[i]->index());
         for (unsigned int p=0; p<local_positions[i].size(); ++p)
-          {
-            hint = particles.insert(hint,
-                                    std::make_pair(current_cell,
-                                                   Particle<dim,spacedim>(positions[index_map[i][p]],
-                                                       local_positions[i][p],
-                                                       local_start_index+index_map[i][p])));
-          }
+          particles.push_back(current_cell,
+                              Particle<dim,spacedim>(positions[index_map[i][p]],
+                                                     local_positions[i][p],
+                                                     local_start_index+index_map[i][p]));
       }
+    particles.sort();
 
     update_cached_numbers();
   }
@@ -378,9 +378,15 @@ namespace Particles
     const internal::LevelInd found_cell = std::make_pair<int, int> (cell->level(),cell->index());
 
     if (cell->is_locally_owned())
-      return particles.count(found_cell);
+      {
+        const std::pair<std::size_t,std::size_t> range = particles.particle_range(found_cell);
+        return range.second - range.first;
+      }
     else if (cell->is_ghost())
-      return ghost_particles.count(found_cell);
+      {
+        const std::pair<std::size_t,std::size_t> range = ghost_particles.particle_range(found_cell);
+        return range.second - range.first;
+      }
     else if (cell->is_artificial())
       AssertThrow(false,ExcInternalError());
 
@@ -409,6 +415,15 @@ namespace Particles
 
   namespace
   {
+    /**
+     * The number of cells with particles, and the number of particles that
+     * have left their cells, that are processed by one task.
+     */
+    const unsigned int cells_per_task = 32;
+    const unsigned int particles_per_task = 64;
+
+
+
     /**
      * This function is used as comparison argument to std::sort to sort the
      * vector of tensors @p center_directions by its scalar product with the
@@ -433,6 +448,27 @@ namespace Particles
       // therefore return if the scalar product of a is larger.
       return (scalar_product_a > scalar_product_b);
     }
+
+
+
+    /**
+     * Return whether the point @p p lies inside the box @p box enlarged by a
+     * quarter of its extent in each direction.
+     */
+    template <int spacedim>
+    bool
+    point_inside_enlarged_box (const BoundingBox<spacedim> &box,
+                               const Point<spacedim>       &p)
+    {
+      const std::pair<Point<spacedim>,Point<spacedim> > &corners = box.get_boundary_points();
+      for (unsigned int d=0; d<spacedim; ++d)
+        {
+          const double margin = 0.25 * (corners.second[d] - corners.first[d]);
+          if (p[d] < corners.first[d] - margin || p[d] > corners.second[d] + margin)
+            return false;
+        }
+      return true;
+    }
   }
 
 
@@ -449,41 +485,182 @@ namespace Particles
     // TODO: Extend this function to allow keeping particles on other
     // processes around (with an invalid cell).
 
-    std::vector<particle_iterator> particles_out_of_cell;
-    particles_out_of_cell.reserve(n_locally_owned_particles());
+    // Now update the reference locations of the moved particles. The
+    // particles of a cell are stored consecutively, so we can map all of
+    // them at once. The cells are independent of each other and are
+    // processed in parallel. Particles that left their cell are marked in
+    // out_of_cell, which every task only writes for its own particles
+    std::vector<char> out_of_cell(particles.size(), 0);
+    parallel::apply_to_subranges
+    (0U, particles.n_cells(),
+     [&](const unsigned int begin, const unsigned int end)
+    {
+      std::vector<Point<dim> > reference_locations;
+      for (unsigned int c=begin; c<end; ++c)
+        {
+          const std::size_t first_particle = particles.cell_begin(c);
+          const std::size_t n_particles = particles.cell_begin(c+1) - first_particle;
+          const internal::LevelInd &level_index = particles.get_cell(first_particle, c);
+          const typename Triangulation<dim,spacedim>::cell_iterator cell (&*triangulation,
+              level_index.first,
+              level_index.second);
+
+          reference_locations.resize(n_particles);
+          mapping->transform_points_real_to_unit_cell(cell,
+                                                      ArrayView<const Point<spacedim> >(&particles.locations[first_particle],
+                                                          n_particles),
+                                                      ArrayView<Point<dim> >(&reference_locations[0],
+                                                          n_particles));
+
+          for (std::size_t i=0; i<n_particles; ++i)
+            if (GeometryInfo<dim>::is_inside_unit_cell(reference_locations[i]))
+              particles.reference_locations[first_particle+i] = reference_locations[i];
+            else
+              {
+                // The particle has left the cell
+                out_of_cell[first_particle+i] = 1;
+              }
+        }
+    },
+    cells_per_task);
 
-    // Now update the reference locations of the moved particles
-    for (particle_iterator it=begin(); it!=end(); ++it)
+    std::vector<std::size_t> particles_out_of_cell;
+    for (std::size_t i=0; i<out_of_cell.size(); ++i)
+      if (out_of_cell[i])
+        particles_out_of_cell.push_back(i);
+
+    // There are three reasons why a particle is not in its old cell:
+    // It moved to another cell, to another subdomain or it left the mesh.
+    // The search for the new cells is done in parallel, storing the new
+    // cell of each particle that left its cell in new_cells, or the end
+    // iterator if no cell was found.
+    const typename Triangulation<dim,spacedim>::active_cell_iterator end_cell = triangulation->end();
+    std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> new_cells (particles_out_of_cell.size(),
+        end_cell);
+
+    {
+      // The map from vertices to adjacent cells, the corresponding map of
+      // vectors from vertex to cell center, and the bounding boxes of the
+      // cells are only recomputed when the triangulation changes. They are
+      // requested here, before the parallel region, because the cache is
+      // updated lazily and is not thread-safe
+      const std::vector<std::set<typename Triangulation<dim,spacedim>::active_cell_iterator> >
+      &vertex_to_cells = triangulation_cache->get_vertex_to_cell_map();
+
+      const std::vector<std::vector<Tensor<1,spacedim> > >
+      &vertex_to_cell_centers = triangulation_cache->get_vertex_to_cell_centers_directions();
+
+      const std::vector<BoundingBox<spacedim> > &cell_bounding_boxes
+        = triangulation_cache->get_cell_bounding_boxes();
+
+      parallel::apply_to_subranges
+      (std::size_t(0), particles_out_of_cell.size(),
+       [&](const std::size_t begin, const std::size_t end)
       {
-        const typename Triangulation<dim,spacedim>::cell_iterator cell = it->get_surrounding_cell(*triangulation);
+        std::vector<unsigned int> neighbor_permutation;
 
-        try
+        // Find the cells that the particles moved to.
+        for (std::size_t p=begin; p<end; ++p)
           {
-            const Point<dim> p_unit = mapping->transform_real_to_unit_cell(cell, it->get_location());
-            if (GeometryInfo<dim>::is_inside_unit_cell(p_unit))
+            const particle_iterator it (particles, particles_out_of_cell[p]);
+
+            // The cell the particle is in
+            Point<dim> current_reference_position;
+            bool found_cell = false;
+
+            // Check if the particle is in one of the old cell's neighbors
+            // that are adjacent to the closest vertex
+            typename Triangulation<dim,spacedim>::active_cell_iterator current_cell = it->get_surrounding_cell(*triangulation);
+
+            const unsigned int closest_vertex = GridTools::find_closest_vertex_of_cell<dim,spacedim>(current_cell,it->get_location());
+            Tensor<1,spacedim> vertex_to_particle = it->get_location() - current_cell->vertex(closest_vertex);
+            vertex_to_particle /= vertex_to_particle.norm();
+
+            const unsigned int closest_vertex_index = current_cell->vertex_index(closest_vertex);
+            const unsigned int n_neighbor_cells = vertex_to_cells[closest_vertex_index].size();
+
+            neighbor_permutation.resize(n_neighbor_cells);
+            for (unsigned int i=0; i<n_neighbor_cells; ++i)
+              neighbor_permutation[i] = i;
+
+            std::sort(neighbor_permutation.begin(),
+                      neighbor_permutation.end(),
+                      std::bind(&compare_particle_association<spacedim>,
+                                std::placeholders::_1,
+                                std::placeholders::_2,
+                                std::cref(vertex_to_particle),
+                                std::cref(vertex_to_cell_centers[closest_vertex_index])));
+
+            // Search all of the cells adjacent to the closest vertex of the previous cell
+            // Most likely we will find the particle in them.
+            for (unsigned int i=0; i<n_neighbor_cells; ++i)
               {
-                it->set_reference_location(p_unit);
+                typename std::set<typename Triangulation<dim,spacedim>::active_cell_iterator>::const_iterator
+                cell = vertex_to_cells[closest_vertex_index].begin();
+                std::advance(cell,neighbor_permutation[i]);
+
+                // Skip cells whose bounding box is far away from the
+                // particle. The margin allows for cells that are curved by
+                // the mapping
+                if (!point_inside_enlarged_box(cell_bounding_boxes[(*cell)->active_cell_index()],
+                                               it->get_location()))
+                  continue;
+
+                try
+                  {
+                    const Point<dim> p_unit = mapping->transform_real_to_unit_cell(*cell,
+                                              it->get_location());
+                    if (GeometryInfo<dim>::is_inside_unit_cell(p_unit))
+                      {
+                        current_cell = *cell;
+                        current_reference_position = p_unit;
+                        found_cell = true;
+                        break;
+                      }
+                  }
+                catch (typename Mapping<dim>::ExcTransformationFailed &)
+                  {}
               }
-            else
+
+            if (!found_cell)
               {
-                // The particle has left the cell
-                particles_out_of_cell.push_back(it);
+                // The particle is not in a neighbor of the old cell.
+                // Look for the new cell in the whole local domain.
+                // This case is rare.
+                try
+                  {
+                    const std::pair<const typename Triangulation<dim,spacedim>::active_cell_iterator,
+                          Point<dim> > current_cell_and_position =
+                            GridTools::find_active_cell_around_point<> (*mapping,
+                                                                        *triangulation,
+                                                                        it->get_location());
+                    current_cell = current_cell_and_position.first;
+                    current_reference_position = current_cell_and_position.second;
+                  }
+                catch (GridTools::ExcPointNotFound<spacedim> &)
+                  {
+                    // We can find no cell for this particle. It has left the
+                    // domain due to an integration error or an open boundary.
+                    continue;
+                  }
               }
+
+            // If we are here, we found a cell and reference position for this particle
+            particles.reference_locations[particles_out_of_cell[p]] = current_reference_position;
+            new_cells[p] = current_cell;
           }
-        catch (typename Mapping<dim>::ExcTransformationFailed &)
-          {
-            // The particle has left the cell
-            particles_out_of_cell.push_back(it);
-          }
-      }
+      },
+      particles_per_task);
+    }
 
-    // There are three reasons why a particle is not in its old cell:
-    // It moved to another cell, to another subdomain or it left the mesh.
-    // Particles that moved to another cell are updated and stored inside the
-    // sorted_particles vector, particles that moved to another domain are
-    // collected in the moved_particles_domain vector. Particles that left
-    // the mesh completely are ignored and removed.
-    std::vector<std::pair<internal::LevelInd, Particle<dim,spacedim> > > sorted_particles;
+    // Particles that moved to another cell are recorded together with their
+    // new cells in the sorted_particles and sorted_cells vectors, particles
+    // that moved to another domain are collected in the moved_particles map.
+    // Particles that left the mesh completely and the ones that are sent
+    // away are removed.
+    std::vector<std::size_t> sorted_particles;
+    std::vector<internal::LevelInd> sorted_cells;
+    std::vector<std::size_t> removed_particles;
     std::map<types::subdomain_id, std::vector<particle_iterator> > moved_particles;
     std::map<types::subdomain_id, std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> > moved_cells;
 
@@ -494,6 +671,7 @@ namespace Particles
     // re-allocation will happen.
     typedef typename std::vector<particle_iterator>::size_type vector_size;
     sorted_particles.reserve(static_cast<vector_size> (particles_out_of_cell.size()*1.25));
+    sorted_cells.reserve(static_cast<vector_size> (particles_out_of_cell.size()*1.25));
 
     const std::set<types::subdomain_id> ghost_owners = triangulation->ghost_owners();
 
@@ -502,131 +680,42 @@ namespace Particles
     for (auto ghost_domain_id = ghost_owners.begin(); ghost_domain_id != ghost_owners.end(); ++ghost_domain_id)
       moved_cells[*ghost_domain_id].reserve(static_cast<vector_size> (particles_out_of_cell.size()*0.25));
 
-    {
-      // Create a map from vertices to adjacent cells
-      const std::vector<std::set<typename Triangulation<dim,spacedim>::active_cell_iterator> >
-      vertex_to_cells(GridTools::vertex_to_cell_map(*triangulation));
-
-      // Create a corresponding map of vectors from vertex to cell center
-      const std::vector<std::vector<Tensor<1,spacedim> > >
-      vertex_to_cell_centers(GridTools::vertex_to_cell_centers_directions(*triangulation,vertex_to_cells));
-
-      std::vector<unsigned int> neighbor_permutation;
-
-      // Find the cells that the particles moved to.
-      typename std::vector<particle_iterator>::iterator it = particles_out_of_cell.begin(),
-                                                        end_particle = particles_out_of_cell.end();
-
-      for (; it!=end_particle; ++it)
-        {
-          // The cell the particle is in
-          Point<dim> current_reference_position;
-          bool found_cell = false;
-
-          // Check if the particle is in one of the old cell's neighbors
-          // that are adjacent to the closest vertex
-          typename Triangulation<dim,spacedim>::active_cell_iterator current_cell = (*it)->get_surrounding_cell(*triangulation);
-
-          const unsigned int closest_vertex = GridTools::find_closest_vertex_of_cell<dim,spacedim>(current_cell,(*it)->get_location());
-          Tensor<1,spacedim> vertex_to_particle = (*it)->get_location() - current_cell->vertex(closest_vertex);
-          vertex_to_particle /= vertex_to_particle.norm();
-
-          const unsigned int closest_vertex_index = current_cell->vertex_index(closest_vertex);
-          const unsigned int n_neighbor_cells = vertex_to_cells[closest_vertex_index].size();
-
-          neighbor_permutation.resize(n_neighbor_cells);
-          for (unsigned int i=0; i<n_neighbor_cells; ++i)
-            neighbor_permutation[i] = i;
-
-          std::sort(neighbor_permutation.begin(),
-                    neighbor_permutation.end(),
-                    std::bind(&compare_particle_association<spacedim>,
-                              std::placeholders::_1,
-                              std::placeholders::_2,
-                              std::cref(vertex_to_particle),
-                              std::cref(vertex_to_cell_centers[closest_vertex_index])));
-
-          // Search all of the cells adjacent to the closest vertex of the previous cell
-          // Most likely we will find the particle in them.
-          for (unsigned int i=0; i<n_neighbor_cells; ++i)
-            {
-              try
-                {
-                  typename std::set<typename Triangulation<dim,spacedim>::active_cell_iterator>::const_iterator
-                  cell = vertex_to_cells[closest_vertex_index].begin();
-
-                  std::advance(cell,neighbor_permutation[i]);
-                  const Point<dim> p_unit = mapping->transform_real_to_unit_cell(*cell,
-                                            (*it)->get_location());
-                  if (GeometryInfo<dim>::is_inside_unit_cell(p_unit))
-                    {
-                      current_cell = *cell;
-                      current_reference_position = p_unit;
-                      found_cell = true;
-                      break;
-                    }
-                }
-              catch (typename Mapping<dim>::ExcTransformationFailed &)
-                {}
-            }
-
-          if (!found_cell)
-            {
-              // The particle is not in a neighbor of the old cell.
-              // Look for the new cell in the whole local domain.
-              // This case is rare.
-              try
-                {
-                  const std::pair<const typename Triangulation<dim,spacedim>::active_cell_iterator,
-                        Point<dim> > current_cell_and_position =
-                          GridTools::find_active_cell_around_point<> (*mapping,
-                                                                      *triangulation,
-                                                                      (*it)->get_location());
-                  current_cell = current_cell_and_position.first;
-                  current_reference_position = current_cell_and_position.second;
-                }
-              catch (GridTools::ExcPointNotFound<spacedim> &)
-                {
-                  // We can find no cell for this particle. It has left the
-                  // domain due to an integration error or an open boundary.
-                  continue;
-                }
-            }
-
-          // If we are here, we found a cell and reference position for this particle
-          (*it)->set_reference_location(current_reference_position);
-
-          // Reinsert the particle into our domain if we own its cell.
-          // Mark it for MPI transfer otherwise
-          if (current_cell->is_locally_owned())
-            {
-              sorted_particles.push_back(std::make_pair(internal::LevelInd(current_cell->level(),current_cell->index()),
-                                                        (*it)->particle->second));
-            }
-          else
-            {
-              moved_particles[current_cell->subdomain_id()].push_back(*it);
-              moved_cells[current_cell->subdomain_id()].push_back(current_cell);
-            }
-        }
-    }
+    for (std::size_t p=0; p<particles_out_of_cell.size(); ++p)
+      {
+        const std::size_t particle_index = particles_out_of_cell[p];
+        const typename Triangulation<dim,spacedim>::active_cell_iterator &current_cell = new_cells[p];
+
+        if (current_cell == end_cell)
+          removed_particles.push_back(particle_index);
+        // Reinsert the particle into our domain if we own its cell.
+        // Mark it for MPI transfer otherwise
+        else if (current_cell->is_locally_owned())
+          {
+            sorted_particles.push_back(particle_index);
+            sorted_cells.push_back(internal::LevelInd(current_cell->level(),current_cell->index()));
+          }
+        else
+          {
+            moved_particles[current_cell->subdomain_id()].push_back(particle_iterator(particles,particle_index));
+            moved_cells[current_cell->subdomain_id()].push_back(current_cell);
+            removed_particles.push_back(particle_index);
+          }
+      }
 
-    // Sort the updated particles. This pre-sort speeds up inserting
-    // them into particles to O(N) complexity.
-    std::multimap<internal::LevelInd,Particle <dim,spacedim> > sorted_particles_map;
+    internal::ParticleContainer<dim,spacedim> received_particles;
+    received_particles.set_property_pool(*property_pool);
 
     // Exchange particles between processors if we have more than one process
 #ifdef DEAL_II_WITH_MPI
     if (dealii::Utilities::MPI::n_mpi_processes(triangulation->get_communicator()) > 1)
-      send_recv_particles(moved_particles,sorted_particles_map,moved_cells);
+      send_recv_particles(moved_particles,received_particles,moved_cells);
 #endif
 
-    sorted_particles_map.insert(sorted_particles.begin(),sorted_particles.end());
-
-    for (unsigned int i=0; i<particles_out_of_cell.size(); ++i)
-      remove_particle(particles_out_of_cell[i]);
-
-    particles.insert(sorted_particles_map.begin(),sorted_particles_map.end());
+    // Move the particles into their new cells in one pass over all
+    // particles, which keeps the other particles sorted, and sort the
+    // received ones in
+    particles.relocate(sorted_particles,sorted_cells,removed_particles);
+    particles.merge(received_particles);
     update_cached_numbers();
   }
 
@@ -634,7 +723,7 @@ namespace Particles
 
   template <int dim, int spacedim>
   void
-  ParticleHandler<dim,spacedim>::exchange_ghost_particles()
+  ParticleHandler<dim,spacedim>::exchange_ghost_particles(const bool enable_ghost_cache)
   {
     // Nothing to do in serial computations
     if (dealii::Utilities::MPI::n_mpi_processes(triangulation->get_communicator()) == 1)
@@ -643,6 +732,7 @@ namespace Particles
 #ifdef DEAL_II_WITH_MPI
     // First clear the current ghost_particle information
     ghost_particles.clear();
+    ghost_particles_cache.clear();
 
     std::map<types::subdomain_id, std::vector<particle_iterator> > ghost_particles_by_domain;
 
@@ -650,57 +740,250 @@ namespace Particles
     for (auto ghost_domain_id = ghost_owners.begin(); ghost_domain_id != ghost_owners.end(); ++ghost_domain_id)
       ghost_particles_by_domain[*ghost_domain_id].reserve(static_cast<typename std::vector<particle_iterator>::size_type> (particles.size()*0.25));
 
-    std::vector<std::set<unsigned int> > vertex_to_neighbor_subdomain(triangulation->n_vertices());
+    const std::vector<std::set<unsigned int> > &vertex_to_neighbor_subdomain
+      = triangulation_cache->get_vertex_to_neighbor_subdomain();
 
-    typename Triangulation<dim,spacedim>::active_cell_iterator
-    cell = triangulation->begin_active(),
-    endc = triangulation->end();
-    for (; cell != endc; ++cell)
-      {
-        if (cell->is_ghost())
+    // Determine the subdomains adjacent to each cell with particles in
+    // parallel, and then collect the particles in the order of the cells
+    std::vector<std::vector<types::subdomain_id> > cell_to_neighbor_subdomains(particles.n_cells());
+    parallel::apply_to_subranges
+    (0U, particles.n_cells(),
+     [&](const unsigned int begin, const unsigned int end)
+    {
+      for (unsigned int c=begin; c<end; ++c)
+        {
+          const internal::LevelInd &level_index = particles.get_cell(particles.cell_begin(c), c);
+          const typename Triangulation<dim,spacedim>::cell_iterator cell (&*triangulation,
+              level_index.first,
+              level_index.second);
+
+          std::set<unsigned int> cell_to_neighbor_subdomain;
           for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
-            vertex_to_neighbor_subdomain[cell->vertex_index(v)].insert(cell->subdomain_id());
-      }
+            {
+              cell_to_neighbor_subdomain.insert(vertex_to_neighbor_subdomain[cell->vertex_index(v)].begin(),
+                                                vertex_to_neighbor_subdomain[cell->vertex_index(v)].end());
+            }
+          cell_to_neighbor_subdomains[c].assign(cell_to_neighbor_subdomain.begin(),
+                                                cell_to_neighbor_subdomain.end());
+        }
+    },
+    cells_per_task);
+
+    for (unsigned int c=0; c<particles.n_cells(); ++c)
+      for (const types::subdomain_id domain : cell_to_neighbor_subdomains[c])
+        for (std::size_t i=particles.cell_begin(c); i<particles.cell_begin(c+1); ++i)
+          ghost_particles_by_domain[domain].push_back(particle_iterator(particles,i));
 
-    cell = triangulation->begin_active();
-    for (; cell != endc; ++cell)
+    std::vector<unsigned int> n_received_particles;
+    send_recv_particles(ghost_particles_by_domain,
+                        ghost_particles,
+                        std::map<types::subdomain_id, std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> > (),
+                        enable_ghost_cache ? &n_received_particles : nullptr);
+
+    if (enable_ghost_cache == false)
       {
-        if (!cell->is_ghost())
-          {
-            std::set<unsigned int> cell_to_neighbor_subdomain;
-            for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
-              {
-                cell_to_neighbor_subdomain.insert(vertex_to_neighbor_subdomain[cell->vertex_index(v)].begin(),
-                                                  vertex_to_neighbor_subdomain[cell->vertex_index(v)].end());
-              }
+        ghost_particles.sort();
+        return;
+      }
 
-            if (cell_to_neighbor_subdomain.size() > 0)
-              {
-                const particle_iterator_range particle_range = particles_in_cell(cell);
+    // The received particles are in the order in which they were received.
+    // Sorting them keeps the order of the particles within each cell, so
+    // the position of each of them after sorting is given by a stable sort
+    // of their cells
+    std::vector<internal::LevelInd> recv_cells(ghost_particles.size());
+    for (std::size_t i=0; i<ghost_particles.size(); ++i)
+      recv_cells[i] = ghost_particles.get_cell(i, 0);
+    std::vector<std::size_t> permutation(ghost_particles.size());
+    std::iota(permutation.begin(), permutation.end(), 0);
+    std::stable_sort(permutation.begin(), permutation.end(),
+                     [&](const std::size_t a, const std::size_t b)
+    {
+      return recv_cells[a] < recv_cells[b];
+    });
 
-                for (std::set<types::subdomain_id>::const_iterator domain=cell_to_neighbor_subdomain.begin();
-                     domain != cell_to_neighbor_subdomain.end(); ++domain)
-                  {
-                    for (typename particle_iterator_range::iterator particle = particle_range.begin(); particle != particle_range.end(); ++particle)
-                      ghost_particles_by_domain[*domain].push_back(particle);
-                  }
-              }
-          }
+    ghost_particles.sort();
+
+    GhostParticleCache &cache = ghost_particles_cache;
+    cache.recv_particles.resize(permutation.size());
+    for (std::size_t i=0; i<permutation.size(); ++i)
+      cache.recv_particles[permutation[i]] = i;
+
+    cache.neighbors.assign(ghost_owners.begin(), ghost_owners.end());
+    cache.n_recv_particles = n_received_particles;
+    cache.send_particles.resize(cache.neighbors.size());
+    std::size_t n_send_particles = 0;
+    for (unsigned int i=0; i<cache.neighbors.size(); ++i)
+      {
+        const std::vector<particle_iterator> &send_particles = ghost_particles_by_domain[cache.neighbors[i]];
+        cache.send_particles[i].resize(send_particles.size());
+        for (std::size_t j=0; j<send_particles.size(); ++j)
+          cache.send_particles[i][j] = send_particles[j]->particle_index;
+        n_send_particles += send_particles.size();
       }
 
-    send_recv_particles(ghost_particles_by_domain,
-                        ghost_particles);
+    cache.particle_size = Particle<dim,spacedim>().serialized_size_in_bytes()
+                          + property_pool->n_properties_per_slot() * sizeof(double)
+                          + (size_callback ? size_callback() : 0);
+    cache.send_data.resize(n_send_particles * cache.particle_size);
+    cache.recv_data.resize(ghost_particles.size() * cache.particle_size);
+
+    // Register the messages with MPI once. The receives come first, so that
+    // update_ghost_particles() can start them before packing the data to
+    // send
+    std::size_t recv_offset = 0;
+    for (unsigned int i=0; i<cache.neighbors.size(); ++i)
+      if (cache.n_recv_particles[i] > 0)
+        {
+          const std::size_t n_bytes = cache.n_recv_particles[i] * cache.particle_size;
+          cache.requests.push_back(MPI_REQUEST_NULL);
+          MPI_Recv_init(&(cache.recv_data[recv_offset]), n_bytes, MPI_CHAR, cache.neighbors[i], 2,
+                        triangulation->get_communicator(), &cache.requests.back());
+          recv_offset += n_bytes;
+        }
+
+    std::size_t send_offset = 0;
+    for (unsigned int i=0; i<cache.neighbors.size(); ++i)
+      if (cache.send_particles[i].size() > 0)
+        {
+          const std::size_t n_bytes = cache.send_particles[i].size() * cache.particle_size;
+          cache.requests.push_back(MPI_REQUEST_NULL);
+          MPI_Send_init(&(cache.send_data[send_offset]), n_bytes, MPI_CHAR, cache.neighbors[i], 2,
+                        triangulation->get_communicator(), &cache.requests.back());
+          send_offset += n_bytes;
+        }
+
+    cache.particles_modifications = particles.n_modifications();
+    cache.ghost_particles_modifications = ghost_particles.n_modifications();
+    cache.valid = true;
+#else
+    (void)enable_ghost_cache;
 #endif
   }
 
 
 
+  template <int dim, int spacedim>
+  void
+  ParticleHandler<dim,spacedim>::update_ghost_particles()
+  {
+    // Nothing to do in serial computations
+    if (dealii::Utilities::MPI::n_mpi_processes(triangulation->get_communicator()) == 1)
+      return;
+
+#ifdef DEAL_II_WITH_MPI
+    GhostParticleCache &cache = ghost_particles_cache;
+    AssertThrow (cache.valid
+                 &&
+                 cache.particles_modifications == particles.n_modifications()
+                 &&
+                 cache.ghost_particles_modifications == ghost_particles.n_modifications(),
+                 ExcMessage("The ghost particles can only be updated after a call "
+                            "to exchange_ghost_particles() with the ghost cache "
+                            "enabled, and as long as no particles have been added, "
+                            "removed or moved to other cells since then."));
+    const std::size_t particle_size = Particle<dim,spacedim>().serialized_size_in_bytes()
+                                      + property_pool->n_properties_per_slot() * sizeof(double)
+                                      + (size_callback ? size_callback() : 0);
+    AssertThrow (cache.particle_size == particle_size,
+                 ExcMessage("The size of the data of the particles has changed "
+                            "since the last call to exchange_ghost_particles()."));
+
+    unsigned int n_recv_requests = 0;
+    for (unsigned int i=0; i<cache.neighbors.size(); ++i)
+      if (cache.n_recv_particles[i] > 0)
+        ++n_recv_requests;
+
+    if (n_recv_requests > 0)
+      MPI_Startall(n_recv_requests, cache.requests.data());
+
+    // Serialize the data sorted by receiving process, in the same way as
+    // send_recv_particles(), but without the cells, which are known to the
+    // receiver
+    void *data = static_cast<void *> (cache.send_data.data());
+    for (unsigned int i=0; i<cache.neighbors.size(); ++i)
+      for (const std::size_t index : cache.send_particles[i])
+        {
+          const particle_iterator particle(particles, index);
+          particle->write_data(data);
+          if (store_callback)
+            data = store_callback(particle, data);
+        }
+    AssertThrow (data == cache.send_data.data() + cache.send_data.size(),
+                 ExcMessage("The amount of data written for the ghost particles "
+                            "does not match the size of the send buffer."));
+
+    if (cache.requests.size() > n_recv_requests)
+      MPI_Startall(cache.requests.size() - n_recv_requests,
+                   cache.requests.data() + n_recv_requests);
+    MPI_Waitall(cache.requests.size(), cache.requests.data(), MPI_STATUSES_IGNORE);
+
+    const void *recv_data_it = static_cast<const void *> (cache.recv_data.data());
+    for (const std::size_t index : cache.recv_particles)
+      {
+        ghost_particles.read_data(index, recv_data_it);
+        if (load_callback)
+          recv_data_it = load_callback(particle_iterator(ghost_particles, index),
+                                       recv_data_it);
+      }
+    AssertThrow (recv_data_it == cache.recv_data.data() + cache.recv_data.size(),
+                 ExcMessage("The amount of data that was read into the ghost particles "
+                            "does not match the amount of data sent around."));
+#endif
+  }
+
+
+
+#ifdef DEAL_II_WITH_MPI
+  template <int dim, int spacedim>
+  ParticleHandler<dim,spacedim>::GhostParticleCache::GhostParticleCache ()
+    :
+    valid (false),
+    particles_modifications (0),
+    ghost_particles_modifications (0),
+    particle_size (0)
+  {}
+
+
+
+  template <int dim, int spacedim>
+  ParticleHandler<dim,spacedim>::GhostParticleCache::~GhostParticleCache ()
+  {
+    clear ();
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  ParticleHandler<dim,spacedim>::GhostParticleCache::clear ()
+  {
+    // The requests can not be freed any more once MPI has been finalized
+    int finalized = 0;
+    if (requests.size() > 0)
+      MPI_Finalized(&finalized);
+    if (!finalized)
+      for (auto &request : requests)
+        if (request != MPI_REQUEST_NULL)
+          MPI_Request_free(&request);
+    requests.clear();
+
+    neighbors.clear();
+    send_particles.clear();
+    recv_particles.clear();
+    n_recv_particles.clear();
+    valid = false;
+  }
+#endif
+
+
+
 #ifdef DEAL_II_WITH_MPI
   template <int dim, int spacedim>
   void
   ParticleHandler<dim,spacedim>::send_recv_particles(const std::map<types::subdomain_id, std::vector<particle_iterator> > &particles_to_send,
-                                                     std::multimap<internal::LevelInd,Particle <dim,spacedim> > &received_particles,
-                                                     const std::map<types::subdomain_id, std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> > &send_cells)
+                                                     internal::ParticleContainer<dim,spacedim> &received_particles,
+                                                     const std::map<types::subdomain_id, std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> > &send_cells,
+                                                     std::vector<unsigned int> *n_received_particles)
   {
     // Determine the communication pattern
     const std::set<types::subdomain_id> ghost_owners = triangulation->ghost_owners();
@@ -730,7 +1013,7 @@ namespace Particles
     // to other processors and the data itself.
     std::vector<unsigned int> n_send_data(n_neighbors,0);
     std::vector<unsigned int> send_offsets(n_neighbors,0);
-    std::vector<char> send_data;
+    std::vector<char> &send_data = send_buffer;
 
     // Only serialize things if there are particles to be send.
     // We can not return early even if no particles
@@ -791,7 +1074,8 @@ namespace Particles
       }
 
     // Set up the space for the received particle data
-    std::vector<char> recv_data(total_recv_data);
+    std::vector<char> &recv_data = recv_buffer;
+    recv_data.resize(total_recv_data);
 
     // Exchange the particle data between domains
     {
@@ -815,10 +1099,28 @@ namespace Particles
       MPI_Waitall(send_ops+recv_ops,&requests[0],MPI_STATUSES_IGNORE);
     }
 
+    // Reserve the memory for the properties of all received particles at
+    // once
+    const std::size_t recv_particle_size = cellid_size
+                                           + Particle<dim,spacedim>().serialized_size_in_bytes()
+                                           + property_pool->n_properties_per_slot() * sizeof(double)
+                                           + (size_callback ? size_callback() : 0);
+    property_pool->reserve(total_recv_data / recv_particle_size);
+
+    if (n_received_particles != nullptr)
+      {
+        n_received_particles->resize(n_neighbors);
+        for (unsigned int i=0; i<n_neighbors; ++i)
+          {
+            Assert (n_recv_data[i] % recv_particle_size == 0, ExcInternalError());
+            (*n_received_particles)[i] = n_recv_data[i] / recv_particle_size;
+          }
+      }
+
     // Put the received particles into the domain if they are in the triangulation
-    const void *recv_data_it = static_cast<const void *> (&recv_data.front());
+    const void *recv_data_it = static_cast<const void *> (recv_data.data());
 
-    while (reinterpret_cast<std::size_t> (recv_data_it) - reinterpret_cast<std::size_t> (&recv_data.front()) < total_recv_data)
+    while (reinterpret_cast<std::size_t> (recv_data_it) - reinterpret_cast<std::size_t> (recv_data.data()) < total_recv_data)
       {
         CellId::binary_type binary_cellid;
         memcpy(&binary_cellid, recv_data_it, cellid_size);
@@ -827,16 +1129,16 @@ namespace Particles
 
         const typename Triangulation<dim,spacedim>::active_cell_iterator cell = id.to_cell(*triangulation);
 
-        typename std::multimap<internal::LevelInd,Particle <dim,spacedim> >::iterator recv_particle =
-          received_particles.insert(std::make_pair(internal::LevelInd(cell->level(),cell->index()),
-                                                   Particle<dim,spacedim>(recv_data_it,*property_pool)));
+        const std::size_t recv_particle =
+          received_particles.push_back(internal::LevelInd(cell->level(),cell->index()),
+                                       recv_data_it);
 
         if (load_callback)
           recv_data_it = load_callback(particle_iterator(received_particles,recv_particle),
                                        recv_data_it);
       }
 
-    AssertThrow(recv_data_it == &recv_data.back()+1,
+    AssertThrow(recv_data_it == recv_data.data() + total_recv_data,
                 ExcMessage("The amount of data that was read into new particles "
                            "does not match the amount of data sent around."));
   }
@@ -964,6 +1266,7 @@ namespace Particles
                       std::placeholders::_3);
 
         non_const_triangulation->notify_ready_to_unpack(data_offset,callback_function);
+        particles.sort();
 
         // Reset offset and update global number of particles. The number
         // can change because of discarded or newly generated particles
@@ -1046,61 +1349,29 @@ namespace Particles
       return;
 
     // Load all particles from the data stream and store them in the local
-    // particle map.
+    // particle container. They are sorted into the other particles once all
+    // cells are unpacked.
+    property_pool->reserve(*n_particles_in_cell_ptr);
+
     if (status == parallel::distributed::Triangulation<dim,spacedim>::CELL_PERSIST)
       {
-        typename std::multimap<internal::LevelInd,Particle<dim,spacedim> >::iterator position_hint = particles.end();
+        const internal::LevelInd level_index (cell->level(),cell->index());
         for (unsigned int i = 0; i < *n_particles_in_cell_ptr; ++i)
-          {
-            // Use std::multimap::emplace_hint to speed up insertion of
-            // particles. This is a C++11 function, but not all compilers
-            // that report a -std=c++11 (like gcc 4.6) implement it, so
-            // require C++14 instead.
-#ifdef DEAL_II_WITH_CXX14
-            position_hint = particles.emplace_hint(position_hint,
-                                                   std::make_pair(cell->level(),cell->index()),
-                                                   Particle<dim,spacedim>(pdata,*property_pool));
-#else
-            position_hint = particles.insert(position_hint,
-                                             std::make_pair(std::make_pair(cell->level(),cell->index()),
-                                                            Particle<dim,spacedim>(pdata,*property_pool)));
-#endif
-            ++position_hint;
-          }
+          particles.push_back(level_index, pdata);
       }
 
     else if (status == parallel::distributed::Triangulation<dim,spacedim>::CELL_COARSEN)
       {
-        typename std::multimap<internal::LevelInd,Particle<dim,spacedim> >::iterator position_hint = particles.end();
+        const internal::LevelInd level_index (cell->level(),cell->index());
         for (unsigned int i = 0; i < *n_particles_in_cell_ptr; ++i)
           {
-            // Use std::multimap::emplace_hint to speed up insertion of
-            // particles. This is a C++11 function, but not all compilers
-            // that report a -std=c++11 (like gcc 4.6) implement it, so
-            // require C++14 instead.
-#ifdef DEAL_II_WITH_CXX14
-            position_hint = particles.emplace_hint(position_hint,
-                                                   std::make_pair(cell->level(),cell->index()),
-                                                   Particle<dim,spacedim>(pdata,*property_pool));
-#else
-            position_hint = particles.insert(position_hint,
-                                             std::make_pair(std::make_pair(cell->level(),cell->index()),
-                                                            Particle<dim,spacedim>(pdata,*property_pool)));
-#endif
-            const Point<dim> p_unit = mapping->transform_real_to_unit_cell(cell, position_hint->second.get_location());
-            position_hint->second.set_reference_location(p_unit);
-            ++position_hint;
+            const std::size_t index = particles.push_back(level_index, pdata);
+            particles.reference_locations[index]
+              = mapping->transform_real_to_unit_cell(cell, particles.locations[index]);
           }
       }
     else if (status == parallel::distributed::Triangulation<dim,spacedim>::CELL_REFINE)
       {
-        std::vector<typename std::multimap<internal::LevelInd, Particle<dim,spacedim> >::iterator > position_hints(GeometryInfo<dim>::max_children_per_cell);
-        for (unsigned int child_index=0; child_index<GeometryInfo<dim>::max_children_per_cell; ++child_index)
-          {
-            const typename Triangulation<dim,spacedim>::cell_iterator child = cell->child(child_index);
-            position_hints[child_index] = particles.upper_bound(std::make_pair(child->level(),child->index()));
-          }
-
         for (unsigned int i = 0; i < *n_particles_in_cell_ptr; ++i)
           {
             Particle<dim,spacedim> p (pdata,*property_pool);
@@ -1116,20 +1387,7 @@ namespace Particles
                     if (GeometryInfo<dim>::is_inside_unit_cell(p_unit))
                       {
                         p.set_reference_location(p_unit);
-                        // Use std::multimap::emplace_hint to speed up insertion of
-                        // particles. This is a C++11 function, but not all compilers
-                        // that report a -std=c++11 (like gcc 4.6) implement it, so
-                        // require C++14 instead.
-#ifdef DEAL_II_WITH_CXX14
-                        position_hints[child_index] = particles.emplace_hint(position_hints[child_index],
-                                                                             std::make_pair(child->level(),child->index()),
-                                                                             std::move(p));
-#else
-                        position_hints[child_index] = particles.insert(position_hints[child_index],
-                                                                       std::make_pair(std::make_pair(child->level(),child->index()),
-                                                                           p));
-#endif
-                        ++position_hints[child_index];
+                        particles.push_back(internal::LevelInd(child->level(),child->index()), p);
                         break;
                       }
                   }
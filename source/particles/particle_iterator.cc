@@ -20,10 +20,10 @@ DEAL_II_NAMESPACE_OPEN
 namespace Particles
 {
   template <int dim, int spacedim>
-  ParticleIterator<dim,spacedim>::ParticleIterator (const std::multimap<internal::LevelInd, Particle<dim,spacedim> > &map,
-                                                    const typename std::multimap<internal::LevelInd, Particle<dim,spacedim> >::iterator &particle)
+  ParticleIterator<dim,spacedim>::ParticleIterator (const internal::ParticleContainer<dim,spacedim> &container,
+                                                    const std::size_t                                particle_index)
     :
-    accessor (map, particle)
+    accessor (container, particle_index)
   {}
 
 
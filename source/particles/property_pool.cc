@@ -16,6 +16,8 @@
 
 #include <deal.II/particles/property_pool.h>
 
+#include <algorithm>
+
 DEAL_II_NAMESPACE_OPEN
 
 namespace Particles
@@ -25,7 +27,9 @@ namespace Particles
 
   PropertyPool::PropertyPool (const unsigned int n_properties_per_slot)
     :
-    n_properties (n_properties_per_slot)
+    n_properties (n_properties_per_slot),
+    slot_size (std::max(n_properties_per_slot, 1U)),
+    n_slots (0)
   {}
 
 
@@ -33,7 +37,24 @@ namespace Particles
   PropertyPool::Handle
   PropertyPool::allocate_properties_array ()
   {
-    return new double[n_properties];
+    if (free_slots.empty())
+      allocate_block (1);
+
+    const Handle handle = free_slots.back();
+    free_slots.pop_back();
+    return handle;
+  }
+
+
+
+  void
+  PropertyPool::allocate_properties_arrays (const std::size_t    n_handles,
+                                            std::vector<Handle> &handles)
+  {
+    reserve (n_handles);
+
+    handles.insert (handles.end(), free_slots.rbegin(), free_slots.rbegin()+n_handles);
+    free_slots.resize (free_slots.size()-n_handles);
   }
 
 
@@ -41,7 +62,20 @@ namespace Particles
   void
   PropertyPool::deallocate_properties_array (Handle handle)
   {
-    delete[] handle;
+    Assert (handle != invalid_handle, ExcInternalError());
+    Assert (free_slots.size() < n_slots, ExcInternalError());
+
+    free_slots.push_back (handle);
+  }
+
+
+
+  void
+  PropertyPool::deallocate_properties_arrays (const std::vector<Handle> &handles)
+  {
+    for (const Handle handle : handles)
+      if (handle != invalid_handle)
+        deallocate_properties_array (handle);
   }
 
 
@@ -57,7 +91,8 @@ namespace Particles
   void
   PropertyPool::reserve(const std::size_t size)
   {
-    (void)size;
+    if (free_slots.size() < size)
+      allocate_block (size - free_slots.size());
   }
 
 
@@ -67,5 +102,44 @@ namespace Particles
   {
     return n_properties;
   }
+
+
+
+  std::size_t
+  PropertyPool::n_allocated_handles() const
+  {
+    return n_slots - free_slots.size();
+  }
+
+
+
+  std::size_t
+  PropertyPool::memory_consumption() const
+  {
+    return sizeof(*this)
+           + n_slots * slot_size * sizeof(double)
+           + blocks.capacity() * sizeof(std::unique_ptr<double[]>)
+           + free_slots.capacity() * sizeof(Handle);
+  }
+
+
+
+  void
+  PropertyPool::allocate_block (const std::size_t min_slots)
+  {
+    // grow geometrically so that the number of blocks stays small, but do
+    // not allocate large blocks for a few particles
+    const std::size_t n_new_slots = std::max (min_slots,
+                                              std::max<std::size_t> (n_slots, 64));
+
+    blocks.push_back (std::unique_ptr<double[]> (new double[n_new_slots * slot_size]));
+    double *const block = blocks.back().get();
+
+    free_slots.reserve (free_slots.size() + n_new_slots);
+    for (std::size_t i=n_new_slots; i>0; --i)
+      free_slots.push_back (block + (i-1) * slot_size);
+
+    n_slots += n_new_slots;
+  }
 }
 DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,456 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/particles/utilities.h>
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/base/work_stream.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_tools.h>
+#include <deal.II/lac/block_vector.h>
+#include <deal.II/lac/la_vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/la_parallel_block_vector.h>
+#include <deal.II/lac/petsc_parallel_vector.h>
+#include <deal.II/lac/petsc_parallel_block_vector.h>
+#include <deal.II/lac/trilinos_vector.h>
+#include <deal.II/lac/trilinos_parallel_block_vector.h>
+#include <deal.II/lac/trilinos_epetra_vector.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+#ifdef DEAL_II_WITH_P4EST
+
+namespace Particles
+{
+  namespace Utilities
+  {
+    namespace internal
+    {
+      /**
+       * The information needed to evaluate one component of a finite
+       * element at arbitrary points of the reference cell.
+       */
+      struct ComponentData
+      {
+        /**
+         * Whether the shape functions of the component are tensor products
+         * of the Lagrange polynomials in @p nodes.
+         */
+        bool tensor_product;
+
+        /**
+         * The support points of the one-dimensional Lagrange polynomials
+         * and the inverses of the denominators of the polynomials.
+         */
+        std::vector<double> nodes;
+        std::vector<double> inverse_denominators;
+
+        /**
+         * The shape functions of the component, in lexicographic order of
+         * the tensor product if @p tensor_product is true.
+         */
+        std::vector<unsigned int> dofs;
+
+        /**
+         * The component of the finite element.
+         */
+        unsigned int component;
+      };
+
+
+
+      /**
+       * Set up the evaluation of the components of @p fe selected by
+       * @p mask.
+       */
+      template <int dim, int spacedim>
+      std::vector<ComponentData>
+      setup_components (const FiniteElement<dim,spacedim> &fe,
+                        const ComponentMask               &mask)
+      {
+        Assert (fe.is_primitive(),
+                ExcMessage("The interpolation between finite element fields "
+                           "and particles is only implemented for primitive "
+                           "finite elements."));
+        Assert (mask.size() == 0 || mask.size() == fe.n_components(),
+                ExcDimensionMismatch (mask.size(), fe.n_components()));
+
+        std::vector<ComponentData> components;
+        for (unsigned int c=0; c<fe.n_components(); ++c)
+          if (mask[c])
+            {
+              ComponentData data;
+              data.component = c;
+
+              const FiniteElement<dim,spacedim> &base_fe
+                = fe.base_element(fe.component_to_base_index(c).first);
+              data.tensor_product = (dynamic_cast<const FE_Q<dim,spacedim> *>(&base_fe) != nullptr);
+
+              if (data.tensor_product)
+                {
+                  const std::vector<unsigned int> lexicographic_to_hierarchic
+                    = FETools::lexicographic_to_hierarchic_numbering (base_fe);
+                  const std::vector<Point<dim> > &support_points = base_fe.get_unit_support_points();
+
+                  const unsigned int n_nodes = base_fe.degree + 1;
+                  data.nodes.resize(n_nodes);
+                  for (unsigned int i=0; i<n_nodes; ++i)
+                    data.nodes[i] = support_points[lexicographic_to_hierarchic[i]][0];
+
+                  data.inverse_denominators.assign(n_nodes, 1.);
+                  for (unsigned int j=0; j<n_nodes; ++j)
+                    for (unsigned int k=0; k<n_nodes; ++k)
+                      if (k != j)
+                        data.inverse_denominators[j] /= data.nodes[j] - data.nodes[k];
+
+                  data.dofs.resize(lexicographic_to_hierarchic.size());
+                  for (unsigned int i=0; i<lexicographic_to_hierarchic.size(); ++i)
+                    data.dofs[i] = fe.component_to_system_index(c, lexicographic_to_hierarchic[i]);
+                }
+              else
+                for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+                  if (fe.system_to_component_index(i).first == c)
+                    data.dofs.push_back(i);
+
+              components.push_back(data);
+            }
+        return components;
+      }
+
+
+
+      /**
+       * Evaluate the Lagrange polynomials of @p data in all coordinate
+       * directions at the reference points @p points of up to
+       * VectorizedArray::n_array_elements particles and store them in
+       * @p values, with the values in direction $d$ starting at
+       * <code>d*nodes.size()</code>. Unused lanes repeat the last point.
+       */
+      template <int dim>
+      void
+      evaluate_lagrange_polynomials (const ComponentData            &data,
+                                     const std::vector<Point<dim> > &points,
+                                     const unsigned int              first,
+                                     const unsigned int              n_points,
+                                     AlignedVector<VectorizedArray<double>> &values)
+      {
+        const unsigned int n_nodes = data.nodes.size();
+        values.resize_fast(dim*n_nodes);
+
+        for (unsigned int d=0; d<dim; ++d)
+          {
+            VectorizedArray<double> x;
+            for (unsigned int l=0; l<VectorizedArray<double>::n_array_elements; ++l)
+              x[l] = points[first + std::min(l, n_points-1)][d];
+
+            for (unsigned int j=0; j<n_nodes; ++j)
+              {
+                VectorizedArray<double> value;
+                value = data.inverse_denominators[j];
+                for (unsigned int k=0; k<n_nodes; ++k)
+                  if (k != j)
+                    value *= x - data.nodes[k];
+                values[d*n_nodes+j] = value;
+              }
+          }
+      }
+
+
+
+      /**
+       * The locally owned cells of @p dof_handler that contain particles,
+       * together with the position of their first particle among the
+       * locally owned particles. The particles of a ParticleHandler are
+       * sorted by the level and index of their cells, which is the order in
+       * which the active cells are traversed.
+       */
+      template <int dim, int spacedim>
+      std::vector<std::pair<typename DoFHandler<dim,spacedim>::active_cell_iterator,std::size_t> >
+      cells_with_particles (const DoFHandler<dim,spacedim>      &dof_handler,
+                            const ParticleHandler<dim,spacedim> &particle_handler)
+      {
+        std::vector<std::pair<typename DoFHandler<dim,spacedim>::active_cell_iterator,std::size_t> > cells;
+        std::size_t n_particles = 0;
+        for (const auto &cell : dof_handler.active_cell_iterators())
+          if (cell->is_locally_owned())
+            {
+              const unsigned int n_particles_in_cell
+                = particle_handler.n_particles_in_cell(typename Triangulation<dim,spacedim>::active_cell_iterator(cell));
+              if (n_particles_in_cell > 0)
+                {
+                  cells.push_back(std::make_pair(cell, n_particles));
+                  n_particles += n_particles_in_cell;
+                }
+            }
+        AssertDimension (n_particles, particle_handler.n_locally_owned_particles());
+        return cells;
+      }
+
+
+
+      /**
+       * Scratch data for the loops over the cells.
+       */
+      template <int dim, typename Number>
+      struct ScratchData
+      {
+        Vector<Number>                  local_dof_values;
+        std::vector<Point<dim> >        reference_locations;
+        AlignedVector<VectorizedArray<double>> shape_values;
+      };
+
+
+
+      /**
+       * The contribution of one cell to the field vector in
+       * deposit_particle_values_on_field().
+       */
+      template <typename Number>
+      struct CopyData
+      {
+        Vector<Number>                       local_dof_values;
+        std::vector<types::global_dof_index> local_dof_indices;
+      };
+
+
+
+      /**
+       * Store the reference locations of the particles in @p cell in
+       * @p reference_locations.
+       */
+      template <int dim, int spacedim, typename CellIterator>
+      void
+      get_reference_locations (const ParticleHandler<dim,spacedim> &particle_handler,
+                               const CellIterator                  &cell,
+                               std::vector<Point<dim> >            &reference_locations)
+      {
+        const typename ParticleHandler<dim,spacedim>::particle_iterator_range particles
+          = particle_handler.particles_in_cell(typename Triangulation<dim,spacedim>::active_cell_iterator(cell));
+        reference_locations.clear();
+        for (const auto &particle : particles)
+          reference_locations.push_back(particle.get_reference_location());
+      }
+    }
+
+
+
+    template <int dim, int spacedim, typename VectorType>
+    void
+    interpolate_field_on_particles (const DoFHandler<dim,spacedim>           &dof_handler,
+                                    const ParticleHandler<dim,spacedim>      &particle_handler,
+                                    const VectorType                         &field_vector,
+                                    Vector<typename VectorType::value_type>  &interpolated_field,
+                                    const ComponentMask                      &field_comps)
+    {
+      typedef typename VectorType::value_type Number;
+      typedef typename DoFHandler<dim,spacedim>::active_cell_iterator active_cell_iterator;
+
+      const FiniteElement<dim,spacedim> &fe = dof_handler.get_fe();
+      const std::vector<internal::ComponentData> components = internal::setup_components(fe, field_comps);
+      const unsigned int n_comps = components.size();
+
+      interpolated_field.reinit(particle_handler.n_locally_owned_particles() * n_comps);
+
+      const std::vector<std::pair<active_cell_iterator,std::size_t> > cells
+        = internal::cells_with_particles(dof_handler, particle_handler);
+
+      // the particles of different cells are written to different entries
+      // of the output, so the worker writes directly into it
+      auto worker = [&](const typename std::vector<std::pair<active_cell_iterator,std::size_t> >::const_iterator &cell,
+                        internal::ScratchData<dim,Number> &scratch,
+                        void *)
+      {
+        scratch.local_dof_values.reinit(fe.dofs_per_cell, true);
+        cell->first->get_dof_values(field_vector, scratch.local_dof_values);
+        internal::get_reference_locations(particle_handler, cell->first, scratch.reference_locations);
+
+        const std::vector<Point<dim> > &points = scratch.reference_locations;
+        Number *output = interpolated_field.begin() + cell->second * n_comps;
+
+        for (unsigned int k=0; k<n_comps; ++k)
+          {
+            const internal::ComponentData &data = components[k];
+            if (data.tensor_product)
+              {
+                const unsigned int n0 = data.nodes.size();
+                const unsigned int n1 = (dim > 1 ? n0 : 1);
+                const unsigned int n2 = (dim > 2 ? n0 : 1);
+
+                VectorizedArray<double> one;
+                one = 1.;
+
+                for (unsigned int first=0; first<points.size(); first+=VectorizedArray<double>::n_array_elements)
+                  {
+                    const unsigned int n_points = std::min<std::size_t>(VectorizedArray<double>::n_array_elements,
+                                                                        points.size()-first);
+                    internal::evaluate_lagrange_polynomials(data, points, first, n_points, scratch.shape_values);
+                    const VectorizedArray<double> *values0 = &scratch.shape_values[0];
+                    const VectorizedArray<double> *values1 = (dim > 1 ? values0 + n0 : &one);
+                    const VectorizedArray<double> *values2 = (dim > 2 ? values0 + 2*n0 : &one);
+
+                    // sum over the tensor product, contracting the first
+                    // direction before multiplying by the other two
+                    VectorizedArray<double> result;
+                    result = 0.;
+                    unsigned int index = 0;
+                    for (unsigned int i2=0; i2<n2; ++i2)
+                      for (unsigned int i1=0; i1<n1; ++i1)
+                        {
+                          VectorizedArray<double> sum;
+                          sum = 0.;
+                          for (unsigned int i0=0; i0<n0; ++i0, ++index)
+                            sum += values0[i0] * static_cast<double>(scratch.local_dof_values[data.dofs[index]]);
+                          result += values2[i2] * values1[i1] * sum;
+                        }
+
+                    for (unsigned int l=0; l<n_points; ++l)
+                      output[(first+l)*n_comps + k] = result[l];
+                  }
+              }
+            else
+              for (unsigned int p=0; p<points.size(); ++p)
+                {
+                  Number value = Number();
+                  for (const unsigned int i : data.dofs)
+                    value += scratch.local_dof_values[i] * fe.shape_value_component(i, points[p], data.component);
+                  output[p*n_comps + k] = value;
+                }
+          }
+      };
+
+      if (cells.size() > 0)
+        WorkStream::run (cells.begin(), cells.end(),
+                         worker,
+                         // no copier, the worker writes into the output
+                         std::function<void (void *const &)>(),
+                         internal::ScratchData<dim,Number>(),
+                         /* copy_data */ static_cast<void *>(nullptr));
+    }
+
+
+
+    template <int dim, int spacedim, typename VectorType>
+    void
+    deposit_particle_values_on_field (const DoFHandler<dim,spacedim>                &dof_handler,
+                                      const ParticleHandler<dim,spacedim>           &particle_handler,
+                                      const Vector<typename VectorType::value_type> &particle_values,
+                                      VectorType                                    &field_vector,
+                                      const ComponentMask                           &field_comps)
+    {
+      typedef typename VectorType::value_type Number;
+      typedef typename DoFHandler<dim,spacedim>::active_cell_iterator active_cell_iterator;
+
+      const FiniteElement<dim,spacedim> &fe = dof_handler.get_fe();
+      const std::vector<internal::ComponentData> components = internal::setup_components(fe, field_comps);
+      const unsigned int n_comps = components.size();
+
+      AssertDimension (particle_values.size(), particle_handler.n_locally_owned_particles() * n_comps);
+
+      const std::vector<std::pair<active_cell_iterator,std::size_t> > cells
+        = internal::cells_with_particles(dof_handler, particle_handler);
+
+      auto worker = [&](const typename std::vector<std::pair<active_cell_iterator,std::size_t> >::const_iterator &cell,
+                        internal::ScratchData<dim,Number> &scratch,
+                        internal::CopyData<Number> &copy_data)
+      {
+        copy_data.local_dof_values.reinit(fe.dofs_per_cell);
+        copy_data.local_dof_indices.resize(fe.dofs_per_cell);
+        cell->first->get_dof_indices(copy_data.local_dof_indices);
+        internal::get_reference_locations(particle_handler, cell->first, scratch.reference_locations);
+
+        const std::vector<Point<dim> > &points = scratch.reference_locations;
+        const Number *input = particle_values.begin() + cell->second * n_comps;
+
+        for (unsigned int k=0; k<n_comps; ++k)
+          {
+            const internal::ComponentData &data = components[k];
+            if (data.tensor_product)
+              {
+                const unsigned int n0 = data.nodes.size();
+                const unsigned int n1 = (dim > 1 ? n0 : 1);
+                const unsigned int n2 = (dim > 2 ? n0 : 1);
+
+                VectorizedArray<double> one;
+                one = 1.;
+
+                for (unsigned int first=0; first<points.size(); first+=VectorizedArray<double>::n_array_elements)
+                  {
+                    const unsigned int n_points = std::min<std::size_t>(VectorizedArray<double>::n_array_elements,
+                                                                        points.size()-first);
+                    internal::evaluate_lagrange_polynomials(data, points, first, n_points, scratch.shape_values);
+                    const VectorizedArray<double> *values0 = &scratch.shape_values[0];
+                    const VectorizedArray<double> *values1 = (dim > 1 ? values0 + n0 : &one);
+                    const VectorizedArray<double> *values2 = (dim > 2 ? values0 + 2*n0 : &one);
+
+                    // the values of the particles, zero in unused lanes
+                    VectorizedArray<double> particle_value;
+                    particle_value = 0.;
+                    for (unsigned int l=0; l<n_points; ++l)
+                      particle_value[l] = input[(first+l)*n_comps + k];
+
+                    unsigned int index = 0;
+                    for (unsigned int i2=0; i2<n2; ++i2)
+                      for (unsigned int i1=0; i1<n1; ++i1)
+                        {
+                          const VectorizedArray<double> weight
+                            = values2[i2] * values1[i1] * particle_value;
+                          for (unsigned int i0=0; i0<n0; ++i0, ++index)
+                            {
+                              const VectorizedArray<double> contribution = values0[i0] * weight;
+                              double sum = 0.;
+                              for (unsigned int l=0; l<VectorizedArray<double>::n_array_elements; ++l)
+                                sum += contribution[l];
+                              copy_data.local_dof_values[data.dofs[index]] += sum;
+                            }
+                        }
+                  }
+              }
+            else
+              for (unsigned int p=0; p<points.size(); ++p)
+                for (const unsigned int i : data.dofs)
+                  copy_data.local_dof_values[i] += input[p*n_comps + k]
+                                                   * fe.shape_value_component(i, points[p], data.component);
+          }
+      };
+
+      auto copier = [&](const internal::CopyData<Number> &copy_data)
+      {
+        for (unsigned int i=0; i<copy_data.local_dof_indices.size(); ++i)
+          if (copy_data.local_dof_values[i] != Number())
+            field_vector(copy_data.local_dof_indices[i]) += copy_data.local_dof_values[i];
+      };
+
+      if (cells.size() > 0)
+        WorkStream::run (cells.begin(), cells.end(),
+                         worker,
+                         copier,
+                         internal::ScratchData<dim,Number>(),
+                         internal::CopyData<Number>());
+
+      field_vector.compress(VectorOperation::add);
+    }
+  }
+}
+
+// explicit instantiations
+#include "utilities.inst"
+
+#endif // DEAL_II_WITH_P4EST
+
+DEAL_II_NAMESPACE_CLOSE
@@ -31,6 +31,7 @@
 #endif
 #include <deal.II/base/utilities.h>
 #include <deal.II/sundials/copy.h>
+#include <deal.II/sundials/n_vector.h>
 
 #include <sundials/sundials_config.h>
 
@@ -57,20 +58,13 @@ namespace SUNDIALS
                                    void *user_data)
     {
       ARKode<VectorType> &solver = *static_cast<ARKode<VectorType> *>(user_data);
-      GrowingVectorMemory<VectorType> mem;
-
-      typename VectorMemory<VectorType>::Pointer src_yy(mem);
-      solver.reinit_vector(*src_yy);
 
-      typename VectorMemory<VectorType>::Pointer dst_yp(mem);
-      solver.reinit_vector(*dst_yp);
-
-      copy(*src_yy, yy);
+      const NVectorView<VectorType> src_yy(yy, solver.reinit_vector);
+      const NVectorView<VectorType> dst_yp(yp, solver.reinit_vector,
+                                           NVectorAccess::write);
 
       int err = solver.explicit_function(tt, *src_yy, *dst_yp);
 
-      copy(yp, *dst_yp);
-
       return err;
     }
 
@@ -83,20 +77,13 @@ namespace SUNDIALS
                                    void *user_data)
     {
       ARKode<VectorType> &solver = *static_cast<ARKode<VectorType> *>(user_data);
-      GrowingVectorMemory<VectorType> mem;
-
-      typename VectorMemory<VectorType>::Pointer src_yy(mem);
-      solver.reinit_vector(*src_yy);
-
-      typename VectorMemory<VectorType>::Pointer dst_yp(mem);
-      solver.reinit_vector(*dst_yp);
 
-      copy(*src_yy, yy);
+      const NVectorView<VectorType> src_yy(yy, solver.reinit_vector);
+      const NVectorView<VectorType> dst_yp(yp, solver.reinit_vector,
+                                           NVectorAccess::write);
 
       int err = solver.implicit_function(tt, *src_yy, *dst_yp);
 
-      copy(yp, *dst_yp);
-
       return err;
     }
 
@@ -113,16 +100,9 @@ namespace SUNDIALS
                                 N_Vector)
     {
       ARKode<VectorType> &solver = *static_cast<ARKode<VectorType> *>(arkode_mem->ark_user_data);
-      GrowingVectorMemory<VectorType> mem;
-
-      typename VectorMemory<VectorType>::Pointer src_ypred(mem);
-      solver.reinit_vector(*src_ypred);
 
-      typename VectorMemory<VectorType>::Pointer src_fpred(mem);
-      solver.reinit_vector(*src_fpred);
-
-      copy(*src_ypred, ypred);
-      copy(*src_fpred, fpred);
+      const NVectorView<VectorType> src_ypred(ypred, solver.reinit_vector);
+      const NVectorView<VectorType> src_fpred(fpred, solver.reinit_vector);
 
       int err = solver.setup_jacobian(convfail,
                                       arkode_mem->ark_tn,
@@ -148,27 +128,20 @@ namespace SUNDIALS
       ARKode<VectorType> &solver = *static_cast<ARKode<VectorType> *>(arkode_mem->ark_user_data);
       GrowingVectorMemory<VectorType> mem;
 
-      typename VectorMemory<VectorType>::Pointer src(mem);
-      solver.reinit_vector(*src);
-
-      typename VectorMemory<VectorType>::Pointer src_ycur(mem);
-      solver.reinit_vector(*src_ycur);
-
-      typename VectorMemory<VectorType>::Pointer src_fcur(mem);
-      solver.reinit_vector(*src_fcur);
+      // b is both the right hand side and the solution of the linear system
+      const NVectorView<VectorType> src(b, solver.reinit_vector,
+                                        NVectorAccess::read_write);
+      const NVectorView<VectorType> src_ycur(ycur, solver.reinit_vector);
+      const NVectorView<VectorType> src_fcur(fcur, solver.reinit_vector);
 
       typename VectorMemory<VectorType>::Pointer dst(mem);
       solver.reinit_vector(*dst);
 
-      copy(*src, b);
-      copy(*src_ycur, ycur);
-      copy(*src_fcur, fcur);
-
       int err = solver.solve_jacobian_system(arkode_mem->ark_tn,
                                              arkode_mem->ark_gamma,
                                              *src_ycur, *src_fcur,
                                              *src,*dst);
-      copy(b, *dst);
+      *src = *dst;
 
       return err;
     }
@@ -201,16 +174,15 @@ namespace SUNDIALS
       ARKode<VectorType> &solver = *static_cast<ARKode<VectorType> *>(arkode_mem->ark_user_data);
       GrowingVectorMemory<VectorType> mem;
 
-      typename VectorMemory<VectorType>::Pointer src(mem);
-      solver.reinit_vector(*src);
+      // b is both the right hand side and the solution of the linear system
+      const NVectorView<VectorType> src(b, solver.reinit_vector,
+                                        NVectorAccess::read_write);
 
       typename VectorMemory<VectorType>::Pointer dst(mem);
       solver.reinit_vector(*dst);
 
-      copy(*src, b);
-
       int err = solver.solve_mass_system(*src,*dst);
-      copy(b, *dst);
+      *src = *dst;
 
       return err;
     }
@@ -242,8 +214,6 @@ namespace SUNDIALS
   unsigned int ARKode<VectorType>::solve_ode(VectorType &solution)
   {
 
-    unsigned int system_size = solution.size();
-
     double t = data.initial_time;
     double h = data.initial_step_size;
     unsigned int step_number = 0;
@@ -251,31 +221,10 @@ namespace SUNDIALS
     int status;
     (void)status;
 
-    // The solution is stored in
-    // solution. Here we take only a
-    // view of it.
-#ifdef DEAL_II_WITH_MPI
-    if (is_serial_vector<VectorType>::value == false)
-      {
-        const IndexSet is = solution.locally_owned_elements();
-        const size_t local_system_size = is.n_elements();
-
-        yy        = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-        abs_tolls = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-      }
-    else
-#endif
-      {
-        Assert(is_serial_vector<VectorType>::value,
-               ExcInternalError("Trying to use a serial code with a parallel vector."));
-        yy        = N_VNew_Serial(system_size);
-        abs_tolls = N_VNew_Serial(system_size);
-      }
+    // The solution is stored in the N_Vector yy, which wraps a vector of
+    // type VectorType if possible.
+    yy        = create_nvector(solution, communicator);
+    abs_tolls = create_nvector(solution, communicator);
     reset(data.initial_time,
           data.initial_step_size,
           solution);
@@ -308,18 +257,8 @@ namespace SUNDIALS
       }
 
     // Free the vectors which are no longer used.
-#ifdef DEAL_II_WITH_MPI
-    if (is_serial_vector<VectorType>::value == false)
-      {
-        N_VDestroy_Parallel(yy);
-        N_VDestroy_Parallel(abs_tolls);
-      }
-    else
-#endif
-      {
-        N_VDestroy_Serial(yy);
-        N_VDestroy_Serial(abs_tolls);
-      }
+    N_VDestroy(yy);
+    N_VDestroy(abs_tolls);
 
     return step_number;
   }
@@ -330,8 +269,6 @@ namespace SUNDIALS
                                  const VectorType &solution)
   {
 
-    unsigned int system_size;
-
     if (arkode_mem)
       ARKodeFree(&arkode_mem);
 
@@ -340,44 +277,14 @@ namespace SUNDIALS
     // Free the vectors which are no longer used.
     if (yy)
       {
-#ifdef DEAL_II_WITH_MPI
-        if (is_serial_vector<VectorType>::value == false)
-          {
-            N_VDestroy_Parallel(yy);
-            N_VDestroy_Parallel(abs_tolls);
-          }
-        else
-#endif
-          {
-            N_VDestroy_Serial(yy);
-            N_VDestroy_Serial(abs_tolls);
-          }
+        N_VDestroy(yy);
+        N_VDestroy(abs_tolls);
       }
 
     int status;
     (void)status;
-    system_size = solution.size();
-#ifdef DEAL_II_WITH_MPI
-    if (is_serial_vector<VectorType>::value == false)
-      {
-        const IndexSet is = solution.locally_owned_elements();
-        const size_t local_system_size = is.n_elements();
-
-        yy        = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-        abs_tolls = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-      }
-    else
-#endif
-      {
-        yy        = N_VNew_Serial(system_size);
-        abs_tolls = N_VNew_Serial(system_size);
-      }
+    yy        = create_nvector(solution, communicator);
+    abs_tolls = create_nvector(solution, communicator);
 
     copy(yy, solution);
 
@@ -480,6 +387,8 @@ namespace SUNDIALS
 
   template class ARKode<Vector<double> >;
   template class ARKode<BlockVector<double> >;
+  template class ARKode<LinearAlgebra::distributed::Vector<double> >;
+  template class ARKode<LinearAlgebra::distributed::BlockVector<double> >;
 
 #ifdef DEAL_II_WITH_MPI
 
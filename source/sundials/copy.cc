@@ -14,6 +14,7 @@
 //-----------------------------------------------------------
 
 #include <deal.II/sundials/copy.h>
+#include <deal.II/sundials/n_vector.h>
 
 #ifdef DEAL_II_WITH_SUNDIALS
 
@@ -166,6 +167,12 @@ namespace SUNDIALS
 
     void copy(BlockVector<double> &dst, const N_Vector &src)
     {
+      if (const BlockVector<double> *wrapped_src = unwrap_nvector<BlockVector<double>>(src))
+        {
+          dst = *wrapped_src;
+          return;
+        }
+
       const size_t N = dst.size();
       AssertDimension(N_Vector_length(src), N);
       for (size_t i=0; i<N; ++i)
@@ -176,6 +183,12 @@ namespace SUNDIALS
 
     void copy(N_Vector &dst, const BlockVector<double> &src)
     {
+      if (BlockVector<double> *wrapped_dst = unwrap_nvector<BlockVector<double>>(dst))
+        {
+          *wrapped_dst = src;
+          return;
+        }
+
       const size_t N = src.size();
       AssertDimension(N_Vector_length(dst), N);
       for (size_t i=0; i<N; ++i)
@@ -186,6 +199,12 @@ namespace SUNDIALS
 
     void copy(Vector<double> &dst, const N_Vector &src)
     {
+      if (const Vector<double> *wrapped_src = unwrap_nvector<Vector<double>>(src))
+        {
+          dst = *wrapped_src;
+          return;
+        }
+
       const size_t N = dst.size();
       AssertDimension(N_Vector_length(src), N);
       for (size_t i=0; i<N; ++i)
@@ -196,6 +215,12 @@ namespace SUNDIALS
 
     void copy(N_Vector &dst, const Vector<double> &src)
     {
+      if (Vector<double> *wrapped_dst = unwrap_nvector<Vector<double>>(dst))
+        {
+          *wrapped_dst = src;
+          return;
+        }
+
       const size_t N = src.size();
       AssertDimension(N_Vector_length(dst), N);
       for (size_t i=0; i<N; ++i)
@@ -203,6 +228,88 @@ namespace SUNDIALS
           NV_Ith_S(dst, i) = src[i];
         }
     }
+
+    void copy(LinearAlgebra::distributed::Vector<double> &dst, const N_Vector &src)
+    {
+      if (const LinearAlgebra::distributed::Vector<double> *wrapped_src
+          = unwrap_nvector<LinearAlgebra::distributed::Vector<double> >(src))
+        {
+          dst = *wrapped_src;
+          return;
+        }
+
+      const size_t N = dst.local_size();
+      AssertDimension(N_Vector_length(src), N);
+      const realtype *src_data = N_VGetArrayPointer(src);
+      for (size_t i=0; i<N; ++i)
+        {
+          dst.local_element(i) = src_data[i];
+        }
+    }
+
+    void copy(N_Vector &dst, const LinearAlgebra::distributed::Vector<double> &src)
+    {
+      if (LinearAlgebra::distributed::Vector<double> *wrapped_dst
+          = unwrap_nvector<LinearAlgebra::distributed::Vector<double> >(dst))
+        {
+          *wrapped_dst = src;
+          return;
+        }
+
+      const size_t N = src.local_size();
+      AssertDimension(N_Vector_length(dst), N);
+      realtype *dst_data = N_VGetArrayPointer(dst);
+      for (size_t i=0; i<N; ++i)
+        {
+          dst_data[i] = src.local_element(i);
+        }
+    }
+
+    void copy(LinearAlgebra::distributed::BlockVector<double> &dst, const N_Vector &src)
+    {
+      if (const LinearAlgebra::distributed::BlockVector<double> *wrapped_src
+          = unwrap_nvector<LinearAlgebra::distributed::BlockVector<double> >(src))
+        {
+          dst = *wrapped_src;
+          return;
+        }
+
+      const realtype *src_data = N_VGetArrayPointer(src);
+      size_t offset = 0;
+      for (unsigned int b=0; b<dst.n_blocks(); ++b)
+        {
+          const size_t N = dst.block(b).local_size();
+          for (size_t i=0; i<N; ++i)
+            {
+              dst.block(b).local_element(i) = src_data[offset+i];
+            }
+          offset += N;
+        }
+      AssertDimension(N_Vector_length(src), offset);
+    }
+
+    void copy(N_Vector &dst, const LinearAlgebra::distributed::BlockVector<double> &src)
+    {
+      if (LinearAlgebra::distributed::BlockVector<double> *wrapped_dst
+          = unwrap_nvector<LinearAlgebra::distributed::BlockVector<double> >(dst))
+        {
+          *wrapped_dst = src;
+          return;
+        }
+
+      realtype *dst_data = N_VGetArrayPointer(dst);
+      size_t offset = 0;
+      for (unsigned int b=0; b<src.n_blocks(); ++b)
+        {
+          const size_t N = src.block(b).local_size();
+          for (size_t i=0; i<N; ++i)
+            {
+              dst_data[offset+i] = src.block(b).local_element(i);
+            }
+          offset += N;
+        }
+      AssertDimension(N_Vector_length(dst), offset);
+    }
   }
 }
 DEAL_II_NAMESPACE_CLOSE
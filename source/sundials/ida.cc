@@ -31,6 +31,7 @@
 #endif
 #include <deal.II/base/utilities.h>
 #include <deal.II/sundials/copy.h>
+#include <deal.II/sundials/n_vector.h>
 
 #include <iostream>
 #include <iomanip>
@@ -49,24 +50,14 @@ namespace SUNDIALS
                        N_Vector rr, void *user_data)
     {
       IDA<VectorType> &solver = *static_cast<IDA<VectorType> *>(user_data);
-      GrowingVectorMemory<VectorType> mem;
-
-      typename VectorMemory<VectorType>::Pointer src_yy(mem);
-      solver.reinit_vector(*src_yy);
-
-      typename VectorMemory<VectorType>::Pointer src_yp(mem);
-      solver.reinit_vector(*src_yp);
 
-      typename VectorMemory<VectorType>::Pointer residual(mem);
-      solver.reinit_vector(*residual);
-
-      copy(*src_yy, yy);
-      copy(*src_yp, yp);
+      const NVectorView<VectorType> src_yy(yy, solver.reinit_vector);
+      const NVectorView<VectorType> src_yp(yp, solver.reinit_vector);
+      const NVectorView<VectorType> residual(rr, solver.reinit_vector,
+                                             NVectorAccess::write);
 
       int err = solver.residual(tt, *src_yy, *src_yp, *residual);
 
-      copy(rr, *residual);
-
       return err;
     }
 
@@ -86,16 +77,9 @@ namespace SUNDIALS
       (void) tmp3;
       (void) resp;
       IDA<VectorType> &solver = *static_cast<IDA<VectorType> *>(IDA_mem->ida_user_data);
-      GrowingVectorMemory<VectorType> mem;
 
-      typename VectorMemory<VectorType>::Pointer src_yy(mem);
-      solver.reinit_vector(*src_yy);
-
-      typename VectorMemory<VectorType>::Pointer src_yp(mem);
-      solver.reinit_vector(*src_yp);
-
-      copy(*src_yy, yy);
-      copy(*src_yp, yp);
+      const NVectorView<VectorType> src_yy(yy, solver.reinit_vector);
+      const NVectorView<VectorType> src_yp(yp, solver.reinit_vector);
 
       int err = solver.setup_jacobian(IDA_mem->ida_tn,
                                       *src_yy,
@@ -121,16 +105,15 @@ namespace SUNDIALS
       IDA<VectorType> &solver = *static_cast<IDA<VectorType> *>(IDA_mem->ida_user_data);
       GrowingVectorMemory<VectorType> mem;
 
-      typename VectorMemory<VectorType>::Pointer src(mem);
-      solver.reinit_vector(*src);
+      // b is both the right hand side and the solution of the linear system
+      const NVectorView<VectorType> src(b, solver.reinit_vector,
+                                        NVectorAccess::read_write);
 
       typename VectorMemory<VectorType>::Pointer dst(mem);
       solver.reinit_vector(*dst);
 
-      copy(*src, b);
-
       int err = solver.solve_jacobian_system(*src,*dst);
-      copy(b, *dst);
+      *src = *dst;
 
       return err;
     }
@@ -164,8 +147,6 @@ namespace SUNDIALS
                                           VectorType &solution_dot)
   {
 
-    unsigned int system_size = solution.size();
-
     double t = data.initial_time;
     double h = data.initial_step_size;
     unsigned int step_number = 0;
@@ -173,41 +154,12 @@ namespace SUNDIALS
     int status;
     (void)status;
 
-    // The solution is stored in
-    // solution. Here we take only a
-    // view of it.
-#ifdef DEAL_II_WITH_MPI
-    if (is_serial_vector<VectorType>::value == false)
-      {
-        const IndexSet is = solution.locally_owned_elements();
-        const size_t local_system_size = is.n_elements();
-
-        yy        = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-        yp        = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-        diff_id   = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-        abs_tolls = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-      }
-    else
-#endif
-      {
-        Assert(is_serial_vector<VectorType>::value,
-               ExcInternalError("Trying to use a serial code with a parallel vector."));
-        yy        = N_VNew_Serial(system_size);
-        yp        = N_VNew_Serial(system_size);
-        diff_id   = N_VNew_Serial(system_size);
-        abs_tolls = N_VNew_Serial(system_size);
-      }
+    // The solution is stored in the N_Vector yy, which wraps a vector of
+    // type VectorType if possible.
+    yy        = create_nvector(solution, communicator);
+    yp        = create_nvector(solution, communicator);
+    diff_id   = create_nvector(solution, communicator);
+    abs_tolls = create_nvector(solution, communicator);
     reset(data.initial_time,
           data.initial_step_size,
           solution,
@@ -240,22 +192,10 @@ namespace SUNDIALS
       }
 
     // Free the vectors which are no longer used.
-#ifdef DEAL_II_WITH_MPI
-    if (is_serial_vector<VectorType>::value == false)
-      {
-        N_VDestroy_Parallel(yy);
-        N_VDestroy_Parallel(yp);
-        N_VDestroy_Parallel(abs_tolls);
-        N_VDestroy_Parallel(diff_id);
-      }
-    else
-#endif
-      {
-        N_VDestroy_Serial(yy);
-        N_VDestroy_Serial(yp);
-        N_VDestroy_Serial(abs_tolls);
-        N_VDestroy_Serial(diff_id);
-      }
+    N_VDestroy(yy);
+    N_VDestroy(yp);
+    N_VDestroy(abs_tolls);
+    N_VDestroy(diff_id);
 
     return step_number;
   }
@@ -267,7 +207,6 @@ namespace SUNDIALS
                               VectorType &solution_dot)
   {
 
-    unsigned int system_size;
     bool first_step = (current_time == data.initial_time);
 
     if (ida_mem)
@@ -279,58 +218,18 @@ namespace SUNDIALS
     // Free the vectors which are no longer used.
     if (yy)
       {
-#ifdef DEAL_II_WITH_MPI
-        if (is_serial_vector<VectorType>::value == false)
-          {
-            N_VDestroy_Parallel(yy);
-            N_VDestroy_Parallel(yp);
-            N_VDestroy_Parallel(abs_tolls);
-            N_VDestroy_Parallel(diff_id);
-          }
-        else
-#endif
-          {
-            N_VDestroy_Serial(yy);
-            N_VDestroy_Serial(yp);
-            N_VDestroy_Serial(abs_tolls);
-            N_VDestroy_Serial(diff_id);
-          }
+        N_VDestroy(yy);
+        N_VDestroy(yp);
+        N_VDestroy(abs_tolls);
+        N_VDestroy(diff_id);
       }
 
     int status;
     (void)status;
-    system_size = solution.size();
-#ifdef DEAL_II_WITH_MPI
-    if (is_serial_vector<VectorType>::value == false)
-      {
-        const IndexSet is = solution.locally_owned_elements();
-        const size_t local_system_size = is.n_elements();
-
-        yy        = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-        yp        = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-        diff_id   = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-        abs_tolls = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-      }
-    else
-#endif
-      {
-        yy        = N_VNew_Serial(system_size);
-        yp        = N_VNew_Serial(system_size);
-        diff_id   = N_VNew_Serial(system_size);
-        abs_tolls = N_VNew_Serial(system_size);
-      }
+    yy        = create_nvector(solution, communicator);
+    yp        = create_nvector(solution, communicator);
+    diff_id   = create_nvector(solution, communicator);
+    abs_tolls = create_nvector(solution, communicator);
 
     copy(yy, solution);
     copy(yp, solution_dot);
@@ -492,6 +391,8 @@ namespace SUNDIALS
 
   template class IDA<Vector<double> >;
   template class IDA<BlockVector<double> >;
+  template class IDA<LinearAlgebra::distributed::Vector<double> >;
+  template class IDA<LinearAlgebra::distributed::BlockVector<double> >;
 
 #ifdef DEAL_II_WITH_MPI
 
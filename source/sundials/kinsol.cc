@@ -31,6 +31,7 @@
 #endif
 #include <deal.II/base/utilities.h>
 #include <deal.II/sundials/copy.h>
+#include <deal.II/sundials/n_vector.h>
 
 #include <sundials/sundials_config.h>
 #if DEAL_II_SUNDIALS_VERSION_GTE(3,0,0)
@@ -58,15 +59,10 @@ namespace SUNDIALS
                           void *user_data)
     {
       KINSOL<VectorType> &solver = *static_cast<KINSOL<VectorType> *>(user_data);
-      GrowingVectorMemory<VectorType> mem;
 
-      typename VectorMemory<VectorType>::Pointer src_yy(mem);
-      solver.reinit_vector(*src_yy);
-
-      typename VectorMemory<VectorType>::Pointer dst_FF(mem);
-      solver.reinit_vector(*dst_FF);
-
-      copy(*src_yy, yy);
+      const NVectorView<VectorType> src_yy(yy, solver.reinit_vector);
+      const NVectorView<VectorType> dst_FF(FF, solver.reinit_vector,
+                                           NVectorAccess::write);
 
       int err = 0;
       if (solver.residual)
@@ -76,8 +72,6 @@ namespace SUNDIALS
       else
         Assert(false, ExcInternalError());
 
-      copy(FF, *dst_FF);
-
       return err;
     }
 
@@ -87,16 +81,9 @@ namespace SUNDIALS
     int t_kinsol_setup_jacobian(KINMem kinsol_mem)
     {
       KINSOL<VectorType> &solver = *static_cast<KINSOL<VectorType> *>(kinsol_mem->kin_user_data);
-      GrowingVectorMemory<VectorType> mem;
-
-      typename VectorMemory<VectorType>::Pointer src_ycur(mem);
-      solver.reinit_vector(*src_ycur);
 
-      typename VectorMemory<VectorType>::Pointer src_fcur(mem);
-      solver.reinit_vector(*src_fcur);
-
-      copy(*src_ycur, kinsol_mem->kin_uu);
-      copy(*src_fcur, kinsol_mem->kin_fval);
+      const NVectorView<VectorType> src_ycur(kinsol_mem->kin_uu, solver.reinit_vector);
+      const NVectorView<VectorType> src_fcur(kinsol_mem->kin_fval, solver.reinit_vector);
 
       int err = solver.setup_jacobian(*src_ycur, *src_fcur);
       return err;
@@ -112,28 +99,20 @@ namespace SUNDIALS
                                 realtype *sFdotJp)
     {
       KINSOL<VectorType> &solver = *static_cast<KINSOL<VectorType> *>(kinsol_mem->kin_user_data);
-      GrowingVectorMemory<VectorType> mem;
-
-      typename VectorMemory<VectorType>::Pointer src_ycur(mem);
-      solver.reinit_vector(*src_ycur);
-
-      typename VectorMemory<VectorType>::Pointer src_fcur(mem);
-      solver.reinit_vector(*src_fcur);
 
-      copy(*src_ycur, kinsol_mem->kin_uu);
-      copy(*src_fcur, kinsol_mem->kin_fval);
+      const NVectorView<VectorType> src_ycur(kinsol_mem->kin_uu, solver.reinit_vector);
+      const NVectorView<VectorType> src_fcur(kinsol_mem->kin_fval, solver.reinit_vector);
 
-      typename VectorMemory<VectorType>::Pointer src(mem);
-      solver.reinit_vector(*src);
-
-      typename VectorMemory<VectorType>::Pointer dst(mem);
-      solver.reinit_vector(*dst);
-
-      copy(*src, b);
+      // copy the solution back to x, if necessary, before b is modified below
+      int err = 0;
+      {
+        const NVectorView<VectorType> src(b, solver.reinit_vector);
+        const NVectorView<VectorType> dst(x, solver.reinit_vector,
+                                          NVectorAccess::write);
 
-      int err = solver.solve_jacobian_system(*src_ycur, *src_fcur,
-                                             *src,*dst);
-      copy(x, *dst);
+        err = solver.solve_jacobian_system(*src_ycur, *src_fcur,
+                                           *src,*dst);
+      }
 
       *sJpnorm = N_VWL2Norm(b, kinsol_mem->kin_fscale);
       N_VProd(b, kinsol_mem->kin_fscale, b);
@@ -172,40 +151,16 @@ namespace SUNDIALS
   {
     unsigned int system_size = initial_guess_and_solution.size();
 
-    // The solution is stored in
-    // solution. Here we take only a
-    // view of it.
-#ifdef DEAL_II_WITH_MPI
-    if (is_serial_vector<VectorType>::value == false)
-      {
-        const IndexSet is = initial_guess_and_solution.locally_owned_elements();
-        const unsigned int local_system_size = is.n_elements();
-
-        solution        = N_VNew_Parallel(communicator,
-                                          local_system_size,
-                                          system_size);
-
-        u_scale = N_VNew_Parallel(communicator,
-                                  local_system_size,
-                                  system_size);
-        N_VConst_Parallel( 1.e0, u_scale );
-
-        f_scale = N_VNew_Parallel(communicator,
-                                  local_system_size,
-                                  system_size);
-        N_VConst_Parallel( 1.e0, f_scale );
-      }
-    else
-#endif
-      {
-        Assert(is_serial_vector<VectorType>::value,
-               ExcInternalError("Trying to use a serial code with a parallel vector."));
-        solution = N_VNew_Serial(system_size);
-        u_scale  = N_VNew_Serial(system_size);
-        N_VConst_Serial( 1.e0, u_scale );
-        f_scale  = N_VNew_Serial(system_size);
-        N_VConst_Serial( 1.e0, f_scale );
-      }
+    // The solution is stored in the N_Vector solution, which wraps a vector
+    // of type VectorType if possible. The dense linear solver of KINSOL, used
+    // if no solve_jacobian_system() is provided, only works on the vectors
+    // of SUNDIALS.
+    const bool wrap = static_cast<bool>(solve_jacobian_system);
+    solution = create_nvector(initial_guess_and_solution, communicator, wrap);
+    u_scale  = create_nvector(initial_guess_and_solution, communicator, wrap);
+    N_VConst( 1.e0, u_scale );
+    f_scale  = create_nvector(initial_guess_and_solution, communicator, wrap);
+    N_VConst( 1.e0, f_scale );
 
     if (get_solution_scaling)
       copy(u_scale, get_solution_scaling());
@@ -293,20 +248,9 @@ namespace SUNDIALS
     copy(initial_guess_and_solution, solution );
 
     // Free the vectors which are no longer used.
-#ifdef DEAL_II_WITH_MPI
-    if (is_serial_vector<VectorType>::value == false)
-      {
-        N_VDestroy_Parallel(solution);
-        N_VDestroy_Parallel(u_scale);
-        N_VDestroy_Parallel(f_scale);
-      }
-    else
-#endif
-      {
-        N_VDestroy_Serial(solution);
-        N_VDestroy_Serial(u_scale);
-        N_VDestroy_Serial(f_scale);
-      }
+    N_VDestroy(solution);
+    N_VDestroy(u_scale);
+    N_VDestroy(f_scale);
 
     long nniters;
     status = KINGetNumNonlinSolvIters(kinsol_mem, &nniters);
@@ -331,6 +275,8 @@ namespace SUNDIALS
 
   template class KINSOL<Vector<double> >;
   template class KINSOL<BlockVector<double> >;
+  template class KINSOL<LinearAlgebra::distributed::Vector<double> >;
+  template class KINSOL<LinearAlgebra::distributed::BlockVector<double> >;
 
 #ifdef DEAL_II_WITH_MPI
 
@@ -0,0 +1,610 @@
+//-----------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+//-----------------------------------------------------------
+
+
+#include <deal.II/sundials/n_vector.h>
+
+#ifdef DEAL_II_WITH_SUNDIALS
+
+#include <deal.II/base/array_view.h>
+#include <deal.II/lac/vector_type_traits.h>
+#ifdef DEAL_II_WITH_TRILINOS
+#  include <deal.II/lac/trilinos_parallel_block_vector.h>
+#  include <deal.II/lac/trilinos_vector.h>
+#endif
+#ifdef DEAL_II_WITH_PETSC
+#  include <deal.II/lac/petsc_parallel_block_vector.h>
+#  include <deal.II/lac/petsc_parallel_vector.h>
+#endif
+
+#include <sundials/sundials_config.h>
+
+#include <cmath>
+#include <limits>
+
+DEAL_II_NAMESPACE_OPEN
+namespace SUNDIALS
+{
+  namespace internal
+  {
+    namespace
+    {
+#if DEAL_II_SUNDIALS_VERSION_LT(3,0,0)
+      typedef long int index_type;
+#else
+      typedef sunindextype index_type;
+#endif
+
+      // The operations on N_Vector objects wrapping deal.II vectors work on
+      // the locally owned entries of each block, accessed by the following
+      // functions, and reduce over the communicator of the vector
+      unsigned int n_local_blocks (const Vector<double> &)
+      {
+        return 1;
+      }
+
+      unsigned int n_local_blocks (const LinearAlgebra::distributed::Vector<double> &)
+      {
+        return 1;
+      }
+
+      unsigned int n_local_blocks (const BlockVector<double> &v)
+      {
+        return v.n_blocks();
+      }
+
+      unsigned int n_local_blocks (const LinearAlgebra::distributed::BlockVector<double> &v)
+      {
+        return v.n_blocks();
+      }
+
+
+
+      ArrayView<double> local_entries (Vector<double> &v,
+                                       const unsigned int)
+      {
+        return ArrayView<double>(v.begin(), v.size());
+      }
+
+      ArrayView<double> local_entries (LinearAlgebra::distributed::Vector<double> &v,
+                                       const unsigned int)
+      {
+        return ArrayView<double>(v.begin(), v.local_size());
+      }
+
+      ArrayView<double> local_entries (BlockVector<double> &v,
+                                       const unsigned int block)
+      {
+        return local_entries(v.block(block), 0);
+      }
+
+      ArrayView<double> local_entries (LinearAlgebra::distributed::BlockVector<double> &v,
+                                       const unsigned int block)
+      {
+        return local_entries(v.block(block), 0);
+      }
+
+      template <typename VectorType>
+      ArrayView<const double> local_entries (const VectorType &v,
+                                             const unsigned int block)
+      {
+        return local_entries(const_cast<VectorType &>(v), block);
+      }
+
+
+
+      MPI_Comm get_communicator (const Vector<double> &)
+      {
+        return MPI_COMM_SELF;
+      }
+
+      MPI_Comm get_communicator (const BlockVector<double> &)
+      {
+        return MPI_COMM_SELF;
+      }
+
+      MPI_Comm get_communicator (const LinearAlgebra::distributed::Vector<double> &v)
+      {
+        return v.get_mpi_communicator();
+      }
+
+      MPI_Comm get_communicator (const LinearAlgebra::distributed::BlockVector<double> &v)
+      {
+        return (v.n_blocks() > 0 ? v.block(0).get_mpi_communicator() : MPI_COMM_SELF);
+      }
+
+
+
+      // call operation(z_i, x_i, y_i) for all locally owned entries of the
+      // vectors, which may be the same objects
+      template <typename VectorType, typename Operation>
+      void apply_to_local_entries (VectorType       &z,
+                                   const VectorType &x,
+                                   const VectorType &y,
+                                   const Operation  &operation)
+      {
+        for (unsigned int b=0; b<n_local_blocks(z); ++b)
+          {
+            const ArrayView<double> z_b = local_entries(z, b);
+            const ArrayView<const double> x_b = local_entries(x, b);
+            const ArrayView<const double> y_b = local_entries(y, b);
+            AssertDimension (x_b.size(), z_b.size());
+            AssertDimension (y_b.size(), z_b.size());
+            for (std::size_t i=0; i<z_b.size(); ++i)
+              operation(z_b[i], x_b[i], y_b[i]);
+          }
+      }
+
+      // call operation(x_i, y_i, w_i) for all locally owned entries of the
+      // vectors
+      template <typename VectorType, typename Operation>
+      void visit_local_entries (const VectorType &x,
+                                const VectorType &y,
+                                const VectorType &w,
+                                const Operation  &operation)
+      {
+        for (unsigned int b=0; b<n_local_blocks(x); ++b)
+          {
+            const ArrayView<const double> x_b = local_entries(x, b);
+            const ArrayView<const double> y_b = local_entries(y, b);
+            const ArrayView<const double> w_b = local_entries(w, b);
+            AssertDimension (y_b.size(), x_b.size());
+            AssertDimension (w_b.size(), x_b.size());
+            for (std::size_t i=0; i<x_b.size(); ++i)
+              operation(x_b[i], y_b[i], w_b[i]);
+          }
+      }
+
+
+
+      template <typename VectorType>
+      VectorType &vector_of (N_Vector v)
+      {
+        Assert (v != nullptr && v->content != nullptr, ExcInternalError());
+        return *static_cast<VectorType *>(v->content);
+      }
+
+      template <typename VectorType>
+      _generic_N_Vector_Ops *get_operations ();
+
+      template <typename VectorType>
+      N_Vector make_nvector (VectorType *vector)
+      {
+        N_Vector v = new _generic_N_Vector;
+        v->content = vector;
+        v->ops = get_operations<VectorType>();
+        return v;
+      }
+
+
+
+      template <typename VectorType>
+      N_Vector_ID get_vector_id (N_Vector)
+      {
+        return SUNDIALS_NVEC_CUSTOM;
+      }
+
+      template <typename VectorType>
+      N_Vector clone_empty (N_Vector)
+      {
+        return make_nvector(new VectorType());
+      }
+
+      template <typename VectorType>
+      N_Vector clone (N_Vector w)
+      {
+        VectorType *vector = new VectorType();
+        vector->reinit(vector_of<VectorType>(w), true);
+        return make_nvector(vector);
+      }
+
+      template <typename VectorType>
+      void destroy (N_Vector v)
+      {
+        if (v == nullptr)
+          return;
+        delete static_cast<VectorType *>(v->content);
+        delete v;
+      }
+
+      template <typename VectorType>
+      void space (N_Vector v, index_type *lrw, index_type *liw)
+      {
+        const VectorType &x = vector_of<VectorType>(v);
+        std::size_t n_local_entries = 0;
+        for (unsigned int b=0; b<n_local_blocks(x); ++b)
+          n_local_entries += local_entries(x, b).size();
+        *lrw = n_local_entries;
+        *liw = 0;
+      }
+
+      template <typename VectorType>
+      realtype *get_array_pointer (N_Vector v)
+      {
+        // the entries are only contiguous if there is a single block
+        VectorType &x = vector_of<VectorType>(v);
+        return (n_local_blocks(x) == 1 ? local_entries(x, 0).begin() : nullptr);
+      }
+
+      template <typename VectorType>
+      void linear_sum (realtype a, N_Vector x, realtype b, N_Vector y, N_Vector z)
+      {
+        apply_to_local_entries(vector_of<VectorType>(z), vector_of<VectorType>(x),
+                               vector_of<VectorType>(y),
+                               [a,b] (double &z_i, const double x_i, const double y_i)
+        {
+          z_i = a*x_i + b*y_i;
+        });
+      }
+
+      template <typename VectorType>
+      void set_constant (realtype c, N_Vector z)
+      {
+        vector_of<VectorType>(z) = c;
+      }
+
+      template <typename VectorType>
+      void product (N_Vector x, N_Vector y, N_Vector z)
+      {
+        apply_to_local_entries(vector_of<VectorType>(z), vector_of<VectorType>(x),
+                               vector_of<VectorType>(y),
+                               [] (double &z_i, const double x_i, const double y_i)
+        {
+          z_i = x_i*y_i;
+        });
+      }
+
+      template <typename VectorType>
+      void divide (N_Vector x, N_Vector y, N_Vector z)
+      {
+        apply_to_local_entries(vector_of<VectorType>(z), vector_of<VectorType>(x),
+                               vector_of<VectorType>(y),
+                               [] (double &z_i, const double x_i, const double y_i)
+        {
+          z_i = x_i/y_i;
+        });
+      }
+
+      template <typename VectorType>
+      void scale (realtype c, N_Vector x, N_Vector z)
+      {
+        const VectorType &x_vector = vector_of<VectorType>(x);
+        apply_to_local_entries(vector_of<VectorType>(z), x_vector, x_vector,
+                               [c] (double &z_i, const double x_i, const double)
+        {
+          z_i = c*x_i;
+        });
+      }
+
+      template <typename VectorType>
+      void absolute_value (N_Vector x, N_Vector z)
+      {
+        const VectorType &x_vector = vector_of<VectorType>(x);
+        apply_to_local_entries(vector_of<VectorType>(z), x_vector, x_vector,
+                               [] (double &z_i, const double x_i, const double)
+        {
+          z_i = std::abs(x_i);
+        });
+      }
+
+      template <typename VectorType>
+      void inverse (N_Vector x, N_Vector z)
+      {
+        const VectorType &x_vector = vector_of<VectorType>(x);
+        apply_to_local_entries(vector_of<VectorType>(z), x_vector, x_vector,
+                               [] (double &z_i, const double x_i, const double)
+        {
+          z_i = 1./x_i;
+        });
+      }
+
+      template <typename VectorType>
+      void add_constant (N_Vector x, realtype b, N_Vector z)
+      {
+        const VectorType &x_vector = vector_of<VectorType>(x);
+        apply_to_local_entries(vector_of<VectorType>(z), x_vector, x_vector,
+                               [b] (double &z_i, const double x_i, const double)
+        {
+          z_i = x_i + b;
+        });
+      }
+
+      template <typename VectorType>
+      realtype dot_product (N_Vector x, N_Vector y)
+      {
+        return vector_of<VectorType>(x) * vector_of<VectorType>(y);
+      }
+
+      template <typename VectorType>
+      realtype max_norm (N_Vector x)
+      {
+        return vector_of<VectorType>(x).linfty_norm();
+      }
+
+      template <typename VectorType>
+      realtype weighted_rms_norm (N_Vector x, N_Vector w)
+      {
+        const VectorType &x_vector = vector_of<VectorType>(x);
+        double sum = 0.;
+        visit_local_entries(x_vector, vector_of<VectorType>(w), x_vector,
+                            [&sum] (const double x_i, const double w_i, const double)
+        {
+          sum += (x_i*w_i) * (x_i*w_i);
+        });
+        sum = Utilities::MPI::sum(sum, get_communicator(x_vector));
+        return std::sqrt(sum / x_vector.size());
+      }
+
+      template <typename VectorType>
+      realtype weighted_rms_norm_mask (N_Vector x, N_Vector w, N_Vector id)
+      {
+        const VectorType &x_vector = vector_of<VectorType>(x);
+        double sum = 0.;
+        visit_local_entries(x_vector, vector_of<VectorType>(w), vector_of<VectorType>(id),
+                            [&sum] (const double x_i, const double w_i, const double id_i)
+        {
+          if (id_i > 0.)
+            sum += (x_i*w_i) * (x_i*w_i);
+        });
+        sum = Utilities::MPI::sum(sum, get_communicator(x_vector));
+        return std::sqrt(sum / x_vector.size());
+      }
+
+      template <typename VectorType>
+      realtype min_element (N_Vector x)
+      {
+        const VectorType &x_vector = vector_of<VectorType>(x);
+        double min = std::numeric_limits<double>::max();
+        visit_local_entries(x_vector, x_vector, x_vector,
+                            [&min] (const double x_i, const double, const double)
+        {
+          min = std::min(min, x_i);
+        });
+        return Utilities::MPI::min(min, get_communicator(x_vector));
+      }
+
+      template <typename VectorType>
+      realtype weighted_l2_norm (N_Vector x, N_Vector w)
+      {
+        const VectorType &x_vector = vector_of<VectorType>(x);
+        double sum = 0.;
+        visit_local_entries(x_vector, vector_of<VectorType>(w), x_vector,
+                            [&sum] (const double x_i, const double w_i, const double)
+        {
+          sum += (x_i*w_i) * (x_i*w_i);
+        });
+        return std::sqrt(Utilities::MPI::sum(sum, get_communicator(x_vector)));
+      }
+
+      template <typename VectorType>
+      realtype l1_norm (N_Vector x)
+      {
+        return vector_of<VectorType>(x).l1_norm();
+      }
+
+      template <typename VectorType>
+      void compare (realtype c, N_Vector x, N_Vector z)
+      {
+        const VectorType &x_vector = vector_of<VectorType>(x);
+        apply_to_local_entries(vector_of<VectorType>(z), x_vector, x_vector,
+                               [c] (double &z_i, const double x_i, const double)
+        {
+          z_i = (std::abs(x_i) >= c) ? 1. : 0.;
+        });
+      }
+
+      template <typename VectorType>
+      booleantype inverse_test (N_Vector x, N_Vector z)
+      {
+        const VectorType &x_vector = vector_of<VectorType>(x);
+        double no_zero_found = 1.;
+        apply_to_local_entries(vector_of<VectorType>(z), x_vector, x_vector,
+                               [&no_zero_found] (double &z_i, const double x_i, const double)
+        {
+          if (x_i == 0.)
+            no_zero_found = 0.;
+          else
+            z_i = 1./x_i;
+        });
+        return (Utilities::MPI::min(no_zero_found, get_communicator(x_vector)) > 0.);
+      }
+
+      template <typename VectorType>
+      booleantype constraint_mask (N_Vector c, N_Vector x, N_Vector m)
+      {
+        // the constraints c_i = 2, 1, -1, -2 require x_i > 0, x_i >= 0,
+        // x_i <= 0, x_i < 0, respectively, and m_i is set to one where they
+        // are violated
+        const VectorType &x_vector = vector_of<VectorType>(x);
+        double all_satisfied = 1.;
+        apply_to_local_entries(vector_of<VectorType>(m), vector_of<VectorType>(c), x_vector,
+                               [&all_satisfied] (double &m_i, const double c_i, const double x_i)
+        {
+          m_i = 0.;
+          if ((std::abs(c_i) > 1.5 && x_i*c_i <= 0.) ||
+              (std::abs(c_i) > 0.5 && x_i*c_i < 0.))
+            {
+              m_i = 1.;
+              all_satisfied = 0.;
+            }
+        });
+        return (Utilities::MPI::min(all_satisfied, get_communicator(x_vector)) > 0.);
+      }
+
+      template <typename VectorType>
+      realtype min_quotient (N_Vector num, N_Vector denom)
+      {
+        const VectorType &num_vector = vector_of<VectorType>(num);
+        double min = std::numeric_limits<double>::max();
+        visit_local_entries(num_vector, vector_of<VectorType>(denom), num_vector,
+                            [&min] (const double num_i, const double denom_i, const double)
+        {
+          if (denom_i != 0.)
+            min = std::min(min, num_i/denom_i);
+        });
+        return Utilities::MPI::min(min, get_communicator(num_vector));
+      }
+
+
+
+      template <typename VectorType>
+      _generic_N_Vector_Ops create_operations ()
+      {
+        _generic_N_Vector_Ops operations = {};
+        operations.nvgetvectorid     = &get_vector_id<VectorType>;
+        operations.nvclone           = &clone<VectorType>;
+        operations.nvcloneempty      = &clone_empty<VectorType>;
+        operations.nvdestroy         = &destroy<VectorType>;
+        operations.nvspace           = &space<VectorType>;
+        operations.nvgetarraypointer = &get_array_pointer<VectorType>;
+        operations.nvsetarraypointer = nullptr;
+        operations.nvlinearsum       = &linear_sum<VectorType>;
+        operations.nvconst           = &set_constant<VectorType>;
+        operations.nvprod            = &product<VectorType>;
+        operations.nvdiv             = &divide<VectorType>;
+        operations.nvscale           = &scale<VectorType>;
+        operations.nvabs             = &absolute_value<VectorType>;
+        operations.nvinv             = &inverse<VectorType>;
+        operations.nvaddconst        = &add_constant<VectorType>;
+        operations.nvdotprod         = &dot_product<VectorType>;
+        operations.nvmaxnorm         = &max_norm<VectorType>;
+        operations.nvwrmsnorm        = &weighted_rms_norm<VectorType>;
+        operations.nvwrmsnormmask    = &weighted_rms_norm_mask<VectorType>;
+        operations.nvmin             = &min_element<VectorType>;
+        operations.nvwl2norm         = &weighted_l2_norm<VectorType>;
+        operations.nvl1norm          = &l1_norm<VectorType>;
+        operations.nvcompare         = &compare<VectorType>;
+        operations.nvinvtest         = &inverse_test<VectorType>;
+        operations.nvconstrmask      = &constraint_mask<VectorType>;
+        operations.nvminquotient     = &min_quotient<VectorType>;
+        return operations;
+      }
+
+      template <typename VectorType>
+      _generic_N_Vector_Ops *get_operations ()
+      {
+        static _generic_N_Vector_Ops operations = create_operations<VectorType>();
+        return &operations;
+      }
+
+
+
+      template <typename VectorType>
+      N_Vector create_nvector (const VectorType &model,
+                               const MPI_Comm   &,
+                               std::true_type)
+      {
+        VectorType *vector = new VectorType();
+        vector->reinit(model, false);
+        return make_nvector(vector);
+      }
+
+      template <typename VectorType>
+      N_Vector create_nvector (const VectorType &model,
+                               const MPI_Comm   &communicator,
+                               std::false_type)
+      {
+        N_Vector v = nullptr;
+#ifdef DEAL_II_WITH_MPI
+        if (is_serial_vector<VectorType>::value == false)
+          v = N_VNew_Parallel(communicator,
+                              model.locally_owned_elements().n_elements(),
+                              model.size());
+        else
+#endif
+          {
+            (void)communicator;
+            v = N_VNew_Serial(model.size());
+          }
+        N_VConst(0., v);
+        return v;
+      }
+
+      template <typename VectorType>
+      VectorType *unwrap_nvector (N_Vector nvector,
+                                  std::true_type)
+      {
+        if (nvector != nullptr && nvector->ops == get_operations<VectorType>())
+          return static_cast<VectorType *>(nvector->content);
+        else
+          return nullptr;
+      }
+
+      template <typename VectorType>
+      VectorType *unwrap_nvector (N_Vector,
+                                  std::false_type)
+      {
+        return nullptr;
+      }
+    }
+
+
+
+    template <typename VectorType>
+    N_Vector
+    create_nvector (const VectorType &model,
+                    const MPI_Comm   &communicator,
+                    const bool        wrap)
+    {
+      if (wrap)
+        return create_nvector(model, communicator,
+                              std::integral_constant<bool, IsNVectorWrappable<VectorType>::value>());
+      else
+        return create_nvector(model, communicator, std::false_type());
+    }
+
+
+
+    template <typename VectorType>
+    VectorType *
+    unwrap_nvector (N_Vector nvector)
+    {
+      return unwrap_nvector<VectorType>(nvector,
+                                        std::integral_constant<bool, IsNVectorWrappable<VectorType>::value>());
+    }
+
+
+
+#define INSTANTIATE(VectorType) \
+    template N_Vector create_nvector (const VectorType &, const MPI_Comm &, const bool); \
+    template VectorType *unwrap_nvector (N_Vector)
+
+    INSTANTIATE(Vector<double>);
+    INSTANTIATE(BlockVector<double>);
+    INSTANTIATE(LinearAlgebra::distributed::Vector<double>);
+    INSTANTIATE(LinearAlgebra::distributed::BlockVector<double>);
+
+#ifdef DEAL_II_WITH_MPI
+
+#ifdef DEAL_II_WITH_TRILINOS
+    INSTANTIATE(TrilinosWrappers::MPI::Vector);
+    INSTANTIATE(TrilinosWrappers::MPI::BlockVector);
+#endif // DEAL_II_WITH_TRILINOS
+
+#ifdef DEAL_II_WITH_PETSC
+#ifndef PETSC_USE_COMPLEX
+    INSTANTIATE(PETScWrappers::MPI::Vector);
+    INSTANTIATE(PETScWrappers::MPI::BlockVector);
+#endif // PETSC_USE_COMPLEX
+#endif // DEAL_II_WITH_PETSC
+
+#endif // DEAL_II_WITH_MPI
+
+#undef INSTANTIATE
+  }
+}
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,85 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+// A minimal harness for the microbenchmarks: a kernel is run repeatedly
+// until a minimal time has elapsed, and the best time of a single run is
+// reported together with the throughput derived from it.
+
+#ifndef dealii_benchmarks_benchmark_h
+#define dealii_benchmarks_benchmark_h
+
+#include <deal.II/base/timer.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+
+
+namespace Benchmark
+{
+  /**
+   * Run @p kernel once to warm up the caches and then repeatedly until the
+   * accumulated time exceeds @p min_time seconds, and at least three times.
+   * Return the minimal wall time in seconds of a single run.
+   */
+  template <typename Kernel>
+  double
+  time_kernel (const Kernel &kernel,
+               const double  min_time = 0.5)
+  {
+    kernel();
+
+    dealii::Timer timer;
+    double best_time = std::numeric_limits<double>::max();
+    double total_time = 0.;
+    for (unsigned int n_runs=0; n_runs<3 || total_time<min_time; ++n_runs)
+      {
+        timer.restart();
+        kernel();
+        const double time = timer.wall_time();
+        best_time = std::min(best_time, time);
+        total_time += time;
+      }
+    return best_time;
+  }
+
+
+
+  /**
+   * Print a line with the name of a benchmark, the time of a run and the
+   * throughput @p work_per_run / time in units of @p unit, where the work is
+   * scaled by 1e-9 for the unit GB/s and by 1e-6 for all others.
+   */
+  inline
+  void
+  report (const std::string &name,
+          const double       time,
+          const double       work_per_run,
+          const std::string &unit)
+  {
+    const double scaling = (unit == "GB/s" ? 1e-9 : 1e-6);
+    const std::string prefix = (unit == "GB/s" ? "" : "M");
+    std::cout << std::left << std::setw(48) << name << std::right
+              << std::scientific << std::setprecision(3)
+              << std::setw(12) << time << " s"
+              << std::fixed << std::setprecision(2)
+              << std::setw(12) << work_per_run/time*scaling
+              << ' ' << prefix << unit << std::endl;
+  }
+}
+
+#endif
@@ -0,0 +1,113 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+// benchmark ConstraintMatrix::distribute_local_to_global of cell matrices
+// and vectors into a SparseMatrix and a Vector, for FE_Q elements on a 3D
+// mesh with hanging nodes and Dirichlet boundary conditions
+
+#include "benchmark.h"
+
+#include <deal.II/base/function.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include <sstream>
+
+using namespace dealii;
+
+
+template <int dim>
+void test (const unsigned int degree,
+           const unsigned int n_refinements)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+  // refine the cells in one corner once more to get hanging nodes
+  for (typename Triangulation<dim>::active_cell_iterator cell=tria.begin_active();
+       cell != tria.end(); ++cell)
+    if (cell->center()[0] < 0.5 && cell->center()[1] < 0.5)
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  FE_Q<dim> fe (degree);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  ConstraintMatrix constraints;
+  DoFTools::make_hanging_node_constraints (dof_handler, constraints);
+  VectorTools::interpolate_boundary_values (dof_handler, 0,
+                                            Functions::ZeroFunction<dim>(),
+                                            constraints);
+  constraints.close();
+
+  DynamicSparsityPattern dsp (dof_handler.n_dofs());
+  DoFTools::make_sparsity_pattern (dof_handler, dsp, constraints, false);
+  SparsityPattern sparsity;
+  sparsity.copy_from (dsp);
+
+  SparseMatrix<double> matrix (sparsity);
+  Vector<double> rhs (dof_handler.n_dofs());
+
+  // the values of the cell matrix do not matter for the cost, so use an
+  // arbitrary symmetric matrix
+  FullMatrix<double> cell_matrix (fe.dofs_per_cell, fe.dofs_per_cell);
+  Vector<double> cell_rhs (fe.dofs_per_cell);
+  for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+    {
+      for (unsigned int j=0; j<fe.dofs_per_cell; ++j)
+        cell_matrix(i,j) = (i==j ? 2. : -1./(1+i+j));
+      cell_rhs(i) = 1.;
+    }
+
+  std::vector<types::global_dof_index> local_dof_indices (fe.dofs_per_cell);
+  const double time = Benchmark::time_kernel ([&]()
+  {
+    matrix = 0;
+    rhs = 0;
+    for (typename DoFHandler<dim>::active_cell_iterator cell=dof_handler.begin_active();
+         cell != dof_handler.end(); ++cell)
+      {
+        cell->get_dof_indices (local_dof_indices);
+        constraints.distribute_local_to_global (cell_matrix, cell_rhs,
+                                                local_dof_indices,
+                                                matrix, rhs);
+      }
+  });
+
+  std::ostringstream name;
+  name << "ConstraintMatrix::distribute_local_to_global Q" << degree
+       << " " << dim << "D";
+  Benchmark::report (name.str(), time, tria.n_active_cells(), "cells/s");
+}
+
+
+
+int main()
+{
+  test<3> (1, 4);
+  test<3> (2, 3);
+  test<3> (4, 2);
+}
@@ -0,0 +1,87 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+// benchmark DataOut::build_patches and the output in the VTU format for a
+// solution on a 3D mesh with FE_Q elements of degree two, with one
+// subdivision of the patches per polynomial degree
+
+#include "benchmark.h"
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/data_out.h>
+
+#include <sstream>
+
+using namespace dealii;
+
+
+template <int dim>
+void test (const unsigned int degree,
+           const unsigned int n_refinements)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+
+  FE_Q<dim> fe (degree);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  Vector<double> solution (dof_handler.n_dofs());
+  for (unsigned int i=0; i<solution.size(); ++i)
+    solution(i) = 1. + 0.01*(i%17);
+
+  DataOut<dim> data_out;
+  data_out.attach_dof_handler (dof_handler);
+  data_out.add_data_vector (solution, "solution");
+
+  std::ostringstream name;
+  name << " Q" << degree << " " << dim << "D";
+
+  const double time_patches = Benchmark::time_kernel ([&]()
+  {
+    data_out.build_patches (degree);
+  });
+  Benchmark::report ("DataOut::build_patches" + name.str(), time_patches,
+                     tria.n_active_cells(), "cells/s");
+
+  // write into a string stream to not measure the file system. the stream is
+  // reused for all runs to not measure memory allocation either, and the
+  // size of the output gives the throughput in GB/s
+  std::ostringstream output;
+  std::size_t output_size = 0;
+  const double time_write = Benchmark::time_kernel ([&]()
+  {
+    output.seekp (0);
+    data_out.write_vtu (output);
+    output_size = output.tellp();
+  });
+  Benchmark::report ("DataOut::write_vtu" + name.str(), time_write,
+                     tria.n_active_cells(), "cells/s");
+  Benchmark::report ("DataOut::write_vtu" + name.str(), time_write,
+                     output_size, "GB/s");
+}
+
+
+
+int main()
+{
+  test<3> (1, 5);
+  test<3> (2, 4);
+}
@@ -0,0 +1,91 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+// benchmark FEEvaluation::evaluate and FEEvaluation::integrate for the
+// gradients of FE_Q elements of degrees one to eight in 3D, i.e., the sum
+// factorization kernels without reading from or writing into global vectors
+
+#include "benchmark.h"
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <sstream>
+
+using namespace dealii;
+
+
+template <int dim, int fe_degree>
+void test (const unsigned int n_refinements)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+
+  FE_Q<dim> fe (fe_degree);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  ConstraintMatrix constraints;
+  constraints.close();
+
+  MatrixFree<dim,double> matrix_free;
+  typename MatrixFree<dim,double>::AdditionalData data;
+  data.tasks_parallel_scheme = MatrixFree<dim,double>::AdditionalData::none;
+  matrix_free.reinit (dof_handler, constraints, QGauss<1>(fe_degree+1), data);
+
+  FEEvaluation<dim,fe_degree> phi (matrix_free);
+  for (unsigned int i=0; i<phi.dofs_per_cell; ++i)
+    phi.begin_dof_values()[i] = 1. + 0.01*i;
+
+  const double time = Benchmark::time_kernel ([&]()
+  {
+    for (unsigned int cell=0; cell<matrix_free.n_macro_cells(); ++cell)
+      {
+        phi.reinit (cell);
+        phi.evaluate (false, true);
+        for (unsigned int q=0; q<phi.n_q_points; ++q)
+          phi.submit_gradient (phi.get_gradient(q), q);
+        phi.integrate (false, true);
+      }
+  });
+
+  const double n_cell_dofs = 1. * matrix_free.n_macro_cells() *
+                             VectorizedArray<double>::n_array_elements *
+                             phi.dofs_per_cell;
+
+  std::ostringstream name;
+  name << "FEEvaluation evaluate+integrate Q" << fe_degree << " " << dim << "D";
+  Benchmark::report (name.str(), time, n_cell_dofs, "DoF/s");
+}
+
+
+
+int main()
+{
+  test<3,1> (5);
+  test<3,2> (4);
+  test<3,3> (4);
+  test<3,4> (3);
+  test<3,5> (3);
+  test<3,6> (3);
+  test<3,7> (2);
+  test<3,8> (2);
+}
@@ -0,0 +1,81 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+// benchmark FEValues::reinit on a distorted 3D mesh, for FE_Q elements of
+// degree one and two with the update flags that are used for the
+// assembly of a Laplace problem
+
+#include "benchmark.h"
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/tria.h>
+
+#include <sstream>
+
+using namespace dealii;
+
+
+template <int dim>
+void test (const unsigned int degree,
+           const unsigned int n_refinements)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+  // distort the mesh so that the mapping needs to be recomputed on every
+  // cell rather than being detected as a translation of the previous cell
+  GridTools::distort_random (0.2, tria);
+
+  FE_Q<dim> fe (degree);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  FEValues<dim> fe_values (fe, QGauss<dim>(degree+1),
+                           update_values | update_gradients |
+                           update_quadrature_points | update_JxW_values);
+
+  // accumulate a value of each cell so that the compiler may not remove the
+  // computations
+  double sum = 0;
+  const double time = Benchmark::time_kernel ([&]()
+  {
+    for (typename DoFHandler<dim>::active_cell_iterator cell=dof_handler.begin_active();
+         cell != dof_handler.end(); ++cell)
+      {
+        fe_values.reinit (cell);
+        sum += fe_values.JxW(0);
+      }
+  });
+
+  std::ostringstream name;
+  name << "FEValues::reinit Q" << degree << " " << dim << "D";
+  Benchmark::report (name.str(), time, tria.n_active_cells(), "cells/s");
+  if (sum < 0)
+    std::cout << sum << std::endl;
+}
+
+
+
+int main()
+{
+  test<2> (1, 8);
+  test<3> (1, 4);
+  test<3> (2, 4);
+}
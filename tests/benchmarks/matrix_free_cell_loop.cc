@@ -0,0 +1,108 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+// benchmark MatrixFree::cell_loop with the matrix-free Laplace operator of
+// step-37 for FE_Q elements of degrees one to four in 3D, including the
+// access to the global vectors and the scheduling of the threads
+
+#include "benchmark.h"
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <functional>
+#include <sstream>
+
+using namespace dealii;
+
+
+template <int dim, int fe_degree>
+void
+local_apply (const MatrixFree<dim,double>                     &data,
+             LinearAlgebra::distributed::Vector<double>       &dst,
+             const LinearAlgebra::distributed::Vector<double> &src,
+             const std::pair<unsigned int,unsigned int>       &cell_range)
+{
+  FEEvaluation<dim,fe_degree> phi (data);
+  for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+    {
+      phi.reinit (cell);
+      phi.read_dof_values (src);
+      phi.evaluate (false, true);
+      for (unsigned int q=0; q<phi.n_q_points; ++q)
+        phi.submit_gradient (phi.get_gradient(q), q);
+      phi.integrate (false, true);
+      phi.distribute_local_to_global (dst);
+    }
+}
+
+
+
+template <int dim, int fe_degree>
+void test (const unsigned int n_refinements)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+
+  FE_Q<dim> fe (fe_degree);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  ConstraintMatrix constraints;
+  constraints.close();
+
+  MatrixFree<dim,double> matrix_free;
+  matrix_free.reinit (dof_handler, constraints, QGauss<1>(fe_degree+1));
+
+  LinearAlgebra::distributed::Vector<double> src, dst;
+  matrix_free.initialize_dof_vector (src);
+  matrix_free.initialize_dof_vector (dst);
+  for (unsigned int i=0; i<src.local_size(); ++i)
+    src.local_element(i) = 1. + 0.01*(i%17);
+
+  const std::function<void (const MatrixFree<dim,double> &,
+                             LinearAlgebra::distributed::Vector<double> &,
+                             const LinearAlgebra::distributed::Vector<double> &,
+                             const std::pair<unsigned int,unsigned int> &)>
+  cell_operation = &local_apply<dim,fe_degree>;
+
+  const double time = Benchmark::time_kernel ([&]()
+  {
+    dst = 0.;
+    matrix_free.cell_loop (cell_operation, dst, src);
+  });
+
+  std::ostringstream name;
+  name << "MatrixFree::cell_loop Laplace Q" << fe_degree << " " << dim
+       << "D n=" << dof_handler.n_dofs();
+  Benchmark::report (name.str(), time, dof_handler.n_dofs(), "DoF/s");
+}
+
+
+
+int main()
+{
+  test<3,1> (6);
+  test<3,2> (5);
+  test<3,3> (4);
+  test<3,4> (4);
+}
@@ -0,0 +1,484 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+// A driver for strong and weak scaling studies of the matrix-free geometric
+// multigrid solver of step-37 for the Laplace equation on the unit cube in
+// 3D: a parallel::distributed::Triangulation, MatrixFree operators in double
+// precision on the finest level and in single precision on the multigrid
+// levels, MGTransferMatrixFree and a PreconditionChebyshev smoother.
+//
+// The program is run as
+//   mpirun -np P ./benchmark_multigrid_scaling.release [options]
+// with the options
+//   --degree p           polynomial degree of FE_Q, 1 to 4 (default 2)
+//   --strong r           strong scaling: refine the unit cube r times
+//                        globally, independently of P (default 5)
+//   --weak n             weak scaling: choose the mesh such that each process
+//                        holds approximately n degrees of freedom
+//   --repeat k           number of repetitions of the timed operations
+//                        (default 10)
+// For a strong scaling study, the program is run with the same --strong
+// option for an increasing number of processes P; for a weak scaling study,
+// with the same --weak option. Process 0 prints a table of the setup times,
+// the time of one CG solve, of one V-cycle and of one operator evaluation,
+// the maximum over all processes for each, and the throughput in degrees of
+// freedom per second and core. The communication fraction is the time spent
+// in the exchange of the ghost values of a vector divided by the time of one
+// operator evaluation, which includes the same exchange.
+
+#include <deal.II/base/conditional_ostream.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/timer.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/operators.h>
+#include <deal.II/multigrid/mg_coarse.h>
+#include <deal.II/multigrid/mg_matrix.h>
+#include <deal.II/multigrid/mg_smoother.h>
+#include <deal.II/multigrid/mg_tools.h>
+#include <deal.II/multigrid/mg_transfer_matrix_free.h>
+#include <deal.II/multigrid/multigrid.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <set>
+#include <string>
+
+using namespace dealii;
+
+
+/**
+ * The parameters of a run, as given on the command line.
+ */
+struct Parameters
+{
+  Parameters ()
+    :
+    degree (2),
+    n_refinements (5),
+    dofs_per_process (0),
+    n_repetitions (10)
+  {}
+
+  unsigned int degree;
+  unsigned int n_refinements;
+  unsigned int dofs_per_process;
+  unsigned int n_repetitions;
+};
+
+
+
+/**
+ * Return the maximum of @p time over all processes.
+ */
+double max_time (const double time)
+{
+  return Utilities::MPI::max (time, MPI_COMM_WORLD);
+}
+
+
+
+template <int dim, int fe_degree>
+class ScalingBenchmark
+{
+public:
+  ScalingBenchmark (const Parameters &parameters);
+
+  void run ();
+
+private:
+  typedef LinearAlgebra::distributed::Vector<double> VectorType;
+  typedef LinearAlgebra::distributed::Vector<float>  LevelVectorType;
+  typedef MatrixFreeOperators::LaplaceOperator<dim,fe_degree,fe_degree+1,1,VectorType>
+  SystemMatrixType;
+  typedef MatrixFreeOperators::LaplaceOperator<dim,fe_degree,fe_degree+1,1,LevelVectorType>
+  LevelMatrixType;
+
+  void create_mesh ();
+  void setup_system ();
+  void setup_levels ();
+  void print_row (const std::string &name,
+                  const double       time,
+                  const bool         print_throughput) const;
+
+  const Parameters parameters;
+
+  parallel::distributed::Triangulation<dim> triangulation;
+  FE_Q<dim>                                 fe;
+  DoFHandler<dim>                           dof_handler;
+  ConstraintMatrix                          constraints;
+  SystemMatrixType                          system_matrix;
+  MGConstrainedDoFs                         mg_constrained_dofs;
+  MGLevelObject<LevelMatrixType>            mg_matrices;
+  VectorType                                solution;
+  VectorType                                system_rhs;
+
+  ConditionalOStream pcout;
+};
+
+
+
+template <int dim, int fe_degree>
+ScalingBenchmark<dim,fe_degree>::ScalingBenchmark (const Parameters &parameters)
+  :
+  parameters (parameters),
+  triangulation (MPI_COMM_WORLD,
+                 Triangulation<dim>::limit_level_difference_at_vertices,
+                 parallel::distributed::Triangulation<dim>::construct_multigrid_hierarchy),
+  fe (fe_degree),
+  dof_handler (triangulation),
+  pcout (std::cout, Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0)
+{}
+
+
+
+template <int dim, int fe_degree>
+void
+ScalingBenchmark<dim,fe_degree>::print_row (const std::string &name,
+                                            const double       time,
+                                            const bool         print_throughput) const
+{
+  pcout << std::left << std::setw(32) << name << std::right
+        << std::scientific << std::setprecision(3) << std::setw(12)
+        << time << " s";
+  if (print_throughput)
+    pcout << std::setw(12) << dof_handler.n_dofs() /
+          (time * Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD))
+          << " DoF/s/core";
+  pcout << std::endl;
+}
+
+
+
+template <int dim, int fe_degree>
+void
+ScalingBenchmark<dim,fe_degree>::create_mesh ()
+{
+  // for strong scaling, refine the unit cube the given number of times. for
+  // weak scaling, choose a subdivided cube with two to four cells per
+  // direction on the coarse level and refine it such that the number of
+  // degrees of freedom is close to the target number for all processes,
+  // which keeps the coarse level small
+  unsigned int n_subdivisions = 1;
+  unsigned int n_refinements = parameters.n_refinements;
+  if (parameters.dofs_per_process > 0)
+    {
+      const double n_cells_1d =
+        std::pow (1. * parameters.dofs_per_process *
+                  Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD), 1./dim) / fe_degree;
+      n_refinements = 0;
+      while (n_cells_1d / (1U << (n_refinements+1)) >= 2.)
+        ++n_refinements;
+      n_subdivisions = std::max (1, static_cast<int>(std::round (n_cells_1d /
+                                                                  (1U << n_refinements))));
+    }
+
+  GridGenerator::subdivided_hyper_cube (triangulation, n_subdivisions);
+  triangulation.refine_global (n_refinements);
+}
+
+
+
+template <int dim, int fe_degree>
+void
+ScalingBenchmark<dim,fe_degree>::setup_system ()
+{
+  dof_handler.distribute_dofs (fe);
+  dof_handler.distribute_mg_dofs ();
+
+  IndexSet locally_relevant_dofs;
+  DoFTools::extract_locally_relevant_dofs (dof_handler, locally_relevant_dofs);
+  constraints.clear();
+  constraints.reinit (locally_relevant_dofs);
+  DoFTools::make_hanging_node_constraints (dof_handler, constraints);
+  VectorTools::interpolate_boundary_values (dof_handler, 0,
+                                            Functions::ZeroFunction<dim>(),
+                                            constraints);
+  constraints.close();
+
+  typename MatrixFree<dim,double>::AdditionalData additional_data;
+  additional_data.tasks_parallel_scheme = MatrixFree<dim,double>::AdditionalData::none;
+  std::shared_ptr<MatrixFree<dim,double> > system_mf_storage (new MatrixFree<dim,double>());
+  system_mf_storage->reinit (dof_handler, constraints, QGauss<1>(fe_degree+1),
+                             additional_data);
+  system_matrix.initialize (system_mf_storage);
+
+  system_matrix.initialize_dof_vector (solution);
+  system_matrix.initialize_dof_vector (system_rhs);
+
+  FEEvaluation<dim,fe_degree> phi (*system_matrix.get_matrix_free());
+  for (unsigned int cell=0; cell<system_matrix.get_matrix_free()->n_macro_cells(); ++cell)
+    {
+      phi.reinit (cell);
+      for (unsigned int q=0; q<phi.n_q_points; ++q)
+        phi.submit_value (make_vectorized_array<double>(1.0), q);
+      phi.integrate (true, false);
+      phi.distribute_local_to_global (system_rhs);
+    }
+  system_rhs.compress (VectorOperation::add);
+}
+
+
+
+template <int dim, int fe_degree>
+void
+ScalingBenchmark<dim,fe_degree>::setup_levels ()
+{
+  const unsigned int n_levels = triangulation.n_global_levels();
+  mg_matrices.resize (0, n_levels-1);
+
+  std::set<types::boundary_id> dirichlet_boundary;
+  dirichlet_boundary.insert (0);
+  mg_constrained_dofs.initialize (dof_handler);
+  mg_constrained_dofs.make_zero_boundary_constraints (dof_handler, dirichlet_boundary);
+
+  for (unsigned int level=0; level<n_levels; ++level)
+    {
+      IndexSet relevant_dofs;
+      DoFTools::extract_locally_relevant_level_dofs (dof_handler, level,
+                                                     relevant_dofs);
+      ConstraintMatrix level_constraints;
+      level_constraints.reinit (relevant_dofs);
+      level_constraints.add_lines (mg_constrained_dofs.get_boundary_indices(level));
+      level_constraints.close();
+
+      typename MatrixFree<dim,float>::AdditionalData additional_data;
+      additional_data.tasks_parallel_scheme = MatrixFree<dim,float>::AdditionalData::none;
+      additional_data.level_mg_handler = level;
+      std::shared_ptr<MatrixFree<dim,float> > mg_mf_storage_level (new MatrixFree<dim,float>());
+      mg_mf_storage_level->reinit (dof_handler, level_constraints,
+                                   QGauss<1>(fe_degree+1), additional_data);
+      mg_matrices[level].initialize (mg_mf_storage_level, mg_constrained_dofs, level);
+    }
+}
+
+
+
+template <int dim, int fe_degree>
+void
+ScalingBenchmark<dim,fe_degree>::run ()
+{
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+  Timer timer;
+
+  create_mesh ();
+  const double time_mesh = max_time (timer.wall_time());
+
+  timer.restart();
+  setup_system ();
+  const double time_system = max_time (timer.wall_time());
+
+  timer.restart();
+  setup_levels ();
+  const double time_levels = max_time (timer.wall_time());
+
+  timer.restart();
+  MGTransferMatrixFree<dim,float> mg_transfer (mg_constrained_dofs);
+  mg_transfer.build (dof_handler);
+  const double time_transfer = max_time (timer.wall_time());
+
+  timer.restart();
+  const unsigned int n_levels = triangulation.n_global_levels();
+  typedef PreconditionChebyshev<LevelMatrixType,LevelVectorType> SmootherType;
+  mg::SmootherRelaxation<SmootherType, LevelVectorType> mg_smoother;
+  MGLevelObject<typename SmootherType::AdditionalData> smoother_data;
+  smoother_data.resize (0, n_levels-1);
+  for (unsigned int level=0; level<n_levels; ++level)
+    {
+      if (level > 0)
+        {
+          smoother_data[level].smoothing_range = 15.;
+          smoother_data[level].degree = 4;
+          smoother_data[level].eig_cg_n_iterations = 10;
+        }
+      else
+        {
+          smoother_data[0].smoothing_range = 1e-3;
+          smoother_data[0].degree = numbers::invalid_unsigned_int;
+          smoother_data[0].eig_cg_n_iterations = mg_matrices[0].m();
+        }
+      mg_matrices[level].compute_diagonal();
+      smoother_data[level].preconditioner = mg_matrices[level].get_matrix_diagonal_inverse();
+    }
+  mg_smoother.initialize (mg_matrices, smoother_data);
+
+  MGCoarseGridApplySmoother<LevelVectorType> mg_coarse;
+  mg_coarse.initialize (mg_smoother);
+
+  mg::Matrix<LevelVectorType> mg_matrix (mg_matrices);
+  MGLevelObject<MatrixFreeOperators::MGInterfaceOperator<LevelMatrixType> > mg_interface_matrices;
+  mg_interface_matrices.resize (0, n_levels-1);
+  for (unsigned int level=0; level<n_levels; ++level)
+    mg_interface_matrices[level].initialize (mg_matrices[level]);
+  mg::Matrix<LevelVectorType> mg_interface (mg_interface_matrices);
+
+  Multigrid<LevelVectorType> mg (mg_matrix, mg_coarse, mg_transfer,
+                                 mg_smoother, mg_smoother);
+  mg.set_edge_matrices (mg_interface, mg_interface);
+  PreconditionMG<dim, LevelVectorType, MGTransferMatrixFree<dim,float> >
+  preconditioner (dof_handler, mg, mg_transfer);
+  const double time_smoother = max_time (timer.wall_time());
+
+  // time the solver, taking the best of the repetitions to exclude the
+  // warm-up of the first solve
+  SolverControl solver_control (100, 1e-10*system_rhs.l2_norm());
+  SolverCG<VectorType> cg (solver_control);
+  double time_solve = std::numeric_limits<double>::max();
+  for (unsigned int i=0; i<std::max(parameters.n_repetitions/5, 2U); ++i)
+    {
+      solution = 0;
+      MPI_Barrier (MPI_COMM_WORLD);
+      timer.restart();
+      cg.solve (system_matrix, solution, system_rhs, preconditioner);
+      time_solve = std::min (time_solve, max_time (timer.wall_time()));
+    }
+
+  // time a single V-cycle and a single operator evaluation on the finest
+  // level, averaged over the repetitions
+  VectorType tmp (solution);
+  MPI_Barrier (MPI_COMM_WORLD);
+  timer.restart();
+  for (unsigned int i=0; i<parameters.n_repetitions; ++i)
+    preconditioner.vmult (tmp, system_rhs);
+  const double time_vcycle = max_time (timer.wall_time()) / parameters.n_repetitions;
+
+  MPI_Barrier (MPI_COMM_WORLD);
+  timer.restart();
+  for (unsigned int i=0; i<parameters.n_repetitions; ++i)
+    system_matrix.vmult (tmp, solution);
+  const double time_matvec = max_time (timer.wall_time()) / parameters.n_repetitions;
+
+  // the exchange of ghost values that happens within the operator
+  // evaluation: import the ghosts of the source vector and send the
+  // contributions to the ghosts of the destination vector to their owners
+  MPI_Barrier (MPI_COMM_WORLD);
+  timer.restart();
+  for (unsigned int i=0; i<parameters.n_repetitions; ++i)
+    {
+      solution.update_ghost_values();
+      solution.zero_out_ghosts();
+      tmp.compress (VectorOperation::add);
+    }
+  const double time_communication = max_time (timer.wall_time()) / parameters.n_repetitions;
+
+  pcout << "Multigrid scaling benchmark: " << dim << "D, FE_Q(" << fe_degree << "), "
+        << n_procs << " MPI processes, " << MultithreadInfo::n_threads()
+        << " threads per process" << std::endl
+        << "Number of cells:                " << triangulation.n_global_active_cells()
+        << " on " << n_levels << " levels" << std::endl
+        << "Number of degrees of freedom:   " << dof_handler.n_dofs()
+        << " (" << dof_handler.n_dofs()/n_procs << " per process)" << std::endl;
+  print_row ("Setup: mesh", time_mesh, false);
+  print_row ("Setup: system and MatrixFree", time_system, false);
+  print_row ("Setup: MatrixFree on levels", time_levels, false);
+  print_row ("Setup: MG transfer", time_transfer, false);
+  print_row ("Setup: Chebyshev smoother", time_smoother, false);
+  print_row ("Setup: total", time_mesh + time_system + time_levels +
+             time_transfer + time_smoother, false);
+  print_row ("Solve (" + Utilities::to_string(solver_control.last_step())
+             + " CG iterations)", time_solve, true);
+  print_row ("One V-cycle", time_vcycle, true);
+  print_row ("One operator evaluation", time_matvec, true);
+  print_row ("One ghost exchange", time_communication, false);
+  pcout << "Communication fraction:        "
+        << std::fixed << std::setprecision(1) << std::setw(12)
+        << 100. * time_communication / time_matvec << " %" << std::endl
+        << std::endl;
+}
+
+
+
+int main (int argc, char *argv[])
+{
+  try
+    {
+      Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+
+      Parameters parameters;
+      for (int i=1; i<argc-1; i+=2)
+        {
+          const unsigned int value = std::atoi (argv[i+1]);
+          if (std::strcmp (argv[i], "--degree") == 0)
+            parameters.degree = value;
+          else if (std::strcmp (argv[i], "--strong") == 0)
+            parameters.n_refinements = value;
+          else if (std::strcmp (argv[i], "--weak") == 0)
+            parameters.dofs_per_process = value;
+          else if (std::strcmp (argv[i], "--repeat") == 0)
+            parameters.n_repetitions = std::max (value, 1U);
+          else
+            AssertThrow (false, ExcMessage (std::string("Unknown option ") + argv[i]));
+        }
+
+      switch (parameters.degree)
+        {
+        case 1:
+          ScalingBenchmark<3,1> (parameters).run ();
+          break;
+        case 2:
+          ScalingBenchmark<3,2> (parameters).run ();
+          break;
+        case 3:
+          ScalingBenchmark<3,3> (parameters).run ();
+          break;
+        case 4:
+          ScalingBenchmark<3,4> (parameters).run ();
+          break;
+        default:
+          AssertThrow (false, ExcMessage ("Only degrees 1 to 4 are implemented."));
+        }
+    }
+  catch (std::exception &exc)
+    {
+      std::cerr << std::endl << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      std::cerr << "Exception on processing: " << std::endl
+                << exc.what() << std::endl
+                << "Aborting!" << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      return 1;
+    }
+  catch (...)
+    {
+      std::cerr << std::endl << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      std::cerr << "Unknown exception!" << std::endl
+                << "Aborting!" << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      return 1;
+    }
+
+  return 0;
+}
@@ -0,0 +1,85 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+// benchmark the creation of a parallel::distributed::Triangulation by global
+// refinement and one step of local refinement and coarsening, i.e., the
+// calls into p4est and the reconstruction of the deal.II mesh from the p4est
+// forest
+
+#include "benchmark.h"
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/grid_generator.h>
+
+#include <sstream>
+
+using namespace dealii;
+
+
+template <int dim>
+void test (const unsigned int n_refinements)
+{
+  unsigned int n_cells = 0;
+  const double time_global = Benchmark::time_kernel ([&]()
+  {
+    parallel::distributed::Triangulation<dim> tria (MPI_COMM_WORLD);
+    GridGenerator::hyper_cube (tria);
+    tria.refine_global (n_refinements);
+    n_cells = tria.n_global_active_cells();
+  });
+
+  std::ostringstream name;
+  name << "p4est refine_global " << dim << "D";
+  Benchmark::report (name.str(), time_global, n_cells, "cells/s");
+
+  parallel::distributed::Triangulation<dim> tria (MPI_COMM_WORLD);
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+
+  // refine the cells in a ball around the origin, which creates the most
+  // work for the 2:1 balance of p4est, and coarsen them again so that every
+  // run starts from the same mesh
+  unsigned int n_refined_cells = 0;
+  const double time_adaptive = Benchmark::time_kernel ([&]()
+  {
+    for (typename Triangulation<dim>::active_cell_iterator cell=tria.begin_active();
+         cell != tria.end(); ++cell)
+      if (cell->is_locally_owned() && cell->center().norm() < 0.3)
+        cell->set_refine_flag();
+    tria.execute_coarsening_and_refinement();
+    n_refined_cells = tria.n_global_active_cells();
+
+    for (typename Triangulation<dim>::active_cell_iterator cell=tria.begin_active();
+         cell != tria.end(); ++cell)
+      if (cell->is_locally_owned() && cell->level() > static_cast<int>(n_refinements))
+        cell->set_coarsen_flag();
+    tria.execute_coarsening_and_refinement();
+  });
+
+  name.str("");
+  name << "p4est execute_coarsening_and_refinement " << dim << "D";
+  Benchmark::report (name.str(), time_adaptive, n_refined_cells, "cells/s");
+}
+
+
+
+int main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+
+  test<2> (9);
+  test<3> (5);
+}
@@ -0,0 +1,43 @@
+## ---------------------------------------------------------------------
+##
+## Copyright (C) 2017 by the deal.II authors
+##
+## This file is part of the deal.II library.
+##
+## The deal.II library is free software; you can use it, redistribute
+## it, and/or modify it under the terms of the GNU Lesser General
+## Public License as published by the Free Software Foundation; either
+## version 2.1 of the License, or (at your option) any later version.
+## The full text of the license can be found in the file LICENSE at
+## the top level of the deal.II distribution.
+##
+## ---------------------------------------------------------------------
+
+# This file is run when "make benchmarks" is executed by the user. It runs
+# the benchmark programs one after the other, prints their results and
+# collects them in the file benchmarks.log.
+
+SEPARATE_ARGUMENTS(ALL_BENCHMARKS)
+
+FILE(WRITE benchmarks.log "")
+SET(_failed)
+
+FOREACH(_benchmark ${ALL_BENCHMARKS})
+  EXECUTE_PROCESS(COMMAND ./${_benchmark}
+    OUTPUT_VARIABLE _output
+    ERROR_VARIABLE _output
+    RESULT_VARIABLE _res_var
+    )
+  MESSAGE("${_output}")
+  FILE(APPEND benchmarks.log "${_output}\n")
+  IF(NOT "${_res_var}" STREQUAL "0")
+    LIST(APPEND _failed ${_benchmark})
+  ENDIF()
+ENDFOREACH()
+
+IF(NOT "${_failed}" STREQUAL "")
+  MESSAGE(FATAL_ERROR "
+The following benchmarks did not run successfully: ${_failed}
+Please check the file tests/benchmarks/benchmarks.log for their output.\n"
+    )
+ENDIF()
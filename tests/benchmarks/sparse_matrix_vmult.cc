@@ -0,0 +1,86 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+// benchmark SparseMatrix::vmult for the Laplace matrix of Q1 and Q2
+// elements in 3D. The throughput is based on the bytes that have to be
+// transferred from memory at least, i.e., the matrix values and column
+// indices, the row starts, and the source and destination vectors
+
+#include "benchmark.h"
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/matrix_tools.h>
+
+#include <sstream>
+
+using namespace dealii;
+
+
+template <int dim>
+void test (const unsigned int degree,
+           const unsigned int n_refinements)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+
+  FE_Q<dim> fe (degree);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  DynamicSparsityPattern dsp (dof_handler.n_dofs());
+  DoFTools::make_sparsity_pattern (dof_handler, dsp);
+  SparsityPattern sparsity;
+  sparsity.copy_from (dsp);
+
+  SparseMatrix<double> matrix (sparsity);
+  MatrixCreator::create_laplace_matrix (dof_handler, QGauss<dim>(degree+1),
+                                        matrix);
+
+  Vector<double> src (dof_handler.n_dofs()), dst (dof_handler.n_dofs());
+  for (unsigned int i=0; i<src.size(); ++i)
+    src(i) = 1. + 0.01*(i%17);
+
+  const double time = Benchmark::time_kernel ([&]()
+  {
+    matrix.vmult (dst, src);
+  });
+
+  const double bytes = matrix.n_nonzero_elements() * (sizeof(double) + sizeof(unsigned int))
+                       + (matrix.m()+1) * sizeof(std::size_t)
+                       + 2. * matrix.m() * sizeof(double);
+
+  std::ostringstream name;
+  name << "SparseMatrix::vmult Q" << degree << " " << dim << "D n=" << matrix.m();
+  Benchmark::report (name.str(), time, bytes, "GB/s");
+}
+
+
+
+int main()
+{
+  test<3> (1, 5);
+  test<3> (1, 6);
+  test<3> (2, 5);
+}
@@ -0,0 +1,94 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+// benchmark the operations of Vector that are used by the iterative
+// solvers, for a vector that fits into the caches and one that does not.
+// The throughput counts each vector entry that is read or written once
+
+#include "benchmark.h"
+
+#include <deal.II/lac/vector.h>
+
+#include <sstream>
+
+using namespace dealii;
+
+
+template <typename Number>
+void test (const unsigned int size)
+{
+  Vector<Number> x (size), y (size), z (size);
+  for (unsigned int i=0; i<size; ++i)
+    {
+      x(i) = 1. + 0.01*(i%13);
+      y(i) = 2. - 0.01*(i%7);
+      z(i) = 0.5;
+    }
+
+  std::ostringstream suffix;
+  suffix << " n=" << size << (sizeof(Number) == 4 ? " float" : " double");
+
+  // the result of the reductions is accumulated so that the compiler may
+  // not remove them
+  Number result = 0;
+
+  Benchmark::report ("Vector::operator=" + suffix.str(),
+                     Benchmark::time_kernel ([&]()
+  {
+    z = x;
+  }), 2.*size*sizeof(Number), "GB/s");
+
+  Benchmark::report ("Vector::add" + suffix.str(),
+                     Benchmark::time_kernel ([&]()
+  {
+    z.add (Number(1e-3), x);
+  }), 3.*size*sizeof(Number), "GB/s");
+
+  Benchmark::report ("Vector::sadd" + suffix.str(),
+                     Benchmark::time_kernel ([&]()
+  {
+    z.sadd (Number(0.5), Number(0.5), y);
+  }), 3.*size*sizeof(Number), "GB/s");
+
+  Benchmark::report ("Vector::operator*" + suffix.str(),
+                     Benchmark::time_kernel ([&]()
+  {
+    result += x * y;
+  }), 2.*size*sizeof(Number), "GB/s");
+
+  Benchmark::report ("Vector::l2_norm" + suffix.str(),
+                     Benchmark::time_kernel ([&]()
+  {
+    result += x.l2_norm();
+  }), 1.*size*sizeof(Number), "GB/s");
+
+  Benchmark::report ("Vector::add_and_dot" + suffix.str(),
+                     Benchmark::time_kernel ([&]()
+  {
+    result += z.add_and_dot (Number(1e-3), x, y);
+  }), 4.*size*sizeof(Number), "GB/s");
+
+  if (result == Number(-1))
+    std::cout << result << std::endl;
+}
+
+
+
+int main()
+{
+  test<double> (10000);
+  test<double> (10000000);
+  test<float> (10000000);
+}